@@ -0,0 +1,323 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/util/SyntheticVocabulary.h"
+#include "global/Id.h"
+#include "index/ColumnCodec.h"
+#include "index/PrefixHeuristic.h"
+#include "index/vocabulary/PrefixCompressor.h"
+#include "util/BlockPackedCode.h"
+#include "util/Random.h"
+#include "util/Simple8bCode.h"
+
+namespace ad_benchmark {
+
+namespace {
+// A codec together with the data that it is measured on.
+struct Codec {
+  std::string name_;
+  // The size of the uncompressed data.
+  size_t numBytes_;
+  // Compress the data and return the size of the compressed data.
+  std::function<size_t()> encode_;
+  // Decompress the data that was compressed by the last call to `encode_`.
+  std::function<void()> decode_;
+};
+
+// Split the `values` into blocks of (at most) `blockSize` values.
+template <typename T>
+std::vector<std::vector<T>> splitIntoBlocks(const std::vector<T>& values,
+                                            size_t blockSize) {
+  std::vector<std::vector<T>> blocks;
+  for (size_t start = 0; start < values.size(); start += blockSize) {
+    auto end = std::min(start + blockSize, values.size());
+    blocks.emplace_back(values.begin() + start, values.begin() + end);
+  }
+  return blocks;
+}
+
+// The three columns of a permutation with `numRows` random triples: col0 is
+// sorted and has few distinct values, col1 is sorted within each value of
+// col0, and col2 is sorted only within each pair of col0 and col1.
+std::array<std::vector<Id>, 3> makePermutationColumns(size_t numRows) {
+  ad_utility::SlowRandomIntGenerator<uint64_t> col0{0, numRows / 100 + 1};
+  ad_utility::SlowRandomIntGenerator<uint64_t> otherCols{0, numRows};
+  std::vector<std::array<uint64_t, 3>> triples(numRows);
+  for (auto& triple : triples) {
+    triple = {col0(), otherCols(), otherCols()};
+  }
+  std::ranges::sort(triples);
+  std::array<std::vector<Id>, 3> columns;
+  for (size_t col = 0; col < 3; ++col) {
+    columns[col].reserve(numRows);
+    for (const auto& triple : triples) {
+      columns[col].push_back(
+          Id::makeFromVocabIndex(VocabIndex::make(triple[col])));
+    }
+  }
+  return columns;
+}
+
+// The `columnCodec` with the `codec` on the blocks of an `Id` column.
+Codec makeColumnCodec(std::string name, ColumnCodec codec,
+                      std::vector<std::vector<Id>> blocks) {
+  struct State {
+    std::vector<std::vector<Id>> blocks_;
+    std::vector<std::vector<char>> encoded_;
+    std::vector<Id> decoded_;
+  };
+  auto state = std::make_shared<State>();
+  state->blocks_ = std::move(blocks);
+  size_t numBytes = 0;
+  for (const auto& block : state->blocks_) {
+    numBytes += block.size() * sizeof(Id);
+  }
+  return {std::move(name), numBytes,
+          [state, codec]() {
+            state->encoded_.clear();
+            size_t size = 0;
+            for (const auto& block : state->blocks_) {
+              size += state->encoded_
+                          .emplace_back(columnCodec::encode(codec, block))
+                          .size();
+            }
+            return size;
+          },
+          [state, codec]() {
+            for (size_t i = 0; i < state->blocks_.size(); ++i) {
+              state->decoded_.resize(state->blocks_[i].size());
+              columnCodec::decode(codec, state->encoded_[i], state->decoded_);
+            }
+          }};
+}
+
+// `Simple8bCode` on blocks of integers (each smaller than 2^60).
+Codec makeSimple8bCodec(std::string name,
+                        std::vector<std::vector<uint64_t>> blocks) {
+  struct State {
+    std::vector<std::vector<uint64_t>> blocks_;
+    std::vector<std::vector<uint64_t>> encoded_;
+    std::vector<uint64_t> decoded_;
+  };
+  auto state = std::make_shared<State>();
+  state->blocks_ = std::move(blocks);
+  size_t numBytes = 0;
+  for (const auto& block : state->blocks_) {
+    numBytes += block.size() * sizeof(uint64_t);
+  }
+  return {std::move(name), numBytes,
+          [state]() {
+            state->encoded_.clear();
+            size_t size = 0;
+            for (auto& block : state->blocks_) {
+              // There is at most one code word per value.
+              auto& encoded = state->encoded_.emplace_back(block.size() + 1);
+              size += ad_utility::Simple8bCode::encode(
+                  block.data(), block.size(), encoded.data());
+            }
+            return size;
+          },
+          [state]() {
+            for (size_t i = 0; i < state->blocks_.size(); ++i) {
+              // See the documentation of `Simple8bCode::decode` for the
+              // additional space.
+              state->decoded_.resize(state->blocks_[i].size() + 239);
+              ad_utility::Simple8bCode::decode(state->encoded_[i].data(),
+                                               state->blocks_[i].size(),
+                                               state->decoded_.data());
+            }
+          }};
+}
+
+// `BlockPackedCode` on blocks of integers, with or without differential
+// encoding.
+template <bool Differential>
+Codec makeBlockPackedCodec(std::string name,
+                           std::vector<std::vector<uint64_t>> blocks) {
+  using ad_utility::BlockPackedCode;
+  struct State {
+    std::vector<std::vector<uint64_t>> blocks_;
+    std::vector<std::vector<uint64_t>> encoded_;
+    std::vector<uint64_t> decoded_;
+  };
+  auto state = std::make_shared<State>();
+  state->blocks_ = std::move(blocks);
+  size_t numBytes = 0;
+  for (const auto& block : state->blocks_) {
+    numBytes += block.size() * sizeof(uint64_t);
+  }
+  return {std::move(name), numBytes,
+          [state]() {
+            state->encoded_.clear();
+            size_t size = 0;
+            for (const auto& block : state->blocks_) {
+              size += state->encoded_
+                          .emplace_back(BlockPackedCode::encode<Differential>(
+                              block.data(), block.size()))
+                          .size() *
+                      sizeof(uint64_t);
+            }
+            return size;
+          },
+          [state]() {
+            for (size_t i = 0; i < state->blocks_.size(); ++i) {
+              state->decoded_.resize(state->blocks_[i].size());
+              BlockPackedCode::decode<Differential>(state->encoded_[i].data(),
+                                                    state->blocks_[i].size(),
+                                                    state->decoded_.data());
+            }
+          }};
+}
+
+// The `PrefixCompressor` on the `words` with a codebook that is computed with
+// the same heuristic as in the index build.
+Codec makePrefixCodec(std::string name, std::vector<std::string> words) {
+  struct State {
+    std::vector<std::string> words_;
+    PrefixCompressor compressor_;
+    std::vector<std::string> encoded_;
+    std::vector<std::string> decoded_;
+  };
+  auto state = std::make_shared<State>();
+  state->compressor_.buildCodebook(
+      calculatePrefixes(words, NUM_COMPRESSION_PREFIXES, 1));
+  state->words_ = std::move(words);
+  size_t numBytes = 0;
+  for (const auto& word : state->words_) {
+    numBytes += word.size();
+  }
+  return {std::move(name), numBytes,
+          [state]() {
+            state->encoded_.clear();
+            size_t size = 0;
+            for (const auto& word : state->words_) {
+              size += state->encoded_
+                          .emplace_back(state->compressor_.compress(word))
+                          .size();
+            }
+            return size;
+          },
+          [state]() {
+            state->decoded_.clear();
+            for (const auto& word : state->encoded_) {
+              state->decoded_.push_back(state->compressor_.decompress(word));
+            }
+          }};
+}
+}  // namespace
+
+// Measure the compression ratio and the single-threaded encoding and decoding
+// throughput of the codecs of the index: the `columnCodec`s on the columns of
+// a permutation, `Simple8bCode` and `BlockPackedCode` on the gaps and scores
+// of the postings of the text index, and the `PrefixCompressor` on a synthetic
+// vocabulary. The throughput is the size of the uncompressed data per second.
+class CodecBenchmark : public BenchmarkInterface {
+  size_t numRows_;
+  size_t numRowsPerBlock_;
+  size_t numWords_;
+
+ public:
+  CodecBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("numRows",
+                      "The number of rows of the permutation and of the "
+                      "postings of the text index.",
+                      &numRows_, size_t{10'000'000});
+    manager.addOption("numRowsPerBlock",
+                      "The number of rows per compressed block.",
+                      &numRowsPerBlock_, size_t{65'536});
+    manager.addOption("numWords",
+                      "The number of words of the synthetic vocabulary.",
+                      &numWords_, size_t{1'000'000});
+  }
+
+  std::string name() const final { return "Codecs"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    std::vector<Codec> codecs;
+    auto columns = makePermutationColumns(numRows_);
+    for (size_t col = 0; col < 3; ++col) {
+      auto blocks = splitIntoBlocks(columns[col], numRowsPerBlock_);
+      auto suffix = absl::StrCat(", col", col);
+      codecs.push_back(makeColumnCodec(absl::StrCat("ZSTD", suffix),
+                                       ColumnCodec::Zstd, blocks));
+      codecs.push_back(
+          makeColumnCodec(absl::StrCat("Delta bit packing", suffix),
+                          ColumnCodec::DeltaBitPacking, blocks));
+      codecs.push_back(makeColumnCodec(
+          absl::StrCat("Frame of reference", suffix),
+          ColumnCodec::FrameOfReference, std::move(blocks)));
+    }
+
+    // The postings of the text index: increasing record IDs with small gaps
+    // and small scores.
+    ad_utility::SlowRandomIntGenerator<uint64_t> gap{1, 100};
+    ad_utility::SlowRandomIntGenerator<uint64_t> score{0, 15};
+    std::vector<uint64_t> recordIds(numRows_);
+    std::vector<uint64_t> gaps(numRows_);
+    std::vector<uint64_t> scores(numRows_);
+    uint64_t recordId = 0;
+    for (size_t i = 0; i < numRows_; ++i) {
+      gaps[i] = gap();
+      recordId += gaps[i];
+      recordIds[i] = recordId;
+      scores[i] = score();
+    }
+    codecs.push_back(makeSimple8bCodec(
+        "Simple8b, gaps of record IDs",
+        splitIntoBlocks(gaps, numRowsPerBlock_)));
+    codecs.push_back(makeBlockPackedCodec<true>(
+        "Block packed (differential), record IDs",
+        splitIntoBlocks(recordIds, numRowsPerBlock_)));
+    codecs.push_back(makeSimple8bCodec(
+        "Simple8b, scores", splitIntoBlocks(scores, numRowsPerBlock_)));
+    codecs.push_back(makeBlockPackedCodec<false>(
+        "Block packed, scores", splitIntoBlocks(scores, numRowsPerBlock_)));
+    codecs.push_back(makePrefixCodec("Prefix compression, vocabulary",
+                                     makeSyntheticVocabulary(numWords_)));
+
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (const auto& codec : codecs) {
+      rowNames.push_back(codec.name_);
+    }
+    auto& table = results.addTable(
+        "Codecs", rowNames,
+        {"Codec and data", "Compression ratio", "Encode time", "Decode time",
+         "Encode (MB/s)", "Decode (MB/s)"});
+    table.metadata().addKeyValuePair("numRows", numRows_);
+    table.metadata().addKeyValuePair("numRowsPerBlock", numRowsPerBlock_);
+    table.metadata().addKeyValuePair("numWords", numWords_);
+    for (size_t row = 0; row < codecs.size(); ++row) {
+      auto& codec = codecs.at(row);
+      size_t compressedSize = 0;
+      table.addMeasurement(row, 2, [&codec, &compressedSize]() {
+        compressedSize = codec.encode_();
+      });
+      table.addMeasurement(row, 3, codec.decode_);
+      auto ratio = static_cast<float>(codec.numBytes_) /
+                   static_cast<float>(std::max(compressedSize, size_t{1}));
+      table.setEntry(row, 1, ratio);
+      auto megabytesPerSecond = [&codec, &table, row](size_t column) {
+        auto seconds = std::max(table.getEntry<float>(row, column), 1e-9f);
+        return static_cast<float>(codec.numBytes_) / 1e6f / seconds;
+      };
+      table.setEntry(row, 4, megabytesPerSecond(2));
+      table.setEntry(row, 5, megabytesPerSecond(3));
+    }
+    return results;
+  }
+};
+AD_REGISTER_BENCHMARK(CodecBenchmark);
+}  // namespace ad_benchmark
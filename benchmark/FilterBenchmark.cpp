@@ -0,0 +1,74 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/util/QueryBenchmarkHelpers.h"
+
+namespace ad_benchmark {
+
+// Measure `Filter` for expressions of different shapes (comparisons, boolean
+// combinations, arithmetic, `IN`, and string functions). The input of the
+// `Filter` is computed before the measurement, s.t. only the evaluation of the
+// expression is measured.
+class FilterBenchmark : public BenchmarkInterface {
+  size_t numSubjects_;
+
+ public:
+  FilterBenchmark() {
+    getConfigManager().addOption(
+        "numSubjects",
+        "The number of subjects, each of which has a numeric value and a name.",
+        &numSubjects_, size_t{1'000'000});
+  }
+
+  std::string name() const final { return "Filter"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    auto turtle = makeTurtle(numSubjects_, [](size_t i) {
+      return absl::StrCat("<s", i, "> <value> ", i % 1'000, "; <name> \"name",
+                          i, "\"");
+    });
+    auto* qec = getBenchmarkQec(turtle);
+
+    // The names and expressions of the filters.
+    std::vector<std::pair<std::string, std::string>> filters{
+        {"Comparison", "?v > 500"},
+        {"Conjunction", "?v > 100 && ?v < 900"},
+        {"Disjunction", "?v < 100 || ?v > 900"},
+        {"Arithmetic", "?v * 2 + 1 > 1000"},
+        {"IN", "?v IN (1, 10, 100, 500, 999)"},
+        {"STRSTARTS", "STRSTARTS(?name, \"name1\")"},
+        {"REGEX", "REGEX(?name, \"5$\")"}};
+
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (const auto& [name, expression] : filters) {
+      rowNames.push_back(name);
+    }
+    auto& table = results.addTable(
+        "FILTER", rowNames,
+        {"Shape", "Expression", "Time", "Number of result rows"});
+    table.metadata().addKeyValuePair("numSubjects", numSubjects_);
+    for (size_t row = 0; row < filters.size(); ++row) {
+      const auto& expression = filters.at(row).second;
+      auto qet = planQuery(
+          qec, absl::StrCat("SELECT ?s ?v ?name WHERE { ?s <value> ?v . ?s "
+                            "<name> ?name FILTER (",
+                            expression, ") }"));
+      precomputeSubtrees(qec, qet, 1);
+      size_t numResultRows = 0;
+      table.setEntry(row, 1, expression);
+      table.addMeasurement(row, 2, [&qet, &numResultRows]() {
+        numResultRows = qet.getResult()->size();
+      });
+      table.setEntry(row, 3, numResultRows);
+    }
+    return results;
+  }
+};
+AD_REGISTER_BENCHMARK(FilterBenchmark);
+}  // namespace ad_benchmark
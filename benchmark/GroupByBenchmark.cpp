@@ -0,0 +1,90 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/util/QueryBenchmarkHelpers.h"
+#include "global/Constants.h"
+
+namespace ad_benchmark {
+
+// Compare the sort-based `GroupBy` with its hash map optimization (see the
+// runtime parameter `use-group-by-hash-map-optimization`, note that the hash
+// map is only used if its cost estimate is lower than that of the sort) for
+// different numbers of groups.
+class GroupByBenchmark : public BenchmarkInterface {
+  size_t numSubjects_;
+  std::vector<size_t> numGroups_;
+
+ public:
+  GroupByBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("numSubjects",
+                      "The number of subjects, each of which has a group and "
+                      "a value.",
+                      &numSubjects_, size_t{1'000'000});
+    manager.addOption("numGroups", "The numbers of groups.", &numGroups_,
+                      std::vector<size_t>{10, 1'000, 100'000});
+  }
+
+  std::string name() const final { return "GroupBy (sort versus hash map)"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    // For each number of groups, there is a predicate that assigns the
+    // subjects to that many groups, s.t. all the queries run on the same
+    // index.
+    auto turtle = makeTurtle(numSubjects_, [this](size_t i) {
+      std::string triples = absl::StrCat("<s", i, "> <value> ", i % 1'000);
+      for (size_t numGroups : numGroups_) {
+        absl::StrAppend(&triples, "; <group", numGroups, "> <g",
+                        i % numGroups, ">");
+      }
+      return triples;
+    });
+    auto* qec = getBenchmarkQec(turtle);
+
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (size_t numGroups : numGroups_) {
+      rowNames.push_back(absl::StrCat(numGroups, " groups"));
+    }
+    auto& table = results.addTable(
+        "GROUP BY with COUNT and SUM", rowNames,
+        {"Number of groups", "Sort-based", "Hash map",
+         "Number of result rows"});
+    table.metadata().addKeyValuePair("numSubjects", numSubjects_);
+
+    auto& parameters = RuntimeParameters();
+    bool originalUseHashMap =
+        parameters.get<"use-group-by-hash-map-optimization">();
+    for (size_t row = 0; row < numGroups_.size(); ++row) {
+      // The join on `?s` produces a result that is not sorted by `?g`, so the
+      // `GroupBy` has to sort it (or use the hash map).
+      auto qet = planQuery(
+          qec, absl::StrCat("SELECT ?g (COUNT(?s) AS ?count) "
+                            "(SUM(?v) AS ?sum) WHERE { ?s <group",
+                            numGroups_.at(row),
+                            "> ?g . ?s <value> ?v } GROUP BY ?g"));
+      // The result of the join (below the `GroupBy` and its `Sort`) is
+      // computed before the measurements, s.t. only the grouping (including
+      // the sort) is measured.
+      size_t numResultRows = 0;
+      auto measure = [&](size_t column, bool useHashMap) {
+        parameters.set<"use-group-by-hash-map-optimization">(useHashMap);
+        precomputeSubtrees(qec, qet, 2);
+        table.addMeasurement(row, column, [&qet, &numResultRows]() {
+          numResultRows = qet.getResult()->size();
+        });
+      };
+      measure(1, false);
+      measure(2, true);
+      table.setEntry(row, 3, numResultRows);
+    }
+    parameters.set<"use-group-by-hash-map-optimization">(originalUseHashMap);
+    return results;
+  }
+};
+AD_REGISTER_BENCHMARK(GroupByBenchmark);
+}  // namespace ad_benchmark
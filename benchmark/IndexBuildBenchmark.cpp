@@ -0,0 +1,227 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "index/Index.h"
+#include "index/IndexImpl.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Random.h"
+#include "util/Timer.h"
+
+namespace ad_benchmark {
+
+namespace {
+// Reset the peak of the resident memory of this process (Linux only, see
+// `man 5 proc`). Return false if this is not possible, in which case the
+// peak is the peak since the start of the process.
+bool resetPeakResidentMemory() {
+  std::ofstream clearRefs{"/proc/self/clear_refs"};
+  clearRefs << "5";
+  clearRefs.flush();
+  return clearRefs.good();
+}
+
+// The peak of the resident memory of this process in bytes (since the start
+// of the process or the last `resetPeakResidentMemory`), 0 if unknown.
+size_t peakResidentMemory() {
+  std::ifstream status{"/proc/self/status"};
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.starts_with("VmHWM:")) {
+      // The value is given in kB.
+      return std::stoull(line.substr(6)) * 1024;
+    }
+  }
+  return 0;
+}
+
+// Draw random numbers from `[0, n)` with a Zipf distribution with the
+// exponent `skew` (uniformly for `skew == 0`).
+class ZipfGenerator {
+  std::vector<double> cumulativeProbabilities_;
+  ad_utility::RandomDoubleGenerator random_{0.0, 1.0};
+
+ public:
+  ZipfGenerator(size_t n, double skew) : cumulativeProbabilities_(n) {
+    AD_CONTRACT_CHECK(n > 0);
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+      cumulativeProbabilities_[i] = sum;
+    }
+    for (auto& probability : cumulativeProbabilities_) {
+      probability /= sum;
+    }
+  }
+
+  size_t operator()() {
+    auto it = std::ranges::lower_bound(cumulativeProbabilities_, random_());
+    return std::min(
+        static_cast<size_t>(it - cumulativeProbabilities_.begin()),
+        cumulativeProbabilities_.size() - 1);
+  }
+};
+}  // namespace
+
+// Measure the stages of the index build (`IndexImpl::createFromFiles`) on
+// synthetic N-Triples. The subjects and objects are drawn from a vocabulary of
+// `vocabularySize` entities with a Zipf distribution, and a fraction of the
+// objects are literals (plain strings, strings with a language tag, and
+// integers in equal parts). For each stage, the time, the throughput (the
+// number of input triples per second), and the peak of the resident memory of
+// the process during the stage are reported.
+class IndexBuildBenchmark : public BenchmarkInterface {
+  size_t numTriples_;
+  size_t vocabularySize_;
+  size_t numPredicates_;
+  float skew_;
+  float literalFraction_;
+  std::string memoryLimit_;
+  std::string directory_;
+
+  // The measurements of a single stage.
+  struct Stage {
+    std::string name_;
+    ad_utility::Timer timer_{ad_utility::Timer::Started};
+    size_t peakMemory_ = 0;
+  };
+
+ public:
+  IndexBuildBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("numTriples", "The number of input triples.",
+                      &numTriples_, size_t{10'000'000});
+    manager.addOption("vocabularySize",
+                      "The number of distinct subjects and IRI objects.",
+                      &vocabularySize_, size_t{1'000'000});
+    manager.addOption("numPredicates", "The number of distinct predicates.",
+                      &numPredicates_, size_t{100});
+    manager.addOption("skew",
+                      "The exponent of the Zipf distribution of the subjects "
+                      "and objects (0 for a uniform distribution).",
+                      &skew_, 1.0f);
+    manager.addOption("literalFraction",
+                      "The fraction of the objects that are literals.",
+                      &literalFraction_, 0.3f);
+    manager.addOption("memoryLimit",
+                      "The memory limit of the index build, e.g. `4GB`.",
+                      &memoryLimit_, std::string{"4GB"});
+    manager.addOption("directory",
+                      "The directory for the input and the index (a "
+                      "temporary directory if empty).",
+                      &directory_, std::string{});
+  }
+
+  std::string name() const final { return "Index build"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    namespace fs = std::filesystem;
+    fs::path directory = directory_.empty()
+                             ? fs::temp_directory_path() / "IndexBuildBenchmark"
+                             : fs::path{directory_};
+    fs::create_directories(directory);
+    std::string inputFile = directory / "input.nt";
+    writeInput(inputFile);
+
+    std::mutex mutex;
+    std::vector<Stage> stages;
+    ad_utility::Timer totalTimer{ad_utility::Timer::Stopped};
+    {
+      Index index{ad_utility::makeUnlimitedAllocator<Id>()};
+      index.setOnDiskBase(directory / "index");
+      index.memoryLimitIndexBuilding() =
+          ad_utility::MemorySize::parse(memoryLimit_);
+      index.usePatterns() = true;
+      index.loadAllPermutations() = true;
+      auto& observer = index.getImpl().buildStageObserver();
+      observer.onBegin_ = [&mutex, &stages](std::string_view stage) {
+        std::lock_guard lock{mutex};
+        resetPeakResidentMemory();
+        stages.push_back(Stage{std::string{stage}});
+      };
+      observer.onEnd_ = [&mutex, &stages](std::string_view stage) {
+        std::lock_guard lock{mutex};
+        auto it = std::ranges::find(stages, stage, &Stage::name_);
+        AD_CORRECTNESS_CHECK(it != stages.end());
+        it->timer_.stop();
+        it->peakMemory_ = peakResidentMemory();
+      };
+      totalTimer.start();
+      index.createFromFile(inputFile);
+      totalTimer.stop();
+    }
+
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (const auto& stage : stages) {
+      rowNames.push_back(stage.name_);
+    }
+    rowNames.push_back("Total");
+    auto& table = results.addTable(
+        "Stages of the index build", rowNames,
+        {"Stage", "Time", "Triples per second", "Peak memory (MB)"});
+    table.metadata().addKeyValuePair("numTriples", numTriples_);
+    table.metadata().addKeyValuePair("vocabularySize", vocabularySize_);
+    table.metadata().addKeyValuePair("numPredicates", numPredicates_);
+    table.metadata().addKeyValuePair("skew", skew_);
+    table.metadata().addKeyValuePair("literalFraction", literalFraction_);
+    table.metadata().addKeyValuePair("memoryLimit", memoryLimit_);
+    auto setRow = [this, &table](size_t row, ad_utility::Timer::Duration time,
+                                 size_t peakMemory) {
+      double seconds = std::chrono::duration<double>(time).count();
+      auto triplesPerSecond = static_cast<double>(numTriples_) /
+                              std::max(seconds, 1e-6);
+      table.setEntry(row, 1, static_cast<float>(seconds));
+      table.setEntry(row, 2, static_cast<size_t>(triplesPerSecond));
+      table.setEntry(row, 3, peakMemory / 1'000'000);
+    };
+    for (size_t row = 0; row < stages.size(); ++row) {
+      setRow(row, stages.at(row).timer_.value(), stages.at(row).peakMemory_);
+    }
+    // The peak of the complete build is the maximum of the stages.
+    size_t peakMemory = 0;
+    for (const auto& stage : stages) {
+      peakMemory = std::max(peakMemory, stage.peakMemory_);
+    }
+    setRow(stages.size(), totalTimer.value(), peakMemory);
+
+    if (directory_.empty()) {
+      fs::remove_all(directory);
+    }
+    return results;
+  }
+
+ private:
+  // Write `numTriples_` random triples to the file with the `filename`.
+  void writeInput(const std::string& filename) const {
+    std::ofstream out{filename};
+    ZipfGenerator entities{vocabularySize_, skew_};
+    ZipfGenerator predicates{numPredicates_, 0.0};
+    ad_utility::RandomDoubleGenerator random{0.0, 1.0};
+    for (size_t i = 0; i < numTriples_; ++i) {
+      out << "<http://example.org/s" << entities() << "> <http://example.org/p"
+          << predicates() << "> ";
+      double r = random();
+      if (r >= literalFraction_) {
+        out << "<http://example.org/s" << entities() << ">";
+      } else if (r < literalFraction_ / 3) {
+        out << "\"literal " << entities() << "\"";
+      } else if (r < 2 * literalFraction_ / 3) {
+        out << "\"literal " << entities() << "\"@en";
+      } else {
+        out << "\"" << entities()
+            << "\"^^<http://www.w3.org/2001/XMLSchema#integer>";
+      }
+      out << " .\n";
+    }
+  }
+};
+AD_REGISTER_BENCHMARK(IndexBuildBenchmark);
+}  // namespace ad_benchmark
@@ -0,0 +1,76 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/util/QueryBenchmarkHelpers.h"
+#include "index/DecompressedBlockCache.h"
+
+namespace ad_benchmark {
+
+// Measure the scans of the index permutations (`IndexScan`, which uses
+// `CompressedRelationReader::scan`) cold and warm. For the cold scans, the
+// cache of the decompressed blocks is cleared before the measurement, for the
+// warm scans, the blocks were decompressed by the previous scan. Note that the
+// page cache of the operating system is not cleared, s.t. the blocks are read
+// from memory in both cases, and the difference is the decompression.
+class IndexScanBenchmark : public BenchmarkInterface {
+  size_t numSubjects_;
+
+ public:
+  IndexScanBenchmark() {
+    getConfigManager().addOption(
+        "numSubjects",
+        "The number of subjects, each of which has a value and an object.",
+        &numSubjects_, size_t{1'000'000});
+  }
+
+  std::string name() const final { return "IndexScan (cold versus warm)"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    auto turtle = makeTurtle(numSubjects_, [](size_t i) {
+      return absl::StrCat("<s", i, "> <value> ", i % 1'000, "; <object> <o",
+                          i % 100, ">");
+    });
+    auto* qec = getBenchmarkQec(turtle);
+
+    // The names and triples of the scans.
+    std::vector<std::pair<std::string, std::string>> scans{
+        {"Two variables (PSO)", "?s <value> ?o"},
+        {"Two variables (POS)", "?o <object> ?s"},
+        {"One variable", "?s <object> <o42>"},
+        {"All triples", "?s ?p ?o"}};
+
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (const auto& [name, triple] : scans) {
+      rowNames.push_back(name);
+    }
+    auto& table = results.addTable(
+        "Index scans", rowNames,
+        {"Scan", "Triple", "Cold", "Warm", "Number of result rows"});
+    table.metadata().addKeyValuePair("numSubjects", numSubjects_);
+    for (size_t row = 0; row < scans.size(); ++row) {
+      const auto& triple = scans.at(row).second;
+      auto qet =
+          planQuery(qec, absl::StrCat("SELECT * WHERE { ", triple, " }"));
+      size_t numResultRows = 0;
+      table.setEntry(row, 1, triple);
+      qec->clearCacheUnpinnedOnly();
+      getDecompressedBlockCache().clear();
+      table.addMeasurement(row, 2, [qec, &qet, &numResultRows]() {
+        numResultRows = computeWithoutCache(qec, qet);
+      });
+      table.addMeasurement(row, 3, [qec, &qet]() {
+        computeWithoutCache(qec, qet);
+      });
+      table.setEntry(row, 4, numResultRows);
+    }
+    return results;
+  }
+};
+AD_REGISTER_BENCHMARK(IndexScanBenchmark);
+}  // namespace ad_benchmark
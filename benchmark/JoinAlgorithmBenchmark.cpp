@@ -0,0 +1,101 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../test/util/IdTableHelpers.h"
+#include "../test/util/IdTestHelpers.h"
+#include "../test/util/JoinHelpers.h"
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+// Compare `Join::join` (the merge join, which gallops if one of the inputs is
+// much smaller) with `Join::hashJoin` for different ratios of the sizes of the
+// inputs and different skews of the join column. Both inputs are sorted by the
+// join column, as `Join::join` requires it.
+class JoinAlgorithmBenchmark : public BenchmarkInterface {
+  size_t numRowsSmallerTable_;
+  std::vector<size_t> ratios_;
+  std::vector<float> skews_;
+
+ public:
+  JoinAlgorithmBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("smallerTableNumRows",
+                      "The number of rows of the smaller input.",
+                      &numRowsSmallerTable_, size_t{10'000});
+    manager.addOption("ratios",
+                      "The ratios of the number of rows of the larger and the "
+                      "smaller input.",
+                      &ratios_, std::vector<size_t>{1, 10, 100, 1'000});
+    manager.addOption(
+        "skews",
+        "The skews of the join column. The values of the join column are "
+        "`floor(n * u^skew)` for uniformly random `u` in [0, 1), where `n` "
+        "is the number of rows of the larger input. A skew of 1 is uniform, "
+        "larger skews make the small values more frequent.",
+        &skews_, std::vector<float>{1, 4});
+  }
+
+  std::string name() const final {
+    return "Join::join versus Join::hashJoin";
+  }
+
+  BenchmarkResults runAllBenchmarks() final {
+    BenchmarkResults results{};
+    auto mergeJoin = makeJoinLambda();
+    auto hashJoin = makeHashJoinLambda();
+
+    std::vector<std::string> rowNames;
+    for (size_t ratio : ratios_) {
+      rowNames.push_back(absl::StrCat("1:", ratio));
+    }
+    for (float skew : skews_) {
+      auto& table = results.addTable(
+          absl::StrCat("Skew ", skew), rowNames,
+          {"Ratio of the sizes", "Join::join", "Join::hashJoin",
+           "Number of result rows"});
+      table.metadata().addKeyValuePair("skew", skew);
+      for (size_t row = 0; row < ratios_.size(); ++row) {
+        size_t numRowsLargerTable = numRowsSmallerTable_ * ratios_.at(row);
+        auto smaller =
+            makeInput(numRowsSmallerTable_, numRowsLargerTable, skew);
+        auto larger = makeInput(numRowsLargerTable, numRowsLargerTable, skew);
+        size_t numResultRows = 0;
+        table.addMeasurement(row, 1, [&]() {
+          numResultRows =
+              useJoinFunctionOnIdTables(smaller, larger, mergeJoin).numRows();
+        });
+        table.addMeasurement(row, 2, [&]() {
+          useJoinFunctionOnIdTables(smaller, larger, hashJoin);
+        });
+        table.setEntry(row, 3, numResultRows);
+      }
+    }
+    return results;
+  }
+
+ private:
+  // An input with two columns, which is sorted by the join column 0. The
+  // values of the join column are from `[0, numDistinctValues)` (see the
+  // description of the `skews` option).
+  static IdTableAndJoinColumn makeInput(size_t numRows,
+                                        size_t numDistinctValues, float skew) {
+    ad_utility::RandomDoubleGenerator random{0, 1};
+    auto generator = [&random, numDistinctValues, skew]() {
+      auto value = static_cast<size_t>(static_cast<double>(numDistinctValues) *
+                                       std::pow(random(), skew));
+      return ad_utility::testing::VocabId(value);
+    };
+    IdTableAndJoinColumn result{
+        createRandomlyFilledIdTable(numRows, 2, {{0, generator}}), 0};
+    sortIdTableByJoinColumnInPlace(result);
+    return result;
+  }
+};
+AD_REGISTER_BENCHMARK(JoinAlgorithmBenchmark);
+}  // namespace ad_benchmark
@@ -0,0 +1,370 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_split.h>
+#include <absl/strings/strip.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "engine/QueryExecutionContext.h"
+#include "engine/QueryPlanner.h"
+#include "engine/SortPerformanceEstimator.h"
+#include "global/Constants.h"
+#include "index/DecompressedBlockCache.h"
+#include "index/Index.h"
+#include "index/VocabularyWordCache.h"
+#include "parser/SparqlParser.h"
+#include "util/AllocatorWithLimit.h"
+#include "util/Exception.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Timer.h"
+
+namespace ad_benchmark {
+
+// Replay a query log on an existing index, first cold (all the caches are
+// cleared) and then warm (all the results of the cold run are cached, as far as
+// the size of the cache allows it), with a configurable number of concurrent
+// queries. This allows to compare two builds of QLever on one's own workload.
+// The latency of a query is the time for its parsing, its planning, and the
+// computation of its result (the export of the result is not part of it).
+//
+// The query log is either a TSV file with one query per line, optionally
+// preceded by a name and a tab (the format of `misc/allq-l1000.txt`), or a
+// YAML file in the format of `e2e/scientists_queries.yaml` (only the `query`
+// and `sparql` keys are read).
+class QueryWorkloadBenchmark : public BenchmarkInterface {
+  std::string indexBasename_;
+  std::string queryFile_;
+  size_t numConcurrentQueries_;
+  std::string memoryLimit_;
+  bool useText_;
+  bool usePatterns_;
+  bool loadAllPermutations_;
+
+  struct Query {
+    std::string name_;
+    std::string sparql_;
+  };
+
+  // The outcome of a single query in a single run.
+  struct QueryRun {
+    std::optional<std::string> error_;
+    double latencyMs_ = 0;
+    size_t numResultRows_ = 0;
+    // The time of the operations that were computed (not read from the
+    // cache) by the query, by the name of the operation.
+    std::map<std::string, double> msPerOperator_;
+  };
+
+ public:
+  QueryWorkloadBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("indexBasename",
+                      "The basename of the index on which the queries are run.",
+                      &indexBasename_, std::string{});
+    manager.addOption("queryFile",
+                      "The file with the queries (a TSV file with an optional "
+                      "name and a query per line, or a YAML file with "
+                      "`query` and `sparql` keys).",
+                      &queryFile_, std::string{});
+    manager.addOption("numConcurrentQueries",
+                      "The number of queries that are computed at the same "
+                      "time.",
+                      &numConcurrentQueries_, size_t{1});
+    manager.addOption("memoryLimit",
+                      "The memory limit for the results and the cache, e.g. "
+                      "`4GB`.",
+                      &memoryLimit_, std::string{"4GB"});
+    manager.addOption("useText", "Also load the text index.", &useText_,
+                      false);
+    manager.addOption("usePatterns", "Load the patterns of the index.",
+                      &usePatterns_, true);
+    manager.addOption("loadAllPermutations",
+                      "Load all six permutations of the index (and not only "
+                      "PSO and POS).",
+                      &loadAllPermutations_, true);
+  }
+
+  std::string name() const final { return "Query workload"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    if (indexBasename_.empty() || queryFile_.empty()) {
+      throw std::runtime_error(
+          "The options `indexBasename` and `queryFile` of the query workload "
+          "benchmark are required.");
+    }
+    AD_CONTRACT_CHECK(numConcurrentQueries_ > 0);
+    auto queries = readQueries(queryFile_);
+
+    QueryResultCache cache;
+    const auto& parameters = RuntimeParameters();
+    cache.setMaxNumEntries(parameters.get<"cache-max-num-entries">());
+    cache.setMaxSize(parameters.get<"cache-max-size">());
+    cache.setMaxSizeSingleEntry(
+        parameters.get<"cache-max-size-single-entry">());
+    ad_utility::AllocatorWithLimit<Id> allocator{
+        ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+            ad_utility::MemorySize::parse(memoryLimit_)),
+        [&cache](ad_utility::MemorySize numMemoryToAllocate) {
+          cache.makeRoomAsMuchAsPossible(MAKE_ROOM_SLACK_FACTOR *
+                                         numMemoryToAllocate);
+        }};
+    Index index{allocator};
+    index.usePatterns() = usePatterns_;
+    index.loadAllPermutations() = loadAllPermutations_;
+    index.createFromOnDiskIndex(indexBasename_);
+    if (useText_) {
+      index.addTextFromOnDiskIndex();
+    }
+    SortPerformanceEstimator sortPerformanceEstimator;
+    sortPerformanceEstimator.computeEstimatesExpensively(
+        allocator, index.numTriples().normalAndInternal_() *
+                       PERCENTAGE_OF_TRIPLES_FOR_SORT_ESTIMATE / 100);
+
+    auto runQuery = [&](const Query& query) {
+      QueryRun run;
+      ad_utility::Timer timer{ad_utility::Timer::Started};
+      try {
+        QueryExecutionContext qec{index, &cache, allocator,
+                                  sortPerformanceEstimator};
+        auto parsedQuery = SparqlParser::parseQuery(query.sparql_);
+        QueryPlanner queryPlanner{&qec};
+        auto qet = queryPlanner.createExecutionTree(parsedQuery);
+        run.numResultRows_ = qet.getResult()->size();
+        run.latencyMs_ = toMs(timer.value());
+        addOperatorTimes(qet.getRootOperation()->runtimeInfo(),
+                         run.msPerOperator_);
+      } catch (const std::exception& e) {
+        run.error_ = e.what();
+      }
+      return run;
+    };
+
+    // Compute all the queries with `numConcurrentQueries_` threads, each of
+    // which computes the next query that has not been started yet. Return the
+    // runs of the queries and the total (wall-clock) time.
+    auto replay = [&]() {
+      std::vector<QueryRun> runs(queries.size());
+      std::atomic<size_t> nextQuery = 0;
+      ad_utility::Timer timer{ad_utility::Timer::Started};
+      {
+        std::vector<std::jthread> threads;
+        for (size_t i = 0; i < numConcurrentQueries_; ++i) {
+          threads.emplace_back([&]() {
+            for (size_t j = nextQuery++; j < queries.size(); j = nextQuery++) {
+              runs.at(j) = runQuery(queries.at(j));
+            }
+          });
+        }
+      }
+      return std::pair{std::move(runs), toMs(timer.value())};
+    };
+
+    cache.clearAll();
+    getDecompressedBlockCache().clear();
+    getVocabularyWordCache().clear();
+    auto [coldRuns, coldWallTimeMs] = replay();
+    auto [warmRuns, warmWallTimeMs] = replay();
+
+    BenchmarkResults results{};
+    addSummaryTable(results, {{"Cold", coldRuns, coldWallTimeMs},
+                              {"Warm", warmRuns, warmWallTimeMs}});
+    addQueryTable(results, queries, coldRuns, warmRuns);
+    addOperatorTable(results, "Time per operator (cold run)", coldRuns);
+    addOperatorTable(results, "Time per operator (warm run)", warmRuns);
+    return results;
+  }
+
+  BenchmarkMetadata getMetadata() const final {
+    BenchmarkMetadata meta;
+    meta.addKeyValuePair("indexBasename", indexBasename_);
+    meta.addKeyValuePair("queryFile", queryFile_);
+    meta.addKeyValuePair("numConcurrentQueries", numConcurrentQueries_);
+    meta.addKeyValuePair("memoryLimit", memoryLimit_);
+    return meta;
+  }
+
+ private:
+  static double toMs(ad_utility::Timer::Duration duration) {
+    return ad_utility::Timer::toSeconds(duration) * 1000;
+  }
+
+  // Read the queries from the `file` (see the class comment for the formats).
+  static std::vector<Query> readQueries(const std::string& file) {
+    std::ifstream in{file};
+    if (!in) {
+      throw std::runtime_error(
+          absl::StrCat("Could not open the query file \"", file, "\""));
+    }
+    std::vector<Query> queries;
+    std::string line;
+    if (file.ends_with(".yaml") || file.ends_with(".yml")) {
+      // The SPARQL query is the block that follows `sparql: |` and is indented
+      // more deeply than the key.
+      std::optional<size_t> indentOfSparql;
+      while (std::getline(in, line)) {
+        size_t indent = line.find_first_not_of(' ');
+        std::string_view content = absl::StripAsciiWhitespace(line);
+        if (indentOfSparql.has_value()) {
+          if (content.empty() || indent > indentOfSparql.value()) {
+            absl::StrAppend(&queries.back().sparql_, content, "\n");
+            continue;
+          }
+          indentOfSparql.reset();
+        }
+        if (absl::ConsumePrefix(&content, "- query:")) {
+          queries.push_back({std::string{absl::StripAsciiWhitespace(content)},
+                             std::string{}});
+        } else if (content.starts_with("sparql:") && !queries.empty()) {
+          indentOfSparql = indent;
+        }
+      }
+    } else {
+      size_t lineNumber = 0;
+      while (std::getline(in, line)) {
+        ++lineNumber;
+        if (absl::StripAsciiWhitespace(line).empty()) {
+          continue;
+        }
+        std::vector<std::string> parts =
+            absl::StrSplit(line, absl::MaxSplits('\t', 1));
+        if (parts.size() == 1) {
+          parts.insert(parts.begin(), absl::StrCat("query-", lineNumber));
+        }
+        queries.push_back({std::move(parts.at(0)), std::move(parts.at(1))});
+      }
+    }
+    if (queries.empty()) {
+      throw std::runtime_error(
+          absl::StrCat("The query file \"", file, "\" contains no queries"));
+    }
+    return queries;
+  }
+
+  // Add the time of the `runtimeInfo` and all its descendants to the
+  // `msPerOperator`. The name of an operation is the first word of its
+  // descriptor (e.g. `IndexScan` or `Join`). Operations that were read from
+  // the cache are skipped.
+  static void addOperatorTimes(const RuntimeInformation& runtimeInfo,
+                               std::map<std::string, double>& msPerOperator) {
+    if (runtimeInfo.cacheStatus_ == ad_utility::CacheStatus::computed) {
+      std::string_view descriptor = runtimeInfo.descriptor_;
+      std::string name{descriptor.substr(0, descriptor.find(' '))};
+      msPerOperator[name] +=
+          static_cast<double>(runtimeInfo.getOperationTime().count());
+    }
+    for (const auto& child : runtimeInfo.children_) {
+      addOperatorTimes(*child, msPerOperator);
+    }
+  }
+
+  // The value at the `percentile` (in [0, 100]) of the sorted `values`, using
+  // the nearest-rank method.
+  static float percentile(const std::vector<double>& values,
+                          double percentile) {
+    if (values.empty()) {
+      return 0;
+    }
+    auto rank = static_cast<size_t>(std::ceil(
+        percentile / 100 * static_cast<double>(values.size())));
+    return static_cast<float>(values.at(std::max(rank, size_t{1}) - 1));
+  }
+
+  struct NamedRuns {
+    std::string name_;
+    const std::vector<QueryRun>& runs_;
+    double wallTimeMs_;
+  };
+
+  // The latency percentiles, the throughput, and the number of failed queries
+  // of each of the `runs`.
+  static void addSummaryTable(BenchmarkResults& results,
+                              const std::vector<NamedRuns>& runs) {
+    std::vector<std::string> rowNames;
+    for (const auto& run : runs) {
+      rowNames.push_back(run.name_);
+    }
+    auto& table = results.addTable(
+        "Summary", rowNames,
+        {"Run", "Number of queries", "Number of failed queries",
+         "Wall time (ms)", "Throughput (queries/s)", "Median latency (ms)",
+         "90th percentile (ms)", "99th percentile (ms)", "Maximum (ms)"});
+    for (size_t row = 0; row < runs.size(); ++row) {
+      const auto& [name, queryRuns, wallTimeMs] = runs.at(row);
+      std::vector<double> latencies;
+      for (const auto& run : queryRuns) {
+        if (!run.error_.has_value()) {
+          latencies.push_back(run.latencyMs_);
+        }
+      }
+      std::ranges::sort(latencies);
+      table.setEntry(row, 1, queryRuns.size());
+      table.setEntry(row, 2, queryRuns.size() - latencies.size());
+      table.setEntry(row, 3, static_cast<float>(wallTimeMs));
+      table.setEntry(row, 4,
+                     static_cast<float>(static_cast<double>(latencies.size()) /
+                                        (wallTimeMs / 1000)));
+      table.setEntry(row, 5, percentile(latencies, 50));
+      table.setEntry(row, 6, percentile(latencies, 90));
+      table.setEntry(row, 7, percentile(latencies, 99));
+      table.setEntry(row, 8, percentile(latencies, 100));
+    }
+  }
+
+  // The latency of each query in the cold and in the warm run.
+  static void addQueryTable(BenchmarkResults& results,
+                            const std::vector<Query>& queries,
+                            const std::vector<QueryRun>& coldRuns,
+                            const std::vector<QueryRun>& warmRuns) {
+    std::vector<std::string> rowNames;
+    for (const auto& query : queries) {
+      rowNames.push_back(query.name_);
+    }
+    auto& table = results.addTable(
+        "Queries", rowNames,
+        {"Query", "Cold (ms)", "Warm (ms)", "Number of result rows", "Error"});
+    for (size_t row = 0; row < queries.size(); ++row) {
+      const auto& cold = coldRuns.at(row);
+      const auto& warm = warmRuns.at(row);
+      table.setEntry(row, 1, static_cast<float>(cold.latencyMs_));
+      table.setEntry(row, 2, static_cast<float>(warm.latencyMs_));
+      table.setEntry(row, 3, cold.numResultRows_);
+      table.setEntry(row, 4, cold.error_.value_or(warm.error_.value_or("")));
+    }
+  }
+
+  // The total time of the operations of all the queries of the `runs`, by the
+  // name of the operation.
+  static void addOperatorTable(BenchmarkResults& results,
+                               const std::string& description,
+                               const std::vector<QueryRun>& runs) {
+    std::map<std::string, double> msPerOperator;
+    for (const auto& run : runs) {
+      for (const auto& [name, ms] : run.msPerOperator_) {
+        msPerOperator[name] += ms;
+      }
+    }
+    std::vector<std::string> rowNames;
+    for (const auto& [name, ms] : msPerOperator) {
+      rowNames.push_back(name);
+    }
+    auto& table =
+        results.addTable(description, rowNames, {"Operator", "Total (ms)"});
+    size_t row = 0;
+    for (const auto& [name, ms] : msPerOperator) {
+      table.setEntry(row++, 1, static_cast<float>(ms));
+    }
+  }
+};
+AD_REGISTER_BENCHMARK(QueryWorkloadBenchmark);
+}  // namespace ad_benchmark
@@ -0,0 +1,275 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <absl/strings/str_cat.h>
+
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "engine/Server.h"
+#include "index/Index.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Random.h"
+#include "util/Timer.h"
+#include "util/http/HttpClient.h"
+#include "util/jthread.h"
+
+namespace ad_benchmark {
+
+// Measure the overhead of the HTTP path (`HttpServer` and `Server::process`:
+// parsing, planning, and the export of the result) separately from the
+// computation of the results. A server is started in this process on a small
+// synthetic index, and the same queries are sent to it repeatedly with
+// `numConcurrentRequests` clients, s.t. all results come from the query cache.
+// The trivial query (a single `VALUES` row) measures the overhead of handling
+// a request, the other query additionally the export of `numResultRows` rows.
+// Each query is exported as JSON, TSV, and in the binary format (the IDs of
+// the result). Each request gets a unique comment, s.t. identical concurrent
+// requests don't share their response.
+class ServerBenchmark : public BenchmarkInterface {
+  size_t numTriples_;
+  size_t numResultRows_;
+  size_t numRequests_;
+  size_t numConcurrentRequests_;
+  size_t numServerThreads_;
+  size_t port_;
+  std::string directory_;
+
+  struct Query {
+    std::string name_;
+    std::string sparql_;
+  };
+
+  struct Format {
+    std::string name_;
+    std::string acceptHeader_;
+  };
+
+ public:
+  ServerBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("numTriples", "The number of triples of the index.",
+                      &numTriples_, size_t{100'000});
+    manager.addOption("numResultRows",
+                      "The number of rows of the result that is exported.",
+                      &numResultRows_, size_t{10'000});
+    manager.addOption("numRequests",
+                      "The number of requests per query and format.",
+                      &numRequests_, size_t{1'000});
+    manager.addOption("numConcurrentRequests",
+                      "The number of clients that send requests at the same "
+                      "time.",
+                      &numConcurrentRequests_, size_t{4});
+    manager.addOption("numServerThreads",
+                      "The number of threads of the server.",
+                      &numServerThreads_, size_t{4});
+    manager.addOption("port", "The port of the server.", &port_,
+                      size_t{7099});
+    manager.addOption("directory",
+                      "The directory for the index (a temporary directory if "
+                      "empty).",
+                      &directory_, std::string{});
+  }
+
+  std::string name() const final { return "HTTP path of the server"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    namespace fs = std::filesystem;
+    AD_CONTRACT_CHECK(numConcurrentRequests_ > 0);
+    fs::path directory = directory_.empty()
+                             ? fs::temp_directory_path() / "ServerBenchmark"
+                             : fs::path{directory_};
+    fs::create_directories(directory);
+    std::string indexBasename = directory / "index";
+    buildIndex(directory / "input.nt", indexBasename);
+
+    Server server{static_cast<unsigned short>(port_), numServerThreads_,
+                  ad_utility::MemorySize::gigabytes(1), ""};
+    ad_utility::JThread serverThread{[&server, &indexBasename]() {
+      try {
+        server.run(indexBasename, false);
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "The server of the benchmark failed: " << e.what()
+                   << std::endl;
+      }
+    }};
+
+    std::vector<Query> queries{
+        {"Trivial query", "SELECT ?x WHERE { VALUES ?x { 1 } }"},
+        {absl::StrCat(numResultRows_, " rows"),
+         absl::StrCat("SELECT ?s ?p ?o WHERE { ?s ?p ?o } LIMIT ",
+                      numResultRows_)}};
+    std::vector<Format> formats{
+        {"JSON", "application/sparql-results+json"},
+        {"TSV", "text/tab-separated-values"},
+        {"binary", "application/octet-stream"}};
+
+    std::optional<BenchmarkResults> results;
+    try {
+      waitUntilReady(queries.front());
+      results = measure(queries, formats);
+    } catch (...) {
+      server.shutDown();
+      throw;
+    }
+    server.shutDown();
+    serverThread.join();
+    if (directory_.empty()) {
+      fs::remove_all(directory);
+    }
+    return std::move(results.value());
+  }
+
+ private:
+  // Send all the `queries` in all the `formats` and return the results.
+  BenchmarkResults measure(const std::vector<Query>& queries,
+                           const std::vector<Format>& formats) {
+    std::vector<std::string> rowNames;
+    for (const auto& query : queries) {
+      for (const auto& format : formats) {
+        rowNames.push_back(absl::StrCat(query.name_, ", ", format.name_));
+      }
+    }
+    BenchmarkResults results{};
+    auto& table = results.addTable(
+        "HTTP path", rowNames,
+        {"Query and format", "Response size (bytes)", "Median latency (ms)",
+         "99th percentile (ms)", "Throughput (requests/s)",
+         "Number of failed requests"});
+    table.metadata().addKeyValuePair("numTriples", numTriples_);
+    table.metadata().addKeyValuePair("numRequests", numRequests_);
+    table.metadata().addKeyValuePair("numConcurrentRequests",
+                                     numConcurrentRequests_);
+    table.metadata().addKeyValuePair("numServerThreads", numServerThreads_);
+
+    size_t row = 0;
+    for (const auto& query : queries) {
+      for (const auto& format : formats) {
+        // The first request computes the result and stores it in the cache.
+        size_t responseSize = sendRequest(query, format, 0).value_or(0);
+        std::vector<double> latencies(numRequests_, -1.0);
+        std::atomic<size_t> nextRequest = 0;
+        ad_utility::Timer timer{ad_utility::Timer::Started};
+        {
+          std::vector<ad_utility::JThread> threads;
+          for (size_t i = 0; i < numConcurrentRequests_; ++i) {
+            threads.emplace_back([&]() {
+              std::optional<HttpClient> client;
+              for (size_t j = nextRequest++; j < numRequests_;
+                   j = nextRequest++) {
+                ad_utility::Timer latency{ad_utility::Timer::Started};
+                if (sendRequest(query, format, j + 1, client).has_value()) {
+                  latencies.at(j) = toMs(latency.value());
+                }
+              }
+            });
+          }
+        }
+        double wallTimeMs = toMs(timer.value());
+        std::erase(latencies, -1.0);
+        std::ranges::sort(latencies);
+        table.setEntry(row, 1, responseSize);
+        table.setEntry(row, 2, percentile(latencies, 50));
+        table.setEntry(row, 3, percentile(latencies, 99));
+        table.setEntry(row, 4,
+                       static_cast<float>(
+                           static_cast<double>(latencies.size()) /
+                           (std::max(wallTimeMs, 1e-6) / 1000)));
+        table.setEntry(row, 5, numRequests_ - latencies.size());
+        ++row;
+      }
+    }
+    return results;
+  }
+
+  // Send the `query` (with the unique `requestNumber` as a comment) in the
+  // `format` via the `client`, which is (re)connected if necessary. Return the
+  // size of the response or `std::nullopt` if the request failed.
+  std::optional<size_t> sendRequest(const Query& query, const Format& format,
+                                    size_t requestNumber,
+                                    std::optional<HttpClient>& client) const {
+    try {
+      if (!client.has_value() || !client->isReusable()) {
+        client.reset();
+        client.emplace("localhost", std::to_string(port_));
+      }
+      auto response = client->sendRequest(
+          boost::beast::http::verb::post, "localhost", "/",
+          absl::StrCat(query.sparql_, "\n# request ", requestNumber),
+          "application/sparql-query", format.acceptHeader_);
+      return response.view().size();
+    } catch (const std::exception&) {
+      client.reset();
+      return std::nullopt;
+    }
+  }
+
+  // Same as above, but with a new connection.
+  std::optional<size_t> sendRequest(const Query& query, const Format& format,
+                                    size_t requestNumber) const {
+    std::optional<HttpClient> client;
+    return sendRequest(query, format, requestNumber, client);
+  }
+
+  // Wait until the server (which first loads the index) answers the `query`,
+  // but at most one minute.
+  void waitUntilReady(const Query& query) const {
+    Format format{"JSON", "application/sparql-results+json"};
+    ad_utility::Timer timer{ad_utility::Timer::Started};
+    while (!sendRequest(query, format, 0).has_value()) {
+      if (timer.value() > std::chrono::minutes{1}) {
+        throw std::runtime_error(
+            "The server of the benchmark did not start within one minute");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+  }
+
+  // Build an index with `numTriples_` random triples from the N-Triples file
+  // `inputFile`.
+  void buildIndex(const std::string& inputFile,
+                  const std::string& indexBasename) const {
+    {
+      std::ofstream out{inputFile};
+      ad_utility::SlowRandomIntGenerator<size_t> entity{
+          0, std::max<size_t>(numTriples_ / 10, 1)};
+      ad_utility::SlowRandomIntGenerator<size_t> predicate{0, 9};
+      for (size_t i = 0; i < numTriples_; ++i) {
+        out << "<http://example.org/s" << entity()
+            << "> <http://example.org/p" << predicate() << "> "
+            << (i % 2 == 0 ? "<http://example.org/s" : "\"literal ")
+            << entity() << (i % 2 == 0 ? ">" : "\"") << " .\n";
+      }
+    }
+    Index index{ad_utility::makeUnlimitedAllocator<Id>()};
+    index.setOnDiskBase(indexBasename);
+    index.usePatterns() = true;
+    index.loadAllPermutations() = true;
+    index.createFromFile(inputFile);
+  }
+
+  static double toMs(ad_utility::Timer::Duration duration) {
+    return ad_utility::Timer::toSeconds(duration) * 1000;
+  }
+
+  // The value at the `percentile` (in [0, 100]) of the sorted `values`, using
+  // the nearest-rank method.
+  static float percentile(const std::vector<double>& values,
+                          double percentile) {
+    if (values.empty()) {
+      return 0;
+    }
+    auto rank = static_cast<size_t>(std::ceil(
+        percentile / 100 * static_cast<double>(values.size())));
+    return static_cast<float>(values.at(std::max(rank, size_t{1}) - 1));
+  }
+};
+AD_REGISTER_BENCHMARK(ServerBenchmark);
+}  // namespace ad_benchmark
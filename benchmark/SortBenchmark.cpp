@@ -0,0 +1,92 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../test/util/IdTableHelpers.h"
+#include "../test/util/IdTestHelpers.h"
+#include "engine/Engine.h"
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+// Measure `Engine::sort` for different widths of the input and different
+// numbers of key columns. The values are drawn from a small range, s.t. the
+// later key columns are actually compared.
+class SortBenchmark : public BenchmarkInterface {
+  size_t numRows_;
+  size_t numDistinctValues_;
+  std::vector<size_t> widths_;
+  std::vector<size_t> numKeyColumns_;
+
+ public:
+  SortBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("numRows", "The number of rows of the input.", &numRows_,
+                      size_t{10'000'000});
+    manager.addOption("numDistinctValues",
+                      "The number of distinct values in each column.",
+                      &numDistinctValues_, size_t{1'000});
+    manager.addOption("widths", "The numbers of columns of the input.",
+                      &widths_, std::vector<size_t>{1, 2, 3, 5, 8});
+    manager.addOption("numKeyColumns", "The numbers of columns to sort by.",
+                      &numKeyColumns_, std::vector<size_t>{1, 2, 3});
+  }
+
+  std::string name() const final { return "Engine::sort"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (size_t width : widths_) {
+      rowNames.push_back(absl::StrCat(width, " columns"));
+    }
+    std::vector<std::string> columnNames{"Width"};
+    for (size_t numKeys : numKeyColumns_) {
+      columnNames.push_back(absl::StrCat(numKeys, " key columns"));
+    }
+    auto& table = results.addTable("Engine::sort", rowNames, columnNames);
+    table.metadata().addKeyValuePair("numRows", numRows_);
+    table.metadata().addKeyValuePair("numDistinctValues", numDistinctValues_);
+    table.metadata().addKeyValuePair("sort-num-threads",
+                                     Engine::getNumSortThreads());
+
+    for (size_t row = 0; row < widths_.size(); ++row) {
+      size_t width = widths_.at(row);
+      IdTable input = makeInput(width);
+      for (size_t column = 1; column < columnNames.size(); ++column) {
+        size_t numKeys = numKeyColumns_.at(column - 1);
+        if (numKeys > width) {
+          table.setEntry(row, column, std::string{"-"});
+          continue;
+        }
+        std::vector<ColumnIndex> sortColumns(numKeys);
+        std::iota(sortColumns.begin(), sortColumns.end(), 0);
+        // The copy is made outside the measurement.
+        IdTable copy = input.clone();
+        table.addMeasurement(row, column, [&copy, &sortColumns]() {
+          Engine::sort(copy, sortColumns);
+        });
+      }
+    }
+    return results;
+  }
+
+ private:
+  IdTable makeInput(size_t width) const {
+    ad_utility::FastRandomIntGenerator<size_t> random;
+    return generateIdTable(numRows_, width, [this, width, &random]() {
+      std::vector<ValueId> row;
+      for (size_t i = 0; i < width; ++i) {
+        row.push_back(ad_utility::testing::VocabId(random() %
+                                                   numDistinctValues_));
+      }
+      return row;
+    });
+  }
+};
+AD_REGISTER_BENCHMARK(SortBenchmark);
+}  // namespace ad_benchmark
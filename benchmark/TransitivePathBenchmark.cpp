@@ -0,0 +1,84 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/util/QueryBenchmarkHelpers.h"
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+// Measure `TransitivePath` (property paths like `<p>+`) on synthetic graphs: a
+// chain, a complete binary tree, and a random graph with a fixed out-degree.
+// The scans of the edges are computed before the measurement, s.t. only the
+// computation of the transitive hull is measured.
+class TransitivePathBenchmark : public BenchmarkInterface {
+  size_t numNodes_;
+  size_t outDegree_;
+
+ public:
+  TransitivePathBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("numNodes", "The number of nodes of each of the graphs.",
+                      &numNodes_, size_t{100'000});
+    manager.addOption("outDegree",
+                      "The number of outgoing edges of the nodes of the "
+                      "random graph.",
+                      &outDegree_, size_t{3});
+  }
+
+  std::string name() const final { return "TransitivePath"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    ad_utility::FastRandomIntGenerator<size_t> random;
+    auto turtle = makeTurtle(numNodes_, [this, &random](size_t i) {
+      std::string triples = absl::StrCat("<n", i, "> <tree> <n", 2 * i + 1,
+                                         ">, <n", 2 * i + 2, ">");
+      if (i + 1 < numNodes_) {
+        absl::StrAppend(&triples, "; <chain> <n", i + 1, ">");
+      }
+      for (size_t j = 0; j < outDegree_; ++j) {
+        absl::StrAppend(&triples, "; <random> <n", random() % numNodes_, ">");
+      }
+      return triples;
+    });
+    auto* qec = getBenchmarkQec(turtle);
+
+    // The names and graph patterns of the queries.
+    std::vector<std::pair<std::string, std::string>> queries{
+        {"Chain from a single node", "<n0> <chain>+ ?y"},
+        {"Tree from the root", "<n0> <tree>+ ?y"},
+        {"Tree, all pairs", "?x <tree>+ ?y"},
+        {"Random graph from a single node", "<n0> <random>+ ?y"},
+        {"Random graph, reflexive, from a single node", "<n0> <random>* ?y"}};
+
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (const auto& [name, pattern] : queries) {
+      rowNames.push_back(name);
+    }
+    auto& table = results.addTable(
+        "Property paths", rowNames,
+        {"Query", "Graph pattern", "Time", "Number of result rows"});
+    table.metadata().addKeyValuePair("numNodes", numNodes_);
+    table.metadata().addKeyValuePair("outDegree", outDegree_);
+    for (size_t row = 0; row < queries.size(); ++row) {
+      const auto& pattern = queries.at(row).second;
+      auto qet =
+          planQuery(qec, absl::StrCat("SELECT * WHERE { ", pattern, " }"));
+      precomputeSubtrees(qec, qet, 1);
+      size_t numResultRows = 0;
+      table.setEntry(row, 1, pattern);
+      table.addMeasurement(row, 2, [&qet, &numResultRows]() {
+        numResultRows = qet.getResult()->size();
+      });
+      table.setEntry(row, 3, numResultRows);
+    }
+    return results;
+  }
+};
+AD_REGISTER_BENCHMARK(TransitivePathBenchmark);
+}  // namespace ad_benchmark
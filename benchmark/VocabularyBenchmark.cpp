@@ -0,0 +1,192 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <absl/strings/str_cat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/util/SyntheticVocabulary.h"
+#include "index/PrefixHeuristic.h"
+#include "index/vocabulary/CompressedVocabulary.h"
+#include "index/vocabulary/PrefixCompressor.h"
+#include "index/vocabulary/VocabularyFrontCoded.h"
+#include "index/vocabulary/VocabularyInMemory.h"
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+namespace {
+// Remove the pages of the file with the `filename` from the page cache (on
+// platforms with `posix_fadvise`), s.t. the next reads go to the disk.
+void dropFromPageCache(const std::string& filename) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  ::fdatasync(fd);
+#ifdef POSIX_FADV_DONTNEED
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+  ::close(fd);
+}
+
+// The lookups that are measured for each vocabulary.
+struct Queries {
+  // Random indices of words.
+  std::vector<size_t> indices_;
+  // The words at the `indices_`.
+  std::vector<std::string> words_;
+  // Prefixes of the `words_` (like the ones of `STRSTARTS` or of the
+  // `ql:contains-word` prefix search).
+  std::vector<std::string> prefixes_;
+};
+}  // namespace
+
+// Compare the lookups in the layouts of the vocabulary on a synthetic
+// vocabulary: a plain and a prefix-compressed vocabulary in RAM (the latter is
+// the internal vocabulary of the index), and the front-coded vocabulary on
+// disk. For each layout, the lookup of the ID of a word (`lower_bound`), the
+// lookup of the word of an ID (`operator[]`), and the range of the IDs of the
+// words with a given prefix are measured (single-threaded). The vocabulary on
+// disk is measured with a cold page cache (the file is dropped from the page
+// cache before the lookups) and a warm page cache (the same lookups again).
+class VocabularyBenchmark : public BenchmarkInterface {
+  size_t numWords_;
+  size_t numLookups_;
+  std::string directory_;
+
+ public:
+  VocabularyBenchmark() {
+    auto& manager = getConfigManager();
+    manager.addOption("numWords", "The number of words of the vocabulary.",
+                      &numWords_, size_t{1'000'000});
+    manager.addOption("numLookups",
+                      "The number of lookups of each kind and layout.",
+                      &numLookups_, size_t{100'000});
+    manager.addOption("directory",
+                      "The directory for the vocabulary on disk (the "
+                      "temporary directory if empty).",
+                      &directory_, std::string{});
+  }
+
+  std::string name() const final { return "Vocabulary lookups"; }
+
+  BenchmarkResults runAllBenchmarks() final {
+    namespace fs = std::filesystem;
+    auto words = makeSyntheticVocabulary(numWords_);
+    auto queries = makeQueries(words);
+
+    VocabularyInMemory inMemory;
+    inMemory.build(words);
+    CompressedVocabulary<VocabularyInMemory, PrefixCompressor> compressed;
+    compressed.getCompressor().buildCodebook(
+        calculatePrefixes(words, NUM_COMPRESSION_PREFIXES, 1));
+    compressed.build(words);
+    fs::path directory = directory_.empty() ? fs::temp_directory_path()
+                                            : fs::path{directory_};
+    std::string filename = directory / "VocabularyBenchmark.vocabulary";
+    VocabularyFrontCoded frontCoded;
+    frontCoded.buildFromVector(words, filename);
+
+    // The name of a row, the function that is called before the measurement
+    // (e.g. to drop the page cache), and the lookups to measure.
+    struct Measurement {
+      std::string name_;
+      std::function<void()> prepare_;
+      std::function<void()> lookups_;
+    };
+    std::vector<Measurement> measurements;
+    // The lookups add to the `checksum`, s.t. they can't be optimized away.
+    size_t checksum = 0;
+    auto addLookups = [&measurements, &queries, &checksum](
+                          const std::string& layout, const auto& vocabulary,
+                          std::function<void()> prepare) {
+      measurements.push_back(
+          {absl::StrCat(layout, ", word to ID"), prepare,
+           [&vocabulary, &queries, &checksum]() {
+             for (const auto& word : queries.words_) {
+               checksum += vocabulary.lower_bound(word, std::less<>{})._index;
+             }
+           }});
+      measurements.push_back(
+          {absl::StrCat(layout, ", ID to word"), prepare,
+           [&vocabulary, &queries, &checksum]() {
+             for (size_t index : queries.indices_) {
+               checksum += std::string_view{vocabulary[index]}.size();
+             }
+           }});
+      measurements.push_back(
+          {absl::StrCat(layout, ", prefix range"), prepare,
+           [&vocabulary, &queries, &checksum]() {
+             for (const auto& prefix : queries.prefixes_) {
+               // The end of the range is the first word that is not smaller
+               // than the prefix with its last character incremented.
+               std::string end = prefix;
+               ++end.back();
+               checksum +=
+                   vocabulary.lower_bound(end, std::less<>{})._index -
+                   vocabulary.lower_bound(prefix, std::less<>{})._index;
+             }
+           }});
+    };
+    addLookups("In memory", inMemory, {});
+    addLookups("In memory, prefix-compressed", compressed, {});
+    addLookups("Front-coded on disk, cold", frontCoded,
+               [&filename]() { dropFromPageCache(filename); });
+    addLookups("Front-coded on disk, warm", frontCoded, {});
+
+    BenchmarkResults results{};
+    std::vector<std::string> rowNames;
+    for (const auto& measurement : measurements) {
+      rowNames.push_back(measurement.name_);
+    }
+    auto& table = results.addTable("Vocabulary lookups", rowNames,
+                                   {"Layout and lookup", "Time",
+                                    "Lookups per second"});
+    table.metadata().addKeyValuePair("numWords", numWords_);
+    table.metadata().addKeyValuePair("numLookups", numLookups_);
+    for (size_t row = 0; row < measurements.size(); ++row) {
+      auto& measurement = measurements.at(row);
+      if (measurement.prepare_) {
+        measurement.prepare_();
+      }
+      table.addMeasurement(row, 1, measurement.lookups_);
+      auto seconds = std::max(table.getEntry<float>(row, 1), 1e-9f);
+      table.setEntry(row, 2,
+                     static_cast<size_t>(static_cast<float>(numLookups_) /
+                                         seconds));
+    }
+    table.metadata().addKeyValuePair("checksum", checksum);
+
+    frontCoded.close();
+    fs::remove(filename);
+    fs::remove(absl::StrCat(filename, ".blockIndex"));
+    return results;
+  }
+
+ private:
+  // Draw `numLookups_` random words and prefixes from the `words`.
+  Queries makeQueries(const std::vector<std::string>& words) const {
+    ad_utility::FastRandomIntGenerator<size_t> random{
+        ad_utility::RandomSeed::make(42)};
+    Queries queries;
+    for (size_t i = 0; i < numLookups_; ++i) {
+      size_t index = random() % words.size();
+      const auto& word = words.at(index);
+      queries.indices_.push_back(index);
+      queries.words_.push_back(word);
+      // A prefix with two thirds of the word, but at least one character.
+      queries.prefixes_.push_back(
+          word.substr(0, std::max<size_t>(1, 2 * word.size() / 3)));
+    }
+    return queries;
+  }
+};
+AD_REGISTER_BENCHMARK(VocabularyBenchmark);
+}  // namespace ad_benchmark
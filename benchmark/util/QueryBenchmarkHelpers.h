@@ -0,0 +1,76 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <absl/strings/str_cat.h>
+
+#include <functional>
+#include <string>
+
+#include "../test/IndexTestHelpers.h"
+#include "engine/QueryExecutionTree.h"
+#include "engine/QueryPlanner.h"
+#include "parser/SparqlParser.h"
+#include "util/MemorySize/MemorySize.h"
+
+// Helpers for the benchmarks of the operations that are easiest set up via a
+// SPARQL query on a small, synthetic index (see `GroupByBenchmark.cpp` etc.).
+namespace ad_benchmark {
+
+// Return a knowledge graph in the Turtle format with the `numTriples` triples
+// that the `makeTriple` function returns for `0, ..., numTriples - 1`. Each
+// triple must be given without the final dot.
+inline std::string makeTurtle(
+    size_t numTriples, const std::function<std::string(size_t)>& makeTriple) {
+  std::string turtle;
+  for (size_t i = 0; i < numTriples; ++i) {
+    absl::StrAppend(&turtle, makeTriple(i), " .\n");
+  }
+  return turtle;
+}
+
+// The `QueryExecutionContext` of an index for the `turtle`. The index uses
+// blocks of a realistic size (the default of the test indices is tiny).
+inline QueryExecutionContext* getBenchmarkQec(const std::string& turtle) {
+  using namespace ad_utility::memory_literals;
+  return ad_utility::testing::getQec(turtle, true, true, true, 1_MB);
+}
+
+// Plan the SPARQL `query` on the index of the `qec`, s.t. only the time of the
+// computation of its result can be measured (see `computeWithoutCache`).
+inline QueryExecutionTree planQuery(QueryExecutionContext* qec,
+                                    const std::string& query) {
+  QueryPlanner queryPlanner{qec};
+  auto parsedQuery = SparqlParser::parseQuery(query);
+  return queryPlanner.createExecutionTree(parsedQuery);
+}
+
+// Compute the result of the `qet` without reusing any of the results that were
+// cached by earlier computations, and return its number of rows.
+inline size_t computeWithoutCache(QueryExecutionContext* qec,
+                                  const QueryExecutionTree& qet) {
+  qec->clearCacheUnpinnedOnly();
+  return qet.getResult()->size();
+}
+
+// Clear the cache and compute the results of the operations at the `depth`
+// below the root of the `qet` (the children of the root have depth 1). These
+// results are read from the cache when the `qet` is computed next, s.t. only
+// the time of the operations above them is measured.
+inline void precomputeSubtrees(QueryExecutionContext* qec,
+                               const QueryExecutionTree& qet, size_t depth) {
+  qec->clearCacheUnpinnedOnly();
+  std::function<void(const QueryExecutionTree&, size_t)> precompute =
+      [&precompute](const QueryExecutionTree& tree, size_t remainingDepth) {
+        if (remainingDepth == 0) {
+          tree.getResult();
+          return;
+        }
+        for (const auto* child : tree.getRootOperation()->getChildren()) {
+          precompute(*child, remainingDepth - 1);
+        }
+      };
+  precompute(qet, depth);
+}
+}  // namespace ad_benchmark
@@ -0,0 +1,60 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+// Return `numWords` distinct words that resemble the vocabulary of a knowledge
+// graph, sorted by `std::less`: IRIs from a few namespaces with long common
+// prefixes, literals with and without a language tag, and typed literals. The
+// words are the same for the same `seed`.
+inline std::vector<std::string> makeSyntheticVocabulary(
+    size_t numWords, unsigned int seed = 42) {
+  static constexpr std::array namespaces{
+      "<http://www.wikidata.org/entity/Q",
+      "<http://www.wikidata.org/prop/direct/P",
+      "<http://www.wikidata.org/entity/statement/Q",
+      "<http://dbpedia.org/resource/Entity_",
+      "<http://schema.org/",
+      "<https://example.org/some/deeply/nested/path/item"};
+  static constexpr std::array languages{"en", "de", "fr", "zh"};
+  ad_utility::FastRandomIntGenerator<uint64_t> random{
+      ad_utility::RandomSeed::make(seed)};
+  std::vector<std::string> words;
+  words.reserve(numWords);
+  // The index `i` makes the words distinct.
+  for (size_t i = 0; i < numWords; ++i) {
+    uint64_t r = random();
+    switch (r % 8) {
+      case 0:
+        absl::StrAppend(&words.emplace_back(), "\"label ", i, " of ",
+                        r % 100'000, "\"@", languages[(r >> 8) % 4]);
+        break;
+      case 1:
+        absl::StrAppend(&words.emplace_back(), "\"some text with number ", i,
+                        "\"");
+        break;
+      case 2:
+        absl::StrAppend(&words.emplace_back(), "\"", i,
+                        "\"^^<http://www.w3.org/2001/XMLSchema#string>");
+        break;
+      default:
+        absl::StrAppend(&words.emplace_back(),
+                        namespaces[(r >> 8) % namespaces.size()], i, ">");
+    }
+  }
+  std::ranges::sort(words);
+  return words;
+}
+
+}  // namespace ad_benchmark
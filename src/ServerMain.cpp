@@ -88,6 +88,45 @@ int main(int argc, char** argv) {
       "least-recently used non-pinned entries from the cache. Note that "
       "this condition and the size limit specified via --cache-max-size "
       "both have to hold (logical AND).");
+  add("cache-eviction-policy",
+      optionFactory.getProgramOption<"cache-eviction-policy">(),
+      "The policy for evicting entries from the cache: \"lru\" (least "
+      "recently used) or \"gdsf\" (GreedyDual-Size-Frequency, which also "
+      "takes into account how expensive a result was to compute).");
+  add("persistent-cache-directory",
+      optionFactory.getProgramOption<"persistent-cache-directory">(),
+      "If specified, cache entries that are evicted from the cache and pinned "
+      "cache entries are also stored in this directory, s.t. they can be "
+      "reused after a restart of the server.");
+  add("persistent-cache-max-size",
+      optionFactory.getProgramOption<"persistent-cache-max-size">(),
+      "Maximum size of all the entries in the --persistent-cache-directory.");
+  add("cardinality-feedback-file",
+      optionFactory.getProgramOption<"cardinality-feedback-file">(),
+      "If specified, the actual sizes of joins are compared to their "
+      "estimates and the learned corrections are used for the query planning "
+      "of later queries. The corrections are stored in this file, which "
+      "has to be specific to the index.");
+  add("huge-pages-min-size",
+      optionFactory.getProgramOption<"huge-pages-min-size">(),
+      "Large allocations and memory-mapped index files of at least this size "
+      "are backed by transparent huge pages. 0 disables huge pages.");
+  add("numa-aware", optionFactory.getProgramOption<"numa-aware">(),
+      "If true, the index data is interleaved across the NUMA nodes of the "
+      "machine and the threads that compute the queries are pinned to the "
+      "nodes.");
+  add("slow-query-log-file",
+      optionFactory.getProgramOption<"slow-query-log-file">(),
+      "If specified, the queries that take longer than "
+      "--slow-query-log-threshold are logged to this file (one JSON object "
+      "with the plan and the runtime information per line).");
+  add("slow-query-log-threshold",
+      optionFactory.getProgramOption<"slow-query-log-threshold">(),
+      "The minimal time of the queries in the --slow-query-log-file.");
+  add("slow-query-log-sample-rate",
+      optionFactory.getProgramOption<"slow-query-log-sample-rate">(),
+      "The fraction of the faster queries that are also logged to the "
+      "--slow-query-log-file.");
   add("no-patterns,P", po::bool_switch(&noPatterns),
       "Disable the use of patterns. If disabled, the special predicate "
       "`ql:has-predicate` is not available.");
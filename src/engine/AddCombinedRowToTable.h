@@ -178,6 +178,22 @@ class AddCombinedRowToIdTable {
     return std::move(resultTable_);
   }
 
+  // Return the number of rows that have already been written to the result.
+  // Rows that are only stored in the buffers (because `flush()` has not yet
+  // been called) are not counted.
+  size_t numWrittenRows() const { return resultTable_.numRows(); }
+
+  // Move out the rows that have been written so far, such that the result is
+  // empty afterwards and more rows can be added. This is used to consume the
+  // result of a lazy join in blocks. The function ensures that `flush()` is
+  // called before doing so.
+  IdTable moveOutPartialResult() {
+    flush();
+    IdTable result{resultTable_.numColumns(), resultTable_.getAllocator()};
+    std::swap(result, resultTable_);
+    return result;
+  }
+
   // Disable copying and moving, it is currently not needed and makes it harder
   // to reason about
   AddCombinedRowToIdTable(const AddCombinedRowToIdTable&) = delete;
@@ -4,11 +4,11 @@
 
 #include "Bind.h"
 
-#include "engine/CallFixedSize.h"
 #include "engine/QueryExecutionTree.h"
 #include "engine/sparqlExpressions/SparqlExpression.h"
 #include "engine/sparqlExpressions/SparqlExpressionGenerators.h"
 #include "util/Exception.h"
+#include "util/ParallelExecution.h"
 
 // BIND adds exactly one new column
 size_t Bind::getResultWidth() const { return _subtree->getResultWidth() + 1; }
@@ -84,14 +84,14 @@ std::vector<QueryExecutionTree*> Bind::getChildren() {
 }
 
 // _____________________________________________________________________________
-ResultTable Bind::computeResult() {
+ResultTable Bind::computeResult(bool requestLaziness) {
   using std::endl;
   LOG(DEBUG) << "Get input to BIND operation..." << endl;
-  shared_ptr<const ResultTable> subRes = _subtree->getResult();
+  shared_ptr<const ResultTable> subRes = _subtree->getResult(requestLaziness);
   LOG(DEBUG) << "Got input to Bind operation." << endl;
-  IdTable idTable{getExecutionContext()->getAllocator()};
-
-  idTable.setNumColumns(getResultWidth());
+  if (!subRes->isFullyMaterialized()) {
+    return {bindLazily(std::move(subRes)), resultSortedOn()};
+  }
 
   // Make a deep copy of the local vocab from `subRes` and then add to it (in
   // case BIND adds a new word or words).
@@ -101,46 +101,107 @@ ResultTable Bind::computeResult() {
   // `shareLocalVocabFrom`) and only copy it when a new word is about to be
   // added. Same for GROUP BY.
   auto localVocab = subRes->getCopyOfLocalVocab();
-
-  size_t inwidth = subRes->idTable().numColumns();
-  size_t outwidth = getResultWidth();
-
-  CALL_FIXED_SIZE((std::array{inwidth, outwidth}), &Bind::computeExpressionBind,
-                  this, &idTable, &localVocab, *subRes,
-                  _bind._expression.getPimpl());
+  IdTable idTable = computeBindForIdTable(subRes->idTable(),
+                                          subRes->localVocab(), &localVocab);
 
   LOG(DEBUG) << "BIND result computation done." << endl;
   return {std::move(idTable), resultSortedOn(), std::move(localVocab)};
 }
 
 // _____________________________________________________________________________
-template <size_t IN_WIDTH, size_t OUT_WIDTH>
+ResultTable::Generator Bind::bindLazily(
+    std::shared_ptr<const ResultTable> subRes) {
+  for (auto& [inputTable, inputLocalVocab] : subRes->idTables()) {
+    // The local vocab of each input block is typically very small (or empty),
+    // so copying it is cheap.
+    LocalVocab localVocab = inputLocalVocab.clone();
+    IdTable idTable =
+        computeBindForIdTable(inputTable, inputLocalVocab, &localVocab);
+    checkCancellation();
+    co_yield ResultTable::IdTableVocabPair{std::move(idTable),
+                                           std::move(localVocab)};
+  }
+}
+
+// _____________________________________________________________________________
+IdTable Bind::computeBindForIdTable(const IdTable& inputTable,
+                                    const LocalVocab& inputLocalVocab,
+                                    LocalVocab* outputLocalVocab) const {
+  // The columns of the input remain identical. They are shared with the
+  // `inputTable` (see `CopyOnWriteVector`), so only the new column is
+  // allocated.
+  IdTable idTable = inputTable.clone();
+  idTable.addColumn(Id::makeUndefined());
+  AD_CORRECTNESS_CHECK(idTable.numColumns() == getResultWidth());
+  std::span<Id> outputColumn = idTable.getColumn(idTable.numColumns() - 1);
+  const auto* expression = _bind._expression.getPimpl();
+  size_t numRows = inputTable.numRows();
+  size_t morselSize =
+      std::max(RuntimeParameters().get<"expression-morsel-size">(), size_t{1});
+  size_t numThreads = getExecutionContext()->getNumThreads(
+      RuntimeParameters().get<"expression-num-threads">());
+  if (numRows <= morselSize || numThreads <= 1) {
+    computeExpressionBind(outputColumn, outputLocalVocab, inputTable,
+                          inputLocalVocab, expression, 0, numRows);
+    return idTable;
+  }
+
+  // Evaluate the expression for the morsels concurrently. The words that are
+  // created for a morsel are added to a clone of the `outputLocalVocab`, s.t.
+  // the words that are already contained keep their indexes. The new words
+  // are merged into the `outputLocalVocab` afterwards.
+  size_t numMorsels = (numRows + morselSize - 1) / morselSize;
+  std::vector<LocalVocab> morselVocabs;
+  morselVocabs.reserve(numMorsels);
+  for (size_t i = 0; i < numMorsels; ++i) {
+    morselVocabs.push_back(outputLocalVocab->clone());
+  }
+  ad_utility::forEachMorselConcurrently(
+      numRows, morselSize, numThreads,
+      [&](size_t morsel, size_t beginRow, size_t endRow) {
+        computeExpressionBind(outputColumn, &morselVocabs.at(morsel),
+                              inputTable, inputLocalVocab, expression,
+                              beginRow, endRow);
+      });
+  size_t sizeBefore = outputLocalVocab->size();
+  for (size_t morsel = 0; morsel < numMorsels; ++morsel) {
+    const LocalVocab& morselVocab = morselVocabs[morsel];
+    if (morselVocab.size() == sizeBefore) {
+      continue;
+    }
+    auto newIndexes = outputLocalVocab->mergeWith(morselVocab);
+    size_t beginRow = morsel * morselSize;
+    for (Id& id : outputColumn.subspan(
+             beginRow, std::min(morselSize, numRows - beginRow))) {
+      if (id.getDatatype() == Datatype::LocalVocabIndex) {
+        id = Id::makeFromLocalVocabIndex(
+            newIndexes.at(id.getLocalVocabIndex().get()));
+      }
+    }
+  }
+  runtimeInfo().addDetail("num-morsels", numMorsels);
+  return idTable;
+}
+
+// _____________________________________________________________________________
 void Bind::computeExpressionBind(
-    IdTable* outputIdTable, LocalVocab* outputLocalVocab,
-    const ResultTable& inputResultTable,
-    sparqlExpression::SparqlExpression* expression) const {
+    std::span<Id> outputColumn, LocalVocab* outputLocalVocab,
+    const IdTable& inputTable, const LocalVocab& inputLocalVocab,
+    const sparqlExpression::SparqlExpression* expression, size_t beginRow,
+    size_t endRow) const {
   sparqlExpression::EvaluationContext evaluationContext(
-      *getExecutionContext(), _subtree->getVariableColumns(),
-      inputResultTable.idTable(), getExecutionContext()->getAllocator(),
-      inputResultTable.localVocab());
+      *getExecutionContext(), _subtree->getVariableColumns(), inputTable,
+      getExecutionContext()->getAllocator(), inputLocalVocab);
+  AD_CORRECTNESS_CHECK(beginRow <= endRow && endRow <= inputTable.size());
+  AD_CORRECTNESS_CHECK(outputColumn.size() == inputTable.size());
+  evaluationContext._beginIndex = beginRow;
+  evaluationContext._endIndex = endRow;
 
   sparqlExpression::ExpressionResult expressionResult =
       expression->evaluate(&evaluationContext);
 
-  const auto input = inputResultTable.idTable().asStaticView<IN_WIDTH>();
-  auto output = std::move(*outputIdTable).toStatic<OUT_WIDTH>();
-
-  // first initialize the first columns (they remain identical)
-  const auto inSize = input.size();
-  output.reserve(inSize);
-  const auto inCols = input.numColumns();
-  // copy the input to the first numColumns;
-  for (size_t i = 0; i < inSize; ++i) {
-    output.emplace_back();
-    for (size_t j = 0; j < inCols; ++j) {
-      output(i, j) = input(i, j);
-    }
-  }
+  const auto inSize = endRow - beginRow;
+  outputColumn = outputColumn.subspan(beginRow, inSize);
 
   auto visitor = [&]<sparqlExpression::SingleExpressionResult T>(
                      T&& singleResult) mutable {
@@ -150,13 +211,10 @@ void Bind::computeExpressionBind(
     if constexpr (isVariable) {
       auto column =
           getInternallyVisibleVariableColumns().at(singleResult).columnIndex_;
-      for (size_t i = 0; i < inSize; ++i) {
-        output(i, inCols) = output(i, column);
-      }
+      std::ranges::copy(inputTable.getColumn(column).subspan(beginRow, inSize),
+                        outputColumn.begin());
     } else if constexpr (isStrongId) {
-      for (size_t i = 0; i < inSize; ++i) {
-        output(i, inCols) = singleResult;
-      }
+      std::ranges::fill(outputColumn, singleResult);
     } else {
       bool isConstant = sparqlExpression::isConstantResult<T>;
 
@@ -169,15 +227,13 @@ void Bind::computeExpressionBind(
           Id constantId =
               sparqlExpression::detail::constantExpressionResultToId(
                   std::move(*it), *outputLocalVocab);
-          for (size_t i = 0; i < inSize; ++i) {
-            output(i, inCols) = constantId;
-          }
+          std::ranges::fill(outputColumn, constantId);
         }
       } else {
         size_t i = 0;
         // We deliberately move the values from the generator.
         for (auto& resultValue : resultGenerator) {
-          output(i, inCols) =
+          outputColumn[i] =
               sparqlExpression::detail::constantExpressionResultToId(
                   std::move(resultValue), *outputLocalVocab);
           i++;
@@ -187,6 +243,4 @@ void Bind::computeExpressionBind(
   };
 
   std::visit(visitor, std::move(expressionResult));
-
-  *outputIdTable = std::move(output).toDynamic();
 }
@@ -47,14 +47,29 @@ class Bind : public Operation {
   [[nodiscard]] vector<ColumnIndex> resultSortedOn() const override;
 
  private:
-  ResultTable computeResult() override;
+  ResultTable computeResult(bool requestLaziness) override;
 
-  // Implementation for the binding of arbitrary expressions.
-  template <size_t IN_WIDTH, size_t OUT_WIDTH>
+  // Compute the BIND for each block of the lazy `subRes` and yield the
+  // resulting blocks.
+  ResultTable::Generator bindLazily(std::shared_ptr<const ResultTable> subRes);
+
+  // Compute the BIND for the `inputTable` (a complete result or a single block
+  // of a lazy result). Words that are newly created by the expression are added
+  // to the `outputLocalVocab`. Large inputs are split into morsels, for which
+  // the expression is evaluated concurrently (see the runtime parameter
+  // `expression-morsel-size`).
+  IdTable computeBindForIdTable(const IdTable& inputTable,
+                                const LocalVocab& inputLocalVocab,
+                                LocalVocab* outputLocalVocab) const;
+
+  // Implementation for the binding of arbitrary expressions. The values of the
+  // `expression` for the rows `[beginRow, endRow)` of the `inputTable` are
+  // written to the same rows of the `outputColumn`.
   void computeExpressionBind(
-      IdTable* outputIdTable, LocalVocab* outputLocalVocab,
-      const ResultTable& inputResultTable,
-      sparqlExpression::SparqlExpression* expression) const;
+      std::span<Id> outputColumn, LocalVocab* outputLocalVocab,
+      const IdTable& inputTable, const LocalVocab& inputLocalVocab,
+      const sparqlExpression::SparqlExpression* expression, size_t beginRow,
+      size_t endRow) const;
 
   [[nodiscard]] VariableToColumnMap computeVariableToColumnMap() const override;
 };
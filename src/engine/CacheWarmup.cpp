@@ -0,0 +1,190 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/CacheWarmup.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <array>
+#include <atomic>
+#include <fstream>
+
+#include "engine/QueryPlanner.h"
+#include "index/IndexImpl.h"
+#include "parser/SparqlParser.h"
+#include "util/HashMap.h"
+#include "util/Log.h"
+#include "util/ParallelExecution.h"
+#include "util/Timer.h"
+
+namespace {
+using FileRange = CompressedRelationReader::FileRange;
+
+constexpr std::array allPermutations{Permutation::PSO, Permutation::POS,
+                                     Permutation::SPO, Permutation::SOP,
+                                     Permutation::OPS, Permutation::OSP};
+
+// Return the readers of the permutations that are loaded, together with the
+// names of the permutations.
+std::vector<std::pair<std::string_view, const CompressedRelationReader*>>
+getLoadedReaders(const Index& index) {
+  std::vector<std::pair<std::string_view, const CompressedRelationReader*>>
+      readers;
+  for (auto permutation : allPermutations) {
+    const auto& p = index.getImpl().getPermutation(permutation);
+    if (p.isLoaded_) {
+      readers.emplace_back(Permutation::toString(permutation), &p.reader());
+    }
+  }
+  return readers;
+}
+
+// Announce the ranges from the `blocksFile` (lines of the form
+// `<permutation> <offset> <size>`) to the operating system. Return the number
+// of bytes that were announced.
+size_t prefetchRecordedRanges(const Index& index,
+                              const std::string& blocksFile) {
+  std::ifstream in{blocksFile};
+  if (!in) {
+    return 0;
+  }
+  ad_utility::HashMap<std::string, std::vector<FileRange>> ranges;
+  std::string permutation;
+  off_t offset;
+  size_t size;
+  while (in >> permutation >> offset >> size) {
+    ranges[permutation].emplace_back(offset, size);
+  }
+  size_t numBytes = 0;
+  for (const auto& [name, reader] : getLoadedReaders(index)) {
+    auto it = ranges.find(std::string{name});
+    if (it == ranges.end()) {
+      continue;
+    }
+    reader->adviseWillNeed(it->second);
+    for (const auto& range : it->second) {
+      numBytes += range.second;
+    }
+  }
+  return numBytes;
+}
+
+// Write the ranges that the `readers` recorded to the `blocksFile`. If nothing
+// was read (e.g. because all the results were found in the persistent cache),
+// the ranges from the last warm-up are kept.
+void writeRecordedRanges(const auto& readers, const std::string& blocksFile) {
+  std::vector<std::pair<std::string_view, std::vector<FileRange>>> ranges;
+  bool hasRanges = false;
+  for (const auto& [name, reader] : readers) {
+    ranges.emplace_back(name, reader->getRecordedReads());
+    hasRanges |= !ranges.back().second.empty();
+  }
+  if (!hasRanges) {
+    return;
+  }
+  std::ofstream out{blocksFile};
+  if (!out) {
+    LOG(WARN) << "Could not write the ranges of the warm-up to \""
+              << blocksFile << '"' << std::endl;
+    return;
+  }
+  for (const auto& [name, rangesOfPermutation] : ranges) {
+    for (const auto& [offset, size] : rangesOfPermutation) {
+      out << name << ' ' << offset << ' ' << size << '\n';
+    }
+  }
+}
+}  // namespace
+
+namespace cacheWarmup {
+
+// _____________________________________________________________________________
+std::vector<std::string> readQueries(const std::string& queryFile) {
+  std::ifstream in{queryFile};
+  if (!in) {
+    throw std::runtime_error{
+        absl::StrCat("Could not open the warm-up query file \"", queryFile,
+                     "\"")};
+  }
+  std::vector<std::string> queries;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && !line.starts_with('#')) {
+      queries.push_back(std::move(line));
+    }
+  }
+  return queries;
+}
+
+// _____________________________________________________________________________
+size_t computeQueries(const Index& index, QueryResultCache& cache,
+                      const ad_utility::AllocatorWithLimit<Id>& allocator,
+                      const SortPerformanceEstimator& sortPerformanceEstimator,
+                      bool enablePatternTrick,
+                      const std::vector<std::string>& queries, bool pinResults,
+                      size_t numThreads) {
+  std::atomic<size_t> numSuccessful = 0;
+  ad_utility::forEachMorselConcurrently(
+      queries.size(), 1, numThreads, [&](size_t, size_t begin, size_t) {
+        const auto& query = queries[begin];
+        try {
+          QueryExecutionContext qec{index,
+                                    &cache,
+                                    allocator,
+                                    sortPerformanceEstimator,
+                                    [](std::string) {},
+                                    false,
+                                    pinResults};
+          QueryPlanner planner{&qec};
+          planner.setEnablePatternTrick(enablePatternTrick);
+          auto qet =
+              planner.createExecutionTree(SparqlParser::parseQuery(query));
+          qet.isRoot() = true;  // allow pinning of the final result
+          qet.getResult();
+          cache.registerQuery(qet.getCacheKey(), query);
+          ++numSuccessful;
+        } catch (const std::exception& e) {
+          LOG(WARN) << "Warm-up query #" << begin + 1
+                    << " failed: " << e.what() << std::endl;
+        }
+      });
+  return numSuccessful;
+}
+
+// _____________________________________________________________________________
+size_t run(const Index& index, QueryResultCache& cache,
+           const ad_utility::AllocatorWithLimit<Id>& allocator,
+           const SortPerformanceEstimator& sortPerformanceEstimator,
+           bool enablePatternTrick, const std::string& queryFile,
+           const std::string& blocksFile, size_t numThreads) {
+  ad_utility::Timer timer{ad_utility::Timer::Started};
+  auto queries = readQueries(queryFile);
+  LOG(INFO) << "Warming up the cache with " << queries.size()
+            << " queries from \"" << queryFile << "\" ..." << std::endl;
+  size_t numPrefetchedBytes = prefetchRecordedRanges(index, blocksFile);
+  if (numPrefetchedBytes > 0) {
+    LOG(INFO) << "Prefetching "
+              << ad_utility::MemorySize::bytes(numPrefetchedBytes).asString()
+              << " of the index that were read by the last warm-up"
+              << std::endl;
+  }
+
+  auto readers = getLoadedReaders(index);
+  for (const auto& [name, reader] : readers) {
+    reader->setRecordReads(true);
+  }
+  size_t numSuccessful =
+      computeQueries(index, cache, allocator, sortPerformanceEstimator,
+                     enablePatternTrick, queries, true, numThreads);
+  for (const auto& [name, reader] : readers) {
+    reader->setRecordReads(false);
+  }
+  writeRecordedRanges(readers, blocksFile);
+
+  LOG(INFO) << "Warm-up done, " << numSuccessful << " of " << queries.size()
+            << " queries were computed successfully in "
+            << ad_utility::Timer::toSeconds(timer.value()) << " s"
+            << std::endl;
+  return numSuccessful;
+}
+}  // namespace cacheWarmup
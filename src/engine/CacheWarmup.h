@@ -0,0 +1,53 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "engine/QueryExecutionContext.h"
+#include "engine/SortPerformanceEstimator.h"
+#include "index/Index.h"
+#include "util/AllocatorWithLimit.h"
+
+// Warm up a freshly started server, s.t. the first users don't have to wait
+// until the results of frequent queries are recomputed and the pages of the
+// index are read from disk:
+//
+// 1. The ranges of the permutation files that were read by the warm-up
+//    queries during the last warm-up are read from the `blocksFile` and
+//    announced to the operating system (`posix_fadvise(POSIX_FADV_WILLNEED)`),
+//    s.t. it reads them into the page cache in the background.
+// 2. The queries from the `queryFile` are computed concurrently and their
+//    results are pinned in the cache.
+// 3. The ranges that were read by the queries are written to the `blocksFile`
+//    for the next warm-up.
+//
+// The ranges are only valid for the index that they were recorded with, but a
+// stale `blocksFile` (e.g. after rebuilding the index) only affects the
+// performance of the warm-up, never the results.
+namespace cacheWarmup {
+
+// Return the queries from the `queryFile`, one query per line. Empty lines and
+// lines that start with `#` are skipped.
+std::vector<std::string> readQueries(const std::string& queryFile);
+
+// Compute the `queries` on `numThreads` threads and store their results in
+// the `cache` (pinned if `pinResults` is set). A query that fails is only
+// logged. Return the number of queries that were computed successfully.
+size_t computeQueries(const Index& index, QueryResultCache& cache,
+                      const ad_utility::AllocatorWithLimit<Id>& allocator,
+                      const SortPerformanceEstimator& sortPerformanceEstimator,
+                      bool enablePatternTrick,
+                      const std::vector<std::string>& queries, bool pinResults,
+                      size_t numThreads);
+
+// Run the warm-up as described above on `numThreads` threads. Return the
+// number of queries that were computed successfully.
+size_t run(const Index& index, QueryResultCache& cache,
+           const ad_utility::AllocatorWithLimit<Id>& allocator,
+           const SortPerformanceEstimator& sortPerformanceEstimator,
+           bool enablePatternTrick, const std::string& queryFile,
+           const std::string& blocksFile, size_t numThreads);
+}  // namespace cacheWarmup
@@ -0,0 +1,133 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "engine/CardinalityFeedback.h"
+
+#include <absl/strings/str_split.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+#include "util/Log.h"
+
+// _____________________________________________________________________________
+void CardinalityFeedback::record(const std::string& signature,
+                                 double estimatedSize, double actualSize) {
+  // Add one to both sizes, s.t. empty results have a finite ratio.
+  double logRatio = std::log((actualSize + 1) / (estimatedSize + 1));
+  const double maxLogFactor = std::log(MAX_FACTOR);
+  auto lock = state_.wlock();
+  if (!lock->file_.has_value()) {
+    return;
+  }
+  auto [it, isNew] = lock->entries_.try_emplace(signature, Entry{logRatio, 0});
+  auto& entry = it->second;
+  if (!isNew) {
+    entry.logFactor_ = (1 - WEIGHT_OF_NEW_OBSERVATION) * entry.logFactor_ +
+                       WEIGHT_OF_NEW_OBSERVATION * logRatio;
+  }
+  entry.logFactor_ = std::clamp(entry.logFactor_, -maxLogFactor, maxLogFactor);
+  ++entry.numObservations_;
+  ++lock->numObservationsSinceLastWrite_;
+  if (lock->numObservationsSinceLastWrite_ >= NUM_OBSERVATIONS_BETWEEN_WRITES) {
+    lock->numObservationsSinceLastWrite_ = 0;
+    writeToFile(*lock);
+  }
+}
+
+// _____________________________________________________________________________
+std::optional<double> CardinalityFeedback::getCorrectionFactor(
+    const std::string& signature) const {
+  auto lock = state_.rlock();
+  if (!lock->file_.has_value()) {
+    return std::nullopt;
+  }
+  auto it = lock->entries_.find(signature);
+  if (it == lock->entries_.end()) {
+    return std::nullopt;
+  }
+  return std::exp(it->second.logFactor_);
+}
+
+// _____________________________________________________________________________
+void CardinalityFeedback::setFile(std::filesystem::path file) {
+  auto lock = state_.wlock();
+  std::ifstream in{file};
+  std::string line;
+  size_t numRead = 0;
+  while (std::getline(in, line)) {
+    std::vector<std::string> fields = absl::StrSplit(line, '\t');
+    double factor = 0;
+    size_t numObservations = 0;
+    try {
+      if (fields.size() == 3) {
+        factor = std::stod(fields[1]);
+        numObservations = std::stoul(fields[2]);
+      }
+    } catch (const std::exception&) {
+      // `factor` stays zero, s.t. the line is ignored below.
+    }
+    if (!(factor > 0)) {
+      LOG(WARN) << "Ignoring the invalid line \"" << line
+                << "\" of the cardinality feedback file " << file << std::endl;
+      continue;
+    }
+    lock->entries_[fields[0]] = Entry{std::log(factor), numObservations};
+    ++numRead;
+  }
+  LOG(INFO) << "Read " << numRead << " cardinality corrections from " << file
+            << std::endl;
+  lock->file_ = std::move(file);
+}
+
+// _____________________________________________________________________________
+void CardinalityFeedback::writeToFile() const { writeToFile(*state_.rlock()); }
+
+// _____________________________________________________________________________
+void CardinalityFeedback::writeToFile(const State& state) {
+  if (!state.file_.has_value()) {
+    return;
+  }
+  // Write to a temporary file first, s.t. the file is never incomplete.
+  const auto& file = state.file_.value();
+  auto tmpFile = file;
+  tmpFile += ".tmp";
+  {
+    std::ofstream out{tmpFile};
+    for (const auto& [signature, entry] : state.entries_) {
+      out << signature << '\t' << std::exp(entry.logFactor_) << '\t'
+          << entry.numObservations_ << '\n';
+    }
+    if (!out) {
+      LOG(WARN) << "Could not write the cardinality feedback to " << tmpFile
+                << std::endl;
+      return;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(tmpFile, file, error);
+  if (error) {
+    LOG(WARN) << "Could not write the cardinality feedback to " << file << ": "
+              << error.message() << std::endl;
+  }
+}
+
+// _____________________________________________________________________________
+void CardinalityFeedback::clear() {
+  auto lock = state_.wlock();
+  lock->entries_.clear();
+  lock->numObservationsSinceLastWrite_ = 0;
+}
+
+// _____________________________________________________________________________
+size_t CardinalityFeedback::numSignatures() const {
+  return state_.rlock()->entries_.size();
+}
+
+// _____________________________________________________________________________
+CardinalityFeedback& getCardinalityFeedback() {
+  static CardinalityFeedback feedback;
+  return feedback;
+}
@@ -0,0 +1,90 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "util/HashMap.h"
+#include "util/Synchronized.h"
+
+// Corrections for the size estimates of the query planner that are learned
+// from the actual sizes of the results of previous queries. Each observation
+// belongs to a signature that describes a class of operations independent of
+// the concrete query, e.g. a join of the scans of two particular predicates
+// (see `Join::getCardinalityFeedbackSignature`). The correction factor of a
+// signature is the exponential moving average (in log space) of the ratios
+// `actualSize / estimatedSize` of its observations.
+//
+// The feedback is only recorded and applied after a file was set (see
+// `setFile`). The factors are read from this file and periodically written
+// back to it, s.t. they survive a restart of the server. Each line of the file
+// has the format `<signature>\t<factor>\t<count>`.
+//
+// This class is threadsafe.
+class CardinalityFeedback {
+ public:
+  // The weight of a new observation in the moving average.
+  static constexpr double WEIGHT_OF_NEW_OBSERVATION = 0.3;
+  // The factors are clamped to [1 / MAX_FACTOR, MAX_FACTOR].
+  static constexpr double MAX_FACTOR = 1e6;
+  // The factors are written to the file after this many observations.
+  static constexpr size_t NUM_OBSERVATIONS_BETWEEN_WRITES = 100;
+
+  // The information that an operation provides s.t. its actual size can be
+  // recorded (see `Operation::getCardinalityFeedbackEstimate`).
+  struct Estimate {
+    std::string signature_;
+    // The size estimate without the correction from this class.
+    double uncorrectedSizeEstimate_;
+  };
+
+ private:
+  struct Entry {
+    double logFactor_;
+    size_t numObservations_;
+  };
+  struct State {
+    ad_utility::HashMap<std::string, Entry> entries_;
+    std::optional<std::filesystem::path> file_;
+    size_t numObservationsSinceLastWrite_ = 0;
+  };
+  ad_utility::Synchronized<State> state_;
+
+ public:
+  // Return true iff a file was set, i.e. iff feedback is recorded and applied.
+  bool isEnabled() const { return state_.rlock()->file_.has_value(); }
+
+  // Record that an operation with the `signature` was estimated to have
+  // `estimatedSize` rows (without the correction from this class), but
+  // actually had `actualSize` rows.
+  void record(const std::string& signature, double estimatedSize,
+              double actualSize);
+
+  // The factor by which size estimates for the `signature` should be
+  // multiplied, or `std::nullopt` if nothing was recorded for it or if the
+  // feedback is not enabled.
+  std::optional<double> getCorrectionFactor(const std::string& signature) const;
+
+  // Read the factors from the `file` (if it exists) and write them to it from
+  // now on. Previously recorded factors are overwritten by the ones from the
+  // file.
+  void setFile(std::filesystem::path file);
+
+  // Write all the factors to the file (if one was set).
+  void writeToFile() const;
+
+  // Delete all the factors (but not the file). Note that the factors are
+  // written to the file (if one is set) only with the next observations.
+  void clear();
+
+  size_t numSignatures() const;
+
+ private:
+  static void writeToFile(const State& state);
+};
+
+// Return the instance that is shared by all queries.
+CardinalityFeedback& getCardinalityFeedback();
@@ -8,8 +8,12 @@
 
 // ____________________________________________________________________________
 CartesianProductJoin::CartesianProductJoin(
-    QueryExecutionContext* executionContext, Children children)
-    : Operation{executionContext}, children_{std::move(children)} {
+    QueryExecutionContext* executionContext, Children children,
+    size_t chunkSize)
+    : Operation{executionContext},
+      children_{std::move(children)},
+      chunkSize_{chunkSize} {
+  AD_CONTRACT_CHECK(chunkSize_ > 0);
   AD_CONTRACT_CHECK(!children_.empty());
   AD_CONTRACT_CHECK(std::ranges::all_of(
       children_, [](auto& child) { return child != nullptr; }));
@@ -132,24 +136,27 @@ void CartesianProductJoin::writeResultColumn(std::span<Id> targetColumn,
   }
 }
 // ____________________________________________________________________________
-ResultTable CartesianProductJoin::computeResult() {
-  IdTable result{getExecutionContext()->getAllocator()};
-  result.setNumColumns(getResultWidth());
-  std::vector<std::shared_ptr<const ResultTable>> subResults;
-
-  // We don't need to fully materialize the child results if we have a LIMIT
-  // specified and an OFFSET of 0.
-  // TODO<joka921> We could in theory also apply this optimization if a
-  // non-zero OFFSET is specified, but this would make the algorithm more
-  // complicated.
-  std::optional<LimitOffsetClause> limitIfPresent = getLimit();
-  if (!getLimit()._limit.has_value() || getLimit()._offset != 0) {
-    limitIfPresent = std::nullopt;
+std::vector<std::shared_ptr<const ResultTable>>
+CartesianProductJoin::calculateSubResults() {
+  // We don't need to fully materialize the child results if we have a LIMIT.
+  // The rows of the first input vary the fastest in the result, so the first
+  // `limit + offset` rows of the result only depend on the first rows of each
+  // child (see below).
+  std::optional<LimitOffsetClause> limitIfPresent;
+  if (getLimit()._limit.has_value()) {
+    limitIfPresent = LimitOffsetClause{
+        getLimit()._limit.value() + getLimit()._offset, 0, 0};
   }
 
-  // Get all child results (possibly with limit, see above).
+  if (!limitIfPresent.has_value()) {
+    // Without a limit, all the child results are needed (unless one of them
+    // is empty), so they are computed concurrently.
+    return getChildResults(children_);
+  }
+  std::vector<std::shared_ptr<const ResultTable>> subResults;
+  // Get all child results with limit (see above).
   for (auto& child : childView()) {
-    if (limitIfPresent.has_value() && child.supportsLimit()) {
+    if (child.supportsLimit()) {
       child.setLimit(limitIfPresent.value());
     }
     subResults.push_back(child.getResult());
@@ -158,14 +165,71 @@ ResultTable CartesianProductJoin::computeResult() {
       break;
     }
     // Example for the following calculation: If we have a LIMIT of 1000 and
-    // the first child already has a result of size 100, then the second child
-    // needs to evaluate only its first 10 results. The +1 is because integer
-    // divisions are rounded down by default.
-    if (limitIfPresent.has_value()) {
-      limitIfPresent.value()._limit =
-          limitIfPresent.value()._limit.value() / subResults.back()->size() + 1;
+    // the first child already has a result of size 100, then the second
+    // child needs to evaluate only its first 10 results. The +1 is because
+    // integer divisions are rounded down by default.
+    limitIfPresent.value()._limit =
+        limitIfPresent.value()._limit.value() / subResults.back()->size() + 1;
+  }
+  return subResults;
+}
+
+// ____________________________________________________________________________
+IdTable CartesianProductJoin::writeResultBlock(
+    const std::vector<std::shared_ptr<const ResultTable>>& subResults,
+    size_t offset, size_t numRows) {
+  IdTable result{getExecutionContext()->getAllocator()};
+  result.setNumColumns(getResultWidth());
+  result.resize(numRows);
+  if (numRows == 0) {
+    return result;
+  }
+  // A `groupSize` of N means that each row of the current result is copied N
+  // times adjacent to each other.
+  size_t groupSize = 1;
+  // The index of the next column in the output that hasn't been written so
+  // far.
+  size_t resultColIdx = 0;
+  for (auto& subResultPtr : subResults) {
+    const auto& input = subResultPtr->idTable();
+    for (const auto& inputCol : input.getColumns()) {
+      decltype(auto) resultCol = result.getColumn(resultColIdx);
+      ad_utility::callFixedSize(groupSize, [&]<size_t I>() {
+        writeResultColumn<I>(resultCol, inputCol, groupSize, offset);
+      });
+      ++resultColIdx;
     }
+    groupSize *= input.numRows();
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+ResultTable::Generator CartesianProductJoin::produceTablesLazily(
+    std::vector<std::shared_ptr<const ResultTable>> subResults, size_t offset,
+    size_t numRows) {
+  // At most one of the child results has a non-empty local vocab (see
+  // `ResultTable::getSharedLocalVocabFromNonEmptyOf`), each block gets a copy
+  // of it.
+  LocalVocab localVocab;
+  auto nonEmptyVocab = std::ranges::find_if(subResults, [](const auto& result) {
+    return !result->localVocab().empty();
+  });
+  if (nonEmptyVocab != subResults.end()) {
+    localVocab = (*nonEmptyVocab)->localVocab().clone();
   }
+  for (size_t start = 0; start < numRows; start += chunkSize_) {
+    size_t blockSize = std::min(chunkSize_, numRows - start);
+    co_yield ResultTable::IdTableVocabPair{
+        writeResultBlock(subResults, offset + start, blockSize),
+        localVocab.clone()};
+  }
+}
+
+// ____________________________________________________________________________
+ResultTable CartesianProductJoin::computeResult(bool requestLaziness) {
+  std::vector<std::shared_ptr<const ResultTable>> subResults =
+      calculateSubResults();
 
   auto sizesView = std::views::transform(
       subResults, [](const auto& child) { return child->size(); });
@@ -175,27 +239,16 @@ ResultTable CartesianProductJoin::computeResult() {
   size_t totalSizeIncludingLimit = getLimit().actualSize(totalResultSize);
   size_t offset = getLimit().actualOffset(totalResultSize);
 
-  result.resize(totalSizeIncludingLimit);
-
-  if (totalSizeIncludingLimit != 0) {
-    // A `groupSize` of N means that each row of the current result is copied N
-    // times adjacent to each other.
-    size_t groupSize = 1;
-    // The index of the next column in the output that hasn't been written so
-    // far.
-    size_t resultColIdx = 0;
-    for (auto& subResultPtr : subResults) {
-      const auto& input = subResultPtr->idTable();
-      for (const auto& inputCol : input.getColumns()) {
-        decltype(auto) resultCol = result.getColumn(resultColIdx);
-        ad_utility::callFixedSize(groupSize, [&]<size_t I>() {
-          writeResultColumn<I>(resultCol, inputCol, groupSize, offset);
-        });
-        ++resultColIdx;
-      }
-      groupSize *= input.numRows();
-    }
+  // Only the rows of the LIMIT/OFFSET window are computed, directly from the
+  // rows of the children. Large results are yielded in blocks of `chunkSize_`
+  // rows if laziness is requested.
+  if (requestLaziness && totalSizeIncludingLimit > chunkSize_) {
+    return {produceTablesLazily(std::move(subResults), offset,
+                                totalSizeIncludingLimit),
+            resultSortedOn()};
   }
+  IdTable result =
+      writeResultBlock(subResults, offset, totalSizeIncludingLimit);
 
   // Dereference all the subresult pointers because `getSharedLocalVocabFrom...`
   // requires a range of references, not pointers.
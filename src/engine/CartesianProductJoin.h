@@ -9,14 +9,17 @@
 #include "engine/QueryExecutionTree.h"
 
 // An operation that takes a set of subresults that pairwise-disjoint sets of
-// bound variables and materializes the full Cartesian product of these
-// operations.
+// bound variables and computes the Cartesian product of these operations.
+// Only the rows of the LIMIT/OFFSET window of the result are computed, and
+// large results can be yielded lazily in blocks.
 class CartesianProductJoin : public Operation {
  public:
   using Children = std::vector<std::shared_ptr<QueryExecutionTree>>;
 
  private:
   Children children_;
+  // The number of rows of each block of a lazily computed result.
+  size_t chunkSize_;
 
   // Access to the actual operations of the children.
   // TODO<joka921> We can move this whole children management into a base class
@@ -35,9 +38,12 @@ class CartesianProductJoin : public Operation {
 
  public:
   // Constructor. `children` must not be empty and the variables of all the
-  // children must be disjoint, else an `AD_CONTRACT_CHECK` fails.
+  // children must be disjoint, else an `AD_CONTRACT_CHECK` fails. If laziness
+  // is requested, results with more than `chunkSize` rows are yielded in
+  // blocks of `chunkSize` rows.
   explicit CartesianProductJoin(QueryExecutionContext* executionContext,
-                                Children children);
+                                Children children,
+                                size_t chunkSize = 1'000'000);
 
   /// get non-owning pointers to all the held subtrees to actually use the
   /// Execution Trees as trees
@@ -79,7 +85,24 @@ class CartesianProductJoin : public Operation {
 
  private:
   //! Compute the result of the query-subtree rooted at this element..
-  ResultTable computeResult() override;
+  ResultTable computeResult(bool requestLaziness) override;
+
+  // Compute the results of the children. If a LIMIT is present, the children
+  // are computed one after the other and with a LIMIT, s.t. only the rows that
+  // are needed for the first `limit + offset` rows of the result are computed.
+  std::vector<std::shared_ptr<const ResultTable>> calculateSubResults();
+
+  // Write the `numRows` rows of the Cartesian product of the `subResults` that
+  // start at row `offset` of the product to a new `IdTable`.
+  IdTable writeResultBlock(
+      const std::vector<std::shared_ptr<const ResultTable>>& subResults,
+      size_t offset, size_t numRows);
+
+  // Yield the `numRows` rows of the Cartesian product of the `subResults` that
+  // start at row `offset` in blocks of `chunkSize_` rows.
+  ResultTable::Generator produceTablesLazily(
+      std::vector<std::shared_ptr<const ResultTable>> subResults,
+      size_t offset, size_t numRows);
 
   // Copy each element from the `inputColumn` `groupSize` times to the
   // `targetColumn`. Repeat until the `targetColumn` is copletely filled. Skip
@@ -39,7 +39,8 @@ bool isVariableContainedInGraphPatternOperation(
     using T = std::decay_t<decltype(arg)>;
     if constexpr (std::is_same_v<T, p::Optional> ||
                   std::is_same_v<T, p::GroupGraphPattern> ||
-                  std::is_same_v<T, p::Minus>) {
+                  std::is_same_v<T, p::Minus> ||
+                  std::is_same_v<T, p::ExistsFilter>) {
       return check(arg._child);
     } else if constexpr (std::is_same_v<T, p::Union>) {
       return check(arg._child1) || check(arg._child2);
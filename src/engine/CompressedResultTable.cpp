@@ -0,0 +1,77 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/CompressedResultTable.h"
+
+#include <algorithm>
+
+#include "util/Exception.h"
+#include "util/ParallelExecution.h"
+
+namespace {
+// Call `function(col, block)` for each block of each column of a table with
+// `numColumns` columns and `numBlocks` blocks per column. The pairs are
+// distributed among `CompressedResultTable::NUM_THREADS` threads.
+void forEachBlockConcurrently(size_t numColumns, size_t numBlocks,
+                              const auto& function) {
+  size_t numTasks = numColumns * numBlocks;
+  size_t numThreads =
+      std::clamp(numTasks, size_t{1}, CompressedResultTable::NUM_THREADS);
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    for (size_t task = threadIdx; task < numTasks; task += numThreads) {
+      function(task / numBlocks, task % numBlocks);
+    }
+  });
+}
+
+// The rows of the `column` that belong to its `block`-th block.
+template <typename T>
+std::span<T> getBlock(std::span<T> column, size_t block) {
+  constexpr size_t blockSize = CompressedResultTable::BLOCK_SIZE;
+  size_t begin = block * blockSize;
+  return column.subspan(begin, std::min(blockSize, column.size() - begin));
+}
+}  // namespace
+
+// _____________________________________________________________________________
+CompressedResultTable::CompressedResultTable(const ResultTable& result)
+    : numRows_{result.size()},
+      numColumns_{result.width()},
+      blocks_(numColumns_),
+      emptyResult_{IdTable{numColumns_, result.idTable().getAllocator()},
+                   result.sortedBy(), result.getSharedLocalVocab()} {
+  const IdTable& idTable = result.idTable();
+  size_t numBlocks = (numRows_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  for (auto& blocksOfColumn : blocks_) {
+    blocksOfColumn.resize(numBlocks);
+  }
+  forEachBlockConcurrently(
+      numColumns_, numBlocks, [this, &idTable](size_t col, size_t block) {
+        auto [codec, data] = columnCodec::encodeWithBestCodec(
+            getBlock(idTable.getColumn(col), block));
+        blocks_[col][block] = CompressedBlock{codec, std::move(data)};
+      });
+  size_t numBytes = 0;
+  for (const auto& blocksOfColumn : blocks_) {
+    for (const auto& block : blocksOfColumn) {
+      numBytes += block.data_.size();
+    }
+  }
+  compressedSize_ = ad_utility::MemorySize::bytes(numBytes);
+}
+
+// _____________________________________________________________________________
+ResultTable CompressedResultTable::decompress(
+    const ad_utility::AllocatorWithLimit<Id>& allocator) const {
+  IdTable idTable{numColumns_, allocator};
+  idTable.resize(numRows_);
+  size_t numBlocks = numColumns_ == 0 ? 0 : blocks_.at(0).size();
+  forEachBlockConcurrently(
+      numColumns_, numBlocks, [this, &idTable](size_t col, size_t block) {
+        const auto& compressedBlock = blocks_[col][block];
+        columnCodec::decode(compressedBlock.codec_, compressedBlock.data_,
+                            getBlock(idTable.getColumn(col), block));
+      });
+  return {std::move(idTable), emptyResult_.sortedBy(),
+          emptyResult_.getSharedLocalVocab()};
+}
@@ -0,0 +1,55 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "engine/ResultTable.h"
+#include "index/ColumnCodec.h"
+#include "util/AllocatorWithLimit.h"
+#include "util/MemorySize/MemorySize.h"
+
+// A fully materialized `ResultTable` whose `IdTable` is stored in compressed
+// form, which is used for the entries of the `QueryResultCache` if the runtime
+// parameter `compress-cached-results` is set. Each column is split into blocks
+// of `BLOCK_SIZE` rows, and each block is compressed with the codec that is
+// best for it (see `columnCodec::encodeWithBestCodec`). Sorted columns of IDs,
+// which are typical for intermediate results, are thus stored with only a few
+// bits per entry. The blocks are compressed and decompressed concurrently.
+class CompressedResultTable {
+ public:
+  // The number of rows of the blocks that are compressed separately.
+  static constexpr size_t BLOCK_SIZE = 1 << 16;
+  // The number of threads for the compression and the decompression.
+  static constexpr size_t NUM_THREADS = 4;
+
+ private:
+  struct CompressedBlock {
+    ColumnCodec codec_;
+    std::vector<char> data_;
+  };
+  size_t numRows_;
+  size_t numColumns_;
+  // `blocks_[col][i]` is the `i`-th block of the column `col`.
+  std::vector<std::vector<CompressedBlock>> blocks_;
+  // An empty result that has the same local vocabulary and the same sorting as
+  // the original result. The decompressed results share them.
+  ResultTable emptyResult_;
+  ad_utility::MemorySize compressedSize_;
+
+ public:
+  // Compress the `result`, which must be fully materialized.
+  explicit CompressedResultTable(const ResultTable& result);
+
+  // Return the decompressed result, allocated with the `allocator`.
+  ResultTable decompress(const ad_utility::AllocatorWithLimit<Id>& allocator)
+      const;
+
+  size_t numRows() const { return numRows_; }
+  size_t numColumns() const { return numColumns_; }
+
+  // The memory that is occupied by the compressed blocks.
+  ad_utility::MemorySize compressedSize() const { return compressedSize_; }
+};
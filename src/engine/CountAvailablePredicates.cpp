@@ -5,6 +5,9 @@
 #include "./CountAvailablePredicates.h"
 
 #include "./CallFixedSize.h"
+#include "./IndexScan.h"
+#include "global/Constants.h"
+#include "util/ParallelExecution.h"
 
 // _____________________________________________________________________________
 CountAvailablePredicates::CountAvailablePredicates(QueryExecutionContext* qec,
@@ -77,6 +80,9 @@ float CountAvailablePredicates::getMultiplicity([[maybe_unused]] size_t col) {
 
 // _____________________________________________________________________________
 uint64_t CountAvailablePredicates::getSizeEstimateBeforeLimit() {
+  if (const auto* counts = getPrecomputedCounts()) {
+    return counts->size();
+  }
   if (_subtree.get() != nullptr) {
     // Predicates are only computed for entities in the subtrees result.
 
@@ -96,6 +102,10 @@ uint64_t CountAvailablePredicates::getSizeEstimateBeforeLimit() {
 
 // _____________________________________________________________________________
 size_t CountAvailablePredicates::getCostEstimate() {
+  if (const auto* counts = getPrecomputedCounts()) {
+    // The subtree is not computed.
+    return counts->size();
+  }
   if (_subtree.get() != nullptr) {
     // Without knowing the ratio of elements that will have a pattern assuming
     // constant cost per entry should be reasonable (altough non distinct
@@ -108,18 +118,28 @@ size_t CountAvailablePredicates::getCostEstimate() {
 }
 
 // _____________________________________________________________________________
-ResultTable CountAvailablePredicates::computeResult() {
+ResultTable CountAvailablePredicates::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
   LOG(DEBUG) << "CountAvailablePredicates result computation..." << std::endl;
   IdTable idTable{getExecutionContext()->getAllocator()};
   idTable.setNumColumns(2);
 
-  const std::vector<PatternID>& hasPattern =
+  const CompressedPatternIds& hasPattern =
       _executionContext->getIndex().getHasPattern();
   const CompactVectorOfStrings<Id>& hasPredicate =
       _executionContext->getIndex().getHasPredicate();
   const CompactVectorOfStrings<Id>& patterns =
       _executionContext->getIndex().getPatterns();
 
+  if (const auto* counts = getPrecomputedCounts()) {
+    _subtree->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+    runtimeInfo().addDetail("precomputed", true);
+    idTable.reserve(counts->size());
+    for (const auto& [predicate, count] : *counts) {
+      idTable.push_back({predicate, Id::makeFromInt(count)});
+    }
+    return {std::move(idTable), resultSortedOn(), LocalVocab{}};
+  }
   if (_subtree == nullptr) {
     // Compute the predicates for all entities
     CountAvailablePredicates::computePatternTrickAllEntities(
@@ -139,70 +159,157 @@ ResultTable CountAvailablePredicates::computeResult() {
   }
 }
 
-void CountAvailablePredicates::computePatternTrickAllEntities(
-    IdTable* dynResult, const vector<PatternID>& hasPattern,
+// _____________________________________________________________________________
+const PatternTrickAggregates::PredicateCounts*
+CountAvailablePredicates::getPrecomputedCounts() const {
+  if (_subtree == nullptr) {
+    return nullptr;
+  }
+  auto* scan = dynamic_cast<IndexScan*>(_subtree->getRootOperation().get());
+  // The precomputed counts don't reflect inserted or deleted triples.
+  if (scan == nullptr || scan->numVariables() != 1 ||
+      !scan->getSubject().isVariable() || scan->getResultWidth() != 1 ||
+      scan->hasDeltaTriples()) {
+    return nullptr;
+  }
+  const auto& index = getIndex();
+  if (index.getPatternTrickAggregates().empty()) {
+    return nullptr;
+  }
+  auto predicate = scan->getPredicate().toValueId(index.getVocab());
+  auto object = scan->getObject().toValueId(index.getVocab());
+  if (!predicate.has_value() || !object.has_value()) {
+    return nullptr;
+  }
+  return index.getPatternTrickAggregates().get(predicate.value(),
+                                               object.value());
+}
+
+namespace {
+// The counts of the pattern trick for a range of entities.
+struct PatternTrickCounts {
+  // The number of entities with each pattern, indexed by the pattern id.
+  std::vector<size_t> patternCounts_;
+  // The counts of the predicates of the entities without a pattern.
+  ad_utility::HashMap<Id, size_t> predicateCounts_;
+  // The number of entities that have a pattern.
+  size_t numEntitiesWithPatterns_ = 0;
+  // The number of predicates counted without patterns.
+  size_t numListPredicates_ = 0;
+};
+
+// The number of threads for the pattern trick on `numItems` items. Each thread
+// processes at least `minNumItemsPerThread` items.
+size_t getNumThreadsForPatternTrick(size_t numItems) {
+  static constexpr size_t minNumItemsPerThread = 100'000;
+  size_t maxNumThreads = std::max(
+      size_t{1}, RuntimeParameters().get<"pattern-trick-num-threads">());
+  return std::clamp(numItems / minNumItemsPerThread, size_t{1}, maxNumThreads);
+}
+
+// Count the patterns and the predicates of the entities `getEntity(i)` for all
+// `i` in `[0, numRows)`, where `getEntity` returns `std::nullopt` for rows that
+// are to be skipped. Contiguous ranges of the rows are processed on separate
+// threads, each of which counts the patterns in a dense array indexed by the
+// pattern id. The counts of the threads are merged at the end.
+PatternTrickCounts countPatternsAndPredicates(
+    size_t numRows, const auto& getEntity,
+    const CompressedPatternIds& hasPattern,
     const CompactVectorOfStrings<Id>& hasPredicate,
     const CompactVectorOfStrings<Id>& patterns) {
-  IdTableStatic<2> result = std::move(*dynResult).toStatic<2>();
-  LOG(DEBUG) << "For all entities." << std::endl;
-  ad_utility::HashMap<Id, size_t> predicateCounts;
-  ad_utility::HashMap<size_t, size_t> patternCounts;
-
-  size_t maxId = std::max(hasPattern.size(), hasPredicate.size());
-  for (size_t i = 0; i < maxId; i++) {
-    if (i < hasPattern.size() && hasPattern[i] != NO_PATTERN) {
-      patternCounts[hasPattern[i]]++;
-    } else if (i < hasPredicate.size()) {
-      auto predicates = hasPredicate[i];
-      for (const auto& predicate : predicates) {
-        auto it = predicateCounts.find(predicate);
-        if (it == predicateCounts.end()) {
-          predicateCounts[predicate] = 1;
-        } else {
-          it->second++;
+  size_t numThreads = getNumThreadsForPatternTrick(numRows);
+  size_t chunkSize = numRows / numThreads + 1;
+  std::vector<PatternTrickCounts> countsPerThread(numThreads);
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    PatternTrickCounts& counts = countsPerThread[threadIdx];
+    counts.patternCounts_.resize(patterns.size());
+    size_t end = std::min(numRows, (threadIdx + 1) * chunkSize);
+    for (size_t i = threadIdx * chunkSize; i < end; ++i) {
+      std::optional<size_t> entity = getEntity(i);
+      if (!entity.has_value()) {
+        continue;
+      }
+      size_t subject = entity.value();
+      if (subject < hasPattern.size() && hasPattern[subject] != NO_PATTERN) {
+        ++counts.patternCounts_[hasPattern[subject]];
+        ++counts.numEntitiesWithPatterns_;
+      } else if (subject < hasPredicate.size()) {
+        const auto& predicates = hasPredicate[subject];
+        counts.numListPredicates_ += predicates.size();
+        for (const auto& predicate : predicates) {
+          ++counts.predicateCounts_[predicate];
         }
       }
     }
+  });
+
+  PatternTrickCounts result = std::move(countsPerThread[0]);
+  for (const auto& counts : countsPerThread | std::views::drop(1)) {
+    std::ranges::transform(result.patternCounts_, counts.patternCounts_,
+                           result.patternCounts_.begin(), std::plus{});
+    for (const auto& [predicate, count] : counts.predicateCounts_) {
+      result.predicateCounts_[predicate] += count;
+    }
+    result.numEntitiesWithPatterns_ += counts.numEntitiesWithPatterns_;
+    result.numListPredicates_ += counts.numListPredicates_;
   }
+  return result;
+}
 
-  LOG(DEBUG) << "Using " << patternCounts.size()
-             << " patterns for computing the result." << std::endl;
-  for (const auto& it : patternCounts) {
-    for (const auto& predicate : patterns[it.first]) {
-      predicateCounts[predicate] += it.second;
+// Add the counts of the predicates of the patterns to the
+// `counts.predicateCounts_`. Return the number of distinct predicates in the
+// used patterns and the number of predicates that were counted via patterns.
+std::pair<size_t, size_t> resolvePatterns(
+    PatternTrickCounts& counts, const CompactVectorOfStrings<Id>& patterns) {
+  size_t numPatternPredicates = 0;
+  size_t numPredicatesSubsumedInPatterns = 0;
+  for (size_t patternIdx = 0; patternIdx < counts.patternCounts_.size();
+       ++patternIdx) {
+    size_t patternCount = counts.patternCounts_[patternIdx];
+    if (patternCount == 0) {
+      continue;
+    }
+    const auto& pattern = patterns[patternIdx];
+    numPatternPredicates += pattern.size();
+    for (const auto& predicate : pattern) {
+      counts.predicateCounts_[predicate] += patternCount;
+      numPredicatesSubsumedInPatterns += patternCount;
     }
   }
-  result.reserve(predicateCounts.size());
-  for (const auto& it : predicateCounts) {
-    result.push_back({it.first, Id::makeFromInt(it.second)});
-  }
-  *dynResult = std::move(result).toDynamic();
+  return {numPatternPredicates, numPredicatesSubsumedInPatterns};
 }
 
-/**
- * @ brief A Hashmap from T to size_t which additionally supports merging of
- * Hashmaps
- *
- * publicly inherits from ad_utility::HashMap<T, size_t> and additionally
- * provides operator%= which merges Hashmaps by adding the values for
- * corresponding keys. This is needed for the parallel pattern trick
- *
- */
-template <typename T>
-class MergeableHashMap : public ad_utility::HashMap<T, size_t> {
- public:
-  MergeableHashMap& operator%=(const MergeableHashMap& rhs) {
-    for (const auto& [key, value] : rhs) {
-      (*this)[key] += value;
-    }
-    return *this;
+// Write the predicates and their counts to the `result`.
+void writePredicateCounts(const ad_utility::HashMap<Id, size_t>& counts,
+                          IdTableStatic<2>& result) {
+  result.reserve(counts.size());
+  for (const auto& [predicate, count] : counts) {
+    result.push_back({predicate, Id::makeFromInt(count)});
   }
-};
+}
+}  // namespace
 
+// _____________________________________________________________________________
+void CountAvailablePredicates::computePatternTrickAllEntities(
+    IdTable* dynResult, const CompressedPatternIds& hasPattern,
+    const CompactVectorOfStrings<Id>& hasPredicate,
+    const CompactVectorOfStrings<Id>& patterns) {
+  IdTableStatic<2> result = std::move(*dynResult).toStatic<2>();
+  LOG(DEBUG) << "For all entities." << std::endl;
+  size_t maxId = std::max(hasPattern.size(), hasPredicate.size());
+  auto getEntity = [](size_t i) -> std::optional<size_t> { return i; };
+  PatternTrickCounts counts = countPatternsAndPredicates(
+      maxId, getEntity, hasPattern, hasPredicate, patterns);
+  resolvePatterns(counts, patterns);
+  writePredicateCounts(counts.predicateCounts_, result);
+  *dynResult = std::move(result).toDynamic();
+}
+
+// _____________________________________________________________________________
 template <size_t WIDTH>
 void CountAvailablePredicates::computePatternTrick(
     const IdTable& dynInput, IdTable* dynResult,
-    const vector<PatternID>& hasPattern,
+    const CompressedPatternIds& hasPattern,
     const CompactVectorOfStrings<Id>& hasPredicate,
     const CompactVectorOfStrings<Id>& patterns, const size_t subjectColumn,
     RuntimeInformation& runtimeInfo) {
@@ -211,113 +318,35 @@ void CountAvailablePredicates::computePatternTrick(
   LOG(DEBUG) << "For " << input.size() << " entities in column "
              << subjectColumn << std::endl;
 
-  MergeableHashMap<Id> predicateCounts;
-  MergeableHashMap<size_t> patternCounts;
-
-  // declare openmp reductions which aggregate Hashmaps by adding the values for
-  // corresponding keys
-#pragma omp declare reduction( \
-        MergeHashmapsId : MergeableHashMap<Id> : omp_out %= omp_in)
-#pragma omp declare reduction( \
-        MergeHashmapsSizeT : MergeableHashMap<size_t> : omp_out %= omp_in)
-
-  // These variables are used to gather additional statistics
-  size_t numEntitiesWithPatterns = 0;
-  // the number of distinct predicates in patterns
-  size_t numPatternPredicates = 0;
-  // the number of predicates counted without patterns
-  size_t numListPredicates = 0;
-
-  if (input.size() > 0) {  // avoid strange OpenMP segfaults on GCC
-#pragma omp parallel
-#pragma omp single
-#pragma omp taskloop grainsize(500000) default(none)                           \
-    reduction(MergeHashmapsId : predicateCounts)                               \
-    reduction(MergeHashmapsSizeT : patternCounts)                              \
-    reduction(+ : numEntitiesWithPatterns) reduction(+ : numPatternPredicates) \
-    reduction(+ : numListPredicates)                                           \
-    shared(input, subjectColumn, hasPattern, hasPredicate)
-    for (size_t inputIdx = 0; inputIdx < input.size(); ++inputIdx) {
-      // Skip over elements with the same subject (don't count them twice)
-      Id subjectId = input(inputIdx, subjectColumn);
-      if (inputIdx > 0 && subjectId == input(inputIdx - 1, subjectColumn)) {
-        continue;
-      }
-      if (subjectId.getDatatype() != Datatype::VocabIndex) {
-        // Ignore numeric literals and other types that are folded into
-        // the value IDs. They can never be subjects and thus also have no
-        // patterns.
-        continue;
-      }
-      auto subject = subjectId.getVocabIndex().get();
-
-      if (subject < hasPattern.size() && hasPattern[subject] != NO_PATTERN) {
-        // The subject matches a pattern
-        patternCounts[hasPattern[subject]]++;
-        numEntitiesWithPatterns++;
-      } else if (subject < hasPredicate.size()) {
-        // The subject does not match a pattern
-        const auto& pattern = hasPredicate[subject];
-        numListPredicates += pattern.size();
-        if (!pattern.empty()) {
-          for (const auto& predicate : pattern) {
-            predicateCounts[predicate]++;
-          }
-        } else {
-          LOG(TRACE) << "No pattern or has-relation entry found for entity "
-                     << std::to_string(subject) << std::endl;
-        }
-      } else {
-        LOG(TRACE) << "Subject " << subject
-                   << " does not appear to be an entity "
-                      "(its id is to high)."
-                   << std::endl;
-      }
+  // The subjects are read from the column, which is sorted, s.t. each subject
+  // is only counted once.
+  std::span<const Id> subjects = input.getColumn(subjectColumn);
+  auto getEntity = [&subjects](size_t i) -> std::optional<size_t> {
+    // Skip over elements with the same subject (don't count them twice)
+    Id subjectId = subjects[i];
+    if (i > 0 && subjectId == subjects[i - 1]) {
+      return std::nullopt;
     }
-  }
-  LOG(DEBUG) << "Using " << patternCounts.size()
-             << " patterns for computing the result." << std::endl;
-  // the number of predicates counted with patterns
-  size_t numPredicatesSubsumedInPatterns = 0;
-  // resolve the patterns to predicate counts
-
-  LOG(DEBUG) << "Converting PatternMap to vector" << std::endl;
-  // flatten into a vector, to make iterable
-  const std::vector<std::pair<size_t, size_t>> patternVec(patternCounts.begin(),
-                                                          patternCounts.end());
-
+    if (subjectId.getDatatype() != Datatype::VocabIndex) {
+      // Ignore numeric literals and other types that are folded into
+      // the value IDs. They can never be subjects and thus also have no
+      // patterns.
+      return std::nullopt;
+    }
+    return subjectId.getVocabIndex().get();
+  };
+  PatternTrickCounts counts = countPatternsAndPredicates(
+      subjects.size(), getEntity, hasPattern, hasPredicate, patterns);
+  size_t numEntitiesWithPatterns = counts.numEntitiesWithPatterns_;
+  size_t numListPredicates = counts.numListPredicates_;
   LOG(DEBUG) << "Start translating pattern counts to predicate counts"
              << std::endl;
-  if (patternVec.begin() !=
-      patternVec.end()) {  // avoid segfaults with OpenMP on GCC
-#pragma omp parallel
-#pragma omp single
-#pragma omp taskloop grainsize(100000) default(none)                           \
-    reduction(MergeHashmapsId : predicateCounts)                               \
-    reduction(+ : numPredicatesSubsumedInPatterns)                             \
-    reduction(+ : numEntitiesWithPatterns) reduction(+ : numPatternPredicates) \
-    reduction(+ : numListPredicates) shared(patternVec, patterns)
-    // TODO<joka921> When we use iterators (`patternVec.begin()`) for the loop,
-    // there is a strange warning on clang15 when OpenMP is activated. Find out
-    // whether this is a known issue and whether this will be fixed in later
-    // versions of clang.
-    for (size_t i = 0; i != patternVec.size(); ++i) {
-      auto [patternIndex, patternCount] = patternVec[i];
-      const auto& pattern = patterns[patternIndex];
-      numPatternPredicates += pattern.size();
-      for (const auto& predicate : pattern) {
-        predicateCounts[predicate] += patternCount;
-        numPredicatesSubsumedInPatterns += patternCount;
-      }
-    }
-  }
+  auto [numPatternPredicates, numPredicatesSubsumedInPatterns] =
+      resolvePatterns(counts, patterns);
   LOG(DEBUG) << "Finished translating pattern counts to predicate counts"
              << std::endl;
   // write the predicate counts to the result
-  result.reserve(predicateCounts.size());
-  for (const auto& it : predicateCounts) {
-    result.push_back({it.first, Id::makeFromInt(it.second)});
-  }
+  writePredicateCounts(counts.predicateCounts_, result);
   LOG(DEBUG) << "Finished writing results" << std::endl;
 
   // Print interesting statistics about the pattern trick
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "../global/Pattern.h"
+#include "../index/PatternTrickAggregates.h"
 #include "../parser/ParsedQuery.h"
 #include "./Operation.h"
 #include "./QueryExecutionTree.h"
@@ -102,17 +103,23 @@ class CountAvailablePredicates : public Operation {
   template <size_t I>
   static void computePatternTrick(
       const IdTable& input, IdTable* result,
-      const vector<PatternID>& hasPattern,
+      const CompressedPatternIds& hasPattern,
       const CompactVectorOfStrings<Id>& hasPredicate,
       const CompactVectorOfStrings<Id>& patterns, size_t subjectColumn,
       RuntimeInformation& runtimeInfo);
 
   static void computePatternTrickAllEntities(
-      IdTable* result, const vector<PatternID>& hasPattern,
+      IdTable* result, const CompressedPatternIds& hasPattern,
       const CompactVectorOfStrings<Id>& hasPredicate,
       const CompactVectorOfStrings<Id>& patterns);
 
  private:
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
   [[nodiscard]] VariableToColumnMap computeVariableToColumnMap() const override;
+
+  // If the subtree is an `IndexScan` of the form `?x <p> <o>` and the result
+  // of the pattern trick for the subjects of these triples was precomputed
+  // during the index build (see `PatternTrickAggregates`), return this result.
+  // Else return `nullptr`.
+  const PatternTrickAggregates::PredicateCounts* getPrecomputedCounts() const;
 };
@@ -4,10 +4,14 @@
 
 #include "./Distinct.h"
 
+#include <absl/hash/hash.h>
+
 #include <sstream>
 
-#include "engine/CallFixedSize.h"
 #include "engine/QueryExecutionTree.h"
+#include "global/Constants.h"
+#include "util/HashSet.h"
+#include "util/ParallelExecution.h"
 
 using std::endl;
 using std::string;
@@ -18,18 +22,63 @@ size_t Distinct::getResultWidth() const { return _subtree->getResultWidth(); }
 // _____________________________________________________________________________
 Distinct::Distinct(QueryExecutionContext* qec,
                    std::shared_ptr<QueryExecutionTree> subtree,
-                   const vector<ColumnIndex>& keepIndices)
-    : Operation(qec), _subtree(subtree), _keepIndices(keepIndices) {}
+                   const vector<ColumnIndex>& keepIndices, Strategy strategy)
+    : Operation(qec),
+      _subtree(subtree),
+      _keepIndices(keepIndices),
+      strategy_(strategy) {}
 
 // _____________________________________________________________________________
 string Distinct::getCacheKeyImpl() const {
   std::ostringstream os;
-  os << "Distinct " << _subtree->getCacheKey();
+  os << "Distinct ";
+  // For the `Sorted` strategy, the `_keepIndices` are part of the key of the
+  // `Sort` below. The result of the `Hash` strategy has the order of its
+  // (unsorted) input, so it also differs from the one of the `Sorted` strategy.
+  if (strategy_ == Strategy::Hash) {
+    os << "(hash) on";
+    for (auto index : _keepIndices) {
+      os << ' ' << index;
+    }
+    os << ' ';
+  }
+  os << _subtree->getCacheKey();
   return std::move(os).str();
 }
 
 // _____________________________________________________________________________
-string Distinct::getDescriptor() const { return "Distinct"; }
+string Distinct::getDescriptor() const {
+  return strategy_ == Strategy::Hash ? "Distinct (hash)" : "Distinct";
+}
+
+// _____________________________________________________________________________
+size_t Distinct::getNumDistinctRowsEstimate() {
+  size_t size = _subtree->getSizeEstimate();
+  size_t numDistinct = std::min(size, size_t{1});
+  for (auto index : _keepIndices) {
+    float multiplicity = std::max(1.0f, _subtree->getMultiplicity(index));
+    numDistinct = std::max(
+        numDistinct,
+        static_cast<size_t>(static_cast<float>(size) / multiplicity));
+  }
+  return std::min(size, numDistinct);
+}
+
+// _____________________________________________________________________________
+size_t Distinct::getCostEstimate() {
+  size_t inputSize = getSizeEstimateBeforeLimit();
+  if (strategy_ == Strategy::Sorted) {
+    return inputSize + _subtree->getCostEstimate();
+  }
+  // Each row of the input is looked up in the hash sets, which grow to the
+  // number of distinct rows.
+  size_t numDistinct = getNumDistinctRowsEstimate();
+  size_t logNumDistinct =
+      numDistinct < 4
+          ? 2
+          : static_cast<size_t>(logb(static_cast<double>(numDistinct)));
+  return _subtree->getCostEstimate() + inputSize + numDistinct * logNumDistinct;
+}
 
 // _____________________________________________________________________________
 VariableToColumnMap Distinct::computeVariableToColumnMap() const {
@@ -37,16 +86,80 @@ VariableToColumnMap Distinct::computeVariableToColumnMap() const {
 }
 
 // _____________________________________________________________________________
-ResultTable Distinct::computeResult() {
+ResultTable Distinct::computeResult([[maybe_unused]] bool requestLaziness) {
   IdTable idTable{getExecutionContext()->getAllocator()};
   LOG(DEBUG) << "Getting sub-result for distinct result computation..." << endl;
   shared_ptr<const ResultTable> subRes = _subtree->getResult();
 
   LOG(DEBUG) << "Distinct result computation..." << endl;
   idTable.setNumColumns(subRes->idTable().numColumns());
-  size_t width = subRes->idTable().numColumns();
-  CALL_FIXED_SIZE(width, &Engine::distinct, subRes->idTable(), _keepIndices,
-                  &idTable);
+  if (strategy_ == Strategy::Hash) {
+    idTable = computeHashDistinct(subRes->idTable());
+  } else {
+    Engine::distinct(subRes->idTable(), _keepIndices, &idTable);
+  }
   LOG(DEBUG) << "Distinct result computation done." << endl;
   return {std::move(idTable), resultSortedOn(), subRes->getSharedLocalVocab()};
 }
+
+// _____________________________________________________________________________
+IdTable Distinct::computeHashDistinct(const IdTable& input) const {
+  // Only inputs with several blocks per thread are worth splitting.
+  constexpr size_t blockSize = 65536;
+  size_t numThreads = std::clamp(
+      input.size() / (4 * blockSize), size_t{1},
+      std::max(size_t{1},
+               getExecutionContext()->getNumThreads(
+                   RuntimeParameters().get<"hash-distinct-num-threads">())));
+
+  // The hash sets contain the indices of the rows of the `input` and compare
+  // them by the values of the `_keepIndices`.
+  auto hashRow = [this, &input](size_t row) {
+    size_t hash = 0;
+    for (auto index : _keepIndices) {
+      hash = absl::HashOf(hash, input(row, index));
+    }
+    return hash;
+  };
+  auto rowsAreEqual = [this, &input](size_t a, size_t b) {
+    return std::ranges::all_of(_keepIndices, [&input, a, b](auto index) {
+      return input(a, index) == input(b, index);
+    });
+  };
+
+  // Each thread handles the rows whose hash belongs to its partition, s.t. all
+  // the duplicates of a row are handled by the same thread. The hash sets are
+  // only needed until the result has been created, so they use the arena of
+  // the query.
+  std::vector<std::vector<size_t>> firstOccurrences(numThreads);
+  ad_utility::runConcurrently(numThreads, [&](size_t partition) {
+    ad_utility::HashSetWithMemoryLimit<size_t, decltype(hashRow),
+                                       decltype(rowsAreEqual)>
+        rows{0, hashRow, rowsAreEqual,
+             getExecutionContext()->getTemporaryAllocator()};
+    auto& result = firstOccurrences.at(partition);
+    for (size_t row = 0; row < input.size(); ++row) {
+      if ((numThreads == 1 || hashRow(row) % numThreads == partition) &&
+          rows.insert(row).second) {
+        result.push_back(row);
+      }
+    }
+  });
+
+  // Copy the first occurrences in the order of the input.
+  std::vector<size_t> rows;
+  for (const auto& partition : firstOccurrences) {
+    rows.insert(rows.end(), partition.begin(), partition.end());
+  }
+  std::ranges::sort(rows);
+  IdTable result{input.numColumns(), getExecutionContext()->getAllocator()};
+  result.resize(rows.size());
+  for (size_t column = 0; column < input.numColumns(); ++column) {
+    std::ranges::transform(
+        rows, result.getColumn(column).begin(),
+        [inputColumn = input.getColumn(column)](size_t row) {
+          return inputColumn[row];
+        });
+  }
+  return result;
+}
@@ -17,14 +17,26 @@ using std::pair;
 using std::vector;
 
 class Distinct : public Operation {
+ public:
+  // How the duplicates are removed. `Sorted` requires the input to be sorted on
+  // the `keepIndices` (the query planner adds a `Sort` if it is not) and
+  // removes adjacent duplicates. `Hash` works on unsorted inputs and keeps the
+  // first occurrence of each distinct row, s.t. the order of the input is
+  // kept. It is cheaper than sorting the input if there are few distinct rows.
+  enum class Strategy { Sorted, Hash };
+
  private:
   std::shared_ptr<QueryExecutionTree> _subtree;
   vector<ColumnIndex> _keepIndices;
+  Strategy strategy_;
 
  public:
   Distinct(QueryExecutionContext* qec,
            std::shared_ptr<QueryExecutionTree> subtree,
-           const vector<ColumnIndex>& keepIndices);
+           const vector<ColumnIndex>& keepIndices,
+           Strategy strategy = Strategy::Sorted);
+
+  Strategy strategy() const { return strategy_; }
 
   [[nodiscard]] size_t getResultWidth() const override;
 
@@ -45,9 +57,7 @@ class Distinct : public Operation {
   }
 
  public:
-  virtual size_t getCostEstimate() override {
-    return getSizeEstimateBeforeLimit() + _subtree->getCostEstimate();
-  }
+  size_t getCostEstimate() override;
 
   virtual float getMultiplicity(size_t col) override {
     return _subtree->getMultiplicity(col);
@@ -63,7 +73,17 @@ class Distinct : public Operation {
   [[nodiscard]] string getCacheKeyImpl() const override;
 
  private:
-  virtual ResultTable computeResult() override;
+  virtual ResultTable computeResult(
+      [[maybe_unused]] bool requestLaziness) override;
+
+  // The estimated number of distinct rows of the input, which is at least the
+  // largest number of distinct values of one of the `_keepIndices`.
+  size_t getNumDistinctRowsEstimate();
+
+  // Remove the duplicates from the unsorted `input` (see `Strategy::Hash`).
+  // The rows are partitioned by their hash, and each partition is handled by
+  // a separate thread (see the runtime parameter `hash-distinct-num-threads`).
+  IdTable computeHashDistinct(const IdTable& input) const;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 };
@@ -4,48 +4,50 @@
 
 #include "engine/Engine.h"
 
-#include "engine/CallFixedSize.h"
-
-// The actual implementation of sorting an `IdTable` according to the
-// `sortCols`.
-void Engine::sort(IdTable& idTable, const std::vector<ColumnIndex>& sortCols) {
-  size_t width = idTable.numColumns();
+// ____________________________________________________________________________
+void Engine::sort(
+    IdTable& idTable, const std::vector<ColumnIndex>& sortCols,
+    const ad_utility::idTableSorting::CheckCancellation& checkCancellation) {
+  LOG(DEBUG) << "Sorting " << idTable.size() << " elements.\n";
+  ad_utility::idTableSorting::sortByColumns(
+      idTable, sortCols, getNumSortThreads(), checkCancellation);
+  LOG(DEBUG) << "Sort done.\n";
+}
 
-  // Instantiate specialized comparison lambdas for one and two sort columns
-  // and use a generic comparison for a higher number of sort columns.
-  // TODO<joka921> As soon as we have merged the benchmark, measure whether
-  // this is in fact beneficial and whether it should also be applied for a
-  // higher number of columns, maybe even using `CALL_FIXED_SIZE` for the
-  // number of sort columns.
-  // TODO<joka921> Also experiment with sorting algorithms that take the
-  // column-based structure of the `IdTable` into account.
-  if (sortCols.size() == 1) {
-    CALL_FIXED_SIZE(width, &Engine::sort, &idTable, sortCols.at(0));
-  } else if (sortCols.size() == 2) {
-    auto comparison = [c0 = sortCols[0], c1 = sortCols[1]](const auto& row1,
-                                                           const auto& row2) {
-      if (row1[c0] != row2[c0]) {
-        return row1[c0] < row2[c0];
-      } else {
-        return row1[c1] < row2[c1];
-      }
-    };
-    ad_utility::callFixedSize(idTable.numColumns(),
-                              [&idTable, comparison]<int I>() {
-                                Engine::sort<I>(&idTable, comparison);
-                              });
-  } else {
-    auto comparison = [&sortCols](const auto& row1, const auto& row2) {
-      for (auto& col : sortCols) {
-        if (row1[col] != row2[col]) {
-          return row1[col] < row2[col];
-        }
-      }
-      return false;
-    };
-    ad_utility::callFixedSize(idTable.numColumns(),
-                              [&idTable, comparison]<int I>() {
-                                Engine::sort<I>(&idTable, comparison);
-                              });
+// ____________________________________________________________________________
+void Engine::distinct(const IdTable& input,
+                      const std::vector<ColumnIndex>& keepIndices,
+                      IdTable* result) {
+  LOG(DEBUG) << "Distinct on " << input.size() << " elements.\n";
+  AD_CONTRACT_CHECK(keepIndices.size() <= input.numColumns());
+  // A row is kept iff it is the first row or differs from its predecessor in
+  // one of the `keepIndices`. This is determined column by column.
+  const size_t numRows = input.numRows();
+  std::vector<char> isKept(numRows, false);
+  if (numRows > 0) {
+    isKept[0] = true;
+  }
+  for (ColumnIndex col : keepIndices) {
+    std::span<const Id> column = input.getColumn(col);
+    for (size_t i = 1; i < numRows; ++i) {
+      isKept[i] |= column[i] != column[i - 1];
+    }
+  }
+  std::vector<size_t> keptRows;
+  for (size_t i = 0; i < numRows; ++i) {
+    if (isKept[i]) {
+      keptRows.push_back(i);
+    }
+  }
+  // Copy the kept rows of each column.
+  IdTable distinctRows{input.numColumns(), input.getAllocator()};
+  distinctRows.resize(keptRows.size());
+  for (size_t col = 0; col < input.numColumns(); ++col) {
+    std::ranges::transform(keptRows, distinctRows.getColumn(col).begin(),
+                           [column = input.getColumn(col)](size_t row) {
+                             return column[row];
+                           });
   }
+  *result = std::move(distinctRows);
+  LOG(DEBUG) << "Distinct done.\n";
 }
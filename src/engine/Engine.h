@@ -10,6 +10,7 @@
 
 #include "engine/IndexSequence.h"
 #include "engine/idTable/IdTable.h"
+#include "engine/idTable/IdTableSorting.h"
 #include "global/Constants.h"
 #include "global/Id.h"
 #include "util/Exception.h"
@@ -96,24 +97,17 @@ class Engine {
                << " elements.\n";
   }
 
+  // The number of threads that are used for sorting, as specified by the
+  // runtime parameter `sort-num-threads`.
+  static size_t getNumSortThreads() {
+    return RuntimeParameters().get<"sort-num-threads">();
+  }
+
   template <size_t WIDTH>
   static void sort(IdTable* tab, const size_t keyColumn) {
     LOG(DEBUG) << "Sorting " << tab->size() << " elements ..." << std::endl;
-    IdTableStatic<WIDTH> stab = std::move(*tab).toStatic<WIDTH>();
-    if constexpr (USE_PARALLEL_SORT) {
-      ad_utility::parallel_sort(
-          stab.begin(), stab.end(),
-          [keyColumn](const auto& a, const auto& b) {
-            return a[keyColumn] < b[keyColumn];
-          },
-          ad_utility::parallel_tag(NUM_SORT_THREADS));
-    } else {
-      std::sort(stab.begin(), stab.end(),
-                [keyColumn](const auto& a, const auto& b) {
-                  return a[keyColumn] < b[keyColumn];
-                });
-    }
-    *tab = std::move(stab).toDynamic();
+    ad_utility::idTableSorting::sortByColumns(
+        *tab, std::array{ColumnIndex{keyColumn}}, getNumSortThreads());
     LOG(TRACE) << "Sort done.\n";
   }
   // The effect of the third template argument is that if C does not have
@@ -125,49 +119,31 @@ class Engine {
       typename = std::enable_if_t<std::is_same_v<
           bool, std::invoke_result_t<C, typename IdTableStatic<WIDTH>::row_type,
                                      typename IdTableStatic<WIDTH>::row_type>>>>
-  static void sort(IdTable* tab, C comp) {
+  static void sort(IdTable* tab, C comp,
+                   const ad_utility::idTableSorting::CheckCancellation&
+                       checkCancellation = {}) {
     LOG(DEBUG) << "Sorting " << tab->size() << " elements.\n";
     IdTableStatic<WIDTH> stab = std::move(*tab).toStatic<WIDTH>();
-    if constexpr (USE_PARALLEL_SORT) {
-      ad_utility::parallel_sort(stab.begin(), stab.end(), comp,
-                                ad_utility::parallel_tag(NUM_SORT_THREADS));
-    } else {
-      std::sort(stab.begin(), stab.end(), comp);
-    }
+    ad_utility::idTableSorting::sortWithComparison(
+        stab, comp, getNumSortThreads(), checkCancellation);
     *tab = std::move(stab).toDynamic();
     LOG(DEBUG) << "Sort done.\n";
   }
 
-  static void sort(IdTable& idTable, const std::vector<ColumnIndex>& sortCols);
+  // Sort `idTable` lexicographically by the `sortCols`. The sort can be
+  // cancelled between its steps by the `checkCancellation`.
+  static void sort(IdTable& idTable, const std::vector<ColumnIndex>& sortCols,
+                   const ad_utility::idTableSorting::CheckCancellation&
+                       checkCancellation = {});
 
   /**
    * @brief Removes all duplicates from input with regards to the columns
    *        in keepIndices. The input needs to be sorted on the keep indices,
-   *        otherwise the result of this function is undefined.
+   *        otherwise the result of this function is undefined. The rows that
+   *        are kept are determined first, and the columns are then copied one
+   *        at a time, so the same code is used for all widths.
    **/
-  template <size_t WIDTH>
-  static void distinct(const IdTable& dynInput,
+  static void distinct(const IdTable& input,
                        const std::vector<ColumnIndex>& keepIndices,
-                       IdTable* dynResult) {
-    LOG(DEBUG) << "Distinct on " << dynInput.size() << " elements.\n";
-    const IdTableView<WIDTH> input = dynInput.asStaticView<WIDTH>();
-    IdTableStatic<WIDTH> result = std::move(*dynResult).toStatic<WIDTH>();
-    result = input.clone();
-    if (!input.empty()) {
-      AD_CONTRACT_CHECK(keepIndices.size() <= input.numColumns());
-
-      auto last = std::unique(result.begin(), result.end(),
-                              [&keepIndices](const auto& a, const auto& b) {
-                                for (ColumnIndex i : keepIndices) {
-                                  if (a[i] != b[i]) {
-                                    return false;
-                                  }
-                                }
-                                return true;
-                              });
-      result.erase(last, result.end());
-    }
-    *dynResult = std::move(result).toDynamic();
-    LOG(DEBUG) << "Distinct done.\n";
-  }
+                       IdTable* result);
 };
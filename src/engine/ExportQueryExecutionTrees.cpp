@@ -4,11 +4,18 @@
 
 #include "ExportQueryExecutionTrees.h"
 
+#include <chrono>
 #include <ranges>
 
 #include "absl/strings/str_cat.h"
+#include "engine/IdTableExchange.h"
 #include "parser/RdfEscaping.h"
+#include "parser/data/ConstructQueryExportContext.h"
+#include "util/ArrowIpc.h"
 #include "util/ConstexprUtils.h"
+#include "util/HashSet.h"
+#include "util/OverloadCallOperator.h"
+#include "util/ThreadSafeQueue.h"
 #include "util/http/MediaTypes.h"
 
 // __________________________________________________________________________
@@ -21,6 +28,444 @@ auto getRowIndices(const LimitOffsetClause& limitOffset,
   return std::views::iota(limitOffset.actualOffset(idTable.size()),
                           limitOffset.upperBound(idTable.size()));
 }
+
+// A single block of a result together with its local vocabulary and the
+// indices of the rows that have to be exported from this block.
+struct TableWithRange {
+  const IdTable& idTable_;
+  const LocalVocab& localVocab_;
+  decltype(getRowIndices(std::declval<const LimitOffsetClause&>(),
+                         std::declval<const IdTable&>())) view_;
+};
+
+// Yield the blocks of the `result` (a single block if the result is fully
+// materialized) together with the rows that have to be exported from each of
+// them, such that the LIMIT and OFFSET from the `limitOffset` are respected
+// across block boundaries. Lazy results are consumed block by block and are
+// never materialized as a whole.
+cppcoro::generator<TableWithRange> getIdTables(const ResultTable& result,
+                                               LimitOffsetClause limitOffset) {
+  if (result.isFullyMaterialized()) {
+    co_yield TableWithRange{result.idTable(), result.localVocab(),
+                            getRowIndices(limitOffset, result.idTable())};
+    co_return;
+  }
+  for (const auto& [idTable, localVocab] : result.idTables()) {
+    if (limitOffset._limit.has_value() && limitOffset._limit.value() == 0) {
+      co_return;
+    }
+    auto view = getRowIndices(limitOffset, idTable);
+    uint64_t numExported = limitOffset.actualSize(idTable.size());
+    limitOffset._offset -= limitOffset.actualOffset(idTable.size());
+    if (limitOffset._limit.has_value()) {
+      limitOffset._limit.value() -= numExported;
+    }
+    if (numExported > 0) {
+      co_yield TableWithRange{idTable, localVocab, view};
+    }
+  }
+}
+
+// Split the `rows` into consecutive batches of at most
+// `EXPORT_VOCAB_BATCH_SIZE` rows, for which the words of the vocabulary are
+// resolved together (see `getVocabWordsOfBatch`).
+cppcoro::generator<std::ranges::iota_view<uint64_t, uint64_t>> getBatches(
+    std::ranges::iota_view<uint64_t, uint64_t> rows) {
+  if (rows.empty()) {
+    co_return;
+  }
+  uint64_t end = rows.back() + 1;
+  for (uint64_t begin = rows.front(); begin < end;
+       begin += EXPORT_VOCAB_BATCH_SIZE) {
+    co_yield std::views::iota(begin,
+                              std::min(end, begin + EXPORT_VOCAB_BATCH_SIZE));
+  }
+}
+
+// Format the `rows` batch by batch (see `getBatches`) with the
+// `formatBatch` function, which takes a batch and returns it as a string.
+// The batches are formatted concurrently by `export-num-threads` many threads
+// (the lookups in the vocabularies and the `LocalVocab` are thread-safe), and
+// the formatted batches are yielded in the order of the rows. At most a few
+// formatted batches per thread are kept in memory at the same time.
+cppcoro::generator<std::string> formatBatchesInParallel(
+    std::ranges::iota_view<uint64_t, uint64_t> rows, auto formatBatch) {
+  std::vector<std::ranges::iota_view<uint64_t, uint64_t>> batches;
+  for (auto batch : getBatches(rows)) {
+    batches.push_back(batch);
+  }
+  size_t numThreads = std::min(
+      batches.size(), RuntimeParameters().get<"export-num-threads">());
+  if (numThreads <= 1) {
+    for (auto batch : batches) {
+      std::string formatted = formatBatch(batch);
+      co_yield formatted;
+    }
+    co_return;
+  }
+  std::atomic<size_t> nextBatch = 0;
+  auto producer =
+      [&batches, &nextBatch,
+       &formatBatch]() -> std::optional<std::pair<size_t, std::string>> {
+    size_t batchIndex = nextBatch++;
+    if (batchIndex >= batches.size()) {
+      return std::nullopt;
+    }
+    return std::pair{batchIndex, formatBatch(batches[batchIndex])};
+  };
+  for (std::string& formatted :
+       ad_utility::data_structures::queueManager<
+           ad_utility::data_structures::OrderedThreadSafeQueue<std::string>>(
+           2 * numThreads, numThreads, producer)) {
+    co_yield formatted;
+  }
+}
+
+// Return the Arrow type of the values of the `column` in the `rows` of the
+// `idTable`. Columns of which all defined values are integers, doubles,
+// booleans, or dates (with a year in the range of `Date`) get the respective
+// type, all other columns are exported as dictionary-encoded strings.
+ad_utility::arrow::Type getArrowType(
+    const IdTable& idTable,
+    const std::optional<QueryExecutionTree::VariableAndColumnIndex>& column,
+    std::ranges::iota_view<uint64_t, uint64_t> rows) {
+  using ad_utility::arrow::Type;
+  if (!column.has_value()) {
+    return Type::DictionaryString;
+  }
+  std::optional<Datatype> datatype;
+  decltype(auto) col = idTable.getColumn(column.value().columnIndex_);
+  for (uint64_t i : rows) {
+    Id id = col[i];
+    if (id.isUndefined()) {
+      continue;
+    }
+    if (datatype.has_value() && datatype.value() != id.getDatatype()) {
+      return Type::DictionaryString;
+    }
+    datatype = id.getDatatype();
+    if (datatype == Datatype::Date && !id.getDate().isDate()) {
+      return Type::DictionaryString;
+    }
+  }
+  switch (datatype.value_or(Datatype::Undefined)) {
+    case Datatype::Int:
+      return Type::Int64;
+    case Datatype::Double:
+      return Type::Double;
+    case Datatype::Bool:
+      return Type::Bool;
+    case Datatype::Date:
+      return Type::Timestamp;
+    default:
+      return Type::DictionaryString;
+  }
+}
+
+// Return the number of milliseconds since the Unix epoch of the `date`. The
+// time is converted to UTC, and missing components (for example the time of
+// an `xsd:date`) are taken to be the earliest possible value.
+int64_t getMillisecondsSinceEpoch(const Date& date) {
+  using namespace std::chrono;
+  auto day = sys_days{year{date.getYear()} / std::max(date.getMonth(), 1) /
+                      std::max(date.getDay(), 1)};
+  int64_t timeZoneHours = 0;
+  auto timeZone = date.getTimeZone();
+  if (const int* offset = std::get_if<int>(&timeZone)) {
+    timeZoneHours = *offset;
+  }
+  auto time = hours{std::max(date.getHour(), 0) - timeZoneHours} +
+              minutes{date.getMinute()} +
+              milliseconds{std::llround(date.getSecond() * 1000)};
+  return duration_cast<milliseconds>(day.time_since_epoch() + time).count();
+}
+
+// The members of a single binding in the SPARQL JSON format.
+struct SparqlJSONBinding {
+  std::string_view value_;
+  std::string_view type_;
+  std::optional<std::string_view> datatype_;
+  std::optional<std::string_view> language_;
+};
+
+// Get the SPARQL JSON binding for a result of `idToStringAndType`. The members
+// of the returned binding point into the `stringValue` and the `xsdType`.
+SparqlJSONBinding getSparqlJSONBinding(std::string_view stringValue,
+                                       const char* xsdType) {
+  if (xsdType) {
+    return {stringValue, "literal", xsdType, std::nullopt};
+  }
+  // No xsdType, this means that `stringValue` is a plain string literal or
+  // entity.
+  if (stringValue.starts_with('<')) {
+    // Strip the <> surrounding the iri. Even if they are technically IRIs, the
+    // format needs the type to be "uri".
+    return {stringValue.substr(1, stringValue.size() - 2), "uri"};
+  } else if (stringValue.starts_with("_:")) {
+    return {stringValue.substr(2), "bnode"};
+  }
+  // TODO<joka921> This is probably not quite correct in the corner case
+  // that there are datatype IRIs which contain quotes.
+  size_t quotePos = stringValue.rfind('"');
+  if (quotePos == std::string::npos) {
+    // TEXT entries are currently not surrounded by quotes
+    return {stringValue, "literal"};
+  }
+  SparqlJSONBinding binding{stringValue.substr(1, quotePos - 1), "literal"};
+  // Look for a language tag or type.
+  if (quotePos < stringValue.size() - 1 && stringValue[quotePos + 1] == '@') {
+    binding.language_ = stringValue.substr(quotePos + 2);
+  } else if (quotePos < stringValue.size() - 2 &&
+             stringValue[quotePos + 1] == '^') {
+    AD_CONTRACT_CHECK(stringValue[quotePos + 2] == '^');
+    std::string_view datatype{stringValue};
+    // remove the <angledBrackets> around the datatype IRI
+    AD_CONTRACT_CHECK(datatype.size() >= quotePos + 5);
+    datatype.remove_prefix(quotePos + 4);
+    datatype.remove_suffix(1);
+    binding.datatype_ = datatype;
+  }
+  return binding;
+}
+
+// Append the `value` as a JSON string (including the quotes) to the `out`.
+void appendJSONString(std::string& out, std::string_view value) {
+  static constexpr std::string_view hexDigits = "0123456789abcdef";
+  out.push_back('"');
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      case '\r':
+        out.append("\\r");
+        break;
+      case '\t':
+        out.append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out.append("\\u00");
+          out.push_back(hexDigits[static_cast<unsigned char>(c) >> 4]);
+          out.push_back(hexDigits[static_cast<unsigned char>(c) & 0xF]);
+        } else {
+          out.push_back(c);
+        }
+    }
+  }
+  out.push_back('"');
+}
+
+// Append the `binding` as a JSON object to the `out`.
+void appendSparqlJSONBinding(std::string& out,
+                             const SparqlJSONBinding& binding) {
+  out.append("{\"value\":");
+  appendJSONString(out, binding.value_);
+  out.append(",\"type\":");
+  appendJSONString(out, binding.type_);
+  if (binding.datatype_.has_value()) {
+    out.append(",\"datatype\":");
+    appendJSONString(out, binding.datatype_.value());
+  }
+  if (binding.language_.has_value()) {
+    out.append(",\"xml:lang\":");
+    appendJSONString(out, binding.language_.value());
+  }
+  out.push_back('}');
+}
+
+// Evaluates the template of a CONSTRUCT query on the rows of its (fully
+// materialized) result. The constants of the template are evaluated only once,
+// and the `Id`s of a batch of rows are converted to strings together: the words
+// of the vocabulary are read in a single sorted pass (see
+// `getVocabWordsOfBatch`), and each distinct `Id` is converted only once, s.t.
+// the strings of repeated subjects and predicates are shared by all their
+// triples.
+class ConstructTripleEvaluator {
+  // A term of the template: a constant (IRI or literal), the column of a
+  // variable in the result, or a blank node (the label of which contains the
+  // row).
+  using Term = std::variant<std::string, ColumnIndex, const BlankNode*>;
+  std::vector<std::array<Term, 3>> triples_;
+  // The columns of the variables of the template.
+  QueryExecutionTree::ColumnIndicesAndTypes columns_;
+  const QueryExecutionTree& qet_;
+  const ResultTable& result_;
+
+ public:
+  ConstructTripleEvaluator(
+      const QueryExecutionTree& qet,
+      const ad_utility::sparql_types::Triples& constructTriples,
+      const ResultTable& result)
+      : qet_{qet}, result_{result} {
+    const auto& variableColumns = qet.getVariableColumns();
+    for (const auto& triple : constructTriples) {
+      std::array<Term, 3> terms;
+      bool canBeDefined = true;
+      for (size_t i = 0; i < 3; ++i) {
+        auto position = static_cast<PositionInTriple>(i);
+        triple[i].visit(ad_utility::OverloadCallOperator{
+            [&](const Variable& variable) {
+              // A triple with a variable that is not part of the result is
+              // never exported.
+              if (!variableColumns.contains(variable)) {
+                canBeDefined = false;
+                return;
+              }
+              ColumnIndex column = variableColumns.at(variable).columnIndex_;
+              terms[i] = column;
+              if (!std::ranges::any_of(columns_, [column](const auto& c) {
+                    return c.value().columnIndex_ == column;
+                  })) {
+                columns_.push_back(QueryExecutionTree::VariableAndColumnIndex{
+                    variable.name(), column});
+              }
+            },
+            [&](const GraphTerm& term) {
+              term.visit(ad_utility::OverloadCallOperator{
+                  [&](const BlankNode& blankNode) { terms[i] = &blankNode; },
+                  [&](const auto& constant) {
+                    // IRIs and literals don't depend on the row, and literals
+                    // are only defined as objects.
+                    auto value = constant.evaluate(context(0), position);
+                    if (value.has_value()) {
+                      terms[i] = std::move(value.value());
+                    } else {
+                      canBeDefined = false;
+                    }
+                  }});
+            }});
+      }
+      if (canBeDefined) {
+        triples_.push_back(std::move(terms));
+      }
+    }
+  }
+
+  // Call `onTriple(subject, predicate, object)` for each triple of the
+  // template and each of the `rows` for which all three terms are defined.
+  // The `std::string_view`s are only valid during the call.
+  template <typename OnTriple>
+  void forEachTriple(std::ranges::iota_view<uint64_t, uint64_t> rows,
+                     const OnTriple& onTriple) const {
+    const auto& index = qet_.getQec()->getIndex();
+    const auto& idTable = result_.idTable();
+    auto vocabWords = ExportQueryExecutionTrees::getVocabWordsOfBatch(
+        index, idTable, columns_, rows);
+    ad_utility::HashMap<Id, std::optional<std::string>> strings;
+    for (const auto& column : columns_) {
+      decltype(auto) col = idTable.getColumn(column.value().columnIndex_);
+      for (uint64_t row : rows) {
+        if (!strings.contains(col[row])) {
+          strings.emplace(col[row],
+                          ExportQueryExecutionTrees::idToConstructString(
+                              index, col[row], result_.localVocab(),
+                              &vocabWords));
+        }
+      }
+    }
+    std::array<std::string_view, 3> values;
+    std::array<std::string, 3> blankNodes;
+    for (uint64_t row : rows) {
+      for (const auto& triple : triples_) {
+        bool isDefined = true;
+        for (size_t i = 0; i < 3 && isDefined; ++i) {
+          std::visit(
+              ad_utility::OverloadCallOperator{
+                  [&](const std::string& constant) { values[i] = constant; },
+                  [&](ColumnIndex column) {
+                    const auto& value = strings.at(idTable(row, column));
+                    isDefined = value.has_value();
+                    if (isDefined) {
+                      values[i] = value.value();
+                    }
+                  },
+                  [&](const BlankNode* blankNode) {
+                    blankNodes[i] =
+                        blankNode
+                            ->evaluate(context(row),
+                                       static_cast<PositionInTriple>(i))
+                            .value();
+                    values[i] = blankNodes[i];
+                  }},
+              triple[i]);
+        }
+        if (isDefined) {
+          onTriple(values[0], values[1], values[2]);
+        }
+      }
+    }
+  }
+
+ private:
+  ConstructQueryExportContext context(size_t row) const {
+    return {row, result_, qet_.getVariableColumns(),
+            qet_.getQec()->getIndex()};
+  }
+};
+
+// The triples that were already exported if the runtime parameter
+// `construct-export-deduplicate` is set, else `std::nullopt`.
+std::optional<ad_utility::HashSet<std::string>> makeSeenTriples() {
+  if (!RuntimeParameters().get<"construct-export-deduplicate">()) {
+    return std::nullopt;
+  }
+  return ad_utility::HashSet<std::string>{};
+}
+
+// Return false if the triple is in the `seenTriples`, else add it and return
+// true. The lengths make the key unambiguous.
+bool isNewTriple(ad_utility::HashSet<std::string>& seenTriples,
+                 std::string_view subject, std::string_view predicate,
+                 std::string_view object) {
+  return seenTriples
+      .insert(absl::StrCat(subject.size(), ":", subject, predicate.size(), ":",
+                           predicate, object))
+      .second;
+}
+
+// Format the triples of the CONSTRUCT query batch by batch, each triple with
+// `formatTriple(output, subject, predicate, object)`, which appends the
+// triple to the `output` string. The batches are formatted in parallel (see
+// `formatBatchesInParallel`), unless the triples are deduplicated.
+cppcoro::generator<std::string> formatConstructTriples(
+    const QueryExecutionTree& qet,
+    const ad_utility::sparql_types::Triples& constructTriples,
+    LimitOffsetClause limitAndOffset,
+    std::shared_ptr<const ResultTable> resultTable, auto formatTriple) {
+  ConstructTripleEvaluator evaluator{qet, constructTriples, *resultTable};
+  auto seenTriples = makeSeenTriples();
+  auto formatBatch = [&evaluator, &seenTriples,
+                      &formatTriple](auto batch) -> std::string {
+    std::string result;
+    evaluator.forEachTriple(batch, [&](std::string_view subject,
+                                       std::string_view predicate,
+                                       std::string_view object) {
+      if (!seenTriples.has_value() ||
+          isNewTriple(seenTriples.value(), subject, predicate, object)) {
+        formatTriple(result, subject, predicate, object);
+      }
+    });
+    return result;
+  };
+  auto rows = getRowIndices(limitAndOffset, resultTable->idTable());
+  if (seenTriples.has_value()) {
+    for (auto batch : getBatches(rows)) {
+      std::string formatted = formatBatch(batch);
+      co_yield formatted;
+    }
+  } else {
+    for (std::string& formatted : formatBatchesInParallel(rows, formatBatch)) {
+      co_yield formatted;
+    }
+  }
+}
 }  // namespace
 
 // _____________________________________________________________________________
@@ -29,20 +474,22 @@ ExportQueryExecutionTrees::constructQueryResultToTriples(
     const QueryExecutionTree& qet,
     const ad_utility::sparql_types::Triples& constructTriples,
     LimitOffsetClause limitAndOffset, std::shared_ptr<const ResultTable> res) {
-  for (size_t i : getRowIndices(limitAndOffset, res->idTable())) {
-    ConstructQueryExportContext context{i, *res, qet.getVariableColumns(),
-                                        qet.getQec()->getIndex()};
-    using enum PositionInTriple;
-    for (const auto& triple : constructTriples) {
-      auto subject = triple[0].evaluate(context, SUBJECT);
-      auto predicate = triple[1].evaluate(context, PREDICATE);
-      auto object = triple[2].evaluate(context, OBJECT);
-      if (!subject.has_value() || !predicate.has_value() ||
-          !object.has_value()) {
-        continue;
+  ConstructTripleEvaluator evaluator{qet, constructTriples, *res};
+  auto seenTriples = makeSeenTriples();
+  std::vector<QueryExecutionTree::StringTriple> triples;
+  for (auto batch : getBatches(getRowIndices(limitAndOffset, res->idTable()))) {
+    triples.clear();
+    evaluator.forEachTriple(batch, [&](std::string_view subject,
+                                       std::string_view predicate,
+                                       std::string_view object) {
+      if (!seenTriples.has_value() ||
+          isNewTriple(seenTriples.value(), subject, predicate, object)) {
+        triples.emplace_back(std::string{subject}, std::string{predicate},
+                             std::string{object});
       }
-      co_yield {std::move(subject.value()), std::move(predicate.value()),
-                std::move(object.value())};
+    });
+    for (auto& triple : triples) {
+      co_yield triple;
     }
   }
 }
@@ -56,28 +503,20 @@ ad_utility::streams::stream_generator ExportQueryExecutionTrees::
         LimitOffsetClause limitAndOffset,
         std::shared_ptr<const ResultTable> resultTable) {
   resultTable->logResultSize();
-  auto generator = ExportQueryExecutionTrees::constructQueryResultToTriples(
-      qet, constructTriples, limitAndOffset, resultTable);
-  for (const auto& triple : generator) {
-    co_yield triple.subject_;
-    co_yield ' ';
-    co_yield triple.predicate_;
-    co_yield ' ';
-    // NOTE: It's tempting to co_yield an expression using a ternary operator:
-    // co_yield triple._object.starts_with('"')
-    //     ? RdfEscaping::validRDFLiteralFromNormalized(triple._object)
-    //     : triple._object;
-    // but this leads to 1. segfaults in GCC (probably a compiler bug) and 2.
-    // to unnecessary copies of `triple._object` in the `else` case because
-    // the ternary always has to create a new prvalue.
-    if (triple.object_.starts_with('"')) {
-      std::string objectAsValidRdfLiteral =
-          RdfEscaping::validRDFLiteralFromNormalized(triple.object_);
-      co_yield objectAsValidRdfLiteral;
+  auto formatTriple = [](std::string& out, std::string_view subject,
+                         std::string_view predicate, std::string_view object) {
+    absl::StrAppend(&out, subject, " ", predicate, " ");
+    if (object.starts_with('"')) {
+      out.append(RdfEscaping::validRDFLiteralFromNormalized(object));
     } else {
-      co_yield triple.object_;
+      out.append(object);
     }
-    co_yield " .\n";
+    out.append(" .\n");
+  };
+  for (const std::string& formatted :
+       formatConstructTriples(qet, constructTriples, limitAndOffset,
+                              std::move(resultTable), formatTriple)) {
+    co_yield formatted;
   }
 }
 
@@ -105,7 +544,16 @@ nlohmann::json ExportQueryExecutionTrees::idTableToQLeverJSONArray(
     const QueryExecutionTree::ColumnIndicesAndTypes& columns,
     std::shared_ptr<const ResultTable> resultTable) {
   AD_CORRECTNESS_CHECK(resultTable != nullptr);
-  const IdTable& data = resultTable->idTable();
+  return idTableToQLeverJSONArray(qet.getQec()->getIndex(), limitAndOffset,
+                                  columns, *resultTable);
+}
+
+// _____________________________________________________________________________
+nlohmann::json ExportQueryExecutionTrees::idTableToQLeverJSONArray(
+    const Index& index, const LimitOffsetClause& limitAndOffset,
+    const QueryExecutionTree::ColumnIndicesAndTypes& columns,
+    const ResultTable& resultTable) {
+  const IdTable& data = resultTable.idTable();
   nlohmann::json json = nlohmann::json::array();
 
   for (size_t rowIndex : getRowIndices(limitAndOffset, data)) {
@@ -117,8 +565,8 @@ nlohmann::json ExportQueryExecutionTrees::idTableToQLeverJSONArray(
         continue;
       }
       const auto& currentId = data(rowIndex, opt->columnIndex_);
-      const auto& optionalStringAndXsdType = idToStringAndType(
-          qet.getQec()->getIndex(), currentId, resultTable->localVocab());
+      const auto& optionalStringAndXsdType =
+          idToStringAndType(index, currentId, resultTable.localVocab());
       if (!optionalStringAndXsdType.has_value()) {
         row.emplace_back(nullptr);
         continue;
@@ -175,11 +623,13 @@ template <bool removeQuotesAndAngleBrackets, bool onlyReturnLiterals,
 std::optional<std::pair<std::string, const char*>>
 ExportQueryExecutionTrees::idToStringAndType(const Index& index, Id id,
                                              const LocalVocab& localVocab,
-                                             EscapeFunction&& escapeFunction) {
+                                             EscapeFunction&& escapeFunction,
+                                             const VocabWords* vocabWords) {
   using enum Datatype;
   auto datatype = id.getDatatype();
   if constexpr (onlyReturnLiterals) {
-    if (!(datatype == VocabIndex || datatype == LocalVocabIndex)) {
+    if (!(datatype == VocabIndex || datatype == LocalVocabIndex ||
+          datatype == InlineString)) {
       return std::nullopt;
     }
   }
@@ -199,8 +649,14 @@ ExportQueryExecutionTrees::idToStringAndType(const Index& index, Id id,
     case VocabIndex: {
       // TODO<joka921> As soon as we get rid of the special encoding of date
       // values, we can use `index.getVocab().indexToOptionalString()` directly.
-      std::optional<string> entity =
-          index.idToOptionalString(id.getVocabIndex());
+      std::optional<string> entity;
+      if (vocabWords != nullptr) {
+        auto it = vocabWords->find(id);
+        AD_CONTRACT_CHECK(it != vocabWords->end());
+        entity = it->second;
+      } else {
+        entity = index.idToOptionalString(id.getVocabIndex());
+      }
       AD_CONTRACT_CHECK(entity.has_value());
       if constexpr (onlyReturnLiterals) {
         if (!entity.value().starts_with('"')) {
@@ -213,8 +669,11 @@ ExportQueryExecutionTrees::idToStringAndType(const Index& index, Id id,
       }
       return std::pair{escapeFunction(std::move(entity.value())), nullptr};
     }
-    case LocalVocabIndex: {
-      std::string word = localVocab.getWord(id.getLocalVocabIndex());
+    case LocalVocabIndex:
+    case InlineString: {
+      std::string word{datatype == LocalVocabIndex
+                           ? localVocab.getWord(id.getLocalVocabIndex())
+                           : id.getInlineString().view()};
       if constexpr (onlyReturnLiterals) {
         if (!word.starts_with('"')) {
           return std::nullopt;
@@ -225,10 +684,23 @@ ExportQueryExecutionTrees::idToStringAndType(const Index& index, Id id,
       }
       return std::pair{escapeFunction(std::move(word)), nullptr};
     }
-    case TextRecordIndex:
+    case EncodedIri: {
+      std::string iri = index.getVocab().getEncodedIriManager().toString(id);
+      if constexpr (removeQuotesAndAngleBrackets) {
+        iri = RdfEscaping::normalizedContentFromLiteralOrIri(std::move(iri));
+      }
+      return std::pair{escapeFunction(std::move(iri)), nullptr};
+    }
+    case TextRecordIndex: {
+      if (vocabWords != nullptr) {
+        auto it = vocabWords->find(id);
+        AD_CONTRACT_CHECK(it != vocabWords->end());
+        return std::pair{escapeFunction(it->second), nullptr};
+      }
       return std::pair{
           escapeFunction(index.getTextExcerpt(id.getTextRecordIndex())),
           nullptr};
+    }
   }
   AD_FAIL();
 }
@@ -236,13 +708,13 @@ ExportQueryExecutionTrees::idToStringAndType(const Index& index, Id id,
 template std::optional<std::pair<std::string, const char*>>
 ExportQueryExecutionTrees::idToStringAndType<true, false, std::identity>(
     const Index& index, Id id, const LocalVocab& localVocab,
-    std::identity&& escapeFunction);
+    std::identity&& escapeFunction, const VocabWords* vocabWords);
 
 // ___________________________________________________________________________
 template std::optional<std::pair<std::string, const char*>>
 ExportQueryExecutionTrees::idToStringAndType<true, true, std::identity>(
     const Index& index, Id id, const LocalVocab& localVocab,
-    std::identity&& escapeFunction);
+    std::identity&& escapeFunction, const VocabWords* vocabWords);
 
 // This explicit instantiation is necessary because the `Variable` class
 // currently still uses it.
@@ -251,7 +723,71 @@ ExportQueryExecutionTrees::idToStringAndType<true, true, std::identity>(
 template std::optional<std::pair<std::string, const char*>>
 ExportQueryExecutionTrees::idToStringAndType(const Index& index, Id id,
                                              const LocalVocab& localVocab,
-                                             std::identity&& escapeFunction);
+                                             std::identity&& escapeFunction,
+                                             const VocabWords* vocabWords);
+
+// _____________________________________________________________________________
+std::optional<std::string> ExportQueryExecutionTrees::idToConstructString(
+    const Index& index, Id id, const LocalVocab& localVocab,
+    const VocabWords* vocabWords) {
+  auto optionalStringAndType =
+      idToStringAndType(index, id, localVocab, std::identity{}, vocabWords);
+  if (!optionalStringAndType.has_value()) {
+    return std::nullopt;
+  }
+  auto& [literal, type] = optionalStringAndType.value();
+  const char* i = XSD_INT_TYPE;
+  const char* d = XSD_DECIMAL_TYPE;
+  const char* b = XSD_BOOLEAN_TYPE;
+  if (type == nullptr || type == i || type == d || type == b) {
+    return std::move(literal);
+  } else {
+    return absl::StrCat("\"", literal, "\"^^<", type, ">");
+  }
+}
+
+// _____________________________________________________________________________
+ExportQueryExecutionTrees::VocabWords
+ExportQueryExecutionTrees::getVocabWordsOfBatch(
+    const Index& index, const IdTable& idTable,
+    const QueryExecutionTree::ColumnIndicesAndTypes& columns,
+    std::ranges::iota_view<uint64_t, uint64_t> rows) {
+  std::vector<Id> ids;
+  std::vector<TextRecordIndex> textRecords;
+  for (const auto& column : columns) {
+    if (!column.has_value()) {
+      continue;
+    }
+    decltype(auto) col = idTable.getColumn(column.value().columnIndex_);
+    for (uint64_t i : rows) {
+      if (col[i].getDatatype() == Datatype::VocabIndex) {
+        ids.push_back(col[i]);
+      } else if (col[i].getDatatype() == Datatype::TextRecordIndex) {
+        textRecords.push_back(col[i].getTextRecordIndex());
+      }
+    }
+  }
+  // The `Id`s with datatype `VocabIndex` are sorted by their index in the
+  // vocabulary, the text records by their index in the DocsDB.
+  std::ranges::sort(ids);
+  ids.erase(std::ranges::unique(ids).begin(), ids.end());
+  std::ranges::sort(textRecords);
+  textRecords.erase(std::ranges::unique(textRecords).begin(),
+                    textRecords.end());
+  VocabWords words;
+  words.reserve(ids.size() + textRecords.size());
+  for (Id id : ids) {
+    std::optional<string> word = index.idToOptionalString(id.getVocabIndex());
+    AD_CONTRACT_CHECK(word.has_value());
+    words.emplace(id, std::move(word.value()));
+  }
+  auto excerpts = index.getTextExcerpts(textRecords);
+  for (size_t i = 0; i < textRecords.size(); ++i) {
+    words.emplace(Id::makeFromTextRecordIndex(textRecords[i]),
+                  std::move(excerpts[i]));
+  }
+  return words;
+}
 
 // _____________________________________________________________________________
 nlohmann::json ExportQueryExecutionTrees::selectQueryResultToSparqlJSON(
@@ -297,50 +833,6 @@ nlohmann::json ExportQueryExecutionTrees::selectQueryResultToSparqlJSON(
     return result;
   }
 
-  // Take a string from the vocabulary, deduce the type and
-  // return a JSON dict that describes the binding.
-  auto stringToBinding = [](std::string_view entitystr) -> nlohmann::json {
-    nlohmann::ordered_json b;
-    // The string is an IRI or literal.
-    if (entitystr.starts_with('<')) {
-      // Strip the <> surrounding the iri.
-      b["value"] = entitystr.substr(1, entitystr.size() - 2);
-      // Even if they are technically IRIs, the format needs the type to be
-      // "uri".
-      b["type"] = "uri";
-    } else if (entitystr.starts_with("_:")) {
-      b["value"] = entitystr.substr(2);
-      b["type"] = "bnode";
-    } else {
-      // TODO<joka921> This is probably not quite correct in the corner case
-      // that there are datatype IRIs which contain quotes.
-      size_t quotePos = entitystr.rfind('"');
-      if (quotePos == std::string::npos) {
-        // TEXT entries are currently not surrounded by quotes
-        b["value"] = entitystr;
-        b["type"] = "literal";
-      } else {
-        b["value"] = entitystr.substr(1, quotePos - 1);
-        b["type"] = "literal";
-        // Look for a language tag or type.
-        if (quotePos < entitystr.size() - 1 && entitystr[quotePos + 1] == '@') {
-          b["xml:lang"] = entitystr.substr(quotePos + 2);
-        } else if (quotePos < entitystr.size() - 2 &&
-                   entitystr[quotePos + 1] == '^') {
-          AD_CONTRACT_CHECK(entitystr[quotePos + 2] == '^');
-          std::string_view datatype{entitystr};
-          // remove the <angledBrackets> around the datatype IRI
-          AD_CONTRACT_CHECK(datatype.size() >= quotePos + 5);
-          datatype.remove_prefix(quotePos + 4);
-          datatype.remove_suffix(1);
-          b["datatype"] = datatype;
-          ;
-        }
-      }
-    }
-    return b;
-  };
-
   for (size_t rowIndex : getRowIndices(limitAndOffset, idTable)) {
     // TODO: ordered_json` entries are ordered alphabetically, but insertion
     // order would be preferable.
@@ -353,15 +845,15 @@ nlohmann::json ExportQueryExecutionTrees::selectQueryResultToSparqlJSON(
         continue;
       }
       const auto& [stringValue, xsdType] = optionalValue.value();
+      auto parts = getSparqlJSONBinding(stringValue, xsdType);
       nlohmann::ordered_json b;
-      if (!xsdType) {
-        // No xsdType, this means that `stringValue` is a plain string literal
-        // or entity.
-        b = stringToBinding(stringValue);
-      } else {
-        b["value"] = stringValue;
-        b["type"] = "literal";
-        b["datatype"] = xsdType;
+      b["value"] = parts.value_;
+      b["type"] = parts.type_;
+      if (parts.datatype_.has_value()) {
+        b["datatype"] = parts.datatype_.value();
+      }
+      if (parts.language_.has_value()) {
+        b["xml:lang"] = parts.language_.value();
       }
       binding[column->variable_] = std::move(b);
     }
@@ -409,8 +901,9 @@ ExportQueryExecutionTrees::selectQueryResultToStream(
   AD_CONTRACT_CHECK(format != MediaType::turtle);
 
   // This call triggers the possibly expensive computation of the query result
-  // unless the result is already cached.
-  shared_ptr<const ResultTable> resultTable = qet.getResult();
+  // unless the result is already cached. If supported by the operations of the
+  // query, the result is computed lazily and exported block by block.
+  shared_ptr<const ResultTable> resultTable = qet.getResult(true);
   resultTable->logResultSize();
   LOG(DEBUG) << "Converting result IDs to their corresponding strings ..."
              << std::endl;
@@ -422,15 +915,18 @@ ExportQueryExecutionTrees::selectQueryResultToStream(
   // appear in the query body?
   AD_CONTRACT_CHECK(!selectedColumnIndices.empty());
 
-  const auto& idTable = resultTable->idTable();
   // special case : binary export of IdTable
   if constexpr (format == MediaType::octetStream) {
-    for (size_t i : getRowIndices(limitAndOffset, idTable)) {
-      for (const auto& columnIndex : selectedColumnIndices) {
-        if (columnIndex.has_value()) {
-          co_yield std::string_view{reinterpret_cast<const char*>(&idTable(
-                                        i, columnIndex.value().columnIndex_)),
-                                    sizeof(Id)};
+    for (const auto& [idTable, localVocab, range] :
+         getIdTables(*resultTable, limitAndOffset)) {
+      for (size_t i : range) {
+        for (const auto& columnIndex : selectedColumnIndices) {
+          if (columnIndex.has_value()) {
+            co_yield std::string_view{
+                reinterpret_cast<const char*>(
+                    &idTable(i, columnIndex.value().columnIndex_)),
+                sizeof(Id)};
+          }
         }
       }
     }
@@ -452,32 +948,50 @@ ExportQueryExecutionTrees::selectQueryResultToStream(
   constexpr auto& escapeFunction = format == MediaType::tsv
                                        ? RdfEscaping::escapeForTsv
                                        : RdfEscaping::escapeForCsv;
-  for (size_t i : getRowIndices(limitAndOffset, idTable)) {
-    for (size_t j = 0; j < selectedColumnIndices.size(); ++j) {
-      if (selectedColumnIndices[j].has_value()) {
-        const auto& val = selectedColumnIndices[j].value();
-        Id id = idTable(i, val.columnIndex_);
-        auto optionalStringAndType =
-            idToStringAndType<format == MediaType::csv>(
-                qet.getQec()->getIndex(), id, resultTable->localVocab(),
-                escapeFunction);
-        if (optionalStringAndType.has_value()) [[likely]] {
-          co_yield optionalStringAndType.value().first;
+  const auto& index = qet.getQec()->getIndex();
+  for (const auto& [idTable, localVocab, range] :
+       getIdTables(*resultTable, limitAndOffset)) {
+    auto formatBatch = [&index, &selectedColumnIndices, &escapeFunction,
+                        &idTable = idTable,
+                        &localVocab = localVocab](auto batch) {
+      auto vocabWords =
+          getVocabWordsOfBatch(index, idTable, selectedColumnIndices, batch);
+      std::string result;
+      for (size_t i : batch) {
+        for (size_t j = 0; j < selectedColumnIndices.size(); ++j) {
+          if (selectedColumnIndices[j].has_value()) {
+            const auto& val = selectedColumnIndices[j].value();
+            Id id = idTable(i, val.columnIndex_);
+            auto optionalStringAndType =
+                idToStringAndType<format == MediaType::csv>(
+                    index, id, localVocab, escapeFunction, &vocabWords);
+            if (optionalStringAndType.has_value()) [[likely]] {
+              result.append(optionalStringAndType.value().first);
+            }
+          }
+          result.push_back(j + 1 < selectedColumnIndices.size() ? separator
+                                                                : '\n');
         }
       }
-      co_yield j + 1 < selectedColumnIndices.size() ? separator : '\n';
+      return result;
+    };
+    for (const std::string& formatted :
+         formatBatchesInParallel(range, formatBatch)) {
+      co_yield formatted;
     }
   }
   LOG(DEBUG) << "Done creating readable result.\n";
 }
 
 // Convert a single ID to an XML binding of the given `variable`.
-static std::string idToXMLBinding(std::string_view variable, Id id,
-                                  const auto& index, const auto& localVocab) {
+static std::string idToXMLBinding(
+    std::string_view variable, Id id, const auto& index,
+    const auto& localVocab,
+    const ExportQueryExecutionTrees::VocabWords& vocabWords) {
   using namespace std::string_view_literals;
   using namespace std::string_literals;
-  const auto& optionalValue =
-      ExportQueryExecutionTrees::idToStringAndType(index, id, localVocab);
+  const auto& optionalValue = ExportQueryExecutionTrees::idToStringAndType(
+      index, id, localVocab, std::identity{}, &vocabWords);
   if (!optionalValue.has_value()) {
     return ""s;
   }
@@ -556,8 +1070,9 @@ ad_utility::streams::stream_generator ExportQueryExecutionTrees::
   std::vector<std::string> variables =
       selectClause.getSelectedVariablesAsStrings();
   // This call triggers the possibly expensive computation of the query result
-  // unless the result is already cached.
-  shared_ptr<const ResultTable> resultTable = qet.getResult();
+  // unless the result is already cached. If supported by the operations of the
+  // query, the result is computed lazily and exported block by block.
+  shared_ptr<const ResultTable> resultTable = qet.getResult(true);
 
   // In the XML format, the variables don't include the question mark.
   auto varsWithoutQuestionMark = std::views::transform(
@@ -570,26 +1085,221 @@ ad_utility::streams::stream_generator ExportQueryExecutionTrees::
   co_yield "\n<results>";
 
   resultTable->logResultSize();
-  const auto& idTable = resultTable->idTable();
   auto selectedColumnIndices =
       qet.selectedVariablesToColumnIndices(selectClause, false);
   // TODO<joka921> we could prefilter for the nonexisting variables.
-  for (size_t i : getRowIndices(limitAndOffset, idTable)) {
-    co_yield "\n  <result>";
-    for (size_t j = 0; j < selectedColumnIndices.size(); ++j) {
-      if (selectedColumnIndices[j].has_value()) {
-        const auto& val = selectedColumnIndices[j].value();
-        Id id = idTable(i, val.columnIndex_);
-        co_yield idToXMLBinding(val.variable_, id, qet.getQec()->getIndex(),
-                                resultTable->localVocab());
+  const auto& index = qet.getQec()->getIndex();
+  for (const auto& [idTable, localVocab, range] :
+       getIdTables(*resultTable, limitAndOffset)) {
+    auto formatBatch = [&index, &selectedColumnIndices, &idTable = idTable,
+                        &localVocab = localVocab](auto batch) {
+      auto vocabWords =
+          getVocabWordsOfBatch(index, idTable, selectedColumnIndices, batch);
+      std::string result;
+      for (size_t i : batch) {
+        result.append("\n  <result>");
+        for (size_t j = 0; j < selectedColumnIndices.size(); ++j) {
+          if (selectedColumnIndices[j].has_value()) {
+            const auto& val = selectedColumnIndices[j].value();
+            Id id = idTable(i, val.columnIndex_);
+            result.append(idToXMLBinding(val.variable_, id, index, localVocab,
+                                         vocabWords));
+          }
+        }
+        result.append("\n  </result>");
       }
+      return result;
+    };
+    for (const std::string& formatted :
+         formatBatchesInParallel(range, formatBatch)) {
+      co_yield formatted;
     }
-    co_yield "\n  </result>";
   }
   co_yield "\n</results>";
   co_yield "\n</sparql>";
 }
 
+// _____________________________________________________________________________
+template <>
+ad_utility::streams::stream_generator ExportQueryExecutionTrees::
+    selectQueryResultToStream<ad_utility::MediaType::sparqlJson>(
+        const QueryExecutionTree& qet,
+        const parsedQuery::SelectClause& selectClause,
+        LimitOffsetClause limitAndOffset) {
+  // This call triggers the possibly expensive computation of the query result
+  // unless the result is already cached. If supported by the operations of the
+  // query, the result is computed lazily and exported block by block.
+  shared_ptr<const ResultTable> resultTable = qet.getResult(true);
+  resultTable->logResultSize();
+
+  // The result is never built as a whole in memory, but formatted and yielded
+  // in batches of rows.
+  std::string buffer = "{\"head\":{\"vars\":[";
+  std::vector<std::string> variables =
+      selectClause.getSelectedVariablesAsStrings();
+  for (size_t i = 0; i < variables.size(); ++i) {
+    if (i > 0) {
+      buffer.push_back(',');
+    }
+    // The variables don't include the question mark.
+    appendJSONString(buffer, std::string_view{variables[i]}.substr(1));
+  }
+  buffer.append("]},\"results\":{\"bindings\":[");
+  co_yield buffer;
+
+  // The `false` means "Don't include the question mark in the variable names".
+  auto columns = qet.selectedVariablesToColumnIndices(selectClause, false);
+  std::erase(columns, std::nullopt);
+  if (columns.empty()) {
+    LOG(WARN) << "Exporting a SPARQL query where none of the selected "
+                 "variables is bound in the query"
+              << std::endl;
+    co_yield "]}}";
+    co_return;
+  }
+
+  const auto& index = qet.getQec()->getIndex();
+  bool isFirstBatch = true;
+  for (const auto& [idTable, localVocab, range] :
+       getIdTables(*resultTable, limitAndOffset)) {
+    // The rows of a batch are separated by commas. The batches are never empty.
+    auto formatBatch = [&index, &columns, &idTable = idTable,
+                        &localVocab = localVocab](auto batch) {
+      auto vocabWords = getVocabWordsOfBatch(index, idTable, columns, batch);
+      std::string result;
+      for (size_t i : batch) {
+        result.append(result.empty() ? "{" : ",{");
+        bool isFirstBinding = true;
+        for (const auto& column : columns) {
+          Id id = idTable(i, column->columnIndex_);
+          auto optionalValue = idToStringAndType(index, id, localVocab,
+                                                 std::identity{}, &vocabWords);
+          if (!optionalValue.has_value()) {
+            continue;
+          }
+          if (!isFirstBinding) {
+            result.push_back(',');
+          }
+          isFirstBinding = false;
+          appendJSONString(result, column->variable_);
+          result.push_back(':');
+          const auto& [stringValue, xsdType] = optionalValue.value();
+          appendSparqlJSONBinding(result,
+                                  getSparqlJSONBinding(stringValue, xsdType));
+        }
+        result.push_back('}');
+      }
+      return result;
+    };
+    for (const std::string& formatted :
+         formatBatchesInParallel(range, formatBatch)) {
+      if (!isFirstBatch) {
+        co_yield ',';
+      }
+      isFirstBatch = false;
+      co_yield formatted;
+    }
+  }
+  co_yield "]}}";
+}
+
+// _____________________________________________________________________________
+template <>
+ad_utility::streams::stream_generator ExportQueryExecutionTrees::
+    selectQueryResultToStream<ad_utility::MediaType::arrow>(
+        const QueryExecutionTree& qet,
+        const parsedQuery::SelectClause& selectClause,
+        LimitOffsetClause limitAndOffset) {
+  namespace arrow = ad_utility::arrow;
+  // The types of the columns are part of the schema at the beginning of the
+  // stream and depend on all the values of a column, so the result has to be
+  // fully materialized.
+  shared_ptr<const ResultTable> resultTable = qet.getResult();
+  resultTable->logResultSize();
+  const IdTable& idTable = resultTable->idTable();
+  const LocalVocab& localVocab = resultTable->localVocab();
+  auto range = getRowIndices(limitAndOffset, idTable);
+
+  // The `false` means "Don't include the question mark in the variable names".
+  auto columns = qet.selectedVariablesToColumnIndices(selectClause, false);
+  std::vector<std::string> variables =
+      selectClause.getSelectedVariablesAsStrings();
+  AD_CORRECTNESS_CHECK(columns.size() == variables.size());
+  std::vector<arrow::Field> fields;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    fields.push_back(
+        {variables[i].substr(1), getArrowType(idTable, columns[i], range)});
+  }
+  co_yield arrow::schemaMessage(fields);
+
+  // Each batch is a record batch, preceded by the dictionaries of its string
+  // columns, which contain the distinct words of the batch.
+  const auto& index = qet.getQec()->getIndex();
+  auto formatBatch = [&index, &idTable, &localVocab, &columns,
+                      &fields](auto batch) {
+    auto vocabWords = getVocabWordsOfBatch(index, idTable, columns, batch);
+    std::string result;
+    std::vector<arrow::Column> arrowColumns;
+    for (size_t i = 0; i < columns.size(); ++i) {
+      arrow::Type type = fields[i].type_;
+      auto& column = arrowColumns.emplace_back(type);
+      if (!columns[i].has_value()) {
+        for ([[maybe_unused]] uint64_t row : batch) {
+          column.appendNull();
+        }
+        result.append(arrow::dictionaryBatchMessage(i, {}));
+        continue;
+      }
+      decltype(auto) col = idTable.getColumn(columns[i]->columnIndex_);
+      ad_utility::HashMap<Id, int32_t> dictionaryIndices;
+      std::vector<std::string> dictionary;
+      for (uint64_t row : batch) {
+        Id id = col[row];
+        if (id.isUndefined()) {
+          column.appendNull();
+          continue;
+        }
+        using enum arrow::Type;
+        switch (type) {
+          case Int64:
+            column.appendInt(id.getInt());
+            break;
+          case Double:
+            column.appendDouble(id.getDouble());
+            break;
+          case Bool:
+            column.appendBool(id.getBool());
+            break;
+          case Timestamp:
+            column.appendInt(getMillisecondsSinceEpoch(id.getDate().getDate()));
+            break;
+          case DictionaryString: {
+            auto [it, isNew] = dictionaryIndices.try_emplace(
+                id, static_cast<int32_t>(dictionary.size()));
+            if (isNew) {
+              auto optionalValue = idToStringAndType<true>(
+                  index, id, localVocab, std::identity{}, &vocabWords);
+              AD_CORRECTNESS_CHECK(optionalValue.has_value());
+              dictionary.push_back(std::move(optionalValue.value().first));
+            }
+            column.appendIndex(it->second);
+          } break;
+        }
+      }
+      if (type == arrow::Type::DictionaryString) {
+        result.append(arrow::dictionaryBatchMessage(i, dictionary));
+      }
+    }
+    result.append(arrow::recordBatchMessage(arrowColumns));
+    return result;
+  };
+  for (const std::string& formatted :
+       formatBatchesInParallel(range, formatBatch)) {
+    co_yield formatted;
+  }
+  co_yield arrow::endOfStream();
+}
+
 // _____________________________________________________________________________
 
 // _____________________________________________________________________________
@@ -601,26 +1311,33 @@ ExportQueryExecutionTrees::constructQueryResultToStream(
     LimitOffsetClause limitAndOffset,
     std::shared_ptr<const ResultTable> resultTable) {
   static_assert(format == MediaType::octetStream || format == MediaType::csv ||
-                format == MediaType::tsv || format == MediaType::sparqlXml);
+                format == MediaType::tsv || format == MediaType::sparqlXml ||
+                format == MediaType::sparqlJson || format == MediaType::arrow);
   if constexpr (format == MediaType::octetStream) {
     AD_THROW("Binary export is not supported for CONSTRUCT queries");
   } else if constexpr (format == MediaType::sparqlXml) {
     AD_THROW("XML export is currently not supported for CONSTRUCT queries");
+  } else if constexpr (format == MediaType::sparqlJson) {
+    AD_THROW(
+        "SPARQL-compliant JSON format is only supported for SELECT queries");
+  } else if constexpr (format == MediaType::arrow) {
+    AD_THROW("Arrow export is currently not supported for CONSTRUCT queries");
   }
   resultTable->logResultSize();
-  constexpr auto& escapeFunction = format == MediaType::tsv
-                                       ? RdfEscaping::escapeForTsv
-                                       : RdfEscaping::escapeForCsv;
-  constexpr char sep = format == MediaType::tsv ? '\t' : ',';
-  auto generator = ExportQueryExecutionTrees::constructQueryResultToTriples(
-      qet, constructTriples, limitAndOffset, resultTable);
-  for (auto& triple : generator) {
-    co_yield escapeFunction(std::move(triple.subject_));
-    co_yield sep;
-    co_yield escapeFunction(std::move(triple.predicate_));
-    co_yield sep;
-    co_yield escapeFunction(std::move(triple.object_));
-    co_yield "\n";
+  auto formatTriple = [](std::string& out, std::string_view subject,
+                         std::string_view predicate, std::string_view object) {
+    constexpr auto& escapeFunction = format == MediaType::tsv
+                                         ? RdfEscaping::escapeForTsv
+                                         : RdfEscaping::escapeForCsv;
+    constexpr std::string_view sep = format == MediaType::tsv ? "\t" : ",";
+    absl::StrAppend(&out, escapeFunction(std::string{subject}), sep,
+                    escapeFunction(std::string{predicate}), sep,
+                    escapeFunction(std::string{object}), "\n");
+  };
+  for (const std::string& formatted :
+       formatConstructTriples(qet, constructTriples, limitAndOffset,
+                              std::move(resultTable), formatTriple)) {
+    co_yield formatted;
   }
 }
 
@@ -692,8 +1409,42 @@ ExportQueryExecutionTrees::computeResultAsStream(
   };
 
   using enum MediaType;
-  return ad_utility::ConstexprSwitch<csv, tsv, octetStream, turtle, sparqlXml>(
-      compute, mediaType);
+  return ad_utility::ConstexprSwitch<csv, tsv, octetStream, turtle, sparqlXml,
+                                     sparqlJson, arrow>(compute, mediaType);
+}
+
+// _____________________________________________________________________________
+ad_utility::streams::stream_generator
+ExportQueryExecutionTrees::computeResultAsIdTableExchange(
+    const ParsedQuery& parsedQuery, const QueryExecutionTree& qet,
+    std::optional<uint64_t> receiverVocabularyIdentity) {
+  if (!parsedQuery.hasSelectClause()) {
+    AD_THROW(
+        "The exchange format of QLever is only supported for SELECT queries");
+  }
+  shared_ptr<const ResultTable> resultTable = qet.getResult(true);
+  resultTable->logResultSize();
+  std::vector<std::optional<ColumnIndex>> columns;
+  for (const auto& column : qet.selectedVariablesToColumnIndices(
+           parsedQuery.selectClause(), true)) {
+    columns.push_back(column.has_value()
+                          ? std::optional{column.value().columnIndex_}
+                          : std::nullopt);
+  }
+
+  // The frames are encoded one after the other, because the dictionary of each
+  // frame only contains the words that were not sent before.
+  idTableExchange::Encoder encoder{qet.getQec()->getIndex(),
+                                   receiverVocabularyIdentity};
+  co_yield encoder.header(columns.size());
+  for (const auto& [idTable, localVocab, range] :
+       getIdTables(*resultTable, parsedQuery._limitOffset)) {
+    encoder.setLocalVocab(localVocab);
+    for (auto batch : getBatches(range)) {
+      co_yield encoder.frame(idTable, columns, batch);
+    }
+  }
+  co_yield idTableExchange::Encoder::endOfStream();
 }
 
 // _____________________________________________________________________________
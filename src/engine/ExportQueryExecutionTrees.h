@@ -3,9 +3,11 @@
 //  Author: Johannes Kalmbach <kalmbach@cs.uni-freiburg.de>
 
 #include <cstdlib>
+#include <ranges>
 
 #include "engine/QueryExecutionTree.h"
 #include "parser/data/LimitOffsetClause.h"
+#include "util/HashMap.h"
 #include "util/http/MediaTypes.h"
 #include "util/json.h"
 
@@ -23,6 +25,11 @@
 // consumption of large JSON exports and to make this interface even simpler.
 class ExportQueryExecutionTrees {
  public:
+  // The words of the `Id`s with datatype `VocabIndex` and the excerpts of the
+  // `Id`s with datatype `TextRecordIndex` of a batch of rows of a result (see
+  // `getVocabWordsOfBatch`).
+  using VocabWords = ad_utility::HashMap<Id, std::string>;
+
   using MediaType = ad_utility::MediaType;
 
   // Compute the result of the given `parsedQuery` (created by the
@@ -30,15 +37,23 @@ class ExportQueryExecutionTrees {
   // created by the `QueryPlanner`. The result is converted into a sequence of
   // bytes that represents the result of the computed query in the format
   // specified by the `mediaType`. Supported formats for this function are CSV,
-  // TSV, Turtle, Binary. Note that the Binary format can only be used with
-  // SELECT queries and the Turtle format can only be used with CONSTRUCT
-  // queries. Invalid `mediaType`s and invalid combinations of `mediaType` and
-  // the query type will throw. The result is returned as a `stream_generator`
+  // TSV, Turtle, Binary, SPARQL XML, and SPARQL JSON. Note that the Binary and
+  // the SPARQL JSON format can only be used with SELECT queries and the Turtle
+  // format can only be used with CONSTRUCT queries. Invalid `mediaType`s and
+  // invalid combinations of `mediaType` and the query type will throw. The result is returned as a `stream_generator`
   // that lazily computes the serialized result in large chunks of bytes.
   static ad_utility::streams::stream_generator computeResultAsStream(
       const ParsedQuery& parsedQuery, const QueryExecutionTree& qet,
       MediaType mediaType);
 
+  // Compute the result of the given SELECT query in the binary exchange format
+  // of QLever (see `IdTableExchange.h`), which is used for the `SERVICE`
+  // requests between QLever servers. The `receiverVocabularyIdentity` is the
+  // vocabulary identity that the receiver announced in its "Accept" header.
+  static ad_utility::streams::stream_generator computeResultAsIdTableExchange(
+      const ParsedQuery& parsedQuery, const QueryExecutionTree& qet,
+      std::optional<uint64_t> receiverVocabularyIdentity);
+
   // Compute the result of the given `parsedQuery` (created by the
   // `SparqlParser`) for which the `QueryExecutionTree` has been previously
   // created by the `QueryPlanner`. The result is converted to the format
@@ -75,12 +90,27 @@ class ExportQueryExecutionTrees {
   //
   // TODO<joka921> Make it private again as soon as the evaluation of construct
   // queries is completely performed inside this module.
+  //
+  // If `vocabWords` is not `nullptr`, then the words of the `Id`s with datatype
+  // `VocabIndex` and the text excerpts of the `Id`s with datatype
+  // `TextRecordIndex` are taken from it instead of the `index` (see
+  // `getVocabWordsOfBatch` below).
   template <bool removeQuotesAndAngleBrackets = false,
             bool returnOnlyLiterals = false,
             typename EscapeFunction = std::identity>
   static std::optional<std::pair<std::string, const char*>> idToStringAndType(
       const Index& index, Id id, const LocalVocab& localVocab,
-      EscapeFunction&& escapeFunction = EscapeFunction{});
+      EscapeFunction&& escapeFunction = EscapeFunction{},
+      const VocabWords* vocabWords = nullptr);
+
+  // The string of the `id` as a term of a triple of a CONSTRUCT query: IRIs and
+  // literals as they are, the numeric and boolean values without quotes, and
+  // other values with a datatype as `"value"^^<datatype>`. Return
+  // `std::nullopt` if the `id` is undefined. For `vocabWords`, see
+  // `idToStringAndType`.
+  static std::optional<std::string> idToConstructString(
+      const Index& index, Id id, const LocalVocab& localVocab,
+      const VocabWords* vocabWords = nullptr);
 
   // Same as the previous function, but only handles the datatypes for which the
   // value is encoded directly in the ID. For other datatypes an exception is
@@ -88,6 +118,18 @@ class ExportQueryExecutionTrees {
   static std::optional<std::pair<std::string, const char*>>
   idToStringAndTypeForEncodedValue(Id id);
 
+  // Return the words of all the distinct `Id`s with datatype `VocabIndex` that
+  // appear in the given `columns` of the `rows` of the `idTable`. The `Id`s are
+  // resolved in sorted order, s.t. the vocabulary (which might be external and
+  // compressed) is read in a single sequential pass with one lookup per
+  // distinct word, instead of one random access per exported entry. The same
+  // holds for the text excerpts of the `Id`s with datatype `TextRecordIndex`,
+  // each block of which is only read and decompressed once.
+  static VocabWords getVocabWordsOfBatch(
+      const Index& index, const IdTable& idTable,
+      const QueryExecutionTree::ColumnIndicesAndTypes& columns,
+      std::ranges::iota_view<uint64_t, uint64_t> rows);
+
  private:
   // TODO<joka921> The following functions are all internally called by the
   // two public functions above. All the code has been inside QLever for a long
@@ -131,6 +173,13 @@ class ExportQueryExecutionTrees {
       const QueryExecutionTree::ColumnIndicesAndTypes& columns,
       std::shared_ptr<const ResultTable> resultTable = nullptr);
 
+  // Same as above, but without a `QueryExecutionTree` (for a result that is
+  // kept beyond the processing of its query, see `ResultCursors`).
+  static nlohmann::json idTableToQLeverJSONArray(
+      const Index& index, const LimitOffsetClause& limitAndOffset,
+      const QueryExecutionTree::ColumnIndicesAndTypes& columns,
+      const ResultTable& resultTable);
+
   // ___________________________________________________________________________
   static nlohmann::json constructQueryResultBindingsToQLeverJSON(
       const QueryExecutionTree& qet,
@@ -138,7 +187,10 @@ class ExportQueryExecutionTrees {
       const LimitOffsetClause& limitAndOffset,
       std::shared_ptr<const ResultTable> res);
 
-  // Generate an RDF graph for a CONSTRUCT query.
+  // Generate an RDF graph for a CONSTRUCT query. The strings of the triples
+  // are resolved batch by batch (see `ConstructTripleEvaluator` in the
+  // `.cpp` file). If the runtime parameter `construct-export-deduplicate` is
+  // set, each distinct triple is only generated once.
   static cppcoro::generator<QueryExecutionTree::StringTriple>
   constructQueryResultToTriples(
       const QueryExecutionTree& qet,
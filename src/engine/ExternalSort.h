@@ -0,0 +1,208 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <unistd.h>
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "engine/LocalVocab.h"
+#include "engine/ResultTable.h"
+#include "engine/RuntimeInformation.h"
+#include "engine/idTable/CompressedExternalIdTable.h"
+#include "engine/idTable/IdTable.h"
+#include "global/Constants.h"
+#include "util/AllocatorWithLimit.h"
+#include "util/Timer.h"
+
+// Sorting of query results that may be too large to be sorted in RAM. This is
+// used by the `Sort` and `OrderBy` operations. Results that fit into the
+// `sort-external-memory-budget` are sorted in RAM as before. Larger results
+// are sorted via the `CompressedExternalIdTableSorter`, which writes sorted and
+// compressed runs to the `sort-spill-directory` and merges them afterwards.
+namespace ad_utility::externalSort {
+
+// Return a filename in the `sort-spill-directory` that is unique for this
+// process and this call.
+inline std::string getFilenameForExternalSort() {
+  static std::atomic<size_t> counter = 0;
+  std::filesystem::path directory =
+      RuntimeParameters().get<"sort-spill-directory">();
+  if (directory.empty()) {
+    directory = std::filesystem::temp_directory_path();
+  }
+  return directory / absl::StrCat("qlever-external-sort-", ::getpid(), "-",
+                                  counter++, ".dat");
+}
+
+// Return the amount of memory that the `table` occupies.
+inline MemorySize getMemorySize(const IdTable& table) {
+  return MemorySize::bytes(table.numRows() * table.numColumns() * sizeof(Id));
+}
+
+// Append the words of `blockVocab` to the `targetVocab` and change all the
+// `LocalVocabIndex` `Id`s in the `block` s.t. they refer to the `targetVocab`.
+inline void mergeLocalVocabInto(IdTable& block, LocalVocab& blockVocab,
+                                LocalVocab& targetVocab) {
+  if (blockVocab.empty()) {
+    return;
+  }
+  if (targetVocab.empty()) {
+    targetVocab = std::move(blockVocab);
+    return;
+  }
+  // The words are not copied, `targetVocab` shares them with `blockVocab`.
+  auto newIndexes = targetVocab.mergeWith(blockVocab);
+  for (size_t col = 0; col < block.numColumns(); ++col) {
+    for (Id& id : block.getColumn(col)) {
+      if (id.getDatatype() == Datatype::LocalVocabIndex) {
+        id = Id::makeFromLocalVocabIndex(
+            newIndexes.at(id.getLocalVocabIndex().get()));
+      }
+    }
+  }
+}
+
+namespace detail {
+// Yield the sorted blocks of the `sorter`. Each block is paired with a copy of
+// the `localVocab`, to which all the blocks refer.
+template <typename Sorter>
+ResultTable::Generator yieldSortedBlocks(std::unique_ptr<Sorter> sorter,
+                                         LocalVocab localVocab) {
+  for (auto& block : sorter->template getSortedBlocks<0>()) {
+    co_yield ResultTable::IdTableVocabPair{IdTable{std::move(block)},
+                                           localVocab.clone()};
+  }
+}
+}  // namespace detail
+
+// Sort the `input` (which may be lazy) according to the `comparison`. The
+// `sortInMemory` function is used for inputs that fit into the
+// `sort-external-memory-budget`, the `comparison` must describe the same order
+// and is used for the external sort of larger inputs. A materialized input has
+// to be copied before it is sorted in RAM, unless a `sortedCopyInMemory`
+// function is given, which directly returns a sorted copy of its argument. A
+// lazy input is consumed block by block without such a copy. If the input was
+// sorted externally and `requestLaziness` is true, the result is yielded
+// lazily block by block directly from the merge phase of the external sort.
+template <typename Comparison>
+ResultTable sortWithSpilling(std::shared_ptr<const ResultTable> input,
+                             size_t numColumns,
+                             std::vector<ColumnIndex> sortedOn,
+                             const std::function<void(IdTable&)>& sortInMemory,
+                             Comparison comparison,
+                             const AllocatorWithLimit<Id>& allocator,
+                             bool requestLaziness,
+                             RuntimeInformation& runtimeInfo,
+                             const std::function<IdTable(const IdTable&)>&
+                                 sortedCopyInMemory = nullptr) {
+  const MemorySize budget =
+      RuntimeParameters().get<"sort-external-memory-budget">();
+  using Sorter = CompressedExternalIdTableSorter<Comparison, 0>;
+  std::unique_ptr<Sorter> sorter;
+  auto createSorter = [&]() {
+    MemorySize memory = std::min(budget, allocator.amountMemoryLeft() / 2);
+    sorter = std::make_unique<Sorter>(
+        getFilenameForExternalSort(), numColumns, memory, allocator,
+        DEFAULT_BLOCKSIZE_EXTERNAL_ID_TABLE, comparison);
+  };
+
+  // Try to sort the `table` in RAM and fall back to the external sort if there
+  // is not enough memory. The in-memory sort keeps the rows of the `table`
+  // intact even if it fails, so they can then be pushed to the sorter.
+  auto sortInMemoryOrPush = [&](IdTable& table) {
+    try {
+      sortInMemory(table);
+      return true;
+    } catch (const ad_utility::detail::AllocationExceedsLimitException&) {
+      createSorter();
+      sorter->pushBlock(table);
+      return false;
+    }
+  };
+
+  LocalVocab localVocab;
+  if (input->isFullyMaterialized()) {
+    const IdTable& inputTable = input->idTable();
+    if (getMemorySize(inputTable) <= budget && sortedCopyInMemory) {
+      try {
+        ad_utility::Timer t{ad_utility::timer::Timer::InitialStatus::Started};
+        IdTable table = sortedCopyInMemory(inputTable);
+        runtimeInfo.addDetail("time-sorting-into-copy", t.msecs());
+        return {std::move(table), std::move(sortedOn),
+                input->getSharedLocalVocab()};
+      } catch (const ad_utility::detail::AllocationExceedsLimitException&) {
+        // There is not enough memory for the sorted copy, sort externally.
+      }
+    } else if (getMemorySize(inputTable) <= budget) {
+      std::optional<IdTable> table;
+      try {
+        ad_utility::Timer t{ad_utility::timer::Timer::InitialStatus::Started};
+        table = inputTable.clone();
+        runtimeInfo.addDetail("time-cloning", t.msecs());
+      } catch (const ad_utility::detail::AllocationExceedsLimitException&) {
+        // There is not enough memory to copy the input, sort it externally.
+      }
+      if (table.has_value() && sortInMemoryOrPush(table.value())) {
+        return {std::move(table).value(), std::move(sortedOn),
+                input->getSharedLocalVocab()};
+      }
+    }
+    if (!sorter) {
+      createSorter();
+      sorter->pushBlock(inputTable);
+    }
+    localVocab = input->localVocab().clone();
+  } else {
+    // Collect the blocks in RAM as long as they fit into the budget.
+    std::optional<IdTable> collected;
+    for (auto& [block, blockVocab] : input->idTables()) {
+      mergeLocalVocabInto(block, blockVocab, localVocab);
+      if (!sorter) {
+        MemorySize collectedSize = collected.has_value()
+                                       ? getMemorySize(collected.value())
+                                       : MemorySize::bytes(0);
+        if (collectedSize + getMemorySize(block) <= budget) {
+          if (collected.has_value()) {
+            collected.value().insertAtEnd(block);
+          } else {
+            collected = std::move(block);
+          }
+          continue;
+        }
+        createSorter();
+        if (collected.has_value()) {
+          sorter->pushBlock(collected.value());
+          collected.reset();
+        }
+      }
+      sorter->pushBlock(block);
+    }
+    if (!sorter) {
+      IdTable table =
+          std::move(collected).value_or(IdTable{numColumns, allocator});
+      if (sortInMemoryOrPush(table)) {
+        return {std::move(table), std::move(sortedOn), std::move(localVocab)};
+      }
+    }
+  }
+
+  runtimeInfo.addDetail("sorted-externally", true);
+  if (requestLaziness) {
+    return {detail::yieldSortedBlocks(std::move(sorter), std::move(localVocab)),
+            std::move(sortedOn)};
+  }
+  IdTable result{numColumns, allocator};
+  for (const auto& block : sorter->template getSortedBlocks<0>()) {
+    result.insertAtEnd(block);
+  }
+  return {std::move(result), std::move(sortedOn), std::move(localVocab)};
+}
+}  // namespace ad_utility::externalSort
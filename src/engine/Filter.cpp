@@ -7,14 +7,19 @@
 #include "./Filter.h"
 
 #include <algorithm>
+#include <cmath>
 #include <optional>
 #include <sstream>
 
 #include "engine/CallFixedSize.h"
+#include "engine/IndexScan.h"
 #include "engine/QueryExecutionTree.h"
 #include "engine/sparqlExpressions/SparqlExpression.h"
 #include "engine/sparqlExpressions/SparqlExpressionGenerators.h"
 #include "engine/sparqlExpressions/SparqlExpressionValueGetters.h"
+#include "index/PredicateHistograms.h"
+#include "index/VocabularyValues.h"
+#include "util/ParallelExecution.h"
 
 using std::endl;
 using std::string;
@@ -43,54 +48,274 @@ string Filter::getDescriptor() const {
 }
 
 // _____________________________________________________________________________
-ResultTable Filter::computeResult() {
+ResultTable Filter::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "Getting sub-result for Filter result computation..." << endl;
-  shared_ptr<const ResultTable> subRes = _subtree->getResult();
+  shared_ptr<const ResultTable> subRes = getSubresult(requestLaziness);
+  if (!subRes->isFullyMaterialized()) {
+    return {filterLazily(std::move(subRes)), resultSortedOn()};
+  }
+  // If the parent can consume a lazy result, the filtered rows are not copied
+  // into a single table, but yielded chunk by chunk of the input.
+  if (requestLaziness) {
+    return {filterMaterializedLazily(std::move(subRes)), resultSortedOn()};
+  }
   LOG(DEBUG) << "Filter result computation..." << endl;
 
-  IdTable idTable{getExecutionContext()->getAllocator()};
-  idTable.setNumColumns(subRes->idTable().numColumns());
-
-  size_t width = idTable.numColumns();
-  CALL_FIXED_SIZE(width, &Filter::computeFilterImpl, this, &idTable, *subRes);
+  const IdTable& input = subRes->idTable();
+  IdTable idTable = filterIdTable(input, subRes->localVocab(),
+                                  subRes->sortedBy(), 0, input.numRows());
   LOG(DEBUG) << "Filter result computation done." << endl;
 
   return {std::move(idTable), resultSortedOn(), subRes->getSharedLocalVocab()};
 }
 
+// _____________________________________________________________________________
+std::optional<ResultTable> Filter::computeResultWithSemiJoinFilter(
+    const Variable& variable, std::span<const Id> values) {
+  auto subRes =
+      _subtree->getRootOperation()->getResultWithSemiJoinFilter(variable,
+                                                                values);
+  if (subRes == nullptr) {
+    return std::nullopt;
+  }
+  const IdTable& input = subRes->idTable();
+  IdTable idTable = filterIdTable(input, subRes->localVocab(),
+                                  subRes->sortedBy(), 0, input.numRows());
+  return ResultTable{std::move(idTable), resultSortedOn(),
+                     subRes->getSharedLocalVocab()};
+}
+
+// _____________________________________________________________________________
+std::shared_ptr<const ResultTable> Filter::getSubresult(bool requestLaziness) {
+  auto* scan = dynamic_cast<IndexScan*>(_subtree->getRootOperation().get());
+  if (scan == nullptr) {
+    return _subtree->getResult(requestLaziness);
+  }
+  auto comparison = _expression.getVariableComparison();
+  auto dateRange = comparison.has_value() ? std::nullopt
+                                          : _expression.getDateRange();
+  auto idRange = dateRange.has_value() ? dateRange->getIdRange() : std::nullopt;
+  auto prefixFilter = comparison.has_value() || idRange.has_value()
+                          ? std::nullopt
+                          : _expression.getPrefixFilter();
+  auto substringFilter =
+      comparison.has_value() || idRange.has_value() || prefixFilter.has_value()
+          ? std::nullopt
+          : _expression.getSubstringFilter();
+  auto substringRanges = substringFilter.has_value()
+                             ? substringFilter->getIdRanges(getIndex())
+                             : std::nullopt;
+  if (!comparison.has_value() && !idRange.has_value() &&
+      !prefixFilter.has_value() && !substringRanges.has_value()) {
+    return _subtree->getResult(requestLaziness);
+  }
+  // Use the result of the scan if it is cached, else let the scan skip the
+  // blocks that cannot contain matching rows.
+  if (auto cached = scan->getResult(false, ComputationMode::ONLY_IF_CACHED)) {
+    return cached;
+  }
+  std::optional<ResultTable> result;
+  if (comparison.has_value()) {
+    result = scan->computeResultWithPrefilter(
+        comparison->variable_, comparison->comparison_, comparison->constant_,
+        requestLaziness);
+  } else if (prefixFilter.has_value()) {
+    result = scan->computeResultWithPrefilter(
+        prefixFilter->variable_, prefixFilter->getIdRanges(getIndex()),
+        requestLaziness);
+  } else if (substringRanges.has_value()) {
+    result = scan->computeResultWithPrefilter(
+        substringFilter->variable_, substringRanges.value(), requestLaziness);
+  } else {
+    std::vector<std::pair<Id, Id>> ranges{idRange.value()};
+    // Dates that are stored in the vocabulary (see `DateValueGetter`) can lie
+    // anywhere in the range of the `VocabIndex` values.
+    if (!getIndex().getVocabularyValues().empty()) {
+      ranges.emplace_back(
+          Id::makeFromVocabIndex(VocabIndex::make(0)),
+          Id::makeFromVocabIndex(VocabIndex::make(Id::maxIndex)));
+    }
+    result = scan->computeResultWithPrefilter(dateRange->variable_, ranges,
+                                              requestLaziness);
+  }
+  if (!result.has_value()) {
+    return _subtree->getResult(requestLaziness);
+  }
+  scan->updateRuntimeInformationWhenOptimizedOut({});
+  return std::make_shared<const ResultTable>(std::move(result).value());
+}
+
+// _____________________________________________________________________________
+ResultTable::Generator Filter::filterLazily(
+    std::shared_ptr<const ResultTable> subRes) {
+  for (auto& [idTable, localVocab] : subRes->idTables()) {
+    IdTable filtered = filterIdTable(idTable, localVocab, subRes->sortedBy(), 0,
+                                     idTable.numRows());
+    checkCancellation();
+    if (!filtered.empty()) {
+      co_yield ResultTable::IdTableVocabPair{std::move(filtered),
+                                             std::move(localVocab)};
+    }
+  }
+}
+
+// _____________________________________________________________________________
+ResultTable::Generator Filter::filterMaterializedLazily(
+    std::shared_ptr<const ResultTable> subRes) {
+  const IdTable& input = subRes->idTable();
+  // Each chunk consists of one morsel per thread (see `filterIdTable`).
+  size_t morselSize =
+      std::max(RuntimeParameters().get<"expression-morsel-size">(), size_t{1});
+  size_t numThreads = getExecutionContext()->getNumThreads(
+      RuntimeParameters().get<"expression-num-threads">());
+  size_t chunkSize = morselSize * std::max(numThreads, size_t{1});
+  for (size_t begin = 0; begin < input.numRows(); begin += chunkSize) {
+    size_t end = std::min(begin + chunkSize, input.numRows());
+    IdTable filtered = filterIdTable(input, subRes->localVocab(),
+                                     subRes->sortedBy(), begin, end);
+    checkCancellation();
+    if (!filtered.empty()) {
+      co_yield ResultTable::IdTableVocabPair{std::move(filtered),
+                                             subRes->getCopyOfLocalVocab()};
+    }
+  }
+}
+
+// _____________________________________________________________________________
+IdTable Filter::filterIdTable(const IdTable& inputTable,
+                              const LocalVocab& localVocab,
+                              const std::vector<ColumnIndex>& sortedBy,
+                              size_t beginRow, size_t endRow) {
+  size_t width = inputTable.numColumns();
+  IdTable idTable{width, getExecutionContext()->getAllocator()};
+  AD_CONTRACT_CHECK(beginRow <= endRow && endRow <= inputTable.numRows());
+  size_t numRows = endRow - beginRow;
+  size_t morselSize =
+      std::max(RuntimeParameters().get<"expression-morsel-size">(), size_t{1});
+  size_t numThreads = getExecutionContext()->getNumThreads(
+      RuntimeParameters().get<"expression-num-threads">());
+  if (numRows <= morselSize || numThreads <= 1) {
+    CALL_FIXED_SIZE(width, &Filter::computeFilterImpl, this, &idTable,
+                    inputTable, localVocab, sortedBy, beginRow, endRow);
+    return idTable;
+  }
+
+  // Filter the morsels concurrently and concatenate the filtered morsels in
+  // the order of the input.
+  std::vector<IdTable> morsels;
+  for (size_t i = 0; i < (numRows + morselSize - 1) / morselSize; ++i) {
+    morsels.emplace_back(width, getExecutionContext()->getAllocator());
+  }
+  ad_utility::forEachMorselConcurrently(
+      numRows, morselSize, numThreads,
+      [&](size_t morsel, size_t beginOfMorsel, size_t endOfMorsel) {
+        CALL_FIXED_SIZE(width, &Filter::computeFilterImpl, this,
+                        &morsels.at(morsel), inputTable, localVocab, sortedBy,
+                        beginRow + beginOfMorsel, beginRow + endOfMorsel);
+      });
+  size_t numResultRows = 0;
+  for (const auto& morsel : morsels) {
+    numResultRows += morsel.numRows();
+  }
+  idTable.reserve(numResultRows);
+  for (const auto& morsel : morsels) {
+    idTable.insertAtEnd(morsel);
+  }
+  runtimeInfo().addDetail("num-morsels", morsels.size());
+  return idTable;
+}
+
 // _____________________________________________________________________________
 template <size_t WIDTH>
 void Filter::computeFilterImpl(IdTable* outputIdTable,
-                               const ResultTable& inputResultTable) {
+                               const IdTable& inputTable,
+                               const LocalVocab& localVocab,
+                               const std::vector<ColumnIndex>& sortedBy,
+                               size_t beginRow, size_t endRow) {
   sparqlExpression::EvaluationContext evaluationContext(
-      *getExecutionContext(), _subtree->getVariableColumns(),
-      inputResultTable.idTable(), getExecutionContext()->getAllocator(),
-      inputResultTable.localVocab());
+      *getExecutionContext(), _subtree->getVariableColumns(), inputTable,
+      getExecutionContext()->getAllocator(), localVocab);
 
   // TODO<joka921> This should be a mandatory argument to the EvaluationContext
   // constructor.
-  evaluationContext._columnsByWhichResultIsSorted = inputResultTable.sortedBy();
-
-  sparqlExpression::ExpressionResult expressionResult =
-      _expression.getPimpl()->evaluate(&evaluationContext);
+  evaluationContext._columnsByWhichResultIsSorted = sortedBy;
 
-  const auto input = inputResultTable.idTable().asStaticView<WIDTH>();
+  const auto input = inputTable.asStaticView<WIDTH>();
   auto output = std::move(*outputIdTable).toStatic<WIDTH>();
 
+  // The rows `[beginIndex, endIndex)` of the input for which the expression is
+  // currently evaluated.
+  size_t beginIndex = 0;
+  size_t endIndex = 0;
+  // Reused for all the blocks.
+  std::vector<uint8_t> isSelected;
+
+  // Append the rows `[begin, end)` of the input to the `output` column by
+  // column.
+  auto appendRows = [&input, &output](size_t begin, size_t end) {
+    size_t sizeBefore = output.size();
+    output.resize(sizeBefore + (end - begin));
+    for (size_t col = 0; col < input.numColumns(); ++col) {
+      std::ranges::copy(input.getColumn(col).subspan(begin, end - begin),
+                        output.getColumn(col).begin() + sizeBefore);
+    }
+  };
+
   auto visitor =
       [&]<sparqlExpression::SingleExpressionResult T>(T&& singleResult) {
+        const size_t blockSize = endIndex - beginIndex;
         if constexpr (std::is_same_v<T, ad_utility::SetOfIntervals>) {
+          // The intervals are relative to the `beginIndex`.
           auto totalSize = std::accumulate(
               singleResult._intervals.begin(), singleResult._intervals.end(),
               0ul, [](const auto& sum, const auto& interval) {
                 return sum + (interval.second - interval.first);
               });
-          output.reserve(totalSize);
+          size_t sizeBefore = output.size();
+          output.reserve(sizeBefore + totalSize);
           for (auto [beg, end] : singleResult._intervals) {
-            AD_CONTRACT_CHECK(end <= input.size());
-            output.insertAtEnd(input.cbegin() + beg, input.cbegin() + end);
+            AD_CONTRACT_CHECK(end <= blockSize);
+            appendRows(beginIndex + beg, beginIndex + end);
+          }
+          AD_CONTRACT_CHECK(output.size() == sizeBefore + totalSize);
+        } else if constexpr (std::is_same_v<T, sparqlExpression::
+                                                   VectorWithMemoryLimit<Id>>) {
+          // This is e.g. the result of a relational expression like
+          // `?x < 42`. First compute for each row whether it is selected in a
+          // tight loop, then copy the selected rows column by column.
+          AD_CONTRACT_CHECK(singleResult.size() == blockSize);
+          using EBV = sparqlExpression::detail::EffectiveBooleanValueGetter;
+          isSelected.resize(blockSize);
+          std::ranges::transform(
+              singleResult, isSelected.begin(),
+              [&evaluationContext](Id id) -> uint8_t {
+                auto type = id.getDatatype();
+                if (type == Datatype::Bool || type == Datatype::Undefined) {
+                  return id == Id::makeFromBool(true);
+                }
+                return EBV{}(id, &evaluationContext) == EBV::Result::True;
+              });
+          size_t numSelected =
+              std::accumulate(isSelected.begin(), isSelected.end(), size_t{0});
+          if (numSelected == blockSize) {
+            appendRows(beginIndex, endIndex);
+          } else if (numSelected > 0) {
+            // The branch-free compaction below writes one element past the
+            // last selected row.
+            size_t sizeBefore = output.size();
+            output.resize(sizeBefore + numSelected + 1);
+            for (size_t col = 0; col < input.numColumns(); ++col) {
+              auto inputColumn =
+                  input.getColumn(col).subspan(beginIndex, blockSize);
+              auto outputColumn = output.getColumn(col);
+              size_t j = sizeBefore;
+              for (size_t i = 0; i < inputColumn.size(); ++i) {
+                outputColumn[j] = inputColumn[i];
+                j += isSelected[i];
+              }
+            }
+            output.resize(sizeBefore + numSelected);
           }
-          AD_CONTRACT_CHECK(output.size() == totalSize);
         } else {
           // All other results are converted to boolean values via the
           // `EffectiveBooleanValueGetter`. This means for example, that zero,
@@ -99,8 +324,8 @@ void Filter::computeFilterImpl(IdTable* outputIdTable,
           // the total size. This depends on the expensiveness of the
           // `EffectiveBooleanValueGetter`.
           auto resultGenerator = sparqlExpression::detail::makeGenerator(
-              std::forward<T>(singleResult), input.size(), &evaluationContext);
-          size_t i = 0;
+              std::forward<T>(singleResult), blockSize, &evaluationContext);
+          size_t i = beginIndex;
 
           using EBV = sparqlExpression::detail::EffectiveBooleanValueGetter;
           for (auto&& resultValue : resultGenerator) {
@@ -112,13 +337,29 @@ void Filter::computeFilterImpl(IdTable* outputIdTable,
         }
       };
 
-  std::visit(visitor, std::move(expressionResult));
+  // Evaluate the expression for blocks of rows, s.t. the intermediate results
+  // of the subexpressions are small enough to stay in the cache (and their
+  // memory is reused for the next block), instead of materializing them for
+  // the whole input at once.
+  const size_t blockSize =
+      std::max(RuntimeParameters().get<"filter-block-size">(), size_t{1});
+  AD_CONTRACT_CHECK(beginRow <= endRow && endRow <= input.size());
+  for (beginIndex = beginRow; beginIndex < endRow; beginIndex = endIndex) {
+    endIndex = std::min(beginIndex + blockSize, endRow);
+    evaluationContext._beginIndex = beginIndex;
+    evaluationContext._endIndex = endIndex;
+    std::visit(visitor, _expression.getPimpl()->evaluate(&evaluationContext));
+    checkCancellation();
+  }
 
   *outputIdTable = std::move(output).toDynamic();
 }
 
 // _____________________________________________________________________________
 uint64_t Filter::getSizeEstimateBeforeLimit() {
+  if (auto estimate = getSizeEstimateFromHistogram()) {
+    return estimate.value();
+  }
   return _expression
       .getEstimatesForFilterExpression(
           _subtree->getSizeEstimate(),
@@ -126,6 +367,31 @@ uint64_t Filter::getSizeEstimateBeforeLimit() {
       .sizeEstimate;
 }
 
+// _____________________________________________________________________________
+std::optional<uint64_t> Filter::getSizeEstimateFromHistogram() {
+  auto* scan = dynamic_cast<IndexScan*>(_subtree->getRootOperation().get());
+  auto comparison = _expression.getVariableComparison();
+  if (scan == nullptr || !comparison.has_value() ||
+      scan->getPredicate().isVariable() || !scan->getObject().isVariable() ||
+      scan->getObject().getVariable() != comparison->variable_) {
+    return std::nullopt;
+  }
+  const auto& index = getExecutionContext()->getIndex();
+  auto predicate = scan->getPredicate().toValueId(index.getVocab());
+  if (!predicate.has_value()) {
+    return std::nullopt;
+  }
+  const auto* histogram =
+      index.getPredicateHistograms().get(predicate.value());
+  if (histogram == nullptr) {
+    return std::nullopt;
+  }
+  double fraction = histogram->estimateFraction(comparison->comparison_,
+                                                comparison->constant_);
+  return static_cast<uint64_t>(
+      std::ceil(fraction * static_cast<double>(_subtree->getSizeEstimate())));
+}
+
 // _____________________________________________________________________________
 size_t Filter::getCostEstimate() {
   return _subtree->getCostEstimate() +
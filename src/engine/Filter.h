@@ -60,9 +60,54 @@ class Filter : public Operation {
     return _subtree->getVariableColumns();
   }
 
-  ResultTable computeResult() override;
-
+  ResultTable computeResult(bool requestLaziness) override;
+
+  // Apply the filter to the semi-join reduced result of the `_subtree`.
+  std::optional<ResultTable> computeResultWithSemiJoinFilter(
+      const Variable& variable, std::span<const Id> values) override;
+
+  // Compute the result of the `_subtree`. If the `_subtree` is an `IndexScan`
+  // and the `_expression` compares the first column of the scan with a
+  // constant, restricts the `YEAR` or `MONTH` of this column (see
+  // `SparqlExpression::getDateRange`), checks its prefix (see
+  // `SparqlExpression::getPrefixFilter`), or checks for a substring with the
+  // `TrigramIndex` (see `SparqlExpression::getSubstringFilter`), the blocks of
+  // the scan that cannot contain matching rows are skipped.
+  std::shared_ptr<const ResultTable> getSubresult(bool requestLaziness);
+
+  // If the `_subtree` is an `IndexScan` with a fixed predicate and the
+  // `_expression` compares the object of the scan with a constant, estimate
+  // the size of the result from the histogram of the objects of the predicate
+  // (see `PredicateHistograms`). Return `std::nullopt` if there is no such
+  // histogram.
+  std::optional<uint64_t> getSizeEstimateFromHistogram();
+
+  // Apply the filter to each block of the lazy `subRes` and yield the
+  // (non-empty) filtered blocks.
+  ResultTable::Generator filterLazily(
+      std::shared_ptr<const ResultTable> subRes);
+
+  // Apply the filter to the fully materialized `subRes` in chunks of rows and
+  // yield the (non-empty) filtered chunks. This is used when the parent can
+  // consume a lazy result, s.t. the filtered rows never have to be copied into
+  // a single large table.
+  ResultTable::Generator filterMaterializedLazily(
+      std::shared_ptr<const ResultTable> subRes);
+
+  // Apply the filter to the rows `[beginRow, endRow)` of the `inputTable` (a
+  // complete result or a single block of a lazy result) and return the rows
+  // for which the expression evaluates to true. Large inputs are split into
+  // morsels, which are filtered concurrently (see the runtime parameter
+  // `expression-morsel-size`).
+  IdTable filterIdTable(const IdTable& inputTable, const LocalVocab& localVocab,
+                        const std::vector<ColumnIndex>& sortedBy,
+                        size_t beginRow, size_t endRow);
+
+  // Append the rows `[beginRow, endRow)` of the `inputTable` for which the
+  // expression evaluates to true to the `outputIdTable`.
   template <size_t WIDTH>
-  void computeFilterImpl(IdTable* outputIdTable,
-                         const ResultTable& inputResultTable);
+  void computeFilterImpl(IdTable* outputIdTable, const IdTable& inputTable,
+                         const LocalVocab& localVocab,
+                         const std::vector<ColumnIndex>& sortedBy,
+                         size_t beginRow, size_t endRow);
 };
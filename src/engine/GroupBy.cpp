@@ -6,8 +6,11 @@
 
 #include "engine/GroupBy.h"
 
+#include <cmath>
+
 #include "absl/strings/str_join.h"
 #include "engine/CallFixedSize.h"
+#include "engine/ExternalSort.h"
 #include "engine/IndexScan.h"
 #include "engine/Join.h"
 #include "engine/Sort.h"
@@ -15,6 +18,7 @@
 #include "engine/sparqlExpressions/AggregateExpression.h"
 #include "engine/sparqlExpressions/GroupConcatExpression.h"
 #include "engine/sparqlExpressions/LiteralExpression.h"
+#include "engine/sparqlExpressions/SampleExpression.h"
 #include "engine/sparqlExpressions/SparqlExpression.h"
 #include "engine/sparqlExpressions/SparqlExpressionGenerators.h"
 #include "index/Index.h"
@@ -22,6 +26,7 @@
 #include "parser/Alias.h"
 #include "util/Conversions.h"
 #include "util/HashSet.h"
+#include "util/ParallelExecution.h"
 
 // _______________________________________________________________________________________________
 GroupBy::GroupBy(QueryExecutionContext* qec, vector<Variable> groupByVariables,
@@ -168,9 +173,13 @@ uint64_t GroupBy::getSizeEstimateBeforeLimit() {
 
 size_t GroupBy::getCostEstimate() {
   // TODO: add the cost of the actual group by operation to the cost.
-  // Currently group by is only added to the optimizer as a terminal operation
-  // and its cost should not affect the optimizers results.
-  return _subtree->getCostEstimate();
+  // Currently group by is only added to the optimizer as a terminal operation,
+  // so its cost only decides which of the possible inputs is grouped. If the
+  // hash map optimization applies, the input doesn't have to be sorted.
+  size_t costWithSort = _subtree->getCostEstimate();
+  return std::min(costWithSort,
+                  getCostEstimateForHashMapOptimization().value_or(
+                      costWithSort));
 }
 
 template <size_t OUT_WIDTH>
@@ -238,73 +247,161 @@ void GroupBy::doGroupBy(const IdTable& dynInput,
     return;
   }
   const IdTableView<IN_WIDTH> input = dynInput.asStaticView<IN_WIDTH>();
-  IdTableStatic<OUT_WIDTH> result = std::move(*dynResult).toStatic<OUT_WIDTH>();
 
-  sparqlExpression::EvaluationContext evaluationContext(
-      *getExecutionContext(), _subtree->getVariableColumns(), *inTable,
-      getExecutionContext()->getAllocator(), *outLocalVocab);
-
-  // In a GROUP BY evaluation, the expressions need to know which variables are
-  // grouped, and to which columns the results of the aliases are written. The
-  // latter information is needed if the expression of an alias reuses the
-  // result variable from a previous alias as an input.
-  evaluationContext._groupedVariables = ad_utility::HashSet<Variable>{
-      _groupByVariables.begin(), _groupByVariables.end()};
-  evaluationContext._variableToColumnMapPreviousResults =
-      getInternallyVisibleVariableColumns();
-  evaluationContext._previousResultsFromSameGroup.resize(getResultWidth());
+  // Aggregate the groups in the rows `[beginRow, endRow)` of the input, which
+  // must start and end at group boundaries, and append them to the `result`.
+  // Words that are newly created by the aggregates (e.g. by GROUP_CONCAT) are
+  // added to the `localVocab`.
+  auto aggregateRows = [&](size_t beginRow, size_t endRow,
+                           IdTableStatic<OUT_WIDTH>& result,
+                           LocalVocab& localVocab) {
+    sparqlExpression::EvaluationContext evaluationContext(
+        *getExecutionContext(), _subtree->getVariableColumns(), *inTable,
+        getExecutionContext()->getAllocator(), localVocab);
+
+    // In a GROUP BY evaluation, the expressions need to know which variables
+    // are grouped, and to which columns the results of the aliases are
+    // written. The latter information is needed if the expression of an alias
+    // reuses the result variable from a previous alias as an input.
+    evaluationContext._groupedVariables = ad_utility::HashSet<Variable>{
+        _groupByVariables.begin(), _groupByVariables.end()};
+    evaluationContext._variableToColumnMapPreviousResults =
+        getInternallyVisibleVariableColumns();
+    evaluationContext._previousResultsFromSameGroup.resize(getResultWidth());
+
+    // Let the evaluation know that we are part of a GROUP BY.
+    evaluationContext._isPartOfGroupBy = true;
+
+    auto processNextBlock = [&](size_t blockStart, size_t blockEnd) {
+      result.emplace_back();
+      size_t rowIdx = result.size() - 1;
+      for (size_t i = 0; i < groupByCols.size(); ++i) {
+        result(rowIdx, i) = input(blockStart, groupByCols[i]);
+      }
+      for (const GroupBy::Aggregate& a : aggregates) {
+        processGroup<OUT_WIDTH>(a, evaluationContext, blockStart, blockEnd,
+                                &result, rowIdx, a._outCol, &localVocab);
+      }
+    };
 
-  // Let the evaluation know that we are part of a GROUP BY.
-  evaluationContext._isPartOfGroupBy = true;
+    if (groupByCols.empty()) {
+      // The entire input is a single group
+      processNextBlock(beginRow, endRow);
+      return;
+    }
 
-  auto processNextBlock = [&](size_t blockStart, size_t blockEnd) {
-    result.emplace_back();
-    size_t rowIdx = result.size() - 1;
-    for (size_t i = 0; i < groupByCols.size(); ++i) {
-      result(rowIdx, i) = input(blockStart, groupByCols[i]);
+    // This stores the values of the group by numColumns for the current
+    // block. A block ends when one of these values changes.
+    std::vector<std::pair<size_t, Id>> currentGroupBlock;
+    for (size_t col : groupByCols) {
+      currentGroupBlock.push_back(
+          std::pair<size_t, Id>(col, input(beginRow, col)));
     }
-    for (const GroupBy::Aggregate& a : aggregates) {
-      processGroup<OUT_WIDTH>(a, evaluationContext, blockStart, blockEnd,
-                              &result, rowIdx, a._outCol, outLocalVocab);
+    size_t blockStart = beginRow;
+
+    for (size_t pos = beginRow + 1; pos < endRow; pos++) {
+      checkCancellation();
+      bool rowMatchesCurrentBlock =
+          std::all_of(currentGroupBlock.begin(), currentGroupBlock.end(),
+                      [&](const auto& columns) {
+                        return input(pos, columns.first) == columns.second;
+                      });
+      if (!rowMatchesCurrentBlock) {
+        processNextBlock(blockStart, pos);
+        // setup for processing the next block
+        blockStart = pos;
+        for (auto& columnPair : currentGroupBlock) {
+          columnPair.second = input(pos, columnPair.first);
+        }
+      }
     }
+    processNextBlock(blockStart, endRow);
   };
 
-  if (groupByCols.empty()) {
-    // The entire input is a single group
-    processNextBlock(0, input.size());
+  IdTableStatic<OUT_WIDTH> result = std::move(*dynResult).toStatic<OUT_WIDTH>();
+  size_t chunkSize = std::max(
+      RuntimeParameters().get<"group-by-sorted-chunk-size">(), size_t{1});
+  size_t numThreads = getExecutionContext()->getNumThreads(
+      RuntimeParameters().get<"group-by-sorted-num-threads">());
+  if (groupByCols.empty() || input.size() <= chunkSize || numThreads <= 1) {
+    aggregateRows(0, input.size(), result, *outLocalVocab);
     *dynResult = std::move(result).toDynamic();
     return;
   }
 
-  // This stores the values of the group by numColumns for the current block. A
-  // block ends when one of these values changes.
-  std::vector<std::pair<size_t, Id>> currentGroupBlock;
-  for (size_t col : groupByCols) {
-    currentGroupBlock.push_back(std::pair<size_t, Id>(col, input(0, col)));
+  // Split the input into chunks at group boundaries: The `i`-th chunk starts
+  // at the first group boundary at or after row `i * chunkSize`. The
+  // boundaries are searched concurrently, because a search may have to skip
+  // the rows of a large group. Chunks without a group boundary are empty and
+  // are removed.
+  auto isGroupBoundary = [&](size_t row) {
+    return std::ranges::any_of(groupByCols, [&](size_t col) {
+      return input(row, col) != input(row - 1, col);
+    });
+  };
+  size_t numCandidates = (input.size() + chunkSize - 1) / chunkSize;
+  std::vector<size_t> chunkBoundaries(numCandidates + 1, input.size());
+  chunkBoundaries.front() = 0;
+  ad_utility::forEachMorselConcurrently(
+      numCandidates - 1, 1, numThreads, [&](size_t i, size_t, size_t) {
+        size_t row = (i + 1) * chunkSize;
+        while (row < input.size() && !isGroupBoundary(row)) {
+          ++row;
+        }
+        chunkBoundaries[i + 1] = row;
+      });
+  auto duplicates = std::ranges::unique(chunkBoundaries);
+  chunkBoundaries.erase(duplicates.begin(), duplicates.end());
+  size_t numChunks = chunkBoundaries.size() - 1;
+
+  // Aggregate the chunks concurrently. The words that are created for a chunk
+  // are added to a clone of the `outLocalVocab`, s.t. the words that are
+  // already contained keep their indexes.
+  std::vector<IdTableStatic<OUT_WIDTH>> chunkResults;
+  std::vector<LocalVocab> chunkVocabs;
+  chunkResults.reserve(numChunks);
+  chunkVocabs.reserve(numChunks);
+  for (size_t i = 0; i < numChunks; ++i) {
+    chunkResults.emplace_back(result.numColumns(),
+                              getExecutionContext()->getAllocator());
+    chunkVocabs.push_back(outLocalVocab->clone());
   }
-  size_t blockStart = 0;
-
-  for (size_t pos = 1; pos < input.size(); pos++) {
-    checkCancellation();
-    bool rowMatchesCurrentBlock =
-        std::all_of(currentGroupBlock.begin(), currentGroupBlock.end(),
-                    [&](const auto& columns) {
-                      return input(pos, columns.first) == columns.second;
-                    });
-    if (!rowMatchesCurrentBlock) {
-      processNextBlock(blockStart, pos);
-      // setup for processing the next block
-      blockStart = pos;
-      for (auto& columnPair : currentGroupBlock) {
-        columnPair.second = input(pos, columnPair.first);
+  ad_utility::forEachMorselConcurrently(
+      numChunks, 1, numThreads, [&](size_t chunk, size_t, size_t) {
+        aggregateRows(chunkBoundaries[chunk], chunkBoundaries[chunk + 1],
+                      chunkResults[chunk], chunkVocabs[chunk]);
+      });
+
+  // Concatenate the chunks in order (so the result is still sorted by the
+  // grouped columns), merge the new words into the `outLocalVocab`, and remap
+  // the `Id`s that refer to them.
+  size_t numResultRows = 0;
+  for (const auto& chunkResult : chunkResults) {
+    numResultRows += chunkResult.numRows();
+  }
+  result.reserve(numResultRows);
+  size_t sizeBefore = outLocalVocab->size();
+  for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+    auto& chunkResult = chunkResults[chunk];
+    const LocalVocab& chunkVocab = chunkVocabs[chunk];
+    if (chunkVocab.size() != sizeBefore) {
+      auto newIndexes = outLocalVocab->mergeWith(chunkVocab);
+      for (size_t col = 0; col < chunkResult.numColumns(); ++col) {
+        for (Id& id : chunkResult.getColumn(col)) {
+          if (id.getDatatype() == Datatype::LocalVocabIndex) {
+            id = Id::makeFromLocalVocabIndex(
+                newIndexes.at(id.getLocalVocabIndex().get()));
+          }
+        }
       }
     }
+    result.insertAtEnd(chunkResult);
   }
-  processNextBlock(blockStart, input.size());
+  runtimeInfo().addDetail("num-chunks", numChunks);
   *dynResult = std::move(result).toDynamic();
 }
 
-ResultTable GroupBy::computeResult() {
+ResultTable GroupBy::computeResult([[maybe_unused]] bool requestLaziness) {
   LOG(DEBUG) << "GroupBy result computation..." << std::endl;
 
   IdTable idTable{getExecutionContext()->getAllocator()};
@@ -316,19 +413,17 @@ ResultTable GroupBy::computeResult() {
     return {std::move(idTable), resultSortedOn(), LocalVocab{}};
   }
 
-  std::vector<Aggregate> aggregates;
-  aggregates.reserve(_aliases.size() + _groupByVariables.size());
+  std::vector<Aggregate> aggregates = getAggregates();
 
-  // parse the aggregate aliases
-  const auto& varColMap = getInternallyVisibleVariableColumns();
-  for (const Alias& alias : _aliases) {
-    aggregates.emplace_back(alias._expression,
-                            varColMap.at(alias._target).columnIndex_);
-  }
-
-  // Check if optimization for explicitly sorted child can be applied
+  // Check if optimization for explicitly sorted child can be applied and if it
+  // is cheaper than sorting the input.
   auto hashMapOptimizationParams =
       checkIfHashMapOptimizationPossible(aggregates);
+  if (hashMapOptimizationParams.has_value() &&
+      getCostEstimateForHashMapOptimization().value() >
+          _subtree->getCostEstimate()) {
+    hashMapOptimizationParams.reset();
+  }
 
   std::shared_ptr<const ResultTable> subresult;
   if (hashMapOptimizationParams.has_value()) {
@@ -340,6 +435,18 @@ ResultTable GroupBy::computeResult() {
         child->getRootOperation()->getRuntimeInfoPointer();
     _subtree->getRootOperation()->updateRuntimeInformationWhenOptimizedOut(
         {runTimeInfoChildren}, RuntimeInformation::Status::optimizedOut);
+  } else if (auto lazyAliases = getAliasesForLazyInput(aggregates)) {
+    // The input is sorted by the single grouped variable, s.t. a lazy input
+    // can be aggregated block by block.
+    subresult = _subtree->getResult(true);
+    if (!subresult->isFullyMaterialized()) {
+      LocalVocab localVocab;
+      idTable.setNumColumns(getResultWidth());
+      computeGroupByForLazyInput(
+          &idTable, lazyAliases.value(), *subresult,
+          _subtree->getVariableColumn(_groupByVariables.front()), &localVocab);
+      return {std::move(idTable), resultSortedOn(), std::move(localVocab)};
+    }
   } else {
     subresult = _subtree->getResult();
   }
@@ -417,10 +524,17 @@ bool GroupBy::computeGroupByForSingleIndexScan(IdTable* result) {
     return false;
   }
 
-  // Distinct counts are only supported for triples with three variables.
+  // Distinct counts are supported for triples with three variables, and for
+  // triples with two variables if the number of distinct values can be read
+  // from the metadata of the scanned relation.
   bool countIsDistinct = varAndDistinctness.value().isDistinct_;
+  std::optional<size_t> numDistinct;
   if (countIsDistinct && indexScan->getResultWidth() != 3) {
-    return false;
+    numDistinct = indexScan->getNumDistinctFromMetadata(
+        varAndDistinctness.value().variable_);
+    if (!numDistinct.has_value()) {
+      return false;
+    }
   }
 
   auto& table = *result;
@@ -428,7 +542,9 @@ bool GroupBy::computeGroupByForSingleIndexScan(IdTable* result) {
   table.emplace_back();
   // For `IndexScan`s with at least two variables the size estimates are
   // exact as they are read directly from the index metadata.
-  if (indexScan->getResultWidth() == 3) {
+  if (numDistinct.has_value()) {
+    table(0, 0) = Id::makeFromInt(static_cast<int64_t>(numDistinct.value()));
+  } else if (indexScan->getResultWidth() == 3) {
     if (countIsDistinct) {
       const auto& var = varAndDistinctness.value().variable_;
       auto permutation =
@@ -552,6 +668,177 @@ bool GroupBy::computeGroupByForFullIndexScan(IdTable* result) {
   return true;
 }
 
+// _____________________________________________________________________________
+bool GroupBy::computeGroupByForDistinctCountOfFullIndexScan(IdTable* result) {
+  if (_groupByVariables.size() != 1) {
+    return false;
+  }
+  const auto& groupByVariable = _groupByVariables.at(0);
+
+  // The only alias must be a distinct count of one of the other two variables
+  // of a triple with three variables.
+  auto varAndDistinctness = getVariableForCountOfSingleAlias();
+  if (!varAndDistinctness.has_value() ||
+      !varAndDistinctness.value().isDistinct_ ||
+      varAndDistinctness.value().variable_ == groupByVariable) {
+    return false;
+  }
+  const auto& countedVariable = varAndDistinctness.value().variable_;
+  auto permutationEnum = getPermutationForThreeVariableTriple(
+      *_subtree, groupByVariable, countedVariable);
+  if (!permutationEnum.has_value()) {
+    return false;
+  }
+
+  // The permutation is sorted by the grouped variable, determine whether the
+  // counted variable is its second or its third column.
+  const auto& indexScan =
+      dynamic_cast<const IndexScan&>(*_subtree->getRootOperation());
+  const auto& permutation =
+      getIndex().getImpl().getPermutation(permutationEnum.value());
+  auto keyOfVariable = [&indexScan](const Variable& variable) -> size_t {
+    if (indexScan.getSubject() == variable) {
+      return 0;
+    } else if (indexScan.getPredicate() == variable) {
+      return 1;
+    } else {
+      AD_CORRECTNESS_CHECK(indexScan.getObject() == variable);
+      return 2;
+    }
+  };
+  bool countedIsCol1 =
+      permutation.keyOrder_[1] == keyOfVariable(countedVariable);
+
+  // The counts are computed into a separate table, because the multiplicity of
+  // a relation might be too imprecise to reconstruct its count, in which case
+  // the `result` must be left untouched. As for `computeGroupByForFullIndexScan`
+  // the internally added entities are skipped, but the counts also contain the
+  // internally added triples.
+  auto ignoredRanges =
+      getIndex().getImpl().getIgnoredIdRanges(permutationEnum.value()).first;
+  IdTable table{2, getExecutionContext()->getAllocator()};
+  const auto& metaData = permutation.meta_.data();
+  for (auto it = metaData.ordered_begin(); it != metaData.ordered_end(); ++it) {
+    const CompressedRelationMetadata& relationMetadata = *it;
+    Id id = relationMetadata.col0Id_;
+    if (std::ranges::any_of(ignoredRanges, [&id](const auto& pair) {
+          return id >= pair.first && id < pair.second;
+        })) {
+      continue;
+    }
+    auto numDistinct = countedIsCol1 ? relationMetadata.getNumDistinctCol1()
+                                     : relationMetadata.getNumDistinctCol2();
+    if (!numDistinct.has_value()) {
+      return false;
+    }
+    table.push_back(
+        {id, Id::makeFromInt(static_cast<int64_t>(numDistinct.value()))});
+  }
+  _subtree->getRootOperation()->updateRuntimeInformationWhenOptimizedOut({});
+  *result = std::move(table);
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GroupBy::computeGroupByForCountsOfTwoVariableScan(IdTable* result) {
+  auto* indexScan =
+      dynamic_cast<const IndexScan*>(_subtree->getRootOperation().get());
+  if (!indexScan || indexScan->numVariables() != 2 ||
+      _groupByVariables.size() != 1) {
+    return false;
+  }
+  // The grouped variable must be the first column of the scan (by which it is
+  // sorted).
+  const auto& subtreeVarCols = _subtree->getVariableColumns();
+  if (_subtree->getVariableColumn(_groupByVariables.front()) != 0) {
+    return false;
+  }
+
+  // As in `computeGroupByForFullIndexScan`, there must be at most one alias,
+  // which is a non-distinct count of one of the variables of the scan (which
+  // are all bound in every row).
+  if (_aliases.size() > 1) {
+    return false;
+  }
+  if (_aliases.size() == 1) {
+    auto count = _aliases.front()._expression.getVariableForCount();
+    if (!count.has_value() || count.value().isDistinct_ ||
+        !subtreeVarCols.contains(count.value().variable_)) {
+      return false;
+    }
+  }
+
+  IdTable counts = indexScan->getCountsOfFirstColumn();
+  _subtree->getRootOperation()->updateRuntimeInformationWhenOptimizedOut({});
+  if (_aliases.empty()) {
+    counts.setColumnSubset(std::array{ColumnIndex{0}});
+  }
+  *result = std::move(counts);
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GroupBy::computeGroupByForMinMaxOfIndexScan(IdTable* result) {
+  auto* indexScan =
+      dynamic_cast<const IndexScan*>(_subtree->getRootOperation().get());
+  if (!indexScan || indexScan->numVariables() == 3 ||
+      !_groupByVariables.empty() || _aliases.empty()) {
+    return false;
+  }
+
+  // All the aliases must be a MIN or MAX of the first column of the scan (by
+  // which it is sorted).
+  using namespace sparqlExpression;
+  std::vector<bool> isMin;
+  for (auto& alias : _aliases) {
+    auto* expr = alias._expression.getPimpl();
+    bool exprIsMin = hasType<MinExpression>(expr).has_value();
+    if (!exprIsMin && !hasType<MaxExpression>(expr).has_value()) {
+      return false;
+    }
+    auto variable = expr->children().front()->getVariableOrNullopt();
+    if (!variable.has_value() ||
+        !_subtree->getVariableColumns().contains(variable.value()) ||
+        _subtree->getVariableColumn(variable.value()) != 0) {
+      return false;
+    }
+    isMin.push_back(exprIsMin);
+  }
+
+  // The order of the `Id`s in the permutation is the order of the values only
+  // for non-negative numbers of the same type. Since negative numbers are
+  // sorted after the non-negative ones, a non-negative last value of the same
+  // type as the first value guarantees that all values are of this kind.
+  auto firstAndLast = indexScan->getFirstAndLastIdOfFirstColumn();
+  if (!firstAndLast.has_value()) {
+    return false;
+  }
+  auto [first, last] = firstAndLast.value();
+  auto type = first.getDatatype();
+  if (type != last.getDatatype()) {
+    return false;
+  }
+  if (type == Datatype::Int) {
+    if (last.getInt() < 0) {
+      return false;
+    }
+  } else if (type == Datatype::Double) {
+    if (std::isnan(last.getDouble()) || std::signbit(last.getDouble())) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+
+  _subtree->getRootOperation()->updateRuntimeInformationWhenOptimizedOut({});
+  result->setNumColumns(_aliases.size());
+  result->emplace_back();
+  for (size_t i = 0; i < _aliases.size(); ++i) {
+    (*result)(0, i) = isMin[i] ? first : last;
+  }
+  return true;
+}
+
 // _____________________________________________________________________________
 std::optional<Permutation::Enum> GroupBy::getPermutationForThreeVariableTriple(
     const QueryExecutionTree& tree, const Variable& variableByWhichToSort,
@@ -692,12 +979,70 @@ bool GroupBy::computeGroupByForJoinWithFullScan(IdTable* result) {
   return true;
 }
 
+// _____________________________________________________________________________
+bool GroupBy::computeGroupByForCountOfJoin(IdTable* result) {
+  auto join = dynamic_cast<Join*>(_subtree->getRootOperation().get());
+  if (!join || !_groupByVariables.empty()) {
+    return false;
+  }
+
+  // The alias must be a single non-distinct count of a variable that is bound
+  // in every row of the join result.
+  auto varAndDistinctness = getVariableForCountOfSingleAlias();
+  if (!varAndDistinctness.has_value() ||
+      varAndDistinctness.value().isDistinct_) {
+    return false;
+  }
+  const auto& subtreeVarCols = _subtree->getVariableColumns();
+  auto it = subtreeVarCols.find(varAndDistinctness.value().variable_);
+  if (it == subtreeVarCols.end() ||
+      it->second.mightContainUndef_ !=
+          ColumnIndexAndTypeInfo::UndefStatus::AlwaysDefined) {
+    return false;
+  }
+
+  auto count = join->computeResultSize();
+  if (!count.has_value()) {
+    return false;
+  }
+  std::vector<std::shared_ptr<RuntimeInformation>> runtimeInfoChildren;
+  for (auto* child : join->getChildren()) {
+    runtimeInfoChildren.push_back(
+        child->getRootOperation()->getRuntimeInfoPointer());
+  }
+  join->updateRuntimeInformationWhenOptimizedOut(
+      std::move(runtimeInfoChildren));
+
+  auto& table = *result;
+  table.setNumColumns(1);
+  table.emplace_back();
+  table(0, 0) = Id::makeFromInt(static_cast<int64_t>(count.value()));
+  return true;
+}
+
 // _____________________________________________________________________________
 bool GroupBy::computeOptimizedGroupByIfPossible(IdTable* result) {
+  // The count of a join uses the actual results of the children of the join,
+  // so it also works with inserted and deleted triples.
+  if (computeGroupByForCountOfJoin(result)) {
+    return true;
+  }
+  // The other optimizations read the statistics and the metadata of the
+  // permutations directly, which don't reflect the inserted and deleted
+  // triples.
+  if (!getIndex().deltaTriples().empty()) {
+    return false;
+  }
   if (computeGroupByForSingleIndexScan(result)) {
     return true;
   } else if (computeGroupByForFullIndexScan(result)) {
     return true;
+  } else if (computeGroupByForDistinctCountOfFullIndexScan(result)) {
+    return true;
+  } else if (computeGroupByForCountsOfTwoVariableScan(result)) {
+    return true;
+  } else if (computeGroupByForMinMaxOfIndexScan(result)) {
+    return true;
   } else {
     return computeGroupByForJoinWithFullScan(result);
   }
@@ -706,7 +1051,12 @@ bool GroupBy::computeOptimizedGroupByIfPossible(IdTable* result) {
 // _____________________________________________________________________________
 std::optional<GroupBy::HashMapOptimizationData>
 GroupBy::checkIfHashMapOptimizationPossible(std::vector<Aggregate>& aliases) {
-  if (!RuntimeParameters().get<"use-group-by-hash-map-optimization">()) {
+  // The `QueryHints` of the query can enforce or forbid the hash map.
+  using enum QueryHints::JoinStrategy;
+  auto joinStrategy = getExecutionContext()->getQueryHints().joinStrategy_;
+  if (joinStrategy == Merge ||
+      (joinStrategy != Hash &&
+       !RuntimeParameters().get<"use-group-by-hash-map-optimization">())) {
     return std::nullopt;
   }
 
@@ -720,6 +1070,22 @@ GroupBy::checkIfHashMapOptimizationPossible(std::vector<Aggregate>& aliases) {
     return std::nullopt;
   }
 
+  auto aliasesWithAggregateInfo = getHashMapAliasInformation(aliases);
+  if (!aliasesWithAggregateInfo.has_value()) {
+    return std::nullopt;
+  }
+
+  const Variable& groupByVariable = _groupByVariables.front();
+  auto child = _subtree->getRootOperation()->getChildren().at(0);
+  auto columnIndex = child->getVariableColumn(groupByVariable);
+
+  return HashMapOptimizationData{columnIndex,
+                                 std::move(aliasesWithAggregateInfo).value()};
+}
+
+// _____________________________________________________________________________
+std::optional<std::vector<GroupBy::HashMapAliasInformation>>
+GroupBy::getHashMapAliasInformation(std::vector<Aggregate>& aliases) {
   // Get pointers to all aggregate expressions and their parents
   size_t numAggregates = 0;
   std::vector<HashMapAliasInformation> aliasesWithAggregateInfo;
@@ -739,12 +1105,43 @@ GroupBy::checkIfHashMapOptimizationPossible(std::vector<Aggregate>& aliases) {
     aliasesWithAggregateInfo.emplace_back(alias._expression, alias._outCol,
                                           foundAggregates.value());
   }
+  return aliasesWithAggregateInfo;
+}
 
-  const Variable& groupByVariable = _groupByVariables.front();
-  auto child = _subtree->getRootOperation()->getChildren().at(0);
-  auto columnIndex = child->getVariableColumn(groupByVariable);
+// _____________________________________________________________________________
+std::optional<std::vector<GroupBy::HashMapAliasInformation>>
+GroupBy::getAliasesForLazyInput(std::vector<Aggregate>& aliases) {
+  if (_groupByVariables.size() != 1) {
+    return std::nullopt;
+  }
+  return getHashMapAliasInformation(aliases);
+}
+
+// _____________________________________________________________________________
+std::optional<size_t> GroupBy::getCostEstimateForHashMapOptimization() {
+  auto aggregates = getAggregates();
+  if (!checkIfHashMapOptimizationPossible(aggregates).has_value()) {
+    return std::nullopt;
+  }
+  auto* child = _subtree->getRootOperation()->getChildren().at(0);
+  size_t inputSize = child->getSizeEstimate();
+  size_t numGroups = getSizeEstimateBeforeLimit();
+  size_t logNumGroups =
+      numGroups < 4 ? 2
+                    : static_cast<size_t>(logb(static_cast<double>(numGroups)));
+  return child->getCostEstimate() + inputSize + numGroups * logNumGroups;
+}
 
-  return HashMapOptimizationData{columnIndex, aliasesWithAggregateInfo};
+// _____________________________________________________________________________
+std::vector<GroupBy::Aggregate> GroupBy::getAggregates() const {
+  std::vector<Aggregate> aggregates;
+  aggregates.reserve(_aliases.size());
+  const auto& varColMap = getInternallyVisibleVariableColumns();
+  for (const Alias& alias : _aliases) {
+    aggregates.emplace_back(alias._expression,
+                            varColMap.at(alias._target).columnIndex_);
+  }
+  return aggregates;
 }
 
 // _____________________________________________________________________________
@@ -822,14 +1219,17 @@ std::optional<GroupBy::HashMapAggregateType> GroupBy::isSupportedAggregate(
     sparqlExpression::SparqlExpression* expr) {
   using namespace sparqlExpression;
 
-  // `expr` is not a distinct aggregate
-  if (expr->isDistinct()) return std::nullopt;
-
   // `expr` is not a nested aggregated
   if (expr->children().front()->containsAggregate()) return std::nullopt;
 
   if (hasType<AvgExpression>(expr)) return HashMapAggregateType::AVG;
   if (hasType<CountExpression>(expr)) return HashMapAggregateType::COUNT;
+  if (hasType<SumExpression>(expr)) return HashMapAggregateType::SUM;
+  if (hasType<MinExpression>(expr)) return HashMapAggregateType::MIN;
+  if (hasType<MaxExpression>(expr)) return HashMapAggregateType::MAX;
+  if (hasType<SampleExpression>(expr)) return HashMapAggregateType::SAMPLE;
+  if (hasType<GroupConcatExpression>(expr))
+    return HashMapAggregateType::GROUP_CONCAT;
 
   // `expr` is an unsupported aggregate
   return std::nullopt;
@@ -892,24 +1292,18 @@ void GroupBy::extractValues(
 // _____________________________________________________________________________
 sparqlExpression::VectorWithMemoryLimit<ValueId>
 GroupBy::getHashMapAggregationResults(
-    IdTable* resultTable, const HashMapAggregationData& aggregationData,
-    size_t dataIndex, size_t beginIndex, size_t endIndex) {
+    IdTable* resultTable, const PartitionedAggregationData& aggregationData,
+    size_t dataIndex, size_t beginIndex, size_t endIndex,
+    LocalVocab* localVocab) {
   sparqlExpression::VectorWithMemoryLimit<ValueId> aggregateResults(
       getExecutionContext()->getAllocator());
   aggregateResults.resize(endIndex - beginIndex);
 
   decltype(auto) groupValues = resultTable->getColumn(0);
-  auto& aggregateDataVariant =
-      aggregationData.getAggregationDataVariant(dataIndex);
-
-  auto op = [&aggregationData, &aggregateDataVariant](Id val) {
-    auto index = aggregationData.getIndex(val);
-
-    auto visitor = [&index](auto& aggregateDataVariant) {
-      return aggregateDataVariant.at(index).calculateResult();
-    };
 
-    return std::visit(visitor, aggregateDataVariant);
+  auto op = [&aggregationData, dataIndex, localVocab](Id val) {
+    return aggregationData.getPartition(val).calculateResult(val, dataIndex,
+                                                             localVocab);
   };
 
   std::ranges::transform(groupValues.begin() + beginIndex,
@@ -942,13 +1336,11 @@ void GroupBy::substituteGroupVariable(
 // _____________________________________________________________________________
 void GroupBy::substituteAllAggregates(
     std::vector<HashMapAggregateInformation>& info, size_t beginIndex,
-    size_t endIndex, const HashMapAggregationData& aggregationData,
-    IdTable* resultTable) {
+    size_t endIndex, const AggregateResultsGetter& getAggregateResults) {
   // Substitute in the results of all aggregates of `info`.
   for (auto& aggregate : info) {
-    auto aggregateResults = getHashMapAggregationResults(
-        resultTable, aggregationData, aggregate.aggregateDataIndex_, beginIndex,
-        endIndex);
+    auto aggregateResults = getAggregateResults(aggregate.aggregateDataIndex_,
+                                                beginIndex, endIndex);
 
     // Substitute the resulting vector as a literal
     auto newExpression = std::make_unique<sparqlExpression::VectorIdExpression>(
@@ -961,6 +1353,58 @@ void GroupBy::substituteAllAggregates(
   }
 }
 
+// _____________________________________________________________________________
+GroupBy::HashMapAggregationData::HashMapAggregationData(
+    const ad_utility::AllocatorWithLimit<Id>& alloc,
+    const std::vector<HashMapAliasInformation>& aggregateAliases)
+    : map_{alloc} {
+  using enum HashMapAggregateType;
+  for (const auto& alias : aggregateAliases) {
+    for (const auto& aggregate : alias.aggregateInfo_) {
+      // Add the data for an aggregate that depends on the distinctness.
+      auto emplace = [this, &aggregate]<typename T>() {
+        if (aggregate.expr_->isDistinct()) {
+          aggregationData_.emplace_back(
+              std::vector<DistinctAggregationData<T>>{});
+        } else {
+          aggregationData_.emplace_back(std::vector<T>{});
+        }
+      };
+      std::string_view separator;
+      switch (aggregate.aggregateType_) {
+        case AVG:
+          emplace.template operator()<AverageAggregationData>();
+          break;
+        case COUNT:
+          emplace.template operator()<CountAggregationData>();
+          break;
+        case SUM:
+          emplace.template operator()<SumAggregationData>();
+          break;
+        // MIN, MAX and SAMPLE have the same result with and without DISTINCT.
+        case MIN:
+          aggregationData_.emplace_back(std::vector<MinAggregationData>{});
+          break;
+        case MAX:
+          aggregationData_.emplace_back(std::vector<MaxAggregationData>{});
+          break;
+        case SAMPLE:
+          aggregationData_.emplace_back(std::vector<SampleAggregationData>{});
+          break;
+        case GROUP_CONCAT:
+          separator =
+              dynamic_cast<const sparqlExpression::GroupConcatExpression&>(
+                  *aggregate.expr_)
+                  .separator();
+          emplace.template operator()<GroupConcatAggregationData>();
+          break;
+      }
+      separators_.push_back(separator);
+    }
+  }
+  AD_CONTRACT_CHECK(!aggregationData_.empty());
+}
+
 // _____________________________________________________________________________
 std::vector<size_t> GroupBy::HashMapAggregationData::getHashEntries(
     std::span<const Id> ids) {
@@ -973,31 +1417,112 @@ std::vector<size_t> GroupBy::HashMapAggregationData::getHashEntries(
     hashEntries.push_back(iterator->second);
   }
 
-  for (auto& aggregation : aggregationData_)
-    std::visit([this](auto& arg) { arg.resize(getNumberOfGroups()); },
-               aggregation);
+  for (size_t i = 0; i < aggregationData_.size(); ++i) {
+    std::visit(
+        [numGroups = getNumberOfGroups(),
+         separator = separators_[i]]<typename T>(std::vector<T>& arg) {
+          if constexpr (std::constructible_from<T, std::string_view>) {
+            arg.resize(numGroups, T{separator});
+          } else {
+            arg.resize(numGroups);
+          }
+        },
+        aggregationData_[i]);
+  }
 
   return hashEntries;
 }
 
 // _____________________________________________________________________________
-[[nodiscard]] std::vector<Id>
-GroupBy::HashMapAggregationData::getSortedGroupColumn() const {
-  std::vector<ValueId> sortedKeys;
-  sortedKeys.reserve(map_.size());
+void GroupBy::HashMapAggregationData::mergePartition(
+    HashMapAggregationData& other, size_t partition, size_t numPartitions,
+    const sparqlExpression::EvaluationContext* ctx) {
+  AD_CORRECTNESS_CHECK(aggregationData_.size() ==
+                       other.aggregationData_.size());
+  for (const auto& [id, otherIndex] : other.map_) {
+    if (getPartition(id, numPartitions) == partition) {
+      mergeGroup(id, other, otherIndex, ctx);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void GroupBy::HashMapAggregationData::mergeGroup(
+    Id id, HashMapAggregationData& other,
+    const sparqlExpression::EvaluationContext* ctx) {
+  AD_CORRECTNESS_CHECK(aggregationData_.size() ==
+                       other.aggregationData_.size());
+  mergeGroup(id, other, other.getIndex(id), ctx);
+}
+
+// _____________________________________________________________________________
+void GroupBy::HashMapAggregationData::mergeGroup(
+    Id id, HashMapAggregationData& other, size_t otherIndex,
+    const sparqlExpression::EvaluationContext* ctx) {
+  auto [iterator, wasAdded] = map_.try_emplace(id, getNumberOfGroups());
+  size_t index = iterator->second;
+  for (size_t i = 0; i < aggregationData_.size(); ++i) {
+    std::visit(
+        [&]<typename T>(std::vector<T>& target) {
+          auto& source = std::get<std::vector<T>>(other.aggregationData_[i])
+                             .at(otherIndex);
+          if (wasAdded) {
+            target.push_back(std::move(source));
+          } else {
+            target.at(index).merge(source, ctx);
+          }
+        },
+        aggregationData_[i]);
+  }
+}
+
+// _____________________________________________________________________________
+ValueId GroupBy::HashMapAggregationData::calculateResult(
+    Id id, size_t aggregationDataIndex, LocalVocab* localVocab) const {
+  auto index = getIndex(id);
+  return std::visit(
+      [index, localVocab](const auto& aggregateDataVector) {
+        return aggregateDataVector.at(index).calculateResult(localVocab);
+      },
+      getAggregationDataVariant(aggregationDataIndex));
+}
+
+// _____________________________________________________________________________
+void GroupBy::HashMapAggregationData::appendGroupColumn(
+    std::vector<Id>& keys) const {
   // TODO<C++23>: use ranges::to
   for (const auto& val : map_) {
-    sortedKeys.push_back(val.first);
+    keys.push_back(val.first);
+  }
+}
+
+// _____________________________________________________________________________
+std::vector<Id> GroupBy::PartitionedAggregationData::getSortedGroupColumn()
+    const {
+  std::vector<ValueId> sortedKeys;
+  sortedKeys.reserve(getNumberOfGroups());
+  for (const auto& partition : partitions_) {
+    partition.appendGroupColumn(sortedKeys);
   }
   std::ranges::sort(sortedKeys);
   return sortedKeys;
 }
 
+// _____________________________________________________________________________
+size_t GroupBy::PartitionedAggregationData::getNumberOfGroups() const {
+  size_t numGroups = 0;
+  for (const auto& partition : partitions_) {
+    numGroups += partition.getNumberOfGroups();
+  }
+  return numGroups;
+}
+
 // _____________________________________________________________________________
 void GroupBy::evaluateAlias(
     HashMapAliasInformation& alias, IdTable* result,
     sparqlExpression::EvaluationContext& evaluationContext,
-    const HashMapAggregationData& aggregationData, LocalVocab* localVocab) {
+    const AggregateResultsGetter& getAggregateResults,
+    LocalVocab* localVocab) {
   auto& info = alias.aggregateInfo_;
 
   // Check if the grouped variable occurs in this expression
@@ -1028,9 +1553,9 @@ void GroupBy::evaluateAlias(
     auto& aggregate = info.at(0);
 
     // Get aggregate results
-    auto aggregateResults = getHashMapAggregationResults(
-        result, aggregationData, aggregate.aggregateDataIndex_,
-        evaluationContext._beginIndex, evaluationContext._endIndex);
+    auto aggregateResults = getAggregateResults(
+        aggregate.aggregateDataIndex_, evaluationContext._beginIndex,
+        evaluationContext._endIndex);
 
     // Copy to result table
     decltype(auto) outValues = result->getColumn(alias.outCol_);
@@ -1050,8 +1575,7 @@ void GroupBy::evaluateAlias(
     // Substitute in the results of all aggregates contained in the
     // expression of the current alias, if `info` is non-empty.
     substituteAllAggregates(info, evaluationContext._beginIndex,
-                            evaluationContext._endIndex, aggregationData,
-                            result);
+                            evaluationContext._endIndex, getAggregateResults);
 
     // Evaluate top-level alias expression
     sparqlExpression::ExpressionResult expressionResult =
@@ -1069,7 +1593,7 @@ void GroupBy::evaluateAlias(
 
 // _____________________________________________________________________________
 void GroupBy::createResultFromHashMap(
-    IdTable* result, const HashMapAggregationData& aggregationData,
+    IdTable* result, const PartitionedAggregationData& aggregationData,
     std::vector<HashMapAliasInformation>& aggregateAliases,
     LocalVocab* localVocab) {
   // Create result table, filling in the group values, since they might be
@@ -1080,6 +1604,23 @@ void GroupBy::createResultFromHashMap(
 
   std::ranges::copy(sortedKeys, result->getColumn(0).begin());
 
+  evaluateAliases(
+      result, aggregateAliases,
+      [this, result, &aggregationData, localVocab](
+          size_t dataIndex, size_t beginIndex, size_t endIndex) {
+        return getHashMapAggregationResults(result, aggregationData, dataIndex,
+                                            beginIndex, endIndex, localVocab);
+      },
+      localVocab);
+}
+
+// _____________________________________________________________________________
+void GroupBy::evaluateAliases(
+    IdTable* result, std::vector<HashMapAliasInformation>& aggregateAliases,
+    const AggregateResultsGetter& getAggregateResults,
+    LocalVocab* localVocab) {
+  size_t numberOfGroups = result->numRows();
+
   // Initialize evaluation context
   sparqlExpression::EvaluationContext evaluationContext(
       *getExecutionContext(), _subtree->getVariableColumns(), *result,
@@ -1099,7 +1640,7 @@ void GroupBy::createResultFromHashMap(
     evaluationContext._endIndex = std::min(i + blockSize, numberOfGroups);
 
     for (auto& alias : aggregateAliases) {
-      evaluateAlias(alias, result, evaluationContext, aggregationData,
+      evaluateAlias(alias, result, evaluationContext, getAggregateResults,
                     localVocab);
     }
   }
@@ -1139,34 +1680,31 @@ static constexpr auto makeProcessGroupsVisitor =
     };
 
 // _____________________________________________________________________________
-void GroupBy::computeGroupByForHashMapOptimization(
-    IdTable* result, std::vector<HashMapAliasInformation>& aggregateAliases,
-    const IdTable& subresult, size_t columnIndex, LocalVocab* localVocab) {
-  // Initialize aggregation data
-  HashMapAggregationData aggregationData(getExecutionContext()->getAllocator(),
-                                         aggregateAliases);
+void GroupBy::aggregateIntoHashMap(
+    HashMapAggregationData& aggregationData,
+    const std::vector<HashMapAliasInformation>& aggregateAliases,
+    const IdTable& input, size_t columnIndex, size_t beginIndex,
+    size_t endIndex, const LocalVocab& localVocab) {
+  size_t blockSize = 65536;
 
   // Initialize evaluation context
   sparqlExpression::EvaluationContext evaluationContext(
-      *getExecutionContext(), _subtree->getVariableColumns(), subresult,
-      getExecutionContext()->getAllocator(), *localVocab);
-
+      *getExecutionContext(), _subtree->getVariableColumns(), input,
+      getExecutionContext()->getAllocator(), localVocab);
   evaluationContext._groupedVariables = ad_utility::HashSet<Variable>{
       _groupByVariables.begin(), _groupByVariables.end()};
   evaluationContext._isPartOfGroupBy = true;
 
-  size_t blockSize = 65536;
-
-  for (size_t i = 0; i < subresult.size(); i += blockSize) {
+  for (size_t i = beginIndex; i < endIndex; i += blockSize) {
     evaluationContext._beginIndex = i;
-    evaluationContext._endIndex = std::min(i + blockSize, subresult.size());
+    evaluationContext._endIndex = std::min(i + blockSize, endIndex);
 
     auto currentBlockSize =
         evaluationContext._endIndex - evaluationContext._beginIndex;
 
     // Perform HashMap lookup once for all groups in current block
     auto groupValues =
-        subresult.getColumn(columnIndex)
+        input.getColumn(columnIndex)
             .subspan(evaluationContext._beginIndex, currentBlockSize);
     auto hashEntries = aggregationData.getHashEntries(groupValues);
 
@@ -1187,9 +1725,174 @@ void GroupBy::computeGroupByForHashMapOptimization(
       }
     }
   }
+}
+
+// _____________________________________________________________________________
+void GroupBy::computeGroupByForHashMapOptimization(
+    IdTable* result, std::vector<HashMapAliasInformation>& aggregateAliases,
+    const IdTable& subresult, size_t columnIndex, LocalVocab* localVocab) {
+  size_t blockSize = 65536;
+
+  // Each thread aggregates a consecutive part of the input into its own hash
+  // map. Only inputs with several blocks per thread are worth splitting.
+  size_t maxNumThreads = getExecutionContext()->getNumThreads(
+      RuntimeParameters().get<"group-by-hash-map-num-threads">());
+  size_t numThreads =
+      std::clamp(subresult.size() / (4 * blockSize), size_t{1},
+                 std::max(size_t{1}, maxNumThreads));
+
+  auto makeEvaluationContext = [this, &subresult, localVocab]() {
+    sparqlExpression::EvaluationContext evaluationContext(
+        *getExecutionContext(), _subtree->getVariableColumns(), subresult,
+        getExecutionContext()->getAllocator(), *localVocab);
+    evaluationContext._groupedVariables = ad_utility::HashSet<Variable>{
+        _groupByVariables.begin(), _groupByVariables.end()};
+    evaluationContext._isPartOfGroupBy = true;
+    return evaluationContext;
+  };
+
+  // Initialize aggregation data. The hash maps are only needed until the
+  // result has been created, so they use the arena of the query.
+  const auto& temporaryAllocator =
+      getExecutionContext()->getTemporaryAllocator();
+  std::vector<HashMapAggregationData> threadLocalData;
+  threadLocalData.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; ++i) {
+    threadLocalData.emplace_back(temporaryAllocator, aggregateAliases);
+  }
+
+  auto aggregateRange = [&](size_t threadIndex) {
+    size_t rangeBegin = subresult.size() * threadIndex / numThreads;
+    size_t rangeEnd = subresult.size() * (threadIndex + 1) / numThreads;
+    aggregateIntoHashMap(threadLocalData.at(threadIndex), aggregateAliases,
+                         subresult, columnIndex, rangeBegin, rangeEnd,
+                         *localVocab);
+  };
+  ad_utility::runConcurrently(numThreads, aggregateRange);
+
+  // Merge the thread-local data. Each thread merges one partition of the
+  // groups, and the thread-local data is merged in the order of the input, s.t.
+  // order-dependent aggregates like SAMPLE and GROUP_CONCAT see the values in
+  // the same order as without multiple threads.
+  std::vector<HashMapAggregationData> partitions;
+  if (numThreads == 1) {
+    partitions = std::move(threadLocalData);
+  } else {
+    partitions.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+      partitions.emplace_back(temporaryAllocator, aggregateAliases);
+    }
+    ad_utility::runConcurrently(numThreads, [&](size_t partition) {
+      auto evaluationContext = makeEvaluationContext();
+      for (auto& aggregationData : threadLocalData) {
+        partitions.at(partition).mergePartition(aggregationData, partition,
+                                                numThreads, &evaluationContext);
+      }
+    });
+    threadLocalData.clear();
+  }
+
+  createResultFromHashMap(result,
+                          PartitionedAggregationData{std::move(partitions)},
+                          aggregateAliases, localVocab);
+}
+
+// _____________________________________________________________________________
+void GroupBy::computeGroupByForLazyInput(
+    IdTable* result, std::vector<HashMapAliasInformation>& aggregateAliases,
+    const ResultTable& subresult, size_t columnIndex, LocalVocab* localVocab) {
+  const auto& allocator = getExecutionContext()->getAllocator();
+  // The aggregation data of the blocks and the finished groups are only needed
+  // until the result has been created, so they use the arena of the query,
+  // from which the data of the next block reuses the memory.
+  const auto& temporaryAllocator =
+      getExecutionContext()->getTemporaryAllocator();
+  // The data of the group that is still open at the end of the previous block.
+  std::optional<HashMapAggregationData> openGroup;
+  std::optional<Id> openGroupId;
+  // Column 0 contains the finished groups, column `i + 1` the results of the
+  // aggregate with the `aggregateDataIndex_` `i` for these groups.
+  std::optional<IdTable> finishedGroups;
+
+  auto finishGroup = [&finishedGroups, localVocab](
+                         Id id, const HashMapAggregationData& data) {
+    auto& table = finishedGroups.value();
+    table.emplace_back();
+    size_t row = table.numRows() - 1;
+    table(row, 0) = id;
+    for (size_t i = 0; i < data.getNumberOfAggregates(); ++i) {
+      table(row, i + 1) = data.calculateResult(id, i, localVocab);
+    }
+  };
+
+  size_t numBlocks = 0;
+  for (auto& [block, blockVocab] : subresult.idTables()) {
+    checkCancellation();
+    ++numBlocks;
+    if (block.empty()) {
+      continue;
+    }
+    ad_utility::externalSort::mergeLocalVocabInto(block, blockVocab,
+                                                  *localVocab);
+    HashMapAggregationData blockData{temporaryAllocator, aggregateAliases};
+    aggregateIntoHashMap(blockData, aggregateAliases, block, columnIndex, 0,
+                         block.numRows(), *localVocab);
+    if (!finishedGroups.has_value()) {
+      finishedGroups.emplace(1 + blockData.getNumberOfAggregates(),
+                             temporaryAllocator);
+    }
+    sparqlExpression::EvaluationContext evaluationContext(
+        *getExecutionContext(), _subtree->getVariableColumns(), block,
+        allocator, *localVocab);
+
+    // The input is sorted, so the rows of each group are consecutive. The
+    // groups are finished in the order of the input, only the last group of
+    // the block may be continued in the next block.
+    auto groupColumn = block.getColumn(columnIndex);
+    for (auto it = groupColumn.begin(); it != groupColumn.end();) {
+      Id id = *it;
+      it = std::find_if(it, groupColumn.end(),
+                        [id](Id other) { return other != id; });
+      bool continuesOpenGroup = openGroupId == id;
+      if (continuesOpenGroup) {
+        openGroup->mergeGroup(id, blockData, &evaluationContext);
+      } else if (openGroupId.has_value()) {
+        finishGroup(openGroupId.value(), openGroup.value());
+        openGroupId.reset();
+      }
+      if (it != groupColumn.end()) {
+        finishGroup(id, continuesOpenGroup ? openGroup.value() : blockData);
+        openGroupId.reset();
+      } else if (!continuesOpenGroup) {
+        openGroup.emplace(temporaryAllocator, aggregateAliases);
+        openGroup->mergeGroup(id, blockData, &evaluationContext);
+        openGroupId = id;
+      }
+    }
+  }
+  if (openGroupId.has_value()) {
+    finishGroup(openGroupId.value(), openGroup.value());
+  }
+  runtimeInfo().addDetail("lazy-input-blocks", numBlocks);
 
-  createResultFromHashMap(result, aggregationData, aggregateAliases,
-                          localVocab);
+  if (!finishedGroups.has_value()) {
+    return;
+  }
+  result->resize(finishedGroups->numRows());
+  std::ranges::copy(finishedGroups->getColumn(0), result->getColumn(0).begin());
+  evaluateAliases(
+      result, aggregateAliases,
+      [&finishedGroups, &allocator](size_t dataIndex, size_t beginIndex,
+                                    size_t endIndex) {
+        sparqlExpression::VectorWithMemoryLimit<ValueId> aggregateResults(
+            allocator);
+        aggregateResults.resize(endIndex - beginIndex);
+        auto column = finishedGroups->getColumn(dataIndex + 1);
+        std::ranges::copy(column.begin() + beginIndex,
+                          column.begin() + endIndex, aggregateResults.begin());
+        return aggregateResults;
+      },
+      localVocab);
 }
 
 // _____________________________________________________________________________
@@ -6,18 +6,24 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/hash/hash.h"
 #include "engine/Operation.h"
 #include "engine/QueryExecutionTree.h"
+#include "engine/sparqlExpressions/AggregateExpression.h"
 #include "engine/sparqlExpressions/SparqlExpressionPimpl.h"
 #include "engine/sparqlExpressions/SparqlExpressionValueGetters.h"
 #include "gtest/gtest.h"
 #include "parser/Alias.h"
 #include "parser/ParsedQuery.h"
+#include "util/HashSet.h"
 
 using std::string;
 using std::vector;
@@ -86,7 +92,7 @@ class GroupBy : public Operation {
  private:
   VariableToColumnMap computeVariableToColumnMap() const override;
 
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
 
   template <size_t OUT_WIDTH>
   void processGroup(const Aggregate& expression,
@@ -95,6 +101,10 @@ class GroupBy : public Operation {
                     IdTableStatic<OUT_WIDTH>* result, size_t resultRow,
                     size_t resultColumn, LocalVocab* localVocab) const;
 
+  // Compute the GROUP BY of the `dynInput`, which is sorted by the
+  // `groupByCols`. Large inputs are split at group boundaries into chunks,
+  // which are aggregated concurrently (see the runtime parameter
+  // `group-by-sorted-chunk-size`).
   template <size_t IN_WIDTH, size_t OUT_WIDTH>
   void doGroupBy(const IdTable& dynInput, const vector<size_t>& groupByCols,
                  const vector<GroupBy::Aggregate>& aggregates,
@@ -156,6 +166,51 @@ class GroupBy : public Operation {
   // `?z`.
   bool computeGroupByForJoinWithFullScan(IdTable* result);
 
+  // First, check if the query represented by this GROUP BY is of the following
+  // form:
+  //  SELECT (COUNT(?x) as ?cnt) WHERE {
+  //    %two subtrees that are joined on a variable without UNDEF values
+  //  }
+  // where `?x` is always bound in the result of the join (so the COUNT is the
+  // number of rows of the join). If the query has that form, only the number
+  // of rows of the join is computed (see `Join::computeResultSize`), without
+  // materializing the join result, and stored in the `result` and `true` is
+  // returned. If not, the `result` is left untouched, and `false` is returned.
+  bool computeGroupByForCountOfJoin(IdTable* result);
+
+  // First, check if the query represented by this GROUP BY is of the following
+  // form:
+  //  SELECT ?y (COUNT(DISTINCT ?x) as ?cnt) WHERE {
+  //    ?x ?y ?z
+  //  } GROUP BY ?y
+  // The counted variable must be different from the grouped variable. The
+  // number of distinct values per value of the grouped variable is then read
+  // from the metadata of the corresponding permutation. If the metadata of
+  // one of the values doesn't determine that number exactly, `false` is
+  // returned.
+  bool computeGroupByForDistinctCountOfFullIndexScan(IdTable* result);
+
+  // First, check if the query represented by this GROUP BY is of the following
+  // form:
+  //  SELECT ?y (COUNT(?z) as ?cnt) WHERE {
+  //    <x> ?y ?z
+  //  } GROUP BY ?y
+  // where `?y` is the first column of the index scan. The counts are computed
+  // from the block metadata, only the blocks that contain more than one value
+  // of `?y` have to be read (see `IndexScan::getCountsOfFirstColumn`).
+  bool computeGroupByForCountsOfTwoVariableScan(IdTable* result);
+
+  // First, check if the query represented by this GROUP BY is of the following
+  // form:
+  //  SELECT (MIN(?y) as ?min) (MAX(?y) as ?max) WHERE {
+  //    ?x <p> ?y
+  //  }
+  // where `?y` is the first column of the index scan, and all the values of
+  // `?y` are non-negative numbers of the same type (only then the order of
+  // the IDs is the numeric order). The MIN and MAX are then read from the
+  // metadata of the scan.
+  bool computeGroupByForMinMaxOfIndexScan(IdTable* result);
+
   // Data to perform the AVG aggregation using the HashMap optimization.
   struct AverageAggregationData {
     using ValueGetter = sparqlExpression::detail::NumericValueGetter;
@@ -174,7 +229,13 @@ class GroupBy : public Operation {
         error_ = true;
       ++count_;
     };
-    [[nodiscard]] ValueId calculateResult() const {
+    void merge(AverageAggregationData& other,
+               const sparqlExpression::EvaluationContext*) {
+      error_ = error_ || other.error_;
+      sum_ += other.sum_;
+      count_ += other.count_;
+    }
+    [[nodiscard]] ValueId calculateResult(LocalVocab*) const {
       if (error_)
         return ValueId::makeUndefined();
       else
@@ -190,11 +251,163 @@ class GroupBy : public Operation {
                    const sparqlExpression::EvaluationContext* ctx) {
       if (ValueGetter{}(AD_FWD(value), ctx)) count_++;
     }
-    [[nodiscard]] ValueId calculateResult() const {
+    void merge(CountAggregationData& other,
+               const sparqlExpression::EvaluationContext*) {
+      count_ += other.count_;
+    }
+    [[nodiscard]] ValueId calculateResult(LocalVocab*) const {
       return ValueId::makeFromInt(count_);
     }
   };
 
+  // Data to perform the SUM aggregation using the HashMap optimization.
+  struct SumAggregationData {
+    using ValueGetter = sparqlExpression::detail::NumericValueGetter;
+    sparqlExpression::detail::NumericValue sum_ = int64_t{0};
+    void increment(auto&& value,
+                   const sparqlExpression::EvaluationContext* ctx) {
+      sum_ = sparqlExpression::detail::addForSum(
+          sum_, ValueGetter{}(AD_FWD(value), ctx));
+    }
+    void merge(SumAggregationData& other,
+               const sparqlExpression::EvaluationContext*) {
+      sum_ = sparqlExpression::detail::addForSum(sum_, other.sum_);
+    }
+    [[nodiscard]] ValueId calculateResult(LocalVocab*) const {
+      return sparqlExpression::detail::makeNumericId(sum_);
+    }
+  };
+
+  // Data to perform the MIN (`Comp == LT`) and MAX (`Comp == GT`) aggregations
+  // using the HashMap optimization.
+  template <valueIdComparators::Comparison Comp>
+  struct MinOrMaxAggregationData {
+    std::optional<sparqlExpression::IdOrString> currentValue_;
+    void increment(auto&& value,
+                   const sparqlExpression::EvaluationContext* ctx) {
+      sparqlExpression::IdOrString val{AD_FWD(value)};
+      if (!currentValue_.has_value()) {
+        currentValue_ = std::move(val);
+        return;
+      }
+      auto base = [](const sparqlExpression::IdOrString& i)
+          -> const sparqlExpression::IdOrStringBase& { return i; };
+      currentValue_ = std::visit(
+          [ctx](const auto& a, const auto& b) {
+            return sparqlExpression::detail::compareIdsOrStrings<Comp>(a, b,
+                                                                       ctx);
+          },
+          base(currentValue_.value()), base(val));
+    }
+    void merge(MinOrMaxAggregationData& other,
+               const sparqlExpression::EvaluationContext* ctx) {
+      if (other.currentValue_.has_value()) {
+        increment(std::move(other.currentValue_.value()), ctx);
+      }
+    }
+    [[nodiscard]] ValueId calculateResult(LocalVocab* localVocab) const {
+      AD_CORRECTNESS_CHECK(currentValue_.has_value());
+      return sparqlExpression::detail::constantExpressionResultToId(
+          sparqlExpression::IdOrString{currentValue_.value()}, *localVocab);
+    }
+  };
+  using MinAggregationData =
+      MinOrMaxAggregationData<valueIdComparators::Comparison::LT>;
+  using MaxAggregationData =
+      MinOrMaxAggregationData<valueIdComparators::Comparison::GT>;
+
+  // Data to perform the SAMPLE aggregation using the HashMap optimization. The
+  // first value of each group is taken as the sample.
+  struct SampleAggregationData {
+    std::optional<sparqlExpression::IdOrString> value_;
+    void increment(auto&& value, const sparqlExpression::EvaluationContext*) {
+      if (!value_.has_value()) {
+        value_.emplace(AD_FWD(value));
+      }
+    }
+    void merge(SampleAggregationData& other,
+               const sparqlExpression::EvaluationContext*) {
+      if (!value_.has_value()) {
+        value_ = std::move(other.value_);
+      }
+    }
+    [[nodiscard]] ValueId calculateResult(LocalVocab* localVocab) const {
+      AD_CORRECTNESS_CHECK(value_.has_value());
+      return sparqlExpression::detail::constantExpressionResultToId(
+          sparqlExpression::IdOrString{value_.value()}, *localVocab);
+    }
+  };
+
+  // Data to perform the GROUP_CONCAT aggregation using the HashMap
+  // optimization. The `separator_` points to the separator of the
+  // corresponding `GroupConcatExpression`.
+  struct GroupConcatAggregationData {
+    using ValueGetter = sparqlExpression::detail::StringValueGetter;
+    std::string_view separator_;
+    std::string currentValue_;
+    explicit GroupConcatAggregationData(std::string_view separator)
+        : separator_{separator} {}
+    void increment(auto&& value,
+                   const sparqlExpression::EvaluationContext* ctx) {
+      auto val = ValueGetter{}(AD_FWD(value), ctx);
+      if (val.has_value()) {
+        append(val.value());
+      }
+    }
+    void merge(GroupConcatAggregationData& other,
+               const sparqlExpression::EvaluationContext*) {
+      if (currentValue_.empty()) {
+        currentValue_ = std::move(other.currentValue_);
+      } else if (!other.currentValue_.empty()) {
+        append(other.currentValue_);
+      }
+    }
+    [[nodiscard]] ValueId calculateResult(LocalVocab* localVocab) const {
+      return sparqlExpression::detail::constantExpressionResultToId(
+          sparqlExpression::IdOrString{currentValue_}, *localVocab);
+    }
+
+   private:
+    void append(std::string_view value) {
+      if (!currentValue_.empty()) {
+        currentValue_.append(separator_);
+      }
+      currentValue_.append(value);
+    }
+  };
+
+  // Wrap one of the aggregation data types from above s.t. each distinct
+  // value is passed to it only once. The distinct values are also stored in
+  // the order in which they were first seen, s.t. the order in which they are
+  // passed to the `Base` is the same when the data of consecutive parts of
+  // the input is merged.
+  template <typename Base>
+  struct DistinctAggregationData {
+    Base base_;
+    ad_utility::HashSet<sparqlExpression::IdOrString> seenValues_;
+    std::vector<sparqlExpression::IdOrString> distinctValues_;
+    template <typename... Args>
+    requires std::constructible_from<Base, Args&&...>
+    explicit DistinctAggregationData(Args&&... args) : base_{AD_FWD(args)...} {}
+    void increment(auto&& value,
+                   const sparqlExpression::EvaluationContext* ctx) {
+      sparqlExpression::IdOrString val{AD_FWD(value)};
+      if (seenValues_.insert(val).second) {
+        base_.increment(val, ctx);
+        distinctValues_.push_back(std::move(val));
+      }
+    }
+    void merge(DistinctAggregationData& other,
+               const sparqlExpression::EvaluationContext* ctx) {
+      for (auto& value : other.distinctValues_) {
+        increment(std::move(value), ctx);
+      }
+    }
+    [[nodiscard]] ValueId calculateResult(LocalVocab* localVocab) const {
+      return base_.calculateResult(localVocab);
+    }
+  };
+
   using KeyType = ValueId;
   using ValueType = size_t;
 
@@ -212,7 +425,15 @@ class GroupBy : public Operation {
   };
 
   // Used to store the kind of aggregate.
-  enum class HashMapAggregateType { AVG, COUNT };
+  enum class HashMapAggregateType {
+    AVG,
+    COUNT,
+    SUM,
+    MIN,
+    MAX,
+    SAMPLE,
+    GROUP_CONCAT
+  };
 
   // Stores information required for evaluation of an aggregate as well
   // as the alias containing it.
@@ -265,8 +486,25 @@ class GroupBy : public Operation {
       IdTable* result, std::vector<HashMapAliasInformation>& aggregateAliases,
       const IdTable& subresult, size_t columnIndex, LocalVocab* localVocab);
 
-  using Aggregations = std::variant<std::vector<AverageAggregationData>,
-                                    std::vector<CountAggregationData>>;
+  // Create result IdTable for a lazy `subresult` that is sorted by the grouped
+  // variable at `columnIndex`. The input is consumed block by block. Only the
+  // aggregation data of the group that is still open at the end of a block is
+  // kept, the results of all other groups are computed immediately. The local
+  // vocabs of the blocks are merged into `localVocab`.
+  void computeGroupByForLazyInput(
+      IdTable* result, std::vector<HashMapAliasInformation>& aggregateAliases,
+      const ResultTable& subresult, size_t columnIndex,
+      LocalVocab* localVocab);
+
+  using Aggregations = std::variant<
+      std::vector<AverageAggregationData>, std::vector<CountAggregationData>,
+      std::vector<SumAggregationData>, std::vector<MinAggregationData>,
+      std::vector<MaxAggregationData>, std::vector<SampleAggregationData>,
+      std::vector<GroupConcatAggregationData>,
+      std::vector<DistinctAggregationData<AverageAggregationData>>,
+      std::vector<DistinctAggregationData<CountAggregationData>>,
+      std::vector<DistinctAggregationData<SumAggregationData>>,
+      std::vector<DistinctAggregationData<GroupConcatAggregationData>>>;
 
   // Stores the map which associates Ids with vector offsets and
   // the vectors containing the aggregation data.
@@ -274,27 +512,41 @@ class GroupBy : public Operation {
    public:
     HashMapAggregationData(
         const ad_utility::AllocatorWithLimit<Id>& alloc,
-        const std::vector<HashMapAliasInformation>& aggregateAliases)
-        : map_{alloc} {
-      size_t numAggregates = 0;
-      for (const auto& alias : aggregateAliases) {
-        for (const auto& aggregate : alias.aggregateInfo_) {
-          ++numAggregates;
-
-          if (aggregate.aggregateType_ == HashMapAggregateType::AVG)
-            aggregationData_.emplace_back(
-                std::vector<AverageAggregationData>{});
-          if (aggregate.aggregateType_ == HashMapAggregateType::COUNT)
-            aggregationData_.emplace_back(std::vector<CountAggregationData>{});
-        }
-      }
-      AD_CONTRACT_CHECK(numAggregates > 0);
-    }
+        const std::vector<HashMapAliasInformation>& aggregateAliases);
 
     // Returns a vector containing the offsets for all ids of `ids`,
     // inserting entries if necessary.
     std::vector<size_t> getHashEntries(std::span<const Id> ids);
 
+    // Merge the aggregation data of all groups of `other` that belong to the
+    // `partition` (see `getPartition`) into this data. The data of `other` is
+    // moved from, but different partitions of the same `other` can be merged
+    // concurrently.
+    void mergePartition(HashMapAggregationData& other, size_t partition,
+                        size_t numPartitions,
+                        const sparqlExpression::EvaluationContext* ctx);
+
+    // Merge the aggregation data of the group `id` of `other` into this data.
+    // The data of `other` is moved from.
+    void mergeGroup(Id id, HashMapAggregationData& other,
+                    const sparqlExpression::EvaluationContext* ctx);
+
+    // Calculate the result of the aggregate at `aggregationDataIndex` for the
+    // group `id`.
+    [[nodiscard]] ValueId calculateResult(Id id, size_t aggregationDataIndex,
+                                          LocalVocab* localVocab) const;
+
+    // Returns the number of aggregates.
+    [[nodiscard]] size_t getNumberOfAggregates() const {
+      return aggregationData_.size();
+    }
+
+    // Return the partition of the group `id` when the groups are split into
+    // `numPartitions` parts.
+    static size_t getPartition(Id id, size_t numPartitions) {
+      return absl::Hash<Id>{}(id) % numPartitions;
+    }
+
     // Return the index of `id`.
     [[nodiscard]] size_t getIndex(Id id) const { return map_.at(id); }
 
@@ -310,37 +562,96 @@ class GroupBy : public Operation {
       return aggregationData_.at(aggregationDataIndex);
     }
 
-    // Get the values of the grouped column in ascending order.
-    [[nodiscard]] std::vector<Id> getSortedGroupColumn() const;
+    // Append the values of the grouped column to `keys` (in no particular
+    // order).
+    void appendGroupColumn(std::vector<Id>& keys) const;
 
     // Returns the number of groups.
     [[nodiscard]] size_t getNumberOfGroups() const { return map_.size(); }
 
    private:
+    // Merge the data of the group `id` that is stored at `otherIndex` in
+    // `other` into this data.
+    void mergeGroup(Id id, HashMapAggregationData& other, size_t otherIndex,
+                    const sparqlExpression::EvaluationContext* ctx);
+
     // Maps `Id` to vector offsets.
     ad_utility::HashMapWithMemoryLimit<KeyType, ValueType> map_;
     // Stores the actual aggregation data.
     std::vector<Aggregations> aggregationData_;
+    // The separators of the GROUP_CONCAT aggregates (empty for all other
+    // aggregates), required to initialize the data of new groups.
+    std::vector<std::string_view> separators_;
+  };
+
+  // The aggregation data of all groups after the thread-local
+  // `HashMapAggregationData` have been merged. The groups are split into
+  // disjoint partitions by their hash, s.t. the partitions can be merged
+  // concurrently.
+  class PartitionedAggregationData {
+   public:
+    explicit PartitionedAggregationData(
+        std::vector<HashMapAggregationData> partitions)
+        : partitions_{std::move(partitions)} {
+      AD_CONTRACT_CHECK(!partitions_.empty());
+    }
+
+    // Return the partition that contains the group `id`.
+    [[nodiscard]] const HashMapAggregationData& getPartition(Id id) const {
+      return partitions_.at(
+          HashMapAggregationData::getPartition(id, partitions_.size()));
+    }
+
+    // Get the values of the grouped column in ascending order.
+    [[nodiscard]] std::vector<Id> getSortedGroupColumn() const;
+
+    // Returns the number of groups.
+    [[nodiscard]] size_t getNumberOfGroups() const;
+
+   private:
+    std::vector<HashMapAggregationData> partitions_;
   };
 
+  // Aggregate the rows `[beginIndex, endIndex)` of the `input` into the
+  // `aggregationData`. The grouped variable is stored at `columnIndex`.
+  void aggregateIntoHashMap(
+      HashMapAggregationData& aggregationData,
+      const std::vector<HashMapAliasInformation>& aggregateAliases,
+      const IdTable& input, size_t columnIndex, size_t beginIndex,
+      size_t endIndex, const LocalVocab& localVocab);
+
   // Returns the aggregation results between `beginIndex` and `endIndex`
   // of the aggregates stored at `dataIndex`,
   // based on the groups stored in the first column of `resultTable`
   sparqlExpression::VectorWithMemoryLimit<ValueId> getHashMapAggregationResults(
-      IdTable* resultTable, const HashMapAggregationData& aggregationData,
-      size_t dataIndex, size_t beginIndex, size_t endIndex);
+      IdTable* resultTable, const PartitionedAggregationData& aggregationData,
+      size_t dataIndex, size_t beginIndex, size_t endIndex,
+      LocalVocab* localVocab);
+
+  // Return the results of the aggregate at `dataIndex` for the groups in the
+  // rows `[beginIndex, endIndex)` of the result.
+  using AggregateResultsGetter =
+      std::function<sparqlExpression::VectorWithMemoryLimit<ValueId>(
+          size_t dataIndex, size_t beginIndex, size_t endIndex)>;
 
   // Substitute away any occurrences of the grouped variable and of aggregate
   // results, if necessary, and subsequently evaluate the expression of an
   // alias
   void evaluateAlias(HashMapAliasInformation& alias, IdTable* result,
                      sparqlExpression::EvaluationContext& evaluationContext,
-                     const HashMapAggregationData& aggregationData,
+                     const AggregateResultsGetter& getAggregateResults,
                      LocalVocab* localVocab);
 
+  // Evaluate all the `aggregateAliases` for the groups, which have to be
+  // stored in the first column of the `result`.
+  void evaluateAliases(IdTable* result,
+                       std::vector<HashMapAliasInformation>& aggregateAliases,
+                       const AggregateResultsGetter& getAggregateResults,
+                       LocalVocab* localVocab);
+
   // Sort the HashMap by key and create result table.
   void createResultFromHashMap(
-      IdTable* result, const HashMapAggregationData& aggregationData,
+      IdTable* result, const PartitionedAggregationData& aggregationData,
       std::vector<HashMapAliasInformation>& aggregateAliases,
       LocalVocab* localVocab);
 
@@ -348,11 +659,33 @@ class GroupBy : public Operation {
   // the following conditions hold true:
   // - Runtime parameter is set
   // - Child operation is SORT
-  // - All aggregates are AVG
+  // - All aggregates are AVG, COUNT, SUM, MIN, MAX, SAMPLE or GROUP_CONCAT
+  //   (possibly DISTINCT), and they are not nested
   // - Only one grouped variable
   std::optional<HashMapOptimizationData> checkIfHashMapOptimizationPossible(
       std::vector<Aggregate>& aggregates);
 
+  // Find all aggregates of the `aliases` and return them, together with the
+  // information where their results are stored. Return `std::nullopt` if one
+  // of the aggregates is not supported by the aggregation via hash maps.
+  static std::optional<std::vector<HashMapAliasInformation>>
+  getHashMapAliasInformation(std::vector<Aggregate>& aliases);
+
+  // Return the information about the aggregates of the `aliases` if a lazy
+  // input can be aggregated block by block (see `computeGroupByForLazyInput`),
+  // `std::nullopt` otherwise.
+  std::optional<std::vector<HashMapAliasInformation>> getAliasesForLazyInput(
+      std::vector<Aggregate>& aliases);
+
+  // Return the estimated cost of this GROUP BY if the hash map optimization is
+  // applied (see above), which skips the sorting of the input, but has to
+  // probe the hash map for each input row and to sort the groups in the end.
+  // Return `std::nullopt` if the optimization is not applicable.
+  std::optional<size_t> getCostEstimateForHashMapOptimization();
+
+  // Return the aggregates of the aliases of this GROUP BY.
+  std::vector<Aggregate> getAggregates() const;
+
   // Extract values from `expressionResult` and store them in the rows of
   // `resultTable` specified by the indices in `evaluationContext`, in column
   // `outCol`.
@@ -366,12 +699,11 @@ class GroupBy : public Operation {
       const std::vector<GroupBy::ParentAndChildIndex>& occurrences,
       IdTable* resultTable) const;
 
-  // Substitute the results for all aggregates in `info`. The values of the
-  // grouped variable should be at column 0 in `groupValues`.
-  void substituteAllAggregates(std::vector<HashMapAggregateInformation>& info,
-                               size_t beginIndex, size_t endIndex,
-                               const HashMapAggregationData& aggregationData,
-                               IdTable* resultTable);
+  // Substitute the results for all aggregates in `info` for the groups in the
+  // rows `[beginIndex, endIndex)` of the result.
+  static void substituteAllAggregates(
+      std::vector<HashMapAggregateInformation>& info, size_t beginIndex,
+      size_t endIndex, const AggregateResultsGetter& getAggregateResults);
 
   // Check if an expression is of a certain type.
   template <class T>
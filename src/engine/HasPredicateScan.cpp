@@ -4,7 +4,72 @@
 
 #include "HasPredicateScan.h"
 
+#include <numeric>
+
 #include "CallFixedSize.h"
+#include "global/Constants.h"
+#include "util/ParallelExecution.h"
+
+namespace {
+// The predicates of the subject with the `subjectIndex`, which are either the
+// predicates of its pattern or its list in the `hasPredicate` (empty if it has
+// neither).
+std::span<const Id> predicatesOf(uint64_t subjectIndex,
+                                 const CompressedPatternIds& hasPattern,
+                                 const CompactVectorOfStrings<Id>& hasPredicate,
+                                 const CompactVectorOfStrings<Id>& patterns) {
+  if (subjectIndex < hasPattern.size()) {
+    PatternID patternId = hasPattern[subjectIndex];
+    if (patternId != NO_PATTERN) {
+      return patterns[patternId];
+    }
+  }
+  if (subjectIndex < hasPredicate.size()) {
+    return hasPredicate[subjectIndex];
+  }
+  return {};
+}
+
+// Expand each of the items `[0, numItems)` into one row of the `result` per
+// predicate in `getPredicates(item)`. The items are split into contiguous
+// ranges, one per thread. The number of rows of each range is counted
+// concurrently, the first row of each range is then the prefix sum of these
+// counts, and finally the ranges are written concurrently via
+// `writeRows(item, predicates, firstRow)`, s.t. the result is never resized
+// while it is written and the rows are in the order of the items.
+void expandToPredicates(auto& result, size_t numItems,
+                        const auto& getPredicates, const auto& writeRows) {
+  static constexpr size_t minNumItemsPerThread = 10'000;
+  size_t maxNumThreads = std::max(
+      size_t{1}, RuntimeParameters().get<"has-predicate-scan-num-threads">());
+  size_t numThreads =
+      std::clamp(numItems / minNumItemsPerThread, size_t{1}, maxNumThreads);
+  size_t chunkSize = numItems / numThreads + 1;
+  auto beginOf = [&](size_t threadIdx) {
+    return std::min(numItems, threadIdx * chunkSize);
+  };
+
+  std::vector<size_t> firstRows(numThreads + 1, 0);
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    size_t numRows = 0;
+    for (size_t i = beginOf(threadIdx); i < beginOf(threadIdx + 1); ++i) {
+      numRows += getPredicates(i).size();
+    }
+    firstRows[threadIdx + 1] = numRows;
+  });
+  std::inclusive_scan(firstRows.begin(), firstRows.end(), firstRows.begin());
+
+  result.resize(firstRows.back());
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    size_t row = firstRows[threadIdx];
+    for (size_t i = beginOf(threadIdx); i < beginOf(threadIdx + 1); ++i) {
+      std::span<const Id> predicates = getPredicates(i);
+      writeRows(i, predicates, row);
+      row += predicates.size();
+    }
+  });
+}
+}  // namespace
 
 HasPredicateScan::HasPredicateScan(QueryExecutionContext* qec,
                                    std::shared_ptr<QueryExecutionTree> subtree,
@@ -209,11 +274,12 @@ size_t HasPredicateScan::getCostEstimate() {
   return 0;
 }
 
-ResultTable HasPredicateScan::computeResult() {
+ResultTable HasPredicateScan::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
   IdTable idTable{getExecutionContext()->getAllocator()};
   idTable.setNumColumns(getResultWidth());
 
-  const std::vector<PatternID>& hasPattern = getIndex().getHasPattern();
+  const CompressedPatternIds& hasPattern = getIndex().getHasPattern();
   const CompactVectorOfStrings<Id>& hasPredicate = getIndex().getHasPredicate();
   const CompactVectorOfStrings<Id>& patterns = getIndex().getPatterns();
 
@@ -237,9 +303,8 @@ ResultTable HasPredicateScan::computeResult() {
       return {std::move(idTable), resultSortedOn(), LocalVocab{}};
     };
     case ScanType::FULL_SCAN:
-      HasPredicateScan::computeFullScan(
-          &idTable, hasPattern, hasPredicate, patterns,
-          getIndex().getNumDistinctSubjectPredicatePairs());
+      HasPredicateScan::computeFullScan(&idTable, hasPattern, hasPredicate,
+                                        patterns);
       return {std::move(idTable), resultSortedOn(), LocalVocab{}};
     case ScanType::SUBQUERY_S:
 
@@ -257,7 +322,7 @@ ResultTable HasPredicateScan::computeResult() {
 }
 
 void HasPredicateScan::computeFreeS(
-    IdTable* resultTable, Id objectId, const std::vector<PatternID>& hasPattern,
+    IdTable* resultTable, Id objectId, const CompressedPatternIds& hasPattern,
     const CompactVectorOfStrings<Id>& hasPredicate,
     const CompactVectorOfStrings<Id>& patterns) {
   IdTableStatic<1> result = std::move(*resultTable).toStatic<1>();
@@ -289,7 +354,7 @@ void HasPredicateScan::computeFreeS(
 
 void HasPredicateScan::computeFreeO(
     IdTable* resultTable, Id subjectAsId,
-    const std::vector<PatternID>& hasPattern,
+    const CompressedPatternIds& hasPattern,
     const CompactVectorOfStrings<Id>& hasPredicate,
     const CompactVectorOfStrings<Id>& patterns) {
   // Subjects always have to be from the vocabulary
@@ -316,40 +381,29 @@ void HasPredicateScan::computeFreeO(
 }
 
 void HasPredicateScan::computeFullScan(
-    IdTable* resultTable, const std::vector<PatternID>& hasPattern,
+    IdTable* resultTable, const CompressedPatternIds& hasPattern,
     const CompactVectorOfStrings<Id>& hasPredicate,
-    const CompactVectorOfStrings<Id>& patterns, size_t resultSize) {
+    const CompactVectorOfStrings<Id>& patterns) {
   IdTableStatic<2> result = std::move(*resultTable).toStatic<2>();
-  result.reserve(resultSize);
-
-  uint64_t subjectIndex = 0;
-  while (subjectIndex < hasPattern.size() ||
-         subjectIndex < hasPredicate.size()) {
-    if (subjectIndex < hasPattern.size() &&
-        hasPattern[subjectIndex] != NO_PATTERN) {
-      // add the pattern
-      for (const auto& predicate : patterns[hasPattern[subjectIndex]]) {
-        result.push_back(
-            {Id::makeFromVocabIndex(VocabIndex::make(subjectIndex)),
-             predicate});
-      }
-    } else if (subjectIndex < hasPredicate.size()) {
-      // add the relations
-      for (const auto& predicate : hasPredicate[subjectIndex]) {
-        result.push_back(
-            {Id::makeFromVocabIndex(VocabIndex::make(subjectIndex)),
-             predicate});
-      }
-    }
-    subjectIndex++;
-  }
+  auto getPredicates = [&](size_t subjectIndex) {
+    return predicatesOf(subjectIndex, hasPattern, hasPredicate, patterns);
+  };
+  auto writeRows = [&result](size_t subjectIndex,
+                             std::span<const Id> predicates, size_t row) {
+    std::ranges::fill_n(
+        result.getColumn(0).begin() + row, predicates.size(),
+        Id::makeFromVocabIndex(VocabIndex::make(subjectIndex)));
+    std::ranges::copy(predicates, result.getColumn(1).begin() + row);
+  };
+  expandToPredicates(result, std::max(hasPattern.size(), hasPredicate.size()),
+                     getPredicates, writeRows);
   *resultTable = std::move(result).toDynamic();
 }
 
 template <int IN_WIDTH, int OUT_WIDTH>
 void HasPredicateScan::computeSubqueryS(
     IdTable* dynResult, const IdTable& dynInput, const size_t subtreeColIndex,
-    const std::vector<PatternID>& hasPattern,
+    const CompressedPatternIds& hasPattern,
     const CompactVectorOfStrings<Id>& hasPredicate,
     const CompactVectorOfStrings<Id>& patterns) {
   IdTableStatic<OUT_WIDTH> result = std::move(*dynResult).toStatic<OUT_WIDTH>();
@@ -357,37 +411,24 @@ void HasPredicateScan::computeSubqueryS(
 
   LOG(DEBUG) << "HasPredicateScan subresult size " << input.size() << std::endl;
 
-  for (size_t i = 0; i < input.size(); i++) {
+  auto getPredicates = [&](size_t i) -> std::span<const Id> {
     Id subjectAsId = input(i, subtreeColIndex);
     if (subjectAsId.getDatatype() != Datatype::VocabIndex) {
-      continue;
+      return {};
     }
-    auto subjectIndex = subjectAsId.getVocabIndex().get();
-    if (subjectIndex < hasPattern.size() &&
-        hasPattern[subjectIndex] != NO_PATTERN) {
-      // Expand the pattern and add it to the result
-      for (const auto& predicate : patterns[hasPattern[subjectIndex]]) {
-        result.emplace_back();
-        size_t backIdx = result.size() - 1;
-        for (size_t k = 0; k < input.numColumns(); k++) {
-          result(backIdx, k) = input(i, k);
-        }
-        result(backIdx, input.numColumns()) = predicate;
-      }
-    } else if (subjectIndex < hasPredicate.size()) {
-      // add the relations
-      for (const auto& predicate : hasPredicate[subjectIndex]) {
-        result.emplace_back();
-        size_t backIdx = result.size() - 1;
-        for (size_t k = 0; k < input.numColumns(); k++) {
-          result(backIdx, k) = input(i, k);
-        }
-        result(backIdx, input.numColumns()) = predicate;
-      }
-    } else {
-      break;
+    return predicatesOf(subjectAsId.getVocabIndex().get(), hasPattern,
+                        hasPredicate, patterns);
+  };
+  auto writeRows = [&result, &input](size_t i, std::span<const Id> predicates,
+                                     size_t row) {
+    for (size_t k = 0; k < input.numColumns(); k++) {
+      std::ranges::fill_n(result.getColumn(k).begin() + row, predicates.size(),
+                          input(i, k));
     }
-  }
+    std::ranges::copy(predicates,
+                      result.getColumn(input.numColumns()).begin() + row);
+  };
+  expandToPredicates(result, input.size(), getPredicates, writeRows);
   *dynResult = std::move(result).toDynamic();
 }
 
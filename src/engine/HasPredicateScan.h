@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "../global/Pattern.h"
+#include "../index/CompressedPatternIds.h"
 #include "../parser/ParsedQuery.h"
 #include "./Operation.h"
 #include "./QueryExecutionTree.h"
@@ -85,30 +86,29 @@ class HasPredicateScan : public Operation {
 
   // These are made static and public mainly for easier testing
   static void computeFreeS(IdTable* resultTable, Id objectId,
-                           const std::vector<PatternID>& hasPattern,
+                           const CompressedPatternIds& hasPattern,
                            const CompactVectorOfStrings<Id>& hasPredicate,
                            const CompactVectorOfStrings<Id>& patterns);
 
   static void computeFreeO(IdTable* resultTable, Id subjectAsId,
-                           const std::vector<PatternID>& hasPattern,
+                           const CompressedPatternIds& hasPattern,
                            const CompactVectorOfStrings<Id>& hasPredicate,
                            const CompactVectorOfStrings<Id>& patterns);
 
   static void computeFullScan(IdTable* resultTable,
-                              const std::vector<PatternID>& hasPattern,
+                              const CompressedPatternIds& hasPattern,
                               const CompactVectorOfStrings<Id>& hasPredicate,
-                              const CompactVectorOfStrings<Id>& patterns,
-                              size_t resultSize);
+                              const CompactVectorOfStrings<Id>& patterns);
 
   template <int IN_WIDTH, int OUT_WIDTH>
   static void computeSubqueryS(IdTable* result, const IdTable& _subtree,
                                size_t subtreeColIndex,
-                               const std::vector<PatternID>& hasPattern,
+                               const CompressedPatternIds& hasPattern,
                                const CompactVectorOfStrings<Id>& hasPredicate,
                                const CompactVectorOfStrings<Id>& patterns);
 
  private:
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
 
   [[nodiscard]] VariableToColumnMap computeVariableToColumnMap() const override;
 };
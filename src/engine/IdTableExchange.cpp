@@ -0,0 +1,328 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/IdTableExchange.h"
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_split.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include "index/ColumnCodec.h"
+#include "util/Exception.h"
+#include "util/HashMap.h"
+#include "util/http/MediaTypes.h"
+
+namespace idTableExchange {
+
+namespace {
+// The number of words of the vocabulary from which the vocabulary identity is
+// computed.
+constexpr size_t NUM_SAMPLED_WORDS = 16;
+
+// Compute the 64-bit FNV-1a hash of all the bytes that are added. We can't use
+// `absl::Hash` because the vocabulary identity has to be the same in different
+// processes.
+class StableHash {
+  uint64_t hash_ = 14695981039346656037ULL;
+
+ public:
+  void add(std::string_view bytes) {
+    for (char c : bytes) {
+      hash_ ^= static_cast<unsigned char>(c);
+      hash_ *= 1099511628211ULL;
+    }
+  }
+  void add(uint64_t value) {
+    add(std::string_view{reinterpret_cast<const char*>(&value), sizeof(value)});
+  }
+  uint64_t get() const { return hash_; }
+};
+
+// Append the bytes of the `value` to the `target`.
+void appendInt(std::string& target, uint64_t value) {
+  target.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Read the `data` from the front and throw if it ends prematurely.
+class Reader {
+  std::string_view data_;
+
+ public:
+  explicit Reader(std::string_view data) : data_{data} {}
+
+  std::string_view readBytes(uint64_t numBytes) {
+    if (numBytes > data_.size()) {
+      throw std::runtime_error{
+          "The result in the exchange format of QLever ends prematurely"};
+    }
+    auto result = data_.substr(0, numBytes);
+    data_.remove_prefix(numBytes);
+    return result;
+  }
+
+  template <typename T = uint64_t>
+  T read() {
+    T result;
+    std::memcpy(&result, readBytes(sizeof(T)).data(), sizeof(T));
+    return result;
+  }
+
+  bool atEnd() const { return data_.empty(); }
+};
+}  // namespace
+
+// _____________________________________________________________________________
+uint64_t getVocabularyIdentity(const Index& index) {
+  StableHash hash;
+  const size_t size = index.getVocab().size();
+  hash.add(size);
+  // The sampled words are evenly spaced and include the first and the last
+  // word of the vocabulary.
+  const size_t numSamples = std::min(size, NUM_SAMPLED_WORDS);
+  for (size_t i = 0; i < numSamples; ++i) {
+    size_t idx = numSamples == 1 ? 0 : i * (size - 1) / (numSamples - 1);
+    auto word = index.idToOptionalString(VocabIndex::make(idx));
+    AD_CORRECTNESS_CHECK(word.has_value());
+    hash.add(word.value().size());
+    hash.add(word.value());
+  }
+  for (const auto& prefix :
+       index.getVocab().getEncodedIriManager().prefixes()) {
+    hash.add(prefix.size());
+    hash.add(prefix);
+  }
+  return hash.get();
+}
+
+// _____________________________________________________________________________
+std::string makeAcceptHeader(uint64_t vocabularyIdentity) {
+  return absl::StrCat(
+      ad_utility::toString(ad_utility::MediaType::qleverIdTable), ";",
+      VOCABULARY_PARAMETER, "=", vocabularyIdentity, ", ",
+      ad_utility::toString(ad_utility::MediaType::tsv), ";q=0.5");
+}
+
+// _____________________________________________________________________________
+std::optional<uint64_t> getVocabularyIdentityFromAcceptHeader(
+    std::string_view acceptHeader) {
+  const std::string mediaType =
+      ad_utility::toString(ad_utility::MediaType::qleverIdTable);
+  for (std::string_view range : absl::StrSplit(acceptHeader, ',')) {
+    std::vector<std::string_view> parts = absl::StrSplit(range, ';');
+    if (absl::StripAsciiWhitespace(parts[0]) != mediaType) {
+      continue;
+    }
+    for (std::string_view parameter : std::span{parts}.subspan(1)) {
+      std::pair<std::string_view, std::string_view> keyAndValue =
+          absl::StrSplit(parameter, absl::MaxSplits('=', 1));
+      if (absl::StripAsciiWhitespace(keyAndValue.first) !=
+          VOCABULARY_PARAMETER) {
+        continue;
+      }
+      auto value = absl::StripAsciiWhitespace(keyAndValue.second);
+      uint64_t identity;
+      auto [ptr, ec] =
+          std::from_chars(value.data(), value.data() + value.size(), identity);
+      if (ec == std::errc{} && ptr == value.data() + value.size()) {
+        return identity;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+// _____________________________________________________________________________
+Encoder::Encoder(const Index& index,
+                 std::optional<uint64_t> receiverVocabularyIdentity)
+    : index_{index},
+      vocabularyIdentity_{getVocabularyIdentity(index)},
+      isSameVocabulary_{receiverVocabularyIdentity == vocabularyIdentity_} {}
+
+// _____________________________________________________________________________
+std::string Encoder::header(size_t numColumns) const {
+  std::string result{MAGIC};
+  appendInt(result, vocabularyIdentity_);
+  appendInt(result, numColumns);
+  return result;
+}
+
+// _____________________________________________________________________________
+void Encoder::setLocalVocab(const LocalVocab& localVocab) {
+  localVocab_ = &localVocab;
+  sentLocalVocabIds_.clear();
+}
+
+// _____________________________________________________________________________
+std::string Encoder::frame(const IdTable& idTable,
+                           std::span<const std::optional<ColumnIndex>> columns,
+                           std::ranges::iota_view<uint64_t, uint64_t> rows) {
+  AD_CONTRACT_CHECK(localVocab_ != nullptr);
+  AD_CONTRACT_CHECK(!rows.empty());
+  std::string dictionary;
+  uint64_t numWords = 0;
+  std::string encodedColumns;
+  std::vector<Id> column;
+  column.reserve(rows.size());
+  for (const auto& columnIndex : columns) {
+    column.clear();
+    for (uint64_t row : rows) {
+      Id id = columnIndex.has_value() ? idTable(row, columnIndex.value())
+                                      : Id::makeUndefined();
+      column.push_back(id);
+      if (needsDictionaryEntry(id)) {
+        std::string word = getWord(id);
+        appendInt(dictionary, id.getBits());
+        appendInt(dictionary, word.size());
+        dictionary.append(word);
+        ++numWords;
+      }
+    }
+    auto [codec, bytes] = columnCodec::encodeWithBestCodec(column);
+    encodedColumns.push_back(static_cast<char>(codec));
+    appendInt(encodedColumns, bytes.size());
+    encodedColumns.append(bytes.data(), bytes.size());
+  }
+  std::string result;
+  appendInt(result, rows.size());
+  appendInt(result, numWords);
+  result.append(dictionary);
+  result.append(encodedColumns);
+  return result;
+}
+
+// _____________________________________________________________________________
+std::string Encoder::endOfStream() {
+  std::string result;
+  appendInt(result, 0);
+  return result;
+}
+
+// _____________________________________________________________________________
+bool Encoder::needsDictionaryEntry(Id id) {
+  switch (id.getDatatype()) {
+    case Datatype::LocalVocabIndex:
+      return sentLocalVocabIds_.insert(id).second;
+    case Datatype::VocabIndex:
+    case Datatype::EncodedIri:
+      return !isSameVocabulary_ && sentIds_.insert(id).second;
+    case Datatype::TextRecordIndex:
+    case Datatype::WordVocabIndex:
+      if (!isSameVocabulary_) {
+        throw std::runtime_error{
+            "Results with entries of the text index can only be exchanged "
+            "between QLever servers with the same index"};
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+// _____________________________________________________________________________
+std::string Encoder::getWord(Id id) const {
+  switch (id.getDatatype()) {
+    case Datatype::LocalVocabIndex:
+      return std::string{localVocab_->getWord(id.getLocalVocabIndex())};
+    case Datatype::VocabIndex: {
+      auto word = index_.idToOptionalString(id.getVocabIndex());
+      AD_CORRECTNESS_CHECK(word.has_value());
+      return std::move(word.value());
+    }
+    case Datatype::EncodedIri:
+      return index_.getVocab().getEncodedIriManager().toString(id);
+    default:
+      AD_FAIL();
+  }
+}
+
+// _____________________________________________________________________________
+bool startsWithMagic(std::string_view data) {
+  return MAGIC.starts_with(data.substr(0, MAGIC.size()));
+}
+
+// _____________________________________________________________________________
+IdTable decode(std::string_view data, size_t numColumns, const Index& index,
+               LocalVocab& localVocab,
+               const ad_utility::AllocatorWithLimit<Id>& allocator) {
+  if (!data.starts_with(MAGIC)) {
+    throw std::runtime_error{"The result is not in the exchange format of "
+                             "QLever, it doesn't start with the magic bytes"};
+  }
+  Reader reader{data.substr(MAGIC.size())};
+  const bool isSameVocabulary =
+      reader.read() == getVocabularyIdentity(index);
+  if (auto numColumnsOfData = reader.read(); numColumnsOfData != numColumns) {
+    throw std::runtime_error{
+        absl::StrCat("The result in the exchange format of QLever has ",
+                     numColumnsOfData, " columns, but ", numColumns,
+                     " columns were expected")};
+  }
+
+  // The `Id`s of the sender that were sent with a dictionary, mapped to the
+  // `Id`s of the receiver.
+  ad_utility::HashMap<Id, Id> dictionary;
+  auto mapId = [&dictionary, isSameVocabulary](Id id) {
+    if (auto it = dictionary.find(id); it != dictionary.end()) {
+      return it->second;
+    }
+    auto type = id.getDatatype();
+    bool isValidWithoutEntry =
+        type != Datatype::LocalVocabIndex &&
+        (isSameVocabulary ||
+         (type != Datatype::VocabIndex && type != Datatype::EncodedIri &&
+          type != Datatype::TextRecordIndex &&
+          type != Datatype::WordVocabIndex));
+    if (!isValidWithoutEntry) {
+      throw std::runtime_error{
+          "The result in the exchange format of QLever contains a value "
+          "that is missing from the dictionary"};
+    }
+    return id;
+  };
+
+  IdTable result{numColumns, allocator};
+  std::vector<Id> column;
+  for (uint64_t numRows = reader.read(); numRows != 0;
+       numRows = reader.read()) {
+    uint64_t numWords = reader.read();
+    for (uint64_t i = 0; i < numWords; ++i) {
+      Id id = Id::fromBits(reader.read());
+      std::string word{reader.readBytes(reader.read())};
+      Id receiverId;
+      if (!index.getId(word, &receiverId)) {
+        receiverId = localVocab.getIdAndAddIfNotContained(word);
+      }
+      dictionary[id] = receiverId;
+    }
+    const size_t offset = result.size();
+    result.resize(offset + numRows);
+    column.resize(numRows);
+    for (size_t col = 0; col < numColumns; ++col) {
+      auto codec = reader.read<uint8_t>();
+      if (codec > static_cast<uint8_t>(ColumnCodec::FrameOfReference)) {
+        throw std::runtime_error{absl::StrCat(
+            "Unknown codec ", static_cast<int>(codec),
+            " in the result in the exchange format of QLever")};
+      }
+      auto bytes = reader.readBytes(reader.read());
+      columnCodec::decode(static_cast<ColumnCodec>(codec),
+                          std::span{bytes.data(), bytes.size()}, column);
+      for (size_t row = 0; row < numRows; ++row) {
+        result(offset + row, col) = mapId(column[row]);
+      }
+    }
+  }
+  if (!reader.atEnd()) {
+    throw std::runtime_error{
+        "The result in the exchange format of QLever has trailing bytes "
+        "after the end of the result"};
+  }
+  return result;
+}
+
+}  // namespace idTableExchange
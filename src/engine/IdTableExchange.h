@@ -0,0 +1,122 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/LocalVocab.h"
+#include "engine/idTable/IdTable.h"
+#include "global/Id.h"
+#include "index/Index.h"
+#include "util/AllocatorWithLimit.h"
+#include "util/HashSet.h"
+
+// A binary format for the exchange of results between QLever servers (the
+// media type `application/x-qlever-idtable`), which transfers the `Id`s of the
+// result instead of their string representations. It consists of a header and
+// a sequence of frames, all integers are 64-bit and little-endian:
+//
+// - Header: the `MAGIC` bytes, the vocabulary identity of the sender (see
+//   `getVocabularyIdentity`), and the number of columns.
+// - Frame: the number of rows, followed by a dictionary that maps `Id`s of the
+//   frame to their words (the number of entries and for each entry the bits of
+//   the `Id`, the size of the word, and the word), followed by the columns,
+//   each compressed with `columnCodec::encodeWithBestCodec` (the codec as a
+//   single byte, the number of bytes, and the bytes).
+// - A frame with zero rows marks the end of the result.
+//
+// The dictionary is a delta: it only contains the `Id`s that haven't been sent
+// with a previous frame. It always contains the `Id`s from the `LocalVocab` of
+// the sender. If the receiver has a different vocabulary (it sends its own
+// vocabulary identity in the "Accept" header, see `makeAcceptHeader`), it also
+// contains the `Id`s of the vocabulary and the encoded IRIs, which the receiver
+// maps to its own vocabulary or to its `LocalVocab`.
+namespace idTableExchange {
+
+// The first bytes of each result in this format.
+inline constexpr std::string_view MAGIC = "QLIDTX01";
+
+// The name of the parameter of the media type in the "Accept" header, with
+// which the receiver announces its vocabulary identity.
+inline constexpr std::string_view VOCABULARY_PARAMETER = "vocabulary";
+
+// A hash of the vocabulary of the `index`, which is the same in all processes
+// that use the same index. Two servers with the same identity can exchange
+// the `Id`s of their vocabularies directly. The identity is computed from the
+// size of the vocabulary, a sample of its words, and the prefixes of the
+// encoded IRIs, which is cheap and in practice distinguishes all indexes.
+uint64_t getVocabularyIdentity(const Index& index);
+
+// The "Accept" header for a request to another QLever server, which prefers
+// this format (with the `vocabularyIdentity` of the receiver) and falls back
+// to TSV, which is supported by all SPARQL endpoints.
+std::string makeAcceptHeader(uint64_t vocabularyIdentity);
+
+// The vocabulary identity that was announced for this format in the
+// `acceptHeader` or `std::nullopt` if there is none.
+std::optional<uint64_t> getVocabularyIdentityFromAcceptHeader(
+    std::string_view acceptHeader);
+
+// Encode a result in this format frame by frame, see above.
+class Encoder {
+ private:
+  const Index& index_;
+  uint64_t vocabularyIdentity_;
+  // True iff the receiver has the same vocabulary, then only the `Id`s from the
+  // `LocalVocab` are part of the dictionaries.
+  bool isSameVocabulary_;
+  // The `Id`s that have already been sent with a dictionary. The `Id`s from the
+  // `LocalVocab` are only valid for the current `localVocab_`.
+  ad_utility::HashSet<Id> sentIds_;
+  ad_utility::HashSet<Id> sentLocalVocabIds_;
+  const LocalVocab* localVocab_ = nullptr;
+
+ public:
+  Encoder(const Index& index,
+          std::optional<uint64_t> receiverVocabularyIdentity);
+
+  // The header of a result with `numColumns` columns.
+  std::string header(size_t numColumns) const;
+
+  // Set the `LocalVocab` of the following frames. It has to be called for
+  // each block of the result, because the blocks of a lazy result have
+  // different local vocabularies.
+  void setLocalVocab(const LocalVocab& localVocab);
+
+  // The frame with the (non-empty) `rows` of the `columns` of the `idTable`. A
+  // column without a value (`std::nullopt`) is undefined in all rows.
+  std::string frame(const IdTable& idTable,
+                    std::span<const std::optional<ColumnIndex>> columns,
+                    std::ranges::iota_view<uint64_t, uint64_t> rows);
+
+  // The frame that marks the end of the result.
+  static std::string endOfStream();
+
+ private:
+  // Return true iff the `id` requires an entry in the dictionary.
+  bool needsDictionaryEntry(Id id);
+
+  // The word of the `id`.
+  std::string getWord(Id id) const;
+};
+
+// Return true iff the `data` starts with the `MAGIC` bytes (or with a prefix
+// of them if it is shorter).
+bool startsWithMagic(std::string_view data);
+
+// Decode the complete result in the `data`, which must have `numColumns`
+// columns. The words of the dictionaries are looked up in the vocabulary of
+// the `index`, the words that are not contained are added to the
+// `localVocab`. Throw if the `data` is not a valid result in this format.
+IdTable decode(std::string_view data, size_t numColumns, const Index& index,
+               LocalVocab& localVocab,
+               const ad_utility::AllocatorWithLimit<Id>& allocator);
+
+}  // namespace idTableExchange
@@ -0,0 +1,224 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/IndexNestedLoopJoin.h"
+
+#include <algorithm>
+
+#include "engine/IndexScan.h"
+#include "global/Constants.h"
+#include "util/Exception.h"
+#include "util/ParallelExecution.h"
+
+// _____________________________________________________________________________
+IndexNestedLoopJoin::IndexNestedLoopJoin(
+    QueryExecutionContext* qec, std::shared_ptr<QueryExecutionTree> left,
+    std::shared_ptr<QueryExecutionTree> right)
+    : Operation{qec}, left_{std::move(left)}, right_{std::move(right)} {
+  AD_CONTRACT_CHECK(isApplicable(*left_, *right_));
+  leftJoinColumn_ = QueryExecutionTree::getJoinColumns(*left_, *right_)[0][0];
+}
+
+// _____________________________________________________________________________
+bool IndexNestedLoopJoin::isApplicable(const QueryExecutionTree& left,
+                                       const QueryExecutionTree& right) {
+  if (right.getType() != QueryExecutionTree::SCAN) {
+    return false;
+  }
+  const auto& scan = dynamic_cast<const IndexScan&>(*right.getRootOperation());
+  if (scan.numVariables() != 2 || scan.hasDeltaTriples()) {
+    return false;
+  }
+  auto joinColumns = QueryExecutionTree::getJoinColumns(left, right);
+  if (joinColumns.size() != 1 || joinColumns[0][1] != 0) {
+    return false;
+  }
+  return left.getVariableAndInfoByColumnIndex(joinColumns[0][0])
+             .second.mightContainUndef_ !=
+         ColumnIndexAndTypeInfo::UndefStatus::PossiblyUndefined;
+}
+
+// _____________________________________________________________________________
+string IndexNestedLoopJoin::getCacheKeyImpl() const {
+  std::ostringstream os;
+  os << "INDEX NESTED LOOP JOIN\n"
+     << left_->getCacheKey() << " join-column: [" << leftJoinColumn_ << "]\n";
+  os << "|X|\n" << right_->getCacheKey();
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string IndexNestedLoopJoin::getDescriptor() const {
+  return "Index nested loop join on " +
+         left_->getVariableAndInfoByColumnIndex(leftJoinColumn_).first.name();
+}
+
+// _____________________________________________________________________________
+size_t IndexNestedLoopJoin::getResultWidth() const {
+  return left_->getResultWidth() + right_->getResultWidth() - 1;
+}
+
+// _____________________________________________________________________________
+vector<ColumnIndex> IndexNestedLoopJoin::resultSortedOn() const {
+  // The rows of the result are in the order of the rows of the left input.
+  return left_->resultSortedOn();
+}
+
+// _____________________________________________________________________________
+VariableToColumnMap IndexNestedLoopJoin::computeVariableToColumnMap() const {
+  return makeVarToColMapForJoinOperation(
+      left_->getVariableColumns(), right_->getVariableColumns(),
+      {{leftJoinColumn_, 0}}, BinOpType::Join, left_->getResultWidth());
+}
+
+// _____________________________________________________________________________
+IndexScan& IndexNestedLoopJoin::getScan() const {
+  return dynamic_cast<IndexScan&>(*right_->getRootOperation());
+}
+
+// _____________________________________________________________________________
+float IndexNestedLoopJoin::getMultiplicity(size_t col) {
+  // Each row of the left input is repeated for each row of its lookup.
+  size_t leftWidth = left_->getResultWidth();
+  if (col < leftWidth) {
+    return left_->getMultiplicity(col) * right_->getMultiplicity(0);
+  }
+  return right_->getMultiplicity(col - leftWidth + 1);
+}
+
+// _____________________________________________________________________________
+double IndexNestedLoopJoin::getNumDistinctLeftEstimate() {
+  return std::max(1.0, left_->getSizeEstimate() /
+                           static_cast<double>(std::max(
+                               1.0f, left_->getMultiplicity(leftJoinColumn_))));
+}
+
+// _____________________________________________________________________________
+std::optional<size_t> IndexNestedLoopJoin::getExactSizeFromCachedLeftInput() {
+  auto cached = getExecutionContext()->getQueryTreeCache().getIfContained(
+      left_->getCacheKey());
+  if (!cached.has_value()) {
+    return std::nullopt;
+  }
+  const auto& leftResult = cached->_resultPointer->resultTable();
+  if (!leftResult->isFullyMaterialized() ||
+      leftResult->size() >
+          RuntimeParameters().get<"index-nested-loop-join-max-left-size">()) {
+    return std::nullopt;
+  }
+  std::vector<Id> keys;
+  std::ranges::copy(leftResult->idTable().getColumn(leftJoinColumn_),
+                    std::back_inserter(keys));
+  std::ranges::sort(keys);
+  const IndexScan& scan = getScan();
+  size_t size = 0;
+  // TODO<C++23> This can be simplified using `std::views::chunk_by`.
+  for (auto it = keys.begin(); it != keys.end();) {
+    auto next = std::ranges::upper_bound(it, keys.end(), *it);
+    size += (next - it) * scan.getSizeOfLookupFirstColumn(*it);
+    it = next;
+  }
+  return size;
+}
+
+// _____________________________________________________________________________
+uint64_t IndexNestedLoopJoin::getSizeEstimateBeforeLimit() {
+  if (sizeEstimate_.has_value()) {
+    return sizeEstimate_.value();
+  }
+  if (auto exactSize = getExactSizeFromCachedLeftInput()) {
+    sizeEstimate_ = exactSize.value();
+    return sizeEstimate_.value();
+  }
+  // The same estimate as for a `Join`: The distinct values of the join column
+  // of the input with fewer of them are all contained in the other input.
+  double numDistinctLeft = getNumDistinctLeftEstimate();
+  double numDistinctRight =
+      std::max(1.0, right_->getSizeEstimate() /
+                        static_cast<double>(
+                            std::max(1.0f, right_->getMultiplicity(0))));
+  double numDistinctResult = std::min(numDistinctLeft, numDistinctRight);
+  sizeEstimate_ = static_cast<size_t>(
+      numDistinctResult * left_->getMultiplicity(leftJoinColumn_) *
+      right_->getMultiplicity(0));
+  return sizeEstimate_.value();
+}
+
+// _____________________________________________________________________________
+size_t IndexNestedLoopJoin::getCostEstimate() {
+  // Each lookup reads at least one block of the permutation, and the rows of
+  // the lookups are part of the result. The scan itself is never computed.
+  auto costOfLookups = static_cast<size_t>(
+      getNumDistinctLeftEstimate() * INDEX_NESTED_LOOP_JOIN_COST_PER_LOOKUP);
+  return left_->getCostEstimate() + left_->getSizeEstimate() + costOfLookups +
+         getSizeEstimateBeforeLimit();
+}
+
+// _____________________________________________________________________________
+ResultTable IndexNestedLoopJoin::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
+  right_->getRootOperation()->updateRuntimeInformationWhenOptimizedOut(
+      {}, RuntimeInformation::Status::lazilyMaterialized);
+  auto leftResult = left_->getResult();
+  const IdTable& left = leftResult->idTable();
+
+  // The distinct values of the join column, sorted s.t. the lookups read the
+  // blocks of the permutation in order.
+  std::vector<Id> keys;
+  std::ranges::copy(left.getColumn(leftJoinColumn_), std::back_inserter(keys));
+  std::ranges::sort(keys);
+  auto duplicates = std::ranges::unique(keys);
+  keys.erase(duplicates.begin(), duplicates.end());
+  runtimeInfo().addDetail("num-lookups", keys.size());
+
+  // Perform the lookups for contiguous chunks of the keys on separate threads.
+  static constexpr size_t minNumKeysPerThread = 64;
+  size_t numThreads = std::clamp(
+      keys.size() / minNumKeysPerThread, size_t{1},
+      std::max(size_t{1}, getExecutionContext()->getNumThreads(
+                              RuntimeParameters().get<"join-num-threads">())));
+  size_t chunkSize = keys.size() / numThreads + 1;
+  std::vector<IdTable> lookups;
+  lookups.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    lookups.emplace_back(right_->getResultWidth(),
+                         getExecutionContext()->getAllocator());
+  }
+  const IndexScan& scan = getScan();
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    size_t end = std::min(keys.size(), (threadIdx + 1) * chunkSize);
+    for (size_t i = threadIdx * chunkSize; i < end; ++i) {
+      checkCancellation();
+      lookups[i] = scan.lookupFirstColumn(keys[i]);
+    }
+  });
+
+  // Combine each row of the left input with the rows of its lookup.
+  auto getLookup = [&keys, &lookups](Id key) -> const IdTable& {
+    return lookups[std::ranges::lower_bound(keys, key) - keys.begin()];
+  };
+  std::span<const Id> leftJoinColumn = left.getColumn(leftJoinColumn_);
+  size_t numRows = 0;
+  for (Id key : leftJoinColumn) {
+    numRows += getLookup(key).numRows();
+  }
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  result.resize(numRows);
+  size_t row = 0;
+  for (size_t i = 0; i < left.numRows(); ++i) {
+    const IdTable& lookup = getLookup(leftJoinColumn[i]);
+    for (size_t col = 0; col < left.numColumns(); ++col) {
+      std::ranges::fill_n(result.getColumn(col).begin() + row, lookup.numRows(),
+                          left(i, col));
+    }
+    for (size_t col = 1; col < lookup.numColumns(); ++col) {
+      std::ranges::copy(
+          lookup.getColumn(col),
+          result.getColumn(left.numColumns() + col - 1).begin() + row);
+    }
+    row += lookup.numRows();
+  }
+  checkCancellation();
+  return {std::move(result), resultSortedOn(),
+          leftResult->getSharedLocalVocab()};
+}
@@ -0,0 +1,86 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <memory>
+
+#include "engine/Operation.h"
+#include "engine/QueryExecutionTree.h"
+
+class IndexScan;
+
+// A join of a small left input with an `IndexScan` with two variables (the
+// right input) on the first column of the scan. Instead of reading the scan,
+// the rows of the scan for each distinct value of the join column of the left
+// input are read via a point lookup in the permutation (see
+// `IndexScan::lookupFirstColumn`). The lookups are sorted by their value and
+// performed on several threads. This pays off if the left input has few
+// distinct values in its join column, for example for queries about a single
+// entity. The result has the columns of the left input, followed by the
+// columns of the scan without the join column, like the result of a `Join`.
+class IndexNestedLoopJoin : public Operation {
+ private:
+  std::shared_ptr<QueryExecutionTree> left_;
+  std::shared_ptr<QueryExecutionTree> right_;
+  ColumnIndex leftJoinColumn_;
+
+  std::optional<size_t> sizeEstimate_;
+
+ public:
+  IndexNestedLoopJoin(QueryExecutionContext* qec,
+                      std::shared_ptr<QueryExecutionTree> left,
+                      std::shared_ptr<QueryExecutionTree> right);
+
+  // Return true iff an `IndexNestedLoopJoin` of `left` and `right` is
+  // possible: `right` is an `IndexScan` with two variables on an index without
+  // inserted or deleted triples, and the only variable that `left` and `right`
+  // share is the variable of the first column of the scan, which must never be
+  // UNDEF in `left`.
+  static bool isApplicable(const QueryExecutionTree& left,
+                           const QueryExecutionTree& right);
+
+ protected:
+  string getCacheKeyImpl() const override;
+
+ public:
+  string getDescriptor() const override;
+
+  size_t getResultWidth() const override;
+
+  vector<ColumnIndex> resultSortedOn() const override;
+
+  void setTextLimit(size_t limit) override { left_->setTextLimit(limit); }
+
+  bool knownEmptyResult() override {
+    return left_->knownEmptyResult() || right_->knownEmptyResult();
+  }
+
+  float getMultiplicity(size_t col) override;
+
+ private:
+  uint64_t getSizeEstimateBeforeLimit() override;
+
+ public:
+  size_t getCostEstimate() override;
+
+  vector<QueryExecutionTree*> getChildren() override {
+    return {left_.get(), right_.get()};
+  }
+
+ private:
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
+
+  VariableToColumnMap computeVariableToColumnMap() const override;
+
+  // The number of distinct values in the join column of the left input that
+  // is expected by the query planner.
+  double getNumDistinctLeftEstimate();
+
+  // If the result of the left input is cached and small, return the exact
+  // size of the result, which is computed from the sizes of the lookups (see
+  // `IndexScan::getSizeOfLookupFirstColumn`).
+  std::optional<size_t> getExactSizeFromCachedLeftInput();
+
+  IndexScan& getScan() const;
+};
@@ -7,7 +7,9 @@
 #include <sstream>
 #include <string>
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "index/DeltaTriples.h"
 #include "index/IndexImpl.h"
 #include "index/TriplesView.h"
 #include "parser/ParsedQuery.h"
@@ -119,7 +121,14 @@ VariableToColumnMap IndexScan::computeVariableToColumnMap() const {
   return variableToColumnMap;
 }
 // _____________________________________________________________________________
-ResultTable IndexScan::computeResult() {
+ResultTable IndexScan::computeResult(bool requestLaziness) {
+  // The lazy scans read the blocks of the permutations directly, so they don't
+  // see the inserted and deleted triples.
+  if (requestLaziness && !hasDeltaTriples()) {
+    return {numVariables_ < 3 ? scanLazily()
+                              : computeFullScanLazily(permutation_),
+            resultSortedOn()};
+  }
   LOG(DEBUG) << "IndexScan result computation...\n";
   IdTable idTable{getExecutionContext()->getAllocator()};
 
@@ -136,13 +145,186 @@ ResultTable IndexScan::computeResult() {
   } else {
     AD_CORRECTNESS_CHECK(numVariables_ == 3);
     computeFullScan(&idTable, permutation_);
+    index.deltaTriples().mergeIntoScan(permutation_, std::nullopt,
+                                      std::nullopt, idTable);
   }
   AD_CORRECTNESS_CHECK(idTable.numColumns() == getResultWidth());
   LOG(DEBUG) << "IndexScan result computation done.\n";
 
+  // The inserted triples can contain words of the local vocab of the
+  // `DeltaTriples`.
+  auto containsLocalVocabId = [&idTable]() {
+    return std::ranges::any_of(idTable.getColumns(), [](const auto& column) {
+      return std::ranges::any_of(column, [](Id id) {
+        return id.getDatatype() == Datatype::LocalVocabIndex;
+      });
+    });
+  };
+  auto deltaLocalVocab = index.deltaTriples().localVocab();
+  if (!deltaLocalVocab->empty() && containsLocalVocabId()) {
+    return {std::move(idTable), resultSortedOn(),
+            ResultTable::shareImmutableLocalVocab(std::move(deltaLocalVocab))};
+  }
   return {std::move(idTable), resultSortedOn(), LocalVocab{}};
 }
 
+// _____________________________________________________________________________
+IdTable IndexScan::lookupFirstColumn(Id firstColumnId) const {
+  AD_CONTRACT_CHECK(numVariables_ == 2);
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  const auto& index = getIndex();
+  std::optional<Id> col0Id =
+      index.getImpl().toValueIdIncludingDeltaTriples(*getPermutedTriple()[0]);
+  if (!col0Id.has_value()) {
+    return result;
+  }
+  // The lookup doesn't contain the fixed `firstColumnId`, so it is added as
+  // the first column of the result.
+  IdTable lookup = index.scan(col0Id.value(), firstColumnId, permutation_,
+                              additionalColumns(), cancellationHandle_);
+  AD_CORRECTNESS_CHECK(lookup.numColumns() + 1 == result.numColumns());
+  result.resize(lookup.numRows());
+  std::ranges::fill(result.getColumn(0), firstColumnId);
+  for (size_t i = 0; i < lookup.numColumns(); ++i) {
+    std::ranges::copy(lookup.getColumn(i), result.getColumn(i + 1).begin());
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+size_t IndexScan::getSizeOfLookupFirstColumn(Id firstColumnId) const {
+  AD_CONTRACT_CHECK(numVariables_ == 2);
+  const auto& index = getIndex().getImpl();
+  std::optional<Id> col0Id =
+      index.toValueIdIncludingDeltaTriples(*getPermutedTriple()[0]);
+  if (!col0Id.has_value()) {
+    return 0;
+  }
+  auto delta =
+      index.deltaTriples().getCounts(permutation_, col0Id, firstColumnId);
+  return index.getPermutation(permutation_)
+             .getResultSizeOfScan(col0Id.value(), firstColumnId) +
+         delta.numInserted_ - delta.numDeleted_;
+}
+
+// _____________________________________________________________________________
+std::optional<size_t> IndexScan::getNumDistinctFromMetadata(
+    const Variable& variable) const {
+  if (numVariables_ != 2) {
+    return std::nullopt;
+  }
+  auto permutedTriple = getPermutedTriple();
+  bool isCol1 = *permutedTriple[1] == variable;
+  if (!isCol1 && *permutedTriple[2] != variable) {
+    return std::nullopt;
+  }
+  const auto& index = getIndex().getImpl();
+  std::optional<Id> col0Id = permutedTriple[0]->toValueId(index.getVocab());
+  const auto& metaData = index.getPermutation(permutation_).metaData();
+  if (!col0Id.has_value() || !metaData.col0IdExists(col0Id.value())) {
+    return 0;
+  }
+  auto relationMetadata = metaData.getMetaData(col0Id.value());
+  return isCol1 ? relationMetadata.getNumDistinctCol1()
+                : relationMetadata.getNumDistinctCol2();
+}
+
+// _____________________________________________________________________________
+std::optional<std::pair<Id, Id>> IndexScan::getFirstAndLastIdOfFirstColumn()
+    const {
+  AD_CONTRACT_CHECK(numVariables_ < 3);
+  if (getExactSize() == 0) {
+    return std::nullopt;
+  }
+  auto metaBlocks = getMetadataForScan(*this);
+  if (!metaBlocks.has_value() ||
+      !metaBlocks.value().firstAndLastTriple_.has_value()) {
+    return std::nullopt;
+  }
+  const auto& [first, last] = metaBlocks.value().firstAndLastTriple_.value();
+  if (numVariables_ == 2) {
+    return std::pair{first.col1Id_, last.col1Id_};
+  }
+  return std::pair{first.col2Id_, last.col2Id_};
+}
+
+// _____________________________________________________________________________
+IdTable IndexScan::getCountsOfFirstColumn() const {
+  AD_CONTRACT_CHECK(numVariables_ == 2);
+  IdTable result{2, getExecutionContext()->getAllocator()};
+  auto metaBlocks = getMetadataForScan(*this);
+  if (!metaBlocks.has_value()) {
+    return result;
+  }
+  Id col0Id = metaBlocks.value().relationMetadata_.col0Id_;
+
+  std::vector<std::pair<Id, size_t>> counts;
+  auto addRows = [&counts](Id id, size_t numRows) {
+    if (!counts.empty() && counts.back().first == id) {
+      counts.back().second += numRows;
+    } else {
+      counts.emplace_back(id, numRows);
+    }
+  };
+  for (const auto& block : metaBlocks.value().blockMetadata_) {
+    checkCancellation();
+    const auto& first = block.firstTriple_;
+    const auto& last = block.lastTriple_;
+    if (first.col0Id_ == col0Id && last.col0Id_ == col0Id &&
+        first.col1Id_ == last.col1Id_) {
+      addRows(first.col1Id_, block.numRows_);
+      continue;
+    }
+    // The block also contains other values, so it has to be read. The scan
+    // only yields the rows of this relation.
+    for (const IdTable& rows : getLazyScan(*this, {block})) {
+      for (Id id : rows.getColumn(0)) {
+        addRows(id, 1);
+      }
+    }
+  }
+
+  result.resize(counts.size());
+  for (size_t i = 0; i < counts.size(); ++i) {
+    result(i, 0) = counts[i].first;
+    result(i, 1) = Id::makeFromInt(static_cast<int64_t>(counts[i].second));
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+bool IndexScan::hasDeltaTriples() const {
+  return !getIndex().deltaTriples().empty();
+}
+
+// _____________________________________________________________________________
+std::string IndexScan::getCardinalityFeedbackSignature(
+    ColumnIndex column) const {
+  // The first columns of the result belong to the variables of the permuted
+  // triple, all further columns are additional columns.
+  auto permutedTriple = getPermutedTriple();
+  const TripleComponent* joinElement =
+      column < numVariables_ ? permutedTriple.at(3 - numVariables_ + column)
+                             : nullptr;
+  auto toString = [joinElement](const TripleComponent& element,
+                                bool showValue) -> std::string {
+    if (&element == joinElement) {
+      return "[join]";
+    } else if (element.isVariable()) {
+      return "?";
+    }
+    return showValue ? element.toRdfLiteral() : "<fixed>";
+  };
+  std::string signature =
+      absl::StrCat(toString(subject_, false), " ", toString(predicate_, true),
+                   " ", toString(object_, false));
+  if (column >= numVariables_) {
+    absl::StrAppend(&signature, " [join on additional column ",
+                    column - numVariables_, "]");
+  }
+  return signature;
+}
+
 // _____________________________________________________________________________
 size_t IndexScan::computeSizeEstimate() const {
   if (_executionContext) {
@@ -174,7 +356,9 @@ size_t IndexScan::computeSizeEstimate() const {
       // the number of triples in the actual knowledge graph (excluding the
       // internal triples).
       AD_CORRECTNESS_CHECK(numVariables_ == 3);
-      return getIndex().numTriples().normalAndInternal_();
+      auto delta = getIndex().deltaTriples().getCounts();
+      return getIndex().numTriples().normalAndInternal_() +
+             delta.numInserted_ - delta.numDeleted_;
     }
   } else {
     // Only for test cases. The handling of the objects is to make the
@@ -253,19 +437,7 @@ void IndexScan::computeFullScan(IdTable* result,
 
   result->setNumColumns(3);
 
-  // This implementation computes the complete knowledge graph, except the
-  // internal triples.
-  uint64_t resultSize = getIndex().numTriples().normal_;
-  if (getLimit()._limit.has_value() && getLimit()._limit < resultSize) {
-    resultSize = getLimit()._limit.value();
-  }
-
-  // TODO<joka921> Implement OFFSET
-  if (getLimit()._offset != 0) {
-    throw NotSupportedException{
-        "Scanning the complete index with an OFFSET clause is currently not "
-        "supported by QLever"};
-  }
+  uint64_t resultSize = getResultSizeOfFullScan();
   result->reserve(resultSize);
   auto table = std::move(*result).toStatic<3>();
   size_t i = 0;
@@ -283,6 +455,61 @@ void IndexScan::computeFullScan(IdTable* result,
   *result = std::move(table).toDynamic();
 }
 
+// _____________________________________________________________________________
+ResultTable::Generator IndexScan::computeFullScanLazily(
+    const Permutation::Enum permutation) const {
+  // The number of triples per yielded block.
+  static constexpr size_t blockSize = 100'000;
+  auto [ignoredRanges, isTripleIgnored] =
+      getIndex().getImpl().getIgnoredIdRanges(permutation);
+  uint64_t resultSize = getResultSizeOfFullScan();
+  auto makeBlock = [this, resultSize]() {
+    IdTableStatic<3> block{getExecutionContext()->getAllocator()};
+    block.reserve(std::min(resultSize, uint64_t{blockSize}));
+    return block;
+  };
+  auto block = makeBlock();
+  size_t i = 0;
+  const auto& permutationImpl =
+      getExecutionContext()->getIndex().getImpl().getPermutation(permutation);
+  auto triplesView = TriplesView(permutationImpl, cancellationHandle_,
+                                 ignoredRanges, isTripleIgnored);
+  for (const auto& triple : triplesView) {
+    if (i >= resultSize) {
+      break;
+    }
+    block.push_back(triple);
+    ++i;
+    if (block.size() == blockSize) {
+      co_yield ResultTable::IdTableVocabPair{std::move(block).toDynamic(),
+                                             LocalVocab{}};
+      block = makeBlock();
+    }
+  }
+  if (!block.empty()) {
+    co_yield ResultTable::IdTableVocabPair{std::move(block).toDynamic(),
+                                           LocalVocab{}};
+  }
+}
+
+// _____________________________________________________________________________
+uint64_t IndexScan::getResultSizeOfFullScan() const {
+  // This implementation computes the complete knowledge graph, except the
+  // internal triples.
+  uint64_t resultSize = getIndex().numTriples().normal_;
+  if (getLimit()._limit.has_value() && getLimit()._limit < resultSize) {
+    resultSize = getLimit()._limit.value();
+  }
+
+  // TODO<joka921> Implement OFFSET
+  if (getLimit()._offset != 0) {
+    throw NotSupportedException{
+        "Scanning the complete index with an OFFSET clause is currently not "
+        "supported by QLever"};
+  }
+  return resultSize;
+}
+
 // ___________________________________________________________________________
 std::array<const TripleComponent* const, 3> IndexScan::getPermutedTriple()
     const {
@@ -292,6 +519,31 @@ std::array<const TripleComponent* const, 3> IndexScan::getPermutedTriple()
           triple[permutation[2]]};
 }
 
+// ___________________________________________________________________________
+std::vector<Id> IndexScan::sampleFirstColumn(size_t numBlocks) const {
+  AD_CONTRACT_CHECK(numVariables_ == 2);
+  auto metaBlocks = getMetadataForScan(*this);
+  if (!metaBlocks.has_value() || numBlocks == 0) {
+    return {};
+  }
+  const auto& allBlocks = metaBlocks.value().blockMetadata_;
+  std::vector<CompressedBlockMetadata> blocks;
+  numBlocks = std::min(numBlocks, allBlocks.size());
+  for (size_t i = 0; i < numBlocks; ++i) {
+    blocks.push_back(allBlocks[i * allBlocks.size() / numBlocks]);
+  }
+  const IndexImpl& index = getIndex().getImpl();
+  Id col0Id = getPermutedTriple()[0]->toValueId(index.getVocab()).value();
+  std::vector<Id> sample;
+  for (const IdTable& block :
+       index.getPermutation(permutation_)
+           .lazyScan(col0Id, std::nullopt, std::move(blocks), {},
+                     cancellationHandle_)) {
+    std::ranges::copy(block.getColumn(0), std::back_inserter(sample));
+  }
+  return sample;
+}
+
 // ___________________________________________________________________________
 Permutation::IdTableGenerator IndexScan::getLazyScan(
     const IndexScan& s, std::vector<CompressedBlockMetadata> blocks) {
@@ -306,6 +558,141 @@ Permutation::IdTableGenerator IndexScan::getLazyScan(
                 s.cancellationHandle_);
 };
 
+// ___________________________________________________________________________
+ResultTable::Generator IndexScan::scanLazily() const {
+  auto metaBlocks = getMetadataForScan(*this);
+  if (!metaBlocks.has_value()) {
+    co_return;
+  }
+  const auto& blockMetadata = metaBlocks.value().blockMetadata_;
+  for (auto& pair :
+       scanBlocksLazily(std::vector(blockMetadata.begin(), blockMetadata.end()),
+                        blockMetadata.size())) {
+    co_yield pair;
+  }
+}
+
+// ___________________________________________________________________________
+ResultTable::Generator IndexScan::scanBlocksLazily(
+    std::vector<CompressedBlockMetadata> blocks, size_t numBlocksAll) const {
+  auto blockGenerator = getLazyScan(*this, std::move(blocks));
+  blockGenerator.details().numBlocksAll_ = numBlocksAll;
+  for (IdTable& block : blockGenerator) {
+    co_yield ResultTable::IdTableVocabPair{std::move(block), LocalVocab{}};
+  }
+  const auto& details = blockGenerator.details();
+  runtimeInfo().addDetail("num-blocks-read", details.numBlocksRead_);
+  runtimeInfo().addDetail("num-blocks-all", details.numBlocksAll_);
+  runtimeInfo().addDetail("num-elements-read", details.numElementsRead_);
+}
+
+// ___________________________________________________________________________
+std::optional<ResultTable> IndexScan::computeResultWithPrefilter(
+    const Variable& variable, valueIdComparators::Comparison comparison,
+    Id constant, bool requestLaziness) const {
+  return computeResultWithPrefilterImpl(
+      variable,
+      [comparison, constant](const auto& metaBlocks) {
+        return CompressedRelationReader::getBlocksForFilter(
+            metaBlocks, comparison, constant);
+      },
+      requestLaziness);
+}
+
+// ___________________________________________________________________________
+std::optional<ResultTable> IndexScan::computeResultWithPrefilter(
+    const Variable& variable, std::span<const std::pair<Id, Id>> ranges,
+    bool requestLaziness) const {
+  return computeResultWithPrefilterImpl(
+      variable,
+      [ranges](const auto& metaBlocks) {
+        return CompressedRelationReader::getBlocksForIdRanges(metaBlocks,
+                                                              ranges);
+      },
+      requestLaziness);
+}
+
+// ___________________________________________________________________________
+std::optional<ResultTable> IndexScan::computeResultWithPrefilterImpl(
+    const Variable& variable, const GetBlocksForPrefilter& getBlocks,
+    bool requestLaziness) const {
+  if (numVariables_ == 3 || hasDeltaTriples()) {
+    return std::nullopt;
+  }
+  // The first variable is the col1 if there are two variables, else the col2.
+  const auto& firstVariable = *getPermutedTriple()[3 - numVariables_];
+  if (!firstVariable.isVariable() || firstVariable.getVariable() != variable) {
+    return std::nullopt;
+  }
+  auto metaBlocks = getMetadataForScan(*this);
+  if (!metaBlocks.has_value()) {
+    return ResultTable{
+        IdTable{getResultWidth(), getExecutionContext()->getAllocator()},
+        resultSortedOn(), LocalVocab{}};
+  }
+  auto blocks = getBlocks(metaBlocks.value());
+  size_t numBlocksAll = metaBlocks.value().blockMetadata_.size();
+  runtimeInfo().addDetail("num-blocks-skipped-by-filter",
+                          numBlocksAll - blocks.size());
+  auto generator = scanBlocksLazily(std::move(blocks), numBlocksAll);
+  if (requestLaziness) {
+    return ResultTable{std::move(generator), resultSortedOn()};
+  }
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  for (const auto& [block, localVocab] : generator) {
+    result.insertAtEnd(block.begin(), block.end());
+  }
+  return ResultTable{std::move(result), resultSortedOn(), LocalVocab{}};
+}
+
+// ___________________________________________________________________________
+std::optional<ResultTable> IndexScan::computeResultWithSemiJoinFilter(
+    const Variable& variable, std::span<const Id> values) {
+  const auto& columns = getExternallyVisibleVariableColumns();
+  auto it = columns.find(variable);
+  if (numVariables_ == 3 || it == columns.end() || hasDeltaTriples()) {
+    return std::nullopt;
+  }
+  ColumnIndex column = it->second.columnIndex_;
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  auto metaBlocks = getMetadataForScan(*this);
+  if (!metaBlocks.has_value()) {
+    return ResultTable{std::move(result), resultSortedOn(), LocalVocab{}};
+  }
+  const auto& allBlocks = metaBlocks.value().blockMetadata_;
+  // Only the first column is sorted, so only for this column the blocks can
+  // be filtered via their metadata.
+  auto blocks =
+      column == 0 ? CompressedRelationReader::getBlocksForJoin(
+                        values, metaBlocks.value())
+                  : std::vector(allBlocks.begin(), allBlocks.end());
+  auto generator = getLazyScan(*this, std::move(blocks));
+  generator.details().numBlocksAll_ = allBlocks.size();
+  for (const IdTable& block : generator) {
+    decltype(auto) blockColumn = block.getColumn(column);
+    auto beginOfValues = values.begin();
+    for (size_t i = 0; i < block.numRows(); ++i) {
+      Id id = blockColumn[i];
+      if (column == 0) {
+        // The first column is sorted, so the position in the `values` only
+        // moves forward.
+        beginOfValues = std::lower_bound(beginOfValues, values.end(), id);
+        if (beginOfValues != values.end() && *beginOfValues == id) {
+          result.push_back(block[i]);
+        }
+      } else if (std::ranges::binary_search(values, id)) {
+        result.push_back(block[i]);
+      }
+    }
+    checkCancellation();
+  }
+  const auto& details = generator.details();
+  runtimeInfo().addDetail("num-blocks-read", details.numBlocksRead_);
+  runtimeInfo().addDetail("num-blocks-all", details.numBlocksAll_);
+  runtimeInfo().addDetail("num-elements-read", details.numElementsRead_);
+  return ResultTable{std::move(result), resultSortedOn(), LocalVocab{}};
+}
+
 // ________________________________________________________________
 std::optional<Permutation::MetadataAndBlocks> IndexScan::getMetadataForScan(
     const IndexScan& s) {
@@ -356,6 +743,71 @@ IndexScan::lazyScanForJoinOfTwoScans(const IndexScan& s1, const IndexScan& s2) {
   return result;
 }
 
+// ________________________________________________________________
+std::vector<Permutation::IdTableGenerator> IndexScan::lazyScanForJoinOfScans(
+    const std::vector<const IndexScan*>& scans) {
+  AD_CONTRACT_CHECK(scans.size() >= 2);
+  std::vector<Permutation::MetadataAndBlocks> metaBlocks;
+  for (const IndexScan* scan : scans) {
+    AD_CONTRACT_CHECK(scan->numVariables_ == 2);
+    AD_CONTRACT_CHECK(*scan->getPermutedTriple()[1] ==
+                      *scans.front()->getPermutedTriple()[1]);
+    auto metaBlocksOfScan = getMetadataForScan(*scan);
+    if (!metaBlocksOfScan.has_value()) {
+      // One of the scans is empty, so is the result of the join.
+      std::vector<Permutation::IdTableGenerator> result;
+      result.resize(scans.size());
+      return result;
+    }
+    metaBlocks.push_back(std::move(metaBlocksOfScan.value()));
+  }
+
+  // Filter the blocks of each scan against the (already filtered) blocks of
+  // each other scan.
+  std::vector<std::vector<CompressedBlockMetadata>> blocks;
+  for (const auto& metaBlocksOfScan : metaBlocks) {
+    const auto& blocksOfScan = metaBlocksOfScan.blockMetadata_;
+    blocks.emplace_back(blocksOfScan.begin(), blocksOfScan.end());
+  }
+  auto withFilteredBlocks = [&metaBlocks, &blocks](size_t i) {
+    const auto& m = metaBlocks.at(i);
+    return Permutation::MetadataAndBlocks{m.relationMetadata_, blocks.at(i),
+                                          m.col1Id_, m.firstAndLastTriple_};
+  };
+  for (size_t i = 0; i < scans.size(); ++i) {
+    for (size_t j = 0; j < scans.size(); ++j) {
+      if (i != j) {
+        blocks.at(i) = CompressedRelationReader::getBlocksForJoin(
+            withFilteredBlocks(i), withFilteredBlocks(j))[0];
+      }
+    }
+  }
+
+  std::vector<Permutation::IdTableGenerator> result;
+  for (size_t i = 0; i < scans.size(); ++i) {
+    result.push_back(getLazyScan(*scans.at(i), std::move(blocks.at(i))));
+    result.back().details().numBlocksAll_ =
+        metaBlocks.at(i).blockMetadata_.size();
+  }
+  return result;
+}
+
+// ________________________________________________________________
+void IndexScan::updateRuntimeInfoForLazyScan(
+    const CompressedRelationReader::LazyScanMetadata& metadata) {
+  updateRuntimeInformationWhenOptimizedOut(
+      RuntimeInformation::Status::lazilyMaterialized);
+  auto& rti = runtimeInfo();
+  rti.numRows_ = metadata.numElementsRead_;
+  rti.totalTime_ = metadata.blockingTime_;
+  rti.addDetail("num-blocks-read", metadata.numBlocksRead_);
+  rti.addDetail("num-blocks-all", metadata.numBlocksAll_);
+  if (metadata.maxNumThreads_ > 0) {
+    rti.addDetail("max-num-threads", metadata.maxNumThreads_);
+    rti.addDetail("max-prefetch-depth", metadata.maxPrefetchDepth_);
+  }
+}
+
 // ________________________________________________________________
 Permutation::IdTableGenerator IndexScan::lazyScanForJoinOfColumnWithScan(
     std::span<const Id> joinColumn, const IndexScan& s) {
@@ -3,6 +3,7 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include "./Operation.h"
@@ -36,6 +37,7 @@ class IndexScan : public Operation {
   const TripleComponent& getPredicate() const { return predicate_; }
   const TripleComponent& getSubject() const { return subject_; }
   const TripleComponent& getObject() const { return object_; }
+  size_t numVariables() const { return numVariables_; }
 
   const std::vector<ColumnIndex>& additionalColumns() const {
     return additionalColumns_;
@@ -54,6 +56,13 @@ class IndexScan : public Operation {
   // can be read from the Metadata.
   size_t getExactSize() const { return sizeEstimate_; }
 
+  // Return a description of this scan that is independent of the concrete
+  // subject and object, but contains the predicate (if it is fixed) and marks
+  // the element of the triple that belongs to the `column` of the result, for
+  // example `? <p> [join]`. Used as part of the signatures of the
+  // `CardinalityFeedback` (see `Join::getCardinalityFeedbackEstimate`).
+  std::string getCardinalityFeedbackSignature(ColumnIndex column) const;
+
   // Return two generators that lazily yield the results of `s1` and `s2` in
   // blocks, but only the blocks that can theoretically contain matching rows
   // when performing a join on the first column of the result of `s1` with the
@@ -61,6 +70,24 @@ class IndexScan : public Operation {
   static std::array<Permutation::IdTableGenerator, 2> lazyScanForJoinOfTwoScans(
       const IndexScan& s1, const IndexScan& s2);
 
+  // Generalization of `lazyScanForJoinOfTwoScans` for a join of all the
+  // `scans` (at least two, each with two variables) on the first column of
+  // their results: The blocks of each scan are only read if they can contain
+  // matching rows for all the other scans.
+  static std::vector<Permutation::IdTableGenerator> lazyScanForJoinOfScans(
+      const std::vector<const IndexScan*>& scans);
+
+  // Return true iff triples were inserted into or deleted from the index (see
+  // `DeltaTriples`). In this case, the result is always fully materialized and
+  // the `lazyScanFor...` functions (which read the blocks of the permutations
+  // directly and filter them using their metadata) must not be used.
+  bool hasDeltaTriples() const;
+
+  // Set the runtime information of this scan when it was lazily executed as
+  // part of a join (see the `lazyScanForJoin...` functions).
+  void updateRuntimeInfoForLazyScan(
+      const CompressedRelationReader::LazyScanMetadata& metadata);
+
   // Return a generator that lazily yields the result of `s` in blocks, but only
   // the blocks that can theoretically contain matching rows when performing a
   // join between the first column of the result of `s`  with the `joinColumn`.
@@ -68,6 +95,68 @@ class IndexScan : public Operation {
   static Permutation::IdTableGenerator lazyScanForJoinOfColumnWithScan(
       std::span<const Id> joinColumn, const IndexScan& s);
 
+  // If the `variable` is the first column of the result of this scan (which is
+  // the column by which the result is sorted), compute the result of this scan,
+  // but skip all the blocks that cannot contain a row that fulfills
+  // `variable <comparison> constant`. The result still contains the other rows
+  // of the scanned blocks, so the filter still has to be applied. Return
+  // `std::nullopt` if the `variable` is not the first column or if this is a
+  // full scan or if the index has inserted or deleted triples (see
+  // `hasDeltaTriples`).
+  std::optional<ResultTable> computeResultWithPrefilter(
+      const Variable& variable, valueIdComparators::Comparison comparison,
+      Id constant, bool requestLaziness) const;
+
+  // Similar to the overload above, but skip all the blocks that cannot contain
+  // a row for which the `variable` is contained in at least one of the
+  // `ranges` (see `CompressedRelationReader::getBlocksForIdRanges`).
+  std::optional<ResultTable> computeResultWithPrefilter(
+      const Variable& variable, std::span<const std::pair<Id, Id>> ranges,
+      bool requestLaziness) const;
+
+  // For a scan with two variables, return the rows of its result that have
+  // the `firstColumnId` in their first column (which is the column by which
+  // the result is sorted). This is a point lookup in the permutation that
+  // only reads the blocks that contain these rows. The result has the same
+  // columns as the result of this scan. Used by `IndexNestedLoopJoin`.
+  IdTable lookupFirstColumn(Id firstColumnId) const;
+
+  // Return the exact number of rows of `lookupFirstColumn(firstColumnId)`.
+  size_t getSizeOfLookupFirstColumn(Id firstColumnId) const;
+
+  // The following functions answer questions about the result of this scan
+  // from the metadata of the permutation, without (or with only partially)
+  // reading the result. They must not be used if the index has inserted or
+  // deleted triples (see `hasDeltaTriples`).
+
+  // For a scan with two variables, return the number of distinct values of the
+  // `variable` in the result, which is read from the metadata of the scanned
+  // relation. Return `std::nullopt` if the `variable` is not one of the two
+  // variables or if the number cannot be determined exactly (see
+  // `CompressedRelationMetadata::getNumDistinctCol1`).
+  std::optional<size_t> getNumDistinctFromMetadata(
+      const Variable& variable) const;
+
+  // For a scan with one or two variables, return the first and the last `Id`
+  // of the first column of the result (by which the result is sorted), or
+  // `std::nullopt` if the result is empty. At most the first and the last
+  // block of the scan are read.
+  std::optional<std::pair<Id, Id>> getFirstAndLastIdOfFirstColumn() const;
+
+  // For a scan with two variables, return a table with two columns that
+  // contains each distinct value of the first column of the result together
+  // with the number of rows with this value (as an integer), sorted by the
+  // values. Blocks in which all rows have the same value in the first column
+  // are not read, their rows are counted via the block metadata.
+  IdTable getCountsOfFirstColumn() const;
+
+  // For a scan with two variables, return the values of the first column of
+  // the result (by which it is sorted) in at most `numBlocks` of the blocks of
+  // the scan, which are evenly spread over all its blocks. The result is
+  // sorted. Used to estimate the size of joins at planning time (see
+  // `Join::getSampledSizeEstimate`).
+  std::vector<Id> sampleFirstColumn(size_t numBlocks) const;
+
  private:
   // TODO<joka921> Make the `getSizeEstimateBeforeLimit()` function `const` for
   // ALL the `Operations`.
@@ -96,12 +185,46 @@ class IndexScan : public Operation {
   Permutation::Enum permutation() const { return permutation_; }
 
  private:
-  ResultTable computeResult() override;
+  ResultTable computeResult(bool requestLaziness) override;
+
+  // Only read the blocks that can contain one of the `values` if the
+  // `variable` is the first column of the result, and drop the rows with other
+  // values of the `variable` from each block while it is read. Not possible
+  // if the index has inserted or deleted triples (see `hasDeltaTriples`).
+  std::optional<ResultTable> computeResultWithSemiJoinFilter(
+      const Variable& variable, std::span<const Id> values) override;
+
+  // Lazily compute the result of this scan (with one or two variables) as a
+  // generator that yields the result block by block as it is read from disk.
+  ResultTable::Generator scanLazily() const;
+
+  // Lazily scan the given `blocks` (which must be a subset of the blocks of
+  // this scan), `numBlocksAll` is the total number of blocks of this scan.
+  ResultTable::Generator scanBlocksLazily(
+      std::vector<CompressedBlockMetadata> blocks, size_t numBlocksAll) const;
+
+  // The implementation of both overloads of `computeResultWithPrefilter`.
+  // `getBlocks` is called with the metadata and blocks of this scan and
+  // returns the blocks that have to be scanned.
+  using GetBlocksForPrefilter =
+      std::function<std::vector<CompressedBlockMetadata>(
+          const CompressedRelationReader::MetadataAndBlocks&)>;
+  std::optional<ResultTable> computeResultWithPrefilterImpl(
+      const Variable& variable, const GetBlocksForPrefilter& getBlocks,
+      bool requestLaziness) const;
 
   vector<QueryExecutionTree*> getChildren() override { return {}; }
 
   void computeFullScan(IdTable* result, Permutation::Enum permutation) const;
 
+  // Same as `computeFullScan`, but yield the result lazily in blocks.
+  ResultTable::Generator computeFullScanLazily(
+      Permutation::Enum permutation) const;
+
+  // Return the number of triples of a full scan (considering the LIMIT). Throw
+  // if the scan has an OFFSET, which is not supported for full scans.
+  uint64_t getResultSizeOfFullScan() const;
+
   size_t computeSizeEstimate() const;
 
   string getCacheKeyImpl() const override;
@@ -4,15 +4,23 @@
 //   2015-2017 Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 //   2018-     Johannes Kalmbach (kalmbach@informatik.uni-freiburg.de)
 
+#include <absl/strings/str_cat.h>
 #include <engine/AddCombinedRowToTable.h>
-#include <engine/CallFixedSize.h>
+#include <engine/CardinalityFeedback.h>
 #include <engine/IndexScan.h>
 #include <engine/Join.h>
+#include <engine/Sort.h>
 #include <global/Constants.h>
 #include <global/Id.h>
+#include <index/CharacteristicSets.h>
 #include <util/Exception.h>
 #include <util/HashMap.h>
+#include <util/ParallelExecution.h>
+#include <util/Synchronized.h>
+#include <util/Timer.h>
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <sstream>
 #include <type_traits>
@@ -87,7 +95,7 @@ string Join::getCacheKeyImpl() const {
 string Join::getDescriptor() const { return "Join on " + _joinVar.name(); }
 
 // _____________________________________________________________________________
-ResultTable Join::computeResult() {
+ResultTable Join::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "Getting sub-results for join result computation..." << endl;
   size_t leftWidth = _left->getResultWidth();
   size_t rightWidth = _right->getResultWidth();
@@ -122,18 +130,25 @@ ResultTable Join::computeResult() {
         tree.getVariableAndInfoByColumnIndex(joinCol).second.mightContainUndef_;
     bool containsUndef =
         undefStatus == ColumnIndexAndTypeInfo::UndefStatus::PossiblyUndefined;
-    // The third argument means "only get the result if it can be read from the
-    // cache". So effectively, this returns the result if it is small, contains
-    // UNDEF values, or is contained in the cache, otherwise `nullptr`.
-    return tree.getRootOperation()->getResult(false,
-                                              !(isSmall || containsUndef));
+    // The `ONLY_IF_CACHED` means "only get the result if it can be read from
+    // the cache". So effectively, this returns the result if it is small,
+    // contains UNDEF values, or is contained in the cache, otherwise `nullptr`.
+    return tree.getRootOperation()->getResult(
+        false, isSmall || containsUndef ? ComputationMode::FULLY_MATERIALIZED
+                                        : ComputationMode::ONLY_IF_CACHED);
   };
 
   auto leftResIfCached = getCachedOrSmallResult(*_left, _leftJoinCol);
   auto rightResIfCached = getCachedOrSmallResult(*_right, _rightJoinCol);
 
-  if (_left->getType() == QueryExecutionTree::SCAN &&
-      _right->getType() == QueryExecutionTree::SCAN) {
+  // The joins that read the blocks of index scans directly cannot be used if
+  // the index has inserted or deleted triples.
+  auto isScanOfBlocks = [](const QueryExecutionTree& tree) {
+    return tree.getType() == QueryExecutionTree::SCAN &&
+           !dynamic_cast<const IndexScan&>(*tree.getRootOperation())
+                .hasDeltaTriples();
+  };
+  if (isScanOfBlocks(*_left) && isScanOfBlocks(*_right)) {
     if (rightResIfCached && !leftResIfCached) {
       idTable = computeResultForIndexScanAndIdTable<true>(
           rightResIfCached->idTable(), _rightJoinCol,
@@ -141,17 +156,29 @@ ResultTable Join::computeResult() {
       return {std::move(idTable), resultSortedOn(), LocalVocab{}};
 
     } else if (!leftResIfCached) {
+      // If laziness is requested, the result of the join is yielded in blocks
+      // while both scans are consumed, s.t. neither the inputs nor the result
+      // are ever fully materialized.
+      if (requestLaziness) {
+        return {computeResultForTwoIndexScansLazily(), resultSortedOn()};
+      }
       idTable = computeResultForTwoIndexScans();
-      // TODO<joka921, hannahbast, SPARQL update> When we add triples to the
-      // index, the vocabularies of index scans will not necessarily be empty
-      // and we need a mechanism to still retrieve them when using the lazy
-      // scan.
+      // Without inserted triples (see `isScanOfBlocks`), the results of index
+      // scans have no local vocab.
       return {std::move(idTable), resultSortedOn(), LocalVocab{}};
     }
   }
 
-  shared_ptr<const ResultTable> leftRes =
-      leftResIfCached ? leftResIfCached : _left->getResult();
+  // If only the right input is already computed, it can be used to reduce the
+  // left input (and vice versa below).
+  shared_ptr<const ResultTable> leftRes = leftResIfCached;
+  if (!leftRes && rightResIfCached) {
+    leftRes = getResultWithSemiJoinReduction(*rightResIfCached, _rightJoinCol,
+                                             *_left, _leftJoinCol);
+  }
+  if (!leftRes) {
+    leftRes = _left->getResult();
+  }
   if (leftRes->size() == 0) {
     _right->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
     // TODO<joka921, hannahbast, SPARQL update> When we add triples to the
@@ -167,8 +194,7 @@ ResultTable Join::computeResult() {
   const auto& leftIdTable = leftRes->idTable();
   auto leftHasUndef =
       !leftIdTable.empty() && leftIdTable.at(0, _leftJoinCol).isUndefined();
-  if (_right->getType() == QueryExecutionTree::SCAN && !rightResIfCached &&
-      !leftHasUndef) {
+  if (isScanOfBlocks(*_right) && !rightResIfCached && !leftHasUndef) {
     idTable = computeResultForIndexScanAndIdTable<false>(
         leftRes->idTable(), _leftJoinCol,
         dynamic_cast<IndexScan&>(*_right->getRootOperation()), _rightJoinCol);
@@ -176,8 +202,14 @@ ResultTable Join::computeResult() {
             leftRes->getSharedLocalVocab()};
   }
 
-  shared_ptr<const ResultTable> rightRes =
-      rightResIfCached ? rightResIfCached : _right->getResult();
+  shared_ptr<const ResultTable> rightRes = rightResIfCached;
+  if (!rightRes) {
+    rightRes = getResultWithSemiJoinReduction(*leftRes, _leftJoinCol, *_right,
+                                              _rightJoinCol);
+  }
+  if (!rightRes) {
+    rightRes = _right->getResult();
+  }
   join(leftRes->idTable(), _leftJoinCol, rightRes->idTable(), _rightJoinCol,
        &idTable);
 
@@ -187,6 +219,130 @@ ResultTable Join::computeResult() {
           ResultTable::getSharedLocalVocabFromNonEmptyOf(*leftRes, *rightRes)};
 }
 
+// _____________________________________________________________________________
+std::optional<ResultTable> Join::computeResultWithSemiJoinFilter(
+    const Variable& variable, std::span<const Id> values) {
+  if (isFullScanDummy(_left) || isFullScanDummy(_right)) {
+    return std::nullopt;
+  }
+  auto reduce = [&variable, &values](QueryExecutionTree& tree) {
+    const auto& columns = tree.getVariableColumns();
+    auto it = columns.find(variable);
+    if (it == columns.end() ||
+        it->second.mightContainUndef_ !=
+            ColumnIndexAndTypeInfo::UndefStatus::AlwaysDefined) {
+      return std::shared_ptr<const ResultTable>{};
+    }
+    return tree.getRootOperation()->getResultWithSemiJoinFilter(variable,
+                                                                values);
+  };
+  auto leftRes = reduce(*_left);
+  auto rightRes = reduce(*_right);
+  if (!leftRes && !rightRes) {
+    return std::nullopt;
+  }
+  if (!leftRes) {
+    leftRes = _left->getResult();
+  }
+  if (!rightRes) {
+    rightRes = _right->getResult();
+  }
+  IdTable idTable{getResultWidth(), getExecutionContext()->getAllocator()};
+  join(leftRes->idTable(), _leftJoinCol, rightRes->idTable(), _rightJoinCol,
+       &idTable);
+  return ResultTable{
+      std::move(idTable), resultSortedOn(),
+      ResultTable::getSharedLocalVocabFromNonEmptyOf(*leftRes, *rightRes)};
+}
+
+// _____________________________________________________________________________
+std::optional<size_t> Join::computeResultSize() {
+  auto isAlwaysDefined = [](const QueryExecutionTree& tree, ColumnIndex col) {
+    return tree.getVariableAndInfoByColumnIndex(col)
+               .second.mightContainUndef_ ==
+           ColumnIndexAndTypeInfo::UndefStatus::AlwaysDefined;
+  };
+  if (isFullScanDummy(_right) || !isAlwaysDefined(*_left, _leftJoinCol) ||
+      !isAlwaysDefined(*_right, _rightJoinCol)) {
+    return std::nullopt;
+  }
+
+  if (_left->knownEmptyResult() || _right->knownEmptyResult()) {
+    _left->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+    _right->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+    return 0;
+  }
+  auto leftRes = _left->getResult();
+  if (leftRes->idTable().empty()) {
+    _right->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+    return 0;
+  }
+  auto rightRes = getResultWithSemiJoinReduction(*leftRes, _leftJoinCol,
+                                                 *_right, _rightJoinCol);
+  if (!rightRes) {
+    rightRes = _right->getResult();
+  }
+  return countJoinResult(leftRes->idTable().getColumn(_leftJoinCol),
+                         rightRes->idTable().getColumn(_rightJoinCol));
+}
+
+// _____________________________________________________________________________
+size_t Join::countJoinResult(std::span<const Id> left,
+                             std::span<const Id> right) {
+  size_t count = 0;
+  auto itLeft = left.begin();
+  auto itRight = right.begin();
+  while (itLeft != left.end() && itRight != right.end()) {
+    // Skip the values that have no join partner. The binary search makes this
+    // cheap also if the sizes of the inputs are very different.
+    if (*itLeft < *itRight) {
+      itLeft = std::lower_bound(itLeft, left.end(), *itRight);
+    } else if (*itRight < *itLeft) {
+      itRight = std::lower_bound(itRight, right.end(), *itLeft);
+    } else {
+      auto endLeft = std::upper_bound(itLeft, left.end(), *itLeft);
+      auto endRight = std::upper_bound(itRight, right.end(), *itRight);
+      count += static_cast<size_t>(endLeft - itLeft) *
+               static_cast<size_t>(endRight - itRight);
+      itLeft = endLeft;
+      itRight = endRight;
+    }
+  }
+  return count;
+}
+
+// _____________________________________________________________________________
+std::shared_ptr<const ResultTable> Join::getResultWithSemiJoinReduction(
+    const ResultTable& smallResult, ColumnIndex smallJoinColumn,
+    QueryExecutionTree& tree, ColumnIndex joinColumn) {
+  const IdTable& smallTable = smallResult.idTable();
+  auto maxSize = RuntimeParameters().get<"semi-join-reduction-max-size">();
+  if (maxSize == 0 || smallTable.size() > maxSize ||
+      smallTable.size() >= tree.getSizeEstimate()) {
+    return nullptr;
+  }
+  // An UNDEF value in either of the join columns matches all the values of the
+  // other one, so the reduction is not possible. UNDEF is the smallest ID, so
+  // it can only be the first value of the sorted column.
+  auto column = smallTable.getColumn(smallJoinColumn);
+  const auto& [variable, info] =
+      tree.getVariableAndInfoByColumnIndex(joinColumn);
+  if ((!column.empty() && column.front().isUndefined()) ||
+      info.mightContainUndef_ !=
+          ColumnIndexAndTypeInfo::UndefStatus::AlwaysDefined) {
+    return nullptr;
+  }
+  std::vector<Id> values;
+  std::ranges::unique_copy(column, std::back_inserter(values));
+  auto result =
+      tree.getRootOperation()->getResultWithSemiJoinFilter(variable, values);
+  if (result != nullptr) {
+    runtimeInfo().addDetail("semi-join-reduction-of",
+                            tree.getRootOperation()->getDescriptor());
+  }
+  return result;
+}
+
 // _____________________________________________________________________________
 VariableToColumnMap Join::computeVariableToColumnMap() const {
   AD_CORRECTNESS_CHECK(!isFullScanDummy(_left));
@@ -413,9 +569,245 @@ void Join::computeSizeEstimateAndMultiplicities() {
     _multiplicities.emplace_back(m);
   }
 
+  // For star-shaped joins on a common subject, the characteristic sets give a
+  // much better estimate than the above, which assumes that the predicates
+  // are independent. For joins of two scans, a sample of the blocks of the
+  // scans is even more precise.
+  const auto independentSizeEstimate = static_cast<double>(_sizeEstimate);
+  if (auto starEstimate = getStarJoinSizeEstimate(); starEstimate.has_value()) {
+    _sizeEstimate =
+        std::max(size_t(1), static_cast<size_t>(starEstimate.value()));
+  }
+  if (auto sampledEstimate = getSampledSizeEstimate();
+      sampledEstimate.has_value()) {
+    _sizeEstimate =
+        std::max(size_t(1), static_cast<size_t>(sampledEstimate.value()));
+  }
+
+  // Correct the estimate by the sizes that were observed for previous joins
+  // with the same signature.
+  _uncorrectedSizeEstimate = static_cast<double>(_sizeEstimate);
+  if (auto signature = getCardinalityFeedbackSignature();
+      signature.has_value()) {
+    auto factor =
+        getCardinalityFeedback().getCorrectionFactor(signature.value());
+    if (factor.has_value()) {
+      _sizeEstimate = std::max(
+          size_t(1),
+          static_cast<size_t>(factor.value() * _uncorrectedSizeEstimate));
+    }
+  }
+
+  // Adapt the multiplicities to the corrected size estimate.
+  if (static_cast<double>(_sizeEstimate) != independentSizeEstimate) {
+    double factor =
+        static_cast<double>(_sizeEstimate) / independentSizeEstimate;
+    for (auto& multiplicity : _multiplicities) {
+      multiplicity = static_cast<float>(std::max(1.0, multiplicity * factor));
+    }
+  }
+
   assert(_multiplicities.size() == getResultWidth());
 }
 
+// _____________________________________________________________________________
+bool Join::collectScansOfStar(const QueryExecutionTree& tree,
+                              const Variable& subject,
+                              std::vector<const IndexScan*>& scans) {
+  const Operation* operation = tree.getRootOperation().get();
+  if (const auto* scan = dynamic_cast<const IndexScan*>(operation)) {
+    const auto& object = scan->getObject();
+    bool isPartOfStar =
+        scan->getSubject().isVariable() &&
+        scan->getSubject().getVariable() == subject &&
+        !scan->getPredicate().isVariable() &&
+        scan->additionalColumns().empty() &&
+        !(object.isVariable() && object.getVariable() == subject);
+    if (isPartOfStar) {
+      scans.push_back(scan);
+    }
+    return isPartOfStar;
+  } else if (const auto* join = dynamic_cast<const Join*>(operation)) {
+    return join->_joinVar == subject &&
+           collectScansOfStar(*join->_left, subject, scans) &&
+           collectScansOfStar(*join->_right, subject, scans);
+  } else if (dynamic_cast<const Sort*>(operation) != nullptr) {
+    auto children = operation->getChildren();
+    return children.size() == 1 &&
+           collectScansOfStar(*children.at(0), subject, scans);
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+std::optional<double> Join::getStarJoinSizeEstimate() const {
+  if (!_executionContext || getIndex().getCharacteristicSets().empty()) {
+    return std::nullopt;
+  }
+  std::vector<const IndexScan*> scans;
+  if (!collectScansOfStar(*_left, _joinVar, scans) ||
+      !collectScansOfStar(*_right, _joinVar, scans)) {
+    return std::nullopt;
+  }
+  // The objects must be distinct variables, otherwise the scans are also
+  // joined on the objects.
+  ad_utility::HashSet<Variable> objectVariables;
+  std::vector<Id> predicates;
+  double selectivityOfFixedObjects = 1.0;
+  for (const IndexScan* scan : scans) {
+    const auto& object = scan->getObject();
+    if (object.isVariable() &&
+        !objectVariables.insert(object.getVariable()).second) {
+      return std::nullopt;
+    }
+    auto predicate = scan->getPredicate().toValueId(getIndex().getVocab());
+    if (!predicate.has_value()) {
+      return std::nullopt;
+    }
+    predicates.push_back(predicate.value());
+    // For a fixed object, only the fraction of the triples with the predicate
+    // that also have this object contributes to the result.
+    if (!object.isVariable()) {
+      auto numTriples =
+          getIndex().getCardinality(predicate.value(), Permutation::PSO);
+      if (numTriples == 0) {
+        return std::nullopt;
+      }
+      selectivityOfFixedObjects *= static_cast<double>(scan->getExactSize()) /
+                                   static_cast<double>(numTriples);
+    }
+  }
+  auto estimate =
+      getIndex().getCharacteristicSets().estimateStarSize(predicates);
+  if (!estimate.has_value()) {
+    return std::nullopt;
+  }
+  return estimate.value() * selectivityOfFixedObjects;
+}
+
+namespace {
+// The sampled size estimates of the joins of two scans, see
+// `Join::getSampledSizeEstimate`. The keys consist of the address of the index
+// and the signature of the join, `std::nullopt` means that the sampling
+// exceeded its time budget.
+auto& sampledJoinSizeEstimates() {
+  static ad_utility::Synchronized<
+      ad_utility::HashMap<std::string, std::optional<double>>>
+      estimates;
+  return estimates;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+std::optional<double> Join::getSampledSizeEstimate() const {
+  if (!_executionContext) {
+    return std::nullopt;
+  }
+  const size_t numBlocks =
+      RuntimeParameters().get<"join-sampling-num-blocks">();
+  if (numBlocks == 0 || _leftJoinCol != 0 || _rightJoinCol != 0) {
+    return std::nullopt;
+  }
+  auto signature = getJoinOfTwoScansSignature();
+  if (!signature.has_value()) {
+    return std::nullopt;
+  }
+  const auto& left =
+      dynamic_cast<const IndexScan&>(*_left->getRootOperation());
+  const auto& right =
+      dynamic_cast<const IndexScan&>(*_right->getRootOperation());
+  // The signature only contains the fixed element of the scans if it is the
+  // predicate.
+  if (left.numVariables() != 2 || right.numVariables() != 2 ||
+      left.getPredicate().isVariable() || right.getPredicate().isVariable() ||
+      left.hasDeltaTriples()) {
+    return std::nullopt;
+  }
+  auto key = absl::StrCat(reinterpret_cast<uintptr_t>(&getIndex()), " ",
+                          signature.value());
+  {
+    auto estimates = sampledJoinSizeEstimates().rlock();
+    if (auto it = estimates->find(key); it != estimates->end()) {
+      return it->second;
+    }
+  }
+
+  // Sample the larger scan, the key range of each of its sampled blocks is
+  // then small compared to the blocks of the other scan.
+  bool leftIsLarger = left.getExactSize() >= right.getExactSize();
+  const IndexScan& sampled = leftIsLarger ? left : right;
+  const IndexScan& other = leftIsLarger ? right : left;
+  ad_utility::Timer timer{ad_utility::Timer::Started};
+  const auto timeBudget =
+      RuntimeParameters().get<"join-sampling-time-budget">();
+  auto computeEstimate = [&]() -> std::optional<double> {
+    std::vector<Id> sample = sampled.sampleFirstColumn(numBlocks);
+    if (sample.empty()) {
+      return 0.0;
+    }
+    // Count the matches of the `sample` in the blocks of the other scan that
+    // can contain them, which are yielded in sorted order.
+    size_t joinSizeOfSample = 0;
+    auto sampleIt = sample.begin();
+    for (const IdTable& block :
+         IndexScan::lazyScanForJoinOfColumnWithScan(sample, other)) {
+      for (Id id : block.getColumn(0)) {
+        auto [begin, end] = std::equal_range(sampleIt, sample.end(), id);
+        joinSizeOfSample += end - begin;
+        sampleIt = begin;
+      }
+      if (timer.value() > timeBudget) {
+        return std::nullopt;
+      }
+    }
+    return static_cast<double>(joinSizeOfSample) *
+           static_cast<double>(sampled.getExactSize()) /
+           static_cast<double>(sample.size());
+  };
+  auto estimate = computeEstimate();
+  sampledJoinSizeEstimates().wlock()->emplace(std::move(key), estimate);
+  return estimate;
+}
+
+// _____________________________________________________________________________
+std::optional<std::string> Join::getCardinalityFeedbackSignature() const {
+  if (!getCardinalityFeedback().isEnabled()) {
+    return std::nullopt;
+  }
+  return getJoinOfTwoScansSignature();
+}
+
+// _____________________________________________________________________________
+std::optional<std::string> Join::getJoinOfTwoScansSignature() const {
+  if (_left->getType() != QueryExecutionTree::SCAN ||
+      _right->getType() != QueryExecutionTree::SCAN || isFullScanDummy(_left) ||
+      isFullScanDummy(_right)) {
+    return std::nullopt;
+  }
+  auto getSignature = [](const QueryExecutionTree& tree, ColumnIndex joinCol) {
+    return dynamic_cast<const IndexScan&>(*tree.getRootOperation())
+        .getCardinalityFeedbackSignature(joinCol);
+  };
+  std::array signatures{getSignature(*_left, _leftJoinCol),
+                        getSignature(*_right, _rightJoinCol)};
+  // The order of the children doesn't matter for the size of the result.
+  std::ranges::sort(signatures);
+  return absl::StrCat("JOIN ", signatures[0], " | ", signatures[1]);
+}
+
+// _____________________________________________________________________________
+std::optional<CardinalityFeedback::Estimate>
+Join::getCardinalityFeedbackEstimate() {
+  auto signature = getCardinalityFeedbackSignature();
+  if (!signature.has_value()) {
+    return std::nullopt;
+  }
+  // Make sure that `_uncorrectedSizeEstimate` is computed.
+  getSizeEstimateBeforeLimit();
+  return CardinalityFeedback::Estimate{std::move(signature.value()),
+                                       _uncorrectedSizeEstimate};
+}
+
 // ______________________________________________________________________________
 void Join::appendCrossProduct(const IdTable::const_iterator& leftBegin,
                               const IdTable::const_iterator& leftEnd,
@@ -461,14 +853,6 @@ void Join::join(const IdTable& a, ColumnIndex jc1, const IdTable& b,
   auto aPermuted = a.asColumnSubsetView(joinColumnData.permutationLeft());
   auto bPermuted = b.asColumnSubsetView(joinColumnData.permutationRight());
 
-  auto rowAdder = ad_utility::AddCombinedRowToIdTable(1, aPermuted, bPermuted,
-                                                      std::move(*result));
-  auto addRow = [beginLeft = joinColumnL.begin(),
-                 beginRight = joinColumnR.begin(),
-                 &rowAdder](const auto& itLeft, const auto& itRight) {
-    rowAdder.addRow(itLeft - beginLeft, itRight - beginRight);
-  };
-
   // The UNDEF values are right at the start, so this calculation works.
   size_t numUndefA =
       std::ranges::upper_bound(joinColumnL, ValueId::makeUndefined()) -
@@ -479,6 +863,34 @@ void Join::join(const IdTable& a, ColumnIndex jc1, const IdTable& b,
   std::pair undefRangeA{joinColumnL.begin(), joinColumnL.begin() + numUndefA};
   std::pair undefRangeB{joinColumnR.begin(), joinColumnR.begin() + numUndefB};
 
+  bool useGallopingJoin = numUndefA == 0 && numUndefB == 0 &&
+                          (a.size() / b.size() > GALLOP_THRESHOLD ||
+                           b.size() / a.size() > GALLOP_THRESHOLD);
+  // Without UNDEF values, the zipper join can be split into independent
+  // partitions that are joined concurrently.
+  if (numUndefA == 0 && numUndefB == 0 && !useGallopingJoin) {
+    auto makeRowAdder = [&aPermuted, &bPermuted, &result]() {
+      return ad_utility::AddCombinedRowToIdTable{
+          1, aPermuted, bPermuted,
+          IdTable{result->numColumns(), result->getAllocator()}};
+    };
+    *result = ad_utility::parallelZipperJoinWithoutUndef(
+        joinColumnL, joinColumnR, std::ranges::less{},
+        getExecutionContext()->getNumThreads(
+            RuntimeParameters().get<"join-num-threads">()),
+        makeRowAdder);
+    result->setColumnSubset(joinColumnData.permutationResult());
+    return;
+  }
+
+  auto rowAdder = ad_utility::AddCombinedRowToIdTable(1, aPermuted, bPermuted,
+                                                      std::move(*result));
+  auto addRow = [beginLeft = joinColumnL.begin(),
+                 beginRight = joinColumnR.begin(),
+                 &rowAdder](const auto& itLeft, const auto& itRight) {
+    rowAdder.addRow(itLeft - beginLeft, itRight - beginRight);
+  };
+
   // Determine whether we should use the galloping join optimization.
   if (a.size() / b.size() > GALLOP_THRESHOLD && numUndefA == 0 &&
       numUndefB == 0) {
@@ -510,18 +922,9 @@ void Join::join(const IdTable& a, ColumnIndex jc1, const IdTable& b,
       }
     };
 
-    auto numOutOfOrder = [&]() {
-      if (numUndefB == 0 && numUndefA == 0) {
-        return ad_utility::zipperJoinWithUndef(
-            joinColumnL, joinColumnR, std::ranges::less{}, addRow,
-            ad_utility::noop, ad_utility::noop);
-
-      } else {
-        return ad_utility::zipperJoinWithUndef(
-            joinColumnL, joinColumnR, std::ranges::less{}, addRow,
-            findSmallerUndefRangeLeft, findSmallerUndefRangeRight);
-      }
-    }();
+    auto numOutOfOrder = ad_utility::zipperJoinWithUndef(
+        joinColumnL, joinColumnR, std::ranges::less{}, addRow,
+        findSmallerUndefRangeLeft, findSmallerUndefRangeRight);
     AD_CORRECTNESS_CHECK(numOutOfOrder == 0);
   }
   *result = std::move(rowAdder).resultTable();
@@ -538,12 +941,8 @@ void Join::join(const IdTable& a, ColumnIndex jc1, const IdTable& b,
 }
 
 // ______________________________________________________________________________
-template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
-void Join::hashJoinImpl(const IdTable& dynA, ColumnIndex jc1,
-                        const IdTable& dynB, ColumnIndex jc2, IdTable* dynRes) {
-  const IdTableView<L_WIDTH> a = dynA.asStaticView<L_WIDTH>();
-  const IdTableView<R_WIDTH> b = dynB.asStaticView<R_WIDTH>();
-
+void Join::hashJoin(const IdTable& a, ColumnIndex jc1, const IdTable& b,
+                    ColumnIndex jc2, IdTable* result) {
   LOG(DEBUG) << "Performing hashJoin between two tables.\n";
   LOG(DEBUG) << "A: width = " << a.numColumns() << ", size = " << a.size()
              << "\n";
@@ -555,117 +954,133 @@ void Join::hashJoinImpl(const IdTable& dynA, ColumnIndex jc1,
     return;
   }
 
-  IdTableStatic<OUT_WIDTH> result = std::move(*dynRes).toStatic<OUT_WIDTH>();
+  // The smaller table is put into a hash map, the larger table is probed.
+  // The rows of the result follow the order of the larger table, s.t. the
+  // result is still sorted if the larger table is sorted.
+  //
+  // For large inputs, the join is performed on several threads: The rows of
+  // the smaller table are radix-partitioned by the hash of their join column,
+  // and the hash map of each partition is built on a separate thread. The
+  // larger table is then split into contiguous chunks that are probed
+  // concurrently. Each thread only stores the pairs of matching row indices,
+  // from which the columns of the result are then gathered one at a time.
+  // This works for tables of any width without instantiating the join for
+  // each combination of widths.
+  const bool leftIsLarger = a.size() >= b.size();
+  const IdTable& largerTable = leftIsLarger ? a : b;
+  const IdTable& smallerTable = leftIsLarger ? b : a;
+  std::span<const Id> largerJoinColumn =
+      largerTable.getColumn(leftIsLarger ? jc1 : jc2);
+  std::span<const Id> smallerJoinColumn =
+      smallerTable.getColumn(leftIsLarger ? jc2 : jc1);
+
+  // Using several threads only pays off if the inputs are large enough.
+  static constexpr size_t minSizeForParallelJoin = 100'000;
+  const size_t numThreads =
+      largerTable.size() < minSizeForParallelJoin
+          ? 1
+          : std::max(size_t{1},
+                     getExecutionContext()->getNumThreads(
+                         RuntimeParameters().get<"join-num-threads">()));
+
+  // The hash map for each partition maps a value of the join column to the
+  // indices of the rows of the smaller table with this value.
+  const size_t numPartitions = numThreads;
+  auto getPartition = [numPartitions](Id id) -> size_t {
+    return (absl::Hash<Id>{}(id) >> 32) % numPartitions;
+  };
+  std::vector<ad_utility::HashMap<Id, std::vector<size_t>>> maps(
+      numPartitions);
+  auto getChunk = [numThreads](size_t threadIdx, size_t size) {
+    size_t chunkSize = size / numThreads + 1;
+    size_t begin = std::min(size, threadIdx * chunkSize);
+    return std::pair{begin, std::min(size, begin + chunkSize)};
+  };
 
-  // Puts the rows of the given table into a hash map, with the value of
-  // the join column of a row as the key, and returns the hash map.
-  auto idTableToHashMap = []<typename Table>(const Table& table,
-                                             const ColumnIndex jc) {
-    // This declaration works, because generic lambdas are just syntactic sugar
-    // for templates.
-    ad_utility::HashMap<Id, std::vector<typename Table::row_type>> map;
-    for (const auto& row : table) {
-      map[row[jc]].push_back(row);
+  // Build phase. First, each thread assigns the rows of a contiguous chunk
+  // of the smaller table to their partitions. Then each thread builds the
+  // hash map for one of the partitions. The chunks are processed in order,
+  // so within each entry of a hash map the row indices are sorted.
+  std::vector<std::vector<std::vector<size_t>>> partitionedRows(
+      numThreads, std::vector<std::vector<size_t>>(numPartitions));
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    auto [begin, end] = getChunk(threadIdx, smallerTable.size());
+    for (size_t i = begin; i < end; ++i) {
+      partitionedRows[threadIdx][getPartition(smallerJoinColumn[i])].push_back(
+          i);
     }
-    return map;
-  };
+  });
+  ad_utility::runConcurrently(numPartitions, [&](size_t partition) {
+    auto& map = maps[partition];
+    for (const auto& rowsOfChunk : partitionedRows) {
+      for (size_t i : rowsOfChunk[partition]) {
+        map[smallerJoinColumn[i]].push_back(i);
+      }
+    }
+  });
+  partitionedRows.clear();
+  checkCancellation();
 
-  /*
-   * @brief Joins the two tables, putting the result in result. Creates a cross
-   *  product for matching rows by putting the smaller IdTable in a hash map and
-   *  using that, to faster find the matching rows.
-   *
-   * @tparam leftIsLarger If the left table in the join operation has more
-   *  rows, or the right. True, if he has. False, if he hasn't.
-   * @tparam LargerTableType, SmallerTableType The types of the tables given.
-   *  Can be easily done with type interference, so no need to write them out.
-   *
-   * @param largerTable, smallerTable The two tables of the join operation.
-   * @param largerTableJoinColumn, smallerTableJoinColumn The join columns
-   *  of the tables
-   */
-  auto performHashJoin = [&idTableToHashMap,
-                          &result]<bool leftIsLarger, typename LargerTableType,
-                                   typename SmallerTableType>(
-                             const LargerTableType& largerTable,
-                             const ColumnIndex largerTableJoinColumn,
-                             const SmallerTableType& smallerTable,
-                             const ColumnIndex smallerTableJoinColumn) {
-    // Put the smaller table into the hash table.
-    auto map = idTableToHashMap(smallerTable, smallerTableJoinColumn);
-
-    // Create cross product by going through the larger table.
-    for (size_t i = 0; i < largerTable.size(); i++) {
+  // Probe phase. Collect the pairs of the indices of matching rows of `a` and
+  // `b` by going through contiguous chunks of the larger table.
+  std::vector<std::vector<std::pair<size_t, size_t>>> matchesOfChunks(
+      numThreads);
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    auto& matches = matchesOfChunks[threadIdx];
+    auto [begin, end] = getChunk(threadIdx, largerTable.size());
+    for (size_t i = begin; i < end; i++) {
+      Id id = largerJoinColumn[i];
+      const auto& map = maps[getPartition(id)];
       // Skip, if there is no matching entry for the join column.
-      auto entry = map.find(largerTable(i, largerTableJoinColumn));
+      auto entry = map.find(id);
       if (entry == map.end()) {
         continue;
       }
-
-      for (const auto& row : entry->second) {
-        // Based on which table was larger, the arguments of
-        // addCombinedRowToIdTable are different.
-        // However this information is known at compile time, so the other
-        // branch gets discarded at compile time, which makes this
-        // condition have constant runtime.
-        if constexpr (leftIsLarger) {
-          addCombinedRowToIdTable(largerTable[i], row, smallerTableJoinColumn,
-                                  &result);
+      for (size_t rowIdx : entry->second) {
+        if (leftIsLarger) {
+          matches.emplace_back(i, rowIdx);
         } else {
-          addCombinedRowToIdTable(row, largerTable[i], largerTableJoinColumn,
-                                  &result);
+          matches.emplace_back(rowIdx, i);
         }
       }
     }
-  };
+  });
+  maps.clear();
+  checkCancellation();
 
-  // Cannot just switch a and b around because the order of
-  // items in the result tuples is important.
-  // Procceding with the actual hash join depended on which IdTableView
-  // is bigger.
-  if (a.size() >= b.size()) {
-    performHashJoin.template operator()<true>(a, jc1, b, jc2);
-  } else {
-    performHashJoin.template operator()<false>(b, jc2, a, jc1);
+  // Gather the columns of the result. First the columns of `a`, then the
+  // columns of `b` without its join column. Each thread writes the rows of its
+  // chunk of the larger table.
+  std::vector<size_t> offsets{0};
+  for (const auto& matches : matchesOfChunks) {
+    offsets.push_back(offsets.back() + matches.size());
   }
-  *dynRes = std::move(result).toDynamic();
-
-  LOG(DEBUG) << "HashJoin done.\n";
-  LOG(DEBUG) << "Result: width = " << dynRes->numColumns()
-             << ", size = " << dynRes->size() << "\n";
-}
-
-// ______________________________________________________________________________
-void Join::hashJoin(const IdTable& dynA, ColumnIndex jc1, const IdTable& dynB,
-                    ColumnIndex jc2, IdTable* dynRes) {
-  CALL_FIXED_SIZE(
-      (std::array{dynA.numColumns(), dynB.numColumns(), dynRes->numColumns()}),
-      &Join::hashJoinImpl, this, dynA, jc1, dynB, jc2, dynRes);
-}
-
-// ___________________________________________________________________________
-template <typename ROW_A, typename ROW_B, int TABLE_WIDTH>
-void Join::addCombinedRowToIdTable(const ROW_A& rowA, const ROW_B& rowB,
-                                   const ColumnIndex jcRowB,
-                                   IdTableStatic<TABLE_WIDTH>* table) {
-  // Add a new, empty row.
-  const size_t backIndex = table->size();
-  table->emplace_back();
-
-  // Copy the entire rowA in the table.
-  for (auto h = ColumnIndex{0}; h < rowA.numColumns(); h++) {
-    (*table)(backIndex, h) = rowA[h];
+  result->resize(offsets.back());
+  auto gatherColumn = [&](std::span<const Id> input, size_t outputCol,
+                          bool fromA) {
+    std::span<Id> output = result->getColumn(outputCol);
+    ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+      std::ranges::transform(
+          matchesOfChunks[threadIdx], output.begin() + offsets[threadIdx],
+          [&input, fromA](const auto& match) {
+            return input[fromA ? match.first : match.second];
+          });
+    });
+  };
+  for (size_t col = 0; col < a.numColumns(); ++col) {
+    gatherColumn(a.getColumn(col), col, true);
   }
-
-  // Copy rowB columns before the join column.
-  for (auto h = ColumnIndex{0}; h < jcRowB; h++) {
-    (*table)(backIndex, h + rowA.numColumns()) = rowB[h];
+  size_t outputCol = a.numColumns();
+  for (size_t col = 0; col < b.numColumns(); ++col) {
+    if (col != jc2) {
+      gatherColumn(b.getColumn(col), outputCol++, false);
+    }
   }
+  checkCancellation();
 
-  // Copy rowB columns after the join column.
-  for (auto h = jcRowB + 1; h < rowB.numColumns(); h++) {
-    (*table)(backIndex, h + rowA.numColumns() - 1) = rowB[h];
-  }
+  LOG(DEBUG) << "HashJoin done.\n";
+  LOG(DEBUG) << "Result: width = " << result->numColumns()
+             << ", size = " << result->size() << "\n";
 }
 
 namespace {
@@ -682,19 +1097,6 @@ convertGenerator(Permutation::IdTableGenerator gen) {
   }
 }
 
-// Set the runtime info of the `scanTree` when it was lazily executed during a
-// join.
-void updateRuntimeInfoForLazyScan(
-    IndexScan& scanTree,
-    const CompressedRelationReader::LazyScanMetadata& metadata) {
-  scanTree.updateRuntimeInformationWhenOptimizedOut(
-      RuntimeInformation::Status::lazilyMaterialized);
-  auto& rti = scanTree.runtimeInfo();
-  rti.numRows_ = metadata.numElementsRead_;
-  rti.totalTime_ = metadata.blockingTime_;
-  rti.addDetail("num-blocks-read", metadata.numBlocksRead_);
-  rti.addDetail("num-blocks-all", metadata.numBlocksAll_);
-}
 }  // namespace
 
 // ______________________________________________________________________________________________________
@@ -722,8 +1124,8 @@ IdTable Join::computeResultForTwoIndexScans() {
   ad_utility::zipperJoinForBlocksWithoutUndef(leftBlocks, rightBlocks,
                                               std::less{}, rowAdder);
 
-  updateRuntimeInfoForLazyScan(leftScan, leftBlocks.details());
-  updateRuntimeInfoForLazyScan(rightScan, rightBlocks.details());
+  leftScan.updateRuntimeInfoForLazyScan(leftBlocks.details());
+  rightScan.updateRuntimeInfoForLazyScan(rightBlocks.details());
 
   AD_CORRECTNESS_CHECK(leftBlocks.details().numBlocksRead_ <=
                        rightBlocks.details().numElementsRead_);
@@ -733,6 +1135,61 @@ IdTable Join::computeResultForTwoIndexScans() {
   return std::move(rowAdder).resultTable();
 }
 
+// _____________________________________________________________________________
+ResultTable::Generator Join::computeResultForTwoIndexScansLazily() {
+  AD_CORRECTNESS_CHECK(_left->getType() == QueryExecutionTree::SCAN &&
+                       _right->getType() == QueryExecutionTree::SCAN);
+  // See `computeResultForTwoIndexScans` above for details.
+  AD_CORRECTNESS_CHECK(_leftJoinCol == 0 && _rightJoinCol == 0);
+  ad_utility::AddCombinedRowToIdTable rowAdder{
+      1, IdTable{getResultWidth(), getExecutionContext()->getAllocator()}};
+
+  auto& leftScan = dynamic_cast<IndexScan&>(*_left->getRootOperation());
+  auto& rightScan = dynamic_cast<IndexScan&>(*_right->getRootOperation());
+
+  ad_utility::Timer timer{ad_utility::timer::Timer::InitialStatus::Started};
+  auto [leftBlocksInternal, rightBlocksInternal] =
+      IndexScan::lazyScanForJoinOfTwoScans(leftScan, rightScan);
+  runtimeInfo().addDetail("time-for-filtering-blocks", timer.msecs());
+
+  auto leftBlocks = convertGenerator(std::move(leftBlocksInternal));
+  auto rightBlocks = convertGenerator(std::move(rightBlocksInternal));
+
+  // The runtime information of the scans is updated before each yielded
+  // block, because the consumer might stop early (e.g. because of a LIMIT).
+  auto updateRuntimeInfoForScans = [&]() {
+    leftScan.updateRuntimeInfoForLazyScan(leftBlocks.details());
+    rightScan.updateRuntimeInfoForLazyScan(rightBlocks.details());
+  };
+
+  // Don't yield tiny blocks for each round of the join, but collect at least
+  // this many rows before yielding.
+  static constexpr size_t minBlockSize = 100'000;
+  for (auto& adder : ad_utility::zipperJoinForBlocksWithoutUndefLazily(
+           leftBlocks, rightBlocks, std::less{}, rowAdder)) {
+    if (adder.numWrittenRows() >= minBlockSize) {
+      updateRuntimeInfoForScans();
+      checkCancellation();
+      co_yield ResultTable::IdTableVocabPair{adder.moveOutPartialResult(),
+                                             LocalVocab{}};
+    }
+  }
+  updateRuntimeInfoForScans();
+
+  AD_CORRECTNESS_CHECK(leftBlocks.details().numBlocksRead_ <=
+                       rightBlocks.details().numElementsRead_);
+  AD_CORRECTNESS_CHECK(rightBlocks.details().numBlocksRead_ <=
+                       leftBlocks.details().numElementsRead_);
+
+  IdTable lastBlock = std::move(rowAdder).resultTable();
+  if (!lastBlock.empty()) {
+    // TODO<joka921, hannahbast, SPARQL update> See the comment about the local
+    // vocabularies of lazy scans in `computeResult`.
+    co_yield ResultTable::IdTableVocabPair{std::move(lastBlock),
+                                           LocalVocab{}};
+  }
+}
+
 // ______________________________________________________________________________________________________
 template <bool idTableIsRightInput>
 IdTable Join::computeResultForIndexScanAndIdTable(const IdTable& idTable,
@@ -779,6 +1236,6 @@ IdTable Join::computeResultForIndexScanAndIdTable(const IdTable& idTable,
   auto result = std::move(rowAdder).resultTable();
   result.setColumnSubset(joinColMap.permutationResult());
 
-  updateRuntimeInfoForLazyScan(scan, rightBlocks.details());
+  scan.updateRuntimeInfoForLazyScan(rightBlocks.details());
   return result;
 }
@@ -31,6 +31,8 @@ class Join : public Operation {
 
   bool _sizeEstimateComputed;
   size_t _sizeEstimate;
+  // The size estimate before the correction from the `CardinalityFeedback`.
+  double _uncorrectedSizeEstimate = 0;
 
   vector<float> _multiplicities;
 
@@ -87,6 +89,12 @@ class Join : public Operation {
     return {_left.get(), _right.get()};
   }
 
+  // The inputs of this join (sorted by the join column).
+  const std::shared_ptr<QueryExecutionTree>& getLeft() const { return _left; }
+  const std::shared_ptr<QueryExecutionTree>& getRight() const {
+    return _right;
+  }
+
   /**
    * @brief Joins IdTables a and b on join column jc2, returning
    * the result in dynRes. Creates a cross product for matching rows.
@@ -96,7 +104,7 @@ class Join : public Operation {
    * The possible algorithms should be:
    * - The normal merge join.
    * - The doGallopInnerJoin.
-   * - The hashJoinImpl.
+   * - The hashJoin.
    * Currently it only decides between doGallopInnerJoin and the standard merge
    * join, with the merge join code directly written in the function.
    * TODO Move the merge join into it's own function and make this function
@@ -106,20 +114,31 @@ class Join : public Operation {
             ColumnIndex jc2, IdTable* result) const;
 
   /**
-   * @brief Joins IdTables dynA and dynB on join column jc2, returning
-   * the result in dynRes. Creates a cross product for matching rows by putting
+   * @brief Joins IdTables a and b on join column jc2, returning
+   * the result in result. Creates a cross product for matching rows by putting
    * the smaller IdTable in a hash map and using that, to faster find the
-   * matching rows.
-   * Needed to be a seperate function from the actual implementation, because
-   * compiler optimization keept inlining it, which make testing impossible,
-   * because you couldn't call the function after linking and just got
-   * 'undefined reference' errors.
+   * matching rows. The matching pairs of rows are collected first, and the
+   * columns of the result are then copied one at a time, so the same code is
+   * used for all widths of the tables.
    *
    * @return The result is only sorted, if the bigger table is sorted.
    * Otherwise it is not sorted.
    **/
-  void hashJoin(const IdTable& dynA, ColumnIndex jc1, const IdTable& dynB,
-                ColumnIndex jc2, IdTable* dynRes);
+  void hashJoin(const IdTable& a, ColumnIndex jc1, const IdTable& b,
+                ColumnIndex jc2, IdTable* result);
+
+  // Compute only the number of rows of the result of this join, e.g. for a
+  // `COUNT` over the join. The inputs are computed as usual, but the result is
+  // never materialized: For each value that occurs in both join columns, the
+  // lengths of its ranges in the two columns are multiplied. Return
+  // `std::nullopt` if one of the join columns might contain UNDEF values or if
+  // the right child is a full scan dummy.
+  std::optional<size_t> computeResultSize();
+
+  // The number of rows of the join of two tables with the sorted join columns
+  // `left` and `right`, which must not contain UNDEF values.
+  static size_t countJoinResult(std::span<const Id> left,
+                                std::span<const Id> right);
 
   static bool isFullScanDummy(std::shared_ptr<QueryExecutionTree> tree) {
     return tree->getType() == QueryExecutionTree::SCAN &&
@@ -130,17 +149,81 @@ class Join : public Operation {
   virtual string getCacheKeyImpl() const override;
 
  private:
-  ResultTable computeResult() override;
+  ResultTable computeResult(bool requestLaziness) override;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 
   ResultTable computeResultForJoinWithFullScanDummy();
 
+  // Join the semi-join reduced results of those children in which the
+  // `variable` is always defined (the reduction of a child with UNDEF values
+  // would drop rows that match any value). Children that don't support the
+  // reduction are computed completely.
+  std::optional<ResultTable> computeResultWithSemiJoinFilter(
+      const Variable& variable, std::span<const Id> values) override;
+
+  // If the `smallResult` (the already computed other input of this join, with
+  // the join column `smallJoinColumn`) has at most
+  // `semi-join-reduction-max-size` rows, compute the semi-join reduction of
+  // the result of the `tree` with the distinct values of the join column, s.t.
+  // the rows of the `tree` without a join partner are dropped as early as
+  // possible (see `Operation::getResultWithSemiJoinFilter`). Return `nullptr`
+  // if the reduction is not applicable or not supported by the `tree`.
+  std::shared_ptr<const ResultTable> getResultWithSemiJoinReduction(
+      const ResultTable& smallResult, ColumnIndex smallJoinColumn,
+      QueryExecutionTree& tree, ColumnIndex joinColumn);
+
+  // The signature of this join for the `CardinalityFeedback`, which consists of
+  // the signatures of both children (see
+  // `IndexScan::getCardinalityFeedbackSignature`). Return `std::nullopt` if
+  // the feedback is disabled or if not both children are (non-dummy)
+  // `IndexScan`s, because for other children, the signature would not
+  // describe the join precisely enough.
+  std::optional<std::string> getCardinalityFeedbackSignature() const;
+
+  std::optional<CardinalityFeedback::Estimate> getCardinalityFeedbackEstimate()
+      override;
+
+  // If this join and all the joins below it are joins of index scans
+  // `?s <p> ?o` (or `?s <p> <o>`) on the same subject `?s` (a star), return
+  // the size estimate for this join from the `CharacteristicSets` of the
+  // index. Return `std::nullopt` if this join is not such a star or if the
+  // index has no characteristic sets.
+  std::optional<double> getStarJoinSizeEstimate() const;
+
+  // If this is a join of two index scans with two variables each on the first
+  // column of both (e.g. `?x <p> ?y` and `?y <q> ?z` on `?y`), estimate the
+  // size of the join by sampling: The first columns of a few blocks of the
+  // larger scan are read (see `IndexScan::sampleFirstColumn` and the runtime
+  // parameter `join-sampling-num-blocks`) and joined with the matching blocks
+  // of the other scan. The estimate is the size of this join, scaled by the
+  // fraction of the larger scan that was sampled. The estimates are cached per
+  // pair of scans (see `getJoinOfTwoScansSignature`), which makes them
+  // independent of the concrete query. Return `std::nullopt` if sampling is
+  // disabled or not possible, or if it took longer than the runtime parameter
+  // `join-sampling-time-budget`.
+  std::optional<double> getSampledSizeEstimate() const;
+
+  // If both children are index scans (and none of them is a full scan), return
+  // a description of the join that is independent of the concrete subjects and
+  // objects of the scans (see `IndexScan::getCardinalityFeedbackSignature`).
+  std::optional<std::string> getJoinOfTwoScansSignature() const;
+
+  // If the `tree` is a star of index scans on the `subject` (see above),
+  // append its scans to `scans` and return true, else return false.
+  static bool collectScansOfStar(const QueryExecutionTree& tree,
+                                 const Variable& subject,
+                                 std::vector<const IndexScan*>& scans);
+
   // A special implementation that is called when both children are
   // `IndexScan`s. Uses the lazy scans to only retrieve the subset of the
   // `IndexScan`s that is actually needed without fully materializing them.
   IdTable computeResultForTwoIndexScans();
 
+  // The lazy version of `computeResultForTwoIndexScans`. The result of the join
+  // is yielded in blocks while the two scans are being consumed.
+  ResultTable::Generator computeResultForTwoIndexScansLazily();
+
   // A special implementation that is called when one of the children is an
   // `IndexScan`. The argument `scanIsLeft` determines whether the `IndexScan`
   // is the left or the right child of this `Join`. This needs to be known to
@@ -163,27 +246,4 @@ class Join : public Operation {
                           const IdTable::const_iterator& rightBegin,
                           const IdTable::const_iterator& rightEnd,
                           IdTable* res) const;
-  /*
-   * @brief Combines 2 rows like in a join and inserts the result in the
-   * given table.
-   *
-   *@tparam The amount of columns in the rows and the table.
-   *
-   * @param[in] The left row of the join.
-   * @param[in] The right row of the join.
-   * @param[in] The numerical position of the join column of row b.
-   * @param[in] The table, in which the new combined row should be inserted.
-   * Must be static.
-   */
-  template <typename ROW_A, typename ROW_B, int TABLE_WIDTH>
-  static void addCombinedRowToIdTable(const ROW_A& rowA, const ROW_B& rowB,
-                                      const ColumnIndex jcRowB,
-                                      IdTableStatic<TABLE_WIDTH>* table);
-
-  /*
-   * @brief The implementation of hashJoin.
-   */
-  template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
-  void hashJoinImpl(const IdTable& dynA, ColumnIndex jc1, const IdTable& dynB,
-                    ColumnIndex jc2, IdTable* dynRes);
 };
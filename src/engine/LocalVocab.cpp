@@ -4,79 +4,75 @@
 
 #include "engine/LocalVocab.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "absl/strings/str_cat.h"
 #include "global/Id.h"
 #include "global/ValueId.h"
 
+// _____________________________________________________________________________
+std::string_view LocalVocab::WordArena::add(std::string_view word) {
+  if (word.size() > numFreeBytes_) {
+    size_t chunkSize = std::max(word.size(), nextChunkSize_);
+    nextChunkSize_ = std::min(2 * nextChunkSize_, maxChunkSize_);
+    chunks_.push_back(std::make_unique_for_overwrite<char[]>(chunkSize));
+    free_ = chunks_.back().get();
+    numFreeBytes_ = chunkSize;
+  }
+  std::ranges::copy(word, free_);
+  std::string_view result{free_, word.size()};
+  free_ += word.size();
+  numFreeBytes_ -= word.size();
+  return result;
+}
+
 // _____________________________________________________________________________
 LocalVocab LocalVocab::clone() const {
   LocalVocab localVocabClone;
-  // First, make a deep copy of the `absl::node_hash_map` holding the actual
-  // map of strings to indexes.
-  localVocabClone.wordsToIndexesMap_ = this->wordsToIndexesMap_;
-  // The next free index should be the same.
-  localVocabClone.nextFreeIndex_ = this->nextFreeIndex_;
-  // The map from local ids to strings stores pointers to strings. So we cannot
-  // just copy these from `this->indexesToWordsMap_` to `localVocabClone`, but
-  // we need to make sure to store the pointers to the strings of the new map
-  // `localVocabClone.wordsToIndexesMap_`.
-  //
-  // NOTE: An alternative algorithm would be to sort the word-index pairs in
-  // `wordsToIndexesMap_` by index and then fill `indexesToWordsMap_` in order.
-  // This would have better locality, but the sorting takes non-linear time plus
-  // the sorting has to handle pairs of `LocalVocabIndex` and `std::string`. So
-  // for very large local vocabularies (and only then is this operation
-  // performance-criticial at all), the simpler approach below is probably
-  // better.
-  const size_t localVocabSize = this->size();
-  localVocabClone.indexesToWordsMap_.resize(localVocabSize);
-  for (const auto& [wordInMap, index] : localVocabClone.wordsToIndexesMap_) {
-    AD_CONTRACT_CHECK(index.get() < localVocabSize);
-    localVocabClone.indexesToWordsMap_[index.get()] = std::addressof(wordInMap);
+  // The clone only reads the arenas of this local vocabulary, and adds its
+  // own words to a separate arena. The words that are added to this local
+  // vocabulary later are appended to its own arena without moving the
+  // existing words, so the keys of the copied maps remain valid.
+  localVocabClone.sharedArenas_ = sharedArenas_;
+  if (ownArena_) {
+    localVocabClone.shareArena(ownArena_);
   }
-  // Return the clone.
+  localVocabClone.wordsToIndexesMap_ = wordsToIndexesMap_;
+  localVocabClone.indexesToWordsMap_ = indexesToWordsMap_;
   return localVocabClone;
 }
 
 // _____________________________________________________________________________
-template <typename WordT>
-LocalVocabIndex LocalVocab::getIndexAndAddIfNotContainedImpl(WordT&& word) {
-  // The following code contains two subtle, but important optimizations:
-  //
-  // 1. The variant of `insert` used covers the case that `word` was already
-  // contained in the map as well as the case that it is newly inserted. This
-  // avoids computing the hash for `word` twice in case we see it for the first
-  // time (note that hashing a string is not cheap).
-  //
-  // 2. The fact that we have a member variable `nextFreeIndex_` avoids that we
-  // tentatively have to compute the next free ID every time this function is
-  // called (even when the ID is not actually needed because the word is already
-  // contained in the map).
-  //
-  auto [wordInMapAndIndex, isNewWord] =
-      wordsToIndexesMap_.insert({std::forward<WordT>(word), nextFreeIndex_});
-  const auto& [wordInMap, index] = *wordInMapAndIndex;
-  if (isNewWord) {
-    indexesToWordsMap_.push_back(&wordInMap);
-    nextFreeIndex_ = LocalVocabIndex::make(indexesToWordsMap_.size());
+void LocalVocab::shareArena(std::shared_ptr<const WordArena> arena) {
+  if (arena != ownArena_ &&
+      std::ranges::find(sharedArenas_, arena) == sharedArenas_.end()) {
+    sharedArenas_.push_back(std::move(arena));
   }
-  return index;
 }
 
 // _____________________________________________________________________________
 LocalVocabIndex LocalVocab::getIndexAndAddIfNotContained(
-    const std::string& word) {
-  return getIndexAndAddIfNotContainedImpl(word);
-}
-
-// _____________________________________________________________________________
-LocalVocabIndex LocalVocab::getIndexAndAddIfNotContained(std::string&& word) {
-  return getIndexAndAddIfNotContainedImpl(std::move(word));
+    std::string_view word) {
+  // Use `find` before inserting, because the key that is inserted has to be
+  // the copy of the `word` in the arena.
+  if (auto it = wordsToIndexesMap_.find(word);
+      it != wordsToIndexesMap_.end()) {
+    return it->second;
+  }
+  if (!ownArena_) {
+    ownArena_ = std::make_shared<WordArena>();
+  }
+  std::string_view wordInArena = ownArena_->add(word);
+  auto index = LocalVocabIndex::make(indexesToWordsMap_.size());
+  wordsToIndexesMap_.emplace(wordInArena, index);
+  indexesToWordsMap_.push_back(wordInArena);
+  return index;
 }
 
 // _____________________________________________________________________________
 std::optional<LocalVocabIndex> LocalVocab::getIndexOrNullopt(
-    const std::string& word) const {
+    std::string_view word) const {
   auto localVocabIndex = wordsToIndexesMap_.find(word);
   if (localVocabIndex != wordsToIndexesMap_.end()) {
     return localVocabIndex->second;
@@ -86,12 +82,53 @@ std::optional<LocalVocabIndex> LocalVocab::getIndexOrNullopt(
 }
 
 // _____________________________________________________________________________
-const std::string& LocalVocab::getWord(LocalVocabIndex localVocabIndex) const {
+Id LocalVocab::getIdAndAddIfNotContained(std::string_view word) {
+  if (word.size() <= Id::InlineString::maxSize) {
+    return Id::makeFromInlineString(word);
+  }
+  return Id::makeFromLocalVocabIndex(getIndexAndAddIfNotContained(word));
+}
+
+// _____________________________________________________________________________
+std::optional<Id> LocalVocab::getIdOrNullopt(std::string_view word) const {
+  if (word.size() <= Id::InlineString::maxSize) {
+    return Id::makeFromInlineString(word);
+  }
+  auto index = getIndexOrNullopt(word);
+  if (!index.has_value()) {
+    return std::nullopt;
+  }
+  return Id::makeFromLocalVocabIndex(index.value());
+}
+
+// _____________________________________________________________________________
+std::vector<LocalVocabIndex> LocalVocab::mergeWith(const LocalVocab& other) {
+  for (const auto& arena : other.sharedArenas_) {
+    shareArena(arena);
+  }
+  if (other.ownArena_) {
+    shareArena(other.ownArena_);
+  }
+  std::vector<LocalVocabIndex> indexes;
+  indexes.reserve(other.size());
+  for (std::string_view word : other.indexesToWordsMap_) {
+    auto [it, isNewWord] = wordsToIndexesMap_.try_emplace(
+        word, LocalVocabIndex::make(indexesToWordsMap_.size()));
+    if (isNewWord) {
+      indexesToWordsMap_.push_back(word);
+    }
+    indexes.push_back(it->second);
+  }
+  return indexes;
+}
+
+// _____________________________________________________________________________
+std::string_view LocalVocab::getWord(LocalVocabIndex localVocabIndex) const {
   if (localVocabIndex.get() >= indexesToWordsMap_.size()) {
     throw std::runtime_error(absl::StrCat(
         "LocalVocab error: request for word with local vocab index ",
         localVocabIndex.get(), ", but size of local vocab is only ",
         indexesToWordsMap_.size(), ", please contact the developers"));
   }
-  return *(indexesToWordsMap_.at(localVocabIndex.get()));
+  return indexesToWordsMap_[localVocabIndex.get()];
 }
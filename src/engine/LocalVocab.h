@@ -7,35 +7,59 @@
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include "absl/container/node_hash_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "global/Id.h"
 
 // A class for maintaing a local vocabulary with contiguous (local) IDs. This is
 // meant for words that are not part of the normal vocabulary (constructed from
 // the input data at indexing time).
 //
-// TODO: This is a first version of this class with basic functionality. Note
-// that the local vocabulary used to be a simple `std::vector<std::string>`
-// defined inside of the `ResultTable` class. You gotta start somewhere.
+// Short words are not stored at all, but inlined into their `Id` (see
+// `getIdAndAddIfNotContained`).
+//
+// The characters of the words are stored in append-only arenas, which are
+// shared (and never copied) when a local vocabulary is cloned or merged into
+// another one.
 class LocalVocab {
  private:
-  // A map of the words in the local vocabulary to their local IDs. This is a
-  // node hash map because we need the addresses of the words (which are of type
-  // `std::string`) to remain stable over their lifetime in the hash map because
-  // we refer to them in `wordsToIdsMap_` below.
-  absl::node_hash_map<std::string, LocalVocabIndex> wordsToIndexesMap_;
+  // An append-only storage for the characters of words. The words are stored
+  // contiguously in chunks which are never reallocated, so a `string_view` of
+  // a word remains valid over the lifetime of the arena.
+  class WordArena {
+   private:
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    // The unused part of the last chunk.
+    char* free_ = nullptr;
+    size_t numFreeBytes_ = 0;
+    // The size of the next chunk. The chunks grow exponentially, s.t. small
+    // local vocabularies only need little memory.
+    size_t nextChunkSize_ = 256;
+    static constexpr size_t maxChunkSize_ = 1 << 20;
+
+   public:
+    // Copy the `word` to the arena and return a view of the copy.
+    std::string_view add(std::string_view word);
+  };
+
+  // The arenas which store the words of this local vocabulary and which are
+  // shared with the local vocabularies from which this vocabulary was cloned
+  // or merged. They are never written through these pointers.
+  std::vector<std::shared_ptr<const WordArena>> sharedArenas_;
+
+  // The arena to which the words that are added to this local vocabulary are
+  // copied. It is created when the first word is added.
+  std::shared_ptr<WordArena> ownArena_;
+
+  // A map of the words in the local vocabulary to their local IDs. The keys
+  // point to the words in the arenas.
+  absl::flat_hash_map<std::string_view, LocalVocabIndex> wordsToIndexesMap_;
 
   // A map of the local IDs to the words. Since the IDs are contiguous, we can
-  // use a `std::vector`. We store pointers to the actual words in
-  // `wordsToIdsMap_` to avoid storing every word twice. This saves space, but
-  // costs us an indirection when looking up a word by its ID.
-  std::vector<const std::string*> indexesToWordsMap_;
-
-  // The next free local ID (will be incremented by one each time we add a new
-  // word).
-  LocalVocabIndex nextFreeIndex_ = LocalVocabIndex::make(0);
+  // use a `std::vector`.
+  std::vector<std::string_view> indexesToWordsMap_;
 
  public:
   // Create a new, empty local vocabulary.
@@ -45,7 +69,8 @@ class LocalVocab {
   LocalVocab(const LocalVocab&) = delete;
   LocalVocab& operator=(const LocalVocab&) = delete;
 
-  // Make a deep copy explicitly.
+  // Make a copy explicitly. The words themselves are not copied, but shared
+  // with this local vocabulary, only the maps of the words are copied.
   LocalVocab clone() const;
 
   // Moving a local vocabulary is not problematic (though the typical use case
@@ -56,13 +81,27 @@ class LocalVocab {
   // Get the index of a word in the local vocabulary. If the word was already
   // contained, return the already existing index. If the word was not yet
   // contained, add it, and return the new index.
-  LocalVocabIndex getIndexAndAddIfNotContained(const std::string& word);
-  LocalVocabIndex getIndexAndAddIfNotContained(std::string&& word);
+  LocalVocabIndex getIndexAndAddIfNotContained(std::string_view word);
 
   // Get the index of a word in the local vocabulary, or std::nullopt if it is
   // not contained. This is useful for testing.
-  std::optional<LocalVocabIndex> getIndexOrNullopt(
-      const std::string& word) const;
+  std::optional<LocalVocabIndex> getIndexOrNullopt(std::string_view word) const;
+
+  // Get the `Id` of a word. Words of at most `Id::InlineString::maxSize`
+  // bytes are stored directly in the `Id` (with datatype `InlineString`) and
+  // are not added to the local vocabulary. The `Id` of a longer word has the
+  // datatype `LocalVocabIndex`, the word is added if it is not yet contained.
+  Id getIdAndAddIfNotContained(std::string_view word);
+
+  // Same as `getIdAndAddIfNotContained`, but return std::nullopt instead of
+  // adding a word that is not contained.
+  std::optional<Id> getIdOrNullopt(std::string_view word) const;
+
+  // Add all the words of the `other` local vocabulary that are not yet
+  // contained. The `i`-th element of the result is the index in this local
+  // vocabulary of the word with index `i` in the `other` local vocabulary.
+  // The words are not copied, but the arenas of `other` are shared.
+  std::vector<LocalVocabIndex> mergeWith(const LocalVocab& other);
 
   // The number of words in the vocabulary.
   size_t size() const { return indexesToWordsMap_.size(); }
@@ -70,12 +109,11 @@ class LocalVocab {
   // Return true if and only if the local vocabulary is empty.
   bool empty() const { return indexesToWordsMap_.empty(); }
 
-  // Return a const reference to the word.
-  const std::string& getWord(LocalVocabIndex localVocabIndex) const;
+  // Return a view of the word. It remains valid as long as this local
+  // vocabulary (or one of its clones) exists.
+  std::string_view getWord(LocalVocabIndex localVocabIndex) const;
 
  private:
-  // Common implementation for the two variants of
-  // `getIndexAndAddIfNotContainedImpl` above.
-  template <typename WordT>
-  LocalVocabIndex getIndexAndAddIfNotContainedImpl(WordT&& word);
+  // Add the `arena` to the `sharedArenas_` if it is not contained yet.
+  void shareArena(std::shared_ptr<const WordArena> arena);
 };
@@ -0,0 +1,72 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/MaterializedViews.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <filesystem>
+
+#include "util/File.h"
+
+// _____________________________________________________________________________
+void MaterializedViews::readFromFile(std::string filename) {
+  Definitions definitions;
+  if (std::filesystem::exists(filename)) {
+    definitions = fileToJson(filename).get<Definitions>();
+  }
+  auto state = state_.wlock();
+  state->filename_ = std::move(filename);
+  state->definitions_ = std::move(definitions);
+}
+
+// _____________________________________________________________________________
+void MaterializedViews::add(const std::string& name, std::string query) {
+  auto state = state_.wlock();
+  state->definitions_[name] = std::move(query);
+  writeToFile(*state);
+}
+
+// _____________________________________________________________________________
+bool MaterializedViews::remove(const std::string& name) {
+  auto state = state_.wlock();
+  if (state->definitions_.erase(name) == 0) {
+    return false;
+  }
+  writeToFile(*state);
+  return true;
+}
+
+// _____________________________________________________________________________
+auto MaterializedViews::definitions() const -> Definitions {
+  return state_.rlock()->definitions_;
+}
+
+// _____________________________________________________________________________
+std::optional<std::string> MaterializedViews::getQuery(
+    const std::string& name) const {
+  auto state = state_.rlock();
+  auto it = state->definitions_.find(name);
+  if (it == state->definitions_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+// _____________________________________________________________________________
+nlohmann::json MaterializedViews::toJson() const {
+  return nlohmann::json(definitions());
+}
+
+// _____________________________________________________________________________
+void MaterializedViews::writeToFile(const State& state) {
+  if (state.filename_.empty()) {
+    return;
+  }
+  std::string tmpFilename = absl::StrCat(state.filename_, ".tmp");
+  {
+    auto file = ad_utility::makeOfstream(tmpFilename);
+    file << nlohmann::json(state.definitions_).dump(2) << std::endl;
+  }
+  std::filesystem::rename(tmpFilename, state.filename_);
+}
@@ -0,0 +1,67 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "util/Synchronized.h"
+#include "util/json.h"
+
+// The definitions of the named materialized views of a server: each view is a
+// SPARQL query the result of which is pinned in the cache. A query that
+// contains a subtree with the same cache key as the query of a view then reads
+// the pinned result instead of computing it (see
+// `QueryExecutionTree::readFromCache`), and the persistent tier of the cache
+// (see `PersistentResultCache`) stores the result on disk, s.t. it survives a
+// restart. The results themselves are computed by the `Server`.
+//
+// The definitions are stored as a JSON object (from the names to the queries)
+// in a file next to the index, which can also be edited manually while the
+// server is not running.
+//
+// This class is threadsafe.
+class MaterializedViews {
+ public:
+  static constexpr std::string_view FILE_SUFFIX = ".materialized-views.json";
+
+  // The queries of the views by their names.
+  using Definitions = std::map<std::string, std::string>;
+
+ private:
+  struct State {
+    std::string filename_;
+    Definitions definitions_;
+  };
+  ad_utility::Synchronized<State> state_;
+
+ public:
+  MaterializedViews() = default;
+
+  // Use the definitions from the `filename`. If the file doesn't exist, there
+  // are no definitions. Throw if the file can't be parsed.
+  void readFromFile(std::string filename);
+
+  // Add the view with the `name` and the `query` or replace the query of an
+  // existing view with the `name`, and write the definitions to the file.
+  void add(const std::string& name, std::string query);
+
+  // Remove the view with the `name` and write the definitions to the file.
+  // Return false if there is no such view.
+  bool remove(const std::string& name);
+
+  Definitions definitions() const;
+  std::optional<std::string> getQuery(const std::string& name) const;
+
+  // The definitions as a JSON object (for `cmd=materialized-views`).
+  nlohmann::json toJson() const;
+
+ private:
+  // Write the definitions of the `state` to its file (if it is set). The file
+  // is first written to a temporary file and then renamed, s.t. a crash during
+  // the writing leaves the previous definitions intact.
+  static void writeToFile(const State& state);
+};
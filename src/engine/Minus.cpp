@@ -5,7 +5,9 @@
 #include "Minus.h"
 
 #include "engine/CallFixedSize.h"
+#include "engine/IndexScan.h"
 #include "util/Exception.h"
+#include "util/JoinAlgorithms/Gallop.h"
 
 using std::endl;
 using std::string;
@@ -13,8 +15,16 @@ using std::string;
 // _____________________________________________________________________________
 Minus::Minus(QueryExecutionContext* qec,
              std::shared_ptr<QueryExecutionTree> left,
-             std::shared_ptr<QueryExecutionTree> right)
-    : Operation{qec} {
+             std::shared_ptr<QueryExecutionTree> right,
+             Semantics semantics)
+    : Operation{qec}, semantics_{semantics} {
+  // Without shared variables, the inputs need not be sorted (see
+  // `computeResult`).
+  if (QueryExecutionTree::getJoinColumns(*left, *right).empty()) {
+    _left = std::move(left);
+    _right = std::move(right);
+    return;
+  }
   std::tie(_left, _right, _matchedColumns) =
       QueryExecutionTree::getSortedSubtreesAndJoinColumns(std::move(left),
                                                           std::move(right));
@@ -23,34 +33,81 @@ Minus::Minus(QueryExecutionContext* qec,
 // _____________________________________________________________________________
 string Minus::getCacheKeyImpl() const {
   std::ostringstream os;
-  os << "MINUS\n" << _left->getCacheKey() << "\n";
+  os << (semantics_ == Semantics::Minus ? "MINUS" : "NOT EXISTS") << "\n"
+     << _left->getCacheKey() << "\n";
   os << _right->getCacheKey() << " ";
   return std::move(os).str();
 }
 
 // _____________________________________________________________________________
-string Minus::getDescriptor() const { return "Minus"; }
+string Minus::getDescriptor() const {
+  return semantics_ == Semantics::Minus ? "Minus" : "Not exists";
+}
 
 // _____________________________________________________________________________
-ResultTable Minus::computeResult() {
+ResultTable Minus::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "Minus result computation..." << endl;
 
   IdTable idTable{getExecutionContext()->getAllocator()};
   idTable.setNumColumns(getResultWidth());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  // Without shared variables, the result of `NOT EXISTS` is empty if the right
+  // input is not empty (for `MINUS`, it is the left input, see below).
+  std::shared_ptr<const ResultTable> rightResult;
+  if (_matchedColumns.empty() && semantics_ == Semantics::NotExists) {
+    rightResult = _right->getResult();
+    if (!rightResult->idTable().empty()) {
+      _left->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+      return {std::move(idTable), resultSortedOn(), LocalVocab{}};
+    }
+  }
+
+  auto compute = [this, &idTable](const IdTable& left, const IdTable& right) {
+    int leftWidth = left.numColumns();
+    int rightWidth = right.numColumns();
+    CALL_FIXED_SIZE((std::array{leftWidth, rightWidth}), &Minus::computeMinus,
+                    this, left, right, _matchedColumns, &idTable);
+  };
+
+  // If the right input is an `IndexScan` on the first join column that is not
+  // cached, only the blocks of the scan that can contain a row that matches
+  // the left input are read. The joins that read the blocks of index scans
+  // directly cannot be used if the index has inserted or deleted triples.
+  if (_right->getType() == QueryExecutionTree::SCAN &&
+      !_matchedColumns.empty() && _matchedColumns[0][1] == 0) {
+    auto& scan = dynamic_cast<IndexScan&>(*_right->getRootOperation());
+    if (!scan.hasDeltaTriples() && scan.numVariables() <= 2 &&
+        !scan.getResult(false, ComputationMode::ONLY_IF_CACHED)) {
+      auto leftResult = _left->getResult();
+      const IdTable& left = leftResult->idTable();
+      IdTable right =
+          readBlocksForJoinColumn(left.getColumn(_matchedColumns[0][0]), scan);
+      compute(left, right);
+      // The result only contains rows of the left input.
+      return {std::move(idTable), resultSortedOn(),
+              leftResult->getSharedLocalVocab()};
+    }
+  }
 
-  LOG(DEBUG) << "Minus subresult computation done" << std::endl;
+  std::shared_ptr<const ResultTable> leftResult;
+  if (requestLaziness || rightResult) {
+    if (!rightResult) {
+      rightResult = _right->getResult();
+    }
+    leftResult = _left->getResult(requestLaziness);
+  } else {
+    auto childResults = getChildResults(std::array{_left, _right});
+    leftResult = std::move(childResults[0]);
+    rightResult = std::move(childResults[1]);
+  }
+  if (!leftResult->isFullyMaterialized()) {
+    return {computeMinusLazily(std::move(leftResult), std::move(rightResult)),
+            resultSortedOn()};
+  }
 
   LOG(DEBUG) << "Computing minus of results of size " << leftResult->size()
              << " and " << rightResult->size() << endl;
-
-  int leftWidth = leftResult->idTable().numColumns();
-  int rightWidth = rightResult->idTable().numColumns();
-  CALL_FIXED_SIZE((std::array{leftWidth, rightWidth}), &Minus::computeMinus,
-                  this, leftResult->idTable(), rightResult->idTable(),
-                  _matchedColumns, &idTable);
+  compute(leftResult->idTable(), rightResult->idTable());
 
   LOG(DEBUG) << "Minus result computation done" << endl;
   // If only one of the two operands has a non-empty local vocabulary, share
@@ -60,6 +117,43 @@ ResultTable Minus::computeResult() {
                                                          *rightResult)};
 }
 
+// _____________________________________________________________________________
+ResultTable::Generator Minus::computeMinusLazily(
+    std::shared_ptr<const ResultTable> leftResult,
+    std::shared_ptr<const ResultTable> rightResult) const {
+  const IdTable& right = rightResult->idTable();
+  // The left input is sorted across all its blocks, so the rows of the right
+  // input that were skipped for one block can be skipped for all the following
+  // blocks.
+  size_t rightBegin = 0;
+  for (auto& [block, localVocab] : leftResult->idTables()) {
+    IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+    int leftWidth = block.numColumns();
+    int rightWidth = right.numColumns();
+    CALL_FIXED_SIZE((std::array{leftWidth, rightWidth}),
+                    &Minus::computeMinusFrom, this, block, right,
+                    _matchedColumns, &result, rightBegin);
+    if (!result.empty()) {
+      co_yield ResultTable::IdTableVocabPair{std::move(result),
+                                             std::move(localVocab)};
+    }
+  }
+}
+
+// _____________________________________________________________________________
+IdTable Minus::readBlocksForJoinColumn(std::span<const Id> leftJoinColumn,
+                                       IndexScan& scan) const {
+  auto blocks =
+      IndexScan::lazyScanForJoinOfColumnWithScan(leftJoinColumn, scan);
+  IdTable right{scan.getResultWidth(), getExecutionContext()->getAllocator()};
+  for (const IdTable& block : blocks) {
+    checkCancellation();
+    right.insertAtEnd(block);
+  }
+  scan.updateRuntimeInfoForLazyScan(blocks.details());
+  return right;
+}
+
 // _____________________________________________________________________________
 VariableToColumnMap Minus::computeVariableToColumnMap() const {
   return _left->getVariableColumns();
@@ -99,6 +193,17 @@ void Minus::computeMinus(
     const IdTable& dynA, const IdTable& dynB,
     const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
     IdTable* dynResult) const {
+  size_t bBegin = 0;
+  computeMinusFrom<A_WIDTH, B_WIDTH>(dynA, dynB, joinColumns, dynResult,
+                                     bBegin);
+}
+
+// _____________________________________________________________________________
+template <int A_WIDTH, int B_WIDTH>
+void Minus::computeMinusFrom(
+    const IdTable& dynA, const IdTable& dynB,
+    const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
+    IdTable* dynResult, size_t& bBegin) const {
   // Substract dynB from dynA. The result should be all result mappings mu
   // for which all result mappings mu' in dynB are not compatible (one value
   // for a variable defined in both differs) or the domain of mu and mu' are
@@ -137,7 +242,8 @@ void Minus::computeMinus(
    */
   auto writeResult = [&result, &a](size_t ia) { result.push_back(a[ia]); };
 
-  size_t ia = 0, ib = 0;
+  size_t ia = 0, ib = bBegin;
+  std::span<const Id> bFirstJoinColumn = b.getColumn(joinColumns[0][1]);
   while (ia < a.size() && ib < b.size()) {
     // Join columns 0 are the primary sort columns
     while (a(ia, joinColumns[0][0]) < b(ib, joinColumns[0][1])) {
@@ -149,8 +255,12 @@ void Minus::computeMinus(
         goto finish;
       }
     }
-    while (b(ib, joinColumns[0][1]) < a(ia, joinColumns[0][0])) {
-      ib++;
+    if (b(ib, joinColumns[0][1]) < a(ia, joinColumns[0][0])) {
+      // Skip the rows of `b` without a match by galloping.
+      ib = ad_utility::gallop(bFirstJoinColumn, ib,
+                              [id = a(ia, joinColumns[0][0])](Id x) {
+                                return x < id;
+                              });
       checkCancellation();
       if (ib >= b.size()) {
         goto finish;
@@ -189,6 +299,7 @@ void Minus::computeMinus(
     }
   }
 finish:
+  bBegin = ib;
   result.reserve(result.size() + (a.size() - ia));
   while (ia < a.size()) {
     writeResult(ia);
@@ -9,19 +9,34 @@
 #include "./Operation.h"
 #include "./QueryExecutionTree.h"
 
+class IndexScan;
+
+// The anti-join of `SPARQL`: All the rows of the left input that have no
+// compatible row in the right input on the shared variables. The left input is
+// streamed if the result is requested lazily, and the right input is skipped by
+// galloping and, if it is an `IndexScan`, by reading only the blocks that can
+// contain a row that matches the left input.
 class Minus : public Operation {
+ public:
+  // `MINUS` and `FILTER NOT EXISTS` only differ if the inputs have no shared
+  // variables: The result of `MINUS` is then the left input, while the result
+  // of `NOT EXISTS` is empty unless the right input is empty.
+  enum class Semantics { Minus, NotExists };
+
  private:
   std::shared_ptr<QueryExecutionTree> _left;
   std::shared_ptr<QueryExecutionTree> _right;
 
   vector<float> _multiplicities;
   std::vector<std::array<ColumnIndex, 2>> _matchedColumns;
+  Semantics semantics_ = Semantics::Minus;
 
   enum class RowComparison { EQUAL, LEFT_SMALLER, RIGHT_SMALLER };
 
  public:
   Minus(QueryExecutionContext* qec, std::shared_ptr<QueryExecutionTree> left,
-        std::shared_ptr<QueryExecutionTree> right);
+        std::shared_ptr<QueryExecutionTree> right,
+        Semantics semantics = Semantics::Minus);
 
   // Uninitialized Object for testing the computeMinus method
   struct OnlyForTestingTag {};
@@ -37,6 +52,8 @@ class Minus : public Operation {
 
   vector<ColumnIndex> resultSortedOn() const override;
 
+  Semantics semantics() const { return semantics_; }
+
   void setTextLimit(size_t limit) override {
     _left->setTextLimit(limit);
     _right->setTextLimit(limit);
@@ -68,6 +85,26 @@ class Minus : public Operation {
                     IdTable* result) const;
 
  private:
+  // The same as `computeMinus`, but the rows of `b` before `bBegin` are
+  // skipped, and `bBegin` is set to the position in `b` that can be used for a
+  // following block of `a` (which is sorted after the rows of this `a`).
+  template <int A_WIDTH, int B_WIDTH>
+  void computeMinusFrom(
+      const IdTable& dynA, const IdTable& dynB,
+      const vector<std::array<ColumnIndex, 2>>& joinColumns,
+      IdTable* dynResult, size_t& bBegin) const;
+
+  // Compute the result for a `leftResult` that is yielded lazily in blocks.
+  // The `rightResult` must be fully materialized.
+  ResultTable::Generator computeMinusLazily(
+      std::shared_ptr<const ResultTable> leftResult,
+      std::shared_ptr<const ResultTable> rightResult) const;
+
+  // Read the blocks of the `scan` (the right input) that can contain a row
+  // with a value from the (sorted) `leftJoinColumn` in its first column.
+  IdTable readBlocksForJoinColumn(std::span<const Id> leftJoinColumn,
+                                  IndexScan& scan) const;
+
   /**
    * @brief Compares the two rows under the assumption that the first
    * entries of the rows are equal.
@@ -77,7 +114,7 @@ class Minus : public Operation {
       const IdTableView<A_WIDTH>& a, const IdTableView<B_WIDTH>& b, size_t ia,
       size_t ib, const vector<std::array<ColumnIndex, 2>>& matchedColumns);
 
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 };
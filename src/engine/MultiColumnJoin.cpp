@@ -4,9 +4,13 @@
 
 #include "MultiColumnJoin.h"
 
+#include <absl/hash/hash.h>
+
 #include "engine/AddCombinedRowToTable.h"
 #include "engine/CallFixedSize.h"
+#include "util/HashMap.h"
 #include "util/JoinAlgorithms/JoinAlgorithms.h"
+#include "util/ParallelExecution.h"
 
 using std::endl;
 using std::string;
@@ -14,12 +18,21 @@ using std::string;
 // _____________________________________________________________________________
 MultiColumnJoin::MultiColumnJoin(QueryExecutionContext* qec,
                                  std::shared_ptr<QueryExecutionTree> t1,
-                                 std::shared_ptr<QueryExecutionTree> t2)
-    : Operation{qec} {
+                                 std::shared_ptr<QueryExecutionTree> t2,
+                                 Strategy strategy)
+    : Operation{qec}, strategy_{strategy} {
   // Make sure subtrees are ordered so that identical queries can be identified.
   if (t1->getCacheKey() > t2->getCacheKey()) {
     std::swap(t1, t2);
   }
+  if (strategy_ == Strategy::Hash) {
+    // The inputs need not be sorted.
+    _joinColumns = QueryExecutionTree::getJoinColumns(*t1, *t2);
+    AD_CONTRACT_CHECK(!_joinColumns.empty());
+    _left = std::move(t1);
+    _right = std::move(t2);
+    return;
+  }
   std::tie(_left, _right, _joinColumns) =
       QueryExecutionTree::getSortedSubtreesAndJoinColumns(std::move(t1),
                                                           std::move(t2));
@@ -40,9 +53,29 @@ string MultiColumnJoin::getCacheKeyImpl() const {
     os << _joinColumns[i][1] << (i < _joinColumns.size() - 1 ? " & " : "");
   };
   os << "]";
+  if (strategy_ == Strategy::Hash) {
+    os << " (hash)";
+  }
   return std::move(os).str();
 }
 
+// _____________________________________________________________________________
+bool MultiColumnJoin::isHashStrategyApplicable(
+    const QueryExecutionTree& left, const QueryExecutionTree& right) {
+  auto mightContainUndef = [](const QueryExecutionTree& tree,
+                              ColumnIndex column) {
+    return tree.getVariableAndInfoByColumnIndex(column)
+               .second.mightContainUndef_ ==
+           ColumnIndexAndTypeInfo::UndefStatus::PossiblyUndefined;
+  };
+  return std::ranges::none_of(
+      QueryExecutionTree::getJoinColumns(left, right),
+      [&](const auto& columns) {
+        return mightContainUndef(left, columns[0]) ||
+               mightContainUndef(right, columns[1]);
+      });
+}
+
 // _____________________________________________________________________________
 string MultiColumnJoin::getDescriptor() const {
   std::string joinVars = "";
@@ -55,11 +88,15 @@ string MultiColumnJoin::getDescriptor() const {
       }
     }
   }
+  if (strategy_ == Strategy::Hash) {
+    return "MultiColumnJoin (hash) on " + joinVars;
+  }
   return "MultiColumnJoin on " + joinVars;
 }
 
 // _____________________________________________________________________________
-ResultTable MultiColumnJoin::computeResult() {
+ResultTable MultiColumnJoin::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
   LOG(DEBUG) << "MultiColumnJoin result computation..." << endl;
 
   IdTable idTable{getExecutionContext()->getAllocator()};
@@ -67,16 +104,25 @@ ResultTable MultiColumnJoin::computeResult() {
 
   AD_CONTRACT_CHECK(idTable.numColumns() >= _joinColumns.size());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  auto childResults = getChildResults(std::array{_left, _right});
+  const auto leftResult = std::move(childResults[0]);
+  const auto rightResult = std::move(childResults[1]);
 
   LOG(DEBUG) << "MultiColumnJoin subresult computation done." << std::endl;
 
   LOG(DEBUG) << "Computing a multi column join between results of size "
              << leftResult->size() << " and " << rightResult->size() << endl;
 
-  computeMultiColumnJoin(leftResult->idTable(), rightResult->idTable(),
-                         _joinColumns, &idTable);
+  if (strategy_ == Strategy::Hash) {
+    hashMultiColumnJoin(leftResult->idTable(), rightResult->idTable(),
+                        _joinColumns, &idTable,
+                        getExecutionContext()->getNumThreads(
+                            RuntimeParameters().get<"join-num-threads">()));
+  } else {
+    computeMultiColumnJoin(leftResult->idTable(), rightResult->idTable(),
+                           _joinColumns, &idTable);
+  }
+  checkCancellation();
 
   LOG(DEBUG) << "MultiColumnJoin result computation done" << endl;
   // If only one of the two operands has a non-empty local vocabulary, share
@@ -104,6 +150,9 @@ size_t MultiColumnJoin::getResultWidth() const {
 // _____________________________________________________________________________
 vector<ColumnIndex> MultiColumnJoin::resultSortedOn() const {
   std::vector<ColumnIndex> sortedOn;
+  if (strategy_ == Strategy::Hash) {
+    return sortedOn;
+  }
   // The result is sorted on all join columns from the left subtree.
   for (const auto& a : _joinColumns) {
     sortedOn.push_back(a[0]);
@@ -134,6 +183,14 @@ size_t MultiColumnJoin::getCostEstimate() {
   // This join is slower than a normal join, due to
   // its increased complexity
   costEstimate *= 2;
+  if (strategy_ == Strategy::Hash) {
+    // Building and probing the hash map is more expensive per row than the
+    // zipper join, but the inputs (and thus the costs of the children) need
+    // not be sorted.
+    costEstimate = static_cast<size_t>(
+        static_cast<double>(costEstimate) *
+        getExecutionContext()->getCostFactor("HASH_MULTI_COLUMN_JOIN_COST"));
+  }
   // Make the join 7% more expensive per join column
   costEstimate *= (1 + (_joinColumns.size() - 1) * 0.07);
   return _left->getCostEstimate() + _right->getCostEstimate() + costEstimate;
@@ -222,6 +279,31 @@ void MultiColumnJoin::computeMultiColumnJoin(
   auto rightPermuted =
       right.asColumnSubsetView(joinColumnData.permutationRight());
 
+  // `isCheap` is true iff there are no UNDEF values in the join columns. In
+  // this case we can use a much cheaper algorithm, which additionally can be
+  // run on multiple threads.
+  // TODO<joka921> There are many other cases where a cheaper implementation can
+  // be chosen, but we leave those for another PR, this is the most common case.
+  namespace stdr = std::ranges;
+  bool isCheap = stdr::none_of(joinColumns, [&](const auto& jcs) {
+    auto [leftCol, rightCol] = jcs;
+    return (stdr::any_of(right.getColumn(rightCol), &Id::isUndefined)) ||
+           (stdr::any_of(left.getColumn(leftCol), &Id::isUndefined));
+  });
+
+  if (isCheap) {
+    auto makeRowAdder = [&]() {
+      return ad_utility::AddCombinedRowToIdTable{
+          joinColumns.size(), leftPermuted, rightPermuted,
+          IdTable{result->numColumns(), result->getAllocator()}};
+    };
+    *result = ad_utility::parallelZipperJoinWithoutUndef(
+        leftJoinColumns, rightJoinColumns, std::ranges::lexicographical_compare,
+        RuntimeParameters().get<"join-num-threads">(), makeRowAdder);
+    result->setColumnSubset(joinColumnData.permutationResult());
+    return;
+  }
+
   auto rowAdder = ad_utility::AddCombinedRowToIdTable(
       joinColumns.size(), leftPermuted, rightPermuted, std::move(*result));
   auto addRow = [&rowAdder, beginLeft = leftJoinColumns.begin(),
@@ -236,29 +318,9 @@ void MultiColumnJoin::computeMultiColumnJoin(
                                               resultMightBeUnsorted);
   };
 
-  // `isCheap` is true iff there are no UNDEF values in the join columns. In
-  // this case we can use a much cheaper algorithm.
-  // TODO<joka921> There are many other cases where a cheaper implementation can
-  // be chosen, but we leave those for another PR, this is the most common case.
-  namespace stdr = std::ranges;
-  bool isCheap = stdr::none_of(joinColumns, [&](const auto& jcs) {
-    auto [leftCol, rightCol] = jcs;
-    return (stdr::any_of(right.getColumn(rightCol), &Id::isUndefined)) ||
-           (stdr::any_of(left.getColumn(leftCol), &Id::isUndefined));
-  });
-
-  const size_t numOutOfOrder = [&]() {
-    if (isCheap) {
-      return ad_utility::zipperJoinWithUndef(
-          leftJoinColumns, rightJoinColumns,
-          std::ranges::lexicographical_compare, addRow, ad_utility::noop,
-          ad_utility::noop);
-    } else {
-      return ad_utility::zipperJoinWithUndef(
-          leftJoinColumns, rightJoinColumns,
-          std::ranges::lexicographical_compare, addRow, findUndef, findUndef);
-    }
-  }();
+  const size_t numOutOfOrder = ad_utility::zipperJoinWithUndef(
+      leftJoinColumns, rightJoinColumns, std::ranges::lexicographical_compare,
+      addRow, findUndef, findUndef);
   *result = std::move(rowAdder).resultTable();
   // If there were UNDEF values in the input, the result might be out of
   // order. Sort it, because this operation promises a sorted result in its
@@ -278,3 +340,169 @@ void MultiColumnJoin::computeMultiColumnJoin(
   // `JoinColumnMapping` for details.
   result->setColumnSubset(joinColumnData.permutationResult());
 }
+
+// _____________________________________________________________________________
+void MultiColumnJoin::hashMultiColumnJoin(
+    const IdTable& left, const IdTable& right,
+    const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
+    IdTable* result, size_t numThreads) {
+  // check for trivial cases
+  if (left.empty() || right.empty()) {
+    return;
+  }
+
+  // UNDEF values in the join columns match every value. This is rare, so in
+  // this case the inputs are simply sorted and joined by the zipper join.
+  namespace stdr = std::ranges;
+  bool hasUndef = stdr::any_of(joinColumns, [&](const auto& jcs) {
+    auto [leftCol, rightCol] = jcs;
+    return (stdr::any_of(right.getColumn(rightCol), &Id::isUndefined)) ||
+           (stdr::any_of(left.getColumn(leftCol), &Id::isUndefined));
+  });
+  if (hasUndef) {
+    std::vector<ColumnIndex> leftCols;
+    std::vector<ColumnIndex> rightCols;
+    for (auto [leftCol, rightCol] : joinColumns) {
+      leftCols.push_back(leftCol);
+      rightCols.push_back(rightCol);
+    }
+    IdTable leftSorted = left.clone();
+    IdTable rightSorted = right.clone();
+    Engine::sort(leftSorted, leftCols);
+    Engine::sort(rightSorted, rightCols);
+    computeMultiColumnJoin(leftSorted, rightSorted, joinColumns, result);
+    return;
+  }
+
+  // The smaller input is put into a hash map, the larger input is probed (see
+  // `Join::hashJoin`). The key of the hash map is the hash of the combination
+  // of the join columns of a row, so the rows with the same key are compared
+  // on all the join columns when the map is probed.
+  const bool leftIsLarger = left.size() >= right.size();
+  const IdTable& largerTable = leftIsLarger ? left : right;
+  const IdTable& smallerTable = leftIsLarger ? right : left;
+  std::vector<std::span<const Id>> largerJoinColumns;
+  std::vector<std::span<const Id>> smallerJoinColumns;
+  for (auto [leftCol, rightCol] : joinColumns) {
+    largerJoinColumns.push_back(
+        largerTable.getColumn(leftIsLarger ? leftCol : rightCol));
+    smallerJoinColumns.push_back(
+        smallerTable.getColumn(leftIsLarger ? rightCol : leftCol));
+  }
+  auto hashOfRow = [](const std::vector<std::span<const Id>>& columns,
+                      size_t row) {
+    size_t hash = 0;
+    for (const auto& column : columns) {
+      hash = absl::HashOf(hash, column[row]);
+    }
+    return hash;
+  };
+  auto rowsAreEqual = [&](size_t largerRow, size_t smallerRow) {
+    for (size_t i = 0; i < largerJoinColumns.size(); ++i) {
+      if (largerJoinColumns[i][largerRow] !=
+          smallerJoinColumns[i][smallerRow]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Using several threads only pays off if the inputs are large enough.
+  static constexpr size_t minSizeForParallelJoin = 100'000;
+  if (largerTable.size() < minSizeForParallelJoin) {
+    numThreads = 1;
+  }
+  numThreads = std::max(numThreads, size_t{1});
+
+  // The rows of the smaller input are radix-partitioned by their hash, and
+  // the hash map of each partition is built on a separate thread.
+  const size_t numPartitions = numThreads;
+  auto getPartition = [numPartitions](size_t hash) -> size_t {
+    return (hash >> 32) % numPartitions;
+  };
+  auto getChunk = [numThreads](size_t threadIdx, size_t size) {
+    size_t chunkSize = size / numThreads + 1;
+    size_t begin = std::min(size, threadIdx * chunkSize);
+    return std::pair{begin, std::min(size, begin + chunkSize)};
+  };
+  std::vector<size_t> smallerHashes(smallerTable.size());
+  std::vector<std::vector<std::vector<size_t>>> partitionedRows(
+      numThreads, std::vector<std::vector<size_t>>(numPartitions));
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    auto [begin, end] = getChunk(threadIdx, smallerTable.size());
+    for (size_t i = begin; i < end; ++i) {
+      smallerHashes[i] = hashOfRow(smallerJoinColumns, i);
+      partitionedRows[threadIdx][getPartition(smallerHashes[i])].push_back(i);
+    }
+  });
+  std::vector<ad_utility::HashMap<size_t, std::vector<size_t>>> maps(
+      numPartitions);
+  ad_utility::runConcurrently(numPartitions, [&](size_t partition) {
+    auto& map = maps[partition];
+    for (const auto& rowsOfChunk : partitionedRows) {
+      for (size_t i : rowsOfChunk[partition]) {
+        map[smallerHashes[i]].push_back(i);
+      }
+    }
+  });
+  partitionedRows.clear();
+
+  // Collect the pairs of the indices of the matching rows of `left` and
+  // `right` by probing contiguous chunks of the larger input concurrently.
+  std::vector<std::vector<std::pair<size_t, size_t>>> matchesOfChunks(
+      numThreads);
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    auto& matches = matchesOfChunks[threadIdx];
+    auto [begin, end] = getChunk(threadIdx, largerTable.size());
+    for (size_t i = begin; i < end; ++i) {
+      size_t hash = hashOfRow(largerJoinColumns, i);
+      const auto& map = maps[getPartition(hash)];
+      auto entry = map.find(hash);
+      if (entry == map.end()) {
+        continue;
+      }
+      for (size_t rowIdx : entry->second) {
+        if (!rowsAreEqual(i, rowIdx)) {
+          continue;
+        }
+        if (leftIsLarger) {
+          matches.emplace_back(i, rowIdx);
+        } else {
+          matches.emplace_back(rowIdx, i);
+        }
+      }
+    }
+  });
+  maps.clear();
+
+  // Gather the columns of the result in the order that `computeMultiColumnJoin`
+  // produces: First the columns of `left`, then the columns of `right` without
+  // the join columns.
+  std::vector<size_t> offsets{0};
+  for (const auto& matches : matchesOfChunks) {
+    offsets.push_back(offsets.back() + matches.size());
+  }
+  result->resize(offsets.back());
+  auto gatherColumn = [&](std::span<const Id> input, size_t outputCol,
+                          bool fromLeft) {
+    std::span<Id> output = result->getColumn(outputCol);
+    ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+      std::ranges::transform(
+          matchesOfChunks[threadIdx], output.begin() + offsets[threadIdx],
+          [&input, fromLeft](const auto& match) {
+            return input[fromLeft ? match.first : match.second];
+          });
+    });
+  };
+  for (size_t col = 0; col < left.numColumns(); ++col) {
+    gatherColumn(left.getColumn(col), col, true);
+  }
+  size_t outputCol = left.numColumns();
+  for (size_t col = 0; col < right.numColumns(); ++col) {
+    if (!stdr::any_of(joinColumns, [col](const auto& jcs) {
+          return jcs[1] == col;
+        })) {
+      gatherColumn(right.getColumn(col), outputCol++, false);
+    }
+  }
+}
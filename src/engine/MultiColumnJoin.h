@@ -10,12 +10,26 @@
 #include "engine/QueryExecutionTree.h"
 
 class MultiColumnJoin : public Operation {
+ public:
+  // The algorithm that is used to compute the join.
+  enum struct Strategy {
+    // Both inputs are sorted on all join columns and merged via a zipper join
+    // that also handles UNDEF values.
+    Zipper,
+    // A hash join on the combination of the join columns, which needs no
+    // sorted inputs. This pays off if at least one of the inputs would have to
+    // be sorted for the zipper join. The result is not sorted.
+    Hash
+  };
+
  private:
   std::shared_ptr<QueryExecutionTree> _left;
   std::shared_ptr<QueryExecutionTree> _right;
 
   std::vector<std::array<ColumnIndex, 2>> _joinColumns;
 
+  Strategy strategy_ = Strategy::Zipper;
+
   vector<float> _multiplicities;
   size_t _sizeEstimate;
   bool _multiplicitiesComputed = false;
@@ -23,7 +37,17 @@ class MultiColumnJoin : public Operation {
  public:
   MultiColumnJoin(QueryExecutionContext* qec,
                   std::shared_ptr<QueryExecutionTree> t1,
-                  std::shared_ptr<QueryExecutionTree> t2);
+                  std::shared_ptr<QueryExecutionTree> t2,
+                  Strategy strategy = Strategy::Zipper);
+
+  // Return true iff the `Strategy::Hash` should be considered for the join of
+  // `left` and `right`, i.e. if none of their join columns can contain UNDEF.
+  // (The hash join is also correct for UNDEF values, but then falls back to
+  // sorting the inputs, see `hashMultiColumnJoin`.)
+  static bool isHashStrategyApplicable(const QueryExecutionTree& left,
+                                       const QueryExecutionTree& right);
+
+  Strategy strategy() const { return strategy_; }
 
  protected:
   string getCacheKeyImpl() const override;
@@ -67,8 +91,20 @@ class MultiColumnJoin : public Operation {
       const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
       IdTable* resultMightBeUnsorted);
 
+  // Join `left` and `right` like `computeMultiColumnJoin`, but via a hash map
+  // on the combined join columns of the smaller input, which is probed with
+  // the rows of the larger input (see `Strategy::Hash`). The inputs need not
+  // be sorted, and the rows of the result are in no particular order. Large
+  // inputs are joined on `numThreads` threads. If one of the join columns
+  // contains UNDEF, both inputs are sorted and joined by the zipper join, s.t.
+  // the semantics of UNDEF are exactly those of `zipperJoinWithUndef`.
+  static void hashMultiColumnJoin(
+      const IdTable& left, const IdTable& right,
+      const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
+      IdTable* result, size_t numThreads = 1);
+
  private:
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 
@@ -0,0 +1,286 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/MultiPredicateScan.h"
+
+#include <absl/strings/str_join.h>
+
+#include <algorithm>
+#include <numeric>
+
+#include "engine/IndexScan.h"
+#include "global/Constants.h"
+#include "util/Exception.h"
+#include "util/ParallelMultiwayMerge.h"
+
+// _____________________________________________________________________________
+MultiPredicateScan::MultiPredicateScan(
+    QueryExecutionContext* qec, Permutation::Enum permutation,
+    const SparqlTriple& triple, std::optional<Variable> predicateVariable)
+    : Operation{qec},
+      permutation_{permutation},
+      subject_{triple._s},
+      object_{triple._o},
+      predicateVariable_{std::move(predicateVariable)} {
+  auto permutations = applicablePermutations(triple);
+  AD_CONTRACT_CHECK(std::ranges::find(permutations, permutation_) !=
+                    permutations.end());
+  for (const auto& child : triple._p._children) {
+    predicates_.push_back(child._iri);
+    scans_.push_back(ad_utility::makeExecutionTree<IndexScan>(
+        qec, permutation_, SparqlTriple{subject_, child._iri, object_}));
+  }
+}
+
+// _____________________________________________________________________________
+std::vector<Permutation::Enum> MultiPredicateScan::applicablePermutations(
+    const SparqlTriple& triple) {
+  const auto& path = triple._p;
+  if (path._operation != PropertyPath::Operation::ALTERNATIVE ||
+      path._children.size() < 2) {
+    return {};
+  }
+  for (const auto& child : path._children) {
+    // A `ql:has-predicate` triple is not read from a permutation (see
+    // `HasPredicateScan`).
+    if (child._operation != PropertyPath::Operation::IRI ||
+        child._iri.starts_with("?") || child._iri == HAS_PREDICATE_PREDICATE) {
+      return {};
+    }
+  }
+  if (triple._s.isVariable() && triple._s == triple._o) {
+    return {};
+  }
+  std::vector<Permutation::Enum> permutations;
+  if (triple._o.isVariable()) {
+    permutations.push_back(Permutation::PSO);
+  }
+  if (triple._s.isVariable()) {
+    permutations.push_back(Permutation::POS);
+  }
+  return permutations;
+}
+
+// _____________________________________________________________________________
+string MultiPredicateScan::getCacheKeyImpl() const {
+  std::ostringstream os;
+  os << "MULTI PREDICATE SCAN " << Permutation::toString(permutation_);
+  if (predicateVariable_.has_value()) {
+    os << " with predicate column";
+  }
+  os << "\n";
+  for (const auto& scan : scans_) {
+    os << scan->getCacheKey() << "\n";
+  }
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string MultiPredicateScan::getDescriptor() const {
+  return "MultiPredicateScan " + subject_.toString() + " " +
+         absl::StrJoin(predicates_, "|") + " " + object_.toString();
+}
+
+// _____________________________________________________________________________
+size_t MultiPredicateScan::getResultWidth() const {
+  return scans_.at(0)->getResultWidth() +
+         static_cast<size_t>(predicateVariable_.has_value());
+}
+
+// _____________________________________________________________________________
+vector<ColumnIndex> MultiPredicateScan::resultSortedOn() const {
+  // The merged result is sorted on all the columns of the scans, but not on
+  // the predicate column.
+  return scans_.at(0)->resultSortedOn();
+}
+
+// _____________________________________________________________________________
+VariableToColumnMap MultiPredicateScan::computeVariableToColumnMap() const {
+  VariableToColumnMap variableToColumnMap = scans_.at(0)->getVariableColumns();
+  if (predicateVariable_.has_value()) {
+    variableToColumnMap[predicateVariable_.value()] =
+        makeAlwaysDefinedColumn(scans_.at(0)->getResultWidth());
+  }
+  return variableToColumnMap;
+}
+
+// _____________________________________________________________________________
+bool MultiPredicateScan::knownEmptyResult() {
+  return std::ranges::all_of(
+      scans_, [](const auto& scan) { return scan->knownEmptyResult(); });
+}
+
+// _____________________________________________________________________________
+float MultiPredicateScan::getMultiplicity(size_t col) {
+  double size = std::max(1.0, static_cast<double>(getSizeEstimate()));
+  if (col == scans_.at(0)->getResultWidth()) {
+    // The predicate column.
+    return static_cast<float>(
+        std::max(1.0, size / static_cast<double>(predicates_.size())));
+  }
+  // Assume that the distinct values of the scans are disjoint.
+  double numDistinct = 0;
+  for (const auto& scan : scans_) {
+    numDistinct +=
+        static_cast<double>(scan->getSizeEstimate()) /
+        static_cast<double>(std::max(1.0f, scan->getMultiplicity(col)));
+  }
+  return static_cast<float>(std::max(1.0, size / std::max(1.0, numDistinct)));
+}
+
+// _____________________________________________________________________________
+uint64_t MultiPredicateScan::getSizeEstimateBeforeLimit() {
+  uint64_t size = 0;
+  for (const auto& scan : scans_) {
+    size += scan->getSizeEstimate();
+  }
+  return size;
+}
+
+// _____________________________________________________________________________
+size_t MultiPredicateScan::getCostEstimate() {
+  // The scans plus the merging, which (unlike a `Union` of the scans that is
+  // then sorted) is linear in the size of the result.
+  size_t cost = getSizeEstimateBeforeLimit();
+  for (const auto& scan : scans_) {
+    cost += scan->getCostEstimate();
+  }
+  return cost;
+}
+
+// _____________________________________________________________________________
+vector<QueryExecutionTree*> MultiPredicateScan::getChildren() {
+  vector<QueryExecutionTree*> children;
+  for (const auto& scan : scans_) {
+    children.push_back(scan.get());
+  }
+  return children;
+}
+
+// _____________________________________________________________________________
+ResultTable MultiPredicateScan::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
+  auto results = getChildResults(scans_);
+  std::vector<const IdTable*> inputs;
+  std::vector<Id> predicateIds;
+  size_t numRows = 0;
+  const auto& vocab = getIndex().getVocab();
+  for (size_t i = 0; i < results.size(); ++i) {
+    inputs.push_back(&results[i]->idTable());
+    numRows += inputs.back()->numRows();
+    // A predicate that is not contained in the vocabulary has no triples, so
+    // its ID is never written.
+    predicateIds.push_back(TripleComponent{predicates_[i]}
+                               .toValueId(vocab)
+                               .value_or(Id::makeUndefined()));
+  }
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  result.resize(numRows);
+  merge(inputs, predicateIds, result);
+  return {std::move(result), resultSortedOn(), LocalVocab{}};
+}
+
+// _____________________________________________________________________________
+void MultiPredicateScan::merge(const std::vector<const IdTable*>& inputs,
+                               const std::vector<Id>& predicateIds,
+                               IdTable& result) const {
+  const size_t numScanColumns = scans_.at(0)->getResultWidth();
+  auto writeRow = [&](size_t outputRow, size_t input, size_t row) {
+    const IdTable& table = *inputs[input];
+    for (size_t col = 0; col < numScanColumns; ++col) {
+      result(outputRow, col) = table(row, col);
+    }
+    if (predicateVariable_.has_value()) {
+      result(outputRow, numScanColumns) = predicateIds[input];
+    }
+  };
+  // Return true iff the row `rowA` of the `inputs[a]` is smaller than the row
+  // `rowB` of the `inputs[b]`.
+  auto isSmaller = [&inputs, numScanColumns](size_t a, size_t rowA, size_t b,
+                                             size_t rowB) {
+    for (size_t col = 0; col < numScanColumns; ++col) {
+      Id idA = (*inputs[a])(rowA, col);
+      Id idB = (*inputs[b])(rowB, col);
+      if (idA != idB) {
+        return idA < idB;
+      }
+    }
+    return false;
+  };
+
+  bool mergeInParallel =
+      result.numRows() >=
+      RuntimeParameters()
+          .get<"multi-predicate-scan-min-size-for-parallel-merge">();
+  runtimeInfo().addDetail("num-predicates", predicates_.size());
+  runtimeInfo().addDetail("parallel-merge", mergeInParallel);
+
+  if (!mergeInParallel) {
+    // A k-way merge with a min-heap of the indices of the inputs, ordered by
+    // their current rows.
+    std::vector<size_t> positions(inputs.size(), 0);
+    auto heapOrder = [&positions, &isSmaller](size_t a, size_t b) {
+      return isSmaller(b, positions[b], a, positions[a]);
+    };
+    std::vector<size_t> heap;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (!inputs[i]->empty()) {
+        heap.push_back(i);
+      }
+    }
+    std::ranges::make_heap(heap, heapOrder);
+    for (size_t outputRow = 0; !heap.empty(); ++outputRow) {
+      if (outputRow % 100'000 == 0) {
+        checkCancellation();
+      }
+      std::ranges::pop_heap(heap, heapOrder);
+      size_t input = heap.back();
+      writeRow(outputRow, input, positions[input]);
+      if (++positions[input] < inputs[input]->numRows()) {
+        std::ranges::push_heap(heap, heapOrder);
+      } else {
+        heap.pop_back();
+      }
+    }
+    return;
+  }
+
+  // The elements that are merged are the positions of the rows of the inputs,
+  // with the index of the input in the upper bits.
+  static constexpr size_t inputShift = 48;
+  AD_CORRECTNESS_CHECK(inputs.size() < (size_t{1} << (64 - inputShift)));
+  auto decode = [](uint64_t position) {
+    return std::pair{position >> inputShift,
+                     position & ((uint64_t{1} << inputShift) - 1)};
+  };
+  using Allocator =
+      std::allocator_traits<IdTable::Allocator>::rebind_alloc<uint64_t>;
+  std::vector<uint64_t, Allocator> positions{
+      Allocator{getExecutionContext()->getAllocator()}};
+  positions.reserve(result.numRows());
+  std::vector<std::span<const uint64_t>> ranges;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    size_t begin = positions.size();
+    for (size_t row = 0; row < inputs[i]->numRows(); ++row) {
+      positions.push_back((uint64_t{i} << inputShift) | row);
+    }
+    ranges.emplace_back(positions.begin() + begin, positions.end());
+  }
+  auto comparePositions = [&isSmaller, &decode](const uint64_t& a,
+                                                const uint64_t& b) -> bool {
+    auto [inputA, rowA] = decode(a);
+    auto [inputB, rowB] = decode(b);
+    return isSmaller(inputA, rowA, inputB, rowB);
+  };
+  size_t outputRow = 0;
+  for (const auto& block : ad_utility::parallelMultiwayMerge<uint64_t, false>(
+           ad_utility::MemorySize::max(), ranges, comparePositions, 10'000)) {
+    checkCancellation();
+    for (uint64_t position : block) {
+      auto [input, row] = decode(position);
+      writeRow(outputRow, input, row);
+      ++outputRow;
+    }
+  }
+  AD_CORRECTNESS_CHECK(outputRow == result.numRows());
+}
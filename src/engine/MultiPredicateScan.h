@@ -0,0 +1,88 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "engine/Operation.h"
+#include "engine/QueryExecutionTree.h"
+#include "parser/ParsedQuery.h"
+
+// A scan for a triple the predicate of which is an alternative of IRIs, for
+// example `?x (<p>|<q>|<r>) ?y`. The `IndexScan`s of the single predicates (the
+// children) all use the same permutation (PSO or POS), s.t. each of their
+// results is sorted on all its columns, and the results are merged into one
+// result that is sorted in the same way. Unlike the result of a `Union` of the
+// scans, the result can thus be joined without sorting it first, like the
+// result of a single `IndexScan`. Optionally, the predicate of each row is
+// bound to a variable in an additional last column.
+class MultiPredicateScan : public Operation {
+ private:
+  Permutation::Enum permutation_;
+  TripleComponent subject_;
+  std::vector<std::string> predicates_;
+  TripleComponent object_;
+  std::optional<Variable> predicateVariable_;
+  std::vector<std::shared_ptr<QueryExecutionTree>> scans_;
+
+ public:
+  // The `permutation` must be one of the `applicablePermutations(triple)`.
+  MultiPredicateScan(QueryExecutionContext* qec, Permutation::Enum permutation,
+                     const SparqlTriple& triple,
+                     std::optional<Variable> predicateVariable = std::nullopt);
+
+  // Return the permutations with which the `triple` can be read by a
+  // `MultiPredicateScan`: PSO if the object is a variable, and POS if the
+  // subject is a variable. Return no permutation if the predicate is not an
+  // alternative of at least two IRIs, or if the subject and the object are
+  // the same variable.
+  static std::vector<Permutation::Enum> applicablePermutations(
+      const SparqlTriple& triple);
+
+  Permutation::Enum permutation() const { return permutation_; }
+  const std::vector<std::string>& predicates() const { return predicates_; }
+
+ protected:
+  string getCacheKeyImpl() const override;
+
+ public:
+  string getDescriptor() const override;
+
+  size_t getResultWidth() const override;
+
+  vector<ColumnIndex> resultSortedOn() const override;
+
+  void setTextLimit(size_t) override {
+    // Do nothing.
+  }
+
+  bool knownEmptyResult() override;
+
+  float getMultiplicity(size_t col) override;
+
+ private:
+  uint64_t getSizeEstimateBeforeLimit() override;
+
+ public:
+  size_t getCostEstimate() override;
+
+  vector<QueryExecutionTree*> getChildren() override;
+
+ private:
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
+
+  VariableToColumnMap computeVariableToColumnMap() const override;
+
+  // Merge the `inputs` (the results of the `scans_`, which are sorted on all
+  // their columns) into the `result`, which must already have as many rows as
+  // all the inputs together. If the `predicateVariable_` is set, the
+  // `predicateIds[k]` is written to the last column of the rows of the
+  // `inputs[k]`. Large inputs are merged on several threads via
+  // `ad_utility::parallelMultiwayMerge`.
+  void merge(const std::vector<const IdTable*>& inputs,
+             const std::vector<Id>& predicateIds, IdTable& result) const;
+};
@@ -41,7 +41,7 @@ class NeutralElementOperation : public Operation {
   };
 
  private:
-  ResultTable computeResult() override {
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override {
     IdTable idTable{getExecutionContext()->getAllocator()};
     idTable.setNumColumns(0);
     idTable.resize(1);
@@ -4,8 +4,14 @@
 
 #include "engine/Operation.h"
 
+#include "engine/ExternalSort.h"
 #include "engine/QueryExecutionTree.h"
+#include "engine/QueryRuntimeEstimator.h"
+#include "util/HashSet.h"
 #include "util/OnDestructionDontThrowDuringStackUnwinding.h"
+#include "util/ParallelExecution.h"
+#include "util/Probes.h"
+#include "util/QueryTrace.h"
 #include "util/TransparentFunctors.h"
 
 using namespace std::chrono_literals;
@@ -69,10 +75,116 @@ void Operation::recursivelySetTimeConstraint(
   });
 }
 
+// _____________________________________________________________________________
+void Operation::recordCardinalityFeedback(const ResultTable& result) {
+  auto& feedback = getCardinalityFeedback();
+  // Operations that directly compute the `LIMIT` don't know the size of their
+  // complete result.
+  bool hasLimit = _limit._limit.has_value() || _limit._offset != 0;
+  if (!feedback.isEnabled() || (supportsLimit() && hasLimit)) {
+    return;
+  }
+  auto estimate = getCardinalityFeedbackEstimate();
+  if (estimate.has_value()) {
+    feedback.record(estimate->signature_, estimate->uncorrectedSizeEstimate_,
+                    static_cast<double>(result.idTable().numRows()));
+  }
+}
+
+// _____________________________________________________________________________
+std::optional<CacheValue> Operation::getResultFromCachedSuperset() {
+  auto& cache = _executionContext->getQueryTreeCache();
+  // Mark the runtime information of the `cached` result s.t. it is visible
+  // that the result was computed for a different cache key.
+  auto getRuntimeInfo = [](const auto& cached) {
+    RuntimeInformation runtimeInfo = cached._resultPointer->runtimeInfo();
+    runtimeInfo.addDetail("reused-cached-result-of", runtimeInfo.descriptor_);
+    return runtimeInfo;
+  };
+  // A result that is registered under the partial key of this operation (with
+  // the same `LIMIT` and `OFFSET`) can be used as is.
+  auto partialKey = getPartialCacheKeyForLookup();
+  if (partialKey.has_value()) {
+    if (auto cached = cache.getIfContainedPartially(partialKey.value())) {
+      return cached->_resultPointer->shareResult(
+          getRuntimeInfo(cached.value()));
+    }
+  }
+
+  // Otherwise, the `LIMIT` and `OFFSET` can be applied to the unlimited
+  // result.
+  if (!_limit._limit.has_value() && _limit._offset == 0) {
+    return std::nullopt;
+  }
+  auto cached = cache.getIfContained(getCacheKeyImpl());
+  if (!cached.has_value()) {
+    auto unlimitedPartialKey = getPartialCacheKeyForLookupImpl();
+    if (unlimitedPartialKey.has_value()) {
+      cached = cache.getIfContainedPartially(unlimitedPartialKey.value());
+    }
+  }
+  if (!cached.has_value()) {
+    return std::nullopt;
+  }
+  auto unlimitedPointer = cached->_resultPointer->resultTable();
+  const ResultTable& unlimited = *unlimitedPointer;
+  const IdTable& input = unlimited.idTable();
+  IdTable idTable{input.numColumns(), getExecutionContext()->getAllocator()};
+  idTable.insertAtEnd(input.begin() + _limit.actualOffset(input.numRows()),
+                      input.begin() + _limit.upperBound(input.numRows()));
+  auto runtimeInfo = getRuntimeInfo(cached.value());
+  runtimeInfo.addLimitOffsetRow(_limit, 0ms, false);
+  return CacheValue{ResultTable{std::move(idTable), unlimited.sortedBy(),
+                                unlimited.getSharedLocalVocab()},
+                    std::move(runtimeInfo)};
+}
+
 // ________________________________________________________________________
-shared_ptr<const ResultTable> Operation::getResult(bool isRoot,
-                                                   bool onlyReadFromCache) {
+shared_ptr<const ResultTable> Operation::getResult(
+    bool isRoot, ComputationMode computationMode) {
+  if (sharedResult_ == nullptr || isRoot) {
+    return getResultFromCacheOrCompute(isRoot, computationMode);
+  }
+  std::lock_guard lock{sharedResult_->mutex_};
+  auto& shared = *sharedResult_;
+  const bool onlyReadFromCache =
+      computationMode == ComputationMode::ONLY_IF_CACHED;
+  if (shared.result_ != nullptr) {
+    auto result = shared.result_;
+    if (!onlyReadFromCache) {
+      using enum ad_utility::CacheStatus;
+      updateRuntimeInformationOnSuccess(*result, cachedNotPinned,
+                                        Milliseconds::zero(),
+                                        shared.runtimeInfo_);
+      runtimeInfo().addDetail("shared-with-identical-subtree", true);
+      if (--shared.numRemainingUses_ == 0) {
+        shared.result_.reset();
+        shared.runtimeInfo_.reset();
+      }
+    }
+    return result;
+  }
+  if (onlyReadFromCache) {
+    return getResultFromCacheOrCompute(false, computationMode);
+  }
+  // The first request computes the result, which has to be fully materialized
+  // to be shared. The same tree might be executed again (e.g. in tests).
+  auto result =
+      getResultFromCacheOrCompute(false, ComputationMode::FULLY_MATERIALIZED);
+  shared.numRemainingUses_ = shared.numUses_ - 1;
+  if (shared.numRemainingUses_ > 0) {
+    shared.result_ = result;
+    shared.runtimeInfo_ = runtimeInfo();
+  }
+  return result;
+}
+
+// ______________________________________________________________________
+shared_ptr<const ResultTable> Operation::getResultFromCacheOrCompute(
+    bool isRoot, ComputationMode computationMode) {
   ad_utility::Timer timer{ad_utility::Timer::Started};
+  const bool onlyReadFromCache =
+      computationMode == ComputationMode::ONLY_IF_CACHED;
 
   if (isRoot) {
     // Reset runtime info, tests may re-use Operation objects.
@@ -81,12 +193,32 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot,
     createRuntimeInfoFromEstimates(getRuntimeInfoPointer());
     signalQueryUpdate();
   }
+  // If the query is traced, record a span for this operation (the spans of the
+  // children and of the lazy blocks become its children).
+  ad_utility::QueryTrace::Scope traceScope{_executionContext->getTrace()};
+  std::optional<ad_utility::QueryTrace::ScopedSpan> traceSpan;
+  if (_executionContext->getTrace() != nullptr) {
+    traceSpan.emplace(getDescriptor(), "operation");
+  }
+  // Count the resources that are used for the computation of this operation
+  // (the children install their own statistics, see `OperationStatistics`).
+  auto statistics = std::make_shared<ad_utility::OperationStatistics>();
+  ad_utility::OperationStatistics::Scope statisticsScope{statistics.get()};
   auto& cache = _executionContext->getQueryTreeCache();
   const string cacheKey = getCacheKey();
+  QLEVER_PROBE(operation_start, getDescriptor().c_str(),
+               ad_utility::probes::hashOfCacheKey(cacheKey));
+  // The `QueryHints` of the query might forbid to read the cache (`Bypass`) or
+  // to store new results in it (`NoStore`, and also `Bypass`).
+  using CacheMode = QueryHints::CacheMode;
+  const CacheMode cacheMode = _executionContext->getQueryHints().cacheMode_;
+  const bool readFromCache = cacheMode != CacheMode::Bypass;
+  // Results are only pinned if they may be stored in the cache.
+  const bool mayPin = cacheMode == CacheMode::Default;
   const bool pinFinalResultButNotSubtrees =
-      _executionContext->_pinResult && isRoot;
-  const bool pinResult =
-      _executionContext->_pinSubtrees || pinFinalResultButNotSubtrees;
+      mayPin && _executionContext->_pinResult && isRoot;
+  const bool pinResult = (mayPin && _executionContext->_pinSubtrees) ||
+                         pinFinalResultButNotSubtrees;
 
   // When we pin the final result but no subtrees, we need to remember the sizes
   // of all involved index scans that have only one free variable. Note that
@@ -116,16 +248,100 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot,
     // an exception.
     auto onDestruction =
         ad_utility::makeOnDestructionDontThrowDuringStackUnwinding(
-            [this, &timer]() {
+            [this, &timer, &cacheKey]() {
               if (std::uncaught_exceptions()) {
                 updateRuntimeInformationOnFailure(timer.msecs());
+                QLEVER_PROBE(operation_failed, getDescriptor().c_str(),
+                             ad_utility::probes::hashOfCacheKey(cacheKey),
+                             timer.msecs().count());
               }
             });
-    auto computeLambda = [this, &timer] {
+    // The persistent second tier of the cache (if it exists). Results that
+    // are contained in it are read by the `computeLambda` below and are
+    // treated as cached results.
+    PersistentResultCache* persistentCache =
+        readFromCache ? cache.persistentCache() : nullptr;
+    const bool isInMemoryCache = readFromCache && cache.cacheContains(cacheKey);
+    const bool isInPersistentCache =
+        persistentCache != nullptr && persistentCache->contains(cacheKey);
+    // If the result is not cached under its own key, it might still be
+    // obtained from a cached result for a different key (see
+    // `getResultFromCachedSuperset`). Such results are also treated as cached.
+    std::optional<CacheValue> resultFromSuperset;
+    if (readFromCache && !isInMemoryCache && !isInPersistentCache) {
+      resultFromSuperset = getResultFromCachedSuperset();
+    }
+    bool wasReadFromCache = false;
+    // A lazy result is only computed if it is not already contained in the
+    // cache and if it doesn't have to be pinned, because lazy results are only
+    // written to the cache after they have been consumed. If an operation
+    // doesn't support lazy results, the fully materialized result that it
+    // returns is stored in the cache as usual (see `computeLambda` below).
+    std::optional<ResultTable> precomputedResult;
+    if (computationMode == ComputationMode::LAZY_IF_SUPPORTED && !pinResult &&
+        !isInMemoryCache && !isInPersistentCache &&
+        !resultFromSuperset.has_value()) {
+      checkCancellation([this]() { return "Before " + getDescriptor(); });
+      checkEstimatedRuntime();
+      runtimeInfo().status_ = RuntimeInformation::Status::inProgress;
+      signalQueryUpdate();
+      ResultTable result = computeResult(true);
+      if (!result.isFullyMaterialized()) {
+        // The LIMIT and OFFSET are applied lazily, block by block.
+        if (!supportsLimit()) {
+          result.applyLimitOffset(_limit);
+        }
+        auto lazyResult = wrapLazyResultForRuntimeInformation(
+            std::move(result), std::move(statistics));
+        if (cacheMode == CacheMode::Default &&
+            RuntimeParameters().get<"cache-lazy-results">()) {
+          lazyResult = wrapLazyResultForCache(std::move(lazyResult), cacheKey);
+        }
+        updateRuntimeInformationOnSuccess(lazyResult,
+                                          ad_utility::CacheStatus::computed,
+                                          timer.msecs(), std::nullopt);
+        if (!supportsLimit()) {
+          runtimeInfo().addLimitOffsetRow(_limit, 0ms, true);
+        }
+        if (traceSpan.has_value()) {
+          traceSpan->addAttribute("cache-status", "lazily computed");
+        }
+        QLEVER_PROBE(operation_end, getDescriptor().c_str(),
+                     ad_utility::probes::hashOfCacheKey(cacheKey),
+                     static_cast<int>(ad_utility::CacheStatus::computed),
+                     size_t{0}, timer.msecs().count());
+        return std::make_shared<const ResultTable>(std::move(lazyResult));
+      }
+      precomputedResult = std::move(result);
+    }
+
+    std::shared_ptr<const ResultTable> computedResult;
+    auto computeLambda = [this, &timer, &precomputedResult, &persistentCache,
+                          &cacheKey, &resultFromSuperset, &wasReadFromCache,
+                          &computedResult, &statistics] {
       checkCancellation([this]() { return "Before " + getDescriptor(); });
+      if (resultFromSuperset.has_value()) {
+        wasReadFromCache = true;
+        return std::move(resultFromSuperset.value());
+      }
+      if (persistentCache != nullptr && !precomputedResult.has_value()) {
+        auto storedResult = persistentCache->read(
+            cacheKey, getExecutionContext()->getAllocator());
+        if (storedResult.has_value()) {
+          wasReadFromCache = true;
+          return CacheValue{std::move(storedResult->first),
+                            std::move(storedResult->second)};
+        }
+      }
+      if (!precomputedResult.has_value()) {
+        checkEstimatedRuntime();
+      }
       runtimeInfo().status_ = RuntimeInformation::Status::inProgress;
       signalQueryUpdate();
-      ResultTable result = computeResult();
+      ResultTable result = precomputedResult.has_value()
+                               ? std::move(precomputedResult.value())
+                               : computeResultForCache();
+      AD_CORRECTNESS_CHECK(result.isFullyMaterialized());
 
       checkCancellation([this]() { return "After " + getDescriptor(); });
       // Compute the datatypes that occur in each column of the result.
@@ -137,6 +353,7 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot,
       // change in the DEBUG builds.
       AD_EXPENSIVE_CHECK(
           result.checkDefinedness(getExternallyVisibleVariableColumns()));
+      recordCardinalityFeedback(result);
       // Make sure that the results that are written to the cache have the
       // correct runtimeInfo. The children of the runtime info are already set
       // correctly because the result was computed, so we can pass `nullopt` as
@@ -144,6 +361,7 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot,
       updateRuntimeInformationOnSuccess(result,
                                         ad_utility::CacheStatus::computed,
                                         timer.msecs(), std::nullopt);
+      addStatisticsToRuntimeInformation(*statistics);
       // Apply LIMIT and OFFSET, but only if the call to `computeResult` did not
       // already perform it. An example for an operation that directly computes
       // the Limit is a full index scan with three variables.
@@ -157,25 +375,81 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot,
         AD_CONTRACT_CHECK(result.idTable().numRows() ==
                           _limit.actualSize(result.idTable().numRows()));
       }
+      if (RuntimeParameters().get<"compress-cached-results">()) {
+        // The `CacheValue` doesn't keep the uncompressed result alive, so it
+        // is stored in `computedResult` until it is returned below.
+        computedResult = std::make_shared<const ResultTable>(std::move(result));
+        return CacheValue::makeCompressed(computedResult, runtimeInfo());
+      }
       return CacheValue{std::move(result), runtimeInfo()};
     };
 
-    auto result = (pinResult) ? cache.computeOncePinned(cacheKey, computeLambda,
-                                                        onlyReadFromCache)
-                              : cache.computeOnce(cacheKey, computeLambda,
-                                                  onlyReadFromCache);
+    const bool onlyReadFromMemoryCache =
+        onlyReadFromCache && !isInPersistentCache &&
+        !resultFromSuperset.has_value();
+    // Unless the result is already contained in the (in-memory) cache, it is
+    // computed without storing it if the `QueryHints` don't allow this.
+    const bool storeInCache =
+        cacheMode == CacheMode::Default ||
+        (cacheMode == CacheMode::NoStore && isInMemoryCache);
+    QueryResultCache::ResultAndCacheStatus result;
+    if (!storeInCache) {
+      if (onlyReadFromMemoryCache) {
+        return nullptr;
+      }
+      result = {std::make_shared<const CacheValue>(computeLambda()),
+                ad_utility::CacheStatus::computed};
+    } else {
+      result = (pinResult) ? cache.computeOncePinned(cacheKey, computeLambda,
+                                                     onlyReadFromMemoryCache)
+                           : cache.computeOnce(cacheKey, computeLambda,
+                                               onlyReadFromMemoryCache);
+    }
 
     if (result._resultPointer == nullptr) {
       AD_CORRECTNESS_CHECK(onlyReadFromCache);
       return nullptr;
     }
+    if (storeInCache) {
+      cache.registerPartialKeys(cacheKey, getPartialCacheKeys());
+    }
+    if (wasReadFromCache) {
+      using enum ad_utility::CacheStatus;
+      result._cacheStatus = pinResult ? cachedPinned : cachedNotPinned;
+    } else if (pinResult && persistentCache != nullptr &&
+               result._cacheStatus != ad_utility::CacheStatus::cachedPinned) {
+      // Pinned results are never evicted, so they are written to the
+      // persistent cache as soon as they are pinned to survive a restart.
+      persistentCache->writeInBackground(
+          cacheKey, result._resultPointer->resultTable(),
+          result._resultPointer->runtimeInfo());
+    }
 
+    cache.countLookup(result._cacheStatus !=
+                      ad_utility::CacheStatus::computed);
+    QLEVER_PROBE(cache_lookup, ad_utility::probes::hashOfCacheKey(cacheKey),
+                 static_cast<int>(result._cacheStatus));
+    // For a compressed cache entry, this decompresses the result (unless it
+    // was just computed and is thus still contained in `computedResult`).
+    auto resultTable = result._resultPointer->resultTable();
     updateRuntimeInformationOnSuccess(result, timer.msecs());
-    auto resultNumRows = result._resultPointer->resultTable()->size();
-    auto resultNumCols = result._resultPointer->resultTable()->width();
+    if (result._resultPointer->isCompressed()) {
+      runtimeInfo().addDetail("compressed-in-cache", true);
+    }
+    auto resultNumRows = resultTable->size();
+    auto resultNumCols = resultTable->width();
+    if (traceSpan.has_value()) {
+      traceSpan->addAttribute("cache-status",
+                              std::string{toString(result._cacheStatus)});
+      traceSpan->addAttribute("num-rows", std::to_string(resultNumRows));
+    }
     LOG(DEBUG) << "Computed result of size " << resultNumRows << " x "
                << resultNumCols << std::endl;
-    return result._resultPointer->resultTable();
+    QLEVER_PROBE(operation_end, getDescriptor().c_str(),
+                 ad_utility::probes::hashOfCacheKey(cacheKey),
+                 static_cast<int>(result._cacheStatus), resultNumRows,
+                 timer.msecs().count());
+    return resultTable;
   } catch (const ad_utility::AbortException& e) {
     // A child Operation was aborted, do not print the information again.
     runtimeInfo().status_ =
@@ -208,6 +482,208 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot,
   }
 }
 
+// ______________________________________________________________________
+shared_ptr<const ResultTable> Operation::getResultWithSemiJoinFilter(
+    const Variable& variable, std::span<const Id> values) {
+  // The reduction can't be combined with a `LIMIT` or `OFFSET`, which refer to
+  // the complete result. A cached or shared complete result is used as it is.
+  if (_limit._limit.has_value() || _limit._offset != 0 ||
+      sharedResult_ != nullptr ||
+      _executionContext->getQueryTreeCache().cacheContains(getCacheKey())) {
+    return nullptr;
+  }
+  ad_utility::Timer timer{ad_utility::Timer::Started};
+  checkCancellation([this]() { return "Before " + getDescriptor(); });
+  auto result = computeResultWithSemiJoinFilter(variable, values);
+  if (!result.has_value()) {
+    return nullptr;
+  }
+  AD_CORRECTNESS_CHECK(result->isFullyMaterialized());
+  checkCancellation([this]() { return "After " + getDescriptor(); });
+  updateRuntimeInformationOnSuccess(result.value(),
+                                    ad_utility::CacheStatus::computed,
+                                    timer.msecs(), std::nullopt);
+  runtimeInfo().addDetail("semi-join-filter-size", values.size());
+  return std::make_shared<const ResultTable>(std::move(result).value());
+}
+
+// _____________________________________________________________________________
+ResultTable Operation::computeResultForCache() {
+  if (supportsLimit() || !_limit._limit.has_value()) {
+    return computeResult(false);
+  }
+  ResultTable result = computeResult(true);
+  if (result.isFullyMaterialized()) {
+    return result;
+  }
+  LimitOffsetClause firstRows;
+  firstRows._limit = _limit.upperBound(std::numeric_limits<uint64_t>::max());
+  result.applyLimitOffset(firstRows);
+  LocalVocab localVocab;
+  IdTable idTable{getResultWidth(), getExecutionContext()->getAllocator()};
+  for (auto& [block, blockVocab] : result.idTables()) {
+    ad_utility::externalSort::mergeLocalVocabInto(block, blockVocab,
+                                                  localVocab);
+    idTable.insertAtEnd(block);
+    checkCancellation();
+  }
+  runtimeInfo().addDetail("materialized-lazily-up-to-limit", true);
+  return {std::move(idTable), result.sortedBy(), std::move(localVocab)};
+}
+
+// ______________________________________________________________________
+ResultTable Operation::wrapLazyResultForRuntimeInformation(
+    ResultTable result,
+    std::shared_ptr<ad_utility::OperationStatistics> statistics) {
+  AD_CONTRACT_CHECK(!result.isFullyMaterialized());
+  auto sortedBy = result.sortedBy();
+  auto wrapper =
+      [](ResultTable::Generator generator, Operation* self,
+         ad_utility::QueryTrace::Context traceContext,
+         std::shared_ptr<ad_utility::OperationStatistics> statistics)
+      -> ResultTable::Generator {
+    // Only measure the time that is spent when computing the next block, but
+    // not the time that the consumer spends between two blocks. The runtime
+    // information is updated after each block, because the consumer might stop
+    // early (for example because of a LIMIT during the export).
+    ad_utility::Timer timer{ad_utility::Timer::Started};
+    auto& runtimeInfo = self->runtimeInfo();
+    auto timeBeforeFirstBlock = runtimeInfo.totalTime_;
+    size_t numBlocks = 0;
+    // If the query is traced, each block gets its own span as a child of the
+    // span of the operation.
+    auto beginOfBlock = ad_utility::QueryTrace::Clock::now();
+    // The `statistics` are only installed while the next block is computed,
+    // because the consumer runs with its own statistics between the blocks.
+    auto withStatistics = [&statistics](auto function) {
+      ad_utility::OperationStatistics::Scope scope{statistics.get()};
+      return function();
+    };
+    auto it = withStatistics([&generator]() { return generator.begin(); });
+    while (it != generator.end()) {
+      ResultTable::IdTableVocabPair& pair = *it;
+      timer.stop();
+      AD_EXPENSIVE_CHECK(ResultTable::checkDefinednessOfBlock(
+          pair.idTable_, self->getExternallyVisibleVariableColumns()));
+      runtimeInfo.numRows_ += pair.idTable_.numRows();
+      runtimeInfo.totalTime_ = timeBeforeFirstBlock + timer.msecs();
+      runtimeInfo.addDetail("num-blocks-of-lazy-result", ++numBlocks);
+      self->addStatisticsToRuntimeInformation(*statistics);
+      if (traceContext.trace_ != nullptr) {
+        traceContext.trace_->addSpan(
+            absl::StrCat("block of ", self->getDescriptor()), "lazy-block",
+            beginOfBlock, traceContext.spanId_,
+            {{"num-rows", std::to_string(pair.idTable_.numRows())}});
+      }
+      co_yield pair;
+      timer.cont();
+      beginOfBlock = ad_utility::QueryTrace::Clock::now();
+      withStatistics([&it]() { ++it; });
+    }
+    timer.stop();
+    runtimeInfo.totalTime_ = timeBeforeFirstBlock + timer.msecs();
+    self->addStatisticsToRuntimeInformation(*statistics);
+    self->signalQueryUpdate();
+  };
+  return ResultTable{wrapper(std::move(result.idTables()), this,
+                             ad_utility::QueryTrace::currentContext(),
+                             std::move(statistics)),
+                     std::move(sortedBy)};
+}
+
+// _____________________________________________________________________________
+void Operation::addStatisticsToRuntimeInformation(
+    const ad_utility::OperationStatistics& statistics) {
+  auto& info = runtimeInfo();
+  auto addIfNonZero = [&info](const std::string& key, uint64_t value) {
+    if (value != 0) {
+      info.addDetail(key, value);
+    }
+  };
+  addIfNonZero("bytes-read-from-index", statistics.numBytesRead());
+  addIfNonZero("num-blocks-read-from-index", statistics.numBlocksRead());
+  addIfNonZero("num-blocks-skipped-in-index", statistics.numBlocksSkipped());
+  addIfNonZero("num-vocabulary-lookups", statistics.numVocabularyLookups());
+  addIfNonZero("peak-memory-bytes", statistics.peakMemory());
+  auto decompressionTime = statistics.decompressionTime();
+  if (decompressionTime.count() != 0) {
+    info.addDetail("time-decompression",
+                   std::chrono::duration_cast<std::chrono::milliseconds>(
+                       decompressionTime));
+  }
+  if (size_t numThreads = statistics.numThreads(); numThreads > 1) {
+    info.addDetail("num-threads", numThreads);
+  }
+}
+
+// _____________________________________________________________________________
+ResultTable Operation::wrapLazyResultForCache(ResultTable result,
+                                              std::string cacheKey) {
+  AD_CONTRACT_CHECK(!result.isFullyMaterialized());
+  auto sortedBy = result.sortedBy();
+  auto wrapper = [](ResultTable::Generator generator, Operation* self,
+                    std::string cacheKey, std::vector<ColumnIndex> sortedBy)
+      -> ResultTable::Generator {
+    using namespace ad_utility::externalSort;
+    const auto maxSize =
+        RuntimeParameters().get<"cache-max-size-single-entry">();
+    std::optional<IdTable> collected;
+    collected.emplace(self->getResultWidth(),
+                      self->getExecutionContext()->getAllocator());
+    LocalVocab localVocab;
+    for (ResultTable::IdTableVocabPair& pair : generator) {
+      if (!collected.has_value()) {
+        // The result is too large for the cache, the blocks are only passed
+        // through.
+      } else if (getMemorySize(collected.value()) +
+                     getMemorySize(pair.idTable_) >
+                 maxSize) {
+        collected.reset();
+        localVocab = LocalVocab{};
+        self->runtimeInfo().addDetail("lazy-result-too-large-for-cache", true);
+      } else if (pair.localVocab_.empty()) {
+        collected->insertAtEnd(pair.idTable_);
+      } else {
+        // The yielded block must not be changed, so the `LocalVocabIndex` IDs
+        // are rewritten in a copy.
+        IdTable block = pair.idTable_.clone();
+        LocalVocab blockVocab = pair.localVocab_.clone();
+        mergeLocalVocabInto(block, blockVocab, localVocab);
+        collected->insertAtEnd(block);
+      }
+      co_yield pair;
+    }
+    if (!collected.has_value()) {
+      co_return;
+    }
+    // At this point, all the blocks have been passed to the consumer, so a
+    // failure to store the result must not fail the query.
+    try {
+      RuntimeInformation runtimeInfo = self->runtimeInfo();
+      runtimeInfo.status_ = RuntimeInformation::Status::fullyMaterialized;
+      ResultTable materialized{std::move(collected.value()),
+                               std::move(sortedBy), std::move(localVocab)};
+      auto& cache = self->getExecutionContext()->getQueryTreeCache();
+      cache.computeOnce(cacheKey, [&materialized, &runtimeInfo]() {
+        if (RuntimeParameters().get<"compress-cached-results">()) {
+          return CacheValue::makeCompressed(
+              std::make_shared<const ResultTable>(std::move(materialized)),
+              std::move(runtimeInfo));
+        }
+        return CacheValue{std::move(materialized), std::move(runtimeInfo)};
+      });
+      cache.registerPartialKeys(cacheKey, self->getPartialCacheKeys());
+    } catch (const std::exception& e) {
+      LOG(WARN) << "The lazy result of " << self->getDescriptor()
+                << " could not be stored in the cache: " << e.what()
+                << std::endl;
+    }
+  };
+  return ResultTable{wrapper(std::move(result.idTables()), this,
+                             std::move(cacheKey), sortedBy),
+                     std::move(sortedBy)};
+}
+
 // ______________________________________________________________________
 
 std::chrono::milliseconds Operation::remainingTime() const {
@@ -216,15 +692,73 @@ std::chrono::milliseconds Operation::remainingTime() const {
       0ms, std::chrono::duration_cast<std::chrono::milliseconds>(interval));
 }
 
+// _____________________________________________________________________________
+void Operation::checkEstimatedRuntime() {
+  // Operations without a time limit (e.g. in the query planning) are never
+  // canceled.
+  if (deadline_ == std::chrono::steady_clock::time_point::max()) {
+    return;
+  }
+  getQueryRuntimeEstimator().throwIfEstimateExceedsRemainingTime(
+      getCostEstimate(), remainingTime(), getDescriptor());
+}
+
+// _____________________________________________________________________________
+namespace {
+// True on the threads that compute child results for `getChildResults`. The
+// runtime information of the whole query must not be serialized while the
+// other threads change it, so the updates are only signalled by the calling
+// thread after all the children were computed.
+thread_local bool isThreadForChildResults = false;
+}  // namespace
+
+// _____________________________________________________________________________
+std::vector<shared_ptr<const ResultTable>> Operation::getChildResults(
+    std::span<const std::shared_ptr<QueryExecutionTree>> children,
+    bool requestLaziness) const {
+  std::vector<shared_ptr<const ResultTable>> results(children.size());
+  size_t numThreads =
+      std::min(_executionContext->getNumThreads(
+                   RuntimeParameters().get<"subtree-num-threads">()),
+               children.size());
+  // The same operation must not be computed concurrently by two threads.
+  ad_utility::HashSet<const Operation*> operations;
+  for (const auto& child : children) {
+    operations.insert(child->getRootOperation().get());
+  }
+  if (numThreads <= 1 || operations.size() < children.size()) {
+    for (size_t i = 0; i < children.size(); ++i) {
+      results[i] = children[i]->getResult(requestLaziness);
+    }
+    return results;
+  }
+  // Thread `t` computes the children `t`, `t + numThreads`, ...
+  ad_utility::runConcurrently(numThreads, [&](size_t thread) {
+    isThreadForChildResults = true;
+    for (size_t i = thread; i < children.size(); i += numThreads) {
+      results[i] = children[i]->getResult(requestLaziness);
+    }
+  });
+  signalQueryUpdate();
+  return results;
+}
+
 // _______________________________________________________________________
 void Operation::updateRuntimeInformationOnSuccess(
     const ResultTable& resultTable, ad_utility::CacheStatus cacheStatus,
     Milliseconds duration, std::optional<RuntimeInformation> runtimeInfo) {
   _runtimeInfo->totalTime_ = duration;
-  _runtimeInfo->numRows_ = resultTable.size();
   _runtimeInfo->cacheStatus_ = cacheStatus;
 
-  _runtimeInfo->status_ = RuntimeInformation::Status::fullyMaterialized;
+  // For a lazy result, the number of rows is only known after the result has
+  // been consumed (see `wrapLazyResultForRuntimeInformation`).
+  if (resultTable.isFullyMaterialized()) {
+    _runtimeInfo->numRows_ = resultTable.size();
+    _runtimeInfo->status_ = RuntimeInformation::Status::fullyMaterialized;
+  } else {
+    _runtimeInfo->numRows_ = 0;
+    _runtimeInfo->status_ = RuntimeInformation::Status::lazilyMaterialized;
+  }
 
   bool wasCached = cacheStatus != ad_utility::CacheStatus::computed;
   // If the result was read from the cache, then we need the additional
@@ -430,7 +964,7 @@ void Operation::setTextLimit(size_t limit) {
 // _____________________________________________________________________________
 
 void Operation::signalQueryUpdate() const {
-  if (_executionContext) {
+  if (_executionContext && !isThreadForChildResults) {
     _executionContext->signalQueryUpdate(*_rootRuntimeInfo);
   }
 }
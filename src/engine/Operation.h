@@ -9,8 +9,12 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <utility>
 
+#include "engine/CardinalityFeedback.h"
 #include "engine/QueryExecutionContext.h"
 #include "engine/ResultTable.h"
 #include "engine/RuntimeInformation.h"
@@ -21,11 +25,43 @@
 #include "util/CompilerExtensions.h"
 #include "util/Exception.h"
 #include "util/Log.h"
+#include "util/OperationStatistics.h"
 #include "util/TypeTraits.h"
 
 // forward declaration needed to break dependencies
 class QueryExecutionTree;
 
+// The different ways in which the result of an `Operation` can be requested
+// via `Operation::getResult`.
+enum class ComputationMode {
+  // Compute a fully materialized result and store it in the cache.
+  FULLY_MATERIALIZED,
+  // Compute a lazy result (a generator of blocks) if the operation supports
+  // this, else a fully materialized result. A lazy result is only written to
+  // the cache once it has been consumed completely (see
+  // `Operation::wrapLazyResultForCache`), and a result that is already cached
+  // is used.
+  LAZY_IF_SUPPORTED,
+  // Only return the result if it can be read from the cache without any
+  // computation, return `nullptr` otherwise.
+  ONLY_IF_CACHED
+};
+
+// The result of identical subtrees (with the same cache key) of a single query,
+// which is computed only once and then shared between the subtrees,
+// independently of the cache (see
+// `QueryPlanner::shareResultsOfCommonSubtrees`).
+// The result is released as soon as each of the `numUses_` subtrees has
+// requested it.
+struct SharedSubtreeResult {
+  explicit SharedSubtreeResult(size_t numUses) : numUses_{numUses} {}
+  std::mutex mutex_;
+  std::shared_ptr<const ResultTable> result_;
+  std::optional<RuntimeInformation> runtimeInfo_;
+  size_t numUses_;
+  size_t numRemainingUses_ = 0;
+};
+
 class Operation {
   using SharedCancellationHandle = ad_utility::SharedCancellationHandle;
   using Milliseconds = std::chrono::milliseconds;
@@ -70,14 +106,31 @@ class Operation {
   // This should act like an ID for each subtree.
   // Calls  `getCacheKeyImpl` and adds the information about the `LIMIT` clause.
   virtual string getCacheKey() const final {
-    auto result = getCacheKeyImpl();
-    if (_limit._limit.has_value()) {
-      absl::StrAppend(&result, " LIMIT ", _limit._limit.value());
+    return appendLimitOffsetToCacheKey(getCacheKeyImpl());
+  }
+
+  // The partial cache keys under which the result of this operation is
+  // additionally registered in the cache (with the `LIMIT` clause appended).
+  // A partial key describes a property of the result that suffices for other
+  // operations, e.g. the result of a sort on the columns `(a, b)` is also a
+  // valid result of a sort on the column `a` of the same subtree.
+  std::vector<std::string> getPartialCacheKeys() const {
+    auto keys = getPartialCacheKeysImpl();
+    for (auto& key : keys) {
+      key = appendLimitOffsetToCacheKey(std::move(key));
     }
-    if (_limit._offset != 0) {
-      absl::StrAppend(&result, " OFFSET ", _limit._offset);
+    return keys;
+  }
+
+  // The partial cache key (with the `LIMIT` clause appended) that a cached
+  // result must be registered under to be a valid result of this operation,
+  // or `std::nullopt` if this operation doesn't support partial matches.
+  std::optional<std::string> getPartialCacheKeyForLookup() const {
+    auto key = getPartialCacheKeyForLookupImpl();
+    if (!key.has_value()) {
+      return std::nullopt;
     }
-    return result;
+    return appendLimitOffsetToCacheKey(std::move(key.value()));
   }
 
  private:
@@ -85,6 +138,46 @@ class Operation {
   // customized by every child class.
   virtual string getCacheKeyImpl() const = 0;
 
+  // The individual implementations of `getPartialCacheKeys` and
+  // `getPartialCacheKeyForLookup` (see above). By default, an operation
+  // supports no partial matches.
+  virtual std::vector<std::string> getPartialCacheKeysImpl() const {
+    return {};
+  }
+  virtual std::optional<std::string> getPartialCacheKeyForLookupImpl() const {
+    return std::nullopt;
+  }
+
+  // Append the `LIMIT` and `OFFSET` of this operation to the `key`.
+  std::string appendLimitOffsetToCacheKey(std::string key) const {
+    if (_limit._limit.has_value()) {
+      absl::StrAppend(&key, " LIMIT ", _limit._limit.value());
+    }
+    if (_limit._offset != 0) {
+      absl::StrAppend(&key, " OFFSET ", _limit._offset);
+    }
+    return key;
+  }
+
+  // Return the result of this operation if it can be obtained from a cached
+  // result for a different cache key, namely from a result that is registered
+  // under the partial key of this operation (see above) or from the unlimited
+  // version of this operation, to which the `LIMIT` and `OFFSET` are then
+  // applied. Return `std::nullopt` if there is no such cached result.
+  std::optional<CacheValue> getResultFromCachedSuperset();
+
+  // The signature and the uncorrected size estimate under which the actual
+  // size of the result of this operation is recorded in the global
+  // `CardinalityFeedback`. By default, nothing is recorded.
+  virtual std::optional<CardinalityFeedback::Estimate>
+  getCardinalityFeedbackEstimate() {
+    return std::nullopt;
+  }
+
+  // Record the size of the `result` (before the `LIMIT` is applied) in the
+  // global `CardinalityFeedback` (see `getCardinalityFeedbackEstimate`).
+  void recordCardinalityFeedback(const ResultTable& result);
+
  public:
   // Gets a very short (one line without line ending) descriptor string for
   // this Operation.  This string is used in the RuntimeInformation
@@ -138,14 +231,34 @@ class Operation {
    * @param isRoot Has be set to `true` iff this is the root operation of a
    * complete query to obtain the expected behavior wrt cache pinning and
    * runtime information in error cases.
-   * @param onlyReadFromCache If set to true the result is only returned if it
-   * can be read from the cache without any computation. If the result is not in
-   * the cache, `nullptr` will be returned.
+   * @param computationMode Determines whether the result is fully
+   * materialized, lazy (if supported), or only read from the cache (see the
+   * documentation of `ComputationMode` for details). In the last case, if the
+   * result is not in the cache, `nullptr` will be returned.
    * @return A shared pointer to the result. May only be `nullptr` if
-   * `onlyReadFromCache` is true.
+   * `computationMode` is `ONLY_IF_CACHED`.
    */
-  shared_ptr<const ResultTable> getResult(bool isRoot = false,
-                                          bool onlyReadFromCache = false);
+  shared_ptr<const ResultTable> getResult(
+      bool isRoot = false,
+      ComputationMode computationMode = ComputationMode::FULLY_MATERIALIZED);
+
+  // Compute the rows of the result of this operation in which the `variable`
+  // is bound to one of the `values` (which must be sorted, unique, and not
+  // UNDEF). This semi-join reduction of the result is used by a join if its
+  // other input is small (see `Join::getResultWithSemiJoinReduction`), s.t. the
+  // rows without a join partner are dropped as early as possible. The result
+  // has the same columns and sort order as the complete result and is not
+  // cached. Return `nullptr` if this operation doesn't support the reduction
+  // for the `variable`, then the complete result has to be computed instead.
+  shared_ptr<const ResultTable> getResultWithSemiJoinFilter(
+      const Variable& variable, std::span<const Id> values);
+
+  // Share the result of this operation with the other operations that get the
+  // same `sharedResult` (see `SharedSubtreeResult`). The result is then always
+  // fully materialized and the semi-join reduction is not used.
+  void setSharedResult(std::shared_ptr<SharedSubtreeResult> sharedResult) {
+    sharedResult_ = std::move(sharedResult);
+  }
 
   // Use the same cancellation handle for all children of an operation (= query
   // plan rooted at that operation). As soon as one child is aborted, the whole
@@ -193,8 +306,9 @@ class Operation {
   // Direct access to the `computeResult()` method. This should be only used for
   // testing, otherwise the `getResult()` function should be used which also
   // sets the runtime info and uses the cache.
-  virtual ResultTable computeResultOnlyForTesting() final {
-    return computeResult();
+  virtual ResultTable computeResultOnlyForTesting(
+      bool requestLaziness = false) final {
+    return computeResult(requestLaziness);
   }
 
  protected:
@@ -235,6 +349,22 @@ class Operation {
 
   std::chrono::milliseconds remainingTime() const;
 
+  // Throw a `CancellationException` if the estimated runtime of this operation
+  // (including its children that are not cached) exceeds the remaining time
+  // (see `QueryRuntimeEstimator`). This is checked before the computation of
+  // each result, s.t. an operation that cannot finish in time does no work.
+  void checkEstimatedRuntime();
+
+  // Return the results of the `children` (via `getResult`) in the same order.
+  // The children must be independent subtrees. If the runtime parameter
+  // `subtree-num-threads` is larger than 1, they are computed concurrently by
+  // at most that many threads. The memory limit still holds for all of them
+  // together, because they all allocate via the allocators of the same
+  // `QueryExecutionContext`.
+  std::vector<shared_ptr<const ResultTable>> getChildResults(
+      std::span<const std::shared_ptr<QueryExecutionTree>> children,
+      bool requestLaziness = false) const;
+
   /// Pointer to the cancellation handle of this operation.
   SharedCancellationHandle cancellationHandle_ =
       std::make_shared<SharedCancellationHandle::element_type>();
@@ -249,8 +379,55 @@ class Operation {
       const final;
 
  private:
-  //! Compute the result of the query-subtree rooted at this element..
-  virtual ResultTable computeResult() = 0;
+  // Compute the result of the query-subtree rooted at this element. If
+  // `requestLaziness` is true, the operation may return a lazy result (a
+  // generator of blocks, see `ResultTable`), but it is always allowed to
+  // return a fully materialized result instead. If `requestLaziness` is false,
+  // the result must be fully materialized.
+  virtual ResultTable computeResult(bool requestLaziness) = 0;
+
+  // Compute the fully materialized result that is stored in the cache. If this
+  // operation has a `LIMIT` that it doesn't implement itself (see
+  // `supportsLimit`), the result is computed lazily and only the blocks up to
+  // `LIMIT + OFFSET` rows are materialized, s.t. the remaining blocks (and
+  // everything that the children need to compute them) are never computed.
+  // The LIMIT and OFFSET themselves are applied afterwards by the caller.
+  ResultTable computeResultForCache();
+
+  // The individual implementation of `getResultWithSemiJoinFilter` (see
+  // above). By default, the semi-join reduction is not supported.
+  virtual std::optional<ResultTable> computeResultWithSemiJoinFilter(
+      [[maybe_unused]] const Variable& variable,
+      [[maybe_unused]] std::span<const Id> values) {
+    return std::nullopt;
+  }
+
+  // The implementation of `getResult` if the result is not shared (see
+  // `setSharedResult`) or if this operation is the first of the sharing ones
+  // that requests the result.
+  shared_ptr<const ResultTable> getResultFromCacheOrCompute(
+      bool isRoot, ComputationMode computationMode);
+
+  // Wrap the generator of a lazy `result` s.t. the runtime information of this
+  // operation (the number of rows, the time spent on computing the blocks, and
+  // the `statistics`) is updated while the blocks are consumed. The blocks are
+  // computed with the `statistics` as the current `OperationStatistics`.
+  ResultTable wrapLazyResultForRuntimeInformation(
+      ResultTable result,
+      std::shared_ptr<ad_utility::OperationStatistics> statistics);
+
+  // Add the (non-zero) counters of the `statistics` as details to the runtime
+  // information of this operation.
+  void addStatisticsToRuntimeInformation(
+      const ad_utility::OperationStatistics& statistics);
+
+  // Wrap the generator of a lazy `result` s.t. copies of its blocks are
+  // collected while they are consumed. When the generator has been consumed
+  // completely, the collected result is stored in the cache under the
+  // `cacheKey`. Nothing is stored if the consumer stops early (for example
+  // because the query was cancelled), or if the collected blocks exceed the
+  // `cache-max-size-single-entry`, in which case they are dropped immediately.
+  ResultTable wrapLazyResultForCache(ResultTable result, std::string cacheKey);
 
   // Create and store the complete runtime information for this operation after
   // it has either been succesfully computed or read from the cache.
@@ -310,6 +487,9 @@ class Operation {
 
   std::shared_ptr<RuntimeInformation> _runtimeInfo =
       std::make_shared<RuntimeInformation>();
+  // The result that is shared with identical subtrees of the same query (see
+  // `setSharedResult`), `nullptr` if the result is not shared.
+  std::shared_ptr<SharedSubtreeResult> sharedResult_;
   /// Pointer to the head of the `RuntimeInformation`.
   /// Used in `signalQueryUpdate()`, reset in `createRuntimeInfoFromEstimates()`
   std::shared_ptr<const RuntimeInformation> _rootRuntimeInfo = _runtimeInfo;
@@ -7,6 +7,8 @@
 
 #include "engine/AddCombinedRowToTable.h"
 #include "engine/CallFixedSize.h"
+#include "engine/IndexScan.h"
+#include "util/HashMap.h"
 #include "util/JoinAlgorithms/JoinAlgorithms.h"
 
 using std::endl;
@@ -15,10 +17,12 @@ using std::string;
 // _____________________________________________________________________________
 OptionalJoin::OptionalJoin(QueryExecutionContext* qec,
                            std::shared_ptr<QueryExecutionTree> t1,
-                           std::shared_ptr<QueryExecutionTree> t2)
+                           std::shared_ptr<QueryExecutionTree> t2,
+                           Strategy strategy)
     : Operation(qec),
       _left{std::move(t1)},
       _right{std::move(t2)},
+      strategy_{strategy},
       _joinColumns(QueryExecutionTree::getJoinColumns(*_left, *_right)) {
   AD_CORRECTNESS_CHECK(!_joinColumns.empty());
 
@@ -52,6 +56,19 @@ OptionalJoin::OptionalJoin(QueryExecutionContext* qec,
     implementation_ = Implementation::OnlyUndefInLastJoinColumnOfLeft;
   }
 
+  if (strategy_ == Strategy::Hash) {
+    AD_CONTRACT_CHECK(implementation_ == Implementation::NoUndef);
+    // The inputs need not be sorted. The hash map is built on the first join
+    // column, which is chosen s.t. the blocks of a right `IndexScan` can be
+    // skipped if possible (see `rightIsScanOnFirstJoinColumn`).
+    auto it = std::ranges::find(_joinColumns, ColumnIndex{0},
+                                [](const auto& columns) { return columns[1]; });
+    if (it != _joinColumns.end()) {
+      std::iter_swap(_joinColumns.begin(), it);
+    }
+    return;
+  }
+
   // The inputs must be sorted by the join columns.
   std::tie(_left, _right) = QueryExecutionTree::createSortedTrees(
       std::move(_left), std::move(_right), _joinColumns);
@@ -72,9 +89,29 @@ string OptionalJoin::getCacheKeyImpl() const {
     os << _joinColumns[i][1] << (i < _joinColumns.size() - 1 ? " & " : "");
   };
   os << "]";
+  if (strategy_ == Strategy::Hash) {
+    os << " (hash)";
+  }
   return std::move(os).str();
 }
 
+// _____________________________________________________________________________
+bool OptionalJoin::isHashStrategyApplicable(const QueryExecutionTree& left,
+                                            const QueryExecutionTree& right) {
+  auto mightContainUndef = [](const QueryExecutionTree& tree,
+                              ColumnIndex column) {
+    return tree.getVariableAndInfoByColumnIndex(column)
+               .second.mightContainUndef_ ==
+           ColumnIndexAndTypeInfo::UndefStatus::PossiblyUndefined;
+  };
+  return std::ranges::none_of(
+      QueryExecutionTree::getJoinColumns(left, right),
+      [&](const auto& columns) {
+        return mightContainUndef(left, columns[0]) ||
+               mightContainUndef(right, columns[1]);
+      });
+}
+
 // _____________________________________________________________________________
 string OptionalJoin::getDescriptor() const {
   std::string joinVars;
@@ -84,20 +121,27 @@ string OptionalJoin::getDescriptor() const {
         _left->getVariableAndInfoByColumnIndex(leftCol).first.name();
     joinVars += varName + " ";
   }
+  if (strategy_ == Strategy::Hash) {
+    return "OptionalJoin (hash) on " + joinVars;
+  }
   return "OptionalJoin on " + joinVars;
 }
 
 // _____________________________________________________________________________
-ResultTable OptionalJoin::computeResult() {
+ResultTable OptionalJoin::computeResult([[maybe_unused]] bool requestLaziness) {
   LOG(DEBUG) << "OptionalJoin result computation..." << endl;
+  if (strategy_ == Strategy::Hash) {
+    return computeResultWithHashStrategy();
+  }
 
   IdTable idTable{getExecutionContext()->getAllocator()};
   idTable.setNumColumns(getResultWidth());
 
   AD_CONTRACT_CHECK(idTable.numColumns() >= _joinColumns.size());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  auto childResults = getChildResults(std::array{_left, _right});
+  const auto leftResult = std::move(childResults[0]);
+  const auto rightResult = std::move(childResults[1]);
 
   LOG(DEBUG) << "OptionalJoin subresult computation done." << std::endl;
 
@@ -115,6 +159,65 @@ ResultTable OptionalJoin::computeResult() {
                                                          *rightResult)};
 }
 
+// _____________________________________________________________________________
+ResultTable OptionalJoin::computeResultWithHashStrategy() {
+  IdTable idTable{getResultWidth(), getExecutionContext()->getAllocator()};
+
+  // If the right input is an `IndexScan` on the first join column that is not
+  // cached, only the blocks of the scan that contain one of the values of the
+  // left input are read (see `Minus::computeResult`).
+  if (rightIsScanOnFirstJoinColumn()) {
+    auto& scan = dynamic_cast<IndexScan&>(*_right->getRootOperation());
+    if (!scan.hasDeltaTriples() &&
+        !scan.getResult(false, ComputationMode::ONLY_IF_CACHED)) {
+      auto leftResult = _left->getResult();
+      const IdTable& left = leftResult->idTable();
+      std::vector<Id> leftJoinIds(left.getColumn(_joinColumns[0][0]).begin(),
+                                  left.getColumn(_joinColumns[0][0]).end());
+      std::ranges::sort(leftJoinIds);
+      auto duplicates = std::ranges::unique(leftJoinIds);
+      leftJoinIds.erase(duplicates.begin(), duplicates.end());
+      IdTable right = readBlocksForJoinColumn(leftJoinIds, scan);
+      hashOptionalJoin(left, right, _joinColumns, &idTable);
+      // An `IndexScan` has no local vocabulary.
+      return {std::move(idTable), resultSortedOn(),
+              leftResult->getSharedLocalVocab()};
+    }
+  }
+
+  auto childResults = getChildResults(std::array{_left, _right});
+  const auto leftResult = std::move(childResults[0]);
+  const auto rightResult = std::move(childResults[1]);
+  hashOptionalJoin(leftResult->idTable(), rightResult->idTable(), _joinColumns,
+                   &idTable);
+  return {std::move(idTable), resultSortedOn(),
+          ResultTable::getSharedLocalVocabFromNonEmptyOf(*leftResult,
+                                                         *rightResult)};
+}
+
+// _____________________________________________________________________________
+bool OptionalJoin::rightIsScanOnFirstJoinColumn() const {
+  if (_right->getType() != QueryExecutionTree::SCAN ||
+      _joinColumns[0][1] != 0) {
+    return false;
+  }
+  return dynamic_cast<const IndexScan&>(*_right->getRootOperation())
+             .numVariables() <= 2;
+}
+
+// _____________________________________________________________________________
+IdTable OptionalJoin::readBlocksForJoinColumn(std::span<const Id> leftJoinIds,
+                                              IndexScan& scan) const {
+  auto blocks = IndexScan::lazyScanForJoinOfColumnWithScan(leftJoinIds, scan);
+  IdTable right{scan.getResultWidth(), getExecutionContext()->getAllocator()};
+  for (const IdTable& block : blocks) {
+    checkCancellation();
+    right.insertAtEnd(block);
+  }
+  scan.updateRuntimeInfoForLazyScan(blocks.details());
+  return right;
+}
+
 // _____________________________________________________________________________
 VariableToColumnMap OptionalJoin::computeVariableToColumnMap() const {
   return makeVarToColMapForJoinOperation(
@@ -133,6 +236,9 @@ size_t OptionalJoin::getResultWidth() const {
 // _____________________________________________________________________________
 vector<ColumnIndex> OptionalJoin::resultSortedOn() const {
   std::vector<ColumnIndex> sortedOn;
+  if (strategy_ == Strategy::Hash) {
+    return sortedOn;
+  }
   // The result is sorted on all join columns from the left subtree.
   for (const auto& [joinColumnLeft, joinColumnRight] : _joinColumns) {
     (void)joinColumnRight;
@@ -159,6 +265,26 @@ uint64_t OptionalJoin::getSizeEstimateBeforeLimit() {
 
 // _____________________________________________________________________________
 size_t OptionalJoin::getCostEstimate() {
+  if (!_costEstimate.has_value() && strategy_ == Strategy::Hash) {
+    // The right input is only probed, and if only its blocks with a match are
+    // read, its size (and the cost of the scan) is at most the number of rows
+    // that match the left input.
+    size_t rightSize = _right->getSizeEstimate();
+    size_t rightCost = _right->getCostEstimate();
+    if (rightIsScanOnFirstJoinColumn()) {
+      auto numMatches = static_cast<size_t>(
+          _left->getSizeEstimate() *
+          _right->getMultiplicity(_joinColumns[0][1]));
+      rightSize = std::min(rightSize, numMatches);
+      rightCost = std::min(rightCost, rightSize);
+    }
+    // Building and probing the hash map is about twice as expensive as a
+    // normal join.
+    size_t costEstimate =
+        2 * (getSizeEstimateBeforeLimit() + _left->getSizeEstimate() +
+             rightSize);
+    _costEstimate = _left->getCostEstimate() + rightCost + costEstimate;
+  }
   if (!_costEstimate.has_value()) {
     size_t costEstimate = getSizeEstimateBeforeLimit() +
                           _left->getSizeEstimate() + _right->getSizeEstimate();
@@ -296,6 +422,22 @@ void OptionalJoin::optionalJoin(
 
   auto lessThanBoth = std::ranges::lexicographical_compare;
 
+  // Without UNDEF values the zipper join can be run on multiple threads.
+  if (implementation == Implementation::NoUndef &&
+      right.size() / left.size() <= GALLOP_THRESHOLD) {
+    auto makeRowAdder = [&]() {
+      return ad_utility::AddCombinedRowToIdTable{
+          joinColumns.size(), leftPermuted, rightPermuted,
+          IdTable{result->numColumns(), result->getAllocator()}};
+    };
+    *result = ad_utility::parallelZipperJoinWithoutUndef(
+        joinColumnsLeft, joinColumnsRight, lessThanBoth,
+        RuntimeParameters().get<"join-num-threads">(), makeRowAdder, 100'000,
+        std::true_type{});
+    result->setColumnSubset(joinColumnData.permutationResult());
+    return;
+  }
+
   auto rowAdder = ad_utility::AddCombinedRowToIdTable(
       joinColumns.size(), leftPermuted, rightPermuted, std::move(*result));
   auto addRow = [&rowAdder, beginLeft = joinColumnsLeft.begin(),
@@ -320,15 +462,9 @@ void OptionalJoin::optionalJoin(
                                       addOptionalRow);
       return 0UL;
     } else if (implementation == Implementation::NoUndef) {
-      if (right.size() / left.size() > GALLOP_THRESHOLD) {
-        ad_utility::gallopingJoin(joinColumnsLeft, joinColumnsRight,
-                                  lessThanBoth, addRow, addOptionalRow);
-      } else {
-        auto shouldBeZero = ad_utility::zipperJoinWithUndef(
-            joinColumnsLeft, joinColumnsRight, lessThanBoth, addRow,
-            ad_utility::noop, ad_utility::noop, addOptionalRow);
-        AD_CORRECTNESS_CHECK(shouldBeZero == 0UL);
-      }
+      // The case without galloping has already been handled above.
+      ad_utility::gallopingJoin(joinColumnsLeft, joinColumnsRight, lessThanBoth,
+                                addRow, addOptionalRow);
       return 0UL;
     } else {
       return ad_utility::zipperJoinWithUndef(
@@ -358,3 +494,63 @@ void OptionalJoin::optionalJoin(
   }
   result->setColumnSubset(joinColumnData.permutationResult());
 }
+
+// ______________________________________________________________
+void OptionalJoin::hashOptionalJoin(
+    const IdTable& left, const IdTable& right,
+    const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
+    IdTable* result) {
+  AD_CONTRACT_CHECK(!joinColumns.empty());
+  if (left.empty()) {
+    return;
+  }
+  ad_utility::JoinColumnMapping joinColumnData{joinColumns, left.numColumns(),
+                                               right.numColumns()};
+  auto leftPermuted = left.asColumnSubsetView(joinColumnData.permutationLeft());
+  auto rightPermuted =
+      right.asColumnSubsetView(joinColumnData.permutationRight());
+  auto rowAdder = ad_utility::AddCombinedRowToIdTable(
+      joinColumns.size(), leftPermuted, rightPermuted, std::move(*result));
+
+  // Map the values of the first join column of the left input to the indices
+  // of the rows with this value.
+  std::span<const Id> leftFirst = left.getColumn(joinColumns[0][0]);
+  ad_utility::HashMap<Id, std::vector<size_t>> leftRows;
+  for (size_t i = 0; i < left.size(); ++i) {
+    leftRows[leftFirst[i]].push_back(i);
+  }
+  auto restIsEqual = [&left, &right, &joinColumns](size_t iLeft,
+                                                   size_t iRight) {
+    for (size_t i = 1; i < joinColumns.size(); ++i) {
+      if (left(iLeft, joinColumns[i][0]) != right(iRight, joinColumns[i][1])) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Probe the map with the rows of the right input, and then add the left rows
+  // without a match.
+  std::vector<bool> hasMatch(left.size(), false);
+  std::span<const Id> rightFirst = right.getColumn(joinColumns[0][1]);
+  for (size_t iRight = 0; iRight < right.size(); ++iRight) {
+    auto it = leftRows.find(rightFirst[iRight]);
+    if (it == leftRows.end()) {
+      continue;
+    }
+    for (size_t iLeft : it->second) {
+      if (restIsEqual(iLeft, iRight)) {
+        rowAdder.addRow(iLeft, iRight);
+        hasMatch[iLeft] = true;
+      }
+    }
+  }
+  for (size_t iLeft = 0; iLeft < left.size(); ++iLeft) {
+    if (!hasMatch[iLeft]) {
+      rowAdder.addOptionalRow(iLeft);
+    }
+  }
+  // The columns of the result are permuted like in `optionalJoin`.
+  *result = std::move(rowAdder).resultTable();
+  result->setColumnSubset(joinColumnData.permutationResult());
+}
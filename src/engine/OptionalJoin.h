@@ -11,7 +11,25 @@
 
 using std::list;
 
+class IndexScan;
+
 class OptionalJoin : public Operation {
+ public:
+  // The algorithm that is used to compute the optional join.
+  enum struct Strategy {
+    // Both inputs are sorted on the join columns and merged via a zipper join
+    // that also handles UNDEF values.
+    Zipper,
+    // A left-outer hash join with a hash map of the left input, which is
+    // probed with the rows of the right input. Neither input has to be sorted,
+    // and if the right input is an `IndexScan` on the first join column, only
+    // the blocks of the scan that contain a value of the left input are read.
+    // This pays off if the left input is much smaller than the right input.
+    // Can only be used if none of the join columns contains UNDEF values, and
+    // the result is not sorted.
+    Hash
+  };
+
  private:
   std::shared_ptr<QueryExecutionTree> _left;
   std::shared_ptr<QueryExecutionTree> _right;
@@ -26,6 +44,8 @@ class OptionalJoin : public Operation {
 
   Implementation implementation_ = Implementation::GeneralCase;
 
+  Strategy strategy_ = Strategy::Zipper;
+
   std::vector<std::array<ColumnIndex, 2>> _joinColumns;
 
   std::vector<float> _multiplicities;
@@ -36,7 +56,15 @@ class OptionalJoin : public Operation {
  public:
   OptionalJoin(QueryExecutionContext* qec,
                std::shared_ptr<QueryExecutionTree> t1,
-               std::shared_ptr<QueryExecutionTree> t2);
+               std::shared_ptr<QueryExecutionTree> t2,
+               Strategy strategy = Strategy::Zipper);
+
+  // Return true iff the `Strategy::Hash` can be used for the optional join of
+  // `left` and `right`, i.e. if none of their join columns contains UNDEF.
+  static bool isHashStrategyApplicable(const QueryExecutionTree& left,
+                                       const QueryExecutionTree& right);
+
+  Strategy strategy() const { return strategy_; }
 
  private:
   string getCacheKeyImpl() const override;
@@ -81,10 +109,32 @@ class OptionalJoin : public Operation {
       IdTable* dynResult,
       Implementation implementation = Implementation::GeneralCase);
 
+  // Joins two result tables like `optionalJoin`, but via a hash map of the
+  // `left` table (see `Strategy::Hash`). The inputs need not be sorted and
+  // must not contain UNDEF values in the join columns. The rows of the result
+  // are in no particular order.
+  static void hashOptionalJoin(
+      const IdTable& left, const IdTable& right,
+      const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
+      IdTable* result);
+
  private:
   void computeSizeEstimateAndMultiplicities();
 
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
+
+  // The implementation of `computeResult` for the `Strategy::Hash`.
+  ResultTable computeResultWithHashStrategy();
+
+  // Return true iff the right input is an `IndexScan` the first column of
+  // which is the first join column, s.t. the `Strategy::Hash` only has to read
+  // the blocks of the scan that can contain a match.
+  bool rightIsScanOnFirstJoinColumn() const;
+
+  // Read the blocks of the `scan` (the right input) that can contain a row
+  // with one of the (sorted) `leftJoinIds` in its first column.
+  IdTable readBlocksForJoinColumn(std::span<const Id> leftJoinIds,
+                                  IndexScan& scan) const;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 
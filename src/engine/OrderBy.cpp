@@ -5,10 +5,15 @@
 
 #include "engine/OrderBy.h"
 
+#include <limits>
+#include <numeric>
+#include <ranges>
 #include <sstream>
 
 #include "engine/CallFixedSize.h"
 #include "engine/Comparators.h"
+#include "engine/Engine.h"
+#include "engine/ExternalSort.h"
 #include "engine/QueryExecutionTree.h"
 #include "global/ValueIdComparators.h"
 
@@ -47,6 +52,27 @@ string OrderBy::getCacheKeyImpl() const {
   return std::move(os).str();
 }
 
+// _____________________________________________________________________________
+std::vector<std::string> OrderBy::getPartialCacheKeysImpl() const {
+  std::vector<std::string> keys;
+  std::string prefix = "ORDER BY on column prefix:";
+  auto subtreeKey = absl::StrCat("\n", subtree_->getCacheKey());
+  for (auto ind : sortIndices_) {
+    absl::StrAppend(&prefix, ind.second ? "desc(" : "asc(", ind.first, ") ");
+    keys.push_back(absl::StrCat(prefix, subtreeKey));
+  }
+  return keys;
+}
+
+// _____________________________________________________________________________
+std::optional<std::string> OrderBy::getPartialCacheKeyForLookupImpl() const {
+  auto keys = getPartialCacheKeysImpl();
+  if (keys.empty()) {
+    return std::nullopt;
+  }
+  return std::move(keys.back());
+}
+
 // _____________________________________________________________________________
 string OrderBy::getDescriptor() const {
   std::string orderByVars;
@@ -64,28 +90,10 @@ string OrderBy::getDescriptor() const {
 }
 
 // _____________________________________________________________________________
-ResultTable OrderBy::computeResult() {
+ResultTable OrderBy::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "Getting sub-result for OrderBy result computation..." << endl;
-  shared_ptr<const ResultTable> subRes = subtree_->getResult();
-
-  // TODO<joka921> proper timeout for sorting operations
-  auto sortEstimateCancellationFactor =
-      RuntimeParameters().get<"sort-estimate-cancellation-factor">();
-  if (getExecutionContext()->getSortPerformanceEstimator().estimatedSortTime(
-          subRes->size(), subRes->width()) >
-      remainingTime() * sortEstimateCancellationFactor) {
-    // The estimated time for this sort is much larger than the actually
-    // remaining time, cancel this operation
-    throw ad_utility::CancellationException(
-        "OrderBy operation was canceled, because time estimate exceeded "
-        "remaining time by a factor of " +
-        std::to_string(sortEstimateCancellationFactor));
-  }
-
-  LOG(DEBUG) << "OrderBy result computation..." << endl;
-  IdTable idTable = subRes->idTable().clone();
-
-  size_t width = idTable.numColumns();
+  shared_ptr<const ResultTable> subRes = subtree_->getResult(true);
+  size_t width = getResultWidth();
 
   // TODO<joka921> Measure (as soon as we have the benchmark merged)
   // whether it is beneficial to manually instantiate the comparison when
@@ -96,9 +104,6 @@ ResultTable OrderBy::computeResult() {
   // some O(n) algorithms, or even by returning lazy generators that yield
   // the repaired order.
 
-  // TODO<joka921> For proper sorting of the local vocab we also need to
-  // add some logic for the proper sorting.
-
   // TODO<joka921> Undefined values should always be at the end, no matter
   // if the ordering is ascending or descending.
 
@@ -107,29 +112,196 @@ ResultTable OrderBy::computeResult() {
   // only contains a single datatype, then we can use more efficient
   // implementations here.
 
+  // The words from the local vocab are compared via their precomputed ranks
+  // (see `computeLocalVocabRanks`). For a lazy input, the local vocabs of the
+  // blocks are only merged during the sort, so there are no ranks, and the
+  // words from the local vocab are compared by their `LocalVocabIndex`.
+  auto localVocabRanks = std::make_shared<const std::vector<uint64_t>>(
+      subRes->isFullyMaterialized() ? computeLocalVocabRanks(*subRes)
+                                    : std::vector<uint64_t>{});
+
   // Return true iff `rowA` comes before `rowB` in the sort order specified by
   // `sortIndices_`.
-  auto comparison = [this](const auto& row1, const auto& row2) -> bool {
+  auto comparison = [this, localVocabRanks](const auto& row1,
+                                            const auto& row2) -> bool {
     for (auto& [column, isDescending] : sortIndices_) {
-      if (row1[column] == row2[column]) {
+      Id a = row1[column];
+      Id b = row2[column];
+      if (a == b) {
         continue;
       }
-      bool isLessThan =
-          toBoolNotUndef(valueIdComparators::compareIds<
-                         valueIdComparators::ComparisonForIncompatibleTypes::
-                             CompareByType>(
-              row1[column], row2[column], valueIdComparators::Comparison::LT));
+      bool isLessThan;
+      if (!localVocabRanks->empty() &&
+          a.getDatatype() == Datatype::LocalVocabIndex &&
+          b.getDatatype() == Datatype::LocalVocabIndex) {
+        isLessThan = (*localVocabRanks)[a.getLocalVocabIndex().get()] <
+                     (*localVocabRanks)[b.getLocalVocabIndex().get()];
+      } else {
+        isLessThan = toBoolNotUndef(
+            valueIdComparators::compareIds<
+                valueIdComparators::ComparisonForIncompatibleTypes::
+                    CompareByType>(a, b, valueIdComparators::Comparison::LT));
+      }
       return isLessThan != isDescending;
     }
     return false;
   };
 
+  // With a LIMIT, only the first `LIMIT + OFFSET` rows of the sorted result
+  // are needed. The LIMIT and OFFSET are then applied by `Operation::getResult`
+  // as usual.
+  if (getLimit()._limit.has_value()) {
+    size_t k = getLimit().upperBound(std::numeric_limits<uint64_t>::max());
+    if (isTopKCheaperThanSort(*subRes, k)) {
+      LOG(DEBUG) << "OrderBy result computation via top-k..." << endl;
+      auto result = computeTopK(std::move(subRes), k, comparison);
+      LOG(DEBUG) << "OrderBy result computation done." << endl;
+      return result;
+    }
+  }
+
+  // TODO<joka921> proper timeout for sorting operations
+  auto sortEstimateCancellationFactor =
+      RuntimeParameters().get<"sort-estimate-cancellation-factor">();
+  if (subRes->isFullyMaterialized() &&
+      getExecutionContext()->getSortPerformanceEstimator().estimatedSortTime(
+          subRes->size(), subRes->width()) >
+          remainingTime() * sortEstimateCancellationFactor) {
+    // The estimated time for this sort is much larger than the actually
+    // remaining time, cancel this operation
+    throw ad_utility::CancellationException(
+        "OrderBy operation was canceled, because time estimate exceeded "
+        "remaining time by a factor of " +
+        std::to_string(sortEstimateCancellationFactor));
+  }
+
+  LOG(DEBUG) << "OrderBy result computation..." << endl;
   // We cannot use the `CALL_FIXED_SIZE` macro here because the `sort` function
   // is templated not only on the integer `I` (which the `callFixedSize`
   // function deals with) but also on the `comparison`.
-  ad_utility::callFixedSize(width, [&idTable, &comparison]<size_t I>() {
-    Engine::sort<I>(&idTable, comparison);
-  });
+  auto checkCancellation = [this]() { this->checkCancellation(); };
+  auto sortInMemory = [width, &comparison,
+                       &checkCancellation](IdTable& idTable) {
+    ad_utility::callFixedSize(width, [&]<size_t I>() {
+      Engine::sort<I>(&idTable, comparison, checkCancellation);
+    });
+  };
+  auto result = ad_utility::externalSort::sortWithSpilling(
+      std::move(subRes), width, resultSortedOn(), sortInMemory, comparison,
+      getExecutionContext()->getAllocator(), requestLaziness, runtimeInfo());
   LOG(DEBUG) << "OrderBy result computation done." << endl;
-  return {std::move(idTable), resultSortedOn(), subRes->getSharedLocalVocab()};
+  return result;
+}
+
+// _____________________________________________________________________________
+std::vector<uint64_t> OrderBy::computeLocalVocabRanks(
+    const ResultTable& subRes) {
+  const LocalVocab& localVocab = subRes.localVocab();
+  if (localVocab.size() < 2) {
+    return {};
+  }
+  // Only the words that occur in the sort columns get a sort key.
+  std::vector<bool> occurs(localVocab.size(), false);
+  std::vector<LocalVocabIndex> indices;
+  for (ColumnIndex column : sortIndices_ | std::views::keys) {
+    for (Id id : subRes.idTable().getColumn(column)) {
+      if (id.getDatatype() != Datatype::LocalVocabIndex) {
+        continue;
+      }
+      LocalVocabIndex index = id.getLocalVocabIndex();
+      if (!occurs[index.get()]) {
+        occurs[index.get()] = true;
+        indices.push_back(index);
+      }
+    }
+  }
+  if (indices.size() < 2) {
+    return {};
+  }
+
+  // Compute the sort key of each word only once, s.t. sorting the words
+  // compares the bytes of the sort keys instead of collating the words.
+  using Comparator = TripleComponentComparator;
+  const Comparator& comparator = getIndex().getVocab().getCaseComparator();
+  std::vector<Comparator::SplitVal> sortKeys;
+  sortKeys.reserve(indices.size());
+  for (LocalVocabIndex index : indices) {
+    sortKeys.push_back(comparator.extractAndTransformComparable(
+        localVocab.getWord(index), Comparator::Level::TOTAL));
+  }
+  checkCancellation();
+  std::vector<size_t> order(indices.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::ranges::sort(order, [&comparator, &sortKeys](size_t a, size_t b) {
+    return comparator(sortKeys[a], sortKeys[b], Comparator::Level::TOTAL);
+  });
+  std::vector<uint64_t> ranks(localVocab.size(), 0);
+  for (size_t rank = 0; rank < order.size(); ++rank) {
+    ranks[indices[order[rank]].get()] = rank;
+  }
+  runtimeInfo().addDetail("num-local-vocab-sort-keys", indices.size());
+  return ranks;
+}
+
+// _____________________________________________________________________________
+bool OrderBy::isTopKCheaperThanSort(const ResultTable& subRes, size_t k) const {
+  if (subRes.isFullyMaterialized()) {
+    return k < subRes.size() / 2;
+  }
+  // For a lazy input, the `k` best rows (and the candidates from the current
+  // block) have to fit into the memory budget of the sort.
+  auto memoryForTopK = ad_utility::MemorySize::bytes(
+      2 * std::min(k, std::numeric_limits<size_t>::max() / 2) *
+      getResultWidth() * sizeof(Id));
+  return memoryForTopK <=
+         RuntimeParameters().get<"sort-external-memory-budget">();
+}
+
+// _____________________________________________________________________________
+template <typename Comparison>
+ResultTable OrderBy::computeTopK(std::shared_ptr<const ResultTable> subRes,
+                                 size_t k, const Comparison& comparison) {
+  runtimeInfo().addDetail("top-k", k);
+  size_t numThreads =
+      getExecutionContext()->getNumThreads(Engine::getNumSortThreads());
+  size_t width = getResultWidth();
+  // Return the `k` first rows of the `table` in sorted order.
+  auto topK = [&](const IdTable& table) {
+    std::vector<size_t> rowIndices;
+    ad_utility::callFixedSize(width, [&]<size_t I>() {
+      rowIndices = ad_utility::idTableSorting::topKRowIndices(
+          table.asStaticView<I>(), k, comparison, numThreads);
+    });
+    IdTable result{width, getExecutionContext()->getAllocator()};
+    result.resize(rowIndices.size());
+    for (size_t col = 0; col < width; ++col) {
+      auto input = table.getColumn(col);
+      auto output = result.getColumn(col);
+      for (size_t i = 0; i < rowIndices.size(); ++i) {
+        output[i] = input[rowIndices[i]];
+      }
+    }
+    return result;
+  };
+
+  if (subRes->isFullyMaterialized()) {
+    return {topK(subRes->idTable()), resultSortedOn(),
+            subRes->getSharedLocalVocab()};
+  }
+  // For a lazy input, the `k` first rows of each block are appended to the
+  // `candidates`, which are reduced to their `k` first rows as soon as they
+  // become too large. The rows of earlier blocks come first in the
+  // `candidates`, so the result is the same as for a stable sort.
+  LocalVocab localVocab;
+  IdTable candidates{width, getExecutionContext()->getAllocator()};
+  for (auto& [block, blockVocab] : subRes->idTables()) {
+    ad_utility::externalSort::mergeLocalVocabInto(block, blockVocab,
+                                                  localVocab);
+    candidates.insertAtEnd(topK(block));
+    if (candidates.numRows() >= 2 * k) {
+      candidates = topK(candidates);
+    }
+    checkCancellation();
+  }
+  return {topK(candidates), resultSortedOn(), std::move(localVocab)};
 }
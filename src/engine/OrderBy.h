@@ -4,6 +4,7 @@
 // Author: 2023 -      Johannes Kalmbach (kalmbach@cs.uni-freiburg.de)
 #pragma once
 
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -35,6 +36,13 @@ class OrderBy : public Operation {
  protected:
   string getCacheKeyImpl() const override;
 
+ private:
+  // A result that is sorted on the `sortIndices_` is also sorted on each of
+  // their prefixes, so it is registered under one partial cache key per prefix
+  // (see `Operation::getPartialCacheKeys`).
+  std::vector<std::string> getPartialCacheKeysImpl() const override;
+  std::optional<std::string> getPartialCacheKeyForLookupImpl() const override;
+
  public:
   string getDescriptor() const override;
 
@@ -55,11 +63,17 @@ class OrderBy : public Operation {
     return subtree_->getMultiplicity(col);
   }
 
+  // With a LIMIT, only the first `LIMIT + OFFSET` rows are computed (see
+  // `computeTopK`), which costs `n * log(LIMIT + OFFSET)` instead of
+  // `n * log(n)`.
   size_t getCostEstimate() override {
     size_t size = getSizeEstimateBeforeLimit();
+    size_t numRowsToSort = std::min(
+        size, getLimit().upperBound(std::numeric_limits<uint64_t>::max()));
     size_t logSize = std::max(
-        size_t(1), static_cast<size_t>(logb(
-                       static_cast<double>(getSizeEstimateBeforeLimit()))));
+        size_t(1),
+        static_cast<size_t>(logb(static_cast<double>(
+            std::max(numRowsToSort, size_t{2})))));
     size_t nlogn = size * logSize;
     size_t subcost = subtree_->getCostEstimate();
     return nlogn + subcost;
@@ -74,7 +88,25 @@ class OrderBy : public Operation {
   }
 
  private:
-  ResultTable computeResult() override;
+  ResultTable computeResult(bool requestLaziness) override;
+
+  // Return the ranks of the words from the local vocab of the (fully
+  // materialized) `subRes` that occur in its sort columns, indexed by their
+  // `LocalVocabIndex`. The ranks are the order of the words in the vocabulary
+  // (see `TripleComponentComparator`), for which the sort key of each word is
+  // computed only once. Return an empty vector if there are fewer than two such
+  // words, in which case there is nothing to rank.
+  std::vector<uint64_t> computeLocalVocabRanks(const ResultTable& subRes);
+
+  // Return true iff computing only the first `k` rows of the sorted `subRes`
+  // via `computeTopK` is cheaper than sorting it completely.
+  bool isTopKCheaperThanSort(const ResultTable& subRes, size_t k) const;
+
+  // Compute the first `k` rows of the `subRes` when sorted according to the
+  // `comparison` in `O(k)` memory, without sorting the complete `subRes`.
+  template <typename Comparison>
+  ResultTable computeTopK(std::shared_ptr<const ResultTable> subRes, size_t k,
+                          const Comparison& comparison);
 
   VariableToColumnMap computeVariableToColumnMap() const override {
     return subtree_->getVariableColumns();
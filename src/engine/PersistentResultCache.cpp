@@ -0,0 +1,398 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "engine/PersistentResultCache.h"
+
+#include <absl/cleanup/cleanup.h>
+
+#include <algorithm>
+#include <ranges>
+
+#include "absl/strings/str_cat.h"
+#include "engine/idTable/CompressedExternalIdTable.h"
+#include "util/Exception.h"
+#include "util/File.h"
+#include "util/Log.h"
+#include "util/Serializer/FileSerializer.h"
+#include "util/Serializer/SerializeString.h"
+#include "util/Serializer/SerializeVector.h"
+
+using ad_utility::MemorySize;
+using Writer = ad_utility::CompressedExternalIdTableWriter;
+
+namespace {
+constexpr std::string_view META_EXTENSION = ".meta";
+constexpr std::string_view IDTABLE_EXTENSION = ".idtable";
+
+// The contents of the `.meta` file of an entry. The `cacheKey_` and the
+// `indexVersion_` have to be the first members, s.t. they can be read without
+// reading the rest of the file (see `readExistingEntries`).
+struct MetaData {
+  std::string cacheKey_;
+  std::string indexVersion_;
+  size_t numColumns_ = 0;
+  size_t numRows_ = 0;
+  std::vector<ColumnIndex> sortedBy_;
+  std::vector<std::string> localVocab_;
+  Writer::Metadata idTableMetadata_;
+  // The parts of the `RuntimeInformation` that are needed when the result is
+  // read from the cache. The `details_` are stored as a JSON string.
+  std::string descriptor_;
+  std::vector<std::string> columnNames_;
+  int64_t totalTimeInMs_ = 0;
+  std::string details_;
+
+  AD_SERIALIZE_FRIEND_FUNCTION(MetaData) {
+    serializer | arg.cacheKey_;
+    serializer | arg.indexVersion_;
+    serializer | arg.numColumns_;
+    serializer | arg.numRows_;
+    serializer | arg.sortedBy_;
+    serializer | arg.localVocab_;
+    serializer | arg.idTableMetadata_;
+    serializer | arg.descriptor_;
+    serializer | arg.columnNames_;
+    serializer | arg.totalTimeInMs_;
+    serializer | arg.details_;
+  }
+};
+
+// Append the `extension` to the `path`.
+std::filesystem::path withExtension(std::filesystem::path path,
+                                    std::string_view extension) {
+  path += extension;
+  return path;
+}
+
+// Return the size of the file at `path` or zero if it doesn't exist.
+MemorySize fileSize(const std::filesystem::path& path) {
+  std::error_code ec;
+  auto size = std::filesystem::file_size(path, ec);
+  return MemorySize::bytes(ec ? 0 : size);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+PersistentResultCache::PersistentResultCache(std::filesystem::path directory,
+                                             std::string indexVersion,
+                                             MemorySize maxSize)
+    : directory_{std::move(directory)},
+      indexVersion_{std::move(indexVersion)},
+      maxSizeInBytes_{maxSize.getBytes()} {
+  std::filesystem::create_directories(directory_);
+  readExistingEntries();
+  LOG(INFO) << "Opened the persistent result cache in " << directory_
+            << " with " << numEntries() << " entries of total size " << size()
+            << std::endl;
+}
+
+// _____________________________________________________________________________
+std::string PersistentResultCache::getName(const std::string& cacheKey) {
+  // The 64-bit FNV-1a hash. Unlike `std::hash` and `absl::Hash` it is
+  // guaranteed to be the same for all runs and builds of QLever, which is
+  // required because the names are persisted.
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : cacheKey) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return std::to_string(hash);
+}
+
+// _____________________________________________________________________________
+void PersistentResultCache::deleteFiles(const std::string& name) const {
+  auto basePath = getBasePath(name);
+  ad_utility::deleteFile(withExtension(basePath, META_EXTENSION), false);
+  ad_utility::deleteFile(withExtension(basePath, IDTABLE_EXTENSION), false);
+}
+
+// _____________________________________________________________________________
+void PersistentResultCache::makeRoom(Entries& entries,
+                                     MemorySize sizeToMakeRoomFor) {
+  auto totalSize = [&entries]() {
+    MemorySize result = MemorySize::bytes(0);
+    for (const auto& entry : entries | std::views::values) {
+      result += entry.size_;
+    }
+    return result;
+  };
+  auto maxSize = MemorySize::bytes(maxSizeInBytes_.load());
+  while (!entries.empty() && totalSize() + sizeToMakeRoomFor > maxSize) {
+    auto leastRecentlyUsed = std::ranges::min_element(
+        entries, {}, [](const auto& el) { return el.second.lastAccess_; });
+    deleteFiles(leastRecentlyUsed->first);
+    entries.erase(leastRecentlyUsed);
+  }
+}
+
+// _____________________________________________________________________________
+void PersistentResultCache::readExistingEntries() {
+  std::vector<std::pair<std::filesystem::file_time_type, std::string>>
+      entriesByWriteTime;
+  auto entries = entries_.wlock();
+  // Files are deleted in the loop below, so the directory is not iterated
+  // directly.
+  std::vector<std::filesystem::path> files;
+  for (const auto& file : std::filesystem::directory_iterator(directory_)) {
+    files.push_back(file.path());
+  }
+  for (const auto& path : files) {
+    auto name = path.stem().string();
+    if (path.extension() == IDTABLE_EXTENSION) {
+      // Data without a `.meta` file belong to an incomplete entry.
+      auto metaFile = withExtension(getBasePath(name), META_EXTENSION);
+      if (!std::filesystem::exists(metaFile)) {
+        ad_utility::deleteFile(path, false);
+      }
+      continue;
+    }
+    if (path.extension() != META_EXTENSION) {
+      // Leftovers of writes that were interrupted.
+      if (path.filename().string().find(".tmp-") != std::string::npos) {
+        ad_utility::deleteFile(path, false);
+      }
+      continue;
+    }
+    try {
+      ad_utility::serialization::FileReadSerializer serializer{path.string()};
+      std::string cacheKey;
+      std::string indexVersion;
+      serializer >> cacheKey;
+      serializer >> indexVersion;
+      if (indexVersion != indexVersion_ || getName(cacheKey) != name) {
+        deleteFiles(name);
+        continue;
+      }
+      auto size = fileSize(path) +
+                  fileSize(withExtension(getBasePath(name), IDTABLE_EXTENSION));
+      (*entries)[name] = Entry{std::move(cacheKey), size, 0};
+      entriesByWriteTime.emplace_back(
+          std::filesystem::last_write_time(path), name);
+    } catch (const std::exception& e) {
+      LOG(WARN) << "Could not read the entry " << path
+                << " of the persistent result cache, deleting it: " << e.what()
+                << std::endl;
+      deleteFiles(name);
+    }
+  }
+  // Initialize the LRU order by the time at which the entries were written.
+  std::ranges::sort(entriesByWriteTime);
+  for (const auto& name : entriesByWriteTime | std::views::values) {
+    (*entries)[name].lastAccess_ = accessCounter_++;
+  }
+  makeRoom(*entries, MemorySize::bytes(0));
+}
+
+// _____________________________________________________________________________
+void PersistentResultCache::write(const std::string& cacheKey,
+                                  const ResultTable& result,
+                                  const RuntimeInformation& runtimeInfo) {
+  AD_CONTRACT_CHECK(result.isFullyMaterialized());
+  auto name = getName(cacheKey);
+  {
+    auto entries = entries_.wlock();
+    if (auto it = entries->find(name);
+        it != entries->end() && it->second.cacheKey_ == cacheKey) {
+      it->second.lastAccess_ = accessCounter_++;
+      return;
+    }
+  }
+  const IdTable& idTable = result.idTable();
+  auto uncompressedSize = MemorySize::bytes(idTable.numRows() *
+                                            idTable.numColumns() * sizeof(Id));
+  if (uncompressedSize > MemorySize::bytes(maxSizeInBytes_.load())) {
+    return;
+  }
+
+  MetaData metaData;
+  metaData.cacheKey_ = cacheKey;
+  metaData.indexVersion_ = indexVersion_;
+  metaData.numColumns_ = idTable.numColumns();
+  metaData.numRows_ = idTable.numRows();
+  metaData.sortedBy_ = result.sortedBy();
+  const auto& localVocab = result.localVocab();
+  for (size_t i = 0; i < localVocab.size(); ++i) {
+    metaData.localVocab_.emplace_back(
+        localVocab.getWord(LocalVocabIndex::make(i)));
+  }
+  metaData.descriptor_ = runtimeInfo.descriptor_;
+  metaData.columnNames_ = runtimeInfo.columnNames_;
+  metaData.totalTimeInMs_ = runtimeInfo.totalTime_.count();
+  metaData.details_ = runtimeInfo.details_.dump();
+
+  // Write to temporary files first, s.t. concurrent readers never see an
+  // incomplete entry.
+  static std::atomic<size_t> tmpCounter = 0;
+  auto tmpSuffix = absl::StrCat(".tmp-", tmpCounter++);
+  auto basePath = getBasePath(name);
+  auto idTableFile = withExtension(basePath, IDTABLE_EXTENSION);
+  auto metaFile = withExtension(basePath, META_EXTENSION);
+  auto tmpIdTableFile = withExtension(idTableFile, tmpSuffix);
+  auto tmpMetaFile = withExtension(metaFile, tmpSuffix);
+  absl::Cleanup deleteTmpFiles{[&tmpIdTableFile, &tmpMetaFile]() {
+    ad_utility::deleteFile(tmpIdTableFile, false);
+    ad_utility::deleteFile(tmpMetaFile, false);
+  }};
+  // Tables without rows or columns are not supported by the
+  // `CompressedExternalIdTableWriter`, but they also don't need any data.
+  bool hasData = idTable.numRows() > 0 && idTable.numColumns() > 0;
+  if (hasData) {
+    Writer writer{tmpIdTableFile.string(), idTable.numColumns(),
+                  ad_utility::makeUnlimitedAllocator<Id>()};
+    writer.writeIdTable(idTable);
+    writer.flush();
+    writer.keepFileOnDestruction();
+    metaData.idTableMetadata_ = writer.getMetadata();
+  }
+  {
+    ad_utility::serialization::FileWriteSerializer serializer{
+        tmpMetaFile.string()};
+    serializer << metaData;
+  }
+  auto size = fileSize(tmpMetaFile) + fileSize(tmpIdTableFile);
+
+  auto entries = entries_.wlock();
+  entries->erase(name);
+  makeRoom(*entries, size);
+  if (hasData) {
+    std::filesystem::rename(tmpIdTableFile, idTableFile);
+  }
+  std::filesystem::rename(tmpMetaFile, metaFile);
+  (*entries)[name] = Entry{cacheKey, size, accessCounter_++};
+}
+
+// _____________________________________________________________________________
+void PersistentResultCache::writeInBackground(
+    std::string cacheKey, std::shared_ptr<const ResultTable> result,
+    RuntimeInformation runtimeInfo) {
+  if (numPendingWrites_.fetch_add(1) >= MAX_NUM_PENDING_WRITES) {
+    --numPendingWrites_;
+    LOG(DEBUG) << "Too many pending writes to the persistent result cache, "
+                  "the result is not written"
+               << std::endl;
+    return;
+  }
+  bool pushed = writeQueue_.push([this, cacheKey = std::move(cacheKey),
+                                  result = std::move(result),
+                                  runtimeInfo = std::move(runtimeInfo)]() {
+    absl::Cleanup decrement{[this]() { --numPendingWrites_; }};
+    try {
+      write(cacheKey, *result, runtimeInfo);
+    } catch (const std::exception& e) {
+      LOG(WARN) << "Writing a result to the persistent result cache failed: "
+                << e.what() << std::endl;
+    }
+  });
+  if (!pushed) {
+    --numPendingWrites_;
+  }
+}
+
+// _____________________________________________________________________________
+bool PersistentResultCache::contains(const std::string& cacheKey) const {
+  auto entries = entries_.rlock();
+  auto it = entries->find(getName(cacheKey));
+  return it != entries->end() && it->second.cacheKey_ == cacheKey;
+}
+
+// _____________________________________________________________________________
+std::optional<std::pair<ResultTable, RuntimeInformation>>
+PersistentResultCache::read(
+    const std::string& cacheKey,
+    const ad_utility::AllocatorWithLimit<Id>& allocator) {
+  auto name = getName(cacheKey);
+  {
+    auto entries = entries_.wlock();
+    auto it = entries->find(name);
+    if (it == entries->end() || it->second.cacheKey_ != cacheKey) {
+      return std::nullopt;
+    }
+    it->second.lastAccess_ = accessCounter_++;
+  }
+  auto basePath = getBasePath(name);
+  try {
+    MetaData metaData;
+    {
+      ad_utility::serialization::FileReadSerializer serializer{
+          withExtension(basePath, META_EXTENSION).string()};
+      serializer >> metaData;
+    }
+    AD_CORRECTNESS_CHECK(metaData.cacheKey_ == cacheKey &&
+                         metaData.indexVersion_ == indexVersion_);
+    IdTable idTable{metaData.numColumns_, allocator};
+    if (metaData.numRows_ > 0 && metaData.numColumns_ > 0) {
+      idTable.reserve(metaData.numRows_);
+      Writer reader{withExtension(basePath, IDTABLE_EXTENSION).string(),
+                    Writer::ReopenTag{}, std::move(metaData.idTableMetadata_),
+                    allocator};
+      auto generators = reader.getAllGenerators();
+      AD_CORRECTNESS_CHECK(generators.size() == 1);
+      for (const auto& block : generators.at(0)) {
+        idTable.insertAtEnd(block);
+      }
+    } else {
+      idTable.resize(metaData.numRows_);
+    }
+    AD_CORRECTNESS_CHECK(idTable.numRows() == metaData.numRows_);
+
+    // The words are added in the order of their indices, so the indices remain
+    // the same.
+    LocalVocab localVocab;
+    for (const auto& word : metaData.localVocab_) {
+      localVocab.getIndexAndAddIfNotContained(word);
+    }
+    AD_CORRECTNESS_CHECK(localVocab.size() == metaData.localVocab_.size());
+
+    RuntimeInformation runtimeInfo;
+    runtimeInfo.descriptor_ = std::move(metaData.descriptor_);
+    runtimeInfo.columnNames_ = std::move(metaData.columnNames_);
+    runtimeInfo.numRows_ = metaData.numRows_;
+    runtimeInfo.numCols_ = metaData.numColumns_;
+    runtimeInfo.totalTime_ =
+        std::chrono::milliseconds{metaData.totalTimeInMs_};
+    runtimeInfo.status_ = RuntimeInformation::Status::fullyMaterialized;
+    runtimeInfo.details_ = nlohmann::json::parse(metaData.details_);
+    runtimeInfo.addDetail("read-from-persistent-cache", true);
+    return std::pair{ResultTable{std::move(idTable),
+                                 std::move(metaData.sortedBy_),
+                                 std::move(localVocab)},
+                     std::move(runtimeInfo)};
+  } catch (const std::exception& e) {
+    LOG(WARN) << "Could not read the entry " << basePath
+              << " of the persistent result cache, deleting it: " << e.what()
+              << std::endl;
+    auto entries = entries_.wlock();
+    entries->erase(name);
+    deleteFiles(name);
+    return std::nullopt;
+  }
+}
+
+// _____________________________________________________________________________
+void PersistentResultCache::clear() {
+  auto entries = entries_.wlock();
+  for (const auto& name : *entries | std::views::keys) {
+    deleteFiles(name);
+  }
+  entries->clear();
+}
+
+// _____________________________________________________________________________
+void PersistentResultCache::setMaxSize(MemorySize maxSize) {
+  maxSizeInBytes_ = maxSize.getBytes();
+  makeRoom(*entries_.wlock(), MemorySize::bytes(0));
+}
+
+// _____________________________________________________________________________
+size_t PersistentResultCache::numEntries() const {
+  return entries_.rlock()->size();
+}
+
+// _____________________________________________________________________________
+MemorySize PersistentResultCache::size() const {
+  MemorySize result = MemorySize::bytes(0);
+  for (const auto& entry : *entries_.rlock() | std::views::values) {
+    result += entry.size_;
+  }
+  return result;
+}
@@ -0,0 +1,130 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "engine/ResultTable.h"
+#include "engine/RuntimeInformation.h"
+#include "util/AllocatorWithLimit.h"
+#include "util/HashMap.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Synchronized.h"
+#include "util/TaskQueue.h"
+
+// A second tier for the `QueryResultCache` that stores results on disk, s.t.
+// they survive a restart of the server. Each entry is identified by the cache
+// key of its operation (see `Operation::getCacheKey()`) and consists of two
+// files in the `directory` of the cache:
+// - `<name>.idtable` contains the `IdTable`, which is written and read via the
+//   `CompressedExternalIdTableWriter`.
+// - `<name>.meta` contains the cache key, the `indexVersion` (see below), the
+//   local vocabulary, the columns by which the result is sorted, and parts of
+//   the `RuntimeInformation` of the original computation. The `.meta` file is
+//   always written last, so an entry is only visible once it is complete.
+// The `<name>` is a stable hash of the cache key. All entries that were written
+// for a different `indexVersion` (e.g. for a rebuilt index or an incompatible
+// build of QLever) are deleted when the cache is opened. If the total size of
+// the files exceeds the `maxSize`, the least recently used entries are deleted.
+//
+// This class is threadsafe.
+class PersistentResultCache {
+ public:
+  // The maximal number of entries that are waiting to be written by
+  // `writeInBackground`. Further entries are dropped until the queue has room.
+  static constexpr size_t MAX_NUM_PENDING_WRITES = 8;
+
+ private:
+  // The entries that are currently contained in the cache.
+  struct Entry {
+    std::string cacheKey_;
+    ad_utility::MemorySize size_;
+    // A logical timestamp for the LRU eviction (larger is more recent).
+    size_t lastAccess_;
+  };
+  using Entries = ad_utility::HashMap<std::string, Entry>;
+
+  std::filesystem::path directory_;
+  std::string indexVersion_;
+  std::atomic<size_t> maxSizeInBytes_;
+  ad_utility::Synchronized<Entries> entries_;
+  std::atomic<size_t> accessCounter_ = 0;
+  std::atomic<size_t> numPendingWrites_ = 0;
+  // Must be the last member, s.t. the pending writes are finished before the
+  // other members are destroyed.
+  ad_utility::TaskQueue<> writeQueue_{MAX_NUM_PENDING_WRITES + 1, 1,
+                                      "PersistentResultCache"};
+
+ public:
+  // Open the cache in the `directory`, which is created if it doesn't exist.
+  // Existing entries for the same `indexVersion` are reused, all other entries
+  // are deleted.
+  PersistentResultCache(std::filesystem::path directory,
+                        std::string indexVersion,
+                        ad_utility::MemorySize maxSize);
+
+  // Store the `result` (which has to be fully materialized) under the
+  // `cacheKey`. If there already is an entry for the `cacheKey`, nothing is
+  // written, because the results for the same key are always the same. Results
+  // that are larger than the maximal size of the cache are ignored.
+  void write(const std::string& cacheKey, const ResultTable& result,
+             const RuntimeInformation& runtimeInfo);
+
+  // Call `write` in a background thread. This function never blocks, if too
+  // many writes are already pending, the `result` is not written.
+  void writeInBackground(std::string cacheKey,
+                         std::shared_ptr<const ResultTable> result,
+                         RuntimeInformation runtimeInfo);
+
+  // Return true iff there is an entry for the `cacheKey`.
+  bool contains(const std::string& cacheKey) const;
+
+  // Read the entry for the `cacheKey`. Return `std::nullopt` if there is no
+  // such entry or if it couldn't be read. The `IdTable` of the result is
+  // allocated using the `allocator`.
+  std::optional<std::pair<ResultTable, RuntimeInformation>> read(
+      const std::string& cacheKey,
+      const ad_utility::AllocatorWithLimit<Id>& allocator);
+
+  // Delete all the entries.
+  void clear();
+
+  // Change the maximal total size of the files of the cache.
+  void setMaxSize(ad_utility::MemorySize maxSize);
+
+  // Statistics for `cmd=cache-stats`.
+  size_t numEntries() const;
+  ad_utility::MemorySize size() const;
+
+  // Block until all the writes that were started via `writeInBackground` are
+  // finished. No more calls to `writeInBackground` are allowed afterwards.
+  void finishPendingWrites() { writeQueue_.finish(); }
+
+ private:
+  // The name of the entry for the `cacheKey`, which is a stable hash of the
+  // key (see above).
+  static std::string getName(const std::string& cacheKey);
+
+  // The path of the files of the entry with the `name` without the extension.
+  std::filesystem::path getBasePath(const std::string& name) const {
+    return directory_ / name;
+  }
+
+  // Delete the least recently used entries until the total size of the
+  // remaining entries is at most the maximal size of the cache minus
+  // `sizeToMakeRoomFor`.
+  void makeRoom(Entries& entries, ad_utility::MemorySize sizeToMakeRoomFor);
+
+  // Delete the files of the entry with the `name`.
+  void deleteFiles(const std::string& name) const;
+
+  // Read the entries in the `directory_` and remove the ones that were written
+  // for a different index version or are incomplete.
+  void readExistingEntries();
+};
@@ -6,12 +6,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
 #include <shared_mutex>
 #include <string>
 #include <vector>
 
+#include "engine/CompressedResultTable.h"
 #include "engine/Engine.h"
+#include "engine/PersistentResultCache.h"
+#include "engine/QueryHints.h"
 #include "engine/QueryPlanningCostFactors.h"
 #include "engine/ResultTable.h"
 #include "engine/RuntimeInformation.h"
@@ -21,7 +30,11 @@
 #include "index/Index.h"
 #include "util/Cache.h"
 #include "util/ConcurrentCache.h"
+#include "util/Forward.h"
+#include "util/HashMap.h"
 #include "util/Log.h"
+#include "util/Metrics.h"
+#include "util/QueryTrace.h"
 #include "util/Synchronized.h"
 #include "util/http/websocket/QueryId.h"
 
@@ -31,7 +44,18 @@ using std::vector;
 
 class CacheValue {
  private:
+  // The result, or `nullptr` if the result is stored compressed.
   std::shared_ptr<const ResultTable> _resultTable;
+  // The compressed result (see `CompressedResultTable`) or `nullptr`.
+  std::shared_ptr<const CompressedResultTable> _compressedResult;
+  // The decompressed `_compressedResult` as long as it is still used by some
+  // query, s.t. concurrent users of the same entry share it instead of
+  // decompressing it again.
+  struct Decompressed {
+    std::mutex mutex_;
+    std::weak_ptr<const ResultTable> result_;
+  };
+  std::unique_ptr<Decompressed> _decompressed;
   RuntimeInformation _runtimeInfo;
 
  public:
@@ -40,15 +64,75 @@ class CacheValue {
             std::make_shared<const ResultTable>(std::move(resultTable))),
         _runtimeInfo(std::move(runtimeInfo)) {}
 
-  const shared_ptr<const ResultTable>& resultTable() const {
-    return _resultTable;
+  // Share a `resultTable` that is already stored in a different `CacheValue`.
+  explicit CacheValue(std::shared_ptr<const ResultTable> resultTable,
+                      RuntimeInformation runtimeInfo)
+      : _resultTable(std::move(resultTable)),
+        _runtimeInfo(std::move(runtimeInfo)) {}
+
+  // Store the `resultTable` compressed. The `resultTable` itself is not kept
+  // alive by the `CacheValue`, but it is returned by `resultTable()` as long
+  // as it is still used elsewhere (e.g. by the query that computed it).
+  static CacheValue makeCompressed(
+      const std::shared_ptr<const ResultTable>& resultTable,
+      RuntimeInformation runtimeInfo) {
+    CacheValue value{nullptr, std::move(runtimeInfo)};
+    value._compressedResult =
+        std::make_shared<const CompressedResultTable>(*resultTable);
+    value._decompressed = std::make_unique<Decompressed>();
+    value._decompressed->result_ = resultTable;
+    return value;
+  }
+
+  // Return a `CacheValue` with the same (possibly compressed) result, but with
+  // the given `runtimeInfo`.
+  CacheValue shareResult(RuntimeInformation runtimeInfo) const {
+    CacheValue value{_resultTable, std::move(runtimeInfo)};
+    if (_compressedResult) {
+      value._compressedResult = _compressedResult;
+      value._decompressed = std::make_unique<Decompressed>();
+      std::lock_guard lock{_decompressed->mutex_};
+      value._decompressed->result_ = _decompressed->result_;
+    }
+    return value;
+  }
+
+  // Return the result. A compressed result is decompressed if it is not
+  // currently used elsewhere.
+  std::shared_ptr<const ResultTable> resultTable() const {
+    if (!_compressedResult) {
+      return _resultTable;
+    }
+    std::lock_guard lock{_decompressed->mutex_};
+    auto result = _decompressed->result_.lock();
+    if (!result) {
+      auto allocator = ad_utility::makeUnlimitedAllocator<Id>();
+      result = std::make_shared<const ResultTable>(
+          _compressedResult->decompress(allocator));
+      _decompressed->result_ = result;
+    }
+    return result;
   }
 
+  bool isCompressed() const { return _compressedResult != nullptr; }
+
   const RuntimeInformation& runtimeInfo() const { return _runtimeInfo; }
 
-  // Calculates the `MemorySize` taken up by an instance of `CacheValue`.
+  // The time that was needed to compute the result of a `CacheValue`, which is
+  // used by the `CostAwareCache`.
+  struct CostGetter {
+    std::chrono::milliseconds operator()(const CacheValue& cacheValue) const {
+      return cacheValue._runtimeInfo.totalTime_;
+    }
+  };
+
+  // Calculates the `MemorySize` taken up by an instance of `CacheValue`. For a
+  // compressed result, this is the size of the compressed blocks.
   struct SizeGetter {
     ad_utility::MemorySize operator()(const CacheValue& cacheValue) const {
+      if (const auto& compressed = cacheValue._compressedResult; compressed) {
+        return compressed->compressedSize();
+      }
       if (const auto& tablePtr = cacheValue._resultTable; tablePtr) {
         return ad_utility::MemorySize::bytes(tablePtr->size() *
                                              tablePtr->width() * sizeof(Id));
@@ -59,29 +143,231 @@ class CacheValue {
   };
 };
 
-// Threadsafe LRU cache for (partial) query results, that
-// checks on insertion, if the result is currently being computed
-// by another query.
-using ConcurrentLruCache = ad_utility::ConcurrentCache<
-    ad_utility::LRUCache<string, CacheValue, CacheValue::SizeGetter>>;
+// Threadsafe cache for (partial) query results, that checks on insertion, if
+// the result is currently being computed by another query. Despite its name,
+// the eviction policy can be changed at runtime (see `EvictionPolicy`), the
+// default is LRU. The cache is sharded by the hash of the cache keys, s.t.
+// concurrent queries rarely wait for the same lock.
+using ConcurrentLruCache =
+    ad_utility::ShardedConcurrentCache<ad_utility::CostAwareCache<
+        string, CacheValue, CacheValue::SizeGetter, CacheValue::CostGetter>>;
 using PinnedSizes =
     ad_utility::Synchronized<ad_utility::HashMap<std::string, size_t>,
                              std::shared_mutex>;
 class QueryResultCache : public ConcurrentLruCache {
  private:
   PinnedSizes _pinnedSizes;
+  // The optional second tier of the cache on disk. If it is set, the entries
+  // that are evicted from the (in-memory) cache are written to it, and it is
+  // consulted before a result is computed (see `Operation::getResult`).
+  std::unique_ptr<PersistentResultCache> persistentCache_;
+
+  // The bidirectional mapping between the partial cache keys and the keys of
+  // the cached results that are registered under them (see
+  // `registerPartialKeys` below).
+  class PartialKeys {
+    ad_utility::HashMap<std::string, std::vector<std::string>>
+        partialToCacheKeys_;
+    ad_utility::HashMap<std::string, std::vector<std::string>>
+        cacheToPartialKeys_;
+
+   public:
+    void add(const std::string& cacheKey,
+             const std::vector<std::string>& partialKeys) {
+      if (cacheToPartialKeys_.contains(cacheKey)) {
+        return;
+      }
+      cacheToPartialKeys_[cacheKey] = partialKeys;
+      for (const auto& partialKey : partialKeys) {
+        partialToCacheKeys_[partialKey].push_back(cacheKey);
+      }
+    }
+    void erase(const std::string& cacheKey) {
+      auto it = cacheToPartialKeys_.find(cacheKey);
+      if (it == cacheToPartialKeys_.end()) {
+        return;
+      }
+      for (const auto& partialKey : it->second) {
+        auto& cacheKeys = partialToCacheKeys_[partialKey];
+        std::erase(cacheKeys, cacheKey);
+        if (cacheKeys.empty()) {
+          partialToCacheKeys_.erase(partialKey);
+        }
+      }
+      cacheToPartialKeys_.erase(it);
+    }
+    std::vector<std::string> getCacheKeys(const std::string& partialKey) const {
+      auto it = partialToCacheKeys_.find(partialKey);
+      return it == partialToCacheKeys_.end() ? std::vector<std::string>{}
+                                              : it->second;
+    }
+    void clear() {
+      partialToCacheKeys_.clear();
+      cacheToPartialKeys_.clear();
+    }
+  };
+  ad_utility::Synchronized<PartialKeys, std::mutex> partialKeys_;
+
+  // The queries whose results are stored in the cache, by the cache keys of
+  // these results (see `registerQuery` below).
+  ad_utility::Synchronized<ad_utility::HashMap<std::string, std::string>,
+                           std::mutex>
+      queries_;
+
+  // The statistics of the cache (exported by the `/metrics` endpoint).
+  ad_utility::metrics::Counter numHits_;
+  ad_utility::metrics::Counter numMisses_;
+  ad_utility::metrics::Counter numEvictions_;
+
+  // The result is evicted from the cache: Remove it from the `partialKeys_`
+  // and write it to the persistent cache (if it exists).
+  void onEviction(const std::string& key,
+                  const std::shared_ptr<const CacheValue>& value) {
+    numEvictions_.increment();
+    partialKeys_.withWriteLock(
+        [&key](PartialKeys& partialKeys) { partialKeys.erase(key); });
+    queries_.wlock()->erase(key);
+    if (persistentCache_) {
+      persistentCache_->writeInBackground(key, value->resultTable(),
+                                          value->runtimeInfo());
+    }
+  }
 
  public:
+  QueryResultCache() {
+    setOnEviction([this](const std::string& key,
+                         const std::shared_ptr<const CacheValue>& value) {
+      onEviction(key, value);
+    });
+  }
   virtual ~QueryResultCache() = default;
+
+  // Count a lookup of a result in the cache (`isHit` is true if the result
+  // was cached, either in memory or in the persistent cache).
+  void countLookup(bool isHit) { (isHit ? numHits_ : numMisses_).increment(); }
+  uint64_t numHits() const { return numHits_.value(); }
+  uint64_t numMisses() const { return numMisses_.value(); }
+  uint64_t numEvictions() const { return numEvictions_.value(); }
+
+  // Set (or unset if `nullptr`) the persistent second tier of the cache. This
+  // is not threadsafe w.r.t. the eviction of entries and must therefore be
+  // called before the cache is used.
+  void setPersistentCache(
+      std::unique_ptr<PersistentResultCache> persistentCache) {
+    persistentCache_ = std::move(persistentCache);
+  }
+  PersistentResultCache* persistentCache() { return persistentCache_.get(); }
+  const PersistentResultCache* persistentCache() const {
+    return persistentCache_.get();
+  }
+
+  // Register the result with the `cacheKey` under the `partialKeys` (see
+  // `Operation::getPartialCacheKeys`). The registration is removed when the
+  // result is evicted from the cache.
+  void registerPartialKeys(const std::string& cacheKey,
+                           const std::vector<std::string>& partialKeys) {
+    if (partialKeys.empty()) {
+      return;
+    }
+    partialKeys_.wlock()->add(cacheKey, partialKeys);
+  }
+
+  // Return a cached result that is registered under the `partialKey`, or
+  // `std::nullopt` if there is none.
+  std::optional<ResultAndCacheStatus> getIfContainedPartially(
+      const std::string& partialKey) {
+    // Copy the candidates s.t. the lock of the `partialKeys_` is not held
+    // while the cache is locked (the eviction acquires the locks in the
+    // opposite order).
+    auto candidates = partialKeys_.wlock()->getCacheKeys(partialKey);
+    std::optional<ResultAndCacheStatus> result;
+    std::vector<std::string> staleKeys;
+    for (const auto& cacheKey : candidates) {
+      result = getIfContained(cacheKey);
+      if (result.has_value()) {
+        break;
+      }
+      // The result was removed from the cache without being evicted (e.g. by
+      // `clearUnpinnedOnly`) or was never inserted because it is too large.
+      staleKeys.push_back(cacheKey);
+    }
+    if (!staleKeys.empty()) {
+      auto lock = partialKeys_.wlock();
+      for (const auto& cacheKey : staleKeys) {
+        lock->erase(cacheKey);
+      }
+    }
+    return result;
+  }
+
+  // Register that the result with the `cacheKey` is the result of the whole
+  // `query`. The registration is removed when the result is evicted from the
+  // cache. This is used to compute the same results for a new index (see
+  // `Server::swapIndex`).
+  void registerQuery(const std::string& cacheKey, const std::string& query) {
+    // Results that were not cached (e.g. because they are too large) are not
+    // registered, s.t. the `queries_` don't grow without bounds.
+    if (!cacheContains(cacheKey)) {
+      return;
+    }
+    queries_.wlock()->insert_or_assign(cacheKey, query);
+  }
+
+  // A registered query and whether its result is pinned.
+  struct CachedQuery {
+    std::string query_;
+    bool isPinned_;
+  };
+
+  // Return at most `maxNumQueries` of the registered queries whose results
+  // are still in the cache: first the ones with pinned results, then the ones
+  // whose results took the longest to compute.
+  std::vector<CachedQuery> getCachedQueries(size_t maxNumQueries) {
+    // Copy the registered queries s.t. the lock is not held while the cache
+    // is locked (see `getIfContainedPartially`).
+    auto queries = *queries_.wlock();
+    std::vector<std::pair<CachedQuery, std::chrono::milliseconds>> candidates;
+    std::vector<std::string> staleKeys;
+    for (auto& [cacheKey, query] : queries) {
+      auto result = getIfContained(cacheKey);
+      if (!result.has_value()) {
+        staleKeys.push_back(cacheKey);
+        continue;
+      }
+      bool isPinned =
+          result->_cacheStatus == ad_utility::CacheStatus::cachedPinned;
+      candidates.emplace_back(CachedQuery{std::move(query), isPinned},
+                              result->_resultPointer->runtimeInfo().totalTime_);
+    }
+    if (!staleKeys.empty()) {
+      auto lock = queries_.wlock();
+      for (const auto& cacheKey : staleKeys) {
+        lock->erase(cacheKey);
+      }
+    }
+    std::ranges::sort(candidates, std::greater{}, [](const auto& candidate) {
+      return std::pair{candidate.first.isPinned_, candidate.second};
+    });
+    std::vector<CachedQuery> result;
+    for (auto& [query, time] : candidates | std::views::take(maxNumQueries)) {
+      result.push_back(std::move(query));
+    }
+    return result;
+  }
+
   void clearAll() override {
     // The _pinnedSizes are not part of the (otherwise threadsafe) _cache
     // and thus have to be manually locked.
     auto lock = _pinnedSizes.wlock();
     ConcurrentLruCache::clearAll();
     lock->clear();
+    partialKeys_.wlock()->clear();
+    queries_.wlock()->clear();
+    if (persistentCache_) {
+      persistentCache_->clear();
+    }
   }
-  // Inherit the constructor.
-  using ConcurrentLruCache::ConcurrentLruCache;
+
   const PinnedSizes& pinnedSizes() const { return _pinnedSizes; }
   PinnedSizes& pinnedSizes() { return _pinnedSizes; }
   std::optional<size_t> getPinnedSize(const std::string& key) {
@@ -110,6 +396,7 @@ class QueryExecutionContext {
         _index(index),
         _subtreeCache(cache),
         _allocator(std::move(allocator)),
+        _temporaryAllocator(ad_utility::makeTemporaryAllocator(_allocator)),
         _costFactors(),
         _sortPerformanceEstimator(sortPerformanceEstimator),
         updateCallback_(std::move(updateCallback)) {}
@@ -133,15 +420,65 @@ class QueryExecutionContext {
     return _allocator;
   }
 
+  // An allocator with the same limit as `getAllocator()` that allocates from
+  // an arena of this context (see `QueryMemoryArena`). Use it only for the
+  // temporary `IdTable`s of the operations, and never for the results (which
+  // can outlive the query in the cache).
+  const ad_utility::AllocatorWithLimit<Id>& getTemporaryAllocator() {
+    return _temporaryAllocator;
+  }
+
   /// Function that serializes the given RuntimeInformation to JSON and
   /// calls the updateCallback with this JSON string.
   /// This is used to broadcast updates of any query to a third party
   /// while it's still running.
-  /// \param runtimeInformation The `RuntimeInformation` to serialize
+  /// The updates are rate-limited: While the query is still running, an
+  /// update is dropped (and not even serialized) if the previous one was sent
+  /// less than `websocket-update-interval` ago. The final update (the root
+  /// operation has finished or failed) is always sent.
+  /// \param runtimeInformation The `RuntimeInformation` of the root operation
   void signalQueryUpdate(const RuntimeInformation& runtimeInformation) const {
+    using enum RuntimeInformation::Status;
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto last = lastQueryUpdate_.time_.load(std::memory_order_relaxed);
+    bool isFinal = runtimeInformation.status_ != notStarted &&
+                   runtimeInformation.status_ != inProgress;
+    if (isFinal) {
+      lastQueryUpdate_.time_.store(now, std::memory_order_relaxed);
+    } else {
+      auto interval = std::chrono::steady_clock::duration{
+          RuntimeParameters().get<"websocket-update-interval">()};
+      if (last != 0 && now - last < interval.count()) {
+        return;
+      }
+      // Of several concurrent updates only one is sent.
+      if (!lastQueryUpdate_.time_.compare_exchange_strong(last, now)) {
+        return;
+      }
+    }
     updateCallback_(nlohmann::ordered_json(runtimeInformation).dump());
   }
 
+  // The trace of the query (see `ad_utility::QueryTrace`), or `nullptr` if the
+  // query is not traced, which is the default.
+  ad_utility::QueryTrace* getTrace() const { return trace_.get(); }
+  void setTrace(std::shared_ptr<ad_utility::QueryTrace> trace) {
+    trace_ = std::move(trace);
+  }
+
+  // The hints for the execution of this query (see `QueryHints`).
+  const QueryHints& getQueryHints() const { return queryHints_; }
+  void setQueryHints(QueryHints queryHints) {
+    queryHints_ = std::move(queryHints);
+  }
+
+  // The number of threads for a task of an operation, for which the runtime
+  // parameters allow `numThreadsFromParameter` threads. The `numThreads_` of
+  // the `QueryHints` take precedence.
+  size_t getNumThreads(size_t numThreadsFromParameter) const {
+    return queryHints_.numThreads_.value_or(numThreadsFromParameter);
+  }
+
   bool _pinSubtrees;
   bool _pinResult;
 
@@ -150,7 +487,20 @@ class QueryExecutionContext {
   QueryResultCache* const _subtreeCache;
   // allocators are copied but hold shared state
   ad_utility::AllocatorWithLimit<Id> _allocator;
+  ad_utility::AllocatorWithLimit<Id> _temporaryAllocator;
   QueryPlanningCostFactors _costFactors;
   SortPerformanceEstimator _sortPerformanceEstimator;
   std::function<void(std::string)> updateCallback_;
+  // The time (`std::chrono::steady_clock` ticks, 0 if there was none) at which
+  // the last update was passed to the `updateCallback_`. A copy of the context
+  // starts without a previous update.
+  struct LastQueryUpdate {
+    std::atomic<std::chrono::steady_clock::rep> time_ = 0;
+    LastQueryUpdate() = default;
+    LastQueryUpdate(const LastQueryUpdate&) {}
+    LastQueryUpdate& operator=(const LastQueryUpdate&) { return *this; }
+  };
+  mutable LastQueryUpdate lastQueryUpdate_;
+  std::shared_ptr<ad_utility::QueryTrace> trace_;
+  QueryHints queryHints_;
 };
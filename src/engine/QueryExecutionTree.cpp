@@ -19,15 +19,19 @@
 #include "engine/Filter.h"
 #include "engine/GroupBy.h"
 #include "engine/HasPredicateScan.h"
+#include "engine/IndexNestedLoopJoin.h"
 #include "engine/IndexScan.h"
 #include "engine/Join.h"
 #include "engine/Minus.h"
 #include "engine/MultiColumnJoin.h"
+#include "engine/MultiPredicateScan.h"
 #include "engine/NeutralElementOperation.h"
 #include "engine/OptionalJoin.h"
 #include "engine/OrderBy.h"
+#include "engine/SemiJoin.h"
 #include "engine/Service.h"
 #include "engine/Sort.h"
+#include "engine/SpatialJoin.h"
 #include "engine/TextIndexScanForEntity.h"
 #include "engine/TextIndexScanForWord.h"
 #include "engine/TextOperationWithFilter.h"
@@ -36,6 +40,7 @@
 #include "engine/Union.h"
 #include "engine/Values.h"
 #include "engine/ValuesForTesting.h"
+#include "engine/WorstCaseOptimalJoin.h"
 #include "parser/RdfEscaping.h"
 
 using std::string;
@@ -92,15 +97,17 @@ QueryExecutionTree::selectedVariablesToColumnIndices(
 
 // _____________________________________________________________________________
 size_t QueryExecutionTree::getCostEstimate() {
-  if (cachedResult_) {
-    // result is pinned in cache. Nothing to compute
-    return 0;
-  }
-  if (type_ == QueryExecutionTree::SCAN && getResultWidth() == 1) {
-    return getSizeEstimate();
-  } else {
-    return rootOperation_->getCostEstimate();
+  if (!costEstimate_.has_value()) {
+    if (cachedResult_) {
+      // result is pinned in cache. Nothing to compute
+      costEstimate_ = 0;
+    } else if (type_ == QueryExecutionTree::SCAN && getResultWidth() == 1) {
+      costEstimate_ = getSizeEstimate();
+    } else {
+      costEstimate_ = rootOperation_->getCostEstimate();
+    }
   }
+  return costEstimate_.value();
 }
 
 // _____________________________________________________________________________
@@ -139,8 +146,19 @@ void QueryExecutionTree::readFromCache() {
   }
   auto& cache = qec_->getQueryTreeCache();
   auto res = cache.getIfContained(getCacheKey());
+  // A result that is registered under the partial cache key of the operation
+  // has the same size and can also be reused (see
+  // `Operation::getResultFromCachedSuperset`).
+  if (!res.has_value()) {
+    auto partialKey = rootOperation_->getPartialCacheKeyForLookup();
+    if (partialKey.has_value()) {
+      res = cache.getIfContainedPartially(partialKey.value());
+    }
+  }
   if (res.has_value()) {
     cachedResult_ = res->_resultPointer->resultTable();
+    sizeEstimate_ = std::nullopt;
+    costEstimate_ = std::nullopt;
   }
 }
 
@@ -195,6 +213,16 @@ void QueryExecutionTree::setOperation(std::shared_ptr<Op> operation) {
     type_ = DUMMY;
   } else if constexpr (std::is_same_v<Op, CartesianProductJoin>) {
     type_ = CARTESIAN_PRODUCT_JOIN;
+  } else if constexpr (std::is_same_v<Op, WorstCaseOptimalJoin>) {
+    type_ = WORST_CASE_OPTIMAL_JOIN;
+  } else if constexpr (std::is_same_v<Op, SemiJoin>) {
+    type_ = SEMI_JOIN;
+  } else if constexpr (std::is_same_v<Op, IndexNestedLoopJoin>) {
+    type_ = INDEX_NESTED_LOOP_JOIN;
+  } else if constexpr (std::is_same_v<Op, SpatialJoin>) {
+    type_ = SPATIAL_JOIN;
+  } else if constexpr (std::is_same_v<Op, MultiPredicateScan>) {
+    type_ = MULTI_PREDICATE_SCAN;
   } else {
     static_assert(ad_utility::alwaysFalse<Op>,
                   "New type of operation that was not yet registered");
@@ -239,6 +267,14 @@ template void QueryExecutionTree::setOperation(
     std::shared_ptr<ValuesForTestingNoKnownEmptyResult>);
 template void QueryExecutionTree::setOperation(
     std::shared_ptr<CartesianProductJoin>);
+template void QueryExecutionTree::setOperation(
+    std::shared_ptr<WorstCaseOptimalJoin>);
+template void QueryExecutionTree::setOperation(std::shared_ptr<SemiJoin>);
+template void QueryExecutionTree::setOperation(
+    std::shared_ptr<IndexNestedLoopJoin>);
+template void QueryExecutionTree::setOperation(std::shared_ptr<SpatialJoin>);
+template void QueryExecutionTree::setOperation(
+    std::shared_ptr<MultiPredicateScan>);
 
 // ________________________________________________________________________________________________________________
 std::shared_ptr<QueryExecutionTree> QueryExecutionTree::createSortedTree(
@@ -60,7 +60,12 @@ class QueryExecutionTree {
     MINUS,
     NEUTRAL_ELEMENT,
     DUMMY,
-    CARTESIAN_PRODUCT_JOIN
+    CARTESIAN_PRODUCT_JOIN,
+    WORST_CASE_OPTIMAL_JOIN,
+    SEMI_JOIN,
+    INDEX_NESTED_LOOP_JOIN,
+    SPATIAL_JOIN,
+    MULTI_PREDICATE_SCAN
   };
 
   template <typename Op>
@@ -95,8 +100,12 @@ class QueryExecutionTree {
 
   size_t getResultWidth() const { return rootOperation_->getResultWidth(); }
 
-  shared_ptr<const ResultTable> getResult() const {
-    return rootOperation_->getResult(isRoot());
+  // Get the result of the root operation. If `requestLaziness` is true, the
+  // result might be lazy (see `ComputationMode::LAZY_IF_SUPPORTED`).
+  shared_ptr<const ResultTable> getResult(bool requestLaziness = false) const {
+    return rootOperation_->getResult(
+        isRoot(), requestLaziness ? ComputationMode::LAZY_IF_SUPPORTED
+                                  : ComputationMode::FULLY_MATERIALIZED);
   }
 
   // A variable, its column index in the Id space result, and the `ResultType`
@@ -121,6 +130,14 @@ class QueryExecutionTree {
   void setTextLimit(size_t limit) {
     rootOperation_->setTextLimit(limit);
     sizeEstimate_ = std::nullopt;
+    costEstimate_ = std::nullopt;
+  }
+
+  // Set the LIMIT and OFFSET of the root operation. The size estimate is not
+  // changed by this, but the cost estimate may depend on the limit.
+  void setLimit(const LimitOffsetClause& limitOffset) {
+    rootOperation_->setLimit(limitOffset);
+    costEstimate_ = std::nullopt;
   }
 
   size_t getCostEstimate();
@@ -143,7 +160,9 @@ class QueryExecutionTree {
   // Try to find the result for this tree in the LRU cache
   // of our qec. If found, we store a shared ptr to pin it
   // and set the size estimate correctly and the cost estimate
-  // to zero. Currently multiplicities are not affected
+  // to zero. Currently multiplicities are not affected. Results that are
+  // registered under the partial cache key of the root operation are also
+  // found.
   void readFromCache();
 
   // recursively get all warnings from descendant operations
@@ -238,6 +257,10 @@ class QueryExecutionTree {
       nullptr;  // Owned child. Will be deleted at deconstruction.
   OperationType type_ = OperationType::UNDEFINED;
   std::optional<size_t> sizeEstimate_ = std::nullopt;
+  // The cost estimate is also memoized, because the query planner asks for
+  // the costs of the same subtrees many times (the cost of an operation
+  // includes the costs of its children).
+  std::optional<size_t> costEstimate_ = std::nullopt;
   bool isRoot_ = false;  // used to distinguish the root from child
                          // operations/subtrees when pinning only the result.
 
@@ -0,0 +1,73 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/QueryHints.h"
+
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_cat.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Return the value of the one of the `options` that has the same name as the
+// URL parameter `key`, or `defaultValue` if the parameter isn't set.
+template <typename T>
+T getOption(const ad_utility::HashMap<std::string, std::string>& parameters,
+            const std::string& key,
+            const std::vector<std::pair<std::string, T>>& options,
+            T defaultValue) {
+  auto it = parameters.find(key);
+  if (it == parameters.end()) {
+    return defaultValue;
+  }
+  std::string names;
+  for (const auto& [name, value] : options) {
+    if (name == it->second) {
+      return value;
+    }
+    absl::StrAppend(&names, names.empty() ? "" : ", ", "\"", name, "\"");
+  }
+  throw std::runtime_error{absl::StrCat("The value of the parameter \"", key,
+                                        "\" must be one of ", names,
+                                        ", but was \"", it->second, "\"")};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+QueryHints QueryHints::fromParameters(
+    const ad_utility::HashMap<std::string, std::string>& parameters) {
+  QueryHints hints;
+  if (auto it = parameters.find("num-threads"); it != parameters.end()) {
+    size_t numThreads = 0;
+    if (!absl::SimpleAtoi(it->second, &numThreads) || numThreads == 0) {
+      throw std::runtime_error{absl::StrCat(
+          "The value of the parameter \"num-threads\" must be a positive "
+          "integer, but was \"",
+          it->second, "\"")};
+    }
+    hints.numThreads_ = numThreads;
+  }
+  if (auto it = parameters.find("memory-limit"); it != parameters.end()) {
+    hints.memoryLimit_ = ad_utility::MemorySize::parse(it->second);
+  }
+  using enum JoinStrategy;
+  hints.joinStrategy_ = getOption<JoinStrategy>(
+      parameters, "join-strategy",
+      {{"auto", Auto},
+       {"merge", Merge},
+       {"index-nested-loop", IndexNestedLoop},
+       {"hash", Hash}},
+      Auto);
+  hints.cacheMode_ = getOption<CacheMode>(parameters, "cache",
+                                          {{"default", CacheMode::Default},
+                                           {"no-store", CacheMode::NoStore},
+                                           {"bypass", CacheMode::Bypass}},
+                                          CacheMode::Default);
+  hints.approximate_ = getOption<bool>(
+      parameters, "approximate", {{"true", true}, {"false", false}}, false);
+  if (hints.approximate_ && hints.cacheMode_ == CacheMode::Default) {
+    hints.cacheMode_ = CacheMode::NoStore;
+  }
+  return hints;
+}
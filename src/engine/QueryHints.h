@@ -0,0 +1,56 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "util/HashMap.h"
+#include "util/MemorySize/MemorySize.h"
+
+// Hints for the execution of a single query, which are given by URL parameters
+// of the request and take precedence over the (global) runtime parameters for
+// this query. They are stored in the `QueryExecutionContext` of the query.
+struct QueryHints {
+  // The join algorithms that the `QueryPlanner` uses.
+  enum class JoinStrategy {
+    // The cheapest plan is chosen as usual.
+    Auto,
+    // Only joins of sorted inputs are used (no index nested loop joins and no
+    // worst-case optimal joins), and duplicates are removed by sorting.
+    Merge,
+    // An index nested loop join is used whenever it is applicable, regardless
+    // of the size of its left input.
+    IndexNestedLoop,
+    // Duplicates are removed and groups are aggregated via hash maps whenever
+    // this is possible.
+    Hash
+  };
+  enum class CacheMode {
+    Default,
+    // Results are read from the cache, but new results are not stored in it.
+    NoStore,
+    // The cache is neither read nor written.
+    Bypass
+  };
+
+  // Overrides the runtime parameters for the number of threads of the
+  // operations (e.g. `join-num-threads` or `sort-num-threads`).
+  std::optional<size_t> numThreads_;
+  // The query gets its own memory budget instead of sharing the memory limit
+  // of the server with all other queries.
+  std::optional<ad_utility::MemorySize> memoryLimit_;
+  JoinStrategy joinStrategy_ = JoinStrategy::Auto;
+  CacheMode cacheMode_ = CacheMode::Default;
+  // `COUNT(DISTINCT ...)` is estimated like `ql:approx-count-distinct`.
+  // Approximate results are never stored in the cache.
+  bool approximate_ = false;
+
+  // Read the hints from the URL parameters `num-threads`, `memory-limit`,
+  // `join-strategy` (`auto`, `merge`, `index-nested-loop`, or `hash`), `cache`
+  // (`default`, `no-store`, or `bypass`), and `approximate` (`true` or
+  // `false`). Throw `std::runtime_error` if a value is invalid.
+  static QueryHints fromParameters(
+      const ad_utility::HashMap<std::string, std::string>& parameters);
+};
@@ -7,7 +7,9 @@
 #include "engine/QueryPlanner.h"
 
 #include <algorithm>
+#include <bit>
 #include <ctime>
+#include <limits>
 
 #include "engine/Bind.h"
 #include "engine/CartesianProductJoin.h"
@@ -17,15 +19,19 @@
 #include "engine/Filter.h"
 #include "engine/GroupBy.h"
 #include "engine/HasPredicateScan.h"
+#include "engine/IndexNestedLoopJoin.h"
 #include "engine/IndexScan.h"
 #include "engine/Join.h"
 #include "engine/Minus.h"
 #include "engine/MultiColumnJoin.h"
+#include "engine/MultiPredicateScan.h"
 #include "engine/NeutralElementOperation.h"
 #include "engine/OptionalJoin.h"
 #include "engine/OrderBy.h"
+#include "engine/SemiJoin.h"
 #include "engine/Service.h"
 #include "engine/Sort.h"
+#include "engine/SpatialJoin.h"
 #include "engine/TextIndexScanForEntity.h"
 #include "engine/TextIndexScanForWord.h"
 #include "engine/TextOperationWithFilter.h"
@@ -33,12 +39,30 @@
 #include "engine/TransitivePath.h"
 #include "engine/Union.h"
 #include "engine/Values.h"
+#include "engine/WorstCaseOptimalJoin.h"
 #include "parser/Alias.h"
 #include "parser/SparqlParserHelpers.h"
+#include "util/ParallelExecution.h"
 
 namespace p = parsedQuery;
 namespace {
 
+// Subtrees with an actual and estimated size below this threshold never
+// trigger a re-optimization (see `materializeUnreliableSubtrees`).
+constexpr double MIN_SIZE_FOR_REPLANNING = 10'000;
+
+// The number of distinct seeds of the dynamic programming that the `plans`
+// consist of. There can be multiple plans for the same seed, e.g. index scans
+// with different permutations.
+size_t countDistinctSeeds(const std::vector<QueryPlanner::SubtreePlan>& plans) {
+  ad_utility::HashSet<uint64_t> uniqueNodeIds;
+  std::ranges::copy(
+      plans | std::views::transform(
+                  &QueryPlanner::SubtreePlan::_idsOfIncludedNodes),
+      std::inserter(uniqueNodeIds, uniqueNodeIds.end()));
+  return uniqueNodeIds.size();
+}
+
 using ad_utility::makeExecutionTree;
 
 template <typename Operation>
@@ -140,8 +164,21 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createExecutionTrees(
   vector<SubtreePlan>& lastRow = plans.back();
 
   for (auto& plan : lastRow) {
-    if (plan._qet->getRootOperation()->supportsLimit()) {
-      plan._qet->getRootOperation()->setLimit(pq._limitOffset);
+    auto root = plan._qet->getRootOperation();
+    if (root->supportsLimit()) {
+      plan._qet->setLimit(pq._limitOffset);
+    } else if (pq._limitOffset._limit.has_value()) {
+      // With a `LIMIT`, only the first `LIMIT + OFFSET` rows of the result
+      // have to be computed. An `ORDER BY` only sorts these rows (see
+      // `OrderBy::computeTopK`), and all other operations stop computing
+      // their lazy result as soon as there are enough rows (see
+      // `Operation::computeResultForCache`). The LIMIT and OFFSET themselves
+      // are applied later by the export or by the parent of a subquery, so
+      // they must not be applied here a second time.
+      LimitOffsetClause topK;
+      topK._limit =
+          pq._limitOffset.upperBound(std::numeric_limits<uint64_t>::max());
+      plan._qet->setLimit(topK);
     }
   }
 
@@ -163,11 +200,163 @@ QueryExecutionTree QueryPlanner::createExecutionTree(ParsedQuery& pq) {
   auto lastRow = createExecutionTrees(pq);
   auto minInd = findCheapestExecutionTree(lastRow);
   LOG(DEBUG) << "Done creating execution plan.\n";
+  auto& runtimeInfoWholeQuery =
+      lastRow[minInd]._qet->getRootOperation()->getRuntimeInfoWholeQuery();
+  runtimeInfoWholeQuery.numCandidatePlans = numCandidatePlans_;
+  runtimeInfoWholeQuery.numIdpIterations = numIdpIterations_;
+  if (RuntimeParameters().get<"share-results-of-identical-subtrees">()) {
+    shareResultsOfCommonSubtrees(*lastRow[minInd]._qet);
+  }
   return *lastRow[minInd]._qet;
 }
 
+// _____________________________________________________________________________
+void QueryPlanner::shareResultsOfCommonSubtrees(
+    const QueryExecutionTree& tree) {
+  // The operations with the same cache key. The children of an operation are
+  // only visited for the first operation with its cache key, because the
+  // other ones are not computed.
+  ad_utility::HashMap<std::string, std::vector<Operation*>> operations;
+  auto visit = [&operations](const auto& self,
+                             const QueryExecutionTree& subtree) -> void {
+    auto& sameKey = operations[subtree.getCacheKey()];
+    sameKey.push_back(subtree.getRootOperation().get());
+    if (sameKey.size() > 1) {
+      return;
+    }
+    for (const QueryExecutionTree* child :
+         subtree.getRootOperation()->getChildren()) {
+      self(self, *child);
+    }
+  };
+  visit(visit, tree);
+  for (auto& [cacheKey, sameKey] : operations) {
+    if (sameKey.size() < 2 ||
+        dynamic_cast<const IndexScan*>(sameKey.front()) != nullptr) {
+      continue;
+    }
+    auto sharedResult = std::make_shared<SharedSubtreeResult>(sameKey.size());
+    for (Operation* operation : sameKey) {
+      operation->setSharedResult(sharedResult);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+ad_utility::HashSet<Variable> QueryPlanner::getCertainlyBoundVariables(
+    const ParsedQuery::GraphPattern& pattern) {
+  ad_utility::HashSet<Variable> result;
+  auto addIfVariable = [&result](const TripleComponent& component) {
+    if (isVariable(component)) {
+      result.insert(component.getVariable());
+    }
+  };
+  for (const auto& child : pattern._graphPatterns) {
+    child.visit([&](const auto& arg) {
+      using T = std::decay_t<decltype(arg)>;
+      if constexpr (std::is_same_v<T, p::BasicGraphPattern>) {
+        for (const SparqlTriple& triple : arg._triples) {
+          addIfVariable(triple._s);
+          if (isVariable(triple._p)) {
+            result.insert(Variable{triple._p._iri});
+          }
+          addIfVariable(triple._o);
+        }
+      } else if constexpr (std::is_same_v<T, p::TransPath>) {
+        addIfVariable(arg._left);
+        addIfVariable(arg._right);
+      } else if constexpr (std::is_same_v<T, p::GroupGraphPattern>) {
+        result.merge(getCertainlyBoundVariables(arg._child));
+      } else if constexpr (std::is_same_v<T, p::Union>) {
+        auto left = getCertainlyBoundVariables(arg._child1);
+        auto right = getCertainlyBoundVariables(arg._child2);
+        for (const auto& variable : left) {
+          if (right.contains(variable)) {
+            result.insert(variable);
+          }
+        }
+      } else if constexpr (std::is_same_v<T, p::Subquery>) {
+        const ParsedQuery& subquery = arg.get();
+        if (subquery._groupByVariables.empty()) {
+          auto bound = getCertainlyBoundVariables(subquery._rootGraphPattern);
+          for (const auto& variable :
+               subquery.selectClause().getSelectedVariables()) {
+            if (bound.contains(variable)) {
+              result.insert(variable);
+            }
+          }
+        }
+      }
+    });
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+void QueryPlanner::pushFiltersIntoChildren(ParsedQuery::GraphPattern& pattern) {
+  // The graph patterns into which a FILTER can be moved, together with the
+  // variables that they bind in each row.
+  using BoundVariables = ad_utility::HashSet<Variable>;
+  std::vector<std::pair<ParsedQuery::GraphPattern*, BoundVariables>> targets;
+  auto addTarget = [&targets](ParsedQuery::GraphPattern& target,
+                              BoundVariables boundVariables) {
+    targets.emplace_back(&target, std::move(boundVariables));
+  };
+  for (auto& child : pattern._graphPatterns) {
+    child.visit([&](auto& arg) {
+      using T = std::decay_t<decltype(arg)>;
+      if constexpr (std::is_same_v<T, p::GroupGraphPattern>) {
+        addTarget(arg._child, getCertainlyBoundVariables(arg._child));
+      } else if constexpr (std::is_same_v<T, p::Union>) {
+        addTarget(arg._child1, getCertainlyBoundVariables(arg._child1));
+        addTarget(arg._child2, getCertainlyBoundVariables(arg._child2));
+      } else if constexpr (std::is_same_v<T, p::Subquery>) {
+        ParsedQuery& subquery = arg.get();
+        if (subquery._groupByVariables.empty() &&
+            !subquery._limitOffset._limit.has_value() &&
+            subquery._limitOffset._offset == 0) {
+          BoundVariables bound;
+          auto boundInBody =
+              getCertainlyBoundVariables(subquery._rootGraphPattern);
+          for (const auto& variable :
+               subquery.selectClause().getSelectedVariables()) {
+            if (boundInBody.contains(variable)) {
+              bound.insert(variable);
+            }
+          }
+          addTarget(subquery._rootGraphPattern, std::move(bound));
+        }
+      }
+    });
+  }
+  // A FILTER is moved into all targets that bind all its variables. If these
+  // are both branches of a UNION, it is moved into both of them.
+  auto isMovedInto = [](const SparqlFilter& filter, const auto& target) {
+    return std::ranges::all_of(filter.expression_.containedVariables(),
+                               [&target](const Variable* variable) {
+                                 return target.second.contains(*variable);
+                               });
+  };
+  std::vector<SparqlFilter> remainingFilters;
+  for (auto& filter : pattern._filters) {
+    bool isMoved = false;
+    for (auto& target : targets) {
+      if (isMovedInto(filter, target)) {
+        target.first->_filters.push_back(filter);
+        isMoved = true;
+      }
+    }
+    if (!isMoved) {
+      remainingFilters.push_back(std::move(filter));
+    }
+  }
+  pattern._filters = std::move(remainingFilters);
+}
+
+// _____________________________________________________________________________
 std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
     ParsedQuery::GraphPattern* rootPattern) {
+  pushFiltersIntoChildren(*rootPattern);
   // here we collect a set of possible plans for each of our children.
   // always only holds plans for children that can be joined in an
   // arbitrary order
@@ -200,16 +389,15 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
     return fillDpTab(tg, filters, plans).back();
   };
 
-  // find a single best candidate for a given graph pattern
-  auto optimizeSingle = [this](const auto pattern) -> SubtreePlan {
+  // find all the candidates for a given graph pattern
+  auto optimizeNonEmpty = [this](const auto pattern) {
     auto v = optimize(pattern);
     if (v.empty()) {
       throw std::runtime_error(
           "grandchildren or lower of a Plan to be optimized may never be "
           "empty");
     }
-    auto idx = findCheapestExecutionTree(v);
-    return std::move(v[idx]);
+    return v;
   };
 
   // the callback that is called after dealing with a child pattern.
@@ -292,7 +480,9 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
       // All variables seen so far are considered bound and cannot appear as the
       // RHS of a BIND operation. This is also true for variables from OPTIONALs
       // and MINUS clauses (this was a bug in the previous version of the code).
-      {
+      // The variables of a `FILTER (NOT) EXISTS` are not visible outside of it.
+      if (v[0].type != SubtreePlan::NOT_EXISTS &&
+          v[0].type != SubtreePlan::EXISTS) {
         auto vc = v[0]._qet->getVariableColumns();
         std::for_each(vc.begin(), vc.end(), [&boundVariables](const auto& el) {
           boundVariables.insert(Variable{el.first});
@@ -321,7 +511,7 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
       // know that b is from an OPTIONAL.
       for (const auto& a : lastRow) {
         for (const auto& b : v) {
-          auto vec = createJoinCandidates(a, b, std::nullopt);
+          auto vec = createJoinCandidates(a, b, nullptr);
           nextCandidates.insert(nextCandidates.end(),
                                 std::make_move_iterator(vec.begin()),
                                 std::make_move_iterator(vec.end()));
@@ -347,7 +537,7 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
   // go through the child patterns in order, set up all their candidatePlans
   // and then call the joinCandidates call back
   for (auto& child : rootPattern->_graphPatterns) {
-    child.visit([&optimizeSingle, &joinCandidates, this](auto&& arg) {
+    child.visit([&optimizeNonEmpty, &joinCandidates, this](auto&& arg) {
       using T = std::decay_t<decltype(arg)>;
       if constexpr (std::is_same_v<T, p::Optional> ||
                     std::is_same_v<T, p::GroupGraphPattern>) {
@@ -359,16 +549,31 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
         }
         joinCandidates(std::move(candidates));
       } else if constexpr (std::is_same_v<T, p::Union>) {
-        // TODO<joka921> here we could keep all the candidates, and create a
-        // "sorted union" by merging as additional candidates if the inputs
-        // are presorted.
-        SubtreePlan left = optimizeSingle(&arg._child1);
-        SubtreePlan right = optimizeSingle(&arg._child2);
-
-        // create a new subtree plan
-        SubtreePlan candidate =
-            makeSubtreePlan<Union>(_qec, left._qet, right._qet);
-        joinCandidates(std::vector{std::move(candidate)});
+        auto leftPlans = optimizeNonEmpty(&arg._child1);
+        auto rightPlans = optimizeNonEmpty(&arg._child2);
+        const auto& left = leftPlans.at(findCheapestExecutionTree(leftPlans));
+        const auto& right =
+            rightPlans.at(findCheapestExecutionTree(rightPlans));
+
+        // The union of the cheapest inputs, and the unions of inputs that are
+        // sorted on the same variables. The latter are merged, s.t. their
+        // result is sorted (see `Union::mergeColumns`).
+        std::vector<SubtreePlan> candidates;
+        candidates.push_back(
+            makeSubtreePlan<Union>(_qec, left._qet, right._qet));
+        for (const auto& leftPlan : leftPlans) {
+          for (const auto& rightPlan : rightPlans) {
+            if (&leftPlan == &left && &rightPlan == &right) {
+              continue;
+            }
+            auto candidate =
+                makeSubtreePlan<Union>(_qec, leftPlan._qet, rightPlan._qet);
+            if (!candidate._qet->resultSortedOn().empty()) {
+              candidates.push_back(std::move(candidate));
+            }
+          }
+        }
+        joinCandidates(std::move(candidates));
       } else if constexpr (std::is_same_v<T, p::Subquery>) {
         // TODO<joka921> We currently do not optimize across subquery borders
         // but abuse them as "optimization hints". In theory, one could even
@@ -387,7 +592,7 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
         std::ranges::for_each(candidatesForSubquery, setSelectedVariables);
         // A subquery must also respect LIMIT and OFFSET clauses
         std::ranges::for_each(candidatesForSubquery, [&](SubtreePlan& plan) {
-          plan._qet->getRootOperation()->setLimit(arg.get()._limitOffset);
+          plan._qet->setLimit(arg.get()._limitOffset);
         });
         joinCandidates(std::move(candidatesForSubquery));
       } else if constexpr (std::is_same_v<T, p::TransPath>) {
@@ -450,6 +655,13 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
           c.type = SubtreePlan::MINUS;
         }
         joinCandidates(std::move(candidates));
+      } else if constexpr (std::is_same_v<T, p::ExistsFilter>) {
+        auto candidates = optimize(&arg._child);
+        for (auto& c : candidates) {
+          c.type =
+              arg._isNegated ? SubtreePlan::NOT_EXISTS : SubtreePlan::EXISTS;
+        }
+        joinCandidates(std::move(candidates));
       } else {
         static_assert(std::is_same_v<T, p::BasicGraphPattern>);
         // just add all the triples directly.
@@ -493,11 +705,14 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getDistinctRow(
   const vector<SubtreePlan>& previous = dpTab[dpTab.size() - 1];
   vector<SubtreePlan> added;
   added.reserve(previous.size());
-  for (const auto& parent : previous) {
+  // Add the plans that remove the duplicates of the selected variables from
+  // the result of the `parent`.
+  auto addDistinctPlans = [this, &selectClause,
+                           &added](std::shared_ptr<QueryExecutionTree> parent) {
     SubtreePlan distinctPlan(_qec);
     vector<ColumnIndex> keepIndices;
     ad_utility::HashSet<ColumnIndex> indDone;
-    const auto& colMap = parent._qet->getVariableColumns();
+    const auto& colMap = parent->getVariableColumns();
     for (const auto& var : selectClause.getSelectedVariables()) {
       // There used to be a special treatment for `?ql_textscore_` variables
       // which was considered a bug.
@@ -510,7 +725,7 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getDistinctRow(
       }
     }
     const std::vector<ColumnIndex>& resultSortedOn =
-        parent._qet->getRootOperation()->getResultSortedOn();
+        parent->getRootOperation()->getResultSortedOn();
     // check if the current result is sorted on all columns of the distinct
     // with the order of the sorting
     bool isSorted = resultSortedOn.size() >= keepIndices.size();
@@ -519,12 +734,72 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getDistinctRow(
     }
     if (isSorted) {
       distinctPlan._qet =
-          makeExecutionTree<Distinct>(_qec, parent._qet, keepIndices);
+          makeExecutionTree<Distinct>(_qec, parent, keepIndices);
     } else {
-      auto tree = makeExecutionTree<Sort>(_qec, parent._qet, keepIndices);
+      auto tree = makeExecutionTree<Sort>(_qec, parent, keepIndices);
       distinctPlan._qet = makeExecutionTree<Distinct>(_qec, tree, keepIndices);
+      // Also add the plan that removes the duplicates via hashing without
+      // sorting the input. The cheaper of the two plans is chosen in the end,
+      // unless the `QueryHints` require one of them.
+      using enum QueryHints::JoinStrategy;
+      auto joinStrategy = getJoinStrategy();
+      if (joinStrategy == Hash ||
+          (joinStrategy != Merge &&
+           RuntimeParameters().get<"use-hash-distinct">())) {
+        if (joinStrategy != Hash) {
+          added.push_back(distinctPlan);
+        }
+        distinctPlan._qet = makeExecutionTree<Distinct>(
+            _qec, parent, keepIndices, Distinct::Strategy::Hash);
+      }
     }
     added.push_back(distinctPlan);
+  };
+
+  for (const auto& parent : previous) {
+    addDistinctPlans(parent._qet);
+    if (!RuntimeParameters().get<"use-semi-join-for-distinct">()) {
+      continue;
+    }
+    // If the `parent` is a join and all the selected variables are bound by
+    // one of its inputs, the duplicates can also be removed from the
+    // semi-join of this input with the other input.
+    auto* join =
+        dynamic_cast<const Join*>(parent._qet->getRootOperation().get());
+    if (join == nullptr || Join::isFullScanDummy(join->getLeft()) ||
+        Join::isFullScanDummy(join->getRight())) {
+      continue;
+    }
+    const auto& left = join->getLeft();
+    const auto& right = join->getRight();
+    // The `SemiJoin` compares the IDs of the join columns directly, so it must
+    // not be used if they can contain UNDEF values.
+    auto mightContainUndef = [](const QueryExecutionTree& tree,
+                                ColumnIndex column) {
+      return tree.getVariableAndInfoByColumnIndex(column)
+                 .second.mightContainUndef_ !=
+             ColumnIndexAndTypeInfo::UndefStatus::AlwaysDefined;
+    };
+    auto joinColumns = QueryExecutionTree::getJoinColumns(*left, *right);
+    if (std::ranges::any_of(joinColumns, [&](const auto& columns) {
+          return mightContainUndef(*left, columns[0]) ||
+                 mightContainUndef(*right, columns[1]);
+        })) {
+      continue;
+    }
+    auto bindsAllSelectedVariables = [&selectClause, &parent](
+                                         const QueryExecutionTree& input) {
+      return std::ranges::all_of(
+          selectClause.getSelectedVariables(), [&](const Variable& var) {
+            return !parent._qet->getVariableColumns().contains(var) ||
+                   input.getVariableColumns().contains(var);
+          });
+    };
+    if (bindsAllSelectedVariables(*left)) {
+      addDistinctPlans(makeExecutionTree<SemiJoin>(_qec, left, right));
+    } else if (bindsAllSelectedVariables(*right)) {
+      addDistinctPlans(makeExecutionTree<SemiJoin>(_qec, right, left));
+    }
   }
   return added;
 }
@@ -861,6 +1136,18 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::seedWithScansAndText(
                node.triple_.asString());
     }
 
+    // An alternative of IRIs (e.g. `?x (<p>|<q>) ?y`) is read by merging the
+    // scans of the IRIs, s.t. the result is sorted like a single index scan.
+    if (auto permutations =
+            MultiPredicateScan::applicablePermutations(node.triple_);
+        !permutations.empty()) {
+      for (auto permutation : permutations) {
+        pushPlan(makeSubtreePlan<MultiPredicateScan>(_qec, permutation,
+                                                     node.triple_));
+      }
+      continue;
+    }
+
     // If the predicate is a property path, we have to recursively set up the
     // index scans.
     if (node.triple_._p._operation != PropertyPath::Operation::IRI) {
@@ -972,6 +1259,15 @@ std::shared_ptr<ParsedQuery::GraphPattern> QueryPlanner::seedFromAlternative(
     return seedFromPropertyPath(left, path, right);
   }
 
+  // An alternative of IRIs is kept as a single triple, which is read by a
+  // `MultiPredicateScan` (see `seedWithScansAndText`), also when it is part
+  // of a longer path.
+  if (!MultiPredicateScan::applicablePermutations(
+           SparqlTriple{left, path, right})
+           .empty()) {
+    return seedFromIri(left, path, right);
+  }
+
   std::vector<std::shared_ptr<ParsedQuery::GraphPattern>> childPlans;
   childPlans.reserve(path._children.size());
   for (const auto& child : path._children) {
@@ -1097,15 +1393,39 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::merge(
   // Find all pairs between a and b that are connected by an edge.
   LOG(TRACE) << "Considering joins that merge " << a.size() << " and "
              << b.size() << " plans...\n";
-  for (const auto& ai : a) {
-    for (const auto& bj : b) {
-      LOG(TRACE) << "Creating join candidates for " << ai._qet->getCacheKey()
-                 << "\n and " << bj._qet->getCacheKey() << '\n';
-      auto v = createJoinCandidates(ai, bj, tg);
-      for (auto& plan : v) {
-        candidates[getPruningKey(plan, plan._qet->resultSortedOn())]
-            .emplace_back(std::move(plan));
-      }
+  // The join candidates of the pairs are created concurrently and collected
+  // per pair, s.t. they are pruned in the same order as by a single thread.
+  size_t numPairs = a.size() * b.size();
+  std::vector<std::vector<SubtreePlan>> candidatesPerPair(numPairs);
+  constexpr size_t numPairsPerMorsel = 8;
+  size_t numThreads =
+      isInTestMode() || numPairs < 4 * numPairsPerMorsel
+          ? 1
+          : _qec->getNumThreads(
+                RuntimeParameters().get<"query-planning-num-threads">());
+  if (numThreads > 1) {
+    // The estimates are computed lazily, so they have to be computed before
+    // the plans are shared between the threads.
+    precomputeEstimates(a);
+    precomputeEstimates(b);
+  }
+  ad_utility::forEachMorselConcurrently(
+      numPairs, numPairsPerMorsel, numThreads,
+      [&](size_t, size_t beginPair, size_t endPair) {
+        for (size_t pair = beginPair; pair < endPair; ++pair) {
+          const auto& ai = a[pair / b.size()];
+          const auto& bj = b[pair % b.size()];
+          LOG(TRACE) << "Creating join candidates for "
+                     << ai._qet->getCacheKey() << "\n and "
+                     << bj._qet->getCacheKey() << '\n';
+          candidatesPerPair[pair] = createJoinCandidates(ai, bj, &tg);
+        }
+      });
+  for (auto& v : candidatesPerPair) {
+    numCandidatePlans_ += v.size();
+    for (auto& plan : v) {
+      candidates[getPruningKey(plan, plan._qet->resultSortedOn())]
+          .emplace_back(std::move(plan));
     }
   }
 
@@ -1140,6 +1460,19 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::merge(
   return prunedPlans;
 }
 
+// _____________________________________________________________________________
+void QueryPlanner::precomputeEstimates(const vector<SubtreePlan>& plans) {
+  for (const auto& plan : plans) {
+    auto& qet = *plan._qet;
+    qet.getSizeEstimate();
+    qet.getCostEstimate();
+    qet.knownEmptyResult();
+    for (size_t col = 0; col < qet.getResultWidth(); ++col) {
+      qet.getDistinctEstimate(col);
+    }
+  }
+}
+
 // _____________________________________________________________________________
 string QueryPlanner::TripleGraph::asString() const {
   std::ostringstream os;
@@ -1307,23 +1640,131 @@ void QueryPlanner::applyFiltersIfPossible(
 std::vector<QueryPlanner::SubtreePlan>
 QueryPlanner::runDynamicProgrammingOnConnectedComponent(
     std::vector<SubtreePlan> connectedComponent,
-    const vector<SparqlFilter>& filters, const TripleGraph& tg) const {
+    const vector<SparqlFilter>& filters, const TripleGraph& tg,
+    bool allowReplanning) const {
+  allowReplanning =
+      allowReplanning && !isInTestMode() &&
+      RuntimeParameters().get<"adaptive-replanning-error-ratio">() > 0;
+  // The original input, which is needed for a second run of the dynamic
+  // programming (see below).
+  std::vector<SubtreePlan> seeds;
+  if (allowReplanning) {
+    seeds = connectedComponent;
+  }
+  // The exhaustive dynamic programming is exponential in the number of seeds.
+  // For large components, the cheapest plan that joins `idpBlockSize` seeds is
+  // fixed and becomes a new seed that replaces the seeds it contains, until
+  // the exhaustive dynamic programming is feasible (iterative dynamic
+  // programming, see Kossmann and Stocker, "Iterative Dynamic Programming: A
+  // New Class of Query Optimization Algorithms", TODS 2000).
+  const size_t maxNumSeedsForExactDp =
+      RuntimeParameters().get<"query-planning-max-num-nodes-for-exact-dp">();
+  const size_t idpBlockSize =
+      std::min(RuntimeParameters().get<"query-planning-idp-block-size">(),
+               maxNumSeedsForExactDp);
+  while (countDistinctSeeds(connectedComponent) > maxNumSeedsForExactDp) {
+    auto dpTab = fillDpTabForConnectedComponent(std::move(connectedComponent),
+                                                filters, tg, idpBlockSize);
+    auto& lastRow = dpTab.back();
+    auto bestPlan = std::move(lastRow.at(findCheapestExecutionTree(lastRow)));
+    connectedComponent.clear();
+    for (auto& seed : dpTab.front()) {
+      if ((seed._idsOfIncludedNodes & bestPlan._idsOfIncludedNodes) == 0) {
+        connectedComponent.push_back(std::move(seed));
+      }
+    }
+    connectedComponent.push_back(std::move(bestPlan));
+    ++numIdpIterations_;
+  }
+  auto dpTab = fillDpTabForConnectedComponent(
+      std::move(connectedComponent), filters, tg, maxNumSeedsForExactDp);
+  size_t numSeeds = dpTab.size();
+  // If the estimates of the best plan were badly wrong, the join order might
+  // be far from optimal. The results of the misestimated subtrees are now in
+  // the cache, so a second run uses their actual sizes (see
+  // `QueryExecutionTree::readFromCache`). This is only done once, s.t. the
+  // planning always terminates.
+  auto& lastRow = dpTab.back();
+  if (!allowReplanning || numSeeds < 2 ||
+      !materializeUnreliableSubtrees(
+          *lastRow.at(findCheapestExecutionTree(lastRow))._qet)) {
+    return std::move(lastRow);
+  }
+  LOG(DEBUG) << "Re-optimizing the join order with the actual sizes of the "
+                "misestimated subtrees"
+             << std::endl;
+  for (auto& seed : seeds) {
+    seed._qet->readFromCache();
+  }
+  return runDynamicProgrammingOnConnectedComponent(std::move(seeds), filters,
+                                                   tg, false);
+}
+
+// _____________________________________________________________________________
+bool QueryPlanner::materializeUnreliableSubtrees(
+    QueryExecutionTree& plan) const {
+  const double maxErrorRatio =
+      RuntimeParameters().get<"adaptive-replanning-error-ratio">();
+  const std::chrono::seconds timeout =
+      RuntimeParameters().get<"default-query-timeout">();
+  bool foundMisestimate = false;
+  auto materialize = [&](QueryExecutionTree& qet, const auto& self) -> void {
+    for (auto* child : qet.getRootOperation()->getChildren()) {
+      self(*child, self);
+    }
+    auto type = qet.getType();
+    if (type != QueryExecutionTree::TRANSITIVE_PATH &&
+        type != QueryExecutionTree::HAS_PREDICATE_SCAN) {
+      return;
+    }
+    auto estimate = static_cast<double>(qet.getSizeEstimate());
+    // The actual time limit is only set when the query is executed, so use the
+    // default one for the computation during the planning.
+    qet.getRootOperation()->recursivelySetTimeConstraint(timeout);
+    auto actual = static_cast<double>(qet.getResult()->size());
+    // Small results are not worth a re-optimization, even if their estimates
+    // are off by a large factor.
+    if (std::max(actual, estimate) < MIN_SIZE_FOR_REPLANNING) {
+      return;
+    }
+    auto errorRatio =
+        std::max(actual + 1, estimate + 1) / std::min(actual + 1, estimate + 1);
+    if (errorRatio > maxErrorRatio) {
+      LOG(DEBUG) << "The size estimate " << estimate << " of "
+                 << qet.getRootOperation()->getDescriptor()
+                 << " was off by a factor of " << errorRatio << ", the actual "
+                 << "size is " << actual << std::endl;
+      foundMisestimate = true;
+    }
+  };
+  materialize(plan, materialize);
+  return foundMisestimate;
+}
+
+// _____________________________________________________________________________
+vector<vector<QueryPlanner::SubtreePlan>>
+QueryPlanner::fillDpTabForConnectedComponent(
+    std::vector<SubtreePlan> seeds, const vector<SparqlFilter>& filters,
+    const TripleGraph& tg, size_t maxNumSeedsPerPlan) const {
   vector<vector<QueryPlanner::SubtreePlan>> dpTab;
-  // find the unique number of nodes in the current connected component
-  // (there might be duplicates because we already have multiple candidates
-  // for each index scan with different permutations.
-  dpTab.push_back(std::move(connectedComponent));
+  auto worstCaseOptimalJoins = createWorstCaseOptimalJoins(seeds, tg);
+  dpTab.push_back(std::move(seeds));
   applyFiltersIfPossible(dpTab.back(), filters, false);
-  ad_utility::HashSet<uint64_t> uniqueNodeIds;
-  std::ranges::copy(
-      dpTab.back() | std::views::transform(&SubtreePlan::_idsOfIncludedNodes),
-      std::inserter(uniqueNodeIds, uniqueNodeIds.end()));
-  size_t numSeeds = uniqueNodeIds.size();
+  size_t numSeeds =
+      std::min(countDistinctSeeds(dpTab.back()), maxNumSeedsPerPlan);
 
   for (size_t k = 2; k <= numSeeds; ++k) {
     LOG(TRACE) << "Producing plans that unite " << k << " triples."
                << std::endl;
     dpTab.emplace_back(vector<SubtreePlan>());
+    // The worst-case optimal joins are alternatives to the pairwise joins of
+    // the same seeds.
+    for (const auto& plan : worstCaseOptimalJoins) {
+      if (static_cast<size_t>(std::popcount(plan._idsOfIncludedNodes)) == k) {
+        dpTab.back().push_back(plan);
+        ++numCandidatePlans_;
+      }
+    }
     for (size_t i = 1; i * 2 <= k; ++i) {
       auto newPlans = merge(dpTab[i - 1], dpTab[k - i - 1], tg);
       dpTab[k - 1].insert(dpTab[k - 1].end(), newPlans.begin(), newPlans.end());
@@ -1333,7 +1774,101 @@ QueryPlanner::runDynamicProgrammingOnConnectedComponent(
     // be nonempty.
     AD_CORRECTNESS_CHECK(!dpTab[k - 1].empty());
   }
-  return std::move(dpTab.back());
+  return dpTab;
+}
+
+// _____________________________________________________________________________
+std::vector<QueryPlanner::SubtreePlan>
+QueryPlanner::createWorstCaseOptimalJoins(const std::vector<SubtreePlan>& seeds,
+                                          const TripleGraph& tg) const {
+  if (isInTestMode() || getJoinStrategy() == QueryHints::JoinStrategy::Merge ||
+      !RuntimeParameters().get<"use-worst-case-optimal-join">()) {
+    return {};
+  }
+  // The supported triples of the seeds together with the ids of their nodes.
+  // There are several seeds (index scans with different permutations) for the
+  // same triple.
+  std::vector<std::pair<uint64_t, const SparqlTriple*>> triples;
+  for (const auto& seed : seeds) {
+    uint64_t nodeId = seed._idsOfIncludedNodes;
+    if (seed._qet->getType() != QueryExecutionTree::SCAN ||
+        std::popcount(nodeId) != 1) {
+      continue;
+    }
+    size_t nodeIndex = std::countr_zero(nodeId);
+    auto node = tg._nodeMap.find(nodeIndex);
+    if (node == tg._nodeMap.end() ||
+        !WorstCaseOptimalJoin::isSupportedTriple(node->second->triple_) ||
+        std::ranges::any_of(triples, [nodeId](const auto& triple) {
+          return triple.first == nodeId;
+        })) {
+      continue;
+    }
+    triples.emplace_back(nodeId, &node->second->triple_);
+  }
+
+  auto variablesOf = [](const auto& triple) {
+    return std::array{triple.second->_s.getVariable(),
+                      triple.second->_o.getVariable()};
+  };
+  // Compute the 2-core.
+  bool removedTriple = true;
+  while (removedTriple) {
+    ad_utility::HashMap<Variable, size_t> numOccurrences;
+    for (const auto& triple : triples) {
+      for (const auto& variable : variablesOf(triple)) {
+        ++numOccurrences[variable];
+      }
+    }
+    removedTriple = std::erase_if(triples, [&](const auto& triple) {
+                      return std::ranges::any_of(
+                          variablesOf(triple), [&](const Variable& variable) {
+                            return numOccurrences.at(variable) == 1;
+                          });
+                    }) > 0;
+  }
+
+  // Split the 2-core into its connected components.
+  std::vector<SubtreePlan> result;
+  while (!triples.empty()) {
+    std::vector<std::pair<uint64_t, const SparqlTriple*>> component{
+        triples.back()};
+    triples.pop_back();
+    ad_utility::HashSet<Variable> variables{variablesOf(component.front())[0],
+                                            variablesOf(component.front())[1]};
+    bool addedTriple = true;
+    while (addedTriple) {
+      addedTriple = false;
+      for (auto it = triples.begin(); it != triples.end();) {
+        auto [subject, object] = variablesOf(*it);
+        if (variables.contains(subject) || variables.contains(object)) {
+          variables.insert(subject);
+          variables.insert(object);
+          component.push_back(*it);
+          it = triples.erase(it);
+          addedTriple = true;
+        } else {
+          ++it;
+        }
+      }
+    }
+    // Cycles of length two (two triples with the same variables) are handled
+    // well by the `MultiColumnJoin`.
+    if (variables.size() < 3) {
+      continue;
+    }
+    std::vector<SparqlTriple> triplesOfComponent;
+    uint64_t nodeIds = 0;
+    for (const auto& [nodeId, triple] : component) {
+      triplesOfComponent.push_back(*triple);
+      nodeIds |= nodeId;
+    }
+    auto plan = makeSubtreePlan<WorstCaseOptimalJoin>(
+        _qec, std::move(triplesOfComponent));
+    plan._idsOfIncludedNodes = nodeIds;
+    result.push_back(std::move(plan));
+  }
+  return result;
 }
 
 // _____________________________________________________________________________
@@ -1366,23 +1901,70 @@ vector<vector<QueryPlanner::SubtreePlan>> QueryPlanner::fillDpTab(
     applyFiltersIfPossible(lastDpRowFromComponents.back(), filters, true);
     return lastDpRowFromComponents;
   }
-  // More than one connected component, set up a Cartesian product.
+  // More than one connected component, combine the cheapest plans of the
+  // components by spatial joins where possible and by a Cartesian product.
+  std::vector<SubtreePlan> componentPlans;
+  for (auto& row : lastDpRowFromComponents) {
+    componentPlans.push_back(std::move(row.at(findCheapestExecutionTree(row))));
+  }
+  joinComponentsWithSpatialJoins(componentPlans, filters);
   std::vector<std::vector<SubtreePlan>> result;
   result.emplace_back();
-  std::vector<std::shared_ptr<QueryExecutionTree>> subtrees;
-  std::ranges::move(
-      lastDpRowFromComponents |
-          std::views::transform([this](auto& vec) -> decltype(auto) {
-            return vec.at(findCheapestExecutionTree(vec));
-          }) |
-          std::views::transform(&SubtreePlan::_qet),
-      std::back_inserter(subtrees));
-  result.at(0).push_back(
-      makeSubtreePlan<CartesianProductJoin>(_qec, std::move(subtrees)));
+  if (componentPlans.size() == 1) {
+    result.at(0).push_back(std::move(componentPlans.at(0)));
+  } else {
+    std::vector<std::shared_ptr<QueryExecutionTree>> subtrees;
+    uint64_t idsOfIncludedFilters = 0;
+    for (auto& plan : componentPlans) {
+      subtrees.push_back(std::move(plan._qet));
+      idsOfIncludedFilters |= plan._idsOfIncludedFilters;
+    }
+    result.at(0).push_back(
+        makeSubtreePlan<CartesianProductJoin>(_qec, std::move(subtrees)));
+    result.at(0).back()._idsOfIncludedFilters = idsOfIncludedFilters;
+  }
   applyFiltersIfPossible(result.at(0), filters, true);
   return result;
 }
 
+// _____________________________________________________________________________
+void QueryPlanner::joinComponentsWithSpatialJoins(
+    std::vector<SubtreePlan>& plans,
+    const vector<SparqlFilter>& filters) const {
+  // Find a filter on the distance between a variable of one plan and a
+  // variable of another plan, and replace the two plans by their spatial join.
+  // The filter is evaluated exactly by the `SpatialJoin`.
+  auto joinTwoPlans = [this, &plans, &filters]() {
+    for (size_t i = 0; i < filters.size(); ++i) {
+      auto comparison = filters[i].expression_.getDistanceComparison();
+      if (!comparison.has_value()) {
+        continue;
+      }
+      auto findPlan = [&plans](const Variable& variable) {
+        return std::ranges::find_if(plans, [&variable](const auto& plan) {
+          return plan._qet->isVariableCovered(variable);
+        });
+      };
+      auto left = findPlan(comparison->left_);
+      auto right = findPlan(comparison->right_);
+      if (left == plans.end() || right == plans.end() || left == right) {
+        continue;
+      }
+      SubtreePlan plan = makeSubtreePlan<SpatialJoin>(
+          _qec, left->_qet, right->_qet, comparison->left_, comparison->right_,
+          comparison->maxDistance_, comparison->includeMaxDistance_);
+      mergeSubtreePlanIds(plan, *left, *right);
+      plan._idsOfIncludedFilters |= (size_t(1) << i);
+      *left = std::move(plan);
+      plans.erase(right);
+      return true;
+    }
+    return false;
+  };
+  while (plans.size() > 1 && joinTwoPlans()) {
+  }
+}
+
 // _____________________________________________________________________________
 bool QueryPlanner::TripleGraph::isTextNode(size_t i) const {
   return _nodeMap.count(i) > 0 &&
@@ -1682,8 +2264,8 @@ size_t QueryPlanner::findCheapestExecutionTree(
 // _____________________________________________________________________________
 std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createJoinCandidates(
     const SubtreePlan& ain, const SubtreePlan& bin,
-    std::optional<TripleGraph> tg) const {
-  bool swapForTesting = isInTestMode() && bin.type != SubtreePlan::OPTIONAL &&
+    const TripleGraph* tg) const {
+  bool swapForTesting = isInTestMode() && bin.type == SubtreePlan::BASIC &&
                         ain._qet->getCacheKey() < bin._qet->getCacheKey();
   const auto& a = !swapForTesting ? ain : bin;
   const auto& b = !swapForTesting ? bin : ain;
@@ -1695,6 +2277,18 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createJoinCandidates(
   // TODO<joka921> find out, what is ACTUALLY the use case for the triple
   // graph. Is it only meant for (questionable) performance reasons
   // or does it change the meaning.
+  // A `FILTER (NOT) EXISTS` is also evaluated if there are no shared variables
+  // (see `Minus::Semantics` and `SemiJoin`).
+  if (b.type == SubtreePlan::NOT_EXISTS) {
+    AD_CONTRACT_CHECK(a.type == SubtreePlan::BASIC);
+    return {makeSubtreePlan<Minus>(_qec, a._qet, b._qet,
+                                   Minus::Semantics::NotExists)};
+  }
+  if (b.type == SubtreePlan::EXISTS) {
+    AD_CONTRACT_CHECK(a.type == SubtreePlan::BASIC);
+    return {makeSubtreePlan<SemiJoin>(_qec, a._qet, b._qet)};
+  }
+
   std::vector<std::array<ColumnIndex, 2>> jcs;
   if (tg) {
     if (connected(a, b, *tg)) {
@@ -1734,7 +2328,28 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createJoinCandidates(
   AD_CONTRACT_CHECK(a.type != SubtreePlan::OPTIONAL);
   if (b.type == SubtreePlan::OPTIONAL) {
     // Join the two optional columns using an optional join
-    return {makeSubtreePlan<OptionalJoin>(_qec, a._qet, b._qet)};
+    std::vector<SubtreePlan> plans{
+        makeSubtreePlan<OptionalJoin>(_qec, a._qet, b._qet)};
+    // If the left input is much smaller than the right input, the hash join
+    // avoids sorting the right input and possibly reading all of it. The
+    // `QueryHints` can enforce or forbid the hash join.
+    using enum QueryHints::JoinStrategy;
+    auto joinStrategy = getJoinStrategy();
+    auto minSizeRatio =
+        RuntimeParameters().get<"hash-optional-join-min-size-ratio">();
+    bool leftIsMuchSmaller =
+        minSizeRatio > 0 &&
+        a._qet->getSizeEstimate() * minSizeRatio <= b._qet->getSizeEstimate();
+    if (joinStrategy != Merge && (joinStrategy == Hash || leftIsMuchSmaller) &&
+        OptionalJoin::isHashStrategyApplicable(*a._qet, *b._qet)) {
+      auto hashPlan = makeSubtreePlan<OptionalJoin>(
+          _qec, a._qet, b._qet, OptionalJoin::Strategy::Hash);
+      if (joinStrategy == Hash) {
+        return {std::move(hashPlan)};
+      }
+      plans.push_back(std::move(hashPlan));
+    }
+    return plans;
   }
 
   if (jcs.size() >= 2) {
@@ -1743,7 +2358,27 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createJoinCandidates(
     try {
       SubtreePlan plan = makeSubtreePlan<MultiColumnJoin>(_qec, a._qet, b._qet);
       mergeSubtreePlanIds(plan, a, b);
-      return {plan};
+      std::vector<SubtreePlan> plans{std::move(plan)};
+      // If one of the inputs has to be sorted for the zipper join, a hash join
+      // on the combined join columns might be cheaper. The `QueryHints` can
+      // enforce or forbid the hash join.
+      using enum QueryHints::JoinStrategy;
+      auto joinStrategy = getJoinStrategy();
+      auto children = plans.front()._qet->getRootOperation()->getChildren();
+      bool needsSort = std::ranges::any_of(children, [](const auto* child) {
+        return child->getType() == SORT;
+      });
+      if (joinStrategy != Merge && (joinStrategy == Hash || needsSort) &&
+          MultiColumnJoin::isHashStrategyApplicable(*a._qet, *b._qet)) {
+        auto hashPlan = makeSubtreePlan<MultiColumnJoin>(
+            _qec, a._qet, b._qet, MultiColumnJoin::Strategy::Hash);
+        mergeSubtreePlanIds(hashPlan, a, b);
+        if (joinStrategy == Hash) {
+          return {std::move(hashPlan)};
+        }
+        plans.push_back(std::move(hashPlan));
+      }
+      return plans;
     } catch (const std::exception& e) {
       return {};
     }
@@ -1779,6 +2414,17 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createJoinCandidates(
     candidates.push_back(std::move(opt.value()));
   }
 
+  // If one of `a` and `b` is small and the other one is an index scan, the
+  // join can also be computed via point lookups in the index.
+  // With the join strategy `IndexNestedLoop` of the `QueryHints`, this join is
+  // used instead of the normal join below.
+  if (auto opt = createJoinAsIndexNestedLoopJoin(a, b)) {
+    candidates.push_back(std::move(opt.value()));
+    if (getJoinStrategy() == QueryHints::JoinStrategy::IndexNestedLoop) {
+      return candidates;
+    }
+  }
+
   // "NORMAL" CASE:
   // The join class takes care of sorting the subtrees if necessary
   SubtreePlan plan =
@@ -1871,6 +2517,37 @@ auto QueryPlanner::createJoinWithHasPredicateScan(
   return plan;
 }
 
+// _____________________________________________________________________________
+auto QueryPlanner::createJoinAsIndexNestedLoopJoin(SubtreePlan a,
+                                                   SubtreePlan b)
+    -> std::optional<SubtreePlan> {
+  auto maxLeftSize =
+      RuntimeParameters().get<"index-nested-loop-join-max-left-size">();
+  if (getJoinStrategy() == QueryHints::JoinStrategy::Merge) {
+    maxLeftSize = 0;
+  } else if (getJoinStrategy() == QueryHints::JoinStrategy::IndexNestedLoop) {
+    maxLeftSize = std::numeric_limits<size_t>::max();
+  }
+  auto isSuitable = [maxLeftSize](const SubtreePlan& left,
+                                  const SubtreePlan& right) {
+    return left._qet->getSizeEstimate() <= maxLeftSize &&
+           IndexNestedLoopJoin::isApplicable(*left._qet, *right._qet);
+  };
+  if (maxLeftSize == 0) {
+    return std::nullopt;
+  }
+  const bool aIsLeft = isSuitable(a, b);
+  if (!aIsLeft && !isSuitable(b, a)) {
+    return std::nullopt;
+  }
+  const auto& left = aIsLeft ? a._qet : b._qet;
+  const auto& right = aIsLeft ? b._qet : a._qet;
+  auto qec = left->getRootOperation()->getExecutionContext();
+  auto plan = makeSubtreePlan<IndexNestedLoopJoin>(qec, left, right);
+  mergeSubtreePlanIds(plan, a, b);
+  return plan;
+}
+
 // ______________________________________________________________________________________
 auto QueryPlanner::createJoinAsTextFilter(
     SubtreePlan a, SubtreePlan b,
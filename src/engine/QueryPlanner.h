@@ -118,7 +118,7 @@ class QueryPlanner {
 
   class SubtreePlan {
    public:
-    enum Type { BASIC, OPTIONAL, MINUS };
+    enum Type { BASIC, OPTIONAL, MINUS, NOT_EXISTS, EXISTS };
 
     explicit SubtreePlan(QueryExecutionContext* qec)
         : _qet(std::make_shared<QueryExecutionTree>(qec)) {}
@@ -221,9 +221,39 @@ class QueryPlanner {
 
   bool _enablePatternTrick;
 
+  // Statistics about the query planning, which are reported in the
+  // `RuntimeInformationWholeQuery` of the created execution tree.
+  mutable size_t numCandidatePlans_ = 0;
+  mutable size_t numIdpIterations_ = 0;
+
   [[nodiscard]] std::vector<QueryPlanner::SubtreePlan> optimize(
       ParsedQuery::GraphPattern* rootPattern);
 
+  // Return variables that are bound in every row of the result of the
+  // `pattern`. This is a conservative approximation: The variables of the
+  // triples and transitive paths, of both branches of a UNION, and the
+  // selected variables of subqueries (without GROUP BY) are considered, but
+  // not the variables of OPTIONAL, MINUS, BIND, VALUES, or SERVICE clauses.
+  static ad_utility::HashSet<Variable> getCertainlyBoundVariables(
+      const ParsedQuery::GraphPattern& pattern);
+
+  // Move each FILTER of the `pattern` into those children of the `pattern`
+  // (the branches of a UNION, a nested group, or the body of a subquery) that
+  // bind all the variables of the FILTER in each row (see
+  // `getCertainlyBoundVariables`). Such a FILTER has the same effect there, but
+  // is applied before the child is joined with the rest of the `pattern`.
+  // FILTERs are not moved into subqueries with a LIMIT, OFFSET, or GROUP BY.
+  // This is called at the beginning of `optimize`, so the FILTERs are pushed
+  // down as far as possible.
+  static void pushFiltersIntoChildren(ParsedQuery::GraphPattern& pattern);
+
+  // Common-subexpression elimination: Let the subtrees of the `tree` that are
+  // identical (have the same cache key) share their result (see
+  // `Operation::setSharedResult`), s.t. it is computed only once per query. A
+  // subtree that is part of a shared subtree is only counted once. Index scans
+  // are not shared, because they are cheap to recompute and lazy.
+  static void shareResultsOfCommonSubtrees(const QueryExecutionTree& tree);
+
   // Add all the possible index scans for the triple represented by the node.
   // The triple is "ordinary" in the sense that it is neither a text triple with
   // ql:contains-word nor a special pattern trick triple.
@@ -303,9 +333,14 @@ class QueryPlanner {
                                           const vector<SubtreePlan>& b,
                                           const TripleGraph& tg) const;
 
+  // Create the plans that join `a` and `b`. If the `tg` is not null, only
+  // plans that are connected in it are joined.
   [[nodiscard]] std::vector<QueryPlanner::SubtreePlan> createJoinCandidates(
-      const SubtreePlan& a, const SubtreePlan& b,
-      std::optional<TripleGraph> tg) const;
+      const SubtreePlan& a, const SubtreePlan& b, const TripleGraph* tg) const;
+
+  // Compute (and thereby memoize) the estimates of the `plans`, s.t. they
+  // can be read by several threads at the same time (see `merge`).
+  static void precomputeEstimates(const vector<SubtreePlan>& plans);
 
   // Used internally by `createJoinCandidates`. If `a` or `b` is a transitive
   // path operation and the other input can be bound to this transitive path
@@ -325,6 +360,14 @@ class QueryPlanner {
       SubtreePlan a, SubtreePlan b,
       const std::vector<std::array<ColumnIndex, 2>>& jcs);
 
+  // Used internally by `createJoinCandidates`. If one of `a` and `b` is an
+  // `IndexScan` with two variables that is joined on its first column and the
+  // other one is estimated to have at most
+  // `index-nested-loop-join-max-left-size` rows, return an
+  // `IndexNestedLoopJoin` of the two. Else return `std::nullopt`.
+  [[nodiscard]] static std::optional<SubtreePlan>
+  createJoinAsIndexNestedLoopJoin(SubtreePlan a, SubtreePlan b);
+
   // Used internally by `createJoinCandidates`. If  `a` or `b` is a
   // `TextOperationWithoutFilter` create a `TextOperationWithFilter` that takes
   // the result of the other input as the filter input. Else return
@@ -431,10 +474,49 @@ class QueryPlanner {
 
   // Internal subroutine of `fillDpTab` that  only works on a single connected
   // component of the input. Throws if the subtrees in the `connectedComponent`
-  // are not in fact connected (via their variables).
+  // are not in fact connected (via their variables). Components with more
+  // than `query-planning-max-num-nodes-for-exact-dp` subtrees are first
+  // reduced via iterative dynamic programming (see `Constants.h`). If
+  // `allowReplanning` is true and the size estimates of the best plan turn out
+  // to be badly wrong (see `materializeUnreliableSubtrees`), the plans are
+  // computed a second time using the actual sizes.
   runDynamicProgrammingOnConnectedComponent(
       std::vector<SubtreePlan> connectedComponent,
-      const vector<SparqlFilter>& filters, const TripleGraph& tg) const;
+      const vector<SparqlFilter>& filters, const TripleGraph& tg,
+      bool allowReplanning = true) const;
+
+  // Run the dynamic programming on the `seeds` of a single connected component
+  // and return the table of the plans, where the `k`-th row contains the plans
+  // that join `k + 1` of the seeds. Only plans that join at most
+  // `maxNumSeedsPerPlan` seeds are created.
+  vector<vector<SubtreePlan>> fillDpTabForConnectedComponent(
+      std::vector<SubtreePlan> seeds, const vector<SparqlFilter>& filters,
+      const TripleGraph& tg, size_t maxNumSeedsPerPlan) const;
+
+  // Replace pairs of the `plans` of different connected components by a
+  // `SpatialJoin` of the two plans as long as one of the `filters` restricts
+  // the distance between a variable of each of them (see
+  // `SparqlExpressionPimpl::getDistanceComparison`). The remaining plans have
+  // to be combined by a Cartesian product.
+  void joinComponentsWithSpatialJoins(
+      std::vector<SubtreePlan>& plans,
+      const vector<SparqlFilter>& filters) const;
+
+  // Return the plans that join the cyclic parts of the `seeds` via a
+  // `WorstCaseOptimalJoin`. These are the connected components (with at least
+  // three variables) of the 2-core of the graph of the supported triples (see
+  // `WorstCaseOptimalJoin::isSupportedTriple`), i.e. the triples that remain
+  // after repeatedly removing the triples with a variable that occurs in no
+  // other triple.
+  std::vector<SubtreePlan> createWorstCaseOptimalJoins(
+      const std::vector<SubtreePlan>& seeds, const TripleGraph& tg) const;
+
+  // Compute the results of the subtrees of the `plan` with unreliable size
+  // estimates (transitive paths and `HasPredicateScan`s), which are stored in
+  // the cache and reused when the query is executed. Return true iff the
+  // actual size of one of these results differs from its estimate by more
+  // than the factor `adaptive-replanning-error-ratio`.
+  bool materializeUnreliableSubtrees(QueryExecutionTree& plan) const;
 
   [[nodiscard]] SubtreePlan getTextLeafPlan(
       const TripleGraph::Node& node) const;
@@ -452,4 +534,11 @@ class QueryPlanner {
   /// if this Planner is not associated with a queryExecutionContext we are only
   /// in the unit test mode
   [[nodiscard]] bool isInTestMode() const { return _qec == nullptr; }
+
+  // The join strategy of the `QueryHints` of the query (`Auto` in the unit
+  // test mode).
+  [[nodiscard]] QueryHints::JoinStrategy getJoinStrategy() const {
+    return isInTestMode() ? QueryHints::JoinStrategy::Auto
+                          : _qec->getQueryHints().joinStrategy_;
+  }
 };
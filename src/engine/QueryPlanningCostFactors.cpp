@@ -21,6 +21,10 @@ QueryPlanningCostFactors::QueryPlanningCostFactors() : _factors() {
   _factors["HASH_MAP_OPERATION_COST"] = 50.0;
   _factors["JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR"] = 0.7;
   _factors["DUMMY_JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR"] = 0.7;
+  // A hash join on several columns (see `MultiColumnJoin::Strategy::Hash`) is
+  // this many times as expensive as the zipper join of the same (but sorted)
+  // inputs.
+  _factors["HASH_MULTI_COLUMN_JOIN_COST"] = 2.0;
 
   // Assume that a random disk seek is 100 times more expensive than an
   // average `O(1)` access to a single ID.
@@ -0,0 +1,82 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/QueryRuntimeEstimator.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "global/Constants.h"
+#include "util/CancellationHandle.h"
+
+// _____________________________________________________________________________
+void QueryRuntimeEstimator::record(size_t costEstimate, Milliseconds runtime) {
+  if (runtime < MIN_RUNTIME_OF_OBSERVATION) {
+    return;
+  }
+  // Add one to the cost, s.t. a cost of zero has a finite ratio.
+  double logRatio = std::log(static_cast<double>(runtime.count()) /
+                             (static_cast<double>(costEstimate) + 1));
+  auto lock = state_.wlock();
+  if (lock->numObservations_ == 0) {
+    lock->logMillisecondsPerCost_ = logRatio;
+  } else {
+    lock->logMillisecondsPerCost_ =
+        (1 - WEIGHT_OF_NEW_OBSERVATION) * lock->logMillisecondsPerCost_ +
+        WEIGHT_OF_NEW_OBSERVATION * logRatio;
+  }
+  ++lock->numObservations_;
+}
+
+// _____________________________________________________________________________
+auto QueryRuntimeEstimator::estimateRuntime(size_t costEstimate) const
+    -> std::optional<Milliseconds> {
+  auto lock = state_.rlock();
+  if (lock->numObservations_ < MIN_NUM_OBSERVATIONS) {
+    return std::nullopt;
+  }
+  double milliseconds = (static_cast<double>(costEstimate) + 1) *
+                        std::exp(lock->logMillisecondsPerCost_);
+  // Avoid an overflow of the conversion for absurdly large estimates.
+  static constexpr double maxMilliseconds = 1e15;
+  return Milliseconds{
+      static_cast<Milliseconds::rep>(std::min(milliseconds, maxMilliseconds))};
+}
+
+// _____________________________________________________________________________
+void QueryRuntimeEstimator::throwIfEstimateExceedsRemainingTime(
+    size_t costEstimate, Milliseconds remainingTime,
+    std::string_view description) const {
+  auto factor =
+      RuntimeParameters().get<"runtime-estimate-cancellation-factor">();
+  if (factor <= 0) {
+    return;
+  }
+  auto estimate = estimateRuntime(costEstimate);
+  if (!estimate.has_value() ||
+      static_cast<double>(estimate.value().count()) <=
+          static_cast<double>(remainingTime.count()) * factor) {
+    return;
+  }
+  throw ad_utility::CancellationException{absl::StrCat(
+      description,
+      " was canceled before its computation, because its estimated runtime of ",
+      estimate.value().count(), " ms exceeded the remaining time of ",
+      remainingTime.count(), " ms by more than a factor of ", factor)};
+}
+
+// _____________________________________________________________________________
+void QueryRuntimeEstimator::clear() { *state_.wlock() = State{}; }
+
+// _____________________________________________________________________________
+size_t QueryRuntimeEstimator::numObservations() const {
+  return state_.rlock()->numObservations_;
+}
+
+// _____________________________________________________________________________
+QueryRuntimeEstimator& getQueryRuntimeEstimator() {
+  static QueryRuntimeEstimator estimator;
+  return estimator;
+}
@@ -0,0 +1,64 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+#include "util/Synchronized.h"
+
+// Estimate the runtime of a query (or of a subtree of a query) from the cost
+// estimate of the query planner. The cost estimates have no unit, so the
+// estimator is calibrated with the observed runtimes of previous queries: The
+// time per unit of cost is the exponential moving average (in log space) of
+// the ratios `runtime / costEstimate` of the observations. No estimates are
+// available before `MIN_NUM_OBSERVATIONS` observations were recorded.
+//
+// The estimates are used to cancel queries that cannot finish before their
+// timeout before any work is done (see `throwIfEstimateExceedsRemainingTime`).
+//
+// This class is threadsafe.
+class QueryRuntimeEstimator {
+ public:
+  using Milliseconds = std::chrono::milliseconds;
+  // The weight of a new observation in the moving average.
+  static constexpr double WEIGHT_OF_NEW_OBSERVATION = 0.1;
+  // The number of observations before the first estimate.
+  static constexpr size_t MIN_NUM_OBSERVATIONS = 10;
+  // Faster queries are dominated by the fixed overhead of the processing of a
+  // query and are not recorded.
+  static constexpr Milliseconds MIN_RUNTIME_OF_OBSERVATION{10};
+
+ private:
+  struct State {
+    double logMillisecondsPerCost_ = 0;
+    size_t numObservations_ = 0;
+  };
+  ad_utility::Synchronized<State> state_;
+
+ public:
+  // Record that a query with the `costEstimate` took `runtime` to compute.
+  void record(size_t costEstimate, Milliseconds runtime);
+
+  // The estimated runtime for the `costEstimate`, or `std::nullopt` if there
+  // were too few observations.
+  std::optional<Milliseconds> estimateRuntime(size_t costEstimate) const;
+
+  // Throw a `CancellationException` if the estimated runtime for the
+  // `costEstimate` is larger than the `remainingTime` by more than the runtime
+  // parameter `runtime-estimate-cancellation-factor` (0 disables the check).
+  // The `description` (e.g. "The query") is the subject of the error message.
+  void throwIfEstimateExceedsRemainingTime(size_t costEstimate,
+                                           Milliseconds remainingTime,
+                                           std::string_view description) const;
+
+  // Delete all the observations.
+  void clear();
+
+  size_t numObservations() const;
+};
+
+// Return the instance that is shared by all queries.
+QueryRuntimeEstimator& getQueryRuntimeEstimator();
@@ -0,0 +1,114 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/ResultCursors.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+
+// _____________________________________________________________________________
+ad_utility::MemorySize ResultCursors::Cursor::size() const {
+  const IdTable& idTable = result_->idTable();
+  return ad_utility::MemorySize::bytes(idTable.numRows() *
+                                       idTable.numColumns() * sizeof(Id));
+}
+
+// _____________________________________________________________________________
+ResultCursors::ResultCursors(std::function<Clock::time_point()> now)
+    : now_{std::move(now)} {}
+
+// _____________________________________________________________________________
+std::string ResultCursors::open(Cursor cursor, Clock::duration ttl) {
+  auto cursorPtr = std::make_shared<const Cursor>(std::move(cursor));
+  std::vector<std::shared_ptr<const Cursor>> evicted;
+  auto state = state_.wlock();
+  removeExpired(*state, evicted);
+  std::string handle;
+  do {
+    auto& random = state->randomGenerator_;
+    handle = absl::StrCat(absl::Hex(random(), absl::kZeroPad16),
+                          absl::Hex(random(), absl::kZeroPad16));
+  } while (state->entries_.contains(handle));
+  state->entries_.emplace(handle, Entry{std::move(cursorPtr), ttl, now_()});
+  return handle;
+}
+
+// _____________________________________________________________________________
+std::shared_ptr<const ResultCursors::Cursor> ResultCursors::get(
+    const std::string& handle) {
+  std::vector<std::shared_ptr<const Cursor>> evicted;
+  auto state = state_.wlock();
+  removeExpired(*state, evicted);
+  auto it = state->entries_.find(handle);
+  if (it == state->entries_.end()) {
+    return nullptr;
+  }
+  it->second.lastAccess_ = now_();
+  return it->second.cursor_;
+}
+
+// _____________________________________________________________________________
+bool ResultCursors::close(const std::string& handle) {
+  std::shared_ptr<const Cursor> cursor;
+  auto state = state_.wlock();
+  auto it = state->entries_.find(handle);
+  if (it == state->entries_.end()) {
+    return false;
+  }
+  cursor = std::move(it->second.cursor_);
+  state->entries_.erase(it);
+  return true;
+}
+
+// _____________________________________________________________________________
+size_t ResultCursors::makeRoom(ad_utility::MemorySize size) {
+  std::vector<std::shared_ptr<const Cursor>> evicted;
+  auto state = state_.wlock();
+  std::vector<std::pair<Clock::time_point, std::string>> byLastAccess;
+  for (const auto& [handle, entry] : state->entries_) {
+    byLastAccess.emplace_back(entry.lastAccess_, handle);
+  }
+  std::ranges::sort(byLastAccess);
+  ad_utility::MemorySize freed;
+  for (const auto& [lastAccess, handle] : byLastAccess) {
+    if (freed >= size) {
+      break;
+    }
+    auto it = state->entries_.find(handle);
+    freed += it->second.cursor_->size();
+    evicted.push_back(std::move(it->second.cursor_));
+    state->entries_.erase(it);
+  }
+  return evicted.size();
+}
+
+// _____________________________________________________________________________
+size_t ResultCursors::numCursors() const {
+  return state_.wlock()->entries_.size();
+}
+
+// _____________________________________________________________________________
+ad_utility::MemorySize ResultCursors::size() const {
+  ad_utility::MemorySize size;
+  auto state = state_.wlock();
+  for (const auto& [handle, entry] : state->entries_) {
+    size += entry.cursor_->size();
+  }
+  return size;
+}
+
+// _____________________________________________________________________________
+void ResultCursors::removeExpired(
+    State& state, std::vector<std::shared_ptr<const Cursor>>& evicted) const {
+  auto now = now_();
+  for (auto it = state.entries_.begin(); it != state.entries_.end();) {
+    auto& entry = it->second;
+    if (now - entry.lastAccess_ < entry.ttl_) {
+      ++it;
+      continue;
+    }
+    evicted.push_back(std::move(entry.cursor_));
+    state.entries_.erase(it++);
+  }
+}
@@ -0,0 +1,95 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/QueryExecutionTree.h"
+#include "engine/ResultTable.h"
+#include "index/Index.h"
+#include "util/HashMap.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Random.h"
+#include "util/Synchronized.h"
+
+// The results of SELECT queries that are kept by the server s.t. a client can
+// fetch them page by page (`cursor=open` together with a query, and then
+// `cursor=<handle>&offset=...&limit=...`). Unlike an `OFFSET` in a query,
+// which reads (or even computes) the whole result again, a page of a cursor
+// only serializes its rows.
+//
+// The results stay allocated with the allocator of the server, so they are
+// accounted for in its memory limit. A cursor expires if it wasn't accessed
+// for its time to live (TTL), and cursors are evicted (least recently used
+// first) when the server runs out of memory (see `makeRoom`).
+//
+// This class is threadsafe.
+class ResultCursors {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Cursor {
+    // The index on which the result was computed. It is kept alive as long as
+    // the cursor, even if the index of the server is replaced.
+    std::shared_ptr<const Index> index_;
+    std::shared_ptr<const ResultTable> result_;
+    // The columns of the `result_` for the selected variables.
+    QueryExecutionTree::ColumnIndicesAndTypes columns_;
+    std::vector<std::string> selectedVariables_;
+    // The rows of the `result_` after applying the LIMIT and OFFSET of the
+    // query are `[beginRow_, endRow_)`.
+    size_t beginRow_ = 0;
+    size_t endRow_ = 0;
+
+    size_t numRows() const { return endRow_ - beginRow_; }
+    ad_utility::MemorySize size() const;
+  };
+
+ private:
+  struct Entry {
+    std::shared_ptr<const Cursor> cursor_;
+    Clock::duration ttl_;
+    Clock::time_point lastAccess_;
+  };
+  struct State {
+    ad_utility::HashMap<std::string, Entry> entries_;
+    ad_utility::FastRandomIntGenerator<uint64_t> randomGenerator_;
+  };
+  ad_utility::Synchronized<State, std::mutex> state_;
+  std::function<Clock::time_point()> now_;
+
+ public:
+  explicit ResultCursors(std::function<Clock::time_point()> now = Clock::now);
+
+  // Keep the `cursor` for the `ttl` after its last access and return its
+  // handle, which is a random string that can't be guessed by other clients.
+  std::string open(Cursor cursor, Clock::duration ttl);
+
+  // Return the cursor with the `handle` and restart its TTL, or `nullptr` if
+  // there is no such cursor or if it has expired or was evicted.
+  std::shared_ptr<const Cursor> get(const std::string& handle);
+
+  // Remove the cursor with the `handle`. Return false if there is no such
+  // cursor.
+  bool close(const std::string& handle);
+
+  // Evict the least recently used cursors until their results take at least
+  // `size` (or all of them). Return the number of evicted cursors. A result
+  // that is also referenced elsewhere (for example by the cache) is only
+  // freed when the last reference is gone.
+  size_t makeRoom(ad_utility::MemorySize size);
+
+  size_t numCursors() const;
+  ad_utility::MemorySize size() const;
+
+ private:
+  // Remove the expired cursors from the `state`. Their results are moved to
+  // the `evicted` results, s.t. they are freed after the lock is released.
+  void removeExpired(State& state,
+                     std::vector<std::shared_ptr<const Cursor>>& evicted) const;
+};
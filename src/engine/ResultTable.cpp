@@ -7,10 +7,14 @@
 #include "engine/ResultTable.h"
 
 #include "engine/LocalVocab.h"
+#include "util/Algorithm.h"
 #include "util/Exception.h"
 
 // _____________________________________________________________________________
 string ResultTable::asDebugString() const {
+  if (!isFullyMaterialized()) {
+    return "Lazy result, the size is not known in advance";
+  }
   std::ostringstream os;
   os << "First (up to) 5 rows of result with size:\n";
   for (size_t i = 0; i < std::min<size_t>(5, idTable().size()); ++i) {
@@ -38,25 +42,26 @@ LocalVocab ResultTable::getCopyOfLocalVocab() const {
 // _____________________________________________________________________________
 ResultTable::ResultTable(IdTable idTable, vector<ColumnIndex> sortedBy,
                          SharedLocalVocabWrapper localVocab)
-    : _idTable{std::move(idTable)},
+    : data_{std::move(idTable)},
       _sortedBy{std::move(sortedBy)},
       localVocab_{std::move(localVocab.localVocab_)} {
   AD_CONTRACT_CHECK(localVocab_ != nullptr);
-  AD_CONTRACT_CHECK(std::ranges::all_of(_sortedBy, [this](size_t numCols) {
-    return numCols < this->idTable().numColumns();
-  }));
+  assertSortOrderIsRespected(this->idTable(), _sortedBy);
+}
 
-  [[maybe_unused]] auto compareRowsByJoinColumns = [this](const auto& row1,
-                                                          const auto& row2) {
-    for (size_t col : this->sortedBy()) {
-      if (row1[col] != row2[col]) {
-        return row1[col] < row2[col];
-      }
+// _____________________________________________________________________________
+ResultTable::ResultTable(Generator idTables, vector<ColumnIndex> sortedBy)
+    : data_{Generator{}}, _sortedBy{std::move(sortedBy)} {
+  // Check the invariants for each block as soon as it is produced. Note: The
+  // `sortedBy` columns have to be copied into the generator, because the
+  // `ResultTable` might be moved while the generator is still alive.
+  data_ = [](Generator generator,
+             std::vector<ColumnIndex> sortedBy) -> Generator {
+    for (IdTableVocabPair& pair : generator) {
+      assertSortOrderIsRespected(pair.idTable_, sortedBy);
+      co_yield pair;
     }
-    return false;
-  };
-  AD_EXPENSIVE_CHECK(
-      std::ranges::is_sorted(this->idTable(), compareRowsByJoinColumns));
+  }(std::move(idTables), _sortedBy);
 }
 
 // _____________________________________________________________________________
@@ -66,22 +71,93 @@ ResultTable::ResultTable(IdTable idTable, vector<ColumnIndex> sortedBy,
                   SharedLocalVocabWrapper{std::move(localVocab)}) {}
 
 // _____________________________________________________________________________
-void ResultTable::applyLimitOffset(const LimitOffsetClause& limitOffset) {
+const IdTable& ResultTable::idTable() const {
+  AD_CONTRACT_CHECK(isFullyMaterialized());
+  return std::get<IdTable>(data_);
+}
+
+// _____________________________________________________________________________
+auto ResultTable::idTables() const -> Generator& {
+  AD_CONTRACT_CHECK(!isFullyMaterialized());
+  return std::get<Generator>(data_);
+}
+
+// _____________________________________________________________________________
+void ResultTable::assertSortOrderIsRespected(
+    const IdTable& idTable, const std::vector<ColumnIndex>& sortedBy) {
+  AD_CONTRACT_CHECK(std::ranges::all_of(sortedBy, [&idTable](size_t numCols) {
+    return numCols < idTable.numColumns();
+  }));
+
+  [[maybe_unused]] auto compareRowsByJoinColumns = [&sortedBy](
+                                                       const auto& row1,
+                                                       const auto& row2) {
+    for (size_t col : sortedBy) {
+      if (row1[col] != row2[col]) {
+        return row1[col] < row2[col];
+      }
+    }
+    return false;
+  };
+  AD_EXPENSIVE_CHECK(std::ranges::is_sorted(idTable, compareRowsByJoinColumns));
+}
+
+namespace {
+// Apply the `limitOffset` to the `idTable` by shifting and then resizing it.
+void applyLimitOffsetToIdTable(IdTable& idTable,
+                               const LimitOffsetClause& limitOffset) {
   // Apply the OFFSET clause. If the offset is `0` or the offset is larger
   // than the size of the `IdTable`, then this has no effect and runtime
   // `O(1)` (see the docs for `std::shift_left`).
   std::ranges::for_each(
-      _idTable.getColumns(),
-      [offset = limitOffset.actualOffset(_idTable.numRows()),
+      idTable.getColumns(),
+      [offset = limitOffset.actualOffset(idTable.numRows()),
        upperBound =
-           limitOffset.upperBound(_idTable.numRows())](std::span<Id> column) {
+           limitOffset.upperBound(idTable.numRows())](std::span<Id> column) {
         std::shift_left(column.begin(), column.begin() + upperBound, offset);
       });
   // Resize the `IdTable` if necessary.
-  size_t targetSize = limitOffset.actualSize(_idTable.numRows());
-  AD_CORRECTNESS_CHECK(targetSize <= _idTable.numRows());
-  _idTable.resize(targetSize);
-  _idTable.shrinkToFit();
+  size_t targetSize = limitOffset.actualSize(idTable.numRows());
+  AD_CORRECTNESS_CHECK(targetSize <= idTable.numRows());
+  idTable.resize(targetSize);
+  idTable.shrinkToFit();
+}
+
+// Lazily apply the `limitOffset` to the blocks of the `generator`. Blocks that
+// become empty are skipped, and the generator stops as soon as the LIMIT is
+// reached, s.t. the remaining blocks are never computed.
+ResultTable::Generator applyLimitOffsetLazily(ResultTable::Generator generator,
+                                              LimitOffsetClause limitOffset) {
+  if (limitOffset._limit == 0) {
+    co_return;
+  }
+  for (ResultTable::IdTableVocabPair& pair : generator) {
+    IdTable& idTable = pair.idTable_;
+    size_t sizeBefore = idTable.numRows();
+    size_t offsetInThisBlock = limitOffset.actualOffset(sizeBefore);
+    applyLimitOffsetToIdTable(idTable, limitOffset);
+    limitOffset._offset -= offsetInThisBlock;
+    if (limitOffset._limit.has_value()) {
+      limitOffset._limit.value() -= idTable.numRows();
+    }
+    if (!idTable.empty()) {
+      co_yield pair;
+    }
+    if (limitOffset._limit == 0) {
+      co_return;
+    }
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void ResultTable::applyLimitOffset(const LimitOffsetClause& limitOffset) {
+  if (isFullyMaterialized()) {
+    applyLimitOffsetToIdTable(std::get<IdTable>(data_), limitOffset);
+  } else if (limitOffset._limit.has_value() || limitOffset._offset != 0) {
+    data_ = applyLimitOffsetLazily(std::move(std::get<Generator>(data_)),
+                                   limitOffset);
+  }
 }
 
 // _____________________________________________________________________________
@@ -90,10 +166,11 @@ auto ResultTable::getOrComputeDatatypeCountsPerColumn()
   if (datatypeCountsPerColumn_.has_value()) {
     return datatypeCountsPerColumn_.value();
   }
+  const IdTable& table = idTable();
   auto& types = datatypeCountsPerColumn_.emplace();
-  types.resize(_idTable.numColumns());
-  for (size_t i = 0; i < _idTable.numColumns(); ++i) {
-    const auto& col = _idTable.getColumn(i);
+  types.resize(table.numColumns());
+  for (size_t i = 0; i < table.numColumns(); ++i) {
+    const auto& col = table.getColumn(i);
     auto& datatypes = types.at(i);
     for (Id id : col) {
       ++datatypes[static_cast<size_t>(id.getDatatype())];
@@ -113,3 +190,14 @@ bool ResultTable::checkDefinedness(const VariableToColumnMap& varColMap) {
            !hasUndefined;
   });
 }
+
+// _____________________________________________________________
+bool ResultTable::checkDefinednessOfBlock(
+    const IdTable& idTable, const VariableToColumnMap& varColMap) {
+  return std::ranges::all_of(varColMap, [&](const auto& varAndCol) {
+    const auto& [columnIndex, mightContainUndef] = varAndCol.second;
+    return mightContainUndef == ColumnIndexAndTypeInfo::PossiblyUndefined ||
+           !ad_utility::contains(idTable.getColumn(columnIndex),
+                                 Id::makeUndefined());
+  });
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <ranges>
+#include <variant>
 #include <vector>
 
 #include "engine/LocalVocab.h"
@@ -14,21 +15,37 @@
 #include "engine/idTable/IdTable.h"
 #include "global/Id.h"
 #include "parser/data/LimitOffsetClause.h"
+#include "util/Generator.h"
 #include "util/Log.h"
 
 using std::vector;
 
 // The result of an `Operation`. This is the class QLever uses for all
 // intermediate or final results when processing a SPARQL query. The actual data
-// is always a table and contained in the member `idTable()`.
+// is either a single table that is contained in the member `idTable()` (a fully
+// materialized result), or a generator of tables (blocks) that is accessible
+// via `idTables()` (a lazy result). For the lazy case, each block comes with
+// its own local vocabulary.
 //
 // TODO: I would find it more appropriate to simply call this class `Result`.
 // Otherwise, it's not clear from the names what the difference between a
 // `ResultTable` and an `IdTable` is.
 class ResultTable {
+ public:
+  // A single block of a lazy result together with the local vocabulary that is
+  // needed to resolve the IDs in this block.
+  struct IdTableVocabPair {
+    IdTable idTable_;
+    LocalVocab localVocab_;
+  };
+  // The type of a lazy result.
+  using Generator = cppcoro::generator<IdTableVocabPair>;
+
  private:
-  // The actual entries.
-  IdTable _idTable;
+  // The actual entries. For a lazy result, the generator is stored. It is
+  // `mutable` because consuming it (via `idTables()`) is a logically const
+  // operation that is only allowed to happen once.
+  mutable std::variant<IdTable, Generator> data_;
 
   // The column indices by which the result is sorted (primary sort key first).
   // Empty if the result is not sorted on any column.
@@ -91,6 +108,11 @@ class ResultTable {
   ResultTable(IdTable idTable, std::vector<ColumnIndex> sortedBy,
               LocalVocab&& localVocab);
 
+  // Construct a lazy result from a generator of blocks. Each of the blocks
+  // must be sorted by the `sortedBy` columns. The order between the blocks is
+  // not checked and has to be guaranteed by the caller.
+  ResultTable(Generator idTables, std::vector<ColumnIndex> sortedBy);
+
   // Prevent accidental copying of a result table.
   ResultTable(const ResultTable& other) = delete;
   ResultTable& operator=(const ResultTable& other) = delete;
@@ -102,14 +124,29 @@ class ResultTable {
   // Default destructor.
   virtual ~ResultTable() = default;
 
-  // Get the number of rows of this result.
-  size_t size() const { return _idTable.size(); }
+  // Get the number of rows of this result. Requires that the result is fully
+  // materialized.
+  size_t size() const { return idTable().size(); }
 
-  // Get the number of columns of this result.
-  size_t width() const { return _idTable.numColumns(); }
+  // Get the number of columns of this result. Requires that the result is
+  // fully materialized.
+  size_t width() const { return idTable().numColumns(); }
 
-  // Const access to the underlying `IdTable`.
-  const IdTable& idTable() const { return _idTable; }
+  // Return true iff the result is stored as a single `IdTable` and not as a
+  // lazy generator of blocks.
+  bool isFullyMaterialized() const {
+    return std::holds_alternative<IdTable>(data_);
+  }
+
+  // Const access to the underlying `IdTable`. Requires that the result is fully
+  // materialized.
+  const IdTable& idTable() const;
+
+  // Access to the generator of a lazy result. Requires that the result is not
+  // fully materialized. Note: The generator can be iterated only once, so
+  // typically the only code that calls this function is the (single) consumer
+  // of this result.
+  Generator& idTables() const;
 
   // Const access to the columns by which the `idTable()` is sorted.
   const std::vector<ColumnIndex>& sortedBy() const { return _sortedBy; }
@@ -133,6 +170,15 @@ class ResultTable {
     return SharedLocalVocabWrapper{localVocab_};
   }
 
+  // Share a local vocab that is also owned by code outside of the `ResultTable`
+  // class. The caller has to guarantee that the local vocab is never changed
+  // (this is the case for the local vocab of the `DeltaTriples`, which is
+  // copied before new words are added).
+  static SharedLocalVocabWrapper shareImmutableLocalVocab(
+      std::shared_ptr<const LocalVocab> localVocab) {
+    return SharedLocalVocabWrapper{std::move(localVocab)};
+  }
+
   // Like `getSharedLocalVocabFrom`, but takes more than one result and assumes
   // that exactly one of the local vocabularies is empty and gets the shared
   // local vocab from the non-empty one (if all are empty, arbitrarily share
@@ -154,8 +200,17 @@ class ResultTable {
     auto hasNonEmptyVocab = [](const ResultTable& tbl) {
       return !tbl.localVocab_->empty();
     };
-    auto numNonEmptyVocabs =
-        std::ranges::count_if(subResults, hasNonEmptyVocab);
+    // Several results can share the same local vocab (e.g. the results of
+    // index scans share the local vocab of the `DeltaTriples`), this is fine.
+    std::vector<const LocalVocab*> nonEmptyVocabs;
+    for (const ResultTable& subResult : subResults) {
+      if (hasNonEmptyVocab(subResult) &&
+          std::ranges::find(nonEmptyVocabs, subResult.localVocab_.get()) ==
+              nonEmptyVocabs.end()) {
+        nonEmptyVocabs.push_back(subResult.localVocab_.get());
+      }
+    }
+    auto numNonEmptyVocabs = nonEmptyVocabs.size();
     if (numNonEmptyVocabs > 1) {
       throw std::runtime_error(
           "Merging of more than one non-empty local vocabularies is currently "
@@ -185,13 +240,22 @@ class ResultTable {
   // place, but for now, this method at least makes sure that these log
   // messages look all the same.
   void logResultSize() const {
-    LOG(INFO) << "Result has size " << size() << " x " << width() << std::endl;
+    if (isFullyMaterialized()) {
+      LOG(INFO) << "Result has size " << size() << " x " << width()
+                << std::endl;
+    } else {
+      LOG(INFO) << "Result is lazy, its size is not known in advance"
+                << std::endl;
+    }
   }
 
   // The first rows of the result and its total size (for debugging).
   string asDebugString() const;
 
   // Apply the `limitOffset` clause by shifting and then resizing the `IdTable`.
+  // For a lazy result, the generator is wrapped s.t. the blocks are shifted and
+  // resized as they are produced and the generator stops as soon as the LIMIT
+  // is reached.
   // Note: If additional members and invariants are added to the class (for
   // example information about the datatypes in each column) make sure that
   // those are still correct after performing this operation.
@@ -199,12 +263,24 @@ class ResultTable {
 
   // Get the information, which columns stores how many entries of each
   // datatype. This information is computed on the first call to this function
-  // `O(num-entries-in-table)` and then cached for subsequent usages.
+  // `O(num-entries-in-table)` and then cached for subsequent usages. Requires
+  // that the result is fully materialized.
   const DatatypeCountsPerColumn& getOrComputeDatatypeCountsPerColumn();
 
   // Check that if the `varColMap` guarantees that a column is always defined
   // (i.e. that is contains no single undefined value) that there are indeed no
   // undefined values in the `_idTable` of this result. Return `true` iff the
-  // check is succesful.
+  // check is succesful. Requires that the result is fully materialized.
   bool checkDefinedness(const VariableToColumnMap& varColMap);
+
+  // The same check as `checkDefinedness` above, but for a single block of a
+  // lazy result.
+  static bool checkDefinednessOfBlock(const IdTable& idTable,
+                                      const VariableToColumnMap& varColMap);
+
+ private:
+  // Check that the `idTable` is sorted by the `sortedBy` columns. The check
+  // of the actual sorting is only performed if expensive checks are enabled.
+  static void assertSortOrderIsRespected(
+      const IdTable& idTable, const std::vector<ColumnIndex>& sortedBy);
 };
@@ -195,7 +195,9 @@ void to_json(nlohmann::ordered_json& j, const RuntimeInformation& rti) {
 void to_json(nlohmann::ordered_json& j,
              const RuntimeInformationWholeQuery& rti) {
   j = nlohmann::ordered_json{
-      {"time_query_planning", rti.timeQueryPlanning.count()}};
+      {"time_query_planning", rti.timeQueryPlanning.count()},
+      {"num_candidate_plans", rti.numCandidatePlans},
+      {"num_idp_iterations", rti.numIdpIterations}};
 }
 
 // __________________________________________________________________________
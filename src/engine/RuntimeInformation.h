@@ -141,6 +141,13 @@ struct RuntimeInformationWholeQuery {
   // The time spent during query planning (this does not include the time spent
   // on `IndexScan`s that were executed during the query planning).
   std::chrono::milliseconds timeQueryPlanning = RuntimeInformation::ZERO;
+  // The number of candidate plans that the dynamic programming of the query
+  // planner created (before pruning the ones that are dominated by others).
+  size_t numCandidatePlans = 0;
+  // The number of steps of the iterative dynamic programming for large
+  // connected components. Zero means that all the join orders were found via
+  // the exhaustive dynamic programming.
+  size_t numIdpIterations = 0;
   /// Output as json. The signature of this function is mandated by the json
   /// library to allow for implicit conversion.
   friend void to_json(nlohmann::ordered_json& j,
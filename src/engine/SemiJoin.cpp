@@ -0,0 +1,237 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/SemiJoin.h"
+
+#include "engine/CallFixedSize.h"
+#include "engine/IndexScan.h"
+#include "util/Exception.h"
+#include "util/JoinAlgorithms/Gallop.h"
+
+// _____________________________________________________________________________
+SemiJoin::SemiJoin(QueryExecutionContext* qec,
+                   std::shared_ptr<QueryExecutionTree> left,
+                   std::shared_ptr<QueryExecutionTree> right)
+    : Operation{qec} {
+  // Without shared variables, the inputs need not be sorted (see
+  // `computeResult`).
+  if (QueryExecutionTree::getJoinColumns(*left, *right).empty()) {
+    left_ = std::move(left);
+    right_ = std::move(right);
+    return;
+  }
+  std::tie(left_, right_, joinColumns_) =
+      QueryExecutionTree::getSortedSubtreesAndJoinColumns(std::move(left),
+                                                          std::move(right));
+}
+
+// _____________________________________________________________________________
+string SemiJoin::getCacheKeyImpl() const {
+  std::ostringstream os;
+  os << "SEMI JOIN\n" << left_->getCacheKey() << "\n";
+  os << right_->getCacheKey() << " ";
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string SemiJoin::getDescriptor() const { return "Semi-join"; }
+
+// _____________________________________________________________________________
+size_t SemiJoin::getResultWidth() const { return left_->getResultWidth(); }
+
+// _____________________________________________________________________________
+vector<ColumnIndex> SemiJoin::resultSortedOn() const {
+  return left_->resultSortedOn();
+}
+
+// _____________________________________________________________________________
+VariableToColumnMap SemiJoin::computeVariableToColumnMap() const {
+  return left_->getVariableColumns();
+}
+
+// _____________________________________________________________________________
+float SemiJoin::getMultiplicity(size_t col) {
+  // This is an upper bound, like the size estimate below.
+  return left_->getMultiplicity(col);
+}
+
+// _____________________________________________________________________________
+uint64_t SemiJoin::getSizeEstimateBeforeLimit() {
+  auto leftSize = static_cast<double>(left_->getSizeEstimate());
+  if (joinColumns_.empty()) {
+    return right_->knownEmptyResult() ? 0 : static_cast<uint64_t>(leftSize);
+  }
+  // Assume that the distinct values of the first join column of the input with
+  // fewer of them are all contained in the other input.
+  auto numDistinct = [](QueryExecutionTree& tree, ColumnIndex column) {
+    return static_cast<double>(tree.getSizeEstimate()) /
+           std::max(1.0f, tree.getMultiplicity(column));
+  };
+  double leftDistinct = numDistinct(*left_, joinColumns_[0][0]);
+  double rightDistinct = numDistinct(*right_, joinColumns_[0][1]);
+  double fraction =
+      leftDistinct == 0 ? 1.0 : std::min(1.0, rightDistinct / leftDistinct);
+  return static_cast<uint64_t>(leftSize * fraction);
+}
+
+// _____________________________________________________________________________
+size_t SemiJoin::getCostEstimate() {
+  size_t costEstimate = left_->getSizeEstimate() + right_->getSizeEstimate();
+  return left_->getCostEstimate() + right_->getCostEstimate() + costEstimate;
+}
+
+// _____________________________________________________________________________
+ResultTable SemiJoin::computeResult(bool requestLaziness) {
+  // Without shared variables, the result is the left input if the right input
+  // is not empty, and empty otherwise.
+  if (joinColumns_.empty()) {
+    if (right_->getResult()->idTable().empty()) {
+      left_->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+      return {IdTable{getResultWidth(), getExecutionContext()->getAllocator()},
+              resultSortedOn(), LocalVocab{}};
+    }
+    auto leftResult = left_->getResult();
+    return {leftResult->idTable().clone(), resultSortedOn(),
+            leftResult->getSharedLocalVocab()};
+  }
+
+  // If the right input is an `IndexScan` on the first join column that is not
+  // cached, only the blocks of the scan that can contain a row that matches
+  // the left input are read (see `Minus::computeResult`).
+  if (right_->getType() == QueryExecutionTree::SCAN &&
+      joinColumns_[0][1] == 0) {
+    auto& scan = dynamic_cast<IndexScan&>(*right_->getRootOperation());
+    if (!scan.hasDeltaTriples() && scan.numVariables() <= 2 &&
+        !scan.getResult(false, ComputationMode::ONLY_IF_CACHED)) {
+      auto leftResult = left_->getResult();
+      const IdTable& left = leftResult->idTable();
+      IdTable right =
+          readBlocksForJoinColumn(left.getColumn(joinColumns_[0][0]), scan);
+      return {computeMaterialized(left, right), resultSortedOn(),
+              leftResult->getSharedLocalVocab()};
+    }
+  }
+
+  std::shared_ptr<const ResultTable> leftResult;
+  std::shared_ptr<const ResultTable> rightResult;
+  if (requestLaziness) {
+    rightResult = right_->getResult();
+    leftResult = left_->getResult(true);
+  } else {
+    auto childResults = getChildResults(std::array{left_, right_});
+    leftResult = std::move(childResults[0]);
+    rightResult = std::move(childResults[1]);
+  }
+  if (!leftResult->isFullyMaterialized()) {
+    return {computeLazily(std::move(leftResult), std::move(rightResult)),
+            resultSortedOn()};
+  }
+  // The result only contains rows of the left input.
+  return {computeMaterialized(leftResult->idTable(), rightResult->idTable()),
+          resultSortedOn(), leftResult->getSharedLocalVocab()};
+}
+
+// _____________________________________________________________________________
+IdTable SemiJoin::computeMaterialized(const IdTable& left,
+                                      const IdTable& right) const {
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  size_t rightBegin = 0;
+  int leftWidth = left.numColumns();
+  int rightWidth = right.numColumns();
+  CALL_FIXED_SIZE((std::array{leftWidth, rightWidth}),
+                  &SemiJoin::computeSemiJoin, this, left, right, joinColumns_,
+                  &result, rightBegin);
+  return result;
+}
+
+// _____________________________________________________________________________
+ResultTable::Generator SemiJoin::computeLazily(
+    std::shared_ptr<const ResultTable> leftResult,
+    std::shared_ptr<const ResultTable> rightResult) const {
+  const IdTable& right = rightResult->idTable();
+  // The left input is sorted across all its blocks, so the rows of the right
+  // input that were skipped for one block can be skipped for all the following
+  // blocks.
+  size_t rightBegin = 0;
+  for (auto& [block, localVocab] : leftResult->idTables()) {
+    IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+    int leftWidth = block.numColumns();
+    int rightWidth = right.numColumns();
+    CALL_FIXED_SIZE((std::array{leftWidth, rightWidth}),
+                    &SemiJoin::computeSemiJoin, this, block, right,
+                    joinColumns_, &result, rightBegin);
+    if (!result.empty()) {
+      co_yield ResultTable::IdTableVocabPair{std::move(result),
+                                             std::move(localVocab)};
+    }
+  }
+}
+
+// _____________________________________________________________________________
+IdTable SemiJoin::readBlocksForJoinColumn(std::span<const Id> leftJoinColumn,
+                                          IndexScan& scan) const {
+  auto blocks =
+      IndexScan::lazyScanForJoinOfColumnWithScan(leftJoinColumn, scan);
+  IdTable right{scan.getResultWidth(), getExecutionContext()->getAllocator()};
+  for (const IdTable& block : blocks) {
+    checkCancellation();
+    right.insertAtEnd(block);
+  }
+  scan.updateRuntimeInfoForLazyScan(blocks.details());
+  return right;
+}
+
+// _____________________________________________________________________________
+template <int LEFT_WIDTH, int RIGHT_WIDTH>
+void SemiJoin::computeSemiJoin(
+    const IdTable& dynLeft, const IdTable& dynRight,
+    const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
+    IdTable* dynResult, size_t& rightBegin) const {
+  AD_CONTRACT_CHECK(!joinColumns.empty());
+  IdTableView<LEFT_WIDTH> left = dynLeft.asStaticView<LEFT_WIDTH>();
+  IdTableView<RIGHT_WIDTH> right = dynRight.asStaticView<RIGHT_WIDTH>();
+  IdTableStatic<LEFT_WIDTH> result =
+      std::move(*dynResult).toStatic<LEFT_WIDTH>();
+
+  // Compare the join columns after the first one of the given rows.
+  auto compareRest = [&left, &right, &joinColumns](
+                         size_t iLeft, size_t iRight) -> std::strong_ordering {
+    for (size_t i = 1; i < joinColumns.size(); ++i) {
+      auto order = left(iLeft, joinColumns[i][0]) <=>
+                   right(iRight, joinColumns[i][1]);
+      if (order != 0) {
+        return order;
+      }
+    }
+    return std::strong_ordering::equal;
+  };
+
+  std::span<const Id> leftFirst = left.getColumn(joinColumns[0][0]);
+  std::span<const Id> rightFirst = right.getColumn(joinColumns[0][1]);
+  size_t iLeft = 0;
+  size_t iRight = rightBegin;
+  while (iLeft < left.size() && iRight < right.size()) {
+    checkCancellation();
+    Id leftId = leftFirst[iLeft];
+    Id rightId = rightFirst[iRight];
+    // Skip the rows without a match on the first join column by galloping.
+    if (leftId < rightId) {
+      iLeft = ad_utility::gallop(leftFirst, iLeft,
+                                 [rightId](Id x) { return x < rightId; });
+    } else if (rightId < leftId) {
+      iRight = ad_utility::gallop(rightFirst, iRight,
+                                  [leftId](Id x) { return x < leftId; });
+    } else if (auto order = compareRest(iLeft, iRight); order < 0) {
+      ++iLeft;
+    } else if (order > 0) {
+      ++iRight;
+    } else {
+      // The left row has a match, so it is not probed any further. The right
+      // row can match the following left rows, so it is not skipped.
+      result.push_back(left[iLeft]);
+      ++iLeft;
+    }
+  }
+  rightBegin = iRight;
+  *dynResult = std::move(result).toDynamic();
+}
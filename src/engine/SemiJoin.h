@@ -0,0 +1,94 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "engine/Operation.h"
+#include "engine/QueryExecutionTree.h"
+
+class IndexScan;
+
+// The semi-join of `SPARQL`: All the rows of the left input that have a
+// compatible row in the right input on the shared variables, each at most once
+// and with only the columns of the left input. This is the result of a
+// `FILTER EXISTS` and of a join that is followed by a `DISTINCT` on variables
+// of only one of its inputs. The probing of a left row stops at its first
+// match. Like for `Minus`, the left input is streamed if the result is
+// requested lazily, and the right input is skipped by galloping and, if it is
+// an `IndexScan`, by reading only the blocks that can contain a match.
+class SemiJoin : public Operation {
+ private:
+  std::shared_ptr<QueryExecutionTree> left_;
+  std::shared_ptr<QueryExecutionTree> right_;
+  std::vector<std::array<ColumnIndex, 2>> joinColumns_;
+
+ public:
+  SemiJoin(QueryExecutionContext* qec, std::shared_ptr<QueryExecutionTree> left,
+           std::shared_ptr<QueryExecutionTree> right);
+
+ protected:
+  string getCacheKeyImpl() const override;
+
+ public:
+  string getDescriptor() const override;
+
+  size_t getResultWidth() const override;
+
+  vector<ColumnIndex> resultSortedOn() const override;
+
+  void setTextLimit(size_t limit) override {
+    left_->setTextLimit(limit);
+    right_->setTextLimit(limit);
+  }
+
+  bool knownEmptyResult() override {
+    return left_->knownEmptyResult() || right_->knownEmptyResult();
+  }
+
+  float getMultiplicity(size_t col) override;
+
+ private:
+  uint64_t getSizeEstimateBeforeLimit() override;
+
+ public:
+  size_t getCostEstimate() override;
+
+  vector<QueryExecutionTree*> getChildren() override {
+    return {left_.get(), right_.get()};
+  }
+
+  // Append the rows of `left` that have a row in `right` with the same values
+  // in the `joinColumns` to the `result`. Both inputs must be sorted by the
+  // join columns. The rows of `right` before `rightBegin` are skipped, and
+  // `rightBegin` is set to the position from which a following block of the
+  // left input (which is sorted after the rows of this `left`) can continue.
+  // This method is public for testing.
+  template <int LEFT_WIDTH, int RIGHT_WIDTH>
+  void computeSemiJoin(
+      const IdTable& left, const IdTable& right,
+      const std::vector<std::array<ColumnIndex, 2>>& joinColumns,
+      IdTable* result, size_t& rightBegin) const;
+
+ private:
+  ResultTable computeResult(bool requestLaziness) override;
+
+  // Compute the result for a `leftResult` that is yielded lazily in blocks.
+  // The `rightResult` must be fully materialized.
+  ResultTable::Generator computeLazily(
+      std::shared_ptr<const ResultTable> leftResult,
+      std::shared_ptr<const ResultTable> rightResult) const;
+
+  // Compute the result for two fully materialized inputs.
+  IdTable computeMaterialized(const IdTable& left, const IdTable& right) const;
+
+  // Read the blocks of the `scan` (the right input) that can contain a row
+  // with a value from the (sorted) `leftJoinColumn` in its first column.
+  IdTable readBlocksForJoinColumn(std::span<const Id> leftJoinColumn,
+                                  IndexScan& scan) const;
+
+  VariableToColumnMap computeVariableToColumnMap() const override;
+};
@@ -6,17 +6,33 @@
 
 #include "engine/Server.h"
 
+#include <array>
 #include <cstring>
+#include <filesystem>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "CompilationInfo.h"
+#include "engine/CacheWarmup.h"
+#include "engine/CardinalityFeedback.h"
 #include "engine/ExportQueryExecutionTrees.h"
+#include "engine/IdTableExchange.h"
 #include "engine/QueryPlanner.h"
+#include "engine/QueryRuntimeEstimator.h"
+#include "engine/SlowQueryLog.h"
+#include "index/DecompressedBlockCache.h"
+#include "index/VocabularyWordCache.h"
+#include "index/DeltaTriples.h"
 #include "util/AsioHelpers.h"
+#include "util/HugePages.h"
 #include "util/MemorySize/MemorySize.h"
+#include "util/Metrics.h"
 #include "util/OnDestructionDontThrowDuringStackUnwinding.h"
 #include "util/ParseableDuration.h"
+#include "util/Probes.h"
+#include "util/QueryTrace.h"
+#include "util/http/HttpClient.h"
 #include "util/http/HttpUtils.h"
 #include "util/http/websocket/MessageSender.h"
 
@@ -32,23 +48,60 @@ Server::Server(unsigned short port, size_t numThreads,
       accessToken_(std::move(accessToken)),
       allocator_{ad_utility::makeAllocationMemoryLeftThreadsafeObject(maxMem),
                  [this](ad_utility::MemorySize numMemoryToAllocate) {
-                   cache_.makeRoomAsMuchAsPossible(MAKE_ROOM_SLACK_FACTOR *
-                                                   numMemoryToAllocate);
+                   makeRoomForAllocation(numMemoryToAllocate);
                  }},
-      index_{allocator_},
+      // The number of queries that are computed at the same time is limited
+      // by the number of threads.
+      admissionController_{numThreads, maxMem},
+      indexAndCache_{std::make_shared<IndexAndCache>(allocator_)},
       enablePatternTrick_(usePatternTrick),
       // The number of server threads currently also is the number of queries
-      // that can be processed simultaneously.
+      // that can be processed simultaneously. Both are changed by the runtime
+      // parameter `num-query-threads` (see below).
       threadPool_{numThreads} {
   // This also directly triggers the update functions and propagates the
   // values of the parameters to the cache.
   RuntimeParameters().setOnUpdateAction<"cache-max-num-entries">(
-      [this](size_t newValue) { cache_.setMaxNumEntries(newValue); });
+      [this](size_t newValue) {
+        getIndexAndCache()->cache_.setMaxNumEntries(newValue);
+      });
+  RuntimeParameters().setOnUpdateAction<"parsed-query-cache-max-num-entries">(
+      [this](size_t newValue) {
+        parsedQueryCache_.setMaxNumEntries(newValue);
+      });
   RuntimeParameters().setOnUpdateAction<"cache-max-size">(
-      [this](ad_utility::MemorySize newValue) { cache_.setMaxSize(newValue); });
+      [this](ad_utility::MemorySize newValue) {
+        getIndexAndCache()->cache_.setMaxSize(newValue);
+      });
   RuntimeParameters().setOnUpdateAction<"cache-max-size-single-entry">(
       [this](ad_utility::MemorySize newValue) {
-        cache_.setMaxSizeSingleEntry(newValue);
+        getIndexAndCache()->cache_.setMaxSizeSingleEntry(newValue);
+      });
+  RuntimeParameters().setOnUpdateAction<"cache-eviction-policy">(
+      [this](const std::string& newValue) {
+        getIndexAndCache()->cache_.setEvictionPolicy(
+            ad_utility::evictionPolicyFromString(newValue));
+      });
+  RuntimeParameters().setOnUpdateAction<"decompressed-block-cache-max-size">(
+      [](ad_utility::MemorySize newValue) {
+        getDecompressedBlockCache().setMaxSize(newValue);
+      });
+  RuntimeParameters().setOnUpdateAction<"vocabulary-cache-max-size">(
+      [](ad_utility::MemorySize newValue) {
+        getVocabularyWordCache().setMaxSize(newValue);
+      });
+  RuntimeParameters().setOnUpdateAction<"huge-pages-min-size">(
+      [](ad_utility::MemorySize newValue) {
+        ad_utility::hugePages::setMinSize(newValue);
+      });
+  RuntimeParameters().setOnUpdateAction<"num-query-threads">(
+      [this](size_t newValue) { setNumQueryThreads(newValue); });
+  RuntimeParameters().setOnUpdateAction<"persistent-cache-max-size">(
+      [this](ad_utility::MemorySize newValue) {
+        if (auto* persistentCache =
+                getIndexAndCache()->cache_.persistentCache()) {
+          persistentCache->setMaxSize(newValue);
+        }
       });
 }
 
@@ -57,18 +110,65 @@ void Server::initialize(const string& indexBaseName, bool useText,
                         bool usePatterns, bool loadAllPermutations) {
   LOG(INFO) << "Initializing server ..." << std::endl;
 
-  index_.usePatterns() = usePatterns;
-  index_.loadAllPermutations() = loadAllPermutations;
+  useText_ = useText;
+  usePatterns_ = usePatterns;
+  loadAllPermutations_ = loadAllPermutations;
+  if (RuntimeParameters().get<"numa-aware">()) {
+    auto nodes = ad_utility::numa::getNodes();
+    std::erase_if(nodes, [](const auto& node) { return node.cpus_.empty(); });
+    LOG(INFO) << "Number of NUMA nodes for the threads of the server: "
+              << nodes.size() << std::endl;
+    if (nodes.size() > 1) {
+      numaNodes_ = std::move(nodes);
+    }
+  }
+  auto indexAndCache = getIndexAndCache();
+  auto& index = indexAndCache->index_;
+  auto& cache = indexAndCache->cache_;
+  loadIndex(index, indexBaseName);
+
+  // Open the persistent second tier of the cache. Its entries are only valid
+  // for the same index and the same build of QLever. The configuration file is
+  // rewritten whenever the index is rebuilt.
+  if (std::string directory =
+          RuntimeParameters().get<"persistent-cache-directory">();
+      !directory.empty()) {
+    auto configurationFile = indexBaseName + CONFIGURATION_FILE;
+    auto indexVersion = absl::StrCat(
+        indexBaseName, " ", qlever::version::GitHash, " ",
+        std::filesystem::last_write_time(configurationFile)
+            .time_since_epoch()
+            .count());
+    cache.setPersistentCache(std::make_unique<PersistentResultCache>(
+        directory, std::move(indexVersion),
+        RuntimeParameters().get<"persistent-cache-max-size">()));
+  }
+
+  if (std::string file = RuntimeParameters().get<"cardinality-feedback-file">();
+      !file.empty()) {
+    getCardinalityFeedback().setFile(file);
+  }
 
-  // Init the index.
-  index_.createFromOnDiskIndex(indexBaseName);
-  if (useText) {
-    index_.addTextFromOnDiskIndex();
+  // The estimates are stored next to the index, s.t. they only have to be
+  // computed again when the hardware or the build changes.
+  sortPerformanceEstimator_.computeEstimatesOrReadFromFile(
+      allocator_,
+      index.numTriples().normalAndInternal_() *
+          PERCENTAGE_OF_TRIPLES_FOR_SORT_ESTIMATE / 100,
+      indexBaseName + SORT_ESTIMATES_FILE_SUFFIX,
+      RuntimeParameters().get<"recompute-sort-estimates">());
+
+  if (std::string queryFile = RuntimeParameters().get<"warmup-query-file">();
+      !queryFile.empty()) {
+    cacheWarmup::run(index, cache, allocator_, sortPerformanceEstimator_,
+                     enablePatternTrick_, queryFile,
+                     indexBaseName + WARMUP_BLOCKS_FILE_SUFFIX,
+                     RuntimeParameters().get<"warmup-num-threads">());
   }
 
-  sortPerformanceEstimator_.computeEstimatesExpensively(
-      allocator_, index_.numTriples().normalAndInternal_() *
-                      PERCENTAGE_OF_TRIPLES_FOR_SORT_ESTIMATE / 100);
+  materializedViews_.readFromFile(
+      absl::StrCat(indexBaseName, MaterializedViews::FILE_SUFFIX));
+  computeMaterializedViews(index, cache, materializedViews_.definitions());
 
   LOG(INFO) << "Access token for restricted API calls is \"" << accessToken_
             << "\"" << std::endl;
@@ -76,6 +176,113 @@ void Server::initialize(const string& indexBaseName, bool useText,
             << std::to_string(port_) << " ..." << std::endl;
 }
 
+// _____________________________________________________________________________
+void Server::loadIndex(Index& index, const std::string& indexBaseName) const {
+  index.usePatterns() = usePatterns_;
+  index.loadAllPermutations() = loadAllPermutations_;
+  // The data of the index is read by the threads on all NUMA nodes, so it is
+  // interleaved across them.
+  std::optional<ad_utility::numa::InterleaveMemoryOfCurrentThread>
+      interleaveIndexData;
+  if (RuntimeParameters().get<"numa-aware">()) {
+    interleaveIndexData.emplace(ad_utility::numa::getNodes());
+    if (interleaveIndexData->isActive()) {
+      LOG(INFO) << "The index data is interleaved across the NUMA nodes"
+                << std::endl;
+    }
+  }
+  index.createFromOnDiskIndex(indexBaseName);
+  if (useText_) {
+    index.addTextFromOnDiskIndex();
+  }
+}
+
+// _____________________________________________________________________________
+void Server::configureCache(QueryResultCache& cache) {
+  auto& parameters = RuntimeParameters();
+  cache.setMaxNumEntries(parameters.get<"cache-max-num-entries">());
+  cache.setMaxSize(parameters.get<"cache-max-size">());
+  cache.setMaxSizeSingleEntry(parameters.get<"cache-max-size-single-entry">());
+  cache.setEvictionPolicy(ad_utility::evictionPolicyFromString(
+      parameters.get<"cache-eviction-policy">()));
+}
+
+// _____________________________________________________________________________
+void Server::swapIndex(const std::string& indexBaseName) {
+  if (isSwappingIndex_.exchange(true)) {
+    throw std::runtime_error{
+        "Another index is currently being loaded, try again later"};
+  }
+  absl::Cleanup resetIsSwapping{[this]() { isSwappingIndex_ = false; }};
+  ad_utility::Timer timer{ad_utility::Timer::Started};
+  LOG(INFO) << "Loading the index \"" << indexBaseName
+            << "\" to replace the current index ..." << std::endl;
+  auto oldIndexAndCache = getIndexAndCache();
+  auto newIndexAndCache = std::make_shared<IndexAndCache>(allocator_);
+  auto& index = newIndexAndCache->index_;
+  auto& cache = newIndexAndCache->cache_;
+  loadIndex(index, indexBaseName);
+  configureCache(cache);
+
+  // Warm up the new cache, first with the warm-up queries, then with the
+  // queries of the most important results of the old cache. The persistent
+  // cache is not used for the new index, because it would delete the entries
+  // of the old index that are still in use.
+  size_t numThreads = RuntimeParameters().get<"warmup-num-threads">();
+  if (std::string queryFile = RuntimeParameters().get<"warmup-query-file">();
+      !queryFile.empty()) {
+    cacheWarmup::run(index, cache, allocator_, sortPerformanceEstimator_,
+                     enablePatternTrick_, queryFile,
+                     indexBaseName + WARMUP_BLOCKS_FILE_SUFFIX, numThreads);
+  }
+  // The materialized views of the new index are defined next to it.
+  auto viewsFile = absl::StrCat(indexBaseName, MaterializedViews::FILE_SUFFIX);
+  MaterializedViews newViews;
+  newViews.readFromFile(viewsFile);
+  computeMaterializedViews(index, cache, newViews.definitions());
+  std::array<std::vector<std::string>, 2> queriesByIsPinned;
+  for (auto& [query, isPinned] : oldIndexAndCache->cache_.getCachedQueries(
+           RuntimeParameters().get<"swap-index-num-warmup-queries">())) {
+    queriesByIsPinned[isPinned].push_back(std::move(query));
+  }
+  for (bool isPinned : {true, false}) {
+    cacheWarmup::computeQueries(index, cache, allocator_,
+                                sortPerformanceEstimator_, enablePatternTrick_,
+                                queriesByIsPinned[isPinned], isPinned,
+                                numThreads);
+  }
+
+  *indexAndCache_.wlock() = std::move(newIndexAndCache);
+  materializedViews_.readFromFile(viewsFile);
+  LOG(INFO) << "The index \"" << indexBaseName << "\" is used for all new "
+            << "queries, its cache was warmed up with "
+            << queriesByIsPinned[0].size() + queriesByIsPinned[1].size()
+            << " queries of the previous cache, loading took "
+            << ad_utility::Timer::toSeconds(timer.value()) << " s" << std::endl;
+}
+
+// _____________________________________________________________________________
+size_t Server::computeMaterializedViews(
+    const Index& index, QueryResultCache& cache,
+    const MaterializedViews::Definitions& definitions) const {
+  if (definitions.empty()) {
+    return 0;
+  }
+  ad_utility::Timer timer{ad_utility::Timer::Started};
+  std::vector<std::string> queries;
+  for (const auto& [name, query] : definitions) {
+    queries.push_back(query);
+  }
+  size_t numSuccessful = cacheWarmup::computeQueries(
+      index, cache, allocator_, sortPerformanceEstimator_, enablePatternTrick_,
+      queries, true, RuntimeParameters().get<"warmup-num-threads">());
+  LOG(INFO) << numSuccessful << " of " << definitions.size()
+            << " materialized views were computed in "
+            << ad_utility::Timer::toSeconds(timer.value()) << " s"
+            << std::endl;
+  return numSuccessful;
+}
+
 // _____________________________________________________________________________
 void Server::run(const string& indexBaseName, bool useText, bool usePatterns,
                  bool loadAllPermutations) {
@@ -155,10 +362,30 @@ void Server::run(const string& indexBaseName, bool useText, bool usePatterns,
   // Initialize the index
   initialize(indexBaseName, useText, usePatterns, loadAllPermutations);
 
+  *shutDownHttpServer_.wlock() = [&httpServer]() {
+    if (!httpServer.serverIsReady()) {
+      return false;
+    }
+    httpServer.shutDown();
+    return true;
+  };
+  absl::Cleanup resetShutDown{
+      [this]() { *shutDownHttpServer_.wlock() = nullptr; }};
+
   // Start listening for connections on the server.
   httpServer.run();
 }
 
+// _____________________________________________________________________________
+bool Server::shutDown() {
+  auto shutDownHttpServer = shutDownHttpServer_.wlock();
+  if (!*shutDownHttpServer || !(*shutDownHttpServer)()) {
+    return false;
+  }
+  *shutDownHttpServer = nullptr;
+  return true;
+}
+
 // _____________________________________________________________________________
 ad_utility::UrlParser::UrlPathAndParameters Server::getUrlPathAndParameters(
     const ad_utility::httpUtils::HttpRequest auto& request) {
@@ -170,7 +397,8 @@ ad_utility::UrlParser::UrlPathAndParameters Server::getUrlPathAndParameters(
   }
   if (request.method() == http::verb::post) {
     // For a POST request, the content type *must* be either
-    // "application/x-www-form-urlencoded" or "application/sparql-query". In
+    // "application/x-www-form-urlencoded" or "application/sparql-query" (or
+    // "application/sparql-update", which is handled like the latter). In
     // the first case, the body of the POST request contains a URL-encoded
     // query (just like in the part of a GET request after the "?"). In the
     // second case, the body of the POST request contains *only* the SPARQL
@@ -183,6 +411,8 @@ ad_utility::UrlParser::UrlPathAndParameters Server::getUrlPathAndParameters(
         "application/x-www-form-urlencoded";
     static constexpr std::string_view contentTypeSparqlQuery =
         "application/sparql-query";
+    static constexpr std::string_view contentTypeSparqlUpdate =
+        "application/sparql-update";
 
     // In either of the two cases explained above, we convert the data to a
     // format as if it came from a GET request. The second argument to
@@ -202,10 +432,15 @@ ad_utility::UrlParser::UrlPathAndParameters Server::getUrlPathAndParameters(
           absl::StrCat(toStd(request.target()), "?query=", request.body()),
           false);
     }
-    throw std::runtime_error(
-        absl::StrCat("POST request with content type \"", contentType,
-                     "\" not supported (must be \"", contentTypeUrlEncoded,
-                     "\" or \"", contentTypeSparqlQuery, "\")"));
+    if (contentType.starts_with(contentTypeSparqlUpdate)) {
+      return ad_utility::UrlParser::parseGetRequestTarget(
+          absl::StrCat(toStd(request.target()), "?update=", request.body()),
+          false);
+    }
+    throw std::runtime_error(absl::StrCat(
+        "POST request with content type \"", contentType,
+        "\" not supported (must be \"", contentTypeUrlEncoded, "\", \"",
+        contentTypeSparqlQuery, "\" or \"", contentTypeSparqlUpdate, "\")"));
   }
   std::ostringstream requestMethodName;
   requestMethodName << request.method();
@@ -260,6 +495,13 @@ Awaitable<void> Server::process(
 
   // Start timing.
   ad_utility::Timer requestTimer{ad_utility::Timer::Started};
+  QLEVER_PROBE(request_start, static_cast<int>(request.method()),
+               request.target().data(), request.target().size());
+  absl::Cleanup probeRequestEnd{[&]() {
+    QLEVER_PROBE(request_end, static_cast<int>(request.method()),
+                 request.target().data(), request.target().size(),
+                 requestTimer.msecs().count());
+  }};
 
   // Parse the path and the URL parameters from the given request. Works for GET
   // requests as well as the two kinds of POST requests allowed by the SPARQL
@@ -302,12 +544,16 @@ Awaitable<void> Server::process(
     response = createJsonResponse(composeCacheStatsJson(), request);
   } else if (auto cmd = checkParameter("cmd", "clear-cache")) {
     logCommand(cmd, "clear the cache (unpinned elements only)");
-    cache_.clearUnpinnedOnly();
+    getIndexAndCache()->cache_.clearUnpinnedOnly();
+    getDecompressedBlockCache().clear();
+    getVocabularyWordCache().clear();
     response = createJsonResponse(composeCacheStatsJson(), request);
   } else if (auto cmd =
                  checkParameter("cmd", "clear-cache-complete", accessTokenOk)) {
     logCommand(cmd, "clear cache completely (including unpinned elements)");
-    cache_.clearAll();
+    getIndexAndCache()->cache_.clearAll();
+    getDecompressedBlockCache().clear();
+    getVocabularyWordCache().clear();
     response = createJsonResponse(composeCacheStatsJson(), request);
   } else if (auto cmd = checkParameter("cmd", "get-settings")) {
     logCommand(cmd, "get server settings");
@@ -315,7 +561,84 @@ Awaitable<void> Server::process(
   } else if (auto cmd =
                  checkParameter("cmd", "dump-active-queries", accessTokenOk)) {
     logCommand(cmd, "dump active queries");
-    response = createJsonResponse(queryRegistry_.getActiveQueries(), request);
+    response = createJsonResponse(composeActiveQueriesJson(), request);
+  } else if (auto cmd = checkParameter("cmd", "materialized-views")) {
+    logCommand(cmd, "get the definitions of the materialized views");
+    response = createJsonResponse(materializedViews_.toJson(), request);
+  } else if (auto cmd =
+                 checkParameter("cmd", "materialize-views", accessTokenOk)) {
+    // The results of the views are dropped by `clear-cache-complete` and by
+    // updates, this command computes them again.
+    logCommand(cmd, "compute the results of all materialized views");
+    auto indexAndCache = getIndexAndCache();
+    co_await computeInNewThread([this, &indexAndCache]() {
+      computeMaterializedViews(indexAndCache->index_, indexAndCache->cache_,
+                               materializedViews_.definitions());
+    });
+    response = createJsonResponse(materializedViews_.toJson(), request);
+  }
+
+  // Define the materialized view with the given name and the query from the
+  // parameter `view-query` (or replace the query of an existing view), and pin
+  // its result in the cache (see `MaterializedViews`). The view is only
+  // defined if its result could be computed.
+  if (auto name =
+          checkParameter("materialize-view", std::nullopt, accessTokenOk)) {
+    auto query = checkParameter("view-query", std::nullopt);
+    if (name.value().empty() || !query.has_value()) {
+      throw std::runtime_error(
+          "The parameter \"materialize-view\" requires a non-empty name and "
+          "the parameter \"view-query\"");
+    }
+    LOG(INFO) << "Materializing the view \"" << name.value() << "\""
+              << std::endl;
+    MaterializedViews::Definitions definition{
+        {std::string{name.value()}, std::string{query.value()}}};
+    auto indexAndCache = getIndexAndCache();
+    size_t numSuccessful = co_await computeInNewThread(
+        [this, &indexAndCache, &definition]() {
+          return computeMaterializedViews(indexAndCache->index_,
+                                          indexAndCache->cache_, definition);
+        });
+    if (numSuccessful == 0) {
+      throw std::runtime_error(
+          absl::StrCat("The query of the materialized view \"", name.value(),
+                       "\" could not be computed, see the log for details"));
+    }
+    materializedViews_.add(std::string{name.value()},
+                           std::string{query.value()});
+    response = createJsonResponse(materializedViews_.toJson(), request);
+  }
+
+  // Remove the definition of the materialized view with the given name. Its
+  // pinned result stays in the cache until `clear-cache-complete`.
+  if (auto name = checkParameter("drop-view", std::nullopt, accessTokenOk)) {
+    LOG(INFO) << "Dropping the materialized view \"" << name.value() << "\""
+              << std::endl;
+    if (!materializedViews_.remove(std::string{name.value()})) {
+      throw std::runtime_error(absl::StrCat(
+          "There is no materialized view \"", name.value(), "\""));
+    }
+    response = createJsonResponse(materializedViews_.toJson(), request);
+  }
+
+  // Fetch a page of a result cursor (see `ResultCursors`), or close it. The
+  // handle itself serves as the authorization, it can't be guessed.
+  if (auto handle = checkParameter("cursor", std::nullopt);
+      handle.has_value() && handle.value() != "open") {
+    auto pageJson = co_await computeInNewThread(
+        [this, handle = std::string{handle.value()}, &parameters] {
+          return composeCursorPageJson(handle, parameters);
+        });
+    co_return co_await send(createCompressibleJsonResponse(pageJson, request));
+  }
+  if (auto handle = checkParameter("close-cursor", std::nullopt)) {
+    LOG(INFO) << "Closing the result cursor \"" << handle.value() << "\""
+              << std::endl;
+    bool wasOpen = resultCursors_.close(std::string{handle.value()});
+    response = createJsonResponse(json{{"cursor", handle.value()},
+                                       {"closed", wasOpen}},
+                                  request);
   }
 
   // Ping with or without messsage.
@@ -330,12 +653,18 @@ Awaitable<void> Server::process(
                                 request, ad_utility::MediaType::textPlain);
   }
 
+  // The metrics in the Prometheus text format.
+  if (urlPathAndParameters._path == "/metrics") {
+    response = createOkResponse(composeMetrics(), request,
+                                ad_utility::MediaType::textPlain);
+  }
+
   // Set description of KB index.
   if (auto description =
           checkParameter("index-description", std::nullopt, accessTokenOk)) {
     LOG(INFO) << "Setting index description to: \"" << description.value()
               << "\"" << std::endl;
-    index_.setKbName(std::string{description.value()});
+    getIndexAndCache()->index_.setKbName(std::string{description.value()});
     response = createJsonResponse(composeStatsJson(), request);
   }
 
@@ -344,10 +673,41 @@ Awaitable<void> Server::process(
           checkParameter("text-description", std::nullopt, accessTokenOk)) {
     LOG(INFO) << "Setting text description to: \"" << description.value()
               << "\"" << std::endl;
-    index_.setTextName(std::string{description.value()});
+    getIndexAndCache()->index_.setTextName(std::string{description.value()});
+    response = createJsonResponse(composeStatsJson(), request);
+  }
+
+  // Replace the index by the index with the given base name (see
+  // `swapIndex`). The response is sent when the new index is used.
+  if (auto indexBaseName =
+          checkParameter("swap-index", std::nullopt, accessTokenOk)) {
+    LOG(INFO) << "Processing request to swap the index" << std::endl;
+    co_await computeInNewThread([this, name = std::string{*indexBaseName}]() {
+      swapIndex(name);
+    });
     response = createJsonResponse(composeStatsJson(), request);
   }
 
+  // Insert or delete triples via a SPARQL UPDATE request (see
+  // `DeltaTriples::applyUpdate`). The cached results are invalidated.
+  if (auto update = checkParameter("update", std::nullopt, accessTokenOk)) {
+    LOG(INFO) << "Processing update request" << std::endl;
+    auto indexAndCache = getIndexAndCache();
+    auto& deltaTriples = indexAndCache->index_.deltaTriples();
+    size_t numTriples = deltaTriples.applyUpdate(update.value());
+    indexAndCache->cache_.clearAll();
+    auto counts = deltaTriples.getCounts();
+    LOG(INFO) << "Number of triples in the update request: " << numTriples
+              << ", inserted triples now: " << counts.numInserted_
+              << ", deleted triples now: " << counts.numDeleted_ << std::endl;
+    response = createJsonResponse(
+        json{{"status", "OK"},
+             {"num-triples-of-update", numTriples},
+             {"num-inserted-triples", counts.numInserted_},
+             {"num-deleted-triples", counts.numDeleted_}},
+        request);
+  }
+
   // Set one or several of the runtime parameters.
   for (auto key : RuntimeParameters().getKeys()) {
     if (auto value = checkParameter(key, std::nullopt, accessTokenOk)) {
@@ -365,12 +725,25 @@ Awaitable<void> Server::process(
           "Parameter \"query\" must not have an empty value");
     }
 
+    // The hints for the execution of the query (see `QueryHints`). An
+    // explicit memory budget may be larger than the one that is derived from
+    // the estimates of the query planner, so this requires a valid access
+    // token.
+    auto queryHints = QueryHints::fromParameters(parameters);
+    if (queryHints.memoryLimit_.has_value() && !accessTokenOk) {
+      co_return co_await send(createForbiddenResponse(
+          "The parameter \"memory-limit\" requires a valid access token",
+          request));
+    }
+
     if (auto timeLimit = co_await verifyUserSubmittedQueryTimeout(
             checkParameter("timeout", std::nullopt), accessTokenOk, request,
             send)) {
-      co_return co_await processQuery(parameters, requestTimer,
-                                      std::move(request), send,
-                                      timeLimit.value());
+      auto priority = accessTokenOk ? ad_utility::QueryPriority::High
+                                    : ad_utility::QueryPriority::Normal;
+      co_return co_await processQuery(
+          parameters, requestTimer, std::move(request), send, timeLimit.value(),
+          priority, std::move(queryHints));
 
     } else {
       // If the optional is empty, this indicates an error response has been
@@ -428,44 +801,211 @@ json Server::composeErrorResponseJson(
   return j;
 }
 
+// _____________________________________________________________________________
+json Server::composeExplainJson(const string& query,
+                                const QueryExecutionTree& qet,
+                                ad_utility::Timer& requestTimer) {
+  auto root = qet.getRootOperation();
+  root->createRuntimeInfoFromEstimates(root->getRuntimeInfoPointer());
+  // The runtime information has the column names, but not the order in which
+  // the result is sorted, which determines the join algorithms that can be
+  // used by the parent.
+  auto addSortedOn = [](const QueryExecutionTree& tree) {
+    auto& runtimeInfo = tree.getRootOperation()->runtimeInfo();
+    std::vector<std::string> sortedOn;
+    for (ColumnIndex col : tree.resultSortedOn()) {
+      sortedOn.push_back(col < runtimeInfo.columnNames_.size()
+                             ? runtimeInfo.columnNames_.at(col)
+                             : absl::StrCat("col", col));
+    }
+    runtimeInfo.addDetail("sorted-on", sortedOn);
+  };
+  addSortedOn(qet);
+  qet.forAllDescendants(
+      [&addSortedOn](const QueryExecutionTree* child) { addSortedOn(*child); });
+
+  json j;
+  j["query"] = query;
+  j["status"] = "OK";
+  j["time"]["total"] = std::to_string(requestTimer.msecs().count()) + "ms";
+  j["runtimeInformation"]["query_execution_tree"] =
+      nlohmann::ordered_json(root->runtimeInfo());
+  return j;
+}
+
+// _____________________________________________________________________________
+void Server::makeRoomForAllocation(ad_utility::MemorySize numBytes) {
+  auto needed = MAKE_ROOM_SLACK_FACTOR * numBytes;
+  getIndexAndCache()->cache_.makeRoomAsMuchAsPossible(needed);
+  auto memoryLeft = allocator_.amountMemoryLeft();
+  if (memoryLeft < needed) {
+    size_t numEvicted = resultCursors_.makeRoom(needed - memoryLeft);
+    if (numEvicted > 0) {
+      LOG(INFO) << "Evicted " << numEvicted
+                << " result cursor(s) because the memory is exhausted"
+                << std::endl;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+json Server::composeCursorPageJson(const std::string& handle,
+                                   const ParamValueMap& parameters) {
+  auto cursor = resultCursors_.get(handle);
+  if (cursor == nullptr) {
+    throw std::runtime_error(absl::StrCat(
+        "There is no result cursor \"", handle,
+        "\", it has expired or was evicted because the memory was exhausted"));
+  }
+  LimitOffsetClause page;
+  page._offset = parameters.contains("offset")
+                     ? std::stoul(parameters.at("offset"))
+                     : 0;
+  page._offset = std::min(page._offset, cursor->numRows());
+  uint64_t limit = parameters.contains("limit")
+                       ? std::stoul(parameters.at("limit"))
+                       : cursor->numRows();
+  limit = std::min(limit, cursor->numRows() - page._offset);
+  // The rows of the page relative to the complete result.
+  page._offset += cursor->beginRow_;
+  page._limit = limit;
+  json j;
+  j["cursor"] = handle;
+  j["selected"] = cursor->selectedVariables_;
+  j["resultsize"] = cursor->numRows();
+  j["offset"] = page._offset - cursor->beginRow_;
+  j["res"] = ExportQueryExecutionTrees::idTableToQLeverJSONArray(
+      *cursor->index_, page, cursor->columns_, *cursor->result_);
+  return j;
+}
+
 // _____________________________________________________________________________
 json Server::composeStatsJson() const {
+  auto indexAndCache = getIndexAndCache();
+  const auto& index = indexAndCache->index_;
   json result;
-  result["name-index"] = index_.getKbName();
-  result["num-permutations"] = (index_.hasAllPermutations() ? 6 : 2);
-  result["num-predicates-normal"] = index_.numDistinctPredicates().normal_;
-  result["num-predicates-internal"] = index_.numDistinctPredicates().internal_;
-  if (index_.hasAllPermutations()) {
-    result["num-subjects-normal"] = index_.numDistinctSubjects().normal_;
-    result["num-subjects-internal"] = index_.numDistinctSubjects().internal_;
-    result["num-objects-normal"] = index_.numDistinctObjects().normal_;
-    result["num-objects-internal"] = index_.numDistinctObjects().internal_;
-  }
-
-  auto numTriples = index_.numTriples();
+  result["name-index"] = index.getKbName();
+  result["num-permutations"] = (index.hasAllPermutations() ? 6 : 2);
+  result["num-predicates-normal"] = index.numDistinctPredicates().normal_;
+  result["num-predicates-internal"] = index.numDistinctPredicates().internal_;
+  if (index.hasAllPermutations()) {
+    result["num-subjects-normal"] = index.numDistinctSubjects().normal_;
+    result["num-subjects-internal"] = index.numDistinctSubjects().internal_;
+    result["num-objects-normal"] = index.numDistinctObjects().normal_;
+    result["num-objects-internal"] = index.numDistinctObjects().internal_;
+  }
+
+  auto numTriples = index.numTriples();
   result["num-triples-normal"] = numTriples.normal_;
   result["num-triples-internal"] = numTriples.internal_;
-  result["name-text-index"] = index_.getTextName();
-  result["num-text-records"] = index_.getNofTextRecords();
-  result["num-word-occurrences"] = index_.getNofWordPostings();
-  result["num-entity-occurrences"] = index_.getNofEntityPostings();
+  result["name-text-index"] = index.getTextName();
+  result["num-text-records"] = index.getNofTextRecords();
+  result["num-word-occurrences"] = index.getNofWordPostings();
+  result["num-entity-occurrences"] = index.getNofEntityPostings();
+  const auto& wordCache = getVocabularyWordCache();
+  result["num-vocabulary-cache-entries"] = wordCache.numEntries();
+  result["vocabulary-cache-size"] = wordCache.size().getBytes();
+  result["num-vocabulary-cache-hits"] = wordCache.numHits();
+  result["num-vocabulary-cache-misses"] = wordCache.numMisses();
+  auto admission = admissionController_.statistics();
+  result["num-query-threads"] = threadPool_.numThreads();
+  result["num-running-queries"] = admission.numRunning_;
+  result["num-queued-queries"] = admission.numQueued_;
+  result["reserved-query-memory"] = admission.reservedMemory_.getBytes();
+  result["num-admitted-queries"] = admission.numAdmitted_;
+  result["total-query-queue-time-ms"] = admission.totalWaitTime_.count();
+  result["max-query-queue-time-ms"] = admission.maxWaitTime_.count();
   return result;
 }
 
 // _______________________________________
 nlohmann::json Server::composeCacheStatsJson() const {
+  auto indexAndCache = getIndexAndCache();
+  const auto& cache = indexAndCache->cache_;
   nlohmann::json result;
-  result["num-non-pinned-entries"] = cache_.numNonPinnedEntries();
-  result["num-pinned-entries"] = cache_.numPinnedEntries();
+  result["num-non-pinned-entries"] = cache.numNonPinnedEntries();
+  result["num-pinned-entries"] = cache.numPinnedEntries();
 
   // TODO Get rid of the `getByte()`, once `MemorySize` has it's own json
   // converter.
-  result["non-pinned-size"] = cache_.nonPinnedSize().getBytes();
-  result["pinned-size"] = cache_.pinnedSize().getBytes();
-  result["num-pinned-index-scan-sizes"] = cache_.pinnedSizes().rlock()->size();
+  result["non-pinned-size"] = cache.nonPinnedSize().getBytes();
+  result["pinned-size"] = cache.pinnedSize().getBytes();
+  result["num-pinned-index-scan-sizes"] = cache.pinnedSizes().rlock()->size();
+  const auto& blockCache = getDecompressedBlockCache();
+  result["num-decompressed-block-cache-entries"] = blockCache.numEntries();
+  result["decompressed-block-cache-size"] = blockCache.size().getBytes();
+  result["num-decompressed-block-cache-hits"] = blockCache.numHits();
+  result["num-decompressed-block-cache-misses"] = blockCache.numMisses();
+  if (const auto* persistentCache = cache.persistentCache()) {
+    result["num-persistent-cache-entries"] = persistentCache->numEntries();
+    result["persistent-cache-size"] = persistentCache->size().getBytes();
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+nlohmann::json Server::composeActiveQueriesJson() const {
+  auto budgets = queryMemoryBudgets_.rlock();
+  nlohmann::json result = nlohmann::json::array();
+  for (const auto& queryId : queryRegistry_.getActiveQueries()) {
+    nlohmann::json query;
+    query["query-id"] = queryId;
+    // The budget of a query is registered shortly after its id (see
+    // `processQuery`).
+    if (auto it = budgets->find(queryId); it != budgets->end()) {
+      auto memory = it->second.ptr()->wlock();
+      query["memory-used-bytes"] = memory->amountMemoryUsed().getBytes();
+      query["memory-peak-bytes"] = memory->peakMemoryUsed().getBytes();
+      query["memory-left-bytes"] = memory->amountMemoryLeft().getBytes();
+    }
+    result.push_back(std::move(query));
+  }
   return result;
 }
 
+// _____________________________________________________________________________
+std::string Server::composeMetrics() const {
+  using ad_utility::metrics::Sample;
+  using enum Sample::Type;
+  std::vector<Sample> samples;
+  auto addCacheCounters = [&samples](std::string_view cacheName,
+                                     const auto& cache) {
+    ad_utility::metrics::Labels labels{{"cache", std::string{cacheName}}};
+    samples.push_back({"qlever_cache_hits_total", "The number of cache hits",
+                       Counter, labels, static_cast<double>(cache.numHits())});
+    samples.push_back({"qlever_cache_misses_total",
+                       "The number of cache misses", Counter, labels,
+                       static_cast<double>(cache.numMisses())});
+    samples.push_back({"qlever_cache_evictions_total",
+                       "The number of entries that were evicted from a cache",
+                       Counter, labels,
+                       static_cast<double>(cache.numEvictions())});
+  };
+  addCacheCounters("query-result", getIndexAndCache()->cache_);
+  addCacheCounters("decompressed-block", getDecompressedBlockCache());
+  addCacheCounters("vocabulary-word", getVocabularyWordCache());
+
+  samples.push_back(
+      {"qlever_allocator_memory_left_bytes",
+       "The memory that is left for the computation of query results", Gauge,
+       {}, static_cast<double>(allocator_.amountMemoryLeft().getBytes())});
+  samples.push_back({"qlever_thread_pool_queued_tasks",
+                     "The number of tasks that wait for a thread of the pool",
+                     Gauge,
+                     {},
+                     static_cast<double>(numQueuedTasks_.load())});
+  auto admission = admissionController_.statistics();
+  samples.push_back(
+      {"qlever_running_queries", "The number of queries that are computed",
+       Gauge, {}, static_cast<double>(admission.numRunning_)});
+  samples.push_back({"qlever_queued_queries",
+                     "The number of queries that wait for their admission",
+                     Gauge,
+                     {},
+                     static_cast<double>(admission.numQueued_)});
+  return ad_utility::metrics::registry().toPrometheusText(samples);
+}
+
 // _____________________________________________
 
 /// Special type of std::runtime_error used to indicate that there has been
@@ -542,7 +1082,8 @@ auto Server::setupCancellationHandle(
 boost::asio::awaitable<void> Server::processQuery(
     const ParamValueMap& params, ad_utility::Timer& requestTimer,
     const ad_utility::httpUtils::HttpRequest auto& request, auto&& send,
-    TimeLimit timeLimit) {
+    TimeLimit timeLimit, ad_utility::QueryPriority priority,
+    QueryHints queryHints) {
   using namespace ad_utility::httpUtils;
   AD_CONTRACT_CHECK(params.contains("query"));
   const auto& query = params.at("query");
@@ -558,15 +1099,74 @@ boost::asio::awaitable<void> Server::processQuery(
 
   http::status responseStatus = http::status::ok;
 
+  // The total time of the processing of the query by its `outcome`.
+  auto observeQueryDuration = [&requestTimer](std::string_view outcome) {
+    static const std::vector<double> upperBounds{
+        0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 30, 60, 300};
+    auto& histogram = ad_utility::metrics::registry().histogram(
+        "qlever_query_duration_seconds",
+        "The total time of the processing of the queries", upperBounds,
+        {{"outcome", std::string{outcome}}});
+    histogram.observe(
+        std::chrono::duration<double>(requestTimer.value()).count());
+  };
+
   // Put the whole query processing in a try-catch block. If any exception
   // occurs, log the error message and send a JSON response with all the details
   // to the client. Note that the C++ standard forbids co_await in the catch
   // block, hence the workaround with the optional `exceptionErrorMsg`.
   std::optional<std::string> exceptionErrorMsg;
   std::optional<ExceptionMetadata> metadata;
+  // The query is processed completely on the index on which it was started,
+  // even if the index is replaced in the meantime (see `swapIndex`).
+  auto indexAndCache = getIndexAndCache();
   // Also store the QueryExecutionTree outside the try-catch block to gain
   // access to the runtimeInformation in the case of an error.
   std::optional<PlannedQuery> plannedQuery;
+  // If this query is processed on behalf of identical queries that arrive in
+  // the meantime (see `identicalQueries_`), its key. Its response has to be
+  // published on all paths (if the processing is aborted, it is `nullptr`).
+  std::optional<std::string> identicalQueriesKey;
+  auto publishResponse = [this, &identicalQueriesKey](
+                             std::shared_ptr<const SharedResponse> response) {
+    if (identicalQueriesKey.has_value()) {
+      identicalQueries_.publish(
+          std::exchange(identicalQueriesKey, std::nullopt).value(),
+          std::move(response));
+    }
+  };
+  absl::Cleanup publishIfAborted{[&publishResponse]() {
+    publishResponse(nullptr);
+  }};
+  // Write the query to the `SlowQueryLog` if it was slow (or is sampled),
+  // together with its plan, its runtime information, and the `details`.
+  auto writeToSlowQueryLog =
+      [this, &query, &plannedQuery, &requestTimer](
+          std::string_view outcome, json details) -> Awaitable<void> {
+    auto settings = SlowQueryLog::Settings::fromRuntimeParameters();
+    auto totalTime = requestTimer.msecs();
+    auto reason = SlowQueryLog::shouldLog(settings, totalTime);
+    if (!reason.has_value()) {
+      co_return;
+    }
+    json entry{{"time", absl::FormatTime(absl::RFC3339_full, absl::Now(),
+                                         absl::UTCTimeZone())},
+               {"reason", SlowQueryLog::toString(reason.value())},
+               {"outcome", outcome},
+               {"query", query},
+               {"total-time-ms", totalTime.count()}};
+    if (plannedQuery.has_value()) {
+      auto& qet = plannedQuery.value().queryExecutionTree_;
+      auto& root = *qet.getRootOperation();
+      entry["plan"] = qet.getCacheKey();
+      entry["runtime-information"] = nlohmann::ordered_json(root.runtimeInfo());
+      entry["runtime-information-whole-query"] =
+          nlohmann::ordered_json(root.getRuntimeInfoWholeQuery());
+    }
+    entry.update(details);
+    co_await computeInNewThread(
+        [&settings, &entry]() { getSlowQueryLog().write(settings, entry); });
+  };
   try {
     auto containsParam = [&params](const std::string& param,
                                    const std::string& expected) {
@@ -576,6 +1176,23 @@ boost::asio::awaitable<void> Server::processQuery(
                                              : MAX_NOF_ROWS_IN_RESULT;
     const bool pinSubtrees = containsParam("pinsubtrees", "true");
     const bool pinResult = containsParam("pinresult", "true");
+    // With `trace=chrome` or `trace=otel`, the processing of the query is
+    // traced (see `ad_utility::QueryTrace`), and the trace is added to the
+    // QLever JSON response in the Chrome trace event format or as
+    // OpenTelemetry spans, respectively.
+    std::shared_ptr<ad_utility::QueryTrace> trace;
+    std::optional<std::string> traceFormat;
+    if (params.contains("trace")) {
+      traceFormat = params.at("trace");
+      if (traceFormat != "chrome" && traceFormat != "otel") {
+        co_return co_await send(createBadRequestResponse(
+            absl::StrCat("The value of the parameter \"trace\" must be "
+                         "\"chrome\" or \"otel\", but was \"",
+                         traceFormat.value(), "\""),
+            request));
+      }
+      trace = std::make_shared<ad_utility::QueryTrace>();
+    }
     LOG(INFO) << "Processing the following SPARQL query:"
               << (pinResult ? " [pin result]" : "")
               << (pinSubtrees ? " [pin subresults]" : "") << "\n"
@@ -588,6 +1205,13 @@ boost::asio::awaitable<void> Server::processQuery(
     using ad_utility::MediaType;
 
     std::optional<MediaType> mediaType = std::nullopt;
+    // With `action=explain`, the query is only planned, and the plan with its
+    // estimates is returned as QLever JSON (see `composeExplainJson`).
+    const bool isExplain = containsParam("action", "explain");
+    // With `cursor=open`, the result is kept by the server and only its handle
+    // is sent, the pages of the result are then fetched via `cursor=<handle>`
+    // (see `ResultCursors`).
+    const bool isCursor = containsParam("cursor", "open");
 
     // The explicit `action=..._export` parameter have precedence over the
     // `Accept:...` header field
@@ -603,6 +1227,10 @@ boost::asio::awaitable<void> Server::processQuery(
       mediaType = MediaType::turtle;
     } else if (containsParam("action", "binary_export")) {
       mediaType = MediaType::octetStream;
+    } else if (containsParam("action", "arrow_export")) {
+      mediaType = MediaType::arrow;
+    } else if (isExplain) {
+      mediaType = MediaType::qleverJson;
     }
 
     std::string_view acceptHeader = request.base()[http::field::accept];
@@ -623,6 +1251,38 @@ boost::asio::awaitable<void> Server::processQuery(
     LOG(INFO) << "Requested media type of result is \""
               << ad_utility::toString(mediaType.value()) << "\"" << std::endl;
 
+    // Identical queries that are processed at the same time are only computed
+    // and serialized once. This is currently restricted to QLever JSON, for
+    // which the complete response is serialized before it is sent.
+    if (mediaType.value() == MediaType::qleverJson && !isExplain &&
+        !isCursor &&
+        RuntimeParameters().get<"share-responses-of-identical-queries">()) {
+      std::vector<std::pair<std::string, std::string>> sortedParams{
+          params.begin(), params.end()};
+      std::ranges::sort(sortedParams);
+      std::string key;
+      for (const auto& [name, value] : sortedParams) {
+        absl::StrAppend(&key, name.size(), ":", name, value.size(), ":", value);
+      }
+      auto sharedResponse = co_await waitForIdenticalQuery(key);
+      if (!sharedResponse.has_value()) {
+        identicalQueriesKey = std::move(key);
+      } else if (auto response = std::move(sharedResponse.value())) {
+        LOG(INFO) << "Sending the response of an identical query that was "
+                  << "processed at the same time" << std::endl;
+        if (response->status_ == http::status::ok) {
+          co_return co_await send(
+              createCompressibleJsonResponse(response->body_, request));
+        }
+        co_return co_await send(
+            createJsonResponse(response->body_, request, response->status_));
+      } else {
+        throw std::runtime_error(
+            "The processing of an identical query that was sent at the same "
+            "time was aborted");
+      }
+    }
+
     auto queryHub = queryHub_.lock();
     AD_CORRECTNESS_CHECK(queryHub);
     auto messageSender = co_await ad_utility::websocket::MessageSender::create(
@@ -634,13 +1294,65 @@ boost::asio::awaitable<void> Server::processQuery(
     // might happen that the query planner runs for a while (recall that it many
     // do index scans) and then we get an error message afterwards that a
     // certain media type is not supported.
-    QueryExecutionContext qec(index_, &cache_, allocator_,
-                              sortPerformanceEstimator_,
+    //
+    // Each query has its own memory budget, which is charged to the memory
+    // of the server, s.t. a query that exceeds its budget fails alone. Unless
+    // the `memoryLimit_` of the `queryHints` is set, the budget is derived
+    // from the estimate of the query planner (see below).
+    bool hasMemoryLimit = queryHints.memoryLimit_.has_value();
+    auto memoryBudget =
+        ad_utility::makeChildAllocationMemoryLeftThreadsafeObject(
+            allocator_.getMemoryLeft(),
+            queryHints.memoryLimit_.value_or(ad_utility::MemorySize::max()));
+    queryMemoryBudgets_.wlock()->insert_or_assign(messageSender.getQueryId(),
+                                                  memoryBudget);
+    absl::Cleanup removeMemoryBudget{[this, &messageSender]() {
+      queryMemoryBudgets_.wlock()->erase(messageSender.getQueryId());
+    }};
+    ad_utility::AllocatorWithLimit<Id> allocator{
+        memoryBudget,
+        [this, budget = memoryBudget.ptr()](
+            ad_utility::MemorySize numMemoryToAllocate) {
+          // Clearing the cache doesn't help if the query exceeds its budget.
+          if (budget->wlock()->fitsIntoOwnLimit(numMemoryToAllocate)) {
+            makeRoomForAllocation(numMemoryToAllocate);
+          }
+        }};
+    QueryExecutionContext qec(indexAndCache->index_, &indexAndCache->cache_,
+                              std::move(allocator), sortPerformanceEstimator_,
                               std::ref(messageSender), pinSubtrees, pinResult);
+    qec.setTrace(trace);
+    qec.setQueryHints(std::move(queryHints));
 
+    auto beginOfPlanning = ad_utility::QueryTrace::Clock::now();
     plannedQuery = co_await parseAndPlan(query, qec);
+    if (trace != nullptr) {
+      trace->addSpan("query planning", "planning", beginOfPlanning, 0);
+    }
     auto& qet = plannedQuery.value().queryExecutionTree_;
     qet.isRoot() = true;  // allow pinning of the final result
+    if (isExplain) {
+      auto explainJson = composeExplainJson(query, qet, requestTimer);
+      LOG(INFO) << "Sending the query plan without computing the result, "
+                << "total time was " << requestTimer.msecs().count() << " ms"
+                << std::endl;
+      co_return co_await send(
+          createCompressibleJsonResponse(explainJson, request));
+    }
+    if (!hasMemoryLimit) {
+      memoryBudget.ptr()->wlock()->setLimit(
+          queryMemoryBudget(estimateResultMemory(qet)));
+    }
+    // Reject a query that cannot finish before its timeout before any work is
+    // done and before it waits for its admission (see
+    // `QueryRuntimeEstimator`).
+    getQueryRuntimeEstimator().throwIfEstimateExceedsRemainingTime(
+        qet.getCostEstimate(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(timeLimit),
+        "The query");
+    // Wait for the admission before the time limit starts, s.t. the time in
+    // the queue is not counted.
+    auto admissionTicket = co_await waitForAdmission(qet, priority);
     absl::Cleanup cancelCancellationHandle{setupCancellationHandle(
         co_await net::this_coro::executor, messageSender.getQueryId(),
         qet.getRootOperation(), timeLimit)};
@@ -652,12 +1364,65 @@ boost::asio::awaitable<void> Server::processQuery(
               << " ms" << std::endl;
     LOG(TRACE) << qet.getCacheKey() << std::endl;
 
+    if (isCursor) {
+      const auto& parsedQuery = plannedQuery.value().parsedQuery_;
+      if (!parsedQuery.hasSelectClause()) {
+        throw std::runtime_error(
+            "A result cursor can only be opened for a SELECT query");
+      }
+      auto cursorJson = co_await computeInNewThread([&] {
+        ad_utility::QueryTrace::Scope traceScope{trace.get()};
+        queryRegistry_.getCancellationHandle(messageSender.getQueryId())
+            ->resetWatchDogState();
+        ResultCursors::Cursor cursor;
+        // The aliasing constructor keeps the complete `IndexAndCache` alive.
+        cursor.index_ = std::shared_ptr<const Index>{indexAndCache,
+                                                     &indexAndCache->index_};
+        cursor.result_ = qet.getResult();
+        cursor.columns_ =
+            qet.selectedVariablesToColumnIndices(parsedQuery.selectClause());
+        cursor.selectedVariables_ =
+            parsedQuery.selectClause().getSelectedVariablesAsStrings();
+        size_t size = cursor.result_->idTable().numRows();
+        cursor.beginRow_ = parsedQuery._limitOffset.actualOffset(size);
+        cursor.endRow_ = parsedQuery._limitOffset.upperBound(size);
+        size_t numRows = cursor.numRows();
+        auto ttl = std::chrono::seconds{
+            RuntimeParameters().get<"result-cursor-ttl">()};
+        auto handle = resultCursors_.open(std::move(cursor), ttl);
+        return json{{"query", query},
+                    {"cursor", handle},
+                    {"selected", parsedQuery.selectClause()
+                                     .getSelectedVariablesAsStrings()},
+                    {"resultsize", numRows},
+                    {"ttl-seconds", ttl.count()},
+                    {"time",
+                     {{"total", absl::StrCat(requestTimer.msecs().count(),
+                                             "ms")}}}};
+      });
+      LOG(INFO) << "Opened a result cursor with "
+                << cursorJson["resultsize"].get<size_t>()
+                << " rows, total time was " << requestTimer.msecs().count()
+                << " ms" << std::endl;
+      observeQueryDuration("success");
+      indexAndCache->cache_.registerQuery(qet.getCacheKey(), query);
+      co_return co_await send(createJsonResponse(cursorJson, request));
+    }
+
     // Common code for sending responses for the streamable media types
-    // (tsv, csv, octet-stream, turtle).
+    // (tsv, csv, octet-stream, turtle, sparql-xml, sparql-json, arrow, and
+    // the exchange format of QLever).
     auto sendStreamableResponse = [&](MediaType mediaType) -> Awaitable<void> {
       auto responseGenerator = co_await computeInNewThread([&] {
+        ad_utility::QueryTrace::Scope traceScope{trace.get()};
         queryRegistry_.getCancellationHandle(messageSender.getQueryId())
             ->resetWatchDogState();
+        if (mediaType == MediaType::qleverIdTable) {
+          return ExportQueryExecutionTrees::computeResultAsIdTableExchange(
+              plannedQuery.value().parsedQuery_, qet,
+              idTableExchange::getVocabularyIdentityFromAcceptHeader(
+                  acceptHeader));
+        }
         return ExportQueryExecutionTrees::computeResultAsStream(
             plannedQuery.value().parsedQuery_, qet, mediaType);
       });
@@ -690,18 +1455,37 @@ boost::asio::awaitable<void> Server::processQuery(
       case tsv:
       case octetStream:
       case sparqlXml:
-      case turtle: {
+      case sparqlJson:
+      case turtle:
+      case arrow:
+      case qleverIdTable: {
         co_await sendStreamableResponse(mediaType.value());
       } break;
-      case qleverJson:
-      case sparqlJson: {
+      case qleverJson: {
         // Normal case: JSON response
+        // Argument `4` leads to a human-readable indentation.
         auto responseString = co_await computeInNewThread([&, maxSend] {
-          return ExportQueryExecutionTrees::computeResultAsJSON(
-              plannedQuery.value().parsedQuery_, qet, requestTimer, maxSend,
-              mediaType.value());
+          ad_utility::QueryTrace::Scope traceScope{trace.get()};
+          auto responseJson = [&]() {
+            ad_utility::QueryTrace::ScopedSpan traceSpan{"export result",
+                                                         "export"};
+            return ExportQueryExecutionTrees::computeResultAsJSON(
+                plannedQuery.value().parsedQuery_, qet, requestTimer, maxSend,
+                mediaType.value());
+          }();
+          if (trace != nullptr) {
+            responseJson["trace"] = traceFormat == "otel"
+                                        ? trace->toOpenTelemetry()
+                                        : trace->toChromeTrace();
+          }
+          return responseJson.dump(4);
         });
-        co_await sendJson(std::move(responseString), responseStatus);
+        auto response = std::make_shared<const SharedResponse>(
+            std::move(responseString), http::status::ok);
+        publishResponse(response);
+        // Unlike the error messages, the result is compressed if the client
+        // allows it.
+        co_await send(createCompressibleJsonResponse(response->body_, request));
       } break;
       default:
         // This should never happen, because we have carefully restricted the
@@ -724,6 +1508,24 @@ boost::asio::awaitable<void> Server::processQuery(
               << std::endl;
     LOG(DEBUG) << "Runtime Info:\n"
                << qet.getRootOperation()->runtimeInfo().toString() << std::endl;
+    observeQueryDuration("success");
+    // Calibrate the runtime estimates for later queries with the time of the
+    // computation and export of the result, unless it was read from the cache.
+    if (qet.getRootOperation()->runtimeInfo().cacheStatus_ ==
+        ad_utility::CacheStatus::computed) {
+      getQueryRuntimeEstimator().record(
+          qet.getCostEstimate(), requestTimer.msecs() - timeForQueryPlanning);
+    }
+    indexAndCache->cache_.registerQuery(qet.getCacheKey(), query);
+    json memoryDetails{
+        {"temporary-memory-peak-bytes",
+         qec.getTemporaryAllocator().arena()->peakMemory().getBytes()},
+        {"memory-left-bytes", allocator_.amountMemoryLeft().getBytes()}};
+    co_await writeToSlowQueryLog("success", std::move(memoryDetails));
+    if (trace != nullptr &&
+        !RuntimeParameters().get<"trace-collector-url">().empty()) {
+      co_await computeInNewThread([&trace]() { sendTraceToCollector(*trace); });
+    }
   } catch (const ParseException& e) {
     responseStatus = http::status::bad_request;
     exceptionErrorMsg = e.errorMessageWithoutPositionalInfo();
@@ -738,6 +1540,11 @@ boost::asio::awaitable<void> Server::processQuery(
   // TODO<qup42> at this stage should probably have a wrapper that takes
   //  optional<errorMsg> and optional<metadata> and does this logic
   if (exceptionErrorMsg) {
+    std::string_view outcome =
+        responseStatus == http::status::bad_request ? "invalid" : "error";
+    observeQueryDuration(outcome);
+    json errorDetails{{"error", exceptionErrorMsg.value()}};
+    co_await writeToSlowQueryLog(outcome, std::move(errorDetails));
     LOG(ERROR) << exceptionErrorMsg.value() << std::endl;
     if (metadata) {
       // The `coloredError()` message might fail because of the different
@@ -762,6 +1569,8 @@ boost::asio::awaitable<void> Server::processQuery(
                                      .queryExecutionTree_.getRootOperation()
                                      ->runtimeInfo());
     }
+    publishResponse(std::make_shared<const SharedResponse>(
+        errorResponseJson.dump(4), responseStatus));
     co_return co_await sendJson(errorResponseJson, responseStatus);
   }
 }
@@ -769,20 +1578,148 @@ boost::asio::awaitable<void> Server::processQuery(
 // _____________________________________________________________________________
 template <typename Function, typename T>
 Awaitable<T> Server::computeInNewThread(Function function) const {
-  auto runOnExecutor = [](auto executor, Function func) -> net::awaitable<T> {
+  auto runOnExecutor = [](auto executor, const Server& server, Function func,
+                          std::atomic<size_t>& numQueued) -> net::awaitable<T> {
+    ++numQueued;
     co_await net::post(net::bind_executor(executor, net::use_awaitable));
+    --numQueued;
+    server.pinThreadToNumaNode();
     co_return std::invoke(func);
   };
   return ad_utility::resumeOnOriginalExecutor(
-      runOnExecutor(threadPool_.get_executor(), std::move(function)));
+      runOnExecutor(threadPool_.getExecutor(), *this, std::move(function),
+                    numQueuedTasks_));
+}
+
+// _____________________________________________________________________________
+void Server::pinThreadToNumaNode() const {
+  // Each thread of the `threadPool_` is pinned only once (when it computes its
+  // first task), and the queries that it computes allocate their memory on its
+  // node.
+  thread_local bool isPinned = false;
+  if (isPinned || numaNodes_.empty()) {
+    return;
+  }
+  isPinned = true;
+  const auto& node = numaNodes_[numPinnedThreads_++ % numaNodes_.size()];
+  if (!ad_utility::numa::pinCurrentThreadToCpus(node.cpus_)) {
+    LOG(WARN) << "Could not pin a thread to the CPUs of NUMA node " << node.id_
+              << std::endl;
+  }
+}
+
+// _____________________________________________________________________________
+void Server::setNumQueryThreads(size_t numThreads) {
+  if (numThreads == 0) {
+    numThreads = numThreads_;
+  }
+  threadPool_.resize(numThreads);
+  admissionController_.setMaxNumRunning(numThreads);
+  LOG(INFO) << "Number of threads that compute queries: " << numThreads
+            << std::endl;
+}
+
+// _____________________________________________________________________________
+void Server::sendTraceToCollector(const ad_utility::QueryTrace& trace) {
+  std::string url = RuntimeParameters().get<"trace-collector-url">();
+  try {
+    sendHttpOrHttpsRequest(ad_utility::httpUtils::Url{url},
+                           boost::beast::http::verb::post,
+                           trace.toOpenTelemetry().dump(), "application/json",
+                           "application/json");
+  } catch (const std::exception& e) {
+    LOG(WARN) << "Sending the trace of the query to \"" << url
+              << "\" failed: " << e.what() << std::endl;
+  }
+}
+
+// _____________________________________________________________________________
+ad_utility::MemorySize Server::estimateResultMemory(QueryExecutionTree& qet) {
+  size_t numRows = qet.getSizeEstimate();
+  size_t bytesPerRow = std::max(qet.getResultWidth(), size_t{1}) * sizeof(Id);
+  return numRows > ad_utility::MemorySize::max().getBytes() / bytesPerRow
+             ? ad_utility::MemorySize::max()
+             : ad_utility::MemorySize::bytes(numRows * bytesPerRow);
+}
+
+// _____________________________________________________________________________
+ad_utility::MemorySize Server::queryMemoryBudget(
+    ad_utility::MemorySize memoryEstimate) {
+  double factor =
+      RuntimeParameters().get<"query-memory-budget-estimate-factor">();
+  if (factor <= 0.0) {
+    return ad_utility::MemorySize::max();
+  }
+  double bytes = factor * static_cast<double>(memoryEstimate.getBytes());
+  if (bytes >=
+      static_cast<double>(ad_utility::MemorySize::max().getBytes())) {
+    return ad_utility::MemorySize::max();
+  }
+  return std::max(
+      RuntimeParameters().get<"query-memory-budget-min">(),
+      ad_utility::MemorySize::bytes(static_cast<size_t>(bytes)));
+}
+
+// _____________________________________________________________________________
+Awaitable<ad_utility::QueryAdmissionController::Ticket>
+Server::waitForAdmission(QueryExecutionTree& qet,
+                         ad_utility::QueryPriority priority) {
+  using Ticket = ad_utility::QueryAdmissionController::Ticket;
+  // The estimates of the query planner are rough, but they are the best
+  // information about the memory of a query that is available in advance.
+  auto memoryEstimate = estimateResultMemory(qet);
+  auto initiate = [this, priority, memoryEstimate](auto handler) {
+    auto executor = net::get_associated_executor(handler);
+    auto sharedHandler =
+        std::make_shared<decltype(handler)>(std::move(handler));
+    // The admission may happen on a different thread (the one that releases
+    // another ticket), so the coroutine is resumed via its own executor.
+    admissionController_.requestAdmission(
+        priority, memoryEstimate,
+        [executor, sharedHandler = std::move(sharedHandler)](Ticket ticket) {
+          net::post(executor, [sharedHandler,
+                               ticket = std::move(ticket)]() mutable {
+            std::move(*sharedHandler)(std::move(ticket));
+          });
+        });
+  };
+  co_return co_await net::async_initiate<const net::use_awaitable_t<>&,
+                                         void(Ticket)>(initiate,
+                                                       net::use_awaitable);
+}
+
+// _____________________________________________________________________________
+Awaitable<std::optional<std::shared_ptr<const Server::SharedResponse>>>
+Server::waitForIdenticalQuery(const std::string& key) {
+  using Result = std::optional<std::shared_ptr<const SharedResponse>>;
+  auto initiate = [this, &key](auto handler) {
+    auto executor = net::get_associated_executor(handler);
+    auto sharedHandler =
+        std::make_shared<decltype(handler)>(std::move(handler));
+    auto complete = [executor, sharedHandler](Result result) {
+      net::post(executor, [sharedHandler, result = std::move(result)]() {
+        std::move(*sharedHandler)(std::move(result));
+      });
+    };
+    bool isFirst = identicalQueries_.registerOrWait(
+        key, [complete](std::shared_ptr<const SharedResponse> response) {
+          complete(std::move(response));
+        });
+    if (isFirst) {
+      complete(std::nullopt);
+    }
+  };
+  co_return co_await net::async_initiate<const net::use_awaitable_t<>&,
+                                         void(Result)>(initiate,
+                                                       net::use_awaitable);
 }
 
 // _____________________________________________________________________________
 net::awaitable<Server::PlannedQuery> Server::parseAndPlan(
     const std::string& query, QueryExecutionContext& qec) const {
   return computeInNewThread(
-      [&query, &qec, enablePatternTrick = enablePatternTrick_]() {
-        auto pq = SparqlParser::parseQuery(query);
+      [this, &query, &qec, enablePatternTrick = enablePatternTrick_]() {
+        auto pq = parsedQueryCache_.getOrParse(query);
         QueryPlanner qp(&qec);
         qp.setEnablePatternTrick(enablePatternTrick);
         auto qet = qp.createExecutionTree(pq);
@@ -5,20 +5,31 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <semaphore>
 #include <string>
 #include <vector>
 
 #include "engine/Engine.h"
+#include "engine/MaterializedViews.h"
 #include "engine/QueryExecutionContext.h"
 #include "engine/QueryExecutionTree.h"
+#include "engine/ResultCursors.h"
 #include "engine/SortPerformanceEstimator.h"
 #include "index/Index.h"
+#include "parser/ParsedQueryCache.h"
 #include "parser/SparqlParser.h"
 #include "util/AllocatorWithLimit.h"
 #include "util/MemorySize/MemorySize.h"
+#include "util/Numa.h"
 #include "util/ParseException.h"
+#include "util/QueryAdmissionController.h"
+#include "util/ResizableThreadPool.h"
+#include "util/Synchronized.h"
 #include "util/http/HttpServer.h"
+#include "util/http/RequestDeduplicator.h"
 #include "util/http/streamable_body.h"
 #include "util/http/websocket/QueryHub.h"
 #include "util/json.h"
@@ -49,8 +60,22 @@ class Server {
   void run(const string& indexBaseName, bool useText, bool usePatterns = true,
            bool loadAllPermutations = true);
 
-  Index& index() { return index_; }
-  const Index& index() const { return index_; }
+  // Stop the HTTP server of `run` (the requests that are currently processed
+  // still finish), s.t. `run` returns. Return false if the server is not (yet)
+  // ready to accept connections or was already shut down. This is currently
+  // only used by benchmarks, normally the server runs forever.
+  bool shutDown();
+
+  Index& index() { return getIndexAndCache()->index_; }
+  const Index& index() const { return getIndexAndCache()->index_; }
+
+  // Load the index with the `indexBaseName` (with the same settings as the
+  // current index) and compute the queries of the most important results of
+  // the current cache on it. Then process all new queries on the new index and
+  // its cache. The queries that are still running on the old index finish
+  // normally, the old index is destroyed after the last of them. Throw if the
+  // index cannot be loaded or if another swap is in progress.
+  void swapIndex(const std::string& indexBaseName);
 
   /// Helper struct bundling a parsed query with a query execution tree.
   struct PlannedQuery {
@@ -62,19 +87,73 @@ class Server {
   const size_t numThreads_;
   unsigned short port_;
   std::string accessToken_;
-  QueryResultCache cache_;
+  // The maximal number of entries is set in the constructor via the runtime
+  // parameter `parsed-query-cache-max-num-entries`.
+  mutable ParsedQueryCache parsedQueryCache_{0};
   ad_utility::AllocatorWithLimit<Id> allocator_;
+  // Limits the number of queries that are computed at the same time and the
+  // memory that is reserved for them (see `waitForAdmission`).
+  ad_utility::QueryAdmissionController admissionController_;
   SortPerformanceEstimator sortPerformanceEstimator_;
-  Index index_;
+
+  // The index and the cache of the results of the queries on this index. Both
+  // are replaced together by `swapIndex`. Each query holds a `shared_ptr` to
+  // the `IndexAndCache` on which it was started.
+  struct IndexAndCache {
+    Index index_;
+    QueryResultCache cache_;
+    explicit IndexAndCache(ad_utility::AllocatorWithLimit<Id> allocator)
+        : index_{std::move(allocator)} {}
+  };
+  ad_utility::Synchronized<std::shared_ptr<IndexAndCache>> indexAndCache_;
+  // The settings with which the index was loaded by `initialize`, they are
+  // reused by `swapIndex`.
+  bool useText_ = false;
+  bool usePatterns_ = true;
+  bool loadAllPermutations_ = true;
+  std::atomic<bool> isSwappingIndex_ = false;
+  // Shuts down the HTTP server while `run` is running (see `shutDown`).
+  ad_utility::Synchronized<std::function<bool()>> shutDownHttpServer_;
+  // The named materialized views of the current index, the results of which
+  // are pinned in its cache.
+  MaterializedViews materializedViews_;
+  // The results that are kept for the pages of cursors (`cursor=open`).
+  ResultCursors resultCursors_;
   ad_utility::websocket::QueryRegistry queryRegistry_{};
+  // The memory budgets of the queries that are currently processed (see
+  // `processQuery`), which are shown by the command `dump-active-queries`.
+  ad_utility::Synchronized<
+      ad_utility::HashMap<ad_utility::websocket::QueryId,
+                          ad_utility::detail::AllocationMemoryLeftThreadsafe>>
+      queryMemoryBudgets_;
 
   bool enablePatternTrick_;
 
+  /// The serialized response to a query (see `identicalQueries_`).
+  struct SharedResponse {
+    std::string body_;
+    boost::beast::http::status status_;
+  };
+
+  /// The queries that are currently processed, s.t. identical queries that
+  /// arrive in the meantime can wait for them and share their response.
+  ad_utility::httpUtils::RequestDeduplicator<SharedResponse> identicalQueries_;
+
   /// Non-owning reference to the `QueryHub` instance living inside
   /// the `WebSocketHandler` created for `HttpServer`.
   std::weak_ptr<ad_utility::websocket::QueryHub> queryHub_;
 
-  mutable net::static_thread_pool threadPool_;
+  // The threads that compute the queries, the number of which is set by the
+  // runtime parameter `num-query-threads` (see `setNumQueryThreads`).
+  mutable ad_utility::ResizableThreadPool threadPool_;
+  // The number of tasks that were posted to the `threadPool_` via
+  // `computeInNewThread`, but have not started yet.
+  mutable std::atomic<size_t> numQueuedTasks_ = 0;
+  // The NUMA nodes (with CPUs) to which the threads of the `threadPool_` are
+  // pinned if the runtime parameter `numa-aware` is set, and the number of
+  // threads that have been pinned so far (see `pinThreadToNumaNode`).
+  std::vector<ad_utility::numa::Node> numaNodes_;
+  mutable std::atomic<size_t> numPinnedThreads_ = 0;
 
   template <typename T>
   using Awaitable = boost::asio::awaitable<T>;
@@ -106,20 +185,94 @@ class Server {
   ///             `HttpServer.h` for documentation).
   /// \param timeLimit Duration in seconds after which the query will be
   ///                  cancelled.
+  /// \param priority The priority with which the query is admitted by the
+  ///                 `admissionController_`.
+  /// \param queryHints The hints for the execution of the query, which were
+  ///                   read from the `params`.
   Awaitable<void> processQuery(
       const ParamValueMap& params, ad_utility::Timer& requestTimer,
       const ad_utility::httpUtils::HttpRequest auto& request, auto&& send,
-      TimeLimit timeLimit);
+      TimeLimit timeLimit, ad_utility::QueryPriority priority,
+      QueryHints queryHints);
+
+  /// Wait (without blocking a thread) until the `admissionController_` admits
+  /// a query with the given `priority`, for which the memory of the result
+  /// estimated by the query planner is reserved. The returned ticket has to
+  /// be kept alive until the query has been processed completely.
+  Awaitable<ad_utility::QueryAdmissionController::Ticket> waitForAdmission(
+      QueryExecutionTree& qet, ad_utility::QueryPriority priority);
+
+  // The memory of the result of the `qet` as estimated by the query planner.
+  static ad_utility::MemorySize estimateResultMemory(QueryExecutionTree& qet);
+
+  // The memory budget of a query with the given `memoryEstimate`, which is
+  // derived from the runtime parameters `query-memory-budget-estimate-factor`
+  // and `query-memory-budget-min`.
+  static ad_utility::MemorySize queryMemoryBudget(
+      ad_utility::MemorySize memoryEstimate);
+
+  /// If an identical query (with the same key) is currently processed, wait
+  /// for it and return its response (or `nullptr` if it was aborted).
+  /// Otherwise return `std::nullopt`; the caller is then responsible for
+  /// publishing its response to `identicalQueries_` for the `key`.
+  Awaitable<std::optional<std::shared_ptr<const SharedResponse>>>
+  waitForIdenticalQuery(const std::string& key);
 
   static json composeErrorResponseJson(
       const string& query, const std::string& errorMsg,
       ad_utility::Timer& requestTimer,
       const std::optional<ExceptionMetadata>& metadata = std::nullopt);
 
+  // The plan of the `qet` (which is not executed) with the cost and size
+  // estimates, the column names, and the sort order of each operation, in the
+  // format of the runtime information of the QLever JSON result.
+  static json composeExplainJson(const string& query,
+                                 const QueryExecutionTree& qet,
+                                 ad_utility::Timer& requestTimer);
+
+  // The current `IndexAndCache` (see above).
+  std::shared_ptr<IndexAndCache> getIndexAndCache() const {
+    return *indexAndCache_.rlock();
+  }
+
+  // Load the index with the `indexBaseName` into the `index` with the settings
+  // `useText_`, `usePatterns_`, and `loadAllPermutations_`.
+  void loadIndex(Index& index, const std::string& indexBaseName) const;
+
+  // Set the limits and the eviction policy of the `cache` to the values of the
+  // corresponding runtime parameters.
+  static void configureCache(QueryResultCache& cache);
+
+  // Compute the results of the materialized views with the `definitions` on
+  // the `index` and pin them in the `cache`. Return the number of views that
+  // were computed successfully, the failures are only logged.
+  size_t computeMaterializedViews(
+      const Index& index, QueryResultCache& cache,
+      const MaterializedViews::Definitions& definitions) const;
+
+  // Called by the allocators of the server if an allocation of `numBytes`
+  // doesn't fit into the memory limit: first evict results from the cache,
+  // and if that doesn't suffice, the results of the cursors.
+  void makeRoomForAllocation(ad_utility::MemorySize numBytes);
+
+  // Answer a request for the page `[offset, offset + limit)` of the cursor
+  // with the `handle` (URL parameters `offset` and `limit`, both optional).
+  json composeCursorPageJson(const std::string& handle,
+                             const ParamValueMap& parameters);
+
   json composeStatsJson() const;
 
   json composeCacheStatsJson() const;
 
+  // The ids of the queries that are currently processed together with the
+  // memory that they currently use, their peak memory usage, and the memory
+  // that is left in their budget.
+  json composeActiveQueriesJson() const;
+
+  // All the metrics of the server in the Prometheus text format (for the
+  // `/metrics` endpoint).
+  std::string composeMetrics() const;
+
   // Perform the following steps: Acquire a token from the
   // queryProcessingSemaphore_, run `function`, and release the token. These
   // steps are performed on a new thread (not one of the server threads).
@@ -127,6 +280,21 @@ class Server {
   template <typename Function, typename T = std::invoke_result_t<Function>>
   Awaitable<T> computeInNewThread(Function function) const;
 
+  // If the `numaNodes_` are not empty and the calling thread has not been
+  // pinned yet, pin it to the CPUs of the next node. Called at the start of
+  // each task of `computeInNewThread`.
+  void pinThreadToNumaNode() const;
+
+  // Set the number of threads of the `threadPool_` and the maximal number of
+  // queries that are computed at the same time to `numThreads` (to the
+  // `numThreads_` from the command line if `numThreads` is 0). Called when the
+  // runtime parameter `num-query-threads` changes.
+  void setNumQueryThreads(size_t numThreads);
+
+  // Post the `trace` of a query as OpenTelemetry spans to the
+  // `trace-collector-url` (if it is set). Errors are only logged.
+  static void sendTraceToCollector(const ad_utility::QueryTrace& trace);
+
   /// This method extracts a client-defined query id from the passed HTTP
   /// request if it is present. If it is not present or empty, a new
   /// pseudo-random id will be chosen by the server. Note that this id is not
@@ -4,18 +4,70 @@
 
 #include "engine/Service.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "engine/CallFixedSize.h"
+#include "engine/IdTableExchange.h"
 #include "engine/Values.h"
 #include "engine/VariableToColumnMap.h"
 #include "parser/TokenizerCtre.h"
 #include "parser/TurtleParser.h"
 #include "util/Exception.h"
 #include "util/HashSet.h"
+#include "util/ParallelExecution.h"
+#include "util/ParseableDuration.h"
 #include "util/http/HttpClient.h"
 #include "util/http/HttpUtils.h"
 
+namespace {
+// Split the `chunks` of a response into lines (without the newline), as soon
+// as the lines are complete. `onChunk` is called after each chunk.
+cppcoro::generator<std::string_view> splitIntoLines(
+    cppcoro::generator<std::string> chunks,
+    std::function<void()> onChunk) {
+  // The incomplete last line of the previous chunks.
+  std::string remainder;
+  for (const std::string& chunk : chunks) {
+    onChunk();
+    size_t begin = 0;
+    for (size_t end = chunk.find('\n'); end != std::string::npos;
+         end = chunk.find('\n', begin)) {
+      std::string_view line{chunk.data() + begin, end - begin};
+      if (remainder.empty()) {
+        co_yield line;
+      } else {
+        remainder.append(line);
+        co_yield remainder;
+        remainder.clear();
+      }
+      begin = end + 1;
+    }
+    remainder.append(chunk, begin);
+  }
+  if (!remainder.empty()) {
+    co_yield remainder;
+  }
+}
+
+// Yield the `firstChunk` followed by the chunks of the `chunks` from the
+// position `it` on.
+cppcoro::generator<std::string> prependChunk(
+    std::string firstChunk, cppcoro::generator<std::string> chunks,
+    cppcoro::generator<std::string>::iterator it) {
+  co_yield firstChunk;
+  for (; it != chunks.end(); ++it) {
+    co_yield *it;
+  }
+}
+
+// Yield the cached `response` as a single chunk.
+cppcoro::generator<std::string> yieldCachedResponse(
+    std::shared_ptr<const std::string> response) {
+  co_yield std::string{*response};
+}
+}  // namespace
+
 // ____________________________________________________________________________
 Service::Service(QueryExecutionContext* qec,
                  parsedQuery::Service parsedServiceClause,
@@ -31,6 +83,10 @@ std::string Service::getCacheKeyImpl() const {
   os << "SERVICE " << parsedServiceClause_.serviceIri_.toSparql() << " {\n"
      << parsedServiceClause_.prologue_ << "\n"
      << parsedServiceClause_.graphPatternAsString_ << "\n}\n";
+  // The result depends on the shards.
+  if (isSharded()) {
+    os << "ON SHARDS " << absl::StrJoin(getShardEndpoints(), ",");
+  }
   return std::move(os).str();
 }
 
@@ -81,21 +137,72 @@ size_t Service::getCostEstimate() {
 }
 
 // ____________________________________________________________________________
-ResultTable Service::computeResult() {
-  // Get the URL of the SPARQL endpoint.
-  std::string_view serviceIriString = parsedServiceClause_.serviceIri_.iri();
-  AD_CONTRACT_CHECK(serviceIriString.starts_with("<") &&
-                    serviceIriString.ends_with(">"));
-  serviceIriString.remove_prefix(1);
-  serviceIriString.remove_suffix(1);
-  ad_utility::httpUtils::Url serviceUrl{serviceIriString};
+bool Service::isSharded() const {
+  return parsedServiceClause_.serviceIri_.iri() == SHARDS_SERVICE_IRI;
+}
+
+// ____________________________________________________________________________
+std::vector<std::string> Service::getShardEndpoints() {
+  std::vector<std::string> endpoints;
+  for (std::string_view endpoint :
+       absl::StrSplit(RuntimeParameters().get<"shard-endpoints">(), ',')) {
+    endpoint = absl::StripAsciiWhitespace(endpoint);
+    if (!endpoint.empty()) {
+      endpoints.emplace_back(endpoint);
+    }
+  }
+  return endpoints;
+}
+
+// ____________________________________________________________________________
+ServiceCache::Config Service::getServiceCacheConfig(std::string_view endpoint) {
+  using std::chrono::seconds;
+  const auto& parameters = RuntimeParameters();
+  ServiceCache::Config config;
+  config.ttl_ = seconds{parameters.get<"service-cache-ttl">()};
+  for (std::string_view urlAndTtl :
+       absl::StrSplit(parameters.get<"service-cache-ttl-per-endpoint">(), ',',
+                      absl::SkipWhitespace())) {
+    std::vector<std::string_view> parts =
+        absl::StrSplit(urlAndTtl, ' ', absl::SkipWhitespace());
+    if (parts.size() != 2) {
+      throw std::runtime_error(absl::StrCat(
+          "Invalid entry \"", urlAndTtl,
+          "\" in the runtime parameter \"service-cache-ttl-per-endpoint\", "
+          "expected \"<url> <ttl>\""));
+    }
+    if (parts[0] == endpoint) {
+      config.ttl_ =
+          seconds{ad_utility::ParseableDuration<seconds>::fromString(parts[1])};
+    }
+  }
+  config.staleWhileRevalidate_ =
+      seconds{parameters.get<"service-cache-stale-while-revalidate">()};
+  config.errorTtl_ = seconds{parameters.get<"service-cache-error-ttl">()};
+  config.maxSizeInBytes_ =
+      parameters.get<"service-cache-max-size">().getBytes();
+  return config;
+}
 
+// ____________________________________________________________________________
+ResultTable Service::computeResult([[maybe_unused]] bool requestLaziness) {
   // Construct the query to be sent to the SPARQL endpoint.
   std::string variablesForSelectClause = absl::StrJoin(
       parsedServiceClause_.visibleVariables_, " ", Variable::AbslFormatter);
   std::string serviceQuery = absl::StrCat(
       parsedServiceClause_.prologue_, "\nSELECT ", variablesForSelectClause,
       " WHERE ", parsedServiceClause_.graphPatternAsString_);
+  if (isSharded()) {
+    return computeResultFromShards(serviceQuery);
+  }
+
+  // Get the URL of the SPARQL endpoint.
+  std::string_view serviceIriString = parsedServiceClause_.serviceIri_.iri();
+  AD_CONTRACT_CHECK(serviceIriString.starts_with("<") &&
+                    serviceIriString.ends_with(">"));
+  serviceIriString.remove_prefix(1);
+  serviceIriString.remove_suffix(1);
+  ad_utility::httpUtils::Url serviceUrl{serviceIriString};
   LOG(INFO) << "Sending SERVICE query to remote endpoint "
             << "(protocol: " << serviceUrl.protocolAsString()
             << ", host: " << serviceUrl.host()
@@ -103,25 +210,78 @@ ResultTable Service::computeResult() {
             << ", target: " << serviceUrl.target() << ")" << std::endl
             << serviceQuery << std::endl;
 
-  // Send the query to the remote SPARQL endpoint via a POST request and get the
-  // result as TSV.
-  //
-  // TODO: We should support a timeout here.
+  // Send the query to the remote SPARQL endpoint via a POST request. If the
+  // endpoint is a QLever server, it sends the result in the binary exchange
+  // format of QLever (see `IdTableExchange.h`), which needs no parsing and, if
+  // the endpoint uses the same index, no lookups in the vocabulary. Other
+  // endpoints send the result as TSV.
   //
   // TODO: We ask for the result as TSV because that is a compact and
   // easy-to-parse format. It might not be the best choice regarding robustness
   // and portability though. In particular, we are not sure how deterministic
   // the TSV output is with respect to the precise encoding of literals.
-  std::istringstream tsvResult =
-      getTsvFunction_(serviceUrl, boost::beast::http::verb::post, serviceQuery,
-                      "application/sparql-query", "text/tab-separated-values");
+  //
+  // The response is taken from the `ServiceCache` if it is enabled for the
+  // endpoint (the accept header is part of the key, because it contains the
+  // vocabulary identity of this server).
+  std::string acceptHeader = idTableExchange::makeAcceptHeader(
+      idTableExchange::getVocabularyIdentity(getIndex()));
+  auto cacheConfig = getServiceCacheConfig(serviceIriString);
+  auto fetch = [getTsvFunction = getTsvFunction_, serviceUrl, serviceQuery,
+                acceptHeader](const std::function<void()>& onChunk) {
+    std::string response;
+    for (const std::string& chunk :
+         getTsvFunction(serviceUrl, boost::beast::http::verb::post,
+                        serviceQuery, "application/sparql-query",
+                        acceptHeader)) {
+      onChunk();
+      response.append(chunk);
+    }
+    return response;
+  };
+  auto chunks =
+      cacheConfig.ttl_ == ServiceCache::Clock::duration::zero()
+          ? getTsvFunction_(serviceUrl, boost::beast::http::verb::post,
+                            std::move(serviceQuery), "application/sparql-query",
+                            std::move(acceptHeader))
+          : yieldCachedResponse(getServiceCache().getOrFetch(
+                absl::StrCat(serviceIriString, "\n", acceptHeader, "\n",
+                             serviceQuery),
+                cacheConfig, fetch, [this]() { checkCancellation(); }));
+  // Read enough bytes to recognize the format of the result.
+  std::string firstBytes;
+  auto chunkIt = chunks.begin();
+  while (firstBytes.size() < idTableExchange::MAGIC.size() &&
+         chunkIt != chunks.end()) {
+    checkCancellation();
+    firstBytes.append(*chunkIt);
+    ++chunkIt;
+  }
+  if (firstBytes.size() >= idTableExchange::MAGIC.size() &&
+      idTableExchange::startsWithMagic(firstBytes)) {
+    for (; chunkIt != chunks.end(); ++chunkIt) {
+      checkCancellation();
+      firstBytes.append(*chunkIt);
+    }
+    LocalVocab localVocab;
+    IdTable idTable = idTableExchange::decode(
+        firstBytes, getResultWidth(), getIndex(), localVocab,
+        getExecutionContext()->getAllocator());
+    LOG(INFO) << "Number of rows in binary result: " << idTable.size()
+              << std::endl;
+    return {std::move(idTable), resultSortedOn(), std::move(localVocab)};
+  }
+  auto tsvRows = splitIntoLines(
+      prependChunk(std::move(firstBytes), std::move(chunks), chunkIt),
+      [this]() { checkCancellation(); });
 
   // The first line of the TSV result contains the variable names.
-  std::string tsvHeaderRow;
-  if (!std::getline(tsvResult, tsvHeaderRow)) {
+  auto it = tsvRows.begin();
+  if (it == tsvRows.end()) {
     throw std::runtime_error(absl::StrCat("Response from SPARQL endpoint ",
                                           serviceUrl.host(), " is empty"));
   }
+  std::string tsvHeaderRow{*it};
   LOG(INFO) << "Header row of TSV result: " << tsvHeaderRow << std::endl;
 
   // Check that the variables in the header row agree with those requested by
@@ -141,22 +301,76 @@ ResultTable Service::computeResult() {
   // Fill the result table using the `writeTsvResult` method below.
   size_t resWidth = getResultWidth();
   CALL_FIXED_SIZE(resWidth, &Service::writeTsvResult, this,
-                  std::move(tsvResult), &idTable, &localVocab);
+                  std::move(tsvRows), &idTable, &localVocab);
 
   return {std::move(idTable), resultSortedOn(), std::move(localVocab)};
 }
 
+// ____________________________________________________________________________
+ResultTable Service::computeResultFromShards(const std::string& serviceQuery) {
+  auto endpoints = getShardEndpoints();
+  if (endpoints.empty()) {
+    throw std::runtime_error(absl::StrCat(
+        "The SERVICE ", SHARDS_SERVICE_IRI,
+        " requires the runtime parameter \"shard-endpoints\""));
+  }
+  const size_t width = getResultWidth();
+  if (width == 0) {
+    throw std::runtime_error(absl::StrCat(
+        "The SERVICE ", SHARDS_SERVICE_IRI, " must have visible variables"));
+  }
+  LOG(INFO) << "Sending SERVICE query to " << endpoints.size()
+            << " shards: " << absl::StrJoin(endpoints, ", ") << std::endl
+            << serviceQuery << std::endl;
+
+  // The results of the shards in the binary exchange format of QLever (see
+  // `IdTableExchange.h`).
+  const std::string acceptHeader = idTableExchange::makeAcceptHeader(
+      idTableExchange::getVocabularyIdentity(getIndex()));
+  std::vector<std::string> responses(endpoints.size());
+  ad_utility::runConcurrently(endpoints.size(), [&](size_t i) {
+    for (const std::string& chunk :
+         getTsvFunction_(ad_utility::httpUtils::Url{endpoints[i]},
+                         boost::beast::http::verb::post, serviceQuery,
+                         "application/sparql-query", acceptHeader)) {
+      checkCancellation();
+      responses[i].append(chunk);
+    }
+  });
+
+  // The results are decoded one after the other, because they share the
+  // `localVocab`, to which the words that are not contained in the vocabulary
+  // of this server are added.
+  IdTable idTable{width, getExecutionContext()->getAllocator()};
+  LocalVocab localVocab;
+  for (size_t i = 0; i < responses.size(); ++i) {
+    if (!responses[i].starts_with(idTableExchange::MAGIC)) {
+      throw std::runtime_error(absl::StrCat(
+          "The shard ", endpoints[i],
+          " did not send its result in the exchange format of QLever"));
+    }
+    idTable.insertAtEnd(idTableExchange::decode(
+        responses[i], width, getIndex(), localVocab,
+        getExecutionContext()->getAllocator()));
+    std::string{}.swap(responses[i]);
+  }
+  LOG(INFO) << "Number of rows in result: " << idTable.size() << std::endl;
+  return {std::move(idTable), resultSortedOn(), std::move(localVocab)};
+}
+
 // ____________________________________________________________________________
 template <size_t I>
-void Service::writeTsvResult(std::istringstream tsvResult, IdTable* idTablePtr,
-                             LocalVocab* localVocab) {
+void Service::writeTsvResult(cppcoro::generator<std::string_view> tsvRows,
+                             IdTable* idTablePtr, LocalVocab* localVocab) {
   IdTableStatic<I> idTable = std::move(*idTablePtr).toStatic<I>();
   size_t rowIdx = 0;
   std::vector<size_t> numLocalVocabPerColumn(idTable.numColumns());
-  std::string line;
   std::string lastLine;
   const size_t numVariables = parsedServiceClause_.visibleVariables_.size();
-  while (lastLine = std::move(line), std::getline(tsvResult, line)) {
+  // The header row has already been consumed by `computeResult`, so we
+  // continue with the current position of the generator.
+  for (std::string_view line : tsvRows) {
+    lastLine = line;
     // Print first line.
     if (rowIdx == 0) {
       LOG(INFO) << "First non-header row of TSV result: " << line << std::endl;
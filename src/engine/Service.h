@@ -7,6 +7,7 @@
 #include <functional>
 
 #include "engine/Operation.h"
+#include "engine/ServiceCache.h"
 #include "engine/Values.h"
 #include "parser/ParsedQuery.h"
 #include "util/http/HttpClient.h"
@@ -21,7 +22,8 @@
 // 1. Reading the result as TSV has potential problems (see comment in
 // `computeResult` for details).
 //
-// 2. There should be a timeout.
+// 2. There should be a timeout for the connection. Currently, only the time
+// limit of the query is checked whenever a chunk of the result arrives.
 //
 // 3. A variable in place of the IRI is not yet supported (see comment in
 // `computeResult` for details).
@@ -30,12 +32,19 @@
 // estimates of the result size, cost, and multiplicities are therefore dummy
 // values.
 //
+// The special SERVICE `ql:shards` (see `SHARDS_SERVICE_IRI`) is sent to all
+// the `shard-endpoints` concurrently, and the union of their results is the
+// result of the SERVICE. As the shards use the same vocabulary as this index,
+// their results are exchanged in the binary format of `binary_export` instead
+// of TSV, so the `Id`s are neither converted to strings nor looked up again.
+//
 class Service : public Operation {
  public:
-  // The type of the function used to obtain the results, see below.
-  using GetTsvFunction = std::function<std::istringstream(
-      ad_utility::httpUtils::Url, const boost::beast::http::verb&,
-      std::string_view, std::string_view, std::string_view)>;
+  // The type of the function used to obtain the results, see below. It yields
+  // the body of the response in chunks.
+  using GetTsvFunction = std::function<cppcoro::generator<std::string>(
+      ad_utility::httpUtils::Url, boost::beast::http::verb, std::string,
+      std::string, std::string)>;
 
  private:
   // The parsed SERVICE clause.
@@ -48,11 +57,11 @@ class Service : public Operation {
   // Construct from parsed Service clause.
   //
   // NOTE: The third argument is the function used to obtain the result from the
-  // remote endpoint. The default is to use `httpUtils::sendHttpOrHttpsRequest`,
+  // remote endpoint. The default is to use `sendHttpOrHttpsRequestStreaming`,
   // but in our tests (`ServiceTest`) we use a mock function that does not
   // require a running `HttpServer`.
   Service(QueryExecutionContext* qec, parsedQuery::Service parsedServiceClause,
-          GetTsvFunction getTsvFunction = sendHttpOrHttpsRequest);
+          GetTsvFunction getTsvFunction = sendHttpOrHttpsRequestStreaming);
 
   // Methods inherited from base class `Operation`.
   std::string getDescriptor() const override;
@@ -81,16 +90,30 @@ class Service : public Operation {
   std::string getCacheKeyImpl() const override;
 
   // Compute the result using `getTsvFunction_`.
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
+
+  // True iff this is the SERVICE `ql:shards`.
+  bool isSharded() const;
+
+  // The URLs from the runtime parameter `shard-endpoints`.
+  static std::vector<std::string> getShardEndpoints();
+
+  // The configuration of the `ServiceCache` for the `endpoint` (the IRI of
+  // the SERVICE without the angle brackets) from the runtime parameters.
+  static ServiceCache::Config getServiceCacheConfig(std::string_view endpoint);
+
+  // Send the `serviceQuery` to all the `shard-endpoints` and return the union
+  // of their results, which are requested in the binary exchange format of
+  // QLever (see `IdTableExchange.h`).
+  ResultTable computeResultFromShards(const std::string& serviceQuery);
 
-  // Write the given TSV result to the given result object. The `I` is the width
-  // of the result table.
+  // Write the rows of the given TSV result (without the header row) to the
+  // given result object. The `I` is the width of the result table.
   //
   // NOTE: This is similar to `Values::writeValues`, except that we have to
-  // parse TSV here and not a VALUES clause. Note that the only reason that
-  // `tsvResult` is not `const` here is because the method iterates over the
-  // `std::istringstream` and thus changes it.
+  // parse TSV here and not a VALUES clause. The rows are parsed as soon as
+  // they have arrived from the remote endpoint.
   template <size_t I>
-  void writeTsvResult(std::istringstream tsvResult, IdTable* idTable,
-                      LocalVocab* localVocab);
+  void writeTsvResult(cppcoro::generator<std::string_view> tsvRows,
+                      IdTable* idTable, LocalVocab* localVocab);
 };
@@ -0,0 +1,127 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/ServiceCache.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include "util/CancellationHandle.h"
+#include "util/Log.h"
+
+// _____________________________________________________________________________
+ServiceCache::ServiceCache(RunInBackground runInBackground,
+                           std::function<Clock::time_point()> now)
+    : runInBackground_{std::move(runInBackground)}, now_{std::move(now)} {}
+
+// _____________________________________________________________________________
+void ServiceCache::runOnDetachedThread(std::function<void()> function) {
+  std::thread{std::move(function)}.detach();
+}
+
+// _____________________________________________________________________________
+std::shared_ptr<const std::string> ServiceCache::getOrFetch(
+    const std::string& key, const Config& config, const FetchFunction& fetch,
+    const std::function<void()>& onChunk) {
+  if (config.ttl_ == Clock::duration::zero()) {
+    return std::make_shared<const std::string>(fetch(onChunk));
+  }
+  {
+    auto state = state_.wlock();
+    auto it = state->entries_.find(key);
+    if (it != state->entries_.end()) {
+      Entry& entry = it->second;
+      auto now = now_();
+      auto age = now - entry.fetchedAt_;
+      entry.lastAccess_ = now;
+      if (entry.isError_) {
+        if (age < config.errorTtl_) {
+          throw std::runtime_error{*entry.response_};
+        }
+      } else if (age < config.ttl_) {
+        return entry.response_;
+      } else if (age < config.ttl_ + config.staleWhileRevalidate_) {
+        if (!entry.isRefreshing_) {
+          entry.isRefreshing_ = true;
+          runInBackground_(
+              [this, key, config, fetch] { refresh(key, config, fetch); });
+        }
+        return entry.response_;
+      }
+    }
+  }
+
+  std::shared_ptr<const std::string> response;
+  try {
+    response = std::make_shared<const std::string>(fetch(onChunk));
+  } catch (const ad_utility::CancellationException&) {
+    // The request was cancelled by us, the endpoint didn't fail.
+    throw;
+  } catch (const std::exception& e) {
+    if (config.errorTtl_ > Clock::duration::zero()) {
+      store(key, std::make_shared<const std::string>(e.what()), true, config);
+    }
+    throw;
+  }
+  store(key, response, false, config);
+  return response;
+}
+
+// _____________________________________________________________________________
+void ServiceCache::refresh(const std::string& key, const Config& config,
+                           FetchFunction fetch) {
+  try {
+    store(key, std::make_shared<const std::string>(fetch([] {})), false,
+          config);
+  } catch (const std::exception& e) {
+    // The stale response remains better than an error, it is used until it
+    // expires.
+    LOG(WARN) << "Refreshing the cached result of a SERVICE failed: "
+              << e.what() << std::endl;
+    auto state = state_.wlock();
+    if (auto it = state->entries_.find(key); it != state->entries_.end()) {
+      it->second.isRefreshing_ = false;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void ServiceCache::store(const std::string& key,
+                         std::shared_ptr<const std::string> response,
+                         bool isError, const Config& config) {
+  auto state = state_.wlock();
+  auto& entries = state->entries_;
+  if (auto it = entries.find(key); it != entries.end()) {
+    state->sizeInBytes_ -= it->second.response_->size();
+    entries.erase(it);
+  }
+  if (response->size() > config.maxSizeInBytes_) {
+    return;
+  }
+  // Evict the least recently used entries until the new response fits.
+  while (state->sizeInBytes_ + response->size() > config.maxSizeInBytes_) {
+    auto lru = std::ranges::min_element(
+        entries, {}, [](const auto& keyAndEntry) {
+          return keyAndEntry.second.lastAccess_;
+        });
+    state->sizeInBytes_ -= lru->second.response_->size();
+    entries.erase(lru);
+  }
+  auto now = now_();
+  state->sizeInBytes_ += response->size();
+  entries[key] = Entry{std::move(response), isError, now, now, false};
+}
+
+// _____________________________________________________________________________
+void ServiceCache::clear() {
+  auto state = state_.wlock();
+  state->entries_.clear();
+  state->sizeInBytes_ = 0;
+}
+
+// _____________________________________________________________________________
+ServiceCache& getServiceCache() {
+  static ServiceCache cache;
+  return cache;
+}
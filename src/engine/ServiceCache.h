@@ -0,0 +1,99 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "util/HashMap.h"
+#include "util/Synchronized.h"
+
+// A cache for the responses of remote SPARQL endpoints to the queries of a
+// `SERVICE`, which is independent of the `QueryResultCache`: its entries
+// expire after a time to live (TTL), which can be configured per endpoint, and
+// failed requests can be cached as well, s.t. a failing endpoint isn't asked
+// again by each query. The responses are cached as the raw bytes that were
+// received, which are parsed by each `Service` that uses them.
+//
+// An entry that is older than its TTL, but not older than the TTL plus the
+// `staleWhileRevalidate_` duration, is still returned, but it is refreshed in
+// the background. The total size of the responses is limited by evicting the
+// least recently used entries.
+//
+// This class is threadsafe.
+class ServiceCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Config {
+    // An entry is used without refreshing it for this duration, a TTL of zero
+    // disables the caching.
+    Clock::duration ttl_{};
+    Clock::duration staleWhileRevalidate_{};
+    // Failed requests are cached for this duration (not at all if it is zero).
+    Clock::duration errorTtl_{};
+    size_t maxSizeInBytes_ = 0;
+  };
+
+  // Fetch the complete response from the remote endpoint. The argument has to
+  // be called for each chunk of the response to check for a cancellation.
+  using FetchFunction =
+      std::function<std::string(const std::function<void()>& onChunk)>;
+
+  // Run the function in the background, by default on a detached thread.
+  using RunInBackground = std::function<void(std::function<void()>)>;
+
+ private:
+  struct Entry {
+    // The response or, if the request failed, the message of the exception.
+    std::shared_ptr<const std::string> response_;
+    bool isError_ = false;
+    Clock::time_point fetchedAt_;
+    Clock::time_point lastAccess_;
+    bool isRefreshing_ = false;
+  };
+  struct State {
+    ad_utility::HashMap<std::string, Entry> entries_;
+    size_t sizeInBytes_ = 0;
+  };
+  ad_utility::Synchronized<State, std::mutex> state_;
+  RunInBackground runInBackground_;
+  std::function<Clock::time_point()> now_;
+
+ public:
+  explicit ServiceCache(RunInBackground runInBackground = runOnDetachedThread,
+                        std::function<Clock::time_point()> now = Clock::now);
+
+  // Return the response for the `key` (which has to identify the endpoint and
+  // the query) from the cache or fetch it with `fetch` if there is no fresh or
+  // stale entry (see above). If the request failed and the error is cached,
+  // throw a `std::runtime_error` with the message of the original exception.
+  std::shared_ptr<const std::string> getOrFetch(
+      const std::string& key, const Config& config, const FetchFunction& fetch,
+      const std::function<void()>& onChunk);
+
+  // The total size of the cached responses in bytes.
+  size_t sizeInBytes() const { return state_.wlock()->sizeInBytes_; }
+
+  // Remove all entries.
+  void clear();
+
+  static void runOnDetachedThread(std::function<void()> function);
+
+ private:
+  // Insert the `response` for the `key` (replacing an existing entry) and
+  // evict entries until the size limit of the `config` is respected.
+  void store(const std::string& key,
+             std::shared_ptr<const std::string> response, bool isError,
+             const Config& config);
+
+  // Refresh the stale entry for the `key` with `fetch` in the background.
+  void refresh(const std::string& key, const Config& config,
+               FetchFunction fetch);
+};
+
+// The cache that is used by all `Service` operations.
+ServiceCache& getServiceCache();
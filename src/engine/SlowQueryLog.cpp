@@ -0,0 +1,103 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/SlowQueryLog.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <filesystem>
+
+#include "global/Constants.h"
+#include "util/Log.h"
+#include "util/Random.h"
+
+// _____________________________________________________________________________
+auto SlowQueryLog::Settings::fromRuntimeParameters() -> Settings {
+  auto& parameters = RuntimeParameters();
+  return {parameters.get<"slow-query-log-file">(),
+          parameters.get<"slow-query-log-threshold">(),
+          parameters.get<"slow-query-log-sample-rate">(),
+          parameters.get<"slow-query-log-max-file-size">(),
+          parameters.get<"slow-query-log-max-num-files">()};
+}
+
+// _____________________________________________________________________________
+auto SlowQueryLog::shouldLog(const Settings& settings,
+                             std::chrono::milliseconds totalTime)
+    -> std::optional<Reason> {
+  if (settings.file_.empty()) {
+    return std::nullopt;
+  }
+  if (totalTime >= settings.threshold_) {
+    return Reason::Slow;
+  }
+  if (settings.sampleRate_ <= 0) {
+    return std::nullopt;
+  }
+  thread_local ad_utility::RandomDoubleGenerator random{0, 1};
+  if (random() < settings.sampleRate_) {
+    return Reason::Sampled;
+  }
+  return std::nullopt;
+}
+
+// _____________________________________________________________________________
+std::string_view SlowQueryLog::toString(Reason reason) {
+  return reason == Reason::Slow ? "slow" : "sampled";
+}
+
+// _____________________________________________________________________________
+void SlowQueryLog::write(const Settings& settings,
+                         const nlohmann::json& entry) {
+  if (settings.file_.empty()) {
+    return;
+  }
+  std::string line = absl::StrCat(entry.dump(), "\n");
+  auto lock = state_.wlock();
+  auto& state = *lock;
+  try {
+    namespace fs = std::filesystem;
+    auto open = [&state]() {
+      state.file_ = std::ofstream{state.fileName_, std::ios::app};
+      std::error_code error;
+      auto size = fs::file_size(state.fileName_, error);
+      state.fileSize_ = error ? 0 : size;
+    };
+    if (state.fileName_ != settings.file_ || !state.file_.is_open()) {
+      state.fileName_ = settings.file_;
+      open();
+    }
+    // Rotate the files if the current one would become too large (a single
+    // line that is larger than the maximal size is written nevertheless).
+    if (state.fileSize_ > 0 &&
+        state.fileSize_ + line.size() > settings.maxFileSize_.getBytes()) {
+      state.file_.close();
+      auto nameOfFile = [&state](size_t i) {
+        return i == 0 ? state.fileName_ : absl::StrCat(state.fileName_, ".", i);
+      };
+      size_t maxNumFiles = std::max(settings.maxNumFiles_, size_t{1});
+      std::error_code error;
+      fs::remove(nameOfFile(maxNumFiles - 1), error);
+      for (size_t i = maxNumFiles - 1; i > 0; --i) {
+        fs::rename(nameOfFile(i - 1), nameOfFile(i), error);
+      }
+      open();
+    }
+    state.file_ << line;
+    state.file_.flush();
+    if (!state.file_) {
+      throw std::runtime_error{"The write failed"};
+    }
+    state.fileSize_ += line.size();
+  } catch (const std::exception& e) {
+    LOG(WARN) << "Could not write to the slow query log \"" << settings.file_
+              << "\": " << e.what() << std::endl;
+    state.file_ = std::ofstream{};
+  }
+}
+
+// _____________________________________________________________________________
+SlowQueryLog& getSlowQueryLog() {
+  static SlowQueryLog log;
+  return log;
+}
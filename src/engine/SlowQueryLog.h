@@ -0,0 +1,64 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "util/MemorySize/MemorySize.h"
+#include "util/Synchronized.h"
+#include "util/json.h"
+
+// An (opt-in) log of the queries that took longer than a threshold, and of a
+// random sample of the faster ones. Each query is written as a single line of
+// JSON (with the query, its plan, and the complete runtime information, see
+// `Server::processQuery`), s.t. slow queries can be analyzed and reproduced
+// after the fact. When the file becomes larger than a maximal size, it is
+// rotated: The file `<file>` becomes `<file>.1`, `<file>.1` becomes `<file>.2`,
+// and so on, and only a limited number of files is kept.
+//
+// This class is threadsafe.
+class SlowQueryLog {
+ public:
+  struct Settings {
+    // The log is disabled if the `file_` is empty.
+    std::string file_;
+    std::chrono::milliseconds threshold_{1000};
+    // The fraction of the queries below the threshold that are logged.
+    double sampleRate_ = 0;
+    ad_utility::MemorySize maxFileSize_ =
+        ad_utility::MemorySize::megabytes(100);
+    // The number of files including the current one.
+    size_t maxNumFiles_ = 5;
+
+    // The settings from the `slow-query-log-...` runtime parameters.
+    static Settings fromRuntimeParameters();
+  };
+
+  // Why a query is logged.
+  enum class Reason { Slow, Sampled };
+
+ private:
+  struct State {
+    std::string fileName_;
+    std::ofstream file_;
+    size_t fileSize_ = 0;
+  };
+  ad_utility::Synchronized<State> state_;
+
+ public:
+  // Decide whether a query that took `totalTime` is logged.
+  static std::optional<Reason> shouldLog(const Settings& settings,
+                                         std::chrono::milliseconds totalTime);
+  static std::string_view toString(Reason reason);
+
+  // Append the `entry` as a line to the file of the `settings` (and rotate the
+  // file first if necessary). Errors are only logged.
+  void write(const Settings& settings, const nlohmann::json& entry);
+};
+
+// Return the instance that is shared by all queries.
+SlowQueryLog& getSlowQueryLog();
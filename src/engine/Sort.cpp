@@ -9,6 +9,9 @@
 
 #include "CallFixedSize.h"
 #include "QueryExecutionTree.h"
+#include "engine/ExternalSort.h"
+#include "engine/idTable/IdTableSorting.h"
+#include "util/Probes.h"
 
 using std::endl;
 using std::string;
@@ -36,6 +39,27 @@ string Sort::getCacheKeyImpl() const {
   return std::move(os).str();
 }
 
+// _____________________________________________________________________________
+std::vector<std::string> Sort::getPartialCacheKeysImpl() const {
+  std::vector<std::string> keys;
+  std::string prefix = "SORT(internal) on column prefix:";
+  auto subtreeKey = absl::StrCat("\n", subtree_->getCacheKey());
+  for (const auto& sortCol : sortColumnIndices_) {
+    absl::StrAppend(&prefix, "asc(", sortCol, ") ");
+    keys.push_back(absl::StrCat(prefix, subtreeKey));
+  }
+  return keys;
+}
+
+// _____________________________________________________________________________
+std::optional<std::string> Sort::getPartialCacheKeyForLookupImpl() const {
+  auto keys = getPartialCacheKeysImpl();
+  if (keys.empty()) {
+    return std::nullopt;
+  }
+  return std::move(keys.back());
+}
+
 // _____________________________________________________________________________
 string Sort::getDescriptor() const {
   std::string orderByVars;
@@ -52,16 +76,33 @@ string Sort::getDescriptor() const {
 }
 
 // _____________________________________________________________________________
-ResultTable Sort::computeResult() {
+ResultTable Sort::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "Getting sub-result for Sort result computation..." << endl;
-  shared_ptr<const ResultTable> subRes = subtree_->getResult();
+  return sortSubresult(subtree_->getResult(true), requestLaziness);
+}
+
+// _____________________________________________________________________________
+std::optional<ResultTable> Sort::computeResultWithSemiJoinFilter(
+    const Variable& variable, std::span<const Id> values) {
+  auto subRes =
+      subtree_->getRootOperation()->getResultWithSemiJoinFilter(variable,
+                                                                values);
+  if (subRes == nullptr) {
+    return std::nullopt;
+  }
+  return sortSubresult(std::move(subRes), false);
+}
 
+// _____________________________________________________________________________
+ResultTable Sort::sortSubresult(std::shared_ptr<const ResultTable> subRes,
+                                bool requestLaziness) {
   // TODO<joka921> proper timeout for sorting operations
   auto sortEstimateCancellationFactor =
       RuntimeParameters().get<"sort-estimate-cancellation-factor">();
-  if (getExecutionContext()->getSortPerformanceEstimator().estimatedSortTime(
+  if (subRes->isFullyMaterialized() &&
+      getExecutionContext()->getSortPerformanceEstimator().estimatedSortTime(
           subRes->size(), subRes->width()) >
-      remainingTime() * sortEstimateCancellationFactor) {
+          remainingTime() * sortEstimateCancellationFactor) {
     // The estimated time for this sort is much larger than the actually
     // remaining time, cancel this operation
     throw ad_utility::CancellationException(
@@ -71,14 +112,47 @@ ResultTable Sort::computeResult() {
   }
 
   LOG(DEBUG) << "Sort result computation..." << endl;
-  ad_utility::Timer t{ad_utility::timer::Timer::InitialStatus::Started};
-  IdTable idTable = subRes->idTable().clone();
-  runtimeInfo().addDetail("time-cloning", t.msecs());
-  Engine::sort(idTable, sortColumnIndices_);
+  // The sorts check for a cancellation between their steps, s.t. the sort
+  // threads are released soon after a query was cancelled.
+  auto checkCancellation = [this]() { this->checkCancellation(); };
+  auto sortInMemory = [this, &checkCancellation](IdTable& idTable) {
+    Engine::sort(idTable, sortColumnIndices_, checkCancellation);
+  };
+  // The same order as `Engine::sort`, used if the input has to be sorted
+  // externally.
+  auto comparison = [this](const auto& row1, const auto& row2) {
+    for (auto col : sortColumnIndices_) {
+      if (row1[col] != row2[col]) {
+        return row1[col] < row2[col];
+      }
+    }
+    return false;
+  };
+  // A materialized input is typically cached or shared with other operations
+  // (e.g. other `Sort`s of the same subtree on different columns), so it is
+  // sorted into a copy instead of being cloned and then sorted.
+  auto sortedCopy = [this, &checkCancellation](const IdTable& idTable) {
+    return ad_utility::idTableSorting::sortedCopyByColumns(
+        idTable, sortColumnIndices_,
+        getExecutionContext()->getNumThreads(Engine::getNumSortThreads()),
+        checkCancellation);
+  };
+  QLEVER_PROBE(sort_start,
+               subRes->isFullyMaterialized() ? subRes->size() : size_t{0},
+               getResultWidth());
+  auto result = ad_utility::externalSort::sortWithSpilling(
+      std::move(subRes), getResultWidth(), resultSortedOn(), sortInMemory,
+      comparison, getExecutionContext()->getAllocator(), requestLaziness,
+      runtimeInfo(), sortedCopy);
+  QLEVER_PROBE(sort_end,
+               result.isFullyMaterialized() ? result.size() : size_t{0},
+               getResultWidth());
 
-  // Don't report missed timeout check because sort is not cancellable
+  // The single steps of a large sort (e.g. a pass of the radix sort) can take
+  // longer than the interval of the watchdog, don't report them as missed
+  // cancellation checks.
   cancellationHandle_->resetWatchDogState();
 
   LOG(DEBUG) << "Sort result computation done." << endl;
-  return {std::move(idTable), resultSortedOn(), subRes->getSharedLocalVocab()};
+  return result;
 }
@@ -71,7 +71,21 @@ class Sort : public Operation {
   }
 
  private:
-  virtual ResultTable computeResult() override;
+  // Sort the result of the `subtree_`. Inputs that are larger than the
+  // `sort-external-memory-budget` are sorted externally (see
+  // `ExternalSort.h`), the result of such a sort is lazy if `requestLaziness`
+  // is true.
+  virtual ResultTable computeResult(bool requestLaziness) override;
+
+  // Sort the semi-join reduced result of the `subtree_`, which is typically
+  // small enough to be sorted in memory.
+  std::optional<ResultTable> computeResultWithSemiJoinFilter(
+      const Variable& variable, std::span<const Id> values) override;
+
+  // Sort the `subRes` (the complete or the semi-join reduced result of the
+  // `subtree_`), see `computeResult` for details.
+  ResultTable sortSubresult(std::shared_ptr<const ResultTable> subRes,
+                            bool requestLaziness);
 
   [[nodiscard]] VariableToColumnMap computeVariableToColumnMap()
       const override {
@@ -79,4 +93,10 @@ class Sort : public Operation {
   }
 
   string getCacheKeyImpl() const override;
+
+  // A result that is sorted on the `sortColumnIndices_` is also sorted on each
+  // of their prefixes, so it is registered under one partial cache key per
+  // prefix (see `Operation::getPartialCacheKeys`).
+  std::vector<std::string> getPartialCacheKeysImpl() const override;
+  std::optional<std::string> getPartialCacheKeyForLookupImpl() const override;
 };
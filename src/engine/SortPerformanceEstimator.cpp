@@ -5,10 +5,14 @@
 #include "engine/SortPerformanceEstimator.h"
 
 #include <cstdlib>
+#include <fstream>
+#include <thread>
 
-#include "engine/CallFixedSize.h"
+#include "CompilationInfo.h"
+#include "absl/strings/str_cat.h"
 #include "engine/Engine.h"
 #include "engine/idTable/IdTable.h"
+#include "util/Exception.h"
 #include "util/Log.h"
 #include "util/Random.h"
 #include "util/Timer.h"
@@ -43,8 +47,11 @@ auto SortPerformanceEstimator::measureSortingTime(
     const ad_utility::AllocatorWithLimit<Id>& allocator) -> Timer::Duration {
   auto randomTable = createRandomIdTable(numRows, numColumns, allocator);
   ad_utility::Timer timer{ad_utility::Timer::Started};
-  // Always sort on the first column for simplicity;
-  CALL_FIXED_SIZE(numColumns, &Engine::sort, &randomTable, 0ull);
+  // Always sort on the first column for simplicity. This uses the same
+  // kernel and the same number of threads as `Engine::sort`.
+  ad_utility::idTableSorting::sortByColumns(randomTable,
+                                            std::array{ColumnIndex{0}},
+                                            Engine::getNumSortThreads());
   return timer.value();
 }
 
@@ -118,8 +125,8 @@ void SortPerformanceEstimator::computeEstimatesExpensively(
   static_assert(isSorted(sampleValuesRows));
 
   LOG(INFO) << "Sorting random result tables to estimate the sorting "
-               "performance of this machine ..."
-            << std::endl;
+               "performance of this machine (using "
+            << Engine::getNumSortThreads() << " threads) ..." << std::endl;
 
   _samples.fill({});
   for (size_t i = 0; i < NUM_SAMPLES_ROWS; ++i) {
@@ -187,3 +194,85 @@ void SortPerformanceEstimator::computeEstimatesExpensively(
   LOG(DEBUG) << "Done computing sort estimates" << std::endl;
   _estimatesWereCalculated = true;
 }
+
+// _____________________________________________________________________________
+void SortPerformanceEstimator::computeEstimatesOrReadFromFile(
+    const ad_utility::AllocatorWithLimit<Id>& allocator,
+    size_t maxNumberOfElementsToSort, const std::string& filename,
+    bool recompute) {
+  auto fingerprint = computeFingerprint(maxNumberOfElementsToSort);
+  if (!recompute && readFromFile(filename, fingerprint)) {
+    LOG(INFO) << "The estimates of the sorting performance were read from "
+              << filename << std::endl;
+    return;
+  }
+  computeEstimatesExpensively(allocator, maxNumberOfElementsToSort);
+  try {
+    writeToFile(filename, fingerprint);
+  } catch (const std::exception& e) {
+    LOG(WARN) << "The estimates of the sorting performance could not be "
+                 "written to "
+              << filename << ", they will be computed again at the next start: "
+              << e.what() << std::endl;
+  }
+}
+
+// _____________________________________________________________________________
+std::string SortPerformanceEstimator::computeFingerprint(
+    size_t maxNumberOfElementsToSort) {
+  std::string cpuModel = "unknown";
+  std::ifstream cpuInfo{"/proc/cpuinfo"};
+  for (std::string line; std::getline(cpuInfo, line);) {
+    if (line.starts_with("model name")) {
+      cpuModel = line.substr(line.find(':') + 1);
+      break;
+    }
+  }
+  return absl::StrCat("build ", qlever::version::GitHash, ", CPU", cpuModel,
+                      ", ", std::thread::hardware_concurrency(), " threads, ",
+                      Engine::getNumSortThreads(), " sort threads, at most ",
+                      maxNumberOfElementsToSort, " elements");
+}
+
+// _____________________________________________________________________________
+void SortPerformanceEstimator::writeToFile(const std::string& filename,
+                                           std::string_view fingerprint) const {
+  AD_CONTRACT_CHECK(_estimatesWereCalculated);
+  std::ofstream file{filename};
+  file << fingerprint << '\n';
+  for (const auto& samplesOfRow : _samples) {
+    for (const auto& sample : samplesOfRow) {
+      file << sample.count() << ' ';
+    }
+    file << '\n';
+  }
+  file.close();
+  if (!file) {
+    throw std::runtime_error{
+        absl::StrCat("Could not write the file \"", filename, "\"")};
+  }
+}
+
+// _____________________________________________________________________________
+bool SortPerformanceEstimator::readFromFile(const std::string& filename,
+                                            std::string_view fingerprint) {
+  std::ifstream file{filename};
+  std::string fingerprintOfFile;
+  if (!std::getline(file, fingerprintOfFile) ||
+      fingerprintOfFile != fingerprint) {
+    return false;
+  }
+  decltype(_samples) samples;
+  for (auto& samplesOfRow : samples) {
+    for (auto& sample : samplesOfRow) {
+      Timer::Duration::rep count;
+      if (!(file >> count)) {
+        return false;
+      }
+      sample = Timer::Duration{count};
+    }
+  }
+  _samples = samples;
+  _estimatesWereCalculated = true;
+  return true;
+}
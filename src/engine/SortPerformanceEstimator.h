@@ -6,6 +6,8 @@
 #define QLEVER_SORTPERFORMANCEESTIMATOR_H
 
 #include <array>
+#include <string>
+#include <string_view>
 
 #include "global/Id.h"
 #include "util/AllocatorWithLimit.h"
@@ -49,6 +51,30 @@ class SortPerformanceEstimator {
       const ad_utility::AllocatorWithLimit<Id>& allocator,
       size_t maxNumberOfElementsToSort);
 
+  // Read the estimates from the `filename` if it exists and was written for
+  // the same hardware, build, and `maxNumberOfElementsToSort` (see
+  // `computeFingerprint`). Otherwise, or if `recompute` is true, call
+  // `computeEstimatesExpensively` and write the estimates to the `filename`.
+  void computeEstimatesOrReadFromFile(
+      const ad_utility::AllocatorWithLimit<Id>& allocator,
+      size_t maxNumberOfElementsToSort, const std::string& filename,
+      bool recompute);
+
+  // A description of this machine (CPU and number of threads) and of this
+  // build of QLever, together with the `maxNumberOfElementsToSort`. Estimates
+  // that were computed with the same fingerprint can be reused.
+  static std::string computeFingerprint(size_t maxNumberOfElementsToSort);
+
+  // Write the estimates to the `filename`, the first line is the
+  // `fingerprint`. Throw if the file cannot be written.
+  void writeToFile(const std::string& filename,
+                   std::string_view fingerprint) const;
+
+  // Read the estimates from the `filename`. Return false (and leave the
+  // estimates unchanged) if the file doesn't exist, if it has an invalid
+  // format, or if it was written with a different `fingerprint`.
+  bool readFromFile(const std::string& filename, std::string_view fingerprint);
+
  private:
   // The number of columns for which we will sample the sorting time as a base
   // for the estimates. It is crucial that we have values for 5 and 6, because
@@ -0,0 +1,276 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "engine/SpatialJoin.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "engine/ExportQueryExecutionTrees.h"
+#include "index/GeoPoints.h"
+#include "util/Exception.h"
+#include "util/GeoSparqlHelpers.h"
+
+namespace {
+// A point in a row of an input of the `SpatialJoin`.
+struct PointInRow {
+  size_t row_;
+  GeoPoints::Point point_;
+};
+
+// A point of the right input with the cell of the grid in which it lies.
+struct PointInCell {
+  int64_t cellLat_;
+  int64_t cellLng_;
+  PointInRow point_;
+};
+
+// The rows of the `column` that contain a WKT point, together with the point.
+// The points of words in the vocabulary are taken from the precomputed
+// `GeoPoints` of the `index` if there are any, all other points are parsed.
+std::vector<PointInRow> getPoints(const Index& index,
+                                  std::span<const Id> column,
+                                  const LocalVocab& localVocab) {
+  const GeoPoints& geoPoints = index.getGeoPoints();
+  std::vector<PointInRow> result;
+  for (size_t row = 0; row < column.size(); ++row) {
+    Id id = column[row];
+    std::optional<GeoPoints::Point> point;
+    if (id.getDatatype() == Datatype::VocabIndex && !geoPoints.empty()) {
+      point = geoPoints.get(id.getVocabIndex());
+    } else {
+      auto literal = ExportQueryExecutionTrees::idToStringAndType<true, true>(
+          index, id, localVocab);
+      if (literal.has_value()) {
+        point = ad_utility::detail::parseWktPoint(literal->first);
+      }
+    }
+    if (point.has_value() && !std::isnan(point->first) &&
+        !std::isnan(point->second)) {
+      result.push_back({row, point.value()});
+    }
+  }
+  return result;
+}
+
+// The index of the cell of the grid with the `cellSize` (in degrees) that
+// contains the `coordinate`. The clamping avoids overflows for huge
+// coordinates and cell ranges.
+int64_t getCell(double coordinate, double cellSize) {
+  static constexpr double maxCell = 1e15;
+  return static_cast<int64_t>(
+      std::clamp(std::floor(coordinate / cellSize), -maxCell, maxCell));
+}
+}  // namespace
+
+// _____________________________________________________________________________
+SpatialJoin::SpatialJoin(QueryExecutionContext* qec,
+                         std::shared_ptr<QueryExecutionTree> left,
+                         std::shared_ptr<QueryExecutionTree> right,
+                         const Variable& leftVariable,
+                         const Variable& rightVariable, double maxDistance,
+                         bool includeMaxDistance)
+    : Operation{qec},
+      left_{std::move(left)},
+      right_{std::move(right)},
+      leftColumn_{left_->getVariableColumn(leftVariable)},
+      rightColumn_{right_->getVariableColumn(rightVariable)},
+      maxDistance_{maxDistance},
+      includeMaxDistance_{includeMaxDistance} {
+  AD_CONTRACT_CHECK(
+      QueryExecutionTree::getJoinColumns(*left_, *right_).empty());
+}
+
+// _____________________________________________________________________________
+string SpatialJoin::getCacheKeyImpl() const {
+  std::ostringstream os;
+  os.precision(17);
+  os << "SPATIAL JOIN\n"
+     << left_->getCacheKey() << " column: [" << leftColumn_ << "]\n";
+  os << right_->getCacheKey() << " column: [" << rightColumn_ << "]\n";
+  os << "max-distance: " << maxDistance_
+     << (includeMaxDistance_ ? " inclusive" : " exclusive");
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string SpatialJoin::getDescriptor() const {
+  std::ostringstream os;
+  os << "Spatial join "
+     << left_->getVariableAndInfoByColumnIndex(leftColumn_).first.name()
+     << " - "
+     << right_->getVariableAndInfoByColumnIndex(rightColumn_).first.name()
+     << " within " << maxDistance_ << " km";
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+size_t SpatialJoin::getResultWidth() const {
+  return left_->getResultWidth() + right_->getResultWidth();
+}
+
+// _____________________________________________________________________________
+vector<ColumnIndex> SpatialJoin::resultSortedOn() const {
+  // The rows of the result are in the order of the rows of the left input.
+  return left_->resultSortedOn();
+}
+
+// _____________________________________________________________________________
+VariableToColumnMap SpatialJoin::computeVariableToColumnMap() const {
+  // The columns of the right input follow the columns of the left input (see
+  // `CartesianProductJoin::computeVariableToColumnMap`).
+  VariableToColumnMap result = left_->getVariableColumns();
+  for (auto varCol : right_->getVariableColumns()) {
+    varCol.second.columnIndex_ += left_->getResultWidth();
+    result.insert(std::move(varCol));
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+float SpatialJoin::getMultiplicity(size_t col) {
+  size_t leftWidth = left_->getResultWidth();
+  return col < leftWidth ? left_->getMultiplicity(col)
+                         : right_->getMultiplicity(col - leftWidth);
+}
+
+// _____________________________________________________________________________
+uint64_t SpatialJoin::getSizeEstimateBeforeLimit() {
+  // There are no statistics about the locations of the points, so assume that
+  // each point of the larger input has about one point within the distance.
+  uint64_t leftSize = left_->getSizeEstimate();
+  uint64_t rightSize = right_->getSizeEstimate();
+  if (leftSize == 0 || rightSize == 0) {
+    return 0;
+  }
+  return std::max(leftSize, rightSize);
+}
+
+// _____________________________________________________________________________
+size_t SpatialJoin::getCostEstimate() {
+  size_t costEstimate = left_->getSizeEstimate() + right_->getSizeEstimate() +
+                        getSizeEstimateBeforeLimit();
+  return left_->getCostEstimate() + right_->getCostEstimate() + costEstimate;
+}
+
+// _____________________________________________________________________________
+std::vector<std::pair<size_t, size_t>> SpatialJoin::computeMatchingRows(
+    const ResultTable& left, const ResultTable& right) const {
+  std::vector<std::pair<size_t, size_t>> result;
+  // A NaN or negative distance never matches (like the FILTER).
+  if (!(maxDistance_ >= 0)) {
+    return result;
+  }
+  const Index& index = getIndex();
+  auto leftPoints = getPoints(index, left.idTable().getColumn(leftColumn_),
+                              left.localVocab());
+  auto rightPoints = getPoints(index, right.idTable().getColumn(rightColumn_),
+                               right.localVocab());
+  checkCancellation();
+
+  // A degree of latitude is at least 110.5 km long, so the latitudes of two
+  // points within the distance differ by at most `maxDeltaLat`. The cells of
+  // the grid are squares with this size, sorted by rows of the same latitude.
+  double maxDeltaLat = maxDistance_ / 110.0;
+  double cellSize = std::max(maxDeltaLat, 1e-6);
+  std::vector<PointInCell> grid;
+  grid.reserve(rightPoints.size());
+  for (const auto& point : rightPoints) {
+    grid.push_back({getCell(point.point_.second, cellSize),
+                    getCell(point.point_.first, cellSize), point});
+  }
+  auto getKey = [](const PointInCell& p) {
+    return std::tuple{p.cellLat_, p.cellLng_, p.point_.row_};
+  };
+  std::ranges::sort(grid, std::less{}, getKey);
+  auto getCellKey = [](const PointInCell& p) {
+    return std::pair{p.cellLat_, p.cellLng_};
+  };
+
+  auto isMatch = [this](GeoPoints::Point a, GeoPoints::Point b) {
+    double distance = ad_utility::detail::distanceImpl(a, b);
+    return includeMaxDistance_ ? distance <= maxDistance_
+                               : distance < maxDistance_;
+  };
+  static constexpr int64_t minLng = std::numeric_limits<int64_t>::min();
+  static constexpr int64_t maxLng = std::numeric_limits<int64_t>::max();
+  for (const auto& [leftRow, leftPoint] : leftPoints) {
+    checkCancellation();
+    auto [lng, lat] = leftPoint;
+    // The length of a degree of longitude is at least `minLengthLng` km for
+    // all points within `maxDeltaLat` of `lat`. Close to the poles, all
+    // longitudes have to be checked.
+    double maxAbsLat = std::abs(lat) + maxDeltaLat;
+    double minLengthLng =
+        maxAbsLat >= 90.0
+            ? 0.0
+            : 111.3 * std::cos(maxAbsLat * std::numbers::pi / 180.0) - 0.1;
+    bool checkAllLng = minLengthLng <= maxDistance_ / 360.0;
+    double maxDeltaLng = checkAllLng ? 0.0 : maxDistance_ / minLengthLng;
+    int64_t lngBegin =
+        checkAllLng ? minLng : getCell(lng - maxDeltaLng, cellSize);
+    int64_t lngEnd =
+        checkAllLng ? maxLng : getCell(lng + maxDeltaLng, cellSize);
+    int64_t latEnd = getCell(lat + maxDeltaLat, cellSize);
+
+    // Visit the rows of the grid that contain points and lie between the
+    // minimal and the maximal latitude, and in each row, the cells between
+    // the minimal and the maximal longitude.
+    auto rowBegin = std::ranges::lower_bound(
+        grid, std::pair{getCell(lat - maxDeltaLat, cellSize), minLng},
+        std::less{}, getCellKey);
+    while (rowBegin != grid.end() && rowBegin->cellLat_ <= latEnd) {
+      int64_t cellLat = rowBegin->cellLat_;
+      auto cellsBegin =
+          std::ranges::lower_bound(rowBegin, grid.end(),
+                                   std::pair{cellLat, lngBegin}, std::less{},
+                                   getCellKey);
+      auto cellsEnd = std::ranges::upper_bound(
+          cellsBegin, grid.end(), std::pair{cellLat, lngEnd}, std::less{},
+          getCellKey);
+      for (auto it = cellsBegin; it != cellsEnd; ++it) {
+        if (isMatch(leftPoint, it->point_.point_)) {
+          result.emplace_back(leftRow, it->point_.row_);
+        }
+      }
+      rowBegin = std::ranges::upper_bound(cellsEnd, grid.end(),
+                                          std::pair{cellLat, maxLng},
+                                          std::less{}, getCellKey);
+    }
+  }
+  // The matches of each left row are sorted by the right row, like the result
+  // of the `CartesianProductJoin` with a FILTER.
+  std::ranges::sort(result);
+  return result;
+}
+
+// _____________________________________________________________________________
+ResultTable SpatialJoin::computeResult([[maybe_unused]] bool requestLaziness) {
+  auto childResults = getChildResults(std::array{left_, right_});
+  const ResultTable& left = *childResults[0];
+  const ResultTable& right = *childResults[1];
+  auto matches = computeMatchingRows(left, right);
+  runtimeInfo().addDetail("num-matches", matches.size());
+
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  result.resize(matches.size());
+  size_t leftWidth = left.idTable().numColumns();
+  for (size_t col = 0; col < leftWidth; ++col) {
+    std::ranges::transform(
+        matches, result.getColumn(col).begin(),
+        [column = left.idTable().getColumn(col)](const auto& match) {
+          return column[match.first];
+        });
+  }
+  for (size_t col = 0; col < right.idTable().numColumns(); ++col) {
+    std::ranges::transform(
+        matches, result.getColumn(leftWidth + col).begin(),
+        [column = right.idTable().getColumn(col)](const auto& match) {
+          return column[match.second];
+        });
+  }
+  checkCancellation();
+  return {std::move(result), resultSortedOn(),
+          ResultTable::getSharedLocalVocabFromNonEmptyOf(left, right)};
+}
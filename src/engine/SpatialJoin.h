@@ -0,0 +1,81 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <memory>
+
+#include "engine/Operation.h"
+#include "engine/QueryExecutionTree.h"
+
+// A join of two inputs without shared variables on the condition that the
+// distance between the WKT point in one column of the left input and the WKT
+// point in one column of the right input (see `ad_utility::wktDist`) is less
+// than (or equal to) a maximal distance. This is the result of a
+// `CartesianProductJoin` of the inputs with a FILTER like
+// `FILTER(geof:distance(?a, ?b) < 10)`, but instead of checking all pairs of
+// rows, the points of the right input are put into a grid with cells the size
+// of the maximal distance, and for each point of the left input, only the
+// points of the cells in the vicinity are checked. The result has the columns
+// of the left input, followed by the columns of the right input, and the rows
+// are in the order of the rows of the left input.
+class SpatialJoin : public Operation {
+ private:
+  std::shared_ptr<QueryExecutionTree> left_;
+  std::shared_ptr<QueryExecutionTree> right_;
+  ColumnIndex leftColumn_;
+  ColumnIndex rightColumn_;
+  // The maximal distance in km.
+  double maxDistance_;
+  // True iff pairs with exactly the `maxDistance_` are part of the result.
+  bool includeMaxDistance_;
+
+ public:
+  SpatialJoin(QueryExecutionContext* qec,
+              std::shared_ptr<QueryExecutionTree> left,
+              std::shared_ptr<QueryExecutionTree> right,
+              const Variable& leftVariable, const Variable& rightVariable,
+              double maxDistance, bool includeMaxDistance);
+
+ protected:
+  string getCacheKeyImpl() const override;
+
+ public:
+  string getDescriptor() const override;
+
+  size_t getResultWidth() const override;
+
+  vector<ColumnIndex> resultSortedOn() const override;
+
+  void setTextLimit(size_t limit) override {
+    left_->setTextLimit(limit);
+    right_->setTextLimit(limit);
+  }
+
+  bool knownEmptyResult() override {
+    return left_->knownEmptyResult() || right_->knownEmptyResult();
+  }
+
+  float getMultiplicity(size_t col) override;
+
+ private:
+  uint64_t getSizeEstimateBeforeLimit() override;
+
+ public:
+  size_t getCostEstimate() override;
+
+  vector<QueryExecutionTree*> getChildren() override {
+    return {left_.get(), right_.get()};
+  }
+
+ private:
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
+
+  VariableToColumnMap computeVariableToColumnMap() const override;
+
+  // The pairs of the row indices of the `left` and the `right` result, the
+  // points in the join columns of which are within the maximal distance,
+  // sorted by the left row index.
+  std::vector<std::pair<size_t, size_t>> computeMatchingRows(
+      const ResultTable& left, const ResultTable& right) const;
+};
@@ -14,18 +14,7 @@ TextIndexScanForEntity::TextIndexScanForEntity(
       word_(std::move(word)) {}
 
 // _____________________________________________________________________________
-ResultTable TextIndexScanForEntity::computeResult() {
-  IdTable idTable = getExecutionContext()->getIndex().getEntityMentionsForWord(
-      word_, getExecutionContext()->getAllocator());
-
-  if (hasFixedEntity()) {
-    auto beginErase = std::ranges::remove_if(idTable, [this](const auto& row) {
-      return row[1].getVocabIndex() != getVocabIndexOfFixedEntity();
-    });
-    idTable.erase(beginErase.begin(), idTable.end());
-    idTable.setColumnSubset(std::vector<ColumnIndex>{0, 2});
-  }
-
+ResultTable TextIndexScanForEntity::computeResult(bool requestLaziness) {
   // Add details to the runtimeInfo. This is has no effect on the result.
   if (hasFixedEntity()) {
     runtimeInfo().addDetail("fixed entity: ", fixedEntity());
@@ -34,9 +23,43 @@ ResultTable TextIndexScanForEntity::computeResult() {
   }
   runtimeInfo().addDetail("word: ", word_);
 
+  if (requestLaziness) {
+    return {computeResultLazily(), resultSortedOn()};
+  }
+  IdTable idTable = getExecutionContext()->getIndex().getEntityMentionsForWord(
+      word_, getExecutionContext()->getAllocator());
+  filterFixedEntity(idTable);
   return {std::move(idTable), resultSortedOn(), LocalVocab{}};
 }
 
+// _____________________________________________________________________________
+void TextIndexScanForEntity::filterFixedEntity(IdTable& idTable) const {
+  if (!hasFixedEntity()) {
+    return;
+  }
+  auto beginErase = std::ranges::remove_if(idTable, [this](const auto& row) {
+    return row[1].getVocabIndex() != getVocabIndexOfFixedEntity();
+  });
+  idTable.erase(beginErase.begin(), idTable.end());
+  idTable.setColumnSubset(std::vector<ColumnIndex>{0, 2});
+}
+
+// _____________________________________________________________________________
+ResultTable::Generator TextIndexScanForEntity::computeResultLazily() const {
+  size_t numBlocks = 0;
+  for (IdTable& idTable :
+       getExecutionContext()->getIndex().getEntityMentionsForWordLazily(
+           word_, getExecutionContext()->getAllocator())) {
+    ++numBlocks;
+    filterFixedEntity(idTable);
+    if (idTable.empty()) {
+      continue;
+    }
+    co_yield ResultTable::IdTableVocabPair{std::move(idTable), LocalVocab{}};
+  }
+  runtimeInfo().addDetail("num-blocks-read", numBlocks);
+}
+
 // _____________________________________________________________________________
 VariableToColumnMap TextIndexScanForEntity::computeVariableToColumnMap() const {
   VariableToColumnMap vcmap;
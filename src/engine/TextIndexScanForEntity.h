@@ -105,7 +105,18 @@ class TextIndexScanForEntity : public Operation {
     return std::get<FixedEntity>(varOrFixed_.entity_).second;
   }
 
-  ResultTable computeResult() override;
+  // If `requestLaziness` is true, the result is computed lazily (see
+  // `computeResultLazily`).
+  ResultTable computeResult(bool requestLaziness) override;
+
+  // Yield the result in blocks that are read one after the other from the text
+  // index, s.t. a `LIMIT` on this operation only reads the first blocks.
+  ResultTable::Generator computeResultLazily() const;
+
+  // Remove the rows of the `idTable` (with the columns text record, entity,
+  // and score) that don't contain the fixed entity, and then the entity
+  // column. Does nothing if the entity is a variable.
+  void filterFixedEntity(IdTable& idTable) const;
 
   vector<QueryExecutionTree*> getChildren() override { return {}; }
 };
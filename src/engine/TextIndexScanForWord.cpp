@@ -13,7 +13,10 @@ TextIndexScanForWord::TextIndexScanForWord(QueryExecutionContext* qec,
       isPrefix_(word_.ends_with('*')) {}
 
 // _____________________________________________________________________________
-ResultTable TextIndexScanForWord::computeResult() {
+ResultTable TextIndexScanForWord::computeResult(bool requestLaziness) {
+  if (requestLaziness) {
+    return {computeResultLazily(), resultSortedOn()};
+  }
   IdTable idTable = getExecutionContext()->getIndex().getWordPostingsForTerm(
       word_, getExecutionContext()->getAllocator());
 
@@ -32,6 +35,21 @@ ResultTable TextIndexScanForWord::computeResult() {
   return {std::move(idTable), resultSortedOn(), LocalVocab{}};
 }
 
+// _____________________________________________________________________________
+ResultTable::Generator TextIndexScanForWord::computeResultLazily() const {
+  size_t numBlocks = 0;
+  for (IdTable& idTable :
+       getExecutionContext()->getIndex().getWordPostingsForTermLazily(
+           word_, getExecutionContext()->getAllocator())) {
+    ++numBlocks;
+    if (!isPrefix_) {
+      idTable.setColumnSubset(std::vector<ColumnIndex>{0});
+    }
+    co_yield ResultTable::IdTableVocabPair{std::move(idTable), LocalVocab{}};
+  }
+  runtimeInfo().addDetail("num-blocks-read", numBlocks);
+}
+
 // _____________________________________________________________________________
 VariableToColumnMap TextIndexScanForWord::computeVariableToColumnMap() const {
   VariableToColumnMap vcmap;
@@ -53,8 +53,14 @@ class TextIndexScanForWord : public Operation {
 
  private:
   // Returns a ResultTable containing an IdTable with the columns being
-  // the text variable and the completed word (if it was prefixed)
-  ResultTable computeResult() override;
+  // the text variable and the completed word (if it was prefixed). If
+  // `requestLaziness` is true, the result is computed lazily (see
+  // `computeResultLazily`).
+  ResultTable computeResult(bool requestLaziness) override;
+
+  // Yield the result in blocks that are read one after the other from the text
+  // index, s.t. a `LIMIT` on this operation only reads the first blocks.
+  ResultTable::Generator computeResultLazily() const;
 
   vector<QueryExecutionTree*> getChildren() override { return {}; }
 };
@@ -105,7 +105,8 @@ string TextOperationWithFilter::getDescriptor() const {
 }
 
 // _____________________________________________________________________________
-ResultTable TextOperationWithFilter::computeResult() {
+ResultTable TextOperationWithFilter::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
   LOG(DEBUG) << "TextOperationWithFilter result computation..." << endl;
   AD_CONTRACT_CHECK(getNofVars() >= 1);
   IdTable idTable{getExecutionContext()->getAllocator()};
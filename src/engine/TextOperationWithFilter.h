@@ -94,7 +94,8 @@ class TextOperationWithFilter : public Operation {
  private:
   void computeMultiplicities();
 
-  virtual ResultTable computeResult() override;
+  virtual ResultTable computeResult(
+      [[maybe_unused]] bool requestLaziness) override;
 
   virtual VariableToColumnMap computeVariableToColumnMap() const override;
 };
@@ -88,7 +88,8 @@ string TextOperationWithoutFilter::getDescriptor() const {
 }
 
 // _____________________________________________________________________________
-ResultTable TextOperationWithoutFilter::computeResult() {
+ResultTable TextOperationWithoutFilter::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
   LOG(DEBUG) << "TextOperationWithoutFilter result computation..." << endl;
   IdTable table{getExecutionContext()->getAllocator()};
   if (getNofVars() == 0) {
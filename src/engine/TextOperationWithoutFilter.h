@@ -85,7 +85,7 @@ class TextOperationWithoutFilter : public Operation {
  private:
   void computeMultiplicities();
 
-  ResultTable computeResult() override;
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
 
   void computeResultNoVar(IdTable* idTable) const;
 
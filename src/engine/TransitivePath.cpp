@@ -5,11 +5,14 @@
 #include "TransitivePath.h"
 
 #include <limits>
+#include <numeric>
 
-#include "engine/CallFixedSize.h"
 #include "engine/ExportQueryExecutionTrees.h"
 #include "engine/IndexScan.h"
+#include "engine/Sort.h"
+#include "global/Constants.h"
 #include "util/Exception.h"
+#include "util/ParallelExecution.h"
 
 // _____________________________________________________________________________
 TransitivePath::TransitivePath(QueryExecutionContext* qec,
@@ -136,6 +139,24 @@ float TransitivePath::getMultiplicity(size_t col) {
 
 // _____________________________________________________________________________
 uint64_t TransitivePath::getSizeEstimateBeforeLimit() {
+  if (!lhs_.isBoundVariable() && !rhs_.isBoundVariable()) {
+    // The precomputed closure gives the exact size.
+    if (const auto* closure = getPrecomputedClosure(lhs_)) {
+      const auto* reverseClosure = getPrecomputedClosure(rhs_);
+      uint64_t identity = minDist_ == 0 ? 1 : 0;
+      if (!lhs_.isVariable() && !rhs_.isVariable()) {
+        return 1;
+      } else if (!lhs_.isVariable()) {
+        return closure->reachableFrom(std::get<Id>(lhs_.value_)).size() +
+               identity;
+      } else if (!rhs_.isVariable()) {
+        return reverseClosure->reachableFrom(std::get<Id>(rhs_.value_))
+                   .size() +
+               identity;
+      }
+      return closure->numPairs();
+    }
+  }
   if (std::holds_alternative<Id>(lhs_.value_) ||
       std::holds_alternative<Id>(rhs_.value_)) {
     // If the subject or object is fixed, assume that the number of matching
@@ -171,9 +192,11 @@ size_t TransitivePath::getCostEstimate() {
   // We assume that the cost of computing the transitive path is proportional to
   // the result size.
   auto costEstimate = getSizeEstimateBeforeLimit();
-  // Add the cost for the index scan of the predicate involved.
+  // Add the cost for the index scan of the predicate involved (unless the
+  // precomputed closure is used) and for the bound sides.
+  bool usePrecomputedClosure = getPrecomputedClosure(lhs_) != nullptr;
   for (auto* ptr : getChildren()) {
-    if (ptr) {
+    if (ptr && !(usePrecomputedClosure && ptr == subtree_.get())) {
       costEstimate += ptr->getCostEstimate();
     }
   }
@@ -181,79 +204,57 @@ size_t TransitivePath::getCostEstimate() {
 }
 
 // _____________________________________________________________________________
-template <size_t RES_WIDTH, size_t SUB_WIDTH, size_t SIDE_WIDTH>
 void TransitivePath::computeTransitivePathBound(
-    IdTable* dynRes, const IdTable& dynSub, const TransitivePathSide& startSide,
+    IdTable* res, const IdTable& sub, const TransitivePathSide& startSide,
     const TransitivePathSide& targetSide, const IdTable& startSideTable) const {
-  IdTableStatic<RES_WIDTH> res = std::move(*dynRes).toStatic<RES_WIDTH>();
+  std::vector<Id> nodes = setupStartNodes(startSide, startSideTable);
+  Hull hull = computeHull(sub, startSide, targetSide, nodes);
 
-  auto [edges, nodes] = setupMapAndNodes<SUB_WIDTH, SIDE_WIDTH>(
-      dynSub, startSide, targetSide, startSideTable);
-
-  Map hull(allocator());
-  if (!targetSide.isVariable()) {
-    hull = transitiveHull(edges, nodes, std::get<Id>(targetSide.value_));
-  } else {
-    hull = transitiveHull(edges, nodes, std::nullopt);
-  }
-
-  TransitivePath::fillTableWithHull<RES_WIDTH, SIDE_WIDTH>(
-      res, hull, nodes, startSide.outputCol_, targetSide.outputCol_,
+  TransitivePath::fillTableWithHull(
+      *res, hull, nodes, startSide.outputCol_, targetSide.outputCol_,
       startSideTable, startSide.treeAndCol_.value().second);
-
-  *dynRes = std::move(res).toDynamic();
 }
 
 // _____________________________________________________________________________
-template <size_t RES_WIDTH, size_t SUB_WIDTH>
 void TransitivePath::computeTransitivePath(
-    IdTable* dynRes, const IdTable& dynSub, const TransitivePathSide& startSide,
+    IdTable* res, const IdTable& sub, const TransitivePathSide& startSide,
     const TransitivePathSide& targetSide) const {
-  IdTableStatic<RES_WIDTH> res = std::move(*dynRes).toStatic<RES_WIDTH>();
+  std::vector<Id> nodes = setupStartNodes(sub, startSide, targetSide);
+  Hull hull = computeHull(sub, startSide, targetSide, nodes);
 
-  auto [edges, nodes] =
-      setupMapAndNodes<SUB_WIDTH>(dynSub, startSide, targetSide);
-
-  Map hull{allocator()};
-  if (!targetSide.isVariable()) {
-    hull = transitiveHull(edges, nodes, std::get<Id>(targetSide.value_));
-  } else {
-    hull = transitiveHull(edges, nodes, std::nullopt);
-  }
-
-  TransitivePath::fillTableWithHull<RES_WIDTH>(res, hull, startSide.outputCol_,
-                                               targetSide.outputCol_);
-
-  *dynRes = std::move(res).toDynamic();
+  TransitivePath::fillTableWithHull(*res, hull, startSide.outputCol_,
+                                    targetSide.outputCol_);
 }
 
 // _____________________________________________________________________________
-ResultTable TransitivePath::computeResult() {
+ResultTable TransitivePath::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
   if (minDist_ == 0 && !isBoundOrId() && lhs_.isVariable() &&
       rhs_.isVariable()) {
     AD_THROW(
         "This query might have to evalute the empty path, which is currently "
         "not supported");
   }
-  shared_ptr<const ResultTable> subRes = subtree_->getResult();
+  // If the precomputed closure is used, the subtree is not needed.
+  shared_ptr<const ResultTable> subRes =
+      getPrecomputedClosure(lhs_) != nullptr
+          ? std::make_shared<const ResultTable>(
+                IdTable{subtree_->getResultWidth(), allocator()},
+                std::vector<ColumnIndex>{}, LocalVocab{})
+          : subtree_->getResult();
 
   IdTable idTable{allocator()};
 
   idTable.setNumColumns(getResultWidth());
 
-  size_t subWidth = subRes->idTable().numColumns();
-
-  auto computeForOneSide = [this, &idTable, subRes, subWidth](
-                               auto& boundSide,
-                               auto& otherSide) -> ResultTable {
+  auto computeForOneSide = [this, &idTable, subRes](auto& boundSide,
+                                                    auto& otherSide)
+      -> ResultTable {
     shared_ptr<const ResultTable> sideRes =
         boundSide.treeAndCol_.value().first->getResult();
-    size_t sideWidth = sideRes->idTable().numColumns();
 
-    CALL_FIXED_SIZE((std::array{resultWidth_, subWidth, sideWidth}),
-                    &TransitivePath::computeTransitivePathBound, this, &idTable,
-                    subRes->idTable(), boundSide, otherSide,
-                    sideRes->idTable());
+    computeTransitivePathBound(&idTable, subRes->idTable(), boundSide,
+                               otherSide, sideRes->idTable());
 
     return {std::move(idTable), resultSortedOn(),
             ResultTable::getSharedLocalVocabFromNonEmptyOf(*sideRes, *subRes)};
@@ -265,15 +266,11 @@ ResultTable TransitivePath::computeResult() {
     return computeForOneSide(rhs_, lhs_);
     // Right side is an Id
   } else if (!rhs_.isVariable()) {
-    CALL_FIXED_SIZE((std::array{resultWidth_, subWidth}),
-                    &TransitivePath::computeTransitivePath, this, &idTable,
-                    subRes->idTable(), rhs_, lhs_);
+    computeTransitivePath(&idTable, subRes->idTable(), rhs_, lhs_);
     // No side is a bound variable, the right side is an unbound variable
     // and the left side is either an unbound Variable or an ID.
   } else {
-    CALL_FIXED_SIZE((std::array{resultWidth_, subWidth}),
-                    &TransitivePath::computeTransitivePath, this, &idTable,
-                    subRes->idTable(), lhs_, rhs_);
+    computeTransitivePath(&idTable, subRes->idTable(), lhs_, rhs_);
   }
 
   // NOTE: The only place, where the input to a transitive path operation is not
@@ -342,223 +339,556 @@ bool TransitivePath::isBoundOrId() const {
 }
 
 // _____________________________________________________________________________
-TransitivePath::Map TransitivePath::transitiveHull(
-    const Map& edges, const std::vector<Id>& startNodes,
+TransitivePath::Edges TransitivePath::Edges::fromSortedPairs(
+    const Vector<std::pair<Id, Id>>& pairs) {
+  Edges result{pairs.get_allocator()};
+  result.successors_.reserve(pairs.size());
+  for (const auto& [node, successor] : pairs) {
+    if (result.nodes_.empty() || result.nodes_.back() != node) {
+      if (!result.nodes_.empty()) {
+        result.offsets_.push_back(result.successors_.size());
+      }
+      result.nodes_.push_back(node);
+    }
+    result.successors_.push_back(successor);
+  }
+  if (!result.nodes_.empty()) {
+    result.offsets_.push_back(result.successors_.size());
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+TransitivePath::Edges TransitivePath::Edges::reversed() const {
+  Vector<std::pair<Id, Id>> reversedEdges{nodes_.get_allocator()};
+  reversedEdges.reserve(successors_.size());
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    for (Id successor : successorsAt(i)) {
+      reversedEdges.emplace_back(successor, nodes_[i]);
+    }
+  }
+  std::ranges::sort(reversedEdges);
+  return fromSortedPairs(reversedEdges);
+}
+
+// _____________________________________________________________________________
+TransitivePath::Hull TransitivePath::transitiveHull(
+    const Edges& edges, const std::vector<Id>& startNodes,
     std::optional<Id> target) const {
-  using MapIt = Map::const_iterator;
-  // For every node do a dfs on the graph
-  Map hull{allocator()};
+  // Each start node is processed only once.
+  std::vector<Id> distinctStartNodes = startNodes;
+  std::ranges::sort(distinctStartNodes);
+  auto [eraseBegin, eraseEnd] = std::ranges::unique(distinctStartNodes);
+  distinctStartNodes.erase(eraseBegin, eraseEnd);
+
+  Hull hull{allocator()};
+  ad_utility::HashSetWithMemoryLimit<Id> marks{allocator()};
+  if (target.has_value() && distinctStartNodes.size() > 1) {
+    // All the start nodes have the same target, so a single search backwards
+    // from the target finds all the start nodes from which the target can be
+    // reached (with the same restrictions of the path length).
+    auto reachingNodes =
+        reachableNodes(edges.reversed(), target.value(), std::nullopt, marks);
+    std::ranges::sort(reachingNodes);
+    std::span<const Id> targetAsSpan{&target.value(), 1};
+    for (Id node : distinctStartNodes) {
+      if (std::ranges::binary_search(reachingNodes, node)) {
+        hull.append(node, targetAsSpan);
+      }
+    }
+    return hull;
+  }
 
-  // Stores nodes we already have a path to. This avoids cycles.
-  ad_utility::HashSetWithMemoryLimit<Id> marks{
-      getExecutionContext()->getAllocator()};
+  if (!target.has_value() && minDist_ <= 1 &&
+      maxDist_ == std::numeric_limits<size_t>::max() &&
+      distinctStartNodes.size() >=
+          RuntimeParameters()
+              .get<"transitive-path-min-start-nodes-for-condensation">()) {
+    return condensedTransitiveHull(edges, distinctStartNodes);
+  }
 
-  // The stack used to store the dfs' progress
-  std::vector<Set::const_iterator> positions;
+  // The hulls of the start nodes are independent of each other, so they are
+  // computed concurrently. The (sorted) start nodes are split into blocks, and
+  // each thread repeatedly takes the next block and computes its hull. The
+  // hulls of the blocks are concatenated at the end.
+  static constexpr size_t minNumStartNodesPerThread = 100;
+  static constexpr size_t numStartNodesPerBlock = 64;
+  const size_t maxNumThreads =
+      std::max(size_t{1},
+               getExecutionContext()->getNumThreads(
+                   RuntimeParameters().get<"transitive-path-num-threads">()));
+  const size_t numThreads =
+      std::clamp(distinctStartNodes.size() / minNumStartNodesPerThread,
+                 size_t{1}, maxNumThreads);
+  const size_t numBlocks =
+      (distinctStartNodes.size() + numStartNodesPerBlock - 1) /
+      numStartNodesPerBlock;
+  std::vector<Hull> blockHulls(numBlocks, Hull{allocator()});
+  std::atomic<size_t> nextBlock = 0;
+  ad_utility::runConcurrently(numThreads, [&](size_t) {
+    ad_utility::HashSetWithMemoryLimit<Id> threadMarks{allocator()};
+    for (size_t block = nextBlock++; block < numBlocks; block = nextBlock++) {
+      size_t begin = block * numStartNodesPerBlock;
+      size_t end =
+          std::min(begin + numStartNodesPerBlock, distinctStartNodes.size());
+      for (size_t i = begin; i < end; ++i) {
+        Id startNode = distinctStartNodes[i];
+        blockHulls[block].append(
+            startNode, reachableNodes(edges, startNode, target, threadMarks));
+      }
+    }
+  });
+  if (numBlocks == 1) {
+    return std::move(blockHulls.front());
+  }
+  size_t numReachable = 0;
+  for (const Hull& blockHull : blockHulls) {
+    numReachable += blockHull.successors_.size();
+  }
+  hull.successors_.reserve(numReachable);
+  for (const Hull& blockHull : blockHulls) {
+    for (size_t i = 0; i < blockHull.nodes_.size(); ++i) {
+      hull.append(blockHull.nodes_[i], blockHull.successorsAt(i));
+    }
+  }
+  return hull;
+}
 
-  // Used to store all edges leading away from a node for every level.
-  // Reduces access to the hashmap, and is safe as the map will not
-  // be modified after this point.
-  std::vector<const Set*> edgeCache;
+// _____________________________________________________________________________
+TransitivePath::Hull TransitivePath::condensedTransitiveHull(
+    const Edges& edges, const std::vector<Id>& distinctStartNodes) const {
+  // Number the nodes of the graph densely in the order of their IDs and
+  // convert the edges to these numbers.
+  Edges::Vector<Id> nodes{edges.successors_.begin(),
+                          edges.successors_.end(), allocator()};
+  nodes.insert(nodes.end(), edges.nodes_.begin(), edges.nodes_.end());
+  std::ranges::sort(nodes);
+  auto [eraseBegin, eraseEnd] = std::ranges::unique(nodes);
+  nodes.erase(eraseBegin, eraseEnd);
+  const size_t numNodes = nodes.size();
+  auto numberOf = [&nodes](Id node) -> size_t {
+    return std::ranges::lower_bound(nodes, node) - nodes.begin();
+  };
+  Edges::Vector<size_t> offsets(numNodes + 1, 0, allocator());
+  Edges::Vector<size_t> successors{allocator()};
+  successors.reserve(edges.successors_.size());
+  for (size_t node = 0, i = 0; node < numNodes; ++node) {
+    if (i < edges.nodes_.size() && edges.nodes_[i] == nodes[node]) {
+      for (Id successor : edges.successorsAt(i)) {
+        successors.push_back(numberOf(successor));
+      }
+      ++i;
+    }
+    offsets[node + 1] = successors.size();
+  }
+  checkCancellation();
+
+  // Tarjan's algorithm, with an explicit stack instead of recursion. The SCCs
+  // are numbered in the order in which they are completed, s.t. an SCC only
+  // reaches SCCs with smaller numbers.
+  static constexpr size_t unvisited = std::numeric_limits<size_t>::max();
+  Edges::Vector<size_t> visitIndex(numNodes, unvisited, allocator());
+  Edges::Vector<size_t> lowLink(numNodes, 0, allocator());
+  Edges::Vector<size_t> component(numNodes, unvisited, allocator());
+  // The visited nodes that are not yet assigned to an SCC.
+  std::vector<size_t> openNodes;
+  // The nodes of the current path of the depth-first search, each with the
+  // position of its next successor.
+  std::vector<std::pair<size_t, size_t>> path;
+  size_t numVisited = 0;
+  size_t numComponents = 0;
+  auto visit = [&](size_t node) {
+    visitIndex[node] = lowLink[node] = numVisited++;
+    openNodes.push_back(node);
+    path.emplace_back(node, offsets[node]);
+  };
+  for (size_t root = 0; root < numNodes; ++root) {
+    if (visitIndex[root] != unvisited) {
+      continue;
+    }
+    checkCancellation();
+    visit(root);
+    while (!path.empty()) {
+      auto [node, position] = path.back();
+      if (position < offsets[node + 1]) {
+        ++path.back().second;
+        size_t successor = successors[position];
+        if (visitIndex[successor] == unvisited) {
+          visit(successor);
+        } else if (component[successor] == unvisited) {
+          lowLink[node] = std::min(lowLink[node], visitIndex[successor]);
+        }
+        continue;
+      }
+      path.pop_back();
+      if (!path.empty()) {
+        size_t parent = path.back().first;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+      }
+      if (lowLink[node] == visitIndex[node]) {
+        size_t member;
+        do {
+          member = openNodes.back();
+          openNodes.pop_back();
+          component[member] = numComponents;
+        } while (member != node);
+        ++numComponents;
+      }
+    }
+  }
+  runtimeInfo().addDetail("num-strongly-connected-components", numComponents);
+
+  // The nodes of each SCC (sorted), and the SCCs that contain a cycle (more
+  // than one node or an edge from a node to itself), the nodes of which reach
+  // themselves.
+  Edges::Vector<size_t> memberOffsets(numComponents + 1, 0, allocator());
+  for (size_t node = 0; node < numNodes; ++node) {
+    ++memberOffsets[component[node] + 1];
+  }
+  std::partial_sum(memberOffsets.begin(), memberOffsets.end(),
+                   memberOffsets.begin());
+  Edges::Vector<Id> members(numNodes, Id::makeUndefined(), allocator());
+  {
+    Edges::Vector<size_t> nextMember{memberOffsets.begin(),
+                                     memberOffsets.end() - 1, allocator()};
+    for (size_t node = 0; node < numNodes; ++node) {
+      members[nextMember[component[node]]++] = nodes[node];
+    }
+  }
+  std::vector<bool> isCyclic(numComponents, false);
+  // The edges between different SCCs, sorted and unique.
+  Edges::Vector<std::pair<size_t, size_t>> componentEdges{allocator()};
+  for (size_t node = 0; node < numNodes; ++node) {
+    size_t from = component[node];
+    for (size_t i = offsets[node]; i < offsets[node + 1]; ++i) {
+      size_t to = component[successors[i]];
+      if (to == from) {
+        isCyclic[from] = true;
+      } else {
+        componentEdges.emplace_back(from, to);
+      }
+    }
+    if (memberOffsets[from + 1] - memberOffsets[from] > 1) {
+      isCyclic[from] = true;
+    }
+  }
+  std::ranges::sort(componentEdges);
+  auto [edgesBegin, edgesEnd] = std::ranges::unique(componentEdges);
+  componentEdges.erase(edgesBegin, edgesEnd);
+  checkCancellation();
+
+  // The SCCs that are reachable from each SCC via a path of length at least
+  // one, in the same format as the `Edges`. The successors of an SCC have
+  // smaller numbers, so their reachable SCCs are already known.
+  Edges::Vector<size_t> reachableOffsets(1, 0, allocator());
+  reachableOffsets.reserve(numComponents + 1);
+  Edges::Vector<size_t> reachable{allocator()};
+  std::vector<size_t> current;
+  auto edgeIt = componentEdges.begin();
+  for (size_t c = 0; c < numComponents; ++c) {
+    if (c % 1'000 == 0) {
+      checkCancellation();
+    }
+    current.clear();
+    if (isCyclic[c]) {
+      current.push_back(c);
+    }
+    for (; edgeIt != componentEdges.end() && edgeIt->first == c; ++edgeIt) {
+      size_t to = edgeIt->second;
+      current.push_back(to);
+      current.insert(current.end(), reachable.begin() + reachableOffsets[to],
+                     reachable.begin() + reachableOffsets[to + 1]);
+    }
+    std::ranges::sort(current);
+    auto [currentBegin, currentEnd] = std::ranges::unique(current);
+    current.erase(currentBegin, currentEnd);
+    reachable.insert(reachable.end(), current.begin(), current.end());
+    reachableOffsets.push_back(reachable.size());
+  }
 
-  for (Id currentStartNode : startNodes) {
-    if (hull.contains(currentStartNode)) {
-      // We have already computed the hull for this node
+  // Expand the reachable SCCs of the SCC of each start node to their nodes.
+  Hull hull{allocator()};
+  Edges::Vector<Id> nodesOfHull{allocator()};
+  for (Id startNode : distinctStartNodes) {
+    checkCancellation();
+    nodesOfHull.clear();
+    size_t node = numberOf(startNode);
+    if (node == numNodes || nodes[node] != startNode) {
+      // A node without edges only reaches itself via the empty path.
+      if (minDist_ == 0) {
+        nodesOfHull.push_back(startNode);
+      }
+      hull.append(startNode, nodesOfHull);
       continue;
     }
+    size_t c = component[node];
+    for (size_t i = reachableOffsets[c]; i < reachableOffsets[c + 1]; ++i) {
+      size_t to = reachable[i];
+      nodesOfHull.insert(nodesOfHull.end(),
+                            members.begin() + memberOffsets[to],
+                            members.begin() + memberOffsets[to + 1]);
+    }
+    if (minDist_ == 0 && !isCyclic[c]) {
+      nodesOfHull.push_back(startNode);
+    }
+    hull.append(startNode, nodesOfHull);
+  }
+  return hull;
+}
 
-    // Reset for this iteration
-    marks.clear();
+// _____________________________________________________________________________
+TransitivePath::Edges::Vector<Id> TransitivePath::reachableNodes(
+    const Edges& edges, Id startNode, std::optional<Id> target,
+    ad_utility::HashSetWithMemoryLimit<Id>& marks) const {
+  Edges::Vector<Id> result{allocator()};
+  // Stores the nodes that were reached via a path of length at least
+  // `minDist_`. Their successors need not be visited again, which avoids
+  // cycles. Nodes that are reached via shorter paths are not marked, because
+  // they might also be reached via a path with a valid length later.
+  marks.clear();
+  auto addToResult = [&](Id node) {
+    if (!target.has_value() || node == target.value()) {
+      result.push_back(node);
+    }
+  };
+  if (minDist_ == 0) {
+    marks.insert(startNode);
+    addToResult(startNode);
+  }
 
-    MapIt rootEdges = edges.find(currentStartNode);
-    if (rootEdges != edges.end()) {
-      positions.push_back(rootEdges->second.begin());
-      edgeCache.push_back(&rootEdges->second);
+  // The nodes that are reached via a path of length `depth - 1` (and, if
+  // `depth - 1 >= minDist_`, not before).
+  std::vector<Id> frontier{startNode};
+  std::vector<Id> nextFrontier;
+  for (size_t depth = 1; depth <= maxDist_ && !frontier.empty(); ++depth) {
+    checkCancellation();
+    nextFrontier.clear();
+    for (Id node : frontier) {
+      for (Id child : edges.successors(node)) {
+        if (depth < minDist_) {
+          nextFrontier.push_back(child);
+        } else if (marks.insert(child).second) {
+          addToResult(child);
+          nextFrontier.push_back(child);
+        }
+      }
+    }
+    if (depth < minDist_) {
+      std::ranges::sort(nextFrontier);
+      auto [eraseBegin, eraseEnd] = std::ranges::unique(nextFrontier);
+      nextFrontier.erase(eraseBegin, eraseEnd);
     }
-    if (minDist_ == 0 &&
-        (!target.has_value() || currentStartNode == target.value())) {
-      insertIntoMap(hull, currentStartNode, currentStartNode);
+    if (target.has_value() && !result.empty()) {
+      // The only node of interest was found.
+      break;
     }
+    std::swap(frontier, nextFrontier);
+  }
+  return result;
+}
 
-    // While we have not found the entire transitive hull and have not reached
-    // the max step limit
-    while (!positions.empty()) {
-      checkCancellation();
-      size_t stackIndex = positions.size() - 1;
-      // Process the next child of the node at the top of the stack
-      Set::const_iterator& pos = positions[stackIndex];
-      const Set* nodeEdges = edgeCache.back();
-
-      if (pos == nodeEdges->end()) {
-        // We finished processing this node
-        positions.pop_back();
-        edgeCache.pop_back();
-        continue;
-      }
+// _____________________________________________________________________________
+const TransitiveClosure::Direction* TransitivePath::getPrecomputedClosure(
+    const TransitivePathSide& startSide) const {
+  if (minDist_ > 1 || maxDist_ != std::numeric_limits<size_t>::max() ||
+      subtree_ == nullptr) {
+    return nullptr;
+  }
+  // The `subtree_` might be sorted by the constructor.
+  auto root = subtree_->getRootOperation();
+  if (std::dynamic_pointer_cast<Sort>(root) != nullptr) {
+    root = root->getChildren().at(0)->getRootOperation();
+  }
+  auto scan = std::dynamic_pointer_cast<IndexScan>(root);
+  if (scan == nullptr || !scan->getSubject().isVariable() ||
+      !scan->getObject().isVariable() || scan->getPredicate().isVariable() ||
+      scan->getSubject() == scan->getObject() || scan->hasDeltaTriples()) {
+    return nullptr;
+  }
+  auto predicate = scan->getPredicate().toValueId(getIndex().getVocab());
+  if (!predicate.has_value()) {
+    return nullptr;
+  }
+  const auto* closure = getIndex().getTransitiveClosures().get(*predicate);
+  if (closure == nullptr) {
+    return nullptr;
+  }
+  auto subjectColumn =
+      subtree_->getVariableColumn(scan->getSubject().getVariable());
+  return startSide.subCol_ == subjectColumn ? &closure->forward_
+                                            : &closure->backward_;
+}
 
-      Id child = *pos;
-      ++pos;
-      size_t childDepth = positions.size();
-      if (childDepth <= maxDist_ && marks.count(child) == 0) {
-        // process the child
-        if (childDepth >= minDist_) {
-          marks.insert(child);
-          if (!target.has_value() || child == target.value()) {
-            insertIntoMap(hull, currentStartNode, child);
-          }
-        }
-        // Add the child to the stack
-        MapIt it = edges.find(child);
-        if (it != edges.end()) {
-          positions.push_back(it->second.begin());
-          edgeCache.push_back(&it->second);
-        }
+// _____________________________________________________________________________
+TransitivePath::Hull TransitivePath::hullFromClosure(
+    const TransitiveClosure::Direction& closure,
+    const std::vector<Id>& startNodes, std::optional<Id> target) const {
+  std::vector<Id> distinctStartNodes = startNodes;
+  std::ranges::sort(distinctStartNodes);
+  auto [eraseBegin, eraseEnd] = std::ranges::unique(distinctStartNodes);
+  distinctStartNodes.erase(eraseBegin, eraseEnd);
+
+  Hull hull{allocator()};
+  Edges::Vector<Id> reachable{allocator()};
+  for (Id node : distinctStartNodes) {
+    checkCancellation();
+    auto reachableFromNode = closure.reachableFrom(node);
+    bool containsNode = std::ranges::binary_search(reachableFromNode, node);
+    if (target.has_value()) {
+      if ((minDist_ == 0 && node == target.value()) ||
+          std::ranges::binary_search(reachableFromNode, target.value())) {
+        hull.append(node, std::span<const Id>{&target.value(), 1});
       }
+    } else if (minDist_ > 0 || containsNode) {
+      hull.append(node, reachableFromNode);
+    } else {
+      // The empty path from the `node` to itself is also part of the result.
+      reachable.assign(reachableFromNode.begin(), reachableFromNode.end());
+      reachable.push_back(node);
+      hull.append(node, reachable);
     }
   }
   return hull;
 }
 
 // _____________________________________________________________________________
-template <size_t WIDTH, size_t START_WIDTH>
-void TransitivePath::fillTableWithHull(IdTableStatic<WIDTH>& table,
-                                       const Map& hull, std::vector<Id>& nodes,
+void TransitivePath::fillTableWithHull(IdTable& table, const Hull& hull,
+                                       std::vector<Id>& nodes,
                                        size_t startSideCol,
                                        size_t targetSideCol,
                                        const IdTable& startSideTable,
                                        size_t skipCol) {
-  IdTableView<START_WIDTH> startView =
-      startSideTable.asStaticView<START_WIDTH>();
-
-  size_t rowIndex = 0;
+  // First determine the size of the result and the ranges of its rows that
+  // belong to each of the `nodes`, s.t. all columns can be written
+  // sequentially, one at a time.
+  std::vector<size_t> offsets;
+  offsets.reserve(nodes.size() + 1);
+  offsets.push_back(0);
+  for (Id node : nodes) {
+    offsets.push_back(offsets.back() + hull.successors(node).size());
+  }
+  table.resize(offsets.back());
+  auto startColumn = table.getColumn(startSideCol);
+  auto targetColumn = table.getColumn(targetSideCol);
   for (size_t i = 0; i < nodes.size(); i++) {
-    Id node = nodes[i];
-    auto it = hull.find(node);
-    if (it == hull.end()) {
+    std::fill(startColumn.begin() + offsets[i],
+              startColumn.begin() + offsets[i + 1], nodes[i]);
+    std::ranges::copy(hull.successors(nodes[i]),
+                      targetColumn.begin() + offsets[i]);
+  }
+
+  // Copy the other columns of the start side.
+  size_t outCol = 2;
+  for (size_t inCol = 0;
+       inCol < startSideTable.numColumns() && outCol < table.numColumns();
+       ++inCol) {
+    if (inCol == skipCol) {
       continue;
     }
-
-    for (Id otherNode : it->second) {
-      table.emplace_back();
-      table(rowIndex, startSideCol) = node;
-      table(rowIndex, targetSideCol) = otherNode;
-
-      TransitivePath::copyColumns<START_WIDTH, WIDTH>(startView, table, i,
-                                                      rowIndex, skipCol);
-
-      rowIndex++;
+    auto input = startSideTable.getColumn(inCol);
+    auto output = table.getColumn(outCol);
+    for (size_t i = 0; i < nodes.size(); i++) {
+      std::fill(output.begin() + offsets[i], output.begin() + offsets[i + 1],
+                input[i]);
     }
+    outCol++;
   }
 }
 
 // _____________________________________________________________________________
-template <size_t WIDTH>
-void TransitivePath::fillTableWithHull(IdTableStatic<WIDTH>& table,
-                                       const Map& hull, size_t startSideCol,
+void TransitivePath::fillTableWithHull(IdTable& table, const Hull& hull,
+                                       size_t startSideCol,
                                        size_t targetSideCol) {
-  size_t rowIndex = 0;
-  for (auto const& [node, linkedNodes] : hull) {
-    for (Id linkedNode : linkedNodes) {
-      table.emplace_back();
-      table(rowIndex, startSideCol) = node;
-      table(rowIndex, targetSideCol) = linkedNode;
-
-      rowIndex++;
-    }
+  table.resize(hull.successors_.size());
+  auto startColumn = table.getColumn(startSideCol);
+  for (size_t i = 0; i < hull.nodes_.size(); ++i) {
+    std::fill(startColumn.begin() + hull.offsets_[i],
+              startColumn.begin() + hull.offsets_[i + 1], hull.nodes_[i]);
   }
+  std::ranges::copy(hull.successors_, table.getColumn(targetSideCol).begin());
 }
 
 // _____________________________________________________________________________
-template <size_t SUB_WIDTH, size_t SIDE_WIDTH>
-std::pair<TransitivePath::Map, std::vector<Id>>
-TransitivePath::setupMapAndNodes(const IdTable& sub,
-                                 const TransitivePathSide& startSide,
-                                 const TransitivePathSide& targetSide,
-                                 const IdTable& startSideTable) const {
-  std::vector<Id> nodes;
-  Map edges = setupEdgesMap<SUB_WIDTH>(sub, startSide, targetSide);
-
+std::vector<Id> TransitivePath::setupStartNodes(
+    const TransitivePathSide& startSide, const IdTable& startSideTable) const {
   // Bound -> var|id
-  std::span<const Id> startNodes = setupNodes<SIDE_WIDTH>(
+  std::span<const Id> startNodes = setupNodes(
       startSideTable, startSide.treeAndCol_.value().second);
-  nodes.insert(nodes.end(), startNodes.begin(), startNodes.end());
-
-  return {std::move(edges), std::move(nodes)};
+  return {startNodes.begin(), startNodes.end()};
 }
 
 // _____________________________________________________________________________
-template <size_t SUB_WIDTH>
-std::pair<TransitivePath::Map, std::vector<Id>>
-TransitivePath::setupMapAndNodes(const IdTable& sub,
-                                 const TransitivePathSide& startSide,
-                                 const TransitivePathSide& targetSide) const {
+std::vector<Id> TransitivePath::setupStartNodes(
+    const IdTable& sub, const TransitivePathSide& startSide,
+    const TransitivePathSide& targetSide) const {
   std::vector<Id> nodes;
-  Map edges = setupEdgesMap<SUB_WIDTH>(sub, startSide, targetSide);
-
   // id -> var|id
   if (!startSide.isVariable()) {
     nodes.push_back(std::get<Id>(startSide.value_));
+  } else if (const auto* closure = getPrecomputedClosure(startSide)) {
+    // var -> var with a precomputed closure, the `sub` was not computed. Note
+    // that an empty path is not possible in this case.
+    AD_CORRECTNESS_CHECK(minDist_ > 0);
+    nodes.assign(closure->nodes_.begin(), closure->nodes_.end());
     // var -> var
   } else {
     std::span<const Id> startNodes =
-        setupNodes<SUB_WIDTH>(sub, startSide.subCol_);
+        setupNodes(sub, startSide.subCol_);
     nodes.insert(nodes.end(), startNodes.begin(), startNodes.end());
     if (minDist_ == 0) {
       std::span<const Id> targetNodes =
-          setupNodes<SUB_WIDTH>(sub, targetSide.subCol_);
+          setupNodes(sub, targetSide.subCol_);
       nodes.insert(nodes.end(), targetNodes.begin(), targetNodes.end());
     }
   }
+  return nodes;
+}
 
-  return {std::move(edges), std::move(nodes)};
+// _____________________________________________________________________________
+TransitivePath::Hull TransitivePath::computeHull(
+    const IdTable& sub, const TransitivePathSide& startSide,
+    const TransitivePathSide& targetSide,
+    const std::vector<Id>& startNodes) const {
+  std::optional<Id> target;
+  if (!targetSide.isVariable()) {
+    target = std::get<Id>(targetSide.value_);
+  }
+  if (const auto* closure = getPrecomputedClosure(startSide)) {
+    return hullFromClosure(*closure, startNodes, target);
+  }
+  Edges edges = setupEdges(sub, startSide, targetSide);
+  return transitiveHull(edges, startNodes, target);
 }
 
 // _____________________________________________________________________________
-template <size_t SUB_WIDTH>
-TransitivePath::Map TransitivePath::setupEdgesMap(
-    const IdTable& dynSub, const TransitivePathSide& startSide,
+TransitivePath::Edges TransitivePath::setupEdges(
+    const IdTable& sub, const TransitivePathSide& startSide,
     const TransitivePathSide& targetSide) const {
-  const IdTableView<SUB_WIDTH> sub = dynSub.asStaticView<SUB_WIDTH>();
-  Map edges{allocator()};
-  decltype(auto) startCol = sub.getColumn(startSide.subCol_);
-  decltype(auto) targetCol = sub.getColumn(targetSide.subCol_);
-
+  std::span<const Id> startCol = sub.getColumn(startSide.subCol_);
+  std::span<const Id> targetCol = sub.getColumn(targetSide.subCol_);
+
+  // Sort the edges by their start node (the subtree is sorted on its first
+  // column, which is the start side for one of the two directions) and
+  // remove duplicates.
+  Edges::Vector<std::pair<Id, Id>> sortedEdges{allocator()};
+  sortedEdges.reserve(sub.size());
   for (size_t i = 0; i < sub.size(); i++) {
-    checkCancellation();
-    insertIntoMap(edges, startCol[i], targetCol[i]);
+    sortedEdges.emplace_back(startCol[i], targetCol[i]);
+  }
+  checkCancellation();
+  if (!std::ranges::is_sorted(sortedEdges)) {
+    std::ranges::sort(sortedEdges);
   }
-  return edges;
+  checkCancellation();
+  auto [eraseBegin, eraseEnd] = std::ranges::unique(sortedEdges);
+  sortedEdges.erase(eraseBegin, eraseEnd);
+
+  return Edges::fromSortedPairs(sortedEdges);
 }
 
 // _____________________________________________________________________________
-template <size_t WIDTH>
 std::span<const Id> TransitivePath::setupNodes(const IdTable& table,
                                                size_t col) {
   return table.getColumn(col);
 }
 
-// _____________________________________________________________________________
-template <size_t INPUT_WIDTH, size_t OUTPUT_WIDTH>
-void TransitivePath::copyColumns(const IdTableView<INPUT_WIDTH>& inputTable,
-                                 IdTableStatic<OUTPUT_WIDTH>& outputTable,
-                                 size_t inputRow, size_t outputRow,
-                                 size_t skipCol) {
-  size_t inCol = 0;
-  size_t outCol = 2;
-  while (inCol < inputTable.numColumns() && outCol < outputTable.numColumns()) {
-    if (skipCol == inCol) {
-      inCol++;
-      continue;
-    }
-
-    outputTable(outputRow, outCol) = inputTable(inputRow, inCol);
-    inCol++;
-    outCol++;
-  }
-}
-
-// _____________________________________________________________________________
-void TransitivePath::insertIntoMap(Map& map, Id key, Id value) const {
-  auto [it, success] = map.try_emplace(key, allocator());
-  it->second.insert(value);
-}
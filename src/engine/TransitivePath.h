@@ -9,6 +9,7 @@
 #include "engine/Operation.h"
 #include "engine/QueryExecutionTree.h"
 #include "engine/idTable/IdTable.h"
+#include "index/TransitiveClosures.h"
 
 using TreeAndCol = std::pair<std::shared_ptr<QueryExecutionTree>, size_t>;
 struct TransitivePathSide {
@@ -57,16 +58,66 @@ struct TransitivePathSide {
 };
 
 class TransitivePath : public Operation {
-  // We deliberately use the `std::` variants of a hash set and hash map because
-  // `absl`s types are not exception safe.
-  constexpr static auto hash = [](Id id) {
-    return std::hash<uint64_t>{}(id.getBits());
+  // The edges of the graph in compressed sparse row (CSR) format: The
+  // successors of `nodes_[i]` are `successors_[offsets_[i]]` to
+  // `successors_[offsets_[i + 1] - 1]`. The `nodes_` are sorted, s.t. the
+  // successors of a node can be found via binary search. Compared to a hash
+  // map of hash sets, this needs much less memory and the successors of a node
+  // are contiguous in memory. The edges are never modified after their
+  // creation, so they can be read by several threads concurrently.
+  struct Edges {
+    template <typename T>
+    using Vector = std::vector<T, ad_utility::AllocatorWithLimit<T>>;
+    Vector<Id> nodes_;
+    Vector<size_t> offsets_;
+    Vector<Id> successors_;
+
+    explicit Edges(const ad_utility::AllocatorWithLimit<Id>& allocator)
+        : nodes_{allocator},
+          offsets_(1, 0, allocator),
+          successors_{allocator} {}
+
+    // Return the successors of the `node` (empty if it has no outgoing edges).
+    std::span<const Id> successors(Id node) const {
+      auto it = std::ranges::lower_bound(nodes_, node);
+      if (it == nodes_.end() || *it != node) {
+        return {};
+      }
+      return successorsAt(it - nodes_.begin());
+    }
+
+    // Return the successors of `nodes_[i]`.
+    std::span<const Id> successorsAt(size_t i) const {
+      return {successors_.begin() + offsets_[i],
+              successors_.begin() + offsets_[i + 1]};
+    }
+
+    // Add the `node` with the given `successors`. The `node` must be larger
+    // than all the previously added nodes. Nodes without successors are
+    // skipped.
+    void append(Id node, std::span<const Id> successors) {
+      if (successors.empty()) {
+        return;
+      }
+      AD_CORRECTNESS_CHECK(nodes_.empty() || nodes_.back() < node);
+      nodes_.push_back(node);
+      successors_.insert(successors_.end(), successors.begin(),
+                         successors.end());
+      offsets_.push_back(successors_.size());
+    }
+
+    // Create the edges from the `pairs` of a node and one of its successors,
+    // which must be sorted and unique.
+    static Edges fromSortedPairs(const Vector<std::pair<Id, Id>>& pairs);
+
+    // Return the edges with the opposite direction.
+    Edges reversed() const;
   };
-  using Set = std::unordered_set<Id, decltype(hash), std::equal_to<Id>,
-                                 ad_utility::AllocatorWithLimit<Id>>;
-  using Map = std::unordered_map<
-      Id, Set, decltype(hash), std::equal_to<Id>,
-      ad_utility::AllocatorWithLimit<std::pair<const Id, Set>>>;
+
+  // The transitive hull maps each start node to the nodes that can be reached
+  // from it (the successors) and has the same format as the edges. The result
+  // table can thus be written column by column.
+  using Hull = Edges;
 
   std::shared_ptr<QueryExecutionTree> subtree_;
   TransitivePathSide lhs_;
@@ -154,16 +205,12 @@ class TransitivePath : public Operation {
    * it is a variable. The other IdTable contains the result
    * of the start side and will be used to get the start nodes.
    *
-   * @tparam RES_WIDTH Number of columns of the result table
-   * @tparam SUB_WIDTH Number of columns of the sub table
-   * @tparam SIDE_WIDTH Number of columns of the
    * @param res The result table which will be filled in-place
    * @param sub The IdTable for the sub result
    * @param startSide The start side for the transitive hull
    * @param targetSide The target side for the transitive hull
    * @param startSideTable The IdTable of the startSide
    */
-  template <size_t RES_WIDTH, size_t SUB_WIDTH, size_t SIDE_WIDTH>
   void computeTransitivePathBound(IdTable* res, const IdTable& sub,
                                   const TransitivePathSide& startSide,
                                   const TransitivePathSide& targetSide,
@@ -173,14 +220,11 @@ class TransitivePath : public Operation {
    * @brief Compute the transitive hull.
    * This function is called when no side is bound (or an id).
    *
-   * @tparam RES_WIDTH Number of columns of the result table
-   * @tparam SUB_WIDTH Number of columns of the sub table
    * @param res The result table which will be filled in-place
    * @param sub The IdTable for the sub result
    * @param startSide The start side for the transitive hull
    * @param targetSide The target side for the transitive hull
    */
-  template <size_t RES_WIDTH, size_t SUB_WIDTH>
   void computeTransitivePath(IdTable* res, const IdTable& sub,
                              const TransitivePathSide& startSide,
                              const TransitivePathSide& targetSide) const;
@@ -195,7 +239,8 @@ class TransitivePath : public Operation {
    *
    * @return ResultTable The result of the TransitivePath operation
    */
-  virtual ResultTable computeResult() override;
+  virtual ResultTable computeResult(
+      [[maybe_unused]] bool requestLaziness) override;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 
@@ -207,27 +252,82 @@ class TransitivePath : public Operation {
 
   /**
    * @brief Compute the transitive hull starting at the given nodes,
-   * using the given Map.
+   * using the given edges. The hulls of different start nodes are computed
+   * concurrently.
    *
-   * @param edges Adjacency lists, mapping Ids (nodes) to their connected
-   * Ids.
+   * @param edges The edges of the graph.
    * @param nodes A list of Ids. These Ids are used as starting points for the
    * transitive hull. Thus, this parameter guides the performance of this
    * algorithm.
    * @param target Optional target Id. If supplied, only paths which end
-   * in this Id are added to the hull.
-   * @return Map Maps each Id to its connected Ids in the transitive hull
+   * in this Id are added to the hull. For more than one start node, the hull
+   * is then computed backwards from the target.
+   * @return Hull Maps each Id to its connected Ids in the transitive hull
    */
-  Map transitiveHull(const Map& edges, const std::vector<Id>& startNodes,
+  Hull transitiveHull(const Edges& edges, const std::vector<Id>& startNodes,
                      std::optional<Id> target) const;
 
+  /**
+   * @brief Compute the transitive hull of the `distinctStartNodes` (sorted and
+   * unique) for paths of unrestricted length (`maxDist_` is unbounded and
+   * `minDist_` is at most one) via the condensation of the graph.
+   *
+   * All the nodes of a strongly connected component (SCC) reach the same
+   * nodes. The SCCs are computed once via Tarjan's algorithm, and the
+   * reachable SCCs of each SCC are computed on the (acyclic) graph of the
+   * SCCs, in which each SCC is processed after the SCCs that it reaches.
+   * The reachable SCCs are only expanded to their nodes when the hull of a
+   * start node is written. Compared to a search from each start node, this
+   * avoids traversing large SCCs (e.g. cycles) again for each of their nodes.
+   */
+  Hull condensedTransitiveHull(const Edges& edges,
+                               const std::vector<Id>& distinctStartNodes) const;
+
+  /**
+   * @brief Return the precomputed closure of the index that can be used
+   * instead of a graph search.
+   *
+   * This is the case if the `subtree_` is a scan `?x <p> ?y` of a predicate
+   * for which the index has a transitive closure (see `TransitiveClosures`),
+   * and the paths have a minimal length of at most one and no maximal length.
+   * Then the `subtree_` does not have to be computed.
+   *
+   * @param startSide The side where the paths start, which determines the
+   * direction of the closure.
+   * @return The closure or `nullptr` if it cannot be used.
+   */
+  const TransitiveClosure::Direction* getPrecomputedClosure(
+      const TransitivePathSide& startSide) const;
+
+  /**
+   * @brief Compute the transitive hull starting at the given nodes from the
+   * precomputed `closure` (see `getPrecomputedClosure`).
+   */
+  Hull hullFromClosure(const TransitiveClosure::Direction& closure,
+                       const std::vector<Id>& startNodes,
+                       std::optional<Id> target) const;
+
+  /**
+   * @brief Compute the nodes that are reachable from the `startNode` via a
+   * path with a length in `[minDist_, maxDist_]` via a breadth-first search.
+   *
+   * @param edges The edges of the graph.
+   * @param startNode The start node of the search.
+   * @param target Optional target Id. If supplied, only this Id is added to
+   * the result (if it is reachable), and the search stops once it is found.
+   * @param marks Used to store the already visited nodes. It is passed in
+   * only to reuse its memory.
+   * @return The reachable nodes (unsorted).
+   */
+  Edges::Vector<Id> reachableNodes(
+      const Edges& edges, Id startNode, std::optional<Id> target,
+      ad_utility::HashSetWithMemoryLimit<Id>& marks) const;
+
   /**
    * @brief Fill the given table with the transitive hull and use the
    * startSideTable to fill in the rest of the columns.
    * This function is called if the start side is bound and a variable.
    *
-   * @tparam WIDTH The number of columns of the result table.
-   * @tparam START_WIDTH The number of columns of the start table.
    * @param table The result table which will be filled.
    * @param hull The transitive hull.
    * @param nodes The start nodes of the transitive hull. These need to be in
@@ -241,8 +341,7 @@ class TransitivePath : public Operation {
    * @param skipCol This column contains the Ids of the start side in the
    * startSideTable and will be skipped.
    */
-  template <size_t WIDTH, size_t START_WIDTH>
-  static void fillTableWithHull(IdTableStatic<WIDTH>& table, const Map& hull,
+  static void fillTableWithHull(IdTable& table, const Hull& hull,
                                 std::vector<Id>& nodes, size_t startSideCol,
                                 size_t targetSideCol,
                                 const IdTable& startSideTable, size_t skipCol);
@@ -251,7 +350,6 @@ class TransitivePath : public Operation {
    * @brief Fill the given table with the transitive hull.
    * This function is called if the sides are unbound or ids.
    *
-   * @tparam WIDTH The number of columns of the result table.
    * @param table The result table which will be filled.
    * @param hull The transitive hull.
    * @param startSideCol The column of the result table for the startSide of the
@@ -259,62 +357,51 @@ class TransitivePath : public Operation {
    * @param targetSideCol The column of the result table for the targetSide of
    * the hull
    */
-  template <size_t WIDTH>
-  static void fillTableWithHull(IdTableStatic<WIDTH>& table, const Map& hull,
+  static void fillTableWithHull(IdTable& table, const Hull& hull,
                                 size_t startSideCol, size_t targetSideCol);
 
   /**
-   * @brief Prepare a Map and a nodes vector for the transitive hull
-   * computation.
+   * @brief Prepare the start nodes for the transitive hull computation.
+   *
+   * @param startSide The TransitivePathSide where the edges start
+   * @param startSideTable An IdTable containing the Ids for the startSide
+   * @return std::vector<Id> The start nodes for the transitive hull
+   * computation in the same order as in the startSideTable
+   */
+  std::vector<Id> setupStartNodes(const TransitivePathSide& startSide,
+                                  const IdTable& startSideTable) const;
+
+  /**
+   * @brief Prepare the start nodes for the transitive hull computation.
    *
-   * @tparam SUB_WIDTH Number of columns of the sub table
-   * @tparam SIDE_WIDTH Number of columns of the startSideTable
    * @param sub The sub table result
    * @param startSide The TransitivePathSide where the edges start
    * @param targetSide The TransitivePathSide where the edges end
-   * @param startSideTable An IdTable containing the Ids for the startSide
-   * @return std::pair<Map, std::vector<Id>> A Map and Id vector (nodes) for the
-   * transitive hull computation
+   * @return std::vector<Id> The start nodes for the transitive hull
+   * computation
    */
-  template <size_t SUB_WIDTH, size_t SIDE_WIDTH>
-  std::pair<Map, std::vector<Id>> setupMapAndNodes(
-      const IdTable& sub, const TransitivePathSide& startSide,
-      const TransitivePathSide& targetSide,
-      const IdTable& startSideTable) const;
+  std::vector<Id> setupStartNodes(const IdTable& sub,
+                                  const TransitivePathSide& startSide,
+                                  const TransitivePathSide& targetSide) const;
 
   /**
-   * @brief Prepare a Map and a nodes vector for the transitive hull
-   * computation.
+   * @brief Compute the transitive hull for the `startNodes`, either from the
+   * precomputed closure of the index or from the edges of the `sub` table.
    *
-   * @tparam SUB_WIDTH Number of columns of the sub table
    * @param sub The sub table result
    * @param startSide The TransitivePathSide where the edges start
    * @param targetSide The TransitivePathSide where the edges end
-   * @return std::pair<Map, std::vector<Id>> A Map and Id vector (nodes) for the
-   * transitive hull computation
+   * @param startNodes The start nodes for the transitive hull
+   * @return Hull Maps each Id to its connected Ids in the transitive hull
    */
-  template <size_t SUB_WIDTH>
-  std::pair<Map, std::vector<Id>> setupMapAndNodes(
-      const IdTable& sub, const TransitivePathSide& startSide,
-      const TransitivePathSide& targetSide) const;
+  Hull computeHull(const IdTable& sub, const TransitivePathSide& startSide,
+                   const TransitivePathSide& targetSide,
+                   const std::vector<Id>& startNodes) const;
 
-  // initialize the map from the subresult
-  template <size_t SUB_WIDTH>
-  Map setupEdgesMap(const IdTable& dynSub, const TransitivePathSide& startSide,
-                    const TransitivePathSide& targetSide) const;
+  // initialize the edges from the subresult
+  Edges setupEdges(const IdTable& dynSub, const TransitivePathSide& startSide,
+                   const TransitivePathSide& targetSide) const;
 
   // initialize a vector for the starting nodes (Ids)
-  template <size_t WIDTH>
   static std::span<const Id> setupNodes(const IdTable& table, size_t col);
-
-  // Copy the columns from the input table to the output table
-  template <size_t INPUT_WIDTH, size_t OUTPUT_WIDTH>
-  static void copyColumns(const IdTableView<INPUT_WIDTH>& inputTable,
-                          IdTableStatic<OUTPUT_WIDTH>& outputTable,
-                          size_t inputRow, size_t outputRow, size_t skipCol);
-
-  // A small helper function: Insert the `value` to the set at `map[key]`.
-  // As the sets all have an allocator with memory limit, this construction is a
-  // little bit more involved, so this can be a separate helper function.
-  void insertIntoMap(Map& map, Id key, Id value) const;
 };
@@ -44,6 +44,23 @@ Union::Union(QueryExecutionContext* qec,
   AD_CORRECTNESS_CHECK(std::ranges::all_of(_columnOrigins, [](const auto& el) {
     return el[0] != NO_COLUMN || el[1] != NO_COLUMN;
   }));
+
+  // The inputs can be merged on the longest common prefix of their sort
+  // orders (e.g. for a union of two index scans with the same variable in the
+  // first column). The cache key doesn't have to reflect this, because the
+  // sort orders of the inputs are determined by their cache keys.
+  const auto& leftSortedOn = t1->resultSortedOn();
+  const auto& rightSortedOn = t2->resultSortedOn();
+  for (size_t i = 0; i < std::min(leftSortedOn.size(), rightSortedOn.size());
+       ++i) {
+    auto it = std::ranges::find_if(_columnOrigins, [&](const auto& origins) {
+      return origins[0] == leftSortedOn[i];
+    });
+    if (it == _columnOrigins.end() || (*it)[1] != rightSortedOn[i]) {
+      break;
+    }
+    mergeColumns_.push_back(it - _columnOrigins.begin());
+  }
 }
 
 string Union::getCacheKeyImpl() const {
@@ -63,7 +80,7 @@ size_t Union::getResultWidth() const {
   return _columnOrigins.size();
 }
 
-vector<ColumnIndex> Union::resultSortedOn() const { return {}; }
+vector<ColumnIndex> Union::resultSortedOn() const { return mergeColumns_; }
 
 // _____________________________________________________________________________
 VariableToColumnMap Union::computeVariableToColumnMap() const {
@@ -163,12 +180,55 @@ size_t Union::getCostEstimate() {
          getSizeEstimateBeforeLimit();
 }
 
-ResultTable Union::computeResult() {
+ResultTable Union::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "Union result computation..." << std::endl;
-  shared_ptr<const ResultTable> subRes1 = _subtrees[0]->getResult();
-  shared_ptr<const ResultTable> subRes2 = _subtrees[1]->getResult();
+  auto subResults = getChildResults(_subtrees, requestLaziness);
+  shared_ptr<const ResultTable> subRes1 = std::move(subResults[0]);
+  shared_ptr<const ResultTable> subRes2 = std::move(subResults[1]);
   LOG(DEBUG) << "Union subresult computation done." << std::endl;
 
+  // If the parent can consume a lazy result, the union doesn't have to copy
+  // the inputs into a single table. The parent then only holds the inputs and
+  // the current block at the same time.
+  bool isLazy = requestLaziness || !subRes1->isFullyMaterialized() ||
+                !subRes2->isFullyMaterialized();
+  if (isLazy) {
+    if (!mergeColumns_.empty()) {
+      return {computeMergedLazily(std::move(subRes1), std::move(subRes2)),
+              resultSortedOn()};
+    }
+    return {computeLazily(std::move(subRes1), std::move(subRes2)),
+            resultSortedOn()};
+  }
+
+  if (!mergeColumns_.empty()) {
+    const IdTable& left = subRes1->idTable();
+    const IdTable& right = subRes2->idTable();
+    size_t leftPos = 0;
+    size_t rightPos = 0;
+    std::vector<Segment> segments;
+    mergeSegments(left, leftPos, right, rightPos, segments);
+    if (leftPos < left.numRows()) {
+      segments.push_back({true, leftPos, left.numRows()});
+    }
+    if (rightPos < right.numRows()) {
+      segments.push_back({false, rightPos, right.numRows()});
+    }
+    IdTable idTable = writeSegments(left, right, segments);
+    const LocalVocab& leftVocab = subRes1->localVocab();
+    const LocalVocab& rightVocab = subRes2->localVocab();
+    if (!leftVocab.empty() && !rightVocab.empty() &&
+        &leftVocab != &rightVocab) {
+      auto localVocab =
+          mergeLocalVocabs(idTable, segments, leftVocab, rightVocab);
+      return ResultTable{std::move(idTable), resultSortedOn(),
+                         std::move(localVocab)};
+    }
+    return ResultTable{
+        std::move(idTable), resultSortedOn(),
+        ResultTable::getSharedLocalVocabFromNonEmptyOf(*subRes1, *subRes2)};
+  }
+
   IdTable idTable{getExecutionContext()->getAllocator()};
 
   idTable.setNumColumns(getResultWidth());
@@ -176,21 +236,267 @@ ResultTable Union::computeResult() {
                       _columnOrigins);
 
   LOG(DEBUG) << "Union result computation done" << std::endl;
-  // If only one of the two operands has a non-empty local vocabulary, share
-  // with that one (otherwise, throws an exception).
+  const LocalVocab& leftVocab = subRes1->localVocab();
+  const LocalVocab& rightVocab = subRes2->localVocab();
+  if (!leftVocab.empty() && !rightVocab.empty() && &leftVocab != &rightVocab) {
+    // Both operands have a (different) non-empty local vocabulary. The result
+    // gets a local vocabulary that shares the words of both, and the IDs of
+    // the rows of the right operand are changed to refer to it.
+    LocalVocab localVocab = leftVocab.clone();
+    auto newIndexes = localVocab.mergeWith(rightVocab);
+    size_t numRowsLeft = subRes1->idTable().numRows();
+    for (size_t col = 0; col < idTable.numColumns(); ++col) {
+      for (Id& id : idTable.getColumn(col).subspan(numRowsLeft)) {
+        if (id.getDatatype() == Datatype::LocalVocabIndex) {
+          id = Id::makeFromLocalVocabIndex(
+              newIndexes.at(id.getLocalVocabIndex().get()));
+        }
+      }
+    }
+    return ResultTable{std::move(idTable), resultSortedOn(),
+                       std::move(localVocab)};
+  }
+  // At most one of the two operands has a non-empty local vocabulary, share
+  // with that one.
   return ResultTable{
       std::move(idTable), resultSortedOn(),
       ResultTable::getSharedLocalVocabFromNonEmptyOf(*subRes1, *subRes2)};
 }
 
+// _____________________________________________________________________________
+ResultTable::Generator Union::computeLazily(
+    std::shared_ptr<const ResultTable> left,
+    std::shared_ptr<const ResultTable> right) {
+  for (bool isLeft : {true, false}) {
+    const ResultTable& input = isLeft ? *left : *right;
+    if (input.isFullyMaterialized()) {
+      const IdTable& table = input.idTable();
+      for (size_t begin = 0; begin < table.numRows(); begin += chunkSize) {
+        checkCancellation();
+        size_t size = std::min(chunkSize, table.numRows() - begin);
+        IdTable chunk{getResultWidth(), getExecutionContext()->getAllocator()};
+        chunk.resize(size);
+        for (size_t column = 0; column < _columnOrigins.size(); ++column) {
+          size_t origin = _columnOrigins.at(column)[isLeft ? 0 : 1];
+          auto target = chunk.getColumn(column);
+          if (origin == NO_COLUMN) {
+            std::ranges::fill(target, Id::makeUndefined());
+          } else {
+            std::ranges::copy(table.getColumn(origin).subspan(begin, size),
+                              target.begin());
+          }
+        }
+        co_yield ResultTable::IdTableVocabPair{std::move(chunk),
+                                               input.getCopyOfLocalVocab()};
+      }
+      continue;
+    }
+    for (auto& [block, localVocab] : input.idTables()) {
+      co_yield ResultTable::IdTableVocabPair{
+          transformBlock(std::move(block), isLeft), std::move(localVocab)};
+    }
+  }
+}
+
+// _____________________________________________________________________________
+IdTable Union::transformBlock(IdTable block, bool isLeft) const {
+  std::vector<ColumnIndex> columns;
+  columns.reserve(_columnOrigins.size());
+  for (const auto& origins : _columnOrigins) {
+    size_t origin = origins[isLeft ? 0 : 1];
+    if (origin == NO_COLUMN) {
+      origin = block.numColumns();
+      block.addColumn(Id::makeUndefined());
+    }
+    columns.push_back(origin);
+  }
+  block.setColumnSubset(columns);
+  return block;
+}
+
+// _____________________________________________________________________________
+ResultTable::Generator Union::computeMergedLazily(
+    std::shared_ptr<const ResultTable> left,
+    std::shared_ptr<const ResultTable> right) {
+  // The current block of one of the inputs and the position in it. A fully
+  // materialized input consists of a single block.
+  struct Input {
+    const ResultTable& result_;
+    std::optional<decltype(result_.idTables().begin())> iterator_{};
+    const IdTable* block_ = nullptr;
+    const LocalVocab* localVocab_ = nullptr;
+    size_t position_ = 0;
+    bool isFirstBlock_ = true;
+
+    // Move to the next block, return false if there is none.
+    bool next() {
+      position_ = 0;
+      if (result_.isFullyMaterialized()) {
+        block_ = &result_.idTable();
+        localVocab_ = &result_.localVocab();
+        return std::exchange(isFirstBlock_, false);
+      }
+      if (!iterator_.has_value()) {
+        iterator_ = result_.idTables().begin();
+      } else {
+        ++iterator_.value();
+      }
+      if (iterator_.value() == result_.idTables().end()) {
+        return false;
+      }
+      block_ = &(*iterator_.value()).idTable_;
+      localVocab_ = &(*iterator_.value()).localVocab_;
+      return true;
+    }
+    bool isExhausted() const { return position_ == block_->numRows(); }
+  };
+  Input leftInput{*left};
+  Input rightInput{*right};
+
+  bool hasLeft = leftInput.next();
+  bool hasRight = rightInput.next();
+  while (hasLeft && hasRight) {
+    std::vector<Segment> segments;
+    mergeSegments(*leftInput.block_, leftInput.position_, *rightInput.block_,
+                  rightInput.position_, segments);
+    if (!segments.empty()) {
+      IdTable block =
+          writeSegments(*leftInput.block_, *rightInput.block_, segments);
+      auto localVocab = mergeLocalVocabs(
+          block, segments, *leftInput.localVocab_, *rightInput.localVocab_);
+      co_yield ResultTable::IdTableVocabPair{std::move(block),
+                                             std::move(localVocab)};
+    }
+    if (leftInput.isExhausted()) {
+      hasLeft = leftInput.next();
+    }
+    if (rightInput.isExhausted()) {
+      hasRight = rightInput.next();
+    }
+  }
+
+  // Yield the remaining rows of the input that is not exhausted yet.
+  for (bool isLeft : {true, false}) {
+    Input& input = isLeft ? leftInput : rightInput;
+    IdTable empty{0, getExecutionContext()->getAllocator()};
+    for (bool hasBlock = isLeft ? hasLeft : hasRight; hasBlock;
+         hasBlock = input.next()) {
+      if (input.isExhausted()) {
+        continue;
+      }
+      std::vector<Segment> segments{
+          {isLeft, input.position_, input.block_->numRows()}};
+      co_yield ResultTable::IdTableVocabPair{
+          isLeft ? writeSegments(*input.block_, empty, segments)
+                 : writeSegments(empty, *input.block_, segments),
+          input.localVocab_->clone()};
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void Union::mergeSegments(const IdTable& left, size_t& leftPos,
+                          const IdTable& right, size_t& rightPos,
+                          std::vector<Segment>& segments) const {
+  // Return true iff the row `r` of the `right` input is smaller than the row
+  // `l` of the `left` input.
+  auto rightIsSmaller = [this, &left, &right](size_t l, size_t r) {
+    for (auto column : mergeColumns_) {
+      auto [leftColumn, rightColumn] = _columnOrigins[column];
+      Id leftId = left(l, leftColumn);
+      Id rightId = right(r, rightColumn);
+      if (leftId != rightId) {
+        return rightId < leftId;
+      }
+    }
+    return false;
+  };
+  checkCancellation();
+  while (leftPos < left.numRows() && rightPos < right.numRows()) {
+    size_t begin = leftPos;
+    while (leftPos < left.numRows() && !rightIsSmaller(leftPos, rightPos)) {
+      ++leftPos;
+    }
+    if (leftPos > begin) {
+      segments.push_back({true, begin, leftPos});
+    }
+    if (leftPos == left.numRows()) {
+      break;
+    }
+    begin = rightPos;
+    while (rightPos < right.numRows() && rightIsSmaller(leftPos, rightPos)) {
+      ++rightPos;
+    }
+    segments.push_back({false, begin, rightPos});
+  }
+}
+
+// _____________________________________________________________________________
+IdTable Union::writeSegments(const IdTable& left, const IdTable& right,
+                             const std::vector<Segment>& segments) const {
+  size_t numRows = 0;
+  for (const auto& segment : segments) {
+    numRows += segment.end_ - segment.begin_;
+  }
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  result.resize(numRows);
+  for (size_t column = 0; column < _columnOrigins.size(); ++column) {
+    checkCancellation();
+    auto target = result.getColumn(column).begin();
+    for (const auto& [isLeft, begin, end] : segments) {
+      size_t origin = _columnOrigins[column][isLeft ? 0 : 1];
+      if (origin == NO_COLUMN) {
+        target = std::fill_n(target, end - begin, Id::makeUndefined());
+      } else {
+        const IdTable& input = isLeft ? left : right;
+        target = std::ranges::copy(
+                     input.getColumn(origin).subspan(begin, end - begin),
+                     target)
+                     .out;
+      }
+    }
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+LocalVocab Union::mergeLocalVocabs(IdTable& table,
+                                   const std::vector<Segment>& segments,
+                                   const LocalVocab& left,
+                                   const LocalVocab& right) {
+  if (right.empty() || &left == &right) {
+    return left.clone();
+  }
+  if (left.empty()) {
+    return right.clone();
+  }
+  LocalVocab localVocab = left.clone();
+  auto newIndexes = localVocab.mergeWith(right);
+  size_t offset = 0;
+  for (const auto& [isLeft, begin, end] : segments) {
+    size_t size = end - begin;
+    if (!isLeft) {
+      for (size_t column = 0; column < table.numColumns(); ++column) {
+        for (Id& id : table.getColumn(column).subspan(offset, size)) {
+          if (id.getDatatype() == Datatype::LocalVocabIndex) {
+            id = Id::makeFromLocalVocabIndex(
+                newIndexes.at(id.getLocalVocabIndex().get()));
+          }
+        }
+      }
+    }
+    offset += size;
+  }
+  return localVocab;
+}
+
+// _____________________________________________________________________________
 void Union::computeUnion(
     IdTable* resPtr, const IdTable& left, const IdTable& right,
     const std::vector<std::array<size_t, 2>>& columnOrigins) {
   IdTable& res = *resPtr;
   res.resize(left.size() + right.size());
 
-  static constexpr size_t chunkSize = 1'000'000;
-
   // A drop-in replacement for `std::copy` that performs the copying in chunks
   // of `chunkSize` and checks the timeout after each chunk.
   auto copyChunked = [this](auto beg, auto end, auto target) {
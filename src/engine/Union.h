@@ -23,6 +23,17 @@ class Union : public Operation {
    */
   std::vector<std::array<size_t, 2>> _columnOrigins;
   std::array<std::shared_ptr<QueryExecutionTree>, 2> _subtrees;
+  // If both inputs are sorted on the same columns of the union, the union
+  // merges them and its result is sorted on these columns. Empty if the inputs
+  // are concatenated.
+  std::vector<ColumnIndex> mergeColumns_;
+
+  // A range of rows of the left (if `isLeft_`) or the right input.
+  struct Segment {
+    bool isLeft_;
+    size_t begin_;
+    size_t end_;
+  };
 
  public:
   Union(QueryExecutionContext* qec,
@@ -53,17 +64,68 @@ class Union : public Operation {
 
   const static size_t NO_COLUMN;
 
+  // The number of rows that are copied at once. The cancellation is checked
+  // after each chunk, and the fully materialized inputs of a lazy union are
+  // yielded in chunks of this size.
+  static constexpr size_t chunkSize = 1'000'000;
+
   // The method is declared here to make it unit testable
   void computeUnion(IdTable* inputTable, const IdTable& left,
                     const IdTable& right,
                     const std::vector<std::array<size_t, 2>>& columnOrigins);
 
+  // Transform the `block` of the left (if `isLeft`) or the right input to the
+  // column layout of the union by reordering its columns and adding the UNDEF
+  // columns in place. Public for the same reason as `computeUnion`.
+  IdTable transformBlock(IdTable block, bool isLeft) const;
+
+  // The columns of the union on which the inputs are merged (see
+  // `mergeColumns_`).
+  const std::vector<ColumnIndex>& mergeColumns() const { return mergeColumns_; }
+
   vector<QueryExecutionTree*> getChildren() override {
     return {_subtrees[0].get(), _subtrees[1].get()};
   }
 
  private:
-  virtual ResultTable computeResult() override;
+  virtual ResultTable computeResult(bool requestLaziness) override;
+
+  // Lazily yield the blocks of the `left` result followed by the blocks of the
+  // `right` result, each transformed to the column layout of the union. Each of
+  // the results may be lazy or fully materialized. The blocks of a lazy result
+  // are not copied, and a fully materialized result is copied in chunks, s.t.
+  // the union never holds a copy of a complete input.
+  ResultTable::Generator computeLazily(
+      std::shared_ptr<const ResultTable> left,
+      std::shared_ptr<const ResultTable> right);
+
+  // Merge the inputs, which are sorted on the `mergeColumns_`, lazily block by
+  // block. Each of the results may be lazy or fully materialized.
+  ResultTable::Generator computeMergedLazily(
+      std::shared_ptr<const ResultTable> left,
+      std::shared_ptr<const ResultTable> right);
+
+  // Append the segments of the merge of the `left` rows starting at `leftPos`
+  // and the `right` rows starting at `rightPos` to the `segments`, until all
+  // the rows of one of the two tables have been merged. The positions are
+  // advanced accordingly. For equal rows, the left one comes first.
+  void mergeSegments(const IdTable& left, size_t& leftPos,
+                     const IdTable& right, size_t& rightPos,
+                     std::vector<Segment>& segments) const;
+
+  // Write the rows of the `segments` of the `left` and `right` table in the
+  // column layout of the union, one after the other.
+  IdTable writeSegments(const IdTable& left, const IdTable& right,
+                        const std::vector<Segment>& segments) const;
+
+  // Return the local vocabulary for the `table` that was written from the
+  // `segments` of two inputs with the local vocabularies `left` and `right`.
+  // If both are not empty, the vocabularies are merged and the IDs of the rows
+  // of the right input in the `table` are changed to refer to the merged one.
+  static LocalVocab mergeLocalVocabs(IdTable& table,
+                                     const std::vector<Segment>& segments,
+                                     const LocalVocab& left,
+                                     const LocalVocab& right);
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 };
@@ -11,7 +11,10 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "engine/CallFixedSize.h"
+#include "global/Constants.h"
+#include "global/SpecialIds.h"
 #include "util/Exception.h"
+#include "util/HashMap.h"
 #include "util/HashSet.h"
 
 // ____________________________________________________________________________
@@ -108,7 +111,7 @@ void Values::computeMultiplicities() {
 }
 
 // ____________________________________________________________________________
-ResultTable Values::computeResult() {
+ResultTable Values::computeResult([[maybe_unused]] bool requestLaziness) {
   // Set basic properties of the result table.
   IdTable idTable{getExecutionContext()->getAllocator()};
   idTable.setNumColumns(getResultWidth());
@@ -125,22 +128,63 @@ ResultTable Values::computeResult() {
 template <size_t I>
 void Values::writeValues(IdTable* idTablePtr, LocalVocab* localVocab) {
   IdTableStatic<I> idTable = std::move(*idTablePtr).toStatic<I>();
-  idTable.resize(parsedValues_._values.size());
-  size_t rowIdx = 0;
+  auto& rows = parsedValues_._values;
+  idTable.resize(rows.size());
+  const auto& vocab = getIndex().getVocab();
+  auto getContent = [](const TripleComponent& tc) -> std::string_view {
+    return tc.isString() ? tc.getString() : tc.getLiteral().rawContent();
+  };
+  // The IDs of the distinct strings (IRIs and literals) of the VALUES clause.
+  // They are looked up in the vocabulary all at once (a single lookup is a
+  // binary search over the vocabulary with an expensive comparison, see
+  // `Vocabulary::getIds`), which matters for large data blocks. The keys point
+  // to the strings in `rows`, so they are not copied.
+  ad_utility::HashMap<std::string_view, Id> idsOfStrings;
+  std::vector<std::string_view> distinctStrings;
+  for (const auto& row : rows) {
+    for (const TripleComponent& tc : row) {
+      if ((tc.isString() || tc.isLiteral()) &&
+          idsOfStrings.try_emplace(getContent(tc)).second) {
+        distinctStrings.push_back(getContent(tc));
+      }
+    }
+  }
+  auto vocabIndices = vocab.getIds(
+      distinctStrings,
+      getExecutionContext()->getNumThreads(
+          RuntimeParameters().get<"vocabulary-lookup-num-threads">()));
+  for (size_t i = 0; i < distinctStrings.size(); ++i) {
+    std::string_view content = distinctStrings[i];
+    Id& id = idsOfStrings.at(content);
+    if (vocabIndices[i].has_value()) {
+      id = Id::makeFromVocabIndex(vocabIndices[i].value());
+    } else if (auto it = qlever::specialIds.find(content);
+               it != qlever::specialIds.end()) {
+      id = it->second;
+    } else {
+      id = localVocab->getIdAndAddIfNotContained(content);
+    }
+  }
+
   std::vector<size_t> numLocalVocabPerColumn(idTable.numColumns());
-  for (auto& row : parsedValues_._values) {
-    for (size_t colIdx = 0; colIdx < idTable.numColumns(); colIdx++) {
-      TripleComponent& tc = row[colIdx];
-      Id id = std::move(tc).toValueId(getIndex().getVocab(), *localVocab);
-      idTable(rowIdx, colIdx) = id;
+  for (size_t colIdx = 0; colIdx < idTable.numColumns(); colIdx++) {
+    // Fill the table column by column, which writes the memory sequentially.
+    decltype(auto) column = idTable.getColumn(colIdx);
+    for (size_t rowIdx = 0; rowIdx < rows.size(); ++rowIdx) {
+      TripleComponent& tc = rows[rowIdx][colIdx];
+      Id id = tc.isString() || tc.isLiteral()
+                  ? idsOfStrings.at(getContent(tc))
+                  : std::move(tc).toValueId(vocab, *localVocab);
+      column[rowIdx] = id;
       if (id.getDatatype() == Datatype::LocalVocabIndex) {
         ++numLocalVocabPerColumn[colIdx];
       }
     }
-    rowIdx++;
   }
-  AD_CORRECTNESS_CHECK(rowIdx == parsedValues_._values.size());
-  LOG(INFO) << "Number of tuples in VALUES clause: " << rowIdx << std::endl;
+  LOG(INFO) << "Number of tuples in VALUES clause: " << rows.size()
+            << std::endl;
+  LOG(INFO) << "Number of distinct IRIs and literals in VALUES clause: "
+            << idsOfStrings.size() << std::endl;
   LOG(INFO) << "Number of entries in local vocabulary per column: "
             << absl::StrJoin(numLocalVocabPerColumn, ", ") << std::endl;
   *idTablePtr = std::move(idTable).toDynamic();
@@ -50,7 +50,8 @@ class Values : public Operation {
 
  public:
   // These two are also used by class `Service`, hence public.
-  virtual ResultTable computeResult() override;
+  virtual ResultTable computeResult(
+      [[maybe_unused]] bool requestLaziness) override;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "absl/strings/str_join.h"
 #include "engine/Operation.h"
 #include "engine/QueryExecutionContext.h"
 #include "engine/ResultTable.h"
@@ -21,6 +22,13 @@ class ValuesForTesting : public Operation {
   // Those can be manually overwritten for testing using the respective getters.
   size_t sizeEstimate_;
   size_t costEstimate_;
+  // If set, the result is yielded lazily in blocks of this size when laziness
+  // is requested.
+  std::optional<size_t> lazyBlockSize_;
+  // The columns by which the `table_` is sorted, empty by default.
+  std::vector<ColumnIndex> sortedColumns_;
+  // The local vocab of the (fully materialized) result, empty by default.
+  LocalVocab localVocab_;
 
  public:
   // Create an operation that has as its result the given `table` and the given
@@ -41,9 +49,20 @@ class ValuesForTesting : public Operation {
   // Accessors for the estimates for manual testing.
   size_t& sizeEstimate() { return sizeEstimate_; }
   size_t& costEstimate() { return costEstimate_; }
+  std::optional<size_t>& lazyBlockSize() { return lazyBlockSize_; }
+  std::vector<ColumnIndex>& sortedColumns() { return sortedColumns_; }
+  LocalVocab& localVocab() { return localVocab_; }
 
   // ___________________________________________________________________________
-  ResultTable computeResult() override {
+  ResultTable computeResult(bool requestLaziness) override {
+    if (requestLaziness && lazyBlockSize_.has_value()) {
+      ResultTable result{computeLazily(lazyBlockSize_.value()),
+                         resultSortedOn()};
+      if (supportsLimit_) {
+        result.applyLimitOffset(getLimit());
+      }
+      return result;
+    }
     auto table = table_.clone();
     if (supportsLimit_) {
       table.erase(table.begin() + getLimit().upperBound(table.size()),
@@ -51,11 +70,22 @@ class ValuesForTesting : public Operation {
       table.erase(table.begin(),
                   table.begin() + getLimit().actualOffset(table.size()));
     }
-    return {std::move(table), resultSortedOn(), LocalVocab{}};
+    return {std::move(table), resultSortedOn(), localVocab_.clone()};
   }
   bool supportsLimit() const override { return supportsLimit_; }
 
  private:
+  // Yield the `table_` in blocks of size `blockSize`.
+  ResultTable::Generator computeLazily(size_t blockSize) const {
+    AD_CONTRACT_CHECK(blockSize > 0);
+    for (size_t i = 0; i < table_.numRows(); i += blockSize) {
+      IdTable block{table_.numColumns(), table_.getAllocator()};
+      size_t end = std::min(i + blockSize, table_.numRows());
+      block.insertAtEnd(table_.begin() + i, table_.begin() + end);
+      co_yield ResultTable::IdTableVocabPair{std::move(block), LocalVocab{}};
+    }
+  }
+
   // ___________________________________________________________________________
   string getCacheKeyImpl() const override {
     std::stringstream str;
@@ -67,6 +97,7 @@ class ValuesForTesting : public Operation {
       }
     }
     str << "Supports limit: " << supportsLimit_;
+    str << " Sorted on: " << absl::StrJoin(sortedColumns_, " ");
     return std::move(str).str();
   }
 
@@ -77,9 +108,7 @@ class ValuesForTesting : public Operation {
 
   size_t getResultWidth() const override { return table_.numColumns(); }
 
-  // TODO<joka921> Maybe we will need to store sorted tables for future unit
-  // tests.
-  vector<ColumnIndex> resultSortedOn() const override { return {}; }
+  vector<ColumnIndex> resultSortedOn() const override { return sortedColumns_; }
 
   void setTextLimit(size_t limit) override { (void)limit; }
 
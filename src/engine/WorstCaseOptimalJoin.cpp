@@ -0,0 +1,273 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "engine/WorstCaseOptimalJoin.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "absl/strings/str_join.h"
+#include "engine/IndexScan.h"
+#include "util/JoinAlgorithms/LeapfrogTriejoin.h"
+
+// _____________________________________________________________________________
+WorstCaseOptimalJoin::WorstCaseOptimalJoin(QueryExecutionContext* qec,
+                                           std::vector<SparqlTriple> triples)
+    : Operation{qec} {
+  AD_CONTRACT_CHECK(triples.size() >= 2);
+  AD_CONTRACT_CHECK(std::ranges::all_of(triples, &isSupportedTriple));
+  // The same triples in a different order lead to the same operation (and
+  // cache key).
+  std::ranges::sort(triples, {}, &SparqlTriple::asString);
+  variables_ = computeVariableOrder(triples);
+
+  auto indexOfVariable = [this](const TripleComponent& component) {
+    return static_cast<size_t>(
+        std::ranges::find(variables_, component.getVariable()) -
+        variables_.begin());
+  };
+  for (const auto& triple : triples) {
+    size_t subjectIndex = indexOfVariable(triple._s);
+    size_t objectIndex = indexOfVariable(triple._o);
+    using enum Permutation::Enum;
+    if (subjectIndex < objectIndex) {
+      children_.push_back(
+          ad_utility::makeExecutionTree<IndexScan>(qec, PSO, triple));
+      variablesOfChildren_.push_back({subjectIndex, objectIndex});
+    } else {
+      children_.push_back(
+          ad_utility::makeExecutionTree<IndexScan>(qec, POS, triple));
+      variablesOfChildren_.push_back({objectIndex, subjectIndex});
+    }
+  }
+}
+
+// _____________________________________________________________________________
+bool WorstCaseOptimalJoin::isSupportedTriple(const SparqlTriple& triple) {
+  const auto& predicate = triple._p;
+  return predicate._operation == PropertyPath::Operation::IRI &&
+         !isVariable(predicate) &&
+         predicate._iri != HAS_PREDICATE_PREDICATE &&
+         predicate._iri != CONTAINS_WORD_PREDICATE &&
+         predicate._iri != CONTAINS_ENTITY_PREDICATE &&
+         triple._s.isVariable() && triple._o.isVariable() &&
+         triple._s != triple._o && triple._additionalScanColumns.empty();
+}
+
+// _____________________________________________________________________________
+std::vector<Variable> WorstCaseOptimalJoin::computeVariableOrder(
+    const std::vector<SparqlTriple>& triples) {
+  std::vector<Variable> candidates;
+  for (const auto& triple : triples) {
+    for (const auto* component : {&triple._s, &triple._o}) {
+      const auto& variable = component->getVariable();
+      if (std::ranges::find(candidates, variable) == candidates.end()) {
+        candidates.push_back(variable);
+      }
+    }
+  }
+  auto numTriplesWith = [&triples](const Variable& variable,
+                                   const auto& otherVariableIsChosen) {
+    return std::ranges::count_if(triples, [&](const SparqlTriple& triple) {
+      const auto& subject = triple._s.getVariable();
+      const auto& object = triple._o.getVariable();
+      return (subject == variable && otherVariableIsChosen(object)) ||
+             (object == variable && otherVariableIsChosen(subject));
+    });
+  };
+
+  std::vector<Variable> order;
+  auto isChosen = [&order](const Variable& variable) {
+    return std::ranges::find(order, variable) != order.end();
+  };
+  while (!candidates.empty()) {
+    // `std::ranges::max_element` returns the first maximum, so ties are broken
+    // by the order of appearance.
+    auto next = std::ranges::max_element(
+        candidates, std::less{}, [&](const Variable& variable) {
+          return std::pair{numTriplesWith(variable, isChosen),
+                           numTriplesWith(variable, [](const auto&) {
+                             return true;
+                           })};
+        });
+    order.push_back(*next);
+    candidates.erase(next);
+  }
+  return order;
+}
+
+// _____________________________________________________________________________
+std::vector<QueryExecutionTree*> WorstCaseOptimalJoin::getChildren() {
+  std::vector<QueryExecutionTree*> result;
+  std::ranges::transform(children_, std::back_inserter(result),
+                         [](auto& child) { return child.get(); });
+  return result;
+}
+
+// _____________________________________________________________________________
+string WorstCaseOptimalJoin::getCacheKeyImpl() const {
+  std::ostringstream os;
+  os << "WORST_CASE_OPTIMAL_JOIN on "
+     << absl::StrJoin(variables_, " ",
+                      [](std::string* out, const Variable& variable) {
+                        out->append(variable.name());
+                      });
+  for (size_t i = 0; i < children_.size(); ++i) {
+    os << "\n{" << children_[i]->getCacheKey() << "} variables: ["
+       << variablesOfChildren_[i][0] << " & " << variablesOfChildren_[i][1]
+       << "]";
+  }
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string WorstCaseOptimalJoin::getDescriptor() const {
+  std::string descriptor = "WorstCaseOptimalJoin on";
+  for (const auto& variable : variables_) {
+    absl::StrAppend(&descriptor, " ", variable.name());
+  }
+  return descriptor;
+}
+
+// _____________________________________________________________________________
+vector<ColumnIndex> WorstCaseOptimalJoin::resultSortedOn() const {
+  std::vector<ColumnIndex> sortedOn(variables_.size());
+  std::iota(sortedOn.begin(), sortedOn.end(), ColumnIndex{0});
+  return sortedOn;
+}
+
+// _____________________________________________________________________________
+VariableToColumnMap WorstCaseOptimalJoin::computeVariableToColumnMap() const {
+  VariableToColumnMap map;
+  for (size_t i = 0; i < variables_.size(); ++i) {
+    // The columns of index scans are always defined.
+    map[variables_[i]] = makeAlwaysDefinedColumn(i);
+  }
+  return map;
+}
+
+// _____________________________________________________________________________
+bool WorstCaseOptimalJoin::knownEmptyResult() {
+  return std::ranges::any_of(
+      children_, [](const auto& child) { return child->knownEmptyResult(); });
+}
+
+// _____________________________________________________________________________
+void WorstCaseOptimalJoin::computeSizeEstimateAndMultiplicities() {
+  // For each variable the number of distinct values in each of the scans that
+  // contain it.
+  std::vector<std::vector<double>> numDistinct(variables_.size());
+  double size = 1;
+  for (size_t i = 0; i < children_.size(); ++i) {
+    auto& child = *children_[i];
+    auto childSize = static_cast<double>(child.getSizeEstimate());
+    size *= childSize;
+    for (size_t col = 0; col < 2; ++col) {
+      numDistinct.at(variablesOfChildren_[i][col])
+          .push_back(std::max(1.0, childSize / child.getMultiplicity(col)));
+    }
+  }
+  multiplicities_.clear();
+  for (auto& distinct : numDistinct) {
+    std::ranges::sort(distinct);
+    for (size_t i = 1; i < distinct.size(); ++i) {
+      size /= distinct[i];
+    }
+  }
+  sizeEstimate_ = static_cast<uint64_t>(std::round(size));
+  for (const auto& distinct : numDistinct) {
+    multiplicities_.push_back(static_cast<float>(
+        std::max(1.0, static_cast<double>(sizeEstimate_) / distinct.front())));
+  }
+  sizeEstimateComputed_ = true;
+}
+
+// _____________________________________________________________________________
+uint64_t WorstCaseOptimalJoin::getSizeEstimateBeforeLimit() {
+  if (!sizeEstimateComputed_) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return sizeEstimate_;
+}
+
+// _____________________________________________________________________________
+float WorstCaseOptimalJoin::getMultiplicity(size_t col) {
+  if (!sizeEstimateComputed_) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return multiplicities_.at(col);
+}
+
+// _____________________________________________________________________________
+size_t WorstCaseOptimalJoin::getCostEstimate() {
+  // Each scan is read once, and there are no intermediate results.
+  size_t cost = getSizeEstimateBeforeLimit();
+  for (const auto& child : children_) {
+    cost += child->getCostEstimate() + child->getSizeEstimate();
+  }
+  return cost;
+}
+
+// _____________________________________________________________________________
+ResultTable WorstCaseOptimalJoin::computeResult(
+    [[maybe_unused]] bool requestLaziness) {
+  // The results of the scans. The scans that contain the first variable are
+  // read lazily, s.t. only the blocks that can contain matching rows for all of
+  // them are read. The other scans are computed as usual.
+  std::vector<IdTable> lazilyScannedTables;
+  std::vector<std::shared_ptr<const ResultTable>> subResults;
+  std::vector<const IdTable*> tables(children_.size());
+
+  std::vector<size_t> scansOfFirstVariable;
+  for (size_t i = 0; i < children_.size(); ++i) {
+    if (variablesOfChildren_[i][0] == 0) {
+      scansOfFirstVariable.push_back(i);
+    }
+  }
+  // The lazy scans read the blocks of the permutations directly, so they
+  // cannot be used if the index has inserted or deleted triples.
+  auto& firstScan = dynamic_cast<IndexScan&>(*children_[0]->getRootOperation());
+  if (scansOfFirstVariable.size() >= 2 && !firstScan.hasDeltaTriples()) {
+    std::vector<IndexScan*> scans;
+    for (size_t i : scansOfFirstVariable) {
+      scans.push_back(
+          &dynamic_cast<IndexScan&>(*children_[i]->getRootOperation()));
+    }
+    ad_utility::Timer timer{ad_utility::timer::Timer::InitialStatus::Started};
+    auto generators = IndexScan::lazyScanForJoinOfScans(
+        std::vector<const IndexScan*>(scans.begin(), scans.end()));
+    runtimeInfo().addDetail("time-for-filtering-blocks", timer.msecs());
+    lazilyScannedTables.reserve(scans.size());
+    for (size_t k = 0; k < scans.size(); ++k) {
+      auto& table = lazilyScannedTables.emplace_back(
+          2, getExecutionContext()->getTemporaryAllocator());
+      for (const IdTable& block : generators[k]) {
+        table.insertAtEnd(block.begin(), block.end());
+        checkCancellation();
+      }
+      scans[k]->updateRuntimeInfoForLazyScan(generators[k].details());
+      tables[scansOfFirstVariable[k]] = &table;
+    }
+  }
+  for (size_t i = 0; i < children_.size(); ++i) {
+    if (tables[i] == nullptr) {
+      tables[i] =
+          &subResults.emplace_back(children_[i]->getResult())->idTable();
+    }
+  }
+
+  std::vector<ad_utility::TrieRelation> relations;
+  for (size_t i = 0; i < children_.size(); ++i) {
+    relations.push_back({tables[i]->getColumn(0), tables[i]->getColumn(1),
+                         variablesOfChildren_[i]});
+  }
+  IdTable result{getResultWidth(), getExecutionContext()->getAllocator()};
+  ad_utility::leapfrogTriejoin(
+      relations, variables_.size(),
+      [&result](std::span<const Id> row) { result.push_back(row); },
+      [this]() { checkCancellation(); });
+
+  // Index scans never have a local vocabulary.
+  return {std::move(result), resultSortedOn(), LocalVocab{}};
+}
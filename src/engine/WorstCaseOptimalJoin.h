@@ -0,0 +1,96 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "engine/Operation.h"
+#include "engine/QueryExecutionTree.h"
+#include "parser/ParsedQuery.h"
+
+// A worst-case optimal join of triples of the form `?x <p> ?y` via the
+// Leapfrog Triejoin (see `util/JoinAlgorithms/LeapfrogTriejoin.h`). For cyclic
+// patterns like the triangle `?a <p> ?b . ?b <p> ?c . ?c <p> ?a`, a sequence of
+// pairwise joins can have intermediate results that are much larger than the
+// final result, while this operation binds one variable after the other and
+// never materializes intermediate results.
+//
+// The variables are bound in a fixed order (see `computeVariableOrder`), which
+// is also the order of the columns of the result. Each triple is read via the
+// permutation (PSO or POS) that is sorted by the variable of the triple that is
+// bound first, s.t. the result of the scan is a trie with two levels. The
+// scans of the triples that contain the first variable are joined on their
+// first column, so their blocks are filtered against each other using the
+// metadata of the blocks before they are read.
+class WorstCaseOptimalJoin : public Operation {
+ private:
+  // The index scans, one for each triple.
+  std::vector<std::shared_ptr<QueryExecutionTree>> children_;
+  // The order in which the variables are bound.
+  std::vector<Variable> variables_;
+  // For each of the `children_`, the indices in the `variables_` of the
+  // variables of its first and its second column.
+  std::vector<std::array<size_t, 2>> variablesOfChildren_;
+
+  uint64_t sizeEstimate_ = 0;
+  std::vector<float> multiplicities_;
+  bool sizeEstimateComputed_ = false;
+
+ public:
+  // Create the join of the `triples`, which must all be supported (see
+  // `isSupportedTriple`), else an `AD_CONTRACT_CHECK` fails.
+  WorstCaseOptimalJoin(QueryExecutionContext* qec,
+                       std::vector<SparqlTriple> triples);
+
+  // Return true iff the `triple` can be part of this join, which is the case
+  // for the triples with a fixed IRI as the predicate and two different
+  // variables as the subject and the object.
+  static bool isSupportedTriple(const SparqlTriple& triple);
+
+  // The order in which the variables are bound, which is also the order of the
+  // columns of the result.
+  const std::vector<Variable>& variableOrder() const { return variables_; }
+
+  std::vector<QueryExecutionTree*> getChildren() override;
+
+  string getDescriptor() const override;
+
+  size_t getResultWidth() const override { return variables_.size(); }
+
+  // The result is sorted by all the columns.
+  vector<ColumnIndex> resultSortedOn() const override;
+
+  size_t getCostEstimate() override;
+
+  float getMultiplicity(size_t col) override;
+
+  bool knownEmptyResult() override;
+
+ private:
+  string getCacheKeyImpl() const override;
+
+  uint64_t getSizeEstimateBeforeLimit() override;
+
+  // Estimate the size of the result from the sizes and the multiplicities of
+  // the scans: Each variable divides the product of the sizes of the scans by
+  // the numbers of distinct values of the variable in all the scans that
+  // contain it, except the smallest of these numbers (this is the usual
+  // estimate for a sequence of joins, see `Join`).
+  void computeSizeEstimateAndMultiplicities();
+
+  // Compute the order of the variables of the `triples`: The first variable is
+  // the one that occurs in the most triples. Then the variable that occurs in
+  // the most triples together with the already chosen variables comes next
+  // (ties are broken by the total number of triples of the variable and then
+  // by the order of appearance), s.t. each variable (except the first) is
+  // restricted by the values of the previous ones.
+  static std::vector<Variable> computeVariableOrder(
+      const std::vector<SparqlTriple>& triples);
+
+  ResultTable computeResult([[maybe_unused]] bool requestLaziness) override;
+
+  VariableToColumnMap computeVariableToColumnMap() const override;
+};
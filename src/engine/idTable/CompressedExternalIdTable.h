@@ -17,6 +17,9 @@
 #include "util/CompressionUsingZstd/ZstdWrapper.h"
 #include "util/File.h"
 #include "util/MemorySize/MemorySize.h"
+#include "util/ParallelMultiwayMerge.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
 #include "util/TransparentFunctors.h"
 #include "util/Views.h"
 #include "util/http/beast.h"
@@ -45,6 +48,8 @@ class CompressedExternalIdTableWriter {
     size_t compressedSize_;
     size_t uncompressedSize_;
     size_t offsetInFile_;
+    friend std::true_type allowTrivialSerialization(CompressedBlockMetadata,
+                                                    auto);
   };
 
   // The filename and actual file to which the `IdTable` is written .
@@ -74,7 +79,24 @@ class CompressedExternalIdTableWriter {
   // contents.
   size_t numActiveGenerators_ = 0;
 
+  // If set to true, the file is not deleted by the destructor.
+  bool keepFileOnDestruction_ = false;
+
  public:
+  // The metadata of all the stored `IdTable`s, which is only kept in memory.
+  // Together with the file, it can be used to reopen the stored `IdTable`s in a
+  // new `CompressedExternalIdTableWriter` (see the constructor with the
+  // `ReopenTag` below), e.g. after a restart.
+  struct Metadata {
+    std::vector<ColumnMetadata> blocksPerColumn_;
+    std::vector<size_t> startOfSingleIdTables_;
+    AD_SERIALIZE_FRIEND_FUNCTION(Metadata) {
+      serializer | arg.blocksPerColumn_;
+      serializer | arg.startOfSingleIdTables_;
+    }
+  };
+  struct ReopenTag {};
+
   // Constructor. The file at `filename` will be overwritten. Each of the
   // `IdTables` that will be passed in has to have exactly `numCols` columns.
   explicit CompressedExternalIdTableWriter(
@@ -87,12 +109,45 @@ class CompressedExternalIdTableWriter {
         allocator_{std::move(allocator)},
         blockSizeUncompressed_(blockSizeUncompressed) {}
 
-  // Destructor. Deletes the stored file.
+  // Reopen the file at `filename`, which was written by another
+  // `CompressedExternalIdTableWriter` with the given `metadata` (see
+  // `getMetadata()` and `keepFileOnDestruction()`), for reading. The file is
+  // not modified.
+  CompressedExternalIdTableWriter(std::string filename, ReopenTag,
+                                  Metadata metadata,
+                                  ad_utility::AllocatorWithLimit<Id> allocator)
+      : filename_{std::move(filename)},
+        file_{filename_, "r"},
+        blocksPerColumn_(std::move(metadata.blocksPerColumn_)),
+        startOfSingleIdTables_(std::move(metadata.startOfSingleIdTables_)),
+        allocator_{std::move(allocator)},
+        keepFileOnDestruction_{true} {
+    AD_CONTRACT_CHECK(!blocksPerColumn_.empty());
+  }
+
+  // Destructor. Deletes the stored file unless `keepFileOnDestruction()` was
+  // called.
   ~CompressedExternalIdTableWriter() {
     file_.wlock()->close();
-    ad_utility::deleteFile(filename_);
+    if (!keepFileOnDestruction_) {
+      ad_utility::deleteFile(filename_);
+    }
+  }
+
+  // Don't delete the file in the destructor, s.t. it can later be reopened
+  // using the `getMetadata()`.
+  void keepFileOnDestruction() { keepFileOnDestruction_ = true; }
+
+  // Return the metadata that is needed to reopen the stored `IdTable`s. The
+  // file has to be flushed (e.g. by destroying this writer) before it is
+  // reopened.
+  Metadata getMetadata() const {
+    return {blocksPerColumn_, startOfSingleIdTables_};
   }
 
+  // Flush all the stored `IdTable`s to the file.
+  void flush() { file_.wlock()->flush(); }
+
   // Simple getters for the stored allocator and the number of columns;
   const auto& allocator() const { return allocator_; }
   size_t numColumns() const { return blocksPerColumn_.size(); }
@@ -556,6 +611,21 @@ class CompressedExternalIdTableSorter
   // The number of merged blocks that are buffered during the
   //  output phase.
   int numBufferedOutputBlocks_ = 4;
+  // The maximal number of rows in the blocks that are passed between the
+  // concurrent merges of the output phase.
+  static constexpr size_t MERGE_BLOCKSIZE = 10'000;
+
+  // The memory of a single row, which is used to limit the memory of the
+  // merges in the output phase.
+  struct RowSizeGetter {
+    MemorySize operator()(const typename Base::value_type& row) const {
+      if constexpr (NumStaticCols == 0) {
+        return MemorySize::bytes(sizeof(row) + row.numColumns() * sizeof(Id));
+      } else {
+        return MemorySize::bytes(sizeof(row));
+      }
+    }
+  };
 
   // See the `moveResultOnMerge()` getter function for documentation.
   bool moveResultOnMerge_ = true;
@@ -683,49 +753,58 @@ class CompressedExternalIdTableSorter
       }
       co_return;
     }
-    auto rowGenerators =
-        this->writer_.template getAllRowGenerators<NumStaticCols>();
-
-    const size_t blockSizeOutput =
-        blocksize.value_or(computeBlockSizeForMergePhase(rowGenerators.size()));
-
-    using P = std::pair<decltype(rowGenerators[0].begin()),
-                        decltype(rowGenerators[0].end())>;
-    auto projection = [](const auto& el) -> decltype(auto) {
-      return *el.first;
+    auto blockGenerators =
+        this->writer_.template getAllGenerators<NumStaticCols>();
+
+    const size_t blockSizeOutput = blocksize.value_or(
+        computeBlockSizeForMergePhase(blockGenerators.size()));
+
+    // The presorted runs are merged by a binary tree of merges, the nodes of
+    // which run concurrently (see `ParallelMultiwayMerge.h`). The merge
+    // requires lvalues of the rows, so the blocks of the runs are converted to
+    // vectors of rows.
+    using Row = typename Base::value_type;
+    auto toRows =
+        [](cppcoro::generator<const IdTableStatic<NumStaticCols>> blocks)
+        -> cppcoro::generator<std::vector<Row>> {
+      for (const auto& block : blocks) {
+        std::vector<Row> rows(block.begin(), block.end());
+        co_yield rows;
+      }
     };
-    // NOTE: We have to switch the arguments, because the heap operations by
-    // default order descending...
-    auto comp = [&, this](const auto& a, const auto& b) {
-      return comparator_(projection(b), projection(a));
+    using RowGenerator = decltype(std::views::join(
+        ad_utility::OwningView{toRows(std::move(blockGenerators.front()))}));
+    std::vector<RowGenerator> rowGenerators;
+    rowGenerators.reserve(blockGenerators.size());
+    for (auto& blocks : blockGenerators) {
+      rowGenerators.push_back(std::views::join(
+          ad_utility::OwningView{toRows(std::move(blocks))}));
+    }
+    auto comp = [this](const Row& a, const Row& b) -> bool {
+      return comparator_(a, b);
     };
-    std::vector<P> pq;
+    // The buffers of all the merges together use about as much memory as one
+    // output block, which is accounted for by `computeBlockSizeForMergePhase`.
+    auto memoryForMerge = MemorySize::bytes(blockSizeOutput *
+                                            this->numColumns_ * sizeof(Id));
 
-    for (auto& gen : rowGenerators) {
-      pq.emplace_back(gen.begin(), gen.end());
-    }
-    std::ranges::make_heap(pq, comp);
     IdTableStatic<NumStaticCols> result(this->writer_.numColumns(),
                                         this->writer_.allocator());
     result.reserve(blockSizeOutput);
     size_t numPopped = 0;
-    while (!pq.empty()) {
-      std::ranges::pop_heap(pq, comp);
-      auto& min = pq.back();
-      result.push_back(*min.first);
-      ++(min.first);
-      if (min.first == min.second) {
-        pq.pop_back();
-      } else {
-        std::ranges::push_heap(pq, comp);
-      }
-      if (result.size() >= blockSizeOutput) {
-        numPopped += result.numRows();
-        co_yield std::move(result).template toStatic<N>();
-        // The `result` will be moved away, so we have to reset it again.
-        result = IdTableStatic<NumStaticCols>(this->writer_.numColumns(),
-                                              this->writer_.allocator());
-        result.reserve(blockSizeOutput);
+    for (const auto& rows :
+         ad_utility::parallelMultiwayMerge<Row, true, RowSizeGetter>(
+             memoryForMerge, rowGenerators, comp, MERGE_BLOCKSIZE)) {
+      for (const auto& row : rows) {
+        result.push_back(row);
+        if (result.size() >= blockSizeOutput) {
+          numPopped += result.numRows();
+          co_yield std::move(result).template toStatic<N>();
+          // The `result` will be moved away, so we have to reset it again.
+          result = IdTableStatic<NumStaticCols>(this->writer_.numColumns(),
+                                                this->writer_.allocator());
+          result.reserve(blockSizeOutput);
+        }
       }
     }
     numPopped += result.numRows();
@@ -0,0 +1,139 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "util/Exception.h"
+
+namespace columnBasedIdTable::detail {
+// A column of an `IdTable` that is shared by all its copies until one of them
+// is modified (copy on write). The elements are stored in a reference-counted
+// `Vector` (e.g. `std::vector`). Copying a `CopyOnWriteVector` only copies the
+// pointer, and each function that (potentially) modifies the elements first
+// copies them into a new `Vector` if the current one is shared by another
+// `CopyOnWriteVector`. This allows an `IdTable` to be cloned in O(number of
+// columns), s.t. an operation can reuse the unchanged columns of (possibly
+// cached) inputs and only allocate the new or modified columns.
+//
+// Note: Like for `std::vector`, pointers and iterators into the elements are
+// invalidated when the elements are modified, here also if they are shared.
+// For reading the elements of a shared column, the const functions should be
+// used, because the non-const functions copy the elements.
+template <typename Vector>
+class CopyOnWriteVector {
+ public:
+  using value_type = typename Vector::value_type;
+  using allocator_type = typename Vector::allocator_type;
+  using size_type = size_t;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+
+ private:
+  // `nullptr` for an empty column, which is the state after a move.
+  std::shared_ptr<Vector> vector_;
+  allocator_type allocator_;
+
+ public:
+  explicit CopyOnWriteVector(allocator_type allocator)
+      : allocator_{std::move(allocator)} {}
+  CopyOnWriteVector(size_t numElements, allocator_type allocator)
+      : CopyOnWriteVector{std::move(allocator)} {
+    resize(numElements);
+  }
+  template <typename It>
+  CopyOnWriteVector(It begin, It end, allocator_type allocator)
+      : vector_{std::make_shared<Vector>(begin, end, allocator)},
+        allocator_{std::move(allocator)} {}
+
+  // Copies share the elements, moving leaves an empty column.
+  CopyOnWriteVector(const CopyOnWriteVector&) = default;
+  CopyOnWriteVector& operator=(const CopyOnWriteVector&) = default;
+  CopyOnWriteVector(CopyOnWriteVector&&) noexcept = default;
+  CopyOnWriteVector& operator=(CopyOnWriteVector&&) noexcept = default;
+
+  allocator_type get_allocator() const { return allocator_; }
+
+  // True iff the elements are shared with another `CopyOnWriteVector`.
+  bool isShared() const { return vector_ && vector_.use_count() > 1; }
+
+  // Read-only access, which never copies.
+  size_t size() const { return vector_ ? vector_->size() : 0; }
+  bool empty() const { return size() == 0; }
+  size_t capacity() const { return vector_ ? vector_->capacity() : 0; }
+  const value_type* data() const {
+    return vector_ ? vector_->data() : nullptr;
+  }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + size(); }
+  const value_type& operator[](size_t i) const { return (*vector_)[i]; }
+  const value_type& at(size_t i) const {
+    AD_CONTRACT_CHECK(i < size());
+    return (*vector_)[i];
+  }
+  const value_type& back() const { return vector_->back(); }
+
+  // Mutable access to the elements, which copies them if they are shared.
+  value_type* data() { return getUnique()->data(); }
+  iterator begin() { return data(); }
+  iterator end() { return data() + size(); }
+  value_type& operator[](size_t i) { return (*getUnique())[i]; }
+  value_type& at(size_t i) {
+    AD_CONTRACT_CHECK(i < size());
+    return (*getUnique())[i];
+  }
+  value_type& back() { return getUnique()->back(); }
+
+  // Functions that change the size. If the elements are shared, only the
+  // remaining ones are copied.
+  void resize(size_t numElements) {
+    getUnique(numElements)->resize(numElements);
+  }
+  void reserve(size_t numElements) { getUnique()->reserve(numElements); }
+  void clear() { getUnique(0)->clear(); }
+  void shrink_to_fit() {
+    if (vector_ && !isShared()) {
+      vector_->shrink_to_fit();
+    }
+  }
+  void emplace_back() { getUnique()->emplace_back(); }
+  void push_back(const value_type& value) { getUnique()->push_back(value); }
+  void erase(const_iterator first, const_iterator last) {
+    size_t firstIdx = first - std::as_const(*this).begin();
+    size_t lastIdx = last - std::as_const(*this).begin();
+    auto& vector = *getUnique();
+    vector.erase(vector.begin() + firstIdx, vector.begin() + lastIdx);
+  }
+  template <typename It>
+  void insert(const_iterator position, It first, It last) {
+    size_t idx = position - std::as_const(*this).begin();
+    auto& vector = *getUnique();
+    vector.insert(vector.begin() + idx, first, last);
+  }
+
+ private:
+  // Return the `vector_` after making sure that there is one and that it is
+  // not shared. A shared `vector_` is replaced by a copy of its first
+  // `numElementsToKeep` elements.
+  Vector* getUnique(size_t numElementsToKeep = static_cast<size_t>(-1)) {
+    if (!vector_) {
+      vector_ = std::make_shared<Vector>(allocator_);
+    } else if (vector_.use_count() > 1) [[unlikely]] {
+      auto begin = vector_->begin();
+      auto end = begin + std::min(numElementsToKeep, vector_->size());
+      vector_ = std::make_shared<Vector>(begin, end, allocator_);
+    }
+    return vector_.get();
+  }
+};
+
+// True iff `T` is an instantiation of `CopyOnWriteVector`.
+template <typename T>
+constexpr bool isCopyOnWriteVector = false;
+template <typename Vector>
+constexpr bool isCopyOnWriteVector<CopyOnWriteVector<Vector>> = true;
+}  // namespace columnBasedIdTable::detail
@@ -12,6 +12,7 @@
 #include <variant>
 #include <vector>
 
+#include "engine/idTable/CopyOnWriteVector.h"
 #include "engine/idTable/IdTableRow.h"
 #include "engine/idTable/VectorWithElementwiseMove.h"
 #include "global/Id.h"
@@ -423,10 +424,16 @@ class IdTable {
   // exception: If `this` is a view (because the `isView` template parameter is
   // `true`), then the copy constructor will also create a (const and
   // non-owning) view, but `clone` will create a mutable deep copy of the data
-  // that the view points to
+  // that the view points to. If the columns are `CopyOnWriteVector`s (which
+  // is the case for the default `IdTable`), the copy shares them with this
+  // table until either of them is modified, so cloning is cheap.
   IdTable<T, NumColumns, ColumnStorage, IsView::False> clone() const
       requires std::is_copy_constructible_v<Storage> &&
                std::is_copy_constructible_v<ColumnStorage> {
+    if constexpr (!isView && detail::isCopyOnWriteVector<ColumnStorage>) {
+      return IdTable<T, NumColumns, ColumnStorage, IsView::False>{
+          Storage(data()), numColumns_, numRows_, allocator_};
+    }
     Storage storage;
     for (const auto& column : getColumns()) {
       storage.emplace_back(column.begin(), column.end(), getAllocator());
@@ -559,6 +566,17 @@ class IdTable {
     std::swap(data()[c1], data()[c2]);
   }
 
+  // Add a column at the end of the table, all the entries of which are equal
+  // to `value`. Together with `setColumnSubset`, this allows to change the
+  // layout of the columns without copying the existing columns.
+  void addColumn(const T& value) requires(isDynamic && columnsAreAllocatable) {
+    ColumnStorage column{allocator_};
+    column.resize(numRows_);
+    std::ranges::fill(column, value);
+    data().push_back(std::move(column));
+    ++numColumns_;
+  }
+
   // Helper `struct` that stores a pointer to this table and has an `operator()`
   // that can be called with a reference to an `IdTable` and the index of a row
   // and then returns a `row_reference_restricted` to that row. This struct is
@@ -638,15 +656,27 @@ class IdTable {
   // of this `IdTable`. `beginIt` and `endIt` must *not* point into this
   // IdTable, else the behavior is undefined.
   //
-  // TODO<joka921> Insert can be done much more efficiently when `beginIt` and
-  // `endIt` are iterators to a different column-major `IdTable`. Implement
-  // this case.
+  // Note: If all the rows of another `IdTable` are to be inserted, the more
+  // efficient overload of `insertAtEnd` below should be used.
   void insertAtEnd(auto beginIt, auto endIt) {
     for (; beginIt != endIt; ++beginIt) {
       push_back(*beginIt);
     }
   }
 
+  // Insert all the rows of `other` at the end of this `IdTable`. The columns
+  // are copied one after the other. `other` must have the same number of
+  // columns and must not be this `IdTable` itself.
+  void insertAtEnd(const IdTable& other) requires(!isView) {
+    AD_CONTRACT_CHECK(other.numColumns() == numColumns());
+    AD_CONTRACT_CHECK(&other != this);
+    size_t oldSize = size();
+    resize(oldSize + other.size());
+    for (size_t i = 0; i < numColumns(); ++i) {
+      std::ranges::copy(other.getColumn(i), getColumn(i).begin() + oldSize);
+    }
+  }
+
   // Check whether two `IdTables` have the same content. Mostly used for unit
   // testing.
   bool operator==(const IdTable& other) const requires(!isView) {
@@ -714,7 +744,10 @@ class IdTable {
 namespace detail {
 using DefaultAllocator =
     ad_utility::default_init_allocator<Id, ad_utility::AllocatorWithLimit<Id>>;
-using IdVector = std::vector<Id, DefaultAllocator>;
+// The columns of an `IdTable` are shared by its clones until they are
+// modified (see `CopyOnWriteVector`).
+using IdVector = columnBasedIdTable::detail::CopyOnWriteVector<
+    std::vector<Id, DefaultAllocator>>;
 }  // namespace detail
 
 /// The general IdTable class. Can be modified and owns its data. If COLS > 0,
@@ -0,0 +1,553 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "engine/CallFixedSize.h"
+#include "engine/idTable/IdTable.h"
+#include "global/Id.h"
+#include "util/AllocatorWithLimit.h"
+#include "util/Exception.h"
+#include "util/ParallelExecution.h"
+#include "util/ParallelMultiwayMerge.h"
+
+// Sorting algorithms for `IdTable`s that run on multiple threads and take the
+// column-based layout of the `IdTable` into account. The rows of the `IdTable`
+// are not moved during the sorting. Instead, a permutation of the row indices
+// is computed first, which is then applied to one column after the other.
+// There is also a partial sort (`topKRowIndices`) for `ORDER BY ... LIMIT` and
+// a sort into a copy of a table that must not be changed
+// (`sortedCopyByColumns`).
+namespace ad_utility::idTableSorting {
+
+// Is called by the sorts below between their steps (e.g. between the passes of
+// the radix sort, between the merged blocks, and between the columns to which
+// the permutation is applied). It cancels the sort by throwing, which leaves
+// the table in a valid but unspecified state. An empty function never cancels.
+using CheckCancellation = std::function<void()>;
+
+// Tables with fewer rows are sorted with `std::sort` directly, because the
+// setup of the more elaborate algorithms below does not pay off.
+static constexpr size_t MIN_SIZE_FOR_PERMUTATION_SORT = 10'000;
+// The minimal number of rows that each thread processes. This keeps the
+// overhead of starting the threads small compared to the actual work.
+static constexpr size_t MIN_ROWS_PER_THREAD = 100'000;
+
+namespace detail {
+// The entries that are sorted by the radix sort: the bits of the sort key and
+// the index of the row in the original table.
+struct KeyAndRowIndex {
+  uint64_t key_;
+  uint64_t rowIndex_;
+  static KeyAndRowIndex make(uint64_t key, uint64_t rowIndex) {
+    return {key, rowIndex};
+  }
+  uint64_t key() const { return key_; }
+  uint64_t rowIndex() const { return rowIndex_; }
+};
+
+// A narrow variant of `KeyAndRowIndex` that packs both into a single 64-bit
+// word. It can be used if the row indices and the keys fit into 32 bits each,
+// where the key is the offset of the bits of the `Id` from the smallest bits
+// in its column (see `getBasesForNarrowKeys`). The radix sort is limited by
+// the memory bandwidth, so the half-sized entries make it almost twice as
+// fast.
+struct NarrowKeyAndRowIndex {
+  uint64_t bits_;
+  static constexpr uint64_t lowerMask = (uint64_t{1} << 32) - 1;
+  static NarrowKeyAndRowIndex make(uint64_t key, uint64_t rowIndex) {
+    return {(key << 32) | rowIndex};
+  }
+  uint64_t key() const { return bits_ >> 32; }
+  uint64_t rowIndex() const { return bits_ & lowerMask; }
+};
+
+// The radix sort works on one byte of the key at a time.
+static constexpr size_t BITS_PER_DIGIT = 8;
+static constexpr size_t NUM_BUCKETS = 1 << BITS_PER_DIGIT;
+static constexpr size_t NUM_DIGITS = 64 / BITS_PER_DIGIT;
+
+// Call the `checkCancellation` if it is not empty.
+inline void check(const CheckCancellation& checkCancellation) {
+  if (checkCancellation) {
+    checkCancellation();
+  }
+}
+
+// Return the number of threads that should be used for `numRows` rows if at
+// most `numThreads` threads are available.
+inline size_t getNumThreads(size_t numRows, size_t numThreads) {
+  return std::clamp(numRows / MIN_ROWS_PER_THREAD, size_t{1},
+                    std::max(numThreads, size_t{1}));
+}
+
+// Return the half-open range of indices that the thread with index `threadIdx`
+// has to process when `numElements` elements are processed by `numThreads`
+// threads.
+inline std::array<size_t, 2> getChunk(size_t threadIdx, size_t numThreads,
+                                      size_t numElements) {
+  return {threadIdx * numElements / numThreads,
+          (threadIdx + 1) * numElements / numThreads};
+}
+
+// Stably sort the `entries` by their `key()` via an LSD radix sort on
+// `numThreads` threads. The `buffer` must have the same size as the
+// `entries`, its contents are overwritten. Digits that are the same for all the
+// keys are skipped, which is very effective for `Id`s because all `Id`s of the
+// same datatype share their most significant bits.
+template <typename Vector>
+void radixSort(Vector& entries, Vector& buffer, size_t numThreads,
+               const CheckCancellation& checkCancellation = {}) {
+  AD_CORRECTNESS_CHECK(entries.size() == buffer.size());
+  if (entries.empty()) {
+    return;
+  }
+  numThreads = getNumThreads(entries.size(), numThreads);
+
+  // Determine the bits in which at least two keys differ.
+  std::vector<uint64_t> differingBitsPerThread(numThreads, 0);
+  uint64_t firstKey = entries.front().key();
+  runConcurrently(numThreads, [&](size_t threadIdx) {
+    auto [begin, end] = getChunk(threadIdx, numThreads, entries.size());
+    uint64_t differingBits = 0;
+    for (size_t i = begin; i < end; ++i) {
+      differingBits |= entries[i].key() ^ firstKey;
+    }
+    differingBitsPerThread[threadIdx] = differingBits;
+  });
+  uint64_t differingBits = 0;
+  for (auto bits : differingBitsPerThread) {
+    differingBits |= bits;
+  }
+
+  using Histogram = std::array<size_t, NUM_BUCKETS>;
+  std::vector<Histogram> histograms(numThreads);
+  for (size_t digit = 0; digit < NUM_DIGITS; ++digit) {
+    size_t shift = digit * BITS_PER_DIGIT;
+    if (((differingBits >> shift) & (NUM_BUCKETS - 1)) == 0) {
+      continue;
+    }
+    check(checkCancellation);
+    auto getBucket = [shift](const auto& entry) {
+      return (entry.key() >> shift) & (NUM_BUCKETS - 1);
+    };
+    // Count the number of keys per bucket for each chunk.
+    runConcurrently(numThreads, [&](size_t threadIdx) {
+      auto& histogram = histograms[threadIdx];
+      histogram.fill(0);
+      auto [begin, end] = getChunk(threadIdx, numThreads, entries.size());
+      for (size_t i = begin; i < end; ++i) {
+        ++histogram[getBucket(entries[i])];
+      }
+    });
+    // Turn the counts into the starting positions. Within a bucket, the
+    // entries from the first chunk come first etc., which makes the sort
+    // stable.
+    size_t position = 0;
+    for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+      for (auto& histogram : histograms) {
+        size_t count = histogram[bucket];
+        histogram[bucket] = position;
+        position += count;
+      }
+    }
+    runConcurrently(numThreads, [&](size_t threadIdx) {
+      auto& positions = histograms[threadIdx];
+      auto [begin, end] = getChunk(threadIdx, numThreads, entries.size());
+      for (size_t i = begin; i < end; ++i) {
+        buffer[positions[getBucket(entries[i])]++] = entries[i];
+      }
+    });
+    std::swap(entries, buffer);
+  }
+}
+
+// Reorder the rows of the `table` s.t. row `i` of the result is row
+// `permutation[i]` of the original table. The columns are permuted one after
+// the other, each of them on `numThreads` threads.
+void applyPermutation(IdTable& table, const auto& permutation,
+                      size_t numThreads,
+                      const CheckCancellation& checkCancellation = {}) {
+  AD_CORRECTNESS_CHECK(permutation.size() == table.numRows());
+  numThreads = getNumThreads(table.numRows(), numThreads);
+  std::vector<Id, IdTable::Allocator> buffer(table.numRows(),
+                                             table.getAllocator());
+  for (size_t col = 0; col < table.numColumns(); ++col) {
+    check(checkCancellation);
+    auto column = table.getColumn(col);
+    runConcurrently(numThreads, [&](size_t threadIdx) {
+      auto [begin, end] = getChunk(threadIdx, numThreads, buffer.size());
+      for (size_t i = begin; i < end; ++i) {
+        buffer[i] = column[permutation[i]];
+      }
+    });
+    std::ranges::copy(buffer, column.begin());
+  }
+}
+
+// Return a copy of the `table` in which row `i` is row `permutation[i]` of the
+// `table`. The columns are copied one after the other, each of them on
+// `numThreads` threads.
+inline IdTable copyWithPermutation(
+    const IdTable& table, const auto& permutation, size_t numThreads,
+    const CheckCancellation& checkCancellation = {}) {
+  AD_CORRECTNESS_CHECK(permutation.size() == table.numRows());
+  numThreads = getNumThreads(table.numRows(), numThreads);
+  IdTable result{table.numColumns(), table.getAllocator()};
+  result.resize(table.numRows());
+  for (size_t col = 0; col < table.numColumns(); ++col) {
+    check(checkCancellation);
+    auto input = table.getColumn(col);
+    auto output = result.getColumn(col);
+    runConcurrently(numThreads, [&](size_t threadIdx) {
+      auto [begin, end] = getChunk(threadIdx, numThreads, output.size());
+      for (size_t i = begin; i < end; ++i) {
+        output[i] = input[permutation[i]];
+      }
+    });
+  }
+  return result;
+}
+
+// If the radix sort of the `table` by the `sortColumns` can use the
+// `NarrowKeyAndRowIndex` entries, return the smallest bits of each of the
+// `sortColumns`, which are subtracted from the bits of the `Id`s to obtain the
+// keys. This is the case if the `table` has at most 2^32 rows and the bits of
+// the `Id`s of each of the `sortColumns` differ by less than 2^32, which is
+// typical for example for a column of `VocabIndex`es. Else return
+// `std::nullopt`.
+inline std::optional<std::vector<uint64_t>> getBasesForNarrowKeys(
+    const IdTable& table, std::span<const ColumnIndex> sortColumns,
+    size_t numThreads) {
+  if (table.numRows() > NarrowKeyAndRowIndex::lowerMask + 1) {
+    return std::nullopt;
+  }
+  numThreads = getNumThreads(table.numRows(), numThreads);
+  std::vector<uint64_t> bases;
+  for (auto col : sortColumns) {
+    auto column = table.getColumn(col);
+    std::vector<std::array<uint64_t, 2>> minAndMaxPerThread(
+        numThreads, {std::numeric_limits<uint64_t>::max(), 0});
+    runConcurrently(numThreads, [&](size_t threadIdx) {
+      auto [begin, end] = getChunk(threadIdx, numThreads, column.size());
+      auto& [min, max] = minAndMaxPerThread[threadIdx];
+      for (size_t i = begin; i < end; ++i) {
+        min = std::min(min, column[i].getBits());
+        max = std::max(max, column[i].getBits());
+      }
+    });
+    uint64_t min = std::numeric_limits<uint64_t>::max();
+    uint64_t max = 0;
+    for (const auto& [threadMin, threadMax] : minAndMaxPerThread) {
+      min = std::min(min, threadMin);
+      max = std::max(max, threadMax);
+    }
+    if (min <= max && max - min > NarrowKeyAndRowIndex::lowerMask) {
+      return std::nullopt;
+    }
+    bases.push_back(min);
+  }
+  return bases;
+}
+
+// Compute the permutation that sorts the `table` by the `sortColumns` (at most
+// two) via the radix sort. The keys of the entries are the bits of the `Id`s
+// minus the `bases` (one per sort column). The `rowIndex()`es of the returned
+// entries form the permutation.
+template <typename Entry>
+auto radixSortPermutation(const IdTable& table,
+                          std::span<const ColumnIndex> sortColumns,
+                          size_t numThreads, std::span<const uint64_t> bases,
+                          const CheckCancellation& checkCancellation = {}) {
+  AD_CORRECTNESS_CHECK(sortColumns.size() == 1 || sortColumns.size() == 2);
+  AD_CORRECTNESS_CHECK(bases.size() == sortColumns.size());
+  using Allocator =
+      std::allocator_traits<IdTable::Allocator>::rebind_alloc<Entry>;
+  using Vector = std::vector<Entry, Allocator>;
+  Vector entries(table.numRows(), Allocator{table.getAllocator()});
+  Vector buffer(table.numRows(), Allocator{table.getAllocator()});
+  size_t numThreadsForRows = getNumThreads(table.numRows(), numThreads);
+
+  // The sort is stable, so we first sort by the last sort column, then by the
+  // first one.
+  for (size_t i = sortColumns.size(); i-- > 0;) {
+    auto column = table.getColumn(sortColumns[i]);
+    uint64_t base = bases[i];
+    bool isFirstPass = i + 1 == sortColumns.size();
+    runConcurrently(numThreadsForRows, [&](size_t threadIdx) {
+      auto [begin, end] =
+          getChunk(threadIdx, numThreadsForRows, table.numRows());
+      for (size_t j = begin; j < end; ++j) {
+        size_t rowIndex = isFirstPass ? j : entries[j].rowIndex();
+        entries[j] = Entry::make(column[rowIndex].getBits() - base, rowIndex);
+      }
+    });
+    radixSort(entries, buffer, numThreads, checkCancellation);
+  }
+  return entries;
+}
+
+// The indices of the rows of the `entries` of `radixSortPermutation`.
+inline auto getRowIndices(const auto& entries) {
+  return std::views::transform(entries,
+                               [](const auto& e) { return e.rowIndex(); });
+}
+
+// Compute the permutation that sorts the `table` by the `sortColumns` (at most
+// two) via the radix sort (with the narrow entries if possible) and return
+// `function(permutation)`.
+template <typename Function>
+decltype(auto) withRadixSortPermutation(
+    const IdTable& table, std::span<const ColumnIndex> sortColumns,
+    size_t numThreads, const Function& function,
+    const CheckCancellation& checkCancellation = {}) {
+  if (auto bases = getBasesForNarrowKeys(table, sortColumns, numThreads)) {
+    auto entries = radixSortPermutation<NarrowKeyAndRowIndex>(
+        table, sortColumns, numThreads, bases.value(), checkCancellation);
+    return function(getRowIndices(entries));
+  }
+  std::vector<uint64_t> bases(sortColumns.size(), 0);
+  auto entries = radixSortPermutation<KeyAndRowIndex>(
+      table, sortColumns, numThreads, bases, checkCancellation);
+  return function(getRowIndices(entries));
+}
+
+// Compute the permutation that sorts the `table` by the `sortColumns` (at most
+// two) and apply it.
+inline void radixSortIdTable(IdTable& table,
+                             std::span<const ColumnIndex> sortColumns,
+                             size_t numThreads,
+                             const CheckCancellation& checkCancellation = {}) {
+  withRadixSortPermutation(
+      table, sortColumns, numThreads,
+      [&](const auto& permutation) {
+        applyPermutation(table, permutation, numThreads, checkCancellation);
+      },
+      checkCancellation);
+}
+}  // namespace detail
+
+// Sort the rows of `table` according to the `comparison` on up to
+// `numThreads` threads. The table is split into chunks that are sorted
+// concurrently using `std::sort`. The sorted chunks are then merged using
+// `parallelMultiwayMerge` and the resulting permutation is applied to the
+// table.
+template <int WIDTH, typename Comparison>
+void sortWithComparison(IdTableStatic<WIDTH>& table,
+                        const Comparison& comparison, size_t numThreads,
+                        const CheckCancellation& checkCancellation = {}) {
+  size_t numChunks = detail::getNumThreads(table.numRows(), numThreads);
+  if (numChunks == 1 || table.numRows() < MIN_SIZE_FOR_PERMUTATION_SORT) {
+    std::sort(table.begin(), table.end(), comparison);
+    return;
+  }
+  using Allocator =
+      std::allocator_traits<IdTable::Allocator>::rebind_alloc<size_t>;
+  std::vector<size_t, Allocator> rowIndices(table.numRows(),
+                                            Allocator{table.getAllocator()});
+  std::iota(rowIndices.begin(), rowIndices.end(), size_t{0});
+  std::vector<std::span<const size_t>> chunks;
+  for (size_t i = 0; i < numChunks; ++i) {
+    auto [begin, end] = detail::getChunk(i, numChunks, table.numRows());
+    chunks.emplace_back(rowIndices.begin() + begin, rowIndices.begin() + end);
+  }
+  runConcurrently(numChunks, [&](size_t i) {
+    auto begin = table.begin() + chunks[i].front();
+    std::sort(begin, begin + chunks[i].size(), comparison);
+  });
+  detail::check(checkCancellation);
+
+  // Merge the indices of the rows of the sorted chunks.
+  auto compareRows = [&table, &comparison](const size_t& a,
+                                           const size_t& b) -> bool {
+    return comparison(table[a], table[b]);
+  };
+  std::vector<size_t, Allocator> permutation{
+      Allocator{table.getAllocator()}};
+  permutation.reserve(table.numRows());
+  for (const auto& block : parallelMultiwayMerge<size_t, false>(
+           MemorySize::max(), chunks, compareRows, 10'000)) {
+    detail::check(checkCancellation);
+    permutation.insert(permutation.end(), block.begin(), block.end());
+  }
+  rowIndices.clear();
+  rowIndices.shrink_to_fit();
+  IdTable dynamicTable = std::move(table).toDynamic();
+  detail::applyPermutation(dynamicTable, permutation, numThreads,
+                           checkCancellation);
+  table = std::move(dynamicTable).toStatic<WIDTH>();
+}
+
+// Return the indices of the first `k` rows of the `table` according to the
+// `comparison` in sorted order. Rows that are equal according to the
+// `comparison` are ordered by their index, so the result is the same as the
+// first `k` rows of a stable sort. The `table` is split into chunks that are
+// processed concurrently on up to `numThreads` threads, each of them keeps a
+// max-heap of its `k` best rows. The heaps of all the chunks are then merged.
+// This requires `O(k * numThreads)` additional memory and `O(n * log(k))`
+// time, where `n` is the number of rows.
+template <typename Table, typename Comparison>
+std::vector<size_t> topKRowIndices(const Table& table, size_t k,
+                                   const Comparison& comparison,
+                                   size_t numThreads) {
+  k = std::min(k, table.numRows());
+  if (k == 0) {
+    return {};
+  }
+  auto compareIndices = [&table, &comparison](size_t a, size_t b) {
+    if (comparison(table[a], table[b])) {
+      return true;
+    }
+    if (comparison(table[b], table[a])) {
+      return false;
+    }
+    return a < b;
+  };
+  size_t numChunks = detail::getNumThreads(table.numRows(), numThreads);
+  std::vector<std::vector<size_t>> heaps(numChunks);
+  runConcurrently(numChunks, [&](size_t chunkIdx) {
+    auto [begin, end] = detail::getChunk(chunkIdx, numChunks, table.numRows());
+    auto& heap = heaps[chunkIdx];
+    heap.reserve(std::min(k, end - begin));
+    for (size_t i = begin; i < end; ++i) {
+      if (heap.size() < k) {
+        heap.push_back(i);
+        std::ranges::push_heap(heap, compareIndices);
+      } else if (compareIndices(i, heap.front())) {
+        std::ranges::pop_heap(heap, compareIndices);
+        heap.back() = i;
+        std::ranges::push_heap(heap, compareIndices);
+      }
+    }
+  });
+
+  std::vector<size_t> result = std::move(heaps.front());
+  for (const auto& heap : heaps | std::views::drop(1)) {
+    result.insert(result.end(), heap.begin(), heap.end());
+  }
+  if (result.size() > k) {
+    std::ranges::nth_element(result, result.begin() + k, compareIndices);
+    result.resize(k);
+  }
+  std::ranges::sort(result, compareIndices);
+  return result;
+}
+
+// Sort the rows of `table` lexicographically by the `sortColumns` on up to
+// `numThreads` threads. For one or two sort columns, a radix sort on the bits
+// of the `Id`s is used, otherwise the comparison-based `sortWithComparison`
+// from above. If there is not enough memory for the radix sort, the table is
+// sorted in place via `std::sort` instead.
+inline void sortByColumns(IdTable& table,
+                          std::span<const ColumnIndex> sortColumns,
+                          size_t numThreads,
+                          const CheckCancellation& checkCancellation = {}) {
+  auto sortViaComparison = [&table, &sortColumns,
+                            &checkCancellation](size_t numThreads) {
+    auto comparison = [&sortColumns](const auto& row1, const auto& row2) {
+      for (auto col : sortColumns) {
+        if (row1[col] != row2[col]) {
+          return row1[col] < row2[col];
+        }
+      }
+      return false;
+    };
+    ad_utility::callFixedSize(table.numColumns(), [&]<int WIDTH>() {
+      IdTableStatic<WIDTH> staticTable = std::move(table).toStatic<WIDTH>();
+      sortWithComparison(staticTable, comparison, numThreads,
+                         checkCancellation);
+      table = std::move(staticTable).toDynamic();
+    });
+  };
+  if (sortColumns.size() > 2 ||
+      table.numRows() < MIN_SIZE_FOR_PERMUTATION_SORT) {
+    sortViaComparison(numThreads);
+    return;
+  }
+  try {
+    detail::radixSortIdTable(table, sortColumns, numThreads,
+                             checkCancellation);
+  } catch (const ad_utility::detail::AllocationExceedsLimitException&) {
+    // The radix sort allocates all of its buffers before it changes the table,
+    // so we can still fall back to the sort that needs no additional memory.
+    sortViaComparison(1);
+  }
+}
+
+// Return a copy of the `table` that is sorted lexicographically by the
+// `sortColumns`, without cloning the `table` first. The permutation that sorts
+// the `table` is computed on up to `numThreads` threads (via the radix sort for
+// one or two sort columns, else by sorting chunks of the row indices via
+// `std::sort` and merging them) and then applied while the columns are copied.
+// This is used for results that must not be changed because they are cached or
+// shared (e.g. when the same result is sorted in several orders). Throws an
+// `AllocationExceedsLimitException` if there is not enough memory.
+inline IdTable sortedCopyByColumns(
+    const IdTable& table, std::span<const ColumnIndex> sortColumns,
+    size_t numThreads, const CheckCancellation& checkCancellation = {}) {
+  const size_t numRows = table.numRows();
+  if ((sortColumns.size() == 1 || sortColumns.size() == 2) &&
+      numRows >= MIN_SIZE_FOR_PERMUTATION_SORT) {
+    return detail::withRadixSortPermutation(
+        table, sortColumns, numThreads,
+        [&](const auto& permutation) {
+          return detail::copyWithPermutation(table, permutation, numThreads,
+                                             checkCancellation);
+        },
+        checkCancellation);
+  }
+  auto compareRows = [&table, &sortColumns](const size_t& a,
+                                            const size_t& b) -> bool {
+    for (auto col : sortColumns) {
+      if (table(a, col) != table(b, col)) {
+        return table(a, col) < table(b, col);
+      }
+    }
+    return false;
+  };
+  using Allocator =
+      std::allocator_traits<IdTable::Allocator>::rebind_alloc<size_t>;
+  std::vector<size_t, Allocator> rowIndices(numRows,
+                                            Allocator{table.getAllocator()});
+  std::iota(rowIndices.begin(), rowIndices.end(), size_t{0});
+  size_t numChunks = detail::getNumThreads(numRows, numThreads);
+  if (numChunks == 1 || numRows < MIN_SIZE_FOR_PERMUTATION_SORT) {
+    std::ranges::sort(rowIndices, compareRows);
+    return detail::copyWithPermutation(table, rowIndices, numThreads,
+                                       checkCancellation);
+  }
+  std::vector<std::span<const size_t>> chunks;
+  for (size_t i = 0; i < numChunks; ++i) {
+    auto [begin, end] = detail::getChunk(i, numChunks, numRows);
+    chunks.emplace_back(rowIndices.begin() + begin, rowIndices.begin() + end);
+  }
+  runConcurrently(numChunks, [&](size_t i) {
+    auto [begin, end] = detail::getChunk(i, numChunks, numRows);
+    std::sort(rowIndices.begin() + begin, rowIndices.begin() + end,
+              compareRows);
+  });
+  detail::check(checkCancellation);
+  std::vector<size_t, Allocator> permutation{Allocator{table.getAllocator()}};
+  permutation.reserve(numRows);
+  for (const auto& block : parallelMultiwayMerge<size_t, false>(
+           MemorySize::max(), chunks, compareRows, 10'000)) {
+    detail::check(checkCancellation);
+    permutation.insert(permutation.end(), block.begin(), block.end());
+  }
+  rowIndices.clear();
+  rowIndices.shrink_to_fit();
+  return detail::copyWithPermutation(table, permutation, numThreads,
+                                     checkCancellation);
+}
+}  // namespace ad_utility::idTableSorting
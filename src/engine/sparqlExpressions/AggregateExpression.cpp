@@ -4,6 +4,7 @@
 
 #include "engine/sparqlExpressions/AggregateExpression.h"
 
+#include "engine/sparqlExpressions/ApproxCountDistinctExpression.h"
 #include "engine/sparqlExpressions/GroupConcatExpression.h"
 
 namespace sparqlExpression {
@@ -69,6 +70,15 @@ AggregateExpression<AggregateOperation, FinalOperation>::getVariableForCount()
   return std::nullopt;
 }
 
+// __________________________________________________________________________
+ExpressionResult CountExpression::evaluate(EvaluationContext* context) const {
+  if (_distinct && context->_qec.getQueryHints().approximate_) {
+    return ApproxCountDistinctExpression::countDistinctApproximately(
+        _child->evaluate(context), context);
+  }
+  return CountExpressionBase::evaluate(context);
+}
+
 #define INSTANTIATE_AGG_EXP(...)      \
   template class AggregateExpression< \
       Operation<2, FunctionAndValueGetters<__VA_ARGS__>>>;
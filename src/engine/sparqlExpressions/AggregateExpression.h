@@ -182,6 +182,13 @@ inline auto count = [](const auto& a, const auto& b) -> int64_t {
 using CountExpressionBase = AGG_EXP<decltype(count), IsValidValueGetter>;
 class CountExpression : public CountExpressionBase {
   using CountExpressionBase::CountExpressionBase;
+
+ public:
+  // In the approximate mode of the `QueryHints`, `COUNT(DISTINCT ...)` is
+  // estimated like `ql:approx-count-distinct`.
+  ExpressionResult evaluate(EvaluationContext* context) const override;
+
+ private:
   [[nodiscard]] std::optional<SparqlExpressionPimpl::VariableAndDistinctness>
   getVariableForCount() const override {
     auto optionalVariable = _child->getVariableOrNullopt();
@@ -0,0 +1,63 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "engine/sparqlExpressions/ApproxCountDistinctExpression.h"
+
+#include <cmath>
+
+#include "engine/sparqlExpressions/SparqlExpressionGenerators.h"
+#include "engine/sparqlExpressions/SparqlExpressionValueGetters.h"
+#include "util/HashSet.h"
+#include "util/HyperLogLog.h"
+
+using namespace sparqlExpression;
+using namespace sparqlExpression::detail;
+
+namespace {
+using Sketch = ad_utility::HyperLogLog<>;
+// Inputs with at most this many rows are counted exactly, the hash set of
+// their values is then not much larger than the registers of the `Sketch`.
+constexpr size_t maxInputSizeForExactCount = Sketch::numRegisters;
+}  // namespace
+
+// ____________________________________________________________________________
+ExpressionResult ApproxCountDistinctExpression::evaluate(
+    EvaluationContext* context) const {
+  return countDistinctApproximately(_child->evaluate(context), context);
+}
+
+// ____________________________________________________________________________
+ExpressionResult ApproxCountDistinctExpression::countDistinctApproximately(
+    ExpressionResult childResult, EvaluationContext* context) {
+  auto evaluator = [context]<SingleExpressionResult T>(
+                       T&& childResult) -> ExpressionResult {
+    size_t inputSize = getResultSize(*context, childResult);
+    auto operands =
+        makeGenerator(std::forward<T>(childResult), inputSize, context);
+    using Value = std::decay_t<decltype(*operands.begin())>;
+    auto isValid = [context](const Value& value) {
+      return IsValidValueGetter{}(value, context);
+    };
+
+    if (inputSize <= maxInputSizeForExactCount) {
+      ad_utility::HashSet<Value> distinctValues;
+      for (const auto& value : operands) {
+        if (isValid(value)) {
+          distinctValues.insert(value);
+        }
+      }
+      return Id::makeFromInt(static_cast<int64_t>(distinctValues.size()));
+    }
+
+    Sketch sketch;
+    absl::Hash<Value> hash;
+    for (const auto& value : operands) {
+      if (isValid(value)) {
+        sketch.add(hash(value));
+      }
+    }
+    return Id::makeFromInt(std::llround(sketch.estimate()));
+  };
+
+  return std::visit(evaluator, std::move(childResult));
+}
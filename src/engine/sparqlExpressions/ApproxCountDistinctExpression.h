@@ -0,0 +1,51 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include "absl/strings/str_cat.h"
+#include "engine/sparqlExpressions/SparqlExpression.h"
+
+namespace sparqlExpression {
+/// The aggregate `ql:approx-count-distinct(?x)`, which estimates the number of
+/// distinct bound values of `?x` with a `HyperLogLog` sketch instead of
+/// hashing or sorting all the values as `COUNT(DISTINCT ?x)` does. Inputs that
+/// are not larger than the registers of the sketch are counted exactly.
+class ApproxCountDistinctExpression : public SparqlExpression {
+ public:
+  explicit ApproxCountDistinctExpression(Ptr&& child)
+      : _child{std::move(child)} {
+    setIsInsideAggregate();
+  }
+
+  // __________________________________________________________________________
+  ExpressionResult evaluate(EvaluationContext* context) const override;
+
+  // Estimate the number of distinct bound values in the `childResult`. This
+  // is also used for `COUNT(DISTINCT ...)` in the approximate mode of the
+  // `QueryHints`.
+  static ExpressionResult countDistinctApproximately(
+      ExpressionResult childResult, EvaluationContext* context);
+
+  // _____________________________________________________________________
+  vector<Variable> getUnaggregatedVariables() override {
+    // This is an aggregation, so it never leaves any unaggregated variables.
+    return {};
+  }
+
+  // An `ApproxCountDistinctExpression` is an aggregate.
+  bool isAggregate() const override { return true; }
+
+  // __________________________________________________________________________
+  string getCacheKey(const VariableToColumnMap& varColMap) const override {
+    return absl::StrCat("APPROX_COUNT_DISTINCT(",
+                        _child->getCacheKey(varColMap), ")");
+  }
+
+  // __________________________________________________________________________
+  std::span<Ptr> childrenImpl() override { return {&_child, 1}; }
+
+ private:
+  Ptr _child;
+};
+}  // namespace sparqlExpression
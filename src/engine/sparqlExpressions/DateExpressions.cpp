@@ -59,9 +59,31 @@ constexpr auto extractMinutes =
 constexpr auto extractSeconds =
     extractTimeComponentImpl<&Date::getSecond, &Id::makeFromDouble>;
 
-NARY_EXPRESSION(YearExpression, 1, FV<decltype(extractYear), DateValueGetter>);
-NARY_EXPRESSION(MonthExpression, 1,
-                FV<decltype(extractMonth), DateValueGetter>);
+// The `YEAR` and `MONTH` functions additionally report their argument if it is
+// a variable, s.t. FILTERs on them can skip the blocks of an `IndexScan` that
+// contain no dates of the requested range (see `getDateRange`).
+template <typename Function, SparqlExpression::DateComponent component>
+class DateComponentExpression
+    : public NaryExpression<Operation<1, FV<Function, DateValueGetter>>> {
+  using Base = NaryExpression<Operation<1, FV<Function, DateValueGetter>>>;
+  using Base::Base;
+
+ public:
+  std::optional<std::pair<SparqlExpression::DateComponent, ::Variable>>
+  getDateComponentOfVariable() const override {
+    auto variable = this->children()[0]->getVariableOrNullopt();
+    if (!variable.has_value()) {
+      return std::nullopt;
+    }
+    return std::pair{component, std::move(variable.value())};
+  }
+};
+using YearExpression =
+    DateComponentExpression<decltype(extractYear),
+                            SparqlExpression::DateComponent::Year>;
+using MonthExpression =
+    DateComponentExpression<decltype(extractMonth),
+                            SparqlExpression::DateComponent::Month>;
 NARY_EXPRESSION(DayExpression, 1, FV<decltype(extractDay), DateValueGetter>);
 NARY_EXPRESSION(HoursExpression, 1,
                 FV<decltype(extractHours), DateValueGetter>);
@@ -28,10 +28,9 @@ class GroupConcatExpression : public SparqlExpression {
   ExpressionResult evaluate(EvaluationContext* context) const override {
     auto impl = [context,
                  this](SingleExpressionResult auto&& el) -> ExpressionResult {
-      std::string result;
+      std::string& result = concatenationBuffer();
+      result.clear();
       auto groupConcatImpl = [&result, this, context](auto generator) {
-        // TODO<joka921> Make this a configurable constant.
-        result.reserve(20000);
         for (auto& inp : generator) {
           const auto& s = detail::StringValueGetter{}(std::move(inp), context);
           if (s.has_value()) {
@@ -50,8 +49,12 @@ class GroupConcatExpression : public SparqlExpression {
       } else {
         groupConcatImpl(std::move(generator));
       }
-      result.shrink_to_fit();
-      return IdOrString(std::move(result));
+      // Copy the concatenation with its exact size.
+      IdOrString concatenation{std::string{result}};
+      if (result.capacity() > maxRetainedBufferCapacity) {
+        result = std::string{};
+      }
+      return concatenation;
     };
 
     auto childRes = child_->evaluate(context);
@@ -67,6 +70,9 @@ class GroupConcatExpression : public SparqlExpression {
 
   bool isDistinct() const override { return distinct_; }
 
+  // The separator that is put between the concatenated values.
+  const std::string& separator() const { return separator_; }
+
   [[nodiscard]] string getCacheKey(
       const VariableToColumnMap& varColMap) const override {
     return absl::StrCat("[ GROUP_CONCAT", distinct_ ? " DISTINCT " : "",
@@ -74,6 +80,18 @@ class GroupConcatExpression : public SparqlExpression {
   }
 
  private:
+  // The values of a group are concatenated in a buffer that is reused for all
+  // the groups that are evaluated by the same thread, s.t. its memory doesn't
+  // have to be allocated (and grown) again for each of the (possibly millions
+  // of) groups. Only the finished concatenation is copied. A buffer that has
+  // grown larger than `maxRetainedBufferCapacity` bytes is released after its
+  // group, s.t. a single large group doesn't keep the memory.
+  static constexpr size_t maxRetainedBufferCapacity = 1 << 20;
+  static std::string& concatenationBuffer() {
+    thread_local std::string buffer;
+    return buffer;
+  }
+
   // _________________________________________________________________________
   std::span<SparqlExpression::Ptr> childrenImpl() override {
     return {&child_, 1};
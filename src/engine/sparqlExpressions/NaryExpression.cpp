@@ -15,9 +15,27 @@ NARY_EXPRESSION(LongitudeExpression, 1,
 NARY_EXPRESSION(LatitudeExpression, 1,
                 FV<NumericIdWrapper<decltype(ad_utility::wktLatitude), true>,
                    LiteralFromIdGetter>);
-NARY_EXPRESSION(DistExpression, 2,
-                FV<NumericIdWrapper<decltype(ad_utility::wktDist), true>,
-                   LiteralFromIdGetter>);
+using DistExpressionBase = NaryExpression<
+    Operation<2, FV<NumericIdWrapper<decltype(ad_utility::wktDist), true>,
+                    LiteralFromIdGetter>>>;
+// The `geof:distance` function. It additionally reports its arguments if they
+// are two variables, s.t. the query planner can use a `SpatialJoin` for a
+// `FILTER` on the distance.
+class DistExpression : public DistExpressionBase {
+  using DistExpressionBase::DistExpressionBase;
+
+ public:
+  std::optional<std::pair<::Variable, ::Variable>> getDistanceArguments()
+      const override {
+    auto children = this->children();
+    auto left = children[0]->getVariableOrNullopt();
+    auto right = children[1]->getVariableOrNullopt();
+    if (!left.has_value() || !right.has_value()) {
+      return std::nullopt;
+    }
+    return std::pair{std::move(left.value()), std::move(right.value())};
+  }
+};
 
 }  // namespace detail
 
@@ -38,6 +38,9 @@ class NaryExpression : public SparqlExpression {
   [[nodiscard]] string getCacheKey(
       const VariableToColumnMap& varColMap) const override;
 
+  // _________________________________________________________________________
+  size_t getCostEstimatePerRow() const override;
+
  private:
   // _________________________________________________________________________
   std::span<SparqlExpression::Ptr> childrenImpl() override;
@@ -184,6 +187,26 @@ requires(isOperation<Op>) [[nodiscard]] string NaryExpression<Op>::getCacheKey(
   return key;
 }
 
+// _____________________________________________________________________________
+template <typename Op>
+requires(isOperation<Op>)
+size_t NaryExpression<Op>::getCostEstimatePerRow() const {
+  // Operations that work on the strings of their operands (e.g. `CONTAINS` or
+  // `STRLEN`) have to look up these strings for each row, which is much more
+  // expensive than working on the `Id`s directly.
+  using ValueGetters = typename Op::ValueGetters;
+  constexpr bool readsStrings = []<size_t... I>(std::index_sequence<I...>) {
+    return (... || ad_utility::SameAsAny<std::tuple_element_t<I, ValueGetters>,
+                                         StringValueGetter, LiteralFromIdGetter,
+                                         RegexValueGetter>);
+  }(std::make_index_sequence<std::tuple_size_v<ValueGetters>>{});
+  size_t cost = readsStrings ? 20 : 1;
+  for (const auto& child : children_) {
+    cost += child->getCostEstimatePerRow();
+  }
+  return cost;
+}
+
 // Define a class `Name` that is a strong typedef (via inheritance) from
 // `NaryExpresssion<N, X, ...>`. The strong typedef (vs. a simple `using`
 // declaration) is used to improve compiler messages as the resulting class has
@@ -1,6 +1,7 @@
 //  Copyright 2023, University of Freiburg,
 //                  Chair of Algorithms and Data Structures.
 //  Author: Johannes Kalmbach <kalmbacj@cs.uni-freiburg.de>
+#include "absl/cleanup/cleanup.h"
 #include "engine/sparqlExpressions/NaryExpressionImpl.h"
 
 namespace sparqlExpression {
@@ -45,7 +46,7 @@ inline auto orLambda = [](TernaryBool a, TernaryBool b) {
   return Id::makeUndefined();
 };
 
-NARY_EXPRESSION(OrExpression, 2,
+NARY_EXPRESSION(NaryOrExpression, 2,
                 FV<decltype(orLambda), EffectiveBooleanValueGetter>,
                 SET<SetOfIntervals::Union>);
 
@@ -60,10 +61,138 @@ inline auto andLambda = [](TernaryBool a, TernaryBool b) {
   }
   return Id::makeUndefined();
 };
-NARY_EXPRESSION(AndExpression, 2,
+NARY_EXPRESSION(NaryAndExpression, 2,
                 FV<decltype(andLambda), EffectiveBooleanValueGetter>,
                 SET<SetOfIntervals::Intersection>);
 
+// An `&&` or `||` expression (the `NaryBase`) that evaluates its right operand
+// only on the rows for which the result is not already determined by the left
+// operand being `decidingValue`. In SPARQL's three-valued logic both operators
+// are commutative (also in the presence of errors), so the operands are
+// ordered s.t. the cheaper one is evaluated first.
+template <typename NaryBase, typename Combine, TernaryBool decidingValue>
+class ShortCircuitExpression : public NaryBase {
+ private:
+  // Only an expensive right operand (e.g. a `REGEX` or `CONTAINS`) is worth
+  // the overhead of the short-circuit evaluation.
+  static constexpr size_t minCostOfRightOperand = 10;
+  // If the undetermined rows are fragmented into intervals that are shorter
+  // than this on average, the right operand is evaluated on all rows at once.
+  static constexpr size_t minAverageIntervalSize = 16;
+
+ public:
+  ShortCircuitExpression(SparqlExpression::Ptr child1,
+                         SparqlExpression::Ptr child2)
+      : NaryBase{orderByCost(std::move(child1), std::move(child2))} {}
+
+  // ___________________________________________________________________________
+  ExpressionResult evaluate(EvaluationContext* context) const override {
+    auto children = this->children();
+    const SparqlExpression& left = *children[0];
+    const SparqlExpression& right = *children[1];
+    // Inside a GROUP BY the right operand has to see all the rows of a group
+    // (e.g. for aggregates or `RAND()`).
+    if (context->_isPartOfGroupBy || right.containsAggregate() ||
+        right.getCostEstimatePerRow() < minCostOfRightOperand) {
+      return NaryBase::evaluate(context);
+    }
+
+    const size_t size = context->size();
+    std::vector<TernaryBool> leftValues;
+    leftValues.reserve(size);
+    std::visit(
+        [&]<SingleExpressionResult T>(T&& leftResult) {
+          for (TernaryBool value :
+               valueGetterGenerator(size, context, AD_FWD(leftResult),
+                                    EffectiveBooleanValueGetter{})) {
+            leftValues.push_back(value);
+          }
+        },
+        left.evaluate(context));
+
+    // The maximal intervals of rows for which the result is not yet
+    // determined, relative to `context->_beginIndex`.
+    std::vector<std::pair<size_t, size_t>> undetermined;
+    for (size_t i = 0; i < size; ++i) {
+      if (leftValues[i] == decidingValue) {
+        continue;
+      }
+      if (!undetermined.empty() && undetermined.back().second == i) {
+        ++undetermined.back().second;
+      } else {
+        undetermined.emplace_back(i, i + 1);
+      }
+    }
+    if (undetermined.size() * minAverageIntervalSize > size) {
+      undetermined.assign(1, {0, size});
+    }
+
+    VectorWithMemoryLimit<Id> result{context->_allocator};
+    result.resize(size, Combine{}(decidingValue, decidingValue));
+    const size_t beginIndex = context->_beginIndex;
+    const size_t endIndex = context->_endIndex;
+    absl::Cleanup restoreRange{[context, beginIndex, endIndex]() {
+      context->_beginIndex = beginIndex;
+      context->_endIndex = endIndex;
+    }};
+    for (auto [first, last] : undetermined) {
+      context->_beginIndex = beginIndex + first;
+      context->_endIndex = beginIndex + last;
+      std::visit(
+          [&]<SingleExpressionResult T>(T&& rightResult) {
+            size_t i = first;
+            auto values =
+                valueGetterGenerator(last - first, context, AD_FWD(rightResult),
+                                     EffectiveBooleanValueGetter{});
+            for (TernaryBool value : values) {
+              result[i] = Combine{}(leftValues[i], value);
+              ++i;
+            }
+          },
+          right.evaluate(context));
+    }
+    return result;
+  }
+
+ private:
+  // Return the children s.t. the cheaper one is the first (left) one.
+  static typename NaryBase::Children orderByCost(SparqlExpression::Ptr child1,
+                                                 SparqlExpression::Ptr child2) {
+    if (child2->getCostEstimatePerRow() < child1->getCostEstimatePerRow()) {
+      std::swap(child1, child2);
+    }
+    return {std::move(child1), std::move(child2)};
+  }
+};
+
+class OrExpression
+    : public ShortCircuitExpression<NaryOrExpression, decltype(orLambda),
+                                    TernaryBool::True> {
+  using ShortCircuitExpression::ShortCircuitExpression;
+};
+class AndExpression
+    : public ShortCircuitExpression<NaryAndExpression, decltype(andLambda),
+                                    TernaryBool::False> {
+  using ShortCircuitExpression::ShortCircuitExpression;
+
+ public:
+  // The intersection of the date ranges of the operands if they are for the
+  // same variable. Otherwise either of the ranges also contains all the
+  // values for which the conjunction is true.
+  std::optional<DateRangeData> getDateRange() const override {
+    auto children = this->children();
+    auto left = children[0]->getDateRange();
+    auto right = children[1]->getDateRange();
+    if (!left.has_value()) {
+      return right;
+    }
+    if (right.has_value() && right->variable_ == left->variable_) {
+      return left->intersect(right.value());
+    }
+    return left;
+  }
+};
+
 }  // namespace detail
 
 using namespace detail;
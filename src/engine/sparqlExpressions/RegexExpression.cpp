@@ -4,6 +4,8 @@
 
 #include "./RegexExpression.h"
 
+#include <cctype>
+
 #include "engine/sparqlExpressions/LiteralExpression.h"
 #include "engine/sparqlExpressions/NaryExpression.h"
 #include "engine/sparqlExpressions/SparqlExpressionGenerators.h"
@@ -65,6 +67,106 @@ std::optional<std::string> getPrefixRegex(std::string regex) {
   return regex;
 }
 
+// ____________________________________________________________________________
+std::string getRequiredLiteral(std::string_view regex) {
+  std::string best;
+  // The literal characters since the last special character of the regex.
+  std::string current;
+  // True iff the last atom of the regex is the last character of `current`.
+  bool lastAtomIsLiteral = false;
+  auto finishCurrent = [&]() {
+    if (current.size() > best.size()) {
+      best = current;
+    }
+    current.clear();
+    lastAtomIsLiteral = false;
+  };
+  // Remove the last (UTF-8) character from `current`.
+  auto removeLastCharacter = [&current]() {
+    while (!current.empty() &&
+           (static_cast<unsigned char>(current.back()) & 0xC0) == 0x80) {
+      current.pop_back();
+    }
+    if (!current.empty()) {
+      current.pop_back();
+    }
+  };
+  // Skip a `?` after a quantifier, which makes it non-greedy.
+  auto skipNonGreedy = [&regex](size_t& i) {
+    if (i + 1 < regex.size() && regex[i + 1] == '?') {
+      ++i;
+    }
+  };
+  for (size_t i = 0; i < regex.size(); ++i) {
+    char c = regex[i];
+    if (c == '\\') {
+      if (i + 1 == regex.size()) {
+        return "";
+      }
+      char next = regex[++i];
+      if (std::ispunct(static_cast<unsigned char>(next))) {
+        current.push_back(next);
+        lastAtomIsLiteral = true;
+      } else if (std::string_view{"dDwWsSbB"}.find(next) !=
+                 std::string_view::npos) {
+        finishCurrent();
+      } else {
+        // Escapes with parameters (e.g. `\x41` or `\p{L}`) are not analyzed.
+        return "";
+      }
+    } else if (c == '|') {
+      return "";
+    } else if (c == '(') {
+      // The content of a group might be optional, and the group might contain
+      // an alternation, so we stop here.
+      break;
+    } else if (c == '[') {
+      // Skip the character class, note that a `]` directly at its beginning
+      // is a literal.
+      finishCurrent();
+      size_t j = i + 1;
+      if (j < regex.size() && regex[j] == '^') {
+        ++j;
+      }
+      if (j < regex.size() && regex[j] == ']') {
+        ++j;
+      }
+      while (j < regex.size() && regex[j] != ']') {
+        j += regex[j] == '\\' ? 2 : 1;
+      }
+      if (j >= regex.size()) {
+        return "";
+      }
+      i = j;
+    } else if (c == '*' || c == '?' || c == '{') {
+      // The last atom is optional or repeated (`{` is conservatively treated
+      // in the same way).
+      if (lastAtomIsLiteral) {
+        removeLastCharacter();
+      }
+      finishCurrent();
+      if (c == '{') {
+        i = regex.find('}', i);
+        if (i == std::string_view::npos) {
+          return "";
+        }
+      }
+      skipNonGreedy(i);
+    } else if (c == '+') {
+      // The last atom occurs at least once, but might be repeated.
+      finishCurrent();
+      skipNonGreedy(i);
+    } else if (c == '.' || c == '^' || c == '$') {
+      finishCurrent();
+    } else {
+      current.push_back(c);
+      lastAtomIsLiteral = true;
+    }
+  }
+  finishCurrent();
+  return best;
+}
+
 // Assert that `input` starts and ends with double quotes `"` and remove those
 // quotes.
 std::string removeQuotes(std::string_view input) {
@@ -92,6 +194,7 @@ RegexExpression::RegexExpression(
   }
   std::string regexString;
   std::string originalRegexString;
+  bool ignoreCase = false;
   if (auto regexPtr =
           dynamic_cast<const StringLiteralExpression*>(regex.get())) {
     originalRegexString = regexPtr->value().normalizedLiteralContent().get();
@@ -127,6 +230,7 @@ RegexExpression::RegexExpression(
             "combination of them")};
       }
 
+      ignoreCase = flags.find('i') != std::string::npos;
       // In Google RE2 the flags are directly part of the regex.
       if (!flags.empty()) {
         regexString = absl::StrCat("(?", flags, ":", regexString + ")");
@@ -138,10 +242,20 @@ RegexExpression::RegexExpression(
     }
   }
 
+  // The required literal is computed from the regex without the flags (which
+  // are a group in `regexString`).
+  auto requiredLiteralWithoutFlags =
+      detail::getRequiredLiteral(detail::removeQuotes(originalRegexString));
   regexAsString_ = regexString;
   if (auto opt = detail::getPrefixRegex(regexString)) {
     regex_ = std::move(opt.value());
   } else {
+    requiredLiteral_ = detail::getRequiredLiteral(regexString);
+    if (!requiredLiteralWithoutFlags.empty()) {
+      substringFilter_ = SubstringFilterData{
+          dynamic_cast<const VariableExpression&>(*child_).value(),
+          std::move(requiredLiteralWithoutFlags), ignoreCase};
+    }
     regex_.emplace<RE2>(regexString, RE2::Quiet);
     const auto& r = std::get<RE2>(regex_);
     if (r.error_code() != RE2::NoError) {
@@ -238,15 +352,42 @@ ExpressionResult RegexExpression::evaluateNonPrefixRegex(
   VectorWithMemoryLimit<Id> result{context->_allocator};
   result.reserve(resultSize);
 
+  const auto& regex = std::get<RE2>(regex_);
+  auto matches = [this, &regex](const std::string& str) {
+    if (!requiredLiteral_.empty() &&
+        str.find(requiredLiteral_) == std::string::npos) {
+      return false;
+    }
+    return RE2::PartialMatch(str, regex);
+  };
+  if (substringFilter_.has_value()) {
+    std::call_once(candidatesAreComputed_, [this, context] {
+      candidates_ = substringFilter_->getCandidates(context->_qec.getIndex());
+    });
+  }
+  auto memoizedResults = memoizedResults_.wlock();
   auto impl = [&]<typename ValueGetter>(const ValueGetter& getter) {
     for (auto id : detail::makeGenerator(variable, resultSize, context)) {
+      if (candidates_.has_value() && candidates_->isNoMatch(id)) {
+        result.push_back(Id::makeFromBool(false));
+        continue;
+      }
+      // Only the `Id`s from the vocabulary are memoized, because the `Id`s
+      // of the local vocabulary are different for each input.
+      bool isVocabId = id.getDatatype() == Datatype::VocabIndex;
+      if (isVocabId) {
+        if (auto it = memoizedResults->find(id); it != memoizedResults->end()) {
+          result.push_back(it->second);
+          continue;
+        }
+      }
       auto str = getter(id, context);
-      if (!str.has_value()) {
-        result.push_back(Id::makeUndefined());
-      } else {
-        result.push_back(Id::makeFromBool(
-            RE2::PartialMatch(str.value(), std::get<RE2>(regex_))));
+      Id resultId = str.has_value() ? Id::makeFromBool(matches(str.value()))
+                                    : Id::makeUndefined();
+      if (isVocabId && memoizedResults->size() < maxNumMemoizedResults) {
+        memoizedResults->emplace(id, resultId);
       }
+      result.push_back(resultId);
     }
   };
   if (childIsStrExpression_) {
@@ -276,6 +417,27 @@ bool RegexExpression::isPrefixExpression() const {
   return std::holds_alternative<std::string>(regex_);
 }
 
+// ____________________________________________________________________________
+auto RegexExpression::getPrefixFilter() const
+    -> std::optional<PrefixFilterData> {
+  if (!isPrefixExpression()) {
+    return std::nullopt;
+  }
+  const auto& variable =
+      dynamic_cast<const VariableExpression&>(*child_).value();
+  return PrefixFilterData{variable, std::get<std::string>(regex_),
+                          childIsStrExpression_};
+}
+
+// ____________________________________________________________________________
+size_t RegexExpression::getCostEstimatePerRow() const {
+  // A prefix regex is evaluated via a range of the (sorted) vocabulary, so it
+  // is cheap. For all other regexes, the string of each row has to be looked
+  // up and matched.
+  size_t cost = isPrefixExpression() ? 1 : 100;
+  return cost + child_->getCostEstimatePerRow();
+}
+
 // ____________________________________________________________________________
 auto RegexExpression::getEstimatesForFilterExpression(
     uint64_t inputSize,
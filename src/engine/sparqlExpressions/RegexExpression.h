@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 
 #include "engine/sparqlExpressions/LiteralExpression.h"
 #include "engine/sparqlExpressions/SparqlExpression.h"
 #include "re2/re2.h"
+#include "util/HashMap.h"
+#include "util/Synchronized.h"
 
 namespace sparqlExpression {
 class RegexExpression : public SparqlExpression {
@@ -24,6 +27,25 @@ class RegexExpression : public SparqlExpression {
   // the regex.
   bool childIsStrExpression_ = false;
 
+  // A substring that is contained in every match of a non-prefix regex (see
+  // `detail::getRequiredLiteral`). Strings that don't contain it are rejected
+  // without running the regex engine.
+  std::string requiredLiteral_;
+
+  // The required literal of a non-prefix regex (also for a case-insensitive
+  // regex), with which the literals from the vocabulary that can't match are
+  // rejected via the `TrigramIndex`. The candidates are computed once.
+  std::optional<SubstringFilterData> substringFilter_;
+  mutable std::once_flag candidatesAreComputed_;
+  mutable std::optional<SubstringFilterData::Candidates> candidates_;
+
+  // The results of a non-prefix regex for the `Id`s from the vocabulary that
+  // were already evaluated, s.t. each distinct vocabulary entry is matched
+  // only once (with at most `maxNumMemoizedResults` entries).
+  mutable ad_utility::Synchronized<ad_utility::HashMap<Id, Id>>
+      memoizedResults_;
+  static constexpr size_t maxNumMemoizedResults = 1'000'000;
+
  public:
   // `child` must be a `VariableExpression` and `regex` must be a
   // `LiteralExpression` that stores a string, else an exception will be thrown.
@@ -39,11 +61,22 @@ class RegexExpression : public SparqlExpression {
   // _________________________________________________________________________
   [[nodiscard]] bool isPrefixExpression() const;
 
+  // The prefix of a prefix regex.
+  std::optional<PrefixFilterData> getPrefixFilter() const override;
+
+  // The required literal of a non-prefix regex.
+  std::optional<SubstringFilterData> getSubstringFilter() const override {
+    return substringFilter_;
+  }
+
   // _________________________________________________________________________
   Estimates getEstimatesForFilterExpression(
       uint64_t inputSize,
       const std::optional<Variable>& firstSortedVariable) const override;
 
+  // _________________________________________________________________________
+  size_t getCostEstimatePerRow() const override;
+
  private:
   std::span<SparqlExpression::Ptr> childrenImpl() override;
   // Internal implementations that are called by `evaluate`.
@@ -60,5 +93,11 @@ namespace detail {
 // suceeds, the prefix is returned without the leading `^` and with all escaping
 // undone. Else, `std::nullopt` is returned.
 std::optional<std::string> getPrefixRegex(std::string regex);
+
+// Return the longest string that is a substring of every match of the
+// `regex`, as far as this can be determined by a simple scan of the regex
+// (everything after the first group is ignored). Return the empty string if
+// no such literal was found or if the regex contains an alternation.
+std::string getRequiredLiteral(std::string_view regex);
 }  // namespace detail
 }  // namespace sparqlExpression
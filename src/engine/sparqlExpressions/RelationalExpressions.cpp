@@ -142,11 +142,11 @@ requires AreComparable<S1, S2> ExpressionResult evaluateRelationalExpression(
     auto impl = [&](const auto& value2) -> std::optional<ExpressionResult> {
       auto columnIndex = context->getColumnIndexForVariable(value1);
       auto valueId = makeValueId(value2, context);
+      constexpr static bool value2IsString =
+          !ad_utility::isSimilar<decltype(valueId), Id>;
       // TODO<C++23> Use `std::ranges::starts_with`.
       if (const auto& cols = context->_columnsByWhichResultIsSorted;
           !cols.empty() && cols[0] == columnIndex) {
-        constexpr static bool value2IsString =
-            !ad_utility::isSimilar<decltype(valueId), Id>;
         if constexpr (value2IsString) {
           return evaluateWithBinarySearch<Comp>(value1, valueId.first,
                                                 valueId.second, context);
@@ -155,6 +155,15 @@ requires AreComparable<S1, S2> ExpressionResult evaluateRelationalExpression(
                                                 context);
         }
       }
+      if constexpr (!value2IsString) {
+        // Compare the complete column with the constant in a tight loop.
+        auto column =
+            sparqlExpression::detail::getIdsFromVariable(value1, context);
+        result.resize(column.size());
+        valueIdComparators::compareColumnWithConstant<Comp>(column, valueId,
+                                                            result);
+        return std::move(result);
+      }
       return std::nullopt;
     };
     std::optional<ExpressionResult> resultFromBinarySearch;
@@ -310,6 +319,150 @@ RelationalExpression<Comp>::getLanguageFilterExpression() const {
   }
 }
 
+// _____________________________________________________________________________
+template <Comparison Comp>
+std::optional<SparqlExpression::VariableComparisonData>
+RelationalExpression<Comp>::getVariableComparison() const {
+  // We support both directions: `?x < 42` and `42 > ?x`.
+  auto getData = [](const auto& left, const auto& right,
+                    Comparison comparison)
+      -> std::optional<VariableComparisonData> {
+    const auto* varPtr = dynamic_cast<const VariableExpression*>(left.get());
+    const auto* idPtr = dynamic_cast<const IdExpression*>(right.get());
+    if (!varPtr || !idPtr) {
+      return std::nullopt;
+    }
+    return VariableComparisonData{varPtr->value(), comparison, idPtr->value()};
+  };
+  if (auto data = getData(children_[0], children_[1], Comp)) {
+    return data;
+  }
+  return getData(children_[1], children_[0],
+                 getComparisonForSwappedArguments(Comp));
+}
+
+// _____________________________________________________________________________
+template <Comparison Comp>
+std::optional<SparqlExpression::DistanceComparisonData>
+RelationalExpression<Comp>::getDistanceComparison() const {
+  // We support both directions: `geof:distance(?a, ?b) < 42` and
+  // `42 > geof:distance(?a, ?b)`.
+  auto getData = [](const auto& left, const auto& right,
+                    Comparison comparison)
+      -> std::optional<DistanceComparisonData> {
+    if (comparison != Comparison::LT && comparison != Comparison::LE) {
+      return std::nullopt;
+    }
+    auto variables = left->getDistanceArguments();
+    const auto* idPtr = dynamic_cast<const IdExpression*>(right.get());
+    if (!variables.has_value() || !idPtr) {
+      return std::nullopt;
+    }
+    Id constant = idPtr->value();
+    double maxDistance;
+    if (constant.getDatatype() == Datatype::Int) {
+      maxDistance = static_cast<double>(constant.getInt());
+    } else if (constant.getDatatype() == Datatype::Double) {
+      maxDistance = constant.getDouble();
+    } else {
+      return std::nullopt;
+    }
+    return DistanceComparisonData{std::move(variables.value().first),
+                                  std::move(variables.value().second),
+                                  maxDistance, comparison == Comparison::LE};
+  };
+  if (auto data = getData(children_[0], children_[1], Comp)) {
+    return data;
+  }
+  return getData(children_[1], children_[0],
+                 getComparisonForSwappedArguments(Comp));
+}
+
+// _____________________________________________________________________________
+template <Comparison Comp>
+std::optional<SparqlExpression::DateRangeData>
+RelationalExpression<Comp>::getDateRange() const {
+  // The values `x` in `[min, max]` (both inclusive) with
+  // `x <comparison> constant`.
+  auto getInterval = [](Comparison comparison, int64_t constant, int64_t min,
+                        int64_t max)
+      -> std::optional<std::pair<int64_t, int64_t>> {
+    using enum Comparison;
+    switch (comparison) {
+      case LT:
+        return std::pair{min, std::min(constant - 1, max)};
+      case LE:
+        return std::pair{min, std::min(constant, max)};
+      case EQ:
+        return std::pair{std::max(constant, min), std::min(constant, max)};
+      case GE:
+        return std::pair{std::max(constant, min), max};
+      case GT:
+        return std::pair{std::max(constant + 1, min), max};
+      default:
+        return std::nullopt;
+    }
+  };
+  auto getData = [&getInterval](const auto& left, const auto& right,
+                                Comparison comparison)
+      -> std::optional<DateRangeData> {
+    const auto* idPtr = dynamic_cast<const IdExpression*>(right.get());
+    if (!idPtr || comparison == Comparison::NE) {
+      return std::nullopt;
+    }
+    Id constant = idPtr->value();
+    // `?d <comparison> date`, which can only be true for dates. All the dates
+    // of the month of the constant are part of the range.
+    if (auto variable = left->getVariableOrNullopt();
+        variable.has_value() && constant.getDatatype() == Datatype::Date) {
+      DateRangeData data{std::move(variable.value())};
+      DateOrLargeYear date = constant.getDate();
+      std::pair<int64_t, int> month{date.getYear(),
+                                    date.getMonth().value_or(0)};
+      if (comparison != Comparison::GE && comparison != Comparison::GT) {
+        data.last_ = month;
+      }
+      if (comparison != Comparison::LE && comparison != Comparison::LT) {
+        data.first_ = month;
+      }
+      return data;
+    }
+    // `YEAR(?d) <comparison> integer` or `MONTH(?d) <comparison> integer`.
+    auto dateComponent = left->getDateComponentOfVariable();
+    if (!dateComponent.has_value() ||
+        constant.getDatatype() != Datatype::Int) {
+      return std::nullopt;
+    }
+    auto& [component, variable] = dateComponent.value();
+    DateRangeData data{std::move(variable)};
+    if (component == DateComponent::Year) {
+      auto [first, last] =
+          getInterval(comparison, constant.getInt(), DateOrLargeYear::minYear,
+                      DateOrLargeYear::maxYear)
+              .value();
+      if (first > last) {
+        // The range is empty.
+        std::swap(data.first_, data.last_);
+      } else {
+        data.first_ = {first, 0};
+        data.last_ = {last, 12};
+      }
+    } else {
+      // Only dates with a month have a `MONTH`.
+      auto [first, last] =
+          getInterval(comparison, constant.getInt(), 1, 12).value();
+      data.firstMonth_ = static_cast<int>(first);
+      data.lastMonth_ = static_cast<int>(std::max(last, first - 1));
+    }
+    return data;
+  };
+  if (auto data = getData(children_[0], children_[1], Comp)) {
+    return data;
+  }
+  return getData(children_[1], children_[0],
+                 getComparisonForSwappedArguments(Comp));
+}
+
 template <Comparison comp>
 SparqlExpression::Estimates
 RelationalExpression<comp>::getEstimatesForFilterExpression(
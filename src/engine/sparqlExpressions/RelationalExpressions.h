@@ -38,6 +38,21 @@ class RelationalExpression : public SparqlExpression {
   // the appropriate data.
   std::optional<LangFilterData> getLanguageFilterExpression() const override;
 
+  // Check if this expression has the form `?var < constant` (or one of the
+  // other comparisons) where the constant is an `Id` and return the
+  // appropriate data.
+  std::optional<VariableComparisonData> getVariableComparison()
+      const override;
+
+  // Check if this expression has the form `geof:distance(?a, ?b) < constant`
+  // (see `SparqlExpressionPimpl::getDistanceComparison`).
+  std::optional<DistanceComparisonData> getDistanceComparison()
+      const override;
+
+  // Check if this expression compares `YEAR(?d)` or `MONTH(?d)` with an
+  // integer, or `?d` with a date (see `SparqlExpressionPimpl::getDateRange`).
+  std::optional<DateRangeData> getDateRange() const override;
+
   // These expressions are typically used inside `FILTER` clauses, so we need
   // proper estimates.
   Estimates getEstimatesForFilterExpression(
@@ -29,6 +29,9 @@ class SampleExpression : public SparqlExpression {
     return {};
   }
 
+  // A `SampleExpression` is an aggregate.
+  bool isAggregate() const override { return true; }
+
   // __________________________________________________________________________
   string getCacheKey(const VariableToColumnMap& varColMap) const override {
     return absl::StrCat("SAMPLE(", _child->getCacheKey(varColMap), ")");
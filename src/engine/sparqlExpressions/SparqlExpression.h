@@ -124,8 +124,26 @@ class SparqlExpression {
     return std::nullopt;
   }
 
-  // For the following three functions (`containsLangExpression`,
-  // `getLanguageFilterExpression`, and `getEstimatesForFilterExpression`, see
+  // If this expression is `geof:distance(?a, ?b)` for two variables, return
+  // these variables. Otherwise, return std::nullopt.
+  virtual std::optional<std::pair<::Variable, ::Variable>>
+  getDistanceArguments() const {
+    return std::nullopt;
+  }
+
+  // If this expression is `YEAR(?x)` or `MONTH(?x)` for a variable `?x`,
+  // return which of the two functions it is and the variable. Otherwise,
+  // return std::nullopt.
+  enum struct DateComponent { Year, Month };
+  virtual std::optional<std::pair<DateComponent, ::Variable>>
+  getDateComponentOfVariable() const {
+    return std::nullopt;
+  }
+
+  // For the following eight functions (`containsLangExpression`,
+  // `getLanguageFilterExpression`, `getVariableComparison`,
+  // `getDistanceComparison`, `getDateRange`, `getPrefixFilter`,
+  // `getSubstringFilter`, and `getEstimatesForFilterExpression`, see
   // the documentation of the functions of the same names in
   // `SparqlExpressionPimpl.h`. Each of them has a default implementation that
   // is correct for most of the expressions.
@@ -142,6 +160,36 @@ class SparqlExpression {
     return std::nullopt;
   }
 
+  // ___________________________________________________________________________
+  using VariableComparisonData = SparqlExpressionPimpl::VariableComparisonData;
+  virtual std::optional<VariableComparisonData> getVariableComparison() const {
+    return std::nullopt;
+  }
+
+  // ___________________________________________________________________________
+  using DistanceComparisonData = SparqlExpressionPimpl::DistanceComparisonData;
+  virtual std::optional<DistanceComparisonData> getDistanceComparison() const {
+    return std::nullopt;
+  }
+
+  // ___________________________________________________________________________
+  using DateRangeData = SparqlExpressionPimpl::DateRangeData;
+  virtual std::optional<DateRangeData> getDateRange() const {
+    return std::nullopt;
+  }
+
+  // ___________________________________________________________________________
+  using PrefixFilterData = SparqlExpressionPimpl::PrefixFilterData;
+  virtual std::optional<PrefixFilterData> getPrefixFilter() const {
+    return std::nullopt;
+  }
+
+  // ___________________________________________________________________________
+  using SubstringFilterData = SparqlExpressionPimpl::SubstringFilterData;
+  virtual std::optional<SubstringFilterData> getSubstringFilter() const {
+    return std::nullopt;
+  }
+
   // ___________________________________________________________________________
   using Estimates = SparqlExpressionPimpl::Estimates;
   virtual Estimates getEstimatesForFilterExpression(
@@ -153,6 +201,18 @@ class SparqlExpression {
     return {inputSizeEstimate, inputSizeEstimate};
   }
 
+  // A rough estimate of the relative cost of evaluating this expression for a
+  // single row. It is used to evaluate the cheaper operand of `&&` and `||`
+  // first. The default implementation assumes a constant cost for this
+  // expression itself, plus the cost of the children.
+  virtual size_t getCostEstimatePerRow() const {
+    size_t cost = 1;
+    for (const auto& child : children()) {
+      cost += child->getCostEstimatePerRow();
+    }
+    return cost;
+  }
+
   // Returns true iff this expression is a simple constant. Default
   // implementation returns `false`.
   virtual bool isConstantExpression() const { return false; }
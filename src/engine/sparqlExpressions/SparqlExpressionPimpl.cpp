@@ -4,11 +4,32 @@
 
 #include "./SparqlExpressionPimpl.h"
 
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <ranges>
+
 #include "engine/sparqlExpressions/LiteralExpression.h"
 #include "engine/sparqlExpressions/SparqlExpression.h"
+#include "index/Index.h"
+#include "index/TrigramIndex.h"
 
 namespace sparqlExpression {
 
+namespace {
+// Add the ranges of the values that are not stored in the vocabulary (for
+// example inline strings, encoded IRIs, and numbers) to the `ranges`.
+void addNonVocabRanges(std::vector<std::pair<ValueId, ValueId>>& ranges) {
+  auto firstVocabId = ValueId::makeFromVocabIndex(VocabIndex::make(0));
+  auto lastVocabId =
+      ValueId::makeFromVocabIndex(VocabIndex::make(ValueId::maxIndex));
+  ranges.emplace_back(ValueId::makeUndefined(),
+                      ValueId::fromBits(firstVocabId.getBits() - 1));
+  ranges.emplace_back(ValueId::fromBits(lastVocabId.getBits() + 1),
+                      ValueId::fromBits(~uint64_t{0}));
+}
+}  // namespace
+
 // __________________________________________________________________________
 SparqlExpressionPimpl::SparqlExpressionPimpl(
     std::shared_ptr<SparqlExpression>&& pimpl, std::string descriptor)
@@ -84,6 +105,189 @@ SparqlExpressionPimpl::getLanguageFilterExpression() const {
   return _pimpl->getLanguageFilterExpression();
 }
 
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::getVariableComparison() const
+    -> std::optional<VariableComparisonData> {
+  return _pimpl->getVariableComparison();
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::getDistanceComparison() const
+    -> std::optional<DistanceComparisonData> {
+  return _pimpl->getDistanceComparison();
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::getDateRange() const
+    -> std::optional<DateRangeData> {
+  return _pimpl->getDateRange();
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::DateRangeData::intersect(
+    const DateRangeData& other) const -> DateRangeData {
+  AD_CONTRACT_CHECK(variable_ == other.variable_);
+  return {variable_, std::max(first_, other.first_),
+          std::min(last_, other.last_),
+          std::max(firstMonth_, other.firstMonth_),
+          std::min(lastMonth_, other.lastMonth_)};
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::DateRangeData::getIdRange() const
+    -> std::optional<std::pair<ValueId, ValueId>> {
+  using D = DateOrLargeYear;
+  auto [first, last] = std::pair{first_, last_};
+  if (first.first == last.first) {
+    first.second = std::max(first.second, firstMonth_);
+    last.second = std::min(last.second, lastMonth_);
+  } else if (first == std::pair<int64_t, int>{D::minYear, 0} &&
+             last == std::pair<int64_t, int>{D::maxYear, 12}) {
+    return std::nullopt;
+  }
+  auto makeId = [](int64_t year, int month) {
+    return ValueId::makeFromDate(D::getFirstOfYearAndMonth(year, month));
+  };
+  if (first > last) {
+    return std::pair{makeId(D::maxYear, 0), makeId(D::minYear, 0)};
+  }
+  ValueId firstId = makeId(first.first, first.second);
+  // The last `ValueId` is the one before the first `ValueId` of the next month
+  // (or year).
+  bool isLargeYear = last.first < Date::minYear || last.first > Date::maxYear;
+  std::pair<int64_t, int> next =
+      last.second == 12 || isLargeYear ? std::pair{last.first + 1, 0}
+                                       : std::pair{last.first, last.second + 1};
+  if (next.first > D::maxYear) {
+    return std::pair{firstId, ValueId::makeFromDate(
+                                  D{D::maxYear, D::Type::DateTime})};
+  }
+  return std::pair{firstId, ValueId::fromBits(
+                                makeId(next.first, next.second).getBits() - 1)};
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::getPrefixFilter() const
+    -> std::optional<PrefixFilterData> {
+  return _pimpl->getPrefixFilter();
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::PrefixFilterData::getIdRanges(
+    const Index& index) const -> std::vector<std::pair<ValueId, ValueId>> {
+  std::vector<std::pair<ValueId, ValueId>> ranges;
+  auto addPrefixRange = [&index, &ranges](const std::string& prefix) {
+    auto [begin, end] = index.prefix_range(prefix);
+    if (begin < end) {
+      ranges.emplace_back(begin, ValueId::fromBits(end.getBits() - 1));
+    }
+  };
+  addPrefixRange(absl::StrCat("\"", prefix_));
+  if (strIsApplied_) {
+    addPrefixRange(absl::StrCat("<", prefix_));
+  }
+  // The `prefix_range` only covers the internal vocabulary.
+  size_t internalVocabSize = index.getVocab().size();
+  if (internalVocabSize <= ValueId::maxIndex) {
+    ranges.emplace_back(
+        ValueId::makeFromVocabIndex(VocabIndex::make(internalVocabSize)),
+        ValueId::makeFromVocabIndex(VocabIndex::make(ValueId::maxIndex)));
+  }
+  addNonVocabRanges(ranges);
+  return ranges;
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::getSubstringFilter() const
+    -> std::optional<SubstringFilterData> {
+  return _pimpl->getSubstringFilter();
+}
+
+// _____________________________________________________________________________
+bool SparqlExpressionPimpl::SubstringFilterData::Candidates::isNoMatch(
+    ValueId id) const {
+  if (id.getDatatype() != Datatype::VocabIndex ||
+      !trigramIndex_->isIndexed(id.getVocabIndex())) {
+    return false;
+  }
+  return !std::ranges::binary_search(indices_, id.getVocabIndex().get());
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::SubstringFilterData::getCandidates(
+    const Index& index) const -> std::optional<Candidates> {
+  const TrigramIndex& trigramIndex = index.getTrigramIndex();
+  if (trigramIndex.empty()) {
+    return std::nullopt;
+  }
+  auto indices = trigramIndex.getCandidates(substring_, ignoreCase_);
+  if (!indices.has_value()) {
+    return std::nullopt;
+  }
+  return Candidates{&trigramIndex, std::move(indices.value())};
+}
+
+// _____________________________________________________________________________
+auto SparqlExpressionPimpl::SubstringFilterData::getIdRanges(
+    const Index& index) const
+    -> std::optional<std::vector<std::pair<ValueId, ValueId>>> {
+  auto candidates = getCandidates(index);
+  if (!candidates.has_value()) {
+    return std::nullopt;
+  }
+  // The half-open ranges of the vocabulary indices that might match.
+  std::vector<std::pair<uint64_t, uint64_t>> vocabRanges;
+  auto addVocabRange = [&vocabRanges](uint64_t begin, uint64_t end) {
+    if (begin >= end) {
+      return;
+    }
+    if (!vocabRanges.empty() && vocabRanges.back().second == begin) {
+      vocabRanges.back().second = end;
+    } else {
+      vocabRanges.emplace_back(begin, end);
+    }
+  };
+  const auto& indices = candidates->indices_;
+  auto candidate = indices.begin();
+  uint64_t endOfLastIndexedRange = 0;
+  for (auto [begin, end] : candidates->trigramIndex_->indexedRanges()) {
+    addVocabRange(endOfLastIndexedRange, begin);
+    for (; candidate != indices.end() && *candidate < end; ++candidate) {
+      addVocabRange(*candidate, *candidate + 1);
+    }
+    endOfLastIndexedRange = end;
+  }
+  addVocabRange(endOfLastIndexedRange, ValueId::maxIndex + 1);
+
+  // Merge the ranges with the smallest gaps between them.
+  if (vocabRanges.size() > maxNumRanges) {
+    std::vector<uint64_t> gaps;
+    for (size_t i = 0; i + 1 < vocabRanges.size(); ++i) {
+      gaps.push_back(vocabRanges[i + 1].first - vocabRanges[i].second);
+    }
+    auto nth = gaps.begin() + (vocabRanges.size() - maxNumRanges - 1);
+    std::ranges::nth_element(gaps, nth);
+    uint64_t maxMergedGap = *nth;
+    std::vector<std::pair<uint64_t, uint64_t>> merged{vocabRanges.front()};
+    for (const auto& range : vocabRanges | std::views::drop(1)) {
+      if (range.first - merged.back().second <= maxMergedGap) {
+        merged.back().second = range.second;
+      } else {
+        merged.push_back(range);
+      }
+    }
+    vocabRanges = std::move(merged);
+  }
+
+  std::vector<std::pair<ValueId, ValueId>> ranges;
+  for (auto [begin, end] : vocabRanges) {
+    ranges.emplace_back(ValueId::makeFromVocabIndex(VocabIndex::make(begin)),
+                        ValueId::makeFromVocabIndex(VocabIndex::make(end - 1)));
+  }
+  addNonVocabRanges(ranges);
+  return ranges;
+}
+
 // _____________________________________________________________________________
 auto SparqlExpressionPimpl::getEstimatesForFilterExpression(
     uint64_t inputSizeEstimate,
@@ -9,10 +9,15 @@
 #include <vector>
 
 #include "engine/VariableToColumnMap.h"
+#include "global/ValueIdComparators.h"
 #include "parser/data/Variable.h"
+#include "util/Date.h"
 #include "util/HashMap.h"
 #include "util/HashSet.h"
 
+class Index;
+class TrigramIndex;
+
 namespace sparqlExpression {
 
 class SparqlExpression;
@@ -98,6 +103,119 @@ class SparqlExpressionPimpl {
   // Return true iff the `LANG()` function is used inside this expression.
   bool containsLangExpression() const;
 
+  // If `this` is an expression of the form `?variable <comparison> constant`
+  // or `constant <comparison> ?variable`, where the constant is a single `Id`
+  // (for example a number or a date), return the variable, the comparison and
+  // the constant. The comparison is normalized s.t. the variable is on the
+  // left. Else return `std::nullopt`.
+  struct VariableComparisonData {
+    Variable variable_;
+    valueIdComparators::Comparison comparison_;
+    ValueId constant_;
+  };
+  std::optional<VariableComparisonData> getVariableComparison() const;
+
+  // If `this` is an expression of the form `geof:distance(?a, ?b) < constant`
+  // (or `<=`, or with swapped arguments of the comparison), where the constant
+  // is a number, return the two variables, the constant (the maximal distance
+  // in km) and whether the maximal distance itself is allowed. Else return
+  // `std::nullopt`.
+  struct DistanceComparisonData {
+    Variable left_;
+    Variable right_;
+    double maxDistance_;
+    bool includeMaxDistance_;
+  };
+  std::optional<DistanceComparisonData> getDistanceComparison() const;
+
+  // If `this` is an expression that can only be true if the value of a single
+  // variable is a date in a certain range of years and months, for example
+  // `YEAR(?d) = 2020`, `YEAR(?d) >= 2015 && YEAR(?d) < 2020`,
+  // `YEAR(?d) = 2020 && MONTH(?d) = 3`, or `?d >= "2020-03-15"^^xsd:date`,
+  // return the variable and the range. Else return `std::nullopt`.
+  struct DateRangeData {
+    Variable variable_;
+    // The first and the last year and month of the range (both inclusive),
+    // where the month 0 stands for a date without a month (`xsd:gYear`).
+    std::pair<int64_t, int> first_{DateOrLargeYear::minYear, 0};
+    std::pair<int64_t, int> last_{DateOrLargeYear::maxYear, 12};
+    // The months to which the dates are additionally restricted in each year
+    // (for example by `MONTH(?d) = 3`), both inclusive.
+    int firstMonth_ = 0;
+    int lastMonth_ = 12;
+
+    // The intersection of this range with the `other` range (of the same
+    // variable).
+    DateRangeData intersect(const DateRangeData& other) const;
+
+    // Return the smallest and the largest `ValueId` of a date in this range
+    // (both inclusive). The first `ValueId` is larger than the second one if
+    // the range is empty. The months are only taken into account if the range
+    // consists of a single year. Return `std::nullopt` if the range is not
+    // restricted at all.
+    std::optional<std::pair<ValueId, ValueId>> getIdRange() const;
+  };
+  std::optional<DateRangeData> getDateRange() const;
+
+  // If `this` is an expression that can only be true if the value of a single
+  // variable (or its string value via `STR`) starts with a fixed prefix, for
+  // example `STRSTARTS(?x, "Ber")`, `STRSTARTS(STR(?x), "http://")`, or a
+  // prefix `REGEX`, return the variable, the prefix, and whether `STR` is
+  // applied. Else return `std::nullopt`.
+  struct PrefixFilterData {
+    Variable variable_;
+    // The prefix of the string value (without quotes).
+    std::string prefix_;
+    bool strIsApplied_ = false;
+
+    // Return the ranges of `ValueId`s (each with its first and last `ValueId`,
+    // both inclusive) that contain all the values that might start with the
+    // prefix: the range of the literals (and with `STR` of the IRIs) of the
+    // vocabulary that start with the prefix (see `Index::prefix_range`), the
+    // external vocabulary, and all the values that are not stored in the
+    // vocabulary.
+    std::vector<std::pair<ValueId, ValueId>> getIdRanges(
+        const Index& index) const;
+  };
+  std::optional<PrefixFilterData> getPrefixFilter() const;
+
+  // If `this` is an expression that can only be true if the string value of a
+  // single variable contains a fixed substring, for example
+  // `CONTAINS(?x, "berg")` or a `REGEX` with a required literal (see
+  // `detail::getRequiredLiteral`), return the variable, the substring, and
+  // whether the case is ignored. Else return `std::nullopt`.
+  struct SubstringFilterData {
+    Variable variable_;
+    // The substring of the string value (without quotes).
+    std::string substring_;
+    bool ignoreCase_ = false;
+
+    // The literals from the vocabulary that might contain the substring
+    // according to the `TrigramIndex`.
+    struct Candidates {
+      const TrigramIndex* trigramIndex_;
+      std::vector<uint64_t> indices_;
+
+      // Return true iff the `id` is a literal from the vocabulary that
+      // doesn't contain the substring.
+      bool isNoMatch(ValueId id) const;
+    };
+    // Return `std::nullopt` if the `index` has no trigram index or if the
+    // substring has no trigram that can be used.
+    std::optional<Candidates> getCandidates(const Index& index) const;
+
+    // Return the ranges of `ValueId`s (each with its first and last
+    // `ValueId`, both inclusive) that contain all the values that might
+    // contain the substring: the `Candidates` and all the values that are not
+    // indexed by the `TrigramIndex`. Close ranges are merged, s.t. there are
+    // at most `maxNumRanges` of them. Return `std::nullopt` if there are no
+    // `Candidates`.
+    static constexpr size_t maxNumRanges = 1000;
+    std::optional<std::vector<std::pair<ValueId, ValueId>>> getIdRanges(
+        const Index& index) const;
+  };
+  std::optional<SubstringFilterData> getSubstringFilter() const;
+
   // Return the size and cost estimate for this expression if it is used as the
   // expression of a `FILTER` clause given that the input has `inputSize` many
   // elements and the input is sorted by the variable `firstSortedVariable`.
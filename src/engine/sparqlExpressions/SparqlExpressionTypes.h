@@ -257,8 +257,7 @@ Id constantExpressionResultToId(T&& result, LocalVocabT& localVocab) {
     return std::visit(
         [&localVocab]<typename R>(R&& el) mutable {
           if constexpr (ad_utility::isSimilar<R, string>) {
-            return Id::makeFromLocalVocabIndex(
-                localVocab.getIndexAndAddIfNotContained(std::forward<R>(el)));
+            return localVocab.getIdAndAddIfNotContained(el);
           } else {
             static_assert(ad_utility::isSimilar<R, Id>);
             return el;
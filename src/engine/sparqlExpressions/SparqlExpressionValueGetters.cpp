@@ -6,13 +6,14 @@
 
 #include "engine/ExportQueryExecutionTrees.h"
 #include "global/Constants.h"
+#include "index/VocabularyValues.h"
 #include "util/Conversions.h"
 
 using namespace sparqlExpression::detail;
 
 // _____________________________________________________________________________
 NumericValue NumericValueGetter::operator()(
-    ValueId id, const sparqlExpression::EvaluationContext*) const {
+    ValueId id, const sparqlExpression::EvaluationContext* context) const {
   switch (id.getDatatype()) {
     case Datatype::Double:
       return id.getDouble();
@@ -23,17 +24,46 @@ NumericValue NumericValueGetter::operator()(
       // here. They probably should be UNDEF as soon as we have conversion
       // functions.
       return static_cast<int64_t>(id.getBool());
+    case Datatype::VocabIndex: {
+      // A numeric literal that was stored in the vocabulary, if its value was
+      // precomputed during the index build.
+      auto value = context->_qec.getIndex().getVocabularyValues().get(
+          id.getVocabIndex());
+      if (value.has_value() && value.value().getDatatype() != Datatype::Date) {
+        return (*this)(value.value(), context);
+      }
+      return NotNumeric{};
+    }
     case Datatype::Undefined:
-    case Datatype::VocabIndex:
     case Datatype::LocalVocabIndex:
     case Datatype::TextRecordIndex:
     case Datatype::WordVocabIndex:
     case Datatype::Date:
+    case Datatype::InlineString:
+    case Datatype::EncodedIri:
       return NotNumeric{};
   }
   AD_FAIL();
 }
 
+// _____________________________________________________________________________
+auto DateValueGetter::operator()(ValueId id,
+                                 const EvaluationContext* context) const
+    -> Opt {
+  if (id.getDatatype() == Datatype::Date) {
+    return id.getDate();
+  } else if (id.getDatatype() == Datatype::VocabIndex) {
+    // A date literal that was stored in the vocabulary, if its value was
+    // precomputed during the index build.
+    auto value = context->_qec.getIndex().getVocabularyValues().get(
+        id.getVocabIndex());
+    if (value.has_value() && value.value().getDatatype() == Datatype::Date) {
+      return value.value().getDate();
+    }
+  }
+  return std::nullopt;
+}
+
 // _____________________________________________________________________________
 auto EffectiveBooleanValueGetter::operator()(
     ValueId id, const EvaluationContext* context) const -> Result {
@@ -66,9 +96,12 @@ auto EffectiveBooleanValueGetter::operator()(
                  ? False
                  : True;
     }
+    case Datatype::InlineString:
+      return id.getInlineString().view().empty() ? False : True;
     case Datatype::WordVocabIndex:
     case Datatype::TextRecordIndex:
     case Datatype::Date:
+    case Datatype::EncodedIri:
       return True;
   }
   AD_FAIL();
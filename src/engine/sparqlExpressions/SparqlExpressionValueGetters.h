@@ -128,13 +128,7 @@ struct StringValueGetter {
 struct DateValueGetter {
   using Opt = std::optional<DateOrLargeYear>;
 
-  Opt operator()(ValueId id, const EvaluationContext*) const {
-    if (id.getDatatype() == Datatype::Date) {
-      return id.getDate();
-    } else {
-      return std::nullopt;
-    }
-  }
+  Opt operator()(ValueId id, const EvaluationContext* context) const;
 
   Opt operator()(const std::string&, const EvaluationContext*) const {
     return std::nullopt;
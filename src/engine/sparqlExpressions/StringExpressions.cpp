@@ -3,9 +3,13 @@
 //  Author: Johannes Kalmbach <kalmbacj@cs.uni-freiburg.de>
 
 #include <boost/url.hpp>
+#include <mutex>
 
+#include "engine/sparqlExpressions/LiteralExpression.h"
 #include "engine/sparqlExpressions/NaryExpressionImpl.h"
 #include "engine/sparqlExpressions/VariadicExpression.h"
+#include "index/Index.h"
+#include "util/ByteScanning.h"
 
 namespace sparqlExpression {
 namespace detail::string_expressions {
@@ -199,10 +203,143 @@ using SubstrExpression =
   return Id::makeFromBool(text.starts_with(pattern));
 };
 
-using StrStartsExpression =
+using StrStartsExpressionImpl =
     StringExpressionImpl<2, LiftStringFunction<decltype(strStartsImpl)>,
                          StringValueGetter>;
 
+// The arguments of a string function like `STRSTARTS(?x, "Ber")` or
+// `CONTAINS(STR(?x), "berg")`: the variable, the constant string (without
+// quotes), and whether `STR` is applied to the variable.
+struct VariableAndConstantString {
+  ::Variable variable_;
+  std::string constant_;
+  bool strIsApplied_ = false;
+};
+
+// Return the arguments if the `child` is a variable (or `STR` of a variable)
+// and the `constant` is a string literal without a datatype or language tag.
+// Else return `std::nullopt`.
+std::optional<VariableAndConstantString> getVariableAndConstantString(
+    const SparqlExpression& child, const SparqlExpression& constant) {
+  const auto* literal = dynamic_cast<const StringLiteralExpression*>(&constant);
+  if (literal == nullptr || !literal->value().datatypeOrLangtag().empty()) {
+    return std::nullopt;
+  }
+  // Remove the quotes.
+  std::string_view content = literal->value().normalizedLiteralContent().get();
+  AD_CORRECTNESS_CHECK(content.size() >= 2);
+  content = content.substr(1, content.size() - 2);
+  bool strIsApplied = child.isStrExpression();
+  const auto* variable = dynamic_cast<const VariableExpression*>(
+      strIsApplied ? child.children()[0].get() : &child);
+  if (variable == nullptr) {
+    return std::nullopt;
+  }
+  return VariableAndConstantString{variable->value(), std::string{content},
+                                   strIsApplied};
+}
+
+// Evaluate the `predicate` on the string values of the `variable` (obtained
+// via the `ValueGetter`). For the `Id`s for which `isNoMatch` is true, the
+// result is `false` without looking up their strings.
+template <typename ValueGetter>
+ExpressionResult evaluateOnStringsUnlessNoMatch(const ::Variable& variable,
+                                                EvaluationContext* context,
+                                                const auto& isNoMatch,
+                                                const auto& predicate) {
+  auto resultSize = context->size();
+  VectorWithMemoryLimit<Id> result{context->_allocator};
+  result.reserve(resultSize);
+  for (Id id : detail::makeGenerator(variable, resultSize, context)) {
+    if (isNoMatch(id)) {
+      result.push_back(Id::makeFromBool(false));
+      continue;
+    }
+    auto str = ValueGetter{}(id, context);
+    result.push_back(str.has_value() ? Id::makeFromBool(predicate(str.value()))
+                                     : Id::makeUndefined());
+  }
+  return result;
+}
+
+// If the first argument of `STRSTARTS` is a variable (or `STR` of a variable)
+// and the second argument is a constant ASCII prefix, the values from the
+// vocabulary are first checked via their `Id`s: as the vocabulary is sorted,
+// the literals (and IRIs) that start with the prefix form a range (see
+// `Index::prefix_range`), and the strings of the values outside of this range
+// don't have to be looked up. The collation of the vocabulary might ignore
+// case and punctuation, so the range can contain more words than those that
+// start with the prefix, which are still compared exactly. The prefix is also
+// used by the `Filter` to skip the blocks of an `IndexScan`.
+class StrStartsExpression : public StrStartsExpressionImpl {
+ private:
+  std::optional<PrefixFilterData> prefixFilter_;
+
+ public:
+  StrStartsExpression(SparqlExpression::Ptr child, SparqlExpression::Ptr prefix)
+      : StrStartsExpression{computePrefixFilter(*child, *prefix),
+                            std::move(child), std::move(prefix)} {}
+
+  std::optional<PrefixFilterData> getPrefixFilter() const override {
+    return prefixFilter_;
+  }
+
+  ExpressionResult evaluate(EvaluationContext* context) const override {
+    if (!prefixFilter_.has_value()) {
+      return StrStartsExpressionImpl::evaluate(context);
+    }
+    if (prefixFilter_->strIsApplied_) {
+      return evaluateWithPrefixRanges<StringValueGetter>(context);
+    }
+    return evaluateWithPrefixRanges<LiteralFromIdGetter>(context);
+  }
+
+ private:
+  StrStartsExpression(std::optional<PrefixFilterData> prefixFilter,
+                      SparqlExpression::Ptr child, SparqlExpression::Ptr prefix)
+      : StrStartsExpressionImpl{std::move(child), std::move(prefix)},
+        prefixFilter_{std::move(prefixFilter)} {}
+
+  static std::optional<PrefixFilterData> computePrefixFilter(
+      const SparqlExpression& child, const SparqlExpression& prefix) {
+    auto arguments = getVariableAndConstantString(child, prefix);
+    if (!arguments.has_value() || arguments->constant_.empty() ||
+        !ad_utility::isAscii(arguments->constant_)) {
+      return std::nullopt;
+    }
+    return PrefixFilterData{std::move(arguments->variable_),
+                            std::move(arguments->constant_),
+                            arguments->strIsApplied_};
+  }
+
+  template <typename ValueGetter>
+  ExpressionResult evaluateWithPrefixRanges(EvaluationContext* context) const {
+    const std::string& prefix = prefixFilter_->prefix_;
+    bool strIsApplied = prefixFilter_->strIsApplied_;
+    const Index& index = context->_qec.getIndex();
+    // The values of the vocabulary in the `range` that are not in the
+    // `matchingRange` don't start with the prefix.
+    auto literals = index.prefix_range("\"");
+    auto matchingLiterals = index.prefix_range(absl::StrCat("\"", prefix));
+    auto iris = index.prefix_range("<");
+    auto matchingIris = index.prefix_range(absl::StrCat("<", prefix));
+    auto contains = [](const std::pair<Id, Id>& range, Id id) {
+      return range.first <= id && id < range.second;
+    };
+    auto isNoMatch = [&](Id id) {
+      if (id.getDatatype() != Datatype::VocabIndex) {
+        return false;
+      }
+      return (contains(literals, id) && !contains(matchingLiterals, id)) ||
+             (strIsApplied && contains(iris, id) &&
+              !contains(matchingIris, id));
+    };
+    return evaluateOnStringsUnlessNoMatch<ValueGetter>(
+        prefixFilter_->variable_, context, isNoMatch,
+        [&prefix](std::string_view str) { return str.starts_with(prefix); });
+  }
+};
+
 // STRENDS
 [[maybe_unused]] auto strEndsImpl = [](std::string_view text,
                                        std::string_view pattern) {
@@ -219,10 +356,73 @@ using StrEndsExpression =
   return Id::makeFromBool(text.find(pattern) != std::string::npos);
 };
 
-using ContainsExpression =
+using ContainsExpressionImpl =
     StringExpressionImpl<2, LiftStringFunction<decltype(containsImpl)>,
                          StringValueGetter>;
 
+// If the first argument of `CONTAINS` is a variable (or `STR` of a variable)
+// and the second argument is a constant string, the literals from the
+// vocabulary that can't contain the string are rejected via the
+// `TrigramIndex` (if the index has one) without looking up their strings. The
+// substring is also used by the `Filter` to skip the blocks of an
+// `IndexScan`.
+class ContainsExpression : public ContainsExpressionImpl {
+ private:
+  std::optional<SubstringFilterData> substringFilter_;
+  bool strIsApplied_ = false;
+  // The candidates of the `substringFilter_`, which are computed once.
+  mutable std::once_flag candidatesAreComputed_;
+  mutable std::optional<SubstringFilterData::Candidates> candidates_;
+
+ public:
+  ContainsExpression(SparqlExpression::Ptr child,
+                     SparqlExpression::Ptr substring)
+      : ContainsExpression{getVariableAndConstantString(*child, *substring),
+                           std::move(child), std::move(substring)} {}
+
+  std::optional<SubstringFilterData> getSubstringFilter() const override {
+    return substringFilter_;
+  }
+
+  ExpressionResult evaluate(EvaluationContext* context) const override {
+    if (substringFilter_.has_value()) {
+      std::call_once(candidatesAreComputed_, [this, context] {
+        candidates_ =
+            substringFilter_->getCandidates(context->_qec.getIndex());
+      });
+    }
+    if (!candidates_.has_value()) {
+      return ContainsExpressionImpl::evaluate(context);
+    }
+    auto isNoMatch = [this](Id id) { return candidates_->isNoMatch(id); };
+    auto contains = [&substring = substringFilter_->substring_](
+                        std::string_view str) {
+      return str.find(substring) != std::string_view::npos;
+    };
+    const auto& variable = substringFilter_->variable_;
+    if (strIsApplied_) {
+      return evaluateOnStringsUnlessNoMatch<StringValueGetter>(
+          variable, context, isNoMatch, contains);
+    }
+    return evaluateOnStringsUnlessNoMatch<LiteralFromIdGetter>(
+        variable, context, isNoMatch, contains);
+  }
+
+ private:
+  ContainsExpression(std::optional<VariableAndConstantString> arguments,
+                     SparqlExpression::Ptr child,
+                     SparqlExpression::Ptr substring)
+      : ContainsExpressionImpl{std::move(child), std::move(substring)} {
+    // The empty string is contained in every string.
+    if (arguments.has_value() && !arguments->constant_.empty()) {
+      substringFilter_ =
+          SubstringFilterData{std::move(arguments->variable_),
+                              std::move(arguments->constant_), false};
+      strIsApplied_ = arguments->strIsApplied_;
+    }
+  }
+};
+
 // STRAFTER / STRBEFORE
 template <bool isStrAfter>
 [[maybe_unused]] auto strAfterOrBeforeImpl =
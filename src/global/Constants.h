@@ -36,9 +36,17 @@ static const size_t USE_BLOCKS_INDEX_SIZE_TRESHOLD = 20'000;
 
 static const size_t TEXT_PREDICATE_CARDINALITY_ESTIMATE = 1'000'000'000;
 static const size_t TEXT_LIMIT_DEFAULT = std::numeric_limits<size_t>::max();
+// The lazy scans of the text index (e.g. `Index::getWordPostingsForTermLazily`)
+// yield the postings of this many sub-blocks (see `TextSkipEntry`) at once.
+static const size_t NUM_TEXT_SUB_BLOCKS_PER_LAZY_BLOCK = 16;
 
 static const size_t GALLOP_THRESHOLD = 1000;
 
+// The estimated cost of a single point lookup in a permutation, which reads at
+// least one block (see `IndexNestedLoopJoin`), in the unit of the other cost
+// estimates (roughly the number of rows that are processed).
+static const size_t INDEX_NESTED_LOOP_JOIN_COST_PER_LOOKUP = 1000;
+
 static const char INTERNAL_PREDICATE_PREFIX_NAME[] = "ql";
 
 static const std::string INTERNAL_PREDICATE_PREFIX =
@@ -62,10 +70,15 @@ static const std::string INTERNAL_TEXT_MATCH_PREDICATE =
 static const std::string HAS_PREDICATE_PREDICATE =
     makeInternalIri("has-predicate");
 static const std::string HAS_PATTERN_PREDICATE = makeInternalIri("has-pattern");
+// The IRI of a SERVICE that is computed by all the `shard-endpoints` (see
+// `Service::computeResultFromShards`).
+static const std::string SHARDS_SERVICE_IRI = makeInternalIri("shards");
 static constexpr std::pair<std::string_view, std::string_view> GEOF_PREFIX = {
     "geof:", "<http://www.opengis.net/def/function/geosparql/"};
 static constexpr std::pair<std::string_view, std::string_view> MATH_PREFIX = {
     "math:", "<http://www.w3.org/2005/xpath-functions/math#"};
+static constexpr std::pair<std::string_view, std::string_view> QL_PREFIX = {
+    "ql:", "<http://qlever.cs.uni-freiburg.de/builtin-functions/"};
 
 static const std::string INTERNAL_VARIABLE_PREFIX =
     "?_QLever_internal_variable_";
@@ -131,6 +144,8 @@ static const std::string EXTERNAL_VOCAB_SUFFIX = ".vocabulary.external";
 static const std::string MMAP_FILE_SUFFIX = ".meta";
 static const std::string CONFIGURATION_FILE = ".meta-data.json";
 static const std::string PREFIX_FILE = ".prefixes";
+static const std::string SORT_ESTIMATES_FILE_SUFFIX = ".sort-estimates";
+static const std::string WARMUP_BLOCKS_FILE_SUFFIX = ".warmup-blocks";
 
 static const std::string ERROR_IGNORE_CASE_UNSUPPORTED =
     "Key \"ignore-case\" is no longer supported. Please remove this key from "
@@ -190,6 +205,11 @@ static constexpr uint32_t PATTERNS_FILE_VERSION = 1;
 // compiler limits for the evaluation of constexpr functions and templates.
 static constexpr int DEFAULT_MAX_NUM_COLUMNS_STATIC_ID_TABLE = 5;
 
+// When exporting a result as a stream (e.g. TSV or CSV), the rows are exported
+// in batches of this size. The words of the `VocabIndex` values of a batch are
+// resolved together in sorted order (see `ExportQueryExecutionTrees`).
+static constexpr size_t EXPORT_VOCAB_BATCH_SIZE = 65'536;
+
 // Interval in which an enabled watchdog would check if
 // `CancellationHandle::throwIfCancelled` is called regularly.
 constexpr std::chrono::milliseconds DESIRED_CANCELLATION_CHECK_INTERVAL{50};
@@ -200,6 +220,7 @@ inline auto& RuntimeParameters() {
   using ad_utility::detail::parameterShortNames::DurationParameter;
   using ad_utility::detail::parameterShortNames::MemorySizeParameter;
   using ad_utility::detail::parameterShortNames::SizeT;
+  using ad_utility::detail::parameterShortNames::String;
   // NOTE: It is important that the value of the static variable is created by
   // an immediately invoked lambda, otherwise we get really strange segfaults on
   // Clang 16 and 17.
@@ -218,21 +239,339 @@ inline auto& RuntimeParameters() {
           });
       return AD_FWD(parameter);
     };
+    auto ensureValidEvictionPolicy = [](auto&& parameter) {
+      parameter.setParameterConstraint(
+          [](const std::string& value, std::string_view parameterName) {
+            if (value != "lru" && value != "gdsf") {
+              throw std::runtime_error{absl::StrCat(
+                  "Parameter ", parameterName,
+                  " must be \"lru\" or \"gdsf\", was \"", value, "\"")};
+            }
+          });
+      return AD_FWD(parameter);
+    };
+    auto ensureAtLeastTwo = [](auto&& parameter) {
+      parameter.setParameterConstraint(
+          [](size_t value, std::string_view parameterName) {
+            if (value < 2) {
+              throw std::runtime_error{absl::StrCat(
+                  "Parameter ", parameterName, " must be at least 2, was ",
+                  value)};
+            }
+          });
+      return AD_FWD(parameter);
+    };
     return ad_utility::Parameters{
         // If the time estimate for a sort operation is larger by more than this
         // factor than the remaining time, then the sort is canceled with a
         // timeout exception.
         Double<"sort-estimate-cancellation-factor">{3.0},
+        // If the estimated runtime of a query (or of an operation before its
+        // computation) is larger by more than this factor than the remaining
+        // time, then it is canceled with a timeout exception before any work is
+        // done. The runtime is estimated from the cost estimate of the query
+        // planner (see `QueryRuntimeEstimator`). 0 disables this check.
+        Double<"runtime-estimate-cancellation-factor">{10.0},
         SizeT<"cache-max-num-entries">{1000},
         MemorySizeParameter<"cache-max-size">{30_GB},
         MemorySizeParameter<"cache-max-size-single-entry">{5_GB},
+        // The policy that decides which entries are evicted from the query
+        // result cache: "lru" (least recently used) or "gdsf"
+        // (GreedyDual-Size-Frequency, which prefers to keep small results that
+        // were expensive to compute, see `ad_utility::EvictionPolicy`).
+        ensureValidEvictionPolicy(String<"cache-eviction-policy">{"lru"}),
+        // If true, the entries of the query result cache are stored compressed
+        // (see `CompressedResultTable`), which is slower on a cache hit, but
+        // makes much better use of the `cache-max-size`.
+        Bool<"compress-cached-results">{false},
+        // If true, the blocks of a lazy result are also collected while they
+        // are consumed, and the complete result is stored in the query result
+        // cache if it was consumed completely and its size is at most
+        // `cache-max-size-single-entry` (see
+        // `Operation::wrapLazyResultForCache`).
+        Bool<"cache-lazy-results">{true},
+        // The maximal number of blocks that a lazy index scan reads ahead and
+        // the maximal number of threads that read them. The actual values are
+        // adapted to the speed of the consumer of each scan (see
+        // `LazyScanPrefetchController`).
         SizeT<"lazy-index-scan-queue-size">{20},
         SizeT<"lazy-index-scan-num-threads">{10},
+        // The number of threads that all concurrent lazy index scans may use
+        // together (each scan can always use one thread).
+        SizeT<"lazy-index-scan-max-total-threads">{32},
         ensureStrictPositivity(
             DurationParameter<std::chrono::seconds, "default-query-timeout">{
                 30s}),
         SizeT<"lazy-index-scan-max-size-materialization">{1'000'000},
-        Bool<"use-group-by-hash-map-optimization">{false}};
+        // If one input of a join is already computed and has at most this
+        // many rows, the other input is computed with a semi-join reduction:
+        // only the rows with a join partner are computed (see
+        // `Operation::getResultWithSemiJoinFilter`). 0 disables the reduction.
+        SizeT<"semi-join-reduction-max-size">{100'000},
+        // The number of threads that read and decompress the blocks of a
+        // (non-lazy) index scan.
+        SizeT<"index-scan-num-threads">{10},
+        // The number of blocks that an index scan announces to the operating
+        // system ahead of reading them, s.t. they can be loaded from disk in
+        // the background. A value of 0 disables the prefetching.
+        SizeT<"index-scan-num-prefetched-blocks">{16},
+        // The maximal size of the cache for decompressed blocks of the index
+        // permutations, which is shared by all queries. 0 disables it.
+        MemorySizeParameter<"decompressed-block-cache-max-size">{1_GB},
+        // The maximal size of the cache for the decoded words of the
+        // vocabularies, which is shared by all queries. 0 disables it.
+        MemorySizeParameter<"vocabulary-cache-max-size">{500_MB},
+        // Allocations (e.g. the columns of large `IdTable`s) and memory-mapped
+        // index files (e.g. the metadata of the permutations) of at least this
+        // size are backed by transparent huge pages, which reduces the misses
+        // of the TLB. 0 disables huge pages.
+        MemorySizeParameter<"huge-pages-min-size">{0_B},
+        // The number of threads that look up the strings of a large VALUES
+        // clause in the vocabulary (see `Vocabulary::getIds`).
+        SizeT<"vocabulary-lookup-num-threads">{4},
+        // If not empty, the evicted and the pinned entries of the query result
+        // cache are also stored in this directory, s.t. they can be reused
+        // after a restart of the server. It is only read at startup.
+        String<"persistent-cache-directory">{""},
+        MemorySizeParameter<"persistent-cache-max-size">{100_GB},
+        // The number of threads that are used for the join of large inputs.
+        SizeT<"join-num-threads">{4},
+        // The independent inputs of an operation (e.g. the branches of a
+        // UNION or the children of a Cartesian product) are computed
+        // concurrently by at most this many threads. 1 disables this.
+        SizeT<"subtree-num-threads">{4},
+        // The number of threads that are used for sorting large results.
+        SizeT<"sort-num-threads">{4},
+        // Inputs of `Sort` and `OrderBy` that are larger than this budget are
+        // sorted externally using at most this much memory. Sorted runs are
+        // written to the `sort-spill-directory` (the system's directory for
+        // temporary files if empty).
+        MemorySizeParameter<"sort-external-memory-budget">{5_GB},
+        String<"sort-spill-directory">{""},
+        // Each query gets its own memory budget, which is charged to the
+        // memory of the server, s.t. a query that exceeds its budget fails
+        // (or spills to disk where this is supported) alone. The budget is
+        // the memory that the query planner estimates for the result times
+        // `query-memory-budget-estimate-factor`, but at least
+        // `query-memory-budget-min`. With a factor of zero, a query is only
+        // limited by the memory of the server.
+        Double<"query-memory-budget-estimate-factor">{10.0},
+        MemorySizeParameter<"query-memory-budget-min">{2_GB},
+        // A GROUP BY with a single grouped variable is computed via hash maps
+        // instead of sorting the input if this is estimated to be cheaper.
+        // Large inputs are then aggregated by this many threads.
+        Bool<"use-group-by-hash-map-optimization">{true},
+        SizeT<"group-by-hash-map-num-threads">{4},
+        // A GROUP BY on a sorted input with more than this many rows is split
+        // at group boundaries into chunks of (roughly) this many rows, which
+        // are aggregated concurrently on `group-by-sorted-num-threads` threads.
+        SizeT<"group-by-sorted-chunk-size">{65536},
+        SizeT<"group-by-sorted-num-threads">{4},
+        // A DISTINCT on an unsorted input is computed via hash sets instead of
+        // sorting the input if this is estimated to be cheaper. Large inputs
+        // are then partitioned by the hash of their rows between this many
+        // threads.
+        Bool<"use-hash-distinct">{true},
+        SizeT<"hash-distinct-num-threads">{4},
+        // The number of threads that count the patterns and predicates of
+        // large inputs of `CountAvailablePredicates` (the pattern trick).
+        SizeT<"pattern-trick-num-threads">{4},
+        // The number of threads that expand the subjects of a large
+        // `HasPredicateScan` into their predicates.
+        SizeT<"has-predicate-scan-num-threads">{4},
+        // If true, a `DISTINCT` on the result of a join whose selected
+        // variables all come from one of the inputs of the join is also
+        // planned with a semi-join of that input (see `SemiJoin`), which does
+        // not multiply the rows before the duplicates are removed.
+        Bool<"use-semi-join-for-distinct">{true},
+        // An `OPTIONAL` is also planned as a left-outer hash join (see
+        // `OptionalJoin::Strategy::Hash`), which needs no sorted inputs, if the
+        // estimated size of the right input is at least this many times the
+        // estimated size of the left input. 0 disables the hash join.
+        SizeT<"hash-optional-join-min-size-ratio">{100},
+        // A join of an input with at most this many (estimated) rows and an
+        // index scan with two variables on the first variable of the scan is
+        // also planned as point lookups in the permutation of the scan for
+        // each distinct value of the input (see `IndexNestedLoopJoin`). 0
+        // disables this.
+        SizeT<"index-nested-loop-join-max-left-size">{10'000},
+        // The number of threads that compute the transitive hulls of the start
+        // nodes of a transitive path (property paths with `+` or `*`).
+        SizeT<"transitive-path-num-threads">{4},
+        // The transitive hulls of a path of unrestricted length (`+` or `*`)
+        // are computed via the strongly connected components of the graph
+        // (see `TransitivePath::condensedTransitiveHull`) if they are computed
+        // for at least this many start nodes, e.g. if both ends of the path
+        // are unbound.
+        SizeT<"transitive-path-min-start-nodes-for-condensation">{1'000},
+        // The scans of the predicates of an alternative property path (e.g.
+        // `?x (<p>|<q>) ?y`) are merged via a parallel multiway merge (see
+        // `MultiPredicateScan`) if they have at least this many rows in total.
+        SizeT<"multi-predicate-scan-min-size-for-parallel-merge">{100'000},
+        // During the query planning, the subtrees with unreliable size
+        // estimates (transitive paths and `HasPredicateScan`s) of the best
+        // join order are computed. If the actual size of one of them differs
+        // from the estimate by more than this factor, the join order is
+        // optimized again using the actual sizes. 0 disables this.
+        Double<"adaptive-replanning-error-ratio">{10.0},
+        // If not empty, the ratios between the actual and the estimated sizes
+        // of joins of two index scans are recorded in this file and used to
+        // correct the estimates for later queries (see `CardinalityFeedback`).
+        // The corrections are specific to an index. The file is only read at
+        // startup.
+        String<"cardinality-feedback-file">{""},
+        // If positive, the size of a join of two index scans with two
+        // variables each (e.g. `?x <p> ?y . ?y <q> ?z`) is estimated during
+        // the query planning by reading the first columns of this many blocks
+        // of the larger scan and joining them with the other scan (see
+        // `Join::getSampledSizeEstimate`). If this takes longer than the time
+        // budget, the usual estimate is used. The estimates are cached per
+        // pair of predicates.
+        SizeT<"join-sampling-num-blocks">{0},
+        DurationParameter<std::chrono::milliseconds,
+                          "join-sampling-time-budget">{10ms},
+        // The number of threads of the server that compute the queries, which
+        // is also the maximal number of queries that are computed at the same
+        // time. It can be changed while the server is running (see
+        // `ResizableThreadPool`), 0 means the number of threads from the
+        // command line. The number of threads of a single operation is set by
+        // the respective parameters (e.g. `sort-num-threads`).
+        SizeT<"num-query-threads">{0},
+        // If true, the memory that is allocated while the index is loaded (e.g.
+        // the vocabulary and the metadata of the permutations) is interleaved
+        // across the NUMA nodes of the machine, and each thread of the server
+        // is pinned to the CPUs of one of the nodes (round-robin), s.t. the
+        // memory of a query is allocated on the node on which it is computed.
+        // It is only read at startup.
+        Bool<"numa-aware">{false},
+        // The estimates of the sorting performance of this machine (see
+        // `SortPerformanceEstimator`) are stored in a file next to the index
+        // and only computed again when the hardware or the build of QLever
+        // changes, or if this is true. It is only read at startup.
+        Bool<"recompute-sort-estimates">{false},
+        // If not empty, the queries from this file (one per line) are computed
+        // at startup on `warmup-num-threads` threads and their results are
+        // pinned in the cache (see `CacheWarmup`). Both are only read at
+        // startup.
+        String<"warmup-query-file">{""},
+        SizeT<"warmup-num-threads">{4},
+        // When the index is replaced at runtime (see `Server::swapIndex`), the
+        // cache of the new index is warmed up with the queries of at most this
+        // many results of the old cache.
+        SizeT<"swap-index-num-warmup-queries">{100},
+        // The query planner finds the optimal join order of a connected
+        // component of the query graph via exhaustive dynamic programming if
+        // it consists of at most this many subtrees (typically index scans).
+        // Larger components are planned via iterative dynamic programming
+        // (IDP): The cheapest plan that joins `query-planning-idp-block-size`
+        // of the subtrees is fixed and replaces them, until the exhaustive
+        // dynamic programming can be used. A block size of 2 corresponds to a
+        // greedy join ordering.
+        ensureAtLeastTwo(
+            SizeT<"query-planning-max-num-nodes-for-exact-dp">{12}),
+        ensureAtLeastTwo(SizeT<"query-planning-idp-block-size">{4}),
+        // The join candidates of two rows of the dynamic programming table
+        // are created by this many threads (see `QueryPlanner::merge`).
+        SizeT<"query-planning-num-threads">{4},
+        // The cyclic parts of the query graph (e.g. triangles of triples with
+        // two variables each) can also be joined via a worst-case optimal join
+        // (see `WorstCaseOptimalJoin`), which the query planner chooses if it
+        // is estimated to be cheaper than a sequence of pairwise joins.
+        Bool<"use-worst-case-optimal-join">{true},
+        // Identical subtrees of a query (with the same cache key, e.g. a graph
+        // pattern that is repeated in several branches of a UNION) are
+        // computed only once and their result is shared for the duration of
+        // the query, also if the result is not stored in the cache (see
+        // `QueryPlanner::shareResultsOfCommonSubtrees`).
+        Bool<"share-results-of-identical-subtrees">{true},
+        // The maximal number of parsed queries that are cached, s.t. queries
+        // that only differ in the IRIs of their triples are parsed only once
+        // (see `ParsedQueryCache`). 0 disables the cache.
+        SizeT<"parsed-query-cache-max-num-entries">{1000},
+        // The number of threads that format the batches of rows of a result
+        // that is exported as TSV, CSV, SPARQL XML, or SPARQL JSON, or of the
+        // triples of a CONSTRUCT query.
+        SizeT<"export-num-threads">{4},
+        // If true, each distinct triple of the result of a CONSTRUCT query is
+        // exported only once, also if the template produces it for several
+        // rows. This requires memory for all the distinct triples, and the
+        // batches of the triples are then formatted by a single thread.
+        Bool<"construct-export-deduplicate">{false},
+        // The level of the compression of HTTP responses (if the client
+        // accepts a compressed response via its `Accept-Encoding` header).
+        // Higher levels compress better, but are slower. The level is clamped
+        // to the levels that are supported by the chosen compression method.
+        SizeT<"http-compression-level">{1},
+        // Queries that arrive while an identical query (same URL parameters,
+        // result as QLever JSON) is processed wait for the latter and are
+        // answered with the same serialized response.
+        Bool<"share-responses-of-identical-queries">{true},
+        // The connections to remote hosts (e.g. for SERVICE) are kept open
+        // and reused for later requests to the same host. At most this many
+        // connections to a single host are open at the same time, and at most
+        // `http-client-max-idle-connections-per-host` of them are kept open
+        // while they are not used.
+        SizeT<"http-client-max-connections-per-host">{16},
+        SizeT<"http-client-max-idle-connections-per-host">{4},
+        // The responses of remote endpoints to the queries of a SERVICE are
+        // cached for `service-cache-ttl` (not at all if it is zero), which can
+        // be overridden per endpoint by the comma-separated pairs
+        // `<url> <ttl>` of `service-cache-ttl-per-endpoint`, for example
+        // `https://query.wikidata.org/sparql 10min`. An expired response is
+        // still used for `service-cache-stale-while-revalidate` while it is
+        // refreshed in the background. Failed requests are cached for
+        // `service-cache-error-ttl` (see `ServiceCache`).
+        DurationParameter<std::chrono::seconds, "service-cache-ttl">{0s},
+        String<"service-cache-ttl-per-endpoint">{""},
+        DurationParameter<std::chrono::seconds,
+                          "service-cache-stale-while-revalidate">{0s},
+        DurationParameter<std::chrono::seconds, "service-cache-error-ttl">{0s},
+        MemorySizeParameter<"service-cache-max-size">{1_GB},
+        // The comma-separated URLs of the QLever servers that compute a
+        // `SERVICE ql:shards`. Each of them holds a part of the triples, but
+        // all of them (and this server) must use the same vocabulary, because
+        // the results are exchanged as binary `Id`s.
+        String<"shard-endpoints">{""},
+        // A FILTER evaluates its expression for blocks of this many rows, s.t.
+        // the intermediate results of the subexpressions stay small.
+        SizeT<"filter-block-size">{4096},
+        // The inputs of a FILTER or BIND with more than this many rows are
+        // split into morsels of this many rows, which are evaluated
+        // concurrently on `expression-num-threads` threads. The outputs of the
+        // morsels are concatenated in order, s.t. the sorting is preserved.
+        SizeT<"expression-morsel-size">{65536},
+        SizeT<"expression-num-threads">{4},
+        // The number of threads that aggregate the scores of the combinations
+        // of entities of large text results with several entity variables.
+        SizeT<"text-aggregation-num-threads">{4},
+        // If this is not empty, the traces of the queries that are sent with
+        // the URL parameter `trace` are additionally posted as OpenTelemetry
+        // spans (OTLP/JSON) to this URL of a collector, for example
+        // `http://localhost:4318/v1/traces`.
+        String<"trace-collector-url">{""},
+        // If not empty, the queries that take at least
+        // `slow-query-log-threshold` are logged to this file as JSON lines,
+        // together with their plan and runtime information (see
+        // `SlowQueryLog`). Additionally, the given fraction of the faster
+        // queries is logged. The file is rotated when it becomes larger than
+        // `slow-query-log-max-file-size`, and at most
+        // `slow-query-log-max-num-files` files are kept.
+        String<"slow-query-log-file">{""},
+        DurationParameter<std::chrono::milliseconds,
+                          "slow-query-log-threshold">{1000ms},
+        Double<"slow-query-log-sample-rate">{0.0},
+        MemorySizeParameter<"slow-query-log-max-file-size">{100_MB},
+        SizeT<"slow-query-log-max-num-files">{5},
+        // The updates of the runtime information of a running query that are
+        // sent to the websocket clients of the query are serialized at most
+        // once per this interval. Only the final update of a query is always
+        // sent. 0 sends every update.
+        DurationParameter<std::chrono::milliseconds,
+                          "websocket-update-interval">{50ms},
+        // The results that are kept for the pages of a cursor (URL parameter
+        // `cursor=open`) are removed if they weren't accessed for this
+        // duration (see `ResultCursors`).
+        DurationParameter<std::chrono::seconds, "result-cursor-ttl">{300s}};
   }();
   return params;
 }
@@ -261,4 +600,3 @@ auto parallel_sort([[maybe_unused]] Args&&... args) {
 using parallel_tag = int;
 }  // namespace ad_utility
 #endif
-static constexpr size_t NUM_SORT_THREADS = 4;
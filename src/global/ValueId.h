@@ -7,11 +7,14 @@
 
 #include <absl/strings/str_cat.h>
 
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <cstdint>
 #include <functional>
 #include <limits>
 #include <sstream>
+#include <string_view>
 
 #include "global/IndexTypes.h"
 #include "util/BitUtils.h"
@@ -31,7 +34,9 @@ enum struct Datatype {
   TextRecordIndex,
   Date,
   WordVocabIndex,
-  MaxValue = WordVocabIndex
+  InlineString,
+  EncodedIri,
+  MaxValue = EncodedIri
   // Note: Unfortunately we cannot easily get the size of an enum.
   // If members are added to this enum, then the `MaxValue`
   // alias must always be equal to the last member,
@@ -59,6 +64,10 @@ constexpr std::string_view toString(Datatype type) {
       return "WordVocabIndex";
     case Datatype::Date:
       return "Date";
+    case Datatype::InlineString:
+      return "InlineString";
+    case Datatype::EncodedIri:
+      return "EncodedIri";
   }
   // This line is reachable if we cast an arbitrary invalid int to this enum
   AD_FAIL();
@@ -110,10 +119,60 @@ class ValueId {
   /// generic code like in the `visit` method.
   struct UndefinedType {};
 
+  /// A string of at most `maxSize` bytes that is stored directly in the bits
+  /// of a `ValueId` of type `InlineString` (see `makeFromInlineString`).
+  class InlineString {
+   public:
+    static constexpr size_t maxSize = 7;
+
+   private:
+    std::array<char, maxSize> chars_{};
+    uint8_t size_ = 0;
+
+   public:
+    InlineString() = default;
+    explicit InlineString(std::string_view s)
+        : size_{static_cast<uint8_t>(s.size())} {
+      AD_CONTRACT_CHECK(s.size() <= maxSize);
+      std::ranges::copy(s, chars_.begin());
+    }
+    std::string_view view() const { return {chars_.data(), size_}; }
+
+    // Strings are compared bytewise (like `std::string_view`), which is
+    // consistent with the order of the bits of the `ValueId`s.
+    bool operator==(const InlineString& other) const {
+      return view() == other.view();
+    }
+    auto operator<=>(const InlineString& other) const {
+      return view() <=> other.view();
+    }
+  };
+
+  /// An IRI of the form `<prefix><number>` (for example
+  /// `<http://www.wikidata.org/entity/Q42>`), where the `prefix` is one of the
+  /// prefixes of the `EncodedIriManager` of the index, which is identified by
+  /// its `prefixIndex_` (see `makeFromEncodedIri`).
+  struct EncodedIri {
+    uint64_t prefixIndex_;
+    uint64_t number_;
+    bool operator==(const EncodedIri&) const = default;
+    auto operator<=>(const EncodedIri&) const = default;
+  };
+  static constexpr T numEncodedIriPrefixBits = 4;
+  static constexpr T maxNumEncodedIriPrefixes = 1ull
+                                                << numEncodedIriPrefixBits;
+  static constexpr T maxEncodedIriNumber =
+      (1ull << (numDataBits - numEncodedIriPrefixBits)) - 1;
+
  private:
   // The actual bits.
   T _bits;
 
+  // The number of (lowest) bits that store the size of an `InlineString`.
+  static constexpr T numInlineSizeBits = 3;
+  static_assert(InlineString::maxSize < (1u << numInlineSizeBits) &&
+                8 * InlineString::maxSize + numInlineSizeBits <= numDataBits);
+
  public:
   /// Default construction of an uninitialized id.
   ValueId() = default;
@@ -239,6 +298,56 @@ class ValueId {
     return std::bit_cast<DateOrLargeYear>(removeDatatypeBits(_bits));
   }
 
+  /// Store a string of at most `InlineString::maxSize` bytes directly in the
+  /// `ValueId`. The bytes are stored in the highest of the data bits (the
+  /// first byte first) followed by the size in the lowest 3 bits, s.t. the
+  /// order of the bits is the lexicographical order of the strings.
+  static ValueId makeFromInlineString(std::string_view s) {
+    AD_CONTRACT_CHECK(s.size() <= InlineString::maxSize);
+    T bits = 0;
+    for (size_t i = 0; i < InlineString::maxSize; ++i) {
+      bits <<= 8;
+      if (i < s.size()) {
+        bits |= static_cast<uint8_t>(s[i]);
+      }
+    }
+    bits = (bits << numInlineSizeBits) | s.size();
+    return addDatatypeBits(bits, Datatype::InlineString);
+  }
+
+  /// Obtain the string that this `ValueId` encodes. If `getDatatype() !=
+  /// InlineString` then the result is unspecified.
+  [[nodiscard]] InlineString getInlineString() const noexcept {
+    auto size = removeDatatypeBits(_bits) &
+                ad_utility::bitMaskForLowerBits(numInlineSizeBits);
+    T chars = removeDatatypeBits(_bits) >> numInlineSizeBits;
+    std::array<char, InlineString::maxSize> buffer;
+    for (size_t i = InlineString::maxSize; i-- > 0;) {
+      buffer[i] = static_cast<char>(chars & 0xFF);
+      chars >>= 8;
+    }
+    return InlineString{std::string_view{buffer.data(), size}};
+  }
+
+  /// Store an `EncodedIri` directly in the `ValueId`. The index of the prefix
+  /// is stored in the highest of the data bits followed by the number, s.t.
+  /// the IRIs with the same prefix are adjacent and ordered by their number.
+  static ValueId makeFromEncodedIri(EncodedIri iri) {
+    AD_CONTRACT_CHECK(iri.prefixIndex_ < maxNumEncodedIriPrefixes &&
+                      iri.number_ <= maxEncodedIriNumber);
+    T bits = (iri.prefixIndex_ << (numDataBits - numEncodedIriPrefixBits)) |
+             iri.number_;
+    return addDatatypeBits(bits, Datatype::EncodedIri);
+  }
+
+  /// Obtain the `EncodedIri` that this `ValueId` encodes. If `getDatatype() !=
+  /// EncodedIri` then the result is unspecified.
+  [[nodiscard]] EncodedIri getEncodedIri() const noexcept {
+    T bits = removeDatatypeBits(_bits);
+    return {bits >> (numDataBits - numEncodedIriPrefixBits),
+            bits & maxEncodedIriNumber};
+  }
+
   // TODO<joka921> implement dates
 
   /// Return the smallest and largest possible `ValueId` wrt the underlying
@@ -291,6 +400,10 @@ class ValueId {
         return std::invoke(visitor, getWordVocabIndex());
       case Datatype::Date:
         return std::invoke(visitor, getDate());
+      case Datatype::InlineString:
+        return std::invoke(visitor, getInlineString());
+      case Datatype::EncodedIri:
+        return std::invoke(visitor, getEncodedIri());
     }
     AD_FAIL();
   }
@@ -322,6 +435,10 @@ class ValueId {
         ostr << (value ? "true" : "false");
       } else if constexpr (ad_utility::isSimilar<T, DateOrLargeYear>) {
         ostr << value.toStringAndType().first;
+      } else if constexpr (ad_utility::isSimilar<T, InlineString>) {
+        ostr << value.view();
+      } else if constexpr (ad_utility::isSimilar<T, EncodedIri>) {
+        ostr << value.prefixIndex_ << ':' << value.number_;
       } else {
         // T is `VocabIndex || LocalVocabIndex || TextRecordIndex`
         ostr << std::to_string(value.get());
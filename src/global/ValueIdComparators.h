@@ -5,6 +5,12 @@
 #ifndef QLEVER_VALUEIDCOMPARATORS_H
 #define QLEVER_VALUEIDCOMPARATORS_H
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
 #include <utility>
 
 #include "global/ValueId.h"
@@ -389,7 +395,10 @@ inline std::vector<std::pair<RandomIt, RandomIt>> getRangesForId(
     case Datatype::TextRecordIndex:
     case Datatype::Bool:
     case Datatype::Date:
-      // For `Date` the trivial comparison via bits is also correct.
+    case Datatype::InlineString:
+    case Datatype::EncodedIri:
+      // For `Date`, `InlineString`, and `EncodedIri` the trivial comparison
+      // via bits is also correct.
       return detail::simplifyRanges(
           detail::getRangesForIndexTypes(begin, end, valueId, comparison));
   }
@@ -422,6 +431,8 @@ inline std::vector<std::pair<RandomIt, RandomIt>> getRangesForEqualIds(
     case Datatype::LocalVocabIndex:
     case Datatype::WordVocabIndex:
     case Datatype::TextRecordIndex:
+    case Datatype::InlineString:
+    case Datatype::EncodedIri:
       return detail::simplifyRanges(detail::getRangesForIndexTypes(
           begin, end, valueIdBegin, valueIdEnd, comparison));
   }
@@ -579,6 +590,199 @@ inline ComparisonResult compareWithEqualIds(ValueId a, ValueId bBegin,
   }
 }
 
+namespace detail {
+// Apply the `Comp` to `a` and `b`.
+template <Comparison Comp, typename T>
+constexpr bool applyComparison(const T& a, const T& b) {
+  using enum Comparison;
+  if constexpr (Comp == LT) {
+    return a < b;
+  } else if constexpr (Comp == LE) {
+    return a <= b;
+  } else if constexpr (Comp == EQ) {
+    return a == b;
+  } else if constexpr (Comp == NE) {
+    return a != b;
+  } else if constexpr (Comp == GE) {
+    return a >= b;
+  } else {
+    static_assert(Comp == GT);
+    return a > b;
+  }
+}
+}  // namespace detail
+
+// Compare each `ValueId` of the `column` with the `constant` and write the
+// results to the `result` (a `Bool` ID or `Undefined` if the types are
+// incompatible). This has the same semantics as
+// `compareIds<AlwaysUndef>(id, constant, Comp)` for each `id`, but is much
+// faster for large columns: The type of the `constant` is dispatched only
+// once, and the loop bodies don't have branches that depend on the data, s.t.
+// the compiler can vectorize them. Note that IDs of the same non-numeric
+// datatype are ordered by their bits (this also holds for `Date`s).
+template <Comparison Comp>
+void compareColumnWithConstant(std::span<const ValueId> column,
+                               ValueId constant, std::span<ValueId> result) {
+  AD_CONTRACT_CHECK(column.size() == result.size());
+  using T = ValueId::T;
+  constexpr T numDataBits = ValueId::numDataBits;
+  constexpr T numDatatypeBits = ValueId::numDatatypeBits;
+  constexpr T falseBits = ValueId::makeFromBool(false).getBits();
+  static_assert(ValueId::makeUndefined().getBits() == 0);
+  // `Undefined` if not `isComparable`, else the `Bool` ID for `value`.
+  auto toResult = [](bool isComparable, bool value) {
+    return ValueId::fromBits(static_cast<T>(isComparable) *
+                             (falseBits | static_cast<T>(value)));
+  };
+
+  const auto type = constant.getDatatype();
+  if (type == Datatype::Undefined) {
+    std::ranges::fill(result, ValueId::makeUndefined());
+  } else if (type == Datatype::Int || type == Datatype::Double) {
+    const bool constantIsInt = type == Datatype::Int;
+    const int64_t intConstant = constant.getInt();
+    const double doubleConstant = constantIsInt
+                                      ? static_cast<double>(intConstant)
+                                      : constant.getDouble();
+    constexpr auto intType = static_cast<T>(Datatype::Int);
+    constexpr auto doubleType = static_cast<T>(Datatype::Double);
+    std::ranges::transform(column, result.begin(), [&](ValueId id) {
+      T bits = id.getBits();
+      T datatype = bits >> numDataBits;
+      bool isInt = datatype == intType;
+      // Same as `getInt()` and `getDouble()`, but without the dependency on
+      // the datatype.
+      int64_t intValue = static_cast<int64_t>(bits << numDatatypeBits) >>
+                         static_cast<int64_t>(numDatatypeBits);
+      double doubleValue =
+          isInt ? static_cast<double>(intValue)
+                : std::bit_cast<double>(bits << numDatatypeBits);
+      bool value =
+          (isInt && constantIsInt)
+              ? detail::applyComparison<Comp>(intValue, intConstant)
+              : detail::applyComparison<Comp>(doubleValue, doubleConstant);
+      return toResult(isInt || datatype == doubleType, value);
+    });
+  } else {
+    // All other datatypes can only be compared with IDs of the same datatype,
+    // and those are ordered by their bits.
+    const T constantBits = constant.getBits();
+    const T constantType = constantBits >> numDataBits;
+    std::ranges::transform(column, result.begin(), [&](ValueId id) {
+      T bits = id.getBits();
+      return toResult(bits >> numDataBits == constantType,
+                      detail::applyComparison<Comp>(bits, constantBits));
+    });
+  }
+}
+
+// Return false if there is no `ValueId` `x` with `lower <= x <= upper` (in the
+// order of the bits, which is the order in which `ValueId`s are sorted in the
+// index) for which `compareIds(x, constant, comparison)` is `True`. Return true
+// if there might be such an `x`. This can be used to skip blocks of sorted
+// `ValueId`s if only their first and last `ValueId` are known. The result is
+// exact for IDs of the same datatype, but conservative (true) for ranges of
+// numeric values that mix positive and negative numbers.
+inline bool mayContainMatchingId(ValueId lower, ValueId upper,
+                                 ValueId constant, Comparison comparison) {
+  using T = ValueId::T;
+  constexpr T numDataBits = ValueId::numDataBits;
+  if (upper < lower) {
+    return false;
+  }
+  // Return the subrange of `[lower, upper]` that has the given `datatype`, or
+  // `std::nullopt` if this subrange is empty.
+  auto getRangeForType =
+      [lower, upper](Datatype datatype) -> std::optional<std::pair<T, T>> {
+    auto type = static_cast<T>(datatype);
+    T lowerType = lower.getBits() >> numDataBits;
+    T upperType = upper.getBits() >> numDataBits;
+    if (type < lowerType || type > upperType) {
+      return std::nullopt;
+    }
+    T first = type == lowerType ? lower.getBits() : type << numDataBits;
+    T last =
+        type == upperType ? upper.getBits() : ((type + 1) << numDataBits) - 1;
+    return std::pair{first, last};
+  };
+  // Is there an `x` in `[first, last]` with `x comparison value`?
+  auto existsMatch = [comparison](const auto& first, const auto& last,
+                                  const auto& value) {
+    using enum Comparison;
+    switch (comparison) {
+      case LT:
+        return first < value;
+      case LE:
+        return first <= value;
+      case EQ:
+        return first <= value && value <= last;
+      case NE:
+        return !(first == value && last == value);
+      case GE:
+        return last >= value;
+      case GT:
+        return last > value;
+      default:
+        AD_FAIL();
+    }
+  };
+
+  auto type = constant.getDatatype();
+  if (type == Datatype::Undefined) {
+    return false;
+  }
+  if (type != Datatype::Int && type != Datatype::Double) {
+    // Only IDs of the same datatype can be compared, those are ordered by
+    // their bits.
+    auto range = getRangeForType(type);
+    return range.has_value() &&
+           existsMatch(range->first, range->second, constant.getBits());
+  }
+
+  // The numeric values are compared as `long double`, which can exactly
+  // represent all the values of `Int` and `Double` IDs.
+  using Value = long double;
+  constexpr auto inf = std::numeric_limits<Value>::infinity();
+  auto toValue = [](ValueId id) -> Value {
+    return id.getDatatype() == Datatype::Int
+               ? static_cast<Value>(id.getInt())
+               : static_cast<Value>(id.getDouble());
+  };
+  const Value value = toValue(constant);
+  // Check the `Int`s, these are ordered by their bits, but the negative
+  // numbers come after the positive numbers.
+  if (auto range = getRangeForType(Datatype::Int)) {
+    int64_t first = ValueId::fromBits(range->first).getInt();
+    int64_t last = ValueId::fromBits(range->second).getInt();
+    if (first > last) {
+      first = ValueId::IntegerType::min();
+      last = ValueId::maxInt;
+    }
+    if (existsMatch(static_cast<Value>(first), static_cast<Value>(last),
+                    value)) {
+      return true;
+    }
+  }
+  // Check the `Double`s, first come the positive doubles in order, then the
+  // negative doubles in reversed order. NaN values are sorted after the
+  // infinities of the same sign.
+  if (auto range = getRangeForType(Datatype::Double)) {
+    double first = ValueId::fromBits(range->first).getDouble();
+    double last = ValueId::fromBits(range->second).getDouble();
+    bool isNan = std::isnan(first) || std::isnan(last);
+    if (!isNan && !std::signbit(first) && !std::signbit(last)) {
+      return existsMatch(static_cast<Value>(first), static_cast<Value>(last),
+                         value);
+    } else if (!isNan && std::signbit(first) && std::signbit(last)) {
+      return existsMatch(static_cast<Value>(last), static_cast<Value>(first),
+                         value);
+    }
+    // The range might contain NaN, for which only `!=` is true.
+    return existsMatch(-inf, inf, value) || comparison == Comparison::NE;
+  }
+  return false;
+}
+
 }  // namespace valueIdComparators
 
 #endif  // QLEVER_VALUEIDCOMPARATORS_H
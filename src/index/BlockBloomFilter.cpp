@@ -0,0 +1,116 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "index/BlockBloomFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "util/Exception.h"
+
+namespace blockBloomFilter {
+namespace {
+
+// The maximal number of hash functions, which is reached for 23 bits per key.
+constexpr size_t MAX_NUM_HASH_FUNCTIONS = 16;
+
+// A fast hash function with good avalanche properties (the finalizer of
+// `splitmix64`).
+uint64_t mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// The hashes of the two kinds of keys. The different constants make sure that
+// the key `col1` is independent of all the keys `(col1, col2)`.
+uint64_t hashKey(Id col1) {
+  return mix(col1.getBits() + 0x9e3779b97f4a7c15ULL);
+}
+uint64_t hashKey(Id col1, Id col2) {
+  return mix(mix(col1.getBits()) ^ (col2.getBits() + 0x632be59bd9b4e019ULL));
+}
+
+// Call `function(word, bit)` for each of the bits that are set for the key
+// with the given `hash` in a filter with `numBits` bits (double hashing). Stop
+// as soon as the `function` returns false and return false in that case.
+bool forEachBit(uint64_t hash, size_t numHashFunctions, size_t numBits,
+                auto function) {
+  uint64_t h1 = hash;
+  // The second hash is odd, s.t. it is never zero and the probed bits differ.
+  uint64_t h2 = (hash >> 32 | hash << 32) | 1;
+  for (size_t i = 0; i < numHashFunctions; ++i) {
+    uint64_t bit = (h1 + i * h2) % numBits;
+    if (!function(bit / 64, bit % 64)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Return true iff the `filter` contains the key with the given `hash`.
+bool containsHash(std::span<const Id> filter, uint64_t hash) {
+  AD_CONTRACT_CHECK(filter.size() >= 2);
+  size_t numHashFunctions = filter[0].getBits();
+  auto bits = filter.subspan(1);
+  return forEachBit(hash, numHashFunctions, bits.size() * 64,
+                    [&bits](size_t word, size_t bit) {
+                      return (bits[word].getBits() >> bit & 1) != 0;
+                    });
+}
+}  // namespace
+
+// _____________________________________________________________________________
+std::vector<Id> build(std::span<const Id> col1, std::span<const Id> col2,
+                      size_t bitsPerKey) {
+  AD_CONTRACT_CHECK(col1.size() == col2.size());
+  AD_CONTRACT_CHECK(bitsPerKey > 0);
+  // The `col1` is sorted within each relation, so the number of changes is
+  // (an upper bound for) the number of distinct `col1`s.
+  size_t numDistinctCol1 = col1.empty() ? 0 : 1;
+  for (size_t i = 1; i < col1.size(); ++i) {
+    numDistinctCol1 += col1[i] != col1[i - 1];
+  }
+  size_t numKeys = numDistinctCol1 + col2.size();
+  size_t numWords = std::max(size_t{1}, (numKeys * bitsPerKey + 63) / 64);
+  size_t numHashFunctions = std::clamp(
+      static_cast<size_t>(std::round(static_cast<double>(bitsPerKey) *
+                                     std::log(2.0))),
+      size_t{1}, MAX_NUM_HASH_FUNCTIONS);
+
+  std::vector<uint64_t> bits(numWords, 0);
+  auto add = [&bits, numHashFunctions](uint64_t hash) {
+    forEachBit(hash, numHashFunctions, bits.size() * 64,
+               [&bits](size_t word, size_t bit) {
+                 bits[word] |= uint64_t{1} << bit;
+                 return true;
+               });
+  };
+  for (size_t i = 0; i < col1.size(); ++i) {
+    if (i == 0 || col1[i] != col1[i - 1]) {
+      add(hashKey(col1[i]));
+    }
+    add(hashKey(col1[i], col2[i]));
+  }
+
+  std::vector<Id> result;
+  result.reserve(numWords + 1);
+  result.push_back(Id::fromBits(numHashFunctions));
+  std::ranges::transform(bits, std::back_inserter(result), &Id::fromBits);
+  return result;
+}
+
+// _____________________________________________________________________________
+bool mightContain(std::span<const Id> filter, Id col1) {
+  return containsHash(filter, hashKey(col1));
+}
+
+// _____________________________________________________________________________
+bool mightContain(std::span<const Id> filter, Id col1, Id col2) {
+  return containsHash(filter, hashKey(col1, col2));
+}
+}  // namespace blockBloomFilter
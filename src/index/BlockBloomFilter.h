@@ -0,0 +1,41 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "global/Id.h"
+
+// Bloom filters for the blocks of the index permutations. The filter of a
+// block contains the `col1` of each of its rows and the pair `(col1, col2)` of
+// each of its rows, s.t. the scans with a fixed `col1` can skip the blocks that
+// don't contain the `col1` without reading and decompressing them. This is
+// most useful for point lookups that find nothing, for which the first and last
+// triple of the blocks are not sufficient (the `col1` lies between them).
+//
+// The filter is stored as a sequence of `Id`s of which only the bits are
+// used, s.t. it can be written to the file of the permutation and cached
+// together with the decompressed columns (see `DecompressedBlockCache`). The
+// first `Id` is the number of hash functions, the others are the bits of the
+// filter. Note that the `col0` is not part of the keys, because it is not
+// stored in the blocks. For blocks with several small relations, this only
+// leads to more false positives.
+namespace blockBloomFilter {
+
+// Build the Bloom filter for a block with the given `col1` and `col2`, which
+// must have the same size, with `bitsPerKey` bits per key (which must be
+// positive). The number of hash functions is chosen optimally, s.t. for
+// example 10 bits per key lead to a false positive rate of about one percent.
+std::vector<Id> build(std::span<const Id> col1, std::span<const Id> col2,
+                      size_t bitsPerKey);
+
+// Return false if the `filter` (the result of `build`) certainly doesn't
+// contain the `col1` (or the pair of `col1` and `col2`). True means that the
+// block might contain it.
+bool mightContain(std::span<const Id> filter, Id col1);
+bool mightContain(std::span<const Id> filter, Id col1, Id col2);
+
+}  // namespace blockBloomFilter
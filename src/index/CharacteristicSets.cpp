@@ -0,0 +1,93 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/CharacteristicSets.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "util/Exception.h"
+#include "util/Serializer/FileSerializer.h"
+
+// _____________________________________________________________________________
+void CharacteristicSets::add(Set set) {
+  AD_CONTRACT_CHECK(set.predicates_.size() == set.numTriples_.size());
+  AD_CONTRACT_CHECK(set.numSubjects_ > 0);
+  // Sort the predicates (and the corresponding numbers of triples), s.t. they
+  // can be found via binary search.
+  std::vector<size_t> permutation(set.predicates_.size());
+  std::iota(permutation.begin(), permutation.end(), 0);
+  std::ranges::sort(permutation, std::less<>{},
+                    [&set](size_t i) { return set.predicates_[i]; });
+  Set sorted;
+  sorted.numSubjects_ = set.numSubjects_;
+  for (size_t i : permutation) {
+    sorted.predicates_.push_back(set.predicates_[i]);
+    sorted.numTriples_.push_back(set.numTriples_[i]);
+  }
+  AD_CONTRACT_CHECK(std::ranges::adjacent_find(sorted.predicates_) ==
+                    sorted.predicates_.end());
+  for (Id predicate : sorted.predicates_) {
+    setsWithPredicate_[predicate].push_back(sets_.size());
+  }
+  sets_.push_back(std::move(sorted));
+}
+
+// _____________________________________________________________________________
+std::optional<double> CharacteristicSets::estimateStarSize(
+    std::span<const Id> predicates) const {
+  if (sets_.empty() || predicates.empty()) {
+    return std::nullopt;
+  }
+  // Only the sets that contain the rarest of the `predicates` have to be
+  // considered.
+  const std::vector<size_t>* candidates = nullptr;
+  for (Id predicate : predicates) {
+    auto it = setsWithPredicate_.find(predicate);
+    if (it == setsWithPredicate_.end()) {
+      return 0.0;
+    }
+    if (candidates == nullptr || it->second.size() < candidates->size()) {
+      candidates = &it->second;
+    }
+  }
+  double result = 0;
+  for (size_t index : *candidates) {
+    const Set& set = sets_[index];
+    double numSubjects = static_cast<double>(set.numSubjects_);
+    double size = numSubjects;
+    bool containsAllPredicates = true;
+    for (Id predicate : predicates) {
+      auto it = std::ranges::lower_bound(set.predicates_, predicate);
+      if (it == set.predicates_.end() || *it != predicate) {
+        containsAllPredicates = false;
+        break;
+      }
+      auto numTriples = set.numTriples_[it - set.predicates_.begin()];
+      size *= static_cast<double>(numTriples) / numSubjects;
+    }
+    if (containsAllPredicates) {
+      result += size;
+    }
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+void CharacteristicSets::writeToFile(const std::string& filename) const {
+  ad_utility::serialization::FileWriteSerializer serializer{filename};
+  serializer << sets_;
+}
+
+// _____________________________________________________________________________
+CharacteristicSets CharacteristicSets::readFromFile(
+    const std::string& filename) {
+  ad_utility::serialization::FileReadSerializer serializer{filename};
+  std::vector<Set> sets;
+  serializer >> sets;
+  CharacteristicSets result;
+  for (auto& set : sets) {
+    result.add(std::move(set));
+  }
+  return result;
+}
@@ -0,0 +1,79 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/HashMap.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+// The characteristic sets of an index, which are used to estimate the sizes of
+// star-shaped joins on a common subject. The characteristic set of a subject is
+// the set of its predicates (the same as its pattern, see `PatternCreator`).
+// For each distinct characteristic set we store the number of subjects that
+// have it and, for each of its predicates, the total number of triples of these
+// subjects with this predicate. Unlike the per-column multiplicities, these
+// statistics capture the correlation between predicates. For example, only a
+// small fraction of the subjects with a `<birthDate>` will also have a
+// `<numberOfEmployees>`.
+//
+// See Neumann and Moerkotte, "Characteristic Sets: Accurate Cardinality
+// Estimation for RDF Queries with Multiple Joins", ICDE 2011.
+class CharacteristicSets {
+ public:
+  // The characteristic sets are written to the pattern file with this suffix.
+  static constexpr std::string_view FILE_SUFFIX = ".characteristic-sets";
+
+  struct Set {
+    // The distinct predicates of the set, sorted.
+    std::vector<Id> predicates_;
+    // The number of subjects with exactly these predicates.
+    uint64_t numSubjects_ = 0;
+    // `numTriples_[i]` is the number of triples of these subjects with the
+    // predicate `predicates_[i]`.
+    std::vector<uint64_t> numTriples_;
+
+    AD_SERIALIZE_FRIEND_FUNCTION(Set) {
+      serializer | arg.predicates_;
+      serializer | arg.numSubjects_;
+      serializer | arg.numTriples_;
+    }
+  };
+
+ private:
+  std::vector<Set> sets_;
+  // For each predicate the indices of the sets in `sets_` that contain it.
+  ad_utility::HashMap<Id, std::vector<size_t>> setsWithPredicate_;
+
+ public:
+  // Add a set. The `predicates_` don't have to be sorted, but are not allowed
+  // to contain duplicates.
+  void add(Set set);
+
+  // The number of distinct characteristic sets.
+  size_t size() const { return sets_.size(); }
+  bool empty() const { return sets_.empty(); }
+
+  // Estimate the size of the join of the scans `?s <p> ?o_p` for all the
+  // `predicates` (which may contain duplicates) on the common subject `?s`,
+  // where all the `?o_p` are distinct variables. This is the sum over all the
+  // sets that contain all the `predicates` of the number of subjects of the
+  // set times the product of the average number of triples per subject for
+  // each of the `predicates`. Return `std::nullopt` if no characteristic
+  // sets are available or `predicates` is empty.
+  std::optional<double> estimateStarSize(std::span<const Id> predicates) const;
+
+  // Write the sets to the `filename`.
+  void writeToFile(const std::string& filename) const;
+
+  // Read the sets that were written by `writeToFile` from the `filename`.
+  static CharacteristicSets readFromFile(const std::string& filename);
+};
@@ -0,0 +1,190 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "index/ColumnCodec.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#include "util/CompressionUsingZstd/ZstdWrapper.h"
+#include "util/Exception.h"
+
+namespace columnCodec {
+namespace {
+
+using Frame = std::array<uint64_t, FRAME_SIZE>;
+
+// The number of 64-bit words that are needed to store `numValues` values with
+// `width` bits each.
+size_t numWords(size_t numValues, size_t width) {
+  return (numValues * width + 63) / 64;
+}
+
+// Append the `numValues` first values of the `frame`, each of which has at most
+// `width` bits, to the `out` buffer.
+void packFrame(const Frame& frame, size_t numValues, size_t width,
+               std::vector<char>& out) {
+  std::array<uint64_t, FRAME_SIZE> words{};
+  if (width > 0) {
+    for (size_t i = 0; i < numValues; ++i) {
+      size_t bitPos = i * width;
+      size_t word = bitPos / 64;
+      size_t offset = bitPos % 64;
+      words[word] |= frame[i] << offset;
+      if (offset + width > 64) {
+        words[word + 1] |= frame[i] >> (64 - offset);
+      }
+    }
+  }
+  auto bytes = numWords(numValues, width) * sizeof(uint64_t);
+  auto oldSize = out.size();
+  out.resize(oldSize + bytes);
+  std::memcpy(out.data() + oldSize, words.data(), bytes);
+}
+
+// Inverse of `packFrame`: Read `numValues` values with `width` bits each from
+// the `in` buffer into the `frame` and return the number of bytes read.
+size_t unpackFrame(const char* in, size_t numValues, size_t width,
+                   Frame& frame) {
+  std::array<uint64_t, FRAME_SIZE + 1> words{};
+  auto bytes = numWords(numValues, width) * sizeof(uint64_t);
+  std::memcpy(words.data(), in, bytes);
+  const uint64_t mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+  for (size_t i = 0; i < numValues; ++i) {
+    size_t bitPos = i * width;
+    size_t word = bitPos / 64;
+    size_t offset = bitPos % 64;
+    uint64_t value = words[word] >> offset;
+    // `words` has one additional word, s.t. this read is always valid. The
+    // shift by 64 (for `offset == 0`) is avoided via the ternary operator.
+    value |= offset == 0 ? 0 : words[word + 1] << (64 - offset);
+    frame[i] = value & mask;
+  }
+  return bytes;
+}
+
+// Encode the `column` with one of the lightweight codecs.
+std::vector<char> encodeFrames(std::span<const Id> column, bool useDelta) {
+  std::vector<char> result;
+  Frame frame;
+  for (size_t start = 0; start < column.size(); start += FRAME_SIZE) {
+    auto numValues = std::min(FRAME_SIZE, column.size() - start);
+    auto values = column.subspan(start, numValues);
+    uint64_t reference = 0;
+    if (useDelta) {
+      reference = values[0].getBits();
+      uint64_t previous = reference;
+      for (size_t i = 0; i < numValues; ++i) {
+        // The unsigned arithmetic wraps around, so the decoding is correct
+        // even if the column is not sorted.
+        frame[i] = values[i].getBits() - previous;
+        previous = values[i].getBits();
+      }
+    } else {
+      reference = std::ranges::min(values, {}, &Id::getBits).getBits();
+      for (size_t i = 0; i < numValues; ++i) {
+        frame[i] = values[i].getBits() - reference;
+      }
+    }
+    uint64_t allBits = 0;
+    for (size_t i = 0; i < numValues; ++i) {
+      allBits |= frame[i];
+    }
+    auto width = static_cast<uint8_t>(std::bit_width(allBits));
+    auto oldSize = result.size();
+    result.resize(oldSize + sizeof(reference) + sizeof(width));
+    std::memcpy(result.data() + oldSize, &reference, sizeof(reference));
+    std::memcpy(result.data() + oldSize + sizeof(reference), &width,
+                sizeof(width));
+    packFrame(frame, numValues, width, result);
+  }
+  return result;
+}
+
+// Decode a column that was encoded by `encodeFrames`.
+void decodeFrames(std::span<const char> encoded, std::span<Id> result,
+                  bool useDelta) {
+  const char* in = encoded.data();
+  Frame frame;
+  for (size_t start = 0; start < result.size(); start += FRAME_SIZE) {
+    auto numValues = std::min(FRAME_SIZE, result.size() - start);
+    uint64_t reference;
+    uint8_t width;
+    AD_CORRECTNESS_CHECK(in + sizeof(reference) + sizeof(width) <=
+                         encoded.data() + encoded.size());
+    std::memcpy(&reference, in, sizeof(reference));
+    std::memcpy(&width, in + sizeof(reference), sizeof(width));
+    in += sizeof(reference) + sizeof(width);
+    AD_CORRECTNESS_CHECK(width <= 64);
+    AD_CORRECTNESS_CHECK(in + numWords(numValues, width) * sizeof(uint64_t) <=
+                         encoded.data() + encoded.size());
+    in += unpackFrame(in, numValues, width, frame);
+    auto out = result.subspan(start, numValues);
+    if (useDelta) {
+      uint64_t current = reference;
+      for (size_t i = 0; i < numValues; ++i) {
+        current += frame[i];
+        out[i] = Id::fromBits(current);
+      }
+    } else {
+      for (size_t i = 0; i < numValues; ++i) {
+        out[i] = Id::fromBits(reference + frame[i]);
+      }
+    }
+  }
+  AD_CORRECTNESS_CHECK(in == encoded.data() + encoded.size());
+}
+}  // namespace
+
+// _____________________________________________________________________________
+std::vector<char> encode(ColumnCodec codec, std::span<const Id> column) {
+  switch (codec) {
+    case ColumnCodec::Zstd:
+      return ZstdWrapper::compress(column.data(), column.size() * sizeof(Id));
+    case ColumnCodec::DeltaBitPacking:
+      return encodeFrames(column, true);
+    case ColumnCodec::FrameOfReference:
+      return encodeFrames(column, false);
+  }
+  AD_FAIL();
+}
+
+// _____________________________________________________________________________
+void decode(ColumnCodec codec, std::span<const char> encoded,
+            std::span<Id> result) {
+  switch (codec) {
+    case ColumnCodec::Zstd: {
+      auto numBytesActuallyRead = ZstdWrapper::decompressToBuffer(
+          encoded.data(), encoded.size(), result.data(),
+          result.size() * sizeof(Id));
+      AD_CORRECTNESS_CHECK(result.size() * sizeof(Id) == numBytesActuallyRead);
+      return;
+    }
+    case ColumnCodec::DeltaBitPacking:
+      return decodeFrames(encoded, result, true);
+    case ColumnCodec::FrameOfReference:
+      return decodeFrames(encoded, result, false);
+  }
+  AD_FAIL();
+}
+
+// _____________________________________________________________________________
+std::pair<ColumnCodec, std::vector<char>> encodeWithBestCodec(
+    std::span<const Id> column) {
+  auto delta = encode(ColumnCodec::DeltaBitPacking, column);
+  auto frameOfReference = encode(ColumnCodec::FrameOfReference, column);
+  auto [lightweightCodec, lightweight] =
+      delta.size() <= frameOfReference.size()
+          ? std::pair{ColumnCodec::DeltaBitPacking, std::move(delta)}
+          : std::pair{ColumnCodec::FrameOfReference,
+                      std::move(frameOfReference)};
+  auto zstd = encode(ColumnCodec::Zstd, column);
+  if (static_cast<double>(lightweight.size()) <=
+      MAX_SIZE_FACTOR_OF_LIGHTWEIGHT_CODEC * static_cast<double>(zstd.size())) {
+    return {lightweightCodec, std::move(lightweight)};
+  }
+  return {ColumnCodec::Zstd, std::move(zstd)};
+}
+}  // namespace columnCodec
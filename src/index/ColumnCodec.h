@@ -0,0 +1,62 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "global/Id.h"
+
+// The codecs with which the columns of the blocks of the index permutations
+// can be compressed. The codec of each column is stored in the
+// `CompressedBlockMetadata`.
+//
+// The two lightweight codecs split a column into frames of `FRAME_SIZE` values.
+// Each frame stores a 64-bit reference value and a bit width followed by the
+// bit-packed values of the frame:
+// - `DeltaBitPacking` packs the differences between consecutive values (the
+//   reference is the first value of the frame). It is very compact for sorted
+//   columns like the col1 of a permutation.
+// - `FrameOfReference` packs the differences to the smallest value of the
+//   frame, which also works well for unsorted columns with a small range of
+//   values like the col2 of a permutation.
+// Both are decoded without any branches in the inner loop, which is much faster
+// than the decompression of ZSTD, which remains the fallback for columns that
+// the lightweight codecs can't compress well.
+enum class ColumnCodec : uint8_t {
+  Zstd = 0,
+  DeltaBitPacking = 1,
+  FrameOfReference = 2
+};
+
+// Allow the serialization of the `ColumnCodec` as part of the block metadata.
+std::true_type allowTrivialSerialization(ColumnCodec, auto);
+
+namespace columnCodec {
+
+// The number of values in a frame of the lightweight codecs.
+static constexpr size_t FRAME_SIZE = 128;
+
+// A lightweight codec is chosen if the compressed column is at most this factor
+// larger than its ZSTD compression, because its decoding is much cheaper.
+static constexpr double MAX_SIZE_FACTOR_OF_LIGHTWEIGHT_CODEC = 1.5;
+
+// Compress the `column` using the `codec`.
+std::vector<char> encode(ColumnCodec codec, std::span<const Id> column);
+
+// Decompress the `encoded` column, which was compressed using the `codec`,
+// into the `result`, which must have the size of the original column.
+void decode(ColumnCodec codec, std::span<const char> encoded,
+            std::span<Id> result);
+
+// Compress the `column` with each of the codecs and return the codec that is
+// best in terms of compressed size and decoding speed (see
+// `MAX_SIZE_FACTOR_OF_LIGHTWEIGHT_CODEC`) together with the compressed column.
+std::pair<ColumnCodec, std::vector<char>> encodeWithBestCodec(
+    std::span<const Id> column);
+
+}  // namespace columnCodec
@@ -0,0 +1,44 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/CompressedPatternIds.h"
+
+#include <algorithm>
+
+// _____________________________________________________________________________
+CompressedPatternIds::CompressedPatternIds(
+    const std::vector<PatternID>& patternIds) {
+  size_t numPatterns = 0;
+  for (PatternID patternId : patternIds) {
+    if (patternId != NO_PATTERN) {
+      numPatterns = std::max(numPatterns, size_t{patternId} + 1);
+    }
+  }
+  ownedWords_.resize(HEADER_SIZE);
+  Packer packer{ownedWords_, numPatterns};
+  std::ranges::for_each(patternIds,
+                        [&packer](PatternID id) { packer.push(id); });
+  packer.finish();
+  setFromWords(ownedWords_);
+}
+
+// _____________________________________________________________________________
+CompressedPatternIds CompressedPatternIds::readFromFile(
+    const std::string& filename) {
+  CompressedPatternIds result;
+  result.mappedWords_.open(filename, ad_utility::AccessPattern::Random);
+  result.setFromWords({result.mappedWords_.data(), result.mappedWords_.size()});
+  return result;
+}
+
+// _____________________________________________________________________________
+void CompressedPatternIds::setFromWords(std::span<const uint64_t> words) {
+  AD_CORRECTNESS_CHECK(words.size() >= HEADER_SIZE);
+  size_ = words[0];
+  bitWidth_ = words[1];
+  AD_CORRECTNESS_CHECK(bitWidth_ >= 1 && bitWidth_ <= 32);
+  AD_CORRECTNESS_CHECK(words.size() - HEADER_SIZE ==
+                       (size_ * bitWidth_ + 63) / 64);
+  mask_ = maskFor(bitWidth_);
+  data_ = words.data() + HEADER_SIZE;
+}
@@ -0,0 +1,134 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "global/Pattern.h"
+#include "util/Exception.h"
+#include "util/MmapVector.h"
+
+// The mapping from the subjects (their `VocabIndex`) to the IDs of their
+// patterns (the `has-pattern` mapping). The pattern IDs are bit-packed with the
+// minimal number of bits for the number of patterns, where the largest value
+// of this width encodes `NO_PATTERN`. The mapping is either memory-mapped from
+// a file (see `readFromFile`), s.t. only the parts that are accessed are read
+// from disk and the mapping doesn't take resident memory when it is not used,
+// or it is held in memory (which is mostly useful for tests).
+class CompressedPatternIds {
+ public:
+  static constexpr std::string_view FILE_SUFFIX = ".has-pattern.packed";
+
+  // The stored words start with this header: the number of pattern IDs and
+  // the number of bits per pattern ID.
+  static constexpr size_t HEADER_SIZE = 2;
+
+  // Append pattern IDs bit-packed to the `Words` (a `std::vector<uint64_t>` or
+  // an `ad_utility::MmapVector<uint64_t>`), which must contain the header.
+  template <typename Words>
+  class Packer {
+   private:
+    Words& words_;
+    size_t bitWidth_;
+    uint64_t mask_;
+    size_t size_ = 0;
+    uint64_t buffer_ = 0;
+    size_t numBitsInBuffer_ = 0;
+
+   public:
+    Packer(Words& words, size_t numPatterns)
+        : words_{words},
+          bitWidth_{bitWidthFor(numPatterns)},
+          mask_{maskFor(bitWidth_)} {
+      AD_CONTRACT_CHECK(words_.size() == HEADER_SIZE);
+    }
+
+    void push(PatternID patternId) {
+      uint64_t code = patternId == NO_PATTERN ? mask_ : patternId;
+      AD_CONTRACT_CHECK(code <= mask_);
+      buffer_ |= code << numBitsInBuffer_;
+      numBitsInBuffer_ += bitWidth_;
+      if (numBitsInBuffer_ >= 64) {
+        words_.push_back(buffer_);
+        numBitsInBuffer_ -= 64;
+        // The high bits of `code` that didn't fit into the full word.
+        buffer_ =
+            numBitsInBuffer_ > 0 ? code >> (bitWidth_ - numBitsInBuffer_) : 0;
+      }
+      ++size_;
+    }
+
+    // Write the last partial word and the header.
+    void finish() {
+      if (numBitsInBuffer_ > 0) {
+        words_.push_back(buffer_);
+        numBitsInBuffer_ = 0;
+      }
+      words_[0] = size_;
+      words_[1] = bitWidth_;
+    }
+  };
+
+ private:
+  std::vector<uint64_t> ownedWords_;
+  ad_utility::MmapVectorView<uint64_t> mappedWords_;
+  // Points to the words after the header, either in `ownedWords_` or in
+  // `mappedWords_`.
+  const uint64_t* data_ = nullptr;
+  size_t size_ = 0;
+  size_t bitWidth_ = 1;
+  uint64_t mask_ = 1;
+
+ public:
+  CompressedPatternIds() = default;
+
+  // Compress the `patternIds` in memory. The conversion is implicit, s.t.
+  // functions that take a `CompressedPatternIds` can be called with a vector
+  // in tests.
+  CompressedPatternIds(const std::vector<PatternID>& patternIds);
+
+  CompressedPatternIds(CompressedPatternIds&&) noexcept = default;
+  CompressedPatternIds& operator=(CompressedPatternIds&&) noexcept = default;
+
+  // Memory-map the pattern IDs from the `filename`, which must have been
+  // written by a `Packer` for an `ad_utility::MmapVector<uint64_t>`.
+  static CompressedPatternIds readFromFile(const std::string& filename);
+
+  size_t size() const { return size_; }
+  size_t bitWidth() const { return bitWidth_; }
+
+  // The pattern ID of the subject with the `idx`, which must be `< size()`.
+  PatternID operator[](size_t idx) const {
+    size_t bitPos = idx * bitWidth_;
+    size_t wordIdx = bitPos / 64;
+    size_t offset = bitPos % 64;
+    uint64_t code = data_[wordIdx] >> offset;
+    if (offset + bitWidth_ > 64) {
+      code |= data_[wordIdx + 1] << (64 - offset);
+    }
+    code &= mask_;
+    return code == mask_ ? NO_PATTERN : static_cast<PatternID>(code);
+  }
+
+  // The number of bits that is used for the pattern IDs if there are
+  // `numPatterns` patterns (the additional value is `NO_PATTERN`).
+  static size_t bitWidthFor(size_t numPatterns) {
+    size_t bitWidth = std::bit_width(numPatterns);
+    return std::max(size_t{1}, bitWidth);
+  }
+
+ private:
+  static uint64_t maskFor(size_t bitWidth) {
+    return bitWidth == 64 ? ~uint64_t{0} : (uint64_t{1} << bitWidth) - 1;
+  }
+
+  // Set the members from the header of the `words`.
+  void setFromWords(std::span<const uint64_t> words);
+};
@@ -4,15 +4,22 @@
 
 #include "CompressedRelation.h"
 
+#include <atomic>
+#include <cmath>
 #include <ranges>
 
 #include "engine/idTable/IdTable.h"
+#include "index/BlockBloomFilter.h"
+#include "index/LazyScanPrefetch.h"
 #include "util/Cache.h"
-#include "util/CompressionUsingZstd/ZstdWrapper.h"
 #include "util/ConcurrentCache.h"
 #include "util/Generator.h"
 #include "util/OnDestructionDontThrowDuringStackUnwinding.h"
+#include "util/OperationStatistics.h"
 #include "util/OverloadCallOperator.h"
+#include "util/ParallelExecution.h"
+#include "util/Probes.h"
+#include "util/QueryTrace.h"
 #include "util/ThreadSafeQueue.h"
 #include "util/Timer.h"
 #include "util/TypeTraits.h"
@@ -36,13 +43,34 @@ CompressedRelationReader::asyncParallelBlockGenerator(
   }
   const size_t queueSize =
       RuntimeParameters().get<"lazy-index-scan-queue-size">();
+  const size_t numPrefetchedBlocks =
+      RuntimeParameters().get<"index-scan-num-prefetched-blocks">();
+  prefetchBlocks(std::span{beginBlock, std::min(numPrefetchedBlocks,
+                                                static_cast<size_t>(
+                                                    endBlock - beginBlock))},
+                 columnIndices);
+  // The number of threads that read the blocks and the number of blocks that
+  // are read ahead are adapted while the blocks are consumed.
+  LazyScanPrefetchController prefetchController;
   auto blockIterator = beginBlock;
   std::mutex blockIteratorMutex;
-  auto readAndDecompressBlock =
+  // The blocks are read and decompressed on the worker threads of the queue
+  // below, to which the trace of the query (if any) and the statistics of the
+  // current operation are propagated.
+  auto traceContext = ad_utility::QueryTrace::currentContext();
+  auto* statistics = ad_utility::OperationStatistics::current();
+  auto readAndDecompressNextBlock =
       [&]() -> std::optional<std::pair<size_t, DecompressedBlock>> {
+    ad_utility::QueryTrace::Scope traceScope{traceContext};
+    ad_utility::OperationStatistics::Scope statisticsScope{statistics};
     checkCancellation(cancellationHandle);
+    if (!prefetchController.startBlock()) {
+      return std::nullopt;
+    }
     std::unique_lock lock{blockIteratorMutex};
     if (blockIterator == endBlock) {
+      // Wake up the threads that are waiting in `startBlock`.
+      prefetchController.finish();
       return std::nullopt;
     }
     // Note: taking a copy here is probably not necessary (the lifetime of
@@ -54,15 +82,23 @@ CompressedRelationReader::asyncParallelBlockGenerator(
     // so we have to compute it before incrementing the iterator.
     auto myIndex = static_cast<size_t>(blockIterator - beginBlock);
     ++blockIterator;
-    // Note: the reading of the block could also happen without holding the
-    // lock. We still perform it inside the lock to avoid contention of the
-    // file. On a fast SSD we could possibly change this, but this has to be
-    // investigated.
-    CompressedBlock compressedBlock =
-        readCompressedBlockFromFile(block, columnIndices);
+    if (numPrefetchedBlocks < static_cast<size_t>(endBlock - blockIterator)) {
+      prefetchBlocks(std::span{blockIterator + numPrefetchedBlocks, 1},
+                     columnIndices);
+    }
     lock.unlock();
-    return std::pair{myIndex, decompressBlock(compressedBlock, block.numRows_)};
+    // The block is read outside of the lock (`File::read` with an offset is
+    // thread-safe), s.t. blocks that are already contained in the
+    // `DecompressedBlockCache` don't have to wait for the reads of other
+    // blocks.
+    ad_utility::Timer decompressionTimer{ad_utility::Timer::Started};
+    auto result =
+        std::pair{myIndex, readAndDecompressBlock(block, columnIndices)};
+    prefetchController.finishBlock(decompressionTimer.value());
+    return result;
   };
+  // This is the maximal number of threads, most of them might wait in
+  // `LazyScanPrefetchController::startBlock`.
   const size_t numThreads =
       RuntimeParameters().get<"lazy-index-scan-num-threads">();
 
@@ -74,14 +110,37 @@ CompressedRelationReader::asyncParallelBlockGenerator(
 
   auto queue = ad_utility::data_structures::queueManager<
       ad_utility::data_structures::OrderedThreadSafeQueue<IdTable>>(
-      queueSize, numThreads, readAndDecompressBlock);
+      queueSize, numThreads, readAndDecompressNextBlock);
+  // The worker threads are joined when the `queue` is destroyed, so the
+  // threads that wait for the `prefetchController` have to be woken up before
+  // (this is relevant if the consumer stops early).
+  auto finishPrefetchController =
+      ad_utility::makeOnDestructionDontThrowDuringStackUnwinding(
+          [&prefetchController, &details]() {
+            prefetchController.finish();
+            details.maxNumThreads_ = prefetchController.maxNumThreadsUsed();
+            details.maxPrefetchDepth_ =
+                prefetchController.maxPrefetchDepthUsed();
+          });
+  auto beginOfWait = ad_utility::QueryTrace::Clock::now();
+  ad_utility::Timer waitTimer{ad_utility::Timer::Started};
+  ad_utility::Timer consumerTimer{ad_utility::Timer::Stopped};
   for (IdTable& block : queue) {
     popTimer.stop();
+    prefetchController.blockConsumed(waitTimer.value(), consumerTimer.value());
+    if (traceContext.trace_ != nullptr) {
+      traceContext.trace_->addSpan("wait for block of lazy scan", "lazy-scan",
+                                   beginOfWait, traceContext.spanId_);
+    }
     checkCancellation(cancellationHandle);
     ++details.numBlocksRead_;
     details.numElementsRead_ += block.numRows();
+    consumerTimer.start();
     co_yield block;
+    consumerTimer.stop();
+    waitTimer.start();
     popTimer.cont();
+    beginOfWait = ad_utility::QueryTrace::Clock::now();
   }
   // The `OnDestruction...` above might be called too late, so we manually stop
   // the timer here in case it wasn't already.
@@ -95,11 +154,21 @@ CompressedRelationReader::IdTableGenerator CompressedRelationReader::lazyScan(
     ColumnIndices additionalColumns,
     ad_utility::SharedCancellationHandle cancellationHandle) const {
   AD_CONTRACT_CHECK(cancellationHandle);
-  auto relevantBlocks = getBlocksFromMetadata(metadata, col1Id, blockMetadata);
+  auto blocksOfRelation =
+      getBlocksFromMetadata(metadata, col1Id, blockMetadata);
+  auto relevantBlocks = filterBlocksWithBloomFilters(blocksOfRelation, col1Id);
   auto [beginBlock, endBlock] = getBeginAndEnd(relevantBlocks);
 
   LazyScanMetadata& details = co_await cppcoro::getDetails;
   size_t numBlocksTotal = endBlock - beginBlock;
+  // For the scans of a join, the `blockMetadata` is only the subset of the
+  // blocks that can contain matches (see `getBlocksForJoin`).
+  if (details.numBlocksAll_ > blocksOfRelation.size()) {
+    metrics_.blocksSkipped_->increment(details.numBlocksAll_ -
+                                       blocksOfRelation.size());
+    ad_utility::OperationStatistics::addBlocksSkipped(
+        details.numBlocksAll_ - blocksOfRelation.size());
+  }
 
   if (beginBlock == endBlock) {
     co_return;
@@ -229,6 +298,43 @@ std::vector<CompressedBlockMetadata> CompressedRelationReader::getBlocksForJoin(
   return result;
 }
 
+// _____________________________________________________________________________
+std::vector<CompressedBlockMetadata>
+CompressedRelationReader::getBlocksForFilter(
+    const MetadataAndBlocks& metadataAndBlocks,
+    valueIdComparators::Comparison comparison, Id constant) {
+  auto mayContainMatch = [&](const CompressedBlockMetadata& block) {
+    return valueIdComparators::mayContainMatchingId(
+        getRelevantIdFromTriple(block.firstTriple_, metadataAndBlocks),
+        getRelevantIdFromTriple(block.lastTriple_, metadataAndBlocks),
+        constant, comparison);
+  };
+  std::vector<CompressedBlockMetadata> result;
+  std::ranges::copy(getBlocksFromMetadata(metadataAndBlocks) |
+                        std::views::filter(mayContainMatch),
+                    std::back_inserter(result));
+  return result;
+}
+
+// _____________________________________________________________________________
+std::vector<CompressedBlockMetadata>
+CompressedRelationReader::getBlocksForIdRanges(
+    const MetadataAndBlocks& metadataAndBlocks,
+    std::span<const std::pair<Id, Id>> ranges) {
+  auto mayContainMatch = [&](const CompressedBlockMetadata& block) {
+    Id first = getRelevantIdFromTriple(block.firstTriple_, metadataAndBlocks);
+    Id last = getRelevantIdFromTriple(block.lastTriple_, metadataAndBlocks);
+    return std::ranges::any_of(ranges, [first, last](const auto& range) {
+      return first <= range.second && range.first <= last;
+    });
+  };
+  std::vector<CompressedBlockMetadata> result;
+  std::ranges::copy(getBlocksFromMetadata(metadataAndBlocks) |
+                        std::views::filter(mayContainMatch),
+                    std::back_inserter(result));
+  return result;
+}
+
 // _____________________________________________________________________________
 std::array<std::vector<CompressedBlockMetadata>, 2>
 CompressedRelationReader::getBlocksForJoin(
@@ -305,7 +411,8 @@ IdTable CompressedRelationReader::scan(
 
   // Get all the blocks  that possibly might contain our pair of col0Id and
   // col1Id
-  auto relevantBlocks = getBlocksFromMetadata(metadata, col1Id, blocks);
+  auto relevantBlocks = filterBlocksWithBloomFilters(
+      getBlocksFromMetadata(metadata, col1Id, blocks), col1Id);
   auto beginBlock = relevantBlocks.begin();
   auto endBlock = relevantBlocks.end();
 
@@ -365,41 +472,58 @@ IdTable CompressedRelationReader::scan(
 
   addIncompleteBlockIfExists(firstBlockResult);
 
-  // Insert the complete blocks from the middle in parallel
+  // Read and decompress the complete blocks from the middle in parallel. The
+  // position of each block in the `result` is known in advance, so each block
+  // is decompressed directly into its slice of the `result`. The worker
+  // threads also read the blocks concurrently (`File::read` with an offset
+  // uses `pread`, which is thread-safe), because cold scans of large
+  // relations are bound by the I/O as well as by the decompression.
   if (beginBlock < endBlock) {
-#pragma omp parallel
-#pragma omp single
-    for (; beginBlock < endBlock; ++beginBlock) {
-      const auto& block = *beginBlock;
-
-      // Read the block serially, only read the second column.
-      AD_CORRECTNESS_CHECK(block.offsetsAndCompressedSize_.size() >= 2);
-      CompressedBlock compressedBuffer =
-          readCompressedBlockFromFile(block, columnIndices);
-
-      // A lambda that owns the compressed block decompresses it to the
-      // correct position in the result. It may safely be run in parallel
-      auto decompressLambda = [rowIndexOfNextBlockStart, &block, &result,
-                               compressedBuffer =
-                                   std::move(compressedBuffer)]() mutable {
-        ad_utility::TimeBlockAndLog tbl{"Decompression a block"};
-
-        decompressBlockToExistingIdTable(compressedBuffer, block.numRows_,
-                                         result, rowIndexOfNextBlockStart);
-      };
-
-      // Register an OpenMP task that performs the decompression of this
-      // block in parallel
-#pragma omp task
-      {
-        if (!cancellationHandle->isCancelled()) {
-          decompressLambda();
+    const size_t numBlocks = static_cast<size_t>(endBlock - beginBlock);
+    std::vector<size_t> rowOffsets;
+    rowOffsets.reserve(numBlocks);
+    for (const auto& block : std::ranges::subrange{beginBlock, endBlock}) {
+      rowOffsets.push_back(rowIndexOfNextBlockStart);
+      rowIndexOfNextBlockStart += block.numRows_;
+    }
+    const size_t numThreads =
+        std::clamp(RuntimeParameters().get<"index-scan-num-threads">(),
+                   size_t{1}, numBlocks);
+    const size_t numPrefetchedBlocks =
+        RuntimeParameters().get<"index-scan-num-prefetched-blocks">();
+    prefetchBlocks(std::span{beginBlock, std::min(numPrefetchedBlocks,
+                                                  numBlocks)},
+                   columnIndices);
+    std::atomic<size_t> nextBlockIndex = 0;
+    auto* statistics = ad_utility::OperationStatistics::current();
+    ad_utility::runConcurrently(numThreads, [&](size_t) {
+      ad_utility::OperationStatistics::Scope statisticsScope{statistics};
+      for (size_t i = nextBlockIndex++; i < numBlocks; i = nextBlockIndex++) {
+        checkCancellation(cancellationHandle);
+        if (i + numPrefetchedBlocks < numBlocks) {
+          prefetchBlocks(std::span{beginBlock + i + numPrefetchedBlocks, 1},
+                         columnIndices);
+        }
+        const auto& block = beginBlock[i];
+        AD_CORRECTNESS_CHECK(block.offsetsAndCompressedSize_.size() >= 2);
+        metrics_.blocksRead_->increment();
+        ad_utility::OperationStatistics::addBlocksRead();
+        if (!getDecompressedBlockCache().isEnabled()) {
+          CompressedBlock compressedBuffer =
+              readCompressedBlockFromFile(block, columnIndices);
+          decompressBlockToExistingIdTable(compressedBuffer, block.numRows_,
+                                           result, rowOffsets[i]);
+          metrics_.decompressedBytes_->increment(
+              block.numRows_ * columnIndices.size() * sizeof(Id));
+          continue;
+        }
+        for (size_t col = 0; col < columnIndices.size(); ++col) {
+          auto column = readAndDecompressColumn(block, columnIndices[col]);
+          std::ranges::copy(column->getColumn(0),
+                            result.getColumn(col).begin() + rowOffsets[i]);
         }
       }
-
-      // update the pointers
-      rowIndexOfNextBlockStart += block.numRows_;
-    }  // end of parallel region
+    });
   }
   // Add the last block.
   addIncompleteBlockIfExists(lastBlockResult);
@@ -418,15 +542,7 @@ DecompressedBlock CompressedRelationReader::readPossiblyIncompleteBlock(
   std::ranges::copy(
       ad_utility::integerRange(blockMetadata.offsetsAndCompressedSize_.size()),
       std::back_inserter(allColumns));
-  // A block is uniquely identified by its start position in the file.
-  auto cacheKey = blockMetadata.offsetsAndCompressedSize_.at(0).offsetInFile_;
-  DecompressedBlock block = blockCache_
-                                .computeOnce(cacheKey,
-                                             [&]() {
-                                               return readAndDecompressBlock(
-                                                   blockMetadata, allColumns);
-                                             })
-                                ._resultPointer->clone();
+  DecompressedBlock block = readAndDecompressBlock(blockMetadata, allColumns);
   const auto& col1Column = block.getColumn(0);
 
   // Find the range in the blockMetadata, that belongs to the same relation
@@ -465,10 +581,11 @@ DecompressedBlock CompressedRelationReader::readPossiblyIncompleteBlock(
 // _____________________________________________________________________________
 size_t CompressedRelationReader::getResultSizeOfScan(
     const CompressedRelationMetadata& metadata, Id col1Id,
-    const vector<CompressedBlockMetadata>& blocks) const {
+    std::span<const CompressedBlockMetadata> blocks) const {
   // Get all the blocks  that possibly might contain our pair of col0Id and
   // col1Id
-  auto relevantBlocks = getBlocksFromMetadata(metadata, col1Id, blocks);
+  auto relevantBlocks = filterBlocksWithBloomFilters(
+      getBlocksFromMetadata(metadata, col1Id, blocks), col1Id);
   auto [beginBlock, endBlock] = getBeginAndEnd(relevantBlocks);
   std::array<ColumnIndex, 1> columnIndices{0u};
 
@@ -503,6 +620,37 @@ size_t CompressedRelationReader::getResultSizeOfScan(
   return numResults;
 }
 
+// _____________________________________________________________________________
+static std::optional<size_t> numDistinctFromMultiplicity(size_t numRows,
+                                                         float multiplicity) {
+  if (numRows == 0) {
+    return 0;
+  }
+  auto numDistinct = static_cast<size_t>(
+      std::llround(static_cast<double>(numRows) / multiplicity));
+  // Two different numbers of distinct elements below this bound lead to
+  // multiplicities that differ by more than the precision of a `float`, so a
+  // number that reproduces the stored multiplicity is the correct one.
+  constexpr size_t maxNumDistinct = size_t{1} << 22;
+  if (numDistinct == 0 || numDistinct > numRows ||
+      numDistinct >= maxNumDistinct ||
+      CompressedRelationWriter::computeMultiplicity(numRows, numDistinct) !=
+          multiplicity) {
+    return std::nullopt;
+  }
+  return numDistinct;
+}
+
+// _____________________________________________________________________________
+std::optional<size_t> CompressedRelationMetadata::getNumDistinctCol1() const {
+  return numDistinctFromMultiplicity(numRows_, multiplicityCol1_);
+}
+
+// _____________________________________________________________________________
+std::optional<size_t> CompressedRelationMetadata::getNumDistinctCol2() const {
+  return numDistinctFromMultiplicity(numRows_, multiplicityCol2_);
+}
+
 // _____________________________________________________________________________
 float CompressedRelationWriter::computeMultiplicity(
     size_t numElements, size_t numDistinctElements) {
@@ -529,13 +677,14 @@ void CompressedRelationWriter::writeBufferedRelationsToSingleBlock() {
       currentBlockFirstCol0_, currentBlockLastCol0_,
       std::make_shared<IdTable>(std::move(smallRelationsBuffer_).toDynamic()));
   smallRelationsBuffer_.clear();
-  smallRelationsBuffer_.reserve(2 * blocksize());
+  smallRelationsBuffer_.reserve(2 * smallRelationsBlocksize());
 }
 
 // _____________________________________________________________________________
 CompressedBlock CompressedRelationReader::readCompressedBlockFromFile(
     const CompressedBlockMetadata& blockMetaData,
     ColumnIndicesRef columnIndices) const {
+  ad_utility::QueryTrace::ScopedSpan traceSpan{"read block", "io"};
   CompressedBlock compressedBuffer;
   compressedBuffer.resize(columnIndices.size());
   // TODO<C++23> Use `std::views::zip`
@@ -543,15 +692,62 @@ CompressedBlock CompressedRelationReader::readCompressedBlockFromFile(
     const auto& offset =
         blockMetaData.offsetsAndCompressedSize_.at(columnIndices[i]);
     auto& currentCol = compressedBuffer[i];
-    currentCol.resize(offset.compressedSize_);
-    file_.read(currentCol.data(), offset.compressedSize_, offset.offsetInFile_);
+    currentCol.codec_ = offset.codec_;
+    currentCol.data_.resize(offset.compressedSize_);
+    QLEVER_PROBE(block_read_start, offset.offsetInFile_,
+                 offset.compressedSize_);
+    file_.read(currentCol.data_.data(), offset.compressedSize_,
+               offset.offsetInFile_);
+    recordRead(offset.offsetInFile_, offset.compressedSize_);
   }
   return compressedBuffer;
 }
 
+// _____________________________________________________________________________
+void CompressedRelationReader::recordRead(off_t offset, size_t size) const {
+  QLEVER_PROBE(block_read_end, offset, size);
+  ad_utility::OperationStatistics::addBytesRead(size);
+  if (readRecorder_->isActive_) {
+    readRecorder_->ranges_.wlock()->emplace_back(offset, size);
+  }
+}
+
+// _____________________________________________________________________________
+auto CompressedRelationReader::getRecordedReads() const
+    -> std::vector<FileRange> {
+  auto ranges = *readRecorder_->ranges_.rlock();
+  std::ranges::sort(ranges);
+  ranges.erase(std::ranges::unique(ranges).begin(), ranges.end());
+  return ranges;
+}
+
+// _____________________________________________________________________________
+void CompressedRelationReader::adviseWillNeed(
+    std::span<const FileRange> ranges) const {
+  for (const auto& [offset, size] : ranges) {
+    file_.adviseWillNeed(offset, size);
+  }
+}
+
+// _____________________________________________________________________________
+void CompressedRelationReader::prefetchBlocks(
+    std::span<const CompressedBlockMetadata> blocks,
+    ColumnIndicesRef columnIndices) const {
+  for (const auto& block : blocks) {
+    for (ColumnIndex column : columnIndices) {
+      const auto& offset = block.offsetsAndCompressedSize_.at(column);
+      file_.adviseWillNeed(offset.offsetInFile_, offset.compressedSize_);
+    }
+  }
+}
+
 // ____________________________________________________________________________
 DecompressedBlock CompressedRelationReader::decompressBlock(
     const CompressedBlock& compressedBlock, size_t numRowsToRead) const {
+  ad_utility::QueryTrace::ScopedSpan traceSpan{"decompress block",
+                                               "decompression"};
+  metrics_.decompressedBytes_->increment(numRowsToRead *
+                                         compressedBlock.size() * sizeof(Id));
   DecompressedBlock decompressedBlock{compressedBlock.size(), allocator_};
   decompressedBlock.resize(numRowsToRead);
   for (size_t i = 0; i < compressedBlock.size(); ++i) {
@@ -576,45 +772,171 @@ void CompressedRelationReader::decompressBlockToExistingIdTable(
 }
 
 // ____________________________________________________________________________
-template <typename Iterator>
 void CompressedRelationReader::decompressColumn(
-    const std::vector<char>& compressedBlock, size_t numRowsToRead,
-    Iterator iterator) {
-  auto numBytesActuallyRead = ZstdWrapper::decompressToBuffer(
-      compressedBlock.data(), compressedBlock.size(), iterator,
-      numRowsToRead * sizeof(*iterator));
-  static_assert(sizeof(Id) == sizeof(*iterator));
-  AD_CORRECTNESS_CHECK(numRowsToRead * sizeof(Id) == numBytesActuallyRead);
+    const CompressedColumn& compressedColumn, size_t numRowsToRead,
+    Id* target) {
+  ad_utility::OperationStatistics::DecompressionTimer timer;
+  QLEVER_PROBE(column_decompress_start, numRowsToRead);
+  columnCodec::decode(compressedColumn.codec_, compressedColumn.data_,
+                      std::span{target, numRowsToRead});
+  QLEVER_PROBE(column_decompress_end, numRowsToRead);
 }
 
 // _____________________________________________________________________________
 DecompressedBlock CompressedRelationReader::readAndDecompressBlock(
     const CompressedBlockMetadata& blockMetaData,
     ColumnIndicesRef columnIndices) const {
-  CompressedBlock compressedColumns =
-      readCompressedBlockFromFile(blockMetaData, columnIndices);
-  const auto numRowsToRead = blockMetaData.numRows_;
-  return decompressBlock(compressedColumns, numRowsToRead);
+  metrics_.blocksRead_->increment();
+  ad_utility::OperationStatistics::addBlocksRead();
+  if (!getDecompressedBlockCache().isEnabled()) {
+    CompressedBlock compressedColumns =
+        readCompressedBlockFromFile(blockMetaData, columnIndices);
+    const auto numRowsToRead = blockMetaData.numRows_;
+    return decompressBlock(compressedColumns, numRowsToRead);
+  }
+  DecompressedBlock result{columnIndices.size(), allocator_};
+  result.resize(blockMetaData.numRows_);
+  for (size_t i = 0; i < columnIndices.size(); ++i) {
+    auto column = readAndDecompressColumn(blockMetaData, columnIndices[i]);
+    std::ranges::copy(column->getColumn(0), result.getColumn(i).begin());
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+std::shared_ptr<const DecompressedBlock>
+CompressedRelationReader::readAndDecompressColumn(
+    const CompressedBlockMetadata& blockMetaData,
+    ColumnIndex columnIndex) const {
+  const auto& offset = blockMetaData.offsetsAndCompressedSize_.at(columnIndex);
+  auto computeColumn = [&]() {
+    CompressedColumn compressedColumn{
+        std::vector<char>(offset.compressedSize_), offset.codec_};
+    {
+      ad_utility::QueryTrace::ScopedSpan traceSpan{"read column", "io"};
+      QLEVER_PROBE(block_read_start, offset.offsetInFile_,
+                   offset.compressedSize_);
+      file_.read(compressedColumn.data_.data(), offset.compressedSize_,
+                 offset.offsetInFile_);
+      recordRead(offset.offsetInFile_, offset.compressedSize_);
+    }
+    ad_utility::QueryTrace::ScopedSpan traceSpan{"decompress column",
+                                                 "decompression"};
+    metrics_.decompressedBytes_->increment(blockMetaData.numRows_ * sizeof(Id));
+    DecompressedBlock column{1, allocator_};
+    column.resize(blockMetaData.numRows_);
+    decompressColumn(compressedColumn, blockMetaData.numRows_,
+                     column.getColumn(0).data());
+    return column;
+  };
+  return getDecompressedBlockCache().getOrCompute(
+      {readerId_, offset.offsetInFile_}, computeColumn);
+}
+
+// _____________________________________________________________________________
+std::shared_ptr<const DecompressedBlock>
+CompressedRelationReader::readBloomFilter(
+    const CompressedBlockMetadata& blockMetadata) const {
+  const auto& [offsetInFile, numIds] = blockMetadata.bloomFilter_;
+  AD_CONTRACT_CHECK(numIds > 0);
+  auto computeFilter = [&]() {
+    DecompressedBlock filter{1, allocator_};
+    filter.resize(numIds);
+    QLEVER_PROBE(block_read_start, offsetInFile, numIds * sizeof(Id));
+    file_.read(filter.getColumn(0).data(), numIds * sizeof(Id), offsetInFile);
+    recordRead(offsetInFile, numIds * sizeof(Id));
+    return filter;
+  };
+  // The offset of the filter in the file is different from the offsets of all
+  // the columns, so it can share the cache with them.
+  return getDecompressedBlockCache().getOrCompute({readerId_, offsetInFile},
+                                                  computeFilter);
+}
+
+// _____________________________________________________________________________
+std::span<const CompressedBlockMetadata>
+CompressedRelationReader::filterBlocksWithBloomFilters(
+    std::span<const CompressedBlockMetadata> blocks,
+    std::optional<Id> col1Id) const {
+  if (!col1Id.has_value()) {
+    return blocks;
+  }
+  size_t numBlocksBefore = blocks.size();
+  auto cannotContainCol1 = [this, &col1Id](const CompressedBlockMetadata& b) {
+    return b.bloomFilter_.numIds_ > 0 &&
+           !blockBloomFilter::mightContain(readBloomFilter(b)->getColumn(0),
+                                           col1Id.value());
+  };
+  while (!blocks.empty() && cannotContainCol1(blocks.front())) {
+    blocks = blocks.subspan(1);
+  }
+  while (!blocks.empty() && cannotContainCol1(blocks.back())) {
+    blocks = blocks.first(blocks.size() - 1);
+  }
+  metrics_.blocksSkipped_->increment(numBlocksBefore - blocks.size());
+  ad_utility::OperationStatistics::addBlocksSkipped(numBlocksBefore -
+                                                    blocks.size());
+  return blocks;
+}
+
+// _____________________________________________________________________________
+auto CompressedRelationReader::makeMetrics(const std::string& permutationName)
+    -> Metrics {
+  auto& registry = ad_utility::metrics::registry();
+  ad_utility::metrics::Labels labels{{"permutation", permutationName}};
+  auto labelsWithStatus = [&labels](std::string status) {
+    auto result = labels;
+    result.emplace_back("status", std::move(status));
+    return result;
+  };
+  static constexpr std::string_view blocksHelp =
+      "The number of blocks of the index scans that were read or skipped "
+      "(because of the Bloom filters or the blocks of the other side of a "
+      "join).";
+  return {&registry.counter("qlever_decompressed_bytes_total",
+                            "The number of bytes of the index that were "
+                            "decompressed.",
+                            labels),
+          &registry.counter("qlever_index_scan_blocks_total", blocksHelp,
+                            labelsWithStatus("read")),
+          &registry.counter("qlever_index_scan_blocks_total", blocksHelp,
+                            labelsWithStatus("skipped"))};
+}
+
+// _____________________________________________________________________________
+size_t CompressedRelationReader::getNextReaderId() {
+  static std::atomic<size_t> nextReaderId = 0;
+  return nextReaderId++;
 }
 
 // _____________________________________________________________________________
 CompressedBlockMetadata::OffsetAndCompressedSize
 CompressedRelationWriter::compressAndWriteColumn(std::span<const Id> column) {
-  std::vector<char> compressedBlock = ZstdWrapper::compress(
-      (void*)(column.data()), column.size() * sizeof(column[0]));
+  auto [codec, compressedBlock] = columnCodec::encodeWithBestCodec(column);
   auto compressedSize = compressedBlock.size();
   auto file = outfile_.wlock();
   auto offsetInFile = file->tell();
   file->write(compressedBlock.data(), compressedBlock.size());
-  return {offsetInFile, compressedSize};
+  return {offsetInFile, compressedSize, codec};
 };
 
+// _____________________________________________________________________________
+CompressedBlockMetadata::BloomFilterLocation
+CompressedRelationWriter::writeBloomFilter(const IdTable& block) {
+  auto filter = blockBloomFilter::build(block.getColumn(0), block.getColumn(1),
+                                        bloomFilterBitsPerKey_);
+  auto file = outfile_.wlock();
+  auto offsetInFile = file->tell();
+  file->write(filter.data(), filter.size() * sizeof(Id));
+  return {offsetInFile, filter.size()};
+}
+
 // _____________________________________________________________________________
 void CompressedRelationWriter::compressAndWriteBlock(
     Id firstCol0Id, Id lastCol0Id, std::shared_ptr<IdTable> block) {
   blockWriteQueue_.push(
       [this, buf = std::move(block), firstCol0Id, lastCol0Id]() {
-        std::vector<CompressedBlockMetadata::OffsetAndCompressedSize> offsets;
+        CompressedBlockMetadata::OffsetsAndCompressedSizes offsets;
         for (const auto& column : buf->getColumns()) {
           offsets.push_back(compressAndWriteColumn(column));
         }
@@ -622,12 +944,17 @@ void CompressedRelationWriter::compressAndWriteBlock(
         auto numRows = buf->numRows();
         const auto& first = (*buf)[0];
         const auto& last = (*buf)[buf->numRows() - 1];
+        CompressedBlockMetadata::BloomFilterLocation bloomFilter;
+        if (bloomFilterBitsPerKey_ > 0) {
+          bloomFilter = writeBloomFilter(*buf);
+        }
 
         blockBuffer_.wlock()->push_back(
-            CompressedBlockMetadata{std::move(offsets),
+            CompressedBlockMetadata{offsets,
                                     numRows,
                                     {firstCol0Id, first[0], first[1]},
-                                    {lastCol0Id, last[0], last[1]}});
+                                    {lastCol0Id, last[0], last[1]},
+                                    bloomFilter});
       });
 }
 
@@ -749,10 +1076,11 @@ CompressedRelationMetadata CompressedRelationWriter::addSmallRelation(
   size_t numRows = relation.numRows();
   // Make sure that the blocks don't become too large: If the previously
   // buffered small relations together with the new relations would exceed `1.5
-  // * blocksize` then we start a new block for the current relation. Note:
-  // there are some unit tests that rely on this factor being `1.5`.
+  // * smallRelationsBlocksize` then we start a new block for the current
+  // relation. Note: there are some unit tests that rely on this factor being
+  // `1.5`.
   if (static_cast<double>(numRows + smallRelationsBuffer_.numRows()) >
-      static_cast<double>(blocksize()) * 1.5) {
+      static_cast<double>(smallRelationsBlocksize()) * 1.5) {
     writeBufferedRelationsToSingleBlock();
   }
   auto offsetInBlock = smallRelationsBuffer_.size();
@@ -879,6 +1207,37 @@ class DistinctIdCounter {
     return count;
   }
 };
+
+// Yield the rows of the `blocks` in blocks with the given numbers of rows (the
+// `blocksizes`, the sum of which must be the total number of rows).
+cppcoro::generator<IdTableStatic<0>> splitIntoBlocks(
+    cppcoro::generator<IdTableStatic<0>> blocks, std::vector<size_t> blocksizes,
+    size_t numColumns) {
+  auto alloc = ad_utility::makeUnlimitedAllocator<Id>();
+  auto blocksize = blocksizes.begin();
+  IdTableStatic<0> result{numColumns, alloc};
+  for (auto& block : blocks) {
+    size_t i = 0;
+    while (i < block.numRows()) {
+      AD_CORRECTNESS_CHECK(blocksize != blocksizes.end());
+      size_t numRows =
+          std::min(block.numRows() - i, *blocksize - result.numRows());
+      size_t oldSize = result.numRows();
+      result.resize(oldSize + numRows);
+      for (size_t col = 0; col < numColumns; ++col) {
+        std::ranges::copy(block.getColumn(col).subspan(i, numRows),
+                          result.getColumn(col).begin() + oldSize);
+      }
+      i += numRows;
+      if (result.numRows() == *blocksize) {
+        co_yield result;
+        result = IdTableStatic<0>{numColumns, alloc};
+        ++blocksize;
+      }
+    }
+  }
+  AD_CORRECTNESS_CHECK(result.empty() && blocksize == blocksizes.end());
+}
 }  // namespace
 
 // __________________________________________________________________________
@@ -932,6 +1291,11 @@ CompressedRelationWriter::createPermutationPair(
   // TODO<joka921> Use call_fixed_size if there is benefit to it.
   IdTableStatic<0> relation{numColumns, alloc};
   size_t numBlocksCurrentRel = 0;
+  // The blocks of a large relation grow with its size (see
+  // `blocksizeOfLargeRelation`). The blocks of the twin relation get the same
+  // sizes, s.t. both permutations have the same number of blocks.
+  size_t blocksizeCurrentRel = blocksize;
+  std::vector<size_t> blocksizesCurrentRel;
   auto compare = [](const auto& a, const auto& b) {
     return std::tie(a[0], a[1]) < std::tie(b[0], b[1]);
   };
@@ -943,7 +1307,8 @@ CompressedRelationWriter::createPermutationPair(
   DistinctIdCounter distinctCol1Counter;
   auto addBlockForLargeRelation = [&numBlocksCurrentRel, &writer1,
                                    &col0IdCurrentRelation, &relation,
-                                   &twinRelationSorter, &blocksize] {
+                                   &twinRelationSorter, &blocksizeCurrentRel,
+                                   &blocksizesCurrentRel] {
     if (relation.empty()) {
       return;
     }
@@ -952,11 +1317,14 @@ CompressedRelationWriter::createPermutationPair(
     for (const auto& row : twinRelation) {
       twinRelationSorter.push(row);
     }
+    blocksizesCurrentRel.push_back(relation.numRows());
     writer1.addBlockForLargeRelation(
         col0IdCurrentRelation.value(),
         std::make_shared<IdTable>(std::move(relation).toDynamic()));
+    blocksizeCurrentRel =
+        writer1.blocksizeOfLargeRelation(writer1.currentRelationPreviousSize_);
     relation.clear();
-    relation.reserve(blocksize);
+    relation.reserve(blocksizeCurrentRel);
     ++numBlocksCurrentRel;
   };
 
@@ -964,7 +1332,9 @@ CompressedRelationWriter::createPermutationPair(
                          &numBlocksCurrentRel, &col0IdCurrentRelation,
                          &relation, &distinctCol1Counter,
                          &addBlockForLargeRelation, &compare, &blocksize,
-                         &writeMetadata, &largeTwinRelationTimer]() {
+                         &blocksizeCurrentRel, &blocksizesCurrentRel,
+                         &numColumns, &writeMetadata,
+                         &largeTwinRelationTimer]() {
     if (numBlocksCurrentRel > 0 || static_cast<double>(relation.numRows()) >
                                        0.8 * static_cast<double>(blocksize)) {
       // The relation is large;
@@ -973,9 +1343,11 @@ CompressedRelationWriter::createPermutationPair(
       largeTwinRelationTimer.cont();
       auto md2 = writer2.addCompleteLargeRelation(
           col0IdCurrentRelation.value(),
-          twinRelationSorter.getSortedBlocks(blocksize));
+          splitIntoBlocks(twinRelationSorter.getSortedBlocks(),
+                          std::move(blocksizesCurrentRel), numColumns));
       largeTwinRelationTimer.stop();
       twinRelationSorter.clear();
+      blocksizesCurrentRel.clear();
       writeMetadata(md1, md2);
     } else {
       // Small relations are written in one go.
@@ -995,6 +1367,7 @@ CompressedRelationWriter::createPermutationPair(
     }
     relation.clear();
     numBlocksCurrentRel = 0;
+    blocksizeCurrentRel = blocksize;
   };
   size_t i = 0;
   // All columns but the `col0` in the order in which they have to be added to
@@ -1026,7 +1399,7 @@ CompressedRelationWriter::createPermutationPair(
       }
       distinctCol1Counter(curRemainingCols[0]);
       relation.push_back(curRemainingCols);
-      if (relation.size() >= blocksize) {
+      if (relation.size() >= blocksizeCurrentRel) {
         addBlockForLargeRelation();
       }
       ++i;
@@ -6,22 +6,31 @@
 #define QLEVER_COMPRESSEDRELATION_H
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
 #include <vector>
 
 #include "engine/idTable/CompressedExternalIdTable.h"
 #include "engine/idTable/IdTable.h"
 #include "global/Id.h"
+#include "global/ValueIdComparators.h"
+#include "index/ColumnCodec.h"
 #include "index/ConstantsIndexBuilding.h"
+#include "index/DecompressedBlockCache.h"
 #include "util/Cache.h"
 #include "util/CancellationHandle.h"
 #include "util/ConcurrentCache.h"
 #include "util/File.h"
+#include "util/FixedCapacityVector.h"
 #include "util/Generator.h"
 #include "util/MemorySize/MemorySize.h"
+#include "util/Metrics.h"
 #include "util/Serializer/ByteBufferSerializer.h"
 #include "util/Serializer/SerializeArray.h"
 #include "util/Serializer/SerializeVector.h"
 #include "util/Serializer/Serializer.h"
+#include "util/Synchronized.h"
 #include "util/TaskQueue.h"
 #include "util/TypeTraits.h"
 
@@ -32,22 +41,16 @@ class IdTable;
 // block.
 using SmallRelationsBuffer = IdTable;
 
-// Sometimes we do not read/decompress  all the columns of a block, so we have
-// to use a dynamic `IdTable`.
-using DecompressedBlock = IdTable;
-
-// To be able to use `DecompressedBlock` with `Caches`, we need a function for
-// calculating the memory used for it.
-struct DecompressedBlockSizeGetter {
-  ad_utility::MemorySize operator()(const DecompressedBlock& block) const {
-    return ad_utility::MemorySize::bytes(block.numColumns() * block.numRows() *
-                                         sizeof(Id));
-  }
+// A single compressed column of a block together with the codec that was used
+// to compress it.
+struct CompressedColumn {
+  std::vector<char> data_;
+  ColumnCodec codec_ = ColumnCodec::Zstd;
 };
 
 // After compression the columns have different sizes, so we cannot use an
 // `IdTable`.
-using CompressedBlock = std::vector<std::vector<char>>;
+using CompressedBlock = std::vector<CompressedColumn>;
 
 // The metadata of a compressed block of ID triples in an index permutation.
 struct CompressedBlockMetadata {
@@ -56,9 +59,20 @@ struct CompressedBlockMetadata {
   struct OffsetAndCompressedSize {
     off_t offsetInFile_;
     size_t compressedSize_;
+    // The codec that was used to compress the column. The index builder
+    // chooses the best codec for each column of each block.
+    ColumnCodec codec_ = ColumnCodec::Zstd;
     bool operator==(const OffsetAndCompressedSize&) const = default;
   };
-  std::vector<OffsetAndCompressedSize> offsetsAndCompressedSize_;
+  // The maximal number of columns of a block (the col1 and col2 and the
+  // additional columns that are stored in the permutations).
+  static constexpr size_t MAX_NUM_COLUMNS = 6;
+  // Note: The capacity is fixed, s.t. the `CompressedBlockMetadata` is
+  // trivially copyable and can be stored in an `MmapVector`, from which it is
+  // read on demand when the index is loaded.
+  using OffsetsAndCompressedSizes =
+      ad_utility::FixedCapacityVector<OffsetAndCompressedSize, MAX_NUM_COLUMNS>;
+  OffsetsAndCompressedSizes offsetsAndCompressedSize_;
   size_t numRows_;
 
   // Store the first and the last triple of the block. First and last are meant
@@ -94,22 +108,30 @@ struct CompressedBlockMetadata {
   PermutedTriple firstTriple_;
   PermutedTriple lastTriple_;
 
+  // The location of the Bloom filter of the block in the file of the
+  // permutation (see `BlockBloomFilter.h`). It is stored as `numIds_` many
+  // (uncompressed) `Id`s, which is zero if the block has no Bloom filter.
+  struct BloomFilterLocation {
+    off_t offsetInFile_ = 0;
+    size_t numIds_ = 0;
+    bool operator==(const BloomFilterLocation&) const = default;
+  };
+  BloomFilterLocation bloomFilter_;
+
   // Two of these are equal if all members are equal.
   bool operator==(const CompressedBlockMetadata&) const = default;
+
+  // The metadata of the blocks is serialized by copying its bytes.
+  friend std::true_type allowTrivialSerialization(CompressedBlockMetadata,
+                                                  auto);
 };
+static_assert(std::is_trivially_copyable_v<CompressedBlockMetadata>);
 
 // Serialization of the `OffsetAndcompressedSize` subclass.
 AD_SERIALIZE_FUNCTION(CompressedBlockMetadata::OffsetAndCompressedSize) {
   serializer | arg.offsetInFile_;
   serializer | arg.compressedSize_;
-}
-
-// Serialization of the block metadata.
-AD_SERIALIZE_FUNCTION(CompressedBlockMetadata) {
-  serializer | arg.offsetsAndCompressedSize_;
-  serializer | arg.numRows_;
-  serializer | arg.firstTriple_;
-  serializer | arg.lastTriple_;
+  serializer | arg.codec_;
 }
 
 // The metadata of a whole compressed "relation", where relation refers to a
@@ -138,6 +160,14 @@ struct CompressedRelationMetadata {
 
   bool isFunctional() const { return multiplicityCol1_ == 1.0f; }
 
+  // The exact number of distinct elements in col1 (col2), which is
+  // reconstructed from the number of rows and the multiplicity. Return
+  // `std::nullopt` if the `float` multiplicity is too imprecise to determine
+  // the number unambiguously (this can only happen for several millions of
+  // distinct elements).
+  std::optional<size_t> getNumDistinctCol1() const;
+  std::optional<size_t> getNumDistinctCol2() const;
+
   // Two of these are equal if all members are equal.
   bool operator==(const CompressedRelationMetadata&) const = default;
 };
@@ -166,11 +196,21 @@ class CompressedRelationWriter {
   // are no additional special payloads.
   size_t numColumns_;
 
+  // The number of bits per key of the Bloom filters of the blocks (see
+  // `BlockBloomFilter.h`). If zero, no Bloom filters are written.
+  size_t bloomFilterBitsPerKey_;
+
   ad_utility::AllocatorWithLimit<Id> allocator_ =
       ad_utility::makeUnlimitedAllocator<Id>();
   // A buffer for small relations that will be stored in the same block.
   SmallRelationsBuffer smallRelationsBuffer_{numColumns_, allocator_};
   ad_utility::MemorySize uncompressedBlocksizePerColumn_;
+  // The (smaller) uncompressed size of the blocks that are shared by several
+  // small relations, see `smallRelationsBlocksize()`.
+  ad_utility::MemorySize smallRelationsBlocksizePerColumn_;
+  // The (larger) maximal uncompressed size of the blocks of large relations,
+  // see `blocksizeOfLargeRelation()`.
+  ad_utility::MemorySize largeRelationsBlocksizePerColumn_;
 
   // When we store a large relation with multiple blocks then we keep track of
   // its `col0Id`, mostly for sanity checks.
@@ -182,14 +222,32 @@ class CompressedRelationWriter {
   // A dummy value for multiplicities that can only later be determined.
   static constexpr float multiplicityDummy = 42.4242f;
 
+  // The blocks of a large relation only become larger than the `blocksize()`
+  // when the relation has at least that many blocks.
+  static constexpr size_t MIN_NUM_BLOCKS_LARGE_RELATION = 64;
+
  public:
-  /// Create using a filename, to which the relation data will be written.
+  /// Create using a filename, to which the relation data will be written. If
+  /// `bloomFilterBitsPerKey` is positive, a Bloom filter with that many bits
+  /// per key is written for each block. The blocks that consist of several
+  /// small relations are limited by `smallRelationsBlocksizePerColumn` (if it
+  /// is smaller than `uncompressedBlocksizePerColumn`). The blocks of large
+  /// relations grow up to `largeRelationsBlocksizePerColumn` (if it is larger
+  /// than `uncompressedBlocksizePerColumn`) with the size of the relation.
   explicit CompressedRelationWriter(
       size_t numColumns, ad_utility::File f,
-      ad_utility::MemorySize uncompressedBlocksizePerColumn)
+      ad_utility::MemorySize uncompressedBlocksizePerColumn,
+      size_t bloomFilterBitsPerKey = 0,
+      ad_utility::MemorySize smallRelationsBlocksizePerColumn =
+          ad_utility::MemorySize::max(),
+      ad_utility::MemorySize largeRelationsBlocksizePerColumn =
+          ad_utility::MemorySize::bytes(0))
       : outfile_{std::move(f)},
         numColumns_{numColumns},
-        uncompressedBlocksizePerColumn_{uncompressedBlocksizePerColumn} {}
+        bloomFilterBitsPerKey_{bloomFilterBitsPerKey},
+        uncompressedBlocksizePerColumn_{uncompressedBlocksizePerColumn},
+        smallRelationsBlocksizePerColumn_{smallRelationsBlocksizePerColumn},
+        largeRelationsBlocksizePerColumn_{largeRelationsBlocksizePerColumn} {}
   // Two helper types used to make the interface of the function
   // `createPermutationPair` below safer and more explicit.
   using MetadataCallback =
@@ -254,6 +312,35 @@ class CompressedRelationWriter {
     return uncompressedBlocksizePerColumn_.getBytes() / sizeof(Id);
   }
 
+  // Return the blocksize (in number of triples) of the blocks that are shared
+  // by several small relations. A scan of a small relation has to read and
+  // decompress its complete block, so small blocks make the very frequent
+  // scans of a single subject or object cheap. A single small relation that is
+  // larger than this blocksize gets a block of its own.
+  size_t smallRelationsBlocksize() const {
+    return std::min(blocksize(),
+                    smallRelationsBlocksizePerColumn_.getBytes() / sizeof(Id));
+  }
+
+  // Return the maximal blocksize (in number of triples) of the blocks of a
+  // large relation.
+  size_t largeRelationsBlocksize() const {
+    return std::max(blocksize(),
+                    largeRelationsBlocksizePerColumn_.getBytes() / sizeof(Id));
+  }
+
+  // Return the blocksize (in number of triples) of the next block of a large
+  // relation of which `numRows` rows are known. The blocks grow with the size
+  // of the relation: A relation has at least `MIN_NUM_BLOCKS_LARGE_RELATION`
+  // blocks of the `blocksize()`, s.t. the blocks of scans with a small range
+  // and of joins can be pruned, but the (mostly sequential) scans of huge
+  // relations need fewer blocks (of at most `largeRelationsBlocksize()`
+  // triples) and less metadata.
+  size_t blocksizeOfLargeRelation(size_t numRows) const {
+    return std::clamp(numRows / MIN_NUM_BLOCKS_LARGE_RELATION, blocksize(),
+                      largeRelationsBlocksize());
+  }
+
  private:
   /// Finish writing all relations which have previously been added, but might
   /// still be in some internal buffer.
@@ -274,6 +361,11 @@ class CompressedRelationWriter {
   CompressedBlockMetadata::OffsetAndCompressedSize compressAndWriteColumn(
       std::span<const Id> column);
 
+  // Build the Bloom filter for the `block` and write it to the `outfile_`.
+  // Return its location in the `outfile_`.
+  CompressedBlockMetadata::BloomFilterLocation writeBloomFilter(
+      const IdTable& block);
+
   // Return the number of columns that is stored inside the blocks.
   size_t numColumns() const { return numColumns_; }
 
@@ -315,9 +407,10 @@ class CompressedRelationWriter {
 
   // This is the function in `CompressedRelationsTest.cpp` that tests the
   // internals of this class and therefore needs private access.
-  friend void testCompressedRelations(const auto& inputs,
-                                      std::string testCaseName,
-                                      ad_utility::MemorySize blocksize);
+  friend void testCompressedRelations(
+      const auto& inputs, std::string testCaseName,
+      ad_utility::MemorySize blocksize, size_t bloomFilterBitsPerKey,
+      ad_utility::MemorySize smallRelationsBlocksize);
 };
 
 using namespace std::string_view_literals;
@@ -359,20 +452,22 @@ class CompressedRelationReader {
     size_t numBlocksAll_ = 0;
     size_t numElementsRead_ = 0;
     std::chrono::milliseconds blockingTime_ = std::chrono::milliseconds::zero();
+    // The largest number of threads and of blocks that were read ahead (see
+    // `LazyScanPrefetchController`).
+    size_t maxNumThreads_ = 0;
+    size_t maxPrefetchDepth_ = 0;
   };
 
   using IdTableGenerator = cppcoro::generator<IdTable, LazyScanMetadata>;
 
+  // A range of bytes in the file of the permutation, given by its offset and
+  // its size.
+  using FileRange = std::pair<off_t, size_t>;
+
  private:
-  // This cache stores a small number of decompressed blocks. Its current
-  // purpose is to make the e2e-tests run fast. They contain many SPARQL queries
-  // with ?s ?p ?o triples in the body.
-  // Note: The cache is thread-safe and using it does not change the semantics
-  // of this class, so it is safe to mark it as `mutable` to make the `scan`
-  // functions below `const`.
-  mutable ad_utility::ConcurrentCache<ad_utility::HeapBasedLRUCache<
-      off_t, DecompressedBlock, DecompressedBlockSizeGetter>>
-      blockCache_{20ul};
+  // Identifies this reader in the `DecompressedBlockCache` that is shared by
+  // all readers (see `readAndDecompressBlock`).
+  size_t readerId_ = getNextReaderId();
 
   // The allocator used to allocate intermediate buffers.
   mutable Allocator allocator_;
@@ -380,9 +475,34 @@ class CompressedRelationReader {
   // The file that stores the actual permutations.
   ad_utility::File file_;
 
+  // The counters of the `/metrics` endpoint, which are labeled with the name
+  // of the permutation of this reader.
+  struct Metrics {
+    ad_utility::metrics::Counter* decompressedBytes_;
+    ad_utility::metrics::Counter* blocksRead_;
+    ad_utility::metrics::Counter* blocksSkipped_;
+  };
+  Metrics metrics_;
+  static Metrics makeMetrics(const std::string& permutationName);
+
+  // The ranges of the `file_` that were read while the recording is active
+  // (see `setRecordReads`).
+  struct ReadRecorder {
+    std::atomic<bool> isActive_ = false;
+    ad_utility::Synchronized<std::vector<FileRange>> ranges_;
+  };
+  std::unique_ptr<ReadRecorder> readRecorder_ =
+      std::make_unique<ReadRecorder>();
+  // Record a read of the `file_` (if the recording is active) and count its
+  // bytes in the `OperationStatistics` of the current operation.
+  void recordRead(off_t offset, size_t size) const;
+
  public:
-  explicit CompressedRelationReader(Allocator allocator, ad_utility::File file)
-      : allocator_{std::move(allocator)}, file_{std::move(file)} {}
+  explicit CompressedRelationReader(Allocator allocator, ad_utility::File file,
+                                    const std::string& permutationName = "")
+      : allocator_{std::move(allocator)},
+        file_{std::move(file)},
+        metrics_{makeMetrics(permutationName)} {}
 
   // Get the blocks (an ordered subset of the blocks that are passed in via the
   // `metadataAndBlocks`) where the `col1Id` can theoretically match one of the
@@ -439,6 +559,24 @@ class CompressedRelationReader {
       ColumnIndices additionalColumns,
       ad_utility::SharedCancellationHandle cancellationHandle) const;
 
+  // Get the blocks (an ordered subset of the blocks that are passed in via the
+  // `metadataAndBlocks`) that might contain a row for which the first column
+  // that is not fixed by the `metadataAndBlocks` (col1 if the
+  // `metadataAndBlocks` don't contain a `col1Id`, else col2) fulfills
+  // `column <comparison> constant`. The blocks are filtered via the values of
+  // this column in the first and last triple of each block, which works
+  // because this column is sorted within the scanned relation.
+  static std::vector<CompressedBlockMetadata> getBlocksForFilter(
+      const MetadataAndBlocks& metadataAndBlocks,
+      valueIdComparators::Comparison comparison, Id constant);
+
+  // Similar to `getBlocksForFilter`, but get the blocks that might contain a
+  // row for which this column is contained in at least one of the `ranges`
+  // (each of which is a pair of the first and the last `Id`, both inclusive).
+  static std::vector<CompressedBlockMetadata> getBlocksForIdRanges(
+      const MetadataAndBlocks& metadataAndBlocks,
+      std::span<const std::pair<Id, Id>> ranges);
+
   // Only get the size of the result for a given permutation XYZ for a given X
   // and Y. This can be done by scanning one or two blocks. Note: The overload
   // of this function where only the X is given is not needed, as the size of
@@ -446,7 +584,7 @@ class CompressedRelationReader {
   // directly.
   size_t getResultSizeOfScan(
       const CompressedRelationMetadata& metaData, Id col1Id,
-      const vector<CompressedBlockMetadata>& blocks) const;
+      std::span<const CompressedBlockMetadata> blocks) const;
 
   // Get the contiguous subrange of the given `blockMetadata` for the blocks
   // that contain the triples that have the relationId/col0Id that was specified
@@ -472,6 +610,21 @@ class CompressedRelationReader {
   // Get access to the underlying allocator
   const Allocator& allocator() const { return allocator_; }
 
+  // Start or stop recording the ranges of the file that are read. This is used
+  // by the cache warm-up to find out which parts of the file are needed by the
+  // warm-up queries (see `CacheWarmup.h`).
+  void setRecordReads(bool recordReads) const {
+    readRecorder_->isActive_ = recordReads;
+  }
+
+  // Return the ranges that were recorded so far, sorted and without
+  // duplicates.
+  std::vector<FileRange> getRecordedReads() const;
+
+  // Announce to the operating system that the `ranges` of the file will be
+  // read soon (see `File::adviseWillNeed`).
+  void adviseWillNeed(std::span<const FileRange> ranges) const;
+
  private:
   // Read the block that is identified by the `blockMetaData` from the `file`.
   // Only the columns specified by `columnIndices` are read.
@@ -479,6 +632,40 @@ class CompressedRelationReader {
       const CompressedBlockMetadata& blockMetaData,
       ColumnIndicesRef columnIndices) const;
 
+  // Return the column with the index `columnIndex` of the block that is
+  // identified by the `blockMetaData` as a `DecompressedBlock` with a single
+  // column. The column is looked up in or inserted into the
+  // `DecompressedBlockCache`.
+  std::shared_ptr<const DecompressedBlock> readAndDecompressColumn(
+      const CompressedBlockMetadata& blockMetaData,
+      ColumnIndex columnIndex) const;
+
+  // Return a unique ID for each reader (used by the constructor).
+  static size_t getNextReaderId();
+
+  // Return the Bloom filter of the `blockMetadata` (see `BlockBloomFilter.h`),
+  // which must have one. Like the decompressed columns, it is looked up in or
+  // inserted into the `DecompressedBlockCache`.
+  std::shared_ptr<const DecompressedBlock> readBloomFilter(
+      const CompressedBlockMetadata& blockMetadata) const;
+
+  // Remove the blocks from the front and the back of the `blocks` (the result
+  // of `getBlocksFromMetadata`) for which the Bloom filter shows that they
+  // don't contain the `col1Id` (the blocks in between contain only triples
+  // with the `col1Id` if the `blocks` are contiguous). Without a `col1Id`, the
+  // `blocks` are returned unchanged. This makes the lookups that find nothing
+  // cheap, because no block has to be read and decompressed.
+  std::span<const CompressedBlockMetadata> filterBlocksWithBloomFilters(
+      std::span<const CompressedBlockMetadata> blocks,
+      std::optional<Id> col1Id) const;
+
+  // Announce to the operating system that the columns with the `columnIndices`
+  // of the `blocks` will be read soon (see `File::adviseWillNeed`). This is
+  // used to prefetch the next `index-scan-num-prefetched-blocks` blocks while
+  // the current blocks are read and decompressed.
+  void prefetchBlocks(std::span<const CompressedBlockMetadata> blocks,
+                      ColumnIndicesRef columnIndices) const;
+
   // Decompress the `compressedBlock`. The number of rows that the block will
   // have after decompression must be passed in via the `numRowsToRead`
   // argument. It is typically obtained from the corresponding
@@ -496,15 +683,16 @@ class CompressedRelationReader {
 
   // Helper function used by `decompressBlock` and
   // `decompressBlockToExistingIdTable`. Decompress the `compressedColumn` and
-  // store the result at the `iterator`. For the `numRowsToRead` argument, see
+  // store the result at the `target`. For the `numRowsToRead` argument, see
   // the documentation of `decompressBlock`.
-  template <typename Iterator>
-  static void decompressColumn(const std::vector<char>& compressedColumn,
-                               size_t numRowsToRead, Iterator iterator);
+  static void decompressColumn(const CompressedColumn& compressedColumn,
+                               size_t numRowsToRead, Id* target);
 
   // Read the block that is identified by the `blockMetaData` from the `file`,
   // decompress and return it. Only the columns specified by the `columnIndices`
-  // are returned.
+  // are returned. The decompressed columns are taken from or inserted into the
+  // `DecompressedBlockCache`, s.t. the hot blocks are decompressed only once
+  // across all queries.
   DecompressedBlock readAndDecompressBlock(
       const CompressedBlockMetadata& blockMetaData,
       ColumnIndicesRef columnIndices) const;
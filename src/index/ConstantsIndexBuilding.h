@@ -21,6 +21,21 @@ static const size_t MAX_INTERNAL_LITERAL_BYTES = 1'000'000;
 // Reduce to save RAM
 static const int NUM_TRIPLES_PER_PARTIAL_VOCAB = 10'000'000;
 
+// The index is built in memory if the (estimated uncompressed) size of the
+// input times this factor fits into the memory limit of the index building.
+// The factor covers the vocabulary, the triples, and the sorters of the
+// permutations (see `IndexImpl::createVocabularyAndPermutations`).
+constexpr size_t MEMORY_PER_INPUT_BYTE_IN_MEMORY_INDEX_BUILD = 4;
+
+// A lower bound for the number of bytes of a triple in the input, which is used
+// to estimate the maximal number of triples of an index that is built in
+// memory.
+constexpr size_t MIN_INPUT_BYTES_PER_TRIPLE = 20;
+
+// The assumed ratio of the uncompressed to the compressed size of an input file
+// that is compressed (`.gz`, `.bz2`, or `.zst`).
+constexpr size_t ESTIMATED_COMPRESSION_RATIO_OF_INPUT = 10;
+
 // How many Triples is the Buffer supposed to parse ahead.
 // If too big, the memory consumption is high, if too low we possibly lose speed
 static const size_t PARSER_BATCH_SIZE = 1'000'000;
@@ -53,6 +68,11 @@ static const size_t THRESHOLD_RELATION_CREATION = 2 << 20;
 static const std::string PARTIAL_VOCAB_FILE_NAME = ".tmp.partial-vocabulary.";
 static const std::string PARTIAL_MMAP_IDS = ".tmp.partial-ids-mmap.";
 
+// The partial vocabularies are compressed with ZSTD in blocks of this many
+// uncompressed bytes (see `ZstdFileWriteSerializer`). During the merge of the
+// vocabulary, two blocks of each partial vocabulary are held in memory.
+constexpr size_t UNCOMPRESSED_BLOCKSIZE_PARTIAL_VOCABULARY = 256 << 10;
+
 // ________________________________________________________________
 static const std::string TMP_BASENAME_COMPRESSION =
     ".tmp.for-prefix-compression";
@@ -68,6 +88,11 @@ constexpr size_t NUM_PARALLEL_ITEM_MAPS = 10;
 // parser is used.
 constexpr size_t NUM_PARALLEL_PARSER_THREADS = 8;
 
+// The number of input files that are parsed concurrently when the index is
+// built from several files (each of them with the number of threads from
+// above, when the parallel parser is used).
+constexpr size_t NUM_FILES_PARSED_CONCURRENTLY = 2;
+
 // Increasing the following two constants increases the RAM usage without much
 // benefit to the performance.
 
@@ -83,6 +108,39 @@ constexpr size_t QUEUE_SIZE_AFTER_PARALLEL_PARSING = 10;
 // performance negatively.
 static constexpr size_t BLOCKSIZE_VOCABULARY_MERGING = 100;
 
+// The maximal number of threads that identify the distinct words in a batch of
+// merged words and assign their global IDs, and that write the mappings from
+// the local to the global IDs. Each of these threads handles at least
+// `MIN_WORDS_PER_THREAD_VOCABULARY_MERGING` words, which is not const, s.t. it
+// can be set to a much lower value in unit tests.
+constexpr size_t NUM_THREADS_VOCABULARY_MERGING = 10;
+inline size_t MIN_WORDS_PER_THREAD_VOCABULARY_MERGING = 100'000;
+
+// The number of threads that parse the words file of the text index and
+// compute the postings of a batch of lines, and that compress and write the
+// blocks of the text index. The words file is processed in batches of (at
+// least) `NUM_LINES_PER_BATCH_TEXT_INDEX_BUILDING` lines, which is not const,
+// s.t. it can be set to a much lower value in unit tests.
+constexpr size_t NUM_THREADS_TEXT_INDEX_BUILDING = 8;
+inline size_t NUM_LINES_PER_BATCH_TEXT_INDEX_BUILDING = 1'000'000;
+
+// For each block of the text index (the words of which share a prefix of
+// `MIN_WORD_PREFIX_SIZE` characters), the postings of each longer prefix of up
+// to `MAX_WORD_PREFIX_SIZE_TEXT_PREFIX_BLOCKS` characters that has at least
+// `MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK` postings are additionally stored in a
+// prefix block, s.t. a prefix query (`word*`) for them doesn't have to read and
+// filter the whole block. The threshold is not const, s.t. it can be set to a
+// much lower value in unit tests.
+constexpr size_t MAX_WORD_PREFIX_SIZE_TEXT_PREFIX_BLOCKS = 6;
+inline size_t MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK = 100'000;
+
+// The number of threads that detect the patterns of the subjects when the SPO
+// permutation is built. The triples are processed in batches of (at least)
+// `NUM_TRIPLES_PER_BATCH_PATTERN_CREATION` triples, which is not const, s.t. it
+// can be set to a much lower value in unit tests.
+constexpr size_t NUM_THREADS_PATTERN_CREATION = 4;
+inline size_t NUM_TRIPLES_PER_BATCH_PATTERN_CREATION = 1'000'000;
+
 // A buffer size used during the second pass of the Index build.
 // It is not const, so we can set it to a much lower value for unit tests to
 // increase the test coverage.
@@ -95,3 +153,22 @@ inline size_t BUFFER_SIZE_PARTIAL_TO_GLOBAL_ID_MAPPINGS = 10'000;
 // infeasible. 250K seems to be a reasonable tradeoff here.
 constexpr ad_utility::MemorySize
     UNCOMPRESSED_BLOCKSIZE_COMPRESSED_METADATA_PER_COLUMN = 250_kB;
+
+// The uncompressed size in bytes of a single column of the blocks that are
+// shared by several small relations (for example the triples of most subjects
+// in the SPO permutation). These blocks are much smaller than the blocks of
+// the large relations, because a scan of a small relation always reads and
+// decompresses its complete block, and such scans (for example all triples of
+// a single entity) are very frequent.
+constexpr ad_utility::MemorySize
+    UNCOMPRESSED_BLOCKSIZE_SMALL_RELATIONS_PER_COLUMN = 16_kB;
+
+// The maximal uncompressed size of a single column of the blocks of the large
+// relations in the PSO and POS permutations. The relations of these
+// permutations (the predicates) are mostly read by sequential scans, so the
+// blocks of a huge relation (for example `rdf:type`) grow up to this size with
+// the size of the relation, which reduces the number of blocks and the size of
+// the metadata. The other permutations are mostly used for the lookup of
+// single entities and always use the normal blocksize.
+constexpr ad_utility::MemorySize
+    UNCOMPRESSED_BLOCKSIZE_LARGE_RELATIONS_PER_COLUMN = 1_MB;
@@ -0,0 +1,57 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "index/DecompressedBlockCache.h"
+
+#include "global/Constants.h"
+
+// _____________________________________________________________________________
+DecompressedBlockCache::DecompressedBlockCache(ad_utility::MemorySize maxSize) {
+  setMaxSize(maxSize);
+  for (auto& shard : shards_) {
+    shard.setOnEviction(
+        [this](const auto&, const auto&) { numEvictions_.increment(); });
+  }
+}
+
+// _____________________________________________________________________________
+void DecompressedBlockCache::setMaxSize(ad_utility::MemorySize maxSize) {
+  enabled_ = maxSize.getBytes() > 0;
+  auto maxSizePerShard = maxSize / NUM_SHARDS;
+  for (auto& shard : shards_) {
+    shard.setMaxSize(maxSizePerShard);
+    shard.setMaxSizeSingleEntry(maxSizePerShard);
+  }
+}
+
+// _____________________________________________________________________________
+void DecompressedBlockCache::clear() {
+  for (auto& shard : shards_) {
+    shard.clearAll();
+  }
+}
+
+// _____________________________________________________________________________
+size_t DecompressedBlockCache::numEntries() const {
+  size_t result = 0;
+  for (const auto& shard : shards_) {
+    result += shard.numNonPinnedEntries();
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+ad_utility::MemorySize DecompressedBlockCache::size() const {
+  ad_utility::MemorySize result = ad_utility::MemorySize::bytes(0);
+  for (const auto& shard : shards_) {
+    result += shard.nonPinnedSize();
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+DecompressedBlockCache& getDecompressedBlockCache() {
+  static DecompressedBlockCache cache{
+      RuntimeParameters().get<"decompressed-block-cache-max-size">()};
+  return cache;
+}
@@ -0,0 +1,107 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "absl/hash/hash.h"
+#include "engine/idTable/IdTable.h"
+#include "util/Cache.h"
+#include "util/ConcurrentCache.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Metrics.h"
+
+// Sometimes we do not read/decompress  all the columns of a block, so we have
+// to use a dynamic `IdTable`.
+using DecompressedBlock = IdTable;
+
+// To be able to use `DecompressedBlock` with `Caches`, we need a function for
+// calculating the memory used for it.
+struct DecompressedBlockSizeGetter {
+  ad_utility::MemorySize operator()(const DecompressedBlock& block) const {
+    return ad_utility::MemorySize::bytes(block.numColumns() * block.numRows() *
+                                         sizeof(Id));
+  }
+};
+
+// A memory-bounded LRU cache for the decompressed columns of the blocks of the
+// index permutations. A single instance (see `getDecompressedBlockCache()`)
+// is shared by all the `CompressedRelationReader`s and thus by all queries, so
+// the hot blocks of frequent predicates have to be decompressed only once. The
+// cache is split into `NUM_SHARDS` independently locked shards to reduce the
+// contention between the many threads that read blocks concurrently.
+class DecompressedBlockCache {
+ public:
+  // A decompressed column is identified by the reader to which it belongs (see
+  // `CompressedRelationReader::readerId_`, there is one reader per permutation)
+  // and the offset of the compressed column in the file of that reader.
+  using Key = std::pair<size_t, off_t>;
+  // The cached values always have a single column.
+  using Column = DecompressedBlock;
+  static constexpr size_t NUM_SHARDS = 16;
+
+ private:
+  using Shard = ad_utility::ConcurrentCache<
+      ad_utility::HeapBasedLRUCache<Key, Column, DecompressedBlockSizeGetter>>;
+  std::array<Shard, NUM_SHARDS> shards_;
+  std::atomic<bool> enabled_ = true;
+  // Sharded counters (see `ad_utility::metrics::Counter`), because they are
+  // updated by all the threads that use the cache.
+  ad_utility::metrics::Counter numHits_;
+  ad_utility::metrics::Counter numMisses_;
+  ad_utility::metrics::Counter numEvictions_;
+
+ public:
+  // Create a cache that stores at most `maxSize` of decompressed columns.
+  explicit DecompressedBlockCache(ad_utility::MemorySize maxSize);
+
+  // Return the cached column for the `key`. If it is not contained, it is
+  // computed via `computeColumn()` (which has to return a `Column` with a
+  // single column) and inserted into the cache. If the cache is disabled
+  // because its size is zero, the column is always computed.
+  template <typename ComputeFunction>
+  std::shared_ptr<const Column> getOrCompute(const Key& key,
+                                             ComputeFunction computeColumn) {
+    if (!enabled_) {
+      return std::make_shared<const Column>(computeColumn());
+    }
+    auto [column, status] = getShard(key).computeOnce(key, computeColumn);
+    if (status == ad_utility::CacheStatus::computed) {
+      numMisses_.increment();
+    } else {
+      numHits_.increment();
+    }
+    return std::move(column);
+  }
+
+  bool isEnabled() const { return enabled_; }
+
+  // Change the maximal size of the cache. A size of zero disables the cache.
+  void setMaxSize(ad_utility::MemorySize maxSize);
+
+  // Remove all entries from the cache. The hit and miss counters are kept.
+  void clear();
+
+  // Statistics for `cmd=cache-stats` and `/metrics`.
+  size_t numHits() const { return numHits_.value(); }
+  size_t numMisses() const { return numMisses_.value(); }
+  size_t numEvictions() const { return numEvictions_.value(); }
+  size_t numEntries() const;
+  ad_utility::MemorySize size() const;
+
+ private:
+  Shard& getShard(const Key& key) {
+    return shards_[absl::Hash<Key>{}(key) % NUM_SHARDS];
+  }
+};
+
+// Return the cache that is shared by all the `CompressedRelationReader`s. Its
+// size is initially set from the runtime parameter
+// `decompressed-block-cache-max-size`.
+DecompressedBlockCache& getDecompressedBlockCache();
@@ -0,0 +1,281 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/DeltaTriples.h"
+
+#include <re2/re2.h>
+
+#include <algorithm>
+#include <ranges>
+
+#include "absl/strings/str_cat.h"
+#include "parser/Tokenizer.h"
+#include "util/Exception.h"
+
+namespace {
+// Return the `triple` (in SPO order) in the order of the `permutation`.
+DeltaTriples::IdTriple permute(const DeltaTriples::IdTriple& triple,
+                               Permutation::Enum permutation) {
+  auto keyOrder = Permutation::toKeyOrder(permutation);
+  return {triple[keyOrder[0]], triple[keyOrder[1]], triple[keyOrder[2]]};
+}
+
+constexpr std::array allPermutations{
+    Permutation::PSO, Permutation::POS, Permutation::SPO,
+    Permutation::SOP, Permutation::OPS, Permutation::OSP};
+}  // namespace
+
+// _____________________________________________________________________________
+bool DeltaTriples::isContainedInIndex(const IdTriple& triple) const {
+  if (!pso_.isLoaded_) {
+    return false;
+  }
+  const auto& [subject, predicate, object] = triple;
+  auto objects =
+      pso_.scan(predicate, subject, {},
+                std::make_shared<ad_utility::CancellationHandle<>>());
+  return std::ranges::binary_search(objects.getColumn(0), object);
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::modifyTriples(State& state,
+                                 std::span<const IdTriple> triples,
+                                 bool insert) const {
+  for (const auto& triple : triples) {
+    // Inserting a triple of the index or deleting a triple that is not part of
+    // the index only undoes a previous deletion or insertion.
+    bool store = isContainedInIndex(triple) != insert;
+    for (auto permutation : allPermutations) {
+      auto& inserted = state.inserted_.at(static_cast<size_t>(permutation));
+      auto& deleted = state.deleted_.at(static_cast<size_t>(permutation));
+      auto permuted = permute(triple, permutation);
+      inserted.erase(permuted);
+      deleted.erase(permuted);
+      if (store) {
+        (insert ? inserted : deleted).insert(permuted);
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::insertTriples(std::span<const IdTriple> triples) {
+  modifyTriples(*state_.wlock(), triples, true);
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::deleteTriples(std::span<const IdTriple> triples) {
+  modifyTriples(*state_.wlock(), triples, false);
+}
+
+// _____________________________________________________________________________
+auto DeltaTriples::toIdTriples(State& state, std::vector<TurtleTriple> triples,
+                               bool insert) const -> std::vector<IdTriple> {
+  // The copy of the local vocabulary to which the new words are added. It
+  // replaces the local vocabulary of the `state` at the end, s.t. the local
+  // vocabularies that have already been handed out are not changed.
+  std::optional<LocalVocab> newLocalVocab;
+  auto toId = [&](TripleComponent component) -> std::optional<Id> {
+    if (auto id = component.toValueId(vocab_); id.has_value()) {
+      return id;
+    }
+    const auto& localVocab =
+        newLocalVocab.has_value() ? newLocalVocab.value() : *state.localVocab_;
+    if (auto id = getLocalVocabId(component, localVocab); id.has_value()) {
+      return id;
+    }
+    if (!insert) {
+      return std::nullopt;
+    }
+    if (!newLocalVocab.has_value()) {
+      newLocalVocab = state.localVocab_->clone();
+    }
+    return std::move(component).toValueId(vocab_, newLocalVocab.value());
+  };
+
+  std::vector<IdTriple> result;
+  result.reserve(triples.size());
+  for (auto& triple : triples) {
+    auto subject = toId(TripleComponent{std::move(triple.subject_)});
+    auto predicate = toId(TripleComponent{std::move(triple.predicate_)});
+    auto object = toId(std::move(triple.object_));
+    if (subject.has_value() && predicate.has_value() && object.has_value()) {
+      result.push_back({subject.value(), predicate.value(), object.value()});
+    }
+  }
+  if (newLocalVocab.has_value()) {
+    state.localVocab_ =
+        std::make_shared<const LocalVocab>(std::move(newLocalVocab.value()));
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::insertTriples(std::vector<TurtleTriple> triples) {
+  auto state = state_.wlock();
+  modifyTriples(*state, toIdTriples(*state, std::move(triples), true), true);
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::deleteTriples(std::vector<TurtleTriple> triples) {
+  auto state = state_.wlock();
+  modifyTriples(*state, toIdTriples(*state, std::move(triples), false), false);
+}
+
+// _____________________________________________________________________________
+std::pair<bool, std::vector<TurtleTriple>> DeltaTriples::parseUpdate(
+    std::string_view update) {
+  static const re2::RE2 updateRegex{
+      R"((?is)(.*?)\b(INSERT|DELETE)\s+DATA\s*\{(.*)\}\s*;?\s*)"};
+  std::string prologue;
+  std::string operation;
+  std::string body;
+  if (!re2::RE2::FullMatch(update, updateRegex, &prologue, &operation,
+                           &body)) {
+    throw std::runtime_error(
+        "Only SPARQL UPDATE requests of the form \"INSERT DATA { ... }\" or "
+        "\"DELETE DATA { ... }\" are supported");
+  }
+  // In SPARQL, the dot after the last triple of the data block is optional.
+  auto lastNonSpace = body.find_last_not_of(" \t\r\n");
+  if (lastNonSpace != std::string::npos && body[lastNonSpace] != '.') {
+    body.append(" .");
+  }
+  TurtleStringParser<Tokenizer> parser;
+  parser.setInputStream(absl::StrCat(prologue, "\n", body));
+  bool isInsert = operation.front() == 'I' || operation.front() == 'i';
+  return {isInsert, parser.parseAndReturnAllTriples()};
+}
+
+// _____________________________________________________________________________
+size_t DeltaTriples::applyUpdate(std::string_view update) {
+  auto [isInsert, triples] = parseUpdate(update);
+  size_t numTriples = triples.size();
+  if (isInsert) {
+    insertTriples(std::move(triples));
+  } else {
+    deleteTriples(std::move(triples));
+  }
+  return numTriples;
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::clear() { *state_.wlock() = State{}; }
+
+// _____________________________________________________________________________
+auto DeltaTriples::getCounts() const -> Counts {
+  auto state = state_.rlock();
+  // All the permutations contain the same triples.
+  return {state->inserted_.front().size(), state->deleted_.front().size()};
+}
+
+// _____________________________________________________________________________
+auto DeltaTriples::matchingTriples(const std::set<IdTriple>& set,
+                                   std::optional<Id> col0Id,
+                                   std::optional<Id> col1Id) {
+  AD_CONTRACT_CHECK(col0Id.has_value() || !col1Id.has_value());
+  IdTriple lower{col0Id.value_or(Id::min()), col1Id.value_or(Id::min()),
+                 Id::min()};
+  IdTriple upper{col0Id.value_or(Id::max()), col1Id.value_or(Id::max()),
+                 Id::max()};
+  return std::ranges::subrange(set.lower_bound(lower), set.upper_bound(upper));
+}
+
+// _____________________________________________________________________________
+auto DeltaTriples::getCounts(Permutation::Enum permutation,
+                             std::optional<Id> col0Id,
+                             std::optional<Id> col1Id) const -> Counts {
+  auto state = state_.rlock();
+  auto count = [&](const auto& sets) {
+    return static_cast<size_t>(std::ranges::distance(matchingTriples(
+        sets.at(static_cast<size_t>(permutation)), col0Id, col1Id)));
+  };
+  return {count(state->inserted_), count(state->deleted_)};
+}
+
+// _____________________________________________________________________________
+std::shared_ptr<const LocalVocab> DeltaTriples::localVocab() const {
+  return state_.rlock()->localVocab_;
+}
+
+// _____________________________________________________________________________
+std::optional<Id> DeltaTriples::getLocalVocabId(
+    const TripleComponent& component, const LocalVocab& localVocab) {
+  if (!component.isString() && !component.isLiteral()) {
+    return std::nullopt;
+  }
+  const std::string& word = component.isString()
+                                ? component.getString()
+                                : component.getLiteral().rawContent();
+  return localVocab.getIdOrNullopt(word);
+}
+
+// _____________________________________________________________________________
+std::optional<Id> DeltaTriples::getLocalVocabId(
+    const TripleComponent& component) const {
+  return getLocalVocabId(component, *localVocab());
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::mergeIntoScan(Permutation::Enum permutation,
+                                 std::optional<Id> col0Id,
+                                 std::optional<Id> col1Id,
+                                 IdTable& result) const {
+  size_t numFixedColumns =
+      static_cast<size_t>(col0Id.has_value()) + col1Id.has_value();
+  size_t numTripleColumns = 3 - numFixedColumns;
+  AD_CONTRACT_CHECK(result.numColumns() >= numTripleColumns);
+
+  auto state = state_.rlock();
+  auto inserted = matchingTriples(
+      state->inserted_.at(static_cast<size_t>(permutation)), col0Id, col1Id);
+  auto deleted = matchingTriples(
+      state->deleted_.at(static_cast<size_t>(permutation)), col0Id, col1Id);
+  if (inserted.empty() && deleted.empty()) {
+    return;
+  }
+
+  // Compare the columns of a row of the `result` that belong to the triple
+  // with the (free columns of the) `triple`.
+  auto compare = [&](const auto& row, const IdTriple& triple) {
+    for (size_t i = 0; i < numTripleColumns; ++i) {
+      if (auto cmp = row[i] <=> triple[numFixedColumns + i]; cmp != 0) {
+        return cmp;
+      }
+    }
+    return std::strong_ordering::equal;
+  };
+  IdTable merged{result.numColumns(), result.getAllocator()};
+  merged.reserve(result.size() + std::ranges::distance(inserted));
+  auto pushInserted = [&](const IdTriple& triple) {
+    merged.emplace_back();
+    size_t row = merged.size() - 1;
+    for (size_t col = 0; col < merged.numColumns(); ++col) {
+      merged(row, col) = col < numTripleColumns
+                             ? triple[numFixedColumns + col]
+                             : Id::makeUndefined();
+    }
+  };
+
+  auto insertedIt = inserted.begin();
+  auto deletedIt = deleted.begin();
+  for (const auto& row : result) {
+    while (insertedIt != inserted.end() && compare(row, *insertedIt) > 0) {
+      pushInserted(*insertedIt);
+      ++insertedIt;
+    }
+    // An inserted triple that is already contained in the `result`.
+    if (insertedIt != inserted.end() && compare(row, *insertedIt) == 0) {
+      ++insertedIt;
+    }
+    while (deletedIt != deleted.end() && compare(row, *deletedIt) > 0) {
+      ++deletedIt;
+    }
+    if (deletedIt != deleted.end() && compare(row, *deletedIt) == 0) {
+      continue;
+    }
+    merged.push_back(row);
+  }
+  std::ranges::for_each(insertedIt, inserted.end(), pushInserted);
+  result = std::move(merged);
+}
@@ -0,0 +1,157 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "engine/LocalVocab.h"
+#include "engine/idTable/IdTable.h"
+#include "global/Id.h"
+#include "index/Permutation.h"
+#include "index/Vocabulary.h"
+#include "parser/TripleComponent.h"
+#include "parser/TurtleParser.h"
+#include "util/Synchronized.h"
+
+// The triples that were inserted into or deleted from an index after it was
+// built (via SPARQL UPDATE requests with `INSERT DATA` or `DELETE DATA`). They
+// are kept in memory, sorted once for each of the six permutations, and are
+// merged into the results of the scans of the permutations at query time (see
+// `mergeIntoScan`), s.t. the index reflects the updates without a rebuild.
+//
+// Words (IRIs and literals) of inserted triples that are not contained in the
+// vocabulary of the index are stored in a `LocalVocab`. That local vocabulary
+// is never changed once it has been handed out (a new word leads to a new copy
+// of it), s.t. the results of scans can share it (see `localVocab()`).
+//
+// The triples are not written back to the permutations on disk, so the updates
+// are lost when the server is restarted.
+class DeltaTriples {
+ public:
+  // A triple of IDs, in the order of a permutation or in SPO order.
+  using IdTriple = std::array<Id, 3>;
+
+  // The number of triples that are currently inserted and deleted.
+  struct Counts {
+    size_t numInserted_ = 0;
+    size_t numDeleted_ = 0;
+    bool operator==(const Counts&) const = default;
+  };
+
+ private:
+  struct State {
+    // The inserted and the deleted triples, once for each permutation (the
+    // index is the `Permutation::Enum`), in the order of the permutation. A
+    // triple is never contained in both sets.
+    std::array<std::set<IdTriple>, 6> inserted_;
+    std::array<std::set<IdTriple>, 6> deleted_;
+    std::shared_ptr<const LocalVocab> localVocab_ =
+        std::make_shared<const LocalVocab>();
+  };
+  const RdfsVocabulary& vocab_;
+  // Used to check whether a triple is contained in the permutations on disk.
+  const Permutation& pso_;
+  ad_utility::Synchronized<State> state_;
+
+ public:
+  // The IDs of the words of the triples are looked up in the `vocab`, and the
+  // `pso` permutation is used to check which triples are already contained in
+  // the index. Both must outlive this object.
+  DeltaTriples(const RdfsVocabulary& vocab, const Permutation& pso)
+      : vocab_{vocab}, pso_{pso} {}
+
+  // Insert or delete the given triples (in SPO order). Only the inserted
+  // triples that are not contained in the index and the deleted triples that
+  // are contained in the index are stored, s.t. the sizes of the scans can be
+  // computed exactly (see `getCounts`).
+  void insertTriples(std::span<const IdTriple> triples);
+  void deleteTriples(std::span<const IdTriple> triples);
+
+  // Insert or delete the given parsed triples. Words that are contained
+  // neither in the vocabulary of the index nor in the local vocabulary are
+  // added to the local vocabulary.
+  void insertTriples(std::vector<TurtleTriple> triples);
+  void deleteTriples(std::vector<TurtleTriple> triples);
+
+  // Apply a SPARQL UPDATE request of the form `INSERT DATA { ... }` or
+  // `DELETE DATA { ... }`, optionally preceded by `PREFIX` declarations. The
+  // triples in the braces are parsed as Turtle. Other kinds of updates lead to
+  // an exception. Return the number of triples of the request.
+  size_t applyUpdate(std::string_view update);
+
+  // Remove all the inserted and deleted triples and the local vocabulary.
+  void clear();
+
+  Counts getCounts() const;
+
+  // The number of inserted and deleted triples that match the scan of the
+  // `permutation` with the given `col0Id` and `col1Id` (see `mergeIntoScan`).
+  // The size of the result of the scan is the size of the scan on disk plus
+  // the inserted minus the deleted triples.
+  Counts getCounts(Permutation::Enum permutation, std::optional<Id> col0Id,
+                   std::optional<Id> col1Id) const;
+
+  // Return true iff no triples are inserted or deleted. If not, the
+  // optimizations that read the blocks of the permutations directly (like the
+  // lazy scans, see `IndexScan`) must not be used.
+  bool empty() const { return getCounts() == Counts{}; }
+
+  // The local vocabulary with the words that are not part of the vocabulary of
+  // the index. It contains all the words of all the inserted triples so far.
+  std::shared_ptr<const LocalVocab> localVocab() const;
+
+  // Return the ID of the `component` if it is a word of the local vocabulary
+  // (or short enough to be inlined into its ID, see `LocalVocab`), else
+  // `std::nullopt`. This is the fallback for the words that are not contained
+  // in the vocabulary of the index.
+  std::optional<Id> getLocalVocabId(const TripleComponent& component) const;
+
+  // Merge the triples into the `result` of the scan of the `permutation` with
+  // the given `col0Id` and `col1Id` (both `std::nullopt` for a full scan). The
+  // `result` has the columns of the triples that are not fixed by the scan,
+  // followed by the additional columns (which are UNDEF for inserted triples).
+  // The deleted triples are removed from it and the inserted triples are
+  // added, such that it remains sorted.
+  void mergeIntoScan(Permutation::Enum permutation, std::optional<Id> col0Id,
+                     std::optional<Id> col1Id, IdTable& result) const;
+
+  // Parse an update request (see `applyUpdate`). Return true for an `INSERT`
+  // and false for a `DELETE`, and the triples of the request.
+  static std::pair<bool, std::vector<TurtleTriple>> parseUpdate(
+      std::string_view update);
+
+ private:
+  // Convert the `triples` to IDs. If `insert` is true, the words that are not
+  // contained in any of the vocabularies are added to a copy of the local
+  // vocabulary of the `state`, else the triples with such words are skipped
+  // (they cannot be contained in the index).
+  std::vector<IdTriple> toIdTriples(State& state,
+                                    std::vector<TurtleTriple> triples,
+                                    bool insert) const;
+
+  // Return the ID of the `component` in the `localVocab` (see the public
+  // overload above).
+  static std::optional<Id> getLocalVocabId(const TripleComponent& component,
+                                           const LocalVocab& localVocab);
+
+  // Return true iff the `triple` (in SPO order) is contained in the
+  // permutations on disk.
+  bool isContainedInIndex(const IdTriple& triple) const;
+
+  // Insert (if `insert` is true) or delete the `triples`.
+  void modifyTriples(State& state, std::span<const IdTriple> triples,
+                     bool insert) const;
+
+  // The triples of the `set` that match the scan with the given `col0Id` and
+  // `col1Id`.
+  static auto matchingTriples(const std::set<IdTriple>& set,
+                              std::optional<Id> col0Id,
+                              std::optional<Id> col1Id);
+};
@@ -4,14 +4,132 @@
 
 #include "DocsDB.h"
 
+#include <zdict.h>
+
 #include <algorithm>
+#include <filesystem>
+#include <numeric>
 
 #include "../global/Constants.h"
 
+// _____________________________________________________________________________
+DocsDB::Builder::Builder(const string& fileName)
+    : file_{fileName, "w"},
+      recordOffsets_{fileName + string(RECORD_OFFSETS_SUFFIX),
+                     ad_utility::CreateTag{}},
+      blocks_{fileName + string(BLOCKS_SUFFIX), ad_utility::CreateTag{}} {}
+
+// _____________________________________________________________________________
+void DocsDB::Builder::addTextRecord(uint64_t contextId, std::string_view text) {
+  AD_CONTRACT_CHECK(contextId >= nextRecord_);
+  while (nextRecord_ <= contextId) {
+    recordOffsets_.push_back(uncompressedOffset_);
+    ++nextRecord_;
+  }
+  currentBlock_.append(text);
+  uncompressedOffset_ += text.size();
+  // A record is never split between two blocks.
+  if (currentBlock_.size() >= BLOCK_SIZE) {
+    finishBlock();
+  }
+}
+
+// _____________________________________________________________________________
+void DocsDB::Builder::finishBlock() {
+  // Empty records that follow the last non-empty block belong to the next
+  // block.
+  if (currentBlock_.empty()) {
+    return;
+  }
+  if (cDict_ == nullptr) {
+    trainingBlocks_.emplace_back(currentBlockFirstRecord_,
+                                 std::move(currentBlock_));
+    if (trainingBlocks_.size() == NUM_TRAINING_BLOCKS) {
+      trainDictionaryAndWriteTrainingBlocks();
+    }
+  } else {
+    writeBlock(currentBlockFirstRecord_, currentBlock_);
+  }
+  currentBlock_.clear();
+  currentBlockFirstRecord_ = nextRecord_;
+}
+
+// _____________________________________________________________________________
+void DocsDB::Builder::trainDictionaryAndWriteTrainingBlocks() {
+  string samples;
+  vector<size_t> sampleSizes;
+  for (const auto& [firstRecord, text] : trainingBlocks_) {
+    samples.append(text);
+    sampleSizes.push_back(text.size());
+  }
+  // For very small inputs, there is nothing to gain from a dictionary (and
+  // the training fails).
+  if (samples.size() >= 8 * MAX_DICTIONARY_SIZE) {
+    dictionary_.resize(MAX_DICTIONARY_SIZE);
+    size_t dictionarySize = ZDICT_trainFromBuffer(
+        dictionary_.data(), dictionary_.size(), samples.data(),
+        sampleSizes.data(), static_cast<unsigned>(sampleSizes.size()));
+    if (ZDICT_isError(dictionarySize)) {
+      LOG(WARN) << "Training the dictionary of the DocsDB failed: "
+                << ZDICT_getErrorName(dictionarySize) << std::endl;
+      dictionarySize = 0;
+    }
+    dictionary_.resize(dictionarySize);
+  }
+  cDict_.reset(ZSTD_createCDict(dictionary_.data(), dictionary_.size(),
+                                COMPRESSION_LEVEL));
+  AD_CORRECTNESS_CHECK(cDict_ != nullptr);
+  for (const auto& [firstRecord, text] : trainingBlocks_) {
+    writeBlock(firstRecord, text);
+  }
+  trainingBlocks_.clear();
+}
+
+// _____________________________________________________________________________
+void DocsDB::Builder::writeBlock(uint64_t firstRecord, std::string_view text) {
+  string compressed(ZSTD_compressBound(text.size()), '\0');
+  size_t compressedSize = ZSTD_compress_usingCDict(
+      cCtx_.get(), compressed.data(), compressed.size(), text.data(),
+      text.size(), cDict_.get());
+  AD_CORRECTNESS_CHECK(!ZSTD_isError(compressedSize));
+  blocks_.push_back(Block{firstRecord, compressedOffset_});
+  compressedOffset_ += file_.write(compressed.data(), compressedSize);
+}
+
+// _____________________________________________________________________________
+void DocsDB::Builder::finish() && {
+  finishBlock();
+  if (cDict_ == nullptr) {
+    trainDictionaryAndWriteTrainingBlocks();
+  }
+  // The end of the last record and block.
+  recordOffsets_.push_back(uncompressedOffset_);
+  blocks_.push_back(Block{nextRecord_, compressedOffset_});
+  // The dictionary follows the blocks.
+  off_t startOfDictionary = static_cast<off_t>(compressedOffset_);
+  file_.write(dictionary_.data(), dictionary_.size());
+  file_.write(&startOfDictionary, sizeof(startOfDictionary));
+  file_.close();
+  recordOffsets_.close();
+  blocks_.close();
+}
+
 // _____________________________________________________________________________
 void DocsDB::init(const string& fileName) {
   _dbFile.open(fileName.c_str(), "r");
-  if (_dbFile.empty()) {
+  isCompressed_ = std::filesystem::exists(fileName + string(BLOCKS_SUFFIX));
+  if (isCompressed_) {
+    recordOffsets_.open(fileName + string(RECORD_OFFSETS_SUFFIX));
+    blocks_.open(fileName + string(BLOCKS_SUFFIX));
+    AD_CORRECTNESS_CHECK(recordOffsets_.size() >= 1 && blocks_.size() >= 1);
+    _size = recordOffsets_.size() - 1;
+    off_t startOfDictionary;
+    off_t endOfDictionary = _dbFile.getLastOffset(&startOfDictionary);
+    string dictionary(endOfDictionary - startOfDictionary, '\0');
+    _dbFile.read(dictionary.data(), dictionary.size(), startOfDictionary);
+    dDict_.reset(ZSTD_createDDict(dictionary.data(), dictionary.size()));
+    AD_CORRECTNESS_CHECK(dDict_ != nullptr);
+  } else if (_dbFile.empty()) {
     _size = 0;
   } else {
     off_t posLastOfft = _dbFile.getLastOffset(&_startOfOffsets);
@@ -28,7 +146,14 @@ string DocsDB::getTextExcerpt(TextRecordIndex cid) const {
         "sure that"
         " a file .text.docsDB exists");
   }
+  if (!isCompressed_) {
+    return getUncompressedTextExcerpt(cid);
+  }
+  return std::move(getTextExcerpts(std::span{&cid, 1}).front());
+}
 
+// _____________________________________________________________________________
+string DocsDB::getUncompressedTextExcerpt(TextRecordIndex cid) const {
   off_t ft[2];
   off_t& from = ft[0];
   off_t& to = ft[1];
@@ -43,3 +168,65 @@ string DocsDB::getTextExcerpt(TextRecordIndex cid) const {
   _dbFile.read(line.data(), nofBytes, from);
   return line;
 }
+
+// _____________________________________________________________________________
+vector<string> DocsDB::getTextExcerpts(
+    std::span<const TextRecordIndex> cids) const {
+  vector<string> result(cids.size());
+  // Handle the IDs in ascending order, s.t. the blocks are read in order and
+  // each of them only once.
+  vector<size_t> order(cids.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::ranges::sort(order, std::less{},
+                    [&cids](size_t i) { return cids[i].get(); });
+
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dCtx{
+      isCompressed_ ? ZSTD_createDCtx() : nullptr, &ZSTD_freeDCtx};
+  const uint64_t* offsets = recordOffsets_.data();
+  const Block* blocks = blocks_.data();
+  size_t currentBlock = blocks_.size();
+  string blockText;
+  string compressed;
+  for (size_t i : order) {
+    uint64_t cid = cids[i].get();
+    if (cid >= _size) {
+      continue;
+    }
+    if (!isCompressed_) {
+      result[i] = getUncompressedTextExcerpt(cids[i]);
+      continue;
+    }
+    // As in the uncompressed format, an empty record yields the next
+    // non-empty one.
+    uint64_t from = offsets[cid];
+    const uint64_t* end = offsets + _size + 1;
+    const uint64_t* to = std::upper_bound(offsets + cid + 1, end, from);
+    if (to == end) {
+      continue;
+    }
+    uint64_t record = (to - offsets) - 1;
+    size_t block =
+        std::upper_bound(blocks, blocks + blocks_.size(), record,
+                         [](uint64_t r, const Block& b) {
+                           return r < b.firstRecord_;
+                         }) -
+        blocks - 1;
+    AD_CORRECTNESS_CHECK(block + 1 < blocks_.size());
+    uint64_t blockStart = offsets[blocks[block].firstRecord_];
+    if (block != currentBlock) {
+      compressed.resize(blocks[block + 1].compressedOffset_ -
+                        blocks[block].compressedOffset_);
+      _dbFile.read(compressed.data(), compressed.size(),
+                   static_cast<off_t>(blocks[block].compressedOffset_));
+      blockText.resize(offsets[blocks[block + 1].firstRecord_] - blockStart);
+      size_t decompressedSize = ZSTD_decompress_usingDDict(
+          dCtx.get(), blockText.data(), blockText.size(), compressed.data(),
+          compressed.size(), dDict_.get());
+      AD_CORRECTNESS_CHECK(!ZSTD_isError(decompressedSize) &&
+                           decompressedSize == blockText.size());
+      currentBlock = block;
+    }
+    result[i] = blockText.substr(from - blockStart, *to - from);
+  }
+  return result;
+}
@@ -3,23 +3,104 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 #pragma once
 
+#include <zstd.h>
+
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "../global/Id.h"
 #include "../util/File.h"
+#include "../util/MmapVector.h"
 
 using std::pair;
 using std::string;
 using std::vector;
 
+// The text records of the text index. The records are concatenated and split
+// into blocks of about `BLOCK_SIZE` bytes, which are compressed independently
+// with zstd and a dictionary that is trained on the first blocks. The offsets
+// of the records (in the uncompressed concatenation) and the first record and
+// offset of each compressed block are stored in two mmapped files next to the
+// file with the compressed blocks.
+//
+// DocsDBs that were built before the compression was introduced (plain text
+// followed by the offsets of the records) can still be read.
 class DocsDB {
  public:
+  // The (uncompressed) size of a block, after which the next block is begun.
+  // Small blocks keep the random access to single excerpts cheap, the
+  // dictionary keeps the compression of small blocks effective.
+  static constexpr size_t BLOCK_SIZE = 16 * 1024;
+  // The dictionary is trained on (at most) this many blocks at the beginning.
+  static constexpr size_t NUM_TRAINING_BLOCKS = 1024;
+  static constexpr size_t MAX_DICTIONARY_SIZE = 112 * 1024;
+  static constexpr int COMPRESSION_LEVEL = 9;
+
+  // The suffixes of the files with the offsets of the records and the blocks.
+  static constexpr std::string_view RECORD_OFFSETS_SUFFIX =
+      ".recordOffsets.mmap";
+  static constexpr std::string_view BLOCKS_SUFFIX = ".blocks.mmap";
+
+  // The first record of a compressed block and its offset in the file.
+  struct Block {
+    uint64_t firstRecord_;
+    uint64_t compressedOffset_;
+  };
+
+  // Write a compressed DocsDB to the `fileName`. The text records have to be
+  // added in ascending order of their IDs, records with IDs that are skipped
+  // are empty.
+  class Builder {
+   public:
+    explicit Builder(const string& fileName);
+    void addTextRecord(uint64_t contextId, std::string_view text);
+    void finish() &&;
+
+   private:
+    void finishBlock();
+    void trainDictionaryAndWriteTrainingBlocks();
+    void writeBlock(uint64_t firstRecord, std::string_view text);
+
+    ad_utility::File file_;
+    ad_utility::MmapVector<uint64_t> recordOffsets_;
+    ad_utility::MmapVector<Block> blocks_;
+    uint64_t nextRecord_ = 0;
+    uint64_t uncompressedOffset_ = 0;
+    uint64_t compressedOffset_ = 0;
+    uint64_t currentBlockFirstRecord_ = 0;
+    string currentBlock_;
+    // The first blocks are kept until the dictionary is trained on them.
+    vector<pair<uint64_t, string>> trainingBlocks_;
+    string dictionary_;
+    std::unique_ptr<ZSTD_CDict, decltype(&ZSTD_freeCDict)> cDict_{
+        nullptr, &ZSTD_freeCDict};
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cCtx_{
+        ZSTD_createCCtx(), &ZSTD_freeCCtx};
+  };
+
   void init(const string& fileName);
   string getTextExcerpt(TextRecordIndex cid) const;
 
+  // Get the excerpts of all the `cids` at once (in the same order). Each block
+  // is read and decompressed only once. Unlike `getTextExcerpt`, IDs that are
+  // out of range yield empty excerpts.
+  vector<string> getTextExcerpts(std::span<const TextRecordIndex> cids) const;
+
   mutable ad_utility::File _dbFile;
   off_t _startOfOffsets;
   size_t _size = 0;
+
+ private:
+  // Read an excerpt from a DocsDB without compression.
+  string getUncompressedTextExcerpt(TextRecordIndex cid) const;
+
+  bool isCompressed_ = false;
+  ad_utility::MmapVectorView<uint64_t> recordOffsets_;
+  ad_utility::MmapVectorView<Block> blocks_;
+  std::unique_ptr<ZSTD_DDict, decltype(&ZSTD_freeDDict)> dDict_{
+      nullptr, &ZSTD_freeDDict};
 };
@@ -0,0 +1,89 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <absl/strings/str_cat.h>
+
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/Exception.h"
+
+// Encode IRIs of the form `<prefix><number>`, where `prefix` is one of a few
+// configured prefixes (for example `<http://www.wikidata.org/entity/Q`) and
+// `number` is a decimal number without leading zeros, directly into an `Id`
+// of type `EncodedIri`. Such IRIs then need no entry in the vocabulary, and
+// they are converted to and from strings without any lookup.
+class EncodedIriManager {
+ private:
+  std::vector<std::string> prefixes_;
+
+ public:
+  EncodedIriManager() = default;
+
+  // Each of the `prefixes` must start with `<` and must not end with a digit
+  // (which guarantees that each IRI can be encoded in at most one way). Throw
+  // if this is not the case or if there are too many prefixes.
+  explicit EncodedIriManager(std::vector<std::string> prefixes)
+      : prefixes_{std::move(prefixes)} {
+    if (prefixes_.size() > Id::maxNumEncodedIriPrefixes) {
+      throw std::runtime_error{
+          absl::StrCat("At most ", Id::maxNumEncodedIriPrefixes,
+                       " prefixes of encoded IRIs are supported")};
+    }
+    for (const auto& prefix : prefixes_) {
+      if (!prefix.starts_with('<') || prefix.find('>') != std::string::npos ||
+          std::isdigit(static_cast<unsigned char>(prefix.back()))) {
+        throw std::runtime_error{absl::StrCat(
+            "Invalid prefix for encoded IRIs: \"", prefix,
+            "\". It must start with \"<\" and must not end with a digit")};
+      }
+    }
+  }
+
+  const std::vector<std::string>& prefixes() const { return prefixes_; }
+
+  // Return the `Id` of the `iri` if it has one of the `prefixes_` followed by
+  // a number that fits into an `EncodedIri`, else return `std::nullopt`.
+  std::optional<Id> encode(std::string_view iri) const {
+    if (prefixes_.empty() || !iri.ends_with('>')) {
+      return std::nullopt;
+    }
+    for (size_t i = 0; i < prefixes_.size(); ++i) {
+      const auto& prefix = prefixes_[i];
+      if (!iri.starts_with(prefix)) {
+        continue;
+      }
+      auto digits = iri.substr(prefix.size(), iri.size() - prefix.size() - 1);
+      // Leading zeros would be lost when converting back to a string.
+      if (digits.empty() || (digits.size() > 1 && digits.front() == '0')) {
+        return std::nullopt;
+      }
+      uint64_t number;
+      auto [ptr, ec] =
+          std::from_chars(digits.data(), digits.data() + digits.size(), number);
+      if (ec != std::errc{} || ptr != digits.data() + digits.size() ||
+          number > Id::maxEncodedIriNumber) {
+        return std::nullopt;
+      }
+      return Id::makeFromEncodedIri({i, number});
+    }
+    return std::nullopt;
+  }
+
+  // Return the IRI that is encoded in the `id`, which must be of type
+  // `EncodedIri`.
+  std::string toString(Id id) const {
+    AD_CONTRACT_CHECK(id.getDatatype() == Datatype::EncodedIri);
+    auto [prefixIndex, number] = id.getEncodedIri();
+    AD_CORRECTNESS_CHECK(prefixIndex < prefixes_.size());
+    return absl::StrCat(prefixes_[prefixIndex], number, ">");
+  }
+};
@@ -4,13 +4,16 @@
 
 #include "./FTSAlgorithms.h"
 
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <set>
 #include <utility>
 
+#include "global/Constants.h"
 #include "util/HashMap.h"
 #include "util/HashSet.h"
+#include "util/ParallelExecution.h"
 #include "util/SuppressWarnings.h"
 
 using std::pair;
@@ -544,172 +547,243 @@ template void FTSAlgorithms::aggScoresAndTakeTopContext<9>(
 template void FTSAlgorithms::aggScoresAndTakeTopContext<10>(
     const WordEntityPostings& wep, IdTable* dynResult);
 
-// _____________________________________________________________________________
-template <int WIDTH>
-void FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts(
-    const WordEntityPostings& wep, size_t nofVars, size_t kLimit,
-    IdTable* dynResult) {
-  AD_CONTRACT_CHECK(wep.wids_.size() >= 1);
-
-  size_t numTerms = dynResult->numColumns() - 2 - nofVars;
+namespace {
+using ScoreAndContext = std::pair<Score, TextRecordIndex>;
 
-  if (wep.cids_.empty()) {
-    return;
+// Orders the contexts s.t. the first one is the one that is dropped first
+// when there are too many: the one with the lowest score, and of those the
+// last one. This is a total order, so the top k contexts don't depend on the
+// order in which the contexts are added.
+struct WorstContextFirst {
+  bool operator()(const ScoreAndContext& a, const ScoreAndContext& b) const {
+    return a.first < b.first || (a.first == b.first && a.second > b.second);
   }
-  if (kLimit == 1) {
-    multVarsAggScoresAndTakeTopContext<WIDTH>(wep, nofVars, dynResult);
-  } else {
-    // Go over contexts.
-    // For each context build a cross product of width 2.
-    // Store them in a map, use a pair of id's as key and
-    // an appropriate hash function.
-    // Use a set (ordered) and keep it at size k for the context scores
-    // This achieves O(n log k)
-    LOG(DEBUG) << "Heap-using case with " << kLimit
-               << " contexts per entity...\n";
-
-    AD_CONTRACT_CHECK(wep.wids_.size() >= numTerms);
-    for (size_t i = 0; i < numTerms; i++) {
-      AD_CONTRACT_CHECK(wep.wids_[i].size() == wep.cids_.size());
-    }
+};
+using TopContexts = std::set<ScoreAndContext, WorstContextFirst>;
+
+// Add the `context` to the `topContexts` and keep only the `kLimit` best
+// ones.
+void addToTopContexts(TopContexts& topContexts, const ScoreAndContext& context,
+                      size_t kLimit) {
+  if (topContexts.size() < std::max(kLimit, size_t{1})) {
+    topContexts.insert(context);
+  } else if (WorstContextFirst{}(*topContexts.begin(), context)) {
+    topContexts.erase(topContexts.begin());
+    topContexts.insert(context);
+  }
+}
 
-    using AggMapContextAndEntityToWord =
-        ad_utility::HashMap<std::pair<vector<Id>, TextRecordIndex>,
-                            std::set<vector<WordIndex>>>;
-    using ScoreAndContextSet = std::set<std::pair<Score, TextRecordIndex>>;
-    using AggMapEntityToSaCS =
-        ad_utility::HashMap<vector<Id>, std::pair<Score, ScoreAndContextSet>>;
-    AggMapContextAndEntityToWord mapEaCtW;
-    AggMapEntityToSaCS mapEtSaCS;
-    vector<Id> entitiesInContext;
-    TextRecordIndex currentCid = wep.cids_[0];
-    Score cscore = wep.scores_[0];
-    ad_utility::HashMap<Id, std::set<vector<WordIndex>>> currentCombinedWids;
-    vector<WordIndex> wids;
-    wids.resize(numTerms);
-    for (size_t l = 0; l < numTerms; l++) {
-      AD_CONTRACT_CHECK(wep.wids_[l].size() == wep.cids_.size());
-      wids[l] = wep.wids_[l][0];
+// The aggregation of the postings of the `multVars...` functions of
+// `FTSAlgorithms` per combination of entities (one for each entity variable).
+struct MultVarsAggregation {
+  // The combinations of words for each combination of entities and context.
+  ad_utility::HashMap<std::pair<vector<Id>, TextRecordIndex>,
+                      std::set<vector<WordIndex>>>
+      wordsPerEntitiesAndContext_;
+  // The number of contexts and the top contexts of each combination of
+  // entities.
+  ad_utility::HashMap<vector<Id>, std::pair<size_t, TopContexts>>
+      contextsPerEntities_;
+
+  // Merge the aggregation of other contexts into this one.
+  void merge(MultVarsAggregation&& other, size_t kLimit) {
+    for (auto& [key, words] : other.wordsPerEntitiesAndContext_) {
+      wordsPerEntitiesAndContext_.emplace(key, std::move(words));
     }
-    currentCombinedWids[wep.eids_[0]].insert(wids);
-
-    for (size_t i = 0; i < wep.cids_.size(); ++i) {
-      if (wep.cids_[i] == currentCid) {
-        for (size_t l = 0; l < numTerms; l++) {
-          wids[l] = wep.wids_[l][i];
-        }
-        if (entitiesInContext.empty() ||
-            entitiesInContext.back() != wep.eids_[i]) {
-          entitiesInContext.push_back(wep.eids_[i]);
-        }
-        currentCombinedWids[wep.eids_[i]].insert(wids);
-        // cscore += scores[i];
-      } else {
-        // Calculate a cross product and add/update the map
-        size_t nofPossibilities =
-            static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
-        for (size_t j = 0; j < nofPossibilities; ++j) {
-          vector<Id> key;
-          key.reserve(nofVars);
-          size_t n = j;
-          for (size_t k = 0; k < nofVars; ++k) {
-            key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-            n /= entitiesInContext.size();
-          }
-          for (size_t k = 0; k < nofVars; k++) {
-            for (auto ccw = currentCombinedWids[key[k]].begin();
-                 ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-              mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-            }
-          }
-          if (!mapEtSaCS.contains(key)) {
-            mapEtSaCS[key].second.emplace(cscore, currentCid);
-            mapEtSaCS[key].first = 1;
-          } else {
-            mapEtSaCS[key].first++;
-            ScoreAndContextSet& sacs = mapEtSaCS[key].second;
-            // Make sure that sacs only contains the top k contexts for
-            // wep.eids_[i]
-            if (sacs.size() < kLimit || sacs.begin()->first < cscore) {
-              if (sacs.size() == kLimit) {
-                sacs.erase(*sacs.begin());
-              }
-              sacs.emplace(cscore, currentCid);
-            }
-          }
-        }
-        entitiesInContext.clear();
-        currentCid = wep.cids_[i];
-        cscore = wep.scores_[i];
-        currentCombinedWids.clear();
-        for (size_t l = 0; l < numTerms; l++) {
-          wids[l] = wep.wids_[l][i];
-        }
-        currentCombinedWids[wep.eids_[i]].insert(wids);
-        entitiesInContext.push_back(wep.eids_[i]);
+    for (const auto& [key, countAndContexts] : other.contextsPerEntities_) {
+      auto& [count, topContexts] = contextsPerEntities_[key];
+      count += countAndContexts.first;
+      for (const auto& context : countAndContexts.second) {
+        addToTopContexts(topContexts, context, kLimit);
       }
     }
-    // Deal with the last context
-    // Calculate a cross product and add/update the map
+  }
+};
+
+// Aggregate the postings `[begin, end)` of the `wep` (which must begin and end
+// at the boundaries of contexts) for all the combinations of `nofVars`
+// entities that occur in a context. The first entity of a combination has to
+// fulfill `isFirstEntityAllowed`, the others can be arbitrary.
+template <typename IsFirstEntityAllowed>
+MultVarsAggregation aggregateMultVars(
+    const Index::WordEntityPostings& wep, size_t begin, size_t end,
+    size_t numTerms, size_t nofVars, size_t kLimit,
+    const IsFirstEntityAllowed& isFirstEntityAllowed) {
+  MultVarsAggregation aggregation;
+  vector<Id> entitiesInContext;
+  vector<Id> allowedEntitiesInContext;
+  ad_utility::HashMap<Id, std::set<vector<WordIndex>>> currentCombinedWids;
+  vector<WordIndex> wids(numTerms);
+  Score cscore = 0;
+
+  // Calculate the cross product of the entities of the context and
+  // add/update the aggregation.
+  auto finishContext = [&](TextRecordIndex currentCid) {
+    if (allowedEntitiesInContext.empty()) {
+      return;
+    }
     size_t nofPossibilities =
-        static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
+        nofVars == 0
+            ? 1
+            : allowedEntitiesInContext.size() *
+                  static_cast<size_t>(pow(entitiesInContext.size(),
+                                          static_cast<double>(nofVars - 1)));
     for (size_t j = 0; j < nofPossibilities; ++j) {
       vector<Id> key;
       key.reserve(nofVars);
       size_t n = j;
       for (size_t k = 0; k < nofVars; ++k) {
-        key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-        n /= entitiesInContext.size();
+        const auto& entities =
+            k == 0 ? allowedEntitiesInContext : entitiesInContext;
+        key.push_back(entities[n % entities.size()]);
+        n /= entities.size();
       }
+      auto& words =
+          aggregation.wordsPerEntitiesAndContext_[std::make_pair(key,
+                                                                 currentCid)];
       for (size_t k = 0; k < nofVars; k++) {
-        for (auto ccw = currentCombinedWids[key[k]].begin();
-             ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-          mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-        }
+        const auto& combinedWids = currentCombinedWids[key[k]];
+        words.insert(combinedWids.begin(), combinedWids.end());
       }
-      if (!mapEtSaCS.contains(key)) {
-        mapEtSaCS[key].second.emplace(cscore, currentCid);
-        mapEtSaCS[key].first = 1;
-      } else {
-        mapEtSaCS[key].first++;
-        ScoreAndContextSet& sacs = mapEtSaCS[key].second;
-        // Make sure that sacs only contains the top k contexts for wep.eids_[i]
-        if (sacs.size() < kLimit || sacs.begin()->first < cscore) {
-          if (sacs.size() == kLimit) {
-            sacs.erase(*sacs.begin());
-          }
-          sacs.emplace(cscore, currentCid);
-        }
+      auto& [count, topContexts] = aggregation.contextsPerEntities_[key];
+      ++count;
+      addToTopContexts(topContexts, {cscore, currentCid}, kLimit);
+    }
+  };
+
+  for (size_t i = begin; i < end; ++i) {
+    if (i == begin || wep.cids_[i] != wep.cids_[i - 1]) {
+      if (i != begin) {
+        finishContext(wep.cids_[i - 1]);
       }
+      entitiesInContext.clear();
+      allowedEntitiesInContext.clear();
+      currentCombinedWids.clear();
+      cscore = wep.scores_[i];
     }
-    // Write remaining wep entries into an IdTable
-    IdTableStatic<WIDTH> result = std::move(*dynResult).toStatic<WIDTH>();
-    result.reserve(mapEtSaCS.size() + 2);
-    for (auto it = mapEtSaCS.begin(); it != mapEtSaCS.end(); ++it) {
-      std::vector<ValueId> row;
-      row.resize(result.numColumns());
-      const Id entityScore = Id::makeFromInt(it->second.first);
-      const ScoreAndContextSet& sacs = it->second.second;
-      row[1] = entityScore;
-      for (size_t k = 0; k < nofVars; ++k) {
-        row[k + 2] = it->first[k];  // eid
+    for (size_t l = 0; l < numTerms; l++) {
+      wids[l] = wep.wids_[l][i];
+    }
+    if (entitiesInContext.empty() ||
+        entitiesInContext.back() != wep.eids_[i]) {
+      entitiesInContext.push_back(wep.eids_[i]);
+      if (isFirstEntityAllowed(wep.eids_[i])) {
+        allowedEntitiesInContext.push_back(wep.eids_[i]);
       }
-      for (auto itt = sacs.rbegin(); itt != sacs.rend(); ++itt) {
-        const TextRecordIndex cid = itt->second;
-        row[0] = Id::makeFromTextRecordIndex(cid);
-        for (auto wids = mapEaCtW[std::make_pair(it->first, cid)].begin();
-             wids != mapEaCtW[std::make_pair(it->first, cid)].end(); wids++) {
+    }
+    currentCombinedWids[wep.eids_[i]].insert(wids);
+  }
+  if (begin < end) {
+    finishContext(wep.cids_[end - 1]);
+  }
+  return aggregation;
+}
+
+// Same as `aggregateMultVars`, but large inputs are split into parts of
+// consecutive contexts, which are aggregated concurrently and then merged.
+template <typename IsFirstEntityAllowed>
+MultVarsAggregation aggregateMultVarsConcurrently(
+    const Index::WordEntityPostings& wep, size_t numTerms, size_t nofVars,
+    size_t kLimit, const IsFirstEntityAllowed& isFirstEntityAllowed) {
+  // Only split inputs with enough postings for each thread.
+  constexpr size_t minNumPostingsPerThread = 10'000;
+  size_t numPostings = wep.cids_.size();
+  size_t numThreads = std::clamp(
+      numPostings / minNumPostingsPerThread, size_t{1},
+      std::max(size_t{1},
+               RuntimeParameters().get<"text-aggregation-num-threads">()));
+  // The parts must not split the postings of a context.
+  vector<size_t> boundaries{0};
+  for (size_t t = 1; t < numThreads; ++t) {
+    size_t boundary = std::max(numPostings * t / numThreads, boundaries.back());
+    while (boundary > 0 && boundary < numPostings &&
+           wep.cids_[boundary] == wep.cids_[boundary - 1]) {
+      ++boundary;
+    }
+    boundaries.push_back(boundary);
+  }
+  boundaries.push_back(numPostings);
+
+  vector<MultVarsAggregation> aggregations(numThreads);
+  ad_utility::runConcurrently(numThreads, [&](size_t t) {
+    aggregations[t] =
+        aggregateMultVars(wep, boundaries[t], boundaries[t + 1], numTerms,
+                          nofVars, kLimit, isFirstEntityAllowed);
+  });
+  for (size_t t = 1; t < numThreads; ++t) {
+    aggregations[0].merge(std::move(aggregations[t]), kLimit);
+  }
+  return std::move(aggregations[0]);
+}
+
+// Write the top contexts of each combination of entities of the
+// `aggregation` to the `dynResult`. The first column is the context, the
+// second one the number of contexts of the combination, then follow the
+// entity columns, and then the `numTerms` word columns. `entityColumns(key)`
+// returns the alternatives for the entity columns of the combination `key`,
+// each of which yields separate rows.
+template <int WIDTH, typename EntityColumns>
+void writeMultVarsResult(const MultVarsAggregation& aggregation,
+                         size_t numTerms, const EntityColumns& entityColumns,
+                         IdTable* dynResult) {
+  IdTableStatic<WIDTH> result = std::move(*dynResult).toStatic<WIDTH>();
+  result.reserve(aggregation.contextsPerEntities_.size() + 2);
+  std::vector<ValueId> row(result.numColumns());
+  for (const auto& [key, countAndContexts] :
+       aggregation.contextsPerEntities_) {
+    const auto& [count, topContexts] = countAndContexts;
+    row[1] = Id::makeFromInt(static_cast<int64_t>(count));
+    const vector<vector<Id>> alternatives = entityColumns(key);
+    for (auto it = topContexts.rbegin(); it != topContexts.rend(); ++it) {
+      const TextRecordIndex cid = it->second;
+      row[0] = Id::makeFromTextRecordIndex(cid);
+      const auto& wordCombinations =
+          aggregation.wordsPerEntitiesAndContext_.at(std::make_pair(key, cid));
+      for (const auto& entities : alternatives) {
+        std::ranges::copy(entities, row.begin() + 2);
+        size_t off = 2 + entities.size();
+        for (const auto& wids : wordCombinations) {
           for (size_t l = 0; l < numTerms; l++) {
-            row[2 + nofVars + l] =
-                Id::makeFromWordVocabIndex(WordVocabIndex::make(wids->at(l)));
+            row[off + l] =
+                Id::makeFromWordVocabIndex(WordVocabIndex::make(wids.at(l)));
           }
           result.push_back(row);
         }
       }
     }
-    *dynResult = std::move(result).toDynamic();
-    LOG(DEBUG) << "Done. There are " << dynResult->size() << " tuples now.\n";
   }
+  *dynResult = std::move(result).toDynamic();
+  LOG(DEBUG) << "Done. There are " << dynResult->size() << " tuples now.\n";
+}
+}  // namespace
+
+// _____________________________________________________________________________
+template <int WIDTH>
+void FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts(
+    const WordEntityPostings& wep, size_t nofVars, size_t kLimit,
+    IdTable* dynResult) {
+  AD_CONTRACT_CHECK(wep.wids_.size() >= 1);
+
+  size_t numTerms = dynResult->numColumns() - 2 - nofVars;
+
+  if (wep.cids_.empty()) {
+    return;
+  }
+  // Go over contexts.
+  // For each context build a cross product of the entities.
+  // Keep the top `kLimit` contexts for each combination.
+  LOG(DEBUG) << "Aggregating with " << kLimit << " contexts per entity...\n";
+
+  AD_CONTRACT_CHECK(wep.wids_.size() >= numTerms);
+  for (size_t i = 0; i < numTerms; i++) {
+    AD_CONTRACT_CHECK(wep.wids_[i].size() == wep.cids_.size());
+  }
+  auto aggregation = aggregateMultVarsConcurrently(
+      wep, numTerms, nofVars, kLimit, [](Id) { return true; });
+  writeMultVarsResult<WIDTH>(
+      aggregation, numTerms,
+      [](const vector<Id>& key) { return vector<vector<Id>>{key}; },
+      dynResult);
 }
 
 template void FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts<0>(
@@ -750,150 +824,9 @@ template void FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts<10>(
 template <int WIDTH>
 void FTSAlgorithms::multVarsAggScoresAndTakeTopContext(
     const WordEntityPostings& wep, size_t nofVars, IdTable* dynResult) {
-  AD_CONTRACT_CHECK(wep.wids_.size() >= 1);
-  LOG(DEBUG) << "Special case with 1 contexts per entity...\n";
-
-  size_t numTerms = dynResult->numColumns() - 2 - nofVars;
-
-  AD_CONTRACT_CHECK(wep.wids_.size() >= numTerms);
-  for (size_t i = 0; i < numTerms; i++) {
-    AD_CONTRACT_CHECK(wep.wids_[i].size() == wep.cids_.size());
-  }
-
-  // Go over contexts.
-  // For each context build a cross product of width 2.
-  // Store them in a map, use a pair of id's as key and
-  // an appropriate hash function.
-  using AggMapContextAndEntityToWord =
-      ad_utility::HashMap<std::pair<vector<Id>, TextRecordIndex>,
-                          std::set<vector<WordIndex>>>;
-  using ScoreAndContext = std::pair<Score, TextRecordIndex>;
-  using AggMapEntityToSaC =
-      ad_utility::HashMap<vector<Id>, std::pair<Score, ScoreAndContext>>;
-  AggMapContextAndEntityToWord mapEaCtW;
-  AggMapEntityToSaC mapEtSaC;
-  // Note: vector{k} initializes with a single value k, as opposed to
-  // vector<Id>(k), which initializes a vector with k default constructed
-  // arguments.
-  // TODO<joka921> proper Id types
-  vector<Id> entitiesInContext;
-  TextRecordIndex currentCid = wep.cids_[0];
-  Score cscore = wep.scores_[0];
-  ad_utility::HashMap<Id, std::set<vector<WordIndex>>> currentCombinedWids;
-  vector<WordIndex> wids;
-  wids.resize(numTerms);
-  for (size_t l = 0; l < numTerms; l++) {
-    AD_CONTRACT_CHECK(wep.wids_[l].size() == wep.cids_.size());
-    wids[l] = wep.wids_[l][0];
-  }
-  currentCombinedWids[wep.eids_[0]].insert(wids);
-
-  for (size_t i = 0; i < wep.cids_.size(); ++i) {
-    if (wep.cids_[i] == currentCid) {
-      for (size_t l = 0; l < numTerms; l++) {
-        wids[l] = wep.wids_[l][i];
-      }
-      if (entitiesInContext.empty() ||
-          entitiesInContext.back() != wep.eids_[i]) {
-        entitiesInContext.push_back(wep.eids_[i]);
-      }
-      currentCombinedWids[wep.eids_[i]].insert(wids);
-    } else {
-      // Calculate a cross product and add/update the map
-      size_t nofPossibilities =
-          static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
-      for (size_t j = 0; j < nofPossibilities; ++j) {
-        vector<Id> key;
-        key.reserve(nofVars);
-        size_t n = j;
-        for (size_t k = 0; k < nofVars; ++k) {
-          key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-          n /= entitiesInContext.size();
-        }
-        for (size_t k = 0; k < nofVars; k++) {
-          for (auto ccw = currentCombinedWids[key[k]].begin();
-               ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-            mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-          }
-        }
-        if (!mapEtSaC.contains(key)) {
-          mapEtSaC[key].second = std::make_pair(cscore, currentCid);
-          mapEtSaC[key].first = 1;
-        } else {
-          mapEtSaC[key].first++;
-          ScoreAndContext& sac = mapEtSaC[key].second;
-          // Make sure that sac only contains the top context for
-          // wep.eids_[i]
-          if (sac.first < cscore) {
-            sac = std::make_pair(cscore, currentCid);
-          }
-        }
-      }
-      entitiesInContext.clear();
-      currentCid = wep.cids_[i];
-      cscore = wep.scores_[i];
-      currentCombinedWids.clear();
-      for (size_t l = 0; l < numTerms; l++) {
-        wids[l] = wep.wids_[l][i];
-      }
-      currentCombinedWids[wep.eids_[i]].insert(wids);
-      entitiesInContext.push_back(wep.eids_[i]);
-    }
-  }
-  // Deal with the last context
-  size_t nofPossibilities =
-      static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
-  for (size_t j = 0; j < nofPossibilities; ++j) {
-    vector<Id> key;
-    key.reserve(nofVars);
-    size_t n = j;
-    for (size_t k = 0; k < nofVars; ++k) {
-      key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-      n /= entitiesInContext.size();
-    }
-    for (size_t k = 0; k < nofVars; k++) {
-      for (auto ccw = currentCombinedWids[key[k]].begin();
-           ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-        mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-      }
-    }
-    if (!mapEtSaC.contains(key)) {
-      mapEtSaC[key].second = std::make_pair(cscore, currentCid);
-      mapEtSaC[key].first = 1;
-    } else {
-      mapEtSaC[key].first++;
-      ScoreAndContext& sac = mapEtSaC[key].second;
-      // Make sure that sac only contains the top context for wep.eids_[i]
-      if (sac.first < cscore) {
-        sac = std::make_pair(cscore, currentCid);
-      }
-    }
-  }
-  // Write remaining wep entries into an IdTable
-  IdTableStatic<WIDTH> result = std::move(*dynResult).toStatic<WIDTH>();
-  result.reserve(mapEtSaC.size() + 2);
-  for (auto it = mapEtSaC.begin(); it != mapEtSaC.end(); ++it) {
-    std::vector<ValueId> row;
-    row.resize(result.numColumns());
-    const ScoreAndContext& sac = it->second.second;
-    const Id entityScore = Id::makeFromInt(it->second.first);
-    row[0] = Id::makeFromTextRecordIndex(sac.second);
-    row[1] = entityScore;
-    for (size_t k = 0; k < nofVars; ++k) {
-      row[k + 2] = it->first[k];  // eid
-    }
-    for (auto wids = mapEaCtW[std::make_pair(it->first, sac.second)].begin();
-         wids != mapEaCtW[std::make_pair(it->first, sac.second)].end();
-         wids++) {
-      for (size_t l = 0; l < numTerms; l++) {
-        row[2 + nofVars + l] =
-            Id::makeFromWordVocabIndex(WordVocabIndex::make(wids->at(l)));
-      }
-      result.push_back(row);
-    }
-  }
-  *dynResult = std::move(result).toDynamic();
-  LOG(DEBUG) << "Done. There are " << dynResult->size() << " tuples now.\n";
+  // This is the special case of `multVarsAggScoresAndTakeTopKContexts` with a
+  // single context per combination of entities.
+  multVarsAggScoresAndTakeTopKContexts<WIDTH>(wep, nofVars, 1, dynResult);
 }
 
 template void FTSAlgorithms::multVarsAggScoresAndTakeTopContext<0>(
@@ -1202,182 +1135,23 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
   for (size_t i = 0; i < numTerms; i++) {
     AD_CONTRACT_CHECK(wep.wids_[i].size() == wep.cids_.size());
   }
-
-  // Go over contexts.
-  // For each context build a cross product with one part being from the filter.
-  // Store them in a map, use a pair of id's as key and
-  // an appropriate hash function.
-  // Use a set (ordered) and keep it at size kLimit for the context scores.
-  LOG(DEBUG) << "Heap-using case with " << kLimit
-             << " contexts per entity...\n";
-  using AggMapContextAndEntityToWord =
-      ad_utility::HashMap<std::pair<vector<Id>, TextRecordIndex>,
-                          std::set<vector<WordIndex>>>;
-  using ScoreAndContextSet = std::set<std::pair<Score, TextRecordIndex>>;
-  using AggMapEntityToSaCS =
-      ad_utility::HashMap<vector<Id>, std::pair<Score, ScoreAndContextSet>>;
-  AggMapContextAndEntityToWord mapEaCtW;
-  AggMapEntityToSaCS mapEtSaCS;
-  vector<Id> entitiesInContext;
-  vector<Id> filteredEntitiesInContext;
-  TextRecordIndex currentCid = wep.cids_[0];
-  Score cscore = wep.scores_[0];
-  ad_utility::HashMap<Id, std::set<vector<WordIndex>>> currentCombinedWids;
-  vector<WordIndex> wids;
-  wids.resize(numTerms);
-  for (size_t l = 0; l < numTerms; l++) {
-    AD_CONTRACT_CHECK(wep.wids_[l].size() == wep.cids_.size());
-    wids[l] = wep.wids_[l][0];
-  }
-  currentCombinedWids[wep.eids_[0]].insert(wids);
-
-  for (size_t i = 0; i < wep.cids_.size(); ++i) {
-    if (wep.cids_[i] == currentCid) {
-      for (size_t l = 0; l < numTerms; l++) {
-        wids[l] = wep.wids_[l][i];
-      }
-      if (entitiesInContext.empty() ||
-          entitiesInContext.back() != wep.eids_[i]) {
-        if (fMap.contains(wep.eids_[i])) {
-          filteredEntitiesInContext.push_back(wep.eids_[i]);
-        }
-        entitiesInContext.push_back(wep.eids_[i]);
-      }
-      currentCombinedWids[wep.eids_[i]].insert(wids);
-      // cscore += scores[i];
-    } else {
-      if (!filteredEntitiesInContext.empty()) {
-        // Calculate a cross product and add/update the map
-        size_t nofPossibilities =
-            filteredEntitiesInContext.size() *
-            static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
-        for (size_t j = 0; j < nofPossibilities; ++j) {
-          vector<Id> key;
-          key.reserve(nofVars);
-          size_t n = j;
-          key.push_back(
-              filteredEntitiesInContext[n % filteredEntitiesInContext.size()]);
-          n /= filteredEntitiesInContext.size();
-          for (size_t k = 1; k < nofVars; ++k) {
-            key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-            n /= entitiesInContext.size();
-          }
-          for (size_t k = 0; k < nofVars; k++) {
-            for (auto ccw = currentCombinedWids[key[k]].begin();
-                 ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-              mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-            }
-          }
-          if (!mapEtSaCS.contains(key)) {
-            mapEtSaCS[key].second.emplace(cscore, currentCid);
-            mapEtSaCS[key].first = 1;
-          } else {
-            mapEtSaCS[key].first++;
-            ScoreAndContextSet& sacs = mapEtSaCS[key].second;
-            // Make sure that sacs only contains the top k contexts for
-            // wep.eids_[i]
-            if (sacs.size() < kLimit || sacs.begin()->first < cscore) {
-              if (sacs.size() == kLimit) {
-                sacs.erase(*sacs.begin());
-              }
-              sacs.emplace(cscore, currentCid);
-            }
-          }
-        }
-      }
-      entitiesInContext.clear();
-      filteredEntitiesInContext.clear();
-      currentCid = wep.cids_[i];
-      cscore = wep.scores_[i];
-      currentCombinedWids.clear();
-      for (size_t l = 0; l < numTerms; l++) {
-        wids[l] = wep.wids_[l][i];
-      }
-      currentCombinedWids[wep.eids_[i]].insert(wids);
-      entitiesInContext.push_back(wep.eids_[i]);
-      if (fMap.contains(wep.eids_[i])) {
-        filteredEntitiesInContext.push_back(wep.eids_[i]);
-      }
-    }
-  }
-  // Deal with the last context
-  if (!filteredEntitiesInContext.empty()) {
-    // Calculate a cross product and add/update the map
-    size_t nofPossibilities =
-        filteredEntitiesInContext.size() *
-        static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
-    for (size_t j = 0; j < nofPossibilities; ++j) {
-      vector<Id> key;
-      key.reserve(nofVars);
-      size_t n = j;
-      key.push_back(
-          filteredEntitiesInContext[n % filteredEntitiesInContext.size()]);
-      n /= filteredEntitiesInContext.size();
-      for (size_t k = 1; k < nofVars; ++k) {
-        key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-        n /= entitiesInContext.size();
-      }
-      for (size_t k = 0; k < nofVars; k++) {
-        for (auto ccw = currentCombinedWids[key[k]].begin();
-             ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-          mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-        }
-      }
-      if (!mapEtSaCS.contains(key)) {
-        mapEtSaCS[key].second.emplace(cscore, currentCid);
-        mapEtSaCS[key].first = 1;
-      } else {
-        mapEtSaCS[key].first++;
-        ScoreAndContextSet& sacs = mapEtSaCS[key].second;
-        // Make sure that sacs only contains the top k contexts for wep.eids_[i]
-        if (sacs.size() < kLimit || sacs.begin()->first < cscore) {
-          if (sacs.size() == kLimit) {
-            sacs.erase(*sacs.begin());
-          }
-          sacs.emplace(cscore, currentCid);
-        }
+  // The first entity of each combination has to be contained in the `fMap`.
+  auto aggregation = aggregateMultVarsConcurrently(
+      wep, numTerms, nofVars, kLimit,
+      [&fMap](Id entity) { return fMap.contains(entity); });
+  // The rows of the `fMap` for the first entity replace it in the result.
+  auto entityColumns = [&fMap](const vector<Id>& key) {
+    vector<vector<Id>> alternatives;
+    for (const auto& fRow : fMap.find(key[0])->second) {
+      vector<Id>& entities = alternatives.emplace_back(key.begin() + 1,
+                                                       key.end());
+      for (size_t i = 0; i < fRow.numColumns(); i++) {
+        entities.push_back(fRow[i]);
       }
     }
-  }
-
-  // Write remaining wep entries into an IdTable
-  IdTableStatic<WIDTH> result = std::move(*dynResult).toStatic<WIDTH>();
-  result.reserve(mapEtSaCS.size() + 2);
-  for (auto it = mapEtSaCS.begin(); it != mapEtSaCS.end(); ++it) {
-    std::vector<ValueId> row;
-    row.resize(result.numColumns());
-    const Id entityScore = Id::makeFromInt(it->second.first);
-    const vector<Id>& keyEids = it->first;
-    const IdTable& filterRows = fMap.find(keyEids[0])->second;
-    const ScoreAndContextSet& sacs = it->second.second;
-
-    for (auto itt = sacs.rbegin(); itt != sacs.rend(); ++itt) {
-      for (auto fRow : filterRows) {
-        const TextRecordIndex cid = itt->second;
-        size_t off = 2;
-        row[0] = Id::makeFromTextRecordIndex(cid);
-        row[1] = entityScore;
-        for (size_t i = 1; i < keyEids.size(); i++) {
-          row[off] = keyEids[i];
-          off++;
-        }
-        for (size_t i = 0; i < fRow.numColumns(); i++) {
-          row[off] = fRow[i];
-          off++;
-        }
-        for (auto wids = mapEaCtW[std::make_pair(it->first, cid)].begin();
-             wids != mapEaCtW[std::make_pair(it->first, cid)].end(); wids++) {
-          for (size_t l = 0; l < numTerms; l++) {
-            row[off + l] =
-                Id::makeFromWordVocabIndex(WordVocabIndex::make(wids->at(l)));
-          }
-          result.push_back(row);
-        }
-      }
-    }
-  }
-  *dynResult = std::move(result).toDynamic();
-  LOG(DEBUG) << "Done. There are " << dynResult->size() << " tuples now.\n";
+    return alternatives;
+  };
+  writeMultVarsResult<WIDTH>(aggregation, numTerms, entityColumns, dynResult);
 }
 
 template void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts<0>(
@@ -1435,175 +1209,17 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
   for (size_t i = 0; i < numTerms; i++) {
     AD_CONTRACT_CHECK(wep.wids_[i].size() == wep.cids_.size());
   }
-
-  // Go over contexts.
-  // For each context build a cross product with one part being from the filter.
-  // Store them in a map, use a pair of id's as key and
-  // an appropriate hash function.
-  // Use a set (ordered) and keep it at size kLimit for the context scores.
-  LOG(DEBUG) << "Heap-using case with " << kLimit
-             << " contexts per entity...\n";
-  using AggMapContextAndEntityToWord =
-      ad_utility::HashMap<std::pair<vector<Id>, TextRecordIndex>,
-                          std::set<vector<WordIndex>>>;
-  using ScoreAndContextSet = std::set<std::pair<Score, TextRecordIndex>>;
-  using AggMapEntityToSaCS =
-      ad_utility::HashMap<vector<Id>, std::pair<Score, ScoreAndContextSet>>;
-  AggMapContextAndEntityToWord mapEaCtW;
-  AggMapEntityToSaCS mapEtSaCS;
-  vector<Id> entitiesInContext;
-  vector<Id> filteredEntitiesInContext;
-  TextRecordIndex currentCid = wep.cids_[0];
-  Score cscore = wep.scores_[0];
-  ad_utility::HashMap<Id, std::set<vector<WordIndex>>> currentCombinedWids;
-  vector<WordIndex> wids;
-  wids.resize(numTerms);
-  for (size_t l = 0; l < numTerms; l++) {
-    AD_CONTRACT_CHECK(wep.wids_[l].size() == wep.cids_.size());
-    wids[l] = wep.wids_[l][0];
-  }
-  currentCombinedWids[wep.eids_[0]].insert(wids);
-
-  for (size_t i = 0; i < wep.cids_.size(); ++i) {
-    if (wep.cids_[i] == currentCid) {
-      for (size_t l = 0; l < numTerms; l++) {
-        wids[l] = wep.wids_[l][i];
-      }
-      if (entitiesInContext.empty() ||
-          entitiesInContext.back() != wep.eids_[i]) {
-        if (fSet.contains(wep.eids_[i])) {
-          filteredEntitiesInContext.push_back(wep.eids_[i]);
-        }
-        entitiesInContext.push_back(wep.eids_[i]);
-      }
-      currentCombinedWids[wep.eids_[i]].insert(wids);
-      // cscore += scores[i];
-    } else {
-      if (!filteredEntitiesInContext.empty()) {
-        // Calculate a cross product and add/update the map
-        size_t nofPossibilities =
-            filteredEntitiesInContext.size() *
-            static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
-        for (size_t j = 0; j < nofPossibilities; ++j) {
-          vector<Id> key;
-          key.reserve(nofVars);
-          size_t n = j;
-          key.push_back(
-              filteredEntitiesInContext[n % filteredEntitiesInContext.size()]);
-          n /= filteredEntitiesInContext.size();
-          for (size_t k = 1; k < nofVars; ++k) {
-            key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-            n /= entitiesInContext.size();
-          }
-          for (size_t k = 0; k < nofVars; k++) {
-            for (auto ccw = currentCombinedWids[key[k]].begin();
-                 ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-              mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-            }
-          }
-          if (!mapEtSaCS.contains(key)) {
-            mapEtSaCS[key].second.emplace(cscore, currentCid);
-            mapEtSaCS[key].first = 1;
-          } else {
-            mapEtSaCS[key].first++;
-            ScoreAndContextSet& sacs = mapEtSaCS[key].second;
-            // Make sure that sacs only contains the top k contexts for
-            // wep.eids_[i]
-            if (sacs.size() < kLimit || sacs.begin()->first < cscore) {
-              if (sacs.size() == kLimit) {
-                sacs.erase(*sacs.begin());
-              }
-              sacs.emplace(cscore, currentCid);
-            }
-          }
-        }
-      }
-      entitiesInContext.clear();
-      filteredEntitiesInContext.clear();
-      currentCid = wep.cids_[i];
-      cscore = wep.scores_[i];
-      currentCombinedWids.clear();
-      for (size_t l = 0; l < numTerms; l++) {
-        wids[l] = wep.wids_[l][i];
-      }
-      currentCombinedWids[wep.eids_[i]].insert(wids);
-      entitiesInContext.push_back(wep.eids_[i]);
-      if (fSet.contains(wep.eids_[i])) {
-        filteredEntitiesInContext.push_back(wep.eids_[i]);
-      }
-    }
-  }
-  // Deal with the last context
-  if (!filteredEntitiesInContext.empty()) {
-    // Calculate a cross product and add/update the map
-    size_t nofPossibilities =
-        filteredEntitiesInContext.size() *
-        static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
-    for (size_t j = 0; j < nofPossibilities; ++j) {
-      vector<Id> key;
-      key.reserve(nofVars);
-      size_t n = j;
-      key.push_back(
-          filteredEntitiesInContext[n % filteredEntitiesInContext.size()]);
-      n /= filteredEntitiesInContext.size();
-      for (size_t k = 1; k < nofVars; ++k) {
-        key.push_back(entitiesInContext[n % entitiesInContext.size()]);
-        n /= entitiesInContext.size();
-      }
-      for (size_t k = 0; k < nofVars; k++) {
-        for (auto ccw = currentCombinedWids[key[k]].begin();
-             ccw != currentCombinedWids[key[k]].end(); ++ccw) {
-          mapEaCtW[std::make_pair(key, currentCid)].insert(*ccw);
-        }
-      }
-      if (!mapEtSaCS.contains(key)) {
-        mapEtSaCS[key].second.emplace(cscore, currentCid);
-        mapEtSaCS[key].first = 1;
-      } else {
-        mapEtSaCS[key].first++;
-        ScoreAndContextSet& sacs = mapEtSaCS[key].second;
-        // Make sure that sacs only contains the top k contexts for wep.eids_[i]
-        if (sacs.size() < kLimit || sacs.begin()->first < cscore) {
-          if (sacs.size() == kLimit) {
-            sacs.erase(*sacs.begin());
-          }
-          sacs.emplace(cscore, currentCid);
-        }
-      }
-    }
-  }
-
-  // Write remaining wep entries into an IdTable
-  IdTableStatic<WIDTH> result = std::move(*dynResult).toStatic<WIDTH>();
-  result.reserve(mapEtSaCS.size() + 2);
-  for (auto it = mapEtSaCS.begin(); it != mapEtSaCS.end(); ++it) {
-    std::vector<ValueId> row;
-    row.resize(result.numColumns());
-    const ScoreAndContextSet& sacs = it->second.second;
-    row[1] = Id::makeFromInt(it->second.first);
-    const vector<Id>& keyEids = it->first;
-    size_t off = 2;
-    for (size_t i = 1; i < keyEids.size(); i++) {
-      row[off] = keyEids[i];
-      off++;
-    }
-    row[off] = keyEids[0];
-    off++;
-    for (auto itt = sacs.rbegin(); itt != sacs.rend(); ++itt) {
-      const TextRecordIndex cid = itt->second;
-      row[0] = Id::makeFromTextRecordIndex(cid);
-      for (auto wids = mapEaCtW[std::make_pair(it->first, cid)].begin();
-           wids != mapEaCtW[std::make_pair(it->first, cid)].end(); wids++) {
-        for (size_t l = 0; l < numTerms; l++) {
-          row[off + l] =
-              Id::makeFromWordVocabIndex(WordVocabIndex::make(wids->at(l)));
-        }
-        result.push_back(row);
-      }
-    }
-  }
-  *dynResult = std::move(result).toDynamic();
-  LOG(DEBUG) << "Done. There are " << dynResult->size() << " tuples now.\n";
+  // The first entity of each combination has to be contained in the `fSet`.
+  auto aggregation = aggregateMultVarsConcurrently(
+      wep, numTerms, nofVars, kLimit,
+      [&fSet](Id entity) { return fSet.contains(entity); });
+  // The first entity is the last entity column of the result.
+  auto entityColumns = [](const vector<Id>& key) {
+    vector<Id> entities(key.begin() + 1, key.end());
+    entities.push_back(key[0]);
+    return vector<vector<Id>>{std::move(entities)};
+  };
+  writeMultVarsResult<WIDTH>(aggregation, numTerms, entityColumns, dynResult);
 }
 
 template void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts<0>(
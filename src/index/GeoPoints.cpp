@@ -0,0 +1,62 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/GeoPoints.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/Exception.h"
+#include "util/GeoSparqlHelpers.h"
+#include "util/Serializer/FileSerializer.h"
+
+// _____________________________________________________________________________
+auto GeoPoints::parseWord(std::string_view word) -> std::optional<Point> {
+  auto closingQuote = word.rfind('"');
+  if (!word.starts_with('"') || closingQuote == 0 ||
+      closingQuote == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto point =
+      ad_utility::detail::parseWktPoint(word.substr(1, closingQuote - 1));
+  if (std::isnan(point.first) || std::isnan(point.second)) {
+    return std::nullopt;
+  }
+  return point;
+}
+
+// _____________________________________________________________________________
+void GeoPoints::add(VocabIndex index, Point point) {
+  AD_CONTRACT_CHECK(indices_.empty() || indices_.back() < index.get());
+  indices_.push_back(index.get());
+  longitudes_.push_back(point.first);
+  latitudes_.push_back(point.second);
+}
+
+// _____________________________________________________________________________
+auto GeoPoints::get(VocabIndex index) const -> std::optional<Point> {
+  auto it = std::ranges::lower_bound(indices_, index.get());
+  if (it == indices_.end() || *it != index.get()) {
+    return std::nullopt;
+  }
+  size_t i = it - indices_.begin();
+  return Point{longitudes_[i], latitudes_[i]};
+}
+
+// _____________________________________________________________________________
+void GeoPoints::writeToFile(const std::string& filename) const {
+  ad_utility::serialization::FileWriteSerializer serializer{filename};
+  serializer << indices_;
+  serializer << longitudes_;
+  serializer << latitudes_;
+}
+
+// _____________________________________________________________________________
+GeoPoints GeoPoints::readFromFile(const std::string& filename) {
+  ad_utility::serialization::FileReadSerializer serializer{filename};
+  GeoPoints result;
+  serializer >> result.indices_;
+  serializer >> result.longitudes_;
+  serializer >> result.latitudes_;
+  return result;
+}
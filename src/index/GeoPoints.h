@@ -0,0 +1,59 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+// The coordinates of the WKT points (e.g.
+// `"POINT(7.85 47.99)"^^geo:wktLiteral`) that are stored in the vocabulary.
+// They are parsed once during the index build if `geo-points` is set in the
+// settings JSON, s.t. the `SpatialJoin` doesn't have to look up and parse the
+// strings at query time.
+class GeoPoints {
+ public:
+  // The points are written to the file with this suffix.
+  static constexpr std::string_view FILE_SUFFIX = ".vocabulary.geo-points";
+
+  // The longitude and the latitude of a point.
+  using Point = std::pair<double, double>;
+
+ private:
+  // The vocabulary indices of the words that are points (sorted) and their
+  // coordinates in two packed columns.
+  std::vector<uint64_t> indices_;
+  std::vector<double> longitudes_;
+  std::vector<double> latitudes_;
+
+ public:
+  // Parse a `word` of the vocabulary that is a literal, the lexical form of
+  // which is a WKT point. Return `std::nullopt` for all other words.
+  static std::optional<Point> parseWord(std::string_view word);
+
+  // Add the `point` of the word with the `index`. The indices have to be added
+  // in increasing order.
+  void add(VocabIndex index, Point point);
+
+  // Return the point of the word with the `index`, or `std::nullopt` if the
+  // word is no point.
+  std::optional<Point> get(VocabIndex index) const;
+
+  // The number of words that are points.
+  size_t size() const { return indices_.size(); }
+  bool empty() const { return indices_.empty(); }
+
+  // Write the points to the `filename`.
+  void writeToFile(const std::string& filename) const;
+
+  // Read the points that were written by `writeToFile` from the `filename`.
+  static GeoPoints readFromFile(const std::string& filename);
+};
@@ -24,6 +24,11 @@ void Index::createFromFile(const std::string& filename) {
   pimpl_->createFromFile(filename);
 }
 
+// ____________________________________________________________________________
+void Index::createFromFiles(const std::vector<std::string>& filenames) {
+  pimpl_->createFromFiles(filenames);
+}
+
 // ____________________________________________________________________________
 void Index::createFromOnDiskIndex(const std::string& onDiskBase) {
   pimpl_->createFromOnDiskIndex(onDiskBase);
@@ -88,7 +93,7 @@ std::pair<Id, Id> Index::prefix_range(const std::string& prefix) const {
 }
 
 // ____________________________________________________________________________
-const vector<PatternID>& Index::getHasPattern() const {
+const CompressedPatternIds& Index::getHasPattern() const {
   return pimpl_->getHasPattern();
 }
 
@@ -102,6 +107,47 @@ const CompactVectorOfStrings<Id>& Index::getPatterns() const {
   return pimpl_->getPatterns();
 }
 
+// ____________________________________________________________________________
+const CharacteristicSets& Index::getCharacteristicSets() const {
+  return pimpl_->getCharacteristicSets();
+}
+
+// ____________________________________________________________________________
+const TransitiveClosures& Index::getTransitiveClosures() const {
+  return pimpl_->getTransitiveClosures();
+}
+
+// ____________________________________________________________________________
+const VocabularyValues& Index::getVocabularyValues() const {
+  return pimpl_->getVocabularyValues();
+}
+
+// ____________________________________________________________________________
+const GeoPoints& Index::getGeoPoints() const { return pimpl_->getGeoPoints(); }
+
+// ____________________________________________________________________________
+const TrigramIndex& Index::getTrigramIndex() const {
+  return pimpl_->getTrigramIndex();
+}
+
+// ____________________________________________________________________________
+const PredicateHistograms& Index::getPredicateHistograms() const {
+  return pimpl_->getPredicateHistograms();
+}
+
+// ____________________________________________________________________________
+const PatternTrickAggregates& Index::getPatternTrickAggregates() const {
+  return pimpl_->getPatternTrickAggregates();
+}
+
+// ____________________________________________________________________________
+DeltaTriples& Index::deltaTriples() { return pimpl_->deltaTriples(); }
+
+// ____________________________________________________________________________
+const DeltaTriples& Index::deltaTriples() const {
+  return pimpl_->deltaTriples();
+}
+
 // ____________________________________________________________________________
 double Index::getAvgNumDistinctPredicatesPerSubject() const {
   return pimpl_->getAvgNumDistinctPredicatesPerSubject();
@@ -186,6 +232,13 @@ IdTable Index::getWordPostingsForTerm(
   return pimpl_->getWordPostingsForTerm(term, allocator);
 }
 
+// ____________________________________________________________________________
+cppcoro::generator<IdTable> Index::getWordPostingsForTermLazily(
+    const std::string& term,
+    const ad_utility::AllocatorWithLimit<Id>& allocator) const {
+  return pimpl_->getWordPostingsForTermLazily(term, allocator);
+}
+
 // ____________________________________________________________________________
 Index::WordEntityPostings Index::getEntityPostingsForTerm(
     const std::string& term) const {
@@ -199,6 +252,13 @@ IdTable Index::getEntityMentionsForWord(
   return pimpl_->getEntityMentionsForWord(term, allocator);
 }
 
+// ____________________________________________________________________________
+cppcoro::generator<IdTable> Index::getEntityMentionsForWordLazily(
+    const string& term,
+    const ad_utility::AllocatorWithLimit<Id>& allocator) const {
+  return pimpl_->getEntityMentionsForWordLazily(term, allocator);
+}
+
 // ____________________________________________________________________________
 size_t Index::getIndexOfBestSuitedElTerm(const vector<string>& terms) const {
   return pimpl_->getIndexOfBestSuitedElTerm(terms);
@@ -209,6 +269,12 @@ std::string Index::getTextExcerpt(TextRecordIndex cid) const {
   return pimpl_->getTextExcerpt(cid);
 }
 
+// ____________________________________________________________________________
+std::vector<std::string> Index::getTextExcerpts(
+    std::span<const TextRecordIndex> cids) const {
+  return pimpl_->getTextExcerpts(cids);
+}
+
 // ____________________________________________________________________________
 float Index::getAverageNofEntityContexts() const {
   return pimpl_->getAverageNofEntityContexts();
@@ -230,11 +296,21 @@ bool& Index::usePatterns() { return pimpl_->usePatterns(); }
 // ____________________________________________________________________________
 bool& Index::loadAllPermutations() { return pimpl_->loadAllPermutations(); }
 
+// ____________________________________________________________________________
+bool& Index::inMemoryBuildIfPossible() {
+  return pimpl_->inMemoryBuildIfPossible();
+}
+
 // ____________________________________________________________________________
 void Index::setKeepTempFiles(bool keepTempFiles) {
   return pimpl_->setKeepTempFiles(keepTempFiles);
 }
 
+// ____________________________________________________________________________
+void Index::setResumeBuild(bool resumeBuild) {
+  return pimpl_->setResumeBuild(resumeBuild);
+}
+
 // ____________________________________________________________________________
 ad_utility::MemorySize& Index::memoryLimitIndexBuilding() {
   return pimpl_->memoryLimitIndexBuilding();
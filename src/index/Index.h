@@ -7,20 +7,31 @@
 
 #include <array>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "global/Id.h"
+#include "index/CompressedPatternIds.h"
 #include "index/CompressedString.h"
 #include "index/Permutation.h"
 #include "index/StringSortComparator.h"
 #include "index/Vocabulary.h"
 #include "parser/TripleComponent.h"
 #include "util/CancellationHandle.h"
+#include "util/Generator.h"
 
 // Forward declarations.
 class IdTable;
 class TextBlockMetaData;
+class CharacteristicSets;
+class TransitiveClosures;
+class VocabularyValues;
+class GeoPoints;
+class TrigramIndex;
+class PredicateHistograms;
+class PatternTrickAggregates;
+class DeltaTriples;
 class IndexImpl;
 
 class Index {
@@ -75,6 +86,11 @@ class Index {
   // setup by `createFromOnDiskIndex` after this call.
   void createFromFile(const std::string& filename);
 
+  // Same as `createFromFile`, but the triples are read from several files,
+  // which are parsed concurrently (see `MultiFileTurtleParser`). The prefixes
+  // that are declared in one of the files only apply to this file.
+  void createFromFiles(const std::vector<std::string>& filenames);
+
   // Create an index object from an on-disk index that has previously been
   // constructed using the `createFromFile` method which is typically called via
   // `IndexBuilderMain`. Read necessary metadata into memory and open file
@@ -131,9 +147,34 @@ class Index {
 
   [[nodiscard]] std::pair<Id, Id> prefix_range(const std::string& prefix) const;
 
-  [[nodiscard]] const vector<PatternID>& getHasPattern() const;
+  [[nodiscard]] const CompressedPatternIds& getHasPattern() const;
   [[nodiscard]] const CompactVectorOfStrings<Id>& getHasPredicate() const;
   [[nodiscard]] const CompactVectorOfStrings<Id>& getPatterns() const;
+  // The statistics for the size estimates of star-shaped joins (see
+  // `CharacteristicSets`).
+  [[nodiscard]] const CharacteristicSets& getCharacteristicSets() const;
+  // The precomputed transitive closures of selected predicates (see
+  // `TransitiveClosures`).
+  [[nodiscard]] const TransitiveClosures& getTransitiveClosures() const;
+  // The values of the numeric and date literals in the vocabulary (see
+  // `VocabularyValues`).
+  [[nodiscard]] const VocabularyValues& getVocabularyValues() const;
+  // The coordinates of the WKT points in the vocabulary (see `GeoPoints`).
+  [[nodiscard]] const GeoPoints& getGeoPoints() const;
+  // The trigram index of the literals in the vocabulary (see `TrigramIndex`).
+  [[nodiscard]] const TrigramIndex& getTrigramIndex() const;
+  // The histograms of the objects of the predicates (see
+  // `PredicateHistograms`).
+  [[nodiscard]] const PredicateHistograms& getPredicateHistograms() const;
+  // The precomputed results of the pattern trick for the subjects of large
+  // groups of triples with the same predicate and object (see
+  // `PatternTrickAggregates`).
+  [[nodiscard]] const PatternTrickAggregates& getPatternTrickAggregates()
+      const;
+  // The triples that were inserted or deleted after the index was built (see
+  // `DeltaTriples`).
+  DeltaTriples& deltaTriples();
+  [[nodiscard]] const DeltaTriples& deltaTriples() const;
   /**
    * @return The multiplicity of the entites column (0) of the full has-relation
    *         relation after unrolling the patterns.
@@ -193,16 +234,32 @@ class Index {
       const std::string& term,
       const ad_utility::AllocatorWithLimit<Id>& allocator) const;
 
+  // The lazy version of `getWordPostingsForTerm`, which yields the postings in
+  // blocks that are sorted by the text record.
+  cppcoro::generator<IdTable> getWordPostingsForTermLazily(
+      const std::string& term,
+      const ad_utility::AllocatorWithLimit<Id>& allocator) const;
+
   WordEntityPostings getEntityPostingsForTerm(const std::string& term) const;
 
   IdTable getEntityMentionsForWord(
       const string& term,
       const ad_utility::AllocatorWithLimit<Id>& allocator) const;
 
+  // The lazy version of `getEntityMentionsForWord`.
+  cppcoro::generator<IdTable> getEntityMentionsForWordLazily(
+      const string& term,
+      const ad_utility::AllocatorWithLimit<Id>& allocator) const;
+
   size_t getIndexOfBestSuitedElTerm(const vector<string>& terms) const;
 
   [[nodiscard]] std::string getTextExcerpt(TextRecordIndex cid) const;
 
+  // Get the excerpts of all the `cids` at once (in the same order), which is
+  // much cheaper than calling `getTextExcerpt` for each of them.
+  [[nodiscard]] std::vector<std::string> getTextExcerpts(
+      std::span<const TextRecordIndex> cids) const;
+
   // Only for debug reasons and external encoding tests.
   // Supply an empty vector to dump all lists above a size threshold.
   void dumpAsciiLists(const vector<std::string>& lists,
@@ -220,8 +277,15 @@ class Index {
 
   bool& loadAllPermutations();
 
+  // Build the index in memory if the input is small enough (the default).
+  bool& inMemoryBuildIfPossible();
+
   void setKeepTempFiles(bool keepTempFiles);
 
+  // Skip the stages of the index build that a previous build with the same
+  // input files and settings has completed, e.g. after it was killed.
+  void setResumeBuild(bool resumeBuild);
+
   ad_utility::MemorySize& memoryLimitIndexBuilding();
   const ad_utility::MemorySize& memoryLimitIndexBuilding() const;
 
@@ -0,0 +1,75 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/IndexBuildManifest.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <filesystem>
+
+#include "util/File.h"
+#include "util/Log.h"
+
+// _____________________________________________________________________________
+IndexBuildManifest::IndexBuildManifest(const std::string& onDiskBase,
+                                       nlohmann::json buildKey, bool resume)
+    : filename_{absl::StrCat(onDiskBase, FILE_SUFFIX)},
+      buildKey_{std::move(buildKey)} {
+  // A manifest that is not used is deleted, s.t. it can't be used by a later
+  // build after this build has overwritten some of the files of the index.
+  if (!resume) {
+    remove();
+    return;
+  }
+  if (!std::filesystem::exists(filename_)) {
+    LOG(INFO) << "No manifest of a previous index build found, the index is "
+                 "built from scratch"
+              << std::endl;
+    return;
+  }
+  nlohmann::json manifest;
+  auto file = ad_utility::makeIfstream(filename_);
+  file >> manifest;
+  if (manifest.value("build-key", nlohmann::json{}) != buildKey_) {
+    LOG(WARN) << "The input files or settings of the previous index build were "
+                 "different, the index is built from scratch"
+              << std::endl;
+    remove();
+    return;
+  }
+  completedStages_ =
+      manifest.value("completed-stages", std::vector<std::string>{});
+  for (const auto& stage : completedStages_) {
+    LOG(INFO) << "The stage \"" << stage
+              << "\" was completed by a previous index build and is skipped"
+              << std::endl;
+  }
+}
+
+// _____________________________________________________________________________
+bool IndexBuildManifest::isCompleted(std::string_view stage) const {
+  return std::ranges::find(completedStages_, stage) != completedStages_.end();
+}
+
+// _____________________________________________________________________________
+void IndexBuildManifest::markCompleted(std::string_view stage) {
+  if (isCompleted(stage)) {
+    return;
+  }
+  completedStages_.emplace_back(stage);
+  nlohmann::json manifest;
+  manifest["build-key"] = buildKey_;
+  manifest["completed-stages"] = completedStages_;
+  std::string tmpFilename = absl::StrCat(filename_, ".tmp");
+  {
+    auto file = ad_utility::makeOfstream(tmpFilename);
+    file << manifest.dump(2) << std::endl;
+  }
+  std::filesystem::rename(tmpFilename, filename_);
+}
+
+// _____________________________________________________________________________
+void IndexBuildManifest::remove() const {
+  ad_utility::deleteFile(filename_, false);
+}
@@ -0,0 +1,50 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/json.h"
+
+// The manifest of the stages of an index build that are completed, which is
+// stored in a JSON file next to the index. When an index build is resumed (see
+// `IndexImpl::createFromFiles`), the completed stages are skipped. A stage is
+// only marked as completed after all of its files have been written.
+//
+// The manifest also stores a `buildKey` (the input files and the settings of
+// the build), and its stages are only used by a build with the same key, s.t.
+// a changed input or setting always leads to a complete build.
+class IndexBuildManifest {
+ public:
+  static constexpr std::string_view FILE_SUFFIX = ".index-build-manifest.json";
+
+ private:
+  std::string filename_;
+  nlohmann::json buildKey_;
+  std::vector<std::string> completedStages_;
+
+ public:
+  // The manifest of the index with the `onDiskBase`. If `resume` is true and
+  // the manifest file exists and has the same `buildKey`, its completed stages
+  // are read. Otherwise the manifest starts without completed stages, and an
+  // existing manifest file is deleted.
+  IndexBuildManifest(const std::string& onDiskBase, nlohmann::json buildKey,
+                     bool resume);
+
+  bool isCompleted(std::string_view stage) const;
+
+  // Mark the `stage` as completed and write the manifest file. The file is
+  // first written to a temporary file and then renamed, s.t. a crash during
+  // the writing leaves the previous manifest intact.
+  void markCompleted(std::string_view stage);
+
+  // Delete the manifest file (after the index build is completed).
+  void remove() const;
+
+  const std::vector<std::string>& completedStages() const {
+    return completedStages_;
+  }
+};
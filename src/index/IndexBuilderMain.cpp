@@ -9,8 +9,10 @@
 #include <exception>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "CompilationInfo.h"
+#include "absl/strings/str_join.h"
 #include "global/Constants.h"
 #include "index/ConstantsIndexBuilding.h"
 #include "index/Index.h"
@@ -68,11 +70,13 @@ int main(int argc, char** argv) {
   string kbIndexName;
   string settingsFile;
   string filetype;
-  string inputFile;
+  std::vector<string> inputFiles;
   bool noPrefixCompression = false;
   bool noPatterns = false;
   bool onlyAddTextIndex = false;
   bool keepTemporaryFiles = false;
+  bool resumeBuild = false;
+  bool noInMemoryBuild = false;
   bool onlyPsoAndPos = false;
   bool addWordsFromLiterals = false;
   std::optional<ad_utility::MemorySize> stxxlMemory;
@@ -88,15 +92,18 @@ int main(int argc, char** argv) {
   add("help,h", "Produce this help message.");
   add("index-basename,i", po::value(&baseName)->required(),
       "The basename of the output files (required).");
-  add("kg-input-file,f", po::value(&inputFile),
-      "The file with the knowledge graph data to be parsed from. If omitted, "
-      "will read from stdin.");
+  add("kg-input-file,f", po::value(&inputFiles)->multitoken(),
+      "The file(s) with the knowledge graph data to be parsed from. If "
+      "omitted, will read from stdin. Several files (e.g. the shards of a dump "
+      "via a shell glob) are parsed concurrently, the prefixes that are "
+      "declared in one file only apply to this file. Files with the suffix "
+      "`.gz`, `.bz2`, or `.zst` are decompressed.");
   add("file-format,F", po::value(&filetype),
-      "The format of the input file with the knowledge graph data. Must be one "
-      "of [nt|ttl]. If not set, QLever will try to deduce it from the "
+      "The format of the input files with the knowledge graph data. Must be "
+      "one of [nt|ttl]. If not set, QLever will try to deduce it from the "
       "filename suffix.");
   add("kg-index-name,K", po::value(&kbIndexName),
-      "The name of the knowledge graph index (default: basename of "
+      "The name of the knowledge graph index (default: basename of the first "
       "`kg-input-file`).");
 
   // Options for the text index.
@@ -132,6 +139,14 @@ int main(int argc, char** argv) {
       "Decrease if the index builder runs out of memory.");
   add("keep-temporary-files,k", po::bool_switch(&keepTemporaryFiles),
       "Do not delete temporary files from index creation for debugging.");
+  add("no-in-memory-build", po::bool_switch(&noInMemoryBuild),
+      "Always use the external (on-disk) sorting, also if the input is small "
+      "enough to build the index in memory.");
+  add("resume", po::bool_switch(&resumeBuild),
+      "Resume a previous index build with the same input files and settings "
+      "that failed or was killed. The stages that it has completed (the "
+      "vocabulary and the permutations, and each of the additional "
+      "precomputations from the settings file) are skipped.");
 
   // Process command line arguments.
   po::variables_map optionsMap;
@@ -160,8 +175,8 @@ int main(int argc, char** argv) {
 
   // If no index name was specified, take the part of the input file name after
   // the last slash.
-  if (kbIndexName.empty() && !inputFile.empty()) {
-    kbIndexName = ad_utility::getLastPartOfString(inputFile, '/');
+  if (kbIndexName.empty() && !inputFiles.empty()) {
+    kbIndexName = ad_utility::getLastPartOfString(inputFiles.front(), '/');
   }
 
   LOG(INFO) << EMPH_ON << "QLever IndexBuilder, compiled on "
@@ -182,6 +197,8 @@ int main(int argc, char** argv) {
     index.usePatterns() = !noPatterns;
     index.setOnDiskBase(baseName);
     index.setKeepTempFiles(keepTemporaryFiles);
+    index.setResumeBuild(resumeBuild);
+    index.inMemoryBuildIfPossible() = !noInMemoryBuild;
     index.setSettingsFile(settingsFile);
     index.setPrefixCompression(!noPrefixCompression);
     index.loadAllPermutations() = !onlyPsoAndPos;
@@ -189,8 +206,19 @@ int main(int argc, char** argv) {
     // index, but we assume that it already exists. In particular, we then need
     // the vocabulary from the KB index for building the text index.
     if (!onlyAddTextIndex) {
-      if (inputFile.empty() || inputFile == "-") {
-        inputFile = "/dev/stdin";
+      if (inputFiles.empty()) {
+        inputFiles.push_back("-");
+      }
+      for (auto& inputFile : inputFiles) {
+        if (inputFile.empty() || inputFile == "-") {
+          inputFile = "/dev/stdin";
+        }
+      }
+      // The format is deduced from the first file, the suffix of a
+      // compression is ignored.
+      std::string_view inputFile = inputFiles.front();
+      if (ParallelDecompressingFileBuffer::compressionFromFilename(inputFile)) {
+        inputFile = inputFile.substr(0, inputFile.rfind('.'));
       }
 
       if (!filetype.empty()) {
@@ -219,13 +247,14 @@ int main(int argc, char** argv) {
       }
 
       if (filetype == "ttl") {
-        LOG(DEBUG) << "Parsing uncompressed TTL from: " << inputFile
+        LOG(DEBUG) << "Parsing TTL from: " << absl::StrJoin(inputFiles, ", ")
                    << std::endl;
-        index.createFromFile(inputFile);
+        index.createFromFiles(inputFiles);
       } else if (filetype == "nt") {
-        LOG(DEBUG) << "Parsing uncompressed N-Triples from: " << inputFile
+        LOG(DEBUG) << "Parsing N-Triples from: "
+                   << absl::StrJoin(inputFiles, ", ")
                    << " (using the Turtle parser)" << std::endl;
-        index.createFromFile(inputFile);
+        index.createFromFiles(inputFiles);
       } else {
         LOG(ERROR) << "File format must be one of: nt ttl" << std::endl;
         std::cerr << boostOptions << std::endl;
@@ -39,16 +39,24 @@ struct TripleComponentWithIndex {
   std::string iriOrLiteral_;
   bool isExternal_ = false;
   uint64_t index_ = 0;
+  // The precomputed `SortKey` of the inner value on the `TOTAL` level (see
+  // `TripleComponentComparator::compareWithSortKeys`), empty if the words are
+  // merged by a comparator that does not use it.
+  LocaleManager::U8String sortKey_;
 
   [[nodiscard]] const auto& isExternal() const { return isExternal_; }
   [[nodiscard]] auto& isExternal() { return isExternal_; }
   [[nodiscard]] const auto& iriOrLiteral() const { return iriOrLiteral_; }
   [[nodiscard]] auto& iriOrLiteral() { return iriOrLiteral_; }
+  [[nodiscard]] LocaleManager::SortKeyView sortKey() const {
+    return LocaleManager::SortKeyView{sortKey_};
+  }
 
   AD_SERIALIZE_FRIEND_FUNCTION(TripleComponentWithIndex) {
     serializer | arg.iriOrLiteral_;
     serializer | arg.isExternal_;
     serializer | arg.index_;
+    serializer | arg.sortKey_;
   }
 };
 
@@ -10,16 +10,22 @@
 
 #include <algorithm>
 #include <charconv>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <ranges>
-#include <stxxl/algorithm>
 #include <tuple>
 #include <utility>
 
 #include "engine/CallFixedSize.h"
 #include "index/FTSAlgorithms.h"
 #include "parser/ContextFileParser.h"
+#include "util/BlockPackedCode.h"
 #include "util/Conversions.h"
 #include "util/Simple8bCode.h"
+#include "util/StringUtils.h"
+#include "util/TaskQueue.h"
 
 namespace {
 
@@ -35,22 +41,32 @@ struct LiteralsTokenizationDelimiter {
   }
 };
 
+// Append the `numBytes` at `data` to `out` and return `numBytes`.
+size_t appendBytes(std::vector<char>& out, const void* data, size_t numBytes) {
+  const char* bytes = static_cast<const char*>(data);
+  out.insert(out.end(), bytes, bytes + numBytes);
+  return numBytes;
+}
 }  // namespace
 
 // _____________________________________________________________________________
-cppcoro::generator<ContextFileParser::Line> IndexImpl::wordsInTextRecords(
-    const std::string& contextFile, bool addWordsFromLiterals) {
+cppcoro::generator<std::vector<ContextFileParser::Line>>
+IndexImpl::wordsInTextRecords(const std::string& contextFile,
+                              bool addWordsFromLiterals) {
   auto localeManager = textVocab_.getLocaleManager();
   // ROUND 1: If context file aka wordsfile is not empty, read words from there.
   // Remember the last context id for the (optional) second round.
   TextRecordIndex contextId = TextRecordIndex::make(0);
   if (!contextFile.empty()) {
-    ContextFileParser::Line line;
     ContextFileParser p(contextFile, localeManager);
-    ad_utility::HashSet<string> items;
-    while (p.getLine(line)) {
-      contextId = line._contextId;
-      co_yield line;
+    while (true) {
+      auto lines = p.getBatch(NUM_LINES_PER_BATCH_TEXT_INDEX_BUILDING,
+                              NUM_THREADS_TEXT_INDEX_BUILDING);
+      if (lines.empty()) {
+        break;
+      }
+      contextId = lines.back()._contextId;
+      co_yield lines;
     }
     if (contextId > TextRecordIndex::make(0)) {
       contextId = contextId.incremented();
@@ -59,24 +75,57 @@ cppcoro::generator<ContextFileParser::Line> IndexImpl::wordsInTextRecords(
   // ROUND 2: Optionally, consider each literal from the interal vocabulary as a
   // text record.
   if (addWordsFromLiterals) {
-    for (VocabIndex index = VocabIndex::make(0); index.get() < vocab_.size();
-         index = index.incremented()) {
-      auto text = vocab_.at(index);
-      if (!isLiteral(text)) {
-        continue;
-      }
-      ContextFileParser::Line entityLine{text, true, contextId, 1};
-      co_yield entityLine;
+    // The lines of a single literal.
+    auto linesOfLiteral = [&localeManager](const std::string& text,
+                                           TextRecordIndex contextId) {
+      std::vector<ContextFileParser::Line> lines;
+      lines.push_back({text, true, contextId, 1});
       std::string_view textView = text;
       textView = textView.substr(0, textView.rfind('"'));
       textView.remove_prefix(1);
       for (auto word : absl::StrSplit(textView, LiteralsTokenizationDelimiter{},
                                       absl::SkipEmpty{})) {
         auto wordNormalized = localeManager.getLowercaseUtf8(word);
-        ContextFileParser::Line wordLine{wordNormalized, false, contextId, 1};
-        co_yield wordLine;
+        lines.push_back({std::move(wordNormalized), false, contextId, 1});
+      }
+      return lines;
+    };
+    std::vector<std::pair<std::string, TextRecordIndex>> literals;
+    // Tokenize the literals of a batch concurrently.
+    auto linesOfLiterals = [&literals, &linesOfLiteral]() {
+      size_t numThreads = std::clamp(literals.size(), size_t{1},
+                                     NUM_THREADS_TEXT_INDEX_BUILDING);
+      std::vector<std::vector<ContextFileParser::Line>> linesPerThread(
+          numThreads);
+      ad_utility::runConcurrently(numThreads, [&](size_t t) {
+        size_t end = literals.size() * (t + 1) / numThreads;
+        for (size_t i = literals.size() * t / numThreads; i < end; ++i) {
+          const auto& [text, contextIdOfLiteral] = literals[i];
+          std::ranges::move(linesOfLiteral(text, contextIdOfLiteral),
+                            std::back_inserter(linesPerThread[t]));
+        }
+      });
+      std::vector<ContextFileParser::Line> lines;
+      for (auto& linesOfThread : linesPerThread) {
+        std::ranges::move(linesOfThread, std::back_inserter(lines));
       }
+      literals.clear();
+      return lines;
+    };
+    for (VocabIndex index = VocabIndex::make(0); index.get() < vocab_.size();
+         index = index.incremented()) {
+      auto text = vocab_.at(index);
+      if (!isLiteral(text)) {
+        continue;
+      }
+      literals.emplace_back(std::move(text), contextId);
       contextId = contextId.incremented();
+      if (literals.size() >= NUM_LINES_PER_BATCH_TEXT_INDEX_BUILDING) {
+        co_yield linesOfLiterals();
+      }
+    }
+    if (!literals.empty()) {
+      co_yield linesOfLiterals();
     }
   }
 }
@@ -119,13 +168,10 @@ void IndexImpl::addTextFromContextFile(const string& contextFile,
   // Build the half-inverted lists (second scan over the text records).
   LOG(INFO) << "Building the half-inverted index lists ..." << std::endl;
   calculateBlockBoundaries();
-  TextVec v;
-  v.reserve(nofLines);
+  LOG(DEBUG) << "Number of lines: " << nofLines << std::endl;
+  TextVec v{onDiskBase_ + ".text-postings-sorter.dat",
+            memoryLimitIndexBuilding() / 3, allocator_};
   processWordsForInvertedLists(contextFile, addWordsFromLiterals, v);
-  LOG(DEBUG) << "Sorting text index, #elements = " << v.size() << std::endl;
-  stxxl::sort(begin(v), end(v), SortText(),
-              memoryLimitIndexBuilding().getBytes() / 3);
-  LOG(DEBUG) << "Sort done" << std::endl;
   createTextIndex(indexFilename, v);
   openTextFileHandle();
 }
@@ -134,12 +180,7 @@ void IndexImpl::addTextFromContextFile(const string& contextFile,
 void IndexImpl::buildDocsDB(const string& docsFileName) const {
   LOG(INFO) << "Building DocsDB...\n";
   std::ifstream docsFile{docsFileName};
-  std::ofstream ofs(onDiskBase_ + ".text.docsDB", std::ios_base::out);
-  // To avoid excessive use of RAM,
-  // we write the offsets to and stxxl:vector first;
-  stxxl::vector<off_t> offsets;
-  off_t currentOffset = 0;
-  uint64_t currentContextId = 0;
+  DocsDB::Builder builder{onDiskBase_ + ".text.docsDB"};
   string line;
   line.reserve(BUFFER_SIZE_DOCSFILE_LINE);
   while (std::getline(docsFile, line)) {
@@ -147,26 +188,9 @@ void IndexImpl::buildDocsDB(const string& docsFileName) const {
     size_t tab = lineView.find('\t');
     uint64_t contextId = 0;
     std::from_chars(lineView.data(), lineView.data() + tab, contextId);
-    lineView = lineView.substr(tab + 1);
-    ofs << lineView;
-    while (currentContextId < contextId) {
-      offsets.push_back(currentOffset);
-      currentContextId++;
-    }
-    offsets.push_back(currentOffset);
-    currentContextId++;
-    currentOffset += static_cast<off_t>(lineView.size());
+    builder.addTextRecord(contextId, lineView.substr(tab + 1));
   }
-  offsets.push_back(currentOffset);
-
-  ofs.close();
-  // Now append the tmp file to the docsDB file.
-  ad_utility::File out(onDiskBase_ + ".text.docsDB", "a");
-  for (size_t i = 0; i < offsets.size(); ++i) {
-    off_t cur = offsets[i];
-    out.write(&cur, sizeof(cur));
-  }
-  out.close();
+  std::move(builder).finish();
   LOG(INFO) << "DocsDB done.\n";
 }
 
@@ -185,8 +209,20 @@ void IndexImpl::addTextFromOnDiskIndex() {
   [[maybe_unused]] off_t metaTo = textIndexFile_.getLastOffset(&metaFrom);
   ad_utility::serialization::FileReadSerializer serializer(
       std::move(textIndexFile_));
+  // Text indices that were built before the format version was introduced
+  // have version 1.
+  textIndexFormatVersion_ =
+      configurationJson_.value("text-index-format-version", size_t{1});
+  AD_CONTRACT_CHECK(textIndexFormatVersion_ >= 1 &&
+                    textIndexFormatVersion_ <=
+                        CURRENT_TEXT_INDEX_FORMAT_VERSION);
   serializer.setSerializationPosition(metaFrom);
   serializer >> textMeta_;
+  if (textIndexFormatVersion_ >= 4) {
+    vector<TextBlockMetaData> prefixBlocks;
+    serializer >> prefixBlocks;
+    textMeta_.setPrefixBlocks(std::move(prefixBlocks));
+  }
   textIndexFile_ = std::move(serializer).file();
   LOG(INFO) << "Registered text index: " << textMeta_.statistics() << std::endl;
 
@@ -213,15 +249,12 @@ size_t IndexImpl::processWordsForVocabulary(string const& contextFile,
                                             bool addWordsFromLiterals) {
   size_t numLines = 0;
   ad_utility::HashSet<string> distinctWords;
-  for (auto line : wordsInTextRecords(contextFile, addWordsFromLiterals)) {
-    ++numLines;
-    // LOG(INFO) << "LINE: "
-    //           << std::setw(50) << line._word << "   "
-    //           << line._isEntity << "\t"
-    //           << line._contextId.get() << "\t"
-    //           << line._score << std::endl;
-    if (!line._isEntity) {
-      distinctWords.insert(line._word);
+  for (auto& lines : wordsInTextRecords(contextFile, addWordsFromLiterals)) {
+    numLines += lines.size();
+    for (auto& line : lines) {
+      if (!line._isEntity) {
+        distinctWords.insert(std::move(line._word));
+      }
     }
   }
   textVocab_.createFromSet(distinctWords);
@@ -233,56 +266,90 @@ void IndexImpl::processWordsForInvertedLists(const string& contextFile,
                                              bool addWordsFromLiterals,
                                              IndexImpl::TextVec& vec) {
   LOG(TRACE) << "BEGIN IndexImpl::passContextFileIntoVector" << std::endl;
-  TextVec::bufwriter_type writer(vec);
-  ad_utility::HashMap<WordIndex, Score> wordsInContext;
-  ad_utility::HashMap<Id, Score> entitiesInContext;
-  auto currentContext = TextRecordIndex::make(0);
-  size_t nofContexts = 0;
-  size_t nofWordPostings = 0;
-  size_t nofEntityPostings = 0;
-  size_t entityNotFoundErrorMsgCount = 0;
-
-  for (auto line : wordsInTextRecords(contextFile, addWordsFromLiterals)) {
-    if (line._contextId != currentContext) {
-      ++nofContexts;
-      addContextToVector(writer, currentContext, wordsInContext,
-                         entitiesInContext);
-      currentContext = line._contextId;
-      wordsInContext.clear();
-      entitiesInContext.clear();
-    }
-    if (line._isEntity) {
-      ++nofEntityPostings;
-      // TODO<joka921> Currently only IRIs and strings from the vocabulary can
-      // be tagged entities in the text index (no doubles, ints, etc).
-      VocabIndex eid;
-      if (getVocab().getId(line._word, &eid)) {
-        // Note that `entitiesInContext` is a HashMap, so the `Id`s don't have
-        // to be contiguous.
-        entitiesInContext[Id::makeFromVocabIndex(eid)] += line._score;
-      } else {
-        if (entityNotFoundErrorMsgCount < 20) {
-          LOG(WARN) << "Entity from text not in KB: " << line._word << '\n';
-          if (++entityNotFoundErrorMsgCount == 20) {
-            LOG(WARN) << "There are more entities not in the KB..."
-                      << " suppressing further warnings...\n";
-          }
+  std::atomic<size_t> nofContexts = 0;
+  std::atomic<size_t> nofWordPostings = 0;
+  std::atomic<size_t> nofEntityPostings = 0;
+  std::atomic<size_t> entityNotFoundErrorMsgCount = 0;
+
+  // Compute the postings of the `lines` (which consist of complete contexts).
+  auto processLines = [&](std::span<const ContextFileParser::Line> lines,
+                          IdTableStatic<NUM_COLUMNS_TEXT_VEC>& postings) {
+    ad_utility::HashMap<WordIndex, Score> wordsInContext;
+    ad_utility::HashMap<Id, Score> entitiesInContext;
+    for (size_t i = 0; i < lines.size(); ++i) {
+      const auto& line = lines[i];
+      if (line._isEntity) {
+        ++nofEntityPostings;
+        // TODO<joka921> Currently only IRIs and strings from the vocabulary can
+        // be tagged entities in the text index (no doubles, ints, etc).
+        VocabIndex eid;
+        if (getVocab().getId(line._word, &eid)) {
+          // Note that `entitiesInContext` is a HashMap, so the `Id`s don't have
+          // to be contiguous.
+          entitiesInContext[Id::makeFromVocabIndex(eid)] += line._score;
         } else {
-          entityNotFoundErrorMsgCount++;
+          auto count = entityNotFoundErrorMsgCount++;
+          if (count < 20) {
+            LOG(WARN) << "Entity from text not in KB: " << line._word << '\n';
+            if (count + 1 == 20) {
+              LOG(WARN) << "There are more entities not in the KB..."
+                        << " suppressing further warnings...\n";
+            }
+          }
         }
+      } else {
+        ++nofWordPostings;
+        // TODO<joka921> Let the `textVocab_` return a `WordIndex` directly.
+        WordVocabIndex vid;
+        bool ret = textVocab_.getId(line._word, &vid);
+        WordIndex wid = vid.get();
+        if (!ret) {
+          LOG(ERROR) << "ERROR: word \"" << line._word << "\" "
+                     << "not found in textVocab. Terminating\n";
+          AD_FAIL();
+        }
+        wordsInContext[wid] += line._score;
       }
-    } else {
-      ++nofWordPostings;
-      // TODO<joka921> Let the `textVocab_` return a `WordIndex` directly.
-      WordVocabIndex vid;
-      bool ret = textVocab_.getId(line._word, &vid);
-      WordIndex wid = vid.get();
-      if (!ret) {
-        LOG(ERROR) << "ERROR: word \"" << line._word << "\" "
-                   << "not found in textVocab. Terminating\n";
-        AD_FAIL();
+      if (i + 1 == lines.size() ||
+          lines[i + 1]._contextId != line._contextId) {
+        ++nofContexts;
+        addContextToVector(postings, line._contextId, wordsInContext,
+                           entitiesInContext);
+        wordsInContext.clear();
+        entitiesInContext.clear();
+      }
+    }
+  };
+
+  for (const auto& lines :
+       wordsInTextRecords(contextFile, addWordsFromLiterals)) {
+    // Split the batch into parts of complete contexts, the postings of which
+    // are computed concurrently.
+    size_t numThreads = std::min(NUM_THREADS_TEXT_INDEX_BUILDING, lines.size());
+    std::vector<size_t> boundaries{0};
+    for (size_t t = 1; t < numThreads; ++t) {
+      size_t boundary =
+          std::max(lines.size() * t / numThreads, boundaries.back());
+      while (boundary > 0 && boundary < lines.size() &&
+             lines[boundary]._contextId == lines[boundary - 1]._contextId) {
+        ++boundary;
+      }
+      boundaries.push_back(boundary);
+    }
+    boundaries.push_back(lines.size());
+    std::vector<IdTableStatic<NUM_COLUMNS_TEXT_VEC>> postings;
+    for (size_t t = 0; t < numThreads; ++t) {
+      postings.emplace_back(allocator_);
+    }
+    ad_utility::runConcurrently(numThreads, [&](size_t t) {
+      processLines(std::span{lines}.subspan(
+                       boundaries[t], boundaries[t + 1] - boundaries[t]),
+                   postings[t]);
+    });
+    for (const auto& postingsOfPart : postings) {
+      for (const auto& posting : postingsOfPart) {
+        vec.push(posting);
       }
-      wordsInContext[wid] += line._score;
     }
   }
   if (entityNotFoundErrorMsgCount > 0) {
@@ -291,28 +358,33 @@ void IndexImpl::processWordsForInvertedLists(const string& contextFile,
   }
   LOG(DEBUG) << "Number of total entity mentions: " << nofEntityPostings
              << std::endl;
-  ++nofContexts;
-  addContextToVector(writer, currentContext, wordsInContext, entitiesInContext);
   textMeta_.setNofTextRecords(nofContexts);
   textMeta_.setNofWordPostings(nofWordPostings);
   textMeta_.setNofEntityPostings(nofEntityPostings);
-
-  writer.finish();
   LOG(TRACE) << "END IndexImpl::passContextFileIntoVector" << std::endl;
 }
 
 // _____________________________________________________________________________
 void IndexImpl::addContextToVector(
-    IndexImpl::TextVec::bufwriter_type& writer, TextRecordIndex context,
+    IdTableStatic<NUM_COLUMNS_TEXT_VEC>& postings, TextRecordIndex context,
     const ad_utility::HashMap<WordIndex, Score>& words,
-    const ad_utility::HashMap<Id, Score>& entities) {
+    const ad_utility::HashMap<Id, Score>& entities) const {
+  // The columns of the postings are stored as the bits of `Id`s, see
+  // `SortText`.
+  auto addPosting = [&postings, context](TextBlockIndex blockId, bool isEntity,
+                                         WordOrEntityIndex wordOrEntity,
+                                         Score score) {
+    postings.push_back({Id::fromBits(blockId), Id::fromBits(isEntity),
+                        Id::fromBits(context.get()), Id::fromBits(wordOrEntity),
+                        Id::fromBits(score)});
+  };
   // Determine blocks for each word and each entity.
   // Add the posting to each block.
   ad_utility::HashSet<TextBlockIndex> touchedBlocks;
   for (auto it = words.begin(); it != words.end(); ++it) {
     TextBlockIndex blockId = getWordBlockId(it->first);
     touchedBlocks.insert(blockId);
-    writer << std::make_tuple(blockId, context, it->first, it->second, false);
+    addPosting(blockId, false, it->first, it->second);
   }
 
   // All entities have to be written in the entity list part for each block.
@@ -323,62 +395,132 @@ void IndexImpl::addContextToVector(
   for (TextBlockIndex blockId : touchedBlocks) {
     for (auto it = entities.begin(); it != entities.end(); ++it) {
       AD_CONTRACT_CHECK(it->first.getDatatype() == Datatype::VocabIndex);
-      writer << std::make_tuple(
-          blockId, context, it->first.getVocabIndex().get(), it->second, true);
+      addPosting(blockId, true, it->first.getVocabIndex().get(), it->second);
     }
   }
 }
 
 // _____________________________________________________________________________
-void IndexImpl::createTextIndex(const string& filename,
-                                const IndexImpl::TextVec& vec) {
+void IndexImpl::createTextIndex(const string& filename, TextVec& vec) {
   ad_utility::File out(filename.c_str(), "w");
   currenttOffset_ = 0;
+  // The blocks are compressed concurrently and written to the file in the
+  // order in which they are finished. The `fileMutex` protects the `out`, the
+  // `currenttOffset_`, and the `blocks`, which are added to the `textMeta_` in
+  // the correct order at the end.
+  std::mutex fileMutex;
+  vector<std::pair<size_t, TextBlockMetaData>> blocks;
+  vector<TextBlockMetaData> prefixBlocks;
+  ad_utility::TaskQueue<false> writeQueue{
+      NUM_THREADS_TEXT_INDEX_BUILDING, NUM_THREADS_TEXT_INDEX_BUILDING,
+      "Compressing and writing the text blocks"};
+  size_t numBlocks = 0;
+  auto writeBlock = [&](WordIndex minWordIndex, WordIndex maxWordIndex,
+                        vector<Posting> classicPostings,
+                        vector<Posting> entityPostings) {
+    AD_CONTRACT_CHECK(!classicPostings.empty());
+    writeQueue.push([&, blockIdx = numBlocks++, minWordIndex, maxWordIndex,
+                     classicPostings = std::move(classicPostings),
+                     entityPostings = std::move(entityPostings)]() {
+      std::vector<char> buffer;
+      auto writeLists = [&](WordIndex first, WordIndex last,
+                            const vector<Posting>& classic,
+                            const vector<Posting>& entity) {
+        return TextBlockMetaData(first, last,
+                                 writePostings(buffer, classic, true),
+                                 writePostings(buffer, entity, false));
+      };
+      TextBlockMetaData block = writeLists(minWordIndex, maxWordIndex,
+                                           classicPostings, entityPostings);
+      // The prefix blocks contain the postings of the words in their range,
+      // and the entity postings of the text records of these postings.
+      vector<TextBlockMetaData> newPrefixBlocks;
+      for (auto [first, last] : getWordRangesOfPrefixBlocks(
+               minWordIndex, maxWordIndex, classicPostings)) {
+        vector<Posting> prefixPostings;
+        std::ranges::copy_if(classicPostings,
+                             std::back_inserter(prefixPostings),
+                             [first, last](const Posting& posting) {
+                               WordIndex word = std::get<1>(posting);
+                               return word >= first && word <= last;
+                             });
+        vector<TextRecordIndex> textRecords;
+        for (const Posting& posting : prefixPostings) {
+          if (textRecords.empty() ||
+              textRecords.back() != std::get<0>(posting)) {
+            textRecords.push_back(std::get<0>(posting));
+          }
+        }
+        vector<Posting> prefixEntityPostings;
+        std::ranges::copy_if(entityPostings,
+                             std::back_inserter(prefixEntityPostings),
+                             [&textRecords](const Posting& posting) {
+                               return std::ranges::binary_search(
+                                   textRecords, std::get<0>(posting));
+                             });
+        newPrefixBlocks.push_back(
+            writeLists(first, last, prefixPostings, prefixEntityPostings));
+      }
+      std::lock_guard lock{fileMutex};
+      auto addOffset = [this](TextBlockMetaData& md) {
+        for (ContextListMetaData* meta : {&md._cl, &md._entityCl}) {
+          meta->_startContextlist += currenttOffset_;
+          meta->_startWordlist += currenttOffset_;
+          meta->_startScorelist += currenttOffset_;
+          meta->_lastByte += currenttOffset_;
+        }
+      };
+      addOffset(block);
+      std::ranges::for_each(newPrefixBlocks, addOffset);
+      currenttOffset_ += out.write(buffer.data(), buffer.size());
+      blocks.emplace_back(blockIdx, block);
+      prefixBlocks.insert(prefixBlocks.end(), newPrefixBlocks.begin(),
+                          newPrefixBlocks.end());
+    });
+  };
+
   // Detect block boundaries from the main key of the vec.
   // Write the data for each block.
   // First, there's the classic lists, then the additional entity ones.
-  TextBlockIndex currentBlockIndex = 0;
+  std::optional<TextBlockIndex> currentBlockIndex;
   WordIndex currentMinWordIndex = std::numeric_limits<WordIndex>::max();
   WordIndex currentMaxWordIndex = std::numeric_limits<WordIndex>::min();
   vector<Posting> classicPostings;
   vector<Posting> entityPostings;
-  for (TextVec::bufreader_type reader(vec); !reader.empty(); ++reader) {
-    if (std::get<0>(*reader) != currentBlockIndex) {
-      AD_CONTRACT_CHECK(!classicPostings.empty());
-
-      ContextListMetaData classic = writePostings(out, classicPostings, true);
-      ContextListMetaData entity = writePostings(out, entityPostings, false);
-      textMeta_.addBlock(TextBlockMetaData(
-          currentMinWordIndex, currentMaxWordIndex, classic, entity));
-      classicPostings.clear();
-      entityPostings.clear();
-      currentBlockIndex = std::get<0>(*reader);
-      currentMinWordIndex = std::get<2>(*reader);
-      currentMaxWordIndex = std::get<2>(*reader);
-    }
-    if (!std::get<4>(*reader)) {
-      classicPostings.emplace_back(std::get<1>(*reader), std::get<2>(*reader),
-                                   std::get<3>(*reader));
-      if (std::get<2>(*reader) < currentMinWordIndex) {
-        currentMinWordIndex = std::get<2>(*reader);
-      }
-      if (std::get<2>(*reader) > currentMaxWordIndex) {
-        currentMaxWordIndex = std::get<2>(*reader);
+  for (const auto& row : vec.sortedView()) {
+    TextBlockIndex blockIndex = row[0].getBits();
+    bool isEntity = row[1].getBits() != 0;
+    TextRecordIndex context = TextRecordIndex::make(row[2].getBits());
+    WordOrEntityIndex wordOrEntity = row[3].getBits();
+    auto score = static_cast<Score>(row[4].getBits());
+    if (blockIndex != currentBlockIndex) {
+      if (currentBlockIndex.has_value()) {
+        writeBlock(currentMinWordIndex, currentMaxWordIndex,
+                   std::move(classicPostings), std::move(entityPostings));
+        classicPostings.clear();
+        entityPostings.clear();
       }
-
+      currentBlockIndex = blockIndex;
+      currentMinWordIndex = wordOrEntity;
+      currentMaxWordIndex = wordOrEntity;
+    }
+    if (!isEntity) {
+      classicPostings.emplace_back(context, wordOrEntity, score);
+      currentMinWordIndex = std::min(currentMinWordIndex, wordOrEntity);
+      currentMaxWordIndex = std::max(currentMaxWordIndex, wordOrEntity);
     } else {
-      entityPostings.emplace_back(std::get<1>(*reader), std::get<2>(*reader),
-                                  std::get<3>(*reader));
+      entityPostings.emplace_back(context, wordOrEntity, score);
     }
   }
   // Write the last block
-  AD_CONTRACT_CHECK(!classicPostings.empty());
-  ContextListMetaData classic = writePostings(out, classicPostings, true);
-  ContextListMetaData entity = writePostings(out, entityPostings, false);
-  textMeta_.addBlock(TextBlockMetaData(currentMinWordIndex, currentMaxWordIndex,
-                                       classic, entity));
-  classicPostings.clear();
-  entityPostings.clear();
+  writeBlock(currentMinWordIndex, currentMaxWordIndex,
+             std::move(classicPostings), std::move(entityPostings));
+  writeQueue.finish();
+  std::ranges::sort(blocks, std::less{}, &decltype(blocks)::value_type::first);
+  for (const auto& [blockIdx, block] : blocks) {
+    textMeta_.addBlock(block);
+  }
+  textMeta_.setPrefixBlocks(std::move(prefixBlocks));
   LOG(DEBUG) << "Done creating text index." << std::endl;
   LOG(INFO) << "Statistics for text index: " << textMeta_.statistics()
             << std::endl;
@@ -386,31 +528,37 @@ void IndexImpl::createTextIndex(const string& filename,
   LOG(DEBUG) << "Writing Meta data to index file ..." << std::endl;
   ad_utility::serialization::FileWriteSerializer serializer{std::move(out)};
   serializer << textMeta_;
+  serializer << textMeta_.prefixBlocks();
   out = std::move(serializer).file();
-  off_t startOfMeta = textMeta_.getOffsetAfter();
+  // The blocks are not written in order, so the metadata starts after all of
+  // them instead of after the last one.
+  off_t startOfMeta = currenttOffset_;
   out.write(&startOfMeta, sizeof(startOfMeta));
   out.close();
+  textIndexFormatVersion_ = CURRENT_TEXT_INDEX_FORMAT_VERSION;
+  configurationJson_["text-index-format-version"] = textIndexFormatVersion_;
+  writeConfiguration();
   LOG(INFO) << "Text index build completed" << std::endl;
 }
 
 // _____________________________________________________________________________
-ContextListMetaData IndexImpl::writePostings(ad_utility::File& out,
-                                             const vector<Posting>& postings,
-                                             bool skipWordlistIfAllTheSame) {
+ContextListMetaData IndexImpl::writePostings(
+    std::vector<char>& out, const vector<Posting>& postings,
+    bool skipWordlistIfAllTheSame) const {
   ContextListMetaData meta;
   meta._nofElements = postings.size();
+  auto currentOffset = static_cast<off_t>(out.size());
   if (meta._nofElements == 0) {
-    meta._startContextlist = currenttOffset_;
-    meta._startWordlist = currenttOffset_;
-    meta._startScorelist = currenttOffset_;
-    meta._lastByte = currenttOffset_ - 1;
+    meta._startContextlist = currentOffset;
+    meta._startWordlist = currentOffset;
+    meta._startScorelist = currentOffset;
+    meta._lastByte = currentOffset - 1;
     return meta;
   }
 
   // Collect the individual lists
-  // Context lists are gap encoded, word and score lists frequency encoded.
-  // TODO<joka921> these are gap encoded contextIds, maybe also create a type
-  // for this.
+  // Context lists are sorted and compressed as differences (see
+  // `BlockPackedCode`), word and score lists frequency encoded.
   auto contextList = new uint64_t[meta._nofElements];
   WordIndex* wordList = new WordIndex[meta._nofElements];
   Score* scoreList = new Score[meta._nofElements];
@@ -432,8 +580,8 @@ ContextListMetaData IndexImpl::writePostings(ad_utility::File& out,
   ++n;
 
   for (auto it = postings.begin() + 1; it < postings.end(); ++it) {
-    uint64_t gap = std::get<0>(*it).get() - lastContext.get();
-    contextList[n] = gap;
+    AD_CONTRACT_CHECK(std::get<0>(*it) >= lastContext);
+    contextList[n] = std::get<0>(*it).get();
     lastContext = std::get<0>(*it);
     wordList[n] = wordCodeMap[std::get<1>(*it)];
     scoreList[n] = scoreCodeMap[std::get<2>(*it)];
@@ -442,32 +590,59 @@ ContextListMetaData IndexImpl::writePostings(ad_utility::File& out,
 
   AD_CONTRACT_CHECK(meta._nofElements == n);
 
-  // Do the actual writing:
-  size_t bytes = 0;
+  // Compress the lists in sub-blocks and create the skip list.
+  // The word list can be skipped if we're writing classic lists and there
+  // is only one distinct wordId in the block, since this Id is already
+  // stored in the meta data.
+  static_assert(TextSkipEntry::SUB_BLOCK_SIZE %
+                    ad_utility::BlockPackedCode::BLOCK_SIZE ==
+                0);
+  static_assert(sizeof(TextSkipEntry) == 4 * sizeof(uint64_t));
+  bool writeWordList = !skipWordlistIfAllTheSame || wordCodebook.size() > 1;
+  vector<TextSkipEntry> skipList;
+  vector<uint64_t> encodedContexts;
+  vector<uint64_t> encodedWords;
+  vector<uint64_t> encodedScores;
+  for (size_t start = 0; start < n; start += TextSkipEntry::SUB_BLOCK_SIZE) {
+    size_t num = std::min(TextSkipEntry::SUB_BLOCK_SIZE, n - start);
+    skipList.push_back({contextList[start], encodedContexts.size(),
+                        encodedWords.size(), encodedScores.size()});
+    auto append = [](vector<uint64_t>& target, vector<uint64_t> encoded) {
+      target.insert(target.end(), encoded.begin(), encoded.end());
+    };
+    append(encodedContexts,
+           ad_utility::BlockPackedCode::encode<true>(
+               contextList + start, num, contextList[start]));
+    if (writeWordList) {
+      append(encodedWords, ad_utility::BlockPackedCode::encode<false>(
+                               wordList + start, num));
+    }
+    append(encodedScores, ad_utility::BlockPackedCode::encode<false>(
+                              scoreList + start, num));
+  }
 
-  // Write context list:
-  meta._startContextlist = currenttOffset_;
-  bytes = writeList(contextList, meta._nofElements, out);
-  currenttOffset_ += bytes;
+  // Do the actual writing:
+  // Write context list (including the skip list):
+  meta._startContextlist = currentOffset;
+  uint64_t numSubBlocks = skipList.size();
+  currentOffset += appendBytes(out, &numSubBlocks, sizeof(numSubBlocks));
+  currentOffset += appendBytes(out, skipList.data(),
+                               skipList.size() * sizeof(TextSkipEntry));
+  currentOffset += writeList(encodedContexts, out);
 
   // Write word list:
-  // This can be skipped if we're writing classic lists and there
-  // is only one distinct wordId in the block, since this Id is already
-  // stored in the meta data.
-  meta._startWordlist = currenttOffset_;
-  if (!skipWordlistIfAllTheSame || wordCodebook.size() > 1) {
-    currenttOffset_ += writeCodebook(wordCodebook, out);
-    bytes = writeList(wordList, meta._nofElements, out);
-    currenttOffset_ += bytes;
+  meta._startWordlist = currentOffset;
+  if (writeWordList) {
+    currentOffset += writeCodebook(wordCodebook, out);
+    currentOffset += writeList(encodedWords, out);
   }
 
   // Write scores
-  meta._startScorelist = currenttOffset_;
-  currenttOffset_ += writeCodebook(scoreCodebook, out);
-  bytes = writeList(scoreList, meta._nofElements, out);
-  currenttOffset_ += bytes;
+  meta._startScorelist = currentOffset;
+  currentOffset += writeCodebook(scoreCodebook, out);
+  currentOffset += writeList(encodedScores, out);
 
-  meta._lastByte = currenttOffset_ - 1;
+  meta._lastByte = currentOffset - 1;
 
   delete[] contextList;
   delete[] wordList;
@@ -476,6 +651,66 @@ ContextListMetaData IndexImpl::writePostings(ad_utility::File& out,
   return meta;
 }
 
+// _____________________________________________________________________________
+vector<std::pair<WordIndex, WordIndex>> IndexImpl::getWordRangesOfPrefixBlocks(
+    WordIndex minWordIndex, WordIndex maxWordIndex,
+    const vector<Posting>& classicPostings) const {
+  vector<std::pair<WordIndex, WordIndex>> result;
+  if (classicPostings.size() < MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK) {
+    return result;
+  }
+  // The number of postings of each word of the block, and the number of
+  // postings of the words before each word (s.t. the number of postings of a
+  // range of words can be computed in constant time).
+  vector<size_t> numPostingsBefore(maxWordIndex - minWordIndex + 2, 0);
+  for (const Posting& posting : classicPostings) {
+    ++numPostingsBefore[std::get<1>(posting) - minWordIndex + 1];
+  }
+  std::partial_sum(numPostingsBefore.begin(), numPostingsBefore.end(),
+                   numPostingsBefore.begin());
+  for (size_t prefixSize = MIN_WORD_PREFIX_SIZE + 1;
+       prefixSize <= MAX_WORD_PREFIX_SIZE_TEXT_PREFIX_BLOCKS; ++prefixSize) {
+    // The words with the same prefix are contiguous in the vocabulary, so the
+    // next word with a new prefix is the one after the range of the prefix.
+    WordIndex word = minWordIndex;
+    while (word <= maxWordIndex) {
+      auto [numCodepoints, prefix] = ad_utility::getUTF8Prefix(
+          textVocab_[WordVocabIndex::make(word)].value(), prefixSize);
+      if (numCodepoints < prefixSize) {
+        ++word;
+        continue;
+      }
+      auto range = textVocab_.getIdRangeForFullTextPrefix(std::string{prefix} +
+                                                          PREFIX_CHAR);
+      // The range always contains the `word` itself, but might exceed the
+      // block for some corner cases of Unicode (see
+      // `calculateBlockBoundariesImpl`). Such prefixes are skipped.
+      if (!range.has_value() || range.value().first().get() > word ||
+          range.value().last().get() < word) {
+        ++word;
+        continue;
+      }
+      WordIndex first = range.value().first().get();
+      WordIndex last = range.value().last().get();
+      word = last + 1;
+      if (first < minWordIndex || last > maxWordIndex ||
+          (first == minWordIndex && last == maxWordIndex)) {
+        continue;
+      }
+      size_t numPostings = numPostingsBefore[last - minWordIndex + 1] -
+                           numPostingsBefore[first - minWordIndex];
+      if (numPostings >= MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK) {
+        result.emplace_back(first, last);
+      }
+    }
+  }
+  // Different prefixes can have the same range of words.
+  std::ranges::sort(result);
+  auto [eraseBegin, eraseEnd] = std::ranges::unique(result);
+  result.erase(eraseBegin, eraseEnd);
+  return result;
+}
+
 /// yields  aaaa, aaab, ..., zzzz
 static cppcoro::generator<std::string> fourLetterPrefixes() {
   static_assert(
@@ -631,19 +866,9 @@ TextBlockIndex IndexImpl::getWordBlockId(WordIndex wordIndex) const {
 }
 
 // _____________________________________________________________________________
-template <typename Numeric>
-size_t IndexImpl::writeList(Numeric* data, size_t nofElements,
-                            ad_utility::File& file) const {
-  if (nofElements > 0) {
-    uint64_t* encoded = new uint64_t[nofElements];
-    size_t size = ad_utility::Simple8bCode::encode(data, nofElements, encoded);
-    size_t ret = file.write(encoded, size);
-    AD_CONTRACT_CHECK(size == ret);
-    delete[] encoded;
-    return size;
-  } else {
-    return 0;
-  }
+size_t IndexImpl::writeList(const vector<uint64_t>& encoded,
+                            std::vector<char>& out) const {
+  return appendBytes(out, encoded.data(), encoded.size() * sizeof(uint64_t));
 }
 
 // _____________________________________________________________________________
@@ -698,10 +923,10 @@ void IndexImpl::createCodebooks(const vector<IndexImpl::Posting>& postings,
 // _____________________________________________________________________________
 template <class T>
 size_t IndexImpl::writeCodebook(const vector<T>& codebook,
-                                ad_utility::File& file) const {
+                                std::vector<char>& out) const {
   size_t byteSizeOfCodebook = sizeof(T) * codebook.size();
-  file.write(&byteSizeOfCodebook, sizeof(byteSizeOfCodebook));
-  file.write(codebook.data(), byteSizeOfCodebook);
+  appendBytes(out, &byteSizeOfCodebook, sizeof(byteSizeOfCodebook));
+  appendBytes(out, codebook.data(), byteSizeOfCodebook);
   return byteSizeOfCodebook + sizeof(byteSizeOfCodebook);
 }
 
@@ -741,14 +966,20 @@ void IndexImpl::getContextListForWords(const string& words,
   Index::WordEntityPostings wep;
   vector<size_t> skipColumns;
   if (terms.size() > 1) {
-    vector<Index::WordEntityPostings> wepVecs;
-    size_t i = 0;
-    for (auto& term : terms) {
-      if (!term.ends_with('*')) {
+    // Read the postings of the term with the fewest postings first, s.t. only
+    // the sub-blocks of the other lists that can contain one of its text
+    // records have to be read.
+    vector<Index::WordEntityPostings> wepVecs(terms.size());
+    size_t rarestTerm = getIndexOfTermWithFewestPostings(terms);
+    wepVecs[rarestTerm] = getWordPostingsForTermWep(terms[rarestTerm]);
+    for (size_t i = 0; i < terms.size(); ++i) {
+      if (!terms[i].ends_with('*')) {
         skipColumns.push_back(i);
       }
-      wepVecs.push_back(getWordPostingsForTermWep(term));
-      i++;
+      if (i != rarestTerm) {
+        wepVecs[i] =
+            getWordPostingsForTermWep(terms[i], &wepVecs[rarestTerm].cids_);
+      }
     }
     wep = FTSAlgorithms::crossIntersectKWay(wepVecs, nullptr);
   } else {
@@ -786,6 +1017,21 @@ void IndexImpl::getContextListForWords(const string& words,
   LOG(DEBUG) << "Done with getContextListForWords.\n";
 }
 
+namespace {
+// The conversions of the values of the lists of the text index to the `Id`s
+// of the `IdTable`s.
+auto makeTextRecordId = [](uint64_t textRecordIndex) {
+  return Id::makeFromTextRecordIndex(TextRecordIndex::make(textRecordIndex));
+};
+auto makeWordId = [](WordIndex wordIndex) {
+  return Id::makeFromWordVocabIndex(WordVocabIndex::make(wordIndex));
+};
+auto makeEntityId = [](WordIndex entity) {
+  return Id::makeFromVocabIndex(VocabIndex::make(entity));
+};
+auto makeScoreId = [](Score score) { return Id::makeFromInt(score); };
+}  // namespace
+
 // _____________________________________________________________________________
 Index::WordEntityPostings IndexImpl::readWordClWep(
     const TextBlockMetaData& tbmd) const {
@@ -808,21 +1054,16 @@ IdTable IndexImpl::readWordCl(
     const TextBlockMetaData& tbmd,
     const ad_utility::AllocatorWithLimit<Id>& allocator) const {
   IdTable idTable{2, allocator};
-  vector<TextRecordIndex> cids = readGapComprList<TextRecordIndex>(
+  // The lists are decoded directly into the columns of the result.
+  idTable.resize(tbmd._cl._nofElements);
+  readGapComprList(
       tbmd._cl._nofElements, tbmd._cl._startContextlist,
       static_cast<size_t>(tbmd._cl._startWordlist - tbmd._cl._startContextlist),
-      &TextRecordIndex::make);
-  idTable.resize(cids.size());
-  std::ranges::transform(cids, idTable.getColumn(0).begin(),
-                         &Id::makeFromTextRecordIndex);
-  std::ranges::transform(
-      readFreqComprList<WordIndex>(
-          tbmd._cl._nofElements, tbmd._cl._startWordlist,
-          static_cast<size_t>(tbmd._cl._startScorelist -
-                              tbmd._cl._startWordlist)),
-      idTable.getColumn(1).begin(), [](WordIndex id) {
-        return Id::makeFromWordVocabIndex(WordVocabIndex::make(id));
-      });
+      idTable.getColumn(0), makeTextRecordId);
+  readFreqComprList<WordIndex>(
+      tbmd._cl._nofElements, tbmd._cl._startWordlist,
+      static_cast<size_t>(tbmd._cl._startScorelist - tbmd._cl._startWordlist),
+      idTable.getColumn(1), makeWordId);
   return idTable;
 }
 
@@ -835,11 +1076,11 @@ Index::WordEntityPostings IndexImpl::readWordEntityClWep(
       static_cast<size_t>(tbmd._entityCl._startWordlist -
                           tbmd._entityCl._startContextlist),
       &TextRecordIndex::make);
-  wep.eids_ = readFreqComprList<Id>(
+  wep.eids_ = readFreqComprList<Id, WordIndex>(
       tbmd._entityCl._nofElements, tbmd._entityCl._startWordlist,
       static_cast<size_t>(tbmd._entityCl._startScorelist -
                           tbmd._entityCl._startWordlist),
-      &Id::fromBits);
+      makeEntityId);
   wep.scores_ = readFreqComprList<Score>(
       tbmd._entityCl._nofElements, tbmd._entityCl._startScorelist,
       static_cast<size_t>(tbmd._entityCl._lastByte + 1 -
@@ -852,33 +1093,182 @@ IdTable IndexImpl::readWordEntityCl(
     const TextBlockMetaData& tbmd,
     const ad_utility::AllocatorWithLimit<Id>& allocator) const {
   IdTable idTable{3, allocator};
-  vector<TextRecordIndex> cids = readGapComprList<TextRecordIndex>(
-      tbmd._entityCl._nofElements, tbmd._entityCl._startContextlist,
-      static_cast<size_t>(tbmd._entityCl._startWordlist -
-                          tbmd._entityCl._startContextlist),
-      &TextRecordIndex::make);
-  idTable.resize(cids.size());
-  std::ranges::transform(cids, idTable.getColumn(0).begin(),
-                         &Id::makeFromTextRecordIndex);
-  std::ranges::copy(
-      readFreqComprList<Id>(tbmd._entityCl._nofElements,
-                            tbmd._entityCl._startWordlist,
-                            static_cast<size_t>(tbmd._entityCl._startScorelist -
-                                                tbmd._entityCl._startWordlist),
-                            &Id::fromBits),
-      idTable.getColumn(1).begin());
-  std::ranges::transform(
-      readFreqComprList<Score>(
-          tbmd._entityCl._nofElements, tbmd._entityCl._startScorelist,
-          static_cast<size_t>(tbmd._entityCl._lastByte + 1 -
-                              tbmd._entityCl._startScorelist)),
-      idTable.getColumn(2).begin(), &Id::makeFromInt);
+  // The lists are decoded directly into the columns of the result.
+  idTable.resize(tbmd._entityCl._nofElements);
+  readGapComprList(tbmd._entityCl._nofElements,
+                   tbmd._entityCl._startContextlist,
+                   static_cast<size_t>(tbmd._entityCl._startWordlist -
+                                       tbmd._entityCl._startContextlist),
+                   idTable.getColumn(0), makeTextRecordId);
+  readFreqComprList<WordIndex>(
+      tbmd._entityCl._nofElements, tbmd._entityCl._startWordlist,
+      static_cast<size_t>(tbmd._entityCl._startScorelist -
+                          tbmd._entityCl._startWordlist),
+      idTable.getColumn(1), makeEntityId);
+  readFreqComprList<Score>(tbmd._entityCl._nofElements,
+                           tbmd._entityCl._startScorelist,
+                           static_cast<size_t>(tbmd._entityCl._lastByte + 1 -
+                                               tbmd._entityCl._startScorelist),
+                           idTable.getColumn(2), makeScoreId);
   return idTable;
 }
 
+// _____________________________________________________________________________
+Index::WordEntityPostings IndexImpl::readSubBlocksOfContextList(
+    const TextBlockMetaData& tbmd, bool isEntityList,
+    const vector<TextRecordIndex>& textRecords) const {
+  Index::WordEntityPostings wep;
+  for (auto& run : readSubBlocksOfContextListLazily(
+           tbmd, isEntityList, &textRecords,
+           std::numeric_limits<size_t>::max())) {
+    if (wep.cids_.empty()) {
+      wep = std::move(run);
+      continue;
+    }
+    auto append = [](auto& target, const auto& source) {
+      target.insert(target.end(), source.begin(), source.end());
+    };
+    append(wep.cids_, run.cids_);
+    append(wep.wids_.at(0), run.wids_.at(0));
+    append(wep.eids_, run.eids_);
+    append(wep.scores_, run.scores_);
+  }
+  return wep;
+}
+
+// _____________________________________________________________________________
+cppcoro::generator<Index::WordEntityPostings>
+IndexImpl::readSubBlocksOfContextListLazily(
+    const TextBlockMetaData& tbmd, bool isEntityList,
+    const vector<TextRecordIndex>* textRecords,
+    size_t maxNumSubBlocksPerRun) const {
+  if (textIndexFormatVersion_ < 3) {
+    co_yield isEntityList ? readWordEntityClWep(tbmd) : readWordClWep(tbmd);
+    co_return;
+  }
+  const ContextListMetaData& cl = isEntityList ? tbmd._entityCl : tbmd._cl;
+  if (cl._nofElements == 0) {
+    co_return;
+  }
+
+  // Read the skip list and the codebooks.
+  off_t startOfContexts = cl._startContextlist;
+  uint64_t numSubBlocks;
+  startOfContexts += textIndexFile_.read(&numSubBlocks, sizeof(numSubBlocks),
+                                         startOfContexts);
+  vector<TextSkipEntry> skipList(numSubBlocks);
+  startOfContexts += textIndexFile_.read(
+      skipList.data(), numSubBlocks * sizeof(TextSkipEntry), startOfContexts);
+  bool hasWordList = cl._startScorelist > cl._startWordlist;
+  AD_CORRECTNESS_CHECK(hasWordList || !isEntityList);
+  vector<WordIndex> wordCodebook;
+  off_t startOfWords = cl._startScorelist;
+  if (hasWordList) {
+    std::tie(wordCodebook, startOfWords) =
+        readCodebook<WordIndex>(cl._startWordlist);
+  }
+  auto [scoreCodebook, startOfScores] = readCodebook<Score>(cl._startScorelist);
+
+  // Sub-block `k` can only contain the text records from its first text
+  // record to the first text record of the next sub-block (inclusive, because
+  // the postings of a text record can span several sub-blocks).
+  vector<bool> isNeeded(numSubBlocks, textRecords == nullptr);
+  if (textRecords != nullptr) {
+    auto it = textRecords->begin();
+    for (size_t k = 0; k < numSubBlocks; ++k) {
+      it = std::lower_bound(
+          it, textRecords->end(),
+          TextRecordIndex::make(skipList[k].firstTextRecord_));
+      isNeeded[k] = it != textRecords->end() &&
+                    (k + 1 == numSubBlocks ||
+                     it->get() <= skipList[k + 1].firstTextRecord_);
+    }
+  }
+
+  // Read the compressed words of the sub-blocks `[first, last)` beginning at
+  // `start` of the file. `end` is the end of the compressed list.
+  auto readSubBlocks = [this, &skipList, numSubBlocks](
+                           off_t start, off_t end,
+                           uint64_t TextSkipEntry::*offset, size_t first,
+                           size_t last) {
+    uint64_t beginWord = skipList[first].*offset;
+    uint64_t endWord = last < numSubBlocks
+                           ? skipList[last].*offset
+                           : static_cast<uint64_t>(end - start) / 8;
+    vector<uint64_t> words(endWord - beginWord);
+    textIndexFile_.read(words.data(), words.size() * sizeof(uint64_t),
+                        start + static_cast<off_t>(beginWord * 8));
+    return words;
+  };
+
+  // Read and decode each maximal run of needed sub-blocks (of at most
+  // `maxNumSubBlocksPerRun` sub-blocks) at once.
+  using ad_utility::BlockPackedCode;
+  for (size_t first = 0; first < numSubBlocks;) {
+    if (!isNeeded[first]) {
+      ++first;
+      continue;
+    }
+    size_t last = first;
+    while (last < numSubBlocks && isNeeded[last] &&
+           last - first < maxNumSubBlocksPerRun) {
+      ++last;
+    }
+    Index::WordEntityPostings wep;
+    auto contexts = readSubBlocks(startOfContexts, cl._startWordlist,
+                                  &TextSkipEntry::contextOffset_, first, last);
+    auto words = hasWordList
+                     ? readSubBlocks(startOfWords, cl._startScorelist,
+                                     &TextSkipEntry::wordOffset_, first, last)
+                     : vector<uint64_t>{};
+    auto scores = readSubBlocks(startOfScores, cl._lastByte + 1,
+                                &TextSkipEntry::scoreOffset_, first, last);
+    for (size_t k = first; k < last; ++k) {
+      const auto& entry = skipList[k];
+      const auto& firstEntry = skipList[first];
+      size_t start = k * TextSkipEntry::SUB_BLOCK_SIZE;
+      size_t num =
+          std::min(TextSkipEntry::SUB_BLOCK_SIZE, cl._nofElements - start);
+      size_t pos = wep.cids_.size();
+      wep.cids_.resize(pos + num);
+      BlockPackedCode::decode<true>(
+          contexts.data() + entry.contextOffset_ - firstEntry.contextOffset_,
+          num, wep.cids_.begin() + pos, &TextRecordIndex::make,
+          entry.firstTextRecord_);
+      const uint64_t* encodedWords =
+          words.data() + entry.wordOffset_ - firstEntry.wordOffset_;
+      auto wordFromCode = [&wordCodebook](uint64_t code) {
+        return wordCodebook[code];
+      };
+      if (isEntityList) {
+        wep.eids_.resize(pos + num);
+        BlockPackedCode::decode<false>(
+            encodedWords, num, wep.eids_.begin() + pos,
+            [&wordFromCode](uint64_t code) {
+              return makeEntityId(wordFromCode(code));
+            });
+      } else if (hasWordList) {
+        wep.wids_.at(0).resize(pos + num);
+        BlockPackedCode::decode<false>(
+            encodedWords, num, wep.wids_.at(0).begin() + pos, wordFromCode);
+      } else {
+        // The only word of the block is stored in the metadata.
+        wep.wids_.at(0).resize(pos + num, tbmd._firstWordId);
+      }
+      wep.scores_.resize(pos + num);
+      BlockPackedCode::decode<false>(
+          scores.data() + entry.scoreOffset_ - firstEntry.scoreOffset_, num,
+          wep.scores_.begin() + pos,
+          [&scoreCodebook](uint64_t code) { return scoreCodebook[code]; });
+    }
+    first = last;
+    co_yield std::move(wep);
+  }
+}
+
 // _____________________________________________________________________________
 Index::WordEntityPostings IndexImpl::getWordPostingsForTermWep(
-    const string& term) const {
+    const string& term, const vector<TextRecordIndex>* textRecords) const {
   LOG(DEBUG) << "Getting word postings for term: " << term << '\n';
   Index::WordEntityPostings wep;
   auto optionalTbmd = getTextBlockMetadataForWordOrPrefix(term);
@@ -886,7 +1276,9 @@ Index::WordEntityPostings IndexImpl::getWordPostingsForTermWep(
     return wep;
   }
   const auto& tbmd = optionalTbmd.value().tbmd_;
-  wep = readWordClWep(tbmd);
+  wep = textRecords != nullptr
+            ? readSubBlocksOfContextList(tbmd, false, *textRecords)
+            : readWordClWep(tbmd);
   if (optionalTbmd.value().hasToBeFiltered_) {
     wep = FTSAlgorithms::filterByRangeWep(optionalTbmd.value().idRange_, wep);
   }
@@ -917,6 +1309,32 @@ IdTable IndexImpl::getWordPostingsForTerm(
   return idTable;
 }
 
+// _____________________________________________________________________________
+cppcoro::generator<IdTable> IndexImpl::getWordPostingsForTermLazily(
+    string term, ad_utility::AllocatorWithLimit<Id> allocator) const {
+  auto optionalTbmd = getTextBlockMetadataForWordOrPrefix(term);
+  if (!optionalTbmd.has_value()) {
+    co_return;
+  }
+  const auto& [tbmd, hasToBeFiltered, idRange] = optionalTbmd.value();
+  for (auto& wep : readSubBlocksOfContextListLazily(
+           tbmd, false, nullptr, NUM_TEXT_SUB_BLOCKS_PER_LAZY_BLOCK)) {
+    if (hasToBeFiltered) {
+      wep = FTSAlgorithms::filterByRangeWep(idRange, wep);
+    }
+    if (wep.cids_.empty()) {
+      continue;
+    }
+    IdTable idTable{2, allocator};
+    idTable.resize(wep.cids_.size());
+    std::ranges::transform(wep.cids_, idTable.getColumn(0).begin(),
+                           &Id::makeFromTextRecordIndex);
+    std::ranges::transform(wep.wids_.at(0), idTable.getColumn(1).begin(),
+                           makeWordId);
+    co_yield idTable;
+  }
+}
+
 // _____________________________________________________________________________
 Index::WordEntityPostings IndexImpl::getContextEntityScoreListsForWords(
     const string& words) const {
@@ -937,6 +1355,9 @@ Index::WordEntityPostings IndexImpl::getContextEntityScoreListsForWords(
     LOG(TRACE) << "Best term to take entity list from: " << terms[useElFromTerm]
                << std::endl;
 
+    // The word postings of all the terms are only needed for the text records
+    // in which the term from which the entities are taken occurs.
+    auto entityPostings = getEntityPostingsForTerm(terms[useElFromTerm]);
     vector<Index::WordEntityPostings> wepVecs;
     vector<size_t> skipColumns;
     for (size_t i = 0; i < terms.size(); ++i) {
@@ -944,10 +1365,11 @@ Index::WordEntityPostings IndexImpl::getContextEntityScoreListsForWords(
         skipColumns.push_back(i);
       }
       if (i != useElFromTerm) {
-        wepVecs.push_back(getWordPostingsForTermWep(terms[i]));
+        wepVecs.push_back(
+            getWordPostingsForTermWep(terms[i], &entityPostings.cids_));
       }
     }
-    wepVecs.push_back(getEntityPostingsForTerm(terms[useElFromTerm]));
+    wepVecs.push_back(std::move(entityPostings));
     resultWep =
         FTSAlgorithms::crossIntersectKWay(wepVecs, &wepVecs.back().eids_);
 
@@ -1106,8 +1528,10 @@ Index::WordEntityPostings IndexImpl::getEntityPostingsForTerm(
   Index::WordEntityPostings matchingContextsWep =
       getWordPostingsForTermWep(term);
 
-  // Read the full lists
-  Index::WordEntityPostings eBlockWep = readWordEntityClWep(tbmd);
+  // Only read the sub-blocks of the entity list that can contain the text
+  // records of the term.
+  Index::WordEntityPostings eBlockWep =
+      readSubBlocksOfContextList(tbmd, true, matchingContextsWep.cids_);
   resultWep = FTSAlgorithms::crossIntersect(matchingContextsWep, eBlockWep);
   return resultWep;
 }
@@ -1124,89 +1548,149 @@ IdTable IndexImpl::getEntityMentionsForWord(
   return readWordEntityCl(tbmd, allocator);
 }
 
+// _____________________________________________________________________________
+cppcoro::generator<IdTable> IndexImpl::getEntityMentionsForWordLazily(
+    string term, ad_utility::AllocatorWithLimit<Id> allocator) const {
+  auto optTbmd = getTextBlockMetadataForWordOrPrefix(term);
+  if (!optTbmd.has_value()) {
+    co_return;
+  }
+  const auto& tbmd = optTbmd.value().tbmd_;
+  for (auto& wep : readSubBlocksOfContextListLazily(
+           tbmd, true, nullptr, NUM_TEXT_SUB_BLOCKS_PER_LAZY_BLOCK)) {
+    IdTable idTable{3, allocator};
+    idTable.resize(wep.cids_.size());
+    std::ranges::transform(wep.cids_, idTable.getColumn(0).begin(),
+                           &Id::makeFromTextRecordIndex);
+    std::ranges::copy(wep.eids_, idTable.getColumn(1).begin());
+    std::ranges::transform(wep.scores_, idTable.getColumn(2).begin(),
+                           makeScoreId);
+    co_yield idTable;
+  }
+}
+
 // _____________________________________________________________________________
 template <typename T, typename MakeFromUint64t>
-vector<T> IndexImpl::readGapComprList(size_t nofElements, off_t from,
-                                      size_t nofBytes,
-                                      MakeFromUint64t makeFromUint64t) const {
+void IndexImpl::readGapComprList(size_t nofElements, off_t from,
+                                 size_t nofBytes, std::span<T> result,
+                                 MakeFromUint64t makeFromUint64t) const {
   LOG(DEBUG) << "Reading gap-encoded list from disk...\n";
   LOG(TRACE) << "NofElements: " << nofElements << ", from: " << from
              << ", nofBytes: " << nofBytes << '\n';
-  vector<T> result;
-  result.resize(nofElements + 250);
-  uint64_t* encoded = new uint64_t[nofBytes / 8];
-  textIndexFile_.read(encoded, nofBytes, from);
-  LOG(DEBUG) << "Decoding Simple8b code...\n";
-  ad_utility::Simple8bCode::decode(encoded, nofElements, result.data(),
-                                   makeFromUint64t);
-  LOG(DEBUG) << "Reverting gaps to actual IDs...\n";
-
-  // TODO<joka921> make this hack unnecessary, probably by a proper output
-  // iterator.
-  if constexpr (requires { T::make(0); }) {
-    uint64_t id = 0;
-    for (size_t i = 0; i < result.size(); ++i) {
-      id += result[i].get();
-      result[i] = T::make(id);
+  AD_CONTRACT_CHECK(result.size() == nofElements);
+  if (nofElements == 0) {
+    return;
+  }
+  vector<uint64_t> encoded(nofBytes / 8);
+  textIndexFile_.read(encoded.data(), nofBytes, from);
+  if (textIndexFormatVersion_ >= 3) {
+    // The list starts with the skip list (see `TextSkipEntry`), and the
+    // sub-blocks are decoded separately.
+    size_t numSubBlocks = encoded.at(0);
+    vector<TextSkipEntry> skipList(numSubBlocks);
+    std::memcpy(skipList.data(), encoded.data() + 1,
+                numSubBlocks * sizeof(TextSkipEntry));
+    const uint64_t* contexts =
+        encoded.data() + 1 + numSubBlocks * sizeof(TextSkipEntry) / 8;
+    for (size_t k = 0; k < numSubBlocks; ++k) {
+      size_t start = k * TextSkipEntry::SUB_BLOCK_SIZE;
+      ad_utility::BlockPackedCode::decode<true>(
+          contexts + skipList[k].contextOffset_,
+          std::min(TextSkipEntry::SUB_BLOCK_SIZE, nofElements - start),
+          result.begin() + start, makeFromUint64t,
+          skipList[k].firstTextRecord_);
     }
+  } else if (textIndexFormatVersion_ >= 2) {
+    // The prefix sum is part of the decoding.
+    ad_utility::BlockPackedCode::decode<true>(encoded.data(), nofElements,
+                                              result.begin(), makeFromUint64t);
   } else {
-    T id = 0;
-    for (size_t i = 0; i < result.size(); ++i) {
-      id += result[i];
-      result[i] = id;
+    LOG(DEBUG) << "Decoding Simple8b code...\n";
+    vector<uint64_t> gaps(nofElements + 250);
+    ad_utility::Simple8bCode::decode(encoded.data(), nofElements, gaps.data());
+    LOG(DEBUG) << "Reverting gaps to actual IDs...\n";
+    uint64_t id = 0;
+    for (size_t i = 0; i < nofElements; ++i) {
+      id += gaps[i];
+      result[i] = makeFromUint64t(id);
     }
   }
-  result.resize(nofElements);
-  delete[] encoded;
   LOG(DEBUG) << "Done reading gap-encoded list. Size: " << result.size()
              << "\n";
-  return result;
 }
 
 // _____________________________________________________________________________
 template <typename T, typename MakeFromUint64t>
-vector<T> IndexImpl::readFreqComprList(size_t nofElements, off_t from,
-                                       size_t nofBytes,
-                                       MakeFromUint64t makeFromUint) const {
-  AD_CONTRACT_CHECK(nofBytes > 0);
-  LOG(DEBUG) << "Reading frequency-encoded list from disk...\n";
-  LOG(TRACE) << "NofElements: " << nofElements << ", from: " << from
-             << ", nofBytes: " << nofBytes << '\n';
+vector<T> IndexImpl::readGapComprList(size_t nofElements, off_t from,
+                                      size_t nofBytes,
+                                      MakeFromUint64t makeFromUint64t) const {
+  vector<T> result(nofElements);
+  readGapComprList(nofElements, from, nofBytes, std::span{result},
+                   makeFromUint64t);
+  return result;
+}
+
+// _____________________________________________________________________________
+template <typename CodebookT>
+std::pair<vector<CodebookT>, off_t> IndexImpl::readCodebook(off_t from) const {
   size_t nofCodebookBytes;
-  vector<T> result;
-  uint64_t* encoded = new uint64_t[nofElements];
-  result.resize(nofElements + 250);
   off_t current = from;
   size_t ret = textIndexFile_.read(&nofCodebookBytes, sizeof(off_t), current);
   LOG(TRACE) << "Nof Codebook Bytes: " << nofCodebookBytes << '\n';
   AD_CONTRACT_CHECK(sizeof(off_t) == ret);
   current += ret;
-  T* codebook = new T[nofCodebookBytes / sizeof(T)];
-  ret = textIndexFile_.read(codebook, nofCodebookBytes, current);
+  vector<CodebookT> codebook(nofCodebookBytes / sizeof(CodebookT));
+  ret = textIndexFile_.read(codebook.data(), nofCodebookBytes, current);
   current += ret;
   AD_CONTRACT_CHECK(ret == size_t(nofCodebookBytes));
-  ret = textIndexFile_.read(
-      encoded, static_cast<size_t>(nofBytes - (current - from)), current);
-  current += ret;
+  return {std::move(codebook), current};
+}
+
+// _____________________________________________________________________________
+template <typename CodebookT, typename T, typename FromCodebook>
+void IndexImpl::readFreqComprList(size_t nofElements, off_t from,
+                                  size_t nofBytes, std::span<T> result,
+                                  FromCodebook fromCodebook) const {
+  AD_CONTRACT_CHECK(nofBytes > 0);
+  AD_CONTRACT_CHECK(result.size() == nofElements);
+  LOG(DEBUG) << "Reading frequency-encoded list from disk...\n";
+  LOG(TRACE) << "NofElements: " << nofElements << ", from: " << from
+             << ", nofBytes: " << nofBytes << '\n';
+  auto [codebook, current] = readCodebook<CodebookT>(from);
+  size_t nofEncodedBytes = static_cast<size_t>(nofBytes - (current - from));
+  vector<uint64_t> encoded(nofEncodedBytes / 8);
+  current += textIndexFile_.read(encoded.data(), nofEncodedBytes, current);
   AD_CONTRACT_CHECK(size_t(current - from) == nofBytes);
-  LOG(DEBUG) << "Decoding Simple8b code...\n";
-  ad_utility::Simple8bCode::decode(encoded, nofElements, result.data(),
-                                   makeFromUint);
-  LOG(DEBUG) << "Reverting frequency encoded items to actual IDs...\n";
-  result.resize(nofElements);
-  for (size_t i = 0; i < result.size(); ++i) {
-    // TODO<joka921> handle the strong ID types properly.
-    if constexpr (requires(T t) { t.getBits(); }) {
-      result[i] = Id::makeFromVocabIndex(
-          VocabIndex::make(codebook[result[i].getBits()].getBits()));
-    } else {
-      result[i] = codebook[result[i]];
-    }
+  auto fromCode = [&codebook, &fromCodebook](uint64_t code) {
+    return fromCodebook(codebook[code]);
+  };
+  if (textIndexFormatVersion_ >= 2) {
+    // In version 3, the list consists of sub-blocks that were compressed
+    // independently, but as their size is a multiple of the block size of the
+    // `BlockPackedCode`, this is the same as compressing the whole list.
+    ad_utility::BlockPackedCode::decode<false>(encoded.data(), nofElements,
+                                               result.begin(), fromCode);
+  } else {
+    LOG(DEBUG) << "Decoding Simple8b code...\n";
+    vector<uint64_t> codes(nofElements + 250);
+    ad_utility::Simple8bCode::decode(encoded.data(), nofElements,
+                                     codes.data());
+    LOG(DEBUG) << "Reverting frequency encoded items to actual IDs...\n";
+    std::transform(codes.begin(), codes.begin() + nofElements, result.begin(),
+                   fromCode);
   }
-  delete[] encoded;
-  delete[] codebook;
   LOG(DEBUG) << "Done reading frequency-encoded list. Size: " << result.size()
              << "\n";
+}
+
+// _____________________________________________________________________________
+template <typename T, typename CodebookT, typename FromCodebook>
+vector<T> IndexImpl::readFreqComprList(size_t nofElements, off_t from,
+                                       size_t nofBytes,
+                                       FromCodebook fromCodebook) const {
+  vector<T> result(nofElements);
+  readFreqComprList<CodebookT>(nofElements, from, nofBytes, std::span{result},
+                               fromCodebook);
   return result;
 }
 
@@ -1431,6 +1915,27 @@ void IndexImpl::dumpAsciiLists(const TextBlockMetaData& tbmd) const {
 }
 #endif
 
+// _____________________________________________________________________________
+size_t IndexImpl::getIndexOfTermWithFewestPostings(
+    const vector<string>& terms) const {
+  AD_CONTRACT_CHECK(!terms.empty());
+  size_t result = 0;
+  size_t fewestPostings = std::numeric_limits<size_t>::max();
+  for (size_t i = 0; i < terms.size(); ++i) {
+    auto optTbmd = getTextBlockMetadataForWordOrPrefix(terms[i]);
+    if (!optTbmd.has_value()) {
+      // The term has no postings at all.
+      return i;
+    }
+    size_t numPostings = optTbmd.value().tbmd_._cl._nofElements;
+    if (numPostings < fewestPostings) {
+      result = i;
+      fewestPostings = numPostings;
+    }
+  }
+  return result;
+}
+
 // _____________________________________________________________________________
 size_t IndexImpl::getIndexOfBestSuitedElTerm(
     const vector<string>& terms) const {
@@ -1524,6 +2029,12 @@ auto IndexImpl::getTextBlockMetadataForWordOrPrefix(const std::string& word)
       return std::nullopt;
     }
     idRange = idRangeOpt.value();
+    // If the prefix has a prefix block, it contains exactly the postings of
+    // the prefix.
+    if (const auto* prefixBlock = textMeta_.getPrefixBlockByWordRange(
+            idRange.first().get(), idRange.last().get())) {
+      return TextBlockMetadataAndWordInfo{*prefixBlock, false, idRange};
+    }
   } else {
     WordVocabIndex idx;
     if (!textVocab_.getId(word, &idx)) {
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <filesystem>
 #include <future>
 #include <optional>
 #include <unordered_map>
@@ -16,16 +17,20 @@
 #include "CompilationInfo.h"
 #include "absl/strings/str_join.h"
 #include "engine/AddCombinedRowToTable.h"
+#include "index/IndexBuildManifest.h"
 #include "index/IndexFormatVersion.h"
 #include "index/PrefixHeuristic.h"
 #include "index/TriplesView.h"
 #include "index/VocabularyGenerator.h"
+#include "parser/ParallelBuffer.h"
 #include "parser/ParallelParseBuffer.h"
 #include "util/BatchedPipeline.h"
 #include "util/CachingMemoryResource.h"
 #include "util/CompressionUsingZstd/ZstdWrapper.h"
+#include "util/DiskSpaceMonitor.h"
 #include "util/HashMap.h"
 #include "util/JoinAlgorithms/JoinAlgorithms.h"
+#include "util/ParallelExecution.h"
 #include "util/Serializer/FileSerializer.h"
 #include "util/TupleHelpers.h"
 #include "util/TypeTraits.h"
@@ -39,6 +44,39 @@ using namespace ad_utility::memory_literals;
 // external sorter.
 static constexpr size_t NUM_EXTERNAL_SORTERS_AT_SAME_TIME = 2u;
 
+// Return true iff the file with the `suffix` (the part of its name after the
+// basename of the index) is one of the temporary files of the index build:
+// the partial vocabularies and ID maps, the inputs of the prefix compression,
+// and the files of the external sorters.
+static bool isTemporaryFileOfIndexBuild(std::string_view suffix) {
+  return suffix.starts_with(".tmp") || suffix.ends_with("-sorter.dat") ||
+         suffix == ".unsorted-triples.dat" || suffix == ".vocabularyTmp";
+}
+
+// Return the estimated total size of the input `filenames` when they are
+// uncompressed, or `std::nullopt` if one of them is not a regular file (e.g.
+// the standard input).
+static std::optional<size_t> estimateSizeOfInput(
+    const std::vector<std::string>& filenames) {
+  size_t size = 0;
+  for (const auto& filename : filenames) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(filename, error)) {
+      return std::nullopt;
+    }
+    size_t fileSize = std::filesystem::file_size(filename, error);
+    if (error) {
+      return std::nullopt;
+    }
+    bool isCompressed =
+        ParallelDecompressingFileBuffer::compressionFromFilename(filename)
+            .has_value();
+    size += isCompressed ? fileSize * ESTIMATED_COMPRESSION_RATIO_OF_INPUT
+                         : fileSize;
+  }
+  return size;
+}
+
 // _____________________________________________________________________________
 IndexImpl::IndexImpl(ad_utility::AllocatorWithLimit<Id> allocator)
     : allocator_{std::move(allocator)} {};
@@ -46,8 +84,17 @@ IndexImpl::IndexImpl(ad_utility::AllocatorWithLimit<Id> allocator)
 // _____________________________________________________________________________
 IndexBuilderDataAsFirstPermutationSorter IndexImpl::createIdTriplesAndVocab(
     std::shared_ptr<TurtleParserBase> parser) {
-  auto indexBuilderData =
-      passFileForVocabulary(std::move(parser), numTriplesPerBatch_);
+  // An index that is built in memory typically has a single partial
+  // vocabulary, whose hash maps are sized for the input.
+  auto indexBuilderData = passFileForVocabulary(
+      std::move(parser),
+      numTriplesPerBatch_.value_or(
+          std::min(numTriplesOfInMemoryBuild_.value_or(
+                       NUM_TRIPLES_PER_PARTIAL_VOCAB),
+                   size_t{NUM_TRIPLES_PER_PARTIAL_VOCAB})));
+  if (numTriplesOfInMemoryBuild_.has_value()) {
+    numTriplesOfInMemoryBuild_ = indexBuilderData.idTriples->size();
+  }
   // first save the total number of words, this is needed to initialize the
   // dense IndexMetaData variants
   totalVocabularySize_ = indexBuilderData.vocabularyMetaData_.numWordsTotal_;
@@ -56,14 +103,18 @@ IndexBuilderDataAsFirstPermutationSorter IndexImpl::createIdTriplesAndVocab(
 
   LOG(INFO) << "Converting external vocabulary to binary format ..."
             << std::endl;
-  vocab_.externalizeLiteralsFromTextFile(
-      onDiskBase_ + EXTERNAL_LITS_TEXT_FILE_NAME,
-      onDiskBase_ + EXTERNAL_VOCAB_SUFFIX);
+  {
+    BuildStage stage{buildStageObserver_, "external-vocabulary"};
+    vocab_.externalizeLiteralsFromTextFile(
+        onDiskBase_ + EXTERNAL_LITS_TEXT_FILE_NAME,
+        onDiskBase_ + EXTERNAL_VOCAB_SUFFIX);
+  }
   deleteTemporaryFile(onDiskBase_ + EXTERNAL_LITS_TEXT_FILE_NAME);
   // clear vocabulary to save ram (only information from partial binary files
   // used from now on). This will preserve information about externalized
   // Prefixes etc.
   vocab_.clear();
+  BuildStage stage{buildStageObserver_, "convert-to-global-ids"};
   auto firstSorter = convertPartialToGlobalIds(
       *indexBuilderData.idTriples, indexBuilderData.actualPartialSizes,
       NUM_TRIPLES_PER_PARTIAL_VOCAB);
@@ -125,6 +176,21 @@ std::unique_ptr<TurtleParserBase> IndexImpl::makeTurtleParser(
   }
 }
 
+// _____________________________________________________________________________
+std::unique_ptr<TurtleParserBase> IndexImpl::makeTurtleParser(
+    const std::vector<std::string>& filenames) {
+  AD_CONTRACT_CHECK(!filenames.empty());
+  if (filenames.size() == 1) {
+    return makeTurtleParser(filenames.front());
+  }
+  return std::make_unique<MultiFileTurtleParser>(
+      filenames,
+      [this](const std::string& filename) {
+        return makeTurtleParser(filename);
+      },
+      NUM_FILES_PARSED_CONCURRENTLY);
+}
+
 // Several helper functions for joining the OSP permutation with the patterns.
 namespace {
 // Return an input range of the blocks that are returned by the external sorter
@@ -263,7 +329,10 @@ std::unique_ptr<ExternalSorter<SortByPSO, 5>> IndexImpl::buildOspWithPatterns(
   createSecondPermutationPair(NumColumnsIndexBuilding + 2, isQleverInternalId,
                               std::move(blockGenerator), *thirdSorter);
   // Add the `ql:has-pattern` predicate to the sorter such that it will become
-  // part of the PSO and POS permutation.
+  // part of the PSO and POS permutation. The patterns themselves are computed
+  // while the first pairs of permutations are created, so this is the only part
+  // of the patterns that is measured as a separate stage.
+  BuildStage stage{buildStageObserver_, "patterns"};
   LOG(INFO) << "Adding " << hasPatternPredicateSortedByPSO->size()
             << " additional triples to the POS and PSO permutation for the "
                "`ql:has-pattern` predicate ..."
@@ -279,19 +348,114 @@ std::unique_ptr<ExternalSorter<SortByPSO, 5>> IndexImpl::buildOspWithPatterns(
 }
 // _____________________________________________________________________________
 void IndexImpl::createFromFile(const string& filename) {
+  createFromFiles({filename});
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createFromFiles(const std::vector<std::string>& filenames) {
+  AD_CONTRACT_CHECK(!filenames.empty());
   if (!loadAllPermutations_ && usePatterns_) {
     throw std::runtime_error{
         "The patterns can only be built when all 6 permutations are created"};
   }
-  LOG(INFO) << "Processing input triples from " << filename << " ..."
-            << std::endl;
+  LOG(INFO) << "Processing input triples from "
+            << absl::StrJoin(filenames, ", ") << " ..." << std::endl;
 
   readIndexBuilderSettingsFromFile();
 
+  IndexBuildManifest manifest{onDiskBase_, makeBuildKey(filenames),
+                              resumeBuild_};
+  if (manifest.isCompleted("permutations")) {
+    // The remaining stages only need the configuration of the index, which
+    // also stores which of them are already completed.
+    auto configurationFile =
+        ad_utility::makeIfstream(onDiskBase_ + CONFIGURATION_FILE);
+    configurationFile >> configurationJson_;
+  } else {
+    // The temporary files are only created while the vocabulary and the
+    // permutations are built.
+    std::filesystem::path basename{onDiskBase_};
+    ad_utility::DiskSpaceMonitor temporaryFiles{
+        basename.has_parent_path() ? basename.parent_path()
+                                    : std::filesystem::path{"."},
+        [prefix = basename.filename().string()](std::string_view filename) {
+          return filename.starts_with(prefix) &&
+                 isTemporaryFileOfIndexBuild(filename.substr(prefix.size()));
+        }};
+    createVocabularyAndPermutations(filenames);
+    LOG(INFO) << "The temporary files of the index build used at most "
+              << ad_utility::MemorySize::bytes(temporaryFiles.stop()).asString()
+              << " of disk space at the same time" << std::endl;
+    manifest.markCompleted("permutations");
+  }
+
+  // Run the `function` for the `stage` unless it is already completed.
+  auto runStage = [this, &manifest](std::string_view stage, auto function) {
+    if (!manifest.isCompleted(stage)) {
+      BuildStage buildStage{buildStageObserver_, std::string{stage}};
+      function();
+      manifest.markCompleted(stage);
+    }
+  };
+  if (!transitiveClosurePredicates_.empty()) {
+    runStage("transitive-closures", [this] { createTransitiveClosures(); });
+  }
+  if (computeVocabularyValues_) {
+    runStage("vocabulary-values", [this] { createVocabularyValues(); });
+  }
+  if (computeGeoPoints_) {
+    runStage("geo-points", [this] { createGeoPoints(); });
+  }
+  if (computeTrigramIndex_) {
+    runStage("trigram-index", [this] { createTrigramIndex(); });
+  }
+  if (computePredicateHistograms_) {
+    runStage("predicate-histograms", [this] { createPredicateHistograms(); });
+  }
+  if (patternTrickAggregatesMinSize_ > 0 && usePatterns_) {
+    runStage("pattern-trick-aggregates",
+             [this] { createPatternTrickAggregates(); });
+  }
+  manifest.remove();
+  LOG(INFO) << "Index build completed" << std::endl;
+}
+
+// _____________________________________________________________________________
+json IndexImpl::makeBuildKey(const std::vector<std::string>& filenames) const {
+  json buildKey;
+  buildKey["input-files"] = filenames;
+  json settings;
+  if (!settingsFileName_.empty()) {
+    auto settingsFile = ad_utility::makeIfstream(settingsFileName_);
+    settingsFile >> settings;
+  }
+  buildKey["settings"] = settings;
+  buildKey["patterns"] = usePatterns_;
+  buildKey["all-permutations"] = loadAllPermutations_;
+  buildKey["prefix-compression"] = vocabPrefixCompressed_;
+  return buildKey;
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createVocabularyAndPermutations(
+    const std::vector<std::string>& filenames) {
+  numTriplesOfInMemoryBuild_.reset();
+  auto inputSize = estimateSizeOfInput(filenames);
+  if (inMemoryBuildIfPossible_ && inputSize.has_value() &&
+      inputSize.value() * MEMORY_PER_INPUT_BYTE_IN_MEMORY_INDEX_BUILD <=
+          memoryLimitIndexBuilding().getBytes()) {
+    LOG(INFO) << "The input is small enough to build the index in memory"
+              << std::endl;
+    numTriplesOfInMemoryBuild_ =
+        inputSize.value() / MIN_INPUT_BYTES_PER_TRIPLE + 1;
+  }
   IndexBuilderDataAsFirstPermutationSorter indexBuilderData =
-      createIdTriplesAndVocab(makeTurtleParser(filename));
+      createIdTriplesAndVocab(makeTurtleParser(filenames));
 
-  compressInternalVocabularyIfSpecified(indexBuilderData.prefixes_);
+  {
+    BuildStage stage{buildStageObserver_, "compress-vocabulary"};
+    compressInternalVocabularyIfSpecified(indexBuilderData.prefixes_);
+  }
 
   // Write the configuration already at this point, so we have it available in
   // case any of the permutations fail.
@@ -314,6 +478,32 @@ void IndexImpl::createFromFile(const string& filename) {
     createFirstPermutationPair(NumColumnsIndexBuilding, isQleverInternalId,
                                std::move(firstSorterWithUnique));
     configurationJson_["has-all-permutations"] = false;
+  } else if (loadAllPermutations_ && !usePatterns_ && parallelPermutations_) {
+    // Without patterns, the second and the third pair of permutations only
+    // depend on the input triples, so the first pair pushes the triples to
+    // both of their sorters. Then the two pairs are created concurrently (the
+    // sorting of one overlaps with the writing of the other). While the first
+    // pair is created, three sorters exist at the same time, so the memory of
+    // the two next sorters is half of the usual.
+    auto secondSorter = makeSorter<SecondPermutation>(
+        "second", 2 * NUM_EXTERNAL_SORTERS_AT_SAME_TIME);
+    auto thirdSorter = makeSorter<ThirdPermutation>(
+        "third", 2 * NUM_EXTERNAL_SORTERS_AT_SAME_TIME);
+    static_assert(std::is_same_v<FirstPermutation, SortBySPO>);
+    createSPOAndSOP(NumColumnsIndexBuilding, isQleverInternalId,
+                    std::move(firstSorterWithUnique), secondSorter,
+                    thirdSorter);
+    indexBuilderData.sorter_.reset();
+    LOG(INFO) << "Creating the remaining two pairs of permutations in parallel"
+              << std::endl;
+    auto thirdPair = std::async(std::launch::async, [&]() {
+      createThirdPermutationPair(NumColumnsIndexBuilding, isQleverInternalId,
+                                 thirdSorter.getSortedBlocks<0>());
+    });
+    createSecondPermutationPair(NumColumnsIndexBuilding, isQleverInternalId,
+                                secondSorter.getSortedBlocks<0>());
+    thirdPair.get();
+    configurationJson_["has-all-permutations"] = true;
   } else if (loadAllPermutations_ && !usePatterns_) {
     // Without patterns we explicitly have to pass in the next sorters to all
     // permutation creating functions.
@@ -344,7 +534,243 @@ void IndexImpl::createFromFile(const string& filename) {
   // Dump the configuration again in case the permutations have added some
   // information.
   writeConfiguration();
-  LOG(INFO) << "Index build completed" << std::endl;
+  numTriplesOfInMemoryBuild_.reset();
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createTransitiveClosures() {
+  // The vocabulary of this index has been cleared during the build, so the
+  // finished index (only the PSO and POS permutations) is loaded separately.
+  IndexImpl index{allocator_};
+  index.loadAllPermutations() = false;
+  index.usePatterns() = false;
+  index.createFromOnDiskIndex(onDiskBase_);
+
+  TransitiveClosures closures;
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  for (const std::string& predicate : transitiveClosurePredicates_) {
+    VocabIndex vocabIndex;
+    if (!index.getVocab().getId(predicate, &vocabIndex)) {
+      LOG(WARN) << "The predicate " << predicate
+                << " for which the transitive closure should be computed "
+                   "does not occur in the vocabulary, it is ignored"
+                << std::endl;
+      continue;
+    }
+    LOG(INFO) << "Computing the transitive closure of " << predicate << " ..."
+              << std::endl;
+    Id id = Id::makeFromVocabIndex(vocabIndex);
+    IdTable triples = index.getPermutation(Permutation::PSO)
+                          .scan(id, std::nullopt, {}, cancellationHandle);
+    auto closure =
+        TransitiveClosure::compute(triples.getColumn(0), triples.getColumn(1));
+    LOG(INFO) << "The transitive closure of " << predicate << " has "
+              << closure.forward_.numPairs() << " pairs (the predicate has "
+              << triples.size() << " triples)" << std::endl;
+    closures.add(id, std::move(closure));
+  }
+  closures.writeToFile(
+      absl::StrCat(onDiskBase_, TransitiveClosures::FILE_SUFFIX));
+  configurationJson_["has-transitive-closures"] = true;
+  writeConfiguration();
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createVocabularyValues() {
+  // The vocabulary of this index has been cleared during the build (see
+  // `createTransitiveClosures`).
+  IndexImpl index{allocator_};
+  index.loadAllPermutations() = false;
+  index.usePatterns() = false;
+  index.createFromOnDiskIndex(onDiskBase_);
+
+  LOG(INFO) << "Computing the values of the numeric and date literals in the "
+               "vocabulary ..."
+            << std::endl;
+  const auto& vocab = index.getVocab();
+  size_t vocabSize = vocab.size() + vocab.getExternalVocab().size();
+  VocabularyValues values;
+  for (size_t i = 0; i < vocabSize; ++i) {
+    auto vocabIndex = VocabIndex::make(i);
+    auto word = vocab.indexToOptionalString(vocabIndex);
+    if (!word.has_value()) {
+      continue;
+    }
+    if (auto value = VocabularyValues::parseLiteral(word.value())) {
+      values.add(vocabIndex, value.value());
+    }
+  }
+  LOG(INFO) << "Number of literals in the vocabulary with a value: "
+            << values.size() << std::endl;
+  values.writeToFile(absl::StrCat(onDiskBase_, VocabularyValues::FILE_SUFFIX));
+  configurationJson_["has-vocabulary-values"] = true;
+  writeConfiguration();
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createGeoPoints() {
+  // The vocabulary of this index has been cleared during the build (see
+  // `createTransitiveClosures`).
+  IndexImpl index{allocator_};
+  index.loadAllPermutations() = false;
+  index.usePatterns() = false;
+  index.createFromOnDiskIndex(onDiskBase_);
+
+  LOG(INFO) << "Computing the coordinates of the WKT points in the "
+               "vocabulary ..."
+            << std::endl;
+  const auto& vocab = index.getVocab();
+  size_t vocabSize = vocab.size() + vocab.getExternalVocab().size();
+  GeoPoints points;
+  for (size_t i = 0; i < vocabSize; ++i) {
+    auto vocabIndex = VocabIndex::make(i);
+    auto word = vocab.indexToOptionalString(vocabIndex);
+    if (!word.has_value()) {
+      continue;
+    }
+    if (auto point = GeoPoints::parseWord(word.value())) {
+      points.add(vocabIndex, point.value());
+    }
+  }
+  LOG(INFO) << "Number of WKT points in the vocabulary: " << points.size()
+            << std::endl;
+  points.writeToFile(absl::StrCat(onDiskBase_, GeoPoints::FILE_SUFFIX));
+  configurationJson_["has-geo-points"] = true;
+  writeConfiguration();
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createTrigramIndex() {
+  // The vocabulary of this index has been cleared during the build (see
+  // `createTransitiveClosures`).
+  IndexImpl index{allocator_};
+  index.loadAllPermutations() = false;
+  index.usePatterns() = false;
+  index.createFromOnDiskIndex(onDiskBase_);
+
+  LOG(INFO) << "Computing the trigram index of the literals in the "
+               "vocabulary ..."
+            << std::endl;
+  const auto& vocab = index.getVocab();
+  size_t vocabSize = vocab.size() + vocab.getExternalVocab().size();
+  TrigramIndex::Builder builder;
+  for (size_t i = 0; i < vocabSize; ++i) {
+    auto vocabIndex = VocabIndex::make(i);
+    auto word = vocab.indexToOptionalString(vocabIndex);
+    if (!word.has_value() || !word.value().starts_with('"')) {
+      continue;
+    }
+    std::string_view content = word.value();
+    content = content.substr(1, content.rfind('"') - 1);
+    builder.add(vocabIndex, content);
+  }
+  auto trigramIndex = std::move(builder).finish();
+  LOG(INFO) << "Number of distinct trigrams of the literals: "
+            << trigramIndex.size() << std::endl;
+  trigramIndex.writeToFile(
+      absl::StrCat(onDiskBase_, TrigramIndex::FILE_SUFFIX));
+  configurationJson_["has-trigram-index"] = true;
+  writeConfiguration();
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createPredicateHistograms() {
+  // The finished index is loaded separately (see `createTransitiveClosures`).
+  IndexImpl index{allocator_};
+  index.loadAllPermutations() = false;
+  index.usePatterns() = false;
+  index.createFromOnDiskIndex(onDiskBase_);
+
+  LOG(INFO) << "Computing the histograms of the objects of the predicates ..."
+            << std::endl;
+  const auto& pos = index.getPermutation(Permutation::POS);
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  PredicateHistograms histograms;
+  for (const auto& relation : pos.metaData().data()) {
+    ObjectHistogram::Builder builder{relation.numRows_};
+    // The objects are the first column of the scan of a predicate in the POS
+    // permutation, and they are sorted.
+    for (const auto& block :
+         pos.lazyScan(relation.col0Id_, std::nullopt, std::nullopt, {},
+                      cancellationHandle)) {
+      builder.add(block.getColumn(0));
+    }
+    histograms.add(relation.col0Id_, std::move(builder).finish());
+  }
+  LOG(INFO) << "Number of predicates with a histogram: " << histograms.size()
+            << std::endl;
+  histograms.writeToFile(
+      absl::StrCat(onDiskBase_, PredicateHistograms::FILE_SUFFIX));
+  configurationJson_["has-predicate-histograms"] = true;
+  writeConfiguration();
+}
+
+// _____________________________________________________________________________
+void IndexImpl::createPatternTrickAggregates() {
+  // The finished index is loaded separately (see `createTransitiveClosures`),
+  // together with the patterns that were written when creating the SPO
+  // permutation.
+  IndexImpl index{allocator_};
+  index.loadAllPermutations() = false;
+  index.usePatterns() = true;
+  index.createFromOnDiskIndex(onDiskBase_);
+
+  LOG(INFO) << "Computing the results of the pattern trick for the groups of "
+               "triples with the same predicate and object and at least "
+            << patternTrickAggregatesMinSize_ << " subjects ..." << std::endl;
+  const auto& pos = index.getPermutation(Permutation::POS);
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  PatternTrickAggregates aggregates;
+  PatternTrickAggregates::Builder builder{index.getHasPattern(),
+                                          index.getPatterns()};
+  for (const auto& relation : pos.metaData().data()) {
+    // Groups with fewer triples than the minimal size have fewer subjects.
+    if (relation.numRows_ < patternTrickAggregatesMinSize_) {
+      continue;
+    }
+    std::optional<Id> currentObject;
+    auto finishGroup = [&]() {
+      if (currentObject.has_value() &&
+          builder.numSubjects() >= patternTrickAggregatesMinSize_) {
+        aggregates.add(relation.col0Id_, currentObject.value(),
+                       builder.finish());
+      } else {
+        builder.finish();
+      }
+    };
+    // The scan of a predicate in the POS permutation is sorted by the objects
+    // (the first column) and then by the subjects.
+    for (const auto& block :
+         pos.lazyScan(relation.col0Id_, std::nullopt, std::nullopt, {},
+                      cancellationHandle)) {
+      std::span<const Id> objects = block.getColumn(0);
+      std::span<const Id> subjects = block.getColumn(1);
+      size_t groupBegin = 0;
+      while (groupBegin < block.numRows()) {
+        Id object = objects[groupBegin];
+        size_t groupEnd =
+            std::ranges::upper_bound(objects.subspan(groupBegin), object) -
+            objects.begin();
+        if (currentObject != object) {
+          finishGroup();
+          currentObject = object;
+        }
+        builder.add(subjects.subspan(groupBegin, groupEnd - groupBegin));
+        groupBegin = groupEnd;
+      }
+    }
+    finishGroup();
+  }
+  LOG(INFO) << "Number of groups with a precomputed result of the pattern "
+               "trick: "
+            << aggregates.size() << std::endl;
+  aggregates.writeToFile(
+      absl::StrCat(onDiskBase_, PatternTrickAggregates::FILE_SUFFIX));
+  configurationJson_["has-pattern-trick-aggregates"] = true;
+  writeConfiguration();
 }
 
 // _____________________________________________________________________________
@@ -352,9 +778,14 @@ IndexBuilderDataAsStxxlVector IndexImpl::passFileForVocabulary(
     std::shared_ptr<TurtleParserBase> parser, size_t linesPerPartial) {
   parser->integerOverflowBehavior() = turtleParserIntegerOverflowBehavior_;
   parser->invalidLiteralsAreSkipped() = turtleParserSkipIllegalLiterals_;
+  // For an index that is built in memory, the triples are never written to
+  // disk.
   ad_utility::Synchronized<std::unique_ptr<TripleVec>> idTriples(
-      std::make_unique<TripleVec>(onDiskBase_ + ".unsorted-triples.dat", 1_GB,
-                                  allocator_));
+      std::make_unique<TripleVec>(
+          onDiskBase_ + ".unsorted-triples.dat",
+          numTriplesOfInMemoryBuild_.has_value() ? memoryLimitIndexBuilding()
+                                                 : 1_GB,
+          allocator_));
   bool parserExhausted = false;
 
   size_t i = 0;
@@ -369,6 +800,10 @@ IndexBuilderDataAsStxxlVector IndexImpl::passFileForVocabulary(
   // batch of triples and partial vocabulary.
   std::array<std::future<void>, 3> writePartialVocabularyFuture;
 
+  // The parsing and the writing of the partial vocabularies overlap, so they
+  // are measured as a single stage.
+  std::optional<BuildStage> stage;
+  stage.emplace(buildStageObserver_, "parse");
   ad_utility::CachingMemoryResource cachingMemoryResource;
   ItemAlloc itemAlloc(&cachingMemoryResource);
   while (!parserExhausted) {
@@ -390,10 +825,12 @@ IndexBuilderDataAsStxxlVector IndexImpl::passFileForVocabulary(
                         [&]() { parserExhausted = true; }),
           // get the Ids for the original triple and the possibly added language
           // Tag triples using the provided HashMaps via itemArray. See
-          // documentation of the function for more details
-          getIdMapLambdas<NUM_PARALLEL_ITEM_MAPS>(&itemArray, linesPerPartial,
-                                                  &(vocab_.getCaseComparator()),
-                                                  this, itemAlloc));
+          // documentation of the function for more details. Each map assigns
+          // the IDs from its own range, so the triples can be distributed
+          // dynamically between them.
+          ad_pipeline::loadBalanced(getIdMapLambdas<NUM_PARALLEL_ITEM_MAPS>(
+              &itemArray, linesPerPartial, &(vocab_.getCaseComparator()), this,
+              itemAlloc)));
 
       while (auto opt = p.getNextValue()) {
         i++;
@@ -407,11 +844,14 @@ IndexBuilderDataAsStxxlVector IndexImpl::passFileForVocabulary(
           LOG(INFO) << "Input triples processed: " << i << std::endl;
         }
       }
-      LOG(TIMING) << "WaitTimes for Pipeline in msecs\n";
-      for (const auto& t : p.getWaitingTime()) {
-        LOG(TIMING)
-            << std::chrono::duration_cast<std::chrono::milliseconds>(t).count()
-            << " msecs" << std::endl;
+      // The stages are the parser and the mapping to IDs.
+      LOG(TIMING) << "Statistics of the stages of the pipeline:\n";
+      for (const auto& stage : p.getStatistics()) {
+        LOG(TIMING) << stage.numElements_ << " elements in "
+                    << stage.busyTime_.count() << " ms ("
+                    << static_cast<size_t>(stage.elementsPerSecond())
+                    << " per second), the next stage waited "
+                    << stage.waitingTime_.count() << " ms" << std::endl;
       }
 
       parser->printAndResetQueueStatistics();
@@ -460,6 +900,7 @@ IndexBuilderDataAsStxxlVector IndexImpl::passFileForVocabulary(
             << (*idTriples.wlock())->size() << " [may contain duplicates]"
             << std::endl;
 
+  stage.emplace(buildStageObserver_, "merge-vocabulary");
   size_t sizeInternalVocabulary = 0;
   std::vector<std::string> prefixes;
   if (vocabPrefixCompressed_) {
@@ -496,9 +937,13 @@ IndexBuilderDataAsStxxlVector IndexImpl::passFileForVocabulary(
             << "(internal and external) ..." << std::endl;
   const VocabularyMerger::VocabularyMetaData mergeRes = [&]() {
     VocabularyMerger v;
-    auto sortPred = [cmp = &(vocab_.getCaseComparator())](std::string_view a,
-                                                          std::string_view b) {
-      return (*cmp)(a, b, decltype(vocab_)::SortLevel::TOTAL);
+    // The partial vocabularies contain the sort keys of the words on the
+    // `TOTAL` level, so no ICU collation is needed for the merge.
+    auto sortPred = [](const TripleComponentWithIndex& a,
+                       const TripleComponentWithIndex& b) {
+      return TripleComponentComparator::compareWithSortKeys(
+                 a.iriOrLiteral(), a.sortKey(), b.iriOrLiteral(),
+                 b.sortKey()) < 0;
     };
     auto wordWriter =
         vocab_.makeUncompressingWordWriter(onDiskBase_ + INTERNAL_VOCAB_SUFFIX);
@@ -557,7 +1002,7 @@ IndexImpl::convertPartialToGlobalIds(
   auto triplesGenerator = data.getRows();
   auto it = triplesGenerator.begin();
   using Buffer = IdTableStatic<3>;
-  using Map = ad_utility::HashMap<Id, Id>;
+  using Map = PartialToGlobalIdMap;
 
   ad_utility::TaskQueue<true> lookupQueue(30, 10,
                                           "looking up local to global IDs");
@@ -569,15 +1014,10 @@ IndexImpl::convertPartialToGlobalIds(
   // For all triple elements find their mapping from partial to global ids.
   auto transformTriple = [](Buffer::row_reference& curTriple, auto& idMap) {
     for (auto& id : curTriple) {
-      // TODO<joka92> Since the mapping only maps `VocabIndex->VocabIndex`,
-      // probably the mapping should also be defined as `HashMap<VocabIndex,
-      // VocabIndex>` instead of `HashMap<Id, Id>`
       if (id.getDatatype() != Datatype::VocabIndex) {
         continue;
       }
-      auto iterator = idMap.find(id);
-      AD_CORRECTNESS_CHECK(iterator != idMap.end());
-      id = iterator->second;
+      id = idMap(id);
     }
   };
 
@@ -624,8 +1064,9 @@ IndexImpl::convertPartialToGlobalIds(
       return std::nullopt;
     }
     std::string mmapFilename = absl::StrCat(onDiskBase_, PARTIAL_MMAP_IDS, idx);
-    auto map = IdMapFromPartialIdMapFile(mmapFilename);
-    // Delete the temporary file in which we stored this map
+    Map map{mmapFilename};
+    // Delete the temporary file in which we stored this map. It remains
+    // readable via the memory mapping until the `map` is destroyed.
     deleteTemporaryFile(mmapFilename);
     return std::pair{idx, std::move(map)};
   };
@@ -685,12 +1126,24 @@ IndexImpl::createPermutationPairImpl(size_t numColumns, const string& fileName1,
   metaData1.setup(fileName1 + MMAP_FILE_SUFFIX, ad_utility::CreateTag{});
   metaData2.setup(fileName2 + MMAP_FILE_SUFFIX, ad_utility::CreateTag{});
 
+  // Only the blocks of the large relations of the PSO and POS permutations
+  // (where the predicate is the first column) grow with the size of the
+  // relation.
+  auto largeRelationsBlocksize = permutation[0] == 1
+                                     ? largeRelationsBlocksizePerColumn_
+                                     : blocksizePermutationPerColumn_;
   CompressedRelationWriter writer1{numColumns - 1,
                                    ad_utility::File(fileName1, "w"),
-                                   blocksizePermutationPerColumn_};
+                                   blocksizePermutationPerColumn_,
+                                   bloomFilterBitsPerKey_,
+                                   smallRelationsBlocksizePerColumn_,
+                                   largeRelationsBlocksize};
   CompressedRelationWriter writer2{numColumns - 1,
                                    ad_utility::File(fileName2, "w"),
-                                   blocksizePermutationPerColumn_};
+                                   blocksizePermutationPerColumn_,
+                                   bloomFilterBitsPerKey_,
+                                   smallRelationsBlocksizePerColumn_,
+                                   largeRelationsBlocksize};
 
   // Lift a callback that works on single elements to a callback that works on
   // blocks.
@@ -707,10 +1160,12 @@ IndexImpl::createPermutationPairImpl(size_t numColumns, const string& fileName1,
   std::vector<std::function<void(const IdTableStatic<0>&)>> perBlockCallbacks{
       liftCallback(perTripleCallbacks)...};
 
-  std::tie(metaData1.blockData(), metaData2.blockData()) =
+  auto [blockData1, blockData2] =
       CompressedRelationWriter::createPermutationPair(
           fileName1, {writer1, callback1}, {writer2, callback2},
           AD_FWD(sortedTriples), permutation, perBlockCallbacks);
+  metaData1.setBlockData(std::move(blockData1));
+  metaData2.setBlockData(std::move(blockData2));
 
   // There previously was a bug in the CompressedIdTableSorter that lead to
   // semantically correct blocks, but with too large block sizes for the twin
@@ -745,6 +1200,10 @@ void IndexImpl::createPermutationPair(size_t numColumns, auto&& sortedTriples,
                                       const Permutation& p1,
                                       const Permutation& p2,
                                       auto&&... perTripleCallbacks) {
+  // The sorting of the triples is lazy, so it is part of this stage.
+  BuildStage stage{buildStageObserver_,
+                   absl::StrCat("permutations-", p1.readableName_, "-",
+                                p2.readableName_)};
   auto [metaData1, metaData2] = createPermutations(
       numColumns, AD_FWD(sortedTriples), p1, p2, AD_FWD(perTripleCallbacks)...);
   // Set the name of this newly created pair of `IndexMetaData` objects.
@@ -767,43 +1226,128 @@ void IndexImpl::createPermutationPair(size_t numColumns, auto&& sortedTriples,
 void IndexImpl::createFromOnDiskIndex(const string& onDiskBase) {
   setOnDiskBase(onDiskBase);
   readConfiguration();
-  vocab_.readFromFile(onDiskBase_ + INTERNAL_VOCAB_SUFFIX,
-                      onDiskBase_ + EXTERNAL_VOCAB_SUFFIX);
-
-  totalVocabularySize_ = vocab_.size() + vocab_.getExternalVocab().size();
-  LOG(DEBUG) << "Number of words in internal and external vocabulary: "
-             << totalVocabularySize_ << std::endl;
 
-  pso_.loadFromDisk(onDiskBase_);
-  pos_.loadFromDisk(onDiskBase_);
+  // The vocabulary, the permutations, and the other data structures are
+  // independent of each other, so they are loaded concurrently. The rarely
+  // used SOP and OSP permutations are loaded in the background, s.t. the
+  // queries that don't need them can already be answered (see
+  // `getPermutation`, which waits for them).
+  std::vector<std::function<void()>> loadingTasks;
+  loadingTasks.push_back([this] {
+    vocab_.readFromFile(onDiskBase_ + INTERNAL_VOCAB_SUFFIX,
+                        onDiskBase_ + EXTERNAL_VOCAB_SUFFIX);
+    totalVocabularySize_ = vocab_.size() + vocab_.getExternalVocab().size();
+    LOG(DEBUG) << "Number of words in internal and external vocabulary: "
+               << totalVocabularySize_ << std::endl;
+  });
+  loadingTasks.push_back([this] { pso_.loadFromDisk(onDiskBase_); });
+  loadingTasks.push_back([this] { pos_.loadFromDisk(onDiskBase_); });
 
   if (loadAllPermutations_) {
-    ops_.loadFromDisk(onDiskBase_);
-    osp_.loadFromDisk(onDiskBase_);
-    spo_.loadFromDisk(onDiskBase_);
-    sop_.loadFromDisk(onDiskBase_);
+    loadingTasks.push_back([this] { spo_.loadFromDisk(onDiskBase_); });
+    loadingTasks.push_back([this] { ops_.loadFromDisk(onDiskBase_); });
+    backgroundLoading_ = std::async(std::launch::async, [this] {
+                           ad_utility::runConcurrently(2, [this](size_t i) {
+                             (i == 0 ? sop_ : osp_).loadFromDisk(onDiskBase_);
+                           });
+                         }).share();
   } else {
     LOG(INFO) << "Only the PSO and POS permutation were loaded, SPARQL queries "
                  "with predicate variables will therefore not work"
               << std::endl;
   }
 
-  if (usePatterns_) {
-    try {
-      PatternCreator::readPatternsFromFile(
-          onDiskBase_ + ".index.patterns", avgNumDistinctSubjectsPerPredicate_,
-          avgNumDistinctPredicatesPerSubject_,
-          numDistinctSubjectPredicatePairs_, patterns_, hasPattern_);
-    } catch (const std::exception& e) {
-      LOG(WARN) << "Could not load the patterns. The internal predicate "
-                   "`ql:has-predicate` is therefore not available (and certain "
-                   "queries that benefit from that predicate will be slower)."
-                   "To suppress this warning, start the server with "
-                   "the `--no-patterns` option. The error message was "
-                << e.what() << std::endl;
-      usePatterns_ = false;
+  // The patterns and the data structures that depend on them.
+  loadingTasks.push_back([this] {
+    if (usePatterns_) {
+      try {
+        PatternCreator::readPatternsFromFile(
+            onDiskBase_ + ".index.patterns",
+            avgNumDistinctSubjectsPerPredicate_,
+            avgNumDistinctPredicatesPerSubject_,
+            numDistinctSubjectPredicatePairs_, patterns_, hasPattern_);
+      } catch (const std::exception& e) {
+        LOG(WARN)
+            << "Could not load the patterns. The internal predicate "
+               "`ql:has-predicate` is therefore not available (and certain "
+               "queries that benefit from that predicate will be slower)."
+               "To suppress this warning, start the server with "
+               "the `--no-patterns` option. The error message was "
+            << e.what() << std::endl;
+        usePatterns_ = false;
+      }
     }
-  }
+    if (usePatterns_) {
+      auto filename = absl::StrCat(onDiskBase_, ".index.patterns",
+                                   CharacteristicSets::FILE_SUFFIX);
+      try {
+        characteristicSets_ = CharacteristicSets::readFromFile(filename);
+        LOG(INFO) << "Number of characteristic sets: "
+                  << characteristicSets_.size() << std::endl;
+      } catch (const std::exception& e) {
+        // Indices that were built by older versions of QLever have no
+        // characteristic sets. They are only used for the size estimates.
+        LOG(INFO) << "Could not load the characteristic sets, the size "
+                     "estimates of star-shaped joins will be less precise: "
+                  << e.what() << std::endl;
+      }
+    }
+    if (usePatterns_ &&
+        configurationJson_.value("has-pattern-trick-aggregates", false)) {
+      patternTrickAggregates_ = PatternTrickAggregates::readFromFile(
+          absl::StrCat(onDiskBase_, PatternTrickAggregates::FILE_SUFFIX));
+      LOG(INFO) << "Number of groups with a precomputed result of the pattern "
+                   "trick: "
+                << patternTrickAggregates_.size() << std::endl;
+    }
+  });
+  loadingTasks.push_back([this] {
+    if (configurationJson_.value("has-transitive-closures", false)) {
+      transitiveClosures_ = TransitiveClosures::readFromFile(
+          absl::StrCat(onDiskBase_, TransitiveClosures::FILE_SUFFIX));
+      LOG(INFO)
+          << "Number of predicates with a precomputed transitive closure: "
+          << transitiveClosures_.size() << std::endl;
+    }
+  });
+  loadingTasks.push_back([this] {
+    if (configurationJson_.value("has-predicate-histograms", false)) {
+      predicateHistograms_ = PredicateHistograms::readFromFile(
+          absl::StrCat(onDiskBase_, PredicateHistograms::FILE_SUFFIX));
+      LOG(INFO) << "Number of predicates with a histogram of their objects: "
+                << predicateHistograms_.size() << std::endl;
+    }
+  });
+  loadingTasks.push_back([this] {
+    if (configurationJson_.value("has-vocabulary-values", false)) {
+      vocabularyValues_ = VocabularyValues::readFromFile(
+          absl::StrCat(onDiskBase_, VocabularyValues::FILE_SUFFIX));
+      LOG(INFO) << "Number of literals in the vocabulary with a precomputed "
+                   "value: "
+                << vocabularyValues_.size() << std::endl;
+    }
+  });
+  loadingTasks.push_back([this] {
+    if (configurationJson_.value("has-geo-points", false)) {
+      geoPoints_ = GeoPoints::readFromFile(
+          absl::StrCat(onDiskBase_, GeoPoints::FILE_SUFFIX));
+      LOG(INFO) << "Number of WKT points in the vocabulary: "
+                << geoPoints_.size() << std::endl;
+    }
+  });
+
+  loadingTasks.push_back([this] {
+    if (configurationJson_.value("has-trigram-index", false)) {
+      trigramIndex_ = TrigramIndex::readFromFile(
+          absl::StrCat(onDiskBase_, TrigramIndex::FILE_SUFFIX));
+      LOG(INFO) << "Number of distinct trigrams of the literals: "
+                << trigramIndex_.size() << std::endl;
+    }
+  });
+
+  ad_utility::runConcurrently(loadingTasks.size(), [&loadingTasks](size_t i) {
+    loadingTasks.at(i)();
+  });
 }
 
 // _____________________________________________________________________________
@@ -816,7 +1360,7 @@ void IndexImpl::throwExceptionIfNoPatterns() const {
 }
 
 // _____________________________________________________________________________
-const vector<PatternID>& IndexImpl::getHasPattern() const {
+const CompressedPatternIds& IndexImpl::getHasPattern() const {
   throwExceptionIfNoPatterns();
   return hasPattern_;
 }
@@ -877,10 +1421,10 @@ bool IndexImpl::isLiteral(const string& object) const {
 void IndexImpl::setKbName(const string& name) {
   pos_.setKbName(name);
   pso_.setKbName(name);
-  sop_.setKbName(name);
+  SOP().setKbName(name);
   spo_.setKbName(name);
   ops_.setKbName(name);
-  osp_.setKbName(name);
+  OSP().setKbName(name);
 }
 
 // ____________________________________________________________________________
@@ -989,6 +1533,10 @@ void IndexImpl::readConfiguration() {
         configurationJson_["prefixes-external"]);
   }
 
+  if (configurationJson_.find("prefixes-encoded") != configurationJson_.end()) {
+    vocab_.initializeEncodedIriPrefixes(configurationJson_["prefixes-encoded"]);
+  }
+
   if (configurationJson_.count("ignore-case")) {
     LOG(ERROR) << ERROR_IGNORE_CASE_UNSUPPORTED << '\n';
     throw std::runtime_error("Deprecated key \"ignore-case\" in index build");
@@ -1071,7 +1619,16 @@ LangtagAndTriple IndexImpl::tripleToInternalRepresentation(
     }
     auto& component = std::get<PossiblyExternalizedIriOrLiteral>(el);
     auto& iriOrLiteral = component.iriOrLiteral_;
-    iriOrLiteral = vocab_.getLocaleManager().normalizeUtf8(iriOrLiteral);
+    vocab_.getLocaleManager().normalizeUtf8InPlace(iriOrLiteral);
+    // IRIs with one of the configured prefixes are encoded directly into the
+    // `Id`. The predicate is excluded because the language-tagged predicates
+    // are created from its string.
+    if (i != 1) {
+      if (auto id = vocab_.getEncodedIriManager().encode(iriOrLiteral)) {
+        el = id.value();
+        continue;
+      }
+    }
     if (vocab_.shouldBeExternalized(iriOrLiteral)) {
       component.isExternal_ = true;
     }
@@ -1097,6 +1654,11 @@ void IndexImpl::readIndexBuilderSettingsFromFile() {
     configurationJson_["prefixes-external"] = j["prefixes-external"];
   }
 
+  if (j.find("prefixes-encoded") != j.end()) {
+    vocab_.initializeEncodedIriPrefixes(j["prefixes-encoded"]);
+    configurationJson_["prefixes-encoded"] = j["prefixes-encoded"];
+  }
+
   if (j.count("ignore-case")) {
     LOG(ERROR) << ERROR_IGNORE_CASE_UNSUPPORTED << '\n';
     throw std::runtime_error("Deprecated key \"ignore-case\" in settings JSON");
@@ -1160,14 +1722,108 @@ void IndexImpl::readIndexBuilderSettingsFromFile() {
     LOG(INFO) << WARNING_PARALLEL_PARSING << std::endl;
   }
 
+  if (j.count("parallel-permutations")) {
+    parallelPermutations_ = static_cast<bool>(j["parallel-permutations"]);
+    LOG(INFO) << "You specified \"parallel-permutations = "
+              << parallelPermutations_
+              << "\", the last two pairs of permutations are then created in "
+                 "parallel (if no patterns are built)"
+              << std::endl;
+  }
+
   if (j.count("num-triples-per-batch")) {
     numTriplesPerBatch_ = size_t{j["num-triples-per-batch"]};
     LOG(INFO)
-        << "You specified \"num-triples-per-batch = " << numTriplesPerBatch_
+        << "You specified \"num-triples-per-batch = "
+        << numTriplesPerBatch_.value()
         << "\", choose a lower value if the index builder runs out of memory"
         << std::endl;
   }
 
+  if (j.count("blocksize-small-relations")) {
+    smallRelationsBlocksizePerColumn_ = ad_utility::MemorySize::parse(
+        static_cast<std::string>(j["blocksize-small-relations"]));
+    LOG(INFO) << "You specified \"blocksize-small-relations = "
+              << smallRelationsBlocksizePerColumn_.asString()
+              << "\", this is the uncompressed size of a single column of the "
+                 "blocks that are shared by several small relations"
+              << std::endl;
+  }
+
+  if (j.count("blocksize-large-relations")) {
+    largeRelationsBlocksizePerColumn_ = ad_utility::MemorySize::parse(
+        static_cast<std::string>(j["blocksize-large-relations"]));
+    LOG(INFO) << "You specified \"blocksize-large-relations = "
+              << largeRelationsBlocksizePerColumn_.asString()
+              << "\", this is the maximal uncompressed size of a single column "
+                 "of the blocks of the large relations of the PSO and POS "
+                 "permutations"
+              << std::endl;
+  }
+
+  if (j.count("bloom-filter-bits-per-key")) {
+    bloomFilterBitsPerKey_ = size_t{j["bloom-filter-bits-per-key"]};
+    LOG(INFO) << "You specified \"bloom-filter-bits-per-key = "
+              << bloomFilterBitsPerKey_
+              << "\", the blocks of the permutations get Bloom filters, which "
+                 "speed up lookups that find nothing (0 means no Bloom filters)"
+              << std::endl;
+  }
+
+  if (j.count("transitive-closure-predicates")) {
+    transitiveClosurePredicates_ =
+        std::vector<std::string>(j["transitive-closure-predicates"]);
+    LOG(INFO) << "The transitive closures of the following predicates will be "
+                 "precomputed: "
+              << absl::StrJoin(transitiveClosurePredicates_, ", ")
+              << std::endl;
+  }
+
+  if (j.count("predicate-histograms")) {
+    computePredicateHistograms_ = bool{j["predicate-histograms"]};
+    if (computePredicateHistograms_) {
+      LOG(INFO) << "The histograms of the objects of the predicates will be "
+                   "precomputed for the size estimates of FILTERs"
+                << std::endl;
+    }
+  }
+
+  if (j.count("vocabulary-values")) {
+    computeVocabularyValues_ = bool{j["vocabulary-values"]};
+    if (computeVocabularyValues_) {
+      LOG(INFO) << "The values of the numeric and date literals that are "
+                   "stored in the vocabulary will be precomputed"
+                << std::endl;
+    }
+  }
+
+  if (j.count("geo-points")) {
+    computeGeoPoints_ = bool{j["geo-points"]};
+    if (computeGeoPoints_) {
+      LOG(INFO) << "The coordinates of the WKT points that are stored in the "
+                   "vocabulary will be precomputed"
+                << std::endl;
+    }
+  }
+
+  if (j.count("trigram-index")) {
+    computeTrigramIndex_ = bool{j["trigram-index"]};
+    if (computeTrigramIndex_) {
+      LOG(INFO) << "A trigram index of the literals in the vocabulary will be "
+                   "built for substring filters"
+                << std::endl;
+    }
+  }
+
+  if (j.count("pattern-trick-aggregates-min-size")) {
+    patternTrickAggregatesMinSize_ =
+        size_t{j["pattern-trick-aggregates-min-size"]};
+    LOG(INFO) << "The results of the pattern trick will be precomputed for "
+                 "the groups of triples with the same predicate and object "
+                 "and at least "
+              << patternTrickAggregatesMinSize_ << " subjects" << std::endl;
+  }
+
   if (j.count("parser-batch-size")) {
     parserBatchSize_ = size_t{j["parser-batch-size"]};
     LOG(INFO) << "Overriding setting parser-batch-size to " << parserBatchSize_
@@ -1293,7 +1949,7 @@ std::future<void> IndexImpl::writeNextPartialVocabulary(
             [](const auto& a, const auto& b) { return a.first < b.first; },
             true);
       }
-      writePartialVocabularyToFile(vec, partialCompressionFilename);
+      writePartialVocabularyToFile(vec, partialCompressionFilename, false);
     }
     LOG(TRACE) << "Finished writing the partial vocabulary" << std::endl;
     vec.clear();
@@ -1314,6 +1970,10 @@ IndexImpl::NumNormalAndInternal IndexImpl::numTriples() const {
 // ____________________________________________________________________________
 Permutation& IndexImpl::getPermutation(Permutation::Enum p) {
   using enum Permutation::Enum;
+  if ((p == SOP || p == OSP) && backgroundLoading_.valid()) {
+    // Rethrows the exception if the loading failed.
+    backgroundLoading_.get();
+  }
   switch (p) {
     case PSO:
       return pso_;
@@ -1353,7 +2013,7 @@ Index::NumNormalAndInternal IndexImpl::numDistinctSubjects() const {
 Index::NumNormalAndInternal IndexImpl::numDistinctObjects() const {
   if (hasAllPermutations()) {
     auto numActually = numObjectsNormal_;
-    return {numActually, osp_.metaData().getNofDistinctC1() - numActually};
+    return {numActually, OSP().metaData().getNofDistinctC1() - numActually};
   } else {
     AD_THROW(
         "Can only get # distinct objects if all 6 permutations "
@@ -1388,11 +2048,13 @@ Index::NumNormalAndInternal IndexImpl::numDistinctCol0(
 
 // ___________________________________________________________________________
 size_t IndexImpl::getCardinality(Id id, Permutation::Enum permutation) const {
+  size_t cardinality = 0;
   if (const auto& p = getPermutation(permutation);
       p.metaData().col0IdExists(id)) {
-    return p.metaData().getMetaData(id).getNofElements();
+    cardinality = p.metaData().getMetaData(id).getNofElements();
   }
-  return 0;
+  auto delta = deltaTriples_.getCounts(permutation, id, std::nullopt);
+  return cardinality + delta.numInserted_ - delta.numDeleted_;
 }
 
 // ___________________________________________________________________________
@@ -1406,7 +2068,8 @@ size_t IndexImpl::getCardinality(const TripleComponent& comp,
   if (comp == INTERNAL_TEXT_MATCH_PREDICATE) {
     return TEXT_PREDICATE_CARDINALITY_ESTIMATE;
   }
-  if (std::optional<Id> relId = comp.toValueId(getVocab()); relId.has_value()) {
+  if (std::optional<Id> relId = toValueIdIncludingDeltaTriples(comp);
+      relId.has_value()) {
     return getCardinality(relId.value(), permutation);
   }
   return 0;
@@ -1426,6 +2089,10 @@ std::optional<string> IndexImpl::idToOptionalString(WordVocabIndex id) const {
 bool IndexImpl::getId(const string& element, Id* id) const {
   // TODO<joka921> we should parse doubles correctly in the SparqlParser and
   // then return the correct ids here or somewhere else.
+  if (auto encodedIri = getVocab().getEncodedIriManager().encode(element)) {
+    *id = encodedIri.value();
+    return true;
+  }
   VocabIndex vocabId;
   auto success = getVocab().getId(element, &vocabId);
   *id = Id::makeFromVocabIndex(vocabId);
@@ -1475,10 +2142,11 @@ IdTable IndexImpl::scan(
     const Permutation::Enum& permutation,
     Permutation::ColumnIndicesRef additionalColumns,
     ad_utility::SharedCancellationHandle cancellationHandle) const {
-  std::optional<Id> col0Id = col0String.toValueId(getVocab());
+  std::optional<Id> col0Id = toValueIdIncludingDeltaTriples(col0String);
   std::optional<Id> col1Id =
-      col1String.has_value() ? col1String.value().get().toValueId(getVocab())
-                             : std::nullopt;
+      col1String.has_value()
+          ? toValueIdIncludingDeltaTriples(col1String.value().get())
+          : std::nullopt;
   if (!col0Id.has_value() || (col1String.has_value() && !col1Id.has_value())) {
     size_t numColumns = col1String.has_value() ? 1 : 2;
     return IdTable{numColumns, allocator_};
@@ -1491,21 +2159,34 @@ IdTable IndexImpl::scan(
     Id col0Id, std::optional<Id> col1Id, Permutation::Enum p,
     Permutation::ColumnIndicesRef additionalColumns,
     ad_utility::SharedCancellationHandle cancellationHandle) const {
-  return getPermutation(p).scan(col0Id, col1Id, additionalColumns,
-                                std::move(cancellationHandle));
+  auto result = getPermutation(p).scan(col0Id, col1Id, additionalColumns,
+                                       std::move(cancellationHandle));
+  deltaTriples_.mergeIntoScan(p, col0Id, col1Id, result);
+  return result;
+}
+
+// _____________________________________________________________________________
+std::optional<Id> IndexImpl::toValueIdIncludingDeltaTriples(
+    const TripleComponent& component) const {
+  if (auto id = component.toValueId(getVocab()); id.has_value()) {
+    return id;
+  }
+  return deltaTriples_.getLocalVocabId(component);
 }
 
 // _____________________________________________________________________________
 size_t IndexImpl::getResultSizeOfScan(
     const TripleComponent& col0, const TripleComponent& col1,
     const Permutation::Enum& permutation) const {
-  std::optional<Id> col0Id = col0.toValueId(getVocab());
-  std::optional<Id> col1Id = col1.toValueId(getVocab());
+  std::optional<Id> col0Id = toValueIdIncludingDeltaTriples(col0);
+  std::optional<Id> col1Id = toValueIdIncludingDeltaTriples(col1);
   if (!col0Id.has_value() || !col1Id.has_value()) {
     return 0;
   }
   const Permutation& p = getPermutation(permutation);
-  return p.getResultSizeOfScan(col0Id.value(), col1Id.value());
+  auto delta = deltaTriples_.getCounts(permutation, col0Id, col1Id);
+  return p.getResultSizeOfScan(col0Id.value(), col1Id.value()) +
+         delta.numInserted_ - delta.numDeleted_;
 }
 
 // _____________________________________________________________________________
@@ -1558,6 +2239,7 @@ void IndexImpl::createPSOAndPOS(size_t numColumns, auto& isInternalId,
       nextSorter.makePushCallback()...,
       makeNumDistinctIdsCounter<1>(numPredicatesNormal, isInternalId),
       countTriplesNormal);
+  std::lock_guard lock{configurationMutex_};
   configurationJson_["num-predicates-normal"] = numPredicatesNormal;
   configurationJson_["num-triples-normal"] = numTriplesNormal;
   writeConfiguration();
@@ -1565,7 +2247,7 @@ void IndexImpl::createPSOAndPOS(size_t numColumns, auto& isInternalId,
 
 // _____________________________________________________________________________
 template <typename... NextSorter>
-requires(sizeof...(NextSorter) <= 1)
+requires(sizeof...(NextSorter) <= 2)
 std::optional<PatternCreatorNew::TripleSorter> IndexImpl::createSPOAndSOP(
     size_t numColumns, auto& isInternalId, BlocksOfTriples sortedTriples,
     NextSorter&&... nextSorter) {
@@ -1599,7 +2281,7 @@ std::optional<PatternCreatorNew::TripleSorter> IndexImpl::createSPOAndSOP(
     writeConfiguration();
     result = std::move(patternCreator).getTripleSorter();
   } else {
-    AD_CORRECTNESS_CHECK(sizeof...(nextSorter) == 1);
+    AD_CORRECTNESS_CHECK(sizeof...(nextSorter) >= 1);
     createPermutationPair(numColumns, AD_FWD(sortedTriples), spo_, sop_,
                           nextSorter.makePushCallback()..., numSubjectCounter);
   }
@@ -1621,6 +2303,7 @@ void IndexImpl::createOSPAndOPS(size_t numColumns, auto& isInternalId,
       numColumns, AD_FWD(sortedTriples), osp_, ops_,
       nextSorter.makePushCallback()...,
       makeNumDistinctIdsCounter<2>(numObjectsNormal, isInternalId));
+  std::lock_guard lock{configurationMutex_};
   configurationJson_["num-objects-normal"] = numObjectsNormal;
   configurationJson_["has-all-permutations"] = true;
   writeConfiguration();
@@ -1628,7 +2311,9 @@ void IndexImpl::createOSPAndOPS(size_t numColumns, auto& isInternalId,
 
 // _____________________________________________________________________________
 template <typename Comparator, size_t I, bool returnPtr>
-auto IndexImpl::makeSorterImpl(std::string_view permutationName) const {
+auto IndexImpl::makeSorterImpl(
+    std::string_view permutationName,
+    std::optional<size_t> numSortersAtSameTime) const {
   using Sorter = ExternalSorter<Comparator, I>;
   auto apply = [](auto&&... args) {
     if constexpr (returnPtr) {
@@ -1637,20 +2322,33 @@ auto IndexImpl::makeSorterImpl(std::string_view permutationName) const {
       return Sorter{AD_FWD(args)...};
     }
   };
+  auto memory =
+      memoryLimitIndexBuilding() /
+      numSortersAtSameTime.value_or(NUM_EXTERNAL_SORTERS_AT_SAME_TIME);
+  if (numTriplesOfInMemoryBuild_.has_value()) {
+    // Size the sorter s.t. all its rows fit into a single block, which is then
+    // sorted in RAM (see `CompressedExternalIdTableBase::blocksize_`) and only
+    // reserved for the actual number of rows. The sorters with the patterns
+    // additionally contain the `ql:has-pattern` triples, so there are at most
+    // twice as many rows as triples.
+    memory = ad_utility::MemorySize::bytes(
+        (2 * numTriplesOfInMemoryBuild_.value() + 1) * I * sizeof(Id) * 2);
+  }
   return apply(absl::StrCat(onDiskBase_, ".", permutationName, "-sorter.dat"),
-               memoryLimitIndexBuilding() / NUM_EXTERNAL_SORTERS_AT_SAME_TIME,
-               allocator_);
+               memory, allocator_);
 }
 
 // _____________________________________________________________________________
 template <typename Comparator, size_t I>
 ExternalSorter<Comparator, I> IndexImpl::makeSorter(
-    std::string_view permutationName) const {
-  return makeSorterImpl<Comparator, I, false>(permutationName);
+    std::string_view permutationName,
+    std::optional<size_t> numSortersAtSameTime) const {
+  return makeSorterImpl<Comparator, I, false>(permutationName,
+                                              numSortersAtSameTime);
 }
 // _____________________________________________________________________________
 template <typename Comparator, size_t I>
 std::unique_ptr<ExternalSorter<Comparator, I>> IndexImpl::makeSorterPtr(
     std::string_view permutationName) const {
-  return makeSorterImpl<Comparator, I, true>(permutationName);
+  return makeSorterImpl<Comparator, I, true>(permutationName, std::nullopt);
 }
@@ -10,20 +10,28 @@
 #include <global/SpecialIds.h>
 #include <index/CompressedRelation.h>
 #include <index/ConstantsIndexBuilding.h>
+#include <index/DeltaTriples.h>
 #include <index/DocsDB.h>
 #include <index/Index.h>
 #include <index/IndexBuilderTypes.h>
 #include <index/IndexMetaData.h>
+#include <index/CharacteristicSets.h>
+#include <index/CompressedPatternIds.h>
+#include <index/GeoPoints.h>
 #include <index/PatternCreator.h>
+#include <index/PatternTrickAggregates.h>
+#include <index/PredicateHistograms.h>
 #include <index/Permutation.h>
 #include <index/StxxlSortFunctors.h>
 #include <index/TextMetaData.h>
+#include <index/TransitiveClosures.h>
+#include <index/TrigramIndex.h>
 #include <index/Vocabulary.h>
+#include <index/VocabularyValues.h>
 #include <index/VocabularyGenerator.h>
 #include <parser/ContextFileParser.h>
 #include <parser/TripleComponent.h>
 #include <parser/TurtleParser.h>
-#include <util/BackgroundStxxlSorter.h>
 #include <util/BufferedVector.h>
 #include <util/CompressionUsingZstd/ZstdWrapper.h>
 #include <util/File.h>
@@ -34,11 +42,14 @@
 
 #include <array>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
-#include <stxxl/sorter>
-#include <stxxl/stream>
+#include <string_view>
 #include <stxxl/vector>
 #include <vector>
 
@@ -102,9 +113,10 @@ struct IndexBuilderDataAsFirstPermutationSorter : IndexBuilderDataBase {
 class IndexImpl {
  public:
   using TripleVec = ad_utility::CompressedExternalIdTable<3>;
-  // Block Id, Context Id, Word Id, Score, entity
-  using TextVec = stxxl::vector<
-      tuple<TextBlockIndex, TextRecordIndex, WordOrEntityIndex, Score, bool>>;
+  // The postings of the text index while it is built, with the columns block,
+  // entity flag, context, word or entity, and score (see `SortText`).
+  static constexpr size_t NUM_COLUMNS_TEXT_VEC = 5;
+  using TextVec = ExternalSorter<SortText, NUM_COLUMNS_TEXT_VEC>;
   using Posting = std::tuple<TextRecordIndex, WordIndex, Score>;
 
   struct IndexMetaDataMmapDispatcher {
@@ -114,21 +126,82 @@ class IndexImpl {
 
   using NumNormalAndInternal = Index::NumNormalAndInternal;
 
+  // The functions that are called at the beginning and at the end of each
+  // stage of the index build (e.g. "parse" or "permutations-PSO-POS"), which
+  // are used to measure the stages (see `benchmark/IndexBuildBenchmark.cpp`).
+  // The stages of the permutations can overlap if `parallelPermutations_` is
+  // set, so the functions have to be threadsafe.
+  struct BuildStageObserver {
+    std::function<void(std::string_view stage)> onBegin_;
+    std::function<void(std::string_view stage)> onEnd_;
+  };
+
+  // Notify a `BuildStageObserver` about the beginning of a stage on
+  // construction and about its end on destruction.
+  class BuildStage {
+    const BuildStageObserver& observer_;
+    std::string stage_;
+
+   public:
+    BuildStage(const BuildStageObserver& observer, std::string stage)
+        : observer_{observer}, stage_{std::move(stage)} {
+      if (observer_.onBegin_) {
+        observer_.onBegin_(stage_);
+      }
+    }
+    ~BuildStage() {
+      if (observer_.onEnd_) {
+        observer_.onEnd_(stage_);
+      }
+    }
+    BuildStage(const BuildStage&) = delete;
+    BuildStage& operator=(const BuildStage&) = delete;
+  };
+
   // Private data members.
  private:
   string onDiskBase_;
   string settingsFileName_;
   bool onlyAsciiTurtlePrefixes_ = false;
   bool useParallelParser_ = true;
+  // If true (and all permutations but no patterns are built), the OSP/OPS and
+  // the PSO/POS permutations are created concurrently (see `createFromFile`).
+  bool parallelPermutations_ = false;
+  // If true, an index whose input is small enough (see
+  // `MEMORY_PER_INPUT_BYTE_IN_MEMORY_INDEX_BUILD`) is built in memory: the
+  // hash maps of the partial vocabulary are sized for the input, and the
+  // unsorted triples and the sorters of the permutations keep all their rows
+  // in a single block that is sorted in RAM instead of being written to disk.
+  bool inMemoryBuildIfPossible_ = true;
+  // Only set during an index build in memory: before the parsing an upper
+  // bound for the number of triples of the input, after the parsing the actual
+  // number of triples (including the triples added by QLever).
+  std::optional<size_t> numTriplesOfInMemoryBuild_;
   TurtleParserIntegerOverflowBehavior turtleParserIntegerOverflowBehavior_ =
       TurtleParserIntegerOverflowBehavior::Error;
   bool turtleParserSkipIllegalLiterals_ = false;
   bool keepTempFiles_ = false;
+  // If true, the stages that a previous index build with the same input files
+  // and settings has completed are skipped (see `IndexBuildManifest`).
+  bool resumeBuild_ = false;
+  BuildStageObserver buildStageObserver_;
   ad_utility::MemorySize memoryLimitIndexBuilding_ =
       DEFAULT_MEMORY_LIMIT_INDEX_BUILDING;
   ad_utility::MemorySize blocksizePermutationPerColumn_ =
       UNCOMPRESSED_BLOCKSIZE_COMPRESSED_METADATA_PER_COLUMN;
+  ad_utility::MemorySize smallRelationsBlocksizePerColumn_ =
+      UNCOMPRESSED_BLOCKSIZE_SMALL_RELATIONS_PER_COLUMN;
+  // Only used for the PSO and POS permutations, see
+  // `CompressedRelationWriter::blocksizeOfLargeRelation`.
+  ad_utility::MemorySize largeRelationsBlocksizePerColumn_ =
+      UNCOMPRESSED_BLOCKSIZE_LARGE_RELATIONS_PER_COLUMN;
+  // The number of bits per key of the Bloom filters of the blocks of the
+  // permutations (see `BlockBloomFilter.h`). Zero means no Bloom filters.
+  size_t bloomFilterBitsPerKey_ = 0;
   json configurationJson_;
+  // Protects the `configurationJson_` when permutations are created
+  // concurrently.
+  std::mutex configurationMutex_;
   Index::Vocab vocab_;
   size_t totalVocabularySize_ = 0;
   bool vocabPrefixCompressed_ = true;
@@ -139,6 +212,14 @@ class IndexImpl {
   vector<WordIndex> blockBoundaries_;
   off_t currenttOffset_;
   mutable ad_utility::File textIndexFile_;
+  // The format of the lists of the text index. In version 1, the lists were
+  // compressed with `Simple8bCode` (and the text record indices were stored as
+  // gaps), since version 2 they are compressed with `BlockPackedCode`. Since
+  // version 3, the lists consist of sub-blocks with a skip list (see
+  // `TextSkipEntry`). Since version 4, the metadata is followed by the metadata
+  // of the prefix blocks (see `TextMetaData::_prefixBlocks`).
+  static constexpr size_t CURRENT_TEXT_INDEX_FORMAT_VERSION = 4;
+  size_t textIndexFormatVersion_ = CURRENT_TEXT_INDEX_FORMAT_VERSION;
 
   // If false, only PSO and POS permutations are loaded and expected.
   bool loadAllPermutations_ = true;
@@ -150,7 +231,9 @@ class IndexImpl {
   uint64_t numDistinctSubjectPredicatePairs_;
 
   size_t parserBatchSize_ = PARSER_BATCH_SIZE;
-  size_t numTriplesPerBatch_ = NUM_TRIPLES_PER_PARTIAL_VOCAB;
+  // If not set, `NUM_TRIPLES_PER_PARTIAL_VOCAB` is used, or the estimated
+  // number of triples of an index that is built in memory if it is smaller.
+  std::optional<size_t> numTriplesPerBatch_;
 
   // These statistics all do *not* include the triples that are added by
   // QLever for more efficient query processing.
@@ -165,11 +248,45 @@ class IndexImpl {
   /**
    * @brief Maps entity ids to pattern ids.
    */
-  std::vector<PatternID> hasPattern_;
+  CompressedPatternIds hasPattern_;
   /**
    * @brief Maps entity ids to sets of predicate ids
    */
   CompactVectorOfStrings<Id> hasPredicate_;
+  // The statistics for the size estimates of star-shaped joins. Empty if the
+  // patterns are not used or if the index was built without them.
+  CharacteristicSets characteristicSets_;
+  // The predicates (IRIs with angle brackets) for which the transitive
+  // closures are precomputed during the index build (see
+  // `createTransitiveClosures`), and the closures of a loaded index.
+  std::vector<std::string> transitiveClosurePredicates_;
+  TransitiveClosures transitiveClosures_;
+  // True iff the values of the numeric and date literals in the vocabulary are
+  // computed during the index build (see `createVocabularyValues`), and the
+  // values of a loaded index.
+  bool computeVocabularyValues_ = false;
+  VocabularyValues vocabularyValues_;
+  // True iff the coordinates of the WKT points in the vocabulary are computed
+  // during the index build (see `createGeoPoints`), and the points of a
+  // loaded index.
+  bool computeGeoPoints_ = false;
+  GeoPoints geoPoints_;
+  // True iff the trigram index of the literals in the vocabulary is built
+  // during the index build (see `createTrigramIndex`), and the trigram index
+  // of a loaded index.
+  bool computeTrigramIndex_ = false;
+  TrigramIndex trigramIndex_;
+  // True iff the histograms of the objects of the predicates are computed
+  // during the index build (see `createPredicateHistograms`), and the
+  // histograms of a loaded index.
+  bool computePredicateHistograms_ = false;
+  PredicateHistograms predicateHistograms_;
+  // The minimal number of subjects of a group of triples with the same
+  // predicate and object for which the result of the pattern trick is
+  // precomputed during the index build (see `createPatternTrickAggregates`),
+  // and the aggregates of a loaded index. 0 means no precomputation.
+  size_t patternTrickAggregatesMinSize_ = 0;
+  PatternTrickAggregates patternTrickAggregates_;
 
   ad_utility::AllocatorWithLimit<Id> allocator_;
 
@@ -183,6 +300,15 @@ class IndexImpl {
   Permutation ops_{Permutation::Enum::OPS, allocator_};
   Permutation osp_{Permutation::Enum::OSP, allocator_};
 
+  // The triples that were inserted or deleted after the index was built. They
+  // are merged into the results of the scans (see `scan`).
+  DeltaTriples deltaTriples_{vocab_, pso_};
+
+  // The loading of the SOP and OSP permutations, which continues in the
+  // background after `createFromOnDiskIndex` has returned. It is declared
+  // after the permutations, s.t. it is waited for before they are destroyed.
+  std::shared_future<void> backgroundLoading_;
+
  public:
   explicit IndexImpl(ad_utility::AllocatorWithLimit<Id> allocator);
 
@@ -200,18 +326,22 @@ class IndexImpl {
   auto& PSO() { return pso_; }
   const auto& SPO() const { return spo_; }
   auto& SPO() { return spo_; }
-  const auto& SOP() const { return sop_; }
-  auto& SOP() { return sop_; }
+  const auto& SOP() const { return getPermutation(Permutation::SOP); }
+  auto& SOP() { return getPermutation(Permutation::SOP); }
   const auto& OPS() const { return ops_; }
   auto& OPS() { return ops_; }
-  const auto& OSP() const { return osp_; }
-  auto& OSP() { return osp_; }
+  const auto& OSP() const { return getPermutation(Permutation::OSP); }
+  auto& OSP() { return getPermutation(Permutation::OSP); }
 
   // For a given `Permutation::Enum` (e.g. `PSO`) return the corresponding
-  // `Permutation` object by reference (`pso_`).
+  // `Permutation` object by reference (`pso_`). For the SOP and OSP
+  // permutations, wait until they are loaded (see `createFromOnDiskIndex`).
   Permutation& getPermutation(Permutation::Enum p);
   const Permutation& getPermutation(Permutation::Enum p) const;
 
+  DeltaTriples& deltaTriples() { return deltaTriples_; }
+  const DeltaTriples& deltaTriples() const { return deltaTriples_; }
+
   // Creates an index from a file. Parameter Parser must be able to split the
   // file's format into triples.
   // Will write vocabulary and on-disk index data.
@@ -219,6 +349,10 @@ class IndexImpl {
   // by createFromOnDiskIndex after this call.
   void createFromFile(const string& filename);
 
+  // Same as `createFromFile`, but the triples are read from several files (see
+  // `Index::createFromFiles`).
+  void createFromFiles(const std::vector<std::string>& filenames);
+
   // Creates an index object from an on disk index that has previously been
   // constructed. Read necessary meta data into memory and opens file handles.
   void createFromOnDiskIndex(const string& onDiskBase);
@@ -279,9 +413,26 @@ class IndexImpl {
   // ___________________________________________________________________________
   std::pair<Id, Id> prefix_range(const std::string& prefix) const;
 
-  const vector<PatternID>& getHasPattern() const;
+  const CompressedPatternIds& getHasPattern() const;
   const CompactVectorOfStrings<Id>& getHasPredicate() const;
   const CompactVectorOfStrings<Id>& getPatterns() const;
+  const CharacteristicSets& getCharacteristicSets() const {
+    return characteristicSets_;
+  }
+  const TransitiveClosures& getTransitiveClosures() const {
+    return transitiveClosures_;
+  }
+  const VocabularyValues& getVocabularyValues() const {
+    return vocabularyValues_;
+  }
+  const GeoPoints& getGeoPoints() const { return geoPoints_; }
+  const TrigramIndex& getTrigramIndex() const { return trigramIndex_; }
+  const PredicateHistograms& getPredicateHistograms() const {
+    return predicateHistograms_;
+  }
+  const PatternTrickAggregates& getPatternTrickAggregates() const {
+    return patternTrickAggregates_;
+  }
   /**
    * @return The multiplicity of the Entites column (0) of the full has-relation
    *         relation after unrolling the patterns.
@@ -347,9 +498,13 @@ class IndexImpl {
       const string& words) const;
 
   // Does the same as getWordPostingsForTerm but returns a
-  // WordEntityPosting. Sorted by textRecord.
+  // WordEntityPosting. Sorted by textRecord. If `textRecords` is not
+  // `nullptr`, the result may be restricted to the postings of the sub-blocks
+  // of the list that can contain one of these (sorted) text records, which is
+  // sufficient when the result is intersected with them.
   Index::WordEntityPostings getWordPostingsForTermWep(
-      const string& wordOrPrefix) const;
+      const string& wordOrPrefix,
+      const vector<TextRecordIndex>* textRecords = nullptr) const;
 
   // Returns a set of [textRecord, term] pairs where the term is contained in
   // the textRecord. The term can be either the wordOrPrefix itself or a word
@@ -359,6 +514,13 @@ class IndexImpl {
       const string& wordOrPrefix,
       const ad_utility::AllocatorWithLimit<Id>& allocator) const;
 
+  // Does the same as `getWordPostingsForTerm`, but yields the postings lazily
+  // in blocks of (at most) `NUM_TEXT_SUB_BLOCKS_PER_LAZY_BLOCK` sub-blocks of
+  // the context list, s.t. a consumer that only needs the first postings (e.g.
+  // because of a `LIMIT`) doesn't read and decode the whole list.
+  cppcoro::generator<IdTable> getWordPostingsForTermLazily(
+      string wordOrPrefix, ad_utility::AllocatorWithLimit<Id> allocator) const;
+
   Index::WordEntityPostings getEntityPostingsForTerm(const string& term) const;
 
   // Returns a set of textRecords and their corresponding entities and
@@ -372,8 +534,17 @@ class IndexImpl {
       const string& term,
       const ad_utility::AllocatorWithLimit<Id>& allocator) const;
 
+  // The lazy version of `getEntityMentionsForWord`, analogous to
+  // `getWordPostingsForTermLazily`.
+  cppcoro::generator<IdTable> getEntityMentionsForWordLazily(
+      string term, ad_utility::AllocatorWithLimit<Id> allocator) const;
+
   size_t getIndexOfBestSuitedElTerm(const vector<string>& terms) const;
 
+  // Return the index of the term the block of which has the fewest word
+  // postings.
+  size_t getIndexOfTermWithFewestPostings(const vector<string>& terms) const;
+
   Index::WordEntityPostings readWordClWep(const TextBlockMetaData& tbmd) const;
 
   IdTable readWordCl(const TextBlockMetaData& tbmd,
@@ -382,6 +553,27 @@ class IndexImpl {
   Index::WordEntityPostings readWordEntityClWep(
       const TextBlockMetaData& tbmd) const;
 
+  // Read the postings of the classic or the entity list of the block `tbmd`,
+  // but only those of the sub-blocks that can contain one of the
+  // `textRecords` (which have to be sorted). Indices with a text index format
+  // version before 3 have no sub-blocks, so the whole list is read.
+  Index::WordEntityPostings readSubBlocksOfContextList(
+      const TextBlockMetaData& tbmd, bool isEntityList,
+      const vector<TextRecordIndex>& textRecords) const;
+
+  // Yield the postings of the classic or the entity list of the block `tbmd`
+  // in runs of consecutive sub-blocks, each of which has at most
+  // `maxNumSubBlocksPerRun` sub-blocks. If `textRecords` is not `nullptr`,
+  // only the sub-blocks that can contain one of these (sorted) text records
+  // are read (see `readSubBlocksOfContextList`). Indices with a text index
+  // format version before 3 have no sub-blocks, so the whole list is yielded
+  // at once.
+  cppcoro::generator<Index::WordEntityPostings>
+  readSubBlocksOfContextListLazily(const TextBlockMetaData& tbmd,
+                                   bool isEntityList,
+                                   const vector<TextRecordIndex>* textRecords,
+                                   size_t maxNumSubBlocksPerRun) const;
+
   IdTable readWordEntityCl(
       const TextBlockMetaData& tbmd,
       const ad_utility::AllocatorWithLimit<Id>& allocator) const;
@@ -393,6 +585,11 @@ class IndexImpl {
     return docsDB_.getTextExcerpt(cid);
   }
 
+  // Get the excerpts of all the `cids` at once, see `DocsDB::getTextExcerpts`.
+  vector<string> getTextExcerpts(std::span<const TextRecordIndex> cids) const {
+    return docsDB_.getTextExcerpts(cids);
+  }
+
   float getAverageNofEntityContexts() const {
     return textMeta_.getAverageNofEntityContexts();
   };
@@ -405,8 +602,16 @@ class IndexImpl {
 
   bool& loadAllPermutations();
 
+  bool& parallelPermutations() { return parallelPermutations_; }
+
+  bool& inMemoryBuildIfPossible() { return inMemoryBuildIfPossible_; }
+
   void setKeepTempFiles(bool keepTempFiles);
 
+  void setResumeBuild(bool resumeBuild) { resumeBuild_ = resumeBuild; }
+
+  BuildStageObserver& buildStageObserver() { return buildStageObserver_; }
+
   ad_utility::MemorySize& memoryLimitIndexBuilding() {
     return memoryLimitIndexBuilding_;
   }
@@ -418,6 +623,16 @@ class IndexImpl {
     return blocksizePermutationPerColumn_;
   }
 
+  ad_utility::MemorySize& smallRelationsBlocksizePerColumn() {
+    return smallRelationsBlocksizePerColumn_;
+  }
+
+  ad_utility::MemorySize& largeRelationsBlocksizePerColumn() {
+    return largeRelationsBlocksizePerColumn_;
+  }
+
+  size_t& bloomFilterBitsPerKey() { return bloomFilterBitsPerKey_; }
+
   void setOnDiskBase(const std::string& onDiskBase);
 
   void setSettingsFile(const std::string& filename);
@@ -460,6 +675,11 @@ class IndexImpl {
                Permutation::ColumnIndicesRef additionalColumns,
                ad_utility::SharedCancellationHandle cancellationHandle) const;
 
+  // Like `TripleComponent::toValueId`, but the words that are only contained
+  // in the inserted triples (see `DeltaTriples`) are also found.
+  std::optional<Id> toValueIdIncludingDeltaTriples(
+      const TripleComponent& component) const;
+
   // _____________________________________________________________________________
   size_t getResultSizeOfScan(const TripleComponent& col0,
                              const TripleComponent& col1,
@@ -511,18 +731,26 @@ class IndexImpl {
   std::unique_ptr<TurtleParserBase> makeTurtleParser(
       const std::string& filename);
 
+  // Return a parser for all the `filenames`. For a single file this is the
+  // parser from the function above, for several files a
+  // `MultiFileTurtleParser` that uses one such parser per file.
+  std::unique_ptr<TurtleParserBase> makeTurtleParser(
+      const std::vector<std::string>& filenames);
+
   std::unique_ptr<ad_utility::CompressedExternalIdTableSorterTypeErased>
   convertPartialToGlobalIds(TripleVec& data,
                             const vector<size_t>& actualLinesPerPartial,
                             size_t linesPerPartial);
 
   // Generator that returns all words in the given context file (if not empty)
-  // and then all words in all literals (if second argument is true).
+  // and then all words in all literals (if second argument is true). The lines
+  // are yielded in batches (see `NUM_LINES_PER_BATCH_TEXT_INDEX_BUILDING`),
+  // which are parsed concurrently and always consist of complete contexts.
   //
   // TODO: So far, this is limited to the internal vocabulary (still in the
   // testing phase, once it works, it should be easy to include the IRIs and
   // literals from the external vocabulary as well).
-  cppcoro::generator<ContextFileParser::Line> wordsInTextRecords(
+  cppcoro::generator<std::vector<ContextFileParser::Line>> wordsInTextRecords(
       const std::string& contextFile, bool addWordsFromLiterals);
 
   size_t processWordsForVocabulary(const string& contextFile,
@@ -570,27 +798,63 @@ class IndexImpl {
                      const Permutation& p1, const Permutation& p2,
                      auto&&... perTripleCallbacks);
 
-  void createTextIndex(const string& filename, const TextVec& vec);
+  // Compress and write the blocks of the sorted postings `vec` concurrently.
+  void createTextIndex(const string& filename, TextVec& vec);
 
-  ContextListMetaData writePostings(ad_utility::File& out,
+  // Append the compressed `postings` to `out`. The offsets of the result are
+  // relative to the beginning of `out`.
+  ContextListMetaData writePostings(std::vector<char>& out,
                                     const vector<Posting>& postings,
-                                    bool skipWordlistIfAllTheSame);
+                                    bool skipWordlistIfAllTheSame) const;
+
+  // Return the word ranges of the prefixes of the words `[minWordIndex,
+  // maxWordIndex]` of a block with the `classicPostings`, for which a prefix
+  // block is written (see `MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK`). The ranges are
+  // unique and don't include the range of the whole block.
+  vector<std::pair<WordIndex, WordIndex>> getWordRangesOfPrefixBlocks(
+      WordIndex minWordIndex, WordIndex maxWordIndex,
+      const vector<Posting>& classicPostings) const;
 
   void openTextFileHandle();
 
-  void addContextToVector(TextVec::bufwriter_type& writer,
+  void addContextToVector(IdTableStatic<NUM_COLUMNS_TEXT_VEC>& postings,
                           TextRecordIndex context,
                           const ad_utility::HashMap<WordIndex, Score>& words,
-                          const ad_utility::HashMap<Id, Score>& entities);
+                          const ad_utility::HashMap<Id, Score>& entities) const;
 
+  // Read the list of `nofElements` text record indices that is stored in the
+  // `nofBytes` at `from` of the text index file, and write
+  // `makeFromUint64t(index)` for each of them to `result`.
+  template <typename T, typename MakeFromUint64t>
+  void readGapComprList(size_t nofElements, off_t from, size_t nofBytes,
+                        std::span<T> result,
+                        MakeFromUint64t makeFromUint64t) const;
+
+  // Same as above, but return the result as a vector.
   template <typename T, typename MakeFromUint64t>
   vector<T> readGapComprList(size_t nofElements, off_t from, size_t nofBytes,
                              MakeFromUint64t makeFromUint64t) const;
 
-  template <typename T, typename MakeFromUint64t = std::identity>
+  // Read the codebook of a frequency-encoded list that is stored at `from`
+  // of the text index file. Also return the offset of the compressed list
+  // after the codebook.
+  template <typename CodebookT>
+  std::pair<vector<CodebookT>, off_t> readCodebook(off_t from) const;
+
+  // Read the frequency-encoded list of `nofElements` that is stored in the
+  // `nofBytes` at `from` of the text index file, and write
+  // `fromCodebook(entry)` for the codebook entry of each element to
+  // `result`.
+  template <typename CodebookT, typename T, typename FromCodebook>
+  void readFreqComprList(size_t nofElements, off_t from, size_t nofBytes,
+                         std::span<T> result, FromCodebook fromCodebook) const;
+
+  // Same as above, but return the result as a vector.
+  template <typename T, typename CodebookT = T,
+            typename FromCodebook = std::identity>
   vector<T> readFreqComprList(
       size_t nofElements, off_t from, size_t nofBytes,
-      MakeFromUint64t makeFromUint = MakeFromUint64t{}) const;
+      FromCodebook fromCodebook = FromCodebook{}) const;
 
   // Get the metadata for the block from the text index that contains the
   // `word`. Also works for prefixes that are terminated with `PREFIX_CHAR` like
@@ -626,12 +890,10 @@ class IndexImpl {
 
   TextBlockIndex getWordBlockId(WordIndex wordIndex) const;
 
-  //! Writes a list of elements (have to be able to be cast to unit64_t)
-  //! to file.
+  //! Appends a list that was compressed with `BlockPackedCode` to `out`.
   //! Returns the number of bytes written.
-  template <class Numeric>
-  size_t writeList(Numeric* data, size_t nofElements,
-                   ad_utility::File& file) const;
+  size_t writeList(const vector<uint64_t>& encoded,
+                   std::vector<char>& out) const;
 
   // TODO<joka921> understand what the "codes" are, are they better just ints?
   typedef ad_utility::HashMap<WordIndex, CompressionCode> WordToCodeMap;
@@ -646,7 +908,7 @@ class IndexImpl {
                        ScoreCodebook& scoreCodebook) const;
 
   template <class T>
-  size_t writeCodebook(const vector<T>& codebook, ad_utility::File& file) const;
+  size_t writeCodebook(const vector<T>& codebook, std::vector<char>& out) const;
 
   // FRIEND TESTS
   friend class IndexTest_createFromTsvTest_Test;
@@ -672,6 +934,43 @@ class IndexImpl {
   void writeConfiguration() const;
   void readConfiguration();
 
+  // The part of `createFromFiles` that builds the vocabulary and all the
+  // permutations (including the patterns) and writes the configuration.
+  void createVocabularyAndPermutations(
+      const std::vector<std::string>& filenames);
+
+  // The input files and all the settings of an index build, which must be the
+  // same for a build to be resumed (see `IndexBuildManifest`).
+  json makeBuildKey(const std::vector<std::string>& filenames) const;
+
+  // Compute the transitive closures of the `transitiveClosurePredicates_` and
+  // write them to disk. This is the last step of the index build, because it
+  // needs the vocabulary and the PSO permutation of the finished index.
+  void createTransitiveClosures();
+
+  // Parse the numeric and date literals of the vocabulary and write their
+  // values to disk. Like `createTransitiveClosures`, this needs the vocabulary
+  // of the finished index.
+  void createVocabularyValues();
+
+  // Parse the WKT points of the vocabulary and write their coordinates to
+  // disk (see `GeoPoints`).
+  void createGeoPoints();
+
+  // Build the trigram index of the literals of the vocabulary and write it to
+  // disk (see `TrigramIndex`).
+  void createTrigramIndex();
+
+  // Compute the histograms of the objects of all predicates from the POS
+  // permutation of the finished index and write them to disk.
+  void createPredicateHistograms();
+
+  // Compute the results of the pattern trick for the subjects of all groups of
+  // triples with the same predicate and object that have at least
+  // `patternTrickAggregatesMinSize_` subjects from the POS permutation and the
+  // patterns of the finished index and write them to disk.
+  void createPatternTrickAggregates();
+
   // initialize the index-build-time settings for the vocabulary
   void readIndexBuilderSettingsFromFile();
 
@@ -780,9 +1079,10 @@ class IndexImpl {
 
   // Create the SPO and SOP permutations. Additionally, count the number of
   // distinct actual (not internal) subjects in the input and write it to the
-  // metadata. Also builds the patterns if specified.
+  // metadata. Also builds the patterns if specified. Without patterns, the
+  // triples can be pushed to two next sorters (see `createFromFile`).
   template <typename... NextSorter>
-  requires(sizeof...(NextSorter) <= 1)
+  requires(sizeof...(NextSorter) <= 2)
   std::optional<PatternCreatorNew::TripleSorter> createSPOAndSOP(
       size_t numColumns, auto& isInternalId, BlocksOfTriples sortedTriples,
       NextSorter&&... nextSorter);
@@ -805,17 +1105,20 @@ class IndexImpl {
 
   // Set up one of the permutation sorters with the appropriate memory limit.
   // The `permutationName` is used to determine the filename and must be unique
-  // for each call during one index build.
+  // for each call during one index build. The `numSortersAtSameTime` is the
+  // number of sorters that share the `memoryLimitIndexBuilding()`.
   template <typename Comparator, size_t N = NumColumnsIndexBuilding>
   ExternalSorter<Comparator, N> makeSorter(
-      std::string_view permutationName) const;
+      std::string_view permutationName,
+      std::optional<size_t> numSortersAtSameTime = std::nullopt) const;
   // Same as the same function, but return a `unique_ptr`.
   template <typename Comparator, size_t N = NumColumnsIndexBuilding>
   std::unique_ptr<ExternalSorter<Comparator, N>> makeSorterPtr(
       std::string_view permutationName) const;
   // The common implementation of the above two functions.
   template <typename Comparator, size_t N, bool returnPtr>
-  auto makeSorterImpl(std::string_view permutationName) const;
+  auto makeSorterImpl(std::string_view permutationName,
+                      std::optional<size_t> numSortersAtSameTime) const;
 
   // Aliases for the three functions above that should be consistently used.
   // They assert that the order of the permutations as communicated by the
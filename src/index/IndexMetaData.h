@@ -10,6 +10,7 @@
 #include <cmath>
 #include <exception>
 #include <limits>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -87,8 +88,14 @@ class IndexMetaData {
 
   // For each relation, its meta data.
   MapType _data;
-  // For each compressed block, its meta data.
+  // For each compressed block, its meta data. For the mmap-based
+  // `IndexMetaData`, the block metadata is written to a separate file (see
+  // `getBlockDataFilename`) when the metadata is written, and it is read on
+  // demand from the `_blockDataMmap` when the metadata is read. This makes the
+  // loading of an index much faster and saves a lot of RAM for large indices.
   BlocksType _blockData;
+  ad_utility::MmapVectorView<CompressedBlockMetadata> _blockDataMmap;
+  bool _blockDataIsMmapped = false;
 
   size_t _totalElements = 0;
   size_t _totalBytes = 0;
@@ -176,8 +183,26 @@ class IndexMetaData {
 
   const MapType& data() const { return _data; }
 
-  BlocksType& blockData() { return _blockData; }
-  const BlocksType& blockData() const { return _blockData; }
+  // Set the metadata of the blocks of the permutation (used when building the
+  // index).
+  void setBlockData(BlocksType blockData) {
+    _blockData = std::move(blockData);
+    _blockDataIsMmapped = false;
+  }
+
+  std::span<const CompressedBlockMetadata> blockData() const {
+    if (_blockDataIsMmapped) {
+      return {_blockDataMmap.data(), _blockDataMmap.size()};
+    }
+    return _blockData;
+  }
+
+  // The name of the file that stores the block metadata of the mmap-based
+  // `IndexMetaData`.
+  std::string getBlockDataFilename() const
+      requires(_isMmapBased) {
+    return _data.getFilename() + ".blocks";
+  }
 
   // Symmetric serialization function for the ad_utility::serialization module.
   AD_SERIALIZE_FRIEND_FUNCTION(IndexMetaData) {
@@ -208,7 +233,9 @@ class IndexMetaData {
     // Serialize the rest of the data members
     serializer | arg._name;
     serializer | arg._data;
-    serializer | arg._blockData;
+    if constexpr (!T::_isMmapBased) {
+      serializer | arg._blockData;
+    }
 
     serializer | arg._offsetAfter;
     serializer | arg._totalElements;
@@ -61,6 +61,13 @@ void IndexMetaData<MapType>::appendToFile(ad_utility::File* file) const {
   serializer << (*this);
   *file = std::move(serializer).file();
   file->write(&startOfMeta, sizeof(startOfMeta));
+  if constexpr (_isMmapBased) {
+    ad_utility::MmapVector<CompressedBlockMetadata> blockData{
+        getBlockDataFilename(), ad_utility::CreateTag{}};
+    for (const auto& block : this->blockData()) {
+      blockData.push_back(block);
+    }
+  }
 }
 
 // _________________________________________________________________________
@@ -84,6 +91,12 @@ void IndexMetaData<MapType>::readFromFile(ad_utility::File* file) {
       std::move(buf)};
 
   serializer >> (*this);
+  if constexpr (_isMmapBased) {
+    _blockDataMmap.open(getBlockDataFilename(), ad_utility::ReuseTag{},
+                        ad_utility::AccessPattern::Random);
+    _blockDataIsMmapped = true;
+    _blockData.clear();
+  }
 }
 
 // _____________________________________________________________________________
@@ -94,7 +107,7 @@ string IndexMetaData<MapType>::statistics() const {
   ad_utility::ReadableNumberFacet facet(1);
   std::locale locWithNumberGrouping(loc, &facet);
   os.imbue(locWithNumberGrouping);
-  os << "#relations = " << _data.size() << ", #blocks = " << _blockData.size()
+  os << "#relations = " << _data.size() << ", #blocks = " << blockData().size()
      << ", #triples = " << _totalElements;
   return std::move(os).str();
 }
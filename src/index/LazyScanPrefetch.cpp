@@ -0,0 +1,177 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/LazyScanPrefetch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "global/Constants.h"
+#include "util/Exception.h"
+
+namespace {
+// Update the exponential moving `average` with the `duration`.
+void updateAverage(double& average, LazyScanPrefetchController::Duration d) {
+  auto value = static_cast<double>(d.count());
+  average = average < 0 ? value : 0.75 * average + 0.25 * value;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+LazyScanPrefetchController::LazyScanPrefetchController(
+    size_t maxNumThreads, size_t maxPrefetchDepth, size_t totalThreadBudget,
+    std::atomic<size_t>& numThreadsOfAllScans)
+    : maxNumThreads_{maxNumThreads},
+      maxPrefetchDepth_{maxPrefetchDepth},
+      totalThreadBudget_{totalThreadBudget},
+      numThreadsOfAllScans_{numThreadsOfAllScans},
+      prefetchDepth_{std::min(size_t{2}, maxPrefetchDepth)},
+      maxPrefetchDepthUsed_{prefetchDepth_} {
+  AD_CONTRACT_CHECK(maxNumThreads > 0 && maxPrefetchDepth > 0);
+  // Each scan uses at least one thread, independent of the budget.
+  ++numThreadsOfAllScans_;
+}
+
+// _____________________________________________________________________________
+LazyScanPrefetchController::LazyScanPrefetchController()
+    : LazyScanPrefetchController(
+          RuntimeParameters().get<"lazy-index-scan-num-threads">(),
+          RuntimeParameters().get<"lazy-index-scan-queue-size">(),
+          RuntimeParameters().get<"lazy-index-scan-max-total-threads">(),
+          numThreadsOfAllLazyScans()) {}
+
+// _____________________________________________________________________________
+LazyScanPrefetchController::~LazyScanPrefetchController() {
+  numThreadsOfAllScans_ -= numThreads_;
+}
+
+// _____________________________________________________________________________
+bool LazyScanPrefetchController::startBlock() {
+  std::unique_lock lock{mutex_};
+  slotNotification_.wait(lock, [this] {
+    return finished_ ||
+           (numActiveThreads_ < numThreads_ &&
+            numStartedBlocks_ - numConsumedBlocks_ < prefetchDepth_);
+  });
+  if (finished_) {
+    return false;
+  }
+  ++numActiveThreads_;
+  ++numStartedBlocks_;
+  return true;
+}
+
+// _____________________________________________________________________________
+void LazyScanPrefetchController::finishBlock(Duration decompressionTime) {
+  std::unique_lock lock{mutex_};
+  AD_CORRECTNESS_CHECK(numActiveThreads_ > 0);
+  --numActiveThreads_;
+  updateAverage(avgDecompressionTime_, decompressionTime);
+  lock.unlock();
+  slotNotification_.notify_all();
+}
+
+// _____________________________________________________________________________
+void LazyScanPrefetchController::blockConsumed(Duration waitTime,
+                                               Duration consumerTime) {
+  std::unique_lock lock{mutex_};
+  ++numConsumedBlocks_;
+  updateAverage(avgWaitTime_, waitTime);
+  // For the first block, the consumer hasn't spent any time on a block yet.
+  if (numConsumedBlocks_ > 1) {
+    updateAverage(avgConsumerTime_, consumerTime);
+  }
+  adapt();
+  lock.unlock();
+  slotNotification_.notify_all();
+}
+
+// _____________________________________________________________________________
+void LazyScanPrefetchController::finish() {
+  std::unique_lock lock{mutex_};
+  finished_ = true;
+  lock.unlock();
+  slotNotification_.notify_all();
+}
+
+// _____________________________________________________________________________
+void LazyScanPrefetchController::adapt() {
+  if (avgConsumerTime_ < 0) {
+    return;
+  }
+  // The number of threads that decompress the blocks as fast as the consumer
+  // processes them.
+  size_t target = numThreads_;
+  if (avgDecompressionTime_ >= 0) {
+    target = static_cast<size_t>(
+        std::ceil(avgDecompressionTime_ / std::max(avgConsumerTime_, 1.0)));
+  }
+  // Waits of a few microseconds are just noise.
+  bool consumerWaits = avgWaitTime_ > std::max(0.1 * avgConsumerTime_, 10.0);
+  if (consumerWaits) {
+    target = std::max(target, 2 * numThreads_);
+  } else {
+    // If the consumer doesn't wait, the number of threads is only decreased,
+    // and only gradually.
+    target = std::clamp(target, numThreads_ - 1, numThreads_);
+  }
+  target = std::clamp(target, size_t{1}, maxNumThreads_);
+  if (target > numThreads_) {
+    numThreads_ += reserveThreads(target - numThreads_);
+  } else if (target < numThreads_) {
+    numThreadsOfAllScans_ -= numThreads_ - target;
+    numThreads_ = target;
+  }
+  size_t minPrefetchDepth = std::min(size_t{2}, maxPrefetchDepth_);
+  prefetchDepth_ =
+      std::clamp(2 * numThreads_, minPrefetchDepth, maxPrefetchDepth_);
+  maxNumThreadsUsed_ = std::max(maxNumThreadsUsed_, numThreads_);
+  maxPrefetchDepthUsed_ = std::max(maxPrefetchDepthUsed_, prefetchDepth_);
+}
+
+// _____________________________________________________________________________
+size_t LazyScanPrefetchController::reserveThreads(size_t numThreads) {
+  size_t current = numThreadsOfAllScans_.load();
+  while (true) {
+    size_t available =
+        current < totalThreadBudget_ ? totalThreadBudget_ - current : 0;
+    size_t granted = std::min(numThreads, available);
+    if (granted == 0) {
+      return 0;
+    }
+    if (numThreadsOfAllScans_.compare_exchange_weak(current,
+                                                    current + granted)) {
+      return granted;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+size_t LazyScanPrefetchController::numThreads() const {
+  std::lock_guard lock{mutex_};
+  return numThreads_;
+}
+
+// _____________________________________________________________________________
+size_t LazyScanPrefetchController::prefetchDepth() const {
+  std::lock_guard lock{mutex_};
+  return prefetchDepth_;
+}
+
+// _____________________________________________________________________________
+size_t LazyScanPrefetchController::maxNumThreadsUsed() const {
+  std::lock_guard lock{mutex_};
+  return maxNumThreadsUsed_;
+}
+
+// _____________________________________________________________________________
+size_t LazyScanPrefetchController::maxPrefetchDepthUsed() const {
+  std::lock_guard lock{mutex_};
+  return maxPrefetchDepthUsed_;
+}
+
+// _____________________________________________________________________________
+std::atomic<size_t>& LazyScanPrefetchController::numThreadsOfAllLazyScans() {
+  static std::atomic<size_t> numThreads = 0;
+  return numThreads;
+}
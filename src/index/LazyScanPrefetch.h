@@ -0,0 +1,120 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include "util/Timer.h"
+
+// Controls how many blocks a lazy index scan reads ahead of its consumer and
+// how many of its worker threads read and decompress blocks concurrently (see
+// `CompressedRelationReader::asyncParallelBlockGenerator`).
+//
+// A scan starts with a single thread and a prefetch depth of two blocks, s.t.
+// small scans (or scans that are stopped early by a LIMIT) don't read blocks
+// that are never used. The number of threads is then adapted after each block
+// that the consumer receives: It is the number of threads that is needed to
+// decompress the blocks as fast as the consumer processes them (the average
+// decompression time of a block divided by the average time that the consumer
+// spends on a block), and it is doubled while the consumer still has to wait
+// for the blocks (which is what is accumulated in the `blockingTime_` of the
+// `LazyScanMetadata`). The prefetch depth is twice the number of threads.
+//
+// The threads of all concurrent scans share a global budget: Additional
+// threads (beyond the first one of each scan) are only used if the total
+// number of threads of all scans stays within
+// `lazy-index-scan-max-total-threads`.
+class LazyScanPrefetchController {
+ public:
+  using Duration = ad_utility::Timer::Duration;
+
+ private:
+  const size_t maxNumThreads_;
+  const size_t maxPrefetchDepth_;
+  const size_t totalThreadBudget_;
+  // The number of threads that are currently reserved by all scans that use
+  // the same budget.
+  std::atomic<size_t>& numThreadsOfAllScans_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable slotNotification_;
+  size_t numThreads_ = 1;
+  size_t prefetchDepth_;
+  // The number of threads that are currently reading a block.
+  size_t numActiveThreads_ = 0;
+  // The number of blocks that the threads have started to read and that the
+  // consumer has received.
+  size_t numStartedBlocks_ = 0;
+  size_t numConsumedBlocks_ = 0;
+  bool finished_ = false;
+  // Exponential moving averages (in microseconds), negative if not measured
+  // yet.
+  double avgDecompressionTime_ = -1.0;
+  double avgConsumerTime_ = -1.0;
+  double avgWaitTime_ = -1.0;
+  // The largest values of `numThreads_` and `prefetchDepth_` so far.
+  size_t maxNumThreadsUsed_ = 1;
+  size_t maxPrefetchDepthUsed_;
+
+ public:
+  // Create a controller for a scan that uses at most `maxNumThreads` threads
+  // and prefetches at most `maxPrefetchDepth` blocks. The threads of all scans
+  // are counted in `numThreadsOfAllScans`.
+  LazyScanPrefetchController(size_t maxNumThreads, size_t maxPrefetchDepth,
+                             size_t totalThreadBudget,
+                             std::atomic<size_t>& numThreadsOfAllScans);
+
+  // Create a controller with the limits from the `RuntimeParameters` and the
+  // global budget that is shared by all lazy scans.
+  LazyScanPrefetchController();
+
+  ~LazyScanPrefetchController();
+
+  // Not copyable or movable, because the worker threads refer to it.
+  LazyScanPrefetchController(const LazyScanPrefetchController&) = delete;
+  LazyScanPrefetchController& operator=(const LazyScanPrefetchController&) =
+      delete;
+
+  // Called by a worker thread before it starts to read the next block. Block
+  // until the current number of threads and the prefetch depth allow this.
+  // Return false if the scan is finished (see `finish`), in which case no
+  // block must be read.
+  bool startBlock();
+
+  // Called by a worker thread after it has read a block (for which `startBlock`
+  // returned true) within the `decompressionTime`.
+  void finishBlock(Duration decompressionTime);
+
+  // Called by the consumer after it has received a block. The `waitTime` is the
+  // time that it waited for the block, and the `consumerTime` the time that it
+  // spent on the previous block (zero for the first block).
+  void blockConsumed(Duration waitTime, Duration consumerTime);
+
+  // Wake up all worker threads and make all further calls to `startBlock`
+  // return false. Called when all the blocks have been read or when the
+  // consumer stops early.
+  void finish();
+
+  // The current number of threads and prefetch depth.
+  size_t numThreads() const;
+  size_t prefetchDepth() const;
+  // The largest number of threads and prefetch depth that were used so far.
+  size_t maxNumThreadsUsed() const;
+  size_t maxPrefetchDepthUsed() const;
+
+  // The budget that is shared by all lazy scans.
+  static std::atomic<size_t>& numThreadsOfAllLazyScans();
+
+ private:
+  // Adapt the `numThreads_` and the `prefetchDepth_` to the measured times.
+  // Requires that the `mutex_` is locked.
+  void adapt();
+
+  // Try to reserve `numThreads` additional threads from the global budget and
+  // return the number of threads that were reserved.
+  size_t reserveThreads(size_t numThreads);
+};
@@ -4,71 +4,178 @@
 
 #include "index/PatternCreator.h"
 
+#include <absl/strings/str_cat.h>
+
+#include <filesystem>
+
 #include "global/SpecialIds.h"
+#include "util/ParallelExecution.h"
 
 static const Id hasPatternId = qlever::specialIds.at(HAS_PATTERN_PREDICATE);
 
+namespace {
+// Bit-pack the mapping from subjects to patterns that is stored at the
+// beginning of the `patternFilename` (see `PatternCreator`) and write it to the
+// file with the `CompressedPatternIds::FILE_SUFFIX`. The mapping is read in
+// blocks, s.t. it is never completely in memory.
+void writeCompressedPatternIds(const std::string& patternFilename,
+                               size_t numPatterns) {
+  ad_utility::serialization::FileReadSerializer reader{patternFilename};
+  size_t numSubjects = 0;
+  reader >> numSubjects;
+  ad_utility::MmapVector<uint64_t> words(
+      CompressedPatternIds::HEADER_SIZE,
+      absl::StrCat(patternFilename, CompressedPatternIds::FILE_SUFFIX));
+  CompressedPatternIds::Packer packer{words, numPatterns};
+  static constexpr size_t blockSize = 1'000'000;
+  std::vector<PatternID> block;
+  for (size_t i = 0; i < numSubjects; i += block.size()) {
+    block.resize(std::min(blockSize, numSubjects - i));
+    reader.serializeBytes(reinterpret_cast<char*>(block.data()),
+                          block.size() * sizeof(PatternID));
+    std::ranges::for_each(block, [&packer](PatternID id) { packer.push(id); });
+  }
+  packer.finish();
+}
+}  // namespace
+
 // _________________________________________________________________________
 void PatternCreatorNew::processTriple(std::array<Id, 3> triple,
                                       bool ignoreForPatterns) {
-  if (ignoreForPatterns) {
-    tripleBuffer_.emplace_back(triple, ignoreForPatterns);
-    return;
-  }
-  if (!currentSubjectIndex_.has_value()) {
-    // This is the first triple
-    currentSubjectIndex_ = triple[0].getVocabIndex();
-  } else if (triple[0].getVocabIndex() != currentSubjectIndex_) {
-    // New subject.
-    finishSubject(currentSubjectIndex_.value(), currentPattern_);
-    currentSubjectIndex_ = triple[0].getVocabIndex();
-    currentPattern_.clear();
+  if (!ignoreForPatterns) {
+    // Only process the buffer at the beginning of a new subject, s.t. no
+    // pattern is split between two batches.
+    if (currentSubject_.has_value() && triple[0] != currentSubject_ &&
+        tripleBuffer_.size() >= NUM_TRIPLES_PER_BATCH_PATTERN_CREATION) {
+      processBatch();
+    }
+    currentSubject_ = triple[0];
   }
   tripleBuffer_.emplace_back(triple, ignoreForPatterns);
-  // Don't list predicates twice in the same pattern.
-  if (currentPattern_.empty() || currentPattern_.back() != triple[1]) {
-    currentPattern_.push_back(triple[1]);
-  }
 }
 
-// ________________________________________________________________________________
-void PatternCreatorNew::finishSubject(VocabIndex subjectIndex,
-                                      const Pattern& pattern) {
-  numDistinctSubjects_++;
-  numDistinctSubjectPredicatePairs_ += pattern.size();
-  PatternID patternId;
-  auto it = patternToIdAndCount_.find(pattern);
-  if (it == patternToIdAndCount_.end()) {
-    // This is a new pattern, assign a new pattern ID and a count of 1.
-    patternId = static_cast<PatternID>(patternToIdAndCount_.size());
-    patternToIdAndCount_[pattern] = PatternIdAndCount{patternId, 1UL};
-
-    // Count the total number of distinct predicates that appear in the
-    // pattern and have not been counted before.
-    for (auto predicate : pattern) {
-      distinctPredicates_.insert(predicate);
+// _________________________________________________________________________
+void PatternCreatorNew::processBatch() {
+  const auto& triples = tripleBuffer_;
+  const size_t numTriples = triples.size();
+  auto subjectOf = [&triples](size_t i) { return triples[i].triple_[0]; };
+
+  // Split the buffer into chunks that don't split a subject.
+  const size_t numChunks = std::max(
+      size_t{1}, std::min(NUM_THREADS_PATTERN_CREATION, numTriples));
+  std::vector<size_t> chunkBoundaries{0};
+  for (size_t i = 1; i < numChunks; ++i) {
+    size_t boundary =
+        std::max(chunkBoundaries.back(), i * numTriples / numChunks);
+    while (boundary > 0 && boundary < numTriples &&
+           subjectOf(boundary) == subjectOf(boundary - 1)) {
+      ++boundary;
     }
-  } else {
-    // We have already seen the same pattern for a previous subject ID, reuse
-    // the ID and increase the count.
-    patternId = it->second.patternId_;
-    it->second.count_++;
+    chunkBoundaries.push_back(boundary);
   }
-
-  auto additionalTriple = std::array{Id::makeFromVocabIndex(subjectIndex),
-                                     hasPatternId, Id::makeFromInt(patternId)};
-  tripleSorter_.hasPatternPredicateSortedByPSO_->push(additionalTriple);
-  auto curSubject = Id::makeFromVocabIndex(currentSubjectIndex_.value());
-  std::ranges::for_each(tripleBuffer_, [this, patternId,
-                                        &curSubject](const auto& t) {
-    const auto& [s, p, o] = t.triple_;
-    // It might happen that the `tripleBuffer_` contains different subjects
-    // which are purely internal and therefore have no pattern.
-    auto actualPatternId =
-        Id::makeFromInt(curSubject != s ? NO_PATTERN : patternId);
-    AD_CORRECTNESS_CHECK(curSubject == s || t.isInternal_);
-    ospSorterTriplesWithPattern().push(std::array{s, p, o, actualPatternId});
+  chunkBoundaries.push_back(numTriples);
+
+  // The triples `[begin_, end_)` of a single subject. Its triples before
+  // `firstRegular_` are ignored for the patterns and get no pattern.
+  struct SubjectRange {
+    size_t begin_;
+    size_t firstRegular_;
+    size_t end_;
+    size_t localPatternIdx_;
+  };
+  // The distinct patterns of a chunk in the order of their first occurrence,
+  // the number of their subjects, and the subjects of the chunk.
+  struct Chunk {
+    std::vector<Pattern> patterns_;
+    std::vector<uint64_t> counts_;
+    std::vector<SubjectRange> subjects_;
+  };
+  std::vector<Chunk> chunks(numChunks);
+  ad_utility::runConcurrently(numChunks, [&](size_t chunkIdx) {
+    Chunk& chunk = chunks[chunkIdx];
+    ad_utility::HashMap<Pattern, size_t> localPatternIndices;
+    size_t end = chunkBoundaries[chunkIdx + 1];
+    for (size_t begin = chunkBoundaries[chunkIdx]; begin < end;) {
+      SubjectRange subject{begin, begin, begin, 0};
+      bool hasRegularTriple = false;
+      Pattern pattern;
+      for (; subject.end_ < end && subjectOf(subject.end_) == subjectOf(begin);
+           ++subject.end_) {
+        const auto& [triple, isInternal] = triples[subject.end_];
+        if (isInternal) {
+          continue;
+        }
+        if (!hasRegularTriple) {
+          hasRegularTriple = true;
+          subject.firstRegular_ = subject.end_;
+        }
+        // Don't list predicates twice in the same pattern.
+        if (pattern.empty() || pattern.back() != triple[1]) {
+          pattern.push_back(triple[1]);
+        }
+      }
+      if (!hasRegularTriple) {
+        subject.firstRegular_ = subject.end_;
+      } else {
+        auto [it, isNew] =
+            localPatternIndices.try_emplace(pattern, chunk.patterns_.size());
+        if (isNew) {
+          chunk.patterns_.push_back(std::move(pattern));
+          chunk.counts_.push_back(0);
+        }
+        subject.localPatternIdx_ = it->second;
+        ++chunk.counts_[it->second];
+      }
+      begin = subject.end_;
+      chunk.subjects_.push_back(subject);
+    }
   });
+
+  // Merge the patterns of the chunks and push the resulting triples.
+  for (const Chunk& chunk : chunks) {
+    std::vector<PatternID> patternIds;
+    patternIds.reserve(chunk.patterns_.size());
+    for (size_t i = 0; i < chunk.patterns_.size(); ++i) {
+      const Pattern& pattern = chunk.patterns_[i];
+      auto it = patternToIdAndCount_.find(pattern);
+      if (it == patternToIdAndCount_.end()) {
+        // This is a new pattern, assign a new pattern ID.
+        auto patternId = static_cast<PatternID>(patternToIdAndCount_.size());
+        patternToIdAndCount_[pattern] =
+            PatternIdAndCount{patternId, chunk.counts_[i]};
+        patternIds.push_back(patternId);
+        // Count the total number of distinct predicates that appear in the
+        // pattern and have not been counted before.
+        for (auto predicate : pattern) {
+          distinctPredicates_.insert(predicate);
+        }
+      } else {
+        // We have already seen the same pattern for a previous subject ID,
+        // reuse the ID and increase the count.
+        patternIds.push_back(it->second.patternId_);
+        it->second.count_ += chunk.counts_[i];
+      }
+    }
+
+    for (const SubjectRange& subject : chunk.subjects_) {
+      Id patternId = Id::makeFromInt(NO_PATTERN);
+      if (subject.firstRegular_ < subject.end_) {
+        const auto& pattern = chunk.patterns_[subject.localPatternIdx_];
+        numDistinctSubjects_++;
+        numDistinctSubjectPredicatePairs_ += pattern.size();
+        patternId = Id::makeFromInt(patternIds[subject.localPatternIdx_]);
+        tripleSorter_.hasPatternPredicateSortedByPSO_->push(
+            std::array{subjectOf(subject.begin_), hasPatternId, patternId});
+      }
+      for (size_t i = subject.begin_; i < subject.end_; ++i) {
+        const auto& [s, p, o] = triples[i].triple_;
+        ospSorterTriplesWithPattern().push(std::array{
+            s, p, o,
+            i < subject.firstRegular_ ? Id::makeFromInt(NO_PATTERN)
+                                      : patternId});
+      }
+    }
+  }
   tripleBuffer_.clear();
 }
 
@@ -79,9 +186,9 @@ void PatternCreatorNew::finish() {
   }
   isFinished_ = true;
 
-  // Write the pattern of the last subject.
-  if (currentSubjectIndex_.has_value()) {
-    finishSubject(currentSubjectIndex_.value(), currentPattern_);
+  // Process the remaining triples, including the pattern of the last subject.
+  if (currentSubject_.has_value()) {
+    processBatch();
   }
 
   // Store all data in the file
@@ -153,6 +260,12 @@ void PatternCreatorNew::printStatistics(
 // All the legacy code of the old pattern stuff.
 // _________________________________________________________________________
 void PatternCreator::processTriple(std::array<Id, 3> triple) {
+  // The mapping from subjects to patterns is indexed by the `VocabIndex`, so
+  // the subjects that are encoded directly into the `Id` (which are sorted
+  // after all the subjects from the vocabulary) get no pattern.
+  if (triple[0].getDatatype() != Datatype::VocabIndex) {
+    return;
+  }
   if (!_currentSubjectIndex.has_value()) {
     // This is the first triple
     _currentSubjectIndex = triple[0].getVocabIndex();
@@ -161,11 +274,14 @@ void PatternCreator::processTriple(std::array<Id, 3> triple) {
     finishSubject(_currentSubjectIndex.value(), _currentPattern);
     _currentSubjectIndex = triple[0].getVocabIndex();
     _currentPattern.clear();
+    _currentNumTriplesPerPredicate.clear();
   }
   // Don't list predicates twice in the same pattern.
   if (_currentPattern.empty() || _currentPattern.back() != triple[1]) {
     _currentPattern.push_back(triple[1]);
+    _currentNumTriplesPerPredicate.push_back(0);
   }
+  ++_currentNumTriplesPerPredicate.back();
 }
 
 // ________________________________________________________________________________
@@ -178,7 +294,8 @@ void PatternCreator::finishSubject(VocabIndex subjectIndex,
   if (it == _patternToIdAndCount.end()) {
     // This is a new pattern, assign a new pattern ID and a count of 1.
     patternId = static_cast<PatternID>(_patternToIdAndCount.size());
-    _patternToIdAndCount[pattern] = PatternIdAndCount{patternId, 1UL};
+    _patternToIdAndCount[pattern] =
+        PatternIdAndCount{patternId, 1UL, _currentNumTriplesPerPredicate};
 
     // Count the total number of distinct predicates that appear in the
     // pattern and have not been counted before.
@@ -190,6 +307,12 @@ void PatternCreator::finishSubject(VocabIndex subjectIndex,
     // the ID and increase the count.
     patternId = it->second._patternId;
     it->second._count++;
+    AD_CORRECTNESS_CHECK(it->second._numTriplesPerPredicate.size() ==
+                         _currentNumTriplesPerPredicate.size());
+    for (size_t i = 0; i < _currentNumTriplesPerPredicate.size(); ++i) {
+      it->second._numTriplesPerPredicate[i] +=
+          _currentNumTriplesPerPredicate[i];
+    }
   }
 
   // The mapping from subjects to patterns is a vector of pattern IDs. We have
@@ -246,6 +369,21 @@ void PatternCreator::finish() {
   }
   patternWriter.finish();
 
+  // Write the characteristic sets, which are the patterns together with their
+  // counts.
+  CharacteristicSets characteristicSets;
+  for (auto& [pattern, idAndCount] : orderedPatterns) {
+    characteristicSets.add(CharacteristicSets::Set{
+        pattern._data, idAndCount._count,
+        std::move(idAndCount._numTriplesPerPredicate)});
+  }
+  characteristicSets.writeToFile(
+      absl::StrCat(_filename, CharacteristicSets::FILE_SUFFIX));
+
+  // The file of the `patternWriter` is already closed at this point, so the
+  // mapping from subjects to patterns can be read again.
+  writeCompressedPatternIds(_filename, orderedPatterns.size());
+
   // Print some statistics for the log of the index builder.
   printStatistics(patternStatistics);
 }
@@ -256,19 +394,34 @@ void PatternCreator::readPatternsFromFile(
     double& avgNumPredicatesPerSubject,
     uint64_t& numDistinctSubjectPredicatePairs,
     CompactVectorOfStrings<Id>& patterns,
-    std::vector<PatternID>& subjectToPattern) {
+    CompressedPatternIds& subjectToPattern) {
   // Read the pattern info from the patterns file.
   LOG(INFO) << "Reading patterns from file " << filename << " ..." << std::endl;
 
-  // Read the subjectToPatternMap.
+  // Skip the subjectToPatternMap, which is memory-mapped from its bit-packed
+  // copy below.
   ad_utility::serialization::FileReadSerializer patternReader(filename);
+  size_t numSubjects = 0;
+  patternReader >> numSubjects;
+  patternReader.setSerializationPosition(sizeof(numSubjects) +
+                                         numSubjects * sizeof(PatternID));
 
   // Read the statistics and the patterns.
-  patternReader >> subjectToPattern;
   PatternStatistics statistics;
   patternReader >> statistics;
   patternReader >> patterns;
 
+  // Indices that were built before the bit-packed mapping existed only have
+  // the plain mapping, so the packed one is created once.
+  auto packedFilename =
+      absl::StrCat(filename, CompressedPatternIds::FILE_SUFFIX);
+  if (!std::filesystem::exists(packedFilename)) {
+    LOG(INFO) << "Writing the bit-packed mapping from subjects to patterns ..."
+              << std::endl;
+    writeCompressedPatternIds(filename, patterns.size());
+  }
+  subjectToPattern = CompressedPatternIds::readFromFile(packedFilename);
+
   numDistinctSubjectPredicatePairs =
       statistics.numDistinctSubjectPredicatePairs_;
   avgNumSubjectsPerPredicate = statistics.avgNumDistinctSubjectsPerPredicate_;
@@ -14,6 +14,9 @@
 #include "global/Constants.h"
 #include "global/Id.h"
 #include "global/Pattern.h"
+#include "index/CharacteristicSets.h"
+#include "index/CompressedPatternIds.h"
+#include "index/ConstantsIndexBuilding.h"
 #include "index/StxxlSortFunctors.h"
 #include "util/BufferedVector.h"
 #include "util/ExceptionHandling.h"
@@ -68,6 +71,9 @@ struct PatternStatistics {
 /// mapping from subjects to predicates (has-predicate) is not written to disk,
 /// but stored in a STXXL sorter which then has to be used to build an index for
 /// these predicates.
+/// The triples are buffered and processed in batches, where the patterns of
+/// the subjects are detected concurrently for disjoint ranges of subjects (see
+/// `processBatch`).
 class PatternCreatorNew {
  public:
   using PSOSorter = ad_utility::CompressedExternalIdTableSorter<SortByPSO, 3>;
@@ -94,17 +100,16 @@ class PatternCreatorNew {
   PatternToIdAndCount patternToIdAndCount_;
 
   // Between the calls to `processTriple` we have to remember the current
-  // subject (the subject of the last triple for which `processTriple` was
-  // called).
-  std::optional<VocabIndex> currentSubjectIndex_;
-  // The pattern of `currentSubjectIndex_`. This might still be incomplete,
-  // because more triples with the same subject might be pushed.
-  Pattern currentPattern_;
+  // subject (the subject of the last triple that is not ignored for the
+  // patterns). This might also be a subject that is not part of the vocabulary
+  // (an `EncodedIri`).
+  std::optional<Id> currentSubject_;
 
   ad_utility::serialization::FileWriteSerializer patternSerializer_;
 
-  // Store the additional triples that are created by the pattern mechanism for
-  // the `has-pattern` and `has-predicate` predicates.
+  // The triples that have been pushed since the last call to `processBatch`.
+  // The buffer always ends with complete subjects, except for the
+  // `currentSubject_`, whose pattern might still be incomplete.
   struct TripleAndIsInternal {
     std::array<Id, 3> triple_;
     bool isInternal_;
@@ -129,7 +134,8 @@ class PatternCreatorNew {
                              ad_utility::MemorySize memoryLimit)
       : filename_{basename},
         patternSerializer_{{basename}},
-        tripleBuffer_(100'000, basename + ".tripleBufferForPatterns.dat"),
+        tripleBuffer_(2 * NUM_TRIPLES_PER_BATCH_PATTERN_CREATION,
+                      basename + ".tripleBufferForPatterns.dat"),
         tripleSorter_{
             std::make_unique<PSOSorter>(
                 basename + ".additionalTriples.pso.dat", memoryLimit / 2,
@@ -175,7 +181,16 @@ class PatternCreatorNew {
   }
 
  private:
-  void finishSubject(VocabIndex subjectIndex, const Pattern& pattern);
+  // Compute the patterns of all the subjects in the `tripleBuffer_` and push
+  // the triples with their patterns as well as the `has-pattern` triples to
+  // the `tripleSorter_`. The buffer is split into at most
+  // `NUM_THREADS_PATTERN_CREATION` chunks of complete subjects, the patterns of
+  // which are detected and deduplicated concurrently. The pattern IDs are then
+  // assigned sequentially in the order of the chunks, s.t. they are the same
+  // as when the triples were processed one after the other. A triple that is
+  // ignored for the patterns gets the pattern of its subject iff it comes
+  // after the first triple of this subject that is not ignored.
+  void processBatch();
 
   void printStatistics(PatternStatistics patternStatistics) const;
 
@@ -192,9 +207,12 @@ class PatternCreator {
 
   // Store the Id of a pattern, and the number of distinct subjects it occurs
   // with.
+  // Also store the total number of triples of all these subjects per predicate
+  // of the pattern for the `CharacteristicSets`.
   struct PatternIdAndCount {
     PatternID _patternId = 0;
     uint64_t _count = 0;
+    std::vector<uint64_t> _numTriplesPerPredicate;
   };
   using PatternToIdAndCount = ad_utility::HashMap<Pattern, PatternIdAndCount>;
   PatternToIdAndCount _patternToIdAndCount;
@@ -206,6 +224,9 @@ class PatternCreator {
   // The pattern of `currentSubjectIndex_`. This might still be incomplete,
   // because more triples with the same subject might be pushed.
   Pattern _currentPattern;
+  // The number of triples of `_currentSubjectIndex` for each predicate of
+  // `_currentPattern`.
+  std::vector<uint64_t> _currentNumTriplesPerPredicate;
 
   // The lowest subject Id for which we have not yet finished and written the
   // pattern.
@@ -240,10 +261,11 @@ class PatternCreator {
   // permutation.
   void processTriple(std::array<Id, 3> triple);
 
-  // Write the patterns to disk after all triples have been pushed. Calls to
-  // `processTriple` after calling `finish` lead to undefined behavior. Note
-  // that the constructor also calls `finish` to give the `PatternCreator`
-  // proper RAII semantics.
+  // Write the patterns to disk after all triples have been pushed. The
+  // `CharacteristicSets` of the patterns are written to the `filename` with
+  // the `CharacteristicSets::FILE_SUFFIX`. Calls to `processTriple` after
+  // calling `finish` lead to undefined behavior. Note that the constructor
+  // also calls `finish` to give the `PatternCreator` proper RAII semantics.
   void finish();
 
   // Destructor implicitly calls `finish`
@@ -261,7 +283,7 @@ class PatternCreator {
                                    double& avgNumPredicatesPerSubject,
                                    uint64_t& numDistinctSubjectPredicatePairs,
                                    CompactVectorOfStrings<Id>& patterns,
-                                   std::vector<PatternID>& subjectToPattern);
+                                   CompressedPatternIds& subjectToPattern);
 
  private:
   void finishSubject(VocabIndex subjectIndex, const Pattern& pattern);
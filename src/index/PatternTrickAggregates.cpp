@@ -0,0 +1,73 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/PatternTrickAggregates.h"
+
+#include <algorithm>
+
+#include "util/Serializer/FileSerializer.h"
+
+// _____________________________________________________________________________
+void PatternTrickAggregates::Builder::add(std::span<const Id> subjects) {
+  for (Id subject : subjects) {
+    // Each subject is counted only once, and like in the pattern trick only
+    // the subjects from the vocabulary can have a pattern.
+    if (lastSubject_ == subject) {
+      continue;
+    }
+    lastSubject_ = subject;
+    ++numSubjects_;
+    if (subject.getDatatype() != Datatype::VocabIndex) {
+      continue;
+    }
+    auto subjectIndex = subject.getVocabIndex().get();
+    if (subjectIndex < hasPattern_.size() &&
+        hasPattern_[subjectIndex] != NO_PATTERN) {
+      ++patternCounts_[hasPattern_[subjectIndex]];
+    }
+  }
+}
+
+// _____________________________________________________________________________
+auto PatternTrickAggregates::Builder::finish() -> PredicateCounts {
+  ad_utility::HashMap<Id, uint64_t> predicateCounts;
+  for (const auto& [patternId, count] : patternCounts_) {
+    for (Id predicate : patterns_[patternId]) {
+      predicateCounts[predicate] += count;
+    }
+  }
+  PredicateCounts result{predicateCounts.begin(), predicateCounts.end()};
+  std::ranges::sort(result);
+  patternCounts_.clear();
+  lastSubject_ = std::nullopt;
+  numSubjects_ = 0;
+  return result;
+}
+
+// _____________________________________________________________________________
+void PatternTrickAggregates::add(Id predicate, Id object,
+                                 PredicateCounts counts) {
+  aggregates_[std::pair{predicate, object}] = std::move(counts);
+}
+
+// _____________________________________________________________________________
+auto PatternTrickAggregates::get(Id predicate, Id object) const
+    -> const PredicateCounts* {
+  auto it = aggregates_.find(std::pair{predicate, object});
+  return it == aggregates_.end() ? nullptr : &it->second;
+}
+
+// _____________________________________________________________________________
+void PatternTrickAggregates::writeToFile(const std::string& filename) const {
+  ad_utility::serialization::FileWriteSerializer serializer{filename};
+  serializer << aggregates_;
+}
+
+// _____________________________________________________________________________
+PatternTrickAggregates PatternTrickAggregates::readFromFile(
+    const std::string& filename) {
+  ad_utility::serialization::FileReadSerializer serializer{filename};
+  PatternTrickAggregates result;
+  serializer >> result.aggregates_;
+  return result;
+}
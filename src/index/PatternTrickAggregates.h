@@ -0,0 +1,82 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "global/Id.h"
+#include "global/Pattern.h"
+#include "index/CompressedPatternIds.h"
+#include "util/HashMap.h"
+#include "util/Serializer/SerializeHashMap.h"
+#include "util/Serializer/SerializePair.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+// The precomputed results of the pattern trick (see `CountAvailablePredicates`)
+// for the subjects of the triples with a fixed predicate and object, for
+// example `?x wdt:P31 wd:Q5 . ?x ql:has-predicate ?p`. They are computed at
+// the end of the index build for each such group with at least
+// `pattern-trick-aggregates-min-size` subjects (see the settings JSON), from
+// the patterns that the `PatternCreator` has assigned to the subjects.
+class PatternTrickAggregates {
+ public:
+  // The aggregates are written to the file with this suffix.
+  static constexpr std::string_view FILE_SUFFIX =
+      ".index.pattern-trick-aggregates";
+
+  // The distinct predicates of the subjects of a group, each with the number
+  // of subjects that have this predicate.
+  using PredicateCounts = std::vector<std::pair<Id, uint64_t>>;
+
+  // Compute the `PredicateCounts` for a group from the subjects of the group,
+  // which are passed to `add` in sorted order (in several chunks).
+  class Builder {
+   private:
+    const CompressedPatternIds& hasPattern_;
+    const CompactVectorOfStrings<Id>& patterns_;
+    ad_utility::HashMap<PatternID, uint64_t> patternCounts_;
+    std::optional<Id> lastSubject_;
+    uint64_t numSubjects_ = 0;
+
+   public:
+    Builder(const CompressedPatternIds& hasPattern,
+            const CompactVectorOfStrings<Id>& patterns)
+        : hasPattern_{hasPattern}, patterns_{patterns} {}
+    void add(std::span<const Id> subjects);
+    // The number of distinct subjects that have been added so far.
+    uint64_t numSubjects() const { return numSubjects_; }
+    // Return the counts of the added subjects and reset the builder for the
+    // next group.
+    PredicateCounts finish();
+  };
+
+ private:
+  // Map from the predicate and object of a group to its counts.
+  ad_utility::HashMap<std::pair<Id, Id>, PredicateCounts> aggregates_;
+
+ public:
+  void add(Id predicate, Id object, PredicateCounts counts);
+
+  // Return the counts of the group with the `predicate` and `object` or
+  // `nullptr` if they were not precomputed.
+  const PredicateCounts* get(Id predicate, Id object) const;
+
+  // The number of groups with precomputed counts.
+  size_t size() const { return aggregates_.size(); }
+  bool empty() const { return aggregates_.empty(); }
+
+  // Write the aggregates to the `filename`.
+  void writeToFile(const std::string& filename) const;
+
+  // Read the aggregates that were written by `writeToFile` from the
+  // `filename`.
+  static PatternTrickAggregates readFromFile(const std::string& filename);
+};
@@ -32,7 +32,7 @@ void Permutation::loadFromDisk(const std::string& onDiskBase) {
              e.what());
   }
   meta_.readFromFile(&file);
-  reader_.emplace(allocator_, std::move(file));
+  reader_.emplace(allocator_, std::move(file), readableName_);
   LOG(INFO) << "Registered " << readableName_
             << " permutation: " << meta_.statistics() << std::endl;
   isLoaded_ = true;
@@ -1,83 +1,504 @@
 //  Copyright 2021, University of Freiburg, Chair of Algorithms and Data
 //  Structures. Author: Johannes Kalmbach <kalmbacj@cs.uni-freiburg.de>
 
+#include <absl/strings/str_cat.h>
+
+#include <array>
+#include <atomic>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 #include "./Index.h"
 #include "./IndexImpl.h"
-#include "./TriplesView.h"
-#include "util/MemorySize/MemorySize.h"
-
-/// Dump a  certain permutation to stdout in a human-readable way as IDs, and
-/// in deterministic order
-template <typename Permutation>
-void dumpToStdout(const Permutation& permutation) {
-  ad_utility::AllocatorWithLimit<Id> allocator{
-      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
-          ad_utility::MemorySize::max())};
-  auto triples = TriplesView(
-      permutation, std::make_shared<ad_utility::CancellationHandle<>>());
-  size_t i = 0;
-  for (auto triple : triples) {
-    std::cout << triple[0] << " " << triple[1] << " " << triple[2] << std::endl;
-    ++i;
-    if (i % (1ul << 20) == 0) {
-      LOG(INFO) << "Exported " << i << " relations" << std::endl;
+#include "util/ArrowIpc.h"
+#include "util/File.h"
+#include "util/ThreadSafeQueue.h"
+#include "util/Timer.h"
+
+namespace po = boost::program_options;
+
+namespace {
+// The formats of the export. `Text` is the human-readable format (one triple
+// of IDs per line), `Arrow` an Arrow IPC stream with one `Int64` column per
+// column of the permutation, and `Binary` one file per column with the raw
+// 64-bit values of the IDs.
+enum class Format { Text, Arrow, Binary };
+
+struct ExportOptions {
+  Format format_ = Format::Text;
+  // The output file (for `Binary` the prefix of the files). If empty, the
+  // export is written to stdout.
+  std::string output_;
+  size_t numThreads_ = 1;
+  size_t rowsPerBatch_ = 1'000'000;
+  // Only the relations with `col0Begin_ <= col0Id < col0End_` are exported.
+  Id col0Begin_ = Id::min();
+  Id col0End_ = Id::max();
+  // The names of the three columns (e.g. "p", "s", "o" for the PSO
+  // permutation).
+  std::array<std::string, 3> columnNames_;
+};
+
+// A part of the permutation that is exported as a whole by one thread: the
+// relations at the positions `[firstRelation_, endRelation_)` of the metadata
+// of the permutation. For a relation that has more rows than a batch, a batch
+// contains only the `blocks_` (given as the range of the positions in the
+// blocks of the relation) of this single relation.
+struct Batch {
+  size_t firstRelation_;
+  size_t endRelation_;
+  std::optional<std::pair<size_t, size_t>> blocks_;
+};
+
+// The blocks of the `relation` in the `permutation`.
+std::span<const CompressedBlockMetadata> getBlocks(
+    const Permutation& permutation,
+    const CompressedRelationMetadata& relation) {
+  return CompressedRelationReader::getBlocksFromMetadata(
+      relation, std::nullopt, permutation.metaData().blockData());
+}
+
+// Split the relations of the `permutation` that are in the col0 range of the
+// `options` into batches of about `options.rowsPerBatch_` rows each.
+std::vector<Batch> computeBatches(const Permutation& permutation,
+                                  const ExportOptions& options) {
+  const auto& metaData = permutation.metaData().data();
+  auto orderedBegin = metaData.ordered_begin();
+  auto orderedEnd = metaData.ordered_end();
+  auto position = [&](Id col0Id) {
+    auto it = std::lower_bound(
+        orderedBegin, orderedEnd, col0Id, [](const auto& relation, const Id& id) {
+          return decltype(orderedBegin)::getIdFromElement(relation) < id;
+        });
+    return static_cast<size_t>(it - orderedBegin);
+  };
+  size_t begin = position(options.col0Begin_);
+  size_t end = std::max(begin, position(options.col0End_));
+
+  std::vector<Batch> batches;
+  size_t firstRelation = begin;
+  size_t numRowsOfBatch = 0;
+  auto finishBatch = [&](size_t endRelation) {
+    if (firstRelation < endRelation) {
+      batches.push_back({firstRelation, endRelation, std::nullopt});
+    }
+    firstRelation = endRelation;
+    numRowsOfBatch = 0;
+  };
+  for (size_t i = begin; i < end; ++i) {
+    const CompressedRelationMetadata& relation = *std::next(orderedBegin, i);
+    if (relation.numRows_ <= options.rowsPerBatch_) {
+      numRowsOfBatch += relation.numRows_;
+      if (numRowsOfBatch >= options.rowsPerBatch_) {
+        finishBatch(i + 1);
+      }
+      continue;
+    }
+    // A large relation is split into ranges of blocks.
+    finishBatch(i);
+    auto blocks = getBlocks(permutation, relation);
+    size_t firstBlock = 0;
+    size_t numRowsOfBlocks = 0;
+    for (size_t j = 0; j < blocks.size(); ++j) {
+      numRowsOfBlocks += blocks[j].numRows_;
+      if (numRowsOfBlocks >= options.rowsPerBatch_ || j + 1 == blocks.size()) {
+        batches.push_back({i, i + 1, std::pair{firstBlock, j + 1}});
+        firstBlock = j + 1;
+        numRowsOfBlocks = 0;
+      }
+    }
+    firstRelation = i + 1;
+  }
+  finishBatch(end);
+  return batches;
+}
+
+// Read the triples of the `batch` from the `permutation` and return them as
+// three columns of the bits of the IDs.
+std::array<std::vector<uint64_t>, 3> readBatch(
+    const Permutation& permutation, const Batch& batch,
+    const ad_utility::SharedCancellationHandle& cancellationHandle) {
+  auto orderedBegin = permutation.metaData().data().ordered_begin();
+  std::array<std::vector<uint64_t>, 3> columns;
+  for (size_t i = batch.firstRelation_; i < batch.endRelation_; ++i) {
+    const CompressedRelationMetadata& relation = *std::next(orderedBegin, i);
+    std::optional<std::vector<CompressedBlockMetadata>> blocks;
+    if (batch.blocks_.has_value()) {
+      auto blocksOfRelation = getBlocks(permutation, relation);
+      auto [firstBlock, endBlock] = batch.blocks_.value();
+      blocks.emplace(blocksOfRelation.begin() + firstBlock,
+                     blocksOfRelation.begin() + endBlock);
+    }
+    auto blockGenerator = permutation.lazyScan(
+        relation.col0Id_, std::nullopt, std::move(blocks),
+        CompressedRelationReader::ColumnIndices{}, cancellationHandle);
+    for (const IdTable& col1And2 : blockGenerator) {
+      AD_CORRECTNESS_CHECK(col1And2.numColumns() == 2);
+      columns[0].insert(columns[0].end(), col1And2.numRows(),
+                        relation.col0Id_.getBits());
+      for (size_t col = 0; col < 2; ++col) {
+        for (Id id : col1And2.getColumn(col)) {
+          columns[col + 1].push_back(id.getBits());
+        }
+      }
+    }
+  }
+  return columns;
+}
+
+// Serialize the `columns` of a batch in the `format`. For `Binary` the result
+// contains one string per column, else a single string.
+std::vector<std::string> formatBatch(
+    const std::array<std::vector<uint64_t>, 3>& columns, Format format) {
+  size_t numRows = columns[0].size();
+  if (format == Format::Text) {
+    std::ostringstream text;
+    for (size_t i = 0; i < numRows; ++i) {
+      text << Id::fromBits(columns[0][i]) << " " << Id::fromBits(columns[1][i])
+           << " " << Id::fromBits(columns[2][i]) << "\n";
+    }
+    return {std::move(text).str()};
+  }
+  if (format == Format::Arrow) {
+    using namespace ad_utility::arrow;
+    std::vector<Column> arrowColumns(3, Column{Type::Int64});
+    for (size_t col = 0; col < 3; ++col) {
+      for (uint64_t bits : columns[col]) {
+        arrowColumns[col].appendInt(static_cast<int64_t>(bits));
+      }
+    }
+    return {recordBatchMessage(arrowColumns)};
+  }
+  std::vector<std::string> result;
+  for (const auto& column : columns) {
+    result.emplace_back(reinterpret_cast<const char*>(column.data()),
+                        column.size() * sizeof(uint64_t));
+  }
+  return result;
+}
+
+// Export the part of the `permutation` that is specified by the `options`.
+// The batches are read, decompressed, and serialized concurrently by
+// `options.numThreads_` threads and written in the order of the permutation.
+void exportPermutation(const Permutation& permutation,
+                       const ExportOptions& options) {
+  auto batches = computeBatches(permutation, options);
+  LOG(INFO) << "Exporting the permutation in " << batches.size()
+            << " batches with " << options.numThreads_ << " threads ..."
+            << std::endl;
+
+  // The output streams, one per column for `Binary`, else a single one.
+  std::vector<std::ofstream> files;
+  std::vector<std::ostream*> outputs;
+  if (options.format_ == Format::Binary) {
+    for (size_t col = 0; col < 3; ++col) {
+      files.push_back(ad_utility::makeOfstream(
+          absl::StrCat(options.output_, ".", options.columnNames_[col]),
+          std::ios::binary));
+    }
+  } else if (!options.output_.empty()) {
+    files.push_back(ad_utility::makeOfstream(options.output_,
+                                             std::ios::binary));
+  }
+  for (auto& file : files) {
+    outputs.push_back(&file);
+  }
+  if (outputs.empty()) {
+    outputs.push_back(&std::cout);
+  }
+
+  if (options.format_ == Format::Arrow) {
+    using namespace ad_utility::arrow;
+    std::vector<Field> fields;
+    for (const auto& name : options.columnNames_) {
+      fields.push_back({name, Type::Int64});
+    }
+    *outputs.front() << schemaMessage(fields);
+  }
+
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  std::atomic<size_t> nextBatch = 0;
+  auto readAndFormatNextBatch =
+      [&]() -> std::optional<std::pair<size_t, std::vector<std::string>>> {
+    size_t i = nextBatch++;
+    if (i >= batches.size()) {
+      return std::nullopt;
+    }
+    auto columns = readBatch(permutation, batches[i], cancellationHandle);
+    return std::pair{i, formatBatch(columns, options.format_)};
+  };
+  auto queue = ad_utility::data_structures::queueManager<
+      ad_utility::data_structures::OrderedThreadSafeQueue<
+          std::vector<std::string>>>(2 * options.numThreads_,
+                                     options.numThreads_,
+                                     readAndFormatNextBatch);
+  ad_utility::Timer timer{ad_utility::Timer::Started};
+  size_t numBatchesWritten = 0;
+  size_t numBytesWritten = 0;
+  for (const auto& parts : queue) {
+    for (size_t i = 0; i < parts.size(); ++i) {
+      outputs.at(i)->write(parts[i].data(),
+                           static_cast<std::streamsize>(parts[i].size()));
+      numBytesWritten += parts[i].size();
+    }
+    ++numBatchesWritten;
+    if (numBatchesWritten % 100 == 0) {
+      LOG(INFO) << "Exported " << numBatchesWritten << " of " << batches.size()
+                << " batches" << std::endl;
+    }
+  }
+  if (options.format_ == Format::Arrow) {
+    *outputs.front() << ad_utility::arrow::endOfStream();
+  }
+  for (auto* output : outputs) {
+    output->flush();
+    if (!output->good()) {
+      throw std::runtime_error{"Writing the export failed"};
+    }
+  }
+  LOG(INFO) << "Done, wrote " << numBytesWritten << " bytes in "
+            << ad_utility::Timer::toSeconds(timer.value()) << " seconds"
+            << std::endl;
+}
+
+// Export the vocabulary of the index with the `indexBasename` as the
+// dictionary that maps the values of the exported columns to the words: The
+// Arrow IPC stream `<output>.vocabulary.arrow` with the columns `id` and
+// `word`, or (for `Binary`) the files `<output>.vocabulary.ids` (the IDs),
+// `<output>.vocabulary.offsets` (the offsets of the words, one more than
+// there are words) and `<output>.vocabulary.words` (the concatenated words).
+void exportVocabulary(const std::string& indexBasename,
+                      const ExportOptions& options) {
+  Index::Vocab vocab;
+  vocab.readFromFile(indexBasename + INTERNAL_VOCAB_SUFFIX,
+                     indexBasename + EXTERNAL_VOCAB_SUFFIX);
+  size_t vocabSize = vocab.size() + vocab.getExternalVocab().size();
+  LOG(INFO) << "Exporting the vocabulary with " << vocabSize << " words ..."
+            << std::endl;
+  // The words are written in batches of this size.
+  constexpr size_t batchSize = 1'000'000;
+  auto forEachBatch = [&vocab, vocabSize](auto onBatch) {
+    std::vector<uint64_t> ids;
+    std::vector<std::string> words;
+    for (size_t i = 0; i < vocabSize; ++i) {
+      auto word = vocab.indexToOptionalString(VocabIndex::make(i));
+      if (word.has_value()) {
+        ids.push_back(Id::makeFromVocabIndex(VocabIndex::make(i)).getBits());
+        words.push_back(std::move(word.value()));
+      }
+      if (ids.size() == batchSize || (i + 1 == vocabSize && !ids.empty())) {
+        onBatch(ids, words);
+        ids.clear();
+        words.clear();
+      }
     }
+  };
+
+  std::string prefix = absl::StrCat(options.output_, ".vocabulary");
+  if (options.format_ == Format::Arrow) {
+    using namespace ad_utility::arrow;
+    auto file =
+        ad_utility::makeOfstream(absl::StrCat(prefix, ".arrow"),
+                                 std::ios::binary);
+    std::vector<Field> fields{{"id", Type::Int64},
+                              {"word", Type::DictionaryString}};
+    file << schemaMessage(fields);
+    forEachBatch([&file](const auto& ids, const auto& words) {
+      std::vector<Column> columns{Column{Type::Int64},
+                                  Column{Type::DictionaryString}};
+      for (size_t i = 0; i < ids.size(); ++i) {
+        columns[0].appendInt(static_cast<int64_t>(ids[i]));
+        columns[1].appendIndex(static_cast<int32_t>(i));
+      }
+      // The dictionary of the `word` column (the field at position 1).
+      file << dictionaryBatchMessage(1, words) << recordBatchMessage(columns);
+    });
+    file << endOfStream();
+    return;
   }
+  AD_CORRECTNESS_CHECK(options.format_ == Format::Binary);
+  auto idFile =
+      ad_utility::makeOfstream(absl::StrCat(prefix, ".ids"), std::ios::binary);
+  auto offsetFile = ad_utility::makeOfstream(absl::StrCat(prefix, ".offsets"),
+                                             std::ios::binary);
+  auto wordFile = ad_utility::makeOfstream(absl::StrCat(prefix, ".words"),
+                                           std::ios::binary);
+  uint64_t offset = 0;
+  auto writeValue = [](std::ofstream& file, uint64_t value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  writeValue(offsetFile, offset);
+  forEachBatch([&](const auto& ids, const auto& words) {
+    for (size_t i = 0; i < ids.size(); ++i) {
+      writeValue(idFile, ids[i]);
+      wordFile << words[i];
+      offset += words[i].size();
+      writeValue(offsetFile, offset);
+    }
+  });
 }
 
-/// Load a certain permutation from a certain index, and dump it to stdout
-/// in a human-readable and deterministic way. This can be used for large
-/// regression tests, when the index format or the index building procedure
-/// changes.
-/// Args: ./PermutationExporterMain <indexBasename> <permutation>
+// Parse the `format` argument of the command line.
+Format parseFormat(std::string_view format) {
+  if (format == "text") {
+    return Format::Text;
+  }
+  if (format == "arrow") {
+    return Format::Arrow;
+  }
+  if (format == "binary") {
+    return Format::Binary;
+  }
+  throw std::runtime_error{absl::StrCat(
+      "--format must be one of text, arrow, binary, but was \"", format,
+      "\"")};
+}
+}  // namespace
+
+/// Load a certain permutation from a certain index, and export it in a
+/// deterministic way. The default is a human-readable dump of the IDs to
+/// stdout, which can be used for large regression tests, when the index format
+/// or the index building procedure changes. For offline analyses of large
+/// permutations, the blocks can be decompressed concurrently and be written as
+/// an Arrow IPC stream or as raw binary columns, optionally together with the
+/// vocabulary as the dictionary of the IDs.
+/// Args: ./PermutationExporterMain <indexBasename> <permutation> [options]
 ///  (<permutation>  must be one of pso, pos, spo, sop, osp, ops
 int main(int argc, char** argv) {
   // Actual output goes to std::cout,output of LOG(...) to std::cerr
   ad_utility::setGlobalLoggingStream(&std::cerr);
 
-  if (argc != 3) {
-    LOG(ERROR) << "Usage: PermutationExporterMain <indexBasename> <permutation "
-                  "to dump>"
-               << std::endl;
+  std::string indexName;
+  std::string p;
+  std::string format;
+  uint64_t col0Begin = 0;
+  uint64_t col0End = 0;
+  bool withVocabulary = false;
+  ExportOptions options;
+
+  po::options_description visibleOptions(
+      "Usage: PermutationExporterMain <indexBasename> <permutation> "
+      "[options]\nOptions for PermutationExporterMain");
+  auto add = [&visibleOptions]<typename... Args>(Args&&... args) {
+    visibleOptions.add_options()(std::forward<Args>(args)...);
+  };
+  add("help,h", "Produce this help message.");
+  add("format,f", po::value<std::string>(&format)->default_value("text"),
+      "The format of the export: \"text\" (one triple of IDs per line), "
+      "\"arrow\" (an Arrow IPC stream with one column of 64-bit integers per "
+      "column of the permutation), or \"binary\" (one file per column with "
+      "the raw 64-bit values of the IDs).");
+  add("output,o", po::value<std::string>(&options.output_),
+      "The output file (default: stdout). For the binary format, the prefix "
+      "of the files (required), to which the name of the column is appended.");
+  add("num-threads,j", po::value<size_t>(&options.numThreads_),
+      "The number of threads that read and decompress the blocks.");
+  add("rows-per-batch",
+      po::value<size_t>(&options.rowsPerBatch_)->default_value(1'000'000),
+      "The (approximate) number of rows that are exported by a thread at "
+      "once.");
+  add("col0-begin", po::value(&col0Begin),
+      "Only export the relations with a col0 ID that is at least this value "
+      "(the 64 bits of the ID, as in the arrow and binary formats).");
+  add("col0-end", po::value(&col0End),
+      "Only export the relations with a col0 ID that is less than this value "
+      "(the 64 bits of the ID, as in the arrow and binary formats).");
+  add("vocabulary", po::bool_switch(&withVocabulary),
+      "Also export the vocabulary, which maps the IDs to their words, to "
+      "<output>.vocabulary.* in the arrow or binary format.");
+  po::options_description allOptions;
+  allOptions.add(visibleOptions);
+  allOptions.add_options()("index-basename", po::value(&indexName))(
+      "permutation", po::value(&p));
+  po::positional_options_description positional;
+  positional.add("index-basename", 1).add("permutation", 1);
+
+  try {
+    po::variables_map optionsMap;
+    po::store(po::command_line_parser(argc, argv)
+                  .options(allOptions)
+                  .positional(positional)
+                  .run(),
+              optionsMap);
+    if (optionsMap.count("help")) {
+      std::cout << visibleOptions << '\n';
+      return EXIT_SUCCESS;
+    }
+    po::notify(optionsMap);
+    if (indexName.empty() || p.empty()) {
+      throw std::runtime_error{
+          "Both the <indexBasename> and the <permutation> are required"};
+    }
+    options.format_ = parseFormat(format);
+    if (optionsMap.count("col0-begin")) {
+      options.col0Begin_ = Id::fromBits(col0Begin);
+    }
+    if (optionsMap.count("col0-end")) {
+      options.col0End_ = Id::fromBits(col0End);
+    }
+    if (!optionsMap.count("num-threads")) {
+      options.numThreads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (options.numThreads_ == 0 || options.rowsPerBatch_ == 0) {
+      throw std::runtime_error{
+          "--num-threads and --rows-per-batch must be positive"};
+    }
+    if (options.output_.empty() &&
+        (options.format_ == Format::Binary || withVocabulary)) {
+      throw std::runtime_error{
+          "--output is required for the binary format and --vocabulary"};
+    }
+    if (withVocabulary && options.format_ == Format::Text) {
+      throw std::runtime_error{
+          "--vocabulary is only supported for the arrow and binary formats"};
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what() << std::endl;
+    std::cerr << visibleOptions << std::endl;
     return EXIT_FAILURE;
   }
+  for (size_t i = 0; i < 3 && i < p.size(); ++i) {
+    options.columnNames_[i] = std::string(1, p[i]);
+  }
 
   Index i{ad_utility::makeUnlimitedAllocator<Id>()};
   IndexImpl& impl = i.getImpl();
-  std::string indexName{argv[1]};
-  std::string p{argv[2]};
+  auto exportTo = [&](Permutation& permutation) {
+    permutation.loadFromDisk(indexName);
+    exportPermutation(permutation, options);
+    if (withVocabulary) {
+      exportVocabulary(indexName, options);
+    }
+    return EXIT_SUCCESS;
+  };
 
   if (p == "sop") {
-    impl.SOP().loadFromDisk(indexName);
-    dumpToStdout(impl.SOP());
-    return EXIT_SUCCESS;
+    return exportTo(impl.SOP());
   }
   if (p == "spo") {
-    impl.SPO().loadFromDisk(indexName);
-    dumpToStdout(impl.SPO());
-    return EXIT_SUCCESS;
+    return exportTo(impl.SPO());
   }
   if (p == "osp") {
-    impl.OSP().loadFromDisk(indexName);
-    dumpToStdout(impl.OSP());
-    return EXIT_SUCCESS;
+    return exportTo(impl.OSP());
   }
   if (p == "ops") {
-    impl.OPS().loadFromDisk(indexName);
-    dumpToStdout(impl.OPS());
-    return EXIT_SUCCESS;
+    return exportTo(impl.OPS());
   }
 
   if (p == "pos") {
-    impl.POS().loadFromDisk(indexName);
-    dumpToStdout(impl.POS());
-    return EXIT_SUCCESS;
+    return exportTo(impl.POS());
   }
 
   if (p == "pso") {
-    impl.PSO().loadFromDisk(indexName);
-    dumpToStdout(impl.PSO());
-    return EXIT_SUCCESS;
+    return exportTo(impl.PSO());
   }
 
   LOG(ERROR)
@@ -0,0 +1,95 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/PredicateHistograms.h"
+
+#include <algorithm>
+
+#include "util/Serializer/FileSerializer.h"
+
+// _____________________________________________________________________________
+ObjectHistogram::Builder::Builder(uint64_t numRows)
+    : numRows_{numRows},
+      numBuckets_{std::min(numRows, uint64_t{MAX_NUM_BUCKETS})} {
+  quantiles_.reserve(numBuckets_);
+}
+
+// _____________________________________________________________________________
+void ObjectHistogram::Builder::add(std::span<const Id> objects) {
+  for (Id object : objects) {
+    if (lastObject_ != object) {
+      ++numDistinct_;
+      lastObject_ = object;
+    }
+    // The `k`-th quantile is the object in the middle of the `k`-th of the
+    // `numBuckets_` equally large buckets.
+    if (quantiles_.size() < numBuckets_ &&
+        numSeen_ ==
+            (2 * quantiles_.size() + 1) * numRows_ / (2 * numBuckets_)) {
+      quantiles_.push_back(object);
+    }
+    ++numSeen_;
+  }
+}
+
+// _____________________________________________________________________________
+ObjectHistogram ObjectHistogram::Builder::finish() && {
+  ObjectHistogram result;
+  result.quantiles_ = std::move(quantiles_);
+  result.numRows_ = numSeen_;
+  result.numDistinct_ = numDistinct_;
+  return result;
+}
+
+// _____________________________________________________________________________
+double ObjectHistogram::estimateFraction(
+    valueIdComparators::Comparison comparison, Id constant) const {
+  if (quantiles_.empty()) {
+    return 0.0;
+  }
+  using namespace valueIdComparators;
+  auto numMatching = std::ranges::count_if(quantiles_, [&](Id quantile) {
+    return compareIds(quantile, constant, comparison) == ComparisonResult::True;
+  });
+  double fraction =
+      static_cast<double>(numMatching) / static_cast<double>(quantiles_.size());
+  // A value that is not frequent enough to be one of the quantiles is assumed
+  // to have the average number of triples.
+  double averageFractionPerValue =
+      std::min(1.0 / static_cast<double>(std::max(numDistinct_, uint64_t{1})),
+               1.0 / static_cast<double>(quantiles_.size()));
+  if (comparison == Comparison::EQ && numMatching == 0) {
+    return averageFractionPerValue;
+  }
+  if (comparison == Comparison::NE &&
+      static_cast<size_t>(numMatching) == quantiles_.size()) {
+    return 1.0 - averageFractionPerValue;
+  }
+  return fraction;
+}
+
+// _____________________________________________________________________________
+void PredicateHistograms::add(Id predicate, ObjectHistogram histogram) {
+  histograms_[predicate] = std::move(histogram);
+}
+
+// _____________________________________________________________________________
+const ObjectHistogram* PredicateHistograms::get(Id predicate) const {
+  auto it = histograms_.find(predicate);
+  return it == histograms_.end() ? nullptr : &it->second;
+}
+
+// _____________________________________________________________________________
+void PredicateHistograms::writeToFile(const std::string& filename) const {
+  ad_utility::serialization::FileWriteSerializer serializer{filename};
+  serializer << histograms_;
+}
+
+// _____________________________________________________________________________
+PredicateHistograms PredicateHistograms::readFromFile(
+    const std::string& filename) {
+  ad_utility::serialization::FileReadSerializer serializer{filename};
+  PredicateHistograms result;
+  serializer >> result.histograms_;
+  return result;
+}
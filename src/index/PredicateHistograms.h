@@ -0,0 +1,96 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "global/Id.h"
+#include "global/ValueIdComparators.h"
+#include "util/HashMap.h"
+#include "util/Serializer/SerializeHashMap.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+// An equi-depth histogram of the objects of the triples of a single predicate.
+// It consists of the objects at evenly spaced positions of the (sorted) object
+// column of the predicate in the POS permutation, s.t. each of them represents
+// the same number of triples. It is used to estimate the selectivity of
+// `FILTER`s like `?o < 42` on the objects of the predicate.
+class ObjectHistogram {
+ public:
+  // The maximal number of objects that are stored per predicate.
+  static constexpr size_t MAX_NUM_BUCKETS = 128;
+
+ private:
+  std::vector<Id> quantiles_;
+  uint64_t numRows_ = 0;
+  uint64_t numDistinct_ = 0;
+
+ public:
+  // Compute the histogram for a predicate with `numRows` triples, the objects
+  // of which are passed to `add` in sorted order (in several chunks).
+  class Builder {
+   private:
+    uint64_t numRows_;
+    uint64_t numBuckets_;
+    uint64_t numSeen_ = 0;
+    std::optional<Id> lastObject_;
+    std::vector<Id> quantiles_;
+    uint64_t numDistinct_ = 0;
+
+   public:
+    explicit Builder(uint64_t numRows);
+    void add(std::span<const Id> objects);
+    ObjectHistogram finish() &&;
+  };
+
+  // The estimated fraction of the triples of the predicate (between 0 and 1),
+  // the object `o` of which fulfills `o comparison constant`.
+  double estimateFraction(valueIdComparators::Comparison comparison,
+                          Id constant) const;
+
+  const std::vector<Id>& quantiles() const { return quantiles_; }
+  uint64_t numRows() const { return numRows_; }
+  uint64_t numDistinct() const { return numDistinct_; }
+
+  AD_SERIALIZE_FRIEND_FUNCTION(ObjectHistogram) {
+    serializer | arg.quantiles_;
+    serializer | arg.numRows_;
+    serializer | arg.numDistinct_;
+  }
+};
+
+// The histograms of the objects of all the predicates of an index. They are
+// computed at the end of the index build if `predicate-histograms` is set in
+// the settings JSON.
+class PredicateHistograms {
+ public:
+  // The histograms are written to the file with this suffix.
+  static constexpr std::string_view FILE_SUFFIX = ".index.predicate-histograms";
+
+ private:
+  ad_utility::HashMap<Id, ObjectHistogram> histograms_;
+
+ public:
+  void add(Id predicate, ObjectHistogram histogram);
+
+  // Return the histogram of the `predicate` or `nullptr` if there is none.
+  const ObjectHistogram* get(Id predicate) const;
+
+  // The number of predicates with a histogram.
+  size_t size() const { return histograms_.size(); }
+  bool empty() const { return histograms_.empty(); }
+
+  // Write the histograms to the `filename`.
+  void writeToFile(const std::string& filename) const;
+
+  // Read the histograms that were written by `writeToFile` from the
+  // `filename`.
+  static PredicateHistograms readFromFile(const std::string& filename);
+};
@@ -14,10 +14,13 @@
 #include <unicode/utypes.h>
 
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <memory_resource>
+#include <vector>
 
 #include "global/Constants.h"
+#include "util/ByteScanning.h"
 #include "util/Exception.h"
 #include "util/StringUtils.h"
 
@@ -179,30 +182,42 @@ class LocaleManager {
   void getSortKey(
       std::string_view s, const Level level,
       std::invocable<const uint8_t*, size_t> auto resultFunction) const {
-    // TODO<joka921> This function is one of the bottlenecks of the first pass
-    // of the IndexBuilder One possible improvement is to reuse the memory
-    // allocations for the `sortKeyBuffer`.
-    auto utf16 = icu::UnicodeString::fromUTF8(toStringPiece(s));
+    // This function is one of the bottlenecks of the first pass of the
+    // `IndexBuilder` and of the lookups in the vocabulary, so the buffers are
+    // reused between the calls on the same thread.
+    thread_local std::vector<UChar> utf16Buffer;
+    thread_local std::vector<uint8_t> sortKeyBuffer;
+    // Most IRIs and literals are pure ASCII. The ASCII characters are also
+    // UTF-16 code units, so they can be widened without decoding the UTF-8
+    // and without allocating an `icu::UnicodeString`.
+    icu::UnicodeString converted;
+    const UChar* utf16;
+    int32_t utf16Size;
+    if (!s.empty() && ad_utility::isAscii(s) &&
+        s.size() <= static_cast<size_t>(intMax)) {
+      utf16Buffer.assign(s.begin(), s.end());
+      utf16 = utf16Buffer.data();
+      utf16Size = static_cast<int32_t>(utf16Buffer.size());
+    } else {
+      converted = icu::UnicodeString::fromUTF8(toStringPiece(s));
+      utf16 = converted.getBuffer();
+      utf16Size = converted.length();
+    }
     auto& col = *_collator[static_cast<uint8_t>(level)];
-    std::vector<uint8_t> sortKeyBuffer;
     // The actual computation of the sort key is very expensive, so we first
-    // allocate a buffer that is typically large enough to store the sort key.
-    static constexpr size_t maxBufferSize = std::numeric_limits<int32_t>::max();
-    sortKeyBuffer.resize(std::min(50 * s.size(), maxBufferSize));
+    // use a buffer that is typically large enough to store the sort key.
     static_assert(sizeof(uint8_t) == sizeof(std::string::value_type));
-    static constexpr auto intMax = std::numeric_limits<int32_t>::max();
-    auto sz = col.getSortKey(utf16, sortKeyBuffer.data(),
+    sortKeyBuffer.resize(std::min(50 * s.size(), static_cast<size_t>(intMax)));
+    auto sz = col.getSortKey(utf16, utf16Size, sortKeyBuffer.data(),
                              static_cast<int32_t>(sortKeyBuffer.size()));
     AD_CONTRACT_CHECK(sz >= 0);
     // If the buffer was large enough, we only have to copy the sort key to the
     // destination. Otherwise, we now know the exact size of the sort key and
     // can retrigger the computation.
     if (static_cast<size_t>(sz) > sortKeyBuffer.size()) {
-      sortKeyBuffer.clear();
       sortKeyBuffer.resize(sz);
-      AD_CORRECTNESS_CHECK(sortKeyBuffer.size() <= static_cast<size_t>(intMax));
       auto actualSz =
-          col.getSortKey(utf16, (sortKeyBuffer.data()),
+          col.getSortKey(utf16, utf16Size, sortKeyBuffer.data(),
                          static_cast<int32_t>(sortKeyBuffer.size()));
       AD_CONTRACT_CHECK(actualSz ==
                         static_cast<decltype(sz)>(sortKeyBuffer.size()));
@@ -212,6 +227,13 @@ class LocaleManager {
     AD_CORRECTNESS_CHECK(sz > 0);
     --sz;
     resultFunction(sortKeyBuffer.data(), sz);
+    // Don't retain the buffers of very long strings.
+    if (sortKeyBuffer.capacity() > maxRetainedBufferSize) {
+      sortKeyBuffer = {};
+    }
+    if (utf16Buffer.capacity() > maxRetainedBufferSize) {
+      utf16Buffer = {};
+    }
   }
 
   // Overload of `getSortKey` that returns a `SortKey` directly.
@@ -305,6 +327,21 @@ class LocaleManager {
     return res;
   }
 
+  /**
+   * @brief Normalize the `input` in place (see `normalizeUtf8`). Most strings
+   * (e.g. all ASCII strings) already are in NFC, then this only checks the
+   * `input` and allocates no memory.
+   */
+  void normalizeUtf8InPlace(std::string& input) const {
+    UErrorCode err = U_ZERO_ERROR;
+    bool isNormalized =
+        _normalizer->isNormalizedUTF8(toStringPiece(input), err);
+    raise(err);
+    if (!isNormalized) {
+      input = normalizeUtf8(input);
+    }
+  }
+
  private:
   icu::Locale _icuLocale;  // the held locale
   /* One collator for each collation Level to make this class threadsafe.
@@ -319,6 +356,11 @@ class LocaleManager {
                 // since it wraps ICU. Initialized by the setupCollators()
                 // method
 
+  static constexpr size_t intMax = std::numeric_limits<int32_t>::max();
+  // The maximal number of elements of the buffers of `getSortKey` that are
+  // kept for the next call.
+  static constexpr size_t maxRetainedBufferSize = 1 << 16;
+
   // raise an exception if the error code holds an error.
   static void raise(const UErrorCode& err) {
     if (U_FAILURE(err)) {
@@ -625,6 +667,27 @@ class TripleComponentComparator {
     return cmp;
   }
 
+  // Compare two words `a` and `b` from the vocabulary on the `TOTAL` level,
+  // given the `SortKey`s of their inner values on the `TOTAL` level (the
+  // `transformedVal_` of the result of `extractAndTransformComparable`). The
+  // result is the same as that of `compare(a, b, Level::TOTAL)` for two
+  // internal words, but no ICU collation is needed, only the bytes of the
+  // `SortKey`s and, on ties, of the words are compared.
+  [[nodiscard]] static int compareWithSortKeys(
+      std::string_view a, const LocaleManager::SortKeyView& sortKeyA,
+      std::string_view b, const LocaleManager::SortKeyView& sortKeyB) {
+    const char firstA = a.empty() ? char(0) : a[0];
+    const char firstB = b.empty() ? char(0) : b[0];
+    if (auto res = std::strncmp(&firstA, &firstB, 1); res != 0) {
+      return res;  // different data types, decide on the datatype
+    }
+    if (int res = sortKeyA.compare(sortKeyB); res != 0) {
+      return res;
+    }
+    // The language tag is part of the word, so it needs no extra comparison.
+    return a.compare(b);
+  }
+
   /**
    * @brief Split a literal or iri into its components and convert the inner
    * value according to the held locale
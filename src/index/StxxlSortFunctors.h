@@ -28,26 +28,16 @@ using SortByPSO = SortTriple<1, 0, 2>;
 using SortBySPO = SortTriple<0, 1, 2>;
 using SortByOSP = SortTriple<2, 0, 1>;
 
-// TODO<joka921> Which of those are actually "IDs" and which are something else?
+// The order of the postings of the text index while it is built. Each posting
+// has the columns block, whether it is an entity posting, text record, word or
+// entity, and score (see `IndexImpl::addContextToVector`), which are sorted by
+// their bits in this order.
 struct SortText {
-  using T = std::tuple<TextBlockIndex, TextRecordIndex, WordOrEntityIndex,
-                       Score, bool>;
   // comparison function
-  bool operator()(const T& a, const T& b) const {
-    auto permute = [](const T& x) {
-      using namespace std;
-      return tie(get<0>(x), get<4>(x), get<1>(x), get<2>(x), get<3>(x));
+  bool operator()(const auto& a, const auto& b) const {
+    auto permute = [](const auto& x) {
+      return std::tie(x[0], x[1], x[2], x[3], x[4]);
     };
     return permute(a) < permute(b);
   }
-
-  // min sentinel = value which is strictly smaller that any input element
-  static T min_value() { return {0, TextRecordIndex::min(), 0, 0, false}; }
-
-  // max sentinel = value which is strictly larger that any input element
-  static T max_value() {
-    return {std::numeric_limits<TextBlockIndex>::max(), TextRecordIndex::max(),
-            std::numeric_limits<WordOrEntityIndex>::max(),
-            std::numeric_limits<Score>::max(), true};
-  }
 };
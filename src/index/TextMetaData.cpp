@@ -4,6 +4,9 @@
 
 #include "./TextMetaData.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "../global/Constants.h"
 #include "../util/ReadableNumberFact.h"
 
@@ -64,7 +67,8 @@ string TextMetaData::statistics() const {
   std::locale locWithNumberGrouping(loc, &facet);
   os.imbue(locWithNumberGrouping);
   os << "#words = " << totalElementsClassicLists
-     << ", #blocks = " << _blocks.size();
+     << ", #blocks = " << _blocks.size()
+     << ", #prefix blocks = " << _prefixBlocks.size();
   return std::move(os).str();
 }
 
@@ -74,6 +78,29 @@ void TextMetaData::addBlock(const TextBlockMetaData& md) {
   _blockUpperBoundWordIds.push_back(md._lastWordId);
 }
 
+// _____________________________________________________________________________
+const TextBlockMetaData* TextMetaData::getPrefixBlockByWordRange(
+    const uint64_t lower, const uint64_t upper) const {
+  auto range = [](const TextBlockMetaData& md) {
+    return std::pair{md._firstWordId, md._lastWordId};
+  };
+  auto it = std::ranges::lower_bound(_prefixBlocks, std::pair{lower, upper},
+                                     std::less{}, range);
+  if (it == _prefixBlocks.end() || range(*it) != std::pair{lower, upper}) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+// _____________________________________________________________________________
+void TextMetaData::setPrefixBlocks(vector<TextBlockMetaData> prefixBlocks) {
+  _prefixBlocks = std::move(prefixBlocks);
+  std::ranges::sort(_prefixBlocks, std::less{},
+                    [](const TextBlockMetaData& md) {
+                      return std::pair{md._firstWordId, md._lastWordId};
+                    });
+}
+
 // _____________________________________________________________________________
 off_t TextMetaData::getOffsetAfter() {
   return _blocks.back()._entityCl._lastByte + 1;
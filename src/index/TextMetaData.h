@@ -44,6 +44,22 @@ class ContextListMetaData {
   }
 };
 
+// Since version 3 of the text index format, each context list is split into
+// sub-blocks of `SUB_BLOCK_SIZE` postings, which are compressed independently.
+// The list starts with the number of sub-blocks and one `TextSkipEntry` per
+// sub-block, s.t. the sub-blocks that can't contain a certain text record can
+// be skipped without reading and decoding them.
+struct TextSkipEntry {
+  static constexpr size_t SUB_BLOCK_SIZE = 1024;
+  // The text record of the first posting of the sub-block.
+  uint64_t firstTextRecord_;
+  // The offsets (in 64-bit words) of the compressed sub-block in the
+  // compressed text records, words (if the list has a word list), and scores.
+  uint64_t contextOffset_;
+  uint64_t wordOffset_;
+  uint64_t scoreOffset_;
+};
+
 class TextBlockMetaData {
  public:
   TextBlockMetaData() : _firstWordId(), _lastWordId(), _cl(), _entityCl() {}
@@ -86,6 +102,19 @@ class TextMetaData {
 
   const TextBlockMetaData& getBlockById(size_t id) const { return _blocks[id]; }
 
+  //! Get the prefix block (see `_prefixBlocks`) with exactly the word range
+  //! `[lower, upper]`, or `nullptr` if there is no such block.
+  const TextBlockMetaData* getPrefixBlockByWordRange(
+      const uint64_t lower, const uint64_t upper) const;
+
+  //! Set the prefix blocks, which are sorted by their word ranges.
+  void setPrefixBlocks(vector<TextBlockMetaData> prefixBlocks);
+
+  vector<TextBlockMetaData>& prefixBlocks() { return _prefixBlocks; }
+  const vector<TextBlockMetaData>& prefixBlocks() const {
+    return _prefixBlocks;
+  }
+
   size_t getNofTextRecords() const { return _nofTextRecords; }
 
   void setNofTextRecords(size_t n) { _nofTextRecords = n; }
@@ -111,6 +140,13 @@ class TextMetaData {
   size_t _nofEntityPostings = 0;
   string _name;
   vector<TextBlockMetaData> _blocks;
+  // Additional blocks that contain exactly the postings of the words with a
+  // frequent prefix that is longer than the prefixes of the regular blocks
+  // (see `IndexImpl::createTextIndex`), s.t. a query for such a prefix doesn't
+  // have to read and filter the whole regular block. These blocks are not part
+  // of the serialization below, but are stored separately after it (since
+  // version 4 of the text index format).
+  vector<TextBlockMetaData> _prefixBlocks;
 
   // ___________________________________________________________________________
   AD_SERIALIZE_FRIEND_FUNCTION(TextMetaData) {
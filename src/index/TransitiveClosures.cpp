@@ -0,0 +1,123 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/TransitiveClosures.h"
+
+#include <algorithm>
+
+#include "util/Exception.h"
+#include "util/HashSet.h"
+#include "util/Serializer/FileSerializer.h"
+
+namespace {
+using Direction = TransitiveClosure::Direction;
+
+// Create a `Direction` from the `edges`, which are sorted and unique.
+Direction fromSortedEdges(const std::vector<std::pair<Id, Id>>& edges) {
+  Direction result;
+  result.reachable_.reserve(edges.size());
+  for (const auto& [node, reachable] : edges) {
+    if (result.nodes_.empty() || result.nodes_.back() != node) {
+      if (!result.nodes_.empty()) {
+        result.offsets_.push_back(result.reachable_.size());
+      }
+      result.nodes_.push_back(node);
+    }
+    result.reachable_.push_back(reachable);
+  }
+  if (!result.nodes_.empty()) {
+    result.offsets_.push_back(result.reachable_.size());
+  }
+  return result;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+std::span<const Id> TransitiveClosure::Direction::reachableFrom(
+    Id node) const {
+  auto it = std::ranges::lower_bound(nodes_, node);
+  if (it == nodes_.end() || *it != node) {
+    return {};
+  }
+  size_t i = it - nodes_.begin();
+  return {reachable_.begin() + offsets_[i],
+          reachable_.begin() + offsets_[i + 1]};
+}
+
+// _____________________________________________________________________________
+TransitiveClosure TransitiveClosure::compute(std::span<const Id> subjects,
+                                             std::span<const Id> objects) {
+  AD_CONTRACT_CHECK(subjects.size() == objects.size());
+  std::vector<std::pair<Id, Id>> edges;
+  edges.reserve(subjects.size());
+  for (size_t i = 0; i < subjects.size(); ++i) {
+    edges.emplace_back(subjects[i], objects[i]);
+  }
+  std::ranges::sort(edges);
+  auto [eraseBegin, eraseEnd] = std::ranges::unique(edges);
+  edges.erase(eraseBegin, eraseEnd);
+  Direction graph = fromSortedEdges(edges);
+
+  // A breadth-first search from each node with outgoing edges.
+  std::vector<std::pair<Id, Id>> closure;
+  ad_utility::HashSet<Id> visited;
+  std::vector<Id> frontier;
+  std::vector<Id> nextFrontier;
+  std::vector<Id> reachable;
+  for (Id start : graph.nodes_) {
+    visited.clear();
+    reachable.clear();
+    frontier.assign(1, start);
+    while (!frontier.empty()) {
+      nextFrontier.clear();
+      for (Id node : frontier) {
+        for (Id child : graph.reachableFrom(node)) {
+          if (visited.insert(child).second) {
+            reachable.push_back(child);
+            nextFrontier.push_back(child);
+          }
+        }
+      }
+      std::swap(frontier, nextFrontier);
+    }
+    std::ranges::sort(reachable);
+    for (Id node : reachable) {
+      closure.emplace_back(start, node);
+    }
+  }
+
+  TransitiveClosure result;
+  result.forward_ = fromSortedEdges(closure);
+  for (auto& [start, node] : closure) {
+    std::swap(start, node);
+  }
+  std::ranges::sort(closure);
+  result.backward_ = fromSortedEdges(closure);
+  return result;
+}
+
+// _____________________________________________________________________________
+void TransitiveClosures::add(Id predicate, TransitiveClosure closure) {
+  closures_[predicate] = std::move(closure);
+}
+
+// _____________________________________________________________________________
+const TransitiveClosure* TransitiveClosures::get(Id predicate) const {
+  auto it = closures_.find(predicate);
+  return it == closures_.end() ? nullptr : &it->second;
+}
+
+// _____________________________________________________________________________
+void TransitiveClosures::writeToFile(const std::string& filename) const {
+  ad_utility::serialization::FileWriteSerializer serializer{filename};
+  serializer << closures_;
+}
+
+// _____________________________________________________________________________
+TransitiveClosures TransitiveClosures::readFromFile(
+    const std::string& filename) {
+  ad_utility::serialization::FileReadSerializer serializer{filename};
+  TransitiveClosures result;
+  serializer >> result.closures_;
+  return result;
+}
@@ -0,0 +1,88 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/HashMap.h"
+#include "util/Serializer/SerializeHashMap.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+// The transitive closure of the triples of a single predicate `<p>`, i.e. all
+// the pairs `(x, y)` s.t. `y` can be reached from `x` via a path of length at
+// least one in the graph of the triples `x <p> y`. It is precomputed during the
+// index build for the predicates in the `transitive-closure-predicates` of the
+// settings JSON, s.t. the property paths `<p>+` and `<p>*` need no graph
+// search at query time (see `TransitivePath`).
+class TransitiveClosure {
+ public:
+  // The closure in one direction in compressed sparse row format: The nodes
+  // that are reachable from `nodes_[i]` are `reachable_[offsets_[i]]` to
+  // `reachable_[offsets_[i + 1] - 1]` (sorted). The `nodes_` are sorted and
+  // only contain the nodes from which at least one node is reachable.
+  struct Direction {
+    std::vector<Id> nodes_;
+    std::vector<uint64_t> offsets_{0};
+    std::vector<Id> reachable_;
+
+    // The nodes that are reachable from the `node`.
+    std::span<const Id> reachableFrom(Id node) const;
+    // The number of pairs in the closure.
+    size_t numPairs() const { return reachable_.size(); }
+
+    AD_SERIALIZE_FRIEND_FUNCTION(Direction) {
+      serializer | arg.nodes_;
+      serializer | arg.offsets_;
+      serializer | arg.reachable_;
+    }
+  };
+
+  // The closure of the triples `x <p> y` (the subject is the start of the
+  // paths) and of the triples `y <p> x` (the object is the start).
+  Direction forward_;
+  Direction backward_;
+
+  // Compute the closure of the edges `subjects[i] -> objects[i]`.
+  static TransitiveClosure compute(std::span<const Id> subjects,
+                                   std::span<const Id> objects);
+
+  AD_SERIALIZE_FRIEND_FUNCTION(TransitiveClosure) {
+    serializer | arg.forward_;
+    serializer | arg.backward_;
+  }
+};
+
+// The precomputed transitive closures of an index, one for each of the
+// predicates that were specified for the index build.
+class TransitiveClosures {
+ public:
+  // The closures are written to the file with this suffix.
+  static constexpr std::string_view FILE_SUFFIX = ".index.transitive-closures";
+
+ private:
+  ad_utility::HashMap<Id, TransitiveClosure> closures_;
+
+ public:
+  void add(Id predicate, TransitiveClosure closure);
+
+  // Return the closure of the `predicate` or `nullptr` if it was not
+  // precomputed.
+  const TransitiveClosure* get(Id predicate) const;
+
+  // The number of predicates with a closure.
+  size_t size() const { return closures_.size(); }
+  bool empty() const { return closures_.empty(); }
+
+  // Write the closures to the `filename`.
+  void writeToFile(const std::string& filename) const;
+
+  // Read the closures that were written by `writeToFile` from the `filename`.
+  static TransitiveClosures readFromFile(const std::string& filename);
+};
@@ -0,0 +1,147 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/TrigramIndex.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+#include "util/Exception.h"
+#include "util/Serializer/FileSerializer.h"
+
+namespace {
+// Convert the ASCII letters to lowercase, all other bytes are unchanged.
+unsigned char toLowerAscii(char c) {
+  auto byte = static_cast<unsigned char>(c);
+  return byte >= 'A' && byte <= 'Z' ? static_cast<unsigned char>(byte + 32)
+                                    : byte;
+}
+
+// Return the sorted and distinct trigrams of the `text`.
+std::vector<TrigramIndex::Trigram> getTrigrams(std::string_view text) {
+  std::vector<TrigramIndex::Trigram> trigrams;
+  for (size_t i = 0; i + 3 <= text.size(); ++i) {
+    trigrams.push_back(TrigramIndex::Trigram{toLowerAscii(text[i])} << 16 |
+                       TrigramIndex::Trigram{toLowerAscii(text[i + 1])} << 8 |
+                       TrigramIndex::Trigram{toLowerAscii(text[i + 2])});
+  }
+  std::ranges::sort(trigrams);
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                 trigrams.end());
+  return trigrams;
+}
+
+// Return true iff a case-insensitive match of the `trigram` is also found
+// via the lowercase trigram. This is not the case for non-ASCII characters,
+// and for `k` and `s`, which are also equal to the Kelvin sign and the long
+// s when ignoring the case.
+bool isCaseInsensitiveTrigram(TrigramIndex::Trigram trigram) {
+  for (int shift : {0, 8, 16}) {
+    auto byte = static_cast<unsigned char>(trigram >> shift);
+    if (byte >= 0x80 || byte == 'k' || byte == 's') {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void TrigramIndex::Builder::add(VocabIndex index, std::string_view content) {
+  uint64_t i = index.get();
+  AD_CONTRACT_CHECK(indexedRanges_.empty() ||
+                    indexedRanges_.back().second <= i);
+  if (!indexedRanges_.empty() && indexedRanges_.back().second == i) {
+    indexedRanges_.back().second = i + 1;
+  } else {
+    indexedRanges_.emplace_back(i, i + 1);
+  }
+  for (Trigram trigram : getTrigrams(content)) {
+    lists_[trigram].push_back(i);
+  }
+}
+
+// _____________________________________________________________________________
+TrigramIndex TrigramIndex::Builder::finish() && {
+  TrigramIndex result;
+  for (const auto& [trigram, list] : lists_) {
+    result.trigrams_.push_back(trigram);
+  }
+  std::ranges::sort(result.trigrams_);
+  result.offsets_.push_back(0);
+  for (Trigram trigram : result.trigrams_) {
+    auto& list = lists_.at(trigram);
+    result.indices_.insert(result.indices_.end(), list.begin(), list.end());
+    result.offsets_.push_back(result.indices_.size());
+    list = {};
+  }
+  result.indexedRanges_ = std::move(indexedRanges_);
+  lists_.clear();
+  return result;
+}
+
+// _____________________________________________________________________________
+std::optional<std::vector<uint64_t>> TrigramIndex::getCandidates(
+    std::string_view substring, bool ignoreCase) const {
+  auto trigrams = getTrigrams(substring);
+  if (ignoreCase) {
+    std::erase_if(trigrams, [](Trigram trigram) {
+      return !isCaseInsensitiveTrigram(trigram);
+    });
+  }
+  if (trigrams.empty()) {
+    return std::nullopt;
+  }
+  std::vector<std::span<const uint64_t>> lists;
+  for (Trigram trigram : trigrams) {
+    auto it = std::ranges::lower_bound(trigrams_, trigram);
+    if (it == trigrams_.end() || *it != trigram) {
+      return std::vector<uint64_t>{};
+    }
+    size_t i = it - trigrams_.begin();
+    lists.emplace_back(indices_.begin() + offsets_[i],
+                       indices_.begin() + offsets_[i + 1]);
+  }
+  // Intersect the lists, starting with the shortest one.
+  std::ranges::sort(lists, std::less{}, &std::span<const uint64_t>::size);
+  std::vector<uint64_t> candidates{lists.front().begin(), lists.front().end()};
+  std::vector<uint64_t> intersection;
+  for (const auto& list : lists | std::views::drop(1)) {
+    intersection.clear();
+    std::ranges::set_intersection(candidates, list,
+                                  std::back_inserter(intersection));
+    std::swap(candidates, intersection);
+  }
+  return candidates;
+}
+
+// _____________________________________________________________________________
+bool TrigramIndex::isIndexed(VocabIndex index) const {
+  auto it = std::ranges::upper_bound(
+      indexedRanges_, index.get(), std::less{},
+      &std::pair<uint64_t, uint64_t>::first);
+  return it != indexedRanges_.begin() && index.get() < std::prev(it)->second;
+}
+
+// _____________________________________________________________________________
+void TrigramIndex::writeToFile(const std::string& filename) const {
+  ad_utility::serialization::FileWriteSerializer serializer{filename};
+  serializer << trigrams_;
+  serializer << offsets_;
+  serializer << indices_;
+  serializer << indexedRanges_;
+}
+
+// _____________________________________________________________________________
+TrigramIndex TrigramIndex::readFromFile(const std::string& filename) {
+  ad_utility::serialization::FileReadSerializer serializer{filename};
+  TrigramIndex result;
+  serializer >> result.trigrams_;
+  serializer >> result.offsets_;
+  serializer >> result.indices_;
+  serializer >> result.indexedRanges_;
+  return result;
+}
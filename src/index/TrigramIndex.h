@@ -0,0 +1,87 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/HashMap.h"
+#include "util/Serializer/SerializePair.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+// An inverted index from the trigrams (three consecutive bytes) of the
+// lexical forms of the literals in the vocabulary to the sorted indices of
+// these literals. It is built during the index build if `trigram-index` is
+// set in the settings JSON. For a substring filter (`CONTAINS` or a `REGEX`
+// with a required literal), the intersection of the lists of the trigrams of
+// the substring is a small superset of the literals that contain it, s.t.
+// the strings of all other literals don't have to be looked up.
+//
+// The trigrams are computed after converting the ASCII letters to lowercase,
+// so the index can also be used for case-insensitive filters.
+class TrigramIndex {
+ public:
+  // The index is written to the file with this suffix.
+  static constexpr std::string_view FILE_SUFFIX = ".vocabulary.trigrams";
+
+  // The three bytes of a trigram.
+  using Trigram = uint32_t;
+
+  class Builder {
+   private:
+    ad_utility::HashMap<Trigram, std::vector<uint64_t>> lists_;
+    std::vector<std::pair<uint64_t, uint64_t>> indexedRanges_;
+
+   public:
+    // Add the literal with the `index`, the lexical form of which is the
+    // `content` (without the quotes). The literals have to be added in
+    // increasing order.
+    void add(VocabIndex index, std::string_view content);
+    TrigramIndex finish() &&;
+  };
+
+ private:
+  // The sorted trigrams, and the list of the `i`-th trigram is
+  // `[indices_[offsets_[i]], indices_[offsets_[i + 1]])`.
+  std::vector<Trigram> trigrams_;
+  std::vector<uint64_t> offsets_;
+  std::vector<uint64_t> indices_;
+  // The half-open ranges of the vocabulary indices that were added to the
+  // index (the literals of the vocabulary are contiguous).
+  std::vector<std::pair<uint64_t, uint64_t>> indexedRanges_;
+
+ public:
+  // Return the sorted indices of the literals that might contain the
+  // `substring`, which is a superset of those that do. If `ignoreCase` is
+  // true, this also holds for a case-insensitive comparison. Return
+  // `std::nullopt` if the `substring` has no trigram that can be used (for
+  // example because it is shorter than three bytes).
+  std::optional<std::vector<uint64_t>> getCandidates(std::string_view substring,
+                                                     bool ignoreCase) const;
+
+  // Return true iff the word with the `index` was added to the index, s.t. it
+  // is no candidate for a substring if it isn't returned by `getCandidates`.
+  bool isIndexed(VocabIndex index) const;
+
+  // The half-open ranges of the indexed vocabulary indices.
+  const std::vector<std::pair<uint64_t, uint64_t>>& indexedRanges() const {
+    return indexedRanges_;
+  }
+
+  // The number of distinct trigrams.
+  size_t size() const { return trigrams_.size(); }
+  bool empty() const { return indexedRanges_.empty(); }
+
+  // Write the index to the `filename`.
+  void writeToFile(const std::string& filename) const;
+
+  // Read the index that was written by `writeToFile` from the `filename`.
+  static TrigramIndex readFromFile(const std::string& filename);
+};
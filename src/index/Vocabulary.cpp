@@ -7,6 +7,8 @@
 
 #include <fstream>
 #include <iostream>
+#include <numeric>
+#include <ranges>
 
 #include "../parser/RdfEscaping.h"
 #include "../parser/Tokenizer.h"
@@ -14,6 +16,8 @@
 #include "../util/File.h"
 #include "../util/HashMap.h"
 #include "../util/HashSet.h"
+#include "../util/OperationStatistics.h"
+#include "../util/ParallelExecution.h"
 #include "../util/Serializer/FileSerializer.h"
 #include "../util/json.h"
 #include "./ConstantsIndexBuilding.h"
@@ -27,6 +31,7 @@ void Vocabulary<S, C, I>::readFromFile(const string& fileName,
   LOG(INFO) << "Reading vocabulary from file " << fileName << " ..."
             << std::endl;
   internalVocabulary_.close();
+  cacheId_ = VocabularyWordCache::newVocabularyId();
   ad_utility::serialization::FileReadSerializer file(fileName);
   internalVocabulary_.open(fileName);
   LOG(INFO) << "Done, number of words: " << internalVocabulary_.size()
@@ -63,6 +68,7 @@ void Vocabulary<S, C, I>::createFromSet(
     const ad_utility::HashSet<std::string>& set) {
   LOG(DEBUG) << "BEGIN Vocabulary::createFromSet" << std::endl;
   internalVocabulary_.close();
+  cacheId_ = VocabularyWordCache::newVocabularyId();
   std::vector<std::string> words(set.begin(), set.end());
   auto totalComparison = [this](const auto& a, const auto& b) {
     return getCaseComparator()(a, b, SortLevel::TOTAL);
@@ -181,6 +187,17 @@ void Vocabulary<S, C, I>::initializeInternalizedLangs(const StringRange& s) {
   }
 }
 
+// ______________________________________________________________________________
+template <class S, class C, class I>
+template <class StringRange>
+void Vocabulary<S, C, I>::initializeEncodedIriPrefixes(const StringRange& s) {
+  std::vector<std::string> prefixes;
+  for (const auto& el : s) {
+    prefixes.emplace_back(el);
+  }
+  encodedIriManager_ = EncodedIriManager{std::move(prefixes)};
+}
+
 // ___________________________________________________________________________
 template <typename S, typename C, typename I>
 std::optional<IdRange<I>> Vocabulary<S, C, I>::getIdRangeForFullTextPrefix(
@@ -235,9 +252,27 @@ AccessReturnType_t<StringType> Vocabulary<StringType, C, I>::at(
   return internalVocabulary_[idx.get()];
 }
 
+// _____________________________________________________________________________
+ad_utility::metrics::Counter& vocabularyLookupCounter(bool wordToId) {
+  static auto& wordToIdCounter = ad_utility::metrics::registry().counter(
+      "qlever_vocabulary_lookups_total", "The number of vocabulary lookups",
+      {{"kind", "word-to-id"}});
+  static auto& idToWordCounter = ad_utility::metrics::registry().counter(
+      "qlever_vocabulary_lookups_total", "The number of vocabulary lookups",
+      {{"kind", "id-to-word"}});
+  return wordToId ? wordToIdCounter : idToWordCounter;
+}
+
+// _____________________________________________________________________________
+void countVocabularyLookups(bool wordToId, size_t numLookups) {
+  vocabularyLookupCounter(wordToId).increment(numLookups);
+  ad_utility::OperationStatistics::addVocabularyLookups(numLookups);
+}
+
 // _____________________________________________________________________________
 template <typename S, typename C, typename I>
 bool Vocabulary<S, C, I>::getId(const string& word, IndexType* idx) const {
+  countVocabularyLookups(true);
   if (!shouldBeExternalized(word)) {
     // need the TOTAL level because we want the unique word.
     *idx = lower_bound(word, SortLevel::TOTAL);
@@ -251,6 +286,81 @@ bool Vocabulary<S, C, I>::getId(const string& word, IndexType* idx) const {
   return wordAndIndex._word == word;
 }
 
+// _____________________________________________________________________________
+template <typename S, typename C, typename I>
+auto Vocabulary<S, C, I>::getIds(std::span<const std::string_view> words,
+                                 size_t numThreads) const
+    -> std::vector<std::optional<IndexType>> {
+  // Smaller ranges of words are not worth the overhead of a thread.
+  static constexpr size_t minNumWordsPerThread = 1000;
+  const auto& comparator = getCaseComparator();
+  auto isLess = [&comparator](std::string_view a, std::string_view b) {
+    return comparator(a, b, SortLevel::TOTAL);
+  };
+  auto isLessThan = [this, &isLess](std::string_view word) {
+    return [this, &isLess, word](uint64_t i) {
+      return isLess(internalVocabulary_[i], word);
+    };
+  };
+
+  // Return the index of the first word in the internal vocabulary that is not
+  // less than the `word`. All the words before `start` must be less than the
+  // `word`. The distance to `start` is determined by exponentially
+  // increasing steps, followed by a binary search in the last step.
+  auto gallopingLowerBound = [this, &isLessThan](std::string_view word,
+                                                 uint64_t start) {
+    auto predicate = isLessThan(word);
+    uint64_t end = start;
+    for (uint64_t step = 1;
+         end < internalVocabulary_.size() && predicate(end); step *= 2) {
+      start = end + 1;
+      end = start + step;
+    }
+    auto range = std::views::iota(
+        start, std::min(end, uint64_t{internalVocabulary_.size()}));
+    return *std::ranges::partition_point(range, predicate);
+  };
+
+  std::vector<std::optional<IndexType>> result(words.size());
+  auto resolveRange = [&](size_t begin, size_t end) {
+    std::vector<size_t> positions(end - begin);
+    std::iota(positions.begin(), positions.end(), begin);
+    std::ranges::sort(positions, isLess, [&words](size_t i) {
+      return words[i];
+    });
+    uint64_t lowerBound = 0;
+    // The lookups of the externalized words are counted by `getId`.
+    size_t numInternalLookups = 0;
+    for (size_t position : positions) {
+      std::string_view word = words[position];
+      std::string wordAsString{word};
+      if (shouldBeExternalized(wordAsString)) {
+        if (IndexType idx; getId(wordAsString, &idx)) {
+          result[position] = idx;
+        }
+        continue;
+      }
+      ++numInternalLookups;
+      lowerBound = gallopingLowerBound(word, lowerBound);
+      if (lowerBound < internalVocabulary_.size() &&
+          internalVocabulary_[lowerBound] == word) {
+        result[position] = IndexType::make(lowerBound);
+      }
+    }
+    countVocabularyLookups(true, numInternalLookups);
+  };
+
+  size_t numTasks = std::clamp(words.size() / minNumWordsPerThread,
+                               size_t{1}, std::max(numThreads, size_t{1}));
+  auto* statistics = ad_utility::OperationStatistics::current();
+  ad_utility::runConcurrently(numTasks, [&](size_t i) {
+    ad_utility::OperationStatistics::Scope statisticsScope{statistics};
+    resolveRange(i * words.size() / numTasks,
+                 (i + 1) * words.size() / numTasks);
+  });
+  return result;
+}
+
 // ___________________________________________________________________________
 template <typename S, typename C, typename I>
 auto Vocabulary<S, C, I>::prefix_range(const string& prefix) const
@@ -327,6 +437,10 @@ template void RdfsVocabulary::initializeExternalizePrefixes<nlohmann::json>(
     const nlohmann::json& prefixes);
 template void RdfsVocabulary::initializeExternalizePrefixes<
     std::vector<std::string>>(const std::vector<std::string>& prefixes);
+template void RdfsVocabulary::initializeEncodedIriPrefixes<nlohmann::json>(
+    const nlohmann::json& prefixes);
+template void RdfsVocabulary::initializeEncodedIriPrefixes<
+    std::vector<std::string>>(const std::vector<std::string>& prefixes);
 
 template void RdfsVocabulary::printRangesForDatatypes();
 
@@ -11,6 +11,7 @@
 #include <fstream>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -22,7 +23,9 @@
 #include "../util/HashMap.h"
 #include "../util/HashSet.h"
 #include "../util/Log.h"
+#include "../util/Metrics.h"
 #include "../util/StringUtils.h"
+#include "./EncodedIriManager.h"
 #include "./CompressedString.h"
 #include "./StringSortComparator.h"
 #include "./vocabulary/CompressedVocabulary.h"
@@ -30,6 +33,7 @@
 #include "./vocabulary/UnicodeVocabulary.h"
 #include "./vocabulary/VocabularyInMemory.h"
 #include "VocabularyOnDisk.h"
+#include "VocabularyWordCache.h"
 
 using std::string;
 using std::vector;
@@ -71,6 +75,15 @@ struct Prefix {
   string fulltext_;
 };
 
+// The number of lookups in all the vocabularies (exported by the `/metrics`
+// endpoint of the server), either of the IDs of words (`wordToId`) or of the
+// words of IDs.
+ad_utility::metrics::Counter& vocabularyLookupCounter(bool wordToId);
+
+// Count `numLookups` lookups in the `vocabularyLookupCounter` and in the
+// `OperationStatistics` of the operation that is currently computed.
+void countVocabularyLookups(bool wordToId, size_t numLookups = 1);
+
 //! A vocabulary. Wraps a vector of strings
 //! and provides additional methods for retrieval.
 //! Template parameters that are supported are:
@@ -110,6 +123,7 @@ class Vocabulary {
   void clear() {
     internalVocabulary_.close();
     externalVocabulary_.close();
+    cacheId_ = VocabularyWordCache::newVocabularyId();
   }
   //! Read the vocabulary from file.
   void readFromFile(const string& fileName, const string& extLitsFileName = "");
@@ -128,7 +142,8 @@ class Vocabulary {
 
   //! Get the word with the given idx or an empty optional if the
   //! word is not in the vocabulary. Returns an lvalue because compressed or
-  //! externalized words don't allow references
+  //! externalized words don't allow references. The words are cached in the
+  //! `VocabularyWordCache`.
   template <typename U = StringType>
   [[nodiscard]] std::optional<string> indexToOptionalString(
       IndexType idx) const;
@@ -147,6 +162,16 @@ class Vocabulary {
   //! Return value signals if something was found at all.
   bool getId(const string& word, IndexType* idx) const;
 
+  //! Batched version of `getId` for many words (e.g. the strings of a large
+  //! VALUES clause). Return the index of each of the `words` (in the same
+  //! order) or `std::nullopt` for the words that are not contained. The words
+  //! are sorted according to the order of the vocabulary and then resolved in
+  //! a single pass over the vocabulary, in which each search gallops from the
+  //! result of the previous one. The `words` are split into ranges that are
+  //! sorted and resolved on at most `numThreads` threads.
+  std::vector<std::optional<IndexType>> getIds(
+      std::span<const std::string_view> words, size_t numThreads = 1) const;
+
   //! Get an Id range that matches a prefix.
   //! Return value also signals if something was found at all.
   //! CAVEAT! TODO<discovered by joka921>: This is only used for the text index,
@@ -211,6 +236,15 @@ class Vocabulary {
   template <class StringRange>
   void initializeInternalizedLangs(const StringRange& prefixes);
 
+  // Set the prefixes of the IRIs that are directly encoded into the `Id`s
+  // instead of being stored in this vocabulary (see `EncodedIriManager`).
+  template <class StringRange>
+  void initializeEncodedIriPrefixes(const StringRange& prefixes);
+
+  const EncodedIriManager& getEncodedIriManager() const {
+    return encodedIriManager_;
+  }
+
   void setLocale(const std::string& language, const std::string& country,
                  bool ignorePunctuation);
 
@@ -237,6 +271,10 @@ class Vocabulary {
   IndexType upper_bound(const string& word, const SortLevel level) const;
 
  private:
+  // Identifies the current contents of this vocabulary in the
+  // `VocabularyWordCache`.
+  size_t cacheId_ = VocabularyWordCache::newVocabularyId();
+
   // If a word starts with one of those prefixes it will be externalized
   vector<std::string> externalizedPrefixes_;
 
@@ -244,6 +282,10 @@ class Vocabulary {
   // defaults to English
   vector<std::string> internalizedLangs_{"en"};
 
+  // The IRIs with one of these prefixes followed by a number are not part of
+  // the vocabulary but encoded directly into the `Id`s.
+  EncodedIriManager encodedIriManager_;
+
   using PrefixCompressedVocabulary =
       CompressedVocabulary<VocabularyInMemory, PrefixCompressor>;
   using InternalCompressedVocabulary =
@@ -293,12 +335,21 @@ template <typename S, typename C, typename I>
 template <typename>
 std::optional<string> Vocabulary<S, C, I>::indexToOptionalString(
     IndexType idx) const {
-  if (idx.get() < internalVocabulary_.size()) {
-    return std::optional<string>(internalVocabulary_[idx.get()]);
-  } else {
+  countVocabularyLookups(false);
+  auto computeWord = [this, idx]() mutable -> std::string {
+    if (idx.get() < internalVocabulary_.size()) {
+      return std::string(internalVocabulary_[idx.get()]);
+    }
     // this word must be externalized
     idx.get() -= internalVocabulary_.size();
     AD_CONTRACT_CHECK(idx.get() < externalVocabulary_.size());
-    return externalVocabulary_[idx.get()];
+    auto word = externalVocabulary_[idx.get()];
+    AD_CORRECTNESS_CHECK(word.has_value());
+    return std::move(word.value());
+  };
+  auto& cache = getVocabularyWordCache();
+  if (!cache.isEnabled()) {
+    return computeWord();
   }
+  return cache.getOrCompute({cacheId_, idx.get()}, computeWord);
 }
@@ -110,6 +110,9 @@ class VocabularyMerger {
   // Returns the number of total Words merged and via the parameters
   // the lower and upper bound of language tagged predicates
   // Argument comparator gives the way to order strings (case-sensitive or not)
+  // It either compares two strings or two `TripleComponentWithIndex`es, the
+  // latter allows to use the precomputed `sortKey_`s of the partial
+  // vocabularies.
   // This automatically resets the inner members after finishing, to leave the
   // external interface stateless
   template <typename Comp, typename InternalVocabularyAction>
@@ -143,17 +146,24 @@ class VocabularyMerger {
 
   constexpr static auto sizeOfQueueWord = [](const QueueWord& q) {
     return ad_utility::MemorySize::bytes(sizeof(QueueWord) +
-                                         q._entry.iriOrLiteral().size());
+                                         q._entry.iriOrLiteral().size() +
+                                         q._entry.sortKey_.size());
   };
 
-  // write the queu words in the buffer to their corresponding idPairVecs.
+  // Write the queue words in the buffer to the vocabulary and the mappings
+  // from the local to the global IDs to their corresponding `idVecs_`.
   // Requires that all the QueueWords that are ever passed are ordered
-  // alphabetically (Also across multiple calls)
+  // alphabetically (also across multiple calls). The new words are identified
+  // and the global IDs are assigned concurrently for chunks of the buffer.
   template <typename InternalVocabularyAction>
   void writeQueueWordsToIdVec(
       const std::vector<QueueWord>& buffer,
       InternalVocabularyAction& internalVocabularyAction, const auto& lessThan);
 
+  // Sort each of the `idVecs_` by the local IDs, s.t. they can be read by a
+  // `PartialToGlobalIdMap`. The `idVecs_` are sorted concurrently.
+  void sortIdMapsByLocalIds();
+
   // close all associated files and MmapVectors and reset all internal variables
   void clear() {
     metaData_ = VocabularyMetaData{};
@@ -162,11 +172,12 @@ class VocabularyMerger {
     idVecs_.clear();
   }
 
-  // inner helper function for the parallel pipeline. perform the actual write
-  // to the IdPairVecs. Format of argument is <vecToWriteTo<internalId,
-  // globalId>>
-  void doActualWrite(
-      const std::vector<std::pair<size_t, std::pair<size_t, size_t>>>& buffer);
+  // Inner helper function for `writeQueueWordsToIdVec`. Write the pairs of
+  // the local ID and the global ID (`globalIds[i]`) of the `buffer[i]` to the
+  // `idVecs_` of the partial vocabularies. The `idVecs_` are written
+  // concurrently.
+  void writeIdMapsConcurrently(const std::vector<QueueWord>& buffer,
+                               const std::vector<size_t>& globalIds);
 };
 
 // ______________
@@ -177,6 +188,24 @@ void writePartialIdMapToBinaryFileForMerging(
     std::shared_ptr<const ItemMapArray> map, const string& fileName, Comp comp,
     bool doParallelSort);
 
+// The mapping from the local IDs of a partial vocabulary to the global IDs,
+// which is read directly from the memory-mapped file that was written by the
+// `VocabularyMerger` (sorted by the local IDs) instead of being loaded into a
+// hash map. If the local IDs are dense (which is always the case during the
+// index building), a lookup is a single access, else a binary search.
+class PartialToGlobalIdMap {
+ private:
+  IdPairMMapVecView pairs_;
+  bool isDense_ = false;
+
+ public:
+  explicit PartialToGlobalIdMap(const string& mmapFilename);
+
+  // Return the global ID of the `localId`, which must be contained in the
+  // mapping.
+  Id operator()(Id localId) const;
+};
+
 // _________________________________________________________________________________________
 ad_utility::HashMap<Id, Id> IdMapFromPartialIdMapFile(
     const string& mmapFilename);
@@ -207,11 +236,15 @@ void writeMappedIdsToExtVec(const auto& input,
  *
  * For each string first writes the size of the string (64 bits). Then the
  * actual string content (no trailing zero) and then the Id (sizeof(Id)
+ * and the `SortKey` of the `splitVal_`.
  *
  * @param els The input
  * @param fileName will write to this file. If it exists it will be overwritten
+ * @param writeSortKeys If false, empty sort keys are written (for partial
+ * vocabularies that are not merged in Unicode order).
  */
-void writePartialVocabularyToFile(const ItemVec& els, const string& fileName);
+void writePartialVocabularyToFile(const ItemVec& els, const string& fileName,
+                                  bool writeSortKeys = true);
 
 /**
  * @brief Take an Array of HashMaps of strings to Ids and insert all the
@@ -7,6 +7,7 @@
 #include <fstream>
 #include <future>
 #include <iostream>
+#include <numeric>
 #include <queue>
 #include <string>
 #include <unordered_set>
@@ -21,10 +22,12 @@
 #include "util/Exception.h"
 #include "util/HashMap.h"
 #include "util/Log.h"
+#include "util/ParallelExecution.h"
 #include "util/ParallelMultiwayMerge.h"
 #include "util/Serializer/ByteBufferSerializer.h"
 #include "util/Serializer/FileSerializer.h"
 #include "util/Serializer/SerializeString.h"
+#include "util/Serializer/ZstdFileSerializer.h"
 #include "util/Timer.h"
 
 // ___________________________________________________________________
@@ -38,11 +41,17 @@ VocabularyMerger::VocabularyMetaData VocabularyMerger::mergeVocabulary(
   // TODO<joka921> Change this as soon as we have Interleaved Ids via the
   // MilestoneIdManager
   auto lessThan = [&comparator](const TripleComponentWithIndex& t1,
-                                const TripleComponentWithIndex& t2) {
+                                const TripleComponentWithIndex& t2) -> bool {
     if (t1.isExternal() != t2.isExternal()) {
       return t2.isExternal();
     }
-    return comparator(t1.iriOrLiteral_, t2.iriOrLiteral_);
+    if constexpr (std::invocable<const Comparator&,
+                                 const TripleComponentWithIndex&,
+                                 const TripleComponentWithIndex&>) {
+      return comparator(t1, t2);
+    } else {
+      return comparator(t1.iriOrLiteral_, t2.iriOrLiteral_);
+    }
   };
   auto lessThanForQueue = [&lessThan](const QueueWord& p1,
                                       const QueueWord& p2) {
@@ -52,7 +61,7 @@ VocabularyMerger::VocabularyMetaData VocabularyMerger::mergeVocabulary(
   std::vector<cppcoro::generator<QueueWord>> generators;
 
   auto makeGenerator = [&](size_t fileIdx) -> cppcoro::generator<QueueWord> {
-    ad_utility::serialization::FileReadSerializer infile{
+    ad_utility::serialization::ZstdFileReadSerializer infile{
         absl::StrCat(basename, PARTIAL_VOCAB_FILE_NAME, fileIdx)};
     uint64_t numWords;
     infile >> numWords;
@@ -131,6 +140,7 @@ VocabularyMerger::VocabularyMetaData VocabularyMerger::mergeVocabulary(
   if (!sortedBuffer.empty()) {
     writeQueueWordsToIdVec(sortedBuffer, internalVocabularyAction, lessThan);
   }
+  sortIdMapsByLocalIds();
 
   auto metaData = std::move(metaData_);
   // completely reset all the inner state
@@ -144,89 +154,145 @@ void VocabularyMerger::writeQueueWordsToIdVec(
     const std::vector<QueueWord>& buffer,
     InternalVocabularyAction& internalVocabularyAction, const auto& lessThan) {
   LOG(TIMING) << "Start writing a batch of merged words\n";
+  if (buffer.empty()) {
+    return;
+  }
 
-  // smaller grained buffer for the actual inner write
-  auto bufSize = _bufferSize / 5;
-  std::future<void> writeFut;
-  std::vector<std::pair<size_t, std::pair<size_t, size_t>>> writeBuf;
-  writeBuf.reserve(bufSize);
-  // avoid duplicates
-  for (auto& top : buffer) {
-    if (!lastTripleComponent_.has_value() ||
-        top.iriOrLiteral() != lastTripleComponent_.value().iriOrLiteral()) {
-      if (lastTripleComponent_.has_value() &&
-          !lessThan(lastTripleComponent_.value(), top._entry)) {
+  // The buffer is split into chunks that are processed concurrently. The
+  // comparisons of the adjacent words (which are the expensive part for long
+  // literals) determine which words are new, and a prefix sum over the numbers
+  // of new words per chunk then yields the global IDs.
+  const size_t numChunks = std::clamp<size_t>(
+      buffer.size() / MIN_WORDS_PER_THREAD_VOCABULARY_MERGING, 1,
+      NUM_THREADS_VOCABULARY_MERGING);
+  auto chunk = [&buffer, numChunks](size_t k) {
+    return std::pair{k * buffer.size() / numChunks,
+                     (k + 1) * buffer.size() / numChunks};
+  };
+  // The previous word of `buffer[i]`, which is the last word of the previous
+  // batch for the first word of the buffer.
+  auto previous = [&](size_t i) -> const TripleComponentWithIndex* {
+    if (i > 0) {
+      return &buffer[i - 1]._entry;
+    }
+    return lastTripleComponent_.has_value() ? &lastTripleComponent_.value()
+                                            : nullptr;
+  };
+  // Note: `std::vector<bool>` cannot be written concurrently.
+  std::vector<char> isNewWord(buffer.size());
+  std::vector<size_t> numNewWords(numChunks);
+  ad_utility::runConcurrently(numChunks, [&](size_t k) {
+    auto [begin, end] = chunk(k);
+    for (size_t i = begin; i < end; ++i) {
+      const auto* prev = previous(i);
+      const auto& top = buffer[i];
+      isNewWord[i] =
+          prev == nullptr || top.iriOrLiteral() != prev->iriOrLiteral();
+      if (isNewWord[i] && prev != nullptr && !lessThan(*prev, top._entry)) {
         LOG(WARN) << "Total vocabulary order violated for "
-                  << lastTripleComponent_->iriOrLiteral() << " and "
-                  << top.iriOrLiteral() << std::endl;
-      }
-      // TODO<joka921> Once we have interleaved IDs using the MilestoneIdManager
-      // we have to compute the correct Ids here.
-      lastTripleComponent_ = TripleComponentWithIndex{
-          top.iriOrLiteral(), top.isExternal(), metaData_.numWordsTotal_};
-
-      // TODO<optimization> If we aim to further speed this up, we could
-      // order all the write requests to _outfile _externalOutfile and all the
-      // idVecs to have a more useful external access pattern.
-
-      // write the new word to the vocabulary
-      if (!lastTripleComponent_.value().isExternal()) {
-        internalVocabularyAction(lastTripleComponent_.value().iriOrLiteral());
-      } else {
-        outfileExternal_ << RdfEscaping::escapeNewlinesAndBackslashes(
-                                lastTripleComponent_.value().iriOrLiteral())
-                         << '\n';
-      }
-
-      metaData_.internalEntities_.addIfWordMatches(
-          top.iriOrLiteral(), lastTripleComponent_.value().index_);
-      metaData_.langTaggedPredicates_.addIfWordMatches(
-          top.iriOrLiteral(), lastTripleComponent_.value().index_);
-      metaData_.numWordsTotal_++;
-      if (metaData_.numWordsTotal_ % 100'000'000 == 0) {
-        LOG(INFO) << "Words merged: " << metaData_.numWordsTotal_ << std::endl;
+                  << prev->iriOrLiteral() << " and " << top.iriOrLiteral()
+                  << std::endl;
       }
+      numNewWords[k] += isNewWord[i];
     }
-    // Write pair of local and global ID to buffer.
-    writeBuf.emplace_back(
-        top._partialFileId,
-        std::pair{top.id(), lastTripleComponent_.value().index_});
-
-    if (writeBuf.size() >= bufSize) {
-      auto task = [this, buf = std::move(writeBuf)]() {
-        this->doActualWrite(buf);
-      };
-      if (writeFut.valid()) {
-        writeFut.get();
-      }
-      writeFut = std::async(task);
-      writeBuf.clear();
-      writeBuf.reserve(bufSize);
+  });
+  std::vector<size_t> firstIdOfChunk(numChunks);
+  std::exclusive_scan(numNewWords.begin(), numNewWords.end(),
+                      firstIdOfChunk.begin(), metaData_.numWordsTotal_);
+  // A word that is equal to its predecessor gets the ID of the predecessor,
+  // which for the first word of the buffer is `numWordsTotal_ - 1`, the ID of
+  // the `lastTripleComponent_`.
+  std::vector<size_t> globalIds(buffer.size());
+  ad_utility::runConcurrently(numChunks, [&](size_t k) {
+    auto [begin, end] = chunk(k);
+    size_t nextId = firstIdOfChunk[k];
+    for (size_t i = begin; i < end; ++i) {
+      nextId += isNewWord[i];
+      globalIds[i] = nextId - 1;
+    }
+  });
+
+  // The mappings from the local to the global IDs are written concurrently to
+  // the sequential output of the new words, which has to happen in order.
+  auto writeIdMapsFuture = std::async(std::launch::async, [&]() {
+    writeIdMapsConcurrently(buffer, globalIds);
+  });
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    if (!isNewWord[i]) {
+      continue;
+    }
+    // TODO<optimization> If we aim to further speed this up, we could
+    // order all the write requests to _outfile _externalOutfile and all the
+    // idVecs to have a more useful external access pattern.
+    const auto& top = buffer[i];
+    // write the new word to the vocabulary
+    if (!top.isExternal()) {
+      internalVocabularyAction(top.iriOrLiteral());
+    } else {
+      outfileExternal_ << RdfEscaping::escapeNewlinesAndBackslashes(
+                              top.iriOrLiteral())
+                       << '\n';
+    }
+    metaData_.internalEntities_.addIfWordMatches(top.iriOrLiteral(),
+                                                 globalIds[i]);
+    metaData_.langTaggedPredicates_.addIfWordMatches(top.iriOrLiteral(),
+                                                     globalIds[i]);
+    if ((globalIds[i] + 1) % 100'000'000 == 0) {
+      LOG(INFO) << "Words merged: " << globalIds[i] + 1 << std::endl;
     }
   }
+  writeIdMapsFuture.get();
 
-  if (writeFut.valid()) {
-    writeFut.get();
-  }
-
-  if (!writeBuf.empty()) {
-    doActualWrite(writeBuf);
-  }
+  // TODO<joka921> Once we have interleaved IDs using the MilestoneIdManager
+  // we have to compute the correct Ids here.
+  metaData_.numWordsTotal_ = firstIdOfChunk.back() + numNewWords.back();
+  lastTripleComponent_ = TripleComponentWithIndex{
+      buffer.back().iriOrLiteral(), buffer.back().isExternal(),
+      globalIds.back(), buffer.back()._entry.sortKey_};
 
   LOG(DEBUG) << "Finished writing batch of merged words" << std::endl;
 }
 
 // ____________________________________________________________________________________________________________
-inline void VocabularyMerger::doActualWrite(
-    const std::vector<std::pair<size_t, std::pair<size_t, size_t>>>& buffer) {
+inline void VocabularyMerger::writeIdMapsConcurrently(
+    const std::vector<QueueWord>& buffer,
+    const std::vector<size_t>& globalIds) {
   if (_noIdMapsAndIgnoreExternalVocab) {
     return;
   }
-  for (const auto& [id, value] : buffer) {
-    idVecs_[id].push_back(
-        {Id::makeFromVocabIndex(VocabIndex::make(value.first)),
-         Id::makeFromVocabIndex(VocabIndex::make(value.second))});
+  // Each thread writes the mappings of the partial vocabularies `i` with
+  // `i % numThreads == threadIdx`, so each mapping is written by a single
+  // thread and in the order of the global IDs.
+  const size_t numThreads =
+      std::min(idVecs_.size(), NUM_THREADS_VOCABULARY_MERGING);
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    for (size_t i = 0; i < buffer.size(); ++i) {
+      const auto& top = buffer[i];
+      if (top._partialFileId % numThreads != threadIdx) {
+        continue;
+      }
+      idVecs_[top._partialFileId].push_back(
+          {Id::makeFromVocabIndex(VocabIndex::make(top.id())),
+           Id::makeFromVocabIndex(VocabIndex::make(globalIds[i]))});
+    }
+  });
+}
+
+// ____________________________________________________________________________
+inline void VocabularyMerger::sortIdMapsByLocalIds() {
+  if (idVecs_.empty()) {
+    return;
   }
+  const size_t numThreads =
+      std::min(idVecs_.size(), NUM_THREADS_VOCABULARY_MERGING);
+  ad_utility::runConcurrently(numThreads, [&](size_t threadIdx) {
+    for (size_t i = threadIdx; i < idVecs_.size(); i += numThreads) {
+      std::sort(idVecs_[i].begin(), idVecs_[i].end(),
+                [](const auto& a, const auto& b) {
+                  return a.first.getBits() < b.first.getBits();
+                });
+    }
+  });
 }
 
 // ____________________________________________________________________________________________________________
@@ -279,11 +345,13 @@ inline void writeMappedIdsToExtVec(
 
 // _________________________________________________________________________________________________________
 inline void writePartialVocabularyToFile(const ItemVec& els,
-                                         const string& fileName) {
+                                         const string& fileName,
+                                         bool writeSortKeys) {
   LOG(DEBUG) << "Writing partial vocabulary to: " << fileName << "\n";
-  ad_utility::serialization::ByteBufferWriteSerializer byteBuffer;
-  byteBuffer.reserve(1'000'000'000);
-  ad_utility::serialization::FileWriteSerializer serializer{fileName};
+  // The partial vocabulary is compressed and written on a background thread
+  // while it is serialized.
+  ad_utility::serialization::ZstdFileWriteSerializer serializer{
+      fileName, UNCOMPRESSED_BLOCKSIZE_PARTIAL_VOCABULARY};
   uint64_t size = els.size();  // really make sure that this has 64bits;
   serializer << size;
   for (const auto& [word, idAndSplitVal] : els) {
@@ -291,14 +359,19 @@ inline void writePartialVocabularyToFile(const ItemVec& els,
     // we have assigned to this word, and the information, whether this word
     // belongs to the internal or external vocabulary.
     const auto& [id, splitVal] = idAndSplitVal;
-    byteBuffer << word;
-    byteBuffer << splitVal.isExternalized_;
-    byteBuffer << id;
+    serializer << word;
+    serializer << splitVal.isExternalized_;
+    serializer << id;
+    // The sort key allows the merge to compare the words without the ICU
+    // collation. It is written in the same format as a `std::basic_string`.
+    const auto& sortKey = splitVal.transformedVal_.get();
+    size_t sortKeySize = writeSortKeys ? sortKey.size() : 0;
+    serializer << sortKeySize;
+    serializer.serializeBytes(reinterpret_cast<const char*>(sortKey.data()),
+                              sortKeySize);
   }
   {
     ad_utility::TimeBlockAndLog t{"performing the actual write"};
-    serializer.serializeBytes(byteBuffer.data().data(),
-                              byteBuffer.data().size());
     serializer.close();
   }
   LOG(DEBUG) << "Done writing partial vocabulary\n";
@@ -376,6 +449,32 @@ void sortVocabVector(ItemVec* vecPtr, StringSortComparator comp,
   }
 }
 
+// _____________________________________________________________________
+inline PartialToGlobalIdMap::PartialToGlobalIdMap(const string& mmapFilename)
+    : pairs_{mmapFilename, ad_utility::AccessPattern::Random} {
+  // The local IDs are sorted and unique, so they are dense iff the first and
+  // the last one are dense.
+  auto isAt = [this](size_t idx) {
+    return pairs_[idx].first == Id::makeFromVocabIndex(VocabIndex::make(idx));
+  };
+  isDense_ = pairs_.size() == 0 || (isAt(0) && isAt(pairs_.size() - 1));
+}
+
+// _____________________________________________________________________
+inline Id PartialToGlobalIdMap::operator()(Id localId) const {
+  if (isDense_) {
+    size_t idx = localId.getVocabIndex().get();
+    AD_CORRECTNESS_CHECK(idx < pairs_.size());
+    return pairs_[idx].second;
+  }
+  auto it = std::lower_bound(pairs_.begin(), pairs_.end(), localId,
+                             [](const auto& pair, Id id) {
+                               return pair.first.getBits() < id.getBits();
+                             });
+  AD_CORRECTNESS_CHECK(it != pairs_.end() && it->first == localId);
+  return it->second;
+}
+
 // _____________________________________________________________________
 inline ad_utility::HashMap<Id, Id> IdMapFromPartialIdMapFile(
     const string& mmapFilename) {
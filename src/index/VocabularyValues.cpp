@@ -0,0 +1,119 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/VocabularyValues.h"
+
+#include <algorithm>
+#include <array>
+
+#include "absl/strings/numbers.h"
+#include "global/Constants.h"
+#include "util/Date.h"
+#include "util/Exception.h"
+#include "util/Serializer/FileSerializer.h"
+
+namespace {
+// Parse the `lexical` form of a literal with the integral XML Schema
+// `datatype`. Integers that don't fit into an `Int` become a `Double`.
+std::optional<Id> parseInteger(std::string_view lexical) {
+  int64_t integer;
+  if (absl::SimpleAtoi(lexical, &integer)) {
+    if (integer >= ValueId::IntegerType::min() &&
+        integer <= ValueId::IntegerType::max()) {
+      return Id::makeFromInt(integer);
+    }
+  }
+  double value;
+  if (absl::SimpleAtod(lexical, &value)) {
+    return Id::makeFromDouble(value);
+  }
+  return std::nullopt;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+std::optional<Id> VocabularyValues::parseLiteral(std::string_view word) {
+  auto separator = word.rfind("\"^^<");
+  if (!word.starts_with('"') || !word.ends_with('>') ||
+      separator == std::string_view::npos || separator == 0) {
+    return std::nullopt;
+  }
+  std::string_view lexical = word.substr(1, separator - 1);
+  std::string_view datatype = word.substr(separator + 4);
+  datatype.remove_suffix(1);
+
+  static const std::array<std::string_view, 13> integerTypes{
+      XSD_INT_TYPE,
+      XSD_INTEGER_TYPE,
+      XSD_LONG_TYPE,
+      XSD_SHORT_TYPE,
+      XSD_BYTE_TYPE,
+      XSD_NON_POSITIVE_INTEGER_TYPE,
+      XSD_NEGATIVE_INTEGER_TYPE,
+      XSD_NON_NEGATIVE_INTEGER_TYPE,
+      XSD_POSITIVE_INTEGER_TYPE,
+      XSD_UNSIGNED_LONG_TYPE,
+      XSD_UNSIGNED_INT_TYPE,
+      XSD_UNSIGNED_SHORT_TYPE,
+      XSD_UNSIGNED_BYTE_TYPE};
+  if (std::ranges::find(integerTypes, datatype) != integerTypes.end()) {
+    return parseInteger(lexical);
+  }
+  if (datatype == XSD_DECIMAL_TYPE || datatype == XSD_DOUBLE_TYPE ||
+      datatype == XSD_FLOAT_TYPE) {
+    double value;
+    if (absl::SimpleAtod(lexical, &value)) {
+      return Id::makeFromDouble(value);
+    }
+    return std::nullopt;
+  }
+  try {
+    if (datatype == XSD_DATETIME_TYPE) {
+      return Id::makeFromDate(DateOrLargeYear::parseXsdDatetime(lexical));
+    } else if (datatype == XSD_DATE_TYPE) {
+      return Id::makeFromDate(DateOrLargeYear::parseXsdDate(lexical));
+    } else if (datatype == XSD_GYEARMONTH_TYPE) {
+      return Id::makeFromDate(DateOrLargeYear::parseGYearMonth(lexical));
+    } else if (datatype == XSD_GYEAR_TYPE) {
+      return Id::makeFromDate(DateOrLargeYear::parseGYear(lexical));
+    }
+  } catch (const DateParseException&) {
+    return std::nullopt;
+  } catch (const DateOutOfRangeException&) {
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+// _____________________________________________________________________________
+void VocabularyValues::add(VocabIndex index, Id value) {
+  AD_CONTRACT_CHECK(indices_.empty() || indices_.back() < index.get());
+  indices_.push_back(index.get());
+  values_.push_back(value);
+}
+
+// _____________________________________________________________________________
+std::optional<Id> VocabularyValues::get(VocabIndex index) const {
+  auto it = std::ranges::lower_bound(indices_, index.get());
+  if (it == indices_.end() || *it != index.get()) {
+    return std::nullopt;
+  }
+  return values_[it - indices_.begin()];
+}
+
+// _____________________________________________________________________________
+void VocabularyValues::writeToFile(const std::string& filename) const {
+  ad_utility::serialization::FileWriteSerializer serializer{filename};
+  serializer << indices_;
+  serializer << values_;
+}
+
+// _____________________________________________________________________________
+VocabularyValues VocabularyValues::readFromFile(const std::string& filename) {
+  ad_utility::serialization::FileReadSerializer serializer{filename};
+  VocabularyValues result;
+  serializer >> result.indices_;
+  serializer >> result.values_;
+  AD_CORRECTNESS_CHECK(result.indices_.size() == result.values_.size());
+  return result;
+}
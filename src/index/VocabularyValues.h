@@ -0,0 +1,58 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+// The numeric and date values of the typed literals that are stored in the
+// vocabulary (e.g. an `xsd:decimal` that was not folded into a `Double`, an
+// `xsd:unsignedByte`, or an `xsd:dateTime` that the index builder stored as a
+// string). They are parsed once during the index build if `vocabulary-values`
+// is set in the settings JSON, s.t. the expressions (see
+// `SparqlExpressionValueGetters`) don't have to parse the strings at query
+// time.
+class VocabularyValues {
+ public:
+  // The values are written to the file with this suffix.
+  static constexpr std::string_view FILE_SUFFIX = ".vocabulary.values";
+
+ private:
+  // The vocabulary indices of the words that have a value (sorted) and their
+  // values (`Int`, `Double`, or `Date`). Most words of a vocabulary are no
+  // such literals, so only the values that exist are stored.
+  std::vector<uint64_t> indices_;
+  std::vector<Id> values_;
+
+ public:
+  // Parse a `word` of the vocabulary of the form `"lexical"^^<datatype>` with
+  // a numeric or date datatype from XML Schema. Return `std::nullopt` for all
+  // other words and for lexical forms that can't be parsed.
+  static std::optional<Id> parseLiteral(std::string_view word);
+
+  // Add the `value` of the word with the `index`. The indices have to be added
+  // in increasing order.
+  void add(VocabIndex index, Id value);
+
+  // Return the value of the word with the `index`, or `std::nullopt` if the
+  // word has no value.
+  std::optional<Id> get(VocabIndex index) const;
+
+  // The number of words with a value.
+  size_t size() const { return indices_.size(); }
+  bool empty() const { return indices_.empty(); }
+
+  // Write the values to the `filename`.
+  void writeToFile(const std::string& filename) const;
+
+  // Read the values that were written by `writeToFile` from the `filename`.
+  static VocabularyValues readFromFile(const std::string& filename);
+};
@@ -0,0 +1,63 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "index/VocabularyWordCache.h"
+
+#include "global/Constants.h"
+
+// _____________________________________________________________________________
+VocabularyWordCache::VocabularyWordCache(ad_utility::MemorySize maxSize) {
+  setMaxSize(maxSize);
+  for (auto& shard : shards_) {
+    shard.setOnEviction(
+        [this](const auto&, const auto&) { numEvictions_.increment(); });
+  }
+}
+
+// _____________________________________________________________________________
+size_t VocabularyWordCache::newVocabularyId() {
+  static std::atomic<size_t> nextId = 0;
+  return nextId++;
+}
+
+// _____________________________________________________________________________
+void VocabularyWordCache::setMaxSize(ad_utility::MemorySize maxSize) {
+  enabled_ = maxSize.getBytes() > 0;
+  auto maxSizePerShard = maxSize / NUM_SHARDS;
+  for (auto& shard : shards_) {
+    shard.setMaxSize(maxSizePerShard);
+    shard.setMaxSizeSingleEntry(maxSizePerShard);
+  }
+}
+
+// _____________________________________________________________________________
+void VocabularyWordCache::clear() {
+  for (auto& shard : shards_) {
+    shard.clearAll();
+  }
+}
+
+// _____________________________________________________________________________
+size_t VocabularyWordCache::numEntries() const {
+  size_t result = 0;
+  for (const auto& shard : shards_) {
+    result += shard.numNonPinnedEntries();
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+ad_utility::MemorySize VocabularyWordCache::size() const {
+  ad_utility::MemorySize result = ad_utility::MemorySize::bytes(0);
+  for (const auto& shard : shards_) {
+    result += shard.nonPinnedSize();
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+VocabularyWordCache& getVocabularyWordCache() {
+  static VocabularyWordCache cache{
+      RuntimeParameters().get<"vocabulary-cache-max-size">()};
+  return cache;
+}
@@ -0,0 +1,100 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/hash/hash.h"
+#include "util/Cache.h"
+#include "util/ConcurrentCache.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Metrics.h"
+
+// To be able to use words with `Caches`, we need a function for calculating
+// the memory used for them.
+struct VocabularyWordSizeGetter {
+  ad_utility::MemorySize operator()(const std::string& word) const {
+    return ad_utility::MemorySize::bytes(sizeof(std::string) + word.size());
+  }
+};
+
+// A memory-bounded LRU cache for the decoded words of the vocabularies. It
+// sits in front of both the (prefix-compressed) internal and the external
+// vocabulary on disk (see `Vocabulary::indexToOptionalString`), s.t. the words
+// that are exported often (for example the labels of popular entities) are
+// only decompressed or read from disk once. Like the `DecompressedBlockCache`,
+// a single instance (see `getVocabularyWordCache()`) is shared by all the
+// vocabularies and split into `NUM_SHARDS` independently locked shards.
+class VocabularyWordCache {
+ public:
+  // A word is identified by the vocabulary to which it belongs (see
+  // `newVocabularyId()`) and its index in that vocabulary.
+  using Key = std::pair<size_t, uint64_t>;
+  static constexpr size_t NUM_SHARDS = 16;
+
+ private:
+  using Shard = ad_utility::ConcurrentCache<ad_utility::HeapBasedLRUCache<
+      Key, std::string, VocabularyWordSizeGetter>>;
+  std::array<Shard, NUM_SHARDS> shards_;
+  std::atomic<bool> enabled_ = true;
+  // Sharded counters (see `ad_utility::metrics::Counter`), because they are
+  // updated by all the threads that use the cache.
+  ad_utility::metrics::Counter numHits_;
+  ad_utility::metrics::Counter numMisses_;
+  ad_utility::metrics::Counter numEvictions_;
+
+ public:
+  // Create a cache that stores at most `maxSize` of words.
+  explicit VocabularyWordCache(ad_utility::MemorySize maxSize);
+
+  // Return a new id for a vocabulary. A vocabulary has to get a new id
+  // whenever its words change, s.t. the cached words of its previous contents
+  // are never returned.
+  static size_t newVocabularyId();
+
+  // Return the cached word for the `key`. If it is not contained, it is
+  // computed via `computeWord()` and inserted into the cache. If the cache is
+  // disabled because its size is zero, the word is always computed.
+  template <typename ComputeFunction>
+  std::string getOrCompute(const Key& key, ComputeFunction computeWord) {
+    if (!enabled_) {
+      return computeWord();
+    }
+    auto [word, status] = getShard(key).computeOnce(key, computeWord);
+    if (status == ad_utility::CacheStatus::computed) {
+      numMisses_.increment();
+    } else {
+      numHits_.increment();
+    }
+    return *word;
+  }
+
+  bool isEnabled() const { return enabled_; }
+
+  // Change the maximal size of the cache. A size of zero disables the cache.
+  void setMaxSize(ad_utility::MemorySize maxSize);
+
+  // Remove all entries from the cache. The hit and miss counters are kept.
+  void clear();
+
+  // Statistics for `cmd=stats` and `/metrics`.
+  size_t numHits() const { return numHits_.value(); }
+  size_t numMisses() const { return numMisses_.value(); }
+  size_t numEvictions() const { return numEvictions_.value(); }
+  size_t numEntries() const;
+  ad_utility::MemorySize size() const;
+
+ private:
+  Shard& getShard(const Key& key) {
+    return shards_[absl::Hash<Key>{}(key) % NUM_SHARDS];
+  }
+};
+
+// Return the cache that is shared by all the vocabularies. Its size is
+// initially set from the runtime parameter `vocabulary-cache-max-size`.
+VocabularyWordCache& getVocabularyWordCache();
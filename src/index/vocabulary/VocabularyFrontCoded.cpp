@@ -0,0 +1,172 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "index/vocabulary/VocabularyFrontCoded.h"
+
+#include "absl/strings/str_cat.h"
+#include "util/ExceptionHandling.h"
+#include "util/Serializer/FileSerializer.h"
+#include "util/Serializer/SerializeVector.h"
+
+namespace {
+// Append `value` to the `target` as a variable-length integer, 7 bits per
+// byte with the highest bit signalling that more bytes follow.
+void appendVarint(std::string& target, uint64_t value) {
+  while (value >= 0x80) {
+    target.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  target.push_back(static_cast<char>(value));
+}
+
+// Read a variable-length integer that was written by `appendVarint` from the
+// `source`, starting at `position`, and advance the `position`.
+uint64_t readVarint(std::string_view source, size_t& position) {
+  uint64_t result = 0;
+  for (size_t shift = 0;; shift += 7) {
+    AD_CORRECTNESS_CHECK(position < source.size());
+    auto byte = static_cast<uint8_t>(source[position++]);
+    result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return result;
+    }
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void VocabularyFrontCoded::buildFromVector(
+    const std::vector<std::string>& words, const std::string& fileName,
+    size_t numWordsPerBlock) {
+  {
+    WordWriter writer{fileName, numWordsPerBlock};
+    for (const auto& word : words) {
+      writer.push(word);
+    }
+    writer.finish();
+  }
+  open(fileName);
+}
+
+// _____________________________________________________________________________
+void VocabularyFrontCoded::open(const std::string& fileName) {
+  {
+    ad_utility::serialization::FileReadSerializer serializer{
+        absl::StrCat(fileName, blockIndexSuffix_)};
+    serializer >> numWordsPerBlock_;
+    serializer >> size_;
+    serializer >> firstWords_;
+    serializer >> blockOffsets_;
+  }
+  AD_CORRECTNESS_CHECK(numWordsPerBlock_ > 0);
+  AD_CORRECTNESS_CHECK(blockOffsets_.size() == firstWords_.size() + 1);
+  file_.open(fileName, "r");
+}
+
+// _____________________________________________________________________________
+void VocabularyFrontCoded::close() {
+  file_.close();
+  firstWords_ = {};
+  blockOffsets_.clear();
+  size_ = 0;
+}
+
+// _____________________________________________________________________________
+std::string VocabularyFrontCoded::operator[](uint64_t i) const {
+  AD_CONTRACT_CHECK(i < size());
+  size_t block = i / numWordsPerBlock_;
+  size_t indexInBlock = i % numWordsPerBlock_;
+  // The first word of each block is stored in RAM.
+  if (indexInBlock == 0) {
+    return std::string{firstWords_[block]};
+  }
+  return std::move(readBlock(block)[indexInBlock]);
+}
+
+// _____________________________________________________________________________
+std::vector<std::string> VocabularyFrontCoded::readBlock(size_t block) const {
+  AD_CORRECTNESS_CHECK(block < firstWords_.size());
+  std::string buffer;
+  buffer.resize(blockOffsets_[block + 1] - blockOffsets_[block]);
+  auto numBytesRead =
+      file_.read(buffer.data(), buffer.size(), blockOffsets_[block]);
+  AD_CORRECTNESS_CHECK(static_cast<size_t>(numBytesRead) == buffer.size());
+
+  size_t numWords =
+      std::min(numWordsPerBlock_, size() - block * numWordsPerBlock_);
+  std::vector<std::string> words;
+  words.reserve(numWords);
+  words.emplace_back(firstWords_[block]);
+  size_t position = 0;
+  for (size_t i = 1; i < numWords; ++i) {
+    auto prefixLength = readVarint(buffer, position);
+    auto suffixLength = readVarint(buffer, position);
+    AD_CORRECTNESS_CHECK(prefixLength <= words.back().size());
+    AD_CORRECTNESS_CHECK(position + suffixLength <= buffer.size());
+    std::string word = words.back().substr(0, prefixLength);
+    word.append(buffer, position, suffixLength);
+    position += suffixLength;
+    words.push_back(std::move(word));
+  }
+  AD_CORRECTNESS_CHECK(position == buffer.size());
+  return words;
+}
+
+// _____________________________________________________________________________
+VocabularyFrontCoded::WordWriter::WordWriter(const std::string& fileName,
+                                             size_t numWordsPerBlock)
+    : file_{fileName, "w"},
+      fileName_{fileName},
+      numWordsPerBlock_{numWordsPerBlock} {
+  AD_CONTRACT_CHECK(numWordsPerBlock_ > 0);
+}
+
+// _____________________________________________________________________________
+void VocabularyFrontCoded::WordWriter::push(std::string_view word) {
+  AD_CONTRACT_CHECK(!finished_);
+  if (numWords_ % numWordsPerBlock_ == 0) {
+    writeCurrentBlock();
+    blockOffsets_.push_back(currentOffset_);
+    firstWords_.emplace_back(word);
+  } else {
+    auto prefixLength = static_cast<size_t>(
+        std::ranges::mismatch(word, previousWord_).in1 - word.begin());
+    appendVarint(currentBlock_, prefixLength);
+    appendVarint(currentBlock_, word.size() - prefixLength);
+    currentBlock_.append(word.substr(prefixLength));
+  }
+  previousWord_ = word;
+  ++numWords_;
+}
+
+// _____________________________________________________________________________
+void VocabularyFrontCoded::WordWriter::writeCurrentBlock() {
+  file_.write(currentBlock_.data(), currentBlock_.size());
+  currentOffset_ += currentBlock_.size();
+  currentBlock_.clear();
+}
+
+// _____________________________________________________________________________
+void VocabularyFrontCoded::WordWriter::finish() {
+  if (std::exchange(finished_, true)) {
+    return;
+  }
+  writeCurrentBlock();
+  blockOffsets_.push_back(currentOffset_);
+  file_.close();
+  ad_utility::serialization::FileWriteSerializer serializer{
+      absl::StrCat(fileName_, blockIndexSuffix_)};
+  serializer << numWordsPerBlock_;
+  serializer << numWords_;
+  CompactVectorOfStrings<char> firstWords;
+  firstWords.build(firstWords_);
+  serializer << firstWords;
+  serializer << blockOffsets_;
+}
+
+// _____________________________________________________________________________
+VocabularyFrontCoded::WordWriter::~WordWriter() {
+  ad_utility::terminateIfThrows(
+      [this]() { finish(); },
+      "Calling `finish` from the destructor of `VocabularyFrontCoded`");
+}
@@ -0,0 +1,170 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "global/Pattern.h"
+#include "index/vocabulary/VocabularyTypes.h"
+#include "util/Exception.h"
+#include "util/File.h"
+
+//! A vocabulary on disk, in which the words are front-coded in blocks of (by
+//! default) `DEFAULT_NUM_WORDS_PER_BLOCK` consecutive words: each word of a
+//! block except the first one is stored as the length of the prefix that it
+//! shares with its predecessor and the remaining suffix. Sorted vocabularies
+//! thus become much smaller, because adjacent words share long prefixes (for
+//! example the IRIs with the same namespace).
+//!
+//! Only the first word and the offset of each block are kept in RAM. This
+//! makes each lookup via `operator[]` cost a single read of one block, and
+//! `lower_bound` and `upper_bound` first binary-search the first words of the
+//! blocks in RAM and then read and scan a single block.
+class VocabularyFrontCoded {
+ public:
+  static constexpr size_t DEFAULT_NUM_WORDS_PER_BLOCK = 32;
+
+ private:
+  // The file with the front-coded blocks (without their first words).
+  mutable ad_utility::File file_;
+  // The first word of each block.
+  CompactVectorOfStrings<char> firstWords_;
+  // The offset of each block in the `file_`, followed by the size of the file.
+  std::vector<uint64_t> blockOffsets_;
+  size_t numWordsPerBlock_ = DEFAULT_NUM_WORDS_PER_BLOCK;
+  size_t size_ = 0;
+
+  // This suffix is appended to the filename of the blocks, in order to get the
+  // name of the file in which the data that is kept in RAM is stored.
+  static constexpr std::string_view blockIndexSuffix_ = ".blockIndex";
+
+ public:
+  /// Default constructor for an empty vocabulary.
+  VocabularyFrontCoded() = default;
+
+  /// `VocabularyFrontCoded` is movable, but not copyable.
+  VocabularyFrontCoded(VocabularyFrontCoded&&) noexcept = default;
+  VocabularyFrontCoded& operator=(VocabularyFrontCoded&&) noexcept = default;
+
+  /// Write the `words` to the file with the given name and open the
+  /// vocabulary from there. The words get the contiguous IDs
+  /// [0 .. #numWords).
+  void buildFromVector(
+      const std::vector<std::string>& words, const std::string& fileName,
+      size_t numWordsPerBlock = DEFAULT_NUM_WORDS_PER_BLOCK);
+
+  /// Open the vocabulary from file. It must have been previously written to
+  /// this file via `buildFromVector` or a `WordWriter`.
+  void open(const std::string& fileName);
+
+  /// Close the underlying file and uninitialize this vocabulary for further
+  /// use.
+  void close();
+
+  /// Return the total number of words.
+  [[nodiscard]] size_t size() const { return size_; }
+
+  /// Return the highest ID (= index) that occurs in this vocabulary. May only
+  /// be called if size() > 0.
+  [[nodiscard]] uint64_t getHighestId() const {
+    AD_CONTRACT_CHECK(size() > 0);
+    return size() - 1;
+  }
+
+  /// Return the `i-th` word. Requires that `i < size()`.
+  std::string operator[](uint64_t i) const;
+
+  /// Return a `WordAndIndex` that points to the first entry that is equal or
+  /// greater than `word` wrt. to the `comparator`. Only works correctly if the
+  /// words are sorted according to the comparator (exactly like in
+  /// `std::lower_bound`).
+  template <typename InternalStringType, typename Comparator>
+  WordAndIndex lower_bound(const InternalStringType& word,
+                           Comparator comparator) const {
+    // The first block of which the first word is not smaller than the `word`.
+    size_t block =
+        std::partition_point(firstWords_.begin(), firstWords_.end(),
+                             [&](std::string_view firstWord) {
+                               return comparator(firstWord, word);
+                             }) -
+        firstWords_.begin();
+    return boundInPreviousBlock(block, [&](std::string_view vocabWord) {
+      return !comparator(vocabWord, word);
+    });
+  }
+
+  /// Return a `WordAndIndex` that points to the first entry that is greater
+  /// than `word` wrt. to the `comparator`. Only works correctly if the words
+  /// are sorted according to the comparator (exactly like in
+  /// `std::upper_bound`).
+  template <typename InternalStringType, typename Comparator>
+  WordAndIndex upper_bound(const InternalStringType& word,
+                           Comparator comparator) const {
+    // The first block of which the first word is greater than the `word`.
+    size_t block =
+        std::partition_point(firstWords_.begin(), firstWords_.end(),
+                             [&](std::string_view firstWord) {
+                               return !comparator(word, firstWord);
+                             }) -
+        firstWords_.begin();
+    return boundInPreviousBlock(block, [&](std::string_view vocabWord) {
+      return comparator(word, vocabWord);
+    });
+  }
+
+  /// Write a `VocabularyFrontCoded` word by word, without materializing it in
+  /// RAM. The words get the IDs [0 .. #numWords) in the order of the calls to
+  /// `push`. `finish` has to be called at the end (otherwise the destructor
+  /// calls it).
+  class WordWriter {
+   private:
+    ad_utility::File file_;
+    std::string fileName_;
+    size_t numWordsPerBlock_;
+    std::vector<std::string> firstWords_;
+    std::vector<uint64_t> blockOffsets_;
+    std::string currentBlock_;
+    std::string previousWord_;
+    size_t numWords_ = 0;
+    uint64_t currentOffset_ = 0;
+    bool finished_ = false;
+
+   public:
+    explicit WordWriter(
+        const std::string& fileName,
+        size_t numWordsPerBlock = DEFAULT_NUM_WORDS_PER_BLOCK);
+    void push(std::string_view word);
+    void finish();
+    ~WordWriter();
+
+   private:
+    void writeCurrentBlock();
+  };
+
+ private:
+  // Read and decode the `block`. The first word of the block is included.
+  std::vector<std::string> readBlock(size_t block) const;
+
+  // Return the first word in the block before the `block` (excluding its first
+  // word, which is known to not fulfill the `predicate`) that fulfills the
+  // `predicate`. If there is no such word, return the first word of the
+  // `block` (or the end of the vocabulary if `block` is the last block).
+  WordAndIndex boundInPreviousBlock(size_t block, auto predicate) const {
+    if (block > 0) {
+      auto words = readBlock(block - 1);
+      for (size_t i = 1; i < words.size(); ++i) {
+        if (predicate(words[i])) {
+          return {std::move(words[i]), (block - 1) * numWordsPerBlock_ + i};
+        }
+      }
+    }
+    if (block == firstWords_.size()) {
+      return {std::nullopt, size()};
+    }
+    return {std::string{firstWords_[block]}, block * numWordsPerBlock_};
+  }
+};
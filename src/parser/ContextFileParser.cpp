@@ -4,9 +4,11 @@
 
 #include "./ContextFileParser.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "../util/Exception.h"
+#include "../util/ParallelExecution.h"
 #include "../util/StringUtils.h"
 
 // _____________________________________________________________________________
@@ -17,30 +19,92 @@ ContextFileParser::ContextFileParser(const string& contextFile,
 // _____________________________________________________________________________
 ContextFileParser::~ContextFileParser() { _in.close(); }
 
+namespace {
+// The (unparsed) context ID of a `line` of a context file.
+std::string_view contextIdOfLine(std::string_view line) {
+  size_t i = line.find('\t');
+  assert(i != string::npos);
+  size_t j = i + 2;
+  size_t k = line.find('\t', j + 2);
+  assert(k != string::npos);
+  return line.substr(j + 1, k - j - 1);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+ContextFileParser::Line ContextFileParser::parseLine(
+    std::string_view l, const LocaleManager& localeManager) {
+  Line line;
+  size_t i = l.find('\t');
+  assert(i != string::npos);
+  size_t j = i + 2;
+  assert(j + 3 < l.size());
+  size_t k = l.find('\t', j + 2);
+  assert(k != string::npos);
+  line._isEntity = (l[i + 1] == '1');
+  auto word = l.substr(0, i);
+  line._word = line._isEntity ? string{word}
+                              : localeManager.getLowercaseUtf8(word);
+  line._contextId = TextRecordIndex::make(
+      atol(string{l.substr(j + 1, k - j - 1)}.c_str()));
+  line._score = static_cast<Score>(atol(string{l.substr(k + 1)}.c_str()));
+  return line;
+}
+
+// _____________________________________________________________________________
+void ContextFileParser::checkSorted(
+    [[maybe_unused]] TextRecordIndex contextId) {
+#ifndef NDEBUG
+  if (_lastCId > contextId) {
+    AD_THROW("ContextFile has to be sorted by context Id.");
+  }
+  _lastCId = contextId;
+#endif
+}
+
 // _____________________________________________________________________________
 bool ContextFileParser::getLine(ContextFileParser::Line& line) {
   string l;
-  if (std::getline(_in, l)) {
-    size_t i = l.find('\t');
-    assert(i != string::npos);
-    size_t j = i + 2;
-    assert(j + 3 < l.size());
-    size_t k = l.find('\t', j + 2);
-    assert(k != string::npos);
-    line._isEntity = (l[i + 1] == '1');
-    line._word =
-        (line._isEntity ? l.substr(0, i)
-                        : _localeManager.getLowercaseUtf8(l.substr(0, i)));
-    line._contextId =
-        TextRecordIndex::make(atol(l.substr(j + 1, k - j - 1).c_str()));
-    line._score = static_cast<Score>(atol(l.substr(k + 1).c_str()));
-#ifndef NDEBUG
-    if (_lastCId > line._contextId) {
-      AD_THROW("ContextFile has to be sorted by context Id.");
+  if (_nextLine.has_value()) {
+    l = std::move(_nextLine.value());
+    _nextLine.reset();
+  } else if (!std::getline(_in, l)) {
+    return false;
+  }
+  line = parseLine(l, _localeManager);
+  checkSorted(line._contextId);
+  return true;
+}
+
+// _____________________________________________________________________________
+std::vector<ContextFileParser::Line> ContextFileParser::getBatch(
+    size_t minNumLines, size_t numThreads) {
+  std::vector<string> rawLines;
+  if (_nextLine.has_value()) {
+    rawLines.push_back(std::move(_nextLine.value()));
+    _nextLine.reset();
+  }
+  string l;
+  while (std::getline(_in, l)) {
+    if (rawLines.size() >= minNumLines &&
+        contextIdOfLine(l) != contextIdOfLine(rawLines.back())) {
+      _nextLine = std::move(l);
+      break;
     }
-    _lastCId = line._contextId;
-#endif
-    return true;
+    rawLines.push_back(std::move(l));
+  }
+
+  std::vector<Line> lines(rawLines.size());
+  numThreads = std::clamp(numThreads, size_t{1},
+                          std::max(rawLines.size(), size_t{1}));
+  ad_utility::runConcurrently(numThreads, [&](size_t t) {
+    size_t end = rawLines.size() * (t + 1) / numThreads;
+    for (size_t i = rawLines.size() * t / numThreads; i < end; ++i) {
+      lines[i] = parseLine(rawLines[i], _localeManager);
+    }
+  });
+  for (const auto& line : lines) {
+    checkSorted(line._contextId);
   }
-  return false;
+  return lines;
 }
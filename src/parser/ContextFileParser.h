@@ -7,7 +7,10 @@
 #include <unicode/locid.h>
 
 #include <fstream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "../global/Id.h"
 #include "../index/StringSortComparator.h"
@@ -34,8 +37,24 @@ class ContextFileParser {
   // Returns true if something was stored.
   bool getLine(Line&);
 
+  // Get the next (at least `minNumLines`, unless the file ends) lines from the
+  // file, s.t. the lines of a context are never split between two batches.
+  // The lines are parsed concurrently on `numThreads` threads. Returns an
+  // empty vector if there are no more lines.
+  std::vector<Line> getBatch(size_t minNumLines, size_t numThreads);
+
+  // Parse a single `line` of a context file.
+  static Line parseLine(std::string_view line,
+                        const LocaleManager& localeManager);
+
  private:
+  // Check that the context IDs are sorted (only in debug builds).
+  void checkSorted(TextRecordIndex contextId);
+
   std::ifstream _in;
+  // The first line of the next batch, which was already read to find the end
+  // of the previous batch.
+  std::optional<string> _nextLine;
 #ifndef NDEBUG
   // Only used for sanity checks in debug builds
   TextRecordIndex _lastCId = TextRecordIndex::make(0);
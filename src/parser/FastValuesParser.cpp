@@ -0,0 +1,397 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "parser/FastValuesParser.h"
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/match.h>
+#include <absl/strings/str_cat.h>
+
+#include <charconv>
+#include <optional>
+
+#include "global/Constants.h"
+#include "parser/RdfEscaping.h"
+#include "parser/Tokenizer.h"
+#include "parser/TurtleParser.h"
+
+namespace {
+using Rows = FastValuesParser::Rows;
+
+// Return true iff the `c` can be part of a variable name, a keyword, or a
+// prefixed name (the non-ASCII characters are not checked precisely).
+bool isNameChar(char c) {
+  return absl::ascii_isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+         c == '-' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+// Return true iff the `input` starts with the `keyword` (case-insensitive),
+// which is not directly followed by another character of a name.
+bool startsWithKeyword(std::string_view input, std::string_view keyword) {
+  return input.size() >= keyword.size() &&
+         absl::EqualsIgnoreCase(input.substr(0, keyword.size()), keyword) &&
+         (input.size() == keyword.size() ||
+          !(isNameChar(input[keyword.size()]) || input[keyword.size()] == ':'));
+}
+
+// If the `input` starts with an IRIREF, return its size.
+std::optional<size_t> sizeOfIriref(std::string_view input) {
+  if (!input.starts_with('<')) {
+    return std::nullopt;
+  }
+  static constexpr std::string_view forbidden = "<>\"{}|^`\\";
+  size_t end = 1;
+  while (end < input.size() && static_cast<unsigned char>(input[end]) > 0x20 &&
+         forbidden.find(input[end]) == std::string_view::npos) {
+    ++end;
+  }
+  if (end < input.size() && input[end] == '>') {
+    return end + 1;
+  }
+  return std::nullopt;
+}
+
+// Return the size of the string literal (including its possibly triple
+// quotes) at the beginning of the `input`.
+size_t sizeOfStringLiteral(std::string_view input) {
+  char c = input.at(0);
+  AD_CORRECTNESS_CHECK(c == '"' || c == '\'');
+  std::string_view quotes = input.substr(0, 3) == std::string(3, c)
+                                ? input.substr(0, 3)
+                                : input.substr(0, 1);
+  size_t end = quotes.size();
+  while (end < input.size() && !input.substr(end).starts_with(quotes)) {
+    end += input[end] == '\\' ? 2 : 1;
+  }
+  return std::min(end + quotes.size(), input.size());
+}
+
+// Return the number of leading whitespace characters and comments of the
+// `input`.
+size_t sizeOfWhitespaceAndComments(std::string_view input) {
+  size_t i = 0;
+  while (i < input.size()) {
+    if (absl::ascii_isspace(static_cast<unsigned char>(input[i]))) {
+      ++i;
+    } else if (input[i] == '#') {
+      i = std::min(input.find('\n', i), input.size());
+    } else {
+      break;
+    }
+  }
+  return i;
+}
+
+// The parser for the values of a single data block. It reuses the parsing of
+// IRIs and literals from the `TurtleParser`.
+class DataBlockParser : public TurtleStringParser<Tokenizer> {
+ public:
+  // The `prefixes` map the prefix names to the IRIs without angle brackets.
+  explicit DataBlockParser(
+      ad_utility::HashMap<std::string, std::string> prefixes) {
+    prefixMap_ = std::move(prefixes);
+  }
+
+  // Parse the data block (which starts with the opening `{`) at the beginning
+  // of the `input`. If `hasParentheses` is true, each row is enclosed in
+  // parentheses and must have `numVariables` entries. Return the rows and the
+  // size of the data block, or `std::nullopt` if the data block cannot be
+  // parsed.
+  std::optional<std::pair<Rows, size_t>> parse(std::string_view input,
+                                               size_t numVariables,
+                                               bool hasParentheses) {
+    AD_CONTRACT_CHECK(input.starts_with('{'));
+    tok_.reset(input.data() + 1, input.size() - 1);
+    Rows rows;
+    try {
+      while (true) {
+        tok_.skipWhitespaceAndComments();
+        if (skipChar('}')) {
+          break;
+        }
+        if (!hasParentheses) {
+          if (!value()) {
+            return std::nullopt;
+          }
+          rows.push_back({std::move(lastParseResult_)});
+          continue;
+        }
+        if (!skipChar('(')) {
+          return std::nullopt;
+        }
+        auto& row = rows.emplace_back();
+        row.reserve(numVariables);
+        while (true) {
+          tok_.skipWhitespaceAndComments();
+          if (skipChar(')')) {
+            break;
+          }
+          if (!value()) {
+            return std::nullopt;
+          }
+          row.push_back(std::move(lastParseResult_));
+        }
+        if (row.size() != numVariables) {
+          return std::nullopt;
+        }
+      }
+    } catch (const std::exception&) {
+      // For example an undefined prefix, the error is reported by the ANTLR
+      // parser.
+      return std::nullopt;
+    }
+    return std::pair{std::move(rows), input.size() - tok_.view().size()};
+  }
+
+ private:
+  bool skipChar(char c) {
+    if (!tok_.view().starts_with(c)) {
+      return false;
+    }
+    tok_.remove_prefix(1);
+    return true;
+  }
+
+  // Parse a `DataBlockValue` of the SPARQL grammar, the result is stored in
+  // `lastParseResult_`. The conversions are the same as in
+  // `SparqlQleverVisitor::visit(DataBlockValueContext*)`.
+  bool value() {
+    tok_.skipWhitespaceAndComments();
+    if (startsWithKeyword(tok_.view(), "UNDEF")) {
+      tok_.remove_prefix(std::string_view{"UNDEF"}.size());
+      lastParseResult_ = TripleComponent::UNDEF{};
+      return true;
+    }
+    for (bool b : {true, false}) {
+      std::string_view keyword = b ? "true" : "false";
+      if (tok_.view().starts_with(keyword) &&
+          startsWithKeyword(tok_.view(), keyword)) {
+        tok_.remove_prefix(keyword.size());
+        lastParseResult_ = b;
+        return true;
+      }
+    }
+    if (iri() || rdfLiteral()) {
+      return true;
+    }
+    try {
+      if (parseTerminal<TurtleTokenId::Double>() ||
+          parseTerminal<TurtleTokenId::Decimal>()) {
+        lastParseResult_ = std::stod(lastParseResult_.getString());
+        return true;
+      } else if (parseTerminal<TurtleTokenId::Integer>()) {
+        lastParseResult_ =
+            static_cast<int64_t>(std::stoll(lastParseResult_.getString()));
+        return true;
+      }
+    } catch (const std::out_of_range&) {
+      // The error is reported by the ANTLR parser.
+    }
+    return false;
+  }
+};
+
+// Call `function` for each `VALUES` clause in the `pattern` (including the
+// nested patterns and subqueries).
+template <typename Function>
+void forEachValues(parsedQuery::GraphPattern& pattern,
+                   const Function& function) {
+  auto recurse = [&function](parsedQuery::GraphPattern& child) {
+    forEachValues(child, function);
+  };
+  for (auto& operation : pattern._graphPatterns) {
+    operation.visit([&]<typename T>(T& arg) {
+      if constexpr (std::is_same_v<T, parsedQuery::Values>) {
+        function(arg._inlineValues);
+      } else if constexpr (std::is_same_v<T, parsedQuery::Optional> ||
+                           std::is_same_v<T, parsedQuery::Minus> ||
+                           std::is_same_v<T, parsedQuery::ExistsFilter> ||
+                           std::is_same_v<T, parsedQuery::GroupGraphPattern>) {
+        recurse(arg._child);
+      } else if constexpr (std::is_same_v<T, parsedQuery::Union>) {
+        recurse(arg._child1);
+        recurse(arg._child2);
+      } else if constexpr (std::is_same_v<T, parsedQuery::Subquery>) {
+        recurse(arg.get()._rootGraphPattern);
+      }
+    });
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+FastValuesParser::QueryWithoutDataBlocks FastValuesParser::extractDataBlocks(
+    std::string_view query, size_t minSizeOfDataBlock) {
+  QueryWithoutDataBlocks result;
+  // The prefixes for the `DataBlockParser`, without the angle brackets.
+  ad_utility::HashMap<std::string, std::string> prefixes{
+      {INTERNAL_PREDICATE_PREFIX_NAME,
+       std::string{stripAngleBrackets(INTERNAL_PREDICATE_PREFIX_IRI)}}};
+  // The end of the part of the `query` that has already been copied to the
+  // `result`.
+  size_t endOfCopiedQuery = 0;
+
+  // Parse the `PREFIX` declaration at the beginning of the `input` (after the
+  // keyword) and return its size or `std::nullopt` if it is invalid.
+  auto parsePrefixDeclaration =
+      [&prefixes](std::string_view input) -> std::optional<size_t> {
+    size_t i = sizeOfWhitespaceAndComments(input);
+    auto colon = input.find(':', i);
+    if (colon == std::string_view::npos) {
+      return std::nullopt;
+    }
+    std::string prefixName{input.substr(i, colon - i)};
+    if (!std::ranges::all_of(prefixName, [](char c) {
+          return isNameChar(c) || c == '.';
+        })) {
+      return std::nullopt;
+    }
+    i = colon + 1;
+    i += sizeOfWhitespaceAndComments(input.substr(i));
+    auto size = sizeOfIriref(input.substr(i));
+    if (!size.has_value()) {
+      return std::nullopt;
+    }
+    auto iri = RdfEscaping::unescapeIriref(input.substr(i, size.value()));
+    prefixes[prefixName] = stripAngleBrackets(iri);
+    return i + size.value();
+  };
+
+  // Try to parse the variables and the data block of the `VALUES` clause at
+  // the beginning of the `input` (after the keyword). On success, replace the
+  // data block by a placeholder. Return the number of characters that have
+  // been handled.
+  auto handleValuesClause = [&](std::string_view input, size_t startInQuery) {
+    size_t i = sizeOfWhitespaceAndComments(input);
+    bool hasParentheses = input.substr(i).starts_with('(');
+    if (hasParentheses) {
+      ++i;
+    }
+    size_t numVariables = 0;
+    while (true) {
+      i += sizeOfWhitespaceAndComments(input.substr(i));
+      if (i >= input.size() || !(input[i] == '?' || input[i] == '$')) {
+        break;
+      }
+      size_t end = i + 1;
+      while (end < input.size() && isNameChar(input[end]) &&
+             input[end] != '-') {
+        ++end;
+      }
+      if (end == i + 1) {
+        return i;
+      }
+      ++numVariables;
+      i = end;
+      if (!hasParentheses) {
+        break;
+      }
+    }
+    if (hasParentheses) {
+      if (!input.substr(i).starts_with(')')) {
+        return i;
+      }
+      ++i;
+      i += sizeOfWhitespaceAndComments(input.substr(i));
+    }
+    if (numVariables == 0 || !input.substr(i).starts_with('{')) {
+      return i;
+    }
+    auto parsed = DataBlockParser{prefixes}.parse(input.substr(i),
+                                                  numVariables, hasParentheses);
+    if (!parsed.has_value() || parsed.value().second < minSizeOfDataBlock) {
+      return i;
+    }
+    auto& [rows, sizeOfDataBlock] = parsed.value();
+    auto placeholder = absl::StrCat(PLACEHOLDER_IRI_PREFIX,
+                                    result.dataBlocks_.size(), ">");
+    std::string row = placeholder;
+    for (size_t j = 1; j < numVariables; ++j) {
+      absl::StrAppend(&row, " UNDEF");
+    }
+    absl::StrAppend(&result.query_,
+                    query.substr(endOfCopiedQuery,
+                                 startInQuery + i - endOfCopiedQuery),
+                    hasParentheses ? absl::StrCat("{ (", row, ") }")
+                                   : absl::StrCat("{ ", row, " }"));
+    endOfCopiedQuery = startInQuery + i + sizeOfDataBlock;
+    result.dataBlocks_.push_back(std::move(rows));
+    return i + sizeOfDataBlock;
+  };
+
+  size_t i = 0;
+  while (i < query.size()) {
+    char c = query[i];
+    auto rest = query.substr(i);
+    if (c == '#' || absl::ascii_isspace(static_cast<unsigned char>(c))) {
+      i += sizeOfWhitespaceAndComments(rest);
+    } else if (c == '"' || c == '\'') {
+      i += sizeOfStringLiteral(rest);
+    } else if (c == '<') {
+      i += sizeOfIriref(rest).value_or(1);
+    } else if (isNameChar(c)) {
+      // A keyword, a prefixed name, a variable, a number etc.
+      bool isWordStart =
+          i == 0 || !(isNameChar(query[i - 1]) || query[i - 1] == ':' ||
+                      query[i - 1] == '.' || query[i - 1] == '?' ||
+                      query[i - 1] == '$' || query[i - 1] == '@');
+      if (isWordStart && startsWithKeyword(rest, "PREFIX")) {
+        auto size = parsePrefixDeclaration(rest.substr(6));
+        if (!size.has_value()) {
+          // Leave the error to the ANTLR parser.
+          return {};
+        }
+        i += 6 + size.value();
+      } else if (isWordStart && startsWithKeyword(rest, "BASE")) {
+        // `BASE` declarations change the meaning of relative IRIs, but are
+        // not supported anyway.
+        return {};
+      } else if (isWordStart && startsWithKeyword(rest, "VALUES")) {
+        i += 6 + handleValuesClause(rest.substr(6), i + 6);
+      } else {
+        while (i < query.size() && isNameChar(query[i])) {
+          ++i;
+        }
+      }
+    } else {
+      ++i;
+    }
+  }
+  if (!result.dataBlocks_.empty()) {
+    absl::StrAppend(&result.query_, query.substr(endOfCopiedQuery));
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+bool FastValuesParser::insertDataBlocks(ParsedQuery& parsedQuery,
+                                        std::vector<Rows> dataBlocks) {
+  std::vector<size_t> numOccurrences(dataBlocks.size(), 0);
+  bool allPlaceholdersAreValid = true;
+  auto insert = [&](parsedQuery::SparqlValues& values) {
+    if (values._values.size() != 1 || values._values[0].empty() ||
+        !values._values[0][0].isString()) {
+      return;
+    }
+    std::string_view placeholder = values._values[0][0].getString();
+    if (!placeholder.starts_with(PLACEHOLDER_IRI_PREFIX) ||
+        !placeholder.ends_with('>')) {
+      return;
+    }
+    placeholder.remove_prefix(PLACEHOLDER_IRI_PREFIX.size());
+    placeholder.remove_suffix(1);
+    size_t index = 0;
+    auto end = placeholder.data() + placeholder.size();
+    auto [ptr, error] = std::from_chars(placeholder.data(), end, index);
+    if (error != std::errc{} || ptr != end || index >= dataBlocks.size() ||
+        numOccurrences[index] > 0) {
+      allPlaceholdersAreValid = false;
+      return;
+    }
+    ++numOccurrences[index];
+    values._values = std::move(dataBlocks[index]);
+  };
+  forEachValues(parsedQuery._rootGraphPattern, insert);
+  return allPlaceholdersAreValid &&
+         std::ranges::all_of(numOccurrences, [](size_t n) { return n == 1; });
+}
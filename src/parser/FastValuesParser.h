@@ -0,0 +1,61 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parser/ParsedQuery.h"
+#include "parser/TripleComponent.h"
+
+// A hand-written parser for the data blocks of `VALUES` clauses. The ANTLR
+// based `SparqlParser` is slow for `VALUES` clauses with many rows, which are
+// often parsed faster by this parser than by the ANTLR parser. The values are
+// parsed with the `TurtleParser` (the syntax of IRIs and literals is the same
+// in SPARQL and Turtle).
+//
+// `SparqlParser::parseQuery` first replaces the large data blocks that can be
+// parsed by this parser by a placeholder (see `extractDataBlocks`), then
+// parses the remaining query with ANTLR, and finally puts the values into the
+// `ParsedQuery` (see `insertDataBlocks`). All other data blocks (e.g. those
+// with syntax errors) are left to the ANTLR parser.
+class FastValuesParser {
+ public:
+  // Data blocks with fewer bytes are left to the ANTLR parser, which is fast
+  // enough for them.
+  static constexpr size_t DEFAULT_MIN_SIZE_OF_DATA_BLOCK = 10'000;
+
+  // The placeholders for the data blocks have the form
+  // `<http://qlever.cs.uni-freiburg.de/values-placeholder/N>`, where `N` is
+  // the index of the data block in `QueryWithoutDataBlocks::dataBlocks_`.
+  static constexpr std::string_view PLACEHOLDER_IRI_PREFIX =
+      "<http://qlever.cs.uni-freiburg.de/values-placeholder/";
+
+  // The rows of a data block.
+  using Rows = std::vector<std::vector<TripleComponent>>;
+
+  // The result of `extractDataBlocks`.
+  struct QueryWithoutDataBlocks {
+    // The query, in which each of the `dataBlocks_` was replaced by a data
+    // block with a single row, the first entry of which is the placeholder,
+    // and the remaining entries are `UNDEF`.
+    std::string query_;
+    std::vector<Rows> dataBlocks_;
+  };
+
+  // Parse the data blocks of the `VALUES` clauses of the `query` that have at
+  // least `minSizeOfDataBlock` bytes and replace them by placeholders. If there
+  // are no such data blocks, the `query_` of the result is empty.
+  static QueryWithoutDataBlocks extractDataBlocks(
+      std::string_view query,
+      size_t minSizeOfDataBlock = DEFAULT_MIN_SIZE_OF_DATA_BLOCK);
+
+  // Replace the placeholders in the `VALUES` clauses of the `parsedQuery` by
+  // the `dataBlocks`. Return false if not every placeholder occurs exactly
+  // once (e.g. because a `VALUES` clause is inside of a `SERVICE`, which is
+  // not parsed). In this case the `parsedQuery` must not be used.
+  static bool insertDataBlocks(ParsedQuery& parsedQuery,
+                               std::vector<Rows> dataBlocks);
+};
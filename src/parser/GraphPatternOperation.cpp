@@ -112,6 +112,9 @@ void GraphPatternOperation::toString(std::ostringstream& os,
     } else if constexpr (std::is_same_v<T, Minus>) {
       os << "MINUS ";
       arg._child.toString(os, indentation);
+    } else if constexpr (std::is_same_v<T, ExistsFilter>) {
+      os << (arg._isNegated ? "FILTER NOT EXISTS " : "FILTER EXISTS ");
+      arg._child.toString(os, indentation);
     } else {
       static_assert(std::is_same_v<T, TransPath>);
       /*
@@ -91,6 +91,14 @@ struct Minus {
   GraphPattern _child;
 };
 
+/// A `FILTER EXISTS` or `FILTER NOT EXISTS` directly in a graph pattern. It is
+/// evaluated as a semi-join or anti-join with the rest of the enclosing graph
+/// pattern (see `SemiJoin` and `Minus` in the engine).
+struct ExistsFilter {
+  GraphPattern _child;
+  bool _isNegated = false;
+};
+
 /// A SPARQL `UNION` construct.
 struct Union {
   GraphPattern _child1;
@@ -153,7 +161,7 @@ struct Bind {
 // class actually becomes `using GraphPatternOperation = std::variant<...>`
 using GraphPatternOperationVariant =
     std::variant<Optional, Union, Subquery, TransPath, Bind, BasicGraphPattern,
-                 Values, Service, Minus, GroupGraphPattern>;
+                 Values, Service, Minus, ExistsFilter, GroupGraphPattern>;
 struct GraphPatternOperation
     : public GraphPatternOperationVariant,
       public VisitMixin<GraphPatternOperation, GraphPatternOperationVariant> {
@@ -3,6 +3,12 @@
 
 #include "./ParallelBuffer.h"
 
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
 // _________________________________________________________________________
 void ParallelFileBuffer::open(const string& filename) {
   file_.open(filename, "r");
@@ -38,6 +44,92 @@ std::optional<ParallelBuffer::BufferType> ParallelFileBuffer::getNextBlock() {
   return ret;
 }
 
+// _____________________________________________________________________________
+std::optional<ParallelDecompressingFileBuffer::Compression>
+ParallelDecompressingFileBuffer::compressionFromFilename(
+    std::string_view filename) {
+  if (filename.ends_with(".gz")) {
+    return Compression::Gzip;
+  } else if (filename.ends_with(".bz2")) {
+    return Compression::Bzip2;
+  } else if (filename.ends_with(".zst")) {
+    return Compression::Zstd;
+  }
+  return std::nullopt;
+}
+
+// _____________________________________________________________________________
+void ParallelDecompressingFileBuffer::open(const string& filename) {
+  namespace io = boost::iostreams;
+  auto compression = compressionFromFilename(filename);
+  AD_CONTRACT_CHECK(compression.has_value());
+  auto stream = std::make_unique<io::filtering_istream>();
+  switch (compression.value()) {
+    using enum Compression;
+    case Gzip:
+      stream->push(io::gzip_decompressor{});
+      break;
+    case Bzip2:
+      stream->push(io::bzip2_decompressor{});
+      break;
+    case Zstd:
+      stream->push(io::zstd_decompressor{});
+      break;
+  }
+  io::file_source file{filename, std::ios_base::in | std::ios_base::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error{
+        absl::StrCat("Could not open the compressed file ", filename)};
+  }
+  stream->push(file);
+  // Decompression errors are reported via exceptions.
+  stream->exceptions(std::ios_base::badbit);
+  stream_ = std::move(stream);
+  eof_ = false;
+  readNextBlockAsync();
+}
+
+// _____________________________________________________________________________
+void ParallelDecompressingFileBuffer::readNextBlockAsync() {
+  buf_.resize(blocksize_);
+  fut_ = std::async(std::launch::async, [this]() {
+    stream_->read(buf_.data(), static_cast<std::streamsize>(blocksize_));
+    return static_cast<size_t>(stream_->gcount());
+  });
+}
+
+// _____________________________________________________________________________
+std::optional<ParallelBuffer::BufferType>
+ParallelDecompressingFileBuffer::getNextBlock() {
+  AD_CONTRACT_CHECK(stream_ != nullptr);
+  if (eof_) {
+    return std::nullopt;
+  }
+  AD_CORRECTNESS_CHECK(fut_.valid());
+  auto numBytesRead = fut_.get();
+  if (numBytesRead == 0) {
+    eof_ = true;
+    return std::nullopt;
+  }
+  buf_.resize(numBytesRead);
+  std::optional<BufferType> ret = std::move(buf_);
+  readNextBlockAsync();
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::unique_ptr<ParallelBuffer> openParallelFileBuffer(size_t blocksize,
+                                                       const string& filename) {
+  std::unique_ptr<ParallelBuffer> buffer;
+  if (ParallelDecompressingFileBuffer::compressionFromFilename(filename)) {
+    buffer = std::make_unique<ParallelDecompressingFileBuffer>(blocksize);
+  } else {
+    buffer = std::make_unique<ParallelFileBuffer>(blocksize);
+  }
+  buffer->open(filename);
+  return buffer;
+}
+
 // ____________________________________________________________________________
 std::optional<size_t> ParallelBufferWithEndRegex::findRegexNearEnd(
     const BufferType& vec, const re2::RE2& regex) {
@@ -72,7 +164,7 @@ std::optional<size_t> ParallelBufferWithEndRegex::findRegexNearEnd(
 // _____________________________________________________________________________
 std::optional<ParallelBuffer::BufferType>
 ParallelBufferWithEndRegex::getNextBlock() {
-  auto rawInput = rawBuffer_.getNextBlock();
+  auto rawInput = rawBuffer_->getNextBlock();
   if (!rawInput || exhausted_) {
     exhausted_ = true;
     if (remainder_.empty()) {
@@ -87,7 +179,7 @@ ParallelBufferWithEndRegex::getNextBlock() {
 
   auto endPosition = findRegexNearEnd(rawInput.value(), endRegex_);
   if (!endPosition) {
-    if (rawBuffer_.getNextBlock()) {
+    if (rawBuffer_->getNextBlock()) {
       throw std::runtime_error(absl::StrCat(
           "The regex \"", endRegexAsString_,
           "\" which marks the end of a statement was not found at "
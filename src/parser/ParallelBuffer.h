@@ -7,8 +7,11 @@
 #include <re2/re2.h>
 
 #include <future>
+#include <istream>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../util/File.h"
@@ -76,6 +79,54 @@ class ParallelFileBuffer : public ParallelBuffer {
   std::future<size_t> fut_;
 };
 
+/**
+ * @brief Read the bytes from a file that is compressed with gzip, bzip2 or
+ * zstd and pass the decompressed bytes.
+ *
+ * As for the `ParallelFileBuffer`, the next block is read and decompressed in
+ * parallel while the current block is processed. Decompressing a single stream
+ * is inherently sequential, but several files can be decompressed
+ * concurrently by using one buffer per file.
+ */
+class ParallelDecompressingFileBuffer : public ParallelBuffer {
+ public:
+  enum class Compression { Gzip, Bzip2, Zstd };
+
+  explicit ParallelDecompressingFileBuffer(size_t blocksize)
+      : ParallelBuffer(blocksize) {}
+
+  // Deduce the compression from the suffix of the `filename` (`.gz`, `.bz2`,
+  // or `.zst`). Return `nullopt` for all other suffixes.
+  static std::optional<Compression> compressionFromFilename(
+      std::string_view filename);
+
+  // Open the `filename`, the compression of which is deduced from its suffix
+  // via `compressionFromFilename` (which must not return `nullopt`).
+  void open(const string& filename) override;
+
+  // _____________________________________________________
+  std::optional<BufferType> getNextBlock() override;
+
+ private:
+  // Asynchronously read the next `blocksize_` decompressed bytes into `buf_`.
+  void readNextBlockAsync();
+
+  // The file and the decompressing filter that reads from it (a
+  // `boost::iostreams::filtering_istream`, which is not exposed here to keep
+  // the boost headers out of this header).
+  std::unique_ptr<std::istream> stream_;
+  bool eof_ = true;
+  BufferType buf_;
+  std::future<size_t> fut_;
+};
+
+// Return a buffer that is opened for the `filename` and that yields blocks of
+// approximately `blocksize` bytes. If the suffix of the `filename` denotes a
+// compressed file (see `ParallelDecompressingFileBuffer`), the blocks are
+// decompressed, else the bytes are passed as they are.
+std::unique_ptr<ParallelBuffer> openParallelFileBuffer(size_t blocksize,
+                                                       const string& filename);
+
 /// A parallel buffer, where each of the blocks except for the last one has to
 /// end with a certain regex (e.g. a full stop followed by whitespace and a
 /// newline to denote the end of a triple in a .ttl file).
@@ -89,8 +140,11 @@ class ParallelBufferWithEndRegex : public ParallelBuffer {
   // __________________________________________________________________________
   std::optional<BufferType> getNextBlock() override;
 
-  // Open the file from which the blocks are read.
-  void open(const string& filename) override { rawBuffer_.open(filename); }
+  // Open the file from which the blocks are read. Compressed files are
+  // decompressed (see `openParallelFileBuffer`).
+  void open(const string& filename) override {
+    rawBuffer_ = openParallelFileBuffer(blocksize_, filename);
+  }
 
  private:
   // Find `regex` near the end of `vec` by searching in blocks of 1000, 2000,
@@ -99,7 +153,7 @@ class ParallelBufferWithEndRegex : public ParallelBuffer {
   // of the regex match, or std::nullopt if the regex was not found at all.
   static std::optional<size_t> findRegexNearEnd(const BufferType& vec,
                                                 const re2::RE2& regex);
-  ParallelFileBuffer rawBuffer_{blocksize_};
+  std::unique_ptr<ParallelBuffer> rawBuffer_;
   BufferType remainder_;
   re2::RE2 endRegex_;
   std::string endRegexAsString_;
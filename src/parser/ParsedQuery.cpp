@@ -4,6 +4,7 @@
 
 #include "ParsedQuery.h"
 
+#include <algorithm>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -358,7 +359,8 @@ void ParsedQuery::GraphPattern::recomputeIds(size_t* id_count) {
         arg._child2.recomputeIds(id_count);
       } else if constexpr (std::is_same_v<T, parsedQuery::Optional> ||
                            std::is_same_v<T, parsedQuery::GroupGraphPattern> ||
-                           std::is_same_v<T, parsedQuery::Minus>) {
+                           std::is_same_v<T, parsedQuery::Minus> ||
+                           std::is_same_v<T, parsedQuery::ExistsFilter>) {
         arg._child.recomputeIds(id_count);
       } else if constexpr (std::is_same_v<T, parsedQuery::TransPath>) {
         // arg._childGraphPattern.recomputeIds(id_count);
@@ -385,19 +387,81 @@ void ParsedQuery::GraphPattern::recomputeIds(size_t* id_count) {
 // __________________________________________________________________________
 ParsedQuery::GraphPattern::GraphPattern() : _optional(false) {}
 
+namespace {
+// Return true iff all the values of the object of the `path` (if
+// `variableIsObject`) or of its subject (else) are bound by a simple IRI
+// predicate in the `path` that can be replaced by the corresponding
+// language-tagged predicate (see `addLanguageFilter` below). For example, this
+// is the case for the object of `<p>`, `<p>|<q>` and `<p>/<q>` and for the
+// subject of `^<p>`, but not for the object of `^<p>` or `<p>*`.
+bool isLanguageFilterApplicable(const PropertyPath& path,
+                                bool variableIsObject) {
+  using enum PropertyPath::Operation;
+  switch (path._operation) {
+    case IRI:
+      return variableIsObject && !isVariable(path) &&
+             !path._iri.starts_with(INTERNAL_ENTITIES_URI_PREFIX);
+    case ALTERNATIVE:
+      return std::ranges::all_of(path._children, [&](const auto& child) {
+        return isLanguageFilterApplicable(child, variableIsObject);
+      });
+    case SEQUENCE:
+      return isLanguageFilterApplicable(variableIsObject
+                                            ? path._children.back()
+                                            : path._children.front(),
+                                        variableIsObject);
+    case INVERSE:
+      return isLanguageFilterApplicable(path._children.front(),
+                                        !variableIsObject);
+    default:
+      return false;
+  }
+}
+
+// Replace the IRI predicates that are found by `isLanguageFilterApplicable`
+// (which must be true for the same arguments) by the language-tagged
+// predicates for the `langTag`.
+void applyLanguageFilter(PropertyPath& path, bool variableIsObject,
+                         const std::string& langTag) {
+  using enum PropertyPath::Operation;
+  switch (path._operation) {
+    case IRI:
+      path._iri = '@' + langTag + '@' + path._iri;
+      return;
+    case ALTERNATIVE:
+      for (auto& child : path._children) {
+        applyLanguageFilter(child, variableIsObject, langTag);
+      }
+      return;
+    case SEQUENCE:
+      applyLanguageFilter(variableIsObject ? path._children.back()
+                                           : path._children.front(),
+                          variableIsObject, langTag);
+      return;
+    case INVERSE:
+      applyLanguageFilter(path._children.front(), !variableIsObject, langTag);
+      return;
+    default:
+      AD_FAIL();
+  }
+}
+}  // namespace
+
 // __________________________________________________________________________
 void ParsedQuery::GraphPattern::addLanguageFilter(
     const Variable& variable, const std::string& languageInQuotes) {
   auto langTag = languageInQuotes.substr(1, languageInQuotes.size() - 2);
   // Find all triples where the object is the `variable` and the predicate is
-  // a simple `IRIREF` (neither a variable nor a complex property path).
-  // Search in all the basic graph patterns, as filters have the complete
-  // graph patterns as their scope.
+  // a simple `IRIREF` (not a variable), or a property path that binds the
+  // `variable` only via such IRIs (e.g. `skos:altLabel|rdfs:label`, or
+  // `^rdfs:label` with the `variable` as the subject). Search in all the basic
+  // graph patterns, as filters have the complete graph patterns as their
+  // scope.
   // TODO<joka921> In theory we could also recurse into GroupGraphPatterns,
   // Subqueries etc.
-  // TODO<joka921> Also support property paths (^rdfs:label,
-  // skos:altLabel|rdfs:label, ...)
-  std::vector<SparqlTriple*> matchingTriples;
+  // The matching triples together with the information whether the `variable`
+  // is their object.
+  std::vector<std::pair<SparqlTriple*, bool>> matchingTriples;
   using BasicPattern = parsedQuery::BasicGraphPattern;
   namespace ad = ad_utility;
   namespace stdv = std::views;
@@ -406,17 +470,18 @@ void ParsedQuery::GraphPattern::addLanguageFilter(
            stdv::filter(ad::toBool)) {
     for (auto& triple : basicPattern->_triples) {
       if (triple._o == variable &&
-          (triple._p._operation == PropertyPath::Operation::IRI &&
-           !isVariable(triple._p)) &&
-          !triple._p._iri.starts_with(INTERNAL_ENTITIES_URI_PREFIX)) {
-        matchingTriples.push_back(&triple);
+          isLanguageFilterApplicable(triple._p, true)) {
+        matchingTriples.emplace_back(&triple, true);
+      } else if (triple._s == variable &&
+                 isLanguageFilterApplicable(triple._p, false)) {
+        matchingTriples.emplace_back(&triple, false);
       }
     }
   }
 
   // Replace all the matching triples.
-  for (auto* triplePtr : matchingTriples) {
-    triplePtr->_p._iri = '@' + langTag + '@' + triplePtr->_p._iri;
+  for (auto [triplePtr, variableIsObject] : matchingTriples) {
+    applyLanguageFilter(triplePtr->_p, variableIsObject, langTag);
   }
 
   // Handle the case, that no suitable triple (see above) was found. In this
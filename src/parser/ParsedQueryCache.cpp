@@ -0,0 +1,339 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "parser/ParsedQueryCache.h"
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/match.h>
+#include <absl/strings/str_cat.h>
+
+#include <charconv>
+
+#include "global/Constants.h"
+#include "parser/RdfEscaping.h"
+#include "parser/SparqlParser.h"
+
+namespace {
+// Return true iff the `c` may occur in an IRIREF (see the SPARQL grammar).
+// Backslashes are allowed by QLever's parser, but IRIs containing them are not
+// parameterized for simplicity.
+bool isIrirefChar(char c) {
+  static constexpr std::string_view forbidden = "<>\"{}|^`\\";
+  return static_cast<unsigned char>(c) > 0x20 &&
+         forbidden.find(c) == std::string_view::npos;
+}
+
+// Return true iff the `normalizedPrefix` (the normalized query up to an IRI)
+// ends with `PREFIX pname:`, s.t. the IRI is part of a prefix declaration.
+bool endsWithPrefixDeclaration(std::string_view normalizedPrefix) {
+  auto stripTrailingSpace = [](std::string_view& s) {
+    if (s.ends_with(' ')) {
+      s.remove_suffix(1);
+    }
+  };
+  auto removeLastToken = [](std::string_view& s) {
+    auto pos = s.find_last_of(' ');
+    std::string_view token =
+        pos == std::string_view::npos ? s : s.substr(pos + 1);
+    s.remove_suffix(token.size());
+    return token;
+  };
+  stripTrailingSpace(normalizedPrefix);
+  std::string_view pname = removeLastToken(normalizedPrefix);
+  if (!pname.ends_with(':')) {
+    return false;
+  }
+  stripTrailingSpace(normalizedPrefix);
+  return absl::EqualsIgnoreCase(removeLastToken(normalizedPrefix), "PREFIX");
+}
+
+// Return the index of the placeholder `component` or `std::nullopt` if the
+// `component` is not a placeholder.
+std::optional<size_t> getPlaceholderIndex(const TripleComponent& component) {
+  if (!component.isString()) {
+    return std::nullopt;
+  }
+  std::string_view s = component.getString();
+  if (!s.starts_with(ParsedQueryCache::PARAMETER_IRI_PREFIX) ||
+      !s.ends_with('>')) {
+    return std::nullopt;
+  }
+  s.remove_prefix(ParsedQueryCache::PARAMETER_IRI_PREFIX.size());
+  s.remove_suffix(1);
+  size_t index = 0;
+  auto [ptr, error] = std::from_chars(s.data(), s.data() + s.size(), index);
+  if (error != std::errc{} || ptr != s.data() + s.size()) {
+    return std::nullopt;
+  }
+  return index;
+}
+
+// Call `function` for the subject and the object of each triple in the
+// `pattern` (including the nested patterns and subqueries). The special
+// triples with QLever-internal predicates (e.g. `ql:contains-entity`) are
+// skipped, because the parser handles their subjects and objects differently.
+template <typename Function>
+void forEachSubjectAndObject(parsedQuery::GraphPattern& pattern,
+                             const Function& function) {
+  auto recurse = [&function](parsedQuery::GraphPattern& child) {
+    forEachSubjectAndObject(child, function);
+  };
+  for (auto& operation : pattern._graphPatterns) {
+    operation.visit([&]<typename T>(T& arg) {
+      if constexpr (std::is_same_v<T, parsedQuery::BasicGraphPattern>) {
+        for (auto& triple : arg._triples) {
+          if (triple._p._operation != PropertyPath::Operation::IRI ||
+              triple._p._iri.starts_with(INTERNAL_ENTITIES_URI_PREFIX)) {
+            continue;
+          }
+          function(triple._s);
+          function(triple._o);
+        }
+      } else if constexpr (std::is_same_v<T, parsedQuery::Optional> ||
+                           std::is_same_v<T, parsedQuery::Minus> ||
+                           std::is_same_v<T, parsedQuery::ExistsFilter> ||
+                           std::is_same_v<T, parsedQuery::GroupGraphPattern>) {
+        recurse(arg._child);
+      } else if constexpr (std::is_same_v<T, parsedQuery::Union>) {
+        recurse(arg._child1);
+        recurse(arg._child2);
+      } else if constexpr (std::is_same_v<T, parsedQuery::Subquery>) {
+        recurse(arg.get()._rootGraphPattern);
+      }
+      // The other operations (e.g. `VALUES` or `SERVICE`) are not searched,
+      // so the placeholders that occur in them are recognized as invalid.
+    });
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+ParsedQueryCache::NormalizedQuery ParsedQueryCache::normalize(
+    std::string_view query) {
+  NormalizedQuery result;
+  std::string& text = result.text_;
+  bool pendingSpace = false;
+  size_t startOfCurrentText = 0;
+  auto append = [&text, &pendingSpace](std::string_view s) {
+    if (pendingSpace && !text.empty()) {
+      text.push_back(' ');
+    }
+    pendingSpace = false;
+    text.append(s);
+  };
+  size_t i = 0;
+  while (i < query.size()) {
+    char c = query[i];
+    if (absl::ascii_isspace(static_cast<unsigned char>(c))) {
+      pendingSpace = true;
+      ++i;
+    } else if (c == '#') {
+      // A comment that ends at the end of the line.
+      i = std::min(query.find('\n', i), query.size());
+      pendingSpace = true;
+    } else if (c == '"' || c == '\'') {
+      // A literal, which is copied including its (possibly triple) quotes.
+      std::string_view quotes = query.substr(i, 3) == std::string(3, c)
+                                    ? query.substr(i, 3)
+                                    : query.substr(i, 1);
+      size_t end = i + quotes.size();
+      while (end < query.size() && !query.substr(end).starts_with(quotes)) {
+        end += query[end] == '\\' ? 2 : 1;
+      }
+      end = std::min(end + quotes.size(), query.size());
+      append(query.substr(i, end - i));
+      i = end;
+    } else if (c == '<') {
+      size_t end = i + 1;
+      while (end < query.size() && isIrirefChar(query[end])) {
+        ++end;
+      }
+      if (end < query.size() && query[end] == '>') {
+        auto iri = query.substr(i, end - i + 1);
+        if (endsWithPrefixDeclaration(text)) {
+          append(iri);
+        } else {
+          // Add the pending space to the text before the placeholder.
+          append("");
+          result.textBetweenParameters_.push_back(
+              text.substr(startOfCurrentText));
+          append(absl::StrCat(PARAMETER_IRI_PREFIX, result.parameters_.size(),
+                              ">"));
+          startOfCurrentText = text.size();
+          result.parameters_.emplace_back(iri);
+        }
+        i = end + 1;
+      } else {
+        // Not an IRI, but e.g. the `<` operator.
+        append(query.substr(i, 1));
+        ++i;
+      }
+    } else {
+      append(query.substr(i, 1));
+      ++i;
+    }
+  }
+  result.textBetweenParameters_.push_back(text.substr(startOfCurrentText));
+  return result;
+}
+
+// _____________________________________________________________________________
+ParsedQueryCache::NormalizedQuery
+ParsedQueryCache::NormalizedQuery::withoutPlaceholdersFor(
+    const std::vector<size_t>& indices) const {
+  AD_CONTRACT_CHECK(textBetweenParameters_.size() == parameters_.size() + 1);
+  NormalizedQuery result;
+  result.textBetweenParameters_.push_back(textBetweenParameters_.at(0));
+  auto nextFixed = indices.begin();
+  for (size_t i = 0; i < parameters_.size(); ++i) {
+    const auto& nextText = textBetweenParameters_[i + 1];
+    if (nextFixed != indices.end() && *nextFixed == i) {
+      ++nextFixed;
+      absl::StrAppend(&result.textBetweenParameters_.back(), parameters_[i],
+                      nextText);
+    } else {
+      result.parameters_.push_back(parameters_[i]);
+      result.textBetweenParameters_.push_back(nextText);
+    }
+  }
+  result.text_ = result.textBetweenParameters_.at(0);
+  for (size_t i = 0; i < result.parameters_.size(); ++i) {
+    absl::StrAppend(&result.text_, PARAMETER_IRI_PREFIX, i, ">",
+                    result.textBetweenParameters_[i + 1]);
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+ParsedQueryCache::ParsedQueryCache(size_t maxNumEntries)
+    : fixedParameters_{maxNumEntries},
+      parsedQueries_{maxNumEntries},
+      maxNumEntries_{maxNumEntries} {}
+
+// _____________________________________________________________________________
+ParsedQuery ParsedQueryCache::getOrParse(const std::string& query) {
+  if (maxNumEntries_ == 0) {
+    return SparqlParser::parseQuery(query);
+  }
+  // True iff the result was not completely taken from the cache.
+  bool wasParsed = false;
+  auto allOccurExactlyOnce = [](const std::vector<size_t>& numOccurrences) {
+    return std::ranges::all_of(numOccurrences,
+                               [](size_t n) { return n == 1; });
+  };
+
+  // First find out which IRIs can be replaced by placeholders. These are the
+  // IRIs that are subjects or objects of triples. If the query with all its
+  // IRIs replaced is invalid, none of them is replaced.
+  auto normalized = normalize(query);
+  auto computeFixedParameters = [&]() {
+    wasParsed = true;
+    auto numParameters = normalized.parameters_.size();
+    std::vector<size_t> numOccurrences(numParameters, 0);
+    try {
+      auto parsedQuery = SparqlParser::parseQuery(normalized.text_);
+      numOccurrences = countPlaceholders(parsedQuery, numParameters);
+    } catch (const std::exception&) {
+      // None of the IRIs is replaced.
+    }
+    FixedParameters result;
+    for (size_t i = 0; i < numParameters; ++i) {
+      if (numOccurrences[i] != 1) {
+        result.push_back(i);
+      }
+    }
+    return result;
+  };
+  auto fixedParameters =
+      fixedParameters_.computeOnce(normalized.text_, computeFixedParameters)
+          ._resultPointer;
+
+  // Then parse the query in which only these IRIs are replaced. The actual
+  // IRIs of the predicates etc. might make the IRIs of some of the subjects
+  // and objects special (e.g. the object of `ql:contains-entity`), so the
+  // placeholders have to be checked again.
+  auto parameterized = normalized.withoutPlaceholdersFor(*fixedParameters);
+  auto parseParameterized = [&]() -> MaybeParsedQuery {
+    wasParsed = true;
+    try {
+      auto parsedQuery = SparqlParser::parseQuery(parameterized.text_);
+      if (allOccurExactlyOnce(countPlaceholders(
+              parsedQuery, parameterized.parameters_.size()))) {
+        return parsedQuery;
+      }
+    } catch (const std::exception&) {
+      // The query is parsed as is below.
+    }
+    return std::nullopt;
+  };
+  auto maybeParsedQuery =
+      parsedQueries_.computeOnce(parameterized.text_, parseParameterized)
+          ._resultPointer;
+
+  ParsedQuery result;
+  if (maybeParsedQuery->has_value()) {
+    result = maybeParsedQuery->value();
+    bindParameters(result, parameterized.parameters_);
+  } else {
+    // Parse the query as is, this also throws the proper exceptions for
+    // invalid queries.
+    auto parseExact = [&]() -> MaybeParsedQuery {
+      wasParsed = true;
+      return SparqlParser::parseQuery(query);
+    };
+    auto exactParsedQuery =
+        parsedQueries_
+            .computeOnce(absl::StrCat(EXACT_KEY_PREFIX, query), parseExact)
+            ._resultPointer;
+    result = exactParsedQuery->value();
+  }
+  ++(wasParsed ? numMisses_ : numHits_);
+  // The normalized query must not be visible to the user (it is e.g. part of
+  // the response).
+  result._originalString = query;
+  return result;
+}
+
+// _____________________________________________________________________________
+std::vector<size_t> ParsedQueryCache::countPlaceholders(
+    ParsedQuery& parsedQuery, size_t numParameters) {
+  std::vector<size_t> numOccurrences(numParameters, 0);
+  forEachSubjectAndObject(
+      parsedQuery._rootGraphPattern, [&](const TripleComponent& component) {
+        auto index = getPlaceholderIndex(component);
+        if (index.has_value() && index.value() < numParameters) {
+          ++numOccurrences[index.value()];
+        }
+      });
+  return numOccurrences;
+}
+
+// _____________________________________________________________________________
+void ParsedQueryCache::bindParameters(
+    ParsedQuery& parsedQuery, const std::vector<std::string>& parameters) {
+  forEachSubjectAndObject(
+      parsedQuery._rootGraphPattern, [&](TripleComponent& component) {
+        auto index = getPlaceholderIndex(component);
+        if (index.has_value() && index.value() < parameters.size()) {
+          component = RdfEscaping::unescapeIriref(parameters[index.value()]);
+        }
+      });
+}
+
+// _____________________________________________________________________________
+void ParsedQueryCache::setMaxNumEntries(size_t maxNumEntries) {
+  maxNumEntries_ = maxNumEntries;
+  fixedParameters_.setMaxNumEntries(maxNumEntries);
+  parsedQueries_.setMaxNumEntries(maxNumEntries);
+}
+
+// _____________________________________________________________________________
+size_t ParsedQueryCache::numEntries() const {
+  return parsedQueries_.numNonPinnedEntries();
+}
+
+// _____________________________________________________________________________
+void ParsedQueryCache::clear() {
+  fixedParameters_.clearAll();
+  parsedQueries_.clearAll();
+}
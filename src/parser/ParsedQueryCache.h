@@ -0,0 +1,122 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parser/ParsedQuery.h"
+#include "util/Cache.h"
+#include "util/ConcurrentCache.h"
+
+// A cache for the results of `SparqlParser::parseQuery`, which saves the
+// parsing time for queries that are sent over and over again. Queries that
+// only differ in the IRIs in the subject or object position of their triples
+// (which is typical for the point lookups of an application, e.g. "the label
+// of <entity>") share the same entry: these IRIs are replaced by placeholders
+// (see `normalize`) and the IRIs of the actual query are bound to the
+// placeholders of the cached query for each lookup.
+//
+// Note: Only the parsing is cached, not the query planning. The query
+// execution trees are built for a specific `QueryExecutionContext` and their
+// operations store the state of their execution, so they cannot be reused by
+// different requests. Additionally, the query planner uses the values of the
+// IRIs for its size estimates, so a plan that is optimal for one IRI might be
+// arbitrarily bad for another one.
+class ParsedQueryCache {
+ public:
+  // The placeholders for the IRIs of a query have the form
+  // `<http://qlever.cs.uni-freiburg.de/parameter/N>`, where `N` is the index
+  // of the IRI in `NormalizedQuery::parameters_`.
+  static constexpr std::string_view PARAMETER_IRI_PREFIX =
+      "<http://qlever.cs.uni-freiburg.de/parameter/";
+
+  // A query with normalized whitespace, without comments, and with (some of)
+  // the IRIs replaced by placeholders.
+  struct NormalizedQuery {
+    std::string text_;
+    // The IRIs that were replaced (exactly as they occur in the query).
+    std::vector<std::string> parameters_;
+    // The parts of the `text_` before, between, and after the placeholders, so
+    // `textBetweenParameters_.size() == parameters_.size() + 1`.
+    std::vector<std::string> textBetweenParameters_;
+
+    // Return the normalized query in which the parameters with the given
+    // `indices` (sorted) are not replaced by placeholders.
+    NormalizedQuery withoutPlaceholdersFor(
+        const std::vector<size_t>& indices) const;
+  };
+
+  // Normalize the `query`: Remove the comments, replace each sequence of
+  // whitespace by a single space and replace each IRI that is not part of a
+  // `PREFIX` declaration by a placeholder. Literals are left unchanged.
+  static NormalizedQuery normalize(std::string_view query);
+
+ private:
+  // For a query in which all the IRIs are replaced by placeholders, the
+  // indices of the placeholders that are not the subject or object of a
+  // triple (e.g. predicates or IRIs in a `FILTER`), because the parsing might
+  // depend on their actual IRIs.
+  using FixedParameters = std::vector<size_t>;
+  struct FixedParametersSizeGetter {
+    ad_utility::MemorySize operator()(const FixedParameters& fixed) const {
+      return ad_utility::MemorySize::bytes(fixed.size() * sizeof(size_t));
+    }
+  };
+  // A parsed query with placeholders. It is `std::nullopt` if the query cannot
+  // be parameterized, such queries are stored with their exact text. The key
+  // of the latter is prefixed by `EXACT_KEY_PREFIX` to distinguish them from
+  // the normalized queries (which never start with a space).
+  static constexpr std::string_view EXACT_KEY_PREFIX = " exact:";
+  using MaybeParsedQuery = std::optional<ParsedQuery>;
+  // All the parsed queries are counted the same, the cache is bounded by the
+  // number of entries.
+  struct MaybeParsedQuerySizeGetter {
+    ad_utility::MemorySize operator()(const MaybeParsedQuery&) const {
+      return ad_utility::MemorySize::bytes(1);
+    }
+  };
+
+  ad_utility::ConcurrentCache<ad_utility::LRUCache<
+      std::string, FixedParameters, FixedParametersSizeGetter>>
+      fixedParameters_;
+  ad_utility::ConcurrentCache<ad_utility::LRUCache<
+      std::string, MaybeParsedQuery, MaybeParsedQuerySizeGetter>>
+      parsedQueries_;
+  std::atomic<size_t> maxNumEntries_;
+  std::atomic<size_t> numHits_ = 0;
+  std::atomic<size_t> numMisses_ = 0;
+
+ public:
+  // Create a cache that stores at most `maxNumEntries` parsed queries. If
+  // `maxNumEntries` is zero, the queries are always parsed.
+  explicit ParsedQueryCache(size_t maxNumEntries);
+
+  // Return the parsed `query`. The result is the same as the result of
+  // `SparqlParser::parseQuery(query)`, in particular all the exceptions for
+  // invalid queries are propagated.
+  ParsedQuery getOrParse(const std::string& query);
+
+  void setMaxNumEntries(size_t maxNumEntries);
+  // The number of cached parsed queries.
+  size_t numEntries() const;
+  void clear();
+
+  // The number of calls to `getOrParse` that did (not) require parsing.
+  size_t numHits() const { return numHits_; }
+  size_t numMisses() const { return numMisses_; }
+
+ private:
+  // For each of the placeholders `0, ..., numParameters - 1` return how often
+  // it occurs as the subject or object of a triple of the `parsedQuery`.
+  static std::vector<size_t> countPlaceholders(ParsedQuery& parsedQuery,
+                                               size_t numParameters);
+
+  // Replace the placeholders in the `parsedQuery` by the `parameters`.
+  static void bindParameters(ParsedQuery& parsedQuery,
+                             const std::vector<std::string>& parameters);
+};
@@ -4,12 +4,14 @@
 
 #include "./SparqlParser.h"
 
+#include "parser/FastValuesParser.h"
 #include "parser/SparqlParserHelpers.h"
 
 using AntlrParser = SparqlAutomaticParser;
 
-// _____________________________________________________________________________
-ParsedQuery SparqlParser::parseQuery(std::string query) {
+namespace {
+// Parse the `query` with the ANTLR parser.
+ParsedQuery parseWithAntlr(std::string query) {
   // The second argument is the `PrefixMap` for QLever's internal IRIs.
   sparqlParserHelpers::ParserAndVisitor p{
       std::move(query),
@@ -24,3 +26,24 @@ ParsedQuery SparqlParser::parseQuery(std::string query) {
   AD_CONTRACT_CHECK(resultOfParseAndRemainingText.remainingText_.empty());
   return std::move(resultOfParseAndRemainingText.resultOfParse_);
 }
+}  // namespace
+
+// _____________________________________________________________________________
+ParsedQuery SparqlParser::parseQuery(std::string query) {
+  // Large `VALUES` clauses are parsed by the much faster `FastValuesParser`.
+  auto withoutDataBlocks = FastValuesParser::extractDataBlocks(query);
+  if (!withoutDataBlocks.dataBlocks_.empty()) {
+    try {
+      auto parsedQuery = parseWithAntlr(std::move(withoutDataBlocks.query_));
+      if (FastValuesParser::insertDataBlocks(
+              parsedQuery, std::move(withoutDataBlocks.dataBlocks_))) {
+        parsedQuery._originalString = std::move(query);
+        return parsedQuery;
+      }
+    } catch (const std::exception&) {
+      // The query is parsed again below, s.t. the error message refers to the
+      // original query.
+    }
+  }
+  return parseWithAntlr(std::move(query));
+}
@@ -222,11 +222,17 @@ class TripleComponent {
   [[nodiscard]] std::optional<Id> toValueIdIfNotString() const;
 
   // Convert the `TripleComponent` to an ID. If the `TripleComponent` is a
-  // string, the IDs are resolved using the `vocabulary`. If a string is not
+  // string, the IDs are resolved using the `vocabulary` (IRIs that are
+  // encoded directly into the ID don't need a lookup). If a string is not
   // found in the vocabulary, `std::nullopt` is returned.
   template <typename Vocabulary>
   [[nodiscard]] std::optional<Id> toValueId(
       const Vocabulary& vocabulary) const {
+    if (isString()) {
+      if (auto id = vocabulary.getEncodedIriManager().encode(getString())) {
+        return id;
+      }
+    }
     if (isString() || isLiteral()) {
       VocabIndex idx;
       const std::string& content =
@@ -247,22 +253,19 @@ class TripleComponent {
   // string is neither in `vocabulary` nor in `localVocab`, it will be added to
   // `localVocab`. Therefore, we get a valid `Id` in any case. The modifier is
   // `&&` because in our uses of this method, the `TripleComponent` object is
-  // created solely to call this method and we want to avoid copying the
-  // `std::string` when passing it to the local vocabulary.
+  // created solely to call this method.
   template <typename Vocabulary>
   [[nodiscard]] Id toValueId(const Vocabulary& vocabulary,
                              LocalVocab& localVocab) && {
     std::optional<Id> id = toValueId(vocabulary);
     if (!id) {
       // If `toValueId` could not convert to `Id`, we have a string, which we
-      // look up in (and potentially add to) our local vocabulary.
+      // look up in (and potentially add to) our local vocabulary, unless it
+      // is short enough to be stored directly in the `Id`.
       AD_CORRECTNESS_CHECK(isString() || isLiteral());
-      // NOTE: There is a `&&` version of `getIndexAndAddIfNotContained`.
-      // Otherwise, `newWord` would be copied here despite the `std::move`.
-      std::string&& newWord = isString() ? std::move(getString())
-                                         : std::move(getLiteral()).rawContent();
-      id = Id::makeFromLocalVocabIndex(
-          localVocab.getIndexAndAddIfNotContained(std::move(newWord)));
+      const std::string& newWord =
+          isString() ? getString() : getLiteral().rawContent();
+      id = localVocab.getIdAndAddIfNotContained(newWord);
     }
     return id.value();
   }
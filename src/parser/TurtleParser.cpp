@@ -7,7 +7,9 @@
 
 #include <cstring>
 
+#include "absl/strings/match.h"
 #include "parser/RdfEscaping.h"
+#include "util/ByteScanning.h"
 #include "util/Conversions.h"
 #include "util/OnDestructionDontThrowDuringStackUnwinding.h"
 
@@ -484,24 +486,24 @@ bool TurtleParser<T>::stringParse() {
     if (view.starts_with(q)) {
       foundString = true;
       startPos = q.size();
-      endPos = view.find(q, startPos);
-      while (endPos != string::npos) {
-        if (view[endPos - 1] == '\\') {
-          size_t numBackslash = 1;
-          auto slashPos = endPos - 2;
-          while (view[slashPos] == '\\') {
-            slashPos--;
-            numBackslash++;
-          }
-          if (numBackslash % 2 == 0) {
-            // even number of backslashes means that the quote we found has not
-            // been escaped
-            break;
-          }
-          endPos = view.find(q, endPos + 1);
-        } else {
-          // no backslash before " , the string has definitely ended
+      // Scan for the first character of the quote or a backslash at once, and
+      // skip the escaped characters.
+      auto findQuoteOrBackslash = [&view, isDouble = q[0] == '"'](size_t pos) {
+        return isDouble ? ad_utility::findFirstOf<'"', '\\'>(view, pos)
+                        : ad_utility::findFirstOf<'\'', '\\'>(view, pos);
+      };
+      endPos = startPos;
+      while (true) {
+        endPos = findQuoteOrBackslash(endPos);
+        if (endPos == string::npos) {
+          break;
+        }
+        if (view[endPos] == '\\') {
+          endPos += 2;
+        } else if (view.substr(endPos).starts_with(q)) {
           break;
+        } else {
+          ++endPos;
         }
       }
       break;
@@ -637,7 +639,7 @@ bool TurtleParser<T>::iriref() {
     tok_.skipWhitespaceAndComments();
     auto view = tok_.view();
     if (view.starts_with('<')) {
-      auto endPos = view.find_first_of("> \n");
+      auto endPos = ad_utility::findFirstOf<'>', ' ', '\n'>(view);
       if (endPos == string::npos || view[endPos] != '>') {
         raise("Parsing IRI ref (IRI without prefix) failed");
       } else {
@@ -714,8 +716,7 @@ bool TurtleStreamParser<T>::resetStateAndRead(
 template <class T>
 void TurtleStreamParser<T>::initialize(const string& filename) {
   this->clear();
-  fileBuffer_ = std::make_unique<ParallelFileBuffer>(bufferSize_);
-  fileBuffer_->open(filename);
+  fileBuffer_ = openParallelFileBuffer(bufferSize_, filename);
   byteVec_.resize(bufferSize_);
   // decompress the first block and initialize Tokenizer
   if (auto res = fileBuffer_->getNextBlock(); res) {
@@ -820,58 +821,81 @@ bool TurtleStreamParser<T>::getLine(TurtleTriple* triple) {
   return true;
 }
 
-// We will use the  following trick: For a batch that is forwarded to the
-// parallel parser, we will first increment `numBatchesTotal_` and then call
-// the following lambda after the batch has completely been parsed and the
-// result pushed to the `tripleCollector_`. We thus get the invariant that
-// `batchIdx_
-// == numBatchesTotal_` iff all batches that have been inserted to the
-// `parallelParser_` have been fully processed. After the last batch we will
-// push another call to this lambda to the `parallelParser_` which will then
-// finish the `tripleCollector_` as soon as all batches have been computed.
+// The parallel parser splits the input into batches (see `fileBuffer_`), which
+// typically end after a complete statement, and parses them speculatively in
+// parallel: each batch is parsed under the assumption that it starts at the
+// beginning of a statement and with the prefixes that are guessed by
+// `guessPrefixesAfterBatch` (see `feedBatchesToParser`). The guesses are
+// validated when the batches are stitched in the order of the input (see
+// `stitchNextBatch`), and the rare batch with a wrong guess (for example after
+// a multiline literal that contains `.` followed by a newline) is parsed again.
 template <typename Tokenizer_T>
-void TurtleParallelParser<Tokenizer_T>::finishTripleCollectorIfLastBatch() {
-  if (batchIdx_.fetch_add(1) == numBatchesTotal_) {
-    tripleCollector_.finish();
-  }
+auto TurtleParallelParser<Tokenizer_T>::parseBatch(
+    size_t parsePosition, ParallelBuffer::BufferType batch, PrefixMap prefixMap)
+    -> SpeculativeBatch {
+  SpeculativeBatch result;
+  result.parsePosition_ = parsePosition;
+  result.guessedPrefixMap_ = prefixMap;
+  TurtleStringParser<Tokenizer_T> parser;
+  parser.setPrefixMap(std::move(prefixMap));
+  parser.setPositionOffset(parsePosition);
+  parser.setInputStream(std::move(batch));
+  result.exception_ = parser.parseCompleteStatements();
+  result.triples_ = parser.releaseTriples();
+  result.prefixMapAtEnd_ = parser.getPrefixMap();
+  auto numUnparsedBytes = parser.getUnparsedRemainder().size();
+  result.input_ = parser.releaseInputStream();
+  result.numParsedBytes_ = result.input_.size() - numUnparsedBytes;
+  return result;
 }
 
-// __________________________________________________________________________________
+// The prefixes at the beginning of a batch are guessed by applying the prefix
+// and base declarations of the previous batches to the prefixes at the
+// beginning of the input. To make this fast, only the lines that start with `@`
+// (`@prefix` or `@base`) or with `PREFIX` or `BASE` (case-insensitive) are
+// parsed. This might miss declarations (for example when they span several
+// lines) or find declarations that are none (for example in a multiline
+// literal), both of which are detected when the batches are stitched.
 template <typename Tokenizer_T>
-void TurtleParallelParser<Tokenizer_T>::parseBatch(size_t parsePosition,
-                                                   auto batch) {
-  try {
+void TurtleParallelParser<Tokenizer_T>::guessPrefixesAfterBatch(
+    std::string_view batch, PrefixMap& prefixMap) {
+  while (!batch.empty()) {
+    auto endOfLine = std::min(batch.find('\n'), batch.size());
+    auto line = batch.substr(0, endOfLine);
+    batch.remove_prefix(std::min(endOfLine + 1, batch.size()));
+    line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+    if (!line.starts_with('@') && !absl::StartsWithIgnoreCase(line, "prefix") &&
+        !absl::StartsWithIgnoreCase(line, "base")) {
+      continue;
+    }
     TurtleStringParser<Tokenizer_T> parser;
-    parser.prefixMap_ = this->prefixMap_;
-    parser.setPositionOffset(parsePosition);
-    parser.setInputStream(std::move(batch));
-    // TODO: raise error message if a prefix parsing fails;
-    std::vector<TurtleTriple> triples = parser.parseAndReturnAllTriples();
-
-    tripleCollector_.push([triples = std::move(triples), this]() mutable {
-      triples_ = std::move(triples);
-    });
-    finishTripleCollectorIfLastBatch();
-  } catch (std::exception& e) {
-    tripleCollector_.pushException(std::current_exception());
-    parallelParser_.finish();
+    parser.setPrefixMap(prefixMap);
+    parser.setInputStream(std::string{line});
+    try {
+      if (parser.parseDirectiveManually()) {
+        prefixMap = parser.getPrefixMap();
+      }
+    } catch (const typename TurtleParser<Tokenizer_T>::ParseException&) {
+      // Not a valid declaration, which is fine for a guess.
+    }
   }
-};
+}
 
 // _______________________________________________________________________
 template <typename Tokenizer_T>
 void TurtleParallelParser<Tokenizer_T>::feedBatchesToParser(
-    auto remainingBatchFromInitialization) {
+    ParallelBuffer::BufferType remainingBatchFromInitialization,
+    PrefixMap prefixMap) {
   bool first = true;
   size_t parsePosition = 0;
   auto cleanup =
       ad_utility::makeOnDestructionDontThrowDuringStackUnwinding([this] {
-        // Wait until everything has been parsed and then also finish the
-        // triple collector.
-        parallelParser_.push([this] { finishTripleCollectorIfLastBatch(); });
+        // All the results have been pushed to the `tripleCollector_`, the
+        // remaining batches are still parsed.
+        tripleCollector_.finish();
         parallelParser_.finish();
       });
-  decltype(remainingBatchFromInitialization) inputBatch;
+  ParallelBuffer::BufferType inputBatch;
   try {
     while (true) {
       if (first) {
@@ -885,16 +909,28 @@ void TurtleParallelParser<Tokenizer_T>::feedBatchesToParser(
         inputBatch = std::move(nextOptional.value());
       }
       auto batchSize = inputBatch.size();
-      auto parseThisBatch = [this, parsePosition,
-                             batch = std::move(inputBatch)]() mutable {
-        return parseBatch(parsePosition, std::move(batch));
+      auto guessedPrefixMap = prefixMap;
+      guessPrefixesAfterBatch({inputBatch.data(), inputBatch.size()},
+                              prefixMap);
+      auto promise = std::make_shared<std::promise<SpeculativeBatch>>();
+      auto result = promise->get_future();
+      auto parseThisBatch = [parsePosition, promise,
+                             batch = std::move(inputBatch),
+                             guessedPrefixMap =
+                                 std::move(guessedPrefixMap)]() mutable {
+        try {
+          promise->set_value(parseBatch(parsePosition, std::move(batch),
+                                        std::move(guessedPrefixMap)));
+        } catch (...) {
+          promise->set_exception(std::current_exception());
+        }
       };
       parsePosition += batchSize;
-      numBatchesTotal_.fetch_add(1);
       if (sleepTimeForTesting_ > 0ms) {
         std::this_thread::sleep_for(sleepTimeForTesting_);
       }
-      bool stillActive = parallelParser_.push(parseThisBatch);
+      bool stillActive = parallelParser_.push(std::move(parseThisBatch)) &&
+                         tripleCollector_.push(std::move(result));
       if (!stillActive) {
         return;
       }
@@ -924,9 +960,10 @@ void TurtleParallelParser<Tokenizer_T>::initialize(const string& filename) {
                       std::back_inserter(remainingBatchFromInitialization));
   }
 
-  auto feedBatches = [this, firstBatch = std::move(
-                                remainingBatchFromInitialization)]() mutable {
-    return feedBatchesToParser(std::move(firstBatch));
+  auto feedBatches = [this,
+                      firstBatch = std::move(remainingBatchFromInitialization),
+                      prefixMap = this->prefixMap_]() mutable {
+    return feedBatchesToParser(std::move(firstBatch), std::move(prefixMap));
   };
 
   parseFuture_ = std::async(std::launch::async, feedBatches);
@@ -940,13 +977,10 @@ bool TurtleParallelParser<T>::getLine(TurtleTriple* triple) {
   // contains no triples. (Theoretically this might happen, and it is safer this
   // way)
   while (triples_.empty()) {
-    auto optionalTripleTask = tripleCollector_.pop();
-    if (!optionalTripleTask) {
+    if (!stitchNextBatch()) {
       // Everything has been parsed
       return false;
     }
-    // OptionalTripleTask fills the triples_ vector
-    (*optionalTripleTask)();
   }
 
   // we now have at least one triple, return it.
@@ -961,17 +995,52 @@ std::optional<std::vector<TurtleTriple>> TurtleParallelParser<T>::getBatch() {
   // we need a while in case there is a batch that contains no triples
   // (this should be rare, // TODO warn about this
   while (triples_.empty()) {
-    auto optionalTripleTask = tripleCollector_.pop();
-    if (!optionalTripleTask) {
+    if (!stitchNextBatch()) {
       // everything has been parsed
       return std::nullopt;
     }
-    (*optionalTripleTask)();
   }
 
   return std::move(triples_);
 }
 
+// The guesses for a batch (see `parseBatch`) are correct iff the previous
+// batches ended after a complete statement and their prefixes at the end are
+// the guessed ones. Otherwise, the batch is parsed again together with the
+// unparsed remainder of the previous batches and with the correct prefixes.
+// If the remainder can't be parsed until the end of the input (or grows too
+// large), the input is invalid, and the exception that stopped its parsing is
+// rethrown.
+template <typename T>
+bool TurtleParallelParser<T>::stitchNextBatch() {
+  auto nextBatch = tripleCollector_.pop();
+  if (!nextBatch.has_value()) {
+    if (!unparsedRemainder_.empty()) {
+      std::rethrow_exception(exceptionForUnparsedRemainder_);
+    }
+    return false;
+  }
+  SpeculativeBatch batch = nextBatch.value().get();
+  if (!unparsedRemainder_.empty() ||
+      batch.guessedPrefixMap_ != this->prefixMap_) {
+    ++numReparsedBatches_;
+    auto input = std::move(unparsedRemainder_);
+    input.insert(input.end(), batch.input_.begin(), batch.input_.end());
+    batch = parseBatch(positionOfUnparsedRemainder_, std::move(input),
+                       this->prefixMap_);
+  }
+  this->prefixMap_ = std::move(batch.prefixMapAtEnd_);
+  unparsedRemainder_.assign(batch.input_.begin() + batch.numParsedBytes_,
+                            batch.input_.end());
+  positionOfUnparsedRemainder_ = batch.parsePosition_ + batch.numParsedBytes_;
+  exceptionForUnparsedRemainder_ = std::move(batch.exception_);
+  if (unparsedRemainder_.size() > BZIP2_MAX_TOTAL_BUFFER_SIZE) {
+    std::rethrow_exception(exceptionForUnparsedRemainder_);
+  }
+  triples_ = std::move(batch.triples_);
+  return true;
+}
+
 // __________________________________________________________
 template <typename T>
 TurtleParallelParser<T>::~TurtleParallelParser() {
@@ -991,3 +1060,87 @@ template class TurtleStreamParser<Tokenizer>;
 template class TurtleStreamParser<TokenizerCtre>;
 template class TurtleParallelParser<Tokenizer>;
 template class TurtleParallelParser<TokenizerCtre>;
+
+// _____________________________________________________________________________
+MultiFileTurtleParser::MultiFileTurtleParser(std::vector<std::string> filenames,
+                                             ParserFactory makeParser,
+                                             size_t numFilesInParallel)
+    : filenames_{std::move(filenames)},
+      makeParser_{std::move(makeParser)},
+      numFilesInParallel_{std::max(
+          size_t{1}, std::min(numFilesInParallel, filenames_.size()))} {
+  LOG(DEBUG) << "Initialize the parsing of " << filenames_.size()
+             << " files, " << numFilesInParallel_ << " of them concurrently"
+             << std::endl;
+}
+
+// _____________________________________________________________________________
+MultiFileTurtleParser::~MultiFileTurtleParser() {
+  // The threads are joined by the destructors of the `threads_`.
+  batchQueue_.finish();
+}
+
+// _____________________________________________________________________________
+void MultiFileTurtleParser::startParsing() {
+  if (!threads_.empty()) {
+    return;
+  }
+  if (filenames_.empty()) {
+    batchQueue_.finish();
+    return;
+  }
+  numUnfinishedThreads_ = static_cast<int64_t>(numFilesInParallel_);
+  auto parseFiles = [this]() {
+    try {
+      bool queueIsActive = true;
+      while (queueIsActive) {
+        size_t fileIdx = nextFile_.fetch_add(1);
+        if (fileIdx >= filenames_.size()) {
+          break;
+        }
+        LOG(INFO) << "Parsing input file " << filenames_[fileIdx] << " ..."
+                  << std::endl;
+        auto parser = makeParser_(filenames_[fileIdx]);
+        parser->integerOverflowBehavior() = integerOverflowBehavior();
+        parser->invalidLiteralsAreSkipped() = invalidLiteralsAreSkipped();
+        while (auto batch = parser->getBatch()) {
+          queueIsActive = batchQueue_.push(std::move(batch.value()));
+          if (!queueIsActive) {
+            break;
+          }
+        }
+      }
+    } catch (...) {
+      batchQueue_.pushException(std::current_exception());
+    }
+    if (--numUnfinishedThreads_ == 0) {
+      batchQueue_.finish();
+    }
+  };
+  for (size_t i = 0; i < numFilesInParallel_; ++i) {
+    threads_.emplace_back(parseFiles);
+  }
+}
+
+// _____________________________________________________________________________
+bool MultiFileTurtleParser::getLine(TurtleTriple* triple) {
+  while (triples_.empty()) {
+    auto batch = getBatch();
+    if (!batch.has_value()) {
+      return false;
+    }
+    triples_ = std::move(batch.value());
+  }
+  *triple = std::move(triples_.back());
+  triples_.pop_back();
+  return true;
+}
+
+// _____________________________________________________________________________
+std::optional<std::vector<TurtleTriple>> MultiFileTurtleParser::getBatch() {
+  startParsing();
+  if (!triples_.empty()) {
+    return std::exchange(triples_, {});
+  }
+  return batchQueue_.pop();
+}
@@ -6,6 +6,7 @@
 
 #include <codecvt>
 #include <exception>
+#include <functional>
 #include <future>
 #include <locale>
 #include <string_view>
@@ -28,6 +29,7 @@
 #include "util/ParseException.h"
 #include "util/TaskQueue.h"
 #include "util/ThreadSafeQueue.h"
+#include "util/jthread.h"
 
 using std::string;
 
@@ -422,6 +424,47 @@ class TurtleStringParser : public TurtleParser<Tokenizer_T> {
     return std::move(this->triples_);
   }
 
+  // Parse the statements at the beginning of the input until the input is
+  // exhausted or a statement can't be parsed, either because the input ends in
+  // the middle of the statement or because the input is invalid. Only the
+  // triples of the complete statements are kept, and the first incomplete
+  // statement and all following bytes remain unparsed (see
+  // `getUnparsedRemainder()`). Return the exception that stopped the parsing
+  // (`nullptr` if the input was parsed completely).
+  std::exception_ptr parseCompleteStatements() {
+    auto& tok = this->tok_;
+    std::string_view beginOfStatement;
+    size_t numTriples = 0;
+    try {
+      while (true) {
+        tok.skipWhitespaceAndComments();
+        beginOfStatement = tok.view();
+        numTriples = this->triples_.size();
+        if (beginOfStatement.empty()) {
+          return nullptr;
+        }
+        if (!this->statement()) {
+          this->raise("Parsing failed before end of input");
+        }
+      }
+    } catch (const typename TurtleParser<Tokenizer_T>::ParseException&) {
+      this->triples_.resize(numTriples);
+      tok.reset(beginOfStatement.data(), beginOfStatement.size());
+      return std::current_exception();
+    }
+  }
+
+  // Move the triples that have been parsed so far out of the parser.
+  std::vector<TurtleTriple> releaseTriples() {
+    return std::move(this->triples_);
+  }
+
+  // Move the complete input out of the parser, which must not be used for
+  // parsing afterwards.
+  ParallelBuffer::BufferType releaseInputStream() {
+    return std::move(tmpToParse_);
+  }
+
   // Parse only a single object.
   static TripleComponent parseTripleObject(std::string_view objectString) {
     TurtleStringParser parser;
@@ -487,8 +530,9 @@ class TurtleStringParser : public TurtleParser<Tokenizer_T> {
 
 /**
  * This class is a TurtleParser that always assumes that
- * its input file is an uncompressed .ttl file that will be read in
- * chunks. Input file can also be a stream like stdin.
+ * its input file is a .ttl file that will be read in chunks. Input file
+ * can also be a stream like stdin. Files with the suffix `.gz`, `.bz2`, or
+ * `.zst` are decompressed (see `openParallelFileBuffer`).
  */
 template <class Tokenizer_T>
 class TurtleStreamParser : public TurtleParser<Tokenizer_T> {
@@ -556,8 +600,9 @@ class TurtleStreamParser : public TurtleParser<Tokenizer_T> {
 
 /**
  * This class is a TurtleParser that always assumes that
- * its input file is an uncompressed .ttl file that will be read in
- * chunks. Input file can also be a stream like stdin.
+ * its input file is a .ttl file that will be read in chunks. Input file
+ * can also be a stream like stdin. Files with the suffix `.gz`, `.bz2`, or
+ * `.zst` are decompressed (see `openParallelFileBuffer`).
  */
 template <class Tokenizer_T>
 class TurtleParallelParser : public TurtleParser<Tokenizer_T> {
@@ -589,7 +634,10 @@ class TurtleParallelParser : public TurtleParser<Tokenizer_T> {
 
   void printAndResetQueueStatistics() override {
     LOG(TIMING) << parallelParser_.getTimeStatistics() << '\n';
+    LOG(TIMING) << "Number of batches that were parsed again: "
+                << numReparsedBatches_ << '\n';
     parallelParser_.resetTimers();
+    numReparsedBatches_ = 0;
   }
 
   void initialize(const string& filename);
@@ -606,15 +654,44 @@ class TurtleParallelParser : public TurtleParser<Tokenizer_T> {
   ~TurtleParallelParser() override;
 
  private:
-  // The documentation for this is in the `.cpp` file, because it closely
-  // interacts with the functions next to it.
-  void finishTripleCollectorIfLastBatch();
-  // Parse the single `batch` and push the result to the `triplesCollector_`.
-  void parseBatch(size_t parsePosition, auto batch);
+  using PrefixMap = ad_utility::HashMap<std::string, std::string>;
+
+  // The result of parsing a batch under the assumption that the batch starts
+  // at the beginning of a statement and that the prefixes at its beginning are
+  // the `guessedPrefixMap_`. This guess is validated when the batch is stitched
+  // to the previous batches (see `stitchNextBatch`).
+  struct SpeculativeBatch {
+    size_t parsePosition_ = 0;
+    ParallelBuffer::BufferType input_;
+    PrefixMap guessedPrefixMap_;
+    // The triples of the complete statements at the beginning of the `input_`,
+    // which consist of the first `numParsedBytes_` bytes.
+    std::vector<TurtleTriple> triples_;
+    size_t numParsedBytes_ = 0;
+    // The exception that stopped the parsing of the remaining bytes.
+    std::exception_ptr exception_;
+    PrefixMap prefixMapAtEnd_;
+  };
+
+  // Parse the complete statements at the beginning of the `batch` that starts
+  // at the `parsePosition` of the input, with the given `prefixMap`.
+  static SpeculativeBatch parseBatch(size_t parsePosition,
+                                     ParallelBuffer::BufferType batch,
+                                     PrefixMap prefixMap);
+  // Apply the prefix and base declarations in the `batch` to the `prefixMap`.
+  // The documentation for this is in the `.cpp` file.
+  static void guessPrefixesAfterBatch(std::string_view batch,
+                                      PrefixMap& prefixMap);
   // Read all the batches from the file and feed them to the parallel parser
-  // threads. The argument is the first batch which might have been leftover
-  // from the initialization phase where the prefixes are parsed.
-  void feedBatchesToParser(auto remainingBatchFromInitialization);
+  // threads. The first argument is the first batch which might have been
+  // leftover from the initialization phase where the prefixes are parsed, the
+  // second argument are these prefixes.
+  void feedBatchesToParser(
+      ParallelBuffer::BufferType remainingBatchFromInitialization,
+      PrefixMap prefixMap);
+  // Stitch the next batch to the previous ones and store its triples in the
+  // `triples_`. Return false if there are no more batches.
+  bool stitchNextBatch();
 
   using TurtleParser<Tokenizer_T>::tok_;
   using TurtleParser<Tokenizer_T>::triples_;
@@ -626,17 +703,73 @@ class TurtleParallelParser : public TurtleParser<Tokenizer_T> {
 
   ParallelBufferWithEndRegex fileBuffer_{bufferSize_, "\\.[\\t ]*([\\r\\n]+)"};
 
-  ad_utility::data_structures::ThreadSafeQueue<std::function<void()>>
+  // The results of the parallel parsing of the batches, in the order of the
+  // input.
+  ad_utility::data_structures::ThreadSafeQueue<std::future<SpeculativeBatch>>
       tripleCollector_{QUEUE_SIZE_AFTER_PARALLEL_PARSING};
   ad_utility::TaskQueue<true> parallelParser_{
       QUEUE_SIZE_BEFORE_PARALLEL_PARSING, NUM_PARALLEL_PARSER_THREADS,
       "parallel parser"};
   std::future<void> parseFuture_;
-  // The parallel parsers need to know when the last batch has been parsed, s.t.
-  // the parser threads can be destroyed. The following two members are needed
-  // for keeping track of this condition.
-  std::atomic<size_t> batchIdx_ = 0;
-  std::atomic<size_t> numBatchesTotal_ = 0;
+
+  // The bytes at the end of the batches that have been stitched so far that
+  // could not be parsed (typically a statement that continues in the next
+  // batch), their position in the input, and the exception that stopped their
+  // parsing.
+  ParallelBuffer::BufferType unparsedRemainder_;
+  size_t positionOfUnparsedRemainder_ = 0;
+  std::exception_ptr exceptionForUnparsedRemainder_;
+  // The number of batches for which the speculative parsing failed.
+  size_t numReparsedBatches_ = 0;
 
   std::chrono::milliseconds sleepTimeForTesting_;
 };
+
+// A parser for the triples of several input files. Each file is parsed by its
+// own parser (which is created by the `ParserFactory`), so the prefixes that
+// are declared in one file only apply to this file, and the anonymous blank
+// nodes of different files are distinct. Up to `numFilesInParallel` files are
+// parsed concurrently, and the batches of triples of all the files are returned
+// in an unspecified order. The parsing starts with the first call to `getLine`
+// or `getBatch`, s.t. the settings of the parser (e.g. the
+// `integerOverflowBehavior`) can be set after the construction and are then
+// passed to the parsers of the single files.
+class MultiFileTurtleParser : public TurtleParserBase {
+ public:
+  using ParserFactory =
+      std::function<std::unique_ptr<TurtleParserBase>(const std::string&)>;
+
+ private:
+  std::vector<std::string> filenames_;
+  ParserFactory makeParser_;
+  size_t numFilesInParallel_;
+  // The index of the next file in the `filenames_` that is to be parsed.
+  std::atomic<size_t> nextFile_ = 0;
+  std::atomic<int64_t> numUnfinishedThreads_ = 0;
+  ad_utility::data_structures::ThreadSafeQueue<std::vector<TurtleTriple>>
+      batchQueue_{QUEUE_SIZE_AFTER_PARALLEL_PARSING};
+  std::vector<ad_utility::JThread> threads_;
+  // The current batch, from which the triples for `getLine` are taken.
+  std::vector<TurtleTriple> triples_;
+
+ public:
+  MultiFileTurtleParser(std::vector<std::string> filenames,
+                        ParserFactory makeParser, size_t numFilesInParallel);
+
+  // Finish the queue and wait for the threads (also if they are still
+  // parsing, e.g. when an exception occurred in the code that uses the parser).
+  ~MultiFileTurtleParser() override;
+
+  using TurtleParserBase::getLine;
+  bool getLine(TurtleTriple* triple) override;
+
+  std::optional<std::vector<TurtleTriple>> getBatch() override;
+
+  // The triples of different files are interleaved, so there is no meaningful
+  // position.
+  size_t getParsePosition() const override { return 0; }
+
+ private:
+  // Start the threads that parse the files, if this has not happened yet.
+  void startParsing();
+};
@@ -35,20 +35,8 @@ Variable::Variable(std::string name) : _name{std::move(name)} {
   if (variableColumns.contains(*this)) {
     size_t index = variableColumns.at(*this).columnIndex_;
     auto id = idTable(row, index);
-    auto optionalStringAndType = ExportQueryExecutionTrees::idToStringAndType(
-        qecIndex, id, res.localVocab());
-    if (!optionalStringAndType.has_value()) {
-      return std::nullopt;
-    }
-    auto& [literal, type] = optionalStringAndType.value();
-    const char* i = XSD_INT_TYPE;
-    const char* d = XSD_DECIMAL_TYPE;
-    const char* b = XSD_BOOLEAN_TYPE;
-    if (type == nullptr || type == i || type == d || type == b) {
-      return std::move(literal);
-    } else {
-      return absl::StrCat("\"", literal, "\"^^<", type, ">");
-    }
+    return ExportQueryExecutionTrees::idToConstructString(qecIndex, id,
+                                                          res.localVocab());
   }
   return std::nullopt;
 }
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "absl/strings/str_join.h"
+#include "engine/sparqlExpressions/ApproxCountDistinctExpression.h"
 #include "engine/sparqlExpressions/LangExpression.h"
 #include "engine/sparqlExpressions/RandomExpression.h"
 #include "engine/sparqlExpressions/RegexExpression.h"
@@ -122,6 +123,13 @@ ExpressionPtr Visitor::processIriFunctionCall(
       checkNumArgs(1);
       return sparqlExpression::makeTanExpression(std::move(argList[0]));
     }
+  } else if (checkPrefix(QL_PREFIX)) {
+    if (functionName == "approx-count-distinct") {
+      checkNumArgs(1);
+      return std::make_unique<
+          sparqlExpression::ApproxCountDistinctExpression>(
+          std::move(argList[0]));
+    }
   }
   reportNotSupported(ctx, "Function \"" + iri + "\" is");
 }
@@ -365,8 +373,15 @@ Visitor::OperationsAndFilters Visitor::visit(
   auto filter = [&filters](SparqlFilter filter) {
     filters.emplace_back(std::move(filter));
   };
-  auto op = [&ops](GraphPatternOperation op) {
-    ops.emplace_back(std::move(op));
+  // Like all filters, a `FILTER (NOT) EXISTS` applies to the complete graph
+  // pattern, so it is evaluated after all the other graph patterns.
+  vector<GraphPatternOperation> existsFilters;
+  auto op = [&ops, &existsFilters](GraphPatternOperation op) {
+    if (std::holds_alternative<parsedQuery::ExistsFilter>(op)) {
+      existsFilters.emplace_back(std::move(op));
+    } else {
+      ops.emplace_back(std::move(op));
+    }
   };
 
   if (ctx->triplesBlock()) {
@@ -387,6 +402,12 @@ Visitor::OperationsAndFilters Visitor::visit(
     std::get<BasicGraphPattern>(ops.back())
         .appendTriples(std::move(triples.value()));
   }
+  if (ops.empty() && !existsFilters.empty()) {
+    reportNotSupported(ctx,
+                       "FILTER EXISTS or FILTER NOT EXISTS in a graph pattern "
+                       "without other graph patterns is");
+  }
+  std::ranges::move(existsFilters, std::back_inserter(ops));
   return {std::move(ops), std::move(filters)};
 }
 
@@ -463,12 +484,49 @@ BasicGraphPattern Visitor::visit(Parser::TriplesBlockContext* ctx) {
 // ____________________________________________________________________________________
 Visitor::OperationOrFilter Visitor::visit(
     Parser::GraphPatternNotTriplesContext* ctx) {
+  if (auto* filter = ctx->filterR();
+      filter && filter->constraint()->builtInCall()) {
+    auto* builtInCall = filter->constraint()->builtInCall();
+    if (builtInCall->existsFunc()) {
+      return visitExistsFilter(builtInCall->existsFunc()->groupGraphPattern(),
+                               false);
+    }
+    if (builtInCall->notExistsFunc()) {
+      return visitExistsFilter(
+          builtInCall->notExistsFunc()->groupGraphPattern(), true);
+    }
+  }
   return visitAlternative<std::variant<GraphPatternOperation, SparqlFilter>>(
       ctx->filterR(), ctx->optionalGraphPattern(), ctx->minusGraphPattern(),
       ctx->bind(), ctx->inlineData(), ctx->groupOrUnionGraphPattern(),
       ctx->graphGraphPattern(), ctx->serviceGraphPattern());
 }
 
+// ____________________________________________________________________________________
+GraphPatternOperation Visitor::visitExistsFilter(
+    Parser::GroupGraphPatternContext* ctx, bool isNegated) {
+  size_t numVisibleVariables = visibleVariables_.size();
+  auto pattern = visit(ctx);
+  std::vector<Variable> innerVariables(
+      visibleVariables_.begin() + numVisibleVariables, visibleVariables_.end());
+  visibleVariables_.resize(numVisibleVariables);
+  // The semi-join and the anti-join only compare the variables that are bound
+  // by the pattern, so a filter in the pattern cannot refer to the variables
+  // outside of it.
+  for (const auto& filter : pattern._filters) {
+    for (const Variable* variable : filter.expression_.containedVariables()) {
+      if (!ad_utility::contains(innerVariables, *variable)) {
+        reportNotSupported(
+            ctx,
+            "A FILTER inside of EXISTS or NOT EXISTS that uses a variable "
+            "that is not bound inside of it is");
+      }
+    }
+  }
+  return GraphPatternOperation{
+      parsedQuery::ExistsFilter{std::move(pattern), isNegated}};
+}
+
 // ____________________________________________________________________________________
 GraphPatternOperation Visitor::visit(Parser::OptionalGraphPatternContext* ctx) {
   auto pattern = visit(ctx->groupGraphPattern());
@@ -1770,12 +1828,16 @@ SparqlExpression::Ptr Visitor::visit(Parser::StrReplaceExpressionContext* ctx) {
 
 // ____________________________________________________________________________________
 void Visitor::visit(const Parser::ExistsFuncContext* ctx) {
-  reportNotSupported(ctx, "The EXISTS function is");
+  reportNotSupported(ctx,
+                     "The EXISTS function (except for FILTER EXISTS directly "
+                     "in a graph pattern) is");
 }
 
 // ____________________________________________________________________________________
 void Visitor::visit(const Parser::NotExistsFuncContext* ctx) {
-  reportNotSupported(ctx, "The NOT EXISTS function is");
+  reportNotSupported(ctx,
+                     "The NOT EXISTS function (except for FILTER NOT EXISTS "
+                     "directly in a graph pattern) is");
 }
 
 // ____________________________________________________________________________________
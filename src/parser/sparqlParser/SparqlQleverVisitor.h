@@ -192,10 +192,19 @@ class SparqlQleverVisitor {
       Parser::TriplesBlockContext* graphTerm);
 
   // Filter clauses are no independent graph patterns themselves, but their
-  // scope is always the complete graph pattern enclosing them.
+  // scope is always the complete graph pattern enclosing them. A
+  // `FILTER EXISTS` or `FILTER NOT EXISTS` is returned as an `ExistsFilter`
+  // (see `visitExistsFilter`).
   [[nodiscard]] OperationOrFilter visit(
       Parser::GraphPatternNotTriplesContext* ctx);
 
+  // Visit the graph pattern `ctx` of a `FILTER EXISTS` (or `FILTER NOT EXISTS`
+  // if `isNegated`), which is evaluated as a semi-join (or anti-join) with the
+  // rest of the enclosing graph pattern. The variables of the pattern are not
+  // visible outside of it.
+  [[nodiscard]] parsedQuery::GraphPatternOperation visitExistsFilter(
+      Parser::GroupGraphPatternContext* ctx, bool isNegated);
+
   [[nodiscard]] parsedQuery::GraphPatternOperation visit(
       Parser::OptionalGraphPatternContext* ctx);
 
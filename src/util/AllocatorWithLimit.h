@@ -7,11 +7,17 @@
 
 #include <absl/strings/str_cat.h>
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <string_view>
 
+#include "util/CachingMemoryResource.h"
+#include "util/HugePages.h"
 #include "util/MemorySize/MemorySize.h"
+#include "util/OperationStatistics.h"
+#include "util/Probes.h"
 #include "util/Synchronized.h"
 
 namespace ad_utility {
@@ -22,12 +28,13 @@ namespace detail {
 // specified as a limit
 class AllocationExceedsLimitException : public std::exception {
  public:
-  AllocationExceedsLimitException(MemorySize requestedMemory,
-                                  MemorySize freeMemory)
+  AllocationExceedsLimitException(
+      MemorySize requestedMemory, MemorySize freeMemory,
+      std::string_view advice =
+          "Clear the cache or allow more memory for QLever during startup")
       : _message{absl::StrCat("Tried to allocate ", requestedMemory.asString(),
                               ", but only ", freeMemory.asString(),
-                              " were available. Clear the cache or allow more "
-                              "memory for QLever during startup")} {};
+                              " were available. ", advice)} {};
 
   const char* what() const noexcept override { return _message.c_str(); }
 
@@ -41,32 +48,84 @@ class AllocationExceedsLimitException : public std::exception {
 // objects at the same time (hence the wrapper class and the synchronization
 // below).
 class AllocationMemoryLeft {
-  // Remaining free memory.
-  MemorySize free_;
+  // The limit and the memory that is currently allocated, the remaining free
+  // memory is the difference.
+  MemorySize limit_;
+  MemorySize used_;
+  // The maximum of `used_` so far.
+  MemorySize peak_;
+  // If set, all allocations are also charged to the `parent_`, which limits
+  // the total memory of all its children (see
+  // `makeChildAllocationMemoryLeftThreadsafeObject`). The lock of a child is
+  // always acquired before the lock of its parent.
+  std::shared_ptr<ad_utility::Synchronized<AllocationMemoryLeft, SpinLock>>
+      parent_;
+
+  MemorySize ownMemoryLeft() const {
+    return limit_ > used_ ? limit_ - used_ : MemorySize::bytes(0);
+  }
 
  public:
-  AllocationMemoryLeft(MemorySize n) : free_(n) {}
+  AllocationMemoryLeft(
+      MemorySize n,
+      std::shared_ptr<ad_utility::Synchronized<AllocationMemoryLeft, SpinLock>>
+          parent = nullptr)
+      : limit_(n), parent_(std::move(parent)) {}
 
   // Called before memory is allocated.
   bool decrease_if_enough_left_or_return_false(MemorySize n) noexcept {
-    if (n <= free_) {
-      free_ -= n;
-      return true;
-    } else {
+    if (!fitsIntoOwnLimit(n) ||
+        (parent_ &&
+         !parent_->wlock()->decrease_if_enough_left_or_return_false(n))) {
       return false;
     }
+    used_ += n;
+    peak_ = std::max(peak_, used_);
+    return true;
   }
 
   // Called before memory is allocated.
   void decrease_if_enough_left_or_throw(MemorySize n) {
     if (!decrease_if_enough_left_or_return_false(n)) {
-      throw AllocationExceedsLimitException{n, free_};
+      QLEVER_PROBE(allocation_failed, n.getBytes(), ownMemoryLeft().getBytes());
+      if (parent_ && !fitsIntoOwnLimit(n)) {
+        throw AllocationExceedsLimitException{
+            n, ownMemoryLeft(),
+            "This limit is the memory budget of a single query, the memory "
+            "of other queries is not affected"};
+      }
+      throw AllocationExceedsLimitException{n, amountMemoryLeft()};
     }
   }
 
   // Called after memory is deallocated.
-  void increase(MemorySize n) { free_ += n; }
-  [[nodiscard]] MemorySize amountMemoryLeft() const { return free_; }
+  void increase(MemorySize n) {
+    used_ = used_ > n ? used_ - n : MemorySize::bytes(0);
+    if (parent_) {
+      parent_->wlock()->increase(n);
+    }
+  }
+
+  // The free memory, which is also limited by the free memory of the parent.
+  [[nodiscard]] MemorySize amountMemoryLeft() const {
+    if (!parent_) {
+      return ownMemoryLeft();
+    }
+    return std::min(ownMemoryLeft(), parent_->wlock()->amountMemoryLeft());
+  }
+
+  // True iff `n` bytes don't exceed the own limit (ignoring the parent).
+  [[nodiscard]] bool fitsIntoOwnLimit(MemorySize n) const {
+    return n <= ownMemoryLeft();
+  }
+
+  // The memory that is currently allocated, and its maximum so far.
+  [[nodiscard]] MemorySize amountMemoryUsed() const { return used_; }
+  [[nodiscard]] MemorySize peakMemoryUsed() const { return peak_; }
+
+  // Change the limit, which may also be less than the memory that is already
+  // allocated (then nothing is free until enough memory is deallocated).
+  void setLimit(MemorySize limit) { limit_ = limit; }
 };
 
 /*
@@ -101,6 +160,86 @@ makeAllocationMemoryLeftThreadsafeObject(MemorySize n) {
       ad_utility::Synchronized<detail::AllocationMemoryLeft, SpinLock>>(n)};
 }
 
+// Set up a shared allocation state with the given `limit`, the allocations of
+// which are also charged to the `parent`. For example, each query can get its
+// own memory budget, which is a part of the memory of the server: a query that
+// exceeds its budget fails alone, and the memory of all queries together is
+// still limited.
+inline detail::AllocationMemoryLeftThreadsafe
+makeChildAllocationMemoryLeftThreadsafeObject(
+    const detail::AllocationMemoryLeftThreadsafe& parent, MemorySize limit) {
+  return detail::AllocationMemoryLeftThreadsafe{std::make_shared<
+      ad_utility::Synchronized<detail::AllocationMemoryLeft, SpinLock>>(
+      limit, parent.ptr())};
+}
+
+// An arena for the temporary allocations of a single query (see
+// `makeTemporaryAllocator` below). The blocks that are deallocated are not
+// returned to the global heap, but kept in a `CachingMemoryResource`, from
+// which the later allocations of the same size are served. This avoids the
+// contention on the global heap (and its fragmentation) when many queries run
+// concurrently. The accounting stays exact: The cached blocks still count
+// towards the `memoryLeft`, and are only given back when the arena is
+// destroyed (which happens when the last allocator that uses it is destroyed),
+// or when an allocation would otherwise exceed the limit.
+class QueryMemoryArena {
+  detail::AllocationMemoryLeftThreadsafe memoryLeft_;
+  CachingMemoryResource resource_;
+  // The memory that is currently held by the arena (in use or cached), and its
+  // maximum over the lifetime of the arena.
+  std::atomic<size_t> numBytes_ = 0;
+  std::atomic<size_t> peakNumBytes_ = 0;
+
+ public:
+  explicit QueryMemoryArena(detail::AllocationMemoryLeftThreadsafe memoryLeft)
+      : memoryLeft_{std::move(memoryLeft)} {}
+
+  // Return a cached block of the given size and alignment, or `nullptr` if
+  // there is none.
+  void* allocateFromCache(size_t bytes, size_t alignment) {
+    return resource_.allocateFromCache(bytes, alignment);
+  }
+
+  // Allocate a new block, which must already have been accounted for.
+  void* allocateNew(size_t bytes, size_t alignment) {
+    void* block = resource_.allocateNew(bytes, alignment);
+    size_t numBytes = numBytes_ += bytes;
+    size_t peak = peakNumBytes_.load();
+    while (numBytes > peak &&
+           !peakNumBytes_.compare_exchange_weak(peak, numBytes)) {
+    }
+    return block;
+  }
+
+  // Add the block to the cache. It still counts towards the `memoryLeft_`.
+  void deallocate(void* p, size_t bytes, size_t alignment) {
+    resource_.deallocate(p, bytes, alignment);
+  }
+
+  // The total size of the blocks that are currently cached.
+  MemorySize cachedMemory() const {
+    return MemorySize::bytes(resource_.numCachedBytes());
+  }
+
+  // Give the cached blocks back to the global heap and the `memoryLeft_`.
+  void releaseCachedBlocks() {
+    size_t numReleasedBytes = resource_.releaseCachedBlocks();
+    numBytes_ -= numReleasedBytes;
+    memoryLeft_.ptr()->wlock()->increase(MemorySize::bytes(numReleasedBytes));
+  }
+
+  // The maximal memory that the arena held at the same time so far.
+  MemorySize peakMemory() const {
+    return MemorySize::bytes(peakNumBytes_.load());
+  }
+
+  ~QueryMemoryArena() { releaseCachedBlocks(); }
+
+  // The arena is always used via a `shared_ptr` (see `AllocatorWithLimit`).
+  QueryMemoryArena(const QueryMemoryArena&) = delete;
+  QueryMemoryArena& operator=(const QueryMemoryArena&) = delete;
+};
+
 /*
 A lambda for use with `AllocatorWithLimit`.
 
@@ -156,21 +295,26 @@ class AllocatorWithLimit {
       memoryLeft_;                       // shared number of free bytes
   ClearOnAllocation clearOnAllocation_;  // TODO<joka921> comment
   std::allocator<T> allocator_;
+  // If set, the memory is allocated from this arena instead of the global heap
+  // (see `QueryMemoryArena` and `makeTemporaryAllocator`).
+  std::shared_ptr<QueryMemoryArena> arena_;
 
  public:
   /// obtain an AllocationMemoryLeftThreadsafe by calls to
   /// makeAllocationMemoryLeftThreadsafeObject()
   explicit AllocatorWithLimit(
       detail::AllocationMemoryLeftThreadsafe ml,
-      ClearOnAllocation clearOnAllocation = noClearOnAllocation)
+      ClearOnAllocation clearOnAllocation = noClearOnAllocation,
+      std::shared_ptr<QueryMemoryArena> arena = nullptr)
       : memoryLeft_{std::move(ml)},
-        clearOnAllocation_{std::move(clearOnAllocation)} {}
+        clearOnAllocation_{std::move(clearOnAllocation)},
+        arena_{std::move(arena)} {}
 
   /// Obtain an AllocatorWithLimit<OtherType> that refers to the
   /// same limit.
   template <typename U>
   AllocatorWithLimit<U> as() {
-    return AllocatorWithLimit<U>(memoryLeft_);
+    return AllocatorWithLimit<U>(memoryLeft_, noClearOnAllocation, arena_);
   }
   AllocatorWithLimit() = delete;
 
@@ -178,7 +322,8 @@ class AllocatorWithLimit {
   requires(!std::same_as<U, T>)
   AllocatorWithLimit(const AllocatorWithLimit<U>& other)
       : memoryLeft_{other.getMemoryLeft()},
-        clearOnAllocation_(other.clearOnAllocation()){};
+        clearOnAllocation_(other.clearOnAllocation()),
+        arena_{other.arena()} {};
 
   // Defaulted copy operations.
   AllocatorWithLimit(const AllocatorWithLimit&) = default;
@@ -221,23 +366,53 @@ class AllocatorWithLimit {
   // An allocator must have a function "allocate" with exactly this signature.
   // TODO<C++20> : the exact signature of allocate changes
   T* allocate(std::size_t n) {
+    // Count the memory for the operation that is currently computed.
+    OperationStatistics::addAllocation(n * sizeof(T));
+    // A block from the cache of the arena has already been accounted for.
+    if (arena_) {
+      if (void* block = arena_->allocateFromCache(n * sizeof(T), alignof(T))) {
+        return static_cast<T*>(block);
+      }
+    }
     // Subtract the amount of memory we want to allocate from the amount of
     // memory left. This will throw an exception if not enough memory is left.
     const auto bytesNeeded = MemorySize::bytes(n * sizeof(T));
-    const bool wasEnoughLeft =
-        memoryLeft_.ptr()->wlock()->decrease_if_enough_left_or_return_false(
-            bytesNeeded);
+    auto decrease = [this, &bytesNeeded]() {
+      return memoryLeft_.ptr()
+          ->wlock()
+          ->decrease_if_enough_left_or_return_false(bytesNeeded);
+    };
+    bool wasEnoughLeft = decrease();
+    // The blocks in the cache of the arena don't fit, but they count towards
+    // the limit, so first give them back.
+    if (!wasEnoughLeft && arena_) {
+      arena_->releaseCachedBlocks();
+      wasEnoughLeft = decrease();
+    }
     if (!wasEnoughLeft) {
       AD_CORRECTNESS_CHECK(clearOnAllocation_);
       clearOnAllocation_(bytesNeeded);
       memoryLeft_.ptr()->wlock()->decrease_if_enough_left_or_throw(bytesNeeded);
     }
     // the actual allocation
-    return allocator_.allocate(n);
+    T* result =
+        arena_ ? static_cast<T*>(arena_->allocateNew(n * sizeof(T), alignof(T)))
+               : allocator_.allocate(n);
+    // Large blocks (e.g. the columns of large `IdTable`s) are backed by huge
+    // pages if enabled.
+    hugePages::adviseIfLarge(result, n * sizeof(T));
+    return result;
   }
 
   // An allocator must have a function "deallocate" with exactly this signature.
   void deallocate(T* p, std::size_t n) {
+    OperationStatistics::addDeallocation(n * sizeof(T));
+    // The arena keeps the block for later allocations, so it still counts
+    // towards the limit.
+    if (arena_) {
+      arena_->deallocate(p, n * sizeof(T), alignof(T));
+      return;
+    }
     // free the memory
     allocator_.deallocate(p, n);
     // Update the amount of memory left.
@@ -257,13 +432,14 @@ class AllocatorWithLimit {
 
   const auto& getMemoryLeft() const { return memoryLeft_; }
   const auto& clearOnAllocation() const { return clearOnAllocation_; }
+  const auto& arena() const { return arena_; }
 
   // The STL needs two allocators to be equal if and only they refer to the same
   // memory pool. For us, they are hence equal if they use the same
-  // AllocationMemoryLeft object.00
+  // AllocationMemoryLeft object and the same arena (if any).
   template <typename V>
   bool operator==(const AllocatorWithLimit<V>& v) const {
-    return memoryLeft_ == v.memoryLeft_;
+    return memoryLeft_ == v.getMemoryLeft() && arena_ == v.arena();
   }
   template <typename V>
   bool operator!=(const AllocatorWithLimit<V>& v) const {
@@ -283,4 +459,16 @@ AllocatorWithLimit<T> makeUnlimitedAllocator() {
   return makeAllocatorWithLimit<T>(MemorySize::max());
 }
 
+// Return an allocator with the same limit as the `allocator`, which allocates
+// from a new `QueryMemoryArena` (that is shared by all copies of the returned
+// allocator). It must only be used for temporary data that is destroyed at the
+// end of a query, because the arena keeps the deallocated memory until then.
+template <typename T>
+AllocatorWithLimit<T> makeTemporaryAllocator(
+    const AllocatorWithLimit<T>& allocator) {
+  return AllocatorWithLimit<T>{
+      allocator.getMemoryLeft(), allocator.clearOnAllocation(),
+      std::make_shared<QueryMemoryArena>(allocator.getMemoryLeft())};
+}
+
 }  // namespace ad_utility
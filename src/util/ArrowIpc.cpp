@@ -0,0 +1,422 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include "util/ArrowIpc.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <variant>
+
+#include "util/Exception.h"
+
+namespace ad_utility::arrow {
+namespace {
+
+// The constants of the Arrow schema (see `Schema.fbs` and `Message.fbs` in the
+// Arrow repository).
+constexpr int16_t METADATA_VERSION_V5 = 4;
+constexpr uint8_t HEADER_SCHEMA = 1;
+constexpr uint8_t HEADER_DICTIONARY_BATCH = 2;
+constexpr uint8_t HEADER_RECORD_BATCH = 3;
+constexpr uint8_t TYPE_INT = 2;
+constexpr uint8_t TYPE_FLOATING_POINT = 3;
+constexpr uint8_t TYPE_UTF8 = 5;
+constexpr uint8_t TYPE_BOOL = 6;
+constexpr uint8_t TYPE_TIMESTAMP = 10;
+constexpr int16_t PRECISION_DOUBLE = 2;
+constexpr int16_t TIME_UNIT_MILLISECOND = 1;
+constexpr uint32_t CONTINUATION_MARKER = 0xFFFFFFFF;
+
+// Append the bytes of the trivially copyable `value` to the `buffer`.
+template <typename T>
+void appendBytes(std::string& buffer, T value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Append zero bytes to the `buffer` until its size is a multiple of 8.
+void padTo8(std::string& buffer) {
+  buffer.resize((buffer.size() + 7) / 8 * 8, '\0');
+}
+
+// A minimal writer for the FlatBuffers format, which Arrow uses for the
+// metadata of the messages. In contrast to the official builder, the buffer
+// is built from front to back: each table is written before the objects that
+// it refers to (which are then written by the `Child` functions), and the
+// offsets to these objects are patched afterwards. This is allowed by the
+// format, as long as the vtable of a table is written before it and all the
+// scalars are aligned to their size.
+class FlatBufferWriter {
+ public:
+  // Write an object to the buffer and return its position.
+  using Child = std::function<size_t(FlatBufferWriter&)>;
+  // The value of a field of a table, either a scalar or a reference to a
+  // string, vector, or table (a `Child`).
+  using Value = std::variant<uint8_t, int16_t, int32_t, int64_t, Child>;
+  struct TableField {
+    uint16_t id_;
+    Value value_;
+  };
+
+ private:
+  std::string buffer_;
+
+  // Append zero bytes until `size + offset` is a multiple of the `alignment`.
+  void pad(size_t alignment, size_t offset = 0) {
+    while ((buffer_.size() + offset) % alignment != 0) {
+      buffer_.push_back('\0');
+    }
+  }
+
+  // Write the (forward) offset from the `position` to the `target`.
+  void patchOffset(size_t position, size_t target) {
+    AD_CORRECTNESS_CHECK(target > position);
+    auto offset = static_cast<uint32_t>(target - position);
+    std::memcpy(buffer_.data() + position, &offset, sizeof(offset));
+  }
+
+  static size_t sizeOfValue(const Value& value) {
+    return std::visit(
+        []<typename T>(const T&) -> size_t {
+          if constexpr (std::is_same_v<T, Child>) {
+            return sizeof(uint32_t);
+          } else {
+            return sizeof(T);
+          }
+        },
+        value);
+  }
+
+ public:
+  // Write a table with the given `fields` (which can be in any order) and its
+  // vtable.
+  size_t writeTable(std::vector<TableField> fields) {
+    // Larger scalars come first, s.t. all of them are aligned if the table
+    // (which starts with the 4 bytes of the offset to its vtable) is aligned
+    // to 8 bytes.
+    std::ranges::stable_sort(fields, std::ranges::greater{},
+                             [](const TableField& field) {
+                               return sizeOfValue(field.value_);
+                             });
+    size_t numVtableEntries = 0;
+    std::vector<size_t> offsets;
+    size_t tableSize = sizeof(int32_t);
+    for (const auto& field : fields) {
+      size_t size = sizeOfValue(field.value_);
+      tableSize = (tableSize + size - 1) / size * size;
+      offsets.push_back(tableSize);
+      tableSize += size;
+      numVtableEntries =
+          std::max(numVtableEntries, static_cast<size_t>(field.id_) + 1);
+    }
+    std::vector<uint16_t> vtable(numVtableEntries, 0);
+    for (size_t i = 0; i < fields.size(); ++i) {
+      vtable[fields[i].id_] = static_cast<uint16_t>(offsets[i]);
+    }
+
+    pad(sizeof(uint16_t));
+    size_t vtablePosition = buffer_.size();
+    appendBytes(buffer_, static_cast<uint16_t>(4 + 2 * numVtableEntries));
+    appendBytes(buffer_, static_cast<uint16_t>(tableSize));
+    for (uint16_t entry : vtable) {
+      appendBytes(buffer_, entry);
+    }
+    pad(8);
+    size_t tablePosition = buffer_.size();
+    // The vtable lies before the table, so the offset is positive.
+    appendBytes(buffer_,
+                static_cast<int32_t>(tablePosition - vtablePosition));
+    buffer_.resize(tablePosition + tableSize, '\0');
+
+    for (size_t i = 0; i < fields.size(); ++i) {
+      if (auto* value = std::get_if<Child>(&fields[i].value_)) {
+        patchOffset(tablePosition + offsets[i], (*value)(*this));
+      } else {
+        std::visit(
+            [this, position = tablePosition + offsets[i]]<typename T>(
+                const T& scalar) {
+              if constexpr (!std::is_same_v<T, Child>) {
+                std::memcpy(buffer_.data() + position, &scalar, sizeof(T));
+              }
+            },
+            fields[i].value_);
+      }
+    }
+    return tablePosition;
+  }
+
+  // Write a (NUL-terminated) string.
+  size_t writeString(std::string_view string) {
+    pad(sizeof(uint32_t));
+    size_t position = buffer_.size();
+    appendBytes(buffer_, static_cast<uint32_t>(string.size()));
+    buffer_.append(string);
+    buffer_.push_back('\0');
+    return position;
+  }
+
+  // Write a vector of tables.
+  size_t writeVector(const std::vector<Child>& elements) {
+    pad(sizeof(uint32_t));
+    size_t position = buffer_.size();
+    appendBytes(buffer_, static_cast<uint32_t>(elements.size()));
+    buffer_.resize(buffer_.size() + sizeof(uint32_t) * elements.size(), '\0');
+    for (size_t i = 0; i < elements.size(); ++i) {
+      size_t offsetPosition = position + sizeof(uint32_t) * (i + 1);
+      patchOffset(offsetPosition, elements[i](*this));
+    }
+    return position;
+  }
+
+  // Write a vector of structs that consist of two `int64_t`s (the `FieldNode`
+  // and `Buffer` structs of Arrow). The structs are aligned to 8 bytes.
+  size_t writeStructVector(std::span<const std::array<int64_t, 2>> elements) {
+    pad(8, sizeof(uint32_t));
+    size_t position = buffer_.size();
+    appendBytes(buffer_, static_cast<uint32_t>(elements.size()));
+    for (const auto& element : elements) {
+      appendBytes(buffer_, element);
+    }
+    return position;
+  }
+
+  // Write the buffer with the given `root` table.
+  static std::string finish(const Child& root) {
+    FlatBufferWriter writer;
+    appendBytes(writer.buffer_, uint32_t{0});
+    writer.patchOffset(0, root(writer));
+    return std::move(writer.buffer_);
+  }
+};
+
+using Child = FlatBufferWriter::Child;
+
+// Return a `Child` that writes a table with the `fields`.
+Child makeTable(std::vector<FlatBufferWriter::TableField> fields) {
+  return [fields = std::move(fields)](FlatBufferWriter& writer) {
+    return writer.writeTable(fields);
+  };
+}
+
+// Return a `Child` that writes the `string`.
+Child makeString(std::string string) {
+  return [string = std::move(string)](FlatBufferWriter& writer) {
+    return writer.writeString(string);
+  };
+}
+
+// Return a `Child` that writes a vector of the `elements`.
+Child makeVector(std::vector<Child> elements) {
+  return [elements = std::move(elements)](FlatBufferWriter& writer) {
+    return writer.writeVector(elements);
+  };
+}
+
+// Return a `Child` that writes a vector of the structs.
+Child makeStructVector(std::vector<std::array<int64_t, 2>> elements) {
+  return [elements = std::move(elements)](FlatBufferWriter& writer) {
+    return writer.writeStructVector(elements);
+  };
+}
+
+// Return the `Int` type with the given `bitWidth`.
+Child intType(int32_t bitWidth) {
+  return makeTable({{0, bitWidth}, {1, uint8_t{1}}});
+}
+
+// Return the message with the header of the given type, the `header` itself,
+// and the `body`, including the continuation marker and the size of the
+// metadata (see the section "Encapsulated message format" of the Arrow
+// specification). The `body` must already be padded to 8 bytes.
+std::string message(uint8_t headerType, Child header, std::string_view body) {
+  AD_CORRECTNESS_CHECK(body.size() % 8 == 0);
+  std::string metadata = FlatBufferWriter::finish(makeTable({
+      {0, METADATA_VERSION_V5},
+      {1, headerType},
+      {2, std::move(header)},
+      {3, static_cast<int64_t>(body.size())},
+  }));
+  padTo8(metadata);
+  std::string result;
+  result.reserve(2 * sizeof(uint32_t) + metadata.size() + body.size());
+  appendBytes(result, CONTINUATION_MARKER);
+  appendBytes(result, static_cast<int32_t>(metadata.size()));
+  result.append(metadata);
+  result.append(body);
+  return result;
+}
+
+// Return the `RecordBatch` table with `length` rows and the given `nodes`
+// and `buffers`.
+Child recordBatch(size_t length, std::vector<std::array<int64_t, 2>> nodes,
+                  std::vector<std::array<int64_t, 2>> buffers) {
+  return makeTable({{0, static_cast<int64_t>(length)},
+                    {1, makeStructVector(std::move(nodes))},
+                    {2, makeStructVector(std::move(buffers))}});
+}
+
+// Append the `data` to the `body` and its `Buffer` struct (the offset and the
+// size in the body) to the `buffers`.
+void appendBuffer(std::string& body,
+                  std::vector<std::array<int64_t, 2>>& buffers,
+                  std::string_view data) {
+  buffers.push_back({static_cast<int64_t>(body.size()),
+                     static_cast<int64_t>(data.size())});
+  body.append(data);
+  padTo8(body);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void Column::appendValidityBit(bool isValid) {
+  if (length_ % 8 == 0) {
+    validity_.push_back('\0');
+  }
+  if (isValid) {
+    validity_.back() = static_cast<char>(validity_.back() | 1 << length_ % 8);
+  } else {
+    ++nullCount_;
+  }
+  ++length_;
+}
+
+// _____________________________________________________________________________
+void Column::appendNull() {
+  if (type_ == Type::Bool) {
+    if (length_ % 8 == 0) {
+      values_.push_back('\0');
+    }
+  } else {
+    size_t size = type_ == Type::DictionaryString ? sizeof(int32_t) : 8;
+    values_.resize(values_.size() + size, '\0');
+  }
+  appendValidityBit(false);
+}
+
+// _____________________________________________________________________________
+void Column::appendInt(int64_t value) {
+  AD_CONTRACT_CHECK(type_ == Type::Int64 || type_ == Type::Timestamp);
+  appendBytes(values_, value);
+  appendValidityBit(true);
+}
+
+// _____________________________________________________________________________
+void Column::appendDouble(double value) {
+  AD_CONTRACT_CHECK(type_ == Type::Double);
+  appendBytes(values_, value);
+  appendValidityBit(true);
+}
+
+// _____________________________________________________________________________
+void Column::appendBool(bool value) {
+  AD_CONTRACT_CHECK(type_ == Type::Bool);
+  if (length_ % 8 == 0) {
+    values_.push_back('\0');
+  }
+  if (value) {
+    values_.back() = static_cast<char>(values_.back() | 1 << length_ % 8);
+  }
+  appendValidityBit(true);
+}
+
+// _____________________________________________________________________________
+void Column::appendIndex(int32_t index) {
+  AD_CONTRACT_CHECK(type_ == Type::DictionaryString);
+  appendBytes(values_, index);
+  appendValidityBit(true);
+}
+
+// _____________________________________________________________________________
+std::string_view Column::validity() const {
+  // The validity bitmap may be omitted if there are no nulls.
+  return nullCount_ == 0 ? std::string_view{} : std::string_view{validity_};
+}
+
+// _____________________________________________________________________________
+std::string schemaMessage(std::span<const Field> fields) {
+  std::vector<Child> fieldTables;
+  for (size_t i = 0; i < fields.size(); ++i) {
+    const Field& field = fields[i];
+    std::vector<FlatBufferWriter::TableField> members{
+        {0, makeString(field.name_)}, {1, uint8_t{1}}, {5, makeVector({})}};
+    using enum Type;
+    switch (field.type_) {
+      case Int64:
+        members.push_back({2, TYPE_INT});
+        members.push_back({3, intType(64)});
+        break;
+      case Double:
+        members.push_back({2, TYPE_FLOATING_POINT});
+        members.push_back({3, makeTable({{0, PRECISION_DOUBLE}})});
+        break;
+      case Bool:
+        members.push_back({2, TYPE_BOOL});
+        members.push_back({3, makeTable({})});
+        break;
+      case Timestamp:
+        members.push_back({2, TYPE_TIMESTAMP});
+        members.push_back(
+            {3, makeTable({{0, TIME_UNIT_MILLISECOND},
+                           {1, makeString("UTC")}})});
+        break;
+      case DictionaryString:
+        members.push_back({2, TYPE_UTF8});
+        members.push_back({3, makeTable({})});
+        members.push_back(
+            {4, makeTable({{0, static_cast<int64_t>(i)}, {1, intType(32)}})});
+        break;
+    }
+    fieldTables.push_back(makeTable(std::move(members)));
+  }
+  return message(HEADER_SCHEMA,
+                 makeTable({{1, makeVector(std::move(fieldTables))}}), {});
+}
+
+// _____________________________________________________________________________
+std::string dictionaryBatchMessage(int64_t id,
+                                   std::span<const std::string> words) {
+  std::string offsets;
+  std::string data;
+  appendBytes(offsets, int32_t{0});
+  for (const std::string& word : words) {
+    data.append(word);
+    AD_CONTRACT_CHECK(data.size() <= std::numeric_limits<int32_t>::max());
+    appendBytes(offsets, static_cast<int32_t>(data.size()));
+  }
+  std::string body;
+  std::vector<std::array<int64_t, 2>> buffers;
+  appendBuffer(body, buffers, {});
+  appendBuffer(body, buffers, offsets);
+  appendBuffer(body, buffers, data);
+  auto numWords = static_cast<int64_t>(words.size());
+  auto batch = recordBatch(words.size(), {{numWords, 0}}, std::move(buffers));
+  return message(HEADER_DICTIONARY_BATCH,
+                 makeTable({{0, id}, {1, std::move(batch)}}), body);
+}
+
+// _____________________________________________________________________________
+std::string recordBatchMessage(std::span<const Column> columns) {
+  size_t numRows = columns.empty() ? 0 : columns.front().size();
+  std::string body;
+  std::vector<std::array<int64_t, 2>> nodes;
+  std::vector<std::array<int64_t, 2>> buffers;
+  for (const Column& column : columns) {
+    AD_CONTRACT_CHECK(column.size() == numRows);
+    nodes.push_back({static_cast<int64_t>(numRows),
+                     static_cast<int64_t>(column.nullCount())});
+    appendBuffer(body, buffers, column.validity());
+    appendBuffer(body, buffers, column.values());
+  }
+  return message(HEADER_RECORD_BATCH,
+                 recordBatch(numRows, std::move(nodes), std::move(buffers)),
+                 body);
+}
+
+// _____________________________________________________________________________
+std::string_view endOfStream() {
+  static constexpr char marker[] = "\xFF\xFF\xFF\xFF\0\0\0\0";
+  return {marker, 8};
+}
+}  // namespace ad_utility::arrow
@@ -0,0 +1,84 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A minimal writer for the Apache Arrow IPC streaming format (see
+// https://arrow.apache.org/docs/format/Columnar.html). The stream consists of
+// the `schemaMessage`, followed by the `dictionaryBatchMessage`s and
+// `recordBatchMessage`s of the batches, and the `endOfStream` marker. The
+// result can be read by every Arrow implementation, for example by
+// `pyarrow.ipc.open_stream` or `polars.read_ipc_stream`. Only the few types
+// that are needed for the export of query results are supported, which is why
+// this writer doesn't depend on the Arrow library.
+namespace ad_utility::arrow {
+
+// The supported types of the columns. A `DictionaryString` column stores
+// `int32_t` indices into a dictionary of strings that is sent in a separate
+// `dictionaryBatchMessage` before each record batch.
+enum class Type { Int64, Double, Bool, Timestamp, DictionaryString };
+
+// A column of the schema. The `Timestamp` type has a millisecond resolution and
+// the time zone UTC.
+struct Field {
+  std::string name_;
+  Type type_;
+};
+
+// The values of a single column of a record batch, including their validity
+// bitmap. For a `DictionaryString` column these are the indices into the
+// dictionary of the batch.
+class Column {
+  Type type_;
+  size_t length_ = 0;
+  size_t nullCount_ = 0;
+  std::string validity_;
+  std::string values_;
+
+ public:
+  explicit Column(Type type) : type_{type} {}
+
+  // Append a null value.
+  void appendNull();
+  // Append an `Int64` or `Timestamp` value.
+  void appendInt(int64_t value);
+  void appendDouble(double value);
+  void appendBool(bool value);
+  // Append an index into the dictionary of a `DictionaryString` column.
+  void appendIndex(int32_t index);
+
+  Type type() const { return type_; }
+  size_t size() const { return length_; }
+  size_t nullCount() const { return nullCount_; }
+  // The validity bitmap (empty if there are no nulls) and the values.
+  std::string_view validity() const;
+  std::string_view values() const { return values_; }
+
+ private:
+  void appendValidityBit(bool isValid);
+};
+
+// The message that describes the `fields`. The dictionary of the
+// `DictionaryString` field at position `i` has the id `i`.
+std::string schemaMessage(std::span<const Field> fields);
+
+// The message with the dictionary (the `words`) with the given `id`. It
+// replaces the previous dictionary with the same id, s.t. each batch can
+// send (only) the words that it contains.
+std::string dictionaryBatchMessage(int64_t id,
+                                   std::span<const std::string> words);
+
+// The message with the `columns` of a batch, which all must have the same
+// size and the types of the fields of the schema.
+std::string recordBatchMessage(std::span<const Column> columns);
+
+// The marker at the end of the stream.
+std::string_view endOfStream();
+
+}  // namespace ad_utility::arrow
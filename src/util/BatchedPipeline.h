@@ -5,6 +5,8 @@
 #ifndef QLEVER_BATCHEDPIPELINE_H
 #define QLEVER_BATCHEDPIPELINE_H
 
+#include <algorithm>
+#include <atomic>
 #include <future>
 #include <utility>
 
@@ -19,9 +21,64 @@ namespace ad_pipeline {
 using namespace ad_tuple_helpers;
 using Timer = ad_utility::Timer;
 
+// The statistics of a single stage of a pipeline (see `getStatistics` of the
+// `BatchExtractor` below).
+struct StageStatistics {
+  // The number of elements that the stage has produced.
+  size_t numElements_ = 0;
+  // The time in which the stage produced these elements (for a parallel stage
+  // the wall-clock time, not the sum of its threads).
+  std::chrono::milliseconds busyTime_{0};
+  // The time that the next stage had to wait for the batches of this stage.
+  // If it is large compared to the `busyTime_`, this stage is the bottleneck.
+  std::chrono::milliseconds waitingTime_{0};
+
+  [[nodiscard]] double elementsPerSecond() const {
+    return busyTime_.count() == 0
+               ? 0.0
+               : 1000.0 * static_cast<double>(numElements_) /
+                     static_cast<double>(busyTime_.count());
+  }
+};
+
+// Mark the tuple of transformers of a stage of `setupParallelPipeline` (see
+// below) s.t. the load is balanced between them: instead of transforming one
+// fixed part of each batch, each transformer repeatedly takes the next small
+// part of the batch that has not been transformed yet. Then the threads of
+// the stage finish at the same time, also if some elements are more expensive
+// than others. The transformers must not depend on which elements they see
+// (e.g. each one assigns IDs from its own range).
+template <typename... Transformers>
+struct LoadBalanced {
+  std::tuple<Transformers...> transformers_;
+};
+
+template <typename... Transformers>
+auto loadBalanced(std::tuple<Transformers...>&& transformers) {
+  return LoadBalanced<Transformers...>{std::move(transformers)};
+}
+
 namespace detail {
 using AtomicMs = std::atomic<std::chrono::milliseconds::rep>;
 
+template <typename T>
+constexpr bool isLoadBalanced = false;
+template <typename... Transformers>
+constexpr bool isLoadBalanced<LoadBalanced<Transformers...>> = true;
+
+// The atomic counters behind the `StageStatistics` (see above), which are
+// updated by the threads of a stage.
+struct AtomicStageStatistics {
+  std::atomic<size_t> numElements_ = 0;
+  AtomicMs busyTime_ = 0;
+  AtomicMs waitingTime_ = 0;
+
+  StageStatistics get() const {
+    return {numElements_, std::chrono::milliseconds{busyTime_},
+            std::chrono::milliseconds{waitingTime_}};
+  }
+};
+
 /* This is used as a return value for the pickupBatch calls of our pipeline
  * elements If the  is false this means that our
  * pipeline is exhausted and there is no point in asking it for further batches.
@@ -75,7 +132,7 @@ class Batcher {
       Timer timer{Timer::InitialStatus::Started};
       auto res = fut_.get();
       orderNextBatch();
-      waitingTime_->fetch_add(timer.msecs().count());
+      statistics_->waitingTime_.fetch_add(timer.msecs().count());
       return res;
     } catch (const std::future_error& e) {
       throw std::runtime_error(
@@ -87,7 +144,12 @@ class Batcher {
   // get the accumulated time that calls to pickupBatch had to block until they
   // could return the next batch
   std::vector<Timer::Duration> getWaitingTime() const {
-    return {std::chrono::milliseconds{*waitingTime_}};
+    return {std::chrono::milliseconds{statistics_->waitingTime_}};
+  }
+
+  // The statistics of this stage (see `StageStatistics`).
+  std::vector<StageStatistics> getStatistics() const {
+    return {statistics_->get()};
   }
 
   // returns the batchSize. The last batch might be smaller
@@ -96,7 +158,8 @@ class Batcher {
  private:
   size_t batchSize_;
   std::unique_ptr<Creator> creator_;
-  std::unique_ptr<AtomicMs> waitingTime_{std::make_unique<AtomicMs>(0)};
+  std::unique_ptr<AtomicStageStatistics> statistics_{
+      std::make_unique<AtomicStageStatistics>()};
   std::future<detail::Batch<ValueT>> fut_;
 
   // start assembling the next batch in parallel
@@ -104,10 +167,15 @@ class Batcher {
     // since the unique_ptr creator_ owns the creator,
     // the captured pointer will stay valid even while this
     // class is moved.
-    fut_ = std::async(std::launch::async,
-                      [bs = batchSize_, ptr = creator_.get()]() {
-                        return produceBatchInternal(bs, ptr);
-                      });
+    fut_ = std::async(std::launch::async, [bs = batchSize_,
+                                           ptr = creator_.get(),
+                                           statistics = statistics_.get()]() {
+      Timer timer{Timer::InitialStatus::Started};
+      auto batch = produceBatchInternal(bs, ptr);
+      statistics->busyTime_.fetch_add(timer.msecs().count());
+      statistics->numElements_.fetch_add(batch.content_.size());
+      return batch;
+    });
   }
 
   /* retrieve values from the creator and store them in the Batch result.
@@ -163,11 +231,17 @@ class Batcher {
  * #AllTransformers elements and so on. In this case the return type of the
  * FirstTransformer determines the produced Value type and the return types of
  * the remaining transformers must be implicitly convertible to this type.
+ *
+ * If `BalanceLoad` is true, the threads instead repeatedly take the next
+ * morsel of the batch that has not been transformed yet (see `LoadBalanced`).
  */
-template <size_t Parallelism, class PreviousStage, class FirstTransformer,
-          class... Transformers>
+template <size_t Parallelism, bool BalanceLoad, class PreviousStage,
+          class FirstTransformer, class... Transformers>
 class BatchedPipeline {
   using AtomicMs = detail::AtomicMs;
+  // With `BalanceLoad`, each thread transforms this many morsels of each
+  // batch on average.
+  static constexpr size_t NUM_MORSELS_PER_THREAD = 16;
 
  public:
   // either the same transformer is applied in all parallel Branches, or there
@@ -182,13 +256,10 @@ class BatchedPipeline {
   // the value type this BatchedPipeline produces
   using ResT = std::invoke_result_t<FirstTransformer, InT>;
 
-  /* TODO<joka921>: Currently the Transformers have to be copy-constructible.
-   * could be changed to some kind of perfect forwarding should this ever become
-   * an issue, but copying is pretty much the default for Function objects in
-   * C++
-   */
+  // The transformers are moved into the pipeline, so they only have to be
+  // move-constructible.
   BatchedPipeline(PreviousStage&& p, FirstTransformer t, Transformers... ts)
-      : transformers_(toUniquePtrTuple(t, ts...)),
+      : transformers_(toUniquePtrTuple(std::move(t), std::move(ts)...)),
         rawTransformers_(toRawPtrTuple(transformers_)),
         previousStage_(std::make_unique<PreviousStage>(std::move(p))) {
     orderNextBatch();
@@ -200,7 +271,7 @@ class BatchedPipeline {
       Timer timer{Timer::InitialStatus::Started};
       auto res = fut_.get();
       orderNextBatch();
-      waitingTime_->fetch_add(timer.msecs().count());
+      statistics_->waitingTime_.fetch_add(timer.msecs().count());
       return res;
     } catch (std::future_error& e) {
       throw std::runtime_error(
@@ -211,14 +282,15 @@ class BatchedPipeline {
 
   // asynchronously prepare the next Batch in a different thread
   void orderNextBatch() {
-    auto lambda =
-        [p = previousStage_.get(),
-         batchSize = previousStage_->getBatchSize()](auto... transformerPtrs) {
-          return std::async(
-              std::launch::async, [p, batchSize, transformerPtrs...]() {
-                return produceBatchInternal(p, batchSize, transformerPtrs...);
-              });
-        };
+    auto lambda = [p = previousStage_.get(),
+                   batchSize = previousStage_->getBatchSize(),
+                   statistics = statistics_.get()](auto... transformerPtrs) {
+      return std::async(std::launch::async, [p, batchSize, statistics,
+                                             transformerPtrs...]() {
+        return produceBatchInternal(p, batchSize, statistics,
+                                    transformerPtrs...);
+      });
+    };
     fut_ = std::apply(lambda, rawTransformers_);
   }
 
@@ -226,7 +298,14 @@ class BatchedPipeline {
   // time in calls to produce batch
   std::vector<Timer::Duration> getWaitingTime() const {
     auto res = previousStage_->getWaitingTime();
-    res.push_back(std::chrono::milliseconds(*waitingTime_));
+    res.push_back(std::chrono::milliseconds(statistics_->waitingTime_));
+    return res;
+  }
+
+  // The statistics of this and all previous stages of the pipeline.
+  std::vector<StageStatistics> getStatistics() const {
+    auto res = previousStage_->getStatistics();
+    res.push_back(statistics_->get());
     return res;
   }
 
@@ -246,24 +325,31 @@ class BatchedPipeline {
    * (possibly incomplete batch)
    */
   template <typename... TransformerPtrs>
-  static Batch<ResT> produceBatchInternal(PreviousStage* previousStage,
-                                          size_t inBatchSize,
-                                          TransformerPtrs... transformers) {
+  static Batch<ResT> produceBatchInternal(
+      PreviousStage* previousStage, size_t inBatchSize,
+      detail::AtomicStageStatistics* statistics,
+      TransformerPtrs... transformers) {
     auto inBatch = previousStage->pickupBatch();
+    Timer timer{Timer::InitialStatus::Started};
     Batch<ResT> result;
     result.isPipelineGood_ = inBatch.isPipelineGood_;
     const size_t batchSize = inBatchSize / Parallelism;
     // We know the total size in advance, so we can preallocate the memory and
     // the threads can directly write to the final result.
     result.content_.resize(inBatch.content_.size());
+    // The index of the first element of the next morsel (only used with
+    // `BalanceLoad`).
+    std::atomic<size_t> nextMorsel = 0;
     auto futures = setupParallelismImpl(
         batchSize, inBatch.content_, result.content_,
-        std::make_index_sequence<Parallelism>{}, transformers...);
+        std::make_index_sequence<Parallelism>{}, &nextMorsel, transformers...);
     // if we had multiple threads, we have to merge the partial results in the
     // correct order.
     for (size_t i = 0; i < Parallelism; ++i) {
       futures[i].get();
     }
+    statistics->busyTime_.fetch_add(timer.msecs().count());
+    statistics->numElements_.fetch_add(result.content_.size());
     return result;
   }
 
@@ -321,17 +407,18 @@ class BatchedPipeline {
             typename... TransformerPtrs>
   static auto setupParallelismImpl(size_t batchSize, InVec& in, OutVec& out,
                                    std::index_sequence<I...>,
+                                   std::atomic<size_t>* nextMorsel,
                                    TransformerPtrs... transformers) {
     AD_CORRECTNESS_CHECK(out.size() == in.size());
     if constexpr (sizeof...(I) == sizeof...(TransformerPtrs)) {
-      return std::array{
-          (createIthFuture<I>(batchSize, in, out, transformers))...};
+      return std::array{(
+          createIthFuture<I>(batchSize, in, out, nextMorsel, transformers))...};
     } else if constexpr (sizeof...(TransformerPtrs) == 1) {
       // only one transformer that is applied to several threads
       auto onlyTransformer =
           std::get<0>(std::forward_as_tuple(transformers...));
-      return std::array{
-          (createIthFuture<I>(batchSize, in, out, onlyTransformer))...};
+      return std::array{(createIthFuture<I>(batchSize, in, out, nextMorsel,
+                                            onlyTransformer))...};
     }
   }
 
@@ -339,7 +426,23 @@ class BatchedPipeline {
             typename TransformerPtr>
   static std::future<void> createIthFuture(size_t batchSize, InVec& in,
                                            OutVec& out,
+                                           std::atomic<size_t>* nextMorsel,
                                            TransformerPtr transformer) {
+    if constexpr (BalanceLoad) {
+      // The threads take the morsels in the order of the batch, so the
+      // elements are still written to their position in `out`.
+      size_t morselSize = std::max(
+          size_t{1}, in.size() / (Parallelism * NUM_MORSELS_PER_THREAD));
+      return std::async(std::launch::async, [transformer, &in, &out,
+                                             nextMorsel, morselSize] {
+        for (size_t begin = nextMorsel->fetch_add(morselSize);
+             begin < in.size(); begin = nextMorsel->fetch_add(morselSize)) {
+          size_t end = std::min(begin + morselSize, in.size());
+          moveAndTransform(std::begin(in) + begin, std::begin(in) + end,
+                           out.begin() + begin, transformer);
+        }
+      });
+    }
     auto [startIt, endIt] =
         getBatchRange(std::begin(in), std::end(in), batchSize, Idx);
     // start a thread for the transformer.
@@ -352,7 +455,8 @@ class BatchedPipeline {
   }
 
  private:
-  std::unique_ptr<AtomicMs> waitingTime_{std::make_unique<AtomicMs>(0)};
+  std::unique_ptr<detail::AtomicStageStatistics> statistics_{
+      std::make_unique<detail::AtomicStageStatistics>()};
   // the unique_ptrs to our Transformers
   using uniquePtrTuple = toUniquePtrTuple_t<FirstTransformer, Transformers...>;
   // raw non-owning pointers to the transformers
@@ -369,11 +473,11 @@ class BatchedPipeline {
  * and implicitly specify the other template types by the constructor
  * arguments.
  */
-template <size_t Parallelism, class PreviousStage, class Transformer,
-          class... OtherTransformers>
+template <size_t Parallelism, bool BalanceLoad = false, class PreviousStage,
+          class Transformer, class... OtherTransformers>
 auto makeBatchedPipeline(PreviousStage&& p, Transformer&& t,
                          OtherTransformers&&... other) {
-  return BatchedPipeline<Parallelism, std::decay_t<PreviousStage>,
+  return BatchedPipeline<Parallelism, BalanceLoad, std::decay_t<PreviousStage>,
                          std::decay_t<Transformer>,
                          std::decay_t<OtherTransformers>...>(
       std::forward<PreviousStage>(p), std::forward<Transformer>(t),
@@ -420,7 +524,9 @@ auto setupParallelPipelineRecursive(SoFar&& sofar) {
  */
 template <size_t NextParallelism, size_t... Parallelisms, typename SoFar,
           typename NextTransformer,
-          typename = std::enable_if_t<!is_tuple<NextTransformer>::value>,
+          typename = std::enable_if_t<
+              !is_tuple<NextTransformer>::value &&
+              !isLoadBalanced<std::decay_t<NextTransformer>>>,
           typename... MoreTransformers>
 auto setupParallelPipelineRecursive(SoFar&& sofar, NextTransformer&& next,
                                     MoreTransformers&&... transformers) {
@@ -453,6 +559,26 @@ auto setupParallelPipelineRecursive(SoFar&& sofar,
       std::forward<MoreTransformers>(transformers)...);
 }
 
+/*
+ * Recursion For the setupParallelPipeline function.
+ * This is the case where the nextTransformer is a tuple of <NextParallelism>
+ * different transformers that is marked as `LoadBalanced`.
+ */
+template <size_t NextParallelism, size_t... Parallelisms, typename SoFar,
+          typename... NextTransformer, typename... MoreTransformers>
+auto setupParallelPipelineRecursive(SoFar&& sofar,
+                                    LoadBalanced<NextTransformer...>&& next,
+                                    MoreTransformers&&... transformers) {
+  auto lambda = [&sofar](NextTransformer&&... transformers) {
+    return makeBatchedPipeline<NextParallelism, true>(
+        std::forward<SoFar>(sofar), std::move(transformers)...);
+  };
+
+  return setupParallelPipelineRecursive<Parallelisms...>(
+      std::apply(lambda, std::move(next.transformers_)),
+      std::forward<MoreTransformers>(transformers)...);
+}
+
 class Interface;  // forward declaration needed below for friend declaration
 
 }  // namespace detail
@@ -522,6 +648,11 @@ class BatchExtractor {
     return res;
   }
 
+  /// The statistics of all stages of the pipeline, starting with the creator.
+  [[nodiscard]] std::vector<StageStatistics> getStatistics() const {
+    return pipeline_->getStatistics();
+  }
+
   /// return the batchSize
   [[nodiscard]] size_t getBatchSize() const { return pipeline_.getBatchSize(); }
 
@@ -0,0 +1,216 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "util/Exception.h"
+
+namespace ad_utility {
+
+// A compression scheme for lists of 64-bit integers in the spirit of
+// SIMD-BP128 (see Lemire & Boytsov: "Decoding billions of integers per second
+// through vectorization"). The list is split into blocks of `BLOCK_SIZE`
+// values, and all the values of a block are stored with the same number of
+// bits (the number of bits of the largest value of the block). The values of a
+// block are distributed round-robin over `NUM_LANES` lanes, and the words of
+// the lanes are interleaved. This means that the same shifts and masks are
+// applied to `NUM_LANES` consecutive words, which the compiler turns into
+// vector instructions, because there is a separate unpacking function for each
+// bit width.
+//
+// In the differential mode (for sorted lists like the text record indices of
+// the text index), each value is stored as the difference to the value
+// `NUM_LANES` positions before it. This makes the prefix sum that undoes the
+// differences a lane-wise addition of vectors as well.
+class BlockPackedCode {
+ public:
+  static constexpr size_t BLOCK_SIZE = 128;
+  static constexpr size_t NUM_LANES = 4;
+  static constexpr size_t VALUES_PER_LANE = BLOCK_SIZE / NUM_LANES;
+
+ private:
+  using Block = std::array<uint64_t, BLOCK_SIZE>;
+
+  // The number of 64-bit words per lane for values with `bitWidth` bits.
+  static constexpr size_t numWordsPerLane(size_t bitWidth) {
+    return (VALUES_PER_LANE * bitWidth + 63) / 64;
+  }
+
+  template <size_t BitWidth>
+  static constexpr uint64_t mask() {
+    if constexpr (BitWidth == 64) {
+      return ~uint64_t{0};
+    } else {
+      return (uint64_t{1} << BitWidth) - 1;
+    }
+  }
+
+  // Unpack the `J`-th value of each lane from `in` to `out` (see below). All
+  // the shifts are known at compile time, s.t. the loop over the lanes has no
+  // branches and can be vectorized.
+  template <size_t BitWidth, size_t J>
+  static void unpackValues(const uint64_t* in, uint64_t* out) {
+    constexpr size_t word = J * BitWidth / 64;
+    constexpr size_t offset = J * BitWidth % 64;
+    const uint64_t* lowWords = in + word * NUM_LANES;
+    for (size_t l = 0; l < NUM_LANES; ++l) {
+      uint64_t value = lowWords[l] >> offset;
+      if constexpr (offset + BitWidth > 64) {
+        value |= lowWords[NUM_LANES + l] << (64 - offset);
+      }
+      out[J * NUM_LANES + l] = value & mask<BitWidth>();
+    }
+  }
+
+  // Unpack the values of a single block with `BitWidth` bits from `in` to
+  // `out`. Word `w` of lane `l` is stored at `in[w * NUM_LANES + l]`, the
+  // `j`-th value of lane `l` becomes `out[j * NUM_LANES + l]`.
+  template <size_t BitWidth>
+  static void unpackBlock(const uint64_t* in, uint64_t* out) {
+    if constexpr (BitWidth == 0) {
+      std::fill(out, out + BLOCK_SIZE, uint64_t{0});
+    } else {
+      [&]<size_t... Js>(std::index_sequence<Js...>) {
+        (..., unpackValues<BitWidth, Js>(in, out));
+      }(std::make_index_sequence<VALUES_PER_LANE>{});
+    }
+  }
+
+  // The inverse of `unpackBlock`. The words at `out` have to be zero.
+  static void packBlock(const uint64_t* in, size_t bitWidth, uint64_t* out) {
+    for (size_t j = 0; j < VALUES_PER_LANE && bitWidth > 0; ++j) {
+      const size_t word = j * bitWidth / 64;
+      const size_t offset = j * bitWidth % 64;
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        uint64_t value = in[j * NUM_LANES + l];
+        out[word * NUM_LANES + l] |= value << offset;
+        if (offset + bitWidth > 64) {
+          out[(word + 1) * NUM_LANES + l] |= value >> (64 - offset);
+        }
+      }
+    }
+  }
+
+  // Call `unpackBlock<bitWidth>` for a `bitWidth` that is only known at
+  // runtime.
+  static void unpackBlock(size_t bitWidth, const uint64_t* in, uint64_t* out) {
+    using UnpackFunction = void (*)(const uint64_t*, uint64_t*);
+    static constexpr auto unpackFunctions =
+        []<size_t... BitWidths>(std::index_sequence<BitWidths...>) {
+          return std::array<UnpackFunction, sizeof...(BitWidths)>{
+              &unpackBlock<BitWidths>...};
+        }(std::make_index_sequence<65>{});
+    AD_CORRECTNESS_CHECK(bitWidth < unpackFunctions.size());
+    unpackFunctions[bitWidth](in, out);
+  }
+
+ public:
+  // Encode the `nofElements` values `get(0), ..., get(nofElements - 1)`. In
+  // the `Differential` mode, the values have to be sorted, and the first
+  // values are stored as the difference to `base` (which must not be larger).
+  // The encoding of each block only depends on the values of the previous
+  // block, and in the non-differential mode not even on those.
+  template <bool Differential, typename Get>
+  static std::vector<uint64_t> encode(size_t nofElements, Get get,
+                                      uint64_t base = 0) {
+    std::vector<uint64_t> encoded;
+    Block block;
+    std::array<uint64_t, NUM_LANES> previous;
+    previous.fill(base);
+    for (size_t start = 0; start < nofElements; start += BLOCK_SIZE) {
+      size_t end = std::min(start + BLOCK_SIZE, nofElements);
+      for (size_t i = start; i < end; ++i) {
+        block[i - start] = get(i);
+      }
+      // Padding with the previous values yields zeros in the differential
+      // mode.
+      for (size_t i = end - start; i < BLOCK_SIZE; ++i) {
+        if constexpr (Differential) {
+          block[i] = i < NUM_LANES ? previous[i] : block[i - NUM_LANES];
+        } else {
+          block[i] = 0;
+        }
+      }
+      if constexpr (Differential) {
+        std::array<uint64_t, NUM_LANES> last;
+        std::copy(block.end() - NUM_LANES, block.end(), last.begin());
+        for (size_t i = BLOCK_SIZE; i-- > NUM_LANES;) {
+          AD_CONTRACT_CHECK(block[i] >= block[i - NUM_LANES]);
+          block[i] -= block[i - NUM_LANES];
+        }
+        for (size_t l = 0; l < NUM_LANES; ++l) {
+          AD_CONTRACT_CHECK(block[l] >= previous[l]);
+          block[l] -= previous[l];
+        }
+        previous = last;
+      }
+      uint64_t maxValue = *std::ranges::max_element(block);
+      size_t bitWidth = static_cast<size_t>(std::bit_width(maxValue));
+      encoded.push_back(bitWidth);
+      size_t headerPos = encoded.size();
+      encoded.resize(headerPos + NUM_LANES * numWordsPerLane(bitWidth), 0);
+      packBlock(block.data(), bitWidth, encoded.data() + headerPos);
+    }
+    return encoded;
+  }
+
+  // Encode the `nofElements` values at `plaintext`.
+  template <bool Differential, typename Numeric>
+  static std::vector<uint64_t> encode(const Numeric* plaintext,
+                                      size_t nofElements, uint64_t base = 0) {
+    return encode<Differential>(
+        nofElements,
+        [plaintext](size_t i) {
+          if constexpr (requires(Numeric n) { n.get(); }) {
+            return static_cast<uint64_t>(plaintext[i].get());
+          } else {
+            return static_cast<uint64_t>(plaintext[i]);
+          }
+        },
+        base);
+  }
+
+  // Decode the `nofElements` values that were encoded with the same
+  // `Differential` mode and `base` to `decoded[0], ...,
+  // decoded[nofElements - 1]` (which can be a pointer or a random access
+  // iterator). Each value is converted with `makeFromUint64` before it is
+  // written. Unlike `Simple8bCode::decode`, no additional space is needed at
+  // `decoded`.
+  template <bool Differential, typename Output,
+            typename MakeFromUint64t = std::identity>
+  static void decode(const uint64_t* encoded, size_t nofElements,
+                     Output decoded,
+                     MakeFromUint64t makeFromUint64 = MakeFromUint64t{},
+                     uint64_t base = 0) {
+    Block block;
+    std::array<uint64_t, NUM_LANES> previous;
+    previous.fill(base);
+    for (size_t start = 0; start < nofElements; start += BLOCK_SIZE) {
+      size_t bitWidth = *encoded;
+      ++encoded;
+      unpackBlock(bitWidth, encoded, block.data());
+      encoded += NUM_LANES * numWordsPerLane(bitWidth);
+      if constexpr (Differential) {
+        for (size_t l = 0; l < NUM_LANES; ++l) {
+          block[l] += previous[l];
+        }
+        for (size_t i = NUM_LANES; i < BLOCK_SIZE; ++i) {
+          block[i] += block[i - NUM_LANES];
+        }
+        std::copy(block.end() - NUM_LANES, block.end(), previous.begin());
+      }
+      size_t num = std::min(BLOCK_SIZE, nofElements - start);
+      std::transform(block.begin(), block.begin() + num, decoded + start,
+                     makeFromUint64);
+    }
+  }
+};
+}  // namespace ad_utility
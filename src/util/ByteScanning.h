@@ -0,0 +1,76 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace ad_utility {
+
+namespace detail {
+// A word in which each byte is equal to `c`.
+constexpr uint64_t broadcastByte(char c) {
+  return 0x0101010101010101ULL * static_cast<uint8_t>(c);
+}
+
+// Return a word in which the highest bit of the byte at index `i` is set if the
+// byte `i` of `word` is zero. Bytes above the first zero byte can also be
+// marked (because of the borrow of the subtraction), but the lowest marked byte
+// is always exactly the first zero byte.
+constexpr uint64_t markZeroBytes(uint64_t word) {
+  return (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+}
+}  // namespace detail
+
+// Return the position of the first character in `s[pos, s.size())` that is
+// equal to one of the `Chars`, or `std::string_view::npos` if there is no such
+// character. Equivalent to `s.find_first_of(std::string_view{Chars...}, pos)`,
+// but eight bytes are compared at once (SIMD within a register). This is used
+// by the hot loops of the Turtle parser, where the searched sets are small and
+// known at compile time, and the matches are typically far apart (e.g. the end
+// of an IRI or a literal).
+template <char... Chars>
+requires(sizeof...(Chars) > 0)
+size_t findFirstOf(std::string_view s, size_t pos = 0) {
+  auto isOneOf = [](char c) { return ((c == Chars) || ...); };
+  if constexpr (std::endian::native == std::endian::little) {
+    constexpr size_t wordSize = sizeof(uint64_t);
+    for (; pos + wordSize <= s.size(); pos += wordSize) {
+      uint64_t word;
+      std::memcpy(&word, s.data() + pos, wordSize);
+      uint64_t matches =
+          (detail::markZeroBytes(word ^ detail::broadcastByte(Chars)) | ...);
+      if (matches != 0) {
+        return pos + std::countr_zero(matches) / 8;
+      }
+    }
+  }
+  for (; pos < s.size(); ++pos) {
+    if (isOneOf(s[pos])) {
+      return pos;
+    }
+  }
+  return std::string_view::npos;
+}
+
+// Return true iff all the bytes of `s` are ASCII characters (smaller than
+// 0x80). Eight bytes are checked at once, which the compiler can further
+// vectorize, because there is no early exit.
+inline bool isAscii(std::string_view s) {
+  constexpr size_t wordSize = sizeof(uint64_t);
+  uint64_t highBits = 0;
+  size_t pos = 0;
+  for (; pos + wordSize <= s.size(); pos += wordSize) {
+    uint64_t word;
+    std::memcpy(&word, s.data() + pos, wordSize);
+    highBits |= word;
+  }
+  for (; pos < s.size(); ++pos) {
+    highBits |= static_cast<uint8_t>(s[pos]);
+  }
+  return (highBits & 0x8080808080808080ULL) == 0;
+}
+}  // namespace ad_utility
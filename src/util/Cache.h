@@ -6,14 +6,19 @@
 
 #pragma once
 
+#include <absl/strings/str_cat.h>
 #include <assert.h>
 
 #include <concepts>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
+#include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "./HashMap.h"
 #include "PriorityQueue.h"
@@ -54,7 +59,9 @@ static constexpr auto size_t_max = std::numeric_limits<size_t>::max();
  @tparam AccessUpdater function (Score, Value) -> Score. Each time a value is
  accessed, its previous score and the value are used to calculate a new score.
  @tparam ScoreCalculator function Value -> Score to determine the Score of a a
- newly inserted entry
+ newly inserted entry. If it has a member function `onEviction(Score)`, this
+ function is called with the score of each entry that is evicted because the
+ capacity is exceeded.
  @tparam ValueSizeGetter function Value -> MemorySize to determine the actual
  size of a value for statistics
  */
@@ -104,6 +111,10 @@ class FlexibleCache {
   using TryEmplaceResult = pair<EmplacedValue, ValuePtr>;
 
  public:
+  // A function that is called for each entry that is removed from the cache
+  // because the capacity of the cache was exceeded (see `setOnEviction`).
+  using OnEviction = std::function<void(const Key&, const ValuePtr&)>;
+
   //! Typical constructor. A default value may be added in time.
   explicit FlexibleCache(size_t maxNumEntries, MemorySize maxSize,
                          MemorySize maxSizeSingleEntry,
@@ -227,6 +238,31 @@ class FlexibleCache {
     // TODO<joka921>:: implement this functionality
   }
 
+  // Set the function that is called for each entry that is evicted from the
+  // non-pinned part of the cache because the cache is full. It is not called
+  // for entries that are explicitly removed via `erase` or one of the `clear`
+  // functions.
+  void setOnEviction(OnEviction onEviction) {
+    _onEviction = std::move(onEviction);
+  }
+
+  // Recompute the scores of all non-pinned entries using the
+  // `ScoreCalculator`, e.g. after its parameters have changed. The information
+  // about previous accesses, which is only stored in the scores, is lost.
+  void recomputeScores() {
+    std::vector<Entry> entries;
+    entries.reserve(_accessMap.size());
+    for (const auto& [key, handle] : _accessMap) {
+      entries.push_back(handle.value());
+    }
+    _entries.clear();
+    for (auto& entry : entries) {
+      Score s = _scoreCalculator(*entry.value());
+      auto key = entry.key();
+      _accessMap[key] = _entries.insert(std::move(s), std::move(entry));
+    }
+  }
+
   //! Checks if there is an entry with the given key.
   bool contains(const Key& key) const {
     return containsPinned(key) || containsNonPinned(key);
@@ -325,6 +361,16 @@ class FlexibleCache {
         });
   }
 
+  // Return the total size of the pinned and the non-pinned entries as it was
+  // tracked when they were inserted (unlike `pinnedSize` and `nonPinnedSize`,
+  // this doesn't iterate over the entries).
+  [[nodiscard]] MemorySize trackedPinnedSize() const {
+    return _totalSizePinned;
+  }
+  [[nodiscard]] MemorySize trackedNonPinnedSize() const {
+    return _totalSizeNonPinned;
+  }
+
   /// Return the number of non-pinned cache entries
   [[nodiscard]] size_t numNonPinnedEntries() const { return _accessMap.size(); }
 
@@ -388,6 +434,12 @@ class FlexibleCache {
     _totalSizeNonPinned =
         _totalSizeNonPinned - _valueSizeGetter(*handle.value().value());
     _accessMap.erase(handle.value().key());
+    if constexpr (requires { _scoreCalculator.onEviction(handle.score()); }) {
+      _scoreCalculator.onEviction(handle.score());
+    }
+    if (_onEviction) {
+      _onEviction(handle.value().key(), handle.value().value());
+    }
   }
   size_t _maxNumEntries;
   MemorySize _maxSize;
@@ -402,6 +454,7 @@ class FlexibleCache {
   ValueSizeGetter _valueSizeGetter;
   PinnedMap _pinnedMap;
   AccessMap _accessMap;
+  OnEviction _onEviction;
 };
 
 // Partial instantiation of FlexibleCache using the heap-based priority queue
@@ -477,6 +530,146 @@ class TreeBasedLRUCache
              detail::timeAsScore{}, ValueSizeGetter{}) {}
 };
 
+// The strategies of the `CostAwareCache` (see below) to decide which entry is
+// evicted next.
+enum class EvictionPolicy {
+  // Evict the least recently used entry.
+  LeastRecentlyUsed,
+  // GreedyDual-Size-Frequency: Evict the entry with the lowest priority
+  // `L + numAccesses * cost / size`, where the `cost` is the time that was
+  // needed to compute the entry. `L` is the priority of the last evicted entry,
+  // s.t. entries that are no longer accessed eventually become evictable.
+  GreedyDualSizeFrequency
+};
+
+// Convert from and to the names that are used for the runtime parameter
+// `cache-eviction-policy` ("lru" and "gdsf"). Throw for an unknown name.
+inline EvictionPolicy evictionPolicyFromString(std::string_view name) {
+  if (name == "lru") {
+    return EvictionPolicy::LeastRecentlyUsed;
+  } else if (name == "gdsf") {
+    return EvictionPolicy::GreedyDualSizeFrequency;
+  }
+  throw std::runtime_error{absl::StrCat(
+      "Unknown cache eviction policy \"", name,
+      "\", the supported policies are \"lru\" and \"gdsf\"")};
+}
+
+namespace detail {
+// The score of an entry in a `CostAwareCache`. Entries with a lower
+// `priority_` are evicted first.
+struct CostAwareScore {
+  double priority_;
+  size_t numAccesses_;
+  bool operator==(const CostAwareScore&) const = default;
+};
+
+struct CostAwareScoreComparator {
+  bool operator()(const CostAwareScore& a, const CostAwareScore& b) const {
+    return a.priority_ < b.priority_;
+  }
+};
+
+// The state that is shared by the score functions of a `CostAwareCache`.
+struct CostAwareState {
+  EvictionPolicy policy_;
+  // The logical clock for `LeastRecentlyUsed`.
+  double clock_ = 0;
+  // The value `L` for `GreedyDualSizeFrequency`.
+  double inflation_ = 0;
+};
+
+// Compute the priority of an entry according to the policy (see
+// `EvictionPolicy` above).
+template <typename Value, typename SizeGetter, typename CostGetter>
+struct CostAwareScoreCalculator {
+  std::shared_ptr<CostAwareState> state_;
+
+  double priority(const Value& value, size_t numAccesses) const {
+    if (state_->policy_ == EvictionPolicy::LeastRecentlyUsed) {
+      return ++state_->clock_;
+    }
+    // Add one to the cost and the size, s.t. results that were instantly
+    // computed or are empty still get a finite, positive priority.
+    auto cost = static_cast<double>(CostGetter{}(value).count()) + 1.0;
+    auto size = static_cast<double>(SizeGetter{}(value).getBytes()) + 1.0;
+    return state_->inflation_ +
+           static_cast<double>(numAccesses) * cost / size;
+  }
+
+  CostAwareScore operator()(const Value& value) const {
+    return {priority(value, 1), 1};
+  }
+
+  void onEviction(const CostAwareScore& score) const {
+    if (state_->policy_ == EvictionPolicy::GreedyDualSizeFrequency) {
+      state_->inflation_ = std::max(state_->inflation_, score.priority_);
+    }
+  }
+};
+
+template <typename Calculator>
+struct CostAwareAccessUpdater {
+  Calculator calculator_;
+  // The `entry` is the `Entry` of the `FlexibleCache`, which stores a pointer
+  // to the value.
+  template <typename Entry>
+  CostAwareScore operator()(const CostAwareScore& score,
+                            const Entry& entry) const {
+    auto numAccesses = score.numAccesses_ + 1;
+    return {calculator_.priority(*entry.value(), numAccesses), numAccesses};
+  }
+};
+}  // namespace detail
+
+// A cache that can switch between the eviction policies from `EvictionPolicy`
+// at runtime. The `CostGetter` is a function `Value -> std::chrono::duration`
+// that returns the time that was needed to compute a value.
+template <typename Key, typename Value, ValueSizeGetter<Value> ValueSizeGetter,
+          typename CostGetter>
+class CostAwareCache
+    : public HeapBasedCache<
+          Key, Value, detail::CostAwareScore, detail::CostAwareScoreComparator,
+          detail::CostAwareAccessUpdater<detail::CostAwareScoreCalculator<
+              Value, ValueSizeGetter, CostGetter>>,
+          detail::CostAwareScoreCalculator<Value, ValueSizeGetter, CostGetter>,
+          ValueSizeGetter> {
+  using Calculator =
+      detail::CostAwareScoreCalculator<Value, ValueSizeGetter, CostGetter>;
+  using Updater = detail::CostAwareAccessUpdater<Calculator>;
+  using Base = HeapBasedCache<Key, Value, detail::CostAwareScore,
+                              detail::CostAwareScoreComparator, Updater,
+                              Calculator, ValueSizeGetter>;
+  std::shared_ptr<detail::CostAwareState> state_;
+
+ public:
+  explicit CostAwareCache(
+      size_t capacityNumEls = size_t_max,
+      MemorySize capacitySize = MemorySize::max(),
+      MemorySize maxSizeSingleEl = MemorySize::max(),
+      EvictionPolicy policy = EvictionPolicy::LeastRecentlyUsed)
+      : CostAwareCache(std::make_shared<detail::CostAwareState>(policy),
+                       capacityNumEls, capacitySize, maxSizeSingleEl) {}
+
+  // Change the eviction policy. The scores of all entries are recomputed, so
+  // the information about their previous accesses is lost.
+  void setEvictionPolicy(EvictionPolicy policy) {
+    state_->policy_ = policy;
+    state_->inflation_ = 0;
+    this->recomputeScores();
+  }
+  EvictionPolicy evictionPolicy() const { return state_->policy_; }
+
+ private:
+  CostAwareCache(std::shared_ptr<detail::CostAwareState> state,
+                 size_t capacityNumEls, MemorySize capacitySize,
+                 MemorySize maxSizeSingleEl)
+      : Base(capacityNumEls, capacitySize, maxSizeSingleEl,
+             detail::CostAwareScoreComparator{}, Updater{Calculator{state}},
+             Calculator{state}, ValueSizeGetter{}),
+        state_(std::move(state)) {}
+};
+
 /// typedef for the simple name LRUCache that is fixed to one of the possible
 /// implementations at compiletime
 #ifdef _QLEVER_USE_TREE_BASED_CACHE
@@ -4,9 +4,12 @@
 
 #pragma once
 
-#include <memory_resource>
+#include <absl/container/flat_hash_map.h>
 
-#include "util/HashMap.h"
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace ad_utility {
 
@@ -29,8 +32,12 @@ namespace ad_utility {
 class CachingMemoryResource : public std::pmr::memory_resource {
  private:
   std::pmr::memory_resource* allocator_ = std::pmr::get_default_resource();
-  ad_utility::HashMap<std::pair<size_t, size_t>, std::vector<void*>> cache_;
-  std::mutex mutex_;
+  // Note: `util/HashMap.h` can't be used here, because it includes
+  // `util/AllocatorWithLimit.h`, which includes this file.
+  absl::flat_hash_map<std::pair<size_t, size_t>, std::vector<void*>> cache_;
+  // The total size of the blocks in the `cache_`.
+  size_t numCachedBytes_ = 0;
+  mutable std::mutex mutex_;
 
   // Allocation: Find suitable block in the cache, or allocate a new block.
   void* do_allocate(std::size_t bytes, std::size_t alignment) override {
@@ -43,6 +50,7 @@ class CachingMemoryResource : public std::pmr::memory_resource {
     auto& c = it->second;
     auto res = c.back();
     c.pop_back();
+    numCachedBytes_ -= bytes;
     return res;
   }
 
@@ -51,6 +59,7 @@ class CachingMemoryResource : public std::pmr::memory_resource {
                      std::size_t alignment) override {
     std::lock_guard l{mutex_};
     cache_[std::pair{bytes, alignment}].push_back(p);
+    numCachedBytes_ += bytes;
   }
 
   // Equality implementation.
@@ -60,13 +69,47 @@ class CachingMemoryResource : public std::pmr::memory_resource {
   }
 
  public:
-  // Destructor: actually deallocate the blocks in the cache.
-  ~CachingMemoryResource() override {
+  // Return a block with the given size and alignment from the cache, or
+  // `nullptr` if the cache contains no such block. Unlike `allocate`, this
+  // never allocates a new block.
+  void* allocateFromCache(std::size_t bytes, std::size_t alignment) {
+    std::lock_guard l{mutex_};
+    auto it = cache_.find(std::pair{bytes, alignment});
+    if (it == cache_.end() || it->second.empty()) {
+      return nullptr;
+    }
+    auto res = it->second.back();
+    it->second.pop_back();
+    numCachedBytes_ -= bytes;
+    return res;
+  }
+
+  // Allocate a new block, bypassing the cache. The block can be deallocated
+  // (and thus be inserted into the cache) like any other block.
+  void* allocateNew(std::size_t bytes, std::size_t alignment) {
+    return allocator_->allocate(bytes, alignment);
+  }
+
+  // The total size of the blocks that are currently cached.
+  size_t numCachedBytes() const {
+    std::lock_guard l{mutex_};
+    return numCachedBytes_;
+  }
+
+  // Actually deallocate all the blocks in the cache and return their total
+  // size.
+  size_t releaseCachedBlocks() {
+    std::lock_guard l{mutex_};
     for (const auto& [key, pointers] : cache_) {
       for (auto ptr : pointers) {
         allocator_->deallocate(ptr, key.first, key.second);
       }
     }
+    cache_.clear();
+    return std::exchange(numCachedBytes_, 0);
   }
+
+  // Destructor: actually deallocate the blocks in the cache.
+  ~CachingMemoryResource() override { releaseCachedBlocks(); }
 };
 }  // namespace ad_utility
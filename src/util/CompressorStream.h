@@ -10,7 +10,9 @@
 #ifndef EOF
 #define EOF std::char_traits<char>::eof()
 #endif
+#include <algorithm>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <string>
 
@@ -24,19 +26,28 @@ using ad_utility::content_encoding::CompressionMethod;
 /**
  * Takes a range of strings. Behavior: The concatenation of all yielded strings
  * is the compression, specified by the `compressionMethod` applied to the
- * concatenation of all the strings from the range.
+ * concatenation of all the strings from the range. The `compressionLevel` is
+ * clamped to the levels that are supported by the `compressionMethod` (1 to 9
+ * for DEFLATE and GZIP, 1 to 19 for ZSTD), with 1 being the fastest.
  */
 template <typename Range>
 cppcoro::generator<std::string> compressStream(
-    Range range, CompressionMethod compressionMethod) {
+    Range range, CompressionMethod compressionMethod,
+    size_t compressionLevel = 1) {
   io::filtering_ostream filteringStream;
   std::string stringBuffer;
 
+  auto level = [compressionLevel](size_t maxLevel) {
+    return static_cast<int>(std::clamp(compressionLevel, size_t{1}, maxLevel));
+  };
   // setup compression method
   if (compressionMethod == CompressionMethod::DEFLATE) {
-    filteringStream.push(io::zlib_compressor(io::zlib::best_speed));
+    filteringStream.push(io::zlib_compressor(io::zlib_params{level(9)}));
   } else if (compressionMethod == CompressionMethod::GZIP) {
-    filteringStream.push(io::gzip_compressor(io::gzip::best_speed));
+    filteringStream.push(io::gzip_compressor(io::gzip_params{level(9)}));
+  } else if (compressionMethod == CompressionMethod::ZSTD) {
+    filteringStream.push(io::zstd_compressor(
+        io::zstd_params{static_cast<uint32_t>(level(19))}));
   }
   filteringStream.push(io::back_inserter(stringBuffer), 0);
 
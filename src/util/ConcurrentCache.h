@@ -4,16 +4,25 @@
 
 #ifndef QLEVER_CONCURRENTCACHE_H
 #define QLEVER_CONCURRENTCACHE_H
+#include <absl/hash/hash.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <concepts>
 #include <condition_variable>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <utility>
 
+#include "util/Cache.h"
 #include "util/Forward.h"
 #include "util/HashMap.h"
 #include "util/Log.h"
 #include "util/MemorySize/MemorySize.h"
+#include "util/QueryTrace.h"
 #include "util/Synchronized.h"
 
 namespace ad_utility {
@@ -240,6 +249,14 @@ class ConcurrentCache {
   /// only for testing: get access to the implementation
   auto& getStorage() { return _cacheAndInProgressMap; }
 
+  // Call the `function` with the underlying cache while it is locked and
+  // return its result.
+  template <typename Function>
+  decltype(auto) withLockedCache(Function function) const {
+    auto lockPtr = _cacheAndInProgressMap.wlock();
+    return function(std::as_const(lockPtr->_cache));
+  }
+
   // is key in cache (not in progress), used for testing
   bool cacheContains(const Key& k) const {
     return _cacheAndInProgressMap.wlock()->_cache.contains(k);
@@ -270,6 +287,24 @@ class ConcurrentCache {
     _cacheAndInProgressMap.wlock()->_cache.setMaxSizeSingleEntry(maxSize);
   }
 
+  // Change the eviction policy of the underlying cache. Only available for
+  // caches that support this, e.g. the `CostAwareCache`.
+  void setEvictionPolicy(EvictionPolicy policy)
+    requires requires(Cache& cache, EvictionPolicy p) {
+      cache.setEvictionPolicy(p);
+    }
+  {
+    _cacheAndInProgressMap.wlock()->_cache.setEvictionPolicy(policy);
+  }
+
+  // Set the function that is called for each entry that is evicted from the
+  // underlying cache (see `FlexibleCache::setOnEviction`). The function is
+  // called while the cache is locked, so it has to be cheap and must not access
+  // this cache.
+  void setOnEviction(typename Cache::OnEviction onEviction) {
+    _cacheAndInProgressMap.wlock()->_cache.setOnEviction(std::move(onEviction));
+  }
+
  private:
   using ResultInProgress = ConcurrentCacheDetail::ResultInProgress<Value>;
 
@@ -372,6 +407,7 @@ class ConcurrentCache {
       // someone else is computing the result, wait till it is finished and
       // return the result, we do not count this case as "cached" as we had to
       // wait.
+      QueryTrace::ScopedSpan traceSpan{"wait for result in progress", "cache"};
       return {resultInProgress->getResult(), CacheStatus::computed};
     }
   }
@@ -379,6 +415,286 @@ class ConcurrentCache {
   // Data members
   SyncCache _cacheAndInProgressMap;  // the data storage
 };
+
+/**
+ * @brief A `ConcurrentCache` that is split into `NumShards` shards by the hash
+ * of the keys. Each shard has its own lock and its own eviction order, so
+ * concurrent lookups of different keys (for example of the subtrees of many
+ * small concurrent queries) rarely wait for each other.
+ *
+ * The maximal size and number of entries are global limits for all the
+ * shards together: The size and the number of entries of each shard are
+ * tracked with atomic counters after each insertion. When the totals exceed
+ * the limits, non-pinned entries are evicted from the shards with the most
+ * non-pinned entries (see `enforceGlobalLimits`). Within a shard, the entries
+ * are evicted according to the policy of the `Cache`. The maximal size of a
+ * single entry is checked by each shard.
+ *
+ * The interface is the same as that of `ConcurrentCache`.
+ */
+template <typename Cache, size_t NumShards = 16>
+class ShardedConcurrentCache {
+ public:
+  using Shard = ConcurrentCache<Cache>;
+  using Value = typename Shard::Value;
+  using Key = typename Shard::Key;
+  using ResultAndCacheStatus = typename Shard::ResultAndCacheStatus;
+
+ private:
+  std::array<Shard, NumShards> shards_;
+
+  // The tracked sizes (in bytes) and numbers of entries of a shard.
+  struct ShardStatistics {
+    std::atomic<size_t> pinnedSize_ = 0;
+    std::atomic<size_t> nonPinnedSize_ = 0;
+    std::atomic<size_t> numPinnedEntries_ = 0;
+    std::atomic<size_t> numNonPinnedEntries_ = 0;
+  };
+  std::array<ShardStatistics, NumShards> statistics_;
+  // The sums of the sizes (pinned and non-pinned) and of the numbers of
+  // entries of all the shards.
+  std::atomic<size_t> totalSize_ = 0;
+  std::atomic<size_t> totalNumEntries_ = 0;
+
+  std::atomic<size_t> maxSize_ = std::numeric_limits<size_t>::max();
+  std::atomic<size_t> maxNumEntries_ = std::numeric_limits<size_t>::max();
+  // Only one thread at a time evicts entries to enforce the global limits.
+  std::mutex enforceLimitsMutex_;
+
+ public:
+  ShardedConcurrentCache() requires std::default_initializable<Cache> = default;
+
+  // _________________________________________________________________________
+  template <class ComputeFunction>
+  ResultAndCacheStatus computeOnce(const Key& key,
+                                   ComputeFunction computeFunction,
+                                   bool onlyReadFromCache = false) {
+    size_t i = getShardIndex(key);
+    auto result = shards_[i].computeOnce(key, std::move(computeFunction),
+                                         onlyReadFromCache);
+    if (result._cacheStatus == CacheStatus::computed) {
+      updateStatistics(i);
+      enforceGlobalLimits();
+    }
+    return result;
+  }
+
+  // _________________________________________________________________________
+  template <class ComputeFunction>
+  ResultAndCacheStatus computeOncePinned(const Key& key,
+                                         ComputeFunction computeFunction,
+                                         bool onlyReadFromCache = false) {
+    size_t i = getShardIndex(key);
+    auto result = shards_[i].computeOncePinned(
+        key, std::move(computeFunction), onlyReadFromCache);
+    // A non-pinned entry that is found might have been pinned.
+    if (result._cacheStatus != CacheStatus::cachedPinned) {
+      updateStatistics(i);
+      enforceGlobalLimits();
+    }
+    return result;
+  }
+
+  // _________________________________________________________________________
+  void clearUnpinnedOnly() {
+    for (size_t i = 0; i < NumShards; ++i) {
+      shards_[i].clearUnpinnedOnly();
+      updateStatistics(i);
+    }
+  }
+
+  // _________________________________________________________________________
+  virtual void clearAll() {
+    for (size_t i = 0; i < NumShards; ++i) {
+      shards_[i].clearAll();
+      updateStatistics(i);
+    }
+  }
+  virtual ~ShardedConcurrentCache() = default;
+
+  // Delete non-pinned entries of a total size of at least `size`, starting
+  // with the shards with the most non-pinned entries. Return false if there
+  // were not enough non-pinned entries, in which case all of them are deleted.
+  bool makeRoomAsMuchAsPossible(MemorySize size) {
+    size_t remaining = size.getBytes();
+    while (remaining > 0) {
+      auto i = getShardWithLargestNonPinnedSize();
+      if (!i.has_value()) {
+        return false;
+      }
+      size_t toRemove = getSizeToRemove(i.value(), remaining);
+      shards_[i.value()].makeRoomAsMuchAsPossible(MemorySize::bytes(toRemove));
+      updateStatistics(i.value());
+      remaining -= toRemove;
+    }
+    return true;
+  }
+
+  // The following statistics are the sums over all shards.
+  size_t numNonPinnedEntries() const {
+    return sumOverShards([](const Shard& s) { return s.numNonPinnedEntries(); },
+                         size_t{0});
+  }
+  size_t numPinnedEntries() const {
+    return sumOverShards([](const Shard& s) { return s.numPinnedEntries(); },
+                         size_t{0});
+  }
+  MemorySize nonPinnedSize() const {
+    return sumOverShards([](const Shard& s) { return s.nonPinnedSize(); },
+                         MemorySize::bytes(0));
+  }
+  MemorySize pinnedSize() const {
+    return sumOverShards([](const Shard& s) { return s.pinnedSize(); },
+                         MemorySize::bytes(0));
+  }
+
+  // _________________________________________________________________________
+  bool cacheContains(const Key& key) const {
+    return shards_[getShardIndex(key)].cacheContains(key);
+  }
+
+  // _________________________________________________________________________
+  std::optional<ResultAndCacheStatus> getIfContained(const Key& key) {
+    return shards_[getShardIndex(key)].getIfContained(key);
+  }
+
+  // Set the global limits. Each shard may use the whole capacity.
+  void setMaxSize(MemorySize maxSize) {
+    maxSize_ = maxSize.getBytes();
+    for (size_t i = 0; i < NumShards; ++i) {
+      shards_[i].setMaxSize(maxSize);
+      updateStatistics(i);
+    }
+    enforceGlobalLimits();
+  }
+  void setMaxNumEntries(size_t maxNumEntries) {
+    maxNumEntries_ = maxNumEntries;
+    for (size_t i = 0; i < NumShards; ++i) {
+      shards_[i].setMaxNumEntries(maxNumEntries);
+      updateStatistics(i);
+    }
+    enforceGlobalLimits();
+  }
+  void setMaxSizeSingleEntry(MemorySize maxSize) {
+    for (auto& shard : shards_) {
+      shard.setMaxSizeSingleEntry(maxSize);
+    }
+  }
+
+  // Change the eviction policy of all shards (see
+  // `ConcurrentCache::setEvictionPolicy`).
+  void setEvictionPolicy(EvictionPolicy policy)
+    requires requires(Shard& shard, EvictionPolicy p) {
+      shard.setEvictionPolicy(p);
+    }
+  {
+    for (auto& shard : shards_) {
+      shard.setEvictionPolicy(policy);
+    }
+  }
+
+  // Set the function that is called for each entry that is evicted (see
+  // `ConcurrentCache::setOnEviction`), for all shards.
+  void setOnEviction(typename Cache::OnEviction onEviction) {
+    for (auto& shard : shards_) {
+      shard.setOnEviction(onEviction);
+    }
+  }
+
+  // Only for testing: the shard that stores the `key`.
+  Shard& getShardForTesting(const Key& key) {
+    return shards_[getShardIndex(key)];
+  }
+
+ private:
+  size_t getShardIndex(const Key& key) const {
+    return absl::Hash<Key>{}(key) % NumShards;
+  }
+
+  // Read the sizes and numbers of entries of the shard `i` and update the
+  // `statistics_` and the totals. This happens while the shard is locked, s.t.
+  // the updates of a shard are applied in the order of its changes.
+  void updateStatistics(size_t i) {
+    shards_[i].withLockedCache([this, i](const Cache& cache) {
+      auto& statistics = statistics_[i];
+      size_t pinnedSize = cache.trackedPinnedSize().getBytes();
+      size_t nonPinnedSize = cache.trackedNonPinnedSize().getBytes();
+      size_t numPinned = cache.numPinnedEntries();
+      size_t numNonPinned = cache.numNonPinnedEntries();
+      // The unsigned arithmetic wraps around if a shard became smaller, which
+      // is well-defined and yields the correct sums.
+      totalSize_ += pinnedSize + nonPinnedSize -
+                    statistics.pinnedSize_.exchange(pinnedSize) -
+                    statistics.nonPinnedSize_.exchange(nonPinnedSize);
+      auto& numPinnedEntries = statistics.numPinnedEntries_;
+      auto& numNonPinnedEntries = statistics.numNonPinnedEntries_;
+      totalNumEntries_ += numPinned + numNonPinned -
+                          numPinnedEntries.exchange(numPinned) -
+                          numNonPinnedEntries.exchange(numNonPinned);
+    });
+  }
+
+  // Return the index of the shard with the largest size of non-pinned entries
+  // (or with the most non-pinned entries if `bySize` is false), or
+  // `std::nullopt` if there are no non-pinned entries.
+  std::optional<size_t> getShardWithLargestNonPinnedSize(bool bySize = true) {
+    std::optional<size_t> result;
+    size_t largest = 0;
+    for (size_t i = 0; i < NumShards; ++i) {
+      size_t current = bySize ? statistics_[i].nonPinnedSize_.load()
+                              : statistics_[i].numNonPinnedEntries_.load();
+      bool hasEntries = statistics_[i].numNonPinnedEntries_ > 0;
+      if (hasEntries && (!result.has_value() || current > largest)) {
+        result = i;
+        largest = current;
+      }
+    }
+    return result;
+  }
+
+  // Return the size that has to be passed to `makeRoomAsMuchAsPossible` of
+  // the shard `i` to remove `size` bytes. It is at most the size of the
+  // non-pinned entries of the shard (s.t. the entries are evicted one by one
+  // and the `OnEviction` function is called for them), but at least one byte
+  // (s.t. at least one entry is removed).
+  size_t getSizeToRemove(size_t i, size_t size) const {
+    return std::max(size_t{1},
+                    std::min(size, statistics_[i].nonPinnedSize_.load()));
+  }
+
+  // Evict non-pinned entries until the totals of all shards are within the
+  // global limits (or there are no more non-pinned entries).
+  void enforceGlobalLimits() {
+    auto exceedsSize = [this]() { return totalSize_ > maxSize_; };
+    auto exceedsNumEntries = [this]() {
+      return totalNumEntries_ > maxNumEntries_;
+    };
+    if (!exceedsSize() && !exceedsNumEntries()) {
+      return;
+    }
+    std::lock_guard lock{enforceLimitsMutex_};
+    while (exceedsSize() || exceedsNumEntries()) {
+      bool bySize = exceedsSize();
+      auto i = getShardWithLargestNonPinnedSize(bySize);
+      if (!i.has_value()) {
+        return;
+      }
+      size_t excess = bySize ? totalSize_ - maxSize_ : 1;
+      shards_[i.value()].makeRoomAsMuchAsPossible(
+          MemorySize::bytes(getSizeToRemove(i.value(), excess)));
+      updateStatistics(i.value());
+    }
+  }
+
+  // Sum up the `function` over all shards, starting with the `init` value.
+  template <typename Function, typename T>
+  T sumOverShards(Function function, T init) const {
+    for (const auto& shard : shards_) {
+      init += function(shard);
+    }
+    return init;
+  }
+};
 }  // namespace ad_utility
 
 #endif  // QLEVER_CONCURRENTCACHE_H
@@ -241,6 +241,25 @@ DateOrLargeYear DateOrLargeYear::parseGYearMonth(std::string_view dateString) {
                              parseTimeZone(match));
 }
 
+// _____________________________________________________________________-
+DateOrLargeYear DateOrLargeYear::getFirstOfYearAndMonth(int64_t year,
+                                                        int month) {
+  AD_CONTRACT_CHECK(month >= 0 && month <= static_cast<int>(Date::maxMonth));
+  if (year < Date::minYear || year > Date::maxYear) {
+    return DateOrLargeYear{year, Type::Year};
+  }
+  // All the components of a `Date` that are stored in the bits below the month
+  // are zero for the smallest `Date` of the month.
+  constexpr uint8_t numBitsBelowMonth = Date::numBitsTimeZone +
+                                        Date::numBitsSecond +
+                                        Date::numBitsMinute +
+                                        Date::numBitsHour + Date::numBitsDay;
+  uint64_t bits = static_cast<uint64_t>(year - Date::minYear)
+                  << (numBitsBelowMonth + Date::numBitsMonth);
+  bits |= static_cast<uint64_t>(month) << numBitsBelowMonth;
+  return DateOrLargeYear{Date::fromBits(bits)};
+}
+
 // _____________________________________________________________________-
 int64_t DateOrLargeYear::getYear() const {
   if (isDate()) {
@@ -383,6 +383,13 @@ class DateOrLargeYear {
     return getDateUnchecked();
   }
 
+  // Return the smallest `DateOrLargeYear` with the given `year` and a month
+  // that is at least `month` (where 0 stands for no month at all, as for
+  // `xsd:gYear`), s.t. the dates of a range of years and months form a range of
+  // `DateOrLargeYear`s. For a large year, the `month` is ignored. The `year`
+  // must be in `[minYear, maxYear]` and the `month` in `[0, 12]`.
+  static DateOrLargeYear getFirstOfYearAndMonth(int64_t year, int month);
+
   // Get the stored year, no matter if it's stored inside a `Date` object or
   // directly.
   int64_t getYear() const;
@@ -0,0 +1,94 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "util/jthread.h"
+
+namespace ad_utility {
+
+// Measure the total size of the files in a `directory` whose names fulfill a
+// predicate periodically on a background thread, and keep the maximum (the
+// high-water mark). This is used to report the disk space that is needed for
+// the temporary files of the index build.
+class DiskSpaceMonitor {
+  std::filesystem::path directory_;
+  std::function<bool(std::string_view filename)> isMonitored_;
+  std::mutex mutex_;
+  std::condition_variable stopped_;
+  bool stop_ = false;
+  size_t peak_ = 0;
+  // Declared last, s.t. it is started after and joined before the other
+  // members are destroyed.
+  ad_utility::JThread thread_;
+
+ public:
+  DiskSpaceMonitor(std::filesystem::path directory,
+                   std::function<bool(std::string_view filename)> isMonitored,
+                   std::chrono::milliseconds interval =
+                       std::chrono::milliseconds{200})
+      : directory_{std::move(directory)},
+        isMonitored_{std::move(isMonitored)},
+        thread_{[this, interval]() {
+          std::unique_lock lock{mutex_};
+          while (!stop_) {
+            lock.unlock();
+            size_t size = currentSize();
+            lock.lock();
+            peak_ = std::max(peak_, size);
+            stopped_.wait_for(lock, interval, [this]() { return stop_; });
+          }
+        }} {}
+
+  ~DiskSpaceMonitor() { stop(); }
+
+  DiskSpaceMonitor(const DiskSpaceMonitor&) = delete;
+  DiskSpaceMonitor& operator=(const DiskSpaceMonitor&) = delete;
+
+  // Stop the measurements (after a last one) and return the peak.
+  size_t stop() {
+    {
+      std::lock_guard lock{mutex_};
+      stop_ = true;
+    }
+    stopped_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    size_t size = currentSize();
+    std::lock_guard lock{mutex_};
+    peak_ = std::max(peak_, size);
+    return peak_;
+  }
+
+  // The total size of the monitored files at this moment. Files that are
+  // deleted during the measurement are ignored.
+  size_t currentSize() const {
+    namespace fs = std::filesystem;
+    size_t size = 0;
+    std::error_code error;
+    for (fs::directory_iterator it{directory_, error}, end; !error && it != end;
+         it.increment(error)) {
+      if (!isMonitored_(it->path().filename().string())) {
+        continue;
+      }
+      std::error_code sizeError;
+      auto fileSize = it->file_size(sizeError);
+      if (!sizeError) {
+        size += fileSize;
+      }
+    }
+    return size;
+  }
+};
+
+}  // namespace ad_utility
@@ -4,6 +4,7 @@
 
 #pragma once
 #include <absl/strings/str_cat.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -158,6 +159,22 @@ class File {
     return bytesRead;
   }
 
+  //! Announce that the `nofBytes` bytes starting at the given offset will be
+  //! read soon. The kernel may then asynchronously load them into the page
+  //! cache, s.t. many such calls for different parts of the file keep the
+  //! queue of the storage device full. This is only a hint, errors and
+  //! platforms without `posix_fadvise` are silently ignored.
+  void adviseWillNeed(off_t offset, size_t nofBytes) const {
+    assert(file_);
+#ifdef POSIX_FADV_WILLNEED
+    posix_fadvise(fileno(file_), offset, static_cast<off_t>(nofBytes),
+                  POSIX_FADV_WILLNEED);
+#else
+    (void)offset;
+    (void)nofBytes;
+#endif
+  }
+
   //! Returns the number of bytes from the beginning
   //! is 0 on opening. Later equal the number of bytes written.
   //! -1 is returned when an error occurs
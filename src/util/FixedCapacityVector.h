@@ -0,0 +1,75 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+
+#include "util/Exception.h"
+
+namespace ad_utility {
+
+// A vector with a capacity that is fixed at compile time. The elements are
+// stored inline, so the `FixedCapacityVector` is trivially copyable if `T` is.
+// This is used for the members of structs that are stored in an `MmapVector`
+// or that are serialized by copying their bytes.
+template <typename T, size_t Capacity>
+class FixedCapacityVector {
+  static_assert(Capacity <= std::numeric_limits<uint8_t>::max());
+
+ private:
+  std::array<T, Capacity> elements_{};
+  uint8_t size_ = 0;
+
+ public:
+  using value_type = T;
+  using iterator = typename std::array<T, Capacity>::iterator;
+  using const_iterator = typename std::array<T, Capacity>::const_iterator;
+
+  FixedCapacityVector() = default;
+  FixedCapacityVector(std::initializer_list<T> elements) {
+    for (const auto& element : elements) {
+      push_back(element);
+    }
+  }
+
+  // Append the `element`. Throw if the capacity is already exhausted.
+  void push_back(const T& element) {
+    AD_CONTRACT_CHECK(size_ < Capacity);
+    elements_[size_] = element;
+    ++size_;
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  static constexpr size_t capacity() { return Capacity; }
+
+  T& operator[](size_t i) { return elements_[i]; }
+  const T& operator[](size_t i) const { return elements_[i]; }
+  T& at(size_t i) {
+    AD_CONTRACT_CHECK(i < size_);
+    return elements_[i];
+  }
+  const T& at(size_t i) const {
+    AD_CONTRACT_CHECK(i < size_);
+    return elements_[i];
+  }
+
+  iterator begin() { return elements_.begin(); }
+  iterator end() { return elements_.begin() + size_; }
+  const_iterator begin() const { return elements_.begin(); }
+  const_iterator end() const { return elements_.begin() + size_; }
+
+  // Only the first `size()` elements are compared.
+  bool operator==(const FixedCapacityVector& other) const {
+    return std::ranges::equal(*this, other);
+  }
+};
+
+}  // namespace ad_utility
@@ -71,8 +71,14 @@ double wktLatitudeImpl(const std::string_view point) {
 // Compute distance (in km) between two WKT points.
 double wktDistImpl(const std::string_view point1,
                    const std::string_view point2) {
-  auto [lng1, lat1] = parseWktPoint(point1);
-  auto [lng2, lat2] = parseWktPoint(point2);
+  return distanceImpl(parseWktPoint(point1), parseWktPoint(point2));
+}
+
+// Compute distance (in km) between two points.
+double distanceImpl(std::pair<double, double> point1,
+                    std::pair<double, double> point2) {
+  auto [lng1, lat1] = point1;
+  auto [lng2, lat2] = point2;
   auto sqr = [](double x) { return x * x; };
   auto m = std::numbers::pi / 180.0 * (lat1 + lat2) / 2.0;
   auto k1 = 111.13209 - 0.56605 * cos(2 * m) + 0.00120 * cos(4 * m);
@@ -23,6 +23,10 @@ double wktLongitudeImpl(const std::string_view point);
 double wktLatitudeImpl(const std::string_view point);
 double wktDistImpl(const std::string_view point1,
                    const std::string_view point2);
+// The distance in km between two points given by their longitude and latitude
+// (see `wktDist` below).
+double distanceImpl(std::pair<double, double> point1,
+                    std::pair<double, double> point2);
 
 }  // namespace detail
 
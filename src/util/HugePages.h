@@ -0,0 +1,67 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <sys/mman.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "util/MemorySize/MemorySize.h"
+
+// Helpers for backing large blocks of memory (the columns of large `IdTable`s
+// and the memory-mapped metadata of the index) by transparent huge pages,
+// which reduces the number of misses of the TLB for scans and random
+// lookups. The blocks are only advised to the kernel (`MADV_HUGEPAGE`), s.t.
+// they are allocated and deallocated as before and the advice has no effect
+// if transparent huge pages are not available.
+namespace ad_utility::hugePages {
+
+// The size of a (transparent) huge page on x86-64 and on ARM64 with 4 KiB
+// pages.
+static constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+namespace detail {
+inline std::atomic<size_t>& minNumBytes() {
+  static std::atomic<size_t> minNumBytes{0};
+  return minNumBytes;
+}
+}  // namespace detail
+
+// The minimal size of the blocks that are backed by huge pages. 0 (the
+// default) disables the huge pages. Set via the runtime parameter
+// `huge-pages-min-size`.
+inline MemorySize getMinSize() {
+  return MemorySize::bytes(detail::minNumBytes().load());
+}
+inline void setMinSize(MemorySize minSize) {
+  detail::minNumBytes() = minSize.getBytes();
+}
+
+// Advise the kernel to back the huge pages that lie completely in the block
+// of memory `[ptr, ptr + numBytes)` by transparent huge pages if the block is
+// at least as large as the `getMinSize()`. Return true iff the advice was
+// given.
+inline bool adviseIfLarge(void* ptr, size_t numBytes) {
+  size_t minNumBytes = detail::minNumBytes().load(std::memory_order_relaxed);
+  if (minNumBytes == 0 || numBytes < minNumBytes || ptr == nullptr) {
+    return false;
+  }
+#ifdef MADV_HUGEPAGE
+  auto begin = reinterpret_cast<uintptr_t>(ptr);
+  auto alignedBegin = (begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE *
+                      HUGE_PAGE_SIZE;
+  auto alignedEnd = (begin + numBytes) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  if (alignedBegin >= alignedEnd) {
+    return false;
+  }
+  return madvise(reinterpret_cast<void*>(alignedBegin),
+                 alignedEnd - alignedBegin, MADV_HUGEPAGE) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace ad_utility::hugePages
@@ -0,0 +1,35 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <span>
+
+#include "global/Id.h"
+
+namespace ad_utility {
+
+// Return the index of the first element in `values[begin, values.size())` for
+// which `isBefore(element)` is false. The elements for which `isBefore` holds
+// must form a prefix of `values`. The search starts with exponentially growing
+// steps (galloping) from the `begin`, which is much faster than a binary search
+// on the whole range when the result is close to the `begin`, which is the
+// typical case for the seeks of the leapfrog join and of `Minus`.
+size_t gallop(std::span<const Id> values, size_t begin, const auto& isBefore) {
+  size_t low = begin;
+  size_t step = 1;
+  size_t high = begin;
+  while (high < values.size() && isBefore(values[high])) {
+    low = high + 1;
+    high = begin + step;
+    step *= 2;
+  }
+  high = std::min(high, values.size());
+  return static_cast<size_t>(
+      std::partition_point(values.begin() + low, values.begin() + high,
+                           isBefore) -
+      values.begin());
+}
+
+}  // namespace ad_utility
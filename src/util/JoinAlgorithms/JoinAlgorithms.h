@@ -7,13 +7,16 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <optional>
 #include <ranges>
+#include <vector>
 
 #include "engine/idTable/IdTable.h"
 #include "global/Id.h"
 #include "util/Generator.h"
 #include "util/JoinAlgorithms/FindUndefRanges.h"
 #include "util/JoinAlgorithms/JoinColumnMapping.h"
+#include "util/ParallelExecution.h"
 #include "util/TransparentFunctors.h"
 
 namespace ad_utility {
@@ -396,6 +399,134 @@ void gallopingJoin(
   }
 }
 
+/**
+ * @brief Split the two sorted inputs `left` and `right` into at most
+ * `numPartitions` consecutive partitions, s.t. matching elements (elements for
+ * which neither is `lessThan` the other) always end up in the same partition.
+ * The partitions can thus be joined independently of each other. The split
+ * points are sampled equidistantly from the larger input, and then located in
+ * both inputs via binary search. The inputs must not contain UNDEF values.
+ * @return The boundaries of the partitions as pairs `[indexLeft,
+ * indexRight]`. The first boundary is always `[0, 0]`, the last boundary is
+ * always `[size(left), size(right)]`, partition `i` consists of the elements
+ * between boundary `i` (inclusive) and boundary `i + 1` (exclusive).
+ */
+template <std::ranges::random_access_range Range1,
+          std::ranges::random_access_range Range2, typename LessThan>
+std::vector<std::array<size_t, 2>> getPartitionBoundariesForParallelJoin(
+    const Range1& left, const Range2& right, const LessThan& lessThan,
+    size_t numPartitions) {
+  AD_CONTRACT_CHECK(numPartitions > 0);
+  size_t sizeLeft = std::ranges::size(left);
+  size_t sizeRight = std::ranges::size(right);
+  auto lowerBound = [&lessThan](const auto& range,
+                                const auto& value) -> size_t {
+    auto comp = [&lessThan](const auto& a, const auto& b) -> bool {
+      return lessThan(a, b);
+    };
+    return std::lower_bound(std::begin(range), std::end(range), value, comp) -
+           std::begin(range);
+  };
+
+  std::vector<std::array<size_t, 2>> boundaries{{0, 0}};
+  auto addBoundary = [&](const auto& splitElement) {
+    std::array<size_t, 2> boundary{lowerBound(left, splitElement),
+                                   lowerBound(right, splitElement)};
+    // If there are many equal elements, two split points can yield the same
+    // boundary. Skip the resulting empty partitions.
+    if (boundary != boundaries.back()) {
+      boundaries.push_back(boundary);
+    }
+  };
+  for (size_t i = 1; i < numPartitions; ++i) {
+    if (sizeLeft >= sizeRight) {
+      addBoundary(*(std::begin(left) + i * sizeLeft / numPartitions));
+    } else {
+      addBoundary(*(std::begin(right) + i * sizeRight / numPartitions));
+    }
+  }
+  // The boundaries that were added in the loop are always strictly smaller
+  // than the size of the larger input, so this never adds a duplicate.
+  boundaries.push_back({sizeLeft, sizeRight});
+  return boundaries;
+}
+
+/**
+ * @brief Perform the `zipperJoinWithUndef` algorithm for two sorted inputs
+ * that contain no UNDEF values on up to `numThreads` threads. The inputs are
+ * partitioned via `getPartitionBoundariesForParallelJoin` (see above), such
+ * that each partition contains at least `minSizePerPartition` elements. The
+ * partitions are joined concurrently and the partial results are concatenated
+ * in order. The result is therefore exactly the same (including the order of
+ * the rows) as the result of the single-threaded join.
+ * @param makeRowAdder Is called once per partition (possibly concurrently) and
+ * has to return a fresh row adder that writes to its own result (typically an
+ * `AddCombinedRowToIdTable`). The row adders get indices that are relative to
+ * the beginning of the complete `left` and `right` inputs. The type of the
+ * result of `std::move(rowAdder).resultTable()` must have a member function
+ * `insertAtEnd(const Result&)`.
+ * @param doOptionalJoin If set to `std::true_type`, an OPTIONAL join is
+ * performed, meaning that `addOptionalRow` is called for all elements from
+ * `left` without a match.
+ * @return The concatenated results of all the row adders.
+ */
+template <std::ranges::random_access_range Range1,
+          std::ranges::random_access_range Range2, typename LessThan,
+          typename MakeRowAdder, typename DoOptionalJoinTag = std::false_type>
+auto parallelZipperJoinWithoutUndef(const Range1& left, const Range2& right,
+                                    const LessThan& lessThan, size_t numThreads,
+                                    const MakeRowAdder& makeRowAdder,
+                                    size_t minSizePerPartition = 100'000,
+                                    DoOptionalJoinTag = {}) {
+  static constexpr bool DoOptionalJoin = DoOptionalJoinTag::value;
+  AD_CONTRACT_CHECK(minSizePerPartition > 0);
+  size_t totalSize = std::ranges::size(left) + std::ranges::size(right);
+  size_t numPartitions = std::clamp(totalSize / minSizePerPartition, size_t{1},
+                                    std::max(numThreads, size_t{1}));
+  auto boundaries = getPartitionBoundariesForParallelJoin(left, right, lessThan,
+                                                          numPartitions);
+
+  using Result = std::decay_t<decltype(makeRowAdder().resultTable())>;
+  std::vector<std::optional<Result>> partialResults(boundaries.size() - 1);
+  auto joinPartition = [&](size_t partition) {
+    auto rowAdder = makeRowAdder();
+    auto beginLeft = std::begin(left);
+    auto beginRight = std::begin(right);
+    auto [lowerLeft, lowerRight] = boundaries.at(partition);
+    auto [upperLeft, upperRight] = boundaries.at(partition + 1);
+    auto addRow = [&rowAdder, beginLeft, beginRight](const auto& itLeft,
+                                                     const auto& itRight) {
+      rowAdder.addRow(itLeft - beginLeft, itRight - beginRight);
+    };
+    auto addOptionalRow = [&rowAdder, beginLeft](const auto& itLeft) {
+      rowAdder.addOptionalRow(itLeft - beginLeft);
+    };
+    auto subrangeLeft = std::ranges::subrange{beginLeft + lowerLeft,
+                                              beginLeft + upperLeft};
+    auto subrangeRight = std::ranges::subrange{beginRight + lowerRight,
+                                               beginRight + upperRight};
+    [[maybe_unused]] auto numOutOfOrder = [&]() {
+      if constexpr (DoOptionalJoin) {
+        return zipperJoinWithUndef(subrangeLeft, subrangeRight, lessThan,
+                                   addRow, noop, noop, addOptionalRow);
+      } else {
+        return zipperJoinWithUndef(subrangeLeft, subrangeRight, lessThan,
+                                   addRow, noop, noop);
+      }
+    }();
+    AD_CORRECTNESS_CHECK(numOutOfOrder == 0);
+    partialResults.at(partition).emplace(std::move(rowAdder).resultTable());
+  };
+  runConcurrently(partialResults.size(), joinPartition);
+
+  Result result = std::move(partialResults.front().value());
+  for (auto& partialResult : partialResults | std::views::drop(1)) {
+    result.insertAtEnd(partialResult.value());
+    partialResult.reset();
+  }
+  return result;
+}
+
 /**
  * @brief Perform an OPTIONAL join for the following special case: The `right`
  * input contains no UNDEF values in any of its join columns, the `left`
@@ -1058,6 +1189,27 @@ struct BlockZipperJoinImpl {
       joinBuffers<DoOptionalJoin, ProjectedEl>(blockStatus);
     }
   }
+
+  // Same as `runJoin`, but yield the `compatibleRowAction_` after each round
+  // of joining. At this point all the matching rows of the round have been
+  // passed to the `compatibleRowAction_` and `flush()` has been called on it,
+  // so the caller can consume the partial result before resuming.
+  template <bool DoOptionalJoin>
+  cppcoro::generator<CompatibleRowAction&> runJoinLazily() {
+    while (true) {
+      BlockStatus blockStatus = fillBuffer();
+      if (leftSide_.currentBlocks_.empty() ||
+          rightSide_.currentBlocks_.empty()) {
+        if constexpr (DoOptionalJoin) {
+          fillWithAllFromLeft();
+        }
+        co_yield compatibleRowAction_;
+        co_return;
+      }
+      joinBuffers<DoOptionalJoin, ProjectedEl>(blockStatus);
+      co_yield compatibleRowAction_;
+    }
+  }
 };
 
 // Deduction guide for the above struct.
@@ -1117,4 +1269,39 @@ void zipperJoinForBlocksWithoutUndef(LeftBlocks&& leftBlocks,
   impl.template runJoin<DoOptionalJoin>();
 }
 
+/**
+ * @brief The lazy version of `zipperJoinForBlocksWithoutUndef` (see above for
+ * the meaning of the arguments). The join is performed round by round, and the
+ * returned generator yields the `compatibleRowAction` after each round. At that
+ * point all the matching rows of the round have been added and `flush()` has
+ * been called, so the caller can consume (e.g. move out) the result so far
+ * before resuming the generator. This makes it possible to emit the result of
+ * a join of two huge block generators incrementally instead of materializing
+ * it completely. Note: The `leftBlocks`, `rightBlocks`, and the
+ * `compatibleRowAction` are stored as references, so the caller has to keep
+ * them alive while the generator is being consumed.
+ */
+template <typename LeftBlocks, typename RightBlocks, typename LessThan,
+          typename CompatibleRowAction,
+          typename LeftProjection = std::identity,
+          typename RightProjection = std::identity,
+          typename DoOptionalJoinTag = std::false_type>
+cppcoro::generator<CompatibleRowAction&> zipperJoinForBlocksWithoutUndefLazily(
+    LeftBlocks& leftBlocks, RightBlocks& rightBlocks, LessThan lessThan,
+    CompatibleRowAction& compatibleRowAction,
+    LeftProjection leftProjection = {}, RightProjection rightProjection = {},
+    DoOptionalJoinTag = {}) {
+  static constexpr bool DoOptionalJoin = DoOptionalJoinTag::value;
+
+  auto leftSide = detail::makeJoinSide(leftBlocks, leftProjection);
+  auto rightSide = detail::makeJoinSide(rightBlocks, rightProjection);
+
+  detail::BlockZipperJoinImpl impl{leftSide, rightSide, lessThan,
+                                   compatibleRowAction};
+  for (CompatibleRowAction& action :
+       impl.template runJoinLazily<DoOptionalJoin>()) {
+    co_yield action;
+  }
+}
+
 }  // namespace ad_utility
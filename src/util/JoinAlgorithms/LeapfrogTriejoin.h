@@ -0,0 +1,200 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/Exception.h"
+#include "util/JoinAlgorithms/Gallop.h"
+
+namespace ad_utility {
+
+// A relation with two columns that is one of the inputs of the
+// `leapfrogTriejoin` (see below). The rows must be sorted lexicographically,
+// s.t. the relation can be used as a trie with two levels: The first level
+// consists of the distinct values of `col0_`, and the children of such a value
+// are the values of `col1_` of the rows with this value in `col0_`. The columns
+// belong to the variables with the indices `variables_[0]` and
+// `variables_[1]` in the global order of the variables, where `variables_[0] <
+// variables_[1]`. The IDs must not be UNDEF.
+struct TrieRelation {
+  std::span<const Id> col0_;
+  std::span<const Id> col1_;
+  std::array<size_t, 2> variables_;
+};
+
+namespace detail {
+// An iterator over the distinct values of a sorted column (which may contain
+// duplicates) with the `seek` operation that is needed for the leapfrog join.
+class LeapfrogIterator {
+  std::span<const Id> values_;
+  size_t position_ = 0;
+
+ public:
+  LeapfrogIterator(std::span<const Id> values, size_t position)
+      : values_{values}, position_{position} {}
+  bool atEnd() const { return position_ == values_.size(); }
+  Id key() const { return values_[position_]; }
+  size_t position() const { return position_; }
+  // Move to the first value `>= id`.
+  void seek(Id id) {
+    position_ = gallop(values_, position_, [id](Id x) { return x < id; });
+  }
+  // Move to the next distinct value.
+  void next() {
+    Id current = key();
+    position_ =
+        gallop(values_, position_, [current](Id x) { return x <= current; });
+  }
+};
+
+// The implementation of `leapfrogTriejoin` (see below).
+template <typename OnResultRow, typename CheckCancellation>
+class LeapfrogTriejoin {
+  std::span<const TrieRelation> relations_;
+  OnResultRow& onResultRow_;
+  const CheckCancellation& checkCancellation_;
+  // `relationsOfVariable_[v]` contains the pairs `(i, c)` s.t. the column `c`
+  // of the `relations_[i]` belongs to the variable `v`.
+  std::vector<std::vector<std::array<size_t, 2>>> relationsOfVariable_;
+  // The range of the rows of each relation in which its `col0_` is equal to
+  // the currently bound value of its first variable.
+  std::vector<std::array<size_t, 2>> rangeOfBoundRows_;
+  // The iterators for each variable and a permutation of them (see `join`).
+  std::vector<std::vector<LeapfrogIterator>> iterators_;
+  std::vector<std::vector<size_t>> orders_;
+  // The currently bound values of the variables.
+  std::vector<Id> row_;
+  size_t numBindings_ = 0;
+
+ public:
+  LeapfrogTriejoin(std::span<const TrieRelation> relations,
+                   size_t numVariables, OnResultRow& onResultRow,
+                   const CheckCancellation& checkCancellation)
+      : relations_{relations},
+        onResultRow_{onResultRow},
+        checkCancellation_{checkCancellation},
+        relationsOfVariable_(numVariables),
+        rangeOfBoundRows_(relations.size()),
+        iterators_(numVariables),
+        orders_(numVariables),
+        row_(numVariables) {
+    for (size_t i = 0; i < relations_.size(); ++i) {
+      const auto& relation = relations_[i];
+      AD_CONTRACT_CHECK(relation.col0_.size() == relation.col1_.size());
+      AD_CONTRACT_CHECK(relation.variables_[0] < relation.variables_[1]);
+      AD_CONTRACT_CHECK(relation.variables_[1] < numVariables);
+      relationsOfVariable_[relation.variables_[0]].push_back({i, 0});
+      relationsOfVariable_[relation.variables_[1]].push_back({i, 1});
+    }
+    for (const auto& relations : relationsOfVariable_) {
+      // Each variable must be bound by at least one relation.
+      AD_CONTRACT_CHECK(!relations.empty());
+    }
+  }
+
+  // Bind the variable `variable` to all the values that are contained in all
+  // the relations with this variable (with the values of the previous
+  // variables already bound), and recursively bind the next variables.
+  void join(size_t variable) {
+    // The buffers are reused, which is safe because the recursion only binds
+    // the subsequent variables.
+    auto& iterators = iterators_[variable];
+    iterators.clear();
+    for (auto [i, column] : relationsOfVariable_[variable]) {
+      const auto& relation = relations_[i];
+      if (column == 0) {
+        iterators.emplace_back(relation.col0_, 0);
+      } else {
+        auto [begin, end] = rangeOfBoundRows_[i];
+        iterators.emplace_back(relation.col1_.subspan(0, end), begin);
+      }
+      if (iterators.back().atEnd()) {
+        return;
+      }
+    }
+    // The `iterators` must stay in the order of the `relationsOfVariable_`, so
+    // a permutation of them is sorted by their current keys.
+    auto& order = orders_[variable];
+    order.resize(iterators.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, {}, [&](size_t k) { return iterators[k].key(); });
+    Id maxKey = iterators[order.back()].key();
+    size_t p = 0;
+    while (true) {
+      auto& iterator = iterators[order[p]];
+      if (iterator.key() == maxKey) {
+        // The keys of the iterators are cyclically sorted, starting at
+        // `order[p]` and ending at the `maxKey`, so all iterators are
+        // positioned at the `maxKey`.
+        bind(variable, maxKey);
+        iterator.next();
+      } else {
+        iterator.seek(maxKey);
+      }
+      if (iterator.atEnd()) {
+        return;
+      }
+      maxKey = iterator.key();
+      p = (p + 1) % order.size();
+    }
+  }
+
+ private:
+  // Bind the `variable` to the `value`, at which all the iterators for the
+  // `variable` are currently positioned.
+  void bind(size_t variable, Id value) {
+    const auto& iterators = iterators_[variable];
+    if (++numBindings_ % 10'000 == 0) {
+      checkCancellation_();
+    }
+    const auto& relations = relationsOfVariable_[variable];
+    for (size_t k = 0; k < relations.size(); ++k) {
+      auto [i, column] = relations[k];
+      if (column == 0) {
+        size_t begin = iterators[k].position();
+        size_t end = gallop(relations_[i].col0_, begin,
+                            [value](Id x) { return x <= value; });
+        rangeOfBoundRows_[i] = {begin, end};
+      }
+    }
+    row_[variable] = value;
+    if (variable + 1 == row_.size()) {
+      onResultRow_(std::span<const Id>{row_});
+    } else {
+      join(variable + 1);
+    }
+  }
+};
+}  // namespace detail
+
+// Compute the natural join of the `relations` with the Leapfrog Triejoin
+// algorithm (see Veldhuizen, "Leapfrog Triejoin: A Simple, Worst-Case Optimal
+// Join Algorithm", ICDT 2014). The variables are bound one after the other in
+// the order of their indices `0, ..., numVariables - 1`: For each variable the
+// sorted values of all the relations that contain it are intersected via
+// galloping seeks, where the values of the variables that were bound before
+// restrict these values. Intermediate results are never materialized, which
+// makes the algorithm worst-case optimal (in the size of the inputs and the
+// largest possible result) for any order of the variables, in particular for
+// cyclic queries. The `onResultRow` is called for each row of the result with
+// a span of the values of all the variables; the rows are produced in
+// lexicographical order. The `checkCancellation` is called regularly.
+template <typename OnResultRow, typename CheckCancellation>
+void leapfrogTriejoin(std::span<const TrieRelation> relations,
+                      size_t numVariables, OnResultRow onResultRow,
+                      const CheckCancellation& checkCancellation) {
+  if (numVariables == 0) {
+    return;
+  }
+  detail::LeapfrogTriejoin<OnResultRow, CheckCancellation> join{
+      relations, numVariables, onResultRow, checkCancellation};
+  join.join(0);
+}
+}  // namespace ad_utility
@@ -0,0 +1,215 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "util/Metrics.h"
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_join.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/Exception.h"
+#include "util/TransparentFunctors.h"
+
+namespace ad_utility::metrics {
+
+// _____________________________________________________________________________
+size_t shardOfThisThread() {
+  static std::atomic<size_t> nextShard = 0;
+  thread_local size_t shard = nextShard++ % NUM_SHARDS;
+  return shard;
+}
+
+// _____________________________________________________________________________
+uint64_t Counter::value() const {
+  uint64_t result = 0;
+  for (const auto& shard : shards_) {
+    result += shard.value_.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+Histogram::Histogram(std::vector<double> upperBounds)
+    : upperBounds_{std::move(upperBounds)} {
+  AD_CONTRACT_CHECK(std::ranges::is_sorted(upperBounds_));
+  for (auto& shard : shards_) {
+    shard.counts_ =
+        std::make_unique<std::atomic<uint64_t>[]>(upperBounds_.size() + 1);
+  }
+}
+
+// _____________________________________________________________________________
+void Histogram::observe(double value) {
+  auto bucket = std::ranges::lower_bound(upperBounds_, value) -
+                upperBounds_.begin();
+  auto& shard = shards_[shardOfThisThread()];
+  shard.counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+// _____________________________________________________________________________
+std::vector<uint64_t> Histogram::cumulativeCounts() const {
+  std::vector<uint64_t> result(upperBounds_.size() + 1, 0);
+  for (const auto& shard : shards_) {
+    for (size_t i = 0; i < result.size(); ++i) {
+      result[i] += shard.counts_[i].load(std::memory_order_relaxed);
+    }
+  }
+  for (size_t i = 1; i < result.size(); ++i) {
+    result[i] += result[i - 1];
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+double Histogram::sum() const {
+  double result = 0;
+  for (const auto& shard : shards_) {
+    result += shard.sum_.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+auto Registry::getFamily(std::string_view name, std::string_view help,
+                         Type type) -> Family& {
+  auto it = std::ranges::find(families_, name, &Family::name_);
+  if (it == families_.end()) {
+    families_.push_back(Family{std::string{name}, std::string{help}, type});
+    return families_.back();
+  }
+  AD_CONTRACT_CHECK(it->type_ == type);
+  return *it;
+}
+
+// _____________________________________________________________________________
+Counter& Registry::counter(std::string_view name, std::string_view help,
+                           const Labels& labels) {
+  std::lock_guard lock{mutex_};
+  auto& counters = getFamily(name, help, Type::Counter).counters_;
+  auto it = std::ranges::find(counters, labels, ad_utility::first);
+  if (it == counters.end()) {
+    counters.emplace_back(labels, std::make_unique<Counter>());
+    return *counters.back().second;
+  }
+  return *it->second;
+}
+
+// _____________________________________________________________________________
+Histogram& Registry::histogram(std::string_view name, std::string_view help,
+                               const std::vector<double>& upperBounds,
+                               const Labels& labels) {
+  std::lock_guard lock{mutex_};
+  auto& histograms = getFamily(name, help, Type::Histogram).histograms_;
+  AD_CONTRACT_CHECK(histograms.empty() ||
+                    histograms.front().second->upperBounds() == upperBounds);
+  auto it = std::ranges::find(histograms, labels, ad_utility::first);
+  if (it == histograms.end()) {
+    histograms.emplace_back(labels, std::make_unique<Histogram>(upperBounds));
+    return *histograms.back().second;
+  }
+  return *it->second;
+}
+
+namespace {
+// The `labels` in the export format, for example `{permutation="PSO"}` (or ""
+// if there are no labels).
+std::string formatLabels(const Labels& labels) {
+  if (labels.empty()) {
+    return "";
+  }
+  auto formatLabel = [](std::string* out, const auto& label) {
+    const auto& [key, value] = label;
+    absl::StrAppend(out, key, "=\"");
+    for (char c : value) {
+      if (c == '\\' || c == '"') {
+        absl::StrAppend(out, "\\", std::string_view{&c, 1});
+      } else if (c == '\n') {
+        absl::StrAppend(out, "\\n");
+      } else {
+        absl::StrAppend(out, std::string_view{&c, 1});
+      }
+    }
+    absl::StrAppend(out, "\"");
+  };
+  return absl::StrCat("{", absl::StrJoin(labels, ",", formatLabel), "}");
+}
+
+// A value in the export format.
+std::string formatValue(double value) {
+  if (std::isinf(value)) {
+    return value > 0 ? "+Inf" : "-Inf";
+  }
+  return absl::StrCat(value);
+}
+
+// The help and type lines of a metric.
+void appendHeader(std::string* out, std::string_view name,
+                  std::string_view help, std::string_view type) {
+  absl::StrAppend(out, "# HELP ", name, " ", help, "\n", "# TYPE ", name, " ",
+                  type, "\n");
+}
+}  // namespace
+
+// _____________________________________________________________________________
+std::string Registry::toPrometheusText(
+    const std::vector<Sample>& samples) const {
+  std::string result;
+  std::lock_guard lock{mutex_};
+  for (const auto& family : families_) {
+    const auto& name = family.name_;
+    if (family.type_ == Type::Counter) {
+      appendHeader(&result, name, family.help_, "counter");
+      for (const auto& [labels, counter] : family.counters_) {
+        absl::StrAppend(&result, name, formatLabels(labels), " ",
+                        counter->value(), "\n");
+      }
+      continue;
+    }
+    appendHeader(&result, name, family.help_, "histogram");
+    for (const auto& [labels, histogram] : family.histograms_) {
+      auto counts = histogram->cumulativeCounts();
+      const auto& upperBounds = histogram->upperBounds();
+      for (size_t i = 0; i < counts.size(); ++i) {
+        auto labelsOfBucket = labels;
+        labelsOfBucket.emplace_back("le", i < upperBounds.size()
+                                              ? formatValue(upperBounds[i])
+                                              : "+Inf");
+        absl::StrAppend(&result, name, "_bucket", formatLabels(labelsOfBucket),
+                        " ", counts[i], "\n");
+      }
+      absl::StrAppend(&result, name, "_sum", formatLabels(labels), " ",
+                      formatValue(histogram->sum()), "\n");
+      absl::StrAppend(&result, name, "_count", formatLabels(labels), " ",
+                      counts.back(), "\n");
+    }
+  }
+  // Samples with the same name are exported together (with the header only
+  // once).
+  std::vector<const Sample*> sortedSamples;
+  for (const auto& sample : samples) {
+    sortedSamples.push_back(&sample);
+  }
+  std::ranges::stable_sort(sortedSamples, std::less{}, &Sample::name_);
+  for (size_t i = 0; i < sortedSamples.size(); ++i) {
+    const auto& sample = *sortedSamples[i];
+    if (i == 0 || sortedSamples[i - 1]->name_ != sample.name_) {
+      AD_CONTRACT_CHECK(std::ranges::find(families_, sample.name_,
+                                          &Family::name_) == families_.end());
+      appendHeader(&result, sample.name_, sample.help_,
+                   sample.type_ == Sample::Type::Counter ? "counter" : "gauge");
+    }
+    absl::StrAppend(&result, sample.name_, formatLabels(sample.labels_), " ",
+                    formatValue(sample.value_), "\n");
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+}  // namespace ad_utility::metrics
@@ -0,0 +1,119 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Counters, gauges, and histograms that are exported in the text format of
+// Prometheus (see `Registry::toPrometheusText`, which is served by the
+// `/metrics` endpoint of the server). The counters and histograms are updated
+// on hot paths, so their updates are lock-free and sharded: each thread adds
+// to one of `NUM_SHARDS` cache lines (with relaxed atomics), which are only
+// summed up when the metrics are exported.
+namespace ad_utility::metrics {
+
+static constexpr size_t NUM_SHARDS = 32;
+
+// The shard of the current thread (the threads are assigned to the shards
+// round robin when they first update a metric).
+size_t shardOfThisThread();
+
+// The labels of a metric, for example `{{"permutation", "PSO"}}`.
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// A monotonically increasing counter.
+class Counter {
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_ = 0;
+  };
+  std::array<Shard, NUM_SHARDS> shards_;
+
+ public:
+  void increment(uint64_t value = 1) {
+    shards_[shardOfThisThread()].value_.fetch_add(value,
+                                                  std::memory_order_relaxed);
+  }
+  uint64_t value() const;
+};
+
+// A histogram with fixed upper bounds of its buckets (the bucket `+Inf` is
+// added implicitly).
+class Histogram {
+  std::vector<double> upperBounds_;
+  struct alignas(64) Shard {
+    // One count per bucket (not cumulative), the last one is `+Inf`.
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<double> sum_ = 0;
+  };
+  std::array<Shard, NUM_SHARDS> shards_;
+
+ public:
+  explicit Histogram(std::vector<double> upperBounds);
+  void observe(double value);
+
+  const std::vector<double>& upperBounds() const { return upperBounds_; }
+  // The cumulative counts of the buckets (as in the export format, the last
+  // one is the total count) and the sum of all the observed values.
+  std::vector<uint64_t> cumulativeCounts() const;
+  double sum() const;
+};
+
+// The value of a metric that is not registered in the `Registry`, but only
+// collected when the metrics are exported. This is used for gauges (like the
+// memory that is currently left) and for the counters of individual objects
+// (like the hits of a certain cache).
+struct Sample {
+  enum class Type { Counter, Gauge };
+  std::string name_;
+  std::string help_;
+  Type type_;
+  Labels labels_;
+  double value_;
+};
+
+// The metrics of a process. The registration of a metric takes a lock, so the
+// (references to the) metrics should be obtained once and then be stored, for
+// example in a static variable.
+class Registry {
+  enum class Type { Counter, Histogram };
+  struct Family {
+    std::string name_;
+    std::string help_;
+    Type type_;
+    std::vector<std::pair<Labels, std::unique_ptr<Counter>>> counters_;
+    std::vector<std::pair<Labels, std::unique_ptr<Histogram>>> histograms_;
+  };
+  mutable std::mutex mutex_;
+  std::vector<Family> families_;
+
+  Family& getFamily(std::string_view name, std::string_view help, Type type);
+
+ public:
+  // Return the counter or histogram with the `name` and the `labels`. It is
+  // created if it doesn't exist yet. All the metrics with the same name must
+  // have the same type (and the same upper bounds for the histograms).
+  Counter& counter(std::string_view name, std::string_view help,
+                   const Labels& labels = {});
+  Histogram& histogram(std::string_view name, std::string_view help,
+                       const std::vector<double>& upperBounds,
+                       const Labels& labels = {});
+
+  // All the registered metrics and the `samples` in the Prometheus text
+  // format. The names of the `samples` must differ from the names of the
+  // registered metrics.
+  std::string toPrometheusText(const std::vector<Sample>& samples = {}) const;
+};
+
+// The registry of the process.
+Registry& registry();
+}  // namespace ad_utility::metrics
@@ -11,6 +11,7 @@
 
 #include <utility>
 
+#include "../util/HugePages.h"
 #include "../util/Log.h"
 
 namespace ad_utility {
@@ -325,6 +326,9 @@ void MmapVector<T>::advise(AccessPattern pattern) {
       madvise(static_cast<void*>(_ptr), _bytesize, MADV_NORMAL);
       break;
   }
+  // Large files (e.g. the metadata of the permutations) are backed by huge
+  // pages if enabled and supported for the file system.
+  hugePages::adviseIfLarge(static_cast<void*>(_ptr), _bytesize);
 }
 
 // ________________________________________________________________
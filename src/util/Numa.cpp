@@ -0,0 +1,145 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "util/Numa.h"
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_split.h>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+
+#include "util/Exception.h"
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ad_utility::numa {
+
+namespace {
+// Parse a single non-negative number of a CPU list.
+size_t parseNumber(std::string_view number, std::string_view cpuList) {
+  size_t result = 0;
+  auto [ptr, ec] =
+      std::from_chars(number.data(), number.data() + number.size(), result);
+  if (number.empty() || ec != std::errc{} ||
+      ptr != number.data() + number.size()) {
+    AD_THROW(absl::StrCat("Malformed list of CPUs: \"", cpuList, "\""));
+  }
+  return result;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+std::vector<size_t> parseCpuList(std::string_view cpuList) {
+  std::vector<size_t> result;
+  std::string_view trimmed = absl::StripAsciiWhitespace(cpuList);
+  if (trimmed.empty()) {
+    return result;
+  }
+  for (std::string_view range : absl::StrSplit(trimmed, ',')) {
+    std::vector<std::string_view> bounds = absl::StrSplit(range, '-');
+    if (bounds.size() > 2) {
+      AD_THROW(absl::StrCat("Malformed list of CPUs: \"", cpuList, "\""));
+    }
+    size_t first = parseNumber(bounds.front(), cpuList);
+    size_t last = parseNumber(bounds.back(), cpuList);
+    for (size_t cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  std::ranges::sort(result);
+  auto [eraseBegin, eraseEnd] = std::ranges::unique(result);
+  result.erase(eraseBegin, eraseEnd);
+  return result;
+}
+
+// _____________________________________________________________________________
+std::vector<Node> getNodes(const std::filesystem::path& sysfsDirectory) {
+  std::vector<Node> result;
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(sysfsDirectory, ec)) {
+    std::string name = entry.path().filename().string();
+    std::string_view id{name};
+    if (!id.starts_with("node") || id.size() == 4 ||
+        !std::ranges::all_of(id.substr(4), absl::ascii_isdigit)) {
+      continue;
+    }
+    std::ifstream cpuListFile{entry.path() / "cpulist"};
+    std::string cpuList;
+    if (!cpuListFile || !std::getline(cpuListFile, cpuList)) {
+      continue;
+    }
+    try {
+      result.push_back(
+          Node{parseNumber(id.substr(4), id), parseCpuList(cpuList)});
+    } catch (const std::exception&) {
+      return {};
+    }
+  }
+  if (ec) {
+    return {};
+  }
+  std::ranges::sort(result, std::less{}, &Node::id_);
+  return result;
+}
+
+// _____________________________________________________________________________
+bool pinCurrentThreadToCpus(
+    [[maybe_unused]] const std::vector<size_t>& cpus) {
+#ifdef __linux__
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (size_t cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &cpuSet);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+  return false;
+#endif
+}
+
+// _____________________________________________________________________________
+InterleaveMemoryOfCurrentThread::InterleaveMemoryOfCurrentThread(
+    [[maybe_unused]] const std::vector<Node>& nodes) {
+#ifdef __linux__
+  if (nodes.size() < 2) {
+    return;
+  }
+  constexpr size_t bitsPerWord = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> nodeMask(nodes.back().id_ / bitsPerWord + 1, 0);
+  for (const auto& node : nodes) {
+    nodeMask[node.id_ / bitsPerWord] |= 1UL << (node.id_ % bitsPerWord);
+  }
+  // Like `libnuma`, pass one more than the number of bits, because the kernel
+  // ignores the last one.
+  isActive_ = syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, nodeMask.data(),
+                      nodeMask.size() * bitsPerWord + 1) == 0;
+#endif
+}
+
+// _____________________________________________________________________________
+InterleaveMemoryOfCurrentThread::~InterleaveMemoryOfCurrentThread() {
+#ifdef __linux__
+  if (isActive_) {
+    syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+  }
+#endif
+}
+
+}  // namespace ad_utility::numa
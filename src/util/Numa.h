@@ -0,0 +1,57 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+// Helpers for the NUMA-aware placement of memory and threads on Linux. They
+// only use the system calls and the `sysfs` of the kernel (no `libnuma`). On
+// other platforms or if the topology is unknown, there is a single node, and
+// the functions have no effect.
+namespace ad_utility::numa {
+
+// A NUMA node with its CPUs.
+struct Node {
+  size_t id_;
+  std::vector<size_t> cpus_;
+  bool operator==(const Node&) const = default;
+};
+
+// Parse a list of CPUs in the format of the kernel, e.g. "0-3,8,10-11". Throw
+// if the list is malformed.
+std::vector<size_t> parseCpuList(std::string_view cpuList);
+
+// The NUMA nodes of the machine, sorted by their ID, as read from the
+// `sysfsDirectory` (one subdirectory `node<id>` with a file `cpulist` per
+// node). Return an empty vector if the topology cannot be read.
+std::vector<Node> getNodes(
+    const std::filesystem::path& sysfsDirectory = "/sys/devices/system/node");
+
+// Restrict the calling thread to the `cpus`. Return false if this is not
+// possible (e.g. if the `cpus` are empty or not available to the process).
+bool pinCurrentThreadToCpus(const std::vector<size_t>& cpus);
+
+// While an object of this class is alive, the pages of memory that are first
+// touched by the thread that created it are distributed round-robin among the
+// `nodes`, s.t. data that is read by the threads on all nodes (e.g. the
+// vocabulary and the metadata of the permutations) is not placed on a single
+// node. The default memory policy is restored by the destructor.
+class InterleaveMemoryOfCurrentThread {
+  bool isActive_ = false;
+
+ public:
+  explicit InterleaveMemoryOfCurrentThread(const std::vector<Node>& nodes);
+  ~InterleaveMemoryOfCurrentThread();
+  InterleaveMemoryOfCurrentThread(const InterleaveMemoryOfCurrentThread&) =
+      delete;
+  InterleaveMemoryOfCurrentThread& operator=(
+      const InterleaveMemoryOfCurrentThread&) = delete;
+
+  // False if the memory policy could not be set, e.g. for less than two nodes.
+  bool isActive() const { return isActive_; }
+};
+
+}  // namespace ad_utility::numa
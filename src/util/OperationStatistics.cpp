@@ -0,0 +1,106 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "util/OperationStatistics.h"
+
+#include <algorithm>
+
+namespace ad_utility {
+
+namespace {
+thread_local OperationStatistics* statisticsOfThread = nullptr;
+}  // namespace
+
+// _____________________________________________________________________________
+OperationStatistics* OperationStatistics::current() {
+  return statisticsOfThread;
+}
+
+// _____________________________________________________________________________
+OperationStatistics::Scope::Scope(OperationStatistics* statistics)
+    : previous_{statisticsOfThread} {
+  statisticsOfThread = statistics;
+  if (statistics != nullptr) {
+    std::lock_guard lock{statistics->threadsMutex_};
+    statistics->threads_.insert(std::this_thread::get_id());
+  }
+}
+
+// _____________________________________________________________________________
+OperationStatistics::Scope::~Scope() { statisticsOfThread = previous_; }
+
+// _____________________________________________________________________________
+void OperationStatistics::addBytesRead(size_t numBytes) {
+  if (auto* statistics = current()) {
+    statistics->numBytesRead_ += numBytes;
+  }
+}
+
+// _____________________________________________________________________________
+void OperationStatistics::addBlocksRead(size_t numBlocks) {
+  if (auto* statistics = current()) {
+    statistics->numBlocksRead_ += numBlocks;
+  }
+}
+
+// _____________________________________________________________________________
+void OperationStatistics::addBlocksSkipped(size_t numBlocks) {
+  if (auto* statistics = current()) {
+    statistics->numBlocksSkipped_ += numBlocks;
+  }
+}
+
+// _____________________________________________________________________________
+void OperationStatistics::addVocabularyLookups(size_t numLookups) {
+  if (auto* statistics = current()) {
+    statistics->numVocabularyLookups_ += numLookups;
+  }
+}
+
+// _____________________________________________________________________________
+void OperationStatistics::addAllocation(size_t numBytes) {
+  auto* statistics = current();
+  if (statistics == nullptr) {
+    return;
+  }
+  uint64_t memory = statistics->currentMemory_ += numBytes;
+  uint64_t peak = statistics->peakMemory_.load();
+  while (memory > peak &&
+         !statistics->peakMemory_.compare_exchange_weak(peak, memory)) {
+  }
+}
+
+// _____________________________________________________________________________
+void OperationStatistics::addDeallocation(size_t numBytes) {
+  auto* statistics = current();
+  if (statistics == nullptr) {
+    return;
+  }
+  uint64_t memory = statistics->currentMemory_.load();
+  while (!statistics->currentMemory_.compare_exchange_weak(
+      memory, memory - std::min<uint64_t>(memory, numBytes))) {
+  }
+}
+
+// _____________________________________________________________________________
+OperationStatistics::DecompressionTimer::DecompressionTimer() {
+  if (statistics_ != nullptr) {
+    begin_ = std::chrono::steady_clock::now();
+  }
+}
+
+// _____________________________________________________________________________
+OperationStatistics::DecompressionTimer::~DecompressionTimer() {
+  if (statistics_ != nullptr) {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin_);
+    statistics_->decompressionTimeMicroseconds_ += duration.count();
+  }
+}
+
+// _____________________________________________________________________________
+size_t OperationStatistics::numThreads() const {
+  std::lock_guard lock{threadsMutex_};
+  return threads_.size();
+}
+}  // namespace ad_utility
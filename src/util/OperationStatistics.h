@@ -0,0 +1,100 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace ad_utility {
+
+// Counters of the resources that were used for the computation of a single
+// operation: the bytes and blocks that were read from the index permutations,
+// the time spent on the decompression of the blocks, the number of vocabulary
+// lookups, the peak of the memory that was allocated via an
+// `AllocatorWithLimit`, and the number of threads.
+//
+// The counters are updated by the code that uses the resources via the static
+// `add...` functions below, which update the statistics that are currently
+// set for the thread (see `Scope`, which is also used to propagate the
+// statistics to worker threads). If no statistics are set, which is the
+// default, the functions are cheap no-ops. The statistics of nested scopes are
+// not added to the outer ones, so each operation only counts what it used
+// itself, and not what its children used.
+class OperationStatistics {
+  std::atomic<uint64_t> numBytesRead_ = 0;
+  std::atomic<uint64_t> numBlocksRead_ = 0;
+  std::atomic<uint64_t> numBlocksSkipped_ = 0;
+  std::atomic<uint64_t> decompressionTimeMicroseconds_ = 0;
+  std::atomic<uint64_t> numVocabularyLookups_ = 0;
+  // The memory that is currently allocated, and its maximum. Memory that is
+  // deallocated with other statistics than it was allocated with (e.g. the
+  // result of a child operation) only reduces the current memory down to
+  // zero.
+  std::atomic<uint64_t> currentMemory_ = 0;
+  std::atomic<uint64_t> peakMemory_ = 0;
+  // The threads on which the statistics were set.
+  mutable std::mutex threadsMutex_;
+  // Note: This header is included by `AllocatorWithLimit.h`, so it only uses
+  // the standard library.
+  std::unordered_set<std::thread::id> threads_;
+
+ public:
+  OperationStatistics() = default;
+  OperationStatistics(const OperationStatistics&) = delete;
+  OperationStatistics& operator=(const OperationStatistics&) = delete;
+
+  // The statistics of the current thread, `nullptr` if there are none.
+  static OperationStatistics* current();
+
+  // Set the `statistics` of the current thread for the lifetime of the
+  // `Scope`. The previous statistics are restored at the end.
+  class Scope {
+    OperationStatistics* previous_;
+
+   public:
+    explicit Scope(OperationStatistics* statistics);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+  // Update the statistics of the current thread (if there are any).
+  static void addBytesRead(size_t numBytes);
+  static void addBlocksRead(size_t numBlocks = 1);
+  static void addBlocksSkipped(size_t numBlocks);
+  static void addVocabularyLookups(size_t numLookups = 1);
+  static void addAllocation(size_t numBytes);
+  static void addDeallocation(size_t numBytes);
+
+  // Measure the time from the construction to the destruction as
+  // decompression time of the statistics of the current thread. No time is
+  // measured if there are no statistics.
+  class DecompressionTimer {
+    OperationStatistics* statistics_ = current();
+    std::chrono::steady_clock::time_point begin_;
+
+   public:
+    DecompressionTimer();
+    ~DecompressionTimer();
+    DecompressionTimer(const DecompressionTimer&) = delete;
+    DecompressionTimer& operator=(const DecompressionTimer&) = delete;
+  };
+
+  // Access to the counters.
+  uint64_t numBytesRead() const { return numBytesRead_; }
+  uint64_t numBlocksRead() const { return numBlocksRead_; }
+  uint64_t numBlocksSkipped() const { return numBlocksSkipped_; }
+  std::chrono::microseconds decompressionTime() const {
+    return std::chrono::microseconds{decompressionTimeMicroseconds_.load()};
+  }
+  uint64_t numVocabularyLookups() const { return numVocabularyLookups_; }
+  uint64_t peakMemory() const { return peakMemory_; }
+  size_t numThreads() const;
+};
+}  // namespace ad_utility
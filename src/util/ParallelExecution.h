@@ -0,0 +1,67 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace ad_utility {
+
+// Run `function(i)` for all `i` in `[0, numTasks)` concurrently on separate
+// threads and wait until all of them have finished. An exception that is
+// thrown by one of the tasks is rethrown in the calling thread. A single task
+// is run directly on the calling thread.
+inline void runConcurrently(size_t numTasks,
+                            const std::function<void(size_t)>& function) {
+  if (numTasks == 1) {
+    function(0);
+    return;
+  }
+  std::vector<std::future<void>> futures;
+  futures.reserve(numTasks);
+  for (size_t i = 0; i < numTasks; ++i) {
+    futures.push_back(std::async(std::launch::async, function, i));
+  }
+  // Wait for all tasks first, s.t. no task is still running when an exception
+  // is propagated.
+  std::ranges::for_each(futures, &std::future<void>::wait);
+  std::ranges::for_each(futures, &std::future<void>::get);
+}
+
+// Split the rows `[0, numRows)` into morsels of `morselSize` consecutive rows
+// and call `function(morselIndex, beginRow, endRow)` for each of them. The
+// morsels are processed concurrently on (at most) `numThreads` threads, each
+// of which takes the next unprocessed morsel when it has finished one, s.t.
+// the load is balanced also if the morsels take different times. After an
+// exception in one of the morsels, the remaining morsels are skipped and the
+// exception is rethrown.
+inline void forEachMorselConcurrently(
+    size_t numRows, size_t morselSize, size_t numThreads,
+    const std::function<void(size_t, size_t, size_t)>& function) {
+  morselSize = std::max(morselSize, size_t{1});
+  size_t numMorsels = (numRows + morselSize - 1) / morselSize;
+  if (numMorsels == 0) {
+    return;
+  }
+  std::atomic<size_t> nextMorsel = 0;
+  std::atomic<bool> hasFailed = false;
+  numThreads = std::clamp(numThreads, size_t{1}, numMorsels);
+  runConcurrently(numThreads, [&](size_t) {
+    for (size_t morsel = nextMorsel++; morsel < numMorsels && !hasFailed;
+         morsel = nextMorsel++) {
+      try {
+        size_t beginRow = morsel * morselSize;
+        function(morsel, beginRow, std::min(beginRow + morselSize, numRows));
+      } catch (...) {
+        hasFailed = true;
+        throw;
+      }
+    }
+  });
+}
+
+}  // namespace ad_utility
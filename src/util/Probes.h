@@ -0,0 +1,53 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// Static tracepoints (USDT probes) on the hot paths of the engine, which can
+// be used to profile a running server with eBPF tools like `bpftrace`, e.g.
+//
+//   bpftrace -e 'usdt:./ServerMain:qlever:operation_end { @ = hist(arg4); }'
+//
+// A probe is a single `nop` instruction unless a tracer is attached (its
+// arguments are still evaluated, so they have to be cheap). The probes are
+// only compiled in if `sys/sdt.h` is available (see `ENABLE_USDT_PROBES` in
+// the `CMakeLists.txt`), otherwise `QLEVER_PROBE` expands to nothing and its
+// arguments are not evaluated. The arguments of a probe must be integers or
+// pointers (e.g. the `c_str()` of a string).
+//
+// The probes of the `qlever` provider and their arguments are:
+//   operation_start   descriptor, hash of the cache key
+//   operation_end     descriptor, hash of the cache key, cache status,
+//                     number of rows (0 for lazy results), time in ms
+//   operation_failed  descriptor, hash of the cache key, time in ms
+//   cache_lookup      hash of the cache key, cache status
+//   block_read_start  offset in the file, number of bytes
+//   block_read_end    offset in the file, number of bytes
+//   column_decompress_start  number of rows
+//   column_decompress_end    number of rows
+//   allocation_failed number of bytes to allocate, number of bytes left
+//   sort_start        number of rows (0 for lazy inputs), number of columns
+//   sort_end          number of rows (0 for lazy results), number of columns
+//   request_start     HTTP method (`boost::beast::http::verb`), pointer to and
+//                     size of the target
+//   request_end       HTTP method, pointer to and size of the target, time in
+//                     ms
+// Probes that come in `_start`/`_end` pairs are emitted on the same thread,
+// s.t. tracers can measure the time between them.
+#ifdef QLEVER_ENABLE_USDT_PROBES
+#include <sys/sdt.h>
+#define QLEVER_PROBE(name, ...) STAP_PROBEV(qlever, name, __VA_ARGS__)
+#else
+#define QLEVER_PROBE(name, ...) static_cast<void>(0)
+#endif
+
+namespace ad_utility::probes {
+// The hash of a cache key, which identifies an operation across the probes.
+inline uint64_t hashOfCacheKey(std::string_view cacheKey) {
+  return std::hash<std::string_view>{}(cacheKey);
+}
+}  // namespace ad_utility::probes
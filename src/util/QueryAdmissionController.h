@@ -0,0 +1,196 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/Exception.h"
+#include "util/MemorySize/MemorySize.h"
+
+namespace ad_utility {
+
+// The priority class of a query. Queries of a higher class are always
+// admitted before all waiting queries of a lower class.
+enum class QueryPriority { Normal, High };
+
+// A controller that limits the number of queries that are processed at the
+// same time and the sum of the memory that is reserved for them. Queries that
+// can't be admitted immediately are queued (ordered by priority and then by
+// arrival) and admitted as soon as enough running queries have finished. The
+// queue is processed strictly in order, s.t. a query with a large memory
+// reservation is not starved by a stream of small queries.
+class QueryAdmissionController {
+ public:
+  // The statistics of the controller, e.g. for `cmd=stats`.
+  struct Statistics {
+    size_t numRunning_ = 0;
+    size_t numQueued_ = 0;
+    MemorySize reservedMemory_ = MemorySize::bytes(0);
+    size_t numAdmitted_ = 0;
+    // The time between the request and the admission of the queries.
+    std::chrono::milliseconds totalWaitTime_{0};
+    std::chrono::milliseconds maxWaitTime_{0};
+  };
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // The data that is shared between the controller and its `Ticket`s.
+  struct State {
+    std::mutex mutex_;
+    size_t maxNumRunning_;
+    MemorySize memoryBudget_;
+    Statistics statistics_;
+    struct Waiter {
+      QueryPriority priority_;
+      MemorySize memory_;
+      Clock::time_point queuedAt_;
+      std::function<void()> onAdmission_;
+    };
+    std::list<Waiter> queue_;
+  };
+  std::shared_ptr<State> state_;
+
+ public:
+  // As long as a `Ticket` exists, the memory that was reserved for its query
+  // stays reserved and the query counts as running. A default-constructed or
+  // moved-from ticket holds no reservation.
+  class Ticket {
+   private:
+    std::shared_ptr<State> state_;
+    MemorySize memory_ = MemorySize::bytes(0);
+    friend class QueryAdmissionController;
+    Ticket(std::shared_ptr<State> state, MemorySize memory)
+        : state_{std::move(state)}, memory_{memory} {}
+
+   public:
+    Ticket() = default;
+    Ticket(Ticket&& other) noexcept = default;
+    Ticket& operator=(Ticket&& other) noexcept {
+      release();
+      state_ = std::move(other.state_);
+      memory_ = other.memory_;
+      return *this;
+    }
+    ~Ticket() { release(); }
+
+    // The memory that is reserved by this ticket.
+    MemorySize reservedMemory() const { return memory_; }
+
+    // Release the reservation and admit the waiting queries that now fit.
+    void release() {
+      if (auto state = std::move(state_)) {
+        QueryAdmissionController::release(*state, memory_);
+      }
+    }
+  };
+
+  // A controller that admits at most `maxNumRunning` queries at the same time,
+  // for which at most `memoryBudget` is reserved in total.
+  QueryAdmissionController(size_t maxNumRunning, MemorySize memoryBudget)
+      : state_{std::make_shared<State>()} {
+    AD_CONTRACT_CHECK(maxNumRunning > 0);
+    state_->maxNumRunning_ = maxNumRunning;
+    state_->memoryBudget_ = memoryBudget;
+  }
+
+  // Request the admission of a query for which `memoryEstimate` has to be
+  // reserved (it is capped at the total budget, s.t. a query with a huge
+  // estimate is run alone instead of never). `onAdmission` is called with the
+  // `Ticket` of the query as soon as it is admitted, either directly from
+  // this function or from the `release` of another ticket (in both cases
+  // without holding the lock of the controller).
+  void requestAdmission(QueryPriority priority, MemorySize memoryEstimate,
+                        std::function<void(Ticket)> onAdmission) {
+    {
+      std::lock_guard lock{state_->mutex_};
+      auto memory = std::min(memoryEstimate, state_->memoryBudget_);
+      // Insert after all waiting queries with at least the same priority.
+      auto position =
+          std::ranges::find_if(state_->queue_, [priority](const auto& waiter) {
+            return waiter.priority_ < priority;
+          });
+      state_->queue_.insert(
+          position, {priority, memory, Clock::now(),
+                     [state = state_, memory,
+                      onAdmission = std::move(onAdmission)]() mutable {
+                       onAdmission(Ticket{std::move(state), memory});
+                     }});
+      ++state_->statistics_.numQueued_;
+    }
+    admitWaiting(*state_);
+  }
+
+  // Change the maximal number of queries that are running at the same time.
+  // If it is increased, the waiting queries that now fit are admitted. If it
+  // is decreased, the running queries are not affected, but no query is
+  // admitted until fewer than `maxNumRunning` are running.
+  void setMaxNumRunning(size_t maxNumRunning) {
+    AD_CONTRACT_CHECK(maxNumRunning > 0);
+    {
+      std::lock_guard lock{state_->mutex_};
+      state_->maxNumRunning_ = maxNumRunning;
+    }
+    admitWaiting(*state_);
+  }
+
+  // Return a copy of the current statistics.
+  Statistics statistics() const {
+    std::lock_guard lock{state_->mutex_};
+    return state_->statistics_;
+  }
+
+ private:
+  // Release the reservation of a query that has finished.
+  static void release(State& state, MemorySize memory) {
+    {
+      std::lock_guard lock{state.mutex_};
+      auto& stats = state.statistics_;
+      AD_CORRECTNESS_CHECK(stats.numRunning_ > 0);
+      --stats.numRunning_;
+      stats.reservedMemory_ -= memory;
+    }
+    admitWaiting(state);
+  }
+
+  // Admit the waiting queries from the front of the queue as long as they fit
+  // into the limits.
+  static void admitWaiting(State& state) {
+    std::vector<std::function<void()>> admitted;
+    {
+      std::lock_guard lock{state.mutex_};
+      auto& stats = state.statistics_;
+      auto fits = [&state, &stats](MemorySize memory) {
+        return stats.numRunning_ < state.maxNumRunning_ &&
+               stats.reservedMemory_ <= state.memoryBudget_ &&
+               memory <= state.memoryBudget_ - stats.reservedMemory_;
+      };
+      auto now = Clock::now();
+      while (!state.queue_.empty() && fits(state.queue_.front().memory_)) {
+        auto& waiter = state.queue_.front();
+        ++stats.numRunning_;
+        stats.reservedMemory_ += waiter.memory_;
+        ++stats.numAdmitted_;
+        --stats.numQueued_;
+        auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - waiter.queuedAt_);
+        stats.totalWaitTime_ += waitTime;
+        stats.maxWaitTime_ = std::max(stats.maxWaitTime_, waitTime);
+        admitted.push_back(std::move(waiter.onAdmission_));
+        state.queue_.pop_front();
+      }
+    }
+    for (auto& onAdmission : admitted) {
+      onAdmission();
+    }
+  }
+};
+
+}  // namespace ad_utility
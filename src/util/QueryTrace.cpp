@@ -0,0 +1,199 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include "util/QueryTrace.h"
+
+#include <absl/strings/str_format.h>
+
+#include <algorithm>
+
+#include "util/Random.h"
+
+namespace ad_utility {
+
+namespace {
+// The trace and the innermost span of the current thread.
+thread_local QueryTrace::Context currentContextOfThread;
+
+// The time between `begin` and `end` in (fractional) microseconds.
+double microseconds(QueryTrace::Clock::time_point begin,
+                    QueryTrace::Clock::time_point end) {
+  return std::chrono::duration<double, std::micro>(end - begin).count();
+}
+}  // namespace
+
+// _____________________________________________________________________________
+QueryTrace::QueryTrace() {
+  SlowRandomIntGenerator<uint64_t> generator;
+  traceId_ = {generator(), generator()};
+}
+
+// _____________________________________________________________________________
+uint64_t QueryTrace::addSpan(std::string name, std::string category,
+                             Clock::time_point begin, uint64_t parentId,
+                             Attributes attributes) {
+  uint64_t id = reserveSpanId();
+  addSpan(id, std::move(name), std::move(category), begin, parentId,
+          std::move(attributes));
+  return id;
+}
+
+// _____________________________________________________________________________
+void QueryTrace::addSpan(uint64_t id, std::string name, std::string category,
+                         Clock::time_point begin, uint64_t parentId,
+                         Attributes attributes) {
+  auto end = Clock::now();
+  std::lock_guard lock{mutex_};
+  auto threadIndex =
+      threadIndices_.try_emplace(std::this_thread::get_id(),
+                                 threadIndices_.size())
+          .first->second;
+  spans_.push_back(Span{std::move(name), std::move(category), threadIndex, id,
+                        parentId, begin, end, std::move(attributes)});
+}
+
+// _____________________________________________________________________________
+std::vector<QueryTrace::Span> QueryTrace::spans() const {
+  std::lock_guard lock{mutex_};
+  return spans_;
+}
+
+// _____________________________________________________________________________
+nlohmann::json QueryTrace::toChromeTrace() const {
+  auto spans = this->spans();
+  std::ranges::sort(spans, std::less{}, &Span::begin_);
+  nlohmann::json events = nlohmann::json::array();
+  size_t numThreads = 0;
+  for (const auto& span : spans) {
+    nlohmann::json args = nlohmann::json::object();
+    for (const auto& [key, value] : span.attributes_) {
+      args[key] = value;
+    }
+    // Complete events (`"ph": "X"`) with the times in microseconds.
+    events.push_back({{"name", span.name_},
+                      {"cat", span.category_},
+                      {"ph", "X"},
+                      {"ts", microseconds(begin_, span.begin_)},
+                      {"dur", microseconds(span.begin_, span.end_)},
+                      {"pid", 1},
+                      {"tid", span.threadIndex_},
+                      {"args", std::move(args)}});
+    numThreads = std::max(numThreads, span.threadIndex_ + 1);
+  }
+  for (size_t i = 0; i < numThreads; ++i) {
+    events.push_back({{"name", "thread_name"},
+                      {"ph", "M"},
+                      {"pid", 1},
+                      {"tid", i},
+                      {"args", {{"name", absl::StrCat("thread ", i)}}}});
+  }
+  return {{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}};
+}
+
+// _____________________________________________________________________________
+nlohmann::json QueryTrace::toOpenTelemetry(std::string_view serviceName) const {
+  auto stringAttribute = [](std::string_view key, std::string_view value) {
+    return nlohmann::json{{"key", key}, {"value", {{"stringValue", value}}}};
+  };
+  auto unixNanos = [this](Clock::time_point time) {
+    auto sinceEpoch = beginSystem_.time_since_epoch() + (time - begin_);
+    return std::to_string(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch)
+            .count());
+  };
+  // The span IDs are only unique within a trace, so the upper half of the
+  // (random) trace ID is mixed into them.
+  auto spanId = [this](uint64_t id) {
+    return absl::StrFormat("%016x", id ^ (traceId_[1] << 32));
+  };
+  auto traceId = absl::StrFormat("%016x%016x", traceId_[0], traceId_[1]);
+
+  nlohmann::json otelSpans = nlohmann::json::array();
+  for (const auto& span : spans()) {
+    nlohmann::json attributes = nlohmann::json::array();
+    attributes.push_back(stringAttribute("qlever.category", span.category_));
+    attributes.push_back(
+        {{"key", "thread.id"},
+         {"value", {{"intValue", std::to_string(span.threadIndex_)}}}});
+    for (const auto& [key, value] : span.attributes_) {
+      attributes.push_back(stringAttribute(key, value));
+    }
+    nlohmann::json otelSpan{{"traceId", traceId},
+                            {"spanId", spanId(span.id_)},
+                            {"name", span.name_},
+                            // SPAN_KIND_INTERNAL
+                            {"kind", 1},
+                            {"startTimeUnixNano", unixNanos(span.begin_)},
+                            {"endTimeUnixNano", unixNanos(span.end_)},
+                            {"attributes", std::move(attributes)}};
+    if (span.parentId_ != 0) {
+      otelSpan["parentSpanId"] = spanId(span.parentId_);
+    }
+    otelSpans.push_back(std::move(otelSpan));
+  }
+  nlohmann::json resource{
+      {"attributes",
+       nlohmann::json::array({stringAttribute("service.name", serviceName)})}};
+  nlohmann::json scopeSpans{{"scope", {{"name", "qlever"}}},
+                            {"spans", std::move(otelSpans)}};
+  return {{"resourceSpans",
+           nlohmann::json::array(
+               {{{"resource", std::move(resource)},
+                 {"scopeSpans", nlohmann::json::array({scopeSpans})}}})}};
+}
+
+// _____________________________________________________________________________
+QueryTrace::Context QueryTrace::currentContext() {
+  return currentContextOfThread;
+}
+
+// _____________________________________________________________________________
+QueryTrace::Scope::Scope(Context context) : previous_{currentContextOfThread} {
+  currentContextOfThread = context;
+}
+
+// _____________________________________________________________________________
+QueryTrace::Scope::Scope(QueryTrace* trace)
+    : Scope{trace == currentContextOfThread.trace_
+                ? currentContextOfThread
+                : Context{trace, 0}} {}
+
+// _____________________________________________________________________________
+QueryTrace::Scope::~Scope() { currentContextOfThread = previous_; }
+
+// _____________________________________________________________________________
+QueryTrace::ScopedSpan::ScopedSpan(std::string_view name,
+                                   std::string_view category)
+    : context_{currentContextOfThread} {
+  if (context_.trace_ == nullptr) {
+    return;
+  }
+  name_ = name;
+  category_ = category;
+  begin_ = Clock::now();
+  // The spans that are recorded in the meantime on this thread are children
+  // of this span.
+  previousSpanId_ = context_.spanId_;
+  context_.spanId_ = context_.trace_->reserveSpanId();
+  currentContextOfThread.spanId_ = context_.spanId_;
+}
+
+// _____________________________________________________________________________
+QueryTrace::ScopedSpan::~ScopedSpan() {
+  if (context_.trace_ == nullptr) {
+    return;
+  }
+  currentContextOfThread.spanId_ = previousSpanId_;
+  context_.trace_->addSpan(context_.spanId_, std::move(name_),
+                           std::move(category_), begin_, previousSpanId_,
+                           std::move(attributes_));
+}
+
+// _____________________________________________________________________________
+void QueryTrace::ScopedSpan::addAttribute(std::string_view key,
+                                          std::string value) {
+  if (context_.trace_ != nullptr) {
+    attributes_.emplace_back(key, std::move(value));
+  }
+}
+}  // namespace ad_utility
@@ -0,0 +1,147 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "util/HashMap.h"
+#include "util/json.h"
+
+namespace ad_utility {
+
+// The trace of the processing of a single query: the spans (named intervals of
+// time) during which certain parts of the query were processed, each recorded
+// on the thread on which it happened. In contrast to the `RuntimeInformation`,
+// which only contains the accumulated times per operation, the trace shows the
+// actual timeline (parallel phases, the time spent waiting for results that
+// are computed by other queries, the reading and decompression of blocks,
+// ...). The trace can be exported in the Chrome trace event format (which can
+// be loaded in `chrome://tracing` or https://ui.perfetto.dev) or as
+// OpenTelemetry spans (in the JSON encoding of OTLP).
+//
+// The spans are recorded via the `ScopedSpan` class below, which records a
+// span for the trace that is currently set for the thread (see `Scope`). If no
+// trace is set, which is the default, the spans are not recorded, which is
+// cheap.
+class QueryTrace {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Attributes = std::vector<std::pair<std::string, std::string>>;
+
+  struct Span {
+    std::string name_;
+    std::string category_;
+    // The threads are numbered in the order in which they record their first
+    // span, starting at 0.
+    size_t threadIndex_;
+    // The IDs of the spans start at 1, the `parentId_` of spans without a
+    // parent is 0.
+    uint64_t id_;
+    uint64_t parentId_;
+    Clock::time_point begin_;
+    Clock::time_point end_;
+    Attributes attributes_;
+  };
+
+  // The trace and the innermost span of a thread, which becomes the parent of
+  // the spans that are recorded next on that thread.
+  struct Context {
+    QueryTrace* trace_ = nullptr;
+    uint64_t spanId_ = 0;
+  };
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<Span> spans_;
+  ad_utility::HashMap<std::thread::id, size_t> threadIndices_;
+  std::atomic<uint64_t> nextSpanId_ = 1;
+  // The time at which the trace was created, on both clocks (the spans are
+  // measured with the monotonic `Clock`, but exported as wall-clock times).
+  Clock::time_point begin_ = Clock::now();
+  std::chrono::system_clock::time_point beginSystem_ =
+      std::chrono::system_clock::now();
+  std::array<uint64_t, 2> traceId_;
+
+ public:
+  QueryTrace();
+
+  // Record a span on the current thread that began at `begin` and ends now.
+  // Return the ID of the span.
+  uint64_t addSpan(std::string name, std::string category,
+                   Clock::time_point begin, uint64_t parentId,
+                   Attributes attributes = {});
+
+  // Reserve the ID for a span that is added later via `addSpan` with an
+  // explicit `id`, s.t. nested spans can already refer to it as their parent.
+  uint64_t reserveSpanId() { return nextSpanId_++; }
+  void addSpan(uint64_t id, std::string name, std::string category,
+               Clock::time_point begin, uint64_t parentId,
+               Attributes attributes);
+
+  // A copy of all the spans that were recorded so far.
+  std::vector<Span> spans() const;
+
+  // The trace in the Chrome trace event format.
+  nlohmann::json toChromeTrace() const;
+
+  // The trace as OpenTelemetry spans, in the JSON encoding of an OTLP
+  // `ExportTraceServiceRequest` (which can be posted to the `/v1/traces`
+  // endpoint of a collector). The `serviceName` becomes the `service.name`
+  // of the resource.
+  nlohmann::json toOpenTelemetry(std::string_view serviceName = "qlever") const;
+
+  // The context of the current thread (with `trace_ == nullptr` if there is no
+  // trace for the current thread).
+  static Context currentContext();
+  static QueryTrace* current() { return currentContext().trace_; }
+
+  // Set the trace of the current thread for the lifetime of the `Scope`. The
+  // previous context is restored at the end. This is used to propagate the
+  // context to worker threads, typically as `Scope{capturedContext}`.
+  class Scope {
+    Context previous_;
+
+   public:
+    explicit Scope(Context context);
+    // Set the `trace` without changing the parent span if the `trace` is
+    // already the trace of the current thread.
+    explicit Scope(QueryTrace* trace);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+  // Record a span from the construction until the destruction of the
+  // `ScopedSpan` for the trace of the current thread (if there is one). The
+  // spans that are recorded on the same thread in the meantime are its
+  // children.
+  class ScopedSpan {
+    Context context_;
+    uint64_t previousSpanId_ = 0;
+    std::string name_;
+    std::string category_;
+    Clock::time_point begin_;
+    Attributes attributes_;
+
+   public:
+    ScopedSpan(std::string_view name, std::string_view category);
+    ~ScopedSpan();
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    // Add an attribute to the span (is a no-op if the span is not recorded).
+    void addAttribute(std::string_view key, std::string value);
+    bool isRecorded() const { return context_.trace_ != nullptr; }
+  };
+};
+}  // namespace ad_utility
@@ -0,0 +1,93 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/jthread.h"
+
+namespace ad_utility {
+
+// A pool of threads that run the tasks that are posted to its executor. Unlike
+// `boost::asio::static_thread_pool`, the number of threads can be changed while
+// tasks are running (e.g. via a runtime parameter of the server). When the
+// pool shrinks, the surplus threads finish their current task and then exit.
+class ResizableThreadPool {
+  // A thread exits as soon as its `stop_` flag is set (after its current task
+  // and at most `STOP_CHECK_INTERVAL` later), and sets `finished_` before it
+  // exits, s.t. it can be joined without blocking.
+  struct Worker {
+    struct Flags {
+      std::atomic<bool> stop_ = false;
+      std::atomic<bool> finished_ = false;
+    };
+    std::shared_ptr<Flags> flags_ = std::make_shared<Flags>();
+    JThread thread_;
+  };
+  static constexpr std::chrono::milliseconds STOP_CHECK_INTERVAL{100};
+
+  boost::asio::io_context ioContext_;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+      workGuard_{ioContext_.get_executor()};
+  mutable std::mutex mutex_;
+  std::vector<Worker> workers_;
+  // The workers that were removed by `resize` and are still exiting.
+  std::vector<Worker> stoppedWorkers_;
+
+ public:
+  explicit ResizableThreadPool(size_t numThreads) { resize(numThreads); }
+
+  // Stop the pool (the tasks that have not started yet are not run) and wait
+  // for the running tasks.
+  ~ResizableThreadPool() {
+    ioContext_.stop();
+    std::lock_guard lock{mutex_};
+    workers_.clear();
+    stoppedWorkers_.clear();
+  }
+
+  ResizableThreadPool(const ResizableThreadPool&) = delete;
+  ResizableThreadPool& operator=(const ResizableThreadPool&) = delete;
+
+  auto getExecutor() { return ioContext_.get_executor(); }
+
+  // Change the number of threads to `numThreads` (at least one).
+  void resize(size_t numThreads) {
+    numThreads = std::max(numThreads, size_t{1});
+    std::lock_guard lock{mutex_};
+    std::erase_if(stoppedWorkers_, [](const Worker& worker) {
+      return worker.flags_->finished_.load();
+    });
+    while (workers_.size() > numThreads) {
+      workers_.back().flags_->stop_ = true;
+      stoppedWorkers_.push_back(std::move(workers_.back()));
+      workers_.pop_back();
+    }
+    while (workers_.size() < numThreads) {
+      Worker worker;
+      worker.thread_ = JThread{[this, flags = worker.flags_]() {
+        while (!flags->stop_ && !ioContext_.stopped()) {
+          ioContext_.run_one_for(STOP_CHECK_INTERVAL);
+        }
+        flags->finished_ = true;
+      }};
+      workers_.push_back(std::move(worker));
+    }
+  }
+
+  // The current number of threads (without the ones that are still exiting).
+  size_t numThreads() const {
+    std::lock_guard lock{mutex_};
+    return workers_.size();
+  }
+};
+
+}  // namespace ad_utility
@@ -0,0 +1,209 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "util/CompressionUsingZstd/ZstdWrapper.h"
+#include "util/File.h"
+#include "util/Log.h"
+#include "util/Serializer/Serializer.h"
+
+namespace ad_utility::serialization {
+
+// A serializer that writes to a file, which is compressed with ZSTD in blocks
+// of (about) `blockSize` uncompressed bytes. Each block is stored as its
+// uncompressed size, its compressed size, and the compressed bytes. A block is
+// compressed and written on a background thread while the next block is
+// serialized. The file can only be read by a `ZstdFileReadSerializer`.
+class ZstdFileWriteSerializer {
+ public:
+  using SerializerType = WriteSerializerTag;
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+  static constexpr int DEFAULT_COMPRESSION_LEVEL = 1;
+
+ private:
+  // The file is stored on the heap, s.t. the background thread can access it
+  // also after this serializer was moved.
+  std::unique_ptr<File> file_;
+  size_t blockSize_;
+  int compressionLevel_;
+  std::vector<char> buffer_;
+  std::future<void> writeFuture_;
+
+ public:
+  explicit ZstdFileWriteSerializer(
+      const std::string& filename, size_t blockSize = DEFAULT_BLOCK_SIZE,
+      int compressionLevel = DEFAULT_COMPRESSION_LEVEL)
+      : file_{std::make_unique<File>(filename, "w")},
+        blockSize_{std::max(blockSize, size_t{1})},
+        compressionLevel_{compressionLevel} {
+    AD_CONTRACT_CHECK(file_->isOpen());
+    buffer_.reserve(blockSize_);
+  }
+
+  ZstdFileWriteSerializer(ZstdFileWriteSerializer&&) noexcept = default;
+  ZstdFileWriteSerializer& operator=(ZstdFileWriteSerializer&& other) noexcept {
+    closeNoThrow();
+    file_ = std::move(other.file_);
+    blockSize_ = other.blockSize_;
+    compressionLevel_ = other.compressionLevel_;
+    buffer_ = std::move(other.buffer_);
+    writeFuture_ = std::move(other.writeFuture_);
+    return *this;
+  }
+
+  ~ZstdFileWriteSerializer() { closeNoThrow(); }
+
+  void serializeBytes(const char* bytePtr, size_t numBytes) {
+    buffer_.insert(buffer_.end(), bytePtr, bytePtr + numBytes);
+    if (buffer_.size() >= blockSize_) {
+      writeBlock();
+    }
+  }
+
+  // Write the remaining bytes and close the file. Rethrow the exceptions of
+  // the background thread.
+  void close() {
+    if (file_ == nullptr || !file_->isOpen()) {
+      return;
+    }
+    writeBlock();
+    if (writeFuture_.valid()) {
+      writeFuture_.get();
+    }
+    file_->close();
+  }
+
+ private:
+  // Compress and write the `buffer_` on the background thread after the
+  // previous block has been written.
+  void writeBlock() {
+    if (writeFuture_.valid()) {
+      writeFuture_.get();
+    }
+    if (buffer_.empty()) {
+      return;
+    }
+    writeFuture_ = std::async(
+        std::launch::async, [file = file_.get(), block = std::move(buffer_),
+                             level = compressionLevel_]() {
+          auto compressed =
+              ZstdWrapper::compress(block.data(), block.size(), level);
+          std::array<uint64_t, 2> sizes{block.size(), compressed.size()};
+          auto numBytes = file->write(sizes.data(), sizeof(sizes));
+          numBytes += file->write(compressed.data(), compressed.size());
+          if (numBytes != sizeof(sizes) + compressed.size()) {
+            throw std::runtime_error{
+                "Writing a block of a ZSTD-compressed file failed"};
+          }
+        });
+    buffer_ = {};
+    buffer_.reserve(blockSize_);
+  }
+
+  // Call `close` in the destructor and the move assignment, where exceptions
+  // can't be propagated.
+  void closeNoThrow() noexcept {
+    try {
+      close();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Closing a ZSTD-compressed file failed: " << e.what()
+                 << std::endl;
+    }
+  }
+};
+
+// Read a file that was written by a `ZstdFileWriteSerializer`. The next block
+// is read and decompressed on a background thread while the current block is
+// deserialized.
+class ZstdFileReadSerializer {
+ public:
+  using SerializerType = ReadSerializerTag;
+
+ private:
+  // The `nextBlock_` is declared after the `file_`, s.t. the background thread
+  // has finished before the `file_` is destroyed.
+  std::unique_ptr<File> file_;
+  std::vector<char> block_;
+  size_t positionInBlock_ = 0;
+  std::future<std::optional<std::vector<char>>> nextBlock_;
+
+ public:
+  explicit ZstdFileReadSerializer(const std::string& filename)
+      : file_{std::make_unique<File>(filename, "r")} {
+    AD_CONTRACT_CHECK(file_->isOpen());
+    readNextBlock();
+  }
+
+  ZstdFileReadSerializer(ZstdFileReadSerializer&&) noexcept = default;
+  ZstdFileReadSerializer& operator=(ZstdFileReadSerializer&& other) noexcept {
+    if (nextBlock_.valid()) {
+      nextBlock_.wait();
+    }
+    nextBlock_ = std::move(other.nextBlock_);
+    file_ = std::move(other.file_);
+    block_ = std::move(other.block_);
+    positionInBlock_ = other.positionInBlock_;
+    return *this;
+  }
+
+  void serializeBytes(char* bytePtr, size_t numBytes) {
+    while (numBytes > 0) {
+      if (positionInBlock_ == block_.size()) {
+        auto block = nextBlock_.get();
+        if (!block.has_value()) {
+          throw SerializationException{
+              "Tried to read from a ZSTD-compressed file, but too few bytes "
+              "were left"};
+        }
+        block_ = std::move(block.value());
+        positionInBlock_ = 0;
+        readNextBlock();
+      }
+      size_t n = std::min(numBytes, block_.size() - positionInBlock_);
+      std::copy_n(block_.data() + positionInBlock_, n, bytePtr);
+      positionInBlock_ += n;
+      bytePtr += n;
+      numBytes -= n;
+    }
+  }
+
+ private:
+  // Read and decompress the next block (`std::nullopt` at the end of the file)
+  // on a background thread.
+  void readNextBlock() {
+    nextBlock_ = std::async(
+        std::launch::async,
+        [file = file_.get()]() -> std::optional<std::vector<char>> {
+          std::array<uint64_t, 2> sizes;
+          auto numBytes = file->read(sizes.data(), sizeof(sizes));
+          if (numBytes == 0) {
+            return std::nullopt;
+          }
+          auto [uncompressedSize, compressedSize] = sizes;
+          std::vector<char> compressed(compressedSize);
+          if (numBytes != sizeof(sizes) ||
+              file->read(compressed.data(), compressedSize) !=
+                  compressedSize) {
+            throw SerializationException{
+                "A block of a ZSTD-compressed file is truncated"};
+          }
+          std::vector<char> block(uncompressedSize);
+          auto decompressedSize = ZstdWrapper::decompressToBuffer(
+              compressed.data(), compressed.size(), block.data(),
+              block.size());
+          AD_CORRECTNESS_CHECK(decompressedSize == uncompressedSize);
+          return block;
+        });
+  }
+};
+
+}  // namespace ad_utility::serialization
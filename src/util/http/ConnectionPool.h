@@ -0,0 +1,142 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "util/Exception.h"
+#include "util/HashMap.h"
+
+namespace ad_utility::httpUtils {
+
+// A pool of connections to remote hosts, s.t. the connections (and their TCP
+// and TLS handshakes) can be reused for several requests to the same host
+// (HTTP keep-alive). The `Client` has to be constructible from a host and a
+// port, and its member function `isReusable()` has to tell whether the last
+// response was read completely and the server allows to keep the connection
+// open.
+template <typename Client>
+class ConnectionPool {
+ private:
+  struct Host {
+    std::vector<std::unique_ptr<Client>> idle_;
+    // The number of connections to this host, including the idle ones.
+    size_t numConnections_ = 0;
+  };
+  std::mutex mutex_;
+  std::condition_variable connectionReleased_;
+  ad_utility::HashMap<std::string, Host> hosts_;
+
+ public:
+  // A connection that was obtained via `acquire`. It is returned to the pool
+  // when it is destroyed.
+  class Connection {
+   private:
+    ConnectionPool* pool_;
+    std::string key_;
+    std::unique_ptr<Client> client_;
+    size_t maxNumIdle_;
+    bool isReused_;
+    friend class ConnectionPool;
+    Connection(ConnectionPool* pool, std::string key,
+               std::unique_ptr<Client> client, size_t maxNumIdle,
+               bool isReused)
+        : pool_{pool},
+          key_{std::move(key)},
+          client_{std::move(client)},
+          maxNumIdle_{maxNumIdle},
+          isReused_{isReused} {}
+
+   public:
+    Connection(Connection&&) = delete;
+    Connection& operator=(Connection&&) = delete;
+    ~Connection() {
+      pool_->release(key_, std::move(client_), maxNumIdle_);
+    }
+
+    Client& operator*() { return *client_; }
+    Client* operator->() { return client_.get(); }
+
+    // True iff the connection was already used for a previous request. Such a
+    // connection might have been closed by the server in the meantime.
+    bool isReused() const { return isReused_; }
+  };
+
+  // Return an idle connection to the `host` and `port`, or establish a new
+  // one. If there already are `maxNumConnections` connections to the host,
+  // block until one of them is released. When the returned connection is
+  // destroyed, it is kept as an idle connection if it is reusable and there
+  // are less than `maxNumIdle` idle connections to the host.
+  std::unique_ptr<Connection> acquire(std::string_view host,
+                                      std::string_view port,
+                                      size_t maxNumConnections,
+                                      size_t maxNumIdle) {
+    AD_CONTRACT_CHECK(maxNumConnections > 0);
+    auto key = absl::StrCat(host, ":", port);
+    {
+      std::unique_lock lock{mutex_};
+      auto& state = hosts_[key];
+      connectionReleased_.wait(lock, [&state, maxNumConnections]() {
+        return !state.idle_.empty() ||
+               state.numConnections_ < maxNumConnections;
+      });
+      if (!state.idle_.empty()) {
+        auto client = std::move(state.idle_.back());
+        state.idle_.pop_back();
+        return std::unique_ptr<Connection>{new Connection{
+            this, std::move(key), std::move(client), maxNumIdle, true}};
+      }
+      ++state.numConnections_;
+    }
+    // Establish the connection without holding the lock.
+    std::unique_ptr<Client> client;
+    try {
+      client = std::make_unique<Client>(host, port);
+    } catch (...) {
+      release(key, nullptr, maxNumIdle);
+      throw;
+    }
+    return std::unique_ptr<Connection>{new Connection{
+        this, std::move(key), std::move(client), maxNumIdle, false}};
+  }
+
+  // The number of idle connections to all hosts.
+  size_t numIdle() {
+    std::lock_guard lock{mutex_};
+    size_t result = 0;
+    for (const auto& [key, host] : hosts_) {
+      result += host.idle_.size();
+    }
+    return result;
+  }
+
+ private:
+  // Keep the `client` as an idle connection or close it (if it is not
+  // reusable, or there are enough idle connections to the host already). A
+  // `nullptr` only releases the slot of a connection.
+  void release(const std::string& key, std::unique_ptr<Client> client,
+               size_t maxNumIdle) {
+    {
+      std::lock_guard lock{mutex_};
+      auto& state = hosts_[key];
+      if (client && client->isReusable() && state.idle_.size() < maxNumIdle) {
+        state.idle_.push_back(std::move(client));
+      } else {
+        AD_CORRECTNESS_CHECK(state.numConnections_ > 0);
+        --state.numConnections_;
+      }
+    }
+    connectionReleased_.notify_all();
+    // If the `client` was not kept, its connection is closed here, outside of
+    // the lock.
+  }
+};
+
+}  // namespace ad_utility::httpUtils
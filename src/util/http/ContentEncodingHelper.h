@@ -7,16 +7,20 @@
 #include <absl/strings/ascii.h>
 #include <absl/strings/str_split.h>
 
+#include <algorithm>
+#include <ranges>
+
 #include "util/http/beast.h"
 
 namespace ad_utility::content_encoding {
 
-enum class CompressionMethod { NONE, DEFLATE, GZIP };
+enum class CompressionMethod { NONE, DEFLATE, GZIP, ZSTD };
 
 namespace detail {
 
 constexpr std::string_view DEFLATE = "deflate";
 constexpr std::string_view GZIP = "gzip";
+constexpr std::string_view ZSTD = "zstd";
 
 inline CompressionMethod getCompressionMethodFromAcceptEncodingHeader(
     std::vector<std::string_view> acceptedEncodings) {
@@ -24,13 +28,31 @@ inline CompressionMethod getCompressionMethodFromAcceptEncodingHeader(
     return std::find(acceptedEncodings.begin(), acceptedEncodings.end(),
                      value) != acceptedEncodings.end();
   };
-  if (contains(DEFLATE)) {
+  // Zstd is preferred, because it compresses better and faster than the
+  // other methods.
+  if (contains(ZSTD)) {
+    return CompressionMethod::ZSTD;
+  } else if (contains(DEFLATE)) {
     return CompressionMethod::DEFLATE;
   } else if (contains(GZIP)) {
     return CompressionMethod::GZIP;
   }
   return CompressionMethod::NONE;
 }
+
+// Return true iff the `parameter` of an encoding in an `Accept-Encoding` header
+// is a quality value of zero (e.g. `q=0` or `q=0.000`), which means that the
+// encoding is not acceptable.
+inline bool isZeroQualityValue(std::string_view parameter) {
+  parameter = absl::StripAsciiWhitespace(parameter);
+  if (!parameter.starts_with("q=0")) {
+    return false;
+  }
+  parameter.remove_prefix(3);
+  return parameter.empty() ||
+         (parameter.starts_with('.') &&
+          parameter.find_first_not_of('0', 1) == std::string_view::npos);
+}
 }  // namespace detail
 
 using boost::beast::http::field;
@@ -46,8 +68,15 @@ CompressionMethod getCompressionMethodForRequest(
     std::string_view headerContent = current->value();
     std::vector<std::string_view> tokens =
         absl::StrSplit(headerContent, absl::ByChar(','));
-    for (auto token : tokens) {
-      acceptedHeaders.push_back(absl::StripAsciiWhitespace(token));
+    for (std::string_view token : tokens) {
+      // Ignore the parameters of the encoding (e.g. `gzip;q=0.5`), unless the
+      // encoding is explicitly not acceptable (`q=0`).
+      std::vector<std::string_view> parameters =
+          absl::StrSplit(token, absl::ByChar(';'));
+      if (std::ranges::none_of(parameters | std::views::drop(1),
+                               &detail::isZeroQualityValue)) {
+        acceptedHeaders.push_back(absl::StripAsciiWhitespace(parameters[0]));
+      }
     }
   }
   return detail::getCompressionMethodFromAcceptEncodingHeader(acceptedHeaders);
@@ -61,6 +90,8 @@ void setContentEncodingHeaderForCompressionMethod(
     header.insert(field::content_encoding, detail::DEFLATE);
   } else if (method == CompressionMethod::GZIP) {
     header.insert(field::content_encoding, detail::GZIP);
+  } else if (method == CompressionMethod::ZSTD) {
+    header.insert(field::content_encoding, detail::ZSTD);
   }
 }
 
@@ -76,6 +107,9 @@ inline std::ostream& operator<<(std::ostream& out,
     case CompressionMethod::GZIP:
       out << "CompressionMethod::GZIP";
       break;
+    case CompressionMethod::ZSTD:
+      out << "CompressionMethod::ZSTD";
+      break;
   }
   return out;
 }
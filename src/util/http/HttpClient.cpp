@@ -8,6 +8,8 @@
 #include <string>
 
 #include "absl/strings/str_cat.h"
+#include "global/Constants.h"
+#include "util/http/ConnectionPool.h"
 #include "util/http/HttpUtils.h"
 #include "util/http/beast.h"
 
@@ -82,30 +84,70 @@ std::istringstream HttpClientImpl<StreamType>::sendRequest(
     const boost::beast::http::verb& method, std::string_view host,
     std::string_view target, std::string_view requestBody,
     std::string_view contentTypeHeader, std::string_view acceptHeader) {
+  // Collect the chunks of the response.
+  std::string responseBody;
+  for (const std::string& chunk :
+       sendRequestStreaming(method, std::string{host}, std::string{target},
+                            std::string{requestBody},
+                            std::string{contentTypeHeader},
+                            std::string{acceptHeader})) {
+    responseBody.append(chunk);
+  }
+  return std::istringstream{std::move(responseBody)};
+}
+
+// ____________________________________________________________________________
+template <typename StreamType>
+cppcoro::generator<std::string>
+HttpClientImpl<StreamType>::sendRequestStreaming(
+    boost::beast::http::verb method, std::string host, std::string target,
+    std::string requestBody, std::string contentTypeHeader,
+    std::string acceptHeader) {
   // Check that we have a stream (created in the constructor).
   AD_CORRECTNESS_CHECK(stream_);
+  // The connection can only be reused after the response has been read
+  // completely.
+  isReusable_ = false;
 
   // Set up the request.
   http::request<http::string_body> request;
   request.method(method);
   request.target(target);
+  request.keep_alive(true);
   request.set(http::field::host, host);
   request.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
   request.set(http::field::accept, acceptHeader);
   request.set(http::field::content_type, contentTypeHeader);
   request.set(http::field::content_length, std::to_string(requestBody.size()));
-  request.body() = requestBody;
+  request.body() = std::move(requestBody);
 
-  // Send the request, receive the response (unlimited body size), and return
-  // the body as a `std::istringstream`.
+  // Send the request, receive the header of the response, and then read the
+  // body (unlimited size) in chunks of at most the size of the `chunk`.
+  // See https://www.boost.org/doc/libs/master/libs/beast/doc/html/beast/more_examples/send_child_process_output.html
+  // for this (documented) usage of the `buffer_body`.
   http::write(*stream_, request);
   beast::flat_buffer buffer;
-  http::response_parser<http::dynamic_body> response_parser;
-  response_parser.body_limit((std::numeric_limits<std::uint64_t>::max)());
-  http::read(*stream_, buffer, response_parser);
-  std::istringstream responseBody(
-      beast::buffers_to_string(response_parser.get().body().data()));
-  return responseBody;
+  http::response_parser<http::buffer_body> responseParser;
+  responseParser.body_limit((std::numeric_limits<std::uint64_t>::max)());
+  http::read_header(*stream_, buffer, responseParser);
+  std::string chunk;
+  while (!responseParser.is_done()) {
+    chunk.resize(1 << 16);
+    auto& body = responseParser.get().body();
+    body.data = chunk.data();
+    body.size = chunk.size();
+    boost::system::error_code ec;
+    http::read(*stream_, buffer, responseParser, ec);
+    // The error `need_buffer` only signals that the `chunk` is full.
+    if (ec && ec != http::error::need_buffer) {
+      throw boost::system::system_error{ec};
+    }
+    chunk.resize(chunk.size() - body.size);
+    if (!chunk.empty()) {
+      co_yield chunk;
+    }
+  }
+  isReusable_ = responseParser.keep_alive();
 }
 
 // ____________________________________________________________________________
@@ -149,15 +191,63 @@ std::istringstream sendHttpOrHttpsRequest(
     ad_utility::httpUtils::Url url, const boost::beast::http::verb& method,
     std::string_view requestData, std::string_view contentTypeHeader,
     std::string_view acceptHeader) {
-  auto sendRequest = [&]<typename Client>() {
-    Client client{url.host(), url.port()};
-    return client.sendRequest(method, url.host(), url.target(), requestData,
-                              contentTypeHeader, acceptHeader);
-  };
+  std::string responseBody;
+  for (const std::string& chunk : sendHttpOrHttpsRequestStreaming(
+           std::move(url), method, std::string{requestData},
+           std::string{contentTypeHeader}, std::string{acceptHeader})) {
+    responseBody.append(chunk);
+  }
+  return std::istringstream{std::move(responseBody)};
+}
+
+// ____________________________________________________________________________
+namespace {
+// Helper for `sendHttpOrHttpsRequestStreaming`, which holds a connection of the
+// global pool for the `Client` while the chunks are yielded.
+template <typename Client>
+cppcoro::generator<std::string> sendRequestWithPooledClient(
+    Url url, boost::beast::http::verb method, std::string requestData,
+    std::string contentTypeHeader, std::string acceptHeader) {
+  static ad_utility::httpUtils::ConnectionPool<Client> pool;
+  while (true) {
+    auto connection = pool.acquire(
+        url.host(), url.port(),
+        RuntimeParameters().get<"http-client-max-connections-per-host">(),
+        RuntimeParameters().get<"http-client-max-idle-connections-per-host">());
+    bool hasReceivedData = false;
+    try {
+      for (std::string& chunk : (*connection)->sendRequestStreaming(
+               method, std::string{url.host()}, std::string{url.target()},
+               requestData, contentTypeHeader, acceptHeader)) {
+        hasReceivedData = true;
+        co_yield chunk;
+      }
+      co_return;
+    } catch (const boost::system::system_error&) {
+      // The server may close an idle connection at any time, in which case
+      // the request fails before anything is received. The failed connection
+      // is not reusable and thus closed, and we retry.
+      if (hasReceivedData || !connection->isReused()) {
+        throw;
+      }
+    }
+  }
+}
+}  // namespace
+
+// ____________________________________________________________________________
+cppcoro::generator<std::string> sendHttpOrHttpsRequestStreaming(
+    ad_utility::httpUtils::Url url, boost::beast::http::verb method,
+    std::string requestData, std::string contentTypeHeader,
+    std::string acceptHeader) {
   if (url.protocol() == Url::Protocol::HTTP) {
-    return sendRequest.operator()<HttpClient>();
+    return sendRequestWithPooledClient<HttpClient>(
+        std::move(url), method, std::move(requestData),
+        std::move(contentTypeHeader), std::move(acceptHeader));
   } else {
     AD_CORRECTNESS_CHECK(url.protocol() == Url::Protocol::HTTPS);
-    return sendRequest.operator()<HttpsClient>();
+    return sendRequestWithPooledClient<HttpsClient>(
+        std::move(url), method, std::move(requestData),
+        std::move(contentTypeHeader), std::move(acceptHeader));
   }
 }
@@ -18,6 +18,7 @@
 #include <sstream>
 #include <string>
 
+#include "util/Generator.h"
 #include "util/http/HttpUtils.h"
 #include "util/http/beast.h"
 
@@ -41,15 +42,27 @@ class HttpClientImpl {
   // `http::verb::post`) and return the body of the reponse (possibly very
   // large) as an `std::istringstream`. The same connection can be used for
   // multiple requests in a row.
-  //
-  // TODO: Read and process the response in chunks. Here is a code example:
-  // https://stackoverflow.com/questions/69011767/handling-large-http-response-using-boostbeast
   std::istringstream sendRequest(
       const boost::beast::http::verb& method, std::string_view host,
       std::string_view target, std::string_view requestBody = "",
       std::string_view contentTypeHeader = "text/plain",
       std::string_view acceptHeader = "text/plain");
 
+  // Same as `sendRequest`, but yield the body of the response in chunks as
+  // soon as they arrive, s.t. the caller can process a large response while it
+  // is still being transferred. The request is sent when the generator is
+  // started. The client must stay alive until the generator is done.
+  cppcoro::generator<std::string> sendRequestStreaming(
+      boost::beast::http::verb method, std::string host, std::string target,
+      std::string requestBody = "",
+      std::string contentTypeHeader = "text/plain",
+      std::string acceptHeader = "text/plain");
+
+  // True iff the response to the last request was read completely and the
+  // server allows to send further requests via this connection (HTTP
+  // keep-alive).
+  bool isReusable() const { return isReusable_; }
+
   // Simple way to establish a websocket connection
   boost::beast::http::response<boost::beast::http::string_body>
   sendWebSocketHandshake(const boost::beast::http::verb& method,
@@ -61,6 +74,7 @@ class HttpClientImpl {
   boost::asio::io_context io_context_;
   std::unique_ptr<boost::asio::ssl::context> ssl_context_;
   std::unique_ptr<StreamType> stream_;
+  bool isReusable_ = false;
 };
 
 // Instantiation for HTTP.
@@ -73,10 +87,25 @@ using HttpsClient =
 // Global convenience function for sending a request (default: GET) to the given
 // URL and obtaining the result as a `std::istringstream`. The protocol (HTTP or
 // HTTPS) is chosen automatically based on the URL. The `requestBody` is the
-// payload sent for POST requests (default: empty).
+// payload sent for POST requests (default: empty). The connection is reused
+// the same way as for `sendHttpOrHttpsRequestStreaming` below.
 std::istringstream sendHttpOrHttpsRequest(
     ad_utility::httpUtils::Url url,
     const boost::beast::http::verb& method = boost::beast::http::verb::get,
     std::string_view postData = "",
     std::string_view contentTypeHeader = "text/plain",
     std::string_view acceptHeader = "text/plain");
+
+// Same as `sendHttpOrHttpsRequest`, but yield the body of the response in
+// chunks as soon as they arrive (see `HttpClientImpl::sendRequestStreaming`).
+// The connection is taken from a global pool of connections and returned to
+// it when the generator is destroyed, s.t. it can be reused by the next
+// request to the same host (see the runtime parameters
+// `http-client-max-connections-per-host` and
+// `http-client-max-idle-connections-per-host`). If a reused connection turns
+// out to be closed, the request is repeated once with a new connection.
+cppcoro::generator<std::string> sendHttpOrHttpsRequestStreaming(
+    ad_utility::httpUtils::Url url,
+    boost::beast::http::verb method = boost::beast::http::verb::get,
+    std::string postData = "", std::string contentTypeHeader = "text/plain",
+    std::string acceptHeader = "text/plain");
@@ -88,8 +88,10 @@ class AcceptHeaderQleverVisitor : public AcceptHeaderVisitor {
     // TODO<joka921> Implement proper parsing of parameters. For now we just
     // ignore them which is more graceful than always throwing, because a lot
     // of agents (especially web browsers) automatically add some default
-    // parameters.
-    if (!ctx->parameter().empty()) {
+    // parameters. The parameters of the exchange format of QLever are read by
+    // the server itself (see `IdTableExchange.h`).
+    if (!ctx->parameter().empty() &&
+        !(ctx->subtype() && ctx->subtype()->getText() == "x-qlever-idtable")) {
       LOG(WARN) << "Ignoring unsupported media type parameters, the first of "
                    "which is \""
                 << ctx->parameter()[0]->getText() << std::endl;
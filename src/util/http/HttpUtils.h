@@ -10,6 +10,7 @@
 #include <string_view>
 
 #include "absl/strings/str_cat.h"
+#include "global/Constants.h"
 #include "util/AsyncStream.h"
 #include "util/CompressorStream.h"
 #include "util/StringUtils.h"
@@ -115,7 +116,9 @@ static auto createOkResponse(std::string text, const HttpRequest auto& request,
 
 /// Assign the generator to the body of the response. If a supported
 /// compression is specified in the request, this method is applied to the
-/// body and the corresponding response headers are set.
+/// body and the corresponding response headers are set. The generator and the
+/// compression are run on two separate threads, s.t. the serialization, the
+/// compression, and the sending of the result are pipelined.
 static void setBody(http::response<streamable_body>& response,
                     const HttpRequest auto& request,
                     streams::stream_generator&& generator) {
@@ -125,8 +128,11 @@ static void setBody(http::response<streamable_body>& response,
       ad_utility::content_encoding::getCompressionMethodForRequest(request);
   auto asyncGenerator = streams::runStreamAsync(std::move(generator), 100);
   if (method != CompressionMethod::NONE) {
-    response.body() =
-        streams::compressStream(std::move(asyncGenerator), method);
+    response.body() = streams::runStreamAsync(
+        streams::compressStream(
+            std::move(asyncGenerator), method,
+            RuntimeParameters().get<"http-compression-level">()),
+        100);
     ad_utility::content_encoding::setContentEncodingHeaderForCompressionMethod(
         method, response);
   } else {
@@ -150,6 +156,26 @@ static auto createOkResponse(ad_utility::streams::stream_generator&& generator,
   return response;
 }
 
+/// Create a HttpResponse from a (serialized) json object with status 200 OK
+/// and mime type "application/json". Unlike `createJsonResponse` below, the
+/// body is compressed if the request allows it (see `setBody`), which is
+/// useful for large results.
+static auto createCompressibleJsonResponse(std::string text,
+                                           const HttpRequest auto& request) {
+  auto generator =
+      [](std::string text) -> ad_utility::streams::stream_generator {
+    co_yield text;
+  }(std::move(text));
+  return createOkResponse(std::move(generator), request, MediaType::json);
+}
+
+/// Same as above, but for a json object.
+static auto createCompressibleJsonResponse(const nlohmann::json& j,
+                                           const HttpRequest auto& request) {
+  // Argument `4` leads to a human-readable indentation.
+  return createCompressibleJsonResponse(j.dump(4), request);
+}
+
 /// Create a HttpResponse from a string with status 200 OK and mime type
 /// "application/json". Otherwise behaves the same as
 /// createHttpResponseFromString.
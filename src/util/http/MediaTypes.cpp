@@ -18,7 +18,8 @@ using enum MediaType;
 // specified in the request. It's "application/sparql-results+json", as
 // required by the SPARQL standard.
 constexpr std::array SUPPORTED_MEDIA_TYPES{
-    sparqlJson, sparqlXml, qleverJson, tsv, csv, turtle, octetStream};
+    sparqlJson, sparqlXml, qleverJson, tsv, csv, turtle, octetStream, arrow,
+    qleverIdTable};
 
 // _____________________________________________________________
 const ad_utility::HashMap<MediaType, MediaTypeImpl>& getAllMediaTypes() {
@@ -41,6 +42,8 @@ const ad_utility::HashMap<MediaType, MediaTypeImpl>& getAllMediaTypes() {
     add(qleverJson, "application", "qlever-results+json", {});
     add(turtle, "text", "turtle", {".ttl"});
     add(octetStream, "application", "octet-stream", {});
+    add(arrow, "application", "vnd.apache.arrow.stream", {".arrows"});
+    add(qleverIdTable, "application", "x-qlever-idtable", {});
     return t;
   }();
   return types;
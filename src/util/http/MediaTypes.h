@@ -28,7 +28,9 @@ enum class MediaType {
   tsv,
   csv,
   turtle,
-  octetStream
+  octetStream,
+  arrow,
+  qleverIdTable
 };
 
 struct MediaTypeWithQuality {
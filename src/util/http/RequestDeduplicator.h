@@ -0,0 +1,71 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "util/Exception.h"
+#include "util/HashMap.h"
+#include "util/Synchronized.h"
+
+namespace ad_utility::httpUtils {
+
+// Keep track of the requests that are currently processed, s.t. an identical
+// request (with the same key) can wait for the one that is already in flight
+// and reuse its response instead of computing it again. The first request
+// with a given key is the "leader", which has to `publish` its response; all
+// identical requests that arrive in the meantime are notified with the same
+// response. Requests that arrive after the publication are leaders again.
+template <typename Response>
+class RequestDeduplicator {
+ public:
+  // Called with the published response, or with `nullptr` if the leader was
+  // aborted without a response.
+  using OnPublished = std::function<void(std::shared_ptr<const Response>)>;
+
+ private:
+  ad_utility::Synchronized<ad_utility::HashMap<std::string,
+                                               std::vector<OnPublished>>>
+      inFlight_;
+
+ public:
+  // If no request with the `key` is in flight, register this request as the
+  // leader and return true. The caller then has to `publish` a response for
+  // the `key` eventually. Otherwise return false; `onPublished` will then be
+  // called when the leader publishes its response.
+  bool registerOrWait(const std::string& key, OnPublished onPublished) {
+    return inFlight_.withWriteLock([&](auto& inFlight) {
+      auto [it, isLeader] = inFlight.try_emplace(key);
+      if (!isLeader) {
+        it->second.push_back(std::move(onPublished));
+      }
+      return isLeader;
+    });
+  }
+
+  // Publish the `response` of the leader for the `key` to all the requests
+  // that are waiting for it (outside of the lock). The `key` is no longer in
+  // flight afterwards.
+  void publish(const std::string& key,
+               std::shared_ptr<const Response> response) {
+    auto waiting = inFlight_.withWriteLock([&key](auto& inFlight) {
+      auto it = inFlight.find(key);
+      AD_CONTRACT_CHECK(it != inFlight.end());
+      auto result = std::move(it->second);
+      inFlight.erase(it);
+      return result;
+    });
+    for (auto& onPublished : waiting) {
+      onPublished(response);
+    }
+  }
+
+  // The number of distinct requests that are currently in flight.
+  size_t numInFlight() const { return inFlight_.wlock()->size(); }
+};
+
+}  // namespace ad_utility::httpUtils
@@ -183,3 +183,31 @@ TEST(AddCombinedRowToTable, cornerCases) {
   };
   testWithAllBuffersizes(testWithBufferSize);
 }
+
+// _______________________________________________________________________________
+TEST(AddCombinedRowToTable, moveOutPartialResult) {
+  auto testWithBufferSize = [](size_t bufferSize) {
+    auto left = makeIdTableFromVector({{3, 4}, {7, 8}, {11, 10}, {14, 11}});
+    auto right =
+        makeIdTableFromVector({{7, 14, 0}, {9, 10, 1}, {14, 8, 2}, {33, 5, 3}});
+    auto result = makeIdTableFromVector({});
+    result.setNumColumns(4);
+    auto adder = ad_utility::AddCombinedRowToIdTable(
+        1, left.asStaticView<0>(), right.asStaticView<0>(), std::move(result),
+        bufferSize);
+    adder.addRow(1, 0);
+    auto firstPart = adder.moveOutPartialResult();
+    ASSERT_EQ(firstPart, makeIdTableFromVector({{7, 8, 14, 0}}));
+    ASSERT_EQ(adder.numWrittenRows(), 0u);
+
+    adder.addRow(3, 2);
+    adder.flush();
+    ASSERT_EQ(adder.numWrittenRows(), 1u);
+    adder.setOnlyLeftInputForOptionalJoin(left);
+    adder.addOptionalRow(2);
+    result = std::move(adder).resultTable();
+    ASSERT_EQ(result,
+              makeIdTableFromVector({{14, 11, 8, 2}, {11, 10, U, U}}));
+  };
+  testWithAllBuffersizes(testWithBufferSize);
+}
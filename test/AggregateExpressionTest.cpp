@@ -8,6 +8,7 @@
 #include "./util/IdTestHelpers.h"
 #include "engine/ValuesForTesting.h"
 #include "engine/sparqlExpressions/AggregateExpression.h"
+#include "engine/sparqlExpressions/ApproxCountDistinctExpression.h"
 #include "gtest/gtest.h"
 
 using namespace sparqlExpression;
@@ -94,3 +95,62 @@ TEST(AggregateExpression, count) {
   auto testCountString = testAggregate<CountExpression, IdOrString, Id>;
   testCountString({"alpha", "äpfel", "", "unfug"}, I(4));
 }
+
+// ______________________________________________________________________________
+TEST(AggregateExpression, approxCountDistinct) {
+  auto evaluate = []<typename T>(std::vector<T> inputAsVector) {
+    VectorWithMemoryLimit<T> input(inputAsVector.begin(), inputAsVector.end(),
+                                   makeAllocator());
+    auto t = TestContext{};
+    t.context._endIndex = input.size();
+    ApproxCountDistinctExpression m{
+        std::make_unique<DummyExpression>(std::move(input))};
+    return std::get<Id>(m.evaluate(&t.context));
+  };
+  // Small inputs are counted exactly, UNDEF values are not counted.
+  EXPECT_EQ(evaluate(std::vector{I(3), D(2), I(3), U, V(17), U}), I(3));
+  EXPECT_EQ(evaluate(std::vector<IdOrString>{"alpha", "beta", "alpha"}), I(2));
+
+  // Each of the 200'000 values occurs twice, the estimate is within 3%.
+  std::vector<Id> input;
+  for (int64_t i = 0; i < 400'000; ++i) {
+    input.push_back(I(i / 2));
+  }
+  EXPECT_NEAR(evaluate(input).getInt(), 200'000, 6'000);
+}
+
+// ______________________________________________________________________________
+TEST(AggregateExpression, countDistinctInApproximateMode) {
+  // Each of the 200'000 values occurs twice.
+  std::vector<Id> inputAsVector;
+  for (int64_t i = 0; i < 400'000; ++i) {
+    inputAsVector.push_back(I(i / 2));
+  }
+  auto evaluate = [&inputAsVector]<typename Expression>(bool approximate) {
+    VectorWithMemoryLimit<Id> input(inputAsVector.begin(), inputAsVector.end(),
+                                    makeAllocator());
+    auto t = TestContext{};
+    t.context._endIndex = input.size();
+    QueryHints hints;
+    hints.approximate_ = approximate;
+    t.qec->setQueryHints(hints);
+    SparqlExpression::Ptr child =
+        std::make_unique<DummyExpression>(std::move(input));
+    SparqlExpression::Ptr expression;
+    if constexpr (std::is_same_v<Expression, CountExpression>) {
+      expression = std::make_unique<CountExpression>(true, std::move(child));
+    } else {
+      expression = std::make_unique<Expression>(std::move(child));
+    }
+    auto result = std::get<Id>(expression->evaluate(&t.context));
+    t.qec->setQueryHints(QueryHints{});
+    return result.getInt();
+  };
+  EXPECT_EQ(evaluate.operator()<CountExpression>(false), 200'000);
+  // In the approximate mode, `COUNT(DISTINCT ...)` yields the estimate of
+  // `ql:approx-count-distinct`.
+  auto estimate = evaluate.operator()<CountExpression>(true);
+  EXPECT_EQ(estimate,
+            evaluate.operator()<ApproxCountDistinctExpression>(false));
+  EXPECT_NEAR(estimate, 200'000, 6'000);
+}
@@ -105,3 +105,139 @@ TEST(AllocatorWithLimit, unlikelyExceptionsDuringCopyingAndMoving) {
   ASSERT_DEATH(moveAssign(),
                "The move assignment operator of `AllocatorWithLimit`");
 }
+
+// _____________________________________________________________________________
+TEST(AllocatorWithLimit, temporaryAllocatorReusesMemoryOfArena) {
+  AllocatorWithLimit<int> global{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(100_B)};
+  {
+    auto temporary = ad_utility::makeTemporaryAllocator(global);
+    ASSERT_NE(temporary, global);
+    ASSERT_EQ(temporary, temporary.as<char>());
+    const auto& arena = temporary.arena();
+    ASSERT_NE(arena, nullptr);
+
+    auto p = temporary.allocate(10);
+    ASSERT_EQ(global.amountMemoryLeft(), 60_B);
+    // The deallocated block is kept in the arena and still counts towards the
+    // limit, so the next allocation of the same size reuses it.
+    temporary.deallocate(p, 10);
+    ASSERT_EQ(global.amountMemoryLeft(), 60_B);
+    ASSERT_EQ(arena->cachedMemory(), 40_B);
+    auto p2 = temporary.allocate(10);
+    ASSERT_EQ(p2, p);
+    ASSERT_EQ(global.amountMemoryLeft(), 60_B);
+    ASSERT_EQ(arena->cachedMemory(), 0_B);
+    ASSERT_EQ(arena->peakMemory(), 40_B);
+
+    // An allocation that doesn't fit because of the cached blocks first
+    // releases them.
+    temporary.deallocate(p2, 10);
+    auto p3 = temporary.allocate(20);
+    ASSERT_EQ(global.amountMemoryLeft(), 20_B);
+    ASSERT_EQ(arena->cachedMemory(), 0_B);
+    ASSERT_THROW(temporary.allocate(10),
+                 ad_utility::detail::AllocationExceedsLimitException);
+    temporary.deallocate(p3, 20);
+    ASSERT_EQ(global.amountMemoryLeft(), 20_B);
+    // The released block doesn't count towards the peak.
+    ASSERT_EQ(arena->peakMemory(), 80_B);
+  }
+  // When the arena is destroyed, all its memory is given back.
+  ASSERT_EQ(global.amountMemoryLeft(), 100_B);
+}
+
+// _____________________________________________________________________________
+TEST(AllocatorWithLimit, hugePages) {
+  namespace hugePages = ad_utility::hugePages;
+  ASSERT_EQ(hugePages::getMinSize(), 0_B);
+  auto allocator = ad_utility::makeUnlimitedAllocator<char>();
+  constexpr size_t numBytes = 3 * hugePages::HUGE_PAGE_SIZE;
+  auto allocateAndDeallocate = [&allocator]() {
+    char* p = allocator.allocate(numBytes);
+    std::fill(p, p + numBytes, 'a');
+    bool advised = hugePages::adviseIfLarge(p, numBytes);
+    allocator.deallocate(p, numBytes);
+    return advised;
+  };
+  // Disabled by default.
+  EXPECT_FALSE(allocateAndDeallocate());
+
+  // Blocks smaller than the minimal size and blocks that don't contain a
+  // complete huge page are not advised. Whether the advice succeeds for the
+  // others depends on the kernel.
+  hugePages::setMinSize(1_MB);
+  EXPECT_EQ(hugePages::getMinSize(), 1_MB);
+  std::vector<char> small(hugePages::HUGE_PAGE_SIZE / 4);
+  EXPECT_FALSE(hugePages::adviseIfLarge(small.data(), small.size()));
+  std::vector<char> large(hugePages::HUGE_PAGE_SIZE);
+  EXPECT_FALSE(hugePages::adviseIfLarge(large.data(), large.size() - 1));
+  EXPECT_FALSE(hugePages::adviseIfLarge(nullptr, numBytes));
+  allocateAndDeallocate();
+  hugePages::setMinSize(0_B);
+}
+
+// _____________________________________________________________________________
+TEST(AllocatorWithLimit, childBudgetIsChargedToParent) {
+  auto parent = makeAllocationMemoryLeftThreadsafeObject(2_MB);
+  auto firstBudget =
+      ad_utility::makeChildAllocationMemoryLeftThreadsafeObject(parent, 1_MB);
+  auto secondBudget = ad_utility::makeChildAllocationMemoryLeftThreadsafeObject(
+      parent, 3_MB);
+  AllocatorWithLimit<char> first{firstBudget};
+  AllocatorWithLimit<char> second{secondBudget};
+
+  // Allocations of a child are charged to the parent.
+  auto* p = first.allocate(600'000);
+  EXPECT_EQ(first.amountMemoryLeft(), 400_kB);
+  EXPECT_EQ(second.amountMemoryLeft(), 1400_kB);
+  EXPECT_EQ(parent.ptr()->wlock()->amountMemoryLeft(), 1400_kB);
+
+  // A child that exceeds its own budget fails alone, the others are not
+  // affected.
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      first.allocate(500'000),
+      ::testing::HasSubstr("memory budget of a single query"));
+  auto* q = second.allocate(1'400'000);
+  EXPECT_EQ(parent.ptr()->wlock()->amountMemoryLeft(), 0_B);
+
+  // The limit of the parent also applies to the children.
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      first.allocate(100'000),
+      ::testing::StartsWith(
+          "Tried to allocate 100 kB, but only 0 B were available. Clear the "
+          "cache"));
+
+  second.deallocate(q, 1'400'000);
+  EXPECT_EQ(parent.ptr()->wlock()->amountMemoryLeft(), 1400_kB);
+  first.deallocate(p, 600'000);
+  EXPECT_EQ(parent.ptr()->wlock()->amountMemoryLeft(), 2_MB);
+}
+
+// _____________________________________________________________________________
+TEST(AllocatorWithLimit, usedAndPeakMemoryAndSetLimit) {
+  auto parent = makeAllocationMemoryLeftThreadsafeObject(10_MB);
+  auto budget = ad_utility::makeChildAllocationMemoryLeftThreadsafeObject(
+      parent, ad_utility::MemorySize::max());
+  AllocatorWithLimit<char> allocator{budget};
+  auto memory = [&budget]() { return budget.ptr()->wlock(); };
+
+  auto* p = allocator.allocate(3'000'000);
+  auto* q = allocator.allocate(1'000'000);
+  EXPECT_EQ(memory()->amountMemoryUsed(), 4_MB);
+  EXPECT_EQ(memory()->peakMemoryUsed(), 4_MB);
+  allocator.deallocate(p, 3'000'000);
+  EXPECT_EQ(memory()->amountMemoryUsed(), 1_MB);
+  EXPECT_EQ(memory()->peakMemoryUsed(), 4_MB);
+
+  // The limit can be changed after memory has been allocated.
+  memory()->setLimit(2_MB);
+  EXPECT_EQ(allocator.amountMemoryLeft(), 1_MB);
+  EXPECT_FALSE(memory()->fitsIntoOwnLimit(1'500_kB));
+  EXPECT_ANY_THROW(allocator.allocate(1'500'000));
+  memory()->setLimit(500_kB);
+  EXPECT_EQ(allocator.amountMemoryLeft(), 0_B);
+  allocator.deallocate(q, 1'000'000);
+  EXPECT_EQ(memory()->amountMemoryUsed(), 0_B);
+  EXPECT_EQ(allocator.amountMemoryLeft(), 500_kB);
+}
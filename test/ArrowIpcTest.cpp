@@ -0,0 +1,223 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+
+#include <cstring>
+
+#include "util/ArrowIpc.h"
+
+using namespace ad_utility::arrow;
+
+namespace {
+// A minimal reader for the FlatBuffers format to check the metadata of the
+// messages.
+struct FlatTable {
+  std::string_view buffer_;
+  size_t position_;
+
+  template <typename T>
+  T read(size_t position) const {
+    EXPECT_EQ(position % sizeof(T), 0u);
+    EXPECT_LE(position + sizeof(T), buffer_.size());
+    T result;
+    std::memcpy(&result, buffer_.data() + position, sizeof(T));
+    return result;
+  }
+
+  // The position of the field with the `id` or 0 if it is absent.
+  size_t field(uint16_t id) const {
+    size_t vtable = position_ - read<int32_t>(position_);
+    auto vtableSize = read<uint16_t>(vtable);
+    if (4u + 2u * id >= vtableSize) {
+      return 0;
+    }
+    auto offset = read<uint16_t>(vtable + 4 + 2 * id);
+    return offset == 0 ? 0 : position_ + offset;
+  }
+
+  template <typename T>
+  T scalar(uint16_t id) const {
+    size_t position = field(id);
+    return position == 0 ? T{0} : read<T>(position);
+  }
+
+  // Follow the offset of the field with the `id`.
+  size_t target(uint16_t id) const {
+    size_t position = field(id);
+    EXPECT_NE(position, 0u);
+    return position + read<uint32_t>(position);
+  }
+
+  FlatTable table(uint16_t id) const {
+    FlatTable result{buffer_, target(id)};
+    EXPECT_EQ(result.position_ % 8, 0u);
+    return result;
+  }
+
+  std::string_view string(uint16_t id) const {
+    size_t position = target(id);
+    return buffer_.substr(position + 4, read<uint32_t>(position));
+  }
+
+  std::vector<FlatTable> tables(uint16_t id) const {
+    size_t position = target(id);
+    std::vector<FlatTable> result;
+    for (size_t i = 0; i < read<uint32_t>(position); ++i) {
+      size_t element = position + 4 + 4 * i;
+      result.push_back({buffer_, element + read<uint32_t>(element)});
+    }
+    return result;
+  }
+
+  std::vector<std::array<int64_t, 2>> structs(uint16_t id) const {
+    size_t position = target(id);
+    std::vector<std::array<int64_t, 2>> result;
+    for (size_t i = 0; i < read<uint32_t>(position); ++i) {
+      size_t element = position + 4 + 16 * i;
+      result.push_back({read<int64_t>(element), read<int64_t>(element + 8)});
+    }
+    return result;
+  }
+};
+
+// Check the framing of the `message` and return the root table of its
+// metadata (the `Message` table) and its body.
+std::pair<FlatTable, std::string_view> parseMessage(std::string_view message) {
+  EXPECT_EQ(message.size() % 8, 0u);
+  EXPECT_EQ(message.substr(0, 4), "\xFF\xFF\xFF\xFF");
+  int32_t metadataSize;
+  std::memcpy(&metadataSize, message.data() + 4, 4);
+  EXPECT_EQ(metadataSize % 8, 0);
+  // The metadata starts at an offset of 8, so its alignment is the one of the
+  // message.
+  auto metadata = message.substr(8, metadataSize);
+  FlatTable root{metadata, 0};
+  root.position_ = root.read<uint32_t>(0);
+  FlatTable messageTable = root;
+  EXPECT_EQ(messageTable.scalar<int16_t>(0), 4);
+  auto body = message.substr(8 + metadataSize);
+  EXPECT_EQ(messageTable.scalar<int64_t>(3),
+            static_cast<int64_t>(body.size()));
+  return {messageTable, body};
+}
+
+// The data of the `buffer` (offset and length) in the `body`.
+std::string_view bufferData(std::string_view body,
+                            const std::array<int64_t, 2>& buffer) {
+  EXPECT_EQ(buffer[0] % 8, 0);
+  return body.substr(buffer[0], buffer[1]);
+}
+
+template <typename T>
+std::string bytes(std::initializer_list<T> values) {
+  std::string result;
+  for (T value : values) {
+    result.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  return result;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ArrowIpc, schemaMessage) {
+  std::vector<Field> fields{{"int", Type::Int64},
+                            {"double", Type::Double},
+                            {"bool", Type::Bool},
+                            {"date", Type::Timestamp},
+                            {"string", Type::DictionaryString}};
+  std::string message = schemaMessage(fields);
+  auto [messageTable, body] = parseMessage(message);
+  EXPECT_TRUE(body.empty());
+  EXPECT_EQ(messageTable.scalar<uint8_t>(1), 1);
+  auto schema = messageTable.table(2);
+  auto fieldTables = schema.tables(1);
+  ASSERT_EQ(fieldTables.size(), 5u);
+  for (size_t i = 0; i < fields.size(); ++i) {
+    EXPECT_EQ(fieldTables[i].string(0), fields[i].name_);
+    EXPECT_EQ(fieldTables[i].scalar<uint8_t>(1), 1);
+    EXPECT_TRUE(fieldTables[i].tables(5).empty());
+  }
+  EXPECT_EQ(fieldTables[0].scalar<uint8_t>(2), 2);
+  EXPECT_EQ(fieldTables[0].table(3).scalar<int32_t>(0), 64);
+  EXPECT_EQ(fieldTables[0].table(3).scalar<uint8_t>(1), 1);
+  EXPECT_EQ(fieldTables[1].scalar<uint8_t>(2), 3);
+  EXPECT_EQ(fieldTables[1].table(3).scalar<int16_t>(0), 2);
+  EXPECT_EQ(fieldTables[2].scalar<uint8_t>(2), 6);
+  EXPECT_EQ(fieldTables[3].scalar<uint8_t>(2), 10);
+  EXPECT_EQ(fieldTables[3].table(3).scalar<int16_t>(0), 1);
+  EXPECT_EQ(fieldTables[3].table(3).string(1), "UTC");
+  EXPECT_EQ(fieldTables[4].scalar<uint8_t>(2), 5);
+  auto dictionary = fieldTables[4].table(4);
+  EXPECT_EQ(dictionary.scalar<int64_t>(0), 4);
+  EXPECT_EQ(dictionary.table(1).scalar<int32_t>(0), 32);
+  // Only the string field is dictionary-encoded.
+  EXPECT_EQ(fieldTables[0].field(4), 0u);
+}
+
+// _____________________________________________________________________________
+TEST(ArrowIpc, recordBatchMessage) {
+  std::vector<Column> columns;
+  columns.emplace_back(Type::Int64);
+  columns.emplace_back(Type::Bool);
+  columns.emplace_back(Type::DictionaryString);
+  columns[0].appendInt(1);
+  columns[0].appendNull();
+  columns[0].appendInt(3);
+  columns[1].appendBool(true);
+  columns[1].appendBool(false);
+  columns[1].appendBool(true);
+  columns[2].appendIndex(1);
+  columns[2].appendIndex(0);
+  columns[2].appendNull();
+  EXPECT_EQ(columns[0].nullCount(), 1u);
+  EXPECT_EQ(columns[1].nullCount(), 0u);
+
+  std::string message = recordBatchMessage(columns);
+  auto [messageTable, body] = parseMessage(message);
+  EXPECT_EQ(messageTable.scalar<uint8_t>(1), 3);
+  auto batch = messageTable.table(2);
+  EXPECT_EQ(batch.scalar<int64_t>(0), 3);
+  using Structs = std::vector<std::array<int64_t, 2>>;
+  EXPECT_EQ(batch.structs(1), (Structs{{3, 1}, {3, 0}, {3, 1}}));
+  auto buffers = batch.structs(2);
+  ASSERT_EQ(buffers.size(), 6u);
+  EXPECT_EQ(bufferData(body, buffers[0]), std::string(1, '\x05'));
+  EXPECT_EQ(bufferData(body, buffers[1]), bytes<int64_t>({1, 0, 3}));
+  // No validity bitmap if there are no nulls.
+  EXPECT_EQ(bufferData(body, buffers[2]), "");
+  EXPECT_EQ(bufferData(body, buffers[3]), std::string(1, '\x05'));
+  EXPECT_EQ(bufferData(body, buffers[4]), std::string(1, '\x03'));
+  EXPECT_EQ(bufferData(body, buffers[5]), bytes<int32_t>({1, 0, 0}));
+
+  EXPECT_ANY_THROW(columns[0].appendDouble(1.0));
+  EXPECT_ANY_THROW(columns[2].appendInt(1));
+  // All the columns must have the same size.
+  columns[0].appendInt(4);
+  EXPECT_ANY_THROW(recordBatchMessage(columns));
+}
+
+// _____________________________________________________________________________
+TEST(ArrowIpc, dictionaryBatchMessage) {
+  std::vector<std::string> words{"a", "bc", ""};
+  std::string message = dictionaryBatchMessage(7, words);
+  auto [messageTable, body] = parseMessage(message);
+  EXPECT_EQ(messageTable.scalar<uint8_t>(1), 2);
+  auto dictionaryBatch = messageTable.table(2);
+  EXPECT_EQ(dictionaryBatch.scalar<int64_t>(0), 7);
+  EXPECT_EQ(dictionaryBatch.scalar<uint8_t>(2), 0);
+  auto batch = dictionaryBatch.table(1);
+  EXPECT_EQ(batch.scalar<int64_t>(0), 3);
+  using Structs = std::vector<std::array<int64_t, 2>>;
+  EXPECT_EQ(batch.structs(1), (Structs{{3, 0}}));
+  auto buffers = batch.structs(2);
+  ASSERT_EQ(buffers.size(), 3u);
+  EXPECT_EQ(bufferData(body, buffers[0]), "");
+  EXPECT_EQ(bufferData(body, buffers[1]), bytes<int32_t>({0, 1, 3, 3}));
+  EXPECT_EQ(bufferData(body, buffers[2]), "abc");
+}
+
+// _____________________________________________________________________________
+TEST(ArrowIpc, endOfStream) {
+  EXPECT_EQ(endOfStream(), std::string_view("\xFF\xFF\xFF\xFF\0\0\0\0", 8));
+}
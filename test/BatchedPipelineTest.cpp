@@ -4,7 +4,10 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <memory>
 #include <optional>
+#include <tuple>
 
 #include "../src/util/BatchedPipeline.h"
 
@@ -181,3 +184,42 @@ TEST(BatchedPipelineTest, BranchedParallelism) {
     ASSERT_EQ(j, 67u);
   }
 }
+
+TEST(BatchedPipelineTest, LoadBalancedParallelism) {
+  // Each transformer counts the elements that it has transformed. The result
+  // doesn't depend on which transformer transforms which element, and the
+  // order of the elements is preserved.
+  std::array<size_t, 3> numTransformed{};
+  auto makeTransformer = [&numTransformed](size_t idx) {
+    return [&numTransformed, idx, ptr = std::make_unique<int>(2)](size_t x) {
+      ++numTransformed[idx];
+      return x * static_cast<size_t>(*ptr);
+    };
+  };
+  auto pipeline = ad_pipeline::setupParallelPipeline<3>(
+      100,
+      [i = 0ull]() mutable -> std::optional<size_t> {
+        if (i >= 1000) {
+          return std::nullopt;
+        }
+        return std::optional(i++);
+      },
+      ad_pipeline::loadBalanced(std::tuple(
+          makeTransformer(0), makeTransformer(1), makeTransformer(2))));
+
+  size_t j = 0;
+  while (auto opt = pipeline.getNextValue()) {
+    ASSERT_EQ(opt.value(), j * 2);
+    j++;
+  }
+  ASSERT_EQ(j, 1000u);
+  EXPECT_EQ(numTransformed[0] + numTransformed[1] + numTransformed[2], 1000u);
+
+  // There is one `StageStatistics` for the creator and one for the
+  // transformers.
+  auto statistics = pipeline.getStatistics();
+  ASSERT_EQ(statistics.size(), 2u);
+  EXPECT_EQ(statistics[0].numElements_, 1000u);
+  EXPECT_EQ(statistics[1].numElements_, 1000u);
+  EXPECT_EQ(pipeline.getWaitingTime().size(), 3u);
+}
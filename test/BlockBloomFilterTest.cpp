@@ -0,0 +1,71 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./util/IdTestHelpers.h"
+#include "index/BlockBloomFilter.h"
+
+using namespace blockBloomFilter;
+using ad_utility::testing::VocabId;
+
+namespace {
+// Return the columns of a block with `numCol1` many distinct `col1`s, each of
+// which has `numRowsPerCol1` many rows (the `col1` and `col2` are even).
+std::pair<std::vector<Id>, std::vector<Id>> makeBlock(size_t numCol1,
+                                                      size_t numRowsPerCol1) {
+  std::vector<Id> col1;
+  std::vector<Id> col2;
+  for (size_t i = 0; i < numCol1; ++i) {
+    for (size_t j = 0; j < numRowsPerCol1; ++j) {
+      col1.push_back(VocabId(2 * i));
+      col2.push_back(VocabId(2 * j));
+    }
+  }
+  return {std::move(col1), std::move(col2)};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(BlockBloomFilter, noFalseNegatives) {
+  auto [col1, col2] = makeBlock(100, 7);
+  for (size_t bitsPerKey : {1u, 4u, 10u, 30u}) {
+    auto filter = build(col1, col2, bitsPerKey);
+    // The number of hash functions and at least one word of bits.
+    ASSERT_GE(filter.size(), 2u);
+    for (size_t i = 0; i < col1.size(); ++i) {
+      EXPECT_TRUE(mightContain(filter, col1[i]));
+      EXPECT_TRUE(mightContain(filter, col1[i], col2[i]));
+    }
+  }
+
+  // An empty block has a filter that contains nothing.
+  auto emptyFilter = build({}, {}, 10);
+  EXPECT_EQ(emptyFilter.size(), 2u);
+  EXPECT_FALSE(mightContain(emptyFilter, VocabId(3)));
+  EXPECT_FALSE(mightContain(emptyFilter, VocabId(3), VocabId(4)));
+
+  EXPECT_ANY_THROW(build(col1, col2, 0));
+  EXPECT_ANY_THROW(build(col1, std::span{col2}.subspan(1), 10));
+}
+
+// _____________________________________________________________________________
+TEST(BlockBloomFilter, falsePositiveRate) {
+  auto [col1, col2] = makeBlock(1000, 3);
+  auto filter = build(col1, col2, 10);
+  // The filter has 10 bits for each distinct `col1` and for each row.
+  EXPECT_EQ(filter.size(), 1 + (4000 * 10 + 63) / 64);
+
+  // Only the even IDs are contained, so all of the odd ones are false
+  // positives. With 10 bits per key, the rate is about one percent.
+  size_t numFalsePositives = 0;
+  size_t numPairFalsePositives = 0;
+  size_t numLookups = 10'000;
+  for (size_t i = 0; i < numLookups; ++i) {
+    numFalsePositives += mightContain(filter, VocabId(2 * i + 1));
+    numPairFalsePositives +=
+        mightContain(filter, VocabId(2 * (i % 1000)), VocabId(2 * i + 1));
+  }
+  EXPECT_LT(numFalsePositives, numLookups / 25);
+  EXPECT_LT(numPairFalsePositives, numLookups / 25);
+}
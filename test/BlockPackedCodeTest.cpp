@@ -0,0 +1,87 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "util/BlockPackedCode.h"
+
+using ad_utility::BlockPackedCode;
+
+namespace {
+// Encode and decode the `values` and check that the result is the same.
+template <bool Differential>
+void testRoundTrip(const std::vector<uint64_t>& values) {
+  auto encoded =
+      BlockPackedCode::encode<Differential>(values.data(), values.size());
+  std::vector<uint64_t> decoded(values.size());
+  BlockPackedCode::decode<Differential>(encoded.data(), values.size(),
+                                        decoded.begin());
+  ASSERT_EQ(decoded, values);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(BlockPackedCode, roundTrip) {
+  testRoundTrip<false>({});
+  testRoundTrip<true>({});
+  testRoundTrip<false>({42});
+  testRoundTrip<true>({42});
+  testRoundTrip<true>({3, 3, 5});
+
+  std::mt19937_64 generator{42};
+  // Values with all the possible bit widths and a number of values that is
+  // not a multiple of the block size.
+  for (size_t bitWidth = 0; bitWidth <= 64; ++bitWidth) {
+    uint64_t maxValue =
+        bitWidth == 64 ? ~uint64_t{0} : (uint64_t{1} << bitWidth) - 1;
+    std::uniform_int_distribution<uint64_t> distribution{0, maxValue};
+    std::vector<uint64_t> values;
+    for (size_t i = 0; i < 3 * BlockPackedCode::BLOCK_SIZE + 17; ++i) {
+      values.push_back(distribution(generator));
+    }
+    testRoundTrip<false>(values);
+    std::ranges::sort(values);
+    testRoundTrip<true>(values);
+  }
+}
+
+// _____________________________________________________________________________
+TEST(BlockPackedCode, sizeAndTransform) {
+  // In the differential mode, only the first `NUM_LANES` values of the list
+  // are stored as they are, so they determine the bit width of the block.
+  std::vector<uint64_t> values;
+  for (size_t i = 0; i < BlockPackedCode::BLOCK_SIZE; ++i) {
+    values.push_back(1'000'000'000 + 3 * i);
+  }
+  auto encoded = BlockPackedCode::encode<true>(values.data(), values.size());
+  ASSERT_EQ(encoded.at(0), 30u);
+  ASSERT_EQ(encoded.size(), 1u + 4 * 15);
+
+  std::vector<int64_t> decoded(values.size());
+  BlockPackedCode::decode<true>(
+      encoded.data(), values.size(), decoded.data(),
+      [](uint64_t value) { return -static_cast<int64_t>(value); });
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(decoded[i], -static_cast<int64_t>(values[i]));
+  }
+
+  // A block of zeros only consists of its header.
+  std::vector<uint64_t> zeros(200, 0);
+  ASSERT_EQ(BlockPackedCode::encode<false>(zeros.data(), zeros.size()).size(),
+            2u);
+}
+
+// _____________________________________________________________________________
+TEST(BlockPackedCode, base) {
+  std::vector<uint64_t> values{1'000'000, 1'000'001, 1'000'001, 1'000'007};
+  auto encoded =
+      BlockPackedCode::encode<true>(values.data(), values.size(), 1'000'000);
+  // All the differences to the `base` are smaller than 8.
+  ASSERT_EQ(encoded.at(0), 3u);
+  std::vector<uint64_t> decoded(values.size());
+  BlockPackedCode::decode<true>(encoded.data(), values.size(),
+                                decoded.begin(), std::identity{}, 1'000'000);
+  ASSERT_EQ(decoded, values);
+}
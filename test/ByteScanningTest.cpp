@@ -0,0 +1,69 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "util/ByteScanning.h"
+
+using ad_utility::findFirstOf;
+using ad_utility::isAscii;
+
+// _____________________________________________________________________________
+TEST(ByteScanning, findFirstOf) {
+  using namespace std::string_view_literals;
+  constexpr auto npos = std::string_view::npos;
+  EXPECT_EQ((findFirstOf<'>'>(""sv)), npos);
+  EXPECT_EQ((findFirstOf<'>'>("abc"sv)), npos);
+  EXPECT_EQ((findFirstOf<'>'>("<abc>"sv)), 4u);
+  EXPECT_EQ((findFirstOf<'>', ' ', '\n'>("<http://example.org/a b>"sv)), 21u);
+  EXPECT_EQ((findFirstOf<'>', ' ', '\n'>("<http://example.org/abc>"sv)), 23u);
+  // Matches in the first word, in a later word, and in the scalar tail.
+  EXPECT_EQ((findFirstOf<'"', '\\'>("a\"bcdefghij"sv)), 1u);
+  EXPECT_EQ((findFirstOf<'"', '\\'>("abcdefghij\\\""sv)), 10u);
+  EXPECT_EQ((findFirstOf<'"', '\\'>("abcdefghijklmnopq\""sv)), 17u);
+  // The start position is respected, also when it is at or after the end.
+  EXPECT_EQ((findFirstOf<'x'>("xaaaaaaaaaaax"sv, 1)), 12u);
+  EXPECT_EQ((findFirstOf<'x'>("xx"sv, 2)), npos);
+  EXPECT_EQ((findFirstOf<'x'>("xx"sv, 3)), npos);
+  // Bytes with the highest bit set and zero bytes are handled correctly.
+  EXPECT_EQ((findFirstOf<'\x80'>("\x7f\xff\x01\x80"sv)), 3u);
+  EXPECT_EQ((findFirstOf<'\0'>("\x01\x01\x01\x01\x01\x01\x01\x01\x01\0"sv)),
+            9u);
+  EXPECT_EQ((findFirstOf<'\x01'>("\0\0\0\0\0\0\0\0\0\x01"sv)), 9u);
+}
+
+// _____________________________________________________________________________
+TEST(ByteScanning, findFirstOfRandom) {
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> bytes{0, 255};
+  std::uniform_int_distribution<size_t> sizes{0, 100};
+  for (size_t i = 0; i < 2000; ++i) {
+    std::string s(sizes(generator), ' ');
+    for (auto& c : s) {
+      c = static_cast<char>(bytes(generator));
+    }
+    std::string_view view{s};
+    for (size_t pos = 0; pos <= s.size(); pos += 7) {
+      EXPECT_EQ((findFirstOf<'"', '\\'>(view, pos)),
+                view.find_first_of("\"\\", pos));
+      EXPECT_EQ((findFirstOf<'>', ' ', '\n', '\xfe'>(view, pos)),
+                view.find_first_of(std::string_view{"> \n\xfe"}, pos));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+TEST(ByteScanning, isAscii) {
+  using namespace std::string_view_literals;
+  EXPECT_TRUE(isAscii(""sv));
+  EXPECT_TRUE(isAscii("<http://example.org/abc>"sv));
+  EXPECT_TRUE(isAscii("\0\x7f\x01"sv));
+  // Non-ASCII bytes in the first word, in a later word, and in the tail.
+  EXPECT_FALSE(isAscii("\x80bcdefghij"sv));
+  EXPECT_FALSE(isAscii("abcdefghi\xffj"sv));
+  EXPECT_FALSE(isAscii("abcdefghijklmnopq\xc3\xa4"sv));
+  EXPECT_FALSE(isAscii("Stra\xc3\x9f" "e"sv));
+}
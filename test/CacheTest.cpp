@@ -2,6 +2,7 @@
 // Chair of Algorithms and Data Structures.
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <string>
@@ -52,6 +53,25 @@ TEST(FlexibleCacheTest, LRUSimple) {
   ASSERT_TRUE(cache.contains("5"));
   ASSERT_TRUE(cache.contains("2"));
 }
+TEST(FlexibleCacheTest, onEviction) {
+  ad_utility::HeapBasedLRUCache<string, int, ad_utility::SizeOfSizeGetter>
+      cache(2, 10_kB, 10_kB);
+  std::vector<std::pair<string, int>> evicted;
+  cache.setOnEviction(
+      [&evicted](const string& key, const std::shared_ptr<const int>& value) {
+        evicted.emplace_back(key, *value);
+      });
+  cache.insert("1", 1);
+  cache.insert("2", 2);
+  cache.insertPinned("3", 3);
+  EXPECT_THAT(evicted, ::testing::ElementsAre(std::pair{"1", 1}));
+  // Entries that are explicitly removed are not reported.
+  cache.clearAll();
+  EXPECT_EQ(evicted.size(), 1);
+  cache.setMaxNumEntries(0);
+  cache.insert("5", 5);
+  EXPECT_EQ(evicted.size(), 1);
+}
 namespace ad_utility {
 // _____________________________________________________________________________
 TEST(LRUCacheTest, testSimpleMapUsage) {
@@ -140,3 +160,120 @@ TEST(LRUCacheTest, testDecreasingCapacity) {
   ASSERT_FALSE(cache["4"]);
 }
 }  // namespace ad_utility
+
+namespace {
+// A value for the `CostAwareCache` with a fixed size and computation time.
+struct CostlyValue {
+  size_t sizeInBytes_;
+  std::chrono::milliseconds cost_;
+};
+struct CostlyValueSizeGetter {
+  ad_utility::MemorySize operator()(const CostlyValue& value) const {
+    return ad_utility::MemorySize::bytes(value.sizeInBytes_);
+  }
+};
+struct CostlyValueCostGetter {
+  std::chrono::milliseconds operator()(const CostlyValue& value) const {
+    return value.cost_;
+  }
+};
+using CostAwareCache =
+    ad_utility::CostAwareCache<string, CostlyValue, CostlyValueSizeGetter,
+                               CostlyValueCostGetter>;
+using enum ad_utility::EvictionPolicy;
+using namespace std::chrono_literals;
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(CostAwareCacheTest, leastRecentlyUsed) {
+  CostAwareCache cache{3, 10_kB, 10_kB};
+  EXPECT_EQ(cache.evictionPolicy(), LeastRecentlyUsed);
+  cache.insert("expensive", {100, 40'000ms});
+  cache.insert("a", {100, 2ms});
+  cache.insert("b", {100, 2ms});
+  cache.insert("c", {100, 2ms});
+  EXPECT_FALSE(cache.contains("expensive"));
+  EXPECT_TRUE(cache.contains("a"));
+  // Accessing an entry makes it the most recently used one.
+  EXPECT_NE(cache["a"], nullptr);
+  cache.insert("d", {100, 2ms});
+  EXPECT_TRUE(cache.contains("a"));
+  EXPECT_FALSE(cache.contains("b"));
+}
+
+// _____________________________________________________________________________
+TEST(CostAwareCacheTest, greedyDualSizeFrequency) {
+  CostAwareCache cache{3, 10_kB, 10_kB, GreedyDualSizeFrequency};
+  cache.insert("expensive", {100, 40'000ms});
+  cache.insert("a", {100, 2ms});
+  cache.insert("b", {100, 2ms});
+  cache.insert("c", {100, 2ms});
+  // The expensive entry is kept although it is the least recently used one.
+  // One of the cheap entries (which all have the same score) is evicted.
+  EXPECT_TRUE(cache.contains("expensive"));
+  EXPECT_EQ(cache.contains("a") + cache.contains("b") + cache.contains("c"),
+            2);
+
+  // With the same cost, larger entries are evicted first.
+  CostAwareCache sizeCache{2, 10_kB, 10_kB, GreedyDualSizeFrequency};
+  sizeCache.insert("large", {5000, 10ms});
+  sizeCache.insert("small", {100, 10ms});
+  sizeCache.insert("new", {100, 10ms});
+  EXPECT_FALSE(sizeCache.contains("large"));
+  EXPECT_TRUE(sizeCache.contains("small"));
+
+  // Frequently accessed entries are kept.
+  CostAwareCache frequencyCache{2, 10_kB, 10_kB, GreedyDualSizeFrequency};
+  frequencyCache.insert("frequent", {100, 2ms});
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_NE(frequencyCache["frequent"], nullptr);
+  }
+  frequencyCache.insert("x", {100, 2ms});
+  frequencyCache.insert("y", {100, 2ms});
+  EXPECT_TRUE(frequencyCache.contains("frequent"));
+  EXPECT_FALSE(frequencyCache.contains("x"));
+  EXPECT_TRUE(frequencyCache.contains("y"));
+}
+
+// _____________________________________________________________________________
+TEST(CostAwareCacheTest, inflationEventuallyEvictsExpensiveEntries) {
+  CostAwareCache cache{2, 10_kB, 10_kB, GreedyDualSizeFrequency};
+  cache.insert("expensive", {100, 100ms});
+  // Each eviction raises the priority of the newly inserted entries, so the
+  // expensive entry, which is never accessed again, is eventually evicted.
+  size_t numInsertions = 0;
+  while (cache.contains("expensive")) {
+    cache.insert(std::to_string(numInsertions), {100, 10ms});
+    ++numInsertions;
+    ASSERT_LT(numInsertions, 100u);
+  }
+  EXPECT_GT(numInsertions, 2u);
+}
+
+// _____________________________________________________________________________
+TEST(CostAwareCacheTest, changeEvictionPolicy) {
+  CostAwareCache cache{3, 10_kB, 10_kB};
+  cache.insert("expensive", {100, 40'000ms});
+  cache.insert("a", {100, 2ms});
+  cache.insert("b", {100, 2ms});
+  cache.setEvictionPolicy(GreedyDualSizeFrequency);
+  EXPECT_EQ(cache.evictionPolicy(), GreedyDualSizeFrequency);
+  cache.insert("c", {100, 2ms});
+  EXPECT_TRUE(cache.contains("expensive"));
+  EXPECT_EQ(cache.numNonPinnedEntries(), 3u);
+
+  cache.setEvictionPolicy(LeastRecentlyUsed);
+  // The scores were recomputed in the order of iteration, so the next evicted
+  // entry is one of the existing entries, but never the new one.
+  cache.insert("d", {100, 2ms});
+  EXPECT_TRUE(cache.contains("d"));
+  EXPECT_EQ(cache.numNonPinnedEntries(), 3u);
+}
+
+// _____________________________________________________________________________
+TEST(CostAwareCacheTest, evictionPolicyFromString) {
+  EXPECT_EQ(ad_utility::evictionPolicyFromString("lru"), LeastRecentlyUsed);
+  EXPECT_EQ(ad_utility::evictionPolicyFromString("gdsf"),
+            GreedyDualSizeFrequency);
+  EXPECT_ANY_THROW(ad_utility::evictionPolicyFromString("fifo"));
+}
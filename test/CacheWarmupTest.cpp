@@ -0,0 +1,103 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "./IndexTestHelpers.h"
+#include "engine/CacheWarmup.h"
+
+namespace {
+// Write the `contents` to the `file`.
+void writeFile(const std::string& file, std::string_view contents) {
+  std::ofstream{file} << contents;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(CacheWarmup, readQueries) {
+  std::string file = "cacheWarmupTest.readQueries.txt";
+  writeFile(file, "SELECT * {?s ?p ?o}\n\n# A comment\nASK {}\n");
+  EXPECT_EQ(cacheWarmup::readQueries(file),
+            (std::vector<std::string>{"SELECT * {?s ?p ?o}", "ASK {}"}));
+  std::filesystem::remove(file);
+  EXPECT_ANY_THROW(cacheWarmup::readQueries(file));
+}
+
+// _____________________________________________________________________________
+TEST(CacheWarmup, run) {
+  auto* qec = ad_utility::testing::getQec(
+      "<a> <p> <b> . <a> <p> <c> . <b> <q> <c> . <c> <q> <warmup> .");
+  std::string queryFile = "cacheWarmupTest.queries.txt";
+  std::string blocksFile = "cacheWarmupTest.blocks.txt";
+  std::filesystem::remove(blocksFile);
+  writeFile(queryFile,
+            "SELECT ?x ?y {?x <p> ?y . ?y <q> ?z}\n"
+            "SELECT ?x {<b> <q> ?x}\n"
+            "This is not a valid query\n");
+
+  QueryResultCache cache;
+  auto run = [&]() {
+    return cacheWarmup::run(qec->getIndex(), cache, qec->getAllocator(),
+                            qec->getSortPerformanceEstimator(), true,
+                            queryFile, blocksFile, 2);
+  };
+  // The invalid query is skipped, the results of the other two are pinned.
+  EXPECT_EQ(run(), 2u);
+  EXPECT_EQ(cache.numPinnedEntries(), 2u);
+
+  // The ranges of the permutations that were read are recorded.
+  std::ifstream blocks{blocksFile};
+  std::string permutation;
+  off_t offset;
+  size_t size;
+  size_t numRanges = 0;
+  while (blocks >> permutation >> offset >> size) {
+    EXPECT_GT(size, 0u);
+    ++numRanges;
+  }
+  EXPECT_GT(numRanges, 0u);
+
+  // A second warm-up prefetches the recorded ranges and then finds the
+  // results in the cache. As it reads nothing, the recorded ranges are kept.
+  EXPECT_EQ(run(), 2u);
+  EXPECT_EQ(cache.numPinnedEntries(), 2u);
+  EXPECT_TRUE(std::filesystem::exists(blocksFile));
+  EXPECT_GT(std::filesystem::file_size(blocksFile), 0u);
+
+  std::filesystem::remove(queryFile);
+  std::filesystem::remove(blocksFile);
+}
+
+// _____________________________________________________________________________
+TEST(CacheWarmup, getCachedQueries) {
+  auto* qec = ad_utility::testing::getQec(
+      "<a> <p> <b> . <a> <p> <c> . <b> <q> <c> . <c> <q> <cachedQueries> .");
+  QueryResultCache cache;
+  auto compute = [&](std::vector<std::string> queries, bool pinResults) {
+    return cacheWarmup::computeQueries(
+        qec->getIndex(), cache, qec->getAllocator(),
+        qec->getSortPerformanceEstimator(), true, queries, pinResults, 2);
+  };
+  std::string pinned = "SELECT ?x {<a> <p> ?x}";
+  std::string notPinned = "SELECT ?x ?y {?x <q> ?y}";
+  EXPECT_EQ(compute({notPinned}, false), 1u);
+  EXPECT_EQ(compute({pinned}, true), 1u);
+
+  // The query with the pinned result comes first.
+  auto queries = cache.getCachedQueries(10);
+  ASSERT_EQ(queries.size(), 2u);
+  EXPECT_EQ(queries[0].query_, pinned);
+  EXPECT_TRUE(queries[0].isPinned_);
+  EXPECT_EQ(queries[1].query_, notPinned);
+  EXPECT_FALSE(queries[1].isPinned_);
+  ASSERT_EQ(cache.getCachedQueries(1).size(), 1u);
+
+  // Queries whose results were removed from the cache are not returned.
+  cache.clearUnpinnedOnly();
+  queries = cache.getCachedQueries(10);
+  ASSERT_EQ(queries.size(), 1u);
+  EXPECT_EQ(queries[0].query_, pinned);
+}
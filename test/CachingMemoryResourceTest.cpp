@@ -54,3 +54,26 @@ TEST(CachingMemoryResource, equality) {
   EXPECT_NE(p2, p3);
   EXPECT_NE(p1, p3);
 }
+
+TEST(CachingMemoryResource, allocateFromCacheAndRelease) {
+  // The test above disallows all allocations of the default resource.
+  std::pmr::set_default_resource(std::pmr::new_delete_resource());
+  CachingMemoryResource resource;
+  EXPECT_EQ(resource.allocateFromCache(16, 8), nullptr);
+  auto p1 = resource.allocateNew(16, 8);
+  auto p2 = resource.allocateNew(32, 8);
+  EXPECT_EQ(resource.numCachedBytes(), 0u);
+  resource.deallocate(p1, 16, 8);
+  resource.deallocate(p2, 32, 8);
+  EXPECT_EQ(resource.numCachedBytes(), 48u);
+
+  // Only a block with the same size and alignment is reused.
+  EXPECT_EQ(resource.allocateFromCache(16, 16), nullptr);
+  EXPECT_EQ(resource.allocateFromCache(16, 8), p1);
+  EXPECT_EQ(resource.numCachedBytes(), 32u);
+
+  EXPECT_EQ(resource.releaseCachedBlocks(), 32u);
+  EXPECT_EQ(resource.numCachedBytes(), 0u);
+  EXPECT_EQ(resource.allocateFromCache(32, 8), nullptr);
+  resource.deallocate(p1, 16, 8);
+}
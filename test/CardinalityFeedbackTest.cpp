@@ -0,0 +1,108 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include "engine/CardinalityFeedback.h"
+
+namespace {
+const std::filesystem::path file = "cardinalityFeedbackTest.tsv";
+
+// Remove the `file` at the beginning and at the end of the test.
+struct FileGuard {
+  FileGuard() { std::filesystem::remove(file); }
+  ~FileGuard() { std::filesystem::remove(file); }
+};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(CardinalityFeedback, isDisabledWithoutFile) {
+  CardinalityFeedback feedback;
+  EXPECT_FALSE(feedback.isEnabled());
+  feedback.record("sig", 10, 1000);
+  EXPECT_EQ(feedback.numSignatures(), 0);
+  EXPECT_FALSE(feedback.getCorrectionFactor("sig").has_value());
+}
+
+// _____________________________________________________________________________
+TEST(CardinalityFeedback, movingAverage) {
+  FileGuard guard;
+  CardinalityFeedback feedback;
+  feedback.setFile(file);
+  EXPECT_TRUE(feedback.isEnabled());
+  EXPECT_FALSE(feedback.getCorrectionFactor("sig").has_value());
+
+  // The first observation is taken as is (the sizes are incremented by one).
+  feedback.record("sig", 9, 99);
+  ASSERT_TRUE(feedback.getCorrectionFactor("sig").has_value());
+  EXPECT_NEAR(feedback.getCorrectionFactor("sig").value(), 10.0, 1e-9);
+
+  // Further observations are averaged in log space.
+  feedback.record("sig", 99, 9);
+  double expected =
+      std::pow(10.0, 1 - 2 * CardinalityFeedback::WEIGHT_OF_NEW_OBSERVATION);
+  EXPECT_NEAR(feedback.getCorrectionFactor("sig").value(), expected, 1e-9);
+  EXPECT_FALSE(feedback.getCorrectionFactor("otherSig").has_value());
+  EXPECT_EQ(feedback.numSignatures(), 1);
+
+  // The factors are clamped.
+  feedback.record("huge", 0, 1e12);
+  EXPECT_NEAR(feedback.getCorrectionFactor("huge").value(),
+              CardinalityFeedback::MAX_FACTOR, 1e-3);
+  feedback.record("tiny", 1e12, 0);
+  EXPECT_NEAR(feedback.getCorrectionFactor("tiny").value(),
+              1 / CardinalityFeedback::MAX_FACTOR, 1e-9);
+
+  feedback.clear();
+  EXPECT_EQ(feedback.numSignatures(), 0);
+  EXPECT_FALSE(feedback.getCorrectionFactor("sig").has_value());
+}
+
+// _____________________________________________________________________________
+TEST(CardinalityFeedback, persistence) {
+  FileGuard guard;
+  {
+    CardinalityFeedback feedback;
+    feedback.setFile(file);
+    feedback.record("JOIN ? <p> [join] | [join] <q> ?", 9, 99);
+    // Nothing is written before `NUM_OBSERVATIONS_BETWEEN_WRITES`
+    // observations.
+    EXPECT_FALSE(std::filesystem::exists(file));
+    for (size_t i = 1; i < CardinalityFeedback::NUM_OBSERVATIONS_BETWEEN_WRITES;
+         ++i) {
+      feedback.record("other", 0, 0);
+    }
+    EXPECT_TRUE(std::filesystem::exists(file));
+    feedback.record("last", 0, 1);
+    feedback.writeToFile();
+  }
+  CardinalityFeedback feedback;
+  feedback.setFile(file);
+  EXPECT_EQ(feedback.numSignatures(), 3);
+  EXPECT_NEAR(
+      feedback.getCorrectionFactor("JOIN ? <p> [join] | [join] <q> ?").value(),
+      10.0, 1e-3);
+  EXPECT_NEAR(feedback.getCorrectionFactor("other").value(), 1.0, 1e-9);
+  EXPECT_NEAR(feedback.getCorrectionFactor("last").value(), 2.0, 1e-3);
+}
+
+// _____________________________________________________________________________
+TEST(CardinalityFeedback, invalidLinesAreIgnored) {
+  FileGuard guard;
+  {
+    std::ofstream out{file};
+    out << "valid\t2\t5\n"
+        << "tooFewFields\t2\n"
+        << "notANumber\tabc\t3\n"
+        << "negative\t-1\t3\n";
+  }
+  CardinalityFeedback feedback;
+  feedback.setFile(file);
+  EXPECT_EQ(feedback.numSignatures(), 1);
+  EXPECT_NEAR(feedback.getCorrectionFactor("valid").value(), 2.0, 1e-9);
+}
@@ -0,0 +1,86 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "./util/GTestHelpers.h"
+#include "./util/IdTestHelpers.h"
+#include "index/ColumnCodec.h"
+#include "util/Random.h"
+
+using namespace columnCodec;
+using ad_utility::source_location;
+using ad_utility::testing::IntId;
+using ad_utility::testing::VocabId;
+
+namespace {
+// Check that the `column` is restored exactly after being encoded and decoded
+// with each of the codecs and with the best codec.
+void testRoundTrip(const std::vector<Id>& column,
+                   source_location l = source_location::current()) {
+  auto trace = generateLocationTrace(l);
+  auto check = [&column](ColumnCodec codec, const std::vector<char>& encoded) {
+    std::vector<Id> decoded(column.size());
+    decode(codec, encoded, decoded);
+    EXPECT_THAT(decoded, ::testing::ElementsAreArray(column));
+  };
+  for (auto codec : {ColumnCodec::Zstd, ColumnCodec::DeltaBitPacking,
+                     ColumnCodec::FrameOfReference}) {
+    check(codec, encode(codec, column));
+  }
+  auto [codec, encoded] = encodeWithBestCodec(column);
+  check(codec, encoded);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ColumnCodec, roundTrip) {
+  testRoundTrip({});
+  testRoundTrip({VocabId(42)});
+  // Sizes that are not multiples of the frame size, equal values (the bit
+  // width is zero), and the full range of bit patterns.
+  for (size_t size : {FRAME_SIZE - 1, FRAME_SIZE, 3 * FRAME_SIZE + 17}) {
+    std::vector<Id> sorted;
+    std::vector<Id> equal;
+    std::vector<Id> random;
+    ad_utility::FastRandomIntGenerator<uint64_t> generator;
+    for (size_t i = 0; i < size; ++i) {
+      sorted.push_back(VocabId(3 * i + i % 7));
+      equal.push_back(IntId(-5));
+      random.push_back(Id::fromBits(generator()));
+    }
+    testRoundTrip(sorted);
+    testRoundTrip(equal);
+    testRoundTrip(random);
+    testRoundTrip({Id::min(), Id::max(), Id::min(), Id::max()});
+  }
+}
+
+// _____________________________________________________________________________
+TEST(ColumnCodec, encodeWithBestCodec) {
+  // A sorted column with small gaps is best compressed via the deltas.
+  std::vector<Id> sorted;
+  std::vector<Id> smallRange;
+  ad_utility::SlowRandomIntGenerator<int64_t> generator{0, 1000};
+  for (size_t i = 0; i < 10'000; ++i) {
+    sorted.push_back(VocabId(i * 1000 + generator()));
+    smallRange.push_back(VocabId(1'000'000 + generator()));
+  }
+  auto [codec, encoded] = encodeWithBestCodec(sorted);
+  EXPECT_EQ(codec, ColumnCodec::DeltaBitPacking);
+  EXPECT_LT(encoded.size(), sorted.size() * sizeof(Id) / 2);
+
+  // An unsorted column with a small range of values.
+  std::tie(codec, encoded) = encodeWithBestCodec(smallRange);
+  EXPECT_EQ(codec, ColumnCodec::FrameOfReference);
+
+  // A column with few distinct but arbitrary bit patterns is much better
+  // compressed by ZSTD.
+  std::vector<Id> repeated;
+  for (size_t i = 0; i < 10'000; ++i) {
+    repeated.push_back(i % 2 == 0 ? Id::min() : Id::max());
+  }
+  std::tie(codec, encoded) = encodeWithBestCodec(repeated);
+  EXPECT_EQ(codec, ColumnCodec::Zstd);
+}
@@ -0,0 +1,91 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <absl/strings/str_cat.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "index/CompressedPatternIds.h"
+#include "util/File.h"
+
+namespace {
+// Assert that the `compressed` pattern IDs are equal to the `expected` ones.
+void expectEqual(const CompressedPatternIds& compressed,
+                 const std::vector<PatternID>& expected) {
+  ASSERT_EQ(compressed.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(compressed[i], expected[i]) << i;
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(CompressedPatternIds, bitWidth) {
+  EXPECT_EQ(CompressedPatternIds::bitWidthFor(0), 1u);
+  // With one pattern, the bit `1` is reserved for `NO_PATTERN`.
+  EXPECT_EQ(CompressedPatternIds::bitWidthFor(1), 1u);
+  EXPECT_EQ(CompressedPatternIds::bitWidthFor(2), 2u);
+  EXPECT_EQ(CompressedPatternIds::bitWidthFor(3), 2u);
+  EXPECT_EQ(CompressedPatternIds::bitWidthFor(4), 3u);
+  EXPECT_EQ(CompressedPatternIds::bitWidthFor(1ul << 31), 32u);
+}
+
+// _____________________________________________________________________________
+TEST(CompressedPatternIds, inMemory) {
+  CompressedPatternIds empty{std::vector<PatternID>{}};
+  EXPECT_EQ(empty.size(), 0u);
+
+  std::vector<PatternID> onlyNoPattern(100, NO_PATTERN);
+  expectEqual(CompressedPatternIds{onlyNoPattern}, onlyNoPattern);
+
+  // Different bit widths, with pattern IDs that are split between two words.
+  for (PatternID numPatterns : {1u, 3u, 5u, 1000u, 1u << 20}) {
+    std::vector<PatternID> patternIds;
+    for (size_t i = 0; i < 500; ++i) {
+      patternIds.push_back(i % 7 == 0 ? NO_PATTERN
+                                      : static_cast<PatternID>(
+                                            (i * 7919) % numPatterns));
+    }
+    patternIds.push_back(numPatterns - 1);
+    CompressedPatternIds compressed{patternIds};
+    EXPECT_EQ(compressed.bitWidth(),
+              CompressedPatternIds::bitWidthFor(numPatterns));
+    expectEqual(compressed, patternIds);
+  }
+
+  // The largest possible pattern ID needs 32 bits.
+  std::vector<PatternID> large{0, NO_PATTERN - 1, NO_PATTERN, 17};
+  CompressedPatternIds compressed{large};
+  EXPECT_EQ(compressed.bitWidth(), 32u);
+  expectEqual(compressed, large);
+}
+
+// _____________________________________________________________________________
+TEST(CompressedPatternIds, readFromFile) {
+  std::string filename = absl::StrCat("compressedPatternIdsTest",
+                                      CompressedPatternIds::FILE_SUFFIX);
+  std::vector<PatternID> patternIds;
+  for (size_t i = 0; i < 1000; ++i) {
+    patternIds.push_back(i % 5 == 0 ? NO_PATTERN : static_cast<PatternID>(i));
+  }
+  {
+    ad_utility::MmapVector<uint64_t> words(CompressedPatternIds::HEADER_SIZE,
+                                           filename);
+    CompressedPatternIds::Packer packer{words, 1000};
+    for (PatternID patternId : patternIds) {
+      packer.push(patternId);
+    }
+    packer.finish();
+  }
+  {
+    auto compressed = CompressedPatternIds::readFromFile(filename);
+    EXPECT_EQ(compressed.bitWidth(), 10u);
+    expectEqual(compressed, patternIds);
+
+    // The mapped file stays valid when the `CompressedPatternIds` is moved.
+    CompressedPatternIds moved = std::move(compressed);
+    expectEqual(moved, patternIds);
+  }
+  ad_utility::deleteFile(filename);
+}
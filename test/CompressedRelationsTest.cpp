@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 
 #include "./IndexTestHelpers.h"
+#include "./util/IdTestHelpers.h"
 #include "index/CompressedRelation.h"
 #include "util/GTestHelpers.h"
 #include "util/OnDestructionDontThrowDuringStackUnwinding.h"
@@ -78,9 +79,14 @@ void checkThatTablesAreEqual(const auto& expected, const IdTable& actual,
 // `inputs` must be ordered wrt the `col0_`. `testCaseName` is used to create
 // a unique name for the required temporary files and for the implicit cache
 // of the `CompressedRelationMetaData`. `blocksize` is the size of the blocks
-// in which the permutation will be compressed and stored on disk.
-void testCompressedRelations(const auto& inputs, std::string testCaseName,
-                             ad_utility::MemorySize blocksize) {
+// in which the permutation will be compressed and stored on disk. If
+// `bloomFilterBitsPerKey` is positive, the blocks get Bloom filters. The blocks
+// that are shared by several small relations are limited by the
+// `smallRelationsBlocksize`.
+void testCompressedRelations(
+    const auto& inputs, std::string testCaseName,
+    ad_utility::MemorySize blocksize, size_t bloomFilterBitsPerKey,
+    ad_utility::MemorySize smallRelationsBlocksize) {
   // First check the invariants of the `inputs`. They must be sorted by the
   // `col0_` and for each of the `inputs` the `col1And2_` must also be sorted.
   AD_CONTRACT_CHECK(std::ranges::is_sorted(
@@ -97,7 +103,8 @@ void testCompressedRelations(const auto& inputs, std::string testCaseName,
   // First create the on-disk permutation.
   size_t numColumns = getNumColumns(inputs);
   CompressedRelationWriter writer{numColumns, ad_utility::File{filename, "w"},
-                                  blocksize};
+                                  blocksize, bloomFilterBitsPerKey,
+                                  smallRelationsBlocksize};
   vector<CompressedRelationMetadata> metaData;
   {
     size_t i = 0;
@@ -136,6 +143,7 @@ void testCompressedRelations(const auto& inputs, std::string testCaseName,
       ++i;
     }
   }
+  size_t smallRelationsBlocksizeInRows = writer.smallRelationsBlocksize();
   auto blocks = std::move(writer).getFinishedBlocks();
   // Test the serialization of the blocks and the metaData.
   ad_utility::serialization::ByteBufferWriteSerializer w;
@@ -148,6 +156,15 @@ void testCompressedRelations(const auto& inputs, std::string testCaseName,
   r >> blocks;
 
   ASSERT_EQ(metaData.size(), inputs.size());
+  ASSERT_TRUE(std::ranges::all_of(blocks, [&](const auto& block) {
+    return (block.bloomFilter_.numIds_ > 0) == (bloomFilterBitsPerKey > 0);
+  }));
+  // The blocks with several relations are limited by the smaller blocksize.
+  ASSERT_TRUE(std::ranges::all_of(blocks, [&](const auto& block) {
+    return block.firstTriple_.col0Id_ == block.lastTriple_.col0Id_ ||
+           static_cast<double>(block.numRows_) <=
+               1.5 * static_cast<double>(smallRelationsBlocksizeInRows);
+  }));
 
   auto cancellationHandle =
       std::make_shared<ad_utility::CancellationHandle<>>();
@@ -206,11 +223,29 @@ void testCompressedRelations(const auto& inputs, std::string testCaseName,
       }
       checkThatTablesAreEqual(col3, tableWidthOne);
     };
+    // Check that the scans for a `col1Id` that is not contained in the
+    // relation are empty (with Bloom filters, these are the ones that skip
+    // the blocks).
+    auto checkEmptyScan = [&](int col1Id) {
+      EXPECT_EQ(reader.getResultSizeOfScan(metaData[i], V(col1Id), blocks), 0);
+      EXPECT_TRUE(reader
+                      .scan(metaData[i], V(col1Id), blocks,
+                            Permutation::ColumnIndicesRef{}, cancellationHandle)
+                      .empty());
+      for (const auto& block :
+           reader.lazyScan(metaData[i], V(col1Id), blocks,
+                           Permutation::ColumnIndices{}, cancellationHandle)) {
+        EXPECT_TRUE(block.empty());
+      }
+    };
     for (size_t j = 0; j < col1And2.size(); ++j) {
       if (col1And2[j][0] == lastCol1Id) {
         col3.push_back({col1And2[j][1]});
         continue;
       }
+      if (col1And2[j][0] > lastCol1Id + 1) {
+        checkEmptyScan(lastCol1Id + 1);
+      }
       scanAndCheck();
       lastCol1Id = col1And2[j][0];
       col3.clear();
@@ -229,9 +264,13 @@ namespace {
 // blocks.
 void testWithDifferentBlockSizes(const std::vector<RelationInput>& inputs,
                                  std::string testCaseName) {
-  testCompressedRelations(inputs, testCaseName, 19_B);
-  testCompressedRelations(inputs, testCaseName, 237_B);
-  testCompressedRelations(inputs, testCaseName, 4096_B);
+  auto noLimit = ad_utility::MemorySize::max();
+  testCompressedRelations(inputs, testCaseName, 19_B, 0, noLimit);
+  testCompressedRelations(inputs, testCaseName, 237_B, 0, noLimit);
+  testCompressedRelations(inputs, testCaseName, 4096_B, 0, noLimit);
+  testCompressedRelations(inputs, testCaseName, 237_B, 10, noLimit);
+  testCompressedRelations(inputs, testCaseName, 4096_B, 1, noLimit);
+  testCompressedRelations(inputs, testCaseName, 4096_B, 0, 64_B);
 }
 }  // namespace
 
@@ -413,6 +452,101 @@ TEST(CompressedRelationReader, getBlocksForJoinWithColumn) {
   test({V(12)}, {block2});
   test({V(13)}, {block3});
 }
+// _____________________________________________________________________________
+TEST(CompressedRelationReader, getBlocksForFilter) {
+  auto I = ad_utility::testing::IntId;
+  CompressedBlockMetadata block1{
+      {}, 0, {V(42), I(0), V(0)}, {V(42), I(-3), V(12)}};
+  CompressedBlockMetadata block2{
+      {}, 0, {V(42), I(-3), V(13)}, {V(42), I(-1), V(12)}};
+  CompressedBlockMetadata block3{
+      {}, 0, {V(42), I(-1), V(13)}, {V(42), I(-1), V(20)}};
+  CompressedBlockMetadata block4{
+      {}, 0, {V(42), I(-1), V(21)}, {V(42), V(100), V(1)}};
+
+  // We are only interested in blocks with a col0 of `42`.
+  CompressedRelationMetadata relation;
+  relation.col0Id_ = V(42);
+
+  std::vector blocks{block1, block2, block3, block4};
+  CompressedRelationReader::MetadataAndBlocks metadataAndBlocks{
+      relation, blocks, std::nullopt, std::nullopt};
+
+  using enum valueIdComparators::Comparison;
+  auto test = [&metadataAndBlocks](
+                  valueIdComparators::Comparison comparison, Id constant,
+                  const std::vector<CompressedBlockMetadata>& expectedBlocks,
+                  source_location l = source_location::current()) {
+    auto t = generateLocationTrace(l);
+    auto result = CompressedRelationReader::getBlocksForFilter(
+        metadataAndBlocks, comparison, constant);
+    EXPECT_THAT(result, ::testing::ElementsAreArray(expectedBlocks));
+  };
+  // The col1Ids of the relation `42` (which is stored in all the blocks) are
+  // the positive integers and the integers `<= -3` in `block1` (the negative
+  // integers come after the positive integers in the order of the `Id`s), the
+  // integers `[-3, -1]` in `block2` and `block3`, and the `Id`s from `-1` to
+  // `V(100)` in `block4`, including all the doubles.
+  test(EQ, I(-2), {block1, block2, block4});
+  test(LT, I(-3), {block1, block4});
+  test(GE, I(-1), {block1, block2, block3, block4});
+  test(GT, I(-1), {block1, block4});
+  test(EQ, I(5), {block1, block4});
+  test(EQ, V(5), {block4});
+  test(NE, ValueId::makeUndefined(), {});
+
+  // Test with a fixed col1Id, now the filter is applied to the last column.
+  // The col2Ids are `[min, V(12)]` in `block2`, `[V(13), V(20)]` in `block3`
+  // and `[V(21), max]` in `block4`.
+  metadataAndBlocks.col1Id_ = I(-1);
+  test(LT, V(13), {block2});
+  test(EQ, V(15), {block3});
+  test(GE, V(21), {block4});
+  test(GT, V(20), {block4});
+  test(EQ, I(15), {block2});
+}
+
+// _____________________________________________________________________________
+TEST(CompressedRelationReader, getBlocksForIdRanges) {
+  CompressedBlockMetadata block1{
+      {}, 0, {V(16), V(0), V(0)}, {V(42), V(2), V(12)}};
+  CompressedBlockMetadata block2{
+      {}, 0, {V(42), V(3), V(0)}, {V(42), V(4), V(12)}};
+  CompressedBlockMetadata block3{
+      {}, 0, {V(42), V(4), V(13)}, {V(42), V(9), V(1)}};
+  CompressedBlockMetadata block4{
+      {}, 0, {V(42), V(12), V(0)}, {V(50), V(0), V(0)}};
+
+  CompressedRelationMetadata relation;
+  relation.col0Id_ = V(42);
+  std::vector blocks{block1, block2, block3, block4};
+  CompressedRelationReader::MetadataAndBlocks metadataAndBlocks{
+      relation, blocks, std::nullopt, std::nullopt};
+
+  auto test = [&metadataAndBlocks](
+                  const std::vector<std::pair<Id, Id>>& ranges,
+                  const std::vector<CompressedBlockMetadata>& expectedBlocks,
+                  source_location l = source_location::current()) {
+    auto t = generateLocationTrace(l);
+    auto result = CompressedRelationReader::getBlocksForIdRanges(
+        metadataAndBlocks, ranges);
+    EXPECT_THAT(result, ::testing::ElementsAreArray(expectedBlocks));
+  };
+  // The col1Ids of the relation `42` are `[min, V(2)]` in `block1` (it starts
+  // with another relation), `[V(3), V(4)]` in `block2`, `[V(4), V(9)]` in
+  // `block3`, and `[V(12), max]` in `block4`. Both ends of a range are
+  // inclusive.
+  test({{V(3), V(3)}}, {block2});
+  test({{V(2), V(3)}}, {block1, block2});
+  test({{V(4), V(4)}}, {block2, block3});
+  test({{V(10), V(11)}}, {});
+  test({{V(10), V(12)}}, {block4});
+  test({{V(1), V(1)}, {V(5), V(20)}}, {block1, block3, block4});
+  test({}, {});
+  // An empty range (the first `Id` is greater than the last) matches nothing.
+  test({{V(4), V(3)}}, {});
+}
+
 TEST(CompressedRelationReader, getBlocksForJoin) {
   CompressedBlockMetadata block1{
       {}, 0, {V(16), V(0), V(0)}, {V(38), V(4), V(12)}};
@@ -0,0 +1,46 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./util/AllocatorTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "engine/CompressedResultTable.h"
+
+using ad_utility::testing::makeAllocator;
+
+// _____________________________________________________________________________
+TEST(CompressedResultTable, compressAndDecompress) {
+  // A table with several blocks, the last of which is incomplete, a sorted
+  // column, an unsorted column, and a column that refers to the local vocab.
+  LocalVocab localVocab;
+  Id word = Id::makeFromLocalVocabIndex(
+      localVocab.getIndexAndAddIfNotContained("\"word\""));
+  IdTable table{3, makeAllocator()};
+  size_t numRows = 2 * CompressedResultTable::BLOCK_SIZE + 17;
+  for (size_t i = 0; i < numRows; ++i) {
+    table.push_back({Id::makeFromInt(static_cast<int64_t>(i / 3)),
+                     Id::makeFromDouble(static_cast<double>(i % 101) / 7),
+                     i % 2 == 0 ? word : Id::makeUndefined()});
+  }
+  ResultTable result{table.clone(), {0}, std::move(localVocab)};
+  CompressedResultTable compressed{result};
+  EXPECT_EQ(compressed.numRows(), numRows);
+  EXPECT_EQ(compressed.numColumns(), 3u);
+  EXPECT_LT(compressed.compressedSize().getBytes(),
+            numRows * 3 * sizeof(Id) / 2);
+
+  auto decompressed = compressed.decompress(makeAllocator());
+  EXPECT_EQ(decompressed.idTable(), table);
+  EXPECT_EQ(decompressed.sortedBy(), std::vector<ColumnIndex>{0});
+  // The local vocab is shared with the original result.
+  EXPECT_EQ(&decompressed.localVocab(), &result.localVocab());
+
+  // Empty results.
+  ResultTable empty{IdTable{2, makeAllocator()}, {}, LocalVocab{}};
+  CompressedResultTable compressedEmpty{empty};
+  EXPECT_EQ(compressedEmpty.compressedSize().getBytes(), 0u);
+  auto decompressedEmpty = compressedEmpty.decompress(makeAllocator());
+  EXPECT_EQ(decompressedEmpty.idTable().numRows(), 0u);
+  EXPECT_EQ(decompressedEmpty.idTable().numColumns(), 2u);
+}
@@ -32,6 +32,8 @@ class CompressorStreamTestFixture
       filterStream.push(io::gzip_decompressor());
     } else if (GetParam() == CompressionMethod::DEFLATE) {
       filterStream.push(io::zlib_decompressor());
+    } else if (GetParam() == CompressionMethod::ZSTD) {
+      filterStream.push(io::zstd_decompressor());
     } else {
       // Unsupported decompression
       AD_FAIL();
@@ -64,4 +66,36 @@ using ad_utility::content_encoding::CompressionMethod;
 INSTANTIATE_TEST_SUITE_P(CompressionMethodParameters,
                          CompressorStreamTestFixture,
                          ::testing::Values(CompressionMethod::DEFLATE,
-                                           CompressionMethod::GZIP));
+                                           CompressionMethod::GZIP,
+                                           CompressionMethod::ZSTD));
+
+// _____________________________________________________________________________
+TEST(CompressorStream, zstdAndCompressionLevels) {
+  std::string input(100'000, 'A');
+  auto compressAll = [&input](CompressionMethod method, size_t level) {
+    std::string result;
+    for (const auto& block :
+         compressStream(std::vector{input}, method, level)) {
+      result += block;
+    }
+    return result;
+  };
+  auto decompress = [](std::string_view compressedData) {
+    std::string result;
+    io::filtering_ostream filterStream;
+    filterStream.push(io::zstd_decompressor());
+    filterStream.push(io::back_inserter(result));
+    filterStream.write(compressedData.data(),
+                       static_cast<std::streamsize>(compressedData.size()));
+    filterStream.reset();
+    return result;
+  };
+  // Levels that are too large are clamped to the maximal level.
+  for (size_t level : {0, 1, 3, 19, 1000}) {
+    auto compressed = compressAll(CompressionMethod::ZSTD, level);
+    EXPECT_LT(compressed.size(), input.size() / 100);
+    EXPECT_EQ(decompress(compressed), input);
+  }
+  EXPECT_NO_THROW(compressAll(CompressionMethod::GZIP, 1000));
+  EXPECT_NO_THROW(compressAll(CompressionMethod::DEFLATE, 0));
+}
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <chrono>
 #include <future>
+#include <ranges>
 #include <string>
 #include <thread>
 
@@ -309,3 +310,98 @@ TEST(ConcurrentCache, cacheStatusToString) {
       static_cast<int>(notInCacheAndNotComputed) + 1);
   EXPECT_ANY_THROW(toString(outOfBounds));
 }
+
+using ShardedCache = ad_utility::ShardedConcurrentCache<
+    ad_utility::HeapBasedLRUCache<int, std::string,
+                                  ad_utility::StringSizeGetter<std::string>>,
+    4>;
+using ad_utility::MemorySize;
+
+// _____________________________________________________________________________
+TEST(ShardedConcurrentCache, globalSizeLimit) {
+  ShardedCache cache;
+  cache.setMaxSize(MemorySize::bytes(10));
+  for (int i = 0; i < 10; ++i) {
+    auto result = cache.computeOnce(i, waiting_function("ab"s, 0));
+    EXPECT_EQ(result._cacheStatus, ad_utility::CacheStatus::computed);
+    EXPECT_LE(cache.nonPinnedSize(), MemorySize::bytes(10));
+  }
+  // The limit holds for all the shards together.
+  EXPECT_EQ(cache.numNonPinnedEntries(), 5u);
+  EXPECT_EQ(cache.nonPinnedSize(), MemorySize::bytes(10));
+  auto contained = std::views::iota(0, 10) | std::views::filter([&](int i) {
+                     return cache.cacheContains(i);
+                   });
+  EXPECT_EQ(std::ranges::distance(contained), 5);
+  auto cached = cache.getIfContained(*contained.begin());
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_EQ(*cached->_resultPointer, "ab");
+  EXPECT_EQ(cached->_cacheStatus, ad_utility::CacheStatus::cachedNotPinned);
+
+  // Pinned entries reduce the capacity for the non-pinned entries.
+  cache.computeOncePinned(100, waiting_function("abcdef"s, 0));
+  EXPECT_EQ(cache.numPinnedEntries(), 1u);
+  EXPECT_EQ(cache.pinnedSize(), MemorySize::bytes(6));
+  EXPECT_EQ(cache.numNonPinnedEntries(), 2u);
+  EXPECT_EQ(cache.nonPinnedSize(), MemorySize::bytes(4));
+
+  // Pinned entries are never evicted, even if they exceed the capacity.
+  cache.setMaxSize(MemorySize::bytes(3));
+  EXPECT_EQ(cache.numPinnedEntries(), 1u);
+  EXPECT_EQ(cache.numNonPinnedEntries(), 0u);
+
+  cache.clearAll();
+  EXPECT_EQ(cache.numPinnedEntries(), 0u);
+  EXPECT_EQ(cache.pinnedSize(), MemorySize::bytes(0));
+}
+
+// _____________________________________________________________________________
+TEST(ShardedConcurrentCache, globalNumEntriesLimitAndMakeRoom) {
+  ShardedCache cache;
+  cache.setMaxNumEntries(3);
+  for (int i = 0; i < 20; ++i) {
+    cache.computeOnce(i, waiting_function("abc"s, 0));
+  }
+  EXPECT_EQ(cache.numNonPinnedEntries(), 3u);
+
+  // Some entries were stored in the same shard (there are only four shards).
+  cache.setMaxNumEntries(100);
+  for (int i = 0; i < 20; ++i) {
+    cache.computeOnce(i, waiting_function("abc"s, 0));
+  }
+  EXPECT_EQ(cache.numNonPinnedEntries(), 20u);
+  EXPECT_TRUE(cache.makeRoomAsMuchAsPossible(MemorySize::bytes(10)));
+  EXPECT_LE(cache.numNonPinnedEntries(), 16u);
+  EXPECT_FALSE(cache.makeRoomAsMuchAsPossible(MemorySize::bytes(1000)));
+  EXPECT_EQ(cache.numNonPinnedEntries(), 0u);
+
+  // Evicted entries are reported to the `OnEviction` function.
+  std::atomic<size_t> numEvicted = 0;
+  cache.setOnEviction([&numEvicted](const int&, const auto&) {
+    ++numEvicted;
+  });
+  cache.setMaxNumEntries(1);
+  cache.computeOnce(1, waiting_function("abc"s, 0));
+  cache.computeOnce(2, waiting_function("abc"s, 0));
+  EXPECT_EQ(numEvicted, 1u);
+  EXPECT_EQ(cache.numNonPinnedEntries(), 1u);
+}
+
+// _____________________________________________________________________________
+TEST(ShardedConcurrentCache, concurrentInsertions) {
+  ShardedCache cache;
+  cache.setMaxSize(MemorySize::bytes(100));
+  std::vector<std::future<void>> futures;
+  for (int t = 0; t < 4; ++t) {
+    futures.push_back(std::async(std::launch::async, [&cache, t] {
+      for (int i = 0; i < 200; ++i) {
+        cache.computeOnce(t * 1000 + i, waiting_function("abcd"s, 0));
+      }
+    }));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+  EXPECT_LE(cache.nonPinnedSize(), MemorySize::bytes(100));
+  EXPECT_GE(cache.numNonPinnedEntries(), 1u);
+}
@@ -0,0 +1,91 @@
+//  Copyright 2026, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include "util/http/ConnectionPool.h"
+
+using ad_utility::httpUtils::ConnectionPool;
+
+namespace {
+// A client that only counts how many instances were created.
+struct FakeClient {
+  static inline std::atomic<size_t> numCreated = 0;
+  std::string host_;
+  bool isReusable_ = true;
+  FakeClient(std::string_view host, std::string_view) : host_{host} {
+    if (host == "unreachable") {
+      throw std::runtime_error("Connection refused");
+    }
+    ++numCreated;
+  }
+  bool isReusable() const { return isReusable_; }
+};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ConnectionPool, reusesIdleConnections) {
+  ConnectionPool<FakeClient> pool;
+  FakeClient::numCreated = 0;
+  {
+    auto connection = pool.acquire("host", "80", 10, 10);
+    EXPECT_FALSE(connection->isReused());
+    EXPECT_EQ((*connection)->host_, "host");
+  }
+  EXPECT_EQ(pool.numIdle(), 1u);
+  {
+    auto c1 = pool.acquire("host", "80", 10, 10);
+    EXPECT_TRUE(c1->isReused());
+    // Another port is another host.
+    auto c2 = pool.acquire("host", "81", 10, 10);
+    EXPECT_FALSE(c2->isReused());
+    // The first connection is in use, so a new one is established.
+    auto c3 = pool.acquire("host", "80", 10, 10);
+    EXPECT_FALSE(c3->isReused());
+    EXPECT_EQ(FakeClient::numCreated, 3u);
+    // This connection can't be reused, so it is not kept.
+    (*c3)->isReusable_ = false;
+  }
+  EXPECT_EQ(pool.numIdle(), 2u);
+}
+
+// _____________________________________________________________________________
+TEST(ConnectionPool, limitsIdleConnections) {
+  ConnectionPool<FakeClient> pool;
+  {
+    auto c1 = pool.acquire("host", "80", 10, 2);
+    auto c2 = pool.acquire("host", "80", 10, 2);
+    auto c3 = pool.acquire("host", "80", 10, 2);
+  }
+  EXPECT_EQ(pool.numIdle(), 2u);
+}
+
+// _____________________________________________________________________________
+TEST(ConnectionPool, failedConnectionsAreNotCounted) {
+  ConnectionPool<FakeClient> pool;
+  EXPECT_THROW(pool.acquire("unreachable", "80", 1, 1), std::runtime_error);
+  // The failed attempt doesn't block the only slot.
+  EXPECT_THROW(pool.acquire("unreachable", "80", 1, 1), std::runtime_error);
+  EXPECT_EQ(pool.numIdle(), 0u);
+}
+
+// _____________________________________________________________________________
+TEST(ConnectionPool, blocksIfAllConnectionsAreInUse) {
+  ConnectionPool<FakeClient> pool;
+  auto c1 = pool.acquire("host", "80", 1, 1);
+  std::atomic<bool> acquired = false;
+  std::thread thread{[&pool, &acquired]() {
+    auto c2 = pool.acquire("host", "80", 1, 1);
+    EXPECT_TRUE(c2->isReused());
+    acquired = true;
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(acquired);
+  c1.reset();
+  thread.join();
+  EXPECT_TRUE(acquired);
+}
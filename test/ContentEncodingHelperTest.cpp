@@ -49,7 +49,8 @@ auto getValuePairsForHeaderTest() {
       // empty string_view means no such header is present
       std::pair{CompressionMethod::NONE, std::string_view{}},
       std::pair{CompressionMethod::DEFLATE, "deflate"},
-      std::pair{CompressionMethod::GZIP, "gzip"});
+      std::pair{CompressionMethod::GZIP, "gzip"},
+      std::pair{CompressionMethod::ZSTD, "zstd"});
 }
 
 INSTANTIATE_TEST_SUITE_P(CompressionMethodParameters,
@@ -95,3 +96,19 @@ TEST(ContentEncodingHelper, DeflateHeaderIsPreferredOverGzipOnMultipleHeaders) {
 
   ASSERT_EQ(result, CompressionMethod::DEFLATE);
 }
+
+TEST(ContentEncodingHelper, ZstdHeaderIsPreferred) {
+  http::request<http::string_body> request;
+  request.set(http::field::accept_encoding, "gzip, deflate, zstd");
+  ASSERT_EQ(getCompressionMethodForRequest(request), CompressionMethod::ZSTD);
+}
+
+TEST(ContentEncodingHelper, QualityValues) {
+  http::request<http::string_body> request;
+  request.set(http::field::accept_encoding, "gzip;q=0.5, zstd ; q=0.000");
+  ASSERT_EQ(getCompressionMethodForRequest(request), CompressionMethod::GZIP);
+  request.set(http::field::accept_encoding, "deflate;q=0, zstd;q=0.01");
+  ASSERT_EQ(getCompressionMethodForRequest(request), CompressionMethod::ZSTD);
+  request.set(http::field::accept_encoding, "gzip;q=0");
+  ASSERT_EQ(getCompressionMethodForRequest(request), CompressionMethod::NONE);
+}
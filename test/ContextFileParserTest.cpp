@@ -57,3 +57,41 @@ TEST(ContextFileParserTest, getLineTest) {
   ASSERT_FALSE(p.getLine(a));
   remove("_testtmp.contexts.tsv");
 };
+
+// _____________________________________________________________________________
+TEST(ContextFileParserTest, getBatch) {
+  std::fstream f("_testtmp.batches.contexts.tsv", std::ios_base::out);
+  f << "Foo\t0\t0\t2\n"
+       "bar\t0\t0\t2\n"
+       "Bär\t1\t1\t1\n"
+       "X\t0\t2\t1\n"
+       "Y\t0\t2\t1\n"
+       "Z\t0\t2\t1\n";
+  f.close();
+  ContextFileParser p("_testtmp.batches.contexts.tsv",
+                      LocaleManager("en", "US", false));
+  auto words = [](const std::vector<ContextFileParser::Line>& lines) {
+    std::vector<std::string> result;
+    for (const auto& line : lines) {
+      result.push_back(line._word);
+    }
+    return result;
+  };
+  // A batch is only finished at the end of a context.
+  using V = std::vector<std::string>;
+  ASSERT_EQ(words(p.getBatch(1, 2)), (V{"foo", "bar"}));
+  ASSERT_EQ(words(p.getBatch(2, 2)), (V{"Bär", "x", "y", "z"}));
+  ASSERT_TRUE(p.getBatch(2, 2).empty());
+
+  // Batches and single lines can be mixed.
+  ContextFileParser p2("_testtmp.batches.contexts.tsv",
+                       LocaleManager("en", "US", false));
+  ASSERT_EQ(words(p2.getBatch(1, 1)), (V{"foo", "bar"}));
+  ContextFileParser::Line a;
+  ASSERT_TRUE(p2.getLine(a));
+  ASSERT_EQ("Bär", a._word);
+  ASSERT_TRUE(a._isEntity);
+  ASSERT_EQ(1u, a._contextId.get());
+  ASSERT_EQ(words(p2.getBatch(100, 3)), (V{"x", "y", "z"}));
+  remove("_testtmp.batches.contexts.tsv");
+}
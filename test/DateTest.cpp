@@ -530,3 +530,27 @@ TEST(DateOrLargeYear, Order) {
   ASSERT_LT(d2, d3);
   ASSERT_LT(d1, d3);
 }
+
+TEST(DateOrLargeYear, getFirstOfYearAndMonth) {
+  using D = DateOrLargeYear;
+  auto first = &D::getFirstOfYearAndMonth;
+  auto date = [](int year, int month, int day, int hour = -1) {
+    return D{Date{year, month, day, hour}};
+  };
+  // The dates of a year without a month (`xsd:gYear`) are the smallest dates
+  // of the year.
+  ASSERT_LE(first(2020, 0), date(2020, 0, 0));
+  ASSERT_EQ(first(2020, 0), D(Date{2020, 0, 0, -1, 0, 0.0, -23}));
+  ASSERT_LT(date(2020, 0, 0), first(2020, 1));
+  ASSERT_LT(first(2020, 3), date(2020, 3, 0));
+  ASSERT_LT(date(2020, 2, 29, 23), first(2020, 3));
+  ASSERT_LT(first(2020, 3), date(2020, 3, 1));
+  ASSERT_LT(date(2019, 12, 31, 23), first(2020, 0));
+  ASSERT_LT(first(-44, 3), date(-44, 3, 15));
+
+  // For large years, the month is ignored.
+  ASSERT_EQ(first(12345, 7), D(12345, D::Type::Year));
+  ASSERT_LT(first(12345, 0), D(12345, D::Type::DateTime));
+  ASSERT_LT(D(-12345, D::Type::DateTime), first(-12344, 0));
+  ASSERT_ANY_THROW(first(2020, 13));
+}
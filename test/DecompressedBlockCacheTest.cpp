@@ -0,0 +1,103 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "./util/AllocatorTestHelpers.h"
+#include "./util/IdTestHelpers.h"
+#include "index/DecompressedBlockCache.h"
+
+using ad_utility::testing::makeAllocator;
+using ad_utility::testing::VocabId;
+using namespace ad_utility::memory_literals;
+
+namespace {
+// Return a lambda that creates a single column with `numRows` entries and
+// counts how often it was called.
+auto makeColumnComputer(size_t numRows, size_t& numCalls) {
+  return [numRows, &numCalls]() {
+    ++numCalls;
+    DecompressedBlock column{1, makeAllocator()};
+    for (size_t i = 0; i < numRows; ++i) {
+      column.push_back({VocabId(i)});
+    }
+    return column;
+  };
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(DecompressedBlockCache, hitsAndMisses) {
+  DecompressedBlockCache cache{1_MB};
+  size_t numCalls = 0;
+  auto compute = makeColumnComputer(100, numCalls);
+  auto column = cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(column->numRows(), 100);
+  EXPECT_EQ(column->at(17, 0), VocabId(17));
+  EXPECT_EQ(cache.numMisses(), 1);
+  EXPECT_EQ(cache.numHits(), 0);
+
+  // The same key is found in the cache, a different reader or offset is not.
+  auto cached = cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(cached.get(), column.get());
+  EXPECT_EQ(numCalls, 1);
+  cache.getOrCompute({1, 42}, compute);
+  cache.getOrCompute({0, 43}, compute);
+  EXPECT_EQ(numCalls, 3);
+  EXPECT_EQ(cache.numHits(), 1);
+  EXPECT_EQ(cache.numMisses(), 3);
+  EXPECT_EQ(cache.numEntries(), 3);
+  EXPECT_EQ(cache.size(), ad_utility::MemorySize::bytes(3 * 100 * sizeof(Id)));
+
+  // After clearing the cache, the column has to be computed again, but the
+  // statistics are kept.
+  cache.clear();
+  EXPECT_EQ(cache.numEntries(), 0);
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 4);
+  EXPECT_EQ(cache.numMisses(), 4);
+}
+
+// _____________________________________________________________________________
+TEST(DecompressedBlockCache, sizeLimits) {
+  // Each of the shards can store `1_kB / NUM_SHARDS` of columns, which is less
+  // than the size of the column.
+  DecompressedBlockCache cache{1_kB};
+  size_t numCalls = 0;
+  auto compute = makeColumnComputer(100, numCalls);
+  cache.getOrCompute({0, 42}, compute);
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 2);
+  EXPECT_EQ(cache.numEntries(), 0);
+
+  // A size of zero disables the cache completely.
+  cache.setMaxSize(0_B);
+  EXPECT_FALSE(cache.isEnabled());
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 3);
+  EXPECT_EQ(cache.numMisses(), 2);
+
+  cache.setMaxSize(1_MB);
+  EXPECT_TRUE(cache.isEnabled());
+  cache.getOrCompute({0, 42}, compute);
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 4);
+  EXPECT_EQ(cache.numEntries(), 1);
+}
+
+// _____________________________________________________________________________
+TEST(DecompressedBlockCache, evictions) {
+  DecompressedBlockCache cache{1_MB};
+  size_t numCalls = 0;
+  auto compute = makeColumnComputer(100, numCalls);
+  // The columns don't fit into the cache together, so some of them are
+  // evicted.
+  size_t numColumns = 2 * 1'000'000 / (100 * sizeof(Id));
+  for (size_t i = 0; i < numColumns; ++i) {
+    cache.getOrCompute({0, i}, compute);
+  }
+  EXPECT_EQ(cache.numMisses(), numColumns);
+  EXPECT_GT(cache.numEvictions(), 0);
+  EXPECT_EQ(cache.numEvictions(), numColumns - cache.numEntries());
+}
@@ -0,0 +1,201 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "./IndexTestHelpers.h"
+#include "./util/GTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "./util/TripleComponentTestHelpers.h"
+#include "engine/IndexScan.h"
+#include "engine/Join.h"
+#include "engine/QueryExecutionTree.h"
+#include "index/DeltaTriples.h"
+#include "index/IndexImpl.h"
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using Var = Variable;
+
+namespace {
+constexpr std::string_view turtle =
+    "<a> <p> <b> . <a> <p> <c> . <b> <p> <c> . <b> <q> <c> .";
+
+// The `DeltaTriples` of the (static) test index for the `turtle` above. The
+// tests reset them at the end, s.t. they don't influence each other.
+std::pair<QueryExecutionContext*, DeltaTriples*> getQecAndDeltaTriples() {
+  auto* qec = ad_utility::testing::getQec(std::string{turtle});
+  // The index of the `getQec` function is not `const`, only the access to it.
+  auto& index = const_cast<Index&>(qec->getIndex());
+  return {qec, &index.deltaTriples()};
+}
+
+// Scan the `permutation` of the index of the `qec` for the `col0` and the
+// (optional) `col1`.
+IdTable scan(QueryExecutionContext* qec, Permutation::Enum permutation,
+             std::string col0, std::optional<std::string> col1 = {}) {
+  TripleComponent col0Component{std::move(col0)};
+  std::optional<TripleComponent> col1Component;
+  if (col1.has_value()) {
+    col1Component = TripleComponent{std::move(col1.value())};
+  }
+  return qec->getIndex().scan(
+      col0Component,
+      col1Component ? std::optional{std::cref(col1Component.value())}
+                    : std::nullopt,
+      permutation, {}, std::make_shared<ad_utility::CancellationHandle<>>());
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(DeltaTriples, parseUpdate) {
+  auto [isInsert, triples] = DeltaTriples::parseUpdate(
+      "PREFIX x: <http://x.org/> insert  DATA { x:a x:b \"c\" . <d> <e> <f> }");
+  EXPECT_TRUE(isInsert);
+  ASSERT_EQ(triples.size(), 2u);
+  EXPECT_EQ(triples[0].subject_, "<http://x.org/a>");
+  EXPECT_EQ(triples[0].predicate_, "<http://x.org/b>");
+  EXPECT_EQ(triples[0].object_,
+            ad_utility::testing::tripleComponentLiteral("\"c\""));
+  EXPECT_EQ(triples[1].subject_, "<d>");
+
+  std::tie(isInsert, triples) =
+      DeltaTriples::parseUpdate("DELETE DATA {\n<a> <b> 42 .\n} ;");
+  EXPECT_FALSE(isInsert);
+  ASSERT_EQ(triples.size(), 1u);
+  EXPECT_EQ(triples[0].object_, TripleComponent{int64_t{42}});
+
+  std::tie(isInsert, triples) = DeltaTriples::parseUpdate("INSERT DATA {}");
+  EXPECT_TRUE(triples.empty());
+
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      DeltaTriples::parseUpdate("DELETE { ?s ?p ?o } WHERE { ?s ?p ?o }"),
+      HasSubstr("INSERT DATA"));
+  EXPECT_ANY_THROW(DeltaTriples::parseUpdate("INSERT DATA { <a> <b> }"));
+}
+
+// _____________________________________________________________________________
+TEST(DeltaTriples, insertAndDeleteAreMergedIntoScans) {
+  auto [qec, deltaTriples] = getQecAndDeltaTriples();
+  auto id = ad_utility::testing::makeGetId(qec->getIndex());
+  using enum Permutation::Enum;
+
+  // Inserting a triple of the index has no effect, `<newWord>` is a new word.
+  deltaTriples->applyUpdate(
+      "INSERT DATA { <a> <p> <b> . <c> <p> <a> . <newWord> <p> <b> }");
+  EXPECT_EQ(deltaTriples->getCounts(), (DeltaTriples::Counts{2, 0}));
+  EXPECT_FALSE(deltaTriples->empty());
+  auto newId = deltaTriples->getLocalVocabId(TripleComponent{"<newWord>"});
+  ASSERT_TRUE(newId.has_value());
+  EXPECT_EQ(deltaTriples->localVocab()->getWord(newId->getLocalVocabIndex()),
+            "<newWord>");
+  EXPECT_EQ(deltaTriples->getLocalVocabId(TripleComponent{"<otherWord>"}),
+            std::nullopt);
+
+  auto a = id("<a>"), b = id("<b>"), c = id("<c>");
+  EXPECT_EQ(scan(qec, PSO, "<p>"),
+            makeIdTableFromVector(
+                {{a, b}, {a, c}, {b, c}, {c, a}, {newId.value(), b}}));
+  EXPECT_EQ(scan(qec, POS, "<p>", "<b>"),
+            makeIdTableFromVector({{a}, {newId.value()}}));
+  EXPECT_EQ(scan(qec, SPO, "<newWord>"),
+            makeIdTableFromVector({{id("<p>"), b}}));
+  EXPECT_EQ(qec->getIndex().getResultSizeOfScan(TripleComponent{"<p>"},
+                                                 TripleComponent{"<b>"}, POS),
+            2u);
+  EXPECT_EQ(qec->getIndex().getCardinality(TripleComponent{"<p>"}, PSO), 5u);
+
+  // Deleting a triple that was inserted before and a triple of the index.
+  // Deleting a triple with a word that is not contained in any vocabulary has
+  // no effect.
+  deltaTriples->applyUpdate(
+      "DELETE DATA { <c> <p> <a> . <a> <p> <c> . <a> <p> <unknown> . }");
+  EXPECT_EQ(deltaTriples->getCounts(), (DeltaTriples::Counts{1, 1}));
+  EXPECT_EQ(scan(qec, PSO, "<p>"),
+            makeIdTableFromVector({{a, b}, {b, c}, {newId.value(), b}}));
+  EXPECT_EQ(scan(qec, OPS, "<c>"), makeIdTableFromVector({{id("<p>"), b},
+                                                          {id("<q>"), b}}));
+  EXPECT_EQ(qec->getIndex().getCardinality(TripleComponent{"<p>"}, PSO), 3u);
+
+  // Inserting a deleted triple of the index again undoes the deletion.
+  deltaTriples->applyUpdate("INSERT DATA { <a> <p> <c> }");
+  EXPECT_EQ(deltaTriples->getCounts(), (DeltaTriples::Counts{1, 0}));
+  EXPECT_EQ(scan(qec, PSO, "<p>", "<a>"), makeIdTableFromVector({{b}, {c}}));
+
+  deltaTriples->clear();
+  EXPECT_TRUE(deltaTriples->empty());
+  EXPECT_EQ(scan(qec, PSO, "<p>"),
+            makeIdTableFromVector({{a, b}, {a, c}, {b, c}}));
+}
+
+// _____________________________________________________________________________
+TEST(DeltaTriples, mergeIntoScanWithAdditionalColumnsAndFullScan) {
+  auto [qec, deltaTriples] = getQecAndDeltaTriples();
+  auto id = ad_utility::testing::makeGetId(qec->getIndex());
+  auto a = id("<a>"), b = id("<b>"), c = id("<c>"), p = id("<p>");
+  deltaTriples->insertTriples(std::vector{DeltaTriples::IdTriple{c, p, a}});
+  deltaTriples->deleteTriples(std::vector{DeltaTriples::IdTriple{a, p, c}});
+  EXPECT_EQ(deltaTriples->getCounts(Permutation::PSO, p, std::nullopt),
+            (DeltaTriples::Counts{1, 1}));
+  EXPECT_EQ(deltaTriples->getCounts(Permutation::PSO, p, b),
+            (DeltaTriples::Counts{}));
+
+  // The additional columns of the inserted triples are UNDEF.
+  auto I = ad_utility::testing::IntId;
+  auto U = Id::makeUndefined();
+  auto table =
+      makeIdTableFromVector({{a, b, I(1)}, {a, c, I(2)}, {b, c, I(3)}});
+  deltaTriples->mergeIntoScan(Permutation::PSO, p, std::nullopt, table);
+  EXPECT_EQ(table,
+            makeIdTableFromVector({{a, b, I(1)}, {b, c, I(3)}, {c, a, U}}));
+
+  // A full scan.
+  auto full = makeIdTableFromVector({{a, p, b}, {a, p, c}, {b, p, c}});
+  deltaTriples->mergeIntoScan(Permutation::SPO, std::nullopt, std::nullopt,
+                              full);
+  EXPECT_EQ(full, makeIdTableFromVector({{a, p, b}, {b, p, c}, {c, p, a}}));
+  EXPECT_ANY_THROW(deltaTriples->mergeIntoScan(Permutation::SPO, std::nullopt,
+                                               a, full));
+  deltaTriples->clear();
+}
+
+// _____________________________________________________________________________
+TEST(DeltaTriples, indexScanAndJoin) {
+  auto [qec, deltaTriples] = getQecAndDeltaTriples();
+  qec->getQueryTreeCache().clearAll();
+  deltaTriples->applyUpdate(
+      "INSERT DATA { <newWord> <p> <b> . <c> <q> <newWord> }");
+  auto newId = deltaTriples->getLocalVocabId(TripleComponent{"<newWord>"});
+  ASSERT_TRUE(newId.has_value());
+  auto id = ad_utility::testing::makeGetId(qec->getIndex());
+
+  auto scanNew = ad_utility::makeExecutionTree<IndexScan>(
+      qec, Permutation::SPO, SparqlTriple{TripleComponent{"<newWord>"}, "<p>",
+                                          Var{"?x"}});
+  auto& scanOperation =
+      dynamic_cast<IndexScan&>(*scanNew->getRootOperation());
+  EXPECT_TRUE(scanOperation.hasDeltaTriples());
+  EXPECT_EQ(scanOperation.getExactSize(), 1u);
+  EXPECT_FALSE(scanOperation.knownEmptyResult());
+
+  // A join of two scans of which both contain the new word share the local
+  // vocab of the `DeltaTriples`.
+  auto scanP = ad_utility::makeExecutionTree<IndexScan>(
+      qec, Permutation::PSO, SparqlTriple{Var{"?x"}, "<p>", Var{"?y"}});
+  auto scanQ = ad_utility::makeExecutionTree<IndexScan>(
+      qec, Permutation::OPS, SparqlTriple{Var{"?z"}, "<q>", Var{"?x"}});
+  Join join{qec, scanP, scanQ, 0, 0};
+  auto result = join.getResult(false, ComputationMode::FULLY_MATERIALIZED);
+  auto columns = join.getExternallyVisibleVariableColumns();
+  ASSERT_EQ(result->size(), 1u);
+  const auto& row = result->idTable()[0];
+  EXPECT_EQ(row[columns.at(Var{"?x"}).columnIndex_], newId.value());
+  EXPECT_EQ(row[columns.at(Var{"?y"}).columnIndex_], id("<b>"));
+  EXPECT_EQ(row[columns.at(Var{"?z"}).columnIndex_], id("<c>"));
+  EXPECT_EQ(result->localVocab().getWord(newId->getLocalVocabIndex()),
+            "<newWord>");
+
+  deltaTriples->clear();
+  qec->getQueryTreeCache().clearAll();
+}
@@ -0,0 +1,56 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "util/DiskSpaceMonitor.h"
+
+namespace {
+namespace fs = std::filesystem;
+
+// Write a file with the `filename` and `numBytes` bytes.
+void writeFile(const fs::path& filename, size_t numBytes) {
+  std::ofstream file{filename};
+  file << std::string(numBytes, 'a');
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(DiskSpaceMonitor, PeakOfMonitoredFiles) {
+  fs::path directory = "DiskSpaceMonitorTestDirectory";
+  fs::create_directories(directory);
+  writeFile(directory / "unrelated", 1000);
+  {
+    ad_utility::DiskSpaceMonitor monitor{
+        directory,
+        [](std::string_view filename) { return filename.starts_with("tmp"); },
+        std::chrono::milliseconds{1}};
+    EXPECT_EQ(monitor.currentSize(), 0u);
+    writeFile(directory / "tmp1", 100);
+    writeFile(directory / "tmp2", 50);
+    EXPECT_EQ(monitor.currentSize(), 150u);
+    // The monitor samples every millisecond, so it sees both files.
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    fs::remove(directory / "tmp1");
+    fs::remove(directory / "tmp2");
+    writeFile(directory / "tmp3", 20);
+    EXPECT_EQ(monitor.stop(), 150u);
+    // Stopping twice is allowed.
+    EXPECT_EQ(monitor.stop(), 150u);
+  }
+  fs::remove_all(directory);
+}
+
+// _____________________________________________________________________________
+TEST(DiskSpaceMonitor, MissingDirectory) {
+  ad_utility::DiskSpaceMonitor monitor{"DiskSpaceMonitorMissingDirectory",
+                                       [](std::string_view) { return true; }};
+  EXPECT_EQ(monitor.currentSize(), 0u);
+  EXPECT_EQ(monitor.stop(), 0u);
+}
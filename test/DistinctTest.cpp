@@ -0,0 +1,93 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./IndexTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "engine/Distinct.h"
+#include "engine/Sort.h"
+#include "engine/ValuesForTesting.h"
+#include "global/Constants.h"
+#include "util/HashSet.h"
+
+using namespace ad_utility::testing;
+
+namespace {
+// A `Distinct` with the `strategy` on the `input` (which is not sorted).
+Distinct makeDistinct(const IdTable& input, std::vector<ColumnIndex> keep,
+                      Distinct::Strategy strategy) {
+  std::vector<std::optional<Variable>> vars;
+  for (ColumnIndex i = 0; i < input.numColumns(); ++i) {
+    vars.emplace_back(Variable{absl::StrCat("?", i)});
+  }
+  auto subtree = ad_utility::makeExecutionTree<ValuesForTesting>(
+      getQec(), input.clone(), vars);
+  if (strategy == Distinct::Strategy::Sorted) {
+    subtree = ad_utility::makeExecutionTree<Sort>(getQec(), subtree, keep);
+  }
+  return Distinct{getQec(), subtree, keep, strategy};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(Distinct, hashStrategyKeepsTheFirstOccurrences) {
+  auto input = makeIdTableFromVector({{1, 5}, {2, 6}, {1, 7}, {3, 5}, {2, 6}});
+  using enum Distinct::Strategy;
+  auto distinct = makeDistinct(input, {0}, Hash);
+  EXPECT_EQ(distinct.getResult()->idTable(),
+            makeIdTableFromVector({{1, 5}, {2, 6}, {3, 5}}));
+  EXPECT_EQ(distinct.getDescriptor(), "Distinct (hash)");
+
+  auto distinct2 = makeDistinct(input, {0, 1}, Hash);
+  EXPECT_EQ(distinct2.getResult()->idTable(),
+            makeIdTableFromVector({{1, 5}, {2, 6}, {1, 7}, {3, 5}}));
+  EXPECT_NE(distinct.getCacheKey(), distinct2.getCacheKey());
+
+  auto sorted = makeDistinct(input, {0}, Sorted);
+  EXPECT_EQ(sorted.getResult()->idTable(),
+            makeIdTableFromVector({{1, 5}, {2, 6}, {3, 5}}));
+  EXPECT_NE(distinct.getCacheKey(), sorted.getCacheKey());
+
+  auto empty = makeDistinct(IdTable{2, makeAllocator()}, {0}, Hash);
+  EXPECT_EQ(empty.getResult()->idTable().numRows(), 0u);
+}
+
+// _____________________________________________________________________________
+TEST(Distinct, hashStrategyWithSeveralThreads) {
+  auto& parameters = RuntimeParameters();
+  auto numThreads = parameters.get<"hash-distinct-num-threads">();
+  parameters.set<"hash-distinct-num-threads">(4);
+  // The input is large enough to be split between all four threads.
+  VectorTable rows;
+  VectorTable expected;
+  ad_utility::HashSet<std::pair<int64_t, int64_t>> seen;
+  for (int64_t i = 0; i < 1'100'000; ++i) {
+    int64_t a = (i * 7) % 1'000;
+    int64_t b = i % 3;
+    rows.push_back({a, b});
+    if (seen.emplace(a, b).second) {
+      expected.push_back({a, b});
+    }
+  }
+  auto input = makeIdTableFromVector(rows);
+  ASSERT_EQ(expected.size(), 3'000u);
+  auto distinct = makeDistinct(input, {0, 1}, Distinct::Strategy::Hash);
+  EXPECT_EQ(distinct.getResult()->idTable(), makeIdTableFromVector(expected));
+  parameters.set<"hash-distinct-num-threads">(numThreads);
+}
+
+// _____________________________________________________________________________
+TEST(Distinct, costEstimate) {
+  // The `ValuesForTesting` have a multiplicity of 42 in the first column, s.t.
+  // the estimated number of distinct rows is much smaller than the input and
+  // hashing is cheaper than sorting.
+  VectorTable rows;
+  for (int64_t i = 0; i < 1'000; ++i) {
+    rows.push_back({i, i});
+  }
+  auto input = makeIdTableFromVector(rows);
+  auto hash = makeDistinct(input, {0}, Distinct::Strategy::Hash);
+  auto sorted = makeDistinct(input, {0}, Distinct::Strategy::Sorted);
+  EXPECT_LT(hash.getCostEstimate(), sorted.getCostEstimate());
+}
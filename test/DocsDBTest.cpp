@@ -0,0 +1,128 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "index/DocsDB.h"
+
+namespace {
+auto TRID = [](uint64_t id) { return TextRecordIndex::make(id); };
+
+// Build a compressed DocsDB from the `records` (pairs of ID and text) and
+// open it.
+DocsDB buildDocsDB(
+    const std::string& fileName,
+    const std::vector<std::pair<uint64_t, std::string>>& records) {
+  DocsDB::Builder builder{fileName};
+  for (const auto& [id, text] : records) {
+    builder.addTextRecord(id, text);
+  }
+  std::move(builder).finish();
+  DocsDB docsDB;
+  docsDB.init(fileName);
+  return docsDB;
+}
+
+// Remove the files of the DocsDB with the `fileName`.
+void removeDocsDB(const std::string& fileName) {
+  ad_utility::deleteFile(fileName);
+  ad_utility::deleteFile(fileName + std::string(DocsDB::RECORD_OFFSETS_SUFFIX),
+                         false);
+  ad_utility::deleteFile(fileName + std::string(DocsDB::BLOCKS_SUFFIX), false);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(DocsDB, smallCompressed) {
+  std::string fileName = "docsDBTest.smallCompressed.docsDB";
+  {
+    auto docsDB = buildDocsDB(fileName, {{0, "first"}, {1, ""}, {3, "third"}});
+    ASSERT_EQ(docsDB._size, 4u);
+    EXPECT_EQ(docsDB.getTextExcerpt(TRID(0)), "first");
+    // Empty records yield the next non-empty record.
+    EXPECT_EQ(docsDB.getTextExcerpt(TRID(1)), "third");
+    EXPECT_EQ(docsDB.getTextExcerpt(TRID(2)), "third");
+    EXPECT_EQ(docsDB.getTextExcerpt(TRID(3)), "third");
+    std::vector<TextRecordIndex> cids{TRID(3), TRID(17), TRID(0), TRID(3)};
+    EXPECT_THAT(docsDB.getTextExcerpts(cids),
+                ::testing::ElementsAre("third", "", "first", "third"));
+  }
+  removeDocsDB(fileName);
+
+  {
+    auto docsDB = buildDocsDB(fileName, {});
+    ASSERT_EQ(docsDB._size, 0u);
+    EXPECT_ANY_THROW(docsDB.getTextExcerpt(TRID(0)));
+    std::vector<TextRecordIndex> cids{TRID(0)};
+    EXPECT_THAT(docsDB.getTextExcerpts(cids), ::testing::ElementsAre(""));
+  }
+  removeDocsDB(fileName);
+}
+
+// _____________________________________________________________________________
+TEST(DocsDB, manyBlocksWithDictionary) {
+  std::string fileName = "docsDBTest.manyBlocks.docsDB";
+  // Enough (similar) sentences for many blocks and the training of the
+  // dictionary.
+  std::vector<std::pair<uint64_t, std::string>> records;
+  std::mt19937_64 generator{42};
+  std::vector<std::string> words{"the",  "quick", "brown", "fox", "jumps",
+                                 "over", "lazy",  "dog",   "and", "cat"};
+  size_t numBytes = 0;
+  for (uint64_t id = 0; numBytes < 2'000'000; id += 1 + generator() % 2) {
+    std::string sentence = "Sentence " + std::to_string(id) + ":";
+    for (size_t i = 0; i < 5 + generator() % 20; ++i) {
+      sentence += " " + words[generator() % words.size()];
+    }
+    numBytes += sentence.size();
+    records.emplace_back(id, std::move(sentence));
+  }
+  {
+    auto docsDB = buildDocsDB(fileName, records);
+    ASSERT_EQ(docsDB._size, records.back().first + 1);
+    // The text is compressed.
+    ad_utility::File file{fileName, "r"};
+    EXPECT_LT(file.sizeOfFile(), numBytes / 2);
+
+    std::vector<TextRecordIndex> cids;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < records.size(); i += 1 + generator() % 100) {
+      cids.push_back(TRID(records[i].first));
+      expected.push_back(records[i].second);
+      EXPECT_EQ(docsDB.getTextExcerpt(cids.back()), expected.back());
+    }
+    std::ranges::reverse(cids);
+    std::ranges::reverse(expected);
+    EXPECT_EQ(docsDB.getTextExcerpts(cids), expected);
+  }
+  removeDocsDB(fileName);
+}
+
+// _____________________________________________________________________________
+TEST(DocsDB, uncompressedFormat) {
+  // A DocsDB in the format without compression: the concatenated records
+  // followed by their offsets.
+  std::string fileName = "docsDBTest.uncompressed.docsDB";
+  {
+    ad_utility::File file{fileName, "w"};
+    std::string text = "firstthird";
+    file.write(text.data(), text.size());
+    for (off_t offset : {0, 5, 5, 5, 10}) {
+      file.write(&offset, sizeof(offset));
+    }
+  }
+  {
+    DocsDB docsDB;
+    docsDB.init(fileName);
+    ASSERT_EQ(docsDB._size, 4u);
+    EXPECT_EQ(docsDB.getTextExcerpt(TRID(0)), "first");
+    EXPECT_EQ(docsDB.getTextExcerpt(TRID(1)), "third");
+    std::vector<TextRecordIndex> cids{TRID(3), TRID(4), TRID(0)};
+    EXPECT_THAT(docsDB.getTextExcerpts(cids),
+                ::testing::ElementsAre("third", "", "first"));
+  }
+  ad_utility::deleteFile(fileName);
+}
@@ -0,0 +1,48 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "index/EncodedIriManager.h"
+
+namespace {
+const std::string wd = "<http://www.wikidata.org/entity/Q";
+const std::string wdt = "<http://www.wikidata.org/prop/direct/P";
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(EncodedIriManager, encodeAndDecode) {
+  EncodedIriManager manager{{wd, wdt}};
+  for (const auto& iri : {wd + "42>", wd + "0>", wdt + "31>", wd + "1234567>"}) {
+    auto id = manager.encode(iri);
+    ASSERT_TRUE(id.has_value()) << iri;
+    EXPECT_EQ(id.value().getDatatype(), Datatype::EncodedIri);
+    EXPECT_EQ(manager.toString(id.value()), iri);
+  }
+  EXPECT_EQ(manager.encode(wd + "42>").value().getEncodedIri(),
+            (Id::EncodedIri{0, 42}));
+  EXPECT_EQ(manager.encode(wdt + "42>").value().getEncodedIri(),
+            (Id::EncodedIri{1, 42}));
+
+  // IRIs that cannot be encoded.
+  for (const auto& iri :
+       {wd + ">", wd + "042>", wd + "42a>", wd + "-42>", wd + "42",
+        wd + "99999999999999999999>", std::string{"<http://example.org/42>"},
+        std::string{"\"42\""}}) {
+    EXPECT_FALSE(manager.encode(iri).has_value()) << iri;
+  }
+
+  // Without prefixes, nothing is encoded.
+  EXPECT_FALSE(EncodedIriManager{}.encode(wd + "42>").has_value());
+}
+
+// _____________________________________________________________________________
+TEST(EncodedIriManager, invalidPrefixes) {
+  using V = std::vector<std::string>;
+  EXPECT_ANY_THROW(EncodedIriManager{V{"http://example.org/"}});
+  EXPECT_ANY_THROW(EncodedIriManager{V{"<http://example.org/1"}});
+  EXPECT_ANY_THROW(EncodedIriManager{V{"<http://example.org/>"}});
+  EXPECT_ANY_THROW(EncodedIriManager{V(Id::maxNumEncodedIriPrefixes + 1, wd)});
+  EXPECT_NO_THROW(EncodedIriManager{V(Id::maxNumEncodedIriPrefixes, wd)});
+}
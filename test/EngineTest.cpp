@@ -19,6 +19,7 @@
 #include "./util/IdTestHelpers.h"
 #include "engine/CallFixedSize.h"
 #include "engine/Engine.h"
+#include "engine/IndexScan.h"
 #include "engine/Join.h"
 #include "engine/OptionalJoin.h"
 #include "engine/QueryExecutionTree.h"
@@ -43,7 +44,7 @@ TEST(EngineTest, distinctTest) {
   IdTable result{4, makeAllocator()};
 
   std::vector<ColumnIndex> keepIndices{{1, 2}};
-  CALL_FIXED_SIZE(4, Engine::distinct, input, keepIndices, &result);
+  Engine::distinct(input, keepIndices, &result);
 
   // For easier checking.
   IdTable expectedResult{
@@ -51,13 +52,31 @@ TEST(EngineTest, distinctTest) {
   ASSERT_EQ(expectedResult, result);
 }
 
+TEST(EngineTest, distinctOfWideTable) {
+  // A table with more columns than the statically sized `IdTable`s.
+  const size_t width = DEFAULT_MAX_NUM_COLUMNS_STATIC_ID_TABLE + 3;
+  IdTable input{width, makeAllocator()};
+  IdTable expectedResult{width, makeAllocator()};
+  for (size_t i = 0; i < 10; ++i) {
+    input.emplace_back();
+    for (size_t col = 0; col < width; ++col) {
+      input.back()[col] = V(col == width - 1 ? i / 3 : i);
+    }
+    if (i % 3 == 0) {
+      expectedResult.push_back(input.back());
+    }
+  }
+  IdTable result{width, makeAllocator()};
+  Engine::distinct(input, {width - 1}, &result);
+  ASSERT_EQ(expectedResult, result);
+}
+
 TEST(EngineTest, distinctWithEmptyInput) {
   IdTable input{1, makeAllocator()};
   // Deliberately input a non-empty result to check that it is
   // overwritten by the (empty) input.
   IdTable result = makeIdTableFromVector({{3}});
-  CALL_FIXED_SIZE(1, Engine::distinct, input, std::vector<ColumnIndex>{},
-                  &result);
+  Engine::distinct(input, std::vector<ColumnIndex>{}, &result);
   ASSERT_EQ(input, result);
 }
 
@@ -97,6 +116,20 @@ void testOptionalJoin(const IdTable& inputA, const IdTable& inputB,
 
     auto result = opt.computeResultOnlyForTesting();
     ASSERT_EQ(result.idTable(), expectedResult);
+
+    // Without UNDEF values in the join columns, the hash join also can be used
+    // and yields the same rows, but in a different order.
+    if (!OptionalJoin::isHashStrategyApplicable(*left, *right)) {
+      return;
+    }
+    IdTable hashResult{expectedResult.numColumns(), makeAllocator()};
+    OptionalJoin::hashOptionalJoin(inputA, inputB, jcls, &hashResult);
+    compareIdTableWithExpectedContent(hashResult, expectedResult);
+    OptionalJoin hash{qec, left, right, OptionalJoin::Strategy::Hash};
+    EXPECT_NE(hash.getCacheKey(), opt.getCacheKey());
+    EXPECT_TRUE(hash.getResultSortedOn().empty());
+    compareIdTableWithExpectedContent(
+        hash.computeResultOnlyForTesting().idTable(), expectedResult);
   }
 }
 
@@ -372,3 +405,36 @@ TEST(OptionalJoin, gallopingJoin) {
     testOptionalJoin(a, b, jcls, expectedResult);
   }
 }
+
+// _____________________________________________________________________________
+TEST(OptionalJoin, hashStrategyOnlyReadsTheMatchingBlocksOfAnIndexScan) {
+  std::string turtle;
+  for (size_t i = 0; i < 50; ++i) {
+    absl::StrAppend(&turtle, "<s", i, "> <p> <o", i, "> . ");
+  }
+  auto* qec = getQec(turtle);
+  auto id = makeGetId(qec->getIndex());
+  // The left input is not sorted.
+  IdTable leftTable{1, makeAllocator()};
+  for (std::string_view iri : {"<s7>", "<o4>", "<s3>"}) {
+    leftTable.push_back({id(std::string{iri})});
+  }
+  auto left = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, std::move(leftTable),
+      std::vector<std::optional<Variable>>{Variable{"?s"}});
+  auto scan = ad_utility::makeExecutionTree<IndexScan>(
+      qec, Permutation::PSO,
+      SparqlTriple{Variable{"?s"}, "<p>", Variable{"?o"}});
+  qec->clearCacheUnpinnedOnly();
+
+  OptionalJoin optionalJoin{qec, left, scan, OptionalJoin::Strategy::Hash};
+  EXPECT_EQ(optionalJoin.getDescriptor(), "OptionalJoin (hash) on ?s ");
+  compareIdTableWithExpectedContent(
+      optionalJoin.computeResultOnlyForTesting().idTable(),
+      makeIdTableFromVector({{id("<s7>"), id("<o7>")},
+                             {id("<o4>"), U},
+                             {id("<s3>"), id("<o3>")}}));
+  auto& details = scan->getRootOperation()->runtimeInfo().details_;
+  EXPECT_LT(details["num-blocks-read"].get<size_t>(),
+            details["num-blocks-all"].get<size_t>());
+}
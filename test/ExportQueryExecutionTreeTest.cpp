@@ -6,11 +6,13 @@
 
 #include "./IndexTestHelpers.h"
 #include "./util/GTestHelpers.h"
+#include "./util/IdTableHelpers.h"
 #include "./util/IdTestHelpers.h"
 #include "engine/ExportQueryExecutionTrees.h"
 #include "engine/IndexScan.h"
 #include "engine/QueryPlanner.h"
 #include "parser/SparqlParser.h"
+#include "util/ArrowIpc.h"
 
 using namespace std::string_literals;
 
@@ -99,6 +101,10 @@ void runSelectQueryTestCase(
 
   auto sparqlJSONResult = runJSONQuery(testCase.kg, testCase.query, sparqlJson);
   EXPECT_EQ(sparqlJSONResult, testCase.resultSparqlJSON);
+  // The streamed SPARQL JSON is the same.
+  auto streamedSparqlJSON = nlohmann::json::parse(
+      runQueryStreamableResult(testCase.kg, testCase.query, sparqlJson));
+  EXPECT_EQ(streamedSparqlJSON, testCase.resultSparqlJSON);
 
   // TODO<joka921> Use this for proper testing etc.
   auto xmlAsString =
@@ -751,6 +757,94 @@ TEST(ExportQueryExecutionTree, BinaryExport) {
   ASSERT_EQ(ad_utility::testing::IntId(31), id3);
 }
 
+// ____________________________________________________________________________
+TEST(ExportQueryExecutionTree, ArrowExport) {
+  namespace arrow = ad_utility::arrow;
+  std::string kg = "<s> <p> 31 . <s> <o> 42";
+  std::string query =
+      "SELECT ?p ?o ?unbound WHERE {<s> ?p ?o } ORDER BY ?p ?o";
+  std::string result =
+      runQueryStreamableResult(kg, query, ad_utility::MediaType::arrow);
+
+  // The integers are a typed column, the IRIs are dictionary-encoded, and the
+  // column of the unbound variable consists of nulls.
+  using enum arrow::Type;
+  std::vector<arrow::Field> fields{
+      {"p", DictionaryString}, {"o", Int64}, {"unbound", DictionaryString}};
+  std::vector<arrow::Column> columns{arrow::Column{DictionaryString},
+                                     arrow::Column{Int64},
+                                     arrow::Column{DictionaryString}};
+  columns[0].appendIndex(0);
+  columns[0].appendIndex(1);
+  columns[1].appendInt(42);
+  columns[1].appendInt(31);
+  columns[2].appendNull();
+  columns[2].appendNull();
+  std::vector<std::string> words{"o", "p"};
+  std::string expected = absl::StrCat(
+      arrow::schemaMessage(fields), arrow::dictionaryBatchMessage(0, words),
+      arrow::dictionaryBatchMessage(2, {}), arrow::recordBatchMessage(columns),
+      arrow::endOfStream());
+  EXPECT_EQ(result, expected);
+
+  // Dates are exported as timestamps (in UTC) and booleans are bit-packed.
+  kg = "<s> <d> \"1970-01-02T01:00:00+01:00\"^^"
+       "<http://www.w3.org/2001/XMLSchema#dateTime> . "
+       "<s> <b> true .";
+  query = "SELECT ?d ?b WHERE {<s> <d> ?d . <s> <b> ?b}";
+  result = runQueryStreamableResult(kg, query, ad_utility::MediaType::arrow);
+  fields = {{"d", Timestamp}, {"b", Bool}};
+  columns = {arrow::Column{Timestamp}, arrow::Column{Bool}};
+  columns[0].appendInt(24 * 60 * 60 * 1000);
+  columns[1].appendBool(true);
+  expected = absl::StrCat(arrow::schemaMessage(fields),
+                          arrow::recordBatchMessage(columns),
+                          arrow::endOfStream());
+  EXPECT_EQ(result, expected);
+}
+
+// ____________________________________________________________________________
+TEST(ExportQueryExecutionTree, getVocabWordsOfBatch) {
+  std::string kg = "<s> <p> <o> . <s> <q> \"lit\"";
+  auto qec = ad_utility::testing::getQec(kg);
+  auto getId = ad_utility::testing::makeGetId(qec->getIndex());
+  auto s = getId("<s>");
+  auto p = getId("<p>");
+  auto o = getId("<o>");
+  auto lit = getId("\"lit\"");
+  auto I = ad_utility::testing::IntId;
+  auto table = makeIdTableFromVector(
+      {{s, p, I(1)}, {s, o, I(2)}, {lit, p, I(3)}, {o, lit, I(4)}});
+  using Column = QueryExecutionTree::VariableAndColumnIndex;
+  QueryExecutionTree::ColumnIndicesAndTypes columns{
+      Column{"?x", 0}, std::nullopt, Column{"?z", 2}};
+  using Words = ExportQueryExecutionTrees::VocabWords;
+  auto rows = [](uint64_t begin, uint64_t end) {
+    return std::views::iota(begin, end);
+  };
+
+  // Only the selected columns and rows are resolved, `Id`s that are not of
+  // datatype `VocabIndex` are ignored.
+  EXPECT_EQ(ExportQueryExecutionTrees::getVocabWordsOfBatch(
+                qec->getIndex(), table, columns, rows(0, 2)),
+            (Words{{s, "<s>"}}));
+  EXPECT_EQ(ExportQueryExecutionTrees::getVocabWordsOfBatch(
+                qec->getIndex(), table, columns, rows(1, 4)),
+            (Words{{s, "<s>"}, {lit, "\"lit\""}, {o, "<o>"}}));
+  EXPECT_TRUE(ExportQueryExecutionTrees::getVocabWordsOfBatch(
+                  qec->getIndex(), table, columns, rows(2, 2))
+                  .empty());
+
+  // The words of the batch are used instead of the vocabulary.
+  Words words{{o, "<other>"}};
+  auto result = ExportQueryExecutionTrees::idToStringAndType(
+      qec->getIndex(), o, LocalVocab{}, std::identity{}, &words);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result.value().first, "<other>");
+  EXPECT_ANY_THROW(ExportQueryExecutionTrees::idToStringAndType(
+      qec->getIndex(), s, LocalVocab{}, std::identity{}, &words));
+}
+
 // ____________________________________________________________________________
 TEST(ExportQueryExecutionTree, CornerCases) {
   std::string kg = "<s> <p> <o>";
@@ -773,6 +867,9 @@ TEST(ExportQueryExecutionTree, CornerCases) {
   ASSERT_THROW(
       runJSONQuery(kg, constructQuery, ad_utility::MediaType::sparqlJson),
       ad_utility::Exception);
+  ASSERT_THROW(runQueryStreamableResult(kg, constructQuery,
+                                        ad_utility::MediaType::sparqlJson),
+               ad_utility::Exception);
   // XML is currently not supported for construct queries.
   AD_EXPECT_THROW_WITH_MESSAGE(
       runQueryStreamableResult(kg, constructQuery,
@@ -784,6 +881,10 @@ TEST(ExportQueryExecutionTree, CornerCases) {
   ASSERT_THROW(runQueryStreamableResult(kg, constructQuery,
                                         ad_utility::MediaType::octetStream),
                ad_utility::Exception);
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      runQueryStreamableResult(kg, constructQuery,
+                               ad_utility::MediaType::arrow),
+      ::testing::ContainsRegex("Arrow export is currently not supported"));
 
   // A SparqlJSON query where none of the variables is even visible in the
   // query body is not supported.
@@ -791,6 +892,11 @@ TEST(ExportQueryExecutionTree, CornerCases) {
   auto resultNoColumns = runJSONQuery(kg, queryNoVariablesVisible,
                                       ad_utility::MediaType::sparqlJson);
   ASSERT_TRUE(resultNoColumns["result"]["bindings"].empty());
+  auto streamedNoColumns = nlohmann::json::parse(runQueryStreamableResult(
+      kg, queryNoVariablesVisible, ad_utility::MediaType::sparqlJson));
+  ASSERT_EQ(streamedNoColumns["head"]["vars"],
+            (std::vector<std::string>{"not", "known"}));
+  ASSERT_TRUE(streamedNoColumns["results"]["bindings"].empty());
 
   auto qec = ad_utility::testing::getQec(kg);
   AD_EXPECT_THROW_WITH_MESSAGE(
@@ -803,6 +909,92 @@ TEST(ExportQueryExecutionTree, CornerCases) {
       ::testing::ContainsRegex("should be unreachable"));
 }
 
+// _____________________________________________________________________________
+TEST(ExportQueryExecutionTree, morselParallelFilterAndBind) {
+  std::string kg;
+  for (size_t i = 0; i < 100; ++i) {
+    absl::StrAppend(&kg, "<s", i, "> <p> ", i % 17, " . ");
+  }
+  // The BIND creates new words that are too long to be inlined into their
+  // `Id` and are thus added to the local vocabulary of each morsel.
+  std::string query =
+      "SELECT ?s ?o ?c WHERE { ?s <p> ?o FILTER(?o > 3) "
+      "BIND(CONCAT(STR(?o), \"-a-suffix-that-is-too-long\") AS ?c) } "
+      "ORDER BY ?s";
+  auto getResult = [&kg, &query](size_t numThreads, size_t morselSize) {
+    RuntimeParameters().set<"expression-num-threads">(numThreads);
+    RuntimeParameters().set<"expression-morsel-size">(morselSize);
+    return runQueryStreamableResult(kg, query, ad_utility::MediaType::tsv);
+  };
+  auto threadsBefore = RuntimeParameters().get<"expression-num-threads">();
+  auto morselSizeBefore = RuntimeParameters().get<"expression-morsel-size">();
+  auto expected = getResult(1, 1'000'000);
+  EXPECT_THAT(expected, ::testing::HasSubstr("\"16-a-suffix-that-is-too-long"));
+  for (size_t morselSize : {1, 7, 50}) {
+    EXPECT_EQ(getResult(3, morselSize), expected) << morselSize;
+  }
+  RuntimeParameters().set<"expression-num-threads">(threadsBefore);
+  RuntimeParameters().set<"expression-morsel-size">(morselSizeBefore);
+}
+
+// _____________________________________________________________________________
+TEST(ExportQueryExecutionTree, lazyFilterOfMaterializedInput) {
+  // The input of the FILTER (the VALUES clause) is fully materialized, but the
+  // export requests a lazy result, so the FILTER yields one block per chunk of
+  // `numThreads * morselSize` input rows.
+  std::string values;
+  for (size_t i = 0; i < 100; ++i) {
+    absl::StrAppend(&values, " ", i % 17);
+  }
+  std::string query =
+      absl::StrCat("SELECT ?x WHERE { VALUES ?x {", values, " } ",
+                   "FILTER(?x > 3) }");
+  auto getResult = [&query](size_t numThreads, size_t morselSize) {
+    RuntimeParameters().set<"expression-num-threads">(numThreads);
+    RuntimeParameters().set<"expression-morsel-size">(morselSize);
+    return runQueryStreamableResult("<a> <b> <c> .", query,
+                                    ad_utility::MediaType::tsv);
+  };
+  auto threadsBefore = RuntimeParameters().get<"expression-num-threads">();
+  auto morselSizeBefore = RuntimeParameters().get<"expression-morsel-size">();
+  auto expected = getResult(1, 1'000'000);
+  EXPECT_THAT(expected, ::testing::StartsWith("?x\n4\n5\n"));
+  for (size_t morselSize : {1, 7, 50}) {
+    EXPECT_EQ(getResult(3, morselSize), expected) << morselSize;
+    EXPECT_EQ(getResult(1, morselSize), expected) << morselSize;
+  }
+  RuntimeParameters().set<"expression-num-threads">(threadsBefore);
+  RuntimeParameters().set<"expression-morsel-size">(morselSizeBefore);
+}
+
+// ____________________________________________________________________________
+TEST(ExportQueryExecutionTree, ConstructWithConstantsAndDeduplication) {
+  std::string kg = "<s> <p> <o> . <s> <p> <o2> . <s2> <p> <o>";
+  std::string query =
+      "CONSTRUCT {?s <type> <Thing> . ?s ?p ?o . ?s <label> \"x\"} "
+      "WHERE {?s ?p ?o} ORDER BY ?s ?o";
+  using enum ad_utility::MediaType;
+  EXPECT_EQ(runQueryStreamableResult(kg, query, turtle),
+            "<s> <type> <Thing> .\n<s> <p> <o> .\n<s> <label> \"x\" .\n"
+            "<s> <type> <Thing> .\n<s> <p> <o2> .\n<s> <label> \"x\" .\n"
+            "<s2> <type> <Thing> .\n<s2> <p> <o> .\n<s2> <label> \"x\" .\n");
+
+  auto deduplicateBefore =
+      RuntimeParameters().get<"construct-export-deduplicate">();
+  RuntimeParameters().set<"construct-export-deduplicate">(true);
+  EXPECT_EQ(runQueryStreamableResult(kg, query, turtle),
+            "<s> <type> <Thing> .\n<s> <p> <o> .\n<s> <label> \"x\" .\n"
+            "<s> <p> <o2> .\n"
+            "<s2> <type> <Thing> .\n<s2> <p> <o> .\n<s2> <label> \"x\" .\n");
+  EXPECT_EQ(runQueryStreamableResult(kg, query, tsv),
+            "<s>\t<type>\t<Thing>\n<s>\t<p>\t<o>\n<s>\t<label>\t\"x\"\n"
+            "<s>\t<p>\t<o2>\n"
+            "<s2>\t<type>\t<Thing>\n<s2>\t<p>\t<o>\n<s2>\t<label>\t\"x\"\n");
+  auto qleverJSON = runJSONQuery(kg, query, qleverJson);
+  EXPECT_EQ(qleverJSON["res"].size(), 7u);
+  RuntimeParameters().set<"construct-export-deduplicate">(deduplicateBefore);
+}
+
 // TODO<joka921> Unit tests for the more complex CONSTRUCT export (combination
 // between constants and stuff from the knowledge graph).
 
@@ -937,3 +937,45 @@ TEST(FTSAlgorithmsTest, multVarsFilterAggScoresAndTakeTopKContexts) {
   EXPECT_THAT(resW6.getColumn(4), ::testing::ElementsAre(W(2u)));
   EXPECT_THAT(resW6.getColumn(5), ::testing::ElementsAre(W(13u)));
 }
+
+// _____________________________________________________________________________
+TEST(FTSAlgorithmsTest, multVarsAggregationIsIndependentOfNumThreads) {
+  // Enough postings s.t. the aggregation is split into several parts, with
+  // contexts of different sizes that don't align with the part boundaries.
+  Index::WordEntityPostings wep;
+  wep.wids_.resize(1);
+  for (size_t cid = 0; wep.cids_.size() < 40'000; ++cid) {
+    for (size_t i = 0; i < 1 + cid % 4; ++i) {
+      wep.cids_.push_back(TRID(cid));
+      wep.eids_.push_back(V(cid % 13 + i));
+      wep.scores_.push_back(static_cast<Score>(cid % 5));
+      wep.wids_[0].push_back(static_cast<WordIndex>(i % 2));
+    }
+  }
+  HashSet<Id> fSet{V(0), V(3), V(7)};
+
+  auto aggregate = [&wep, &fSet](size_t numThreads) {
+    RuntimeParameters().set<"text-aggregation-num-threads">(numThreads);
+    std::array<IdTable, 2> results{IdTable{5, makeAllocator()},
+                                   IdTable{5, makeAllocator()}};
+    FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts<5>(wep, 2, 3,
+                                                           &results[0]);
+    FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts<5>(
+        wep, fSet, 2, 3, &results[1]);
+    for (auto& result : results) {
+      std::ranges::sort(result, std::ranges::lexicographical_compare);
+    }
+    return results;
+  };
+  auto numThreadsBefore =
+      RuntimeParameters().get<"text-aggregation-num-threads">();
+  auto expected = aggregate(1);
+  EXPECT_FALSE(expected[0].empty());
+  EXPECT_FALSE(expected[1].empty());
+  for (size_t numThreads : {2, 3, 4}) {
+    auto results = aggregate(numThreads);
+    EXPECT_EQ(results[0], expected[0]);
+    EXPECT_EQ(results[1], expected[1]);
+  }
+  RuntimeParameters().set<"text-aggregation-num-threads">(numThreadsBefore);
+}
@@ -0,0 +1,131 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "./util/TripleComponentTestHelpers.h"
+#include "parser/FastValuesParser.h"
+#include "parser/SparqlParser.h"
+
+using ::testing::ElementsAre;
+using Rows = FastValuesParser::Rows;
+using UNDEF = TripleComponent::UNDEF;
+
+namespace {
+auto lit = ad_utility::testing::tripleComponentLiteral;
+
+// Return the placeholder with the given `index`.
+std::string placeholder(size_t index) {
+  return absl::StrCat(FastValuesParser::PLACEHOLDER_IRI_PREFIX, index, ">");
+}
+
+// Extract the data blocks of the `query` regardless of their size.
+auto extract(std::string_view query) {
+  return FastValuesParser::extractDataBlocks(query, 0);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(FastValuesParser, extractDataBlocks) {
+  auto result = extract(
+      "PREFIX ex: <http://example.org/> "
+      "SELECT * { VALUES (?x $y) { (<a> 42) (ex:b \"c\"@en) (UNDEF true) } "
+      "VALUES ?z { -1.5 'd'^^ex:t ql:x # <comment>\n } ?x <p> ?y }");
+  EXPECT_EQ(result.query_,
+            absl::StrCat("PREFIX ex: <http://example.org/> "
+                         "SELECT * { VALUES (?x $y) { (",
+                         placeholder(0), " UNDEF) } VALUES ?z { ",
+                         placeholder(1), " } ?x <p> ?y }"));
+  ASSERT_EQ(result.dataBlocks_.size(), 2);
+  EXPECT_THAT(result.dataBlocks_[0],
+              ElementsAre(ElementsAre("<a>", 42),
+                          ElementsAre("<http://example.org/b>",
+                                      lit("\"c\"", "@en")),
+                          ElementsAre(UNDEF{}, true)));
+  EXPECT_THAT(
+      result.dataBlocks_[1],
+      ElementsAre(
+          ElementsAre(-1.5),
+          ElementsAre(lit("\"d\"", "^^<http://example.org/t>")),
+          ElementsAre(absl::StrCat(
+              "<http://qlever.cs.uni-freiburg.de/builtin-functions/x>"))));
+}
+
+// _____________________________________________________________________________
+TEST(FastValuesParser, unsupportedDataBlocksAreKept) {
+  auto expectUnchanged = [](std::string_view query) {
+    auto result = extract(query);
+    EXPECT_TRUE(result.query_.empty()) << query;
+    EXPECT_TRUE(result.dataBlocks_.empty()) << query;
+  };
+  // An undefined prefix.
+  expectUnchanged("SELECT * { VALUES ?x { ex:a } }");
+  // The number of values does not match the number of variables.
+  expectUnchanged("SELECT * { VALUES (?x ?y) { (<a>) } }");
+  // Blank nodes are not allowed.
+  expectUnchanged("SELECT * { VALUES ?x { _:a } }");
+  // Numbers that are too large.
+  expectUnchanged("SELECT * { VALUES ?x { 123456789012345678901234567890 } }");
+  // `BASE` declarations are not supported.
+  expectUnchanged("BASE <http://a/> SELECT * { VALUES ?x { <a> } }");
+  // The keyword inside of literals, IRIs, comments, and variables.
+  expectUnchanged(
+      "SELECT * { ?values <VALUES> \"VALUES ?x { <a> }\" # VALUES ?x { <a> }\n"
+      "}");
+
+  // Small data blocks are left to the ANTLR parser by default.
+  auto result = FastValuesParser::extractDataBlocks(
+      "SELECT * { VALUES ?x { <a> <b> } }");
+  EXPECT_TRUE(result.dataBlocks_.empty());
+}
+
+// _____________________________________________________________________________
+TEST(FastValuesParser, parseQueryWithLargeValuesClause) {
+  std::string values;
+  std::string singleValues;
+  size_t numRows = 2000;
+  for (size_t i = 0; i < numRows; ++i) {
+    absl::StrAppend(&values, "(<x", i, "> ", i, ") ");
+    absl::StrAppend(&singleValues, "<x", i, "> ");
+  }
+  auto query = absl::StrCat(
+      "SELECT * { VALUES (?x ?y) { ", values,
+      "} OPTIONAL { VALUES ?z { <z> } } { SELECT ?x { VALUES ?x { ",
+      singleValues, "} } } }");
+  auto result = extract(query);
+  ASSERT_EQ(result.dataBlocks_.size(), 3);
+  EXPECT_EQ(result.dataBlocks_[2].size(), numRows);
+
+  auto parsedQuery = SparqlParser::parseQuery(query);
+  EXPECT_EQ(parsedQuery._originalString, query);
+  const auto& valuesClause = std::get<parsedQuery::Values>(
+      parsedQuery._rootGraphPattern._graphPatterns.at(0));
+  const auto& rows = valuesClause._inlineValues._values;
+  ASSERT_EQ(rows.size(), numRows);
+  EXPECT_THAT(rows.at(17), ElementsAre("<x17>", 17));
+  EXPECT_THAT(valuesClause._inlineValues._variables,
+              ElementsAre(Variable{"?x"}, Variable{"?y"}));
+  const auto& subquery = std::get<parsedQuery::Subquery>(
+      std::get<parsedQuery::GroupGraphPattern>(
+          parsedQuery._rootGraphPattern._graphPatterns.at(2))
+          ._child._graphPatterns.at(0));
+  const auto& innerValues = std::get<parsedQuery::Values>(
+      subquery.get()._rootGraphPattern._graphPatterns.at(0));
+  ASSERT_EQ(innerValues._inlineValues._values.size(), numRows);
+  EXPECT_THAT(innerValues._inlineValues._values.at(3), ElementsAre("<x3>"));
+
+  // VALUES clauses inside of a `SERVICE` are not parsed, so the
+  // `FastValuesParser` is not used. The result is still correct.
+  auto serviceQuery = absl::StrCat(
+      "SELECT * { SERVICE <http://endpoint> { VALUES (?x ?y) { ", values,
+      "} } }");
+  parsedQuery = SparqlParser::parseQuery(serviceQuery);
+  const auto& service = std::get<parsedQuery::Service>(
+      parsedQuery._rootGraphPattern._graphPatterns.at(0));
+  EXPECT_THAT(service.graphPatternAsString_, ::testing::HasSubstr("<x17> 17"));
+
+  // Errors in the rest of the query are still reported.
+  EXPECT_ANY_THROW(SparqlParser::parseQuery(
+      absl::StrCat("SELECT * { VALUES (?x ?y) { ", values, "} ?x }")));
+}
@@ -67,3 +67,23 @@ TEST(File, makeFilestream) {
   ASSERT_THROW(ad_utility::makeIfstream("nonExisting1620349.datxyz"),
                std::runtime_error);
 }
+
+// _____________________________________________________________________________
+TEST(File, adviseWillNeed) {
+  std::string filename = "adviseWillNeedTest.dat";
+  {
+    ad_utility::File file(filename, "w");
+    file.write("helloAgain", 10);
+  }
+  ad_utility::File file(filename, "r");
+  // The advice is only a hint, it must not change the contents that are read,
+  // also not for ranges that go beyond the end of the file.
+  file.adviseWillNeed(0, 10);
+  file.adviseWillNeed(5, 1000);
+  std::string s;
+  s.resize(5);
+  ASSERT_EQ(file.read(s.data(), 5, 5), 5);
+  ASSERT_EQ(s, "Again");
+  file.close();
+  ad_utility::deleteFile(filename);
+}
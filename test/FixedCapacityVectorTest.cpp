@@ -0,0 +1,38 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "util/FixedCapacityVector.h"
+
+using ad_utility::FixedCapacityVector;
+
+// _____________________________________________________________________________
+TEST(FixedCapacityVector, basicOperations) {
+  static_assert(std::is_trivially_copyable_v<FixedCapacityVector<int, 4>>);
+  FixedCapacityVector<int, 4> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.capacity(), 4);
+  v.push_back(3);
+  v.push_back(7);
+  EXPECT_EQ(v.size(), 2);
+  EXPECT_EQ(v.at(1), 7);
+  v[0] = 4;
+  EXPECT_THAT(v, ::testing::ElementsAre(4, 7));
+  EXPECT_ANY_THROW(v.at(2));
+
+  FixedCapacityVector<int, 4> w{4, 7, 9, 11};
+  EXPECT_NE(v, w);
+  EXPECT_ANY_THROW(w.push_back(12));
+  v.push_back(9);
+  v.push_back(11);
+  EXPECT_EQ(v, w);
+
+  // A copy of the bytes is a valid copy.
+  FixedCapacityVector<int, 4> copy;
+  std::memcpy(&copy, &w, sizeof(w));
+  EXPECT_EQ(copy, w);
+}
@@ -0,0 +1,46 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "index/GeoPoints.h"
+
+// _____________________________________________________________________________
+TEST(GeoPoints, parseWord) {
+  using Point = GeoPoints::Point;
+  auto parse = &GeoPoints::parseWord;
+  EXPECT_EQ(parse("\"POINT(7.85 47.99)\"^^"
+                  "<http://www.opengis.net/ont/geosparql#wktLiteral>"),
+            (Point{7.85, 47.99}));
+  EXPECT_EQ(parse("\"point(-3 0.5)\""), (Point{-3.0, 0.5}));
+
+  // No WKT points.
+  EXPECT_EQ(parse("\"POINT(7.85)\""), std::nullopt);
+  EXPECT_EQ(parse("\"LINESTRING(1 2, 3 4)\""), std::nullopt);
+  EXPECT_EQ(parse("\"42\""), std::nullopt);
+  EXPECT_EQ(parse("\""), std::nullopt);
+  EXPECT_EQ(parse("<http://example.org/POINT(1 2)>"), std::nullopt);
+}
+
+// _____________________________________________________________________________
+TEST(GeoPoints, addGetWriteAndRead) {
+  GeoPoints points;
+  EXPECT_TRUE(points.empty());
+  points.add(VocabIndex::make(3), {1.0, 2.0});
+  points.add(VocabIndex::make(10), {-7.5, 45.0});
+  EXPECT_ANY_THROW(points.add(VocabIndex::make(10), {0.0, 0.0}));
+  EXPECT_EQ(points.size(), 2u);
+  EXPECT_EQ(points.get(VocabIndex::make(3)), (GeoPoints::Point{1.0, 2.0}));
+  EXPECT_EQ(points.get(VocabIndex::make(4)), std::nullopt);
+
+  std::string filename = "geoPointsTest.dat";
+  points.writeToFile(filename);
+  auto read = GeoPoints::readFromFile(filename);
+  std::remove(filename.c_str());
+  EXPECT_EQ(read.size(), 2u);
+  EXPECT_EQ(read.get(VocabIndex::make(10)), (GeoPoints::Point{-7.5, 45.0}));
+  EXPECT_EQ(read.get(VocabIndex::make(0)), std::nullopt);
+  EXPECT_EQ(read.get(VocabIndex::make(11)), std::nullopt);
+}
@@ -15,9 +15,12 @@
 #include "engine/QueryPlanner.h"
 #include "engine/Sort.h"
 #include "engine/Values.h"
+#include "engine/ValuesForTesting.h"
 #include "engine/sparqlExpressions/AggregateExpression.h"
+#include "engine/sparqlExpressions/GroupConcatExpression.h"
 #include "engine/sparqlExpressions/LiteralExpression.h"
 #include "engine/sparqlExpressions/NaryExpression.h"
+#include "engine/sparqlExpressions/SampleExpression.h"
 #include "gtest/gtest.h"
 #include "index/ConstantsIndexBuilding.h"
 #include "parser/SparqlParser.h"
@@ -585,17 +588,12 @@ TEST_F(GroupByOptimizations, checkIfHashMapOptimizationPossible) {
   // Must have exactly one variable to group by.
   testFailure(emptyVariables, aliasesAvgX, subtreeWithSort, avgAggregate);
   testFailure(variablesXAndY, aliasesAvgX, subtreeWithSort, avgAggregate);
-  // No support for min at the moment
-  testFailure(variablesOnlyX, aliasesMinX, subtreeWithSort, minAggregate);
   // Top operation must be SORT
   testFailure(variablesOnlyX, aliasesAvgX, validJoinWhenGroupingByX,
               avgAggregate);
   // Can not be a nested aggregate
   testFailure(variablesOnlyX, aliasesAvgCountX, subtreeWithSort,
               avgCountAggregate);
-  // Do not support distinct aggregates
-  testFailure(variablesOnlyX, aliasesAvgDistinctX, subtreeWithSort,
-              avgDistinctAggregate);
   // Optimization has to be enabled
   RuntimeParameters().set<"use-group-by-hash-map-optimization">(false);
   testFailure(variablesOnlyX, aliasesAvgX, subtreeWithSort, avgAggregate);
@@ -616,8 +614,13 @@ TEST_F(GroupByOptimizations, checkIfHashMapOptimizationPossible) {
   ASSERT_FALSE(aggregateInfo.parentAndIndex_.has_value());
   ASSERT_EQ(aggregateInfo.expr_, avgXPimpl.getPimpl());
 
-  // Disable optimization for following tests
-  RuntimeParameters().set<"use-group-by-hash-map-optimization">(false);
+  // MIN and DISTINCT aggregates are also supported.
+  GroupBy groupByMin{qec, variablesOnlyX, aliasesMinX, subtreeWithSort};
+  ASSERT_TRUE(groupByMin.checkIfHashMapOptimizationPossible(minAggregate));
+  GroupBy groupByAvgDistinct{qec, variablesOnlyX, aliasesAvgDistinctX,
+                             subtreeWithSort};
+  ASSERT_TRUE(groupByAvgDistinct.checkIfHashMapOptimizationPossible(
+      avgDistinctAggregate));
 }
 
 // _____________________________________________________________________________
@@ -656,6 +659,9 @@ TEST_F(GroupByOptimizations, correctResultForHashMapOptimization) {
   // Compare results, using debugString as the result only contains 2 rows
   ASSERT_EQ(resultWithOptimization->asDebugString(),
             resultWithoutOptimization->asDebugString());
+
+  // Restore the default for the following tests.
+  RuntimeParameters().set<"use-group-by-hash-map-optimization">(true);
 }
 
 // _____________________________________________________________________________
@@ -724,8 +730,8 @@ TEST_F(GroupByOptimizations, hashMapOptimizationGroupedVariable) {
       {{d(1), d(1), d(3), d(6)}, {d(5), d(5), d(6), d(9)}});
   EXPECT_EQ(table, expected);
 
-  // Disable optimization for following tests
-  RuntimeParameters().set<"use-group-by-hash-map-optimization">(false);
+  // Restore the default for the following tests.
+  RuntimeParameters().set<"use-group-by-hash-map-optimization">(true);
 }
 
 // _____________________________________________________________________________
@@ -827,9 +833,239 @@ TEST_F(GroupByOptimizations, hashMapOptimizationNonTrivial) {
   // Compare results, using debugString as the result only contains 2 rows
   ASSERT_EQ(resultWithOptimization->asDebugString(),
             resultWithoutOptimization->asDebugString());
+}
+
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, hashMapOptimizationAllAggregates) {
+  // SELECT ?x (SUM(?y) AS ...) ... WHERE { <large input> } GROUP BY ?x
+  // for all the supported aggregates, computed with and without the HashMap
+  // optimization and with several threads. The input is large enough to be
+  // split between three threads.
+  size_t numRows = 800'000;
+  IdTable input{2, makeAllocator()};
+  input.resize(numRows);
+  for (size_t i = 0; i < numRows; ++i) {
+    input(i, 0) = I(static_cast<int64_t>(i % 997));
+    input(i, 1) = I(static_cast<int64_t>((i * 7) % 101));
+  }
+
+  size_t counter = 0;
+  auto makeAlias = [&]<typename Expr>(bool distinct, auto&&... args) {
+    auto expr = std::make_unique<Expr>(distinct, makeVariableExpression(varY),
+                                       AD_FWD(args)...);
+    return Alias{SparqlExpressionPimpl{std::move(expr), "aggregate"},
+                 Variable{absl::StrCat("?aggregate", counter++)}};
+  };
+  std::vector<Alias> aliases{
+      makeAlias.operator()<AvgExpression>(false),
+      makeAlias.operator()<CountExpression>(false),
+      makeAlias.operator()<SumExpression>(false),
+      makeAlias.operator()<MinExpression>(false),
+      makeAlias.operator()<MaxExpression>(false),
+      makeAlias.operator()<SampleExpression>(false),
+      makeAlias.operator()<GroupConcatExpression>(false, std::string{","}),
+      makeAlias.operator()<AvgExpression>(true),
+      makeAlias.operator()<CountExpression>(true),
+      makeAlias.operator()<SumExpression>(true),
+      makeAlias.operator()<MinExpression>(true),
+      makeAlias.operator()<GroupConcatExpression>(true, std::string{";"})};
+
+  // Compute the GROUP BY and return the result with the words of the local
+  // vocab instead of the `Id`s that refer to them, s.t. results with different
+  // local vocabs can be compared.
+  auto computeResult = [&](bool useHashMap) {
+    qec->clearCacheUnpinnedOnly();
+    RuntimeParameters().set<"use-group-by-hash-map-optimization">(useHashMap);
+    auto values = ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, input.clone(), std::vector<std::optional<Variable>>{varX, varY});
+    GroupBy groupBy{qec, variablesOnlyX, aliases, std::move(values)};
+    auto result = groupBy.getResult();
+    auto sortStatus =
+        groupBy.getChildren().at(0)->getRootOperation()->runtimeInfo().status_;
+    EXPECT_EQ(sortStatus == RuntimeInformation::Status::optimizedOut,
+              useHashMap);
+    std::vector<std::vector<std::string>> rows;
+    for (const auto& row : result->idTable()) {
+      auto& outRow = rows.emplace_back();
+      for (Id id : row) {
+        outRow.push_back(id.getDatatype() == Datatype::LocalVocabIndex
+                             ? std::string{result->localVocab().getWord(
+                                   id.getLocalVocabIndex())}
+                             : absl::StrCat(id.getBits()));
+      }
+    }
+    return rows;
+  };
+
+  auto expected = computeResult(false);
+  ASSERT_EQ(expected.size(), 997);
+  for (size_t numThreads : {1, 3}) {
+    RuntimeParameters().set<"group-by-hash-map-num-threads">(numThreads);
+    EXPECT_EQ(computeResult(true), expected);
+  }
+  RuntimeParameters().set<"group-by-hash-map-num-threads">(4);
+  RuntimeParameters().set<"use-group-by-hash-map-optimization">(true);
+}
 
-  // Disable optimization for following tests
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, hashMapOptimizationIsChosenByCost) {
+  // SELECT ?x (COUNT(?y) AS ?count) WHERE { <input> } GROUP BY ?x
+  IdTable input = makeIdTableFromVector({{3, 1}, {1, 2}, {3, 3}});
+  auto values = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, std::move(input), std::vector<std::optional<Variable>>{varX, varY});
+  auto& valuesOp =
+      dynamic_cast<ValuesForTesting&>(*values->getRootOperation());
+  // The multiplicity of `?x` is estimated to be 42 by the `ValuesForTesting`,
+  // so there are few groups and the HashMap optimization is cheaper.
+  valuesOp.sizeEstimate() = 1'000'000;
+  valuesOp.costEstimate() = 1'000'000;
+  GroupBy groupBy{qec, variablesOnlyX, aliasesCountX, values};
+  auto costWithSort = groupBy.getChildren().at(0)->getCostEstimate();
+
+  auto costWithHashMap = groupBy.getCostEstimateForHashMapOptimization();
+  ASSERT_TRUE(costWithHashMap.has_value());
+  EXPECT_LT(costWithHashMap.value(), costWithSort);
+  EXPECT_EQ(groupBy.getCostEstimate(), costWithHashMap.value());
+
+  // Without the optimization, the input has to be sorted.
   RuntimeParameters().set<"use-group-by-hash-map-optimization">(false);
+  EXPECT_FALSE(groupBy.getCostEstimateForHashMapOptimization().has_value());
+  EXPECT_EQ(groupBy.getCostEstimate(), costWithSort);
+  RuntimeParameters().set<"use-group-by-hash-map-optimization">(true);
+}
+
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, lazySortedInput) {
+  // SELECT ?x (SUM(?y) AS ...) ... WHERE { <sorted input> } GROUP BY ?x
+  // for the supported aggregates with an input that is already sorted by `?x`
+  // and yielded lazily. The groups span several blocks of the input.
+  size_t numRows = 10'000;
+  IdTable input{2, makeAllocator()};
+  input.resize(numRows);
+  for (size_t i = 0; i < numRows; ++i) {
+    input(i, 0) = I(static_cast<int64_t>(i / 7));
+    input(i, 1) = I(static_cast<int64_t>((i * 13) % 11));
+  }
+
+  size_t counter = 0;
+  auto makeAlias = [&]<typename Expr>(bool distinct, auto&&... args) {
+    auto expr = std::make_unique<Expr>(distinct, makeVariableExpression(varY),
+                                       AD_FWD(args)...);
+    return Alias{SparqlExpressionPimpl{std::move(expr), "aggregate"},
+                 Variable{absl::StrCat("?aggregate", counter++)}};
+  };
+  std::vector<Alias> aliases{
+      makeAlias.operator()<CountExpression>(false),
+      makeAlias.operator()<SumExpression>(false),
+      makeAlias.operator()<MinExpression>(false),
+      makeAlias.operator()<MaxExpression>(false),
+      makeAlias.operator()<SampleExpression>(false),
+      makeAlias.operator()<GroupConcatExpression>(false, std::string{","}),
+      makeAlias.operator()<CountExpression>(true),
+      makeAlias.operator()<GroupConcatExpression>(true, std::string{";"})};
+
+  // Compute the GROUP BY and return the result with the words of the local
+  // vocab instead of the `Id`s that refer to them, s.t. results with different
+  // local vocabs can be compared.
+  auto computeResult = [&](std::optional<size_t> lazyBlockSize) {
+    qec->clearCacheUnpinnedOnly();
+    auto values = ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, input.clone(), std::vector<std::optional<Variable>>{varX, varY});
+    auto& valuesOp =
+        dynamic_cast<ValuesForTesting&>(*values->getRootOperation());
+    valuesOp.lazyBlockSize() = lazyBlockSize;
+    valuesOp.sortedColumns() = {0};
+    GroupBy groupBy{qec, variablesOnlyX, aliases, std::move(values)};
+    // The input is already sorted, so no `Sort` is added.
+    EXPECT_EQ(groupBy.getChildren().at(0)->getRootOperation().get(),
+              &valuesOp);
+    auto result = groupBy.getResult();
+    EXPECT_EQ(groupBy.runtimeInfo().details_.contains("lazy-input-blocks"),
+              lazyBlockSize.has_value());
+    std::vector<std::vector<std::string>> rows;
+    for (const auto& row : result->idTable()) {
+      auto& outRow = rows.emplace_back();
+      for (Id id : row) {
+        outRow.push_back(id.getDatatype() == Datatype::LocalVocabIndex
+                             ? std::string{result->localVocab().getWord(
+                                   id.getLocalVocabIndex())}
+                             : absl::StrCat(id.getBits()));
+      }
+    }
+    return rows;
+  };
+
+  auto expected = computeResult(std::nullopt);
+  ASSERT_EQ(expected.size(), (numRows + 6) / 7);
+  for (size_t blockSize : {1, 3, 7, 100, 20'000}) {
+    EXPECT_EQ(computeResult(blockSize), expected);
+  }
+}
+
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, sortedInputInParallelChunks) {
+  // SELECT ?x (AVG(?y) AS ...) ... WHERE { <input> } GROUP BY ?x
+  // without the HashMap optimization, with the sorted input split into chunks
+  // of different sizes that are aggregated concurrently. Some of the groups
+  // are larger than the chunks.
+  size_t numRows = 10'000;
+  IdTable input{2, makeAllocator()};
+  input.resize(numRows);
+  for (size_t i = 0; i < numRows; ++i) {
+    input(i, 0) = I(static_cast<int64_t>(i < 500 ? 0 : i / 7));
+    input(i, 1) = I(static_cast<int64_t>((i * 13) % 11));
+  }
+
+  size_t counter = 0;
+  auto makeAlias = [&]<typename Expr>(bool distinct, auto&&... args) {
+    auto expr = std::make_unique<Expr>(distinct, makeVariableExpression(varY),
+                                       AD_FWD(args)...);
+    return Alias{SparqlExpressionPimpl{std::move(expr), "aggregate"},
+                 Variable{absl::StrCat("?aggregate", counter++)}};
+  };
+  std::vector<Alias> aliases{
+      makeAlias.operator()<AvgExpression>(false),
+      makeAlias.operator()<CountExpression>(false),
+      makeAlias.operator()<SampleExpression>(false),
+      makeAlias.operator()<GroupConcatExpression>(false, std::string{","}),
+      makeAlias.operator()<GroupConcatExpression>(true, std::string{";"})};
+
+  // Compute the GROUP BY and return the result with the words of the local
+  // vocab instead of the `Id`s that refer to them, s.t. results with different
+  // local vocabs can be compared.
+  auto computeResult = [&](size_t numThreads, size_t chunkSize) {
+    qec->clearCacheUnpinnedOnly();
+    RuntimeParameters().set<"group-by-sorted-num-threads">(numThreads);
+    RuntimeParameters().set<"group-by-sorted-chunk-size">(chunkSize);
+    auto values = ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, input.clone(), std::vector<std::optional<Variable>>{varX, varY});
+    GroupBy groupBy{qec, variablesOnlyX, aliases, std::move(values)};
+    auto result = groupBy.getResult();
+    EXPECT_EQ(groupBy.runtimeInfo().details_.contains("num-chunks"),
+              numThreads > 1 && chunkSize < numRows);
+    std::vector<std::vector<std::string>> rows;
+    for (const auto& row : result->idTable()) {
+      auto& outRow = rows.emplace_back();
+      for (Id id : row) {
+        outRow.push_back(id.getDatatype() == Datatype::LocalVocabIndex
+                             ? std::string{result->localVocab().getWord(
+                                   id.getLocalVocabIndex())}
+                             : absl::StrCat(id.getBits()));
+      }
+    }
+    return rows;
+  };
+
+  RuntimeParameters().set<"use-group-by-hash-map-optimization">(false);
+  auto expected = computeResult(1, numRows);
+  // The group `0` and the groups `71` to `1428`.
+  ASSERT_EQ(expected.size(), 1359);
+  for (size_t chunkSize : {1, 7, 100, 1000}) {
+    EXPECT_EQ(computeResult(3, chunkSize), expected) << chunkSize;
+  }
+  RuntimeParameters().set<"group-by-sorted-num-threads">(4);
+  RuntimeParameters().set<"group-by-sorted-chunk-size">(65536);
+  RuntimeParameters().set<"use-group-by-hash-map-optimization">(true);
 }
 
 // _____________________________________________________________________________
@@ -946,6 +1182,44 @@ TEST_F(GroupByOptimizations, computeGroupByForJoinWithFullScan) {
   }
 }
 
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, computeGroupByForCountOfJoin) {
+  auto makeTree = [&](const VectorTable& table,
+                      std::vector<std::optional<Variable>> variables) {
+    return ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, makeIdTableFromVector(table), std::move(variables));
+  };
+  auto left = makeTree({{1, 10}, {1, 11}, {2, 12}, {3, 13}}, {varX, varY});
+  auto right = makeTree({{1, 20}, {2, 21}, {2, Id::makeUndefined()}, {4, 22}},
+                        {varX, varZ});
+  auto join = makeExecutionTree<Join>(qec, left, right, 0, 0);
+
+  // `SELECT (COUNT(?x) AS ?count) { ... }` and the same for `?y` are the
+  // number of rows of the join.
+  for (const auto& var : {varX, varY}) {
+    std::vector<Alias> aliases{Alias{makeCountPimpl(var), Variable{"?count"}}};
+    GroupBy groupBy{qec, emptyVariables, aliases, join};
+    IdTable result{qec->getAllocator()};
+    ASSERT_TRUE(groupBy.computeOptimizedGroupByIfPossible(&result));
+    EXPECT_EQ(result, makeIdTableFromVector({{I(4)}}));
+    auto joinOp = groupBy.getChildren().at(0)->getRootOperation();
+    EXPECT_EQ(joinOp->runtimeInfo().status_,
+              RuntimeInformation::Status::optimizedOut);
+  }
+
+  // Not applicable: `?z` might be undefined, the count is distinct, or the
+  // count is grouped.
+  IdTable result{qec->getAllocator()};
+  std::vector<Alias> countZ{Alias{makeCountPimpl(varZ), Variable{"?count"}}};
+  GroupBy countOfUndefined{qec, emptyVariables, countZ, join};
+  EXPECT_FALSE(countOfUndefined.computeGroupByForCountOfJoin(&result));
+  GroupBy distinctCount{qec, emptyVariables, aliasesCountDistinctX, join};
+  EXPECT_FALSE(distinctCount.computeGroupByForCountOfJoin(&result));
+  GroupBy groupedCount{qec, variablesOnlyX, aliasesCountX, join};
+  EXPECT_FALSE(groupedCount.computeGroupByForCountOfJoin(&result));
+  EXPECT_TRUE(result.empty());
+}
+
 // _____________________________________________________________________________
 TEST_F(GroupByOptimizations, computeGroupByForSingleIndexScan) {
   // Assert that a GROUP BY, that is constructed from the given arguments,
@@ -964,9 +1238,12 @@ TEST_F(GroupByOptimizations, computeGroupByForSingleIndexScan) {
   testFailure(variablesOnlyX, aliasesCountX, xyzScanSortedByX);
 
   // Must (currently) have exactly one alias that is a count.
-  // A distinct count is only supporte if the triple has three variables.
+  // A distinct count for a triple with two variables must be of one of the
+  // variables of the triple.
   testFailure(emptyVariables, emptyAliases, xyzScanSortedByX);
-  testFailure(emptyVariables, aliasesCountDistinctX, xyScan);
+  testFailure(emptyVariables,
+              std::vector{Alias{makeCountPimpl(varZ, true), Variable{"?c"}}},
+              xyScan);
   testFailure(emptyVariables, aliasesXAsV, xyzScanSortedByX);
 
   // `chooseInterface == true` means "use the dedicated
@@ -1011,6 +1288,20 @@ TEST_F(GroupByOptimizations, computeGroupByForSingleIndexScan) {
     // <x>, <y>, <z>, <a>, <b> and <c>.
     ASSERT_EQ(result(0, 0), Id::makeFromInt(6));
   }
+  {
+    // The distinct counts for a triple with two variables are read from the
+    // metadata of the relation `<label>`.
+    auto testDistinctCount = [&](const Variable& var, int64_t expected) {
+      IdTable result{qec->getAllocator()};
+      std::vector aliases{Alias{makeCountPimpl(var, true), Variable{"?c"}}};
+      auto groupBy = GroupBy{qec, emptyVariables, aliases, xyScan};
+      ASSERT_TRUE(groupBy.computeGroupByForSingleIndexScan(&result));
+      EXPECT_EQ(result, makeIdTableFromVector({{I(expected)}}));
+    };
+    // The subjects <x> and <z> have five distinct labels.
+    testDistinctCount(varX, 2);
+    testDistinctCount(varY, 5);
+  }
 }
 
 // _____________________________________________________________________________
@@ -1085,6 +1376,113 @@ TEST_F(GroupByOptimizations, computeGroupByForFullIndexScan) {
   // TODO<joka921> Add a test with only one column
 }
 
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, computeGroupByForDistinctCountOfFullIndexScan) {
+  // SELECT ?y (COUNT(DISTINCT ?x) AS ?c) WHERE { ?x ?y ?z } GROUP BY ?y
+  std::vector aliases{Alias{makeCountPimpl(varX, true), Variable{"?c"}}};
+  GroupBy groupBy{qec, variablesOnlyY, aliases, xyzScanSortedByY};
+  IdTable result{qec->getAllocator()};
+  ASSERT_TRUE(groupBy.computeOptimizedGroupByIfPossible(&result));
+  auto getId = makeGetId(qec->getIndex());
+  VectorTable expected{{getId("<is>"), I(4)},
+                       {getId("<is-a>"), I(5)},
+                       {getId("<label>"), I(2)}};
+  std::ranges::sort(expected, {},
+                    [](const auto& row) { return std::get<Id>(row.at(0)); });
+  EXPECT_EQ(result, makeIdTableFromVector(expected));
+
+  // A non-distinct count or a count of the grouped variable is not supported.
+  IdTable result2{qec->getAllocator()};
+  GroupBy nonDistinct{qec, variablesOnlyY, aliasesCountX, xyzScanSortedByY};
+  EXPECT_FALSE(
+      nonDistinct.computeGroupByForDistinctCountOfFullIndexScan(&result2));
+  std::vector countY{Alias{makeCountPimpl(varY, true), Variable{"?c"}}};
+  GroupBy countOfGrouped{qec, variablesOnlyY, countY, xyzScanSortedByY};
+  EXPECT_FALSE(
+      countOfGrouped.computeGroupByForDistinctCountOfFullIndexScan(&result2));
+  EXPECT_TRUE(result2.empty());
+}
+
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, computeGroupByForCountsOfTwoVariableScan) {
+  // SELECT ?y (COUNT(?z) AS ?c) WHERE { <x> ?y ?z } GROUP BY ?y
+  auto scan = makeExecutionTree<IndexScan>(
+      qec, Permutation::Enum::SPO,
+      SparqlTriple{{"<x>"}, "?y", Variable{"?z"}});
+  auto getId = makeGetId(qec->getIndex());
+  VectorTable expected{
+      {getId("<is>"), I(1)}, {getId("<is-a>"), I(2)}, {getId("<label>"), I(4)}};
+  std::ranges::sort(expected, {},
+                    [](const auto& row) { return std::get<Id>(row.at(0)); });
+  for (const auto& var : {varY, varZ}) {
+    std::vector aliases{Alias{makeCountPimpl(var), Variable{"?c"}}};
+    GroupBy groupBy{qec, variablesOnlyY, aliases, scan};
+    IdTable result{qec->getAllocator()};
+    ASSERT_TRUE(groupBy.computeOptimizedGroupByIfPossible(&result));
+    EXPECT_EQ(result, makeIdTableFromVector(expected));
+  }
+
+  // Without a COUNT, only the distinct values are returned.
+  GroupBy withoutCount{qec, variablesOnlyY, emptyAliases, scan};
+  IdTable result{qec->getAllocator()};
+  ASSERT_TRUE(withoutCount.computeGroupByForCountsOfTwoVariableScan(&result));
+  ASSERT_EQ(result.numColumns(), 1);
+  EXPECT_THAT(result.getColumn(0),
+              ::testing::ElementsAreArray(
+                  makeIdTableFromVector(expected).getColumn(0)));
+
+  // Grouping by the second column or a distinct count is not supported.
+  IdTable result2{qec->getAllocator()};
+  std::vector<Variable> variablesOnlyZ{varZ};
+  GroupBy bySecondColumn{qec, variablesOnlyZ, emptyAliases, scan};
+  EXPECT_FALSE(
+      bySecondColumn.computeGroupByForCountsOfTwoVariableScan(&result2));
+  std::vector countDistinct{
+      Alias{makeCountPimpl(varZ, true), Variable{"?c"}}};
+  GroupBy distinctCount{qec, variablesOnlyY, countDistinct, scan};
+  EXPECT_FALSE(
+      distinctCount.computeGroupByForCountsOfTwoVariableScan(&result2));
+  EXPECT_TRUE(result2.empty());
+}
+
+// _____________________________________________________________________________
+TEST_F(GroupByOptimizations, computeGroupByForMinMaxOfIndexScan) {
+  auto* numbersQec = getQec(
+      "<a> <p> 3 . <b> <p> 17 . <c> <p> 5 . <a> <q> -2 . <b> <q> 4 . "
+      "<a> <r> 1.5 . <b> <r> 0.25 .");
+  auto makeScan = [&](std::string predicate) {
+    return makeExecutionTree<IndexScan>(
+        numbersQec, Permutation::Enum::POS,
+        SparqlTriple{Variable{"?x"}, std::move(predicate), Variable{"?y"}});
+  };
+  auto makeMaxPimpl = [](const Variable& var) {
+    return SparqlExpressionPimpl{
+        std::make_unique<MaxExpression>(false, makeVariableExpression(var)),
+        "MAX(?someVariable)"};
+  };
+  // SELECT (MIN(?y) AS ?min) (MAX(?y) AS ?max) WHERE { ?x <p> ?y }
+  std::vector aliases{Alias{makeMinPimpl(varY), Variable{"?min"}},
+                      Alias{makeMaxPimpl(varY), Variable{"?max"}}};
+  auto computeMinMax = [&](std::string predicate) {
+    GroupBy groupBy{numbersQec, emptyVariables, aliases, makeScan(predicate)};
+    IdTable result{numbersQec->getAllocator()};
+    bool success = groupBy.computeOptimizedGroupByIfPossible(&result);
+    return success ? std::optional{std::move(result)} : std::nullopt;
+  };
+  EXPECT_EQ(computeMinMax("<p>"), makeIdTableFromVector({{I(3), I(17)}}));
+  EXPECT_EQ(computeMinMax("<r>"),
+            makeIdTableFromVector({{DoubleId(0.25), DoubleId(1.5)}}));
+  // The negative values are sorted after the positive ones.
+  EXPECT_EQ(computeMinMax("<q>"), std::nullopt);
+
+  // The MIN of the second column is not supported.
+  std::vector minOfX{Alias{makeMinPimpl(varX), Variable{"?min"}}};
+  GroupBy minOfSecondColumn{numbersQec, emptyVariables, minOfX,
+                            makeScan("<p>")};
+  IdTable result{numbersQec->getAllocator()};
+  EXPECT_FALSE(minOfSecondColumn.computeGroupByForMinMaxOfIndexScan(&result));
+}
+
 namespace {
 // A helper function to set up expression trees in the following test.
 template <typename ExprT>
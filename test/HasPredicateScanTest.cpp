@@ -139,8 +139,7 @@ TEST(HasPredicateScan, fullScan) {
   CompactVectorOfStrings<Id> patterns(patternsSrc);
 
   // Query for all relations
-  HasPredicateScan::computeFullScan(&result, hasPattern, hasRelation, patterns,
-                                    16);
+  HasPredicateScan::computeFullScan(&result, hasPattern, hasRelation, patterns);
 
   ASSERT_EQ(16u, result.size());
 
@@ -181,6 +180,32 @@ TEST(HasPredicateScan, fullScan) {
   ASSERT_EQ(V(3u), result[15][1]);
 }
 
+TEST(HasPredicateScan, fullScanConcurrently) {
+  // Enough subjects s.t. the scan is split between several threads.
+  std::vector<PatternID> hasPattern;
+  for (size_t i = 0; i < 100'000; ++i) {
+    hasPattern.push_back(i % 3 == 2 ? NO_PATTERN : i % 2);
+  }
+  CompactVectorOfStrings<Id> hasRelation;
+  CompactVectorOfStrings<Id> patterns(
+      vector<vector<Id>>{{V(0), V(1)}, {V(2)}});
+
+  IdTable result{makeAllocator()};
+  result.setNumColumns(2);
+  HasPredicateScan::computeFullScan(&result, hasPattern, hasRelation, patterns);
+
+  IdTable expected{makeAllocator()};
+  expected.setNumColumns(2);
+  for (size_t i = 0; i < hasPattern.size(); ++i) {
+    if (hasPattern[i] != NO_PATTERN) {
+      for (Id predicate : patterns[hasPattern[i]]) {
+        expected.push_back({V(i), predicate});
+      }
+    }
+  }
+  ASSERT_EQ(result, expected);
+}
+
 TEST(HasPredicateScan, subtreeS) {
   // Used to store the result.
   IdTable result{makeAllocator()};
@@ -361,3 +386,44 @@ TEST(CountAvailablePredicates, patternTrickTest) {
   ASSERT_EQ(V(4u), result[4][0]);
   ASSERT_EQ(Int(3u), result[4][1]);
 }
+
+// _____________________________________________________________________________
+TEST(CountAvailablePredicates, patternTrickOnSeveralThreads) {
+  // Enough entities s.t. they are counted on several threads. The even
+  // entities have the pattern `{V(0), V(1)}`, the odd ones have no pattern and
+  // only the predicate `V(1)`.
+  static constexpr size_t numEntities = 500'001;
+  vector<PatternID> hasPattern;
+  vector<vector<Id>> hasRelationSrc;
+  IdTable input(1, makeAllocator());
+  for (uint64_t i = 0; i < numEntities; ++i) {
+    bool isEven = i % 2 == 0;
+    hasPattern.push_back(isEven ? 0 : NO_PATTERN);
+    hasRelationSrc.push_back(isEven ? vector<Id>{} : vector<Id>{V(1)});
+    // Each entity appears twice in the input, but is only counted once.
+    input.push_back({V(i)});
+    input.push_back({V(i)});
+  }
+  CompactVectorOfStrings<Id> hasRelation(hasRelationSrc);
+  CompactVectorOfStrings<Id> patterns(vector<vector<Id>>{{V(0), V(1)}});
+
+  auto expectCounts = [](IdTable& result) {
+    std::ranges::sort(result, {}, [](const auto& row) { return row[0]; });
+    ASSERT_EQ(result.size(), 2u);
+    EXPECT_EQ(result(0, 0), V(0));
+    EXPECT_EQ(result(0, 1), Int(numEntities / 2 + 1));
+    EXPECT_EQ(result(1, 0), V(1));
+    EXPECT_EQ(result(1, 1), Int(numEntities));
+  };
+
+  IdTable result(2, makeAllocator());
+  RuntimeInformation runtimeInfo{};
+  CountAvailablePredicates::computePatternTrick<1>(
+      input, &result, hasPattern, hasRelation, patterns, 0, runtimeInfo);
+  expectCounts(result);
+
+  result.clear();
+  CountAvailablePredicates::computePatternTrickAllEntities(
+      &result, hasPattern, hasRelation, patterns);
+  expectCounts(result);
+}
@@ -0,0 +1,53 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <absl/hash/hash.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "util/HyperLogLog.h"
+
+using ad_utility::HyperLogLog;
+
+namespace {
+// Add the hashes of all the values in `[begin, end)` to the `sketch`.
+void addRange(HyperLogLog<>& sketch, size_t begin, size_t end) {
+  absl::Hash<size_t> hash;
+  for (size_t i = begin; i < end; ++i) {
+    sketch.add(hash(i));
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(HyperLogLog, estimate) {
+  HyperLogLog<> sketch;
+  EXPECT_EQ(sketch.estimate(), 0.0);
+
+  // Small cardinalities are almost exact because of the linear counting.
+  addRange(sketch, 0, 100);
+  EXPECT_NEAR(sketch.estimate(), 100.0, 1.0);
+
+  // Duplicates don't change the estimate.
+  addRange(sketch, 0, 100);
+  EXPECT_NEAR(sketch.estimate(), 100.0, 1.0);
+
+  // The relative standard error is below 1%, so 3% are never exceeded in
+  // practice.
+  addRange(sketch, 100, 1'000'000);
+  EXPECT_NEAR(sketch.estimate(), 1'000'000.0, 30'000.0);
+}
+
+// _____________________________________________________________________________
+TEST(HyperLogLog, merge) {
+  HyperLogLog<> sketch1;
+  HyperLogLog<> sketch2;
+  addRange(sketch1, 0, 200'000);
+  addRange(sketch2, 100'000, 300'000);
+  sketch1.merge(sketch2);
+  EXPECT_NEAR(sketch1.estimate(), 300'000.0, 9'000.0);
+
+  HyperLogLog<> whole;
+  addRange(whole, 0, 300'000);
+  EXPECT_EQ(sketch1.estimate(), whole.estimate());
+}
@@ -0,0 +1,195 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+
+#include "./IndexTestHelpers.h"
+#include "engine/IdTableExchange.h"
+#include "util/IdTableHelpers.h"
+
+using namespace idTableExchange;
+
+namespace {
+auto I = [](int64_t i) { return Id::makeFromInt(i); };
+const auto U = Id::makeUndefined();
+
+// Encode the rows of the `idTable` in frames of `frameSize` rows.
+std::string encodeInFrames(Encoder& encoder, const IdTable& idTable,
+                           const LocalVocab& localVocab, size_t frameSize) {
+  std::vector<std::optional<ColumnIndex>> columns;
+  for (size_t i = 0; i < idTable.numColumns(); ++i) {
+    columns.emplace_back(i);
+  }
+  std::string result = encoder.header(columns.size());
+  encoder.setLocalVocab(localVocab);
+  for (size_t begin = 0; begin < idTable.size(); begin += frameSize) {
+    size_t end = std::min(begin + frameSize, idTable.size());
+    result.append(
+        encoder.frame(idTable, columns, std::views::iota(begin, end)));
+  }
+  result.append(Encoder::endOfStream());
+  return result;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(IdTableExchange, acceptHeader) {
+  auto header = makeAcceptHeader(4711);
+  EXPECT_THAT(header, ::testing::StartsWith("application/x-qlever-idtable;"));
+  EXPECT_THAT(header, ::testing::HasSubstr("text/tab-separated-values"));
+  EXPECT_EQ(getVocabularyIdentityFromAcceptHeader(header), 4711u);
+  EXPECT_EQ(getVocabularyIdentityFromAcceptHeader(
+                "text/csv, application/x-qlever-idtable ; vocabulary = 12"),
+            12u);
+  EXPECT_EQ(getVocabularyIdentityFromAcceptHeader(
+                "application/x-qlever-idtable;vocabulary=abc"),
+            std::nullopt);
+  EXPECT_EQ(getVocabularyIdentityFromAcceptHeader(
+                "application/x-qlever-idtable, text/tab-separated-values"),
+            std::nullopt);
+  EXPECT_EQ(getVocabularyIdentityFromAcceptHeader("text/csv;vocabulary=12"),
+            std::nullopt);
+}
+
+// _____________________________________________________________________________
+TEST(IdTableExchange, vocabularyIdentity) {
+  const auto& index = ad_utility::testing::getQec()->getIndex();
+  const auto& otherIndex =
+      ad_utility::testing::getQec("<a> <b> <c> .")->getIndex();
+  EXPECT_EQ(getVocabularyIdentity(index), getVocabularyIdentity(index));
+  EXPECT_NE(getVocabularyIdentity(index), getVocabularyIdentity(otherIndex));
+}
+
+// _____________________________________________________________________________
+TEST(IdTableExchange, roundTripWithSameVocabulary) {
+  auto* qec = ad_utility::testing::getQec("<a> <p> <b> . <b> <p> \"text\" .");
+  const auto& index = qec->getIndex();
+  auto getId = ad_utility::testing::makeGetId(index);
+  Id a = getId("<a>");
+  Id b = getId("<b>");
+  LocalVocab senderVocab;
+  Id local = senderVocab.getIdAndAddIfNotContained("<not-in-the-vocabulary>");
+  auto table = makeIdTableFromVector(
+      {{a, I(1), U}, {b, local, I(-3)}, {local, a, U}, {b, b, I(7)}});
+
+  // The `Id`s of the vocabulary are transferred directly and the words of the
+  // local vocabulary are added to the local vocabulary of the receiver.
+  for (size_t frameSize : {1, 3, 100}) {
+    Encoder encoder{index, getVocabularyIdentity(index)};
+    auto data = encodeInFrames(encoder, table, senderVocab, frameSize);
+    EXPECT_TRUE(data.starts_with(MAGIC));
+    LocalVocab receiverVocab;
+    auto decoded = decode(data, 3, index, receiverVocab,
+                          ad_utility::testing::makeAllocator());
+    ASSERT_EQ(receiverVocab.size(), 1u);
+    Id received =
+        receiverVocab.getIdOrNullopt("<not-in-the-vocabulary>").value();
+    EXPECT_EQ(decoded,
+              makeIdTableFromVector({{a, I(1), U},
+                                     {b, received, I(-3)},
+                                     {received, a, U},
+                                     {b, b, I(7)}}));
+  }
+
+  // Without the vocabulary identity of the receiver, the words of the
+  // vocabulary are part of the dictionary, which gives the same result.
+  Encoder encoder{index, std::nullopt};
+  auto withWords = encodeInFrames(encoder, table, senderVocab, 2);
+  Encoder sameVocabularyEncoder{index, getVocabularyIdentity(index)};
+  auto withoutWords =
+      encodeInFrames(sameVocabularyEncoder, table, senderVocab, 2);
+  EXPECT_GT(withWords.size(), withoutWords.size());
+  LocalVocab receiverVocab;
+  auto decoded = decode(withWords, 3, index, receiverVocab,
+                        ad_utility::testing::makeAllocator());
+  EXPECT_EQ(decoded.getColumn(0)[0], a);
+  EXPECT_EQ(decoded.getColumn(2)[3], I(7));
+}
+
+// _____________________________________________________________________________
+TEST(IdTableExchange, roundTripWithDifferentVocabulary) {
+  const auto& sender =
+      ad_utility::testing::getQec("<only-on-the-sender> <p> <shared> .")
+          ->getIndex();
+  const auto& receiver =
+      ad_utility::testing::getQec("<shared> <q> <x> . <x> <q> <y> .")
+          ->getIndex();
+  auto getSenderId = ad_utility::testing::makeGetId(sender);
+  auto getReceiverId = ad_utility::testing::makeGetId(receiver);
+  auto table =
+      makeIdTableFromVector({{getSenderId("<shared>"), I(3)},
+                             {getSenderId("<only-on-the-sender>"), I(4)},
+                             {getSenderId("<shared>"), U}});
+  LocalVocab senderVocab;
+  Encoder encoder{sender, getVocabularyIdentity(receiver)};
+  auto data = encodeInFrames(encoder, table, senderVocab, 2);
+
+  // `<shared>` is mapped to the vocabulary of the receiver, the other word is
+  // added to its local vocabulary.
+  LocalVocab receiverVocab;
+  auto decoded = decode(data, 2, receiver, receiverVocab,
+                        ad_utility::testing::makeAllocator());
+  Id onlyOnSender =
+      receiverVocab.getIdOrNullopt("<only-on-the-sender>").value();
+  EXPECT_EQ(decoded, makeIdTableFromVector({{getReceiverId("<shared>"), I(3)},
+                                            {onlyOnSender, I(4)},
+                                            {getReceiverId("<shared>"), U}}));
+
+  // If the sender wrongly assumes that the receiver has the same vocabulary,
+  // the receiver detects the missing words.
+  Encoder wrongEncoder{sender, getVocabularyIdentity(sender)};
+  EXPECT_ANY_THROW(decode(encodeInFrames(wrongEncoder, table, senderVocab, 2),
+                          2, receiver, receiverVocab,
+                          ad_utility::testing::makeAllocator()));
+}
+
+// _____________________________________________________________________________
+TEST(IdTableExchange, localVocabsOfLazyResults) {
+  const auto& index = ad_utility::testing::getQec()->getIndex();
+  // The two blocks of a lazy result have different local vocabularies, in
+  // which the same `LocalVocabIndex` stands for different words.
+  LocalVocab vocab1;
+  LocalVocab vocab2;
+  Id first = vocab1.getIdAndAddIfNotContained("<first-long-word>");
+  Id second = vocab2.getIdAndAddIfNotContained("<second-long-word>");
+  ASSERT_EQ(first, second);
+  auto table = makeIdTableFromVector({{first}});
+  std::vector<std::optional<ColumnIndex>> columns{ColumnIndex{0}};
+  Encoder encoder{index, getVocabularyIdentity(index)};
+  std::string data = encoder.header(1);
+  encoder.setLocalVocab(vocab1);
+  data.append(encoder.frame(table, columns, std::views::iota(0ul, 1ul)));
+  encoder.setLocalVocab(vocab2);
+  data.append(encoder.frame(table, columns, std::views::iota(0ul, 1ul)));
+  data.append(Encoder::endOfStream());
+
+  LocalVocab receiverVocab;
+  auto decoded = decode(data, 1, index, receiverVocab,
+                        ad_utility::testing::makeAllocator());
+  Id receivedFirst = receiverVocab.getIdOrNullopt("<first-long-word>").value();
+  Id receivedSecond =
+      receiverVocab.getIdOrNullopt("<second-long-word>").value();
+  EXPECT_EQ(decoded,
+            makeIdTableFromVector({{receivedFirst}, {receivedSecond}}));
+}
+
+// _____________________________________________________________________________
+TEST(IdTableExchange, invalidData) {
+  const auto& index = ad_utility::testing::getQec()->getIndex();
+  LocalVocab localVocab;
+  Encoder encoder{index, getVocabularyIdentity(index)};
+  auto data = encodeInFrames(encoder, makeIdTableFromVector({{I(1), I(2)}}),
+                             localVocab, 10);
+  auto decode = [&](std::string_view bytes, size_t numColumns = 2) {
+    return idTableExchange::decode(bytes, numColumns, index, localVocab,
+                                   ad_utility::testing::makeAllocator());
+  };
+  EXPECT_EQ(decode(data), makeIdTableFromVector({{I(1), I(2)}}));
+  EXPECT_ANY_THROW(decode(data, 3));
+  EXPECT_ANY_THROW(decode(data.substr(0, data.size() - 1)));
+  EXPECT_ANY_THROW(decode(data + "x"));
+  EXPECT_ANY_THROW(decode("?x\t?y\n1\t2\n"));
+  EXPECT_TRUE(startsWithMagic("QLID"));
+  EXPECT_TRUE(startsWithMagic(data));
+  EXPECT_FALSE(startsWithMagic("?x\t?y\n"));
+}
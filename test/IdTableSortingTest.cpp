@@ -0,0 +1,265 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "./util/AllocatorTestHelpers.h"
+#include "./util/GTestHelpers.h"
+#include "engine/idTable/IdTableSorting.h"
+#include "util/Random.h"
+
+using namespace ad_utility::idTableSorting;
+using ad_utility::source_location;
+using ad_utility::testing::makeAllocator;
+using namespace ad_utility::memory_literals;
+
+namespace {
+// Create a table with `numRows` rows and `numColumns` columns of random `Id`s.
+// The values of the first column are taken from a small range, s.t. there are
+// many duplicates. The other columns contain arbitrary bit patterns.
+IdTable makeRandomTable(size_t numRows, size_t numColumns,
+                        ad_utility::AllocatorWithLimit<Id> allocator =
+                            makeAllocator()) {
+  ad_utility::FastRandomIntGenerator<uint64_t> generator;
+  IdTable table{numColumns, std::move(allocator)};
+  table.resize(numRows);
+  for (size_t col = 0; col < numColumns; ++col) {
+    for (auto& id : table.getColumn(col)) {
+      auto bits = col == 0 ? generator() % 100 : generator();
+      id = Id::fromBits(bits);
+    }
+  }
+  return table;
+}
+
+// Sort a copy of the `table` by the `sortColumns` using `std::stable_sort`.
+IdTable sortReference(const IdTable& table,
+                      const std::vector<ColumnIndex>& sortColumns) {
+  IdTable result = table.clone();
+  std::stable_sort(result.begin(), result.end(),
+                   [&sortColumns](const auto& a, const auto& b) {
+                     for (auto col : sortColumns) {
+                       if (a[col] != b[col]) {
+                         return a[col] < b[col];
+                       }
+                     }
+                     return false;
+                   });
+  return result;
+}
+
+// Check that the rows of `actual` are equal to the rows of `expected` when
+// only the `sortColumns` are considered and that `actual` is a permutation
+// of `expected`.
+void expectSortedCorrectly(const IdTable& actual, const IdTable& expected,
+                           const std::vector<ColumnIndex>& sortColumns,
+                           source_location l = source_location::current()) {
+  auto trace = generateLocationTrace(l);
+  ASSERT_EQ(actual.numRows(), expected.numRows());
+  ASSERT_EQ(actual.numColumns(), expected.numColumns());
+  for (auto col : sortColumns) {
+    ASSERT_TRUE(std::ranges::equal(actual.getColumn(col),
+                                   expected.getColumn(col)));
+  }
+  auto sortedCompletely = [](const IdTable& table) {
+    IdTable copy = table.clone();
+    std::sort(copy.begin(), copy.end(),
+              std::ranges::lexicographical_compare);
+    return copy;
+  };
+  ASSERT_TRUE(sortedCompletely(actual) == sortedCompletely(expected));
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(IdTableSorting, sortByColumns) {
+  auto testSorting = [](size_t numRows,
+                        const std::vector<std::vector<ColumnIndex>>& sortCols,
+                        const std::vector<size_t>& numThreads) {
+    auto table = makeRandomTable(numRows, 4);
+    for (const auto& sortColumns : sortCols) {
+      auto expected = sortReference(table, sortColumns);
+      for (size_t threads : numThreads) {
+        IdTable copy = table.clone();
+        sortByColumns(copy, sortColumns, threads);
+        // The radix sort is stable, so the result is exactly the same as for
+        // `std::stable_sort`.
+        if (sortColumns.size() <= 2 &&
+            numRows >= MIN_SIZE_FOR_PERMUTATION_SORT) {
+          EXPECT_TRUE(copy == expected);
+        } else {
+          expectSortedCorrectly(copy, expected, sortColumns);
+        }
+      }
+    }
+  };
+  std::vector<std::vector<ColumnIndex>> sortColumns{
+      {0}, {2}, {0, 1}, {3, 0}, {0, 3, 1}};
+  for (size_t numRows : {0, 1, 500, 20'000}) {
+    testSorting(numRows, sortColumns, {0, 1, 2, 5});
+  }
+  // Large enough for multiple threads.
+  testSorting(250'000, {{2}, {0, 1}, {0, 3, 1}}, {1, 3});
+}
+
+// _____________________________________________________________________________
+TEST(IdTableSorting, sortedCopyByColumns) {
+  auto test = [](size_t numRows, const std::vector<ColumnIndex>& sortColumns,
+                 size_t numThreads) {
+    auto table = makeRandomTable(numRows, 4);
+    IdTable original = table.clone();
+    IdTable sorted = sortedCopyByColumns(table, sortColumns, numThreads);
+    // The input is not changed.
+    EXPECT_TRUE(table == original);
+    expectSortedCorrectly(sorted, sortReference(table, sortColumns),
+                          sortColumns);
+  };
+  for (size_t numRows : {0, 1, 500, 20'000}) {
+    for (const auto& sortColumns :
+         std::vector<std::vector<ColumnIndex>>{{0}, {0, 1}, {0, 3, 1}}) {
+      test(numRows, sortColumns, 2);
+    }
+  }
+  // Large enough for multiple threads.
+  test(250'000, {0, 3, 1}, 3);
+  test(250'000, {2}, 3);
+}
+
+// _____________________________________________________________________________
+TEST(IdTableSorting, narrowKeys) {
+  using namespace ad_utility::idTableSorting::detail;
+  // Columns of `VocabIndex`es far away from zero, but within a range of less
+  // than 2^32, can be sorted with the narrow entries.
+  ad_utility::FastRandomIntGenerator<uint64_t> generator;
+  IdTable table{3, makeAllocator()};
+  table.resize(50'000);
+  for (size_t i = 0; i < table.numRows(); ++i) {
+    table(i, 0) = Id::makeFromVocabIndex(
+        VocabIndex::make((uint64_t{1} << 40) + generator() % 1'000));
+    table(i, 1) = Id::makeFromVocabIndex(
+        VocabIndex::make((uint64_t{1} << 50) + generator() % (1ul << 31)));
+    table(i, 2) = Id::makeFromInt(static_cast<int64_t>(generator() % 7) - 3);
+  }
+  std::vector<ColumnIndex> narrowColumns{0, 1};
+  auto bases = getBasesForNarrowKeys(table, narrowColumns, 2);
+  ASSERT_TRUE(bases.has_value());
+  EXPECT_EQ(bases.value().size(), 2u);
+  // Negative and positive integers are far apart in their bits.
+  std::vector<ColumnIndex> wideColumns{0, 2};
+  EXPECT_FALSE(getBasesForNarrowKeys(table, wideColumns, 2).has_value());
+
+  for (const auto& sortColumns : std::vector<std::vector<ColumnIndex>>{
+           {0}, {1}, {1, 0}, {0, 2}, {2}}) {
+    auto expected = sortReference(table, sortColumns);
+    for (size_t numThreads : {1, 3}) {
+      IdTable copy = table.clone();
+      sortByColumns(copy, sortColumns, numThreads);
+      EXPECT_TRUE(copy == expected);
+      EXPECT_TRUE(sortedCopyByColumns(table, sortColumns, numThreads) ==
+                  expected);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+TEST(IdTableSorting, sortWithComparison) {
+  auto table = makeRandomTable(250'000, 2);
+  // Sort descending by the first column and ascending by the second column.
+  auto comparison = [](const auto& a, const auto& b) {
+    if (a[0] != b[0]) {
+      return a[0] > b[0];
+    }
+    return a[1] < b[1];
+  };
+  IdTable expected = table.clone();
+  std::sort(expected.begin(), expected.end(), comparison);
+  for (size_t numThreads : {1, 3}) {
+    IdTableStatic<2> copy = table.clone().toStatic<2>();
+    sortWithComparison(copy, comparison, numThreads);
+    // The second column contains random 64-bit values, so there are no
+    // duplicate rows and the order is unique.
+    EXPECT_TRUE(std::move(copy).toDynamic() == expected);
+  }
+}
+
+// _____________________________________________________________________________
+TEST(IdTableSorting, fallbackIfMemoryIsScarce) {
+  // The buffers for the radix sort need four times as much memory as the
+  // single column of the table, so the table can still be sorted, but not via
+  // the radix sort.
+  auto table = makeRandomTable(
+      20'000, 1, ad_utility::makeAllocatorWithLimit<Id>(300_kB));
+  std::vector<Id> expected(table.getColumn(0).begin(),
+                           table.getColumn(0).end());
+  std::ranges::sort(expected);
+  sortByColumns(table, std::array{ColumnIndex{0}}, 4);
+  EXPECT_THAT(table.getColumn(0), ::testing::ElementsAreArray(expected));
+}
+
+// _____________________________________________________________________________
+TEST(IdTableSorting, cancellation) {
+  struct Cancelled {};
+  auto table = makeRandomTable(250'000, 3);
+  // Run the `sort` with a `checkCancellation` that cancels at its
+  // `numCallsUntilCancelled`-th call (never if it is 0) and return the number
+  // of calls.
+  auto numCalls = [](const auto& sort, size_t numCallsUntilCancelled = 0) {
+    size_t calls = 0;
+    CheckCancellation checkCancellation = [&]() {
+      if (++calls == numCallsUntilCancelled) {
+        throw Cancelled{};
+      }
+    };
+    sort(checkCancellation);
+    return calls;
+  };
+  auto test = [&](const std::vector<ColumnIndex>& sortColumns,
+                  size_t numThreads) {
+    auto expected = sortReference(table, sortColumns);
+    auto sortInPlace = [&](const CheckCancellation& checkCancellation) {
+      IdTable copy = table.clone();
+      sortByColumns(copy, sortColumns, numThreads, checkCancellation);
+      expectSortedCorrectly(copy, expected, sortColumns);
+    };
+    auto sortCopy = [&](const CheckCancellation& checkCancellation) {
+      expectSortedCorrectly(sortedCopyByColumns(table, sortColumns, numThreads,
+                                                checkCancellation),
+                            expected, sortColumns);
+    };
+    for (const auto& sort : {std::function{sortInPlace},
+                             std::function{sortCopy}}) {
+      // The sort is only cancelled between its steps, of which there are
+      // several. It can be cancelled at any of them.
+      size_t numSteps = numCalls(sort);
+      EXPECT_GT(numSteps, 2u);
+      EXPECT_THROW(numCalls(sort, 1), Cancelled);
+      EXPECT_THROW(numCalls(sort, numSteps), Cancelled);
+    }
+  };
+  test({0}, 3);
+  test({0, 1}, 1);
+  test({0, 2, 1}, 3);
+}
+
+// _____________________________________________________________________________
+TEST(IdTableSorting, topKRowIndices) {
+  auto table = makeRandomTable(250'000, 2);
+  // Sort descending by the first column, which has many duplicates.
+  auto comparison = [](const auto& a, const auto& b) { return a[0] > b[0]; };
+  std::vector<size_t> allIndices(table.numRows());
+  std::iota(allIndices.begin(), allIndices.end(), size_t{0});
+  std::ranges::stable_sort(allIndices, [&](size_t a, size_t b) {
+    return comparison(table[a], table[b]);
+  });
+  for (size_t k : {0, 1, 7, 5'000, 250'000, 300'000}) {
+    auto expected = std::vector(
+        allIndices.begin(),
+        allIndices.begin() + std::min(k, allIndices.size()));
+    for (size_t numThreads : {1, 3}) {
+      EXPECT_EQ(topKRowIndices(table, k, comparison, numThreads), expected);
+    }
+  }
+  EXPECT_TRUE(topKRowIndices(IdTable{2, makeAllocator()}, 5, comparison, 2)
+                  .empty());
+}
@@ -365,8 +365,15 @@ TEST(IdTable, insertAtEnd) {
     for (size_t i = 0; i < t1.size(); i++) {
       ASSERT_EQ(t1[i], t2[i + init.size()]);
     }
+
+    // Inserting a complete table has the same effect.
+    Table t3 = clone(init, std::move(additionalArgs.at(3))...);
+    t3.insertAtEnd(t1);
+    ASSERT_TRUE(t2 == t3);
+    Table t4{3, std::move(additionalArgs.at(4))...};
+    ASSERT_ANY_THROW(t3.insertAtEnd(t4));
   };
-  runTestForDifferentTypes<3>(runTestForIdTable, "idTableTest.insertAtEnd");
+  runTestForDifferentTypes<5>(runTestForIdTable, "idTableTest.insertAtEnd");
 }
 
 TEST(IdTable, reserve_and_resize) {
@@ -974,6 +981,27 @@ TEST(IdTable, setColumnSubset) {
   ASSERT_ANY_THROW(t.setColumnSubset(std::vector<ColumnIndex>{1, 2}));
 }
 
+TEST(IdTable, addColumn) {
+  using IntTable = columnBasedIdTable::IdTable<int, 0>;
+  IntTable t{2};
+  t.push_back({0, 10});
+  t.push_back({1, 11});
+  const int* firstColumn = t.getColumn(0).data();
+  t.addColumn(42);
+  ASSERT_EQ(3, t.numColumns());
+  ASSERT_EQ(2, t.numRows());
+  ASSERT_THAT(t.getColumn(2), ::testing::ElementsAre(42, 42));
+  // The existing columns are not copied.
+  ASSERT_EQ(firstColumn, t.getColumn(0).data());
+  t.push_back({2, 12, 22});
+  ASSERT_THAT(t.getColumn(2), ::testing::ElementsAre(42, 42, 22));
+
+  IntTable empty{0};
+  empty.addColumn(3);
+  ASSERT_EQ(1, empty.numColumns());
+  ASSERT_EQ(0, empty.numRows());
+}
+
 TEST(IdTableStatic, setColumnSubset) {
   using IntTable = columnBasedIdTable::IdTable<int, 3>;
   IntTable t;
@@ -1071,6 +1099,64 @@ TEST(IdTable, shrinkToFit) {
   ASSERT_EQ(memory.ptr().get()->wlock()->amountMemoryLeft(), 968_B);
 }
 
+// _____________________________________________________________________________
+TEST(IdTable, cloneSharesColumnsUntilModified) {
+  IdTable table{2, makeAllocator()};
+  table.push_back({V(1), V(11)});
+  table.push_back({V(2), V(12)});
+  const IdTable& constTable = table;
+  const Id* firstColumn = constTable.getColumn(0).data();
+  const Id* secondColumn = constTable.getColumn(1).data();
+
+  // Cloning doesn't copy the columns, and reading them doesn't copy either.
+  IdTable clone = constTable.clone();
+  const IdTable& constClone = clone;
+  ASSERT_EQ(constClone, constTable);
+  ASSERT_EQ(constClone.getColumn(0).data(), firstColumn);
+  ASSERT_EQ(constClone.getColumn(1).data(), secondColumn);
+
+  // Modifying a column of the clone only copies this column, the original
+  // table is not changed.
+  clone(0, 1) = V(42);
+  ASSERT_NE(constClone.getColumn(1).data(), secondColumn);
+  ASSERT_EQ(constClone.getColumn(0).data(), firstColumn);
+  ASSERT_EQ(constTable(0, 1), V(11));
+  ASSERT_EQ(constClone(0, 1), V(42));
+
+  // Adding rows or columns to the clone doesn't change the original table.
+  clone.push_back({V(3), V(13)});
+  clone.addColumn(V(7));
+  ASSERT_EQ(table.numRows(), 2u);
+  ASSERT_EQ(table.numColumns(), 2u);
+  ASSERT_THAT(constTable.getColumn(0), ::testing::ElementsAre(V(1), V(2)));
+  ASSERT_THAT(constClone.getColumn(0),
+              ::testing::ElementsAre(V(1), V(2), V(3)));
+
+  // The elements that remain after shrinking a shared column are copied.
+  IdTable shrunk = constTable.clone();
+  shrunk.resize(1);
+  ASSERT_THAT(std::as_const(shrunk).getColumn(1),
+              ::testing::ElementsAre(V(11)));
+  ASSERT_EQ(table.numRows(), 2u);
+  shrunk.clear();
+  ASSERT_TRUE(shrunk.empty());
+
+  // When the original table is gone, the columns of the clone are no longer
+  // shared and can be modified without copying.
+  IdTable original = constTable.clone();
+  const Id* sharedColumn = std::as_const(original).getColumn(0).data();
+  {
+    IdTable other = std::move(table);
+  }
+  original(0, 0) = V(5);
+  ASSERT_EQ(std::as_const(original).getColumn(0).data(), sharedColumn);
+
+  // A table that was moved from can be used again.
+  table.push_back({V(8), V(9)});
+  ASSERT_THAT(std::as_const(table).getColumn(1), ::testing::ElementsAre(V(9)));
+}
+
+// _____________________________________________________________________________
 TEST(IdTable, staticAsserts) {
   static_assert(std::is_trivially_copyable_v<IdTableStatic<1>::iterator>);
   static_assert(std::is_trivially_copyable_v<IdTableStatic<1>::const_iterator>);
@@ -1082,6 +1168,8 @@ TEST(IdTable, staticAsserts) {
 // type and a different underlying storage.
 
 template class columnBasedIdTable::IdTable<char, 0>;
+template class columnBasedIdTable::IdTable<Id, 0, detail::IdVector>;
+template class columnBasedIdTable::IdTable<Id, 3, detail::IdVector>;
 static_assert(!std::is_copy_constructible_v<ad_utility::BufferedVector<char>>);
 template class columnBasedIdTable::IdTable<char, 0,
                                            ad_utility::BufferedVector<char>>;
@@ -0,0 +1,65 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "index/IndexBuildManifest.h"
+
+namespace {
+const std::string basename = "indexBuildManifestTest";
+const std::string filename =
+    basename + std::string{IndexBuildManifest::FILE_SUFFIX};
+const nlohmann::json key = {{"input-files", {"a.ttl"}}};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(IndexBuildManifest, resume) {
+  {
+    IndexBuildManifest manifest{basename, key, false};
+    EXPECT_FALSE(manifest.isCompleted("permutations"));
+    manifest.markCompleted("permutations");
+    manifest.markCompleted("geo-points");
+    manifest.markCompleted("permutations");
+    EXPECT_TRUE(manifest.isCompleted("permutations"));
+    EXPECT_THAT(manifest.completedStages(),
+                ::testing::ElementsAre("permutations", "geo-points"));
+  }
+  EXPECT_TRUE(std::filesystem::exists(filename));
+
+  // A resumed build with the same key skips the completed stages.
+  {
+    IndexBuildManifest manifest{basename, key, true};
+    EXPECT_THAT(manifest.completedStages(),
+                ::testing::ElementsAre("permutations", "geo-points"));
+    EXPECT_FALSE(manifest.isCompleted("vocabulary-values"));
+  }
+
+  // A build with a different key starts from scratch.
+  {
+    nlohmann::json otherKey = {{"input-files", {"b.ttl"}}};
+    IndexBuildManifest manifest{basename, otherKey, true};
+    EXPECT_TRUE(manifest.completedStages().empty());
+    EXPECT_FALSE(std::filesystem::exists(filename));
+  }
+
+  // A build that is not resumed deletes the manifest.
+  {
+    IndexBuildManifest manifest{basename, key, false};
+    manifest.markCompleted("permutations");
+  }
+  {
+    IndexBuildManifest manifest{basename, key, false};
+    EXPECT_TRUE(manifest.completedStages().empty());
+    EXPECT_FALSE(std::filesystem::exists(filename));
+    manifest.markCompleted("permutations");
+    manifest.remove();
+    EXPECT_FALSE(std::filesystem::exists(filename));
+  }
+
+  // Without a manifest, a resumed build starts from scratch.
+  IndexBuildManifest manifest{basename, key, true};
+  EXPECT_TRUE(manifest.completedStages().empty());
+}
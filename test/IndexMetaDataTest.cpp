@@ -53,7 +53,7 @@ TEST(IndexMetaDataTest, writeReadTest2Mmap) {
     imd.setup(mmapFilename, ad_utility::CreateTag{});
     imd.add(rmdF);
     imd.add(rmdF2);
-    imd.blockData() = bs;
+    imd.setBlockData(bs);
 
     imd.writeToFile(imdFilename);
   }
@@ -70,8 +70,9 @@ TEST(IndexMetaDataTest, writeReadTest2Mmap) {
     ASSERT_EQ(rmdF, rmdFn);
     ASSERT_EQ(rmdF2, rmdFn2);
 
-    ASSERT_EQ(imd2.blockData(), bs);
+    ASSERT_TRUE(std::ranges::equal(imd2.blockData(), bs));
   }
   ad_utility::deleteFile(imdFilename);
   ad_utility::deleteFile(mmapFilename);
+  ad_utility::deleteFile(mmapFilename + ".blocks");
 }
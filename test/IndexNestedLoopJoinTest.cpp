@@ -0,0 +1,137 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./IndexTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "engine/IndexNestedLoopJoin.h"
+#include "engine/IndexScan.h"
+#include "engine/ValuesForTesting.h"
+#include "global/Constants.h"
+
+using namespace ad_utility::testing;
+
+namespace {
+using Vars = std::vector<std::optional<Variable>>;
+
+// An index in which `<s0>` to `<s9>` have `i` objects `<o0>` ... for the
+// predicate `<p>` and one object for the predicate `<q>`.
+QueryExecutionContext* getTestQec() {
+  std::string turtle;
+  for (size_t i = 0; i < 10; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      absl::StrAppend(&turtle, "<s", i, "> <p> <o", j, "> . ");
+    }
+    absl::StrAppend(&turtle, "<s", i, "> <q> <o", i, "> . ");
+  }
+  return getQec(turtle);
+}
+
+std::shared_ptr<QueryExecutionTree> makeScan(QueryExecutionContext* qec,
+                                             Permutation::Enum permutation,
+                                             std::string predicate) {
+  return ad_utility::makeExecutionTree<IndexScan>(
+      qec, permutation,
+      SparqlTriple{Variable{"?s"}, std::move(predicate), Variable{"?o"}});
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(IndexNestedLoopJoin, computeResult) {
+  auto* qec = getTestQec();
+  auto id = makeGetId(qec->getIndex());
+  // The left input is not sorted and contains a value twice, a value without
+  // a match, and a value that is not a subject at all.
+  IdTable leftTable = makeIdTableFromVector({{id("<s3>"), 1},
+                                             {id("<s0>"), 2},
+                                             {id("<s1>"), 3},
+                                             {id("<o2>"), 4},
+                                             {id("<s3>"), 5}});
+  auto left = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, std::move(leftTable), Vars{Variable{"?s"}, Variable{"?x"}});
+  auto scan = makeScan(qec, Permutation::PSO, "<p>");
+  ASSERT_TRUE(IndexNestedLoopJoin::isApplicable(*left, *scan));
+  IndexNestedLoopJoin join{qec, left, scan};
+  EXPECT_EQ(join.getDescriptor(), "Index nested loop join on ?s");
+  EXPECT_EQ(join.getResultWidth(), 3u);
+  const auto& varColMap = join.getExternallyVisibleVariableColumns();
+  EXPECT_EQ(varColMap.at(Variable{"?s"}).columnIndex_, 0u);
+  EXPECT_EQ(varColMap.at(Variable{"?x"}).columnIndex_, 1u);
+  EXPECT_EQ(varColMap.at(Variable{"?o"}).columnIndex_, 2u);
+
+  auto result = join.computeResultOnlyForTesting();
+  // The rows are in the order of the left input.
+  auto s3 = id("<s3>");
+  auto expected = makeIdTableFromVector({{s3, 1, id("<o0>")},
+                                         {s3, 1, id("<o1>")},
+                                         {s3, 1, id("<o2>")},
+                                         {id("<s1>"), 3, id("<o0>")},
+                                         {s3, 5, id("<o0>")},
+                                         {s3, 5, id("<o1>")},
+                                         {s3, 5, id("<o2>")}});
+  EXPECT_EQ(result.idTable(), expected);
+  EXPECT_EQ(join.runtimeInfo().details_["num-lookups"].get<size_t>(), 4u);
+}
+
+// _____________________________________________________________________________
+TEST(IndexNestedLoopJoin, manyLookupsOnSeveralThreads) {
+  auto* qec = getTestQec();
+  auto id = makeGetId(qec->getIndex());
+  // Many more values than `<s0>` ... `<s9>`, s.t. the lookups are performed on
+  // several threads.
+  IdTable leftTable{1, makeAllocator()};
+  size_t expectedSize = 0;
+  for (size_t i = 0; i < 1'000; ++i) {
+    leftTable.push_back({id(absl::StrCat("<s", i % 10, ">"))});
+    expectedSize += i % 10;
+  }
+  auto left = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, std::move(leftTable), Vars{Variable{"?s"}});
+  IndexNestedLoopJoin join{qec, left, makeScan(qec, Permutation::PSO, "<p>")};
+  EXPECT_EQ(join.computeResultOnlyForTesting().idTable().numRows(),
+            expectedSize);
+}
+
+// _____________________________________________________________________________
+TEST(IndexNestedLoopJoin, isApplicable) {
+  auto* qec = getTestQec();
+  auto id = makeGetId(qec->getIndex());
+  auto makeLeft = [qec, &id](Id value, std::string variable) {
+    return ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, makeIdTableFromVector({{value}}), Vars{Variable{variable}});
+  };
+  auto scanPso = makeScan(qec, Permutation::PSO, "<p>");
+  auto scanPos = makeScan(qec, Permutation::POS, "<p>");
+  EXPECT_TRUE(IndexNestedLoopJoin::isApplicable(*makeLeft(id("<s1>"), "?s"),
+                                                *scanPso));
+  // The join variable is not the first column of the scan.
+  EXPECT_FALSE(IndexNestedLoopJoin::isApplicable(*makeLeft(id("<s1>"), "?s"),
+                                                 *scanPos));
+  // The right input is not an `IndexScan`.
+  EXPECT_FALSE(IndexNestedLoopJoin::isApplicable(
+      *scanPso, *makeLeft(id("<s1>"), "?s")));
+  // The join column of the left input contains UNDEF.
+  EXPECT_FALSE(IndexNestedLoopJoin::isApplicable(
+      *makeLeft(Id::makeUndefined(), "?s"), *scanPso));
+}
+
+// _____________________________________________________________________________
+TEST(IndexNestedLoopJoin, sizeAndCostEstimate) {
+  auto* qec = getTestQec();
+  auto id = makeGetId(qec->getIndex());
+  auto left = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, makeIdTableFromVector({{id("<s4>")}, {id("<s7>")}}),
+      Vars{Variable{"?s"}});
+  IndexNestedLoopJoin join{qec, left, makeScan(qec, Permutation::PSO, "<p>")};
+  // The cost consists mostly of the lookups.
+  EXPECT_GE(join.getCostEstimate(), INDEX_NESTED_LOOP_JOIN_COST_PER_LOOKUP);
+
+  // If the left input is cached, the size estimate is the exact size, which is
+  // computed from the sizes of the lookups.
+  qec->clearCacheUnpinnedOnly();
+  left->getResult();
+  IndexNestedLoopJoin cachedJoin{qec, left,
+                                 makeScan(qec, Permutation::PSO, "<p>")};
+  EXPECT_EQ(cachedJoin.getSizeEstimate(), 11u);
+}
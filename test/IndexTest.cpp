@@ -578,6 +578,10 @@ TEST(IndexTest, getPermutation) {
   EXPECT_EQ(&index.SPO(), &index.getPermutation(SPO));
   EXPECT_EQ(&index.OPS(), &index.getPermutation(OPS));
   EXPECT_EQ(&index.OSP(), &index.getPermutation(OSP));
+  // The SOP and OSP permutations are loaded in the background, accessing them
+  // waits until they are loaded.
+  EXPECT_TRUE(index.getPermutation(SOP).isLoaded_);
+  EXPECT_TRUE(index.getPermutation(OSP).isLoaded_);
 }
 
 TEST(IndexTest, trivialGettersAndSetters) {
@@ -610,3 +614,113 @@ TEST(IndexTest, NewlinesInPrefixCompression) {
   // common structure of the literals.
   EXPECT_THAT(prefixes, Contains(ContainsRegex("\nabc\t\n")));
 }
+
+// _____________________________________________________________________________
+TEST(IndexTest, parallelPermutations) {
+  std::string turtle =
+      "<a> <p> <b> . <a> <p> <c> . <b> <q> <a> . <c> <p> <a> . <b> <p> \"x\" . "
+      "<c> <q> <b> . <d> <r> <a> . <a> <r> 42 .";
+  // Build the index with all permutations, but without patterns, and return
+  // the contents of its permutation files.
+  auto buildIndex = [&turtle](const std::string& basename, bool parallel) {
+    std::string inputFilename = basename + ".ttl";
+    {
+      std::ofstream f(inputFilename);
+      f << turtle;
+    }
+    {
+      Index index = makeIndexWithTestSettings();
+      index.blocksizePermutationsPerColumn() = 16_B;
+      index.setOnDiskBase(basename);
+      index.usePatterns() = false;
+      index.loadAllPermutations() = true;
+      index.getImpl().parallelPermutations() = parallel;
+      index.createFromFile(inputFilename);
+    }
+    std::vector<std::string> contents;
+    for (const std::string& permutation :
+         {"pso", "pos", "spo", "sop", "osp", "ops"}) {
+      std::ifstream f(absl::StrCat(basename, ".index.", permutation));
+      contents.emplace_back(std::istreambuf_iterator<char>{f},
+                            std::istreambuf_iterator<char>{});
+      EXPECT_FALSE(contents.back().empty());
+    }
+    for (const auto& filename : getAllIndexFilenames(basename)) {
+      ad_utility::deleteFile(filename, false);
+    }
+    return contents;
+  };
+  // The parallel creation of the permutations yields the same files.
+  EXPECT_EQ(buildIndex("parallelPermutationsTest", true),
+            buildIndex("sequentialPermutationsTest", false));
+}
+
+// _____________________________________________________________________________
+TEST(IndexTest, inMemoryBuild) {
+  std::string turtle =
+      "<a> <p> <b> . <a> <p> <c> . <b> <q> <a> . <c> <p> <a> . <b> <p> \"x\" . "
+      "<c> <q> <b> . <d> <r> <a> . <a> <r> 42 . <d> <p> \"y\"@en .";
+  // Build the index with all permutations and patterns, and return the
+  // contents of its permutation files.
+  auto buildIndex = [&turtle](const std::string& basename, bool inMemory) {
+    std::string inputFilename = basename + ".ttl";
+    {
+      std::ofstream f(inputFilename);
+      f << turtle;
+    }
+    {
+      Index index = makeIndexWithTestSettings();
+      index.blocksizePermutationsPerColumn() = 16_B;
+      index.setOnDiskBase(basename);
+      index.usePatterns() = true;
+      index.loadAllPermutations() = true;
+      index.inMemoryBuildIfPossible() = inMemory;
+      index.createFromFile(inputFilename);
+    }
+    std::vector<std::string> contents;
+    for (const std::string& permutation :
+         {"pso", "pos", "spo", "sop", "osp", "ops"}) {
+      std::ifstream f(absl::StrCat(basename, ".index.", permutation));
+      contents.emplace_back(std::istreambuf_iterator<char>{f},
+                            std::istreambuf_iterator<char>{});
+      EXPECT_FALSE(contents.back().empty());
+    }
+    for (const auto& filename : getAllIndexFilenames(basename)) {
+      ad_utility::deleteFile(filename, false);
+    }
+    return contents;
+  };
+  // The index that is built in memory is the same as the one that is built
+  // with the external sorters.
+  EXPECT_EQ(buildIndex("inMemoryBuildTest", true),
+            buildIndex("externalBuildTest", false));
+}
+
+// _____________________________________________________________________________
+TEST(IndexTest, largeRelationsHaveLargerBlocks) {
+  using enum Permutation::Enum;
+  std::string turtle;
+  for (size_t i = 0; i < 1000; ++i) {
+    turtle += absl::StrCat("<s", i, "> <p> <o", i, "> . ");
+  }
+  const IndexImpl& index = getQec(turtle)->getIndex().getImpl();
+  auto maxBlocksize = [&index](Permutation::Enum permutation) {
+    size_t result = 0;
+    for (const auto& block :
+         index.getPermutation(permutation).metaData().blockData()) {
+      result = std::max(result, block.numRows_);
+    }
+    return result;
+  };
+  // The test index has 2 triples per block, but the blocks of the large
+  // relation `<p>` grow in the PSO and POS permutations.
+  EXPECT_GT(maxBlocksize(PSO), 2u);
+  EXPECT_GT(maxBlocksize(POS), 2u);
+  EXPECT_LE(maxBlocksize(SPO), 3u);
+  EXPECT_EQ(index.getPermutation(PSO).metaData().blockData().size(),
+            index.getPermutation(POS).metaData().blockData().size());
+  auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+  std::string p = "<p>";
+  EXPECT_EQ(index.scan(p, std::nullopt, PSO, {}, handle).numRows(), 1000u);
+  EXPECT_EQ(index.scan(p, std::nullopt, POS, {}, handle).numRows(), 1000u);
+}
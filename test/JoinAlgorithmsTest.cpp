@@ -77,6 +77,27 @@ void testJoin(const NestedBlock& a, const NestedBlock& b, JoinResult expected,
   // and depends on implementation details. We therefore do not enforce it here.
   EXPECT_THAT(result, ::testing::UnorderedElementsAreArray(expected));
 
+  // The lazy version of the join has to yield exactly the same result.
+  {
+    JoinResult lazyResult;
+    auto lazyAdder = makeRowAdder(lazyResult);
+    auto lazyJoin = [&]() {
+      if constexpr (DoOptionalJoin) {
+        return zipperJoinForBlocksWithoutUndefLazily(
+            a, b, compare, lazyAdder, std::identity{}, std::identity{},
+            std::true_type{});
+      } else {
+        return zipperJoinForBlocksWithoutUndefLazily(a, b, compare, lazyAdder);
+      }
+    }();
+    size_t numRounds = 0;
+    for ([[maybe_unused]] RowAdder& adder : lazyJoin) {
+      ++numRounds;
+    }
+    EXPECT_GT(numRounds, 0u);
+    EXPECT_EQ(lazyResult, result);
+  }
+
   if constexpr (DoOptionalJoin) {
     return;
   }
@@ -195,3 +216,95 @@ TEST(JoinAlgorithms, JoinWithBlocksMultipleBlocksPerElementBothSides) {
   // the optional join stays the same.
   testOptionalJoin(a, b, expectedResult);
 }
+
+// ________________________________________________________________________________________
+TEST(JoinAlgorithms, getPartitionBoundariesForParallelJoin) {
+  std::vector<size_t> a{1, 1, 1, 1, 1, 1, 2, 3, 4, 5};
+  std::vector<size_t> b{0, 1, 3, 3, 6};
+  using B = std::vector<std::array<size_t, 2>>;
+  auto partition = [&](size_t numPartitions) {
+    return getPartitionBoundariesForParallelJoin(a, b, std::less<>{},
+                                                 numPartitions);
+  };
+  EXPECT_THAT(partition(1), ::testing::ElementsAreArray(B{{0, 0}, {10, 5}}));
+  EXPECT_THAT(partition(2),
+              ::testing::ElementsAreArray(B{{0, 0}, {0, 1}, {10, 5}}));
+  // The first two split points are both `1`, so there are fewer partitions
+  // than requested.
+  EXPECT_THAT(partition(5), ::testing::ElementsAreArray(
+                                B{{0, 0}, {0, 1}, {6, 2}, {8, 4}, {10, 5}}));
+
+  // The split points are sampled from the larger input.
+  EXPECT_THAT(getPartitionBoundariesForParallelJoin(b, a, std::less<>{}, 2),
+              ::testing::ElementsAreArray(B{{0, 0}, {1, 0}, {5, 10}}));
+  EXPECT_ANY_THROW(partition(0));
+
+  std::vector<size_t> empty;
+  EXPECT_THAT(getPartitionBoundariesForParallelJoin(empty, empty,
+                                                    std::less<>{}, 3),
+              ::testing::ElementsAreArray(B{{0, 0}, {0, 0}}));
+}
+
+// ________________________________________________________________________________________
+TEST(JoinAlgorithms, parallelZipperJoinWithoutUndef) {
+  using Pairs = std::vector<std::array<size_t, 2>>;
+  // A minimal row adder that stores the indices of the matching rows. The
+  // indices of optional rows are stored with `U` as the right index.
+  struct Result : Pairs {
+    void insertAtEnd(const Result& other) {
+      insert(end(), other.begin(), other.end());
+    }
+  };
+  struct IndexRowAdder {
+    Result result_;
+    void addRow(size_t left, size_t right) {
+      result_.push_back({left, right});
+    }
+    void addOptionalRow(size_t left) { result_.push_back({left, U}); }
+    Result resultTable() && { return std::move(result_); }
+  };
+  auto makeRowAdder = []() { return IndexRowAdder{}; };
+
+  std::vector<size_t> a;
+  std::vector<size_t> b;
+  for (size_t i = 0; i < 300; ++i) {
+    a.push_back(i / 3);
+    if (i % 4 != 0) {
+      b.push_back(i / 7);
+    }
+  }
+  auto joinSingleThreaded = [&](bool optional) {
+    IndexRowAdder adder;
+    auto addRow = [&](auto itA, auto itB) {
+      adder.addRow(itA - a.begin(), itB - b.begin());
+    };
+    auto addOptionalRow = [&](auto itA) {
+      adder.addOptionalRow(itA - a.begin());
+    };
+    if (optional) {
+      std::ignore = zipperJoinWithUndef(a, b, std::less<>{}, addRow, noop, noop,
+                                        addOptionalRow);
+    } else {
+      std::ignore =
+          zipperJoinWithUndef(a, b, std::less<>{}, addRow, noop, noop);
+    }
+    return std::move(adder).resultTable();
+  };
+  auto expected = joinSingleThreaded(false);
+  auto expectedOptional = joinSingleThreaded(true);
+  ASSERT_FALSE(expected.empty());
+  ASSERT_GT(expectedOptional.size(), expected.size());
+
+  for (size_t numThreads : {1, 2, 3, 4, 16}) {
+    for (size_t minSize : {1, 10, 200, 1000}) {
+      // The result has to be exactly the same, also in its order.
+      EXPECT_EQ(parallelZipperJoinWithoutUndef(a, b, std::less<>{}, numThreads,
+                                               makeRowAdder, minSize),
+                expected);
+      EXPECT_EQ(parallelZipperJoinWithoutUndef(a, b, std::less<>{}, numThreads,
+                                               makeRowAdder, minSize,
+                                               std::true_type{}),
+                expectedOptional);
+    }
+  }
+}
@@ -202,6 +202,24 @@ std::vector<JoinTestCase> createJoinTestSet() {
                    IdTableAndJoinColumn{makeIdTableFromVector(rightIdTable), 0},
                    makeIdTableFromVector(expectedResult), true});
 
+  // Inputs that are large enough s.t. the hash join uses several threads.
+  leftIdTable = {};
+  rightIdTable = {};
+  expectedResult = {};
+  for (int64_t i = 0; i < 150'000; ++i) {
+    leftIdTable.push_back({i, i % 7});
+    if (i % 3 == 0) {
+      rightIdTable.push_back({i, 1});
+      rightIdTable.push_back({i, 2});
+      expectedResult.push_back({i, i % 7, 1});
+      expectedResult.push_back({i, i % 7, 2});
+    }
+  }
+  myTestSet.push_back(
+      JoinTestCase{IdTableAndJoinColumn{makeIdTableFromVector(leftIdTable), 0},
+                   IdTableAndJoinColumn{makeIdTableFromVector(rightIdTable), 0},
+                   makeIdTableFromVector(expectedResult), true});
+
   return myTestSet;
 }
 }  // namespace
@@ -435,6 +453,108 @@ TEST(JoinTest, joinTwoScans) {
   test(1'000'000);
 }
 
+TEST(JoinTest, semiJoinReduction) {
+  auto qec = ad_utility::testing::getQec(
+      "<x> <p> 1. <x2> <p> 2. <x3> <p> 3. <x> <p2> 4. ");
+  auto materializationThreshold =
+      RuntimeParameters().get<"lazy-index-scan-max-size-materialization">();
+  // Only the VALUES clause is small enough to be computed before the join.
+  RuntimeParameters().set<"lazy-index-scan-max-size-materialization">(2);
+  auto test = [&](size_t maxSizeForReduction, bool expectReduction) {
+    RuntimeParameters().set<"semi-join-reduction-max-size">(
+        maxSizeForReduction);
+    qec->getQueryTreeCache().clearAll();
+    // The scan is sorted by `?o`, so it is sorted by `?s` for the join.
+    auto scan = ad_utility::makeExecutionTree<IndexScan>(
+        qec, POS, SparqlTriple{Var{"?s"}, "<p>", Var{"?o"}});
+    auto valuesTree = makeValuesForSingleVariable(qec, "?s", {"<x>"});
+    auto join = Join{qec, valuesTree, scan, 0, 1};
+    auto id = ad_utility::testing::makeGetId(qec->getIndex());
+    auto expected = makeIdTableFromVector({{I(1), id("<x>")}});
+    VariableToColumnMap expectedVariables{
+        {Variable{"?o"}, makeAlwaysDefinedColumn(0)},
+        {Variable{"?s"}, makeAlwaysDefinedColumn(1)}};
+    testJoinOperation(join, makeExpectedColumns(expectedVariables, expected));
+
+    // The sort (and the scan below it) only computed the rows with `?s = <x>`.
+    auto sort = join.getChildren().at(0)->getRootOperation();
+    ASSERT_EQ(sort->getDescriptor(), "Sort (internal order) on ?s");
+    EXPECT_EQ(sort->runtimeInfo().details_.contains("semi-join-filter-size"),
+              expectReduction);
+    EXPECT_EQ(sort->runtimeInfo().numRows_, expectReduction ? 1u : 3u);
+  };
+  test(100'000, true);
+  test(0, false);
+  RuntimeParameters().set<"semi-join-reduction-max-size">(100'000);
+  RuntimeParameters().set<"lazy-index-scan-max-size-materialization">(
+      materializationThreshold);
+}
+
+TEST(JoinTest, computeResultSize) {
+  auto qec = ad_utility::testing::getQec();
+  auto V = ad_utility::testing::VocabId;
+  auto makeTree = [&](const VectorTable& table, Vars variables) {
+    return ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, makeIdTableFromVector(table), std::move(variables));
+  };
+  auto left = makeTree({{1, 10}, {1, 11}, {2, 12}, {3, 13}, {5, 14}},
+                       Vars{Variable{"?x"}, Variable{"?y"}});
+  auto right =
+      makeTree({{1}, {2}, {2}, {2}, {4}, {5}, {5}}, Vars{Variable{"?x"}});
+  Join join{qec, left, right, 0, 0};
+  // The value 1 matches 2 * 1 times, 2 matches 1 * 3 times, 5 matches 1 * 2
+  // times.
+  EXPECT_EQ(join.computeResultSize(), 7u);
+  EXPECT_EQ(join.computeResultSize(), join.getResult()->idTable().numRows());
+
+  // UNDEF values in a join column are not supported.
+  auto rightWithUndef =
+      makeTree({{V(1)}, {Id::makeUndefined()}}, Vars{Variable{"?x"}});
+  Join joinWithUndef{qec, left, rightWithUndef, 0, 0};
+  EXPECT_EQ(joinWithUndef.computeResultSize(), std::nullopt);
+
+  // The counting of the matching ranges of the join columns.
+  auto count = [](std::vector<int64_t> left, std::vector<int64_t> right) {
+    auto toIds = [](const std::vector<int64_t>& values) {
+      std::vector<Id> ids;
+      for (int64_t value : values) {
+        ids.push_back(Id::makeFromInt(value));
+      }
+      return ids;
+    };
+    return Join::countJoinResult(toIds(left), toIds(right));
+  };
+  EXPECT_EQ(count({}, {1, 2}), 0u);
+  EXPECT_EQ(count({1, 3, 5}, {2, 4, 6}), 0u);
+  EXPECT_EQ(count({1, 1, 1}, {1, 1, 1, 1}), 12u);
+  EXPECT_EQ(count({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, {4, 9, 9}), 3u);
+}
+
+TEST(JoinTest, sampledSizeEstimate) {
+  auto qec = ad_utility::testing::getQec(
+      "<a1> <p> <b> . <a2> <p> <b> . <a3> <p> <b> . <a4> <p> <b> . "
+      "<b> <q> <c1> . <b> <q> <c2> . <b> <q> <c3> . <d> <q> <e> .");
+  RuntimeParameters().set<"join-sampling-num-blocks">(100);
+  RuntimeParameters().set<"join-sampling-time-budget">(
+      std::chrono::milliseconds{10'000});
+  // The join of `?x <p> ?y` and `?y <q> ?z` on `?y`. All the blocks of the
+  // (small) index are sampled, so the estimate is exact.
+  auto scanP = ad_utility::makeExecutionTree<IndexScan>(
+      qec, POS, SparqlTriple{Var{"?x"}, "<p>", Var{"?y"}});
+  auto scanQ = ad_utility::makeExecutionTree<IndexScan>(
+      qec, PSO, SparqlTriple{Var{"?y"}, "<q>", Var{"?z"}});
+  Join join{qec, scanP, scanQ, 0, 0};
+  EXPECT_EQ(join.getSizeEstimate(), 12u);
+  EXPECT_EQ(join.computeResultSize(), 12u);
+  // The estimate is cached, also for the other order of the children.
+  Join joinSwitched{qec, scanQ, scanP, 0, 0};
+  EXPECT_EQ(joinSwitched.getSizeEstimate(), 12u);
+
+  RuntimeParameters().set<"join-sampling-num-blocks">(0);
+  RuntimeParameters().set<"join-sampling-time-budget">(
+      std::chrono::milliseconds{10});
+}
+
 TEST(JoinTest, invalidJoinVariable) {
   auto qec = ad_utility::testing::getQec(
       "<x> <p> 1. <x2> <p> 2. <x> <p2> 3 . <x2> <p2> 4. <x3> <p2> 7. ");
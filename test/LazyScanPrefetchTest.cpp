@@ -0,0 +1,102 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include "index/LazyScanPrefetch.h"
+
+using namespace std::chrono_literals;
+using Duration = LazyScanPrefetchController::Duration;
+
+namespace {
+// Let the `controller` read and consume `numBlocks` blocks (one at a time)
+// with the given times.
+void readAndConsumeBlocks(LazyScanPrefetchController& controller,
+                          size_t numBlocks, Duration decompressionTime,
+                          Duration waitTime, Duration consumerTime) {
+  for (size_t i = 0; i < numBlocks; ++i) {
+    ASSERT_TRUE(controller.startBlock());
+    controller.finishBlock(decompressionTime);
+    controller.blockConsumed(waitTime, consumerTime);
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(LazyScanPrefetchController, startsSmallAndGrowsWhileTheConsumerWaits) {
+  std::atomic<size_t> numThreadsOfAllScans = 0;
+  LazyScanPrefetchController controller{10, 20, 100, numThreadsOfAllScans};
+  EXPECT_EQ(controller.numThreads(), 1u);
+  EXPECT_EQ(controller.prefetchDepth(), 2u);
+  EXPECT_EQ(numThreadsOfAllScans, 1u);
+
+  // A fast consumer that waits for slow blocks gets more threads.
+  readAndConsumeBlocks(controller, 2, 4ms, 3ms, 1ms);
+  EXPECT_EQ(controller.numThreads(), 4u);
+  EXPECT_EQ(controller.prefetchDepth(), 8u);
+  readAndConsumeBlocks(controller, 5, 4ms, 3ms, 1ms);
+  EXPECT_EQ(controller.numThreads(), 10u);
+  EXPECT_EQ(controller.prefetchDepth(), 20u);
+  EXPECT_EQ(numThreadsOfAllScans, 10u);
+
+  // When the consumer doesn't wait anymore, the threads are reduced gradually
+  // to the number that is needed to keep up with the consumer.
+  readAndConsumeBlocks(controller, 100, 4ms, 0ms, 1ms);
+  EXPECT_EQ(controller.numThreads(), 4u);
+  EXPECT_EQ(controller.prefetchDepth(), 8u);
+  EXPECT_EQ(controller.maxNumThreadsUsed(), 10u);
+  EXPECT_EQ(controller.maxPrefetchDepthUsed(), 20u);
+  EXPECT_EQ(numThreadsOfAllScans, 4u);
+}
+
+// _____________________________________________________________________________
+TEST(LazyScanPrefetchController, slowConsumerUsesOneThread) {
+  std::atomic<size_t> numThreadsOfAllScans = 0;
+  LazyScanPrefetchController controller{10, 20, 100, numThreadsOfAllScans};
+  readAndConsumeBlocks(controller, 20, 1ms, 0ms, 5ms);
+  EXPECT_EQ(controller.numThreads(), 1u);
+  EXPECT_EQ(controller.prefetchDepth(), 2u);
+}
+
+// _____________________________________________________________________________
+TEST(LazyScanPrefetchController, globalThreadBudget) {
+  std::atomic<size_t> numThreadsOfAllScans = 0;
+  {
+    LazyScanPrefetchController first{10, 20, 6, numThreadsOfAllScans};
+    LazyScanPrefetchController second{10, 20, 6, numThreadsOfAllScans};
+    EXPECT_EQ(numThreadsOfAllScans, 2u);
+    readAndConsumeBlocks(first, 10, 10ms, 5ms, 1ms);
+    EXPECT_EQ(first.numThreads(), 5u);
+    // The budget is used up, but each scan keeps its first thread.
+    readAndConsumeBlocks(second, 10, 10ms, 5ms, 1ms);
+    EXPECT_EQ(second.numThreads(), 1u);
+    EXPECT_EQ(numThreadsOfAllScans, 6u);
+  }
+  EXPECT_EQ(numThreadsOfAllScans, 0u);
+}
+
+// _____________________________________________________________________________
+TEST(LazyScanPrefetchController, prefetchDepthLimitsTheStartedBlocks) {
+  std::atomic<size_t> numThreadsOfAllScans = 0;
+  LazyScanPrefetchController controller{1, 1, 100, numThreadsOfAllScans};
+  EXPECT_EQ(controller.prefetchDepth(), 1u);
+  ASSERT_TRUE(controller.startBlock());
+  controller.finishBlock(1ms);
+  // The next block can only be started after the first one was consumed.
+  auto next = std::async(std::launch::async,
+                         [&controller] { return controller.startBlock(); });
+  EXPECT_EQ(next.wait_for(10ms), std::future_status::timeout);
+  controller.blockConsumed(0ms, 0ms);
+  EXPECT_TRUE(next.get());
+  controller.finishBlock(1ms);
+
+  // After `finish`, no more blocks are started.
+  auto waiting = std::async(std::launch::async,
+                            [&controller] { return controller.startBlock(); });
+  EXPECT_EQ(waiting.wait_for(10ms), std::future_status::timeout);
+  controller.finish();
+  EXPECT_FALSE(waiting.get());
+  EXPECT_FALSE(controller.startBlock());
+}
@@ -0,0 +1,187 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "./util/IdTestHelpers.h"
+#include "util/JoinAlgorithms/LeapfrogTriejoin.h"
+
+using ad_utility::TrieRelation;
+using ad_utility::testing::IntId;
+
+namespace {
+using Edges = std::vector<std::array<int64_t, 2>>;
+using Rows = std::vector<std::vector<Id>>;
+
+// The columns of a relation, which must outlive the `TrieRelation`s.
+struct Columns {
+  std::vector<Id> col0_;
+  std::vector<Id> col1_;
+  explicit Columns(Edges edges) {
+    std::ranges::sort(edges);
+    for (auto [x, y] : edges) {
+      col0_.push_back(IntId(x));
+      col1_.push_back(IntId(y));
+    }
+  }
+  TrieRelation relation(size_t variable0, size_t variable1) const {
+    return {col0_, col1_, {variable0, variable1}};
+  }
+};
+
+// Compute the join of the `relations` via the leapfrog triejoin.
+Rows join(const std::vector<TrieRelation>& relations, size_t numVariables) {
+  Rows result;
+  ad_utility::leapfrogTriejoin(
+      relations, numVariables,
+      [&result](std::span<const Id> row) {
+        result.emplace_back(row.begin(), row.end());
+      },
+      []() {});
+  return result;
+}
+
+// Compute the join of the `relations` by trying all the combinations of the
+// values that occur in the relations (only feasible for small inputs).
+Rows bruteForceJoin(const std::vector<TrieRelation>& relations,
+                    size_t numVariables) {
+  std::vector<Id> values;
+  for (const auto& relation : relations) {
+    std::ranges::copy(relation.col0_, std::back_inserter(values));
+    std::ranges::copy(relation.col1_, std::back_inserter(values));
+  }
+  std::ranges::sort(values);
+  values.erase(std::ranges::unique(values).begin(), values.end());
+  Rows result;
+  std::vector<Id> row(numVariables);
+  auto contains = [](const TrieRelation& relation, Id x, Id y) {
+    for (size_t i = 0; i < relation.col0_.size(); ++i) {
+      if (relation.col0_[i] == x && relation.col1_[i] == y) {
+        return true;
+      }
+    }
+    return false;
+  };
+  auto recurse = [&](size_t variable, const auto& self) -> void {
+    if (variable == numVariables) {
+      if (std::ranges::all_of(relations, [&](const TrieRelation& relation) {
+            return contains(relation, row[relation.variables_[0]],
+                            row[relation.variables_[1]]);
+          })) {
+        result.push_back(row);
+      }
+      return;
+    }
+    for (Id value : values) {
+      row[variable] = value;
+      self(variable + 1, self);
+    }
+  };
+  recurse(0, recurse);
+  return result;
+}
+
+// Return the rows of the given integers.
+Rows rows(const std::vector<std::vector<int64_t>>& input) {
+  Rows result;
+  for (const auto& row : input) {
+    auto& target = result.emplace_back();
+    std::ranges::transform(row, std::back_inserter(target), IntId);
+  }
+  return result;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(LeapfrogTriejoin, triangles) {
+  // The edges of a graph with the triangles 1 -> 2 -> 3 -> 1 and
+  // 3 -> 4 -> 5 -> 3, and some edges that are not part of a triangle.
+  Columns edges{
+      {{1, 2}, {2, 3}, {3, 1}, {3, 4}, {4, 5}, {5, 3}, {1, 4}, {2, 6}}};
+  // The variables `?a` (0), `?b` (1), `?c` (2) of the pattern
+  // `?a <p> ?b . ?b <p> ?c . ?c <p> ?a`. The last triple is read in the
+  // direction from `?a` to `?c`.
+  Columns reversed{
+      {{2, 1}, {3, 2}, {1, 3}, {4, 3}, {5, 4}, {3, 5}, {4, 1}, {6, 2}}};
+  std::vector relations{edges.relation(0, 1), edges.relation(1, 2),
+                        reversed.relation(0, 2)};
+  auto expected = rows({{1, 2, 3},
+                        {2, 3, 1},
+                        {3, 1, 2},
+                        {3, 4, 5},
+                        {4, 5, 3},
+                        {5, 3, 4}});
+  EXPECT_EQ(join(relations, 3), expected);
+  EXPECT_EQ(bruteForceJoin(relations, 3), expected);
+
+  // An empty relation leads to an empty result.
+  Columns empty{{}};
+  relations.push_back(empty.relation(0, 1));
+  EXPECT_TRUE(join(relations, 3).empty());
+}
+
+// _____________________________________________________________________________
+TEST(LeapfrogTriejoin, singleRelationAndDuplicateValues) {
+  Columns edges{{{1, 2}, {1, 3}, {1, 4}, {2, 2}, {5, 1}}};
+  EXPECT_EQ(join({edges.relation(0, 1)}, 2),
+            rows({{1, 2}, {1, 3}, {1, 4}, {2, 2}, {5, 1}}));
+  // The same relation twice, i.e. `?x <p> ?y . ?x <q> ?y` with `p == q`.
+  EXPECT_EQ(join({edges.relation(0, 1), edges.relation(0, 1)}, 2),
+            rows({{1, 2}, {1, 3}, {1, 4}, {2, 2}, {5, 1}}));
+  // The variables must be ordered and bound by a relation.
+  EXPECT_ANY_THROW(join({edges.relation(1, 0)}, 2));
+  EXPECT_ANY_THROW(join({edges.relation(0, 2)}, 3));
+  EXPECT_TRUE(join({}, 0).empty());
+}
+
+// _____________________________________________________________________________
+TEST(LeapfrogTriejoin, randomCyclesAndCliques) {
+  std::mt19937 generator{42};
+  for (size_t round = 0; round < 20; ++round) {
+    std::uniform_int_distribution<int64_t> nodes{0, 6};
+    auto randomEdges = [&]() {
+      Edges edges;
+      for (size_t i = 0; i < 25; ++i) {
+        edges.push_back({nodes(generator), nodes(generator)});
+      }
+      std::ranges::sort(edges);
+      edges.erase(std::ranges::unique(edges).begin(), edges.end());
+      return Columns{edges};
+    };
+    std::vector<Columns> columns;
+    for (size_t i = 0; i < 6; ++i) {
+      columns.push_back(randomEdges());
+    }
+    // A cycle of length four.
+    std::vector cycle{columns[0].relation(0, 1), columns[1].relation(1, 2),
+                      columns[2].relation(2, 3), columns[3].relation(0, 3)};
+    EXPECT_EQ(join(cycle, 4), bruteForceJoin(cycle, 4));
+    // A clique with four variables.
+    std::vector clique{columns[0].relation(0, 1), columns[1].relation(0, 2),
+                       columns[2].relation(0, 3), columns[3].relation(1, 2),
+                       columns[4].relation(1, 3), columns[5].relation(2, 3)};
+    EXPECT_EQ(join(clique, 4), bruteForceJoin(clique, 4));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(LeapfrogTriejoin, cancellation) {
+  // A large result (the Cartesian product of two stars via a common center)
+  // regularly calls the cancellation check.
+  Edges star;
+  for (int64_t i = 0; i < 200; ++i) {
+    star.push_back({0, i});
+  }
+  Columns edges{star};
+  size_t numChecks = 0;
+  size_t numRows = 0;
+  ad_utility::leapfrogTriejoin(
+      std::vector{edges.relation(0, 1), edges.relation(0, 2)}, 3,
+      [&numRows](std::span<const Id>) { ++numRows; },
+      [&numChecks]() { ++numChecks; });
+  EXPECT_EQ(numRows, 200 * 200);
+  EXPECT_GT(numChecks, 0);
+}
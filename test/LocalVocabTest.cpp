@@ -115,24 +115,96 @@ TEST(LocalVocab, clone) {
   }
   ASSERT_EQ(localVocabOriginal.size(), localVocabSize);
 
-  // Clone it and test that the clone contains the same words, but under
-  // different addresses (that is, the word strings were deeply copied).
+  // Clone it and test that the clone contains the same words under the same
+  // addresses (that is, the words are shared and not copied).
   LocalVocab localVocabClone = localVocabOriginal.clone();
   ASSERT_EQ(localVocabOriginal.size(), localVocabSize);
   ASSERT_EQ(localVocabClone.size(), localVocabSize);
   for (size_t i = 0; i < localVocabSize; ++i) {
     LocalVocabIndex idx = LocalVocabIndex::make(i);
-    const std::string& wordFromOriginal = localVocabOriginal.getWord(idx);
-    const std::string& wordFromClone = localVocabClone.getWord(idx);
+    std::string_view wordFromOriginal = localVocabOriginal.getWord(idx);
+    std::string_view wordFromClone = localVocabClone.getWord(idx);
     ASSERT_EQ(wordFromOriginal, wordFromClone);
-    ASSERT_NE(&wordFromOriginal, &wordFromClone);
+    ASSERT_EQ(wordFromOriginal.data(), wordFromClone.data());
   }
 
-  // Check that `nextFreeIndex_` of the clone is OK by adding another word to
-  // the clone.
+  // Check that the next free index of the clone is OK by adding another word
+  // to the clone.
   localVocabClone.getIndexAndAddIfNotContained("blubb");
   ASSERT_EQ(localVocabClone.getIndexAndAddIfNotContained("blubb"),
             LocalVocabIndex::make(localVocabSize));
+  // The original and the clone are independent of each other.
+  ASSERT_EQ(localVocabOriginal.getIndexOrNullopt("blubb"), std::nullopt);
+  ASSERT_EQ(localVocabOriginal.getIndexAndAddIfNotContained("blabb"),
+            LocalVocabIndex::make(localVocabSize));
+  ASSERT_EQ(localVocabClone.getIndexOrNullopt("blabb"), std::nullopt);
+
+  // The words of the clone remain valid after the original is destroyed.
+  std::string expectedFirstWord{
+      localVocabClone.getWord(LocalVocabIndex::make(0))};
+  localVocabOriginal = LocalVocab{};
+  ASSERT_EQ(localVocabClone.getWord(LocalVocabIndex::make(0)),
+            expectedFirstWord);
+}
+
+// _____________________________________________________________________________
+TEST(LocalVocab, mergeWith) {
+  LocalVocab target;
+  target.getIndexAndAddIfNotContained("a");
+  target.getIndexAndAddIfNotContained("b");
+  std::string_view wordInOther;
+  {
+    LocalVocab other;
+    other.getIndexAndAddIfNotContained("c");
+    other.getIndexAndAddIfNotContained("a");
+    other.getIndexAndAddIfNotContained("");
+    wordInOther = other.getWord(LocalVocabIndex::make(0));
+    auto make = &LocalVocabIndex::make;
+    EXPECT_EQ(target.mergeWith(other),
+              (std::vector<LocalVocabIndex>{make(2), make(0), make(3)}));
+  }
+  ASSERT_EQ(target.size(), 4u);
+  EXPECT_EQ(target.getWord(LocalVocabIndex::make(2)), "c");
+  EXPECT_EQ(target.getWord(LocalVocabIndex::make(3)), "");
+  // The word was not copied, and its storage is kept alive by the `target`.
+  EXPECT_EQ(target.getWord(LocalVocabIndex::make(2)).data(),
+            wordInOther.data());
+  EXPECT_EQ(target.getIndexAndAddIfNotContained("d"),
+            LocalVocabIndex::make(4));
+  EXPECT_TRUE(target.mergeWith(LocalVocab{}).empty());
+
+  // Many long words that need several chunks of the arena.
+  LocalVocab large;
+  for (size_t i = 0; i < 1000; ++i) {
+    large.getIndexAndAddIfNotContained(std::string(i, 'x'));
+  }
+  auto indexes = target.mergeWith(large);
+  ASSERT_EQ(indexes.size(), 1000u);
+  for (size_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(target.getWord(indexes[i]), std::string(i, 'x'));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(LocalVocab, getIdForShortAndLongWords) {
+  LocalVocab localVocab;
+  // Short words are inlined into their `Id` and not added.
+  for (std::string_view word : {"", "x", "<short>"}) {
+    Id id = localVocab.getIdAndAddIfNotContained(word);
+    ASSERT_EQ(id.getDatatype(), Datatype::InlineString);
+    EXPECT_EQ(id.getInlineString().view(), word);
+    EXPECT_EQ(localVocab.getIdOrNullopt(word), id);
+  }
+  EXPECT_TRUE(localVocab.empty());
+
+  // Longer words are added to the local vocabulary.
+  EXPECT_EQ(localVocab.getIdOrNullopt("<longer>"), std::nullopt);
+  Id id = localVocab.getIdAndAddIfNotContained("<longer>");
+  ASSERT_EQ(id.getDatatype(), Datatype::LocalVocabIndex);
+  EXPECT_EQ(localVocab.getWord(id.getLocalVocabIndex()), "<longer>");
+  EXPECT_EQ(localVocab.getIdAndAddIfNotContained("<longer>"), id);
+  EXPECT_EQ(localVocab.getIdOrNullopt("<longer>"), id);
+  EXPECT_EQ(localVocab.size(), 1u);
 }
 
 // _____________________________________________________________________________
@@ -184,12 +256,17 @@ TEST(LocalVocab, propagation) {
   // Note 2: For literals, the quotes are part of the name, so if we wanted the
   // literal "x", we would have to write TripleComponent{"\"x\""}. For the
   // purposes of this test, we just want something that's not yet in the index,
-  // so "x" etc. is just fine (and also different from the "<x>" below).
+  // so "<local-x>" etc. is just fine (and also different from the "<x>"
+  // below). The words must be too long to be inlined into their `Id`s.
+  const std::string x = "<local-x>";
+  const std::string y1 = "<local-y1>";
+  const std::string y2 = "<local-y2>";
+  const std::string z = "<local-z>";
   Values values1(testQec, {{Variable{"?x"}, Variable{"?y"}},
-                           {{TripleComponent{"x"}, TripleComponent{"y1"}},
-                            {TripleComponent{"x"}, TripleComponent{"y2"}}}});
+                           {{TripleComponent{x}, TripleComponent{y1}},
+                            {TripleComponent{x}, TripleComponent{y2}}}});
   Values values1copy = values1;
-  checkLocalVocab(values1copy, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(values1copy, std::vector<std::string>{x, y1, y2});
 
   // VALUES operation that uses an existing literal (from the test index).
   Values values2(testQec, {{Variable{"?x"}, Variable{"?y"}},
@@ -200,13 +277,13 @@ TEST(LocalVocab, propagation) {
   // JOIN operation with exactly one non-empty local vocab and with two
   // non-empty local vocabs (the last two arguments are the two join columns).
   Join join1(testQec, qet(values1), qet(values2), 0, 0);
-  checkLocalVocab(join1, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(join1, std::vector<std::string>{x, y1, y2});
   Join join2(testQec, qet(values1), qet(values1), 0, 0);
   checkThrow(join2);
 
   // OPTIONAL JOIN operation with exactly one non-empty local vocab.
   OptionalJoin optJoin1(testQec, qet(values1), qet(values2));
-  checkLocalVocab(optJoin1, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(optJoin1, std::vector<std::string>{x, y1, y2});
 
   // OPTIONAL JOIN operation with two non-empty local vocab.
   OptionalJoin optJoin2(testQec, qet(values1), qet(values1));
@@ -215,23 +292,23 @@ TEST(LocalVocab, propagation) {
   // MULTI-COLUMN JOIN operation with exactly one non-empty local vocab and with
   // two non-empty local vocabs.
   MultiColumnJoin multiJoin1(testQec, qet(values1), qet(values2));
-  checkLocalVocab(multiJoin1, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(multiJoin1, std::vector<std::string>{x, y1, y2});
   MultiColumnJoin multiJoin2(testQec, qet(values1), qet(values1));
   checkThrow(multiJoin2);
 
   // ORDER BY operation (the third argument are the indices of the columns to be
   // sorted, and the sort order; not important for this test).
   OrderBy orderBy(testQec, qet(values1), {{0, true}, {1, true}});
-  checkLocalVocab(orderBy, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(orderBy, std::vector<std::string>{x, y1, y2});
 
   // SORT operation (the third operation is the sort column).
   Sort sort(testQec, qet(values1), {0});
-  checkLocalVocab(sort, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(sort, std::vector<std::string>{x, y1, y2});
 
   // DISTINCT operation (the third argument are the indices of the input columns
   // that are considered for the output; not important for this test).
   Distinct distinct1(testQec, qet(values1), {0, 1});
-  checkLocalVocab(distinct1, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(distinct1, std::vector<std::string>{x, y1, y2});
 
   // GROUP BY operation.
   auto groupConcatExpression =
@@ -250,25 +327,39 @@ TEST(LocalVocab, propagation) {
       testQec, {Variable{"?x"}},
       {Alias{groupConcatExpression("?y", "|"), Variable{"?concat"}}},
       qet(values1));
-  checkLocalVocab(groupBy, std::vector<std::string>{"x", "y1", "y2", "y1|y2"});
+  checkLocalVocab(groupBy, std::vector<std::string>{x, y1, y2, y1 + "|" + y2});
 
   // DISTINCT again, but after something has been added to the local vocabulary
   // (to check that the "y1|y2" added by the GROUP BY does not also appear here,
   // as it did before GroupBy::computeResult copied it's local vocabulary).
   Distinct distinct2(testQec, qet(values1), {0});
-  checkLocalVocab(distinct2, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(distinct2, std::vector<std::string>{x, y1, y2});
 
   // UNION operation with exactly one non-empty local vocab and with two
   // non-empy local vocabs.
   Union union1(testQec, qet(values1), qet(values2));
-  checkLocalVocab(union1, std::vector<std::string>{"x", "y1", "y2"});
-  Union union2(testQec, qet(values1), qet(values1));
-  checkThrow(union2);
+  checkLocalVocab(union1, std::vector<std::string>{x, y1, y2});
+  Values values3(testQec, {{Variable{"?x"}, Variable{"?y"}},
+                           {{TripleComponent{z}, TripleComponent{x}}}});
+  Union union2(testQec, qet(values1), qet(values3));
+  checkLocalVocab(union2, std::vector<std::string>{x, y1, y2, z});
+  // The IDs of the rows from the right operand refer to the merged local
+  // vocabulary.
+  {
+    auto result = union2.getResult();
+    const auto& idTable = result->idTable();
+    ASSERT_EQ(idTable.numRows(), 3u);
+    auto getWord = [&result](Id id) {
+      return result->localVocab().getWord(id.getLocalVocabIndex());
+    };
+    EXPECT_EQ(getWord(idTable(2, 0)), z);
+    EXPECT_EQ(getWord(idTable(2, 1)), x);
+  }
 
   // MINUS operation with exactly one non-empty local vocab and with
   // two non-empty local vocabs.
   Minus minus1(testQec, qet(values1), qet(values2));
-  checkLocalVocab(minus1, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(minus1, std::vector<std::string>{x, y1, y2});
   Minus minus2(testQec, qet(values1), qet(values1));
   checkThrow(minus2);
 
@@ -278,7 +369,7 @@ TEST(LocalVocab, propagation) {
       testQec, qet(values1),
       {std::make_unique<sparqlExpression::VariableExpression>(Variable{"?x"}),
        "Expression ?x"});
-  checkLocalVocab(filter, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(filter, std::vector<std::string>{x, y1, y2});
 
   // BIND operation (the third argument is a `parsedQuery::Bind` object).
   Bind bind(
@@ -286,7 +377,7 @@ TEST(LocalVocab, propagation) {
       {{std::make_unique<sparqlExpression::VariableExpression>(Variable{"?x"}),
         "Expression ?x"},
        Variable{"?z"}});
-  checkLocalVocab(bind, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(bind, std::vector<std::string>{x, y1, y2});
 
   // TRANSITIVE PATH operation.
   //
@@ -296,15 +387,15 @@ TEST(LocalVocab, propagation) {
   TransitivePathSide left(std::nullopt, 0, Variable{"?x"});
   TransitivePathSide right(std::nullopt, 1, Variable{"?y"});
   TransitivePath transitivePath(testQec, qet(values1), left, right, 1, 1);
-  checkLocalVocab(transitivePath, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(transitivePath, std::vector<std::string>{x, y1, y2});
 
   // PATTERN TRICK operations.
   HasPredicateScan hasPredicateScan(testQec, qet(values1), 0, "?z");
-  checkLocalVocab(hasPredicateScan, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(hasPredicateScan, std::vector<std::string>{x, y1, y2});
   CountAvailablePredicates countAvailablePredictes(
       testQec, qet(values1), 0, Variable{"?x"}, Variable{"?y"});
   checkLocalVocab(countAvailablePredictes,
-                  std::vector<std::string>{"x", "y1", "y2"});
+                  std::vector<std::string>{x, y1, y2});
 
   // TEXT operations.
   //
@@ -314,7 +405,7 @@ TEST(LocalVocab, propagation) {
   TextOperationWithFilter text1(
       testQec, "someWord", {Variable{"?x"}, Variable{"?y"}, Variable{"?text"}},
       Variable{"?text"}, qet(values1), 0);
-  checkLocalVocab(text1, std::vector<std::string>{"x", "y1", "y2"});
+  checkLocalVocab(text1, std::vector<std::string>{x, y1, y2});
   TextOperationWithoutFilter text2(testQec, {"someWord"}, {Variable{"?text"}},
                                    Variable{"?text"});
   checkLocalVocab(text2, {});
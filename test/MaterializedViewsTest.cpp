@@ -0,0 +1,60 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "engine/MaterializedViews.h"
+
+using Definitions = MaterializedViews::Definitions;
+
+// _____________________________________________________________________________
+TEST(MaterializedViews, definitionsAreWrittenToTheFile) {
+  std::string file = "materializedViewsTest.definitions.json";
+  std::filesystem::remove(file);
+  MaterializedViews views;
+  views.readFromFile(file);
+  EXPECT_TRUE(views.definitions().empty());
+  EXPECT_FALSE(std::filesystem::exists(file));
+
+  views.add("humans", "SELECT ?x {?x <is-a> <human>}");
+  views.add("birthDates", "SELECT ?x ?d {?x <born> ?d}");
+  // Replace the query of an existing view.
+  views.add("humans", "SELECT ?x {?x <is-a> <person>}");
+  Definitions expected{{"birthDates", "SELECT ?x ?d {?x <born> ?d}"},
+                       {"humans", "SELECT ?x {?x <is-a> <person>}"}};
+  EXPECT_EQ(views.definitions(), expected);
+  EXPECT_EQ(views.getQuery("humans"), "SELECT ?x {?x <is-a> <person>}");
+  EXPECT_EQ(views.getQuery("unknown"), std::nullopt);
+  EXPECT_EQ(views.toJson(), nlohmann::json(expected));
+
+  // The definitions are read again from the file.
+  MaterializedViews reread;
+  reread.readFromFile(file);
+  EXPECT_EQ(reread.definitions(), expected);
+
+  EXPECT_TRUE(reread.remove("humans"));
+  EXPECT_FALSE(reread.remove("humans"));
+  MaterializedViews afterRemove;
+  afterRemove.readFromFile(file);
+  EXPECT_EQ(afterRemove.definitions(),
+            (Definitions{{"birthDates", "SELECT ?x ?d {?x <born> ?d}"}}));
+  std::filesystem::remove(file);
+}
+
+// _____________________________________________________________________________
+TEST(MaterializedViews, withoutFileAndInvalidFile) {
+  // Without a file, the definitions are only kept in memory.
+  MaterializedViews views;
+  views.add("view", "ASK {}");
+  EXPECT_EQ(views.definitions(), (Definitions{{"view", "ASK {}"}}));
+
+  std::string file = "materializedViewsTest.invalid.json";
+  std::ofstream{file} << "this is not JSON";
+  EXPECT_ANY_THROW(views.readFromFile(file));
+  // The previous definitions are kept.
+  EXPECT_EQ(views.definitions(), (Definitions{{"view", "ASK {}"}}));
+  std::filesystem::remove(file);
+}
@@ -0,0 +1,88 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "util/Metrics.h"
+#include "util/jthread.h"
+
+using namespace ad_utility::metrics;
+using ::testing::HasSubstr;
+
+// _____________________________________________________________________________
+TEST(Metrics, counterWithSeveralThreads) {
+  Counter counter;
+  EXPECT_EQ(counter.value(), 0u);
+  {
+    std::vector<ad_utility::JThread> threads;
+    for (size_t i = 0; i < 2 * NUM_SHARDS; ++i) {
+      threads.emplace_back([&counter]() {
+        for (size_t j = 0; j < 1000; ++j) {
+          counter.increment();
+        }
+        counter.increment(5);
+      });
+    }
+  }
+  EXPECT_EQ(counter.value(), 2 * NUM_SHARDS * 1005);
+}
+
+// _____________________________________________________________________________
+TEST(Metrics, histogram) {
+  Histogram histogram{{0.1, 1, 10}};
+  for (double value : {0.05, 0.1, 0.5, 2.0, 100.0}) {
+    histogram.observe(value);
+  }
+  // The upper bounds are inclusive.
+  EXPECT_THAT(histogram.cumulativeCounts(), ::testing::ElementsAre(2, 3, 4, 5));
+  EXPECT_DOUBLE_EQ(histogram.sum(), 102.65);
+  EXPECT_ANY_THROW(Histogram({1, 0}));
+}
+
+// _____________________________________________________________________________
+TEST(Metrics, registryAndPrometheusText) {
+  Registry registry;
+  auto& pso = registry.counter("blocks_total", "The blocks", {{"perm", "PSO"}});
+  auto& pos = registry.counter("blocks_total", "The blocks", {{"perm", "POS"}});
+  EXPECT_NE(&pso, &pos);
+  EXPECT_EQ(&pso,
+            &registry.counter("blocks_total", "The blocks", {{"perm", "PSO"}}));
+  pso.increment(3);
+  auto& latency = registry.histogram("latency_seconds", "The latency", {1, 2},
+                                     {{"outcome", "a\"b"}});
+  latency.observe(1.5);
+  // The same name with a different type or different buckets is an error.
+  EXPECT_ANY_THROW(registry.histogram("blocks_total", "", {1}));
+  EXPECT_ANY_THROW(registry.histogram("latency_seconds", "", {1}));
+
+  using enum Sample::Type;
+  auto text = registry.toPrometheusText(
+      {{"memory_left_bytes", "The memory", Gauge, {}, 42},
+       {"hits_total", "The hits", Counter, {{"cache", "x"}}, 1},
+       {"hits_total", "The hits", Counter, {{"cache", "y"}}, 2}});
+  EXPECT_EQ(text,
+            "# HELP blocks_total The blocks\n"
+            "# TYPE blocks_total counter\n"
+            "blocks_total{perm=\"PSO\"} 3\n"
+            "blocks_total{perm=\"POS\"} 0\n"
+            "# HELP latency_seconds The latency\n"
+            "# TYPE latency_seconds histogram\n"
+            "latency_seconds_bucket{outcome=\"a\\\"b\",le=\"1\"} 0\n"
+            "latency_seconds_bucket{outcome=\"a\\\"b\",le=\"2\"} 1\n"
+            "latency_seconds_bucket{outcome=\"a\\\"b\",le=\"+Inf\"} 1\n"
+            "latency_seconds_sum{outcome=\"a\\\"b\"} 1.5\n"
+            "latency_seconds_count{outcome=\"a\\\"b\"} 1\n"
+            "# HELP hits_total The hits\n"
+            "# TYPE hits_total counter\n"
+            "hits_total{cache=\"x\"} 1\n"
+            "hits_total{cache=\"y\"} 2\n"
+            "# HELP memory_left_bytes The memory\n"
+            "# TYPE memory_left_bytes gauge\n"
+            "memory_left_bytes 42\n");
+  // The samples must not have the name of a registered metric.
+  EXPECT_ANY_THROW(registry.toPrometheusText(
+      {{"blocks_total", "The blocks", Gauge, {}, 42}}));
+  EXPECT_THAT(ad_utility::metrics::registry().toPrometheusText(),
+              ::testing::Not(HasSubstr("blocks_total")));
+}
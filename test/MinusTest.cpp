@@ -7,9 +7,13 @@
 #include <array>
 #include <vector>
 
+#include "./IndexTestHelpers.h"
+#include "./util/IdTableHelpers.h"
 #include "./util/IdTestHelpers.h"
 #include "engine/CallFixedSize.h"
+#include "engine/IndexScan.h"
 #include "engine/Minus.h"
+#include "engine/ValuesForTesting.h"
 #include "util/AllocatorTestHelpers.h"
 
 namespace {
@@ -17,6 +21,21 @@ auto table(size_t cols) {
   return IdTable(cols, ad_utility::testing::makeAllocator());
 }
 auto V = ad_utility::testing::VocabId;
+using Vars = std::vector<std::optional<Variable>>;
+
+// An input for a `Minus` with the `table` (which must be sorted) that is
+// yielded lazily in blocks of size `lazyBlockSize` if laziness is requested.
+std::shared_ptr<QueryExecutionTree> makeInput(
+    IdTable table, Vars variables, std::optional<size_t> lazyBlockSize = {}) {
+  auto tree = ad_utility::makeExecutionTree<ValuesForTesting>(
+      ad_utility::testing::getQec(), std::move(table), std::move(variables));
+  auto& values = dynamic_cast<ValuesForTesting&>(*tree->getRootOperation());
+  values.lazyBlockSize() = lazyBlockSize;
+  for (ColumnIndex i = 0; i < tree->getResultWidth(); ++i) {
+    values.sortedColumns().push_back(i);
+  }
+  return tree;
+}
 }  // namespace
 
 TEST(EngineTest, minusTest) {
@@ -100,3 +119,94 @@ TEST(EngineTest, minusTest) {
 
   ASSERT_EQ(wantedRes[0], vres[0]);
 }
+
+// _____________________________________________________________________________
+TEST(Minus, lazyLeftInput) {
+  VectorTable leftRows;
+  VectorTable expected;
+  for (int64_t i = 0; i < 100; ++i) {
+    leftRows.push_back({100 * i, i % 3});
+    if (i % 3 != 1) {
+      expected.push_back({100 * i, i % 3});
+    }
+  }
+  // Between two rows of the left input, the right input has long runs of rows
+  // without a match, which are skipped by galloping.
+  VectorTable rightRows;
+  for (int64_t i = 0; i < 5'000; ++i) {
+    rightRows.push_back({2 * i, 1});
+  }
+  auto left = makeInput(makeIdTableFromVector(leftRows),
+                        Vars{Variable{"?x"}, Variable{"?y"}}, 7);
+  auto right = makeInput(makeIdTableFromVector(rightRows),
+                         Vars{Variable{"?x"}, Variable{"?y"}});
+  Minus minus{ad_utility::testing::getQec(), left, right};
+
+  auto result = minus.computeResultOnlyForTesting(true);
+  ASSERT_FALSE(result.isFullyMaterialized());
+  IdTable concatenated = table(2);
+  for (const auto& [block, localVocab] : result.idTables()) {
+    EXPECT_FALSE(block.empty());
+    concatenated.insertAtEnd(block);
+  }
+  EXPECT_EQ(concatenated, makeIdTableFromVector(expected));
+
+  auto materialized = minus.computeResultOnlyForTesting(false);
+  EXPECT_EQ(materialized.idTable(), makeIdTableFromVector(expected));
+}
+
+// _____________________________________________________________________________
+TEST(Minus, notExistsWithoutSharedVariables) {
+  using S = Minus::Semantics;
+  auto* qec = ad_utility::testing::getQec();
+  auto left =
+      makeInput(makeIdTableFromVector({{1}, {2}}), Vars{Variable{"?x"}});
+  auto right = makeInput(makeIdTableFromVector({{3}}), Vars{Variable{"?y"}});
+  auto emptyRight = makeInput(table(1), Vars{Variable{"?y"}});
+
+  Minus minus{qec, left, right, S::Minus};
+  EXPECT_EQ(minus.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{1}, {2}}));
+  Minus notExists{qec, left, right, S::NotExists};
+  EXPECT_EQ(notExists.computeResultOnlyForTesting().idTable().numRows(), 0u);
+  EXPECT_NE(minus.getCacheKey(), notExists.getCacheKey());
+  EXPECT_EQ(notExists.getDescriptor(), "Not exists");
+  Minus notExistsEmpty{qec, left, emptyRight, S::NotExists};
+  EXPECT_EQ(notExistsEmpty.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{1}, {2}}));
+
+  // With shared variables, `MINUS` and `NOT EXISTS` are the same.
+  auto sharedRight = makeInput(makeIdTableFromVector({{2}}),
+                               Vars{Variable{"?x"}});
+  Minus sharedNotExists{qec, left, sharedRight, S::NotExists};
+  EXPECT_EQ(sharedNotExists.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{1}}));
+}
+
+// _____________________________________________________________________________
+TEST(Minus, onlyReadsTheMatchingBlocksOfAnIndexScan) {
+  std::string turtle;
+  for (size_t i = 0; i < 50; ++i) {
+    absl::StrAppend(&turtle, "<s", i, "> <p> <o", i, "> . ");
+  }
+  auto* qec = ad_utility::testing::getQec(turtle);
+  auto id = ad_utility::testing::makeGetId(qec->getIndex());
+  std::vector<Id> leftIds{id("<s3>"), id("<o4>")};
+  std::ranges::sort(leftIds);
+  IdTable leftTable = table(1);
+  for (Id leftId : leftIds) {
+    leftTable.push_back({leftId});
+  }
+  auto left = makeInput(std::move(leftTable), Vars{Variable{"?s"}});
+  auto scan = ad_utility::makeExecutionTree<IndexScan>(
+      qec, Permutation::PSO,
+      SparqlTriple{Variable{"?s"}, "<p>", Variable{"?o"}});
+  qec->clearCacheUnpinnedOnly();
+
+  Minus minus{qec, left, scan};
+  auto result = minus.computeResultOnlyForTesting();
+  EXPECT_EQ(result.idTable(), makeIdTableFromVector({{id("<o4>")}}));
+  auto& details = scan->getRootOperation()->runtimeInfo().details_;
+  EXPECT_LT(details["num-blocks-read"].get<size_t>(),
+            details["num-blocks-all"].get<size_t>());
+}
@@ -5,12 +5,14 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <numeric>
 #include <vector>
 
 #include "./util/AllocatorTestHelpers.h"
 #include "./util/IdTableHelpers.h"
 #include "./util/IdTestHelpers.h"
 #include "engine/CallFixedSize.h"
+#include "engine/Engine.h"
 #include "engine/MultiColumnJoin.h"
 
 using ad_utility::testing::makeAllocator;
@@ -70,3 +72,63 @@ TEST(EngineTest, multiColumnJoinTest) {
   ASSERT_EQ(wantedRes[2], vres[2]);
   ASSERT_EQ(wantedRes[3], vres[3]);
 }
+
+// _____________________________________________________________________________
+TEST(EngineTest, hashMultiColumnJoin) {
+  // The hash join yields the same rows as the zipper join of the sorted
+  // inputs, but in no particular order.
+  auto expectSameRows = [](const IdTable& left, const IdTable& right,
+                           const std::vector<std::array<ColumnIndex, 2>>& jcls,
+                           size_t numThreads) {
+    std::vector<ColumnIndex> leftCols;
+    std::vector<ColumnIndex> rightCols;
+    for (auto [leftCol, rightCol] : jcls) {
+      leftCols.push_back(leftCol);
+      rightCols.push_back(rightCol);
+    }
+    IdTable leftSorted = left.clone();
+    IdTable rightSorted = right.clone();
+    Engine::sort(leftSorted, leftCols);
+    Engine::sort(rightSorted, rightCols);
+    size_t width = left.numColumns() + right.numColumns() - jcls.size();
+    IdTable expected(width, makeAllocator());
+    MultiColumnJoin::computeMultiColumnJoin(leftSorted, rightSorted, jcls,
+                                            &expected);
+    IdTable result(width, makeAllocator());
+    MultiColumnJoin::hashMultiColumnJoin(left, right, jcls, &result,
+                                         numThreads);
+    std::vector<ColumnIndex> allCols(width);
+    std::iota(allCols.begin(), allCols.end(), 0);
+    Engine::sort(expected, allCols);
+    Engine::sort(result, allCols);
+    EXPECT_EQ(result, expected);
+  };
+
+  IdTable a = makeIdTableFromVector(
+      {{4, 1, 2}, {2, 1, 3}, {1, 1, 4}, {2, 2, 1}, {1, 3, 1}});
+  IdTable b =
+      makeIdTableFromVector({{3, 3, 1}, {1, 8, 1}, {4, 2, 2}, {1, 1, 3}});
+  std::vector<std::array<ColumnIndex, 2>> jcls{{1, 2}, {2, 1}};
+  expectSameRows(a, b, jcls, 1);
+  expectSameRows(b, a, {{2, 1}, {1, 2}}, 1);
+
+  // UNDEF values in the join columns.
+  auto U = Id::makeUndefined();
+  IdTable withUndef = makeIdTableFromVector(
+      {{V(1), U, V(7)}, {V(2), V(3), V(8)}, {U, U, V(9)}});
+  IdTable withoutUndef =
+      makeIdTableFromVector({{V(1), V(3)}, {V(2), V(3)}, {V(2), V(4)}});
+  expectSameRows(withUndef, withoutUndef, {{0, 0}, {1, 1}}, 1);
+
+  // Large inputs with many duplicates that are joined on several threads.
+  IdTable largeLeft(3, makeAllocator());
+  IdTable largeRight(3, makeAllocator());
+  for (size_t i = 0; i < 200'000; ++i) {
+    largeLeft.push_back({V(i % 101), V(i % 7), V(i)});
+  }
+  for (size_t i = 0; i < 1'000; ++i) {
+    largeRight.push_back({V(i % 7), V(i), V(i % 103)});
+  }
+  expectSameRows(largeLeft, largeRight, {{0, 2}, {1, 0}}, 4);
+  expectSameRows(largeRight, largeLeft, {{2, 0}, {0, 1}}, 4);
+}
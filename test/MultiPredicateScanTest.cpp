@@ -0,0 +1,126 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./IndexTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "engine/MultiPredicateScan.h"
+#include "global/Constants.h"
+
+using namespace ad_utility::testing;
+
+namespace {
+QueryExecutionContext* getTestQec() {
+  return getQec(
+      "<a> <p> <c> . <b> <p> <a> . <a> <q> <b> . <c> <q> <a> . "
+      "<b> <r> <b> . <c> <other> <c> .");
+}
+
+SparqlTriple makeTriple(TripleComponent subject,
+                        const std::vector<std::string>& predicates,
+                        TripleComponent object) {
+  std::vector<PropertyPath> children;
+  for (const auto& predicate : predicates) {
+    children.push_back(PropertyPath::fromIri(predicate));
+  }
+  return {std::move(subject), PropertyPath::makeAlternative(children),
+          std::move(object)};
+}
+
+const Variable x{"?x"};
+const Variable y{"?y"};
+const TripleComponent iriA{std::string{"<a>"}};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(MultiPredicateScan, computeResult) {
+  auto* qec = getTestQec();
+  auto id = makeGetId(qec->getIndex());
+  auto a = id("<a>");
+  auto b = id("<b>");
+  auto c = id("<c>");
+  auto triple = makeTriple(x, {"<p>", "<q>"}, y);
+
+  MultiPredicateScan pso{qec, Permutation::PSO, triple};
+  EXPECT_EQ(pso.getDescriptor(), "MultiPredicateScan ?x <p>|<q> ?y");
+  EXPECT_EQ(pso.getResultWidth(), 2u);
+  EXPECT_EQ(pso.resultSortedOn(), (std::vector<ColumnIndex>{0, 1}));
+  EXPECT_EQ(pso.getSizeEstimate(), 4u);
+  EXPECT_EQ(pso.getChildren().size(), 2u);
+  EXPECT_EQ(pso.getExternallyVisibleVariableColumns().at(x).columnIndex_, 0u);
+  auto result = pso.computeResultOnlyForTesting();
+  EXPECT_EQ(result.idTable(),
+            makeIdTableFromVector({{a, b}, {a, c}, {b, a}, {c, a}}));
+
+  // The POS permutation yields the object in the first column, and a
+  // predicate that doesn't occur in the index has no rows.
+  auto triple3 = makeTriple(x, {"<p>", "<unknown>", "<q>"}, y);
+  MultiPredicateScan pos{qec, Permutation::POS, triple3};
+  EXPECT_EQ(pos.getExternallyVisibleVariableColumns().at(y).columnIndex_, 0u);
+  EXPECT_EQ(pos.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{a, b}, {a, c}, {b, a}, {c, a}}));
+
+  // The predicates are bound to the additional last column.
+  MultiPredicateScan withPredicate{qec, Permutation::PSO, triple,
+                                   Variable{"?pred"}};
+  EXPECT_EQ(withPredicate.getResultWidth(), 3u);
+  auto p = id("<p>");
+  auto q = id("<q>");
+  EXPECT_EQ(withPredicate.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector(
+                {{a, b, q}, {a, c, p}, {b, a, p}, {c, a, q}}));
+  EXPECT_NE(withPredicate.getCacheKey(), pso.getCacheKey());
+
+  // A fixed subject.
+  MultiPredicateScan fixedSubject{qec, Permutation::PSO,
+                                  makeTriple(iriA, {"<p>", "<q>"}, y)};
+  EXPECT_EQ(fixedSubject.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{b}, {c}}));
+}
+
+// _____________________________________________________________________________
+TEST(MultiPredicateScan, parallelMerge) {
+  auto* qec = getTestQec();
+  auto id = makeGetId(qec->getIndex());
+  auto a = id("<a>");
+  auto b = id("<b>");
+  auto c = id("<c>");
+  auto minSize =
+      RuntimeParameters()
+          .get<"multi-predicate-scan-min-size-for-parallel-merge">();
+  RuntimeParameters().set<"multi-predicate-scan-min-size-for-parallel-merge">(
+      0);
+  MultiPredicateScan scan{qec, Permutation::PSO,
+                          makeTriple(x, {"<r>", "<q>", "<p>"}, y)};
+  EXPECT_EQ(scan.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{a, b}, {a, c}, {b, a}, {b, b}, {c, a}}));
+  EXPECT_TRUE(scan.runtimeInfo().details_["parallel-merge"].get<bool>());
+  RuntimeParameters().set<"multi-predicate-scan-min-size-for-parallel-merge">(
+      minSize);
+}
+
+// _____________________________________________________________________________
+TEST(MultiPredicateScan, applicablePermutations) {
+  using enum Permutation::Enum;
+  using P = std::vector<Permutation::Enum>;
+  auto permutations = &MultiPredicateScan::applicablePermutations;
+  EXPECT_EQ(permutations(makeTriple(x, {"<p>", "<q>"}, y)), (P{PSO, POS}));
+  EXPECT_EQ(permutations(makeTriple(iriA, {"<p>", "<q>"}, y)), (P{PSO}));
+  EXPECT_EQ(permutations(makeTriple(x, {"<p>", "<q>"}, iriA)), (P{POS}));
+  // The subject and the object are the same variable.
+  EXPECT_TRUE(permutations(makeTriple(x, {"<p>", "<q>"}, x)).empty());
+  // Not an alternative.
+  EXPECT_TRUE(permutations(makeTriple(x, {"<p>"}, y)).empty());
+  EXPECT_TRUE(
+      permutations(makeTriple(x, {"<p>", HAS_PREDICATE_PREDICATE}, y)).empty());
+  // An alternative of a sequence and an IRI.
+  auto sequence = PropertyPath::makeSequence(
+      {PropertyPath::fromIri("<p>"), PropertyPath::fromIri("<q>")});
+  EXPECT_TRUE(permutations(SparqlTriple{x,
+                                        PropertyPath::makeAlternative(
+                                            {sequence,
+                                             PropertyPath::fromIri("<r>")}),
+                                        y})
+                  .empty());
+}
@@ -0,0 +1,67 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "util/Numa.h"
+
+using namespace ad_utility::numa;
+using ::testing::ElementsAre;
+
+// _____________________________________________________________________________
+TEST(Numa, parseCpuList) {
+  EXPECT_THAT(parseCpuList("0"), ElementsAre(0));
+  EXPECT_THAT(parseCpuList("0-3,8,10-11\n"),
+              ElementsAre(0, 1, 2, 3, 8, 10, 11));
+  EXPECT_THAT(parseCpuList("5,2-3,3"), ElementsAre(2, 3, 5));
+  EXPECT_TRUE(parseCpuList("").empty());
+  EXPECT_TRUE(parseCpuList("\n").empty());
+  for (auto malformed : {"a", "1-", "-1", "1-2-3", "1,,2", "1 2"}) {
+    EXPECT_ANY_THROW(parseCpuList(malformed)) << malformed;
+  }
+}
+
+// _____________________________________________________________________________
+TEST(Numa, getNodes) {
+  auto directory = std::filesystem::temp_directory_path() / "NumaTestNodes";
+  std::filesystem::remove_all(directory);
+  auto addNode = [&directory](std::string name, std::string cpuList) {
+    std::filesystem::create_directories(directory / name);
+    std::ofstream{directory / name / "cpulist"} << cpuList << '\n';
+  };
+  addNode("node1", "4-7");
+  addNode("node0", "0-3");
+  addNode("node2", "");
+  addNode("possible", "0-2");
+  EXPECT_THAT(getNodes(directory),
+              ElementsAre(Node{0, {0, 1, 2, 3}}, Node{1, {4, 5, 6, 7}},
+                          Node{2, {}}));
+
+  // A malformed topology is ignored.
+  addNode("node3", "x");
+  EXPECT_TRUE(getNodes(directory).empty());
+  std::filesystem::remove_all(directory);
+  EXPECT_TRUE(getNodes(directory).empty());
+}
+
+// _____________________________________________________________________________
+TEST(Numa, pinAndInterleave) {
+  EXPECT_FALSE(pinCurrentThreadToCpus({}));
+  // A single node never changes the memory policy.
+  EXPECT_FALSE(
+      (InterleaveMemoryOfCurrentThread{{Node{0, {0}}}}.isActive()));
+  // The machine on which the test runs might have an arbitrary topology, so
+  // only check that the functions can be called for it.
+  for (const auto& node : getNodes()) {
+    if (!node.cpus_.empty()) {
+      pinCurrentThreadToCpus(node.cpus_);
+    }
+  }
+  InterleaveMemoryOfCurrentThread interleave{getNodes()};
+  std::vector<int> memory(1'000'000, 42);
+  EXPECT_EQ(memory.back(), 42);
+}
@@ -0,0 +1,95 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <latch>
+
+#include "util/AllocatorWithLimit.h"
+#include "util/OperationStatistics.h"
+#include "util/jthread.h"
+
+using ad_utility::OperationStatistics;
+using namespace ad_utility::memory_literals;
+
+// _____________________________________________________________________________
+TEST(OperationStatistics, countersAreOnlyUpdatedInAScope) {
+  ASSERT_EQ(OperationStatistics::current(), nullptr);
+  // Without statistics, the updates are no-ops.
+  OperationStatistics::addBytesRead(10);
+  OperationStatistics statistics;
+  {
+    OperationStatistics::Scope scope{&statistics};
+    EXPECT_EQ(OperationStatistics::current(), &statistics);
+    OperationStatistics::addBytesRead(10);
+    OperationStatistics::addBytesRead(5);
+    OperationStatistics::addBlocksRead();
+    OperationStatistics::addBlocksSkipped(3);
+    OperationStatistics::addVocabularyLookups(7);
+    { OperationStatistics::DecompressionTimer timer; }
+  }
+  EXPECT_EQ(OperationStatistics::current(), nullptr);
+  OperationStatistics::addBytesRead(10);
+  EXPECT_EQ(statistics.numBytesRead(), 15u);
+  EXPECT_EQ(statistics.numBlocksRead(), 1u);
+  EXPECT_EQ(statistics.numBlocksSkipped(), 3u);
+  EXPECT_EQ(statistics.numVocabularyLookups(), 7u);
+  EXPECT_EQ(statistics.numThreads(), 1u);
+}
+
+// _____________________________________________________________________________
+TEST(OperationStatistics, nestedScopesAreCountedSeparately) {
+  OperationStatistics outer;
+  OperationStatistics inner;
+  OperationStatistics::Scope outerScope{&outer};
+  OperationStatistics::addBlocksRead();
+  {
+    OperationStatistics::Scope innerScope{&inner};
+    OperationStatistics::addBlocksRead(2);
+  }
+  OperationStatistics::addBlocksRead();
+  EXPECT_EQ(outer.numBlocksRead(), 2u);
+  EXPECT_EQ(inner.numBlocksRead(), 2u);
+}
+
+// _____________________________________________________________________________
+TEST(OperationStatistics, peakMemory) {
+  OperationStatistics statistics;
+  OperationStatistics::Scope scope{&statistics};
+  ad_utility::AllocatorWithLimit<int> allocator{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(1_MB)};
+  int* first = allocator.allocate(100);
+  int* second = allocator.allocate(50);
+  allocator.deallocate(first, 100);
+  int* third = allocator.allocate(20);
+  allocator.deallocate(second, 50);
+  allocator.deallocate(third, 20);
+  EXPECT_EQ(statistics.peakMemory(), 150 * sizeof(int));
+
+  // Memory that was allocated with other statistics doesn't make the current
+  // memory negative.
+  OperationStatistics::addDeallocation(1000);
+  OperationStatistics::addAllocation(8);
+  EXPECT_EQ(statistics.peakMemory(), 150 * sizeof(int));
+}
+
+// _____________________________________________________________________________
+TEST(OperationStatistics, workerThreads) {
+  OperationStatistics statistics;
+  {
+    OperationStatistics::Scope scope{&statistics};
+    auto* current = OperationStatistics::current();
+    // The threads wait for each other, s.t. their ids are all different.
+    std::latch allThreadsStarted{3};
+    std::vector<ad_utility::JThread> threads;
+    for (size_t i = 0; i < 3; ++i) {
+      threads.emplace_back([current, &allThreadsStarted]() {
+        OperationStatistics::Scope workerScope{current};
+        OperationStatistics::addBytesRead(100);
+        allThreadsStarted.arrive_and_wait();
+      });
+    }
+  }
+  EXPECT_EQ(statistics.numBytesRead(), 300u);
+  EXPECT_EQ(statistics.numThreads(), 4u);
+}
@@ -37,9 +37,9 @@ TEST(OperationTest, getResultOnlyCached) {
   auto qec = getQec();
   qec->getQueryTreeCache().clearAll();
   NeutralElementOperation n{qec};
-  // The second `true` means "only read the result if it was cached".
+  // The `ONLY_IF_CACHED` means "only read the result if it was cached".
   // We have just cleared the cache, and so this should return `nullptr`.
-  EXPECT_EQ(n.getResult(true, true), nullptr);
+  EXPECT_EQ(n.getResult(true, ComputationMode::ONLY_IF_CACHED), nullptr);
   EXPECT_EQ(n.runtimeInfo().status_, RuntimeInformation::Status::notStarted);
   // Nothing has been stored in the cache by this call.
   EXPECT_EQ(qec->getQueryTreeCache().numNonPinnedEntries(), 0);
@@ -58,7 +58,7 @@ TEST(OperationTest, getResultOnlyCached) {
   // When we now request to only return the result if it is cached, we should
   // get exactly the same `shared_ptr` as with the previous call.
   NeutralElementOperation n3{qec};
-  EXPECT_EQ(n3.getResult(true, true), result);
+  EXPECT_EQ(n3.getResult(true, ComputationMode::ONLY_IF_CACHED), result);
   EXPECT_EQ(n3.runtimeInfo().cacheStatus_,
             ad_utility::CacheStatus::cachedNotPinned);
 
@@ -67,7 +67,7 @@ TEST(OperationTest, getResultOnlyCached) {
   QueryExecutionContext qecCopy{*qec};
   qecCopy._pinResult = true;
   NeutralElementOperation n4{&qecCopy};
-  EXPECT_EQ(n4.getResult(true, true), result);
+  EXPECT_EQ(n4.getResult(true, ComputationMode::ONLY_IF_CACHED), result);
 
   // The cache status is `cachedNotPinned` because we found the element cached
   // but not pinned (it does reflect the status BEFORE the operation).
@@ -79,7 +79,7 @@ TEST(OperationTest, getResultOnlyCached) {
   // We have pinned the result, so requesting it again should return a pinned
   // result.
   qecCopy._pinResult = false;
-  EXPECT_EQ(n4.getResult(true, true), result);
+  EXPECT_EQ(n4.getResult(true, ComputationMode::ONLY_IF_CACHED), result);
   EXPECT_EQ(n4.runtimeInfo().cacheStatus_,
             ad_utility::CacheStatus::cachedPinned);
 
@@ -88,6 +88,48 @@ TEST(OperationTest, getResultOnlyCached) {
   qec->getQueryTreeCache().clearAll();
 }
 
+// _____________________________________________________________________________
+TEST(OperationTest, cacheModeOfQueryHints) {
+  auto qec = getQec();
+  auto& cache = qec->getQueryTreeCache();
+  cache.clearAll();
+  QueryExecutionContext qecWithHints{*qec};
+  QueryHints hints;
+
+  // With `NoStore`, a result that is not cached is computed without storing
+  // it in the cache.
+  hints.cacheMode_ = QueryHints::CacheMode::NoStore;
+  qecWithHints.setQueryHints(hints);
+  NeutralElementOperation n1{&qecWithHints};
+  EXPECT_NE(n1.getResult(true), nullptr);
+  EXPECT_EQ(n1.runtimeInfo().cacheStatus_, ad_utility::CacheStatus::computed);
+  EXPECT_EQ(cache.numNonPinnedEntries(), 0);
+  EXPECT_EQ(n1.getResult(true, ComputationMode::ONLY_IF_CACHED), nullptr);
+
+  // A cached result is read with `NoStore`, but not with `Bypass`.
+  NeutralElementOperation n2{qec};
+  auto cached = n2.getResult();
+  EXPECT_EQ(cache.numNonPinnedEntries(), 1);
+  NeutralElementOperation n3{&qecWithHints};
+  EXPECT_EQ(n3.getResult(true), cached);
+  EXPECT_EQ(n3.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::cachedNotPinned);
+  hints.cacheMode_ = QueryHints::CacheMode::Bypass;
+  qecWithHints.setQueryHints(hints);
+  NeutralElementOperation n4{&qecWithHints};
+  EXPECT_NE(n4.getResult(true), cached);
+  EXPECT_EQ(n4.runtimeInfo().cacheStatus_, ad_utility::CacheStatus::computed);
+  EXPECT_EQ(n4.getResult(true, ComputationMode::ONLY_IF_CACHED), nullptr);
+
+  // Results are not pinned either.
+  cache.clearAll();
+  qecWithHints._pinResult = true;
+  NeutralElementOperation n5{&qecWithHints};
+  EXPECT_NE(n5.getResult(true), nullptr);
+  EXPECT_EQ(cache.numPinnedEntries(), 0);
+  EXPECT_EQ(cache.numNonPinnedEntries(), 0);
+}
+
 // _____________________________________________________________________________
 
 /// Fixture to work with a generic operation
@@ -103,6 +145,16 @@ class OperationTestFixture : public testing::Test {
       [&](std::string json) { jsonHistory.emplace_back(std::move(json)); }};
   IdTable table = makeIdTableFromVector({{}, {}, {}});
   ValuesForTesting operation{&qec, std::move(table), {}};
+
+  // Record every update, the rate limiting is tested separately.
+  std::chrono::milliseconds updateIntervalBefore =
+      RuntimeParameters().get<"websocket-update-interval">();
+  OperationTestFixture() {
+    RuntimeParameters().set<"websocket-update-interval">(0ms);
+  }
+  ~OperationTestFixture() override {
+    RuntimeParameters().set<"websocket-update-interval">(updateIntervalBefore);
+  }
 };
 
 // _____________________________________________________________________________
@@ -141,6 +193,22 @@ TEST_F(OperationTestFixture, verifyCachePreventsInProgressState) {
 
 // _____________________________________________________________________________
 
+TEST_F(OperationTestFixture, updatesAreRateLimited) {
+  RuntimeParameters().set<"websocket-update-interval">(1h);
+  operation.getResult(true);
+
+  // The update that the computation is in progress follows the first update
+  // too soon and is dropped, but the final updates are always sent.
+  EXPECT_THAT(
+      jsonHistory,
+      ElementsAre(
+          ParsedAsJson(HasKeyMatching("status", Eq("not started"))),
+          ParsedAsJson(HasKeyMatching("status", Eq("fully materialized"))),
+          ParsedAsJson(HasKeyMatching("status", Eq("fully materialized")))));
+}
+
+// _____________________________________________________________________________
+
 TEST(OperationTest, verifyExceptionIsThrownOnCancellation) {
   auto qec = getQec();
   auto handle = std::make_shared<CancellationHandle<>>();
@@ -153,7 +221,7 @@ TEST(OperationTest, verifyExceptionIsThrownOnCancellation) {
     handle->cancel(CancellationState::TIMEOUT);
   }};
   AD_EXPECT_THROW_WITH_MESSAGE_AND_TYPE(
-      operation.computeResult(),
+      operation.computeResult(false),
       ::testing::HasSubstr("Cancelled due to timeout"),
       ad_utility::AbortException);
 }
@@ -212,3 +280,191 @@ TEST(OperationTest, estimatesForCachedResults) {
     EXPECT_EQ(qet->getCostEstimate(), 0u);
   }
 }
+
+// _____________________________________________________________________________
+TEST(OperationTest, limitIsAppliedToCachedUnlimitedResult) {
+  auto qec = getQec();
+  qec->getQueryTreeCache().clearAll();
+  auto makeOperation = [qec]() {
+    return ValuesForTesting{
+        qec, makeIdTableFromVector({{1}, {2}, {3}, {4}, {5}}),
+        std::vector<std::optional<Variable>>{Variable{"?x"}}};
+  };
+  auto unlimited = makeOperation();
+  [[maybe_unused]] auto full = unlimited.getResult();
+  EXPECT_EQ(qec->getQueryTreeCache().numNonPinnedEntries(), 1);
+
+  // The result with a LIMIT and OFFSET is obtained from the cached unlimited
+  // result without computing the operation again.
+  auto limited = makeOperation();
+  LimitOffsetClause limit;
+  limit._limit = 2;
+  limit._offset = 1;
+  limited.setLimit(limit);
+  auto result = limited.getResult(false, ComputationMode::LAZY_IF_SUPPORTED);
+  ASSERT_TRUE(result->isFullyMaterialized());
+  EXPECT_EQ(result->idTable(), makeIdTableFromVector({{2}, {3}}));
+  EXPECT_EQ(limited.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::cachedNotPinned);
+  EXPECT_EQ(limited.runtimeInfo().numRows_, 2u);
+  // The limited result is also stored in the cache.
+  EXPECT_EQ(qec->getQueryTreeCache().numNonPinnedEntries(), 2);
+  EXPECT_TRUE(qec->getQueryTreeCache().cacheContains(limited.getCacheKey()));
+
+  // An operation with an OFFSET beyond the end yields an empty result.
+  auto beyondTheEnd = makeOperation();
+  limit._offset = 17;
+  beyondTheEnd.setLimit(limit);
+  EXPECT_EQ(beyondTheEnd.getResult()->idTable().numRows(), 0u);
+}
+
+// _____________________________________________________________________________
+TEST(OperationTest, lazyResultsAreNotCachedAndRespectTheLimit) {
+  auto qec = getQec();
+  qec->getQueryTreeCache().clearAll();
+  RuntimeParameters().set<"cache-lazy-results">(false);
+  auto makeOperation = [qec]() {
+    ValuesForTesting op{
+        qec, makeIdTableFromVector({{1}, {2}, {3}, {4}, {5}}),
+        std::vector<std::optional<Variable>>{Variable{"?x"}}};
+    op.lazyBlockSize() = 2;
+    LimitOffsetClause limit;
+    limit._limit = 3;
+    limit._offset = 1;
+    op.setLimit(limit);
+    return op;
+  };
+
+  auto op = makeOperation();
+  auto result = op.getResult(false, ComputationMode::LAZY_IF_SUPPORTED);
+  ASSERT_FALSE(result->isFullyMaterialized());
+  EXPECT_EQ(op.runtimeInfo().status_,
+            RuntimeInformation::Status::lazilyMaterialized);
+  // Lazy results are never stored in the cache.
+  EXPECT_EQ(qec->getQueryTreeCache().numNonPinnedEntries(), 0);
+  EXPECT_EQ(qec->getQueryTreeCache().numPinnedEntries(), 0);
+
+  IdTable aggregated{1, makeAllocator()};
+  size_t numBlocks = 0;
+  for (const auto& [block, localVocab] : result->idTables()) {
+    aggregated.insertAtEnd(block.begin(), block.end());
+    ++numBlocks;
+  }
+  EXPECT_EQ(aggregated, makeIdTableFromVector({{2}, {3}, {4}}));
+  EXPECT_EQ(numBlocks, 2u);
+  EXPECT_EQ(op.runtimeInfo().numRows_, 3u);
+  EXPECT_EQ(op.runtimeInfo().details_["num-blocks-of-lazy-result"], 2);
+
+  // When no laziness is requested, the same operation yields a fully
+  // materialized result which is then also cached.
+  auto op2 = makeOperation();
+  auto materialized = op2.getResult();
+  ASSERT_TRUE(materialized->isFullyMaterialized());
+  EXPECT_EQ(materialized->idTable(), makeIdTableFromVector({{2}, {3}, {4}}));
+  EXPECT_EQ(qec->getQueryTreeCache().numNonPinnedEntries(), 1);
+  // Only the blocks up to the LIMIT of the lazy result were materialized.
+  EXPECT_TRUE(
+      op2.runtimeInfo().details_.contains("materialized-lazily-up-to-limit"));
+
+  // Now that the result is cached, the cached (materialized) result is returned
+  // even if laziness is requested.
+  auto op3 = makeOperation();
+  auto cached = op3.getResult(false, ComputationMode::LAZY_IF_SUPPORTED);
+  EXPECT_EQ(cached, materialized);
+  RuntimeParameters().set<"cache-lazy-results">(true);
+}
+
+// _____________________________________________________________________________
+TEST(OperationTest, lazyResultsAreCachedWhenConsumedCompletely) {
+  auto qec = getQec();
+  qec->getQueryTreeCache().clearAll();
+  auto makeOperation = [qec]() {
+    ValuesForTesting op{
+        qec, makeIdTableFromVector({{1}, {2}, {3}, {4}, {5}}),
+        std::vector<std::optional<Variable>>{Variable{"?x"}}};
+    op.lazyBlockSize() = 2;
+    return op;
+  };
+  auto& cache = qec->getQueryTreeCache();
+
+  // A lazy result that is not consumed completely is not cached.
+  {
+    auto op = makeOperation();
+    auto result = op.getResult(false, ComputationMode::LAZY_IF_SUPPORTED);
+    ASSERT_FALSE(result->isFullyMaterialized());
+    auto& generator = result->idTables();
+    ASSERT_NE(generator.begin(), generator.end());
+  }
+  EXPECT_EQ(cache.numNonPinnedEntries(), 0);
+
+  // A lazy result that is consumed completely is cached.
+  auto op = makeOperation();
+  auto result = op.getResult(false, ComputationMode::LAZY_IF_SUPPORTED);
+  ASSERT_FALSE(result->isFullyMaterialized());
+  size_t numRows = 0;
+  for (const auto& [block, localVocab] : result->idTables()) {
+    EXPECT_EQ(cache.numNonPinnedEntries(), 0);
+    numRows += block.numRows();
+  }
+  EXPECT_EQ(numRows, 5u);
+  EXPECT_EQ(cache.numNonPinnedEntries(), 1);
+  auto op2 = makeOperation();
+  auto cached = op2.getResult(false, ComputationMode::LAZY_IF_SUPPORTED);
+  ASSERT_TRUE(cached->isFullyMaterialized());
+  EXPECT_EQ(cached->idTable(),
+            makeIdTableFromVector({{1}, {2}, {3}, {4}, {5}}));
+  EXPECT_EQ(op2.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::cachedNotPinned);
+
+  // A lazy result that is larger than `cache-max-size-single-entry` is not
+  // cached.
+  cache.clearAll();
+  RuntimeParameters().set<"cache-max-size-single-entry">(
+      ad_utility::MemorySize::bytes(3 * sizeof(Id)));
+  auto op3 = makeOperation();
+  auto tooLarge = op3.getResult(false, ComputationMode::LAZY_IF_SUPPORTED);
+  for ([[maybe_unused]] const auto& pair : tooLarge->idTables()) {
+  }
+  EXPECT_EQ(cache.numNonPinnedEntries(), 0);
+  EXPECT_TRUE(
+      op3.runtimeInfo().details_.contains("lazy-result-too-large-for-cache"));
+  RuntimeParameters().set<"cache-max-size-single-entry">(
+      ad_utility::MemorySize::gigabytes(5));
+}
+
+// _____________________________________________________________________________
+TEST(OperationTest, compressedCacheEntries) {
+  auto qec = getQec();
+  qec->getQueryTreeCache().clearAll();
+  RuntimeParameters().set<"compress-cached-results">(true);
+  IdTable table{2, makeAllocator()};
+  for (size_t i = 0; i < 10'000; ++i) {
+    table.push_back({Id::makeFromInt(i), Id::makeFromInt(i % 7)});
+  }
+  auto makeOperation = [qec, &table]() {
+    return ValuesForTesting{
+        qec, table.clone(),
+        std::vector<std::optional<Variable>>{Variable{"?x"}, Variable{"?y"}}};
+  };
+  auto op = makeOperation();
+  auto result = op.getResult();
+  EXPECT_EQ(result->idTable(), table);
+  auto cached = qec->getQueryTreeCache().getIfContained(op.getCacheKey());
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_TRUE(cached->_resultPointer->isCompressed());
+  // The entry needs much less memory than the uncompressed table.
+  EXPECT_LT(CacheValue::SizeGetter{}(*cached->_resultPointer).getBytes(),
+            table.numRows() * table.numColumns() * sizeof(Id) / 4);
+  // As long as the result is in use, it is not decompressed again.
+  EXPECT_EQ(cached->_resultPointer->resultTable(), result);
+
+  // After the result is released, a cache hit yields a decompressed copy.
+  result.reset();
+  auto op2 = makeOperation();
+  auto fromCache = op2.getResult();
+  EXPECT_EQ(op2.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::cachedNotPinned);
+  EXPECT_EQ(fromCache->idTable(), table);
+  EXPECT_TRUE(op2.runtimeInfo().details_.contains("compressed-in-cache"));
+  RuntimeParameters().set<"compress-cached-results">(false);
+}
@@ -197,6 +197,48 @@ TEST(OrderBy, mixedDatatypes) {
               {true});
 }
 
+// _____________________________________________________________________________
+TEST(OrderBy, localVocabWordsAreSortedByCollation) {
+  auto qec = ad_utility::testing::getQec();
+  LocalVocab localVocab;
+  auto word = [&localVocab](std::string_view w) {
+    return Id::makeFromLocalVocabIndex(
+        localVocab.getIndexAndAddIfNotContained(w));
+  };
+  // Neither the order of the `LocalVocabIndex`es nor the order of the bytes
+  // of the words is the order of the collation.
+  Id zebra = word("\"zebra\"");
+  Id apple = word("\"apple\"");
+  Id banana = word("\"Banana\"");
+  // A word that doesn't occur in the sort column.
+  word("\"aardvark\"");
+
+  auto makeSortedOrderBy = [&](bool isDescending) {
+    auto subtree = ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, makeIdTableFromVector({{zebra}, {banana}, {apple}, {zebra}}),
+        std::vector<std::optional<Variable>>{Variable{"?x"}});
+    dynamic_cast<ValuesForTesting&>(*subtree->getRootOperation())
+        .localVocab() = localVocab.clone();
+    return OrderBy{qec, std::move(subtree), {{0, isDescending}}};
+  };
+
+  OrderBy ascending = makeSortedOrderBy(false);
+  EXPECT_EQ(ascending.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{apple}, {banana}, {zebra}, {zebra}}));
+  const auto& details = ascending.runtimeInfo().details_;
+  EXPECT_EQ(details["num-local-vocab-sort-keys"].get<size_t>(), 3u);
+
+  OrderBy descending = makeSortedOrderBy(true);
+  EXPECT_EQ(descending.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{zebra}, {zebra}, {banana}, {apple}}));
+
+  // The top-k computation uses the same order.
+  OrderBy topK = makeSortedOrderBy(false);
+  topK.setLimit({1});
+  EXPECT_EQ(topK.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{apple}}));
+}
+
 // _____________________________________________________________________________
 TEST(OrderBy, simpleMemberFunctions) {
   {
@@ -257,3 +299,62 @@ TEST(OrderBy, verifyOperationIsPreemptivelyAbortedWithNoRemainingTime) {
       orderBy.getResult(true), ::testing::HasSubstr("time estimate exceeded"),
       ad_utility::AbortException);
 }
+
+// _____________________________________________________________________________
+TEST(OrderBy, externalSort) {
+  auto qec = ad_utility::testing::getQec();
+  VectorTable input;
+  for (int64_t i = 0; i < 1000; ++i) {
+    input.push_back({(i * 37) % 100 - 50, i});
+  }
+  auto inputTable = makeIdTableFromVector(input, &Id::makeFromInt);
+  OrderBy::SortIndices sortIndices{{0, true}, {1, false}};
+
+  auto originalBudget =
+      RuntimeParameters().get<"sort-external-memory-budget">();
+  OrderBy inMemory = makeOrderBy(inputTable.clone(), sortIndices);
+  auto expected = inMemory.computeResultOnlyForTesting();
+  EXPECT_FALSE(inMemory.runtimeInfo().details_.contains("sorted-externally"));
+
+  using namespace ad_utility::memory_literals;
+  RuntimeParameters().set<"sort-external-memory-budget">(1_kB);
+  OrderBy external = makeOrderBy(inputTable.clone(), sortIndices);
+  auto result = external.computeResultOnlyForTesting();
+  EXPECT_TRUE(external.runtimeInfo().details_.contains("sorted-externally"));
+  EXPECT_EQ(result.idTable(), expected.idTable());
+  RuntimeParameters().set<"sort-external-memory-budget">(originalBudget);
+}
+
+// _____________________________________________________________________________
+TEST(OrderBy, topK) {
+  VectorTable input;
+  for (int64_t i = 0; i < 1000; ++i) {
+    input.push_back({(i * 37) % 100 - 50, i});
+  }
+  auto inputTable = makeIdTableFromVector(input, &Id::makeFromInt);
+  OrderBy::SortIndices sortIndices{{0, true}, {1, false}};
+  OrderBy fullSort = makeOrderBy(inputTable.clone(), sortIndices);
+  auto sorted = fullSort.computeResultOnlyForTesting();
+
+  auto testTopK = [&](LimitOffsetClause limitOffset, bool expectTopK,
+                      source_location l = source_location::current()) {
+    auto trace = generateLocationTrace(l);
+    OrderBy orderBy = makeOrderBy(inputTable.clone(), sortIndices);
+    orderBy.setLimit(limitOffset);
+    auto result = orderBy.getResult();
+    EXPECT_EQ(orderBy.runtimeInfo().details_.contains("top-k"), expectTopK);
+    IdTable expected = sorted.idTable().clone();
+    auto begin = expected.begin() + limitOffset.actualOffset(expected.size());
+    auto end = expected.begin() + limitOffset.upperBound(expected.size());
+    IdTable expectedPart{2, expected.getAllocator()};
+    expectedPart.insertAtEnd(begin, end);
+    EXPECT_EQ(result->idTable(), expectedPart);
+  };
+  testTopK({10}, true);
+  testTopK({10, 0, 15}, true);
+  testTopK({0}, true);
+  testTopK({499}, true);
+  testTopK({500}, false);
+  testTopK({std::nullopt, 0, 20}, false);
+  testTopK({200, 0, 900}, false);
+}
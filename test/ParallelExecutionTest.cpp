@@ -0,0 +1,86 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "util/ParallelExecution.h"
+
+using ad_utility::runConcurrently;
+
+// _____________________________________________________________________________
+TEST(ParallelExecution, runConcurrently) {
+  std::vector<size_t> results(17, 0);
+  runConcurrently(results.size(), [&results](size_t i) { results[i] = i * i; });
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i], i * i);
+  }
+
+  // A single task is run on the calling thread.
+  auto id = std::this_thread::get_id();
+  runConcurrently(1, [&id](size_t) { id = std::this_thread::get_id(); });
+  EXPECT_TRUE(id == std::this_thread::get_id());
+
+  // Zero tasks are a noop.
+  runConcurrently(0, [](size_t) { throw std::runtime_error{"unreachable"}; });
+}
+
+// _____________________________________________________________________________
+TEST(ParallelExecution, exceptionsArePropagated) {
+  std::atomic<size_t> numFinished = 0;
+  auto task = [&numFinished](size_t i) {
+    if (i == 2) {
+      throw std::runtime_error{"task 2 failed"};
+    }
+    ++numFinished;
+  };
+  EXPECT_THROW(runConcurrently(5, task), std::runtime_error);
+  // All the other tasks have run to completion before the exception was
+  // rethrown.
+  EXPECT_EQ(numFinished, 4);
+}
+
+// _____________________________________________________________________________
+TEST(ParallelExecution, forEachMorselConcurrently) {
+  using ad_utility::forEachMorselConcurrently;
+  for (size_t numThreads : {1, 3, 8}) {
+    std::vector<size_t> rows(1003, 0);
+    std::vector<std::pair<size_t, size_t>> morsels(11);
+    forEachMorselConcurrently(
+        rows.size(), 100, numThreads,
+        [&](size_t morsel, size_t begin, size_t end) {
+          morsels.at(morsel) = {begin, end};
+          for (size_t i = begin; i < end; ++i) {
+            ++rows[i];
+          }
+        });
+    // Each row belongs to exactly one morsel, and the morsels are consecutive.
+    EXPECT_TRUE(std::ranges::all_of(rows, [](size_t n) { return n == 1; }));
+    for (size_t i = 0; i < morsels.size(); ++i) {
+      EXPECT_EQ(morsels[i].first, i * 100);
+      EXPECT_EQ(morsels[i].second, std::min((i + 1) * 100, rows.size()));
+    }
+  }
+
+  // No rows, no calls.
+  forEachMorselConcurrently(0, 100, 4, [](size_t, size_t, size_t) {
+    throw std::runtime_error{"unreachable"};
+  });
+
+  // After an exception, the remaining morsels are skipped.
+  std::atomic<size_t> numCalls = 0;
+  auto failing = [&numCalls](size_t morsel, size_t, size_t) {
+    ++numCalls;
+    if (morsel == 0) {
+      throw std::runtime_error{"morsel 0 failed"};
+    }
+  };
+  EXPECT_THROW(forEachMorselConcurrently(1000, 1, 1, failing),
+               std::runtime_error);
+  EXPECT_EQ(numCalls, 1);
+}
@@ -0,0 +1,125 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "global/Constants.h"
+#include "parser/ParsedQueryCache.h"
+#include "parser/SparqlParser.h"
+
+using ::testing::ElementsAre;
+
+namespace {
+// Return the placeholder with the given `index`.
+std::string placeholder(size_t index) {
+  return absl::StrCat(ParsedQueryCache::PARAMETER_IRI_PREFIX, index, ">");
+}
+
+// Return the triples of the first graph pattern of the `parsedQuery`.
+const std::vector<SparqlTriple>& getTriples(const ParsedQuery& parsedQuery) {
+  return parsedQuery._rootGraphPattern._graphPatterns.at(0).getBasic()._triples;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ParsedQueryCache, normalize) {
+  auto normalized = ParsedQueryCache::normalize(
+      "PREFIX wd: <http://www.wikidata.org/entity/>\n"
+      "SELECT ?x   WHERE { # a comment with an <iri>\n"
+      "  <a>  wd:P31 ?x . ?x <b> \"<literal>  # \\\" \" }");
+  EXPECT_EQ(normalized.text_,
+            absl::StrCat("PREFIX wd: <http://www.wikidata.org/entity/> "
+                         "SELECT ?x WHERE { ",
+                         placeholder(0), " wd:P31 ?x . ?x ", placeholder(1),
+                         " \"<literal>  # \\\" \" }"));
+  EXPECT_THAT(normalized.parameters_, ElementsAre("<a>", "<b>"));
+  EXPECT_THAT(normalized.textBetweenParameters_,
+              ElementsAre("PREFIX wd: <http://www.wikidata.org/entity/> "
+                          "SELECT ?x WHERE { ",
+                          " wd:P31 ?x . ?x ", " \"<literal>  # \\\" \" }"));
+
+  // Keep the first IRI, the second one is renumbered.
+  auto partial = normalized.withoutPlaceholdersFor({0});
+  EXPECT_EQ(partial.text_,
+            absl::StrCat("PREFIX wd: <http://www.wikidata.org/entity/> "
+                         "SELECT ?x WHERE { <a> wd:P31 ?x . ?x ",
+                         placeholder(0), " \"<literal>  # \\\" \" }"));
+  EXPECT_THAT(partial.parameters_, ElementsAre("<b>"));
+  EXPECT_EQ(normalized.withoutPlaceholdersFor({}).text_, normalized.text_);
+
+  // The `<` operator is not an IRI, triple quotes are supported.
+  normalized = ParsedQueryCache::normalize(
+      "SELECT * { ?x <p> ?y FILTER(?y < 3 && ?y > 1) ?x <q> '''a\n'b''' }");
+  EXPECT_EQ(normalized.text_,
+            absl::StrCat("SELECT * { ?x ", placeholder(0),
+                         " ?y FILTER(?y < 3 && ?y > 1) ?x ", placeholder(1),
+                         " '''a\n'b''' }"));
+  EXPECT_THAT(normalized.parameters_, ElementsAre("<p>", "<q>"));
+}
+
+// _____________________________________________________________________________
+TEST(ParsedQueryCache, queriesWithDifferentIrisShareAnEntry) {
+  ParsedQueryCache cache{10};
+  // The IRIs of the predicates are not replaced by placeholders.
+  std::string query1 = "SELECT ?x WHERE { <s1> <p> ?x . ?x <q> <o1> }";
+  std::string query2 = "SELECT ?x WHERE {\n <s2> <p> ?x .\n ?x <q>  <o2> }";
+  auto pq1 = cache.getOrParse(query1);
+  EXPECT_EQ(cache.numMisses(), 1);
+  auto pq2 = cache.getOrParse(query2);
+  EXPECT_EQ(cache.numHits(), 1);
+  EXPECT_EQ(cache.numEntries(), 1);
+
+  // The results are the same as without the cache.
+  auto expected1 = SparqlParser::parseQuery(query1);
+  auto expected2 = SparqlParser::parseQuery(query2);
+  EXPECT_EQ(getTriples(pq1), getTriples(expected1));
+  EXPECT_EQ(getTriples(pq2), getTriples(expected2));
+  EXPECT_EQ(pq1._originalString, query1);
+  EXPECT_EQ(pq2._originalString, query2);
+  EXPECT_EQ(getTriples(pq2).at(0)._s, "<s2>");
+  EXPECT_EQ(getTriples(pq2).at(1)._o, "<o2>");
+  EXPECT_EQ(getTriples(pq2).at(1)._p._iri, "<q>");
+
+  // The same query again is also a hit.
+  std::ignore = cache.getOrParse(query1);
+  EXPECT_EQ(cache.numHits(), 2);
+  EXPECT_EQ(cache.numMisses(), 1);
+
+  cache.clear();
+  EXPECT_EQ(cache.numEntries(), 0);
+}
+
+// _____________________________________________________________________________
+TEST(ParsedQueryCache, irisOutsideOfTriplesAreNotParameterized) {
+  ParsedQueryCache cache{10};
+  // The IRIs in the `FILTER` are not replaced by placeholders, so these
+  // queries have different entries.
+  std::string query1 = "SELECT ?x WHERE { ?x <p> ?y FILTER(?y = <a>) }";
+  std::string query2 = "SELECT ?x WHERE { ?x <p> ?y FILTER(?y = <b>) }";
+  auto pq1 = cache.getOrParse(query1);
+  auto pq2 = cache.getOrParse(query2);
+  EXPECT_EQ(cache.numMisses(), 2);
+  EXPECT_EQ(getTriples(pq1).at(0)._p._iri, "<p>");
+  EXPECT_EQ(pq2._rootGraphPattern._filters.at(0).expression_.getDescriptor(),
+            "?y = <b>");
+  std::ignore = cache.getOrParse(query2);
+  EXPECT_EQ(cache.numHits(), 1);
+
+  // Invalid queries still throw.
+  EXPECT_ANY_THROW(cache.getOrParse("SELECT ?x WHERE { <a> <b> }"));
+  EXPECT_ANY_THROW(cache.getOrParse("SELECT ?x WHERE { <a> <b> }"));
+
+  // The object of `ql:contains-entity` determines the name of a variable, so
+  // it is not replaced either.
+  std::string textQuery = absl::StrCat("SELECT ?t WHERE { ?t ",
+                                       CONTAINS_ENTITY_PREDICATE, " <e1> }");
+  auto pq = cache.getOrParse(textQuery);
+  EXPECT_EQ(getTriples(pq).at(0)._o, "<e1>");
+  EXPECT_EQ(cache.numMisses(), 3);
+
+  // A cache without entries just parses the queries.
+  ParsedQueryCache disabledCache{0};
+  std::ignore = disabledCache.getOrParse(query1);
+  EXPECT_EQ(disabledCache.numEntries(), 0);
+}
@@ -2,9 +2,13 @@
 //  Chair of Algorithms and Data Structures.
 //  Author: Johannes Kalmbach <kalmbach@cs.uni-freiburg.de>
 
+#include <absl/strings/str_cat.h>
 #include <gtest/gtest.h>
 
+#include <filesystem>
+
 #include "./util/IdTestHelpers.h"
+#include "index/CharacteristicSets.h"
 #include "index/PatternCreator.h"
 #include "util/Serializer/ByteBufferSerializer.h"
 #include "util/Serializer/Serializer.h"
@@ -55,7 +59,7 @@ void assertPatternContents(const std::string& filename) {
   double averageNumPredicatesPerSubject;
   uint64_t numDistinctSubjectPredicatePairs;
   CompactVectorOfStrings<Id> patterns;
-  std::vector<PatternID> subjectToPattern;
+  CompressedPatternIds subjectToPattern;
 
   PatternCreator::readPatternsFromFile(
       filename, averageNumSubjectsPerPredicate, averageNumPredicatesPerSubject,
@@ -88,6 +92,14 @@ void assertPatternContents(const std::string& filename) {
   ASSERT_EQ(0, subjectToPattern[3]);
 }
 
+// Delete the files that were written by a `PatternCreator` for the
+// `filename`, except for the characteristic sets.
+void deletePatternFiles(const std::string& filename) {
+  ad_utility::deleteFile(filename);
+  ad_utility::deleteFile(
+      absl::StrCat(filename, CompressedPatternIds::FILE_SUFFIX));
+}
+
 TEST(PatternCreator, writeAndReadWithFinish) {
   std::string filename = "patternCreator.test.tmp";
   PatternCreator creator{filename};
@@ -95,7 +107,7 @@ TEST(PatternCreator, writeAndReadWithFinish) {
   creator.finish();
 
   assertPatternContents(filename);
-  ad_utility::deleteFile(filename);
+  deletePatternFiles(filename);
 }
 
 TEST(PatternCreator, writeAndReadWithDestructor) {
@@ -108,7 +120,7 @@ TEST(PatternCreator, writeAndReadWithDestructor) {
   }
 
   assertPatternContents(filename);
-  ad_utility::deleteFile(filename);
+  deletePatternFiles(filename);
 }
 
 TEST(PatternCreator, writeAndReadWithDestructorAndFinish) {
@@ -122,5 +134,51 @@ TEST(PatternCreator, writeAndReadWithDestructorAndFinish) {
   }
 
   assertPatternContents(filename);
-  ad_utility::deleteFile(filename);
+  deletePatternFiles(filename);
+}
+
+TEST(PatternCreator, characteristicSets) {
+  std::string filename = "patternCreator.test.tmp";
+  {
+    PatternCreator creator{filename};
+    createExamplePatterns(creator);
+  }
+  auto characteristicSetsFilename =
+      absl::StrCat(filename, CharacteristicSets::FILE_SUFFIX);
+  auto sets = CharacteristicSets::readFromFile(characteristicSetsFilename);
+  // The set (10, 11) occurs for the subjects 0 and 3 with three triples per
+  // predicate, the set (10, 12, 13) occurs only for the subject 1.
+  ASSERT_EQ(sets.size(), 2);
+  auto estimate = [&sets](const std::vector<Id>& predicates) {
+    return sets.estimateStarSize(predicates);
+  };
+  EXPECT_DOUBLE_EQ(estimate({V(10)}).value(), 2 * 1.5 + 1);
+  EXPECT_DOUBLE_EQ(estimate({V(11), V(10)}).value(), 2 * 1.5 * 1.5);
+  EXPECT_DOUBLE_EQ(estimate({V(10), V(10)}).value(), 2 * 1.5 * 1.5 + 1);
+  EXPECT_DOUBLE_EQ(estimate({V(12), V(13)}).value(), 1);
+  // No subject has both the predicates 11 and 12.
+  EXPECT_DOUBLE_EQ(estimate({V(11), V(12)}).value(), 0);
+  EXPECT_DOUBLE_EQ(estimate({V(14)}).value(), 0);
+  EXPECT_FALSE(estimate({}).has_value());
+  EXPECT_FALSE(CharacteristicSets{}.estimateStarSize({{V(10)}}).has_value());
+
+  deletePatternFiles(filename);
+  ad_utility::deleteFile(characteristicSetsFilename);
+}
+
+TEST(PatternCreator, readWithoutPackedFile) {
+  std::string filename = "patternCreator.test.tmp";
+  {
+    PatternCreator creator{filename};
+    createExamplePatterns(creator);
+  }
+  // An index that was built before the bit-packed mapping from subjects to
+  // patterns existed doesn't have its file, so it is created when reading.
+  auto packedFilename =
+      absl::StrCat(filename, CompressedPatternIds::FILE_SUFFIX);
+  ad_utility::deleteFile(packedFilename);
+  assertPatternContents(filename);
+  ASSERT_TRUE(std::filesystem::exists(packedFilename));
+  assertPatternContents(filename);
+  deletePatternFiles(filename);
 }
@@ -0,0 +1,62 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "./util/IdTestHelpers.h"
+#include "index/PatternTrickAggregates.h"
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+namespace {
+auto I = ad_utility::testing::IntId;
+auto V = ad_utility::testing::VocabId;
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(PatternTrickAggregates, builder) {
+  // The subjects `V(0)` and `V(2)` have the first pattern, `V(1)` has the
+  // second one, and `V(3)` has no pattern.
+  CompressedPatternIds hasPattern{
+      std::vector<PatternID>{0, 1, 0, NO_PATTERN}};
+  CompactVectorOfStrings<Id> patterns(
+      std::vector<std::vector<Id>>{{V(10), V(11)}, {V(11), V(12)}});
+  PatternTrickAggregates::Builder builder{hasPattern, patterns};
+
+  // The subjects are added in several chunks, and a subject that occurs at the
+  // end of one chunk and at the beginning of the next is counted once.
+  std::vector<Id> first{V(0), V(1), V(1)};
+  std::vector<Id> second{V(1), V(2), V(3), I(5)};
+  builder.add(first);
+  builder.add(second);
+  EXPECT_EQ(builder.numSubjects(), 5u);
+  EXPECT_THAT(builder.finish(),
+              ElementsAre(Pair(V(10), 2u), Pair(V(11), 3u), Pair(V(12), 1u)));
+
+  // The builder is reset by `finish`.
+  EXPECT_EQ(builder.numSubjects(), 0u);
+  std::vector<Id> third{V(1)};
+  builder.add(third);
+  EXPECT_THAT(builder.finish(), ElementsAre(Pair(V(11), 1u), Pair(V(12), 1u)));
+}
+
+// _____________________________________________________________________________
+TEST(PatternTrickAggregates, writeAndRead) {
+  PatternTrickAggregates aggregates;
+  aggregates.add(V(1), V(2), {{V(10), 3}, {V(11), 1}});
+  EXPECT_EQ(aggregates.get(V(2), V(1)), nullptr);
+
+  std::string filename = "patternTrickAggregatesTest.dat";
+  aggregates.writeToFile(filename);
+  auto read = PatternTrickAggregates::readFromFile(filename);
+  std::remove(filename.c_str());
+  EXPECT_EQ(read.size(), 1u);
+  ASSERT_NE(read.get(V(1), V(2)), nullptr);
+  EXPECT_THAT(*read.get(V(1), V(2)),
+              ElementsAre(Pair(V(10), 3u), Pair(V(11), 1u)));
+  EXPECT_EQ(read.get(V(1), V(3)), nullptr);
+}
@@ -0,0 +1,175 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "./util/AllocatorTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "./util/IdTestHelpers.h"
+#include "engine/PersistentResultCache.h"
+
+using ad_utility::testing::makeAllocator;
+using ad_utility::testing::VocabId;
+using namespace ad_utility::memory_literals;
+
+namespace {
+const std::filesystem::path directory = "persistentResultCacheTest.dir";
+
+// Create a fresh, empty directory for the cache and remove it again at the
+// end of the test.
+struct DirectoryGuard {
+  DirectoryGuard() { std::filesystem::remove_all(directory); }
+  ~DirectoryGuard() { std::filesystem::remove_all(directory); }
+};
+
+// Return a result with `numRows` rows and two columns, the second of which
+// refers to the local vocabulary.
+ResultTable makeResult(size_t numRows) {
+  IdTable table{2, makeAllocator()};
+  LocalVocab localVocab;
+  for (size_t i = 0; i < numRows; ++i) {
+    auto index =
+        localVocab.getIndexAndAddIfNotContained(absl::StrCat("word", i % 7));
+    table.push_back({VocabId(i), Id::makeFromLocalVocabIndex(index)});
+  }
+  return ResultTable{std::move(table), {0}, std::move(localVocab)};
+}
+
+RuntimeInformation makeRuntimeInfo() {
+  RuntimeInformation runtimeInfo;
+  runtimeInfo.descriptor_ = "some operation";
+  runtimeInfo.columnNames_ = {"?x", "?y"};
+  runtimeInfo.totalTime_ = std::chrono::milliseconds{42};
+  runtimeInfo.addDetail("someDetail", 17);
+  return runtimeInfo;
+}
+
+// Check that the `actual` result has the same contents as the `expected`
+// result, including the words of the local vocabulary.
+void expectSameResult(const ResultTable& actual, const ResultTable& expected) {
+  EXPECT_EQ(actual.idTable(), expected.idTable());
+  EXPECT_EQ(actual.sortedBy(), expected.sortedBy());
+  ASSERT_EQ(actual.localVocab().size(), expected.localVocab().size());
+  for (size_t i = 0; i < actual.localVocab().size(); ++i) {
+    auto index = LocalVocabIndex::make(i);
+    EXPECT_EQ(actual.localVocab().getWord(index),
+              expected.localVocab().getWord(index));
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(PersistentResultCache, writeAndRead) {
+  DirectoryGuard guard;
+  PersistentResultCache cache{directory, "version", 1_GB};
+  EXPECT_FALSE(cache.contains("key"));
+  EXPECT_FALSE(cache.read("key", makeAllocator()).has_value());
+
+  // A result that consists of multiple blocks of the
+  // `CompressedExternalIdTableWriter`.
+  auto result = makeResult(100'000);
+  cache.write("key", result, makeRuntimeInfo());
+  EXPECT_TRUE(cache.contains("key"));
+  EXPECT_FALSE(cache.contains("otherKey"));
+  EXPECT_EQ(cache.numEntries(), 1);
+  EXPECT_GT(cache.size(), 0_B);
+
+  auto stored = cache.read("key", makeAllocator());
+  ASSERT_TRUE(stored.has_value());
+  expectSameResult(stored->first, result);
+  const auto& runtimeInfo = stored->second;
+  EXPECT_EQ(runtimeInfo.descriptor_, "some operation");
+  EXPECT_THAT(runtimeInfo.columnNames_, ::testing::ElementsAre("?x", "?y"));
+  EXPECT_EQ(runtimeInfo.totalTime_, std::chrono::milliseconds{42});
+  EXPECT_EQ(runtimeInfo.numRows_, 100'000);
+  EXPECT_EQ(runtimeInfo.numCols_, 2);
+  EXPECT_EQ(runtimeInfo.details_["someDetail"], 17);
+  EXPECT_EQ(runtimeInfo.details_["read-from-persistent-cache"], true);
+
+  // Empty results and results without columns can also be stored.
+  auto emptyResult = makeResult(0);
+  cache.write("empty", emptyResult, makeRuntimeInfo());
+  IdTable noColumns{0, makeAllocator()};
+  noColumns.resize(3);
+  cache.write("noColumns",
+              ResultTable{std::move(noColumns), {}, LocalVocab{}},
+              makeRuntimeInfo());
+  stored = cache.read("empty", makeAllocator());
+  ASSERT_TRUE(stored.has_value());
+  expectSameResult(stored->first, emptyResult);
+  stored = cache.read("noColumns", makeAllocator());
+  ASSERT_TRUE(stored.has_value());
+  EXPECT_EQ(stored->first.idTable().numColumns(), 0);
+  EXPECT_EQ(stored->first.idTable().numRows(), 3);
+
+  cache.clear();
+  EXPECT_EQ(cache.numEntries(), 0);
+  EXPECT_FALSE(cache.contains("key"));
+  EXPECT_FALSE(cache.read("key", makeAllocator()).has_value());
+}
+
+// _____________________________________________________________________________
+TEST(PersistentResultCache, survivesRestart) {
+  DirectoryGuard guard;
+  auto result = makeResult(1000);
+  {
+    PersistentResultCache cache{directory, "version", 1_GB};
+    cache.write("key", result, makeRuntimeInfo());
+  }
+  {
+    PersistentResultCache cache{directory, "version", 1_GB};
+    EXPECT_EQ(cache.numEntries(), 1);
+    auto stored = cache.read("key", makeAllocator());
+    ASSERT_TRUE(stored.has_value());
+    expectSameResult(stored->first, result);
+  }
+  // The entries of a different index version are deleted.
+  {
+    PersistentResultCache cache{directory, "otherVersion", 1_GB};
+    EXPECT_EQ(cache.numEntries(), 0);
+    EXPECT_FALSE(cache.contains("key"));
+  }
+  EXPECT_TRUE(std::filesystem::is_empty(directory));
+}
+
+// _____________________________________________________________________________
+TEST(PersistentResultCache, leastRecentlyUsedEntriesAreDeleted) {
+  DirectoryGuard guard;
+  PersistentResultCache cache{directory, "version", 1_GB};
+  cache.write("a", makeResult(1000), makeRuntimeInfo());
+  cache.write("b", makeResult(1000), makeRuntimeInfo());
+  cache.write("c", makeResult(1000), makeRuntimeInfo());
+  // Make "a" the most recently used entry.
+  EXPECT_TRUE(cache.read("a", makeAllocator()).has_value());
+  auto sizeOfAllEntries = cache.size();
+  cache.setMaxSize(sizeOfAllEntries - 1_B);
+  EXPECT_EQ(cache.numEntries(), 2);
+  EXPECT_TRUE(cache.contains("a"));
+  EXPECT_FALSE(cache.contains("b"));
+  EXPECT_TRUE(cache.contains("c"));
+
+  // Results that are larger than the cache are not written.
+  cache.setMaxSize(1_B);
+  cache.write("d", makeResult(1000), makeRuntimeInfo());
+  EXPECT_FALSE(cache.contains("d"));
+  EXPECT_EQ(cache.numEntries(), 0);
+}
+
+// _____________________________________________________________________________
+TEST(PersistentResultCache, writeInBackground) {
+  DirectoryGuard guard;
+  PersistentResultCache cache{directory, "version", 1_GB};
+  auto result = std::make_shared<const ResultTable>(makeResult(1000));
+  cache.writeInBackground("key", result, makeRuntimeInfo());
+  cache.finishPendingWrites();
+  EXPECT_TRUE(cache.contains("key"));
+  auto stored = cache.read("key", makeAllocator());
+  ASSERT_TRUE(stored.has_value());
+  expectSameResult(stored->first, *result);
+  // After `finishPendingWrites`, the writes are silently ignored.
+  cache.writeInBackground("otherKey", result, makeRuntimeInfo());
+  EXPECT_FALSE(cache.contains("otherKey"));
+}
@@ -0,0 +1,94 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "./util/IdTestHelpers.h"
+#include "index/PredicateHistograms.h"
+
+using ::testing::ElementsAre;
+using valueIdComparators::Comparison;
+
+namespace {
+auto I = ad_utility::testing::IntId;
+auto V = ad_utility::testing::VocabId;
+
+// The histogram of the objects `0, 1, ..., numRows - 1`, which are added in
+// chunks of three.
+ObjectHistogram makeHistogram(int64_t numRows) {
+  std::vector<Id> objects;
+  for (int64_t i = 0; i < numRows; ++i) {
+    objects.push_back(I(i));
+  }
+  ObjectHistogram::Builder builder{static_cast<uint64_t>(numRows)};
+  for (size_t i = 0; i < objects.size(); i += 3) {
+    size_t chunkSize = std::min<size_t>(3, objects.size() - i);
+    builder.add(std::span{objects}.subspan(i, chunkSize));
+  }
+  return std::move(builder).finish();
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ObjectHistogram, build) {
+  auto small = makeHistogram(5);
+  EXPECT_THAT(small.quantiles(), ElementsAre(I(0), I(1), I(2), I(3), I(4)));
+  EXPECT_EQ(small.numRows(), 5u);
+  EXPECT_EQ(small.numDistinct(), 5u);
+
+  auto large = makeHistogram(1280);
+  ASSERT_EQ(large.quantiles().size(), ObjectHistogram::MAX_NUM_BUCKETS);
+  EXPECT_EQ(large.quantiles().front(), I(5));
+  EXPECT_EQ(large.quantiles()[1], I(15));
+  EXPECT_EQ(large.quantiles().back(), I(1275));
+  EXPECT_EQ(large.numRows(), 1280u);
+
+  // Duplicate objects.
+  ObjectHistogram::Builder builder{4};
+  std::vector<Id> objects{V(1), V(1), V(1), V(2)};
+  builder.add(objects);
+  auto duplicates = std::move(builder).finish();
+  EXPECT_THAT(duplicates.quantiles(), ElementsAre(V(1), V(1), V(1), V(2)));
+  EXPECT_EQ(duplicates.numDistinct(), 2u);
+
+  ObjectHistogram::Builder emptyBuilder{0};
+  auto empty = std::move(emptyBuilder).finish();
+  EXPECT_TRUE(empty.quantiles().empty());
+  EXPECT_EQ(empty.estimateFraction(Comparison::LT, I(3)), 0.0);
+}
+
+// _____________________________________________________________________________
+TEST(ObjectHistogram, estimateFraction) {
+  auto histogram = makeHistogram(1280);
+  EXPECT_NEAR(histogram.estimateFraction(Comparison::LT, I(320)), 0.25, 0.01);
+  EXPECT_NEAR(histogram.estimateFraction(Comparison::GE, I(320)), 0.75, 0.01);
+  EXPECT_NEAR(histogram.estimateFraction(Comparison::LE, I(-3)), 0.0, 0.01);
+  EXPECT_NEAR(histogram.estimateFraction(Comparison::GT, I(-3)), 1.0, 0.01);
+  // Values without a quantile have the average number of rows.
+  EXPECT_DOUBLE_EQ(histogram.estimateFraction(Comparison::EQ, I(42)),
+                   1.0 / 1280);
+  EXPECT_DOUBLE_EQ(histogram.estimateFraction(Comparison::NE, I(42)),
+                   1.0 - 1.0 / 1280);
+  // Incompatible datatypes never match.
+  EXPECT_EQ(histogram.estimateFraction(Comparison::LT, V(3)), 0.0);
+}
+
+// _____________________________________________________________________________
+TEST(PredicateHistograms, writeAndRead) {
+  PredicateHistograms histograms;
+  histograms.add(V(42), makeHistogram(10));
+  EXPECT_EQ(histograms.get(V(43)), nullptr);
+
+  std::string filename = "predicateHistogramsTest.dat";
+  histograms.writeToFile(filename);
+  auto read = PredicateHistograms::readFromFile(filename);
+  std::remove(filename.c_str());
+  EXPECT_EQ(read.size(), 1u);
+  ASSERT_NE(read.get(V(42)), nullptr);
+  EXPECT_EQ(read.get(V(42))->quantiles().size(), 10u);
+  EXPECT_EQ(read.get(V(42))->numRows(), 10u);
+  EXPECT_EQ(read.get(V(43)), nullptr);
+}
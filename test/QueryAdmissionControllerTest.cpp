@@ -0,0 +1,154 @@
+//  Copyright 2026, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include "util/QueryAdmissionController.h"
+
+using ad_utility::QueryAdmissionController;
+using ad_utility::QueryPriority;
+using Ticket = QueryAdmissionController::Ticket;
+using namespace ad_utility::memory_literals;
+
+namespace {
+// Request the admission of a query and store its ticket in `ticket` as soon
+// as it is admitted.
+void request(QueryAdmissionController& controller, QueryPriority priority,
+             ad_utility::MemorySize memory, std::optional<Ticket>& ticket) {
+  controller.requestAdmission(priority, memory, [&ticket](Ticket t) {
+    ticket = std::move(t);
+  });
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(QueryAdmissionController, limitsNumberOfRunningQueries) {
+  QueryAdmissionController controller{2, 1_GB};
+  std::optional<Ticket> t1, t2, t3;
+  request(controller, QueryPriority::Normal, 1_kB, t1);
+  request(controller, QueryPriority::Normal, 1_kB, t2);
+  request(controller, QueryPriority::Normal, 1_kB, t3);
+  EXPECT_TRUE(t1.has_value());
+  EXPECT_TRUE(t2.has_value());
+  EXPECT_FALSE(t3.has_value());
+  auto stats = controller.statistics();
+  EXPECT_EQ(stats.numRunning_, 2u);
+  EXPECT_EQ(stats.numQueued_, 1u);
+  EXPECT_EQ(stats.reservedMemory_, 2_kB);
+
+  t1.reset();
+  EXPECT_TRUE(t3.has_value());
+  stats = controller.statistics();
+  EXPECT_EQ(stats.numRunning_, 2u);
+  EXPECT_EQ(stats.numQueued_, 0u);
+  EXPECT_EQ(stats.numAdmitted_, 3u);
+
+  t2.reset();
+  t3.reset();
+  stats = controller.statistics();
+  EXPECT_EQ(stats.numRunning_, 0u);
+  EXPECT_EQ(stats.reservedMemory_, 0_B);
+}
+
+// _____________________________________________________________________________
+TEST(QueryAdmissionController, reservesMemory) {
+  QueryAdmissionController controller{10, 10_kB};
+  std::optional<Ticket> t1, t2, t3, t4;
+  request(controller, QueryPriority::Normal, 6_kB, t1);
+  // Doesn't fit, and the queue is processed in order, so the small third
+  // query has to wait, too.
+  request(controller, QueryPriority::Normal, 5_kB, t2);
+  request(controller, QueryPriority::Normal, 1_kB, t3);
+  EXPECT_TRUE(t1.has_value());
+  EXPECT_FALSE(t2.has_value());
+  EXPECT_FALSE(t3.has_value());
+
+  t1.reset();
+  EXPECT_TRUE(t2.has_value());
+  EXPECT_TRUE(t3.has_value());
+  EXPECT_EQ(controller.statistics().reservedMemory_, 6_kB);
+
+  // An estimate that is larger than the budget is capped, the query is then
+  // run alone.
+  request(controller, QueryPriority::Normal, 1_GB, t4);
+  EXPECT_FALSE(t4.has_value());
+  t2.reset();
+  EXPECT_FALSE(t4.has_value());
+  t3.reset();
+  ASSERT_TRUE(t4.has_value());
+  EXPECT_EQ(t4->reservedMemory(), 10_kB);
+}
+
+// _____________________________________________________________________________
+TEST(QueryAdmissionController, priorities) {
+  QueryAdmissionController controller{1, 1_GB};
+  std::optional<Ticket> running, normal1, normal2, high1, high2;
+  request(controller, QueryPriority::Normal, 1_kB, running);
+  request(controller, QueryPriority::Normal, 1_kB, normal1);
+  request(controller, QueryPriority::High, 1_kB, high1);
+  request(controller, QueryPriority::Normal, 1_kB, normal2);
+  request(controller, QueryPriority::High, 1_kB, high2);
+  EXPECT_TRUE(running.has_value());
+  EXPECT_EQ(controller.statistics().numQueued_, 4u);
+
+  // The queries with a high priority are admitted first, queries with the
+  // same priority in the order of their requests.
+  std::vector<std::optional<Ticket>*> expectedOrder{&high1, &high2, &normal1,
+                                                    &normal2};
+  std::optional<Ticket>* previous = &running;
+  for (auto* ticket : expectedOrder) {
+    EXPECT_FALSE(ticket->has_value());
+    previous->reset();
+    EXPECT_TRUE(ticket->has_value());
+    previous = ticket;
+  }
+  previous->reset();
+  auto stats = controller.statistics();
+  EXPECT_EQ(stats.numRunning_, 0u);
+  EXPECT_EQ(stats.numQueued_, 0u);
+  EXPECT_EQ(stats.numAdmitted_, 5u);
+  EXPECT_LE(stats.maxWaitTime_, stats.totalWaitTime_);
+}
+
+// _____________________________________________________________________________
+TEST(QueryAdmissionController, movingTickets) {
+  QueryAdmissionController controller{1, 1_GB};
+  std::optional<Ticket> t1, t2;
+  request(controller, QueryPriority::Normal, 1_kB, t1);
+  request(controller, QueryPriority::Normal, 1_kB, t2);
+  Ticket moved = std::move(t1.value());
+  // The moved-from ticket holds no reservation anymore.
+  t1.reset();
+  EXPECT_FALSE(t2.has_value());
+  moved = Ticket{};
+  EXPECT_TRUE(t2.has_value());
+  EXPECT_EQ(controller.statistics().numRunning_, 1u);
+}
+
+// _____________________________________________________________________________
+TEST(QueryAdmissionController, setMaxNumRunning) {
+  QueryAdmissionController controller{1, 1_GB};
+  std::optional<Ticket> t1, t2, t3;
+  request(controller, QueryPriority::Normal, 1_kB, t1);
+  request(controller, QueryPriority::Normal, 1_kB, t2);
+  request(controller, QueryPriority::Normal, 1_kB, t3);
+  EXPECT_FALSE(t2.has_value());
+  // Increasing the limit directly admits the waiting queries.
+  controller.setMaxNumRunning(3);
+  EXPECT_TRUE(t2.has_value());
+  EXPECT_TRUE(t3.has_value());
+
+  // Decreasing the limit doesn't affect the running queries.
+  controller.setMaxNumRunning(2);
+  EXPECT_EQ(controller.statistics().numRunning_, 3u);
+  std::optional<Ticket> t4;
+  request(controller, QueryPriority::Normal, 1_kB, t4);
+  t1.reset();
+  EXPECT_FALSE(t4.has_value());
+  t2.reset();
+  EXPECT_TRUE(t4.has_value());
+  EXPECT_ANY_THROW(controller.setMaxNumRunning(0));
+}
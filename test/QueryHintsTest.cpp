@@ -0,0 +1,69 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+
+#include "engine/QueryHints.h"
+#include "./util/GTestHelpers.h"
+
+using namespace ad_utility::memory_literals;
+
+// _____________________________________________________________________________
+TEST(QueryHints, defaults) {
+  auto hints = QueryHints::fromParameters({{"query", "SELECT * {}"}});
+  EXPECT_EQ(hints.numThreads_, std::nullopt);
+  EXPECT_EQ(hints.memoryLimit_, std::nullopt);
+  EXPECT_EQ(hints.joinStrategy_, QueryHints::JoinStrategy::Auto);
+  EXPECT_EQ(hints.cacheMode_, QueryHints::CacheMode::Default);
+  EXPECT_FALSE(hints.approximate_);
+}
+
+// _____________________________________________________________________________
+TEST(QueryHints, fromParameters) {
+  auto hints = QueryHints::fromParameters({{"num-threads", "32"},
+                                           {"memory-limit", "50GB"},
+                                           {"join-strategy", "hash"},
+                                           {"cache", "bypass"},
+                                           {"approximate", "true"}});
+  EXPECT_EQ(hints.numThreads_, 32u);
+  EXPECT_EQ(hints.memoryLimit_, 50_GB);
+  EXPECT_EQ(hints.joinStrategy_, QueryHints::JoinStrategy::Hash);
+  EXPECT_EQ(hints.cacheMode_, QueryHints::CacheMode::Bypass);
+  EXPECT_TRUE(hints.approximate_);
+
+  using enum QueryHints::JoinStrategy;
+  for (auto [name, strategy] :
+       std::vector<std::pair<std::string, QueryHints::JoinStrategy>>{
+           {"auto", Auto},
+           {"merge", Merge},
+           {"index-nested-loop", IndexNestedLoop}}) {
+    EXPECT_EQ(
+        QueryHints::fromParameters({{"join-strategy", name}}).joinStrategy_,
+        strategy);
+  }
+  EXPECT_EQ(QueryHints::fromParameters({{"cache", "no-store"}}).cacheMode_,
+            QueryHints::CacheMode::NoStore);
+
+  // Approximate results are never stored in the cache.
+  EXPECT_EQ(QueryHints::fromParameters({{"approximate", "true"}}).cacheMode_,
+            QueryHints::CacheMode::NoStore);
+  EXPECT_EQ(QueryHints::fromParameters({{"approximate", "false"}}).cacheMode_,
+            QueryHints::CacheMode::Default);
+}
+
+// _____________________________________________________________________________
+TEST(QueryHints, invalidValues) {
+  auto parse = [](std::string key, std::string value) {
+    return QueryHints::fromParameters({{std::move(key), std::move(value)}});
+  };
+  AD_EXPECT_THROW_WITH_MESSAGE(parse("num-threads", "0"),
+                               ::testing::HasSubstr("positive integer"));
+  EXPECT_ANY_THROW(parse("num-threads", "many"));
+  EXPECT_ANY_THROW(parse("memory-limit", "a lot"));
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      parse("join-strategy", "nested-loop"),
+      ::testing::HasSubstr("\"auto\", \"merge\", \"index-nested-loop\", "
+                           "\"hash\", but was \"nested-loop\""));
+  EXPECT_ANY_THROW(parse("cache", "off"));
+  EXPECT_ANY_THROW(parse("approximate", "yes"));
+}
@@ -7,6 +7,10 @@
 
 #include "./QueryPlannerTestHelpers.h"
 #include "./util/TripleComponentTestHelpers.h"
+#include "engine/Distinct.h"
+#include "engine/IndexNestedLoopJoin.h"
+#include "engine/Minus.h"
+#include "engine/SpatialJoin.h"
 #include "engine/QueryPlanner.h"
 #include "global/Constants.h"
 #include "parser/SparqlParser.h"
@@ -875,3 +879,303 @@ TEST(QueryPlannerTest, TooManyTriples) {
       qp.createExecutionTree(pq),
       ::testing::ContainsRegex("At most 64 triples allowed at the moment."));
 }
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, iterativeDynamicProgrammingForManyTriples) {
+  auto scan = h::IndexScanFromStrings;
+  std::string query =
+      "SELECT * WHERE { ?a <p> ?b . ?b <p> ?c . ?c <p> ?d . ?d <p> ?e . "
+      "?e <p> ?f }";
+  auto matcher = h::UnorderedJoins(
+      scan("?a", "<p>", "?b"), scan("?b", "<p>", "?c"), scan("?c", "<p>", "?d"),
+      scan("?d", "<p>", "?e"), scan("?e", "<p>", "?f"));
+  auto getRuntimeInfo = [](const QueryExecutionTree& qet) {
+    return qet.getRootOperation()->getRuntimeInfoWholeQuery();
+  };
+
+  // With the default parameters, the exhaustive dynamic programming is used.
+  auto qet = h::parseAndPlan(query, ad_utility::testing::getQec());
+  EXPECT_THAT(qet, matcher);
+  EXPECT_EQ(getRuntimeInfo(qet).numIdpIterations, 0);
+  EXPECT_GT(getRuntimeInfo(qet).numCandidatePlans, 0);
+
+  // Greedy join ordering: Each step joins two subtrees until only two remain.
+  auto maxNumNodes =
+      RuntimeParameters().get<"query-planning-max-num-nodes-for-exact-dp">();
+  auto blockSize = RuntimeParameters().get<"query-planning-idp-block-size">();
+  RuntimeParameters().set<"query-planning-max-num-nodes-for-exact-dp">(2);
+  RuntimeParameters().set<"query-planning-idp-block-size">(2);
+  qet = h::parseAndPlan(query, ad_utility::testing::getQec());
+  EXPECT_THAT(qet, matcher);
+  EXPECT_EQ(getRuntimeInfo(qet).numIdpIterations, 3);
+
+  // Blocks of three subtrees: 5 -> 3 seeds, then the exhaustive planning.
+  RuntimeParameters().set<"query-planning-max-num-nodes-for-exact-dp">(3);
+  RuntimeParameters().set<"query-planning-idp-block-size">(3);
+  qet = h::parseAndPlan(query, ad_utility::testing::getQec());
+  EXPECT_THAT(qet, matcher);
+  EXPECT_EQ(getRuntimeInfo(qet).numIdpIterations, 1);
+
+  EXPECT_ANY_THROW(RuntimeParameters().set<"query-planning-idp-block-size">(1));
+  RuntimeParameters().set<"query-planning-max-num-nodes-for-exact-dp">(
+      maxNumNodes);
+  RuntimeParameters().set<"query-planning-idp-block-size">(blockSize);
+}
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, worstCaseOptimalJoinForCyclicPatterns) {
+  // A complete graph with four nodes, where the triangle pattern is cheaper to
+  // compute with the worst-case optimal join than with pairwise joins.
+  std::string turtle;
+  for (std::string_view x : {"<a>", "<b>", "<c>", "<d>"}) {
+    for (std::string_view y : {"<a>", "<b>", "<c>", "<d>"}) {
+      if (x != y) {
+        absl::StrAppend(&turtle, x, " <p> ", y, " . ");
+      }
+    }
+  }
+  auto qec = ad_utility::testing::getQec(turtle);
+  auto scan = h::IndexScanFromStrings;
+  using enum Permutation::Enum;
+  std::string triangle =
+      "SELECT * WHERE { ?a <p> ?b . ?b <p> ?c . ?c <p> ?a }";
+  h::expect(triangle,
+            h::WorstCaseOptimalJoin(scan("?a", "<p>", "?b", {PSO, POS}),
+                                    scan("?b", "<p>", "?c", {PSO, POS}),
+                                    scan("?c", "<p>", "?a", {PSO, POS})),
+            qec);
+
+  // Without the runtime parameter, only pairwise joins are used.
+  RuntimeParameters().set<"use-worst-case-optimal-join">(false);
+  auto qet = h::parseAndPlan(triangle, qec);
+  EXPECT_NE(qet.getType(), QueryExecutionTree::WORST_CASE_OPTIMAL_JOIN);
+  RuntimeParameters().set<"use-worst-case-optimal-join">(true);
+}
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, semiJoinForFilterExists) {
+  auto scan = h::IndexScanFromStrings;
+  h::expect("SELECT * WHERE { ?x <p> ?y FILTER EXISTS { ?x <q> <z> } }",
+            h::SemiJoin(scan("?x", "<p>", "?y"), scan("?x", "<q>", "<z>")));
+  h::expect("SELECT * WHERE { ?x <p> ?y FILTER NOT EXISTS { ?x <q> <z> } }",
+            h::MatchTypeAndOrderedChildren<::Minus>(
+                scan("?x", "<p>", "?y"), scan("?x", "<q>", "<z>")));
+}
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, indexNestedLoopJoinForSmallInputs) {
+  // The scan with `<p>` is large, but only the rows of `<s1>` are needed.
+  std::string turtle = "<a> <q> <s1> . ";
+  for (size_t i = 0; i < 5'000; ++i) {
+    absl::StrAppend(&turtle, "<s", i, "> <p> <o", i, "> . ");
+  }
+  auto qec = ad_utility::testing::getQec(turtle);
+  auto scan = h::IndexScanFromStrings;
+  using enum Permutation::Enum;
+  std::string query = "SELECT * WHERE { <a> <q> ?x . ?x <p> ?y }";
+  h::expect(query,
+            h::MatchTypeAndOrderedChildren<::IndexNestedLoopJoin>(
+                scan("<a>", "<q>", "?x"), scan("?x", "<p>", "?y", {PSO})),
+            qec);
+
+  // With the runtime parameter set to 0, a normal join is used.
+  RuntimeParameters().set<"index-nested-loop-join-max-left-size">(0);
+  auto qet = h::parseAndPlan(query, qec);
+  EXPECT_EQ(qet.getType(), QueryExecutionTree::JOIN);
+  RuntimeParameters().set<"index-nested-loop-join-max-left-size">(10'000);
+}
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, joinStrategyOfQueryHints) {
+  std::string turtle = "<a> <q> <s1> . ";
+  for (size_t i = 0; i < 5'000; ++i) {
+    absl::StrAppend(&turtle, "<s", i, "> <p> <o", i, "> . ");
+  }
+  auto qec = ad_utility::testing::getQec(turtle);
+  std::string query = "SELECT * WHERE { <a> <q> ?x . ?x <p> ?y }";
+  QueryHints hints;
+
+  // With `Merge`, the index nested loop join is not used.
+  hints.joinStrategy_ = QueryHints::JoinStrategy::Merge;
+  qec->setQueryHints(hints);
+  EXPECT_EQ(h::parseAndPlan(query, qec).getType(), QueryExecutionTree::JOIN);
+
+  // With `IndexNestedLoop`, it is used regardless of the runtime parameter.
+  hints.joinStrategy_ = QueryHints::JoinStrategy::IndexNestedLoop;
+  qec->setQueryHints(hints);
+  RuntimeParameters().set<"index-nested-loop-join-max-left-size">(0);
+  EXPECT_EQ(h::parseAndPlan(query, qec).getType(),
+            QueryExecutionTree::INDEX_NESTED_LOOP_JOIN);
+  RuntimeParameters().set<"index-nested-loop-join-max-left-size">(10'000);
+
+  // With `Hash`, the duplicates are always removed via hashing, and with
+  // `Merge` never.
+  std::string distinctQuery =
+      "SELECT DISTINCT ?y WHERE { <a> <q> ?x . ?x <p> ?y }";
+  auto getDistinctStrategy = [&]() {
+    auto qet = h::parseAndPlan(distinctQuery, qec);
+    return dynamic_cast<const ::Distinct&>(*qet.getRootOperation()).strategy();
+  };
+  hints.joinStrategy_ = QueryHints::JoinStrategy::Hash;
+  qec->setQueryHints(hints);
+  EXPECT_EQ(getDistinctStrategy(), ::Distinct::Strategy::Hash);
+  hints.joinStrategy_ = QueryHints::JoinStrategy::Merge;
+  qec->setQueryHints(hints);
+  EXPECT_EQ(getDistinctStrategy(), ::Distinct::Strategy::Sorted);
+  qec->setQueryHints(QueryHints{});
+}
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, concurrentCreationOfJoinCandidates) {
+  std::string turtle;
+  for (size_t i = 0; i < 20; ++i) {
+    absl::StrAppend(&turtle, "<s", i, "> <p1> <o", i, "> . <o", i,
+                    "> <p2> <s", i % 3, "> . <s", i, "> <p3> <o", i % 7,
+                    "> . ");
+  }
+  auto qec = ad_utility::testing::getQec(turtle);
+  std::string query =
+      "SELECT * WHERE { ?a <p1> ?b . ?b <p2> ?c . ?c <p3> ?d . ?d <p2> ?e . "
+      "?e <p1> ?f . ?f <p2> ?g }";
+  QueryHints hints;
+  auto planWithThreads = [&](size_t numThreads) {
+    hints.numThreads_ = numThreads;
+    qec->setQueryHints(hints);
+    return h::parseAndPlan(query, qec).getCacheKey();
+  };
+  // The plan doesn't depend on the number of threads.
+  auto expected = planWithThreads(1);
+  EXPECT_EQ(planWithThreads(4), expected);
+  EXPECT_EQ(planWithThreads(16), expected);
+  qec->setQueryHints(QueryHints{});
+}
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, spatialJoinForFilterOnDistance) {
+  auto scan = h::IndexScanFromStrings;
+  std::string prefix =
+      "PREFIX geof: <http://www.opengis.net/def/function/geosparql/> ";
+  h::expect(prefix +
+                "SELECT * WHERE { ?x <p> ?a . ?y <q> ?b "
+                "FILTER(geof:distance(?a, ?b) < 10) }",
+            h::MatchTypeAndOrderedChildren<::SpatialJoin>(
+                scan("?x", "<p>", "?a"), scan("?y", "<q>", "?b")));
+  h::expect(prefix +
+                "SELECT * WHERE { ?x <p> ?a . ?y <q> ?b "
+                "FILTER(10.5 >= geof:distance(?b, ?a)) }",
+            h::MatchTypeAndOrderedChildren<::SpatialJoin>(
+                scan("?y", "<q>", "?b"), scan("?x", "<p>", "?a")));
+  // A lower bound for the distance is a regular FILTER on the Cartesian
+  // product.
+  auto qet = h::parseAndPlan(prefix +
+                                 "SELECT * WHERE { ?x <p> ?a . ?y <q> ?b "
+                                 "FILTER(geof:distance(?a, ?b) > 10) }",
+                             ad_utility::testing::getQec());
+  EXPECT_EQ(qet.getType(), QueryExecutionTree::FILTER);
+}
+
+// __________________________________________________________________________
+TEST(QueryPlannerTest, shareResultsOfIdenticalSubtrees) {
+  auto qec = ad_utility::testing::getQec(
+      "<a> <p> <b> . <b> <p> <c> . <c> <p> <d> . <b> <q> <e> .");
+  std::string query =
+      "SELECT * WHERE { { ?x <p> ?y . ?y <p> ?z } UNION "
+      "{ ?x <p> ?y . ?y <p> ?z } }";
+  auto getSharedChildren = [](const QueryExecutionTree& qet) {
+    size_t numShared = 0;
+    for (auto* child : qet.getRootOperation()->getChildren()) {
+      numShared += child->getRootOperation()->runtimeInfo().details_.contains(
+          "shared-with-identical-subtree");
+    }
+    return numShared;
+  };
+  qec->clearCacheUnpinnedOnly();
+  auto qet = h::parseAndPlan(query, qec);
+  ASSERT_EQ(qet.getType(), QueryExecutionTree::UNION);
+  auto result = qet.getResult();
+  EXPECT_EQ(result->size(), 4u);
+  // The second branch of the UNION uses the result of the first one.
+  EXPECT_EQ(getSharedChildren(qet), 1u);
+  // The shared result is also used when the tree is executed again.
+  qec->clearCacheUnpinnedOnly();
+  EXPECT_EQ(qet.getResult()->idTable(), result->idTable());
+  EXPECT_EQ(getSharedChildren(qet), 1u);
+
+  RuntimeParameters().set<"share-results-of-identical-subtrees">(false);
+  qec->clearCacheUnpinnedOnly();
+  auto unshared = h::parseAndPlan(query, qec);
+  EXPECT_EQ(unshared.getResult()->idTable(), result->idTable());
+  EXPECT_EQ(getSharedChildren(unshared), 0u);
+  RuntimeParameters().set<"share-results-of-identical-subtrees">(true);
+}
+
+// _____________________________________________________________________________
+TEST(QueryPlannerTest, pushFiltersIntoChildren) {
+  auto scan = h::IndexScanFromStrings;
+  // A FILTER on variables that are bound in both branches of a UNION is
+  // applied to each of the branches.
+  h::expect(
+      "SELECT * WHERE { { ?x <p> ?y } UNION { ?x <q> ?y } FILTER(?y < 3) }",
+      h::Union(h::Filter(scan("?x", "<p>", "?y")),
+               h::Filter(scan("?x", "<q>", "?y"))));
+  // This also works for nested groups and UNIONs.
+  h::expect(
+      "SELECT * WHERE { { { ?x <p> ?y } UNION { { ?x <q> ?y } UNION "
+      "{ ?x <r> ?y } } } FILTER(?y < 3) }",
+      h::Union(h::Filter(scan("?x", "<p>", "?y")),
+               h::Union(h::Filter(scan("?x", "<q>", "?y")),
+                        h::Filter(scan("?x", "<r>", "?y")))));
+  // `?y` is not bound in the second branch, so the FILTER stays above the
+  // UNION.
+  h::expect(
+      "SELECT * WHERE { { ?x <p> ?y } UNION { ?x <q> ?z } FILTER(?y < 3) }",
+      h::Filter(h::Union(scan("?x", "<p>", "?y"), scan("?x", "<q>", "?z"))));
+  // In a subquery, the FILTER is applied directly to the scan, but not if the
+  // subquery has a LIMIT, which has to be applied before the FILTER.
+  auto getTypeOfChildOfFilter = [](const QueryExecutionTree& qet) {
+    std::vector<const QueryExecutionTree*> stack{&qet};
+    while (!stack.empty()) {
+      const auto* tree = stack.back();
+      stack.pop_back();
+      auto children = tree->getRootOperation()->getChildren();
+      if (tree->getType() == QueryExecutionTree::FILTER) {
+        return children.at(0)->getType();
+      }
+      std::ranges::copy(children, std::back_inserter(stack));
+    }
+    return QueryExecutionTree::UNDEFINED;
+  };
+  auto qec = ad_utility::testing::getQec("<a> <p> 1 . <a> <q> <b> .");
+  auto planSubquery = [&qec](std::string_view limit) {
+    return h::parseAndPlan(
+        absl::StrCat("SELECT * WHERE { { SELECT ?x ?y WHERE { ?x <p> ?y } ",
+                     limit, " } ?x <q> ?z FILTER(?y < 3) }"),
+        qec);
+  };
+  EXPECT_EQ(getTypeOfChildOfFilter(planSubquery("")),
+            QueryExecutionTree::SCAN);
+  EXPECT_NE(getTypeOfChildOfFilter(planSubquery("LIMIT 1")),
+            QueryExecutionTree::SCAN);
+}
+
+// _____________________________________________________________________________
+TEST(QueryPlannerTest, alternativePathIsMultiPredicateScan) {
+  auto qec = ad_utility::testing::getQec(
+      "<a> <p> <b> . <b> <q> <c> . <c> <r> <a> . <a> <s> <b> .");
+  auto qet = h::parseAndPlan("SELECT * WHERE { ?x <p>|<q> ?y }", qec);
+  EXPECT_EQ(qet.getType(), QueryExecutionTree::MULTI_PREDICATE_SCAN);
+  EXPECT_EQ(qet.getResult()->idTable().numRows(), 2u);
+
+  // The alternative is also read by a single scan if it is part of a
+  // sequence.
+  auto sequence =
+      h::parseAndPlan("SELECT * WHERE { ?x <s>/(<p>|<q>|<r>) ?y }", qec);
+  size_t numMultiPredicateScans = 0;
+  sequence.forAllDescendants(
+      [&numMultiPredicateScans](const QueryExecutionTree* tree) {
+        numMultiPredicateScans +=
+            tree->getType() == QueryExecutionTree::MULTI_PREDICATE_SCAN;
+      });
+  EXPECT_EQ(numMultiPredicateScans, 1u);
+  EXPECT_EQ(sequence.getResult()->idTable().numRows(), 1u);
+}
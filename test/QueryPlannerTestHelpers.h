@@ -8,16 +8,20 @@
 #include "./util/GTestHelpers.h"
 #include "engine/Bind.h"
 #include "engine/CartesianProductJoin.h"
+#include "engine/Filter.h"
 #include "engine/IndexScan.h"
 #include "engine/Join.h"
 #include "engine/MultiColumnJoin.h"
 #include "engine/NeutralElementOperation.h"
 #include "engine/QueryExecutionTree.h"
 #include "engine/QueryPlanner.h"
+#include "engine/SemiJoin.h"
 #include "engine/Sort.h"
 #include "engine/TextIndexScanForEntity.h"
 #include "engine/TextIndexScanForWord.h"
 #include "engine/TransitivePath.h"
+#include "engine/Union.h"
+#include "engine/WorstCaseOptimalJoin.h"
 #include "gmock/gmock-matchers.h"
 #include "gmock/gmock.h"
 #include "parser/SparqlParser.h"
@@ -163,6 +167,12 @@ inline auto IndexScanFromStrings =
 inline auto MultiColumnJoin = MatchTypeAndUnorderedChildren<::MultiColumnJoin>;
 inline auto Join = MatchTypeAndUnorderedChildren<::Join>;
 
+// For a `SemiJoin`, the first child is the input the rows of which are kept.
+inline auto SemiJoin = MatchTypeAndOrderedChildren<::SemiJoin>;
+
+inline auto Filter = MatchTypeAndOrderedChildren<::Filter>;
+inline auto Union = MatchTypeAndOrderedChildren<::Union>;
+
 // Return a matcher that matches a query execution tree that consists of
 // multiple JOIN operations that join the `children`. The `INTERNAL SORT BY`
 // operations required for the joins are also ignored by this matcher.
@@ -197,6 +207,9 @@ inline auto UnorderedJoins = [](auto&&... children) -> QetMatcher {
 inline auto CartesianProductJoin =
     MatchTypeAndUnorderedChildren<::CartesianProductJoin>;
 
+inline auto WorstCaseOptimalJoin =
+    MatchTypeAndUnorderedChildren<::WorstCaseOptimalJoin>;
+
 inline auto TransitivePathSideMatcher = [](TransitivePathSide side) {
   return AllOf(AD_FIELD(TransitivePathSide, value_, Eq(side.value_)),
                AD_FIELD(TransitivePathSide, subCol_, Eq(side.subCol_)),
@@ -0,0 +1,74 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "./util/GTestHelpers.h"
+#include "engine/QueryRuntimeEstimator.h"
+#include "global/Constants.h"
+#include "util/CancellationHandle.h"
+
+using namespace std::chrono_literals;
+
+// _____________________________________________________________________________
+TEST(QueryRuntimeEstimator, estimatesAfterEnoughObservations) {
+  QueryRuntimeEstimator estimator;
+  // Fast queries are not recorded.
+  estimator.record(999, 1ms);
+  EXPECT_EQ(estimator.numObservations(), 0);
+
+  // 100 ms for a cost of 1000, i.e. 0.1 ms per unit of cost (the cost is
+  // incremented by one).
+  for (size_t i = 0; i + 1 < QueryRuntimeEstimator::MIN_NUM_OBSERVATIONS;
+       ++i) {
+    estimator.record(999, 100ms);
+    EXPECT_FALSE(estimator.estimateRuntime(999).has_value());
+  }
+  estimator.record(999, 100ms);
+  EXPECT_EQ(estimator.numObservations(),
+            QueryRuntimeEstimator::MIN_NUM_OBSERVATIONS);
+  auto estimate = estimator.estimateRuntime(9'999);
+  ASSERT_TRUE(estimate.has_value());
+  EXPECT_NEAR(estimate.value().count(), 1'000, 1);
+
+  // A slower observation moves the average towards it.
+  estimator.record(999, 1'000ms);
+  estimate = estimator.estimateRuntime(9'999);
+  ASSERT_TRUE(estimate.has_value());
+  EXPECT_GT(estimate.value().count(), 1'000);
+  EXPECT_LT(estimate.value().count(), 10'000);
+
+  estimator.clear();
+  EXPECT_EQ(estimator.numObservations(), 0);
+  EXPECT_FALSE(estimator.estimateRuntime(999).has_value());
+}
+
+// _____________________________________________________________________________
+TEST(QueryRuntimeEstimator, throwIfEstimateExceedsRemainingTime) {
+  QueryRuntimeEstimator estimator;
+  auto factorBefore =
+      RuntimeParameters().get<"runtime-estimate-cancellation-factor">();
+  RuntimeParameters().set<"runtime-estimate-cancellation-factor">(2.0);
+  // Without enough observations, nothing is canceled.
+  EXPECT_NO_THROW(estimator.throwIfEstimateExceedsRemainingTime(
+      1'000'000, 1ms, "The query"));
+
+  // 1 ms per unit of cost.
+  for (size_t i = 0; i < QueryRuntimeEstimator::MIN_NUM_OBSERVATIONS; ++i) {
+    estimator.record(99, 100ms);
+  }
+  EXPECT_NO_THROW(
+      estimator.throwIfEstimateExceedsRemainingTime(99, 50ms, "The query"));
+  AD_EXPECT_THROW_WITH_MESSAGE_AND_TYPE(
+      estimator.throwIfEstimateExceedsRemainingTime(99, 49ms, "The query"),
+      ::testing::HasSubstr("The query was canceled before its computation"),
+      ad_utility::CancellationException);
+
+  // The check can be disabled.
+  RuntimeParameters().set<"runtime-estimate-cancellation-factor">(0.0);
+  EXPECT_NO_THROW(
+      estimator.throwIfEstimateExceedsRemainingTime(99, 1ms, "The query"));
+  RuntimeParameters().set<"runtime-estimate-cancellation-factor">(
+      factorBefore);
+}
@@ -0,0 +1,123 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "util/QueryTrace.h"
+#include "util/jthread.h"
+
+using ad_utility::QueryTrace;
+
+namespace {
+// The span with the `name` from the `spans`.
+const QueryTrace::Span& getSpan(const std::vector<QueryTrace::Span>& spans,
+                                std::string_view name) {
+  auto it = std::ranges::find(spans, name, &QueryTrace::Span::name_);
+  AD_CORRECTNESS_CHECK(it != spans.end());
+  return *it;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(QueryTrace, spansAreOnlyRecordedWithATrace) {
+  ASSERT_EQ(QueryTrace::current(), nullptr);
+  {
+    QueryTrace::ScopedSpan span{"untraced", "test"};
+    EXPECT_FALSE(span.isRecorded());
+  }
+  QueryTrace trace;
+  {
+    QueryTrace::Scope scope{&trace};
+    EXPECT_EQ(QueryTrace::current(), &trace);
+    QueryTrace::ScopedSpan span{"traced", "test"};
+    EXPECT_TRUE(span.isRecorded());
+  }
+  EXPECT_EQ(QueryTrace::current(), nullptr);
+  auto spans = trace.spans();
+  ASSERT_EQ(spans.size(), 1u);
+  EXPECT_EQ(spans[0].name_, "traced");
+  EXPECT_EQ(spans[0].category_, "test");
+  EXPECT_EQ(spans[0].parentId_, 0u);
+  EXPECT_LE(spans[0].begin_, spans[0].end_);
+}
+
+// _____________________________________________________________________________
+TEST(QueryTrace, nestedSpansAndThreads) {
+  QueryTrace trace;
+  {
+    QueryTrace::Scope scope{&trace};
+    QueryTrace::ScopedSpan outer{"outer", "operation"};
+    outer.addAttribute("num-rows", "42");
+    {
+      QueryTrace::ScopedSpan inner{"inner", "io"};
+    }
+    // The context is propagated to another thread.
+    auto context = QueryTrace::currentContext();
+    ad_utility::JThread thread{[context]() {
+      QueryTrace::Scope threadScope{context};
+      QueryTrace::ScopedSpan span{"onOtherThread", "decompression"};
+    }};
+    thread.join();
+    // Setting the same trace again doesn't change the parent.
+    QueryTrace::Scope sameTrace{&trace};
+    QueryTrace::ScopedSpan second{"secondInner", "io"};
+  }
+  auto spans = trace.spans();
+  ASSERT_EQ(spans.size(), 4u);
+  const auto& outer = getSpan(spans, "outer");
+  EXPECT_EQ(outer.parentId_, 0u);
+  QueryTrace::Attributes expectedAttributes{{"num-rows", "42"}};
+  EXPECT_EQ(outer.attributes_, expectedAttributes);
+  for (auto name : {"inner", "onOtherThread", "secondInner"}) {
+    EXPECT_EQ(getSpan(spans, name).parentId_, outer.id_) << name;
+  }
+  EXPECT_EQ(getSpan(spans, "inner").threadIndex_, outer.threadIndex_);
+  EXPECT_NE(getSpan(spans, "onOtherThread").threadIndex_, outer.threadIndex_);
+
+  // A span with an explicit parent.
+  auto id = trace.addSpan("explicit", "lazy-block", QueryTrace::Clock::now(),
+                          outer.id_, {{"key", "value"}});
+  EXPECT_EQ(getSpan(trace.spans(), "explicit").id_, id);
+}
+
+// _____________________________________________________________________________
+TEST(QueryTrace, export) {
+  QueryTrace trace;
+  {
+    QueryTrace::Scope scope{&trace};
+    QueryTrace::ScopedSpan outer{"outer", "operation"};
+    outer.addAttribute("cache-status", "computed");
+    QueryTrace::ScopedSpan inner{"inner", "io"};
+  }
+
+  auto chrome = trace.toChromeTrace();
+  const auto& events = chrome.at("traceEvents");
+  // The two spans and the name of the single thread.
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[0].at("name"), "outer");
+  EXPECT_EQ(events[0].at("ph"), "X");
+  EXPECT_EQ(events[0].at("cat"), "operation");
+  EXPECT_EQ(events[0].at("args").at("cache-status"), "computed");
+  EXPECT_EQ(events[1].at("name"), "inner");
+  EXPECT_GE(events[1].at("ts").get<double>(), events[0].at("ts").get<double>());
+  EXPECT_EQ(events[2].at("ph"), "M");
+
+  auto otel = trace.toOpenTelemetry("test-service");
+  const auto& resourceSpans = otel.at("resourceSpans").at(0);
+  EXPECT_EQ(resourceSpans.at("resource").at("attributes").at(0).at("value").at(
+                "stringValue"),
+            "test-service");
+  const auto& spans = resourceSpans.at("scopeSpans").at(0).at("spans");
+  ASSERT_EQ(spans.size(), 2u);
+  // The `inner` span is finished and therefore recorded first.
+  const auto& inner = spans[0];
+  const auto& outer = spans[1];
+  EXPECT_EQ(inner.at("name"), "inner");
+  EXPECT_EQ(inner.at("traceId"), outer.at("traceId"));
+  EXPECT_EQ(inner.at("traceId").get<std::string>().size(), 32u);
+  EXPECT_EQ(inner.at("spanId").get<std::string>().size(), 16u);
+  EXPECT_EQ(inner.at("parentSpanId"), outer.at("spanId"));
+  EXPECT_FALSE(outer.contains("parentSpanId"));
+  EXPECT_LE(std::stoull(outer.at("startTimeUnixNano").get<std::string>()),
+            std::stoull(inner.at("startTimeUnixNano").get<std::string>()));
+}
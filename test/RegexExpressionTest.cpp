@@ -154,6 +154,36 @@ TEST(RegexExpression, getPrefixRegex) {
   ASSERT_THROW(getPrefixRegex(R"(^\")"), std::runtime_error);
 }
 
+TEST(RegexExpression, getRequiredLiteral) {
+  using namespace sparqlExpression::detail;
+  EXPECT_EQ("alpha", getRequiredLiteral("alpha"));
+  EXPECT_EQ("alpha", getRequiredLiteral("^alpha$"));
+  EXPECT_EQ("beta", getRequiredLiteral("al.beta"));
+  EXPECT_EQ("lph", getRequiredLiteral("a*lpha?"));
+  EXPECT_EQ("alp", getRequiredLiteral("b?alp+ha"));
+  EXPECT_EQ("gamma", getRequiredLiteral("ab{2,3}gamma"));
+  EXPECT_EQ("beta", getRequiredLiteral("[al]pha\\dbeta"));
+  EXPECT_EQ("a.b", getRequiredLiteral(R"(a\.b)"));
+  EXPECT_EQ("x]y", getRequiredLiteral("[]a]x]y"));
+  EXPECT_EQ("alph", getRequiredLiteral("alph(a|b)"));
+  // A quantifier removes the complete UTF-8 character.
+  EXPECT_EQ("alp", getRequiredLiteral("alpä*"));
+  EXPECT_EQ("", getRequiredLiteral("alpha|beta"));
+  EXPECT_EQ("", getRequiredLiteral("(?i:alpha)"));
+  EXPECT_EQ("", getRequiredLiteral(R"(\x41)"));
+  EXPECT_EQ("", getRequiredLiteral("a*"));
+}
+
+// Evaluating a non-prefix regex again yields the same (memoized) result.
+TEST(RegexExpression, nonPrefixRegexMemoized) {
+  auto expr = makeRegexExpression("?vocab", "l[^a]{2}a");
+  testWithExplicitResult(expr, {F, T, T});
+  testWithExplicitResult(expr, {F, T, T});
+  auto exprWithStr = makeRegexExpression("?mixed", "x", std::nullopt, true);
+  testWithExplicitResult(exprWithStr, {F, F, T});
+  testWithExplicitResult(exprWithStr, {F, F, T});
+}
+
 auto testPrefixRegexUnorderedColumn =
     [](std::string variable, std::string regex,
        const std::vector<Id>& expectedResult, bool childAsStr = false,
@@ -8,6 +8,8 @@
 #include "./SparqlExpressionTestHelpers.h"
 #include "./util/AllocatorTestHelpers.h"
 #include "./util/GTestHelpers.h"
+#include "engine/sparqlExpressions/LiteralExpression.h"
+#include "engine/sparqlExpressions/NaryExpression.h"
 #include "engine/sparqlExpressions/RelationalExpressions.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -783,3 +785,87 @@ TEST(RelationalExpression, VariableAndConstantBinarySearch) {
 // because the relational expressions do not work properly with the current
 // limited implementation of the local vocabularies. Add those tests, as soon as
 // the local vocabularies are implemented properly.
+
+namespace {
+SparqlExpression::Ptr var(std::string_view name) {
+  return std::make_unique<VariableExpression>(Variable{std::string{name}});
+}
+SparqlExpression::Ptr idExpr(Id value) {
+  return std::make_unique<IdExpression>(value);
+}
+// The `RelationalExpression` `left <comp> right`.
+template <Comparison comp>
+SparqlExpression::Ptr compare(SparqlExpression::Ptr left,
+                              SparqlExpression::Ptr right) {
+  return std::make_unique<relational::RelationalExpression<comp>>(
+      std::array{std::move(left), std::move(right)});
+}
+// The expression `YEAR(?d) <comp> value`.
+template <Comparison comp>
+SparqlExpression::Ptr yearIs(int64_t value) {
+  return compare<comp>(makeYearExpression(var("?d")), idExpr(IntId(value)));
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(RelationalExpression, getDateRange) {
+  using D = DateOrLargeYear;
+  using Range = std::pair<std::pair<int64_t, int>, std::pair<int64_t, int>>;
+  auto getRange = [](const SparqlExpression::Ptr& expression) {
+    auto data = expression->getDateRange();
+    EXPECT_TRUE(data.has_value());
+    return Range{data.value().first_, data.value().last_};
+  };
+
+  EXPECT_EQ(getRange(yearIs<EQ>(2020)), Range({2020, 0}, {2020, 12}));
+  EXPECT_EQ(getRange(yearIs<LT>(2020)), Range({D::minYear, 0}, {2019, 12}));
+  EXPECT_EQ(getRange(yearIs<GT>(2020)), Range({2021, 0}, {D::maxYear, 12}));
+  // The constant can also be the left operand.
+  EXPECT_EQ(
+      getRange(compare<LE>(idExpr(IntId(2020)), makeYearExpression(var("?d")))),
+      Range({2020, 0}, {D::maxYear, 12}));
+  // Years that cannot be represented lead to an empty range.
+  auto empty = getRange(yearIs<GT>(D::maxYear));
+  EXPECT_GT(empty.first, empty.second);
+  // A comparison of the variable itself with a date.
+  Id date = Id::makeFromDate(D{Date{2020, 5, 17}});
+  EXPECT_EQ(getRange(compare<LT>(var("?d"), idExpr(date))),
+            Range({D::minYear, 0}, {2020, 5}));
+
+  // Comparisons that don't restrict the date.
+  EXPECT_FALSE(yearIs<NE>(2020)->getDateRange().has_value());
+  EXPECT_FALSE(compare<EQ>(makeYearExpression(var("?d")), idExpr(DoubleId(2)))
+                   ->getDateRange()
+                   .has_value());
+  EXPECT_FALSE(
+      compare<EQ>(var("?d"), idExpr(IntId(3)))->getDateRange().has_value());
+
+  // The combination of `YEAR` and `MONTH` and the corresponding `ValueId`s.
+  auto makeId = [](int64_t year, int month) {
+    return Id::makeFromDate(D::getFirstOfYearAndMonth(year, month));
+  };
+  auto previous = [](Id id) { return Id::fromBits(id.getBits() - 1); };
+  auto march = compare<EQ>(makeMonthExpression(var("?d")), idExpr(IntId(3)));
+  auto monthOnly = march->getDateRange();
+  ASSERT_TRUE(monthOnly.has_value());
+  EXPECT_EQ(monthOnly->firstMonth_, 3);
+  EXPECT_EQ(monthOnly->lastMonth_, 3);
+  // The dates of a month in all years are not contiguous.
+  EXPECT_FALSE(monthOnly->getIdRange().has_value());
+  auto inMarch2020 =
+      makeAndExpression(yearIs<EQ>(2020), std::move(march))->getDateRange();
+  ASSERT_TRUE(inMarch2020.has_value());
+  EXPECT_EQ(inMarch2020->variable_, Variable{"?d"});
+  EXPECT_EQ(inMarch2020->getIdRange(),
+            std::pair(makeId(2020, 3), previous(makeId(2020, 4))));
+  auto years = makeAndExpression(yearIs<GE>(2015), yearIs<LE>(2019));
+  EXPECT_EQ(years->getDateRange()->getIdRange(),
+            std::pair(makeId(2015, 0), previous(makeId(2020, 0))));
+  // For different variables, only one of the ranges is used.
+  auto otherVariable = makeAndExpression(
+      yearIs<EQ>(2015),
+      compare<EQ>(makeYearExpression(var("?e")), idExpr(IntId(2016))));
+  auto range = otherVariable->getDateRange();
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(range->first_.first, range->last_.first);
+}
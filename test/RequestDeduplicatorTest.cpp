@@ -0,0 +1,44 @@
+//  Copyright 2026, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "util/http/RequestDeduplicator.h"
+
+using ad_utility::httpUtils::RequestDeduplicator;
+
+// _____________________________________________________________________________
+TEST(RequestDeduplicator, identicalRequestsShareTheResponse) {
+  RequestDeduplicator<std::string> deduplicator;
+  std::vector<std::string> received;
+  auto receive = [&received](std::shared_ptr<const std::string> response) {
+    received.push_back(response ? *response : "aborted");
+  };
+
+  EXPECT_TRUE(deduplicator.registerOrWait("a", receive));
+  EXPECT_FALSE(deduplicator.registerOrWait("a", receive));
+  EXPECT_FALSE(deduplicator.registerOrWait("a", receive));
+  EXPECT_TRUE(deduplicator.registerOrWait("b", receive));
+  EXPECT_EQ(deduplicator.numInFlight(), 2u);
+  EXPECT_TRUE(received.empty());
+
+  deduplicator.publish("a", std::make_shared<const std::string>("responseA"));
+  EXPECT_EQ(received, (std::vector<std::string>{"responseA", "responseA"}));
+  EXPECT_EQ(deduplicator.numInFlight(), 1u);
+
+  // After the publication, the next request with the same key is computed
+  // again.
+  EXPECT_TRUE(deduplicator.registerOrWait("a", receive));
+  EXPECT_FALSE(deduplicator.registerOrWait("b", receive));
+  deduplicator.publish("b", nullptr);
+  deduplicator.publish("a", nullptr);
+  EXPECT_EQ(received, (std::vector<std::string>{"responseA", "responseA",
+                                                "aborted"}));
+  EXPECT_EQ(deduplicator.numInFlight(), 0u);
+
+  // Only keys that are in flight can be published.
+  EXPECT_ANY_THROW(deduplicator.publish("a", nullptr));
+}
@@ -0,0 +1,74 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <boost/asio/post.hpp>
+#include <chrono>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "util/ResizableThreadPool.h"
+
+using ad_utility::ResizableThreadPool;
+using namespace std::chrono_literals;
+
+namespace {
+// Run `numTasks` tasks on the `pool` that each wait until all of them have
+// started (which blocks forever if the pool has fewer threads), and return the
+// number of distinct threads on which they ran.
+size_t runConcurrentTasks(ResizableThreadPool& pool, size_t numTasks) {
+  std::latch allStarted{static_cast<ptrdiff_t>(numTasks)};
+  std::latch allFinished{static_cast<ptrdiff_t>(numTasks)};
+  std::mutex mutex;
+  std::set<std::thread::id> threadIds;
+  for (size_t i = 0; i < numTasks; ++i) {
+    boost::asio::post(pool.getExecutor(), [&]() {
+      {
+        std::lock_guard lock{mutex};
+        threadIds.insert(std::this_thread::get_id());
+      }
+      allStarted.arrive_and_wait();
+      allFinished.count_down();
+    });
+  }
+  allFinished.wait();
+  return threadIds.size();
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ResizableThreadPool, resize) {
+  ResizableThreadPool pool{2};
+  EXPECT_EQ(pool.numThreads(), 2u);
+  EXPECT_EQ(runConcurrentTasks(pool, 2), 2u);
+
+  pool.resize(5);
+  EXPECT_EQ(pool.numThreads(), 5u);
+  EXPECT_EQ(runConcurrentTasks(pool, 5), 5u);
+
+  // After shrinking, the tasks only run on the remaining threads.
+  pool.resize(1);
+  EXPECT_EQ(pool.numThreads(), 1u);
+  std::this_thread::sleep_for(300ms);
+  std::mutex mutex;
+  std::set<std::thread::id> threadIds;
+  std::latch finished{20};
+  for (size_t i = 0; i < 20; ++i) {
+    boost::asio::post(pool.getExecutor(), [&]() {
+      std::lock_guard lock{mutex};
+      threadIds.insert(std::this_thread::get_id());
+      finished.count_down();
+    });
+  }
+  finished.wait();
+  EXPECT_EQ(threadIds.size(), 1u);
+
+  // The pool always has at least one thread.
+  pool.resize(0);
+  EXPECT_EQ(pool.numThreads(), 1u);
+  pool.resize(3);
+  EXPECT_EQ(runConcurrentTasks(pool, 3), 3u);
+}
@@ -0,0 +1,94 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./util/IdTableHelpers.h"
+#include "engine/ResultCursors.h"
+
+using namespace std::chrono_literals;
+using ad_utility::MemorySize;
+
+namespace {
+// A `ResultCursors` with a manual clock.
+struct TestCursors {
+  ResultCursors::Clock::time_point now_{};
+  ResultCursors cursors_{[this] { return now_; }};
+};
+
+// A cursor for a result with `numRows` rows and two columns.
+ResultCursors::Cursor makeCursor(size_t numRows) {
+  VectorTable rows;
+  for (size_t i = 0; i < numRows; ++i) {
+    rows.push_back({static_cast<int64_t>(i), static_cast<int64_t>(2 * i)});
+  }
+  ResultCursors::Cursor cursor;
+  cursor.result_ = std::make_shared<const ResultTable>(
+      makeIdTableFromVector(rows), std::vector<ColumnIndex>{}, LocalVocab{});
+  cursor.selectedVariables_ = {"?x", "?y"};
+  cursor.endRow_ = numRows;
+  return cursor;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ResultCursors, openGetAndClose) {
+  TestCursors t;
+  auto handle = t.cursors_.open(makeCursor(3), 10s);
+  EXPECT_EQ(handle.size(), 32u);
+  auto otherHandle = t.cursors_.open(makeCursor(5), 10s);
+  EXPECT_NE(handle, otherHandle);
+  EXPECT_EQ(t.cursors_.numCursors(), 2u);
+  EXPECT_EQ(t.cursors_.size(), MemorySize::bytes(8 * 2 * sizeof(Id)));
+
+  auto cursor = t.cursors_.get(handle);
+  ASSERT_NE(cursor, nullptr);
+  EXPECT_EQ(cursor->numRows(), 3u);
+  EXPECT_EQ(cursor->selectedVariables_,
+            (std::vector<std::string>{"?x", "?y"}));
+  EXPECT_EQ(t.cursors_.get("unknown"), nullptr);
+
+  EXPECT_TRUE(t.cursors_.close(handle));
+  EXPECT_FALSE(t.cursors_.close(handle));
+  EXPECT_EQ(t.cursors_.get(handle), nullptr);
+  // A result that is still used (by a page that is serialized) stays valid.
+  EXPECT_EQ(cursor->result_->idTable().numRows(), 3u);
+  EXPECT_EQ(t.cursors_.numCursors(), 1u);
+}
+
+// _____________________________________________________________________________
+TEST(ResultCursors, ttlIsRestartedByEachAccess) {
+  TestCursors t;
+  auto handle = t.cursors_.open(makeCursor(1), 10s);
+  auto shortLived = t.cursors_.open(makeCursor(1), 2s);
+  t.now_ += 8s;
+  EXPECT_NE(t.cursors_.get(handle), nullptr);
+  EXPECT_EQ(t.cursors_.get(shortLived), nullptr);
+  t.now_ += 8s;
+  EXPECT_NE(t.cursors_.get(handle), nullptr);
+  t.now_ += 10s;
+  EXPECT_EQ(t.cursors_.get(handle), nullptr);
+  EXPECT_EQ(t.cursors_.numCursors(), 0u);
+}
+
+// _____________________________________________________________________________
+TEST(ResultCursors, makeRoomEvictsLeastRecentlyUsed) {
+  TestCursors t;
+  auto sizeOfCursor = MemorySize::bytes(10 * 2 * sizeof(Id));
+  auto first = t.cursors_.open(makeCursor(10), 1min);
+  t.now_ += 1s;
+  auto second = t.cursors_.open(makeCursor(10), 1min);
+  t.now_ += 1s;
+  auto third = t.cursors_.open(makeCursor(10), 1min);
+  t.now_ += 1s;
+  // Accessing the first cursor makes the second one the least recently used.
+  EXPECT_NE(t.cursors_.get(first), nullptr);
+
+  EXPECT_EQ(t.cursors_.makeRoom(MemorySize::bytes(0)), 0u);
+  EXPECT_EQ(t.cursors_.makeRoom(MemorySize::bytes(1)), 1u);
+  EXPECT_EQ(t.cursors_.get(second), nullptr);
+  EXPECT_EQ(t.cursors_.makeRoom(sizeOfCursor + MemorySize::bytes(1)), 2u);
+  EXPECT_EQ(t.cursors_.get(third), nullptr);
+  EXPECT_EQ(t.cursors_.get(first), nullptr);
+  EXPECT_EQ(t.cursors_.makeRoom(sizeOfCursor), 0u);
+}
@@ -0,0 +1,135 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./IndexTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "engine/IndexScan.h"
+#include "engine/SemiJoin.h"
+#include "engine/ValuesForTesting.h"
+
+namespace {
+using Vars = std::vector<std::optional<Variable>>;
+
+auto table(size_t cols) {
+  return IdTable(cols, ad_utility::testing::makeAllocator());
+}
+
+// An input for a `SemiJoin` with the `table` (which must be sorted) that is
+// yielded lazily in blocks of size `lazyBlockSize` if laziness is requested.
+std::shared_ptr<QueryExecutionTree> makeInput(
+    IdTable table, Vars variables, std::optional<size_t> lazyBlockSize = {}) {
+  auto tree = ad_utility::makeExecutionTree<ValuesForTesting>(
+      ad_utility::testing::getQec(), std::move(table), std::move(variables));
+  auto& values = dynamic_cast<ValuesForTesting&>(*tree->getRootOperation());
+  values.lazyBlockSize() = lazyBlockSize;
+  for (ColumnIndex i = 0; i < tree->getResultWidth(); ++i) {
+    values.sortedColumns().push_back(i);
+  }
+  return tree;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(SemiJoin, eachLeftRowAtMostOnce) {
+  auto left = makeInput(
+      makeIdTableFromVector({{1, 1, 10}, {1, 2, 11}, {2, 1, 12}, {3, 3, 13}}),
+      Vars{Variable{"?x"}, Variable{"?y"}, Variable{"?a"}});
+  // The first left row has two matches, the third and the fourth none.
+  auto right = makeInput(
+      makeIdTableFromVector({{1, 1, 5}, {1, 1, 6}, {1, 2, 7}, {2, 2, 8}}),
+      Vars{Variable{"?x"}, Variable{"?y"}, Variable{"?b"}});
+  SemiJoin semiJoin{ad_utility::testing::getQec(), left, right};
+  EXPECT_EQ(semiJoin.getResultWidth(), 3u);
+  EXPECT_EQ(semiJoin.getDescriptor(), "Semi-join");
+  EXPECT_FALSE(semiJoin.getExternallyVisibleVariableColumns().contains(
+      Variable{"?b"}));
+  EXPECT_EQ(semiJoin.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{1, 1, 10}, {1, 2, 11}}));
+
+  SemiJoin swapped{ad_utility::testing::getQec(), right, left};
+  EXPECT_NE(semiJoin.getCacheKey(), swapped.getCacheKey());
+  EXPECT_EQ(swapped.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{1, 1, 5}, {1, 1, 6}, {1, 2, 7}}));
+}
+
+// _____________________________________________________________________________
+TEST(SemiJoin, lazyLeftInput) {
+  VectorTable leftRows;
+  VectorTable expected;
+  for (int64_t i = 0; i < 100; ++i) {
+    leftRows.push_back({5 * i, i});
+    if (i % 2 == 0) {
+      expected.push_back({5 * i, i});
+    }
+  }
+  // Every left row with an even value of `?x` has three matches, and between
+  // two left rows, the right input has runs of rows without a match, which are
+  // skipped by galloping.
+  VectorTable rightRows;
+  for (int64_t i = 0; i < 3'000; ++i) {
+    rightRows.push_back({2 * (i / 3)});
+  }
+  auto left = makeInput(makeIdTableFromVector(leftRows),
+                        Vars{Variable{"?x"}, Variable{"?y"}}, 7);
+  auto right =
+      makeInput(makeIdTableFromVector(rightRows), Vars{Variable{"?x"}});
+  SemiJoin semiJoin{ad_utility::testing::getQec(), left, right};
+
+  auto result = semiJoin.computeResultOnlyForTesting(true);
+  ASSERT_FALSE(result.isFullyMaterialized());
+  IdTable concatenated = table(2);
+  for (const auto& [block, localVocab] : result.idTables()) {
+    EXPECT_FALSE(block.empty());
+    concatenated.insertAtEnd(block);
+  }
+  EXPECT_EQ(concatenated, makeIdTableFromVector(expected));
+
+  auto materialized = semiJoin.computeResultOnlyForTesting(false);
+  EXPECT_EQ(materialized.idTable(), makeIdTableFromVector(expected));
+}
+
+// _____________________________________________________________________________
+TEST(SemiJoin, withoutSharedVariables) {
+  auto* qec = ad_utility::testing::getQec();
+  auto left =
+      makeInput(makeIdTableFromVector({{1}, {2}}), Vars{Variable{"?x"}});
+  auto right = makeInput(makeIdTableFromVector({{3}}), Vars{Variable{"?y"}});
+  auto emptyRight = makeInput(table(1), Vars{Variable{"?y"}});
+
+  SemiJoin semiJoin{qec, left, right};
+  EXPECT_EQ(semiJoin.computeResultOnlyForTesting().idTable(),
+            makeIdTableFromVector({{1}, {2}}));
+  SemiJoin semiJoinEmpty{qec, left, emptyRight};
+  EXPECT_EQ(semiJoinEmpty.computeResultOnlyForTesting().idTable().numRows(),
+            0u);
+}
+
+// _____________________________________________________________________________
+TEST(SemiJoin, onlyReadsTheMatchingBlocksOfAnIndexScan) {
+  std::string turtle;
+  for (size_t i = 0; i < 50; ++i) {
+    absl::StrAppend(&turtle, "<s", i, "> <p> <o", i, "> . ");
+  }
+  auto* qec = ad_utility::testing::getQec(turtle);
+  auto id = ad_utility::testing::makeGetId(qec->getIndex());
+  std::vector<Id> leftIds{id("<s3>"), id("<o4>")};
+  std::ranges::sort(leftIds);
+  IdTable leftTable = table(1);
+  for (Id leftId : leftIds) {
+    leftTable.push_back({leftId});
+  }
+  auto left = makeInput(std::move(leftTable), Vars{Variable{"?s"}});
+  auto scan = ad_utility::makeExecutionTree<IndexScan>(
+      qec, Permutation::PSO,
+      SparqlTriple{Variable{"?s"}, "<p>", Variable{"?o"}});
+  qec->clearCacheUnpinnedOnly();
+
+  SemiJoin semiJoin{qec, left, scan};
+  auto result = semiJoin.computeResultOnlyForTesting();
+  EXPECT_EQ(result.idTable(), makeIdTableFromVector({{id("<s3>")}}));
+  auto& details = scan->getRootOperation()->runtimeInfo().details_;
+  EXPECT_LT(details["num-blocks-read"].get<size_t>(),
+            details["num-blocks-all"].get<size_t>());
+}
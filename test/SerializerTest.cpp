@@ -11,6 +11,7 @@
 #include "../src/util/Serializer/SerializeString.h"
 #include "../src/util/Serializer/SerializeVector.h"
 #include "../src/util/Serializer/Serializer.h"
+#include "../src/util/Serializer/ZstdFileSerializer.h"
 
 using namespace ad_utility;
 using ad_utility::serialization::ByteBufferReadSerializer;
@@ -19,6 +20,8 @@ using ad_utility::serialization::CopyableFileReadSerializer;
 using ad_utility::serialization::FileReadSerializer;
 using ad_utility::serialization::FileWriteSerializer;
 using ad_utility::serialization::VectorIncrementalSerializer;
+using ad_utility::serialization::ZstdFileReadSerializer;
+using ad_utility::serialization::ZstdFileWriteSerializer;
 
 using ad_utility::serialization::ReadSerializer;
 using ad_utility::serialization::Serializer;
@@ -222,6 +225,10 @@ TEST(Serializer, Concepts) {
   static_assert(!ReadSerializer<FileWriteSerializer>);
   static_assert(ReadSerializer<CopyableFileReadSerializer>);
   static_assert(!WriteSerializer<CopyableFileReadSerializer>);
+  static_assert(ReadSerializer<ZstdFileReadSerializer>);
+  static_assert(!WriteSerializer<ZstdFileReadSerializer>);
+  static_assert(WriteSerializer<ZstdFileWriteSerializer>);
+  static_assert(!ReadSerializer<ZstdFileWriteSerializer>);
 }
 
 // The following tests are mainly not for documentation but rather stress tests
@@ -246,9 +253,22 @@ auto testWithFileSerialization = [](auto testFunction) {
   unlink(filename.c_str());
 };
 
+// The small block size makes most values span several blocks.
+auto testWithZstdFileSerialization = [](auto testFunction) {
+  const std::string filename = "zstdSerializationTest.tmp";
+  ZstdFileWriteSerializer writer{filename, 7};
+  auto makeReaderFromWriter = [filename, &writer] {
+    writer.close();
+    return ZstdFileReadSerializer{filename};
+  };
+  testFunction(writer, makeReaderFromWriter);
+  unlink(filename.c_str());
+};
+
 auto testWithAllSerializers = [](auto testFunction) {
   testWithByteBuffer(testFunction);
   testWithFileSerialization(testFunction);
+  testWithZstdFileSerialization(testFunction);
   // TODO<joka921> Register new serializers here to apply all existing tests
   // to them
 };
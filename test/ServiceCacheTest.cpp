@@ -0,0 +1,162 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "engine/ServiceCache.h"
+#include "util/CancellationHandle.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+// A `ServiceCache` with a manual clock, which runs the refreshes of stale
+// entries only when `runBackgroundTasks` is called.
+struct TestCache {
+  ServiceCache::Clock::time_point now_{};
+  std::vector<std::function<void()>> backgroundTasks_;
+  ServiceCache cache_{
+      [this](std::function<void()> task) {
+        backgroundTasks_.push_back(std::move(task));
+      },
+      [this] { return now_; }};
+
+  void runBackgroundTasks() {
+    for (auto& task : std::exchange(backgroundTasks_, {})) {
+      task();
+    }
+  }
+};
+
+// A fetch function that returns the `response` and counts its calls.
+ServiceCache::FetchFunction makeFetch(std::string response, size_t& numCalls) {
+  return [response, &numCalls](const std::function<void()>& onChunk) {
+    ++numCalls;
+    onChunk();
+    return response;
+  };
+}
+
+ServiceCache::Config makeConfig() {
+  ServiceCache::Config config;
+  config.ttl_ = 10s;
+  config.staleWhileRevalidate_ = 5s;
+  config.errorTtl_ = 2s;
+  config.maxSizeInBytes_ = 10;
+  return config;
+}
+
+const auto noop = [] {};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ServiceCache, ttlAndStaleWhileRevalidate) {
+  TestCache t;
+  auto config = makeConfig();
+  size_t numCalls = 0;
+  auto fetchOld = makeFetch("old", numCalls);
+  auto fetchNew = makeFetch("new", numCalls);
+
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchOld, noop), "old");
+  EXPECT_EQ(numCalls, 1u);
+  EXPECT_EQ(t.cache_.sizeInBytes(), 3u);
+
+  // Fresh: the cached response is returned.
+  t.now_ += 9s;
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchNew, noop), "old");
+  EXPECT_EQ(numCalls, 1u);
+
+  // Stale: the cached response is returned and refreshed in the background,
+  // but only once.
+  t.now_ += 2s;
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchNew, noop), "old");
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchNew, noop), "old");
+  EXPECT_EQ(t.backgroundTasks_.size(), 1u);
+  t.runBackgroundTasks();
+  EXPECT_EQ(numCalls, 2u);
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchOld, noop), "new");
+
+  // Expired: the response is fetched again.
+  t.now_ += 20s;
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchOld, noop), "old");
+  EXPECT_EQ(numCalls, 3u);
+  EXPECT_TRUE(t.backgroundTasks_.empty());
+
+  // A TTL of zero disables the cache.
+  config.ttl_ = 0s;
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchNew, noop), "new");
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fetchNew, noop), "new");
+  EXPECT_EQ(numCalls, 5u);
+}
+
+// _____________________________________________________________________________
+TEST(ServiceCache, errors) {
+  TestCache t;
+  auto config = makeConfig();
+  size_t numCalls = 0;
+  auto fail = [&numCalls](const std::function<void()>&) -> std::string {
+    ++numCalls;
+    throw std::runtime_error{"endpoint is down"};
+  };
+  EXPECT_ANY_THROW(t.cache_.getOrFetch("key", config, fail, noop));
+  EXPECT_EQ(numCalls, 1u);
+  // The error is cached for the `errorTtl_`.
+  t.now_ += 1s;
+  try {
+    t.cache_.getOrFetch("key", config, makeFetch("ok", numCalls), noop);
+    FAIL() << "The cached error should have been thrown";
+  } catch (const std::runtime_error& e) {
+    EXPECT_STREQ(e.what(), "endpoint is down");
+  }
+  EXPECT_EQ(numCalls, 1u);
+  t.now_ += 2s;
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, makeFetch("ok", numCalls),
+                                 noop),
+            "ok");
+  EXPECT_EQ(numCalls, 2u);
+
+  // A failed refresh keeps the stale response.
+  t.now_ += 12s;
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fail, noop), "ok");
+  t.runBackgroundTasks();
+  EXPECT_EQ(*t.cache_.getOrFetch("key", config, fail, noop), "ok");
+  EXPECT_EQ(numCalls, 3u);
+
+  // Cancellations are never cached.
+  auto cancelled = [](const std::function<void()>&) -> std::string {
+    throw ad_utility::CancellationException{"cancelled"};
+  };
+  EXPECT_THROW(t.cache_.getOrFetch("other", config, cancelled, noop),
+               ad_utility::CancellationException);
+  EXPECT_EQ(*t.cache_.getOrFetch("other", config, makeFetch("ok", numCalls),
+                                 noop),
+            "ok");
+}
+
+// _____________________________________________________________________________
+TEST(ServiceCache, sizeLimit) {
+  TestCache t;
+  auto config = makeConfig();
+  size_t numCalls = 0;
+  t.cache_.getOrFetch("a", config, makeFetch("aaaa", numCalls), noop);
+  t.now_ += 1s;
+  t.cache_.getOrFetch("b", config, makeFetch("bbbb", numCalls), noop);
+  t.now_ += 1s;
+  // Access `a`, s.t. `b` is the least recently used entry.
+  t.cache_.getOrFetch("a", config, makeFetch("aaaa", numCalls), noop);
+  EXPECT_EQ(numCalls, 2u);
+  t.cache_.getOrFetch("c", config, makeFetch("cccc", numCalls), noop);
+  EXPECT_EQ(t.cache_.sizeInBytes(), 8u);
+  t.cache_.getOrFetch("a", config, makeFetch("aaaa", numCalls), noop);
+  EXPECT_EQ(numCalls, 3u);
+  t.cache_.getOrFetch("b", config, makeFetch("bbbb", numCalls), noop);
+  EXPECT_EQ(numCalls, 4u);
+
+  // Responses that are larger than the limit are not cached.
+  t.cache_.getOrFetch("d", config, makeFetch("ddddddddddd", numCalls), noop);
+  t.cache_.getOrFetch("d", config, makeFetch("ddddddddddd", numCalls), noop);
+  EXPECT_EQ(numCalls, 6u);
+  EXPECT_LE(t.cache_.sizeInBytes(), 10u);
+
+  t.cache_.clear();
+  EXPECT_EQ(t.cache_.sizeInBytes(), 0u);
+}
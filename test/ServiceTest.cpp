@@ -8,6 +8,7 @@
 #include <regex>
 
 #include "IndexTestHelpers.h"
+#include "engine/IdTableExchange.h"
 #include "engine/Service.h"
 #include "parser/GraphPatternOperation.h"
 #include "util/IdTableHelpers.h"
@@ -29,24 +30,27 @@ class ServiceTest : public ::testing::Test {
   // `Service.h`). Each mock does the following:
   //
   // 1. It tests that the request method is POST, the content-type header is
-  //    `application/sparql-query`, and the accept header is
-  //    `text/tab-separated-values` (our `Service` always does this).
+  //    `application/sparql-query`, and the accept header asks for the exchange
+  //    format of QLever or TSV (our `Service` always does this).
   //
   // 2. It tests that the host and port are as expected.
   //
   // 3. It tests that the post data is as expected.
   //
-  // 4. It returns the specified TSV.
+  // 4. It yields the specified TSV in chunks.
   //
   // NOTE: In a previous version of this test, we set up an actual test server.
   // The code can be found in the history of this PR.
   static auto constexpr getTsvFunctionFactory =
       [](const std::string& expectedUrl, const std::string& expectedSparqlQuery,
          const std::string& predefinedResult) -> Service::GetTsvFunction {
+    const std::string expectedAcceptHeader = idTableExchange::makeAcceptHeader(
+        idTableExchange::getVocabularyIdentity(
+            ad_utility::testing::getQec()->getIndex()));
     return [=](ad_utility::httpUtils::Url url,
-               const boost::beast::http::verb& method,
-               std::string_view postData, std::string_view contentTypeHeader,
-               std::string_view acceptHeader) -> std::istringstream {
+               boost::beast::http::verb method, std::string postData,
+               std::string contentTypeHeader, std::string acceptHeader)
+               -> cppcoro::generator<std::string> {
       // Check that the request parameters are as expected.
       //
       // NOTE: The first three are hard-coded in `Service::computeResult`, but
@@ -54,7 +58,7 @@ class ServiceTest : public ::testing::Test {
       // two checks are non-trivial.
       EXPECT_EQ(method, boost::beast::http::verb::post);
       EXPECT_EQ(contentTypeHeader, "application/sparql-query");
-      EXPECT_EQ(acceptHeader, "text/tab-separated-values");
+      EXPECT_EQ(acceptHeader, expectedAcceptHeader);
       EXPECT_EQ(url.asString(), expectedUrl);
 
       // Check that the whitespace-normalized POST data is the expected query.
@@ -63,10 +67,16 @@ class ServiceTest : public ::testing::Test {
       // which `Service::computeResult` has to construct a full SPARQL query by
       // adding `SELECT ... WHERE`, so this checks something non-trivial.
       std::string whitespaceNormalizedPostData =
-          std::regex_replace(std::string{postData}, std::regex{"\\s+"}, " ");
+          std::regex_replace(postData, std::regex{"\\s+"}, " ");
       EXPECT_EQ(whitespaceNormalizedPostData, expectedSparqlQuery);
 
-      return std::istringstream{predefinedResult};
+      // Yield the result in small chunks, s.t. the parsing of lines that are
+      // split across several chunks is tested.
+      return [](std::string result) -> cppcoro::generator<std::string> {
+        for (size_t i = 0; i < result.size(); i += 3) {
+          co_yield result.substr(i, 3);
+        }
+      }(predefinedResult);
     };
   };
 };
@@ -153,26 +163,175 @@ TEST_F(ServiceTest, computeResult) {
   std::shared_ptr<const ResultTable> result = serviceOperation4.getResult();
 
   // Check that `<x>` and `<y>` were contained in the original vocabulary and
-  // that `<bla>`, `<bli>`, `<blu>` were added to the (initially empty) local
-  // vocabulary. On the way, obtain their IDs, which we then need below.
+  // that `<bla>`, `<bli>`, `<blu>`, which are short enough to be inlined into
+  // their IDs, were not added to the (initially empty) local vocabulary. On the
+  // way, obtain their IDs, which we then need below.
   Id idX, idY;
   EXPECT_TRUE(testQec->getIndex().getId("<x>", &idX));
   EXPECT_TRUE(testQec->getIndex().getId("<y>", &idY));
-  const auto& localVocab = result->localVocab();
-  EXPECT_EQ(localVocab.size(), 3);
-  std::optional<LocalVocabIndex> idxBla = localVocab.getIndexOrNullopt("<bla>");
-  std::optional<LocalVocabIndex> idxBli = localVocab.getIndexOrNullopt("<bli>");
-  std::optional<LocalVocabIndex> idxBlu = localVocab.getIndexOrNullopt("<blu>");
-  ASSERT_TRUE(idxBli.has_value());
-  ASSERT_TRUE(idxBla.has_value());
-  ASSERT_TRUE(idxBlu.has_value());
-  Id idBli = Id::makeFromLocalVocabIndex(idxBli.value());
-  Id idBla = Id::makeFromLocalVocabIndex(idxBla.value());
-  Id idBlu = Id::makeFromLocalVocabIndex(idxBlu.value());
+  EXPECT_TRUE(result->localVocab().empty());
+  Id idBli = Id::makeFromInlineString("<bli>");
+  Id idBla = Id::makeFromInlineString("<bla>");
+  Id idBlu = Id::makeFromInlineString("<blu>");
 
   // Check that the result table corresponds to the contents of the TSV.
   EXPECT_TRUE(result);
   IdTable expectedIdTable = makeIdTableFromVector(
       {{idX, idY}, {idBla, idBli}, {idBlu, idBla}, {idBli, idBlu}});
   EXPECT_EQ(result->idTable(), expectedIdTable);
+
+  // CHECK 5: The same TSV without the newline at the end gives the same result.
+  Service serviceOperation5{
+      testQec, parsedServiceClause,
+      getTsvFunctionFactory(
+          expectedUrl, expectedSparqlQuery,
+          "?x\t?y\n<x>\t<y>\n<bla>\t<bli>\n<blu>\t<bla>\n<bli>\t<blu>")};
+  EXPECT_EQ(serviceOperation5.computeResultOnlyForTesting().idTable(),
+            expectedIdTable);
+
+  // CHECK 6: The endpoint is a QLever server and sends the same result in the
+  // exchange format of QLever, which is used directly.
+  idTableExchange::Encoder encoder{testQec->getIndex(), std::nullopt};
+  std::vector<std::optional<ColumnIndex>> columns{ColumnIndex{0},
+                                                  ColumnIndex{1}};
+  LocalVocab emptyVocab;
+  encoder.setLocalVocab(emptyVocab);
+  Service serviceOperation6{
+      testQec, parsedServiceClause,
+      getTsvFunctionFactory(
+          expectedUrl, expectedSparqlQuery,
+          absl::StrCat(encoder.header(2),
+                       encoder.frame(expectedIdTable, columns,
+                                     std::views::iota(0ul, 4ul)),
+                       idTableExchange::Encoder::endOfStream()))};
+  EXPECT_EQ(serviceOperation6.computeResultOnlyForTesting().idTable(),
+            expectedIdTable);
+}
+
+// Test the SERVICE `ql:shards`, which gets the results of all the
+// `shard-endpoints` in the exchange format of QLever and concatenates them.
+TEST_F(ServiceTest, computeResultFromShards) {
+  parsedQuery::Service parsedServiceClause{{Variable{"?x"}, Variable{"?y"}},
+                                           Iri{SHARDS_SERVICE_IRI},
+                                           "PREFIX doof: <http://doof.org>",
+                                           "{ }"};
+  const Index& index = testQec->getIndex();
+  Id idX, idY;
+  ASSERT_TRUE(index.getId("<x>", &idX));
+  ASSERT_TRUE(index.getId("<y>", &idY));
+  Id idBla = Id::makeFromInlineString("<bla>");
+  // The word is too long to be inlined, so it is part of the local vocabulary
+  // of the shard.
+  const std::string localWord = "<http://example.org/only-on-shard2>";
+  LocalVocab shardVocab;
+  Id idLocal = shardVocab.getIdAndAddIfNotContained(localWord);
+  ASSERT_EQ(idLocal.getDatatype(), Datatype::LocalVocabIndex);
+  auto encode = [&index, &shardVocab](const IdTable& table) {
+    idTableExchange::Encoder encoder{
+        index, idTableExchange::getVocabularyIdentity(index)};
+    std::vector<std::optional<ColumnIndex>> columns{ColumnIndex{0},
+                                                    ColumnIndex{1}};
+    encoder.setLocalVocab(shardVocab);
+    return absl::StrCat(
+        encoder.header(2),
+        encoder.frame(table, columns, std::views::iota(0ul, table.size())),
+        idTableExchange::Encoder::endOfStream());
+  };
+  ad_utility::HashMap<std::string, std::string> resultsByHost{
+      {"shard1", encode(makeIdTableFromVector({{idX, idY}}))},
+      {"shard2", encode(makeIdTableFromVector(
+                     {{idBla, Id::makeUndefined()}, {idLocal, idX}}))}};
+  auto getBinary = [&resultsByHost, &index](ad_utility::httpUtils::Url url,
+                                            boost::beast::http::verb,
+                                            std::string, std::string,
+                                            std::string acceptHeader)
+      -> cppcoro::generator<std::string> {
+    EXPECT_EQ(acceptHeader,
+              idTableExchange::makeAcceptHeader(
+                  idTableExchange::getVocabularyIdentity(index)));
+    // Yield the result in chunks that split the `Id`s.
+    return [](std::string result) -> cppcoro::generator<std::string> {
+      for (size_t i = 0; i < result.size(); i += 3) {
+        co_yield result.substr(i, 3);
+      }
+    }(resultsByHost.at(url.host()));
+  };
+
+  // Without shards, the SERVICE cannot be computed.
+  RuntimeParameters().set<"shard-endpoints">("");
+  Service withoutShards{testQec, parsedServiceClause, getBinary};
+  EXPECT_ANY_THROW(withoutShards.computeResultOnlyForTesting());
+
+  RuntimeParameters().set<"shard-endpoints">(
+      "http://shard1:7001/, http://shard2:7002/");
+  Service service{testQec, parsedServiceClause, getBinary};
+  EXPECT_THAT(service.getCacheKey(),
+              ::testing::HasSubstr("ON SHARDS http://shard1:7001/"));
+  auto result = service.computeResultOnlyForTesting();
+  auto receivedLocal = result.localVocab().getIdOrNullopt(localWord);
+  ASSERT_TRUE(receivedLocal.has_value());
+  EXPECT_EQ(result.idTable(), makeIdTableFromVector(
+                                  {{idX, idY},
+                                   {idBla, Id::makeUndefined()},
+                                   {receivedLocal.value(), idX}}));
+
+  // A truncated result and a result in a different format are rejected.
+  resultsByHost["shard2"].pop_back();
+  Service truncated{testQec, parsedServiceClause, getBinary};
+  EXPECT_ANY_THROW(truncated.computeResultOnlyForTesting());
+  resultsByHost["shard2"] = "?x\t?y\n<x>\t<y>\n";
+  Service notBinary{testQec, parsedServiceClause, getBinary};
+  EXPECT_ANY_THROW(notBinary.computeResultOnlyForTesting());
+  RuntimeParameters().set<"shard-endpoints">("");
+}
+
+// Test that the responses of the remote endpoint are taken from the
+// `ServiceCache` if it is enabled for the endpoint.
+TEST_F(ServiceTest, serviceCache) {
+  parsedQuery::Service parsedServiceClause{{Variable{"?x"}, Variable{"?y"}},
+                                           Iri{"<http://localhorst/api>"},
+                                           "PREFIX doof: <http://doof.org>",
+                                           "{ }"};
+  size_t numRequests = 0;
+  auto getTsv = [&numRequests](ad_utility::httpUtils::Url,
+                               boost::beast::http::verb, std::string,
+                               std::string, std::string)
+      -> cppcoro::generator<std::string> {
+    ++numRequests;
+    return [](std::string result) -> cppcoro::generator<std::string> {
+      co_yield result;
+    }("?x\t?y\n<x>\t<y>\n");
+  };
+  auto computeTwice = [&]() {
+    numRequests = 0;
+    for (size_t i = 0; i < 2; ++i) {
+      Service service{testQec, parsedServiceClause, getTsv};
+      EXPECT_EQ(service.computeResultOnlyForTesting().idTable().size(), 1u);
+    }
+    return numRequests;
+  };
+
+  // By default, the cache is disabled.
+  getServiceCache().clear();
+  EXPECT_EQ(computeTwice(), 2u);
+
+  // The TTL of another endpoint doesn't matter.
+  RuntimeParameters().set<"service-cache-ttl-per-endpoint">(
+      "http://otherhorst/api 1h");
+  EXPECT_EQ(computeTwice(), 2u);
+  RuntimeParameters().set<"service-cache-ttl-per-endpoint">(
+      "http://otherhorst/api 1h, http://localhorst/api 1h");
+  EXPECT_EQ(computeTwice(), 1u);
+
+  // Enabled for all endpoints.
+  getServiceCache().clear();
+  RuntimeParameters().set<"service-cache-ttl-per-endpoint">("");
+  RuntimeParameters().set<"service-cache-ttl">(std::chrono::seconds{3600});
+  EXPECT_EQ(computeTwice(), 1u);
+
+  RuntimeParameters().set<"service-cache-ttl-per-endpoint">("invalid");
+  EXPECT_ANY_THROW(computeTwice());
+  RuntimeParameters().set<"service-cache-ttl-per-endpoint">("");
+  RuntimeParameters().set<"service-cache-ttl">(std::chrono::seconds{0});
+  getServiceCache().clear();
 }
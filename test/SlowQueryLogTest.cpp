@@ -0,0 +1,90 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "engine/SlowQueryLog.h"
+
+using namespace std::chrono_literals;
+using Reason = SlowQueryLog::Reason;
+
+namespace {
+// The lines of the `file` (or an empty vector if it doesn't exist).
+std::vector<std::string> readLines(const std::string& file) {
+  std::ifstream stream{file};
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(stream, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(SlowQueryLog, shouldLog) {
+  SlowQueryLog::Settings settings;
+  // Without a file, nothing is logged.
+  EXPECT_EQ(SlowQueryLog::shouldLog(settings, 10s), std::nullopt);
+
+  settings.file_ = "slowQueryLogTest.shouldLog.jsonl";
+  settings.threshold_ = 100ms;
+  EXPECT_EQ(SlowQueryLog::shouldLog(settings, 100ms), Reason::Slow);
+  EXPECT_EQ(SlowQueryLog::shouldLog(settings, 99ms), std::nullopt);
+  settings.sampleRate_ = 1.0;
+  EXPECT_EQ(SlowQueryLog::shouldLog(settings, 99ms), Reason::Sampled);
+  EXPECT_EQ(SlowQueryLog::shouldLog(settings, 1s), Reason::Slow);
+  EXPECT_EQ(SlowQueryLog::toString(Reason::Slow), "slow");
+  EXPECT_EQ(SlowQueryLog::toString(Reason::Sampled), "sampled");
+}
+
+// _____________________________________________________________________________
+TEST(SlowQueryLog, writeAndRotate) {
+  std::string file = "slowQueryLogTest.writeAndRotate.jsonl";
+  auto nameOfFile = [&file](size_t i) {
+    return i == 0 ? file : absl::StrCat(file, ".", i);
+  };
+  auto removeFiles = [&nameOfFile]() {
+    for (size_t i = 0; i < 4; ++i) {
+      std::filesystem::remove(nameOfFile(i));
+    }
+  };
+  removeFiles();
+
+  SlowQueryLog log;
+  SlowQueryLog::Settings settings;
+  settings.file_ = file;
+  nlohmann::json entry{{"query", "SELECT * WHERE { ?s ?p ?o }"}};
+  auto lineSize = entry.dump().size() + 1;
+  // Two lines fit into a file.
+  settings.maxFileSize_ = ad_utility::MemorySize::bytes(2 * lineSize);
+  settings.maxNumFiles_ = 3;
+
+  log.write(settings, entry);
+  log.write(settings, entry);
+  ASSERT_EQ(readLines(file).size(), 2u);
+  EXPECT_EQ(nlohmann::json::parse(readLines(file)[0]), entry);
+
+  // The third line starts a new file.
+  log.write(settings, {{"query", "third"}});
+  ASSERT_EQ(readLines(file).size(), 1u);
+  EXPECT_EQ(nlohmann::json::parse(readLines(file)[0]).at("query"), "third");
+  EXPECT_EQ(readLines(nameOfFile(1)).size(), 2u);
+
+  // Only three files are kept.
+  for (size_t i = 0; i < 6; ++i) {
+    log.write(settings, entry);
+  }
+  EXPECT_EQ(readLines(file).size(), 1u);
+  EXPECT_EQ(readLines(nameOfFile(1)).size(), 2u);
+  EXPECT_EQ(readLines(nameOfFile(2)).size(), 2u);
+  EXPECT_FALSE(std::filesystem::exists(nameOfFile(3)));
+
+  // Nothing is written without a file.
+  settings.file_ = "";
+  log.write(settings, entry);
+  EXPECT_EQ(readLines(file).size(), 1u);
+  removeFiles();
+}
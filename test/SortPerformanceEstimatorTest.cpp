@@ -8,6 +8,7 @@
 #include <thread>
 
 #include "engine/SortPerformanceEstimator.h"
+#include "util/File.h"
 #include "util/Log.h"
 #include "util/MemorySize/MemorySize.h"
 #include "util/Random.h"
@@ -58,3 +59,38 @@ TEST(SortPerformanceEstimator, TestManyEstimates) {
     }
   }
 }
+
+// _____________________________________________________________________________
+TEST(SortPerformanceEstimator, ReadAndWriteFile) {
+  auto allocator = ad_utility::AllocatorWithLimit<Id>{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(1_GB)};
+  std::string filename = "sortPerformanceEstimatorTest.sort-estimates";
+  // Only the smallest samples are measured, the others are extrapolated.
+  size_t maxNumElements = 50'000;
+  auto fingerprint =
+      SortPerformanceEstimator::computeFingerprint(maxNumElements);
+  EXPECT_NE(fingerprint,
+            SortPerformanceEstimator::computeFingerprint(maxNumElements + 1));
+
+  SortPerformanceEstimator estimator;
+  EXPECT_FALSE(estimator.readFromFile(filename, fingerprint));
+  estimator.computeEstimatesOrReadFromFile(allocator, maxNumElements, filename,
+                                           false);
+
+  // The estimates are read from the file if the fingerprint matches.
+  SortPerformanceEstimator fromFile;
+  EXPECT_FALSE(fromFile.readFromFile(filename, "another fingerprint"));
+  ASSERT_TRUE(fromFile.readFromFile(filename, fingerprint));
+  for (size_t numRows : {5'000, 200'000, 20'000'000}) {
+    for (size_t numColumns : {1, 4, 7}) {
+      EXPECT_EQ(fromFile.estimatedSortTime(numRows, numColumns),
+                estimator.estimatedSortTime(numRows, numColumns));
+    }
+  }
+  SortPerformanceEstimator fromFile2;
+  fromFile2.computeEstimatesOrReadFromFile(allocator, maxNumElements, filename,
+                                           false);
+  EXPECT_EQ(fromFile2.estimatedSortTime(1'000'000, 3),
+            estimator.estimatedSortTime(1'000'000, 3));
+  ad_utility::deleteFile(filename);
+}
@@ -7,6 +7,7 @@
 
 #include "./IndexTestHelpers.h"
 #include "./util/IdTableHelpers.h"
+#include "engine/ExternalSort.h"
 #include "engine/Sort.h"
 #include "engine/ValuesForTesting.h"
 #include "global/ValueIdComparators.h"
@@ -196,3 +197,114 @@ TEST(Sort, verifyOperationIsPreemptivelyAbortedWithNoRemainingTime) {
       sort.getResult(true), ::testing::HasSubstr("time estimate exceeded"),
       ad_utility::AbortException);
 }
+
+// _____________________________________________________________________________
+TEST(Sort, externalSort) {
+  auto qec = ad_utility::testing::getQec();
+  VectorTable input;
+  for (int64_t i = 0; i < 1000; ++i) {
+    input.push_back({(i * 37) % 100, (i * 11) % 1000});
+  }
+  auto inputTable = makeIdTableFromVector(input, &Id::makeFromInt);
+  IdTable expected = inputTable.clone();
+  Engine::sort(expected, {0, 1});
+
+  auto originalBudget =
+      RuntimeParameters().get<"sort-external-memory-budget">();
+  using namespace ad_utility::memory_literals;
+  for (auto budget : {1_kB, 100_MB}) {
+    RuntimeParameters().set<"sort-external-memory-budget">(budget);
+    bool expectExternal = budget == 1_kB;
+    for (std::optional<size_t> lazyBlockSize :
+         {std::optional<size_t>{}, std::optional<size_t>{17}}) {
+      for (bool requestLaziness : {false, true}) {
+        auto subtree = ad_utility::makeExecutionTree<ValuesForTesting>(
+            qec, inputTable.clone(),
+            std::vector<std::optional<Variable>>{Variable{"?a"},
+                                                 Variable{"?b"}});
+        auto& values =
+            dynamic_cast<ValuesForTesting&>(*subtree->getRootOperation());
+        values.lazyBlockSize() = lazyBlockSize;
+        Sort sort{qec, subtree, {0, 1}};
+        auto result = sort.computeResultOnlyForTesting(requestLaziness);
+        EXPECT_EQ(result.isFullyMaterialized(),
+                  !(expectExternal && requestLaziness));
+        EXPECT_EQ(sort.runtimeInfo().details_.contains("sorted-externally"),
+                  expectExternal);
+        IdTable actual{2, qec->getAllocator()};
+        if (result.isFullyMaterialized()) {
+          actual = result.idTable().clone();
+        } else {
+          for (const auto& [block, localVocab] : result.idTables()) {
+            actual.insertAtEnd(block);
+          }
+        }
+        EXPECT_EQ(actual, expected);
+      }
+    }
+  }
+  RuntimeParameters().set<"sort-external-memory-budget">(originalBudget);
+}
+
+// _____________________________________________________________________________
+TEST(Sort, mergeLocalVocabInto) {
+  using ad_utility::externalSort::mergeLocalVocabInto;
+  auto I = ad_utility::testing::IntId;
+  auto L = [](uint64_t index) {
+    return Id::makeFromLocalVocabIndex(LocalVocabIndex::make(index));
+  };
+  LocalVocab target;
+  LocalVocab firstVocab;
+  firstVocab.getIndexAndAddIfNotContained("a");
+  firstVocab.getIndexAndAddIfNotContained("b");
+  auto first = makeIdTableFromVector({{L(0), I(3)}, {L(1), I(4)}});
+  // The first nonempty vocab is moved, the `Id`s stay the same.
+  mergeLocalVocabInto(first, firstVocab, target);
+  EXPECT_EQ(first, makeIdTableFromVector({{L(0), I(3)}, {L(1), I(4)}}));
+  EXPECT_EQ(target.size(), 2u);
+
+  LocalVocab secondVocab;
+  secondVocab.getIndexAndAddIfNotContained("c");
+  secondVocab.getIndexAndAddIfNotContained("a");
+  auto second = makeIdTableFromVector({{L(1), L(0)}, {I(5), L(1)}});
+  mergeLocalVocabInto(second, secondVocab, target);
+  EXPECT_EQ(second, makeIdTableFromVector({{L(0), L(2)}, {I(5), L(0)}}));
+  ASSERT_EQ(target.size(), 3u);
+  EXPECT_EQ(target.getWord(LocalVocabIndex::make(2)), "c");
+}
+
+// _____________________________________________________________________________
+TEST(Sort, resultIsReusedForSortOnPrefix) {
+  auto qec = ad_utility::testing::getQec();
+  qec->getQueryTreeCache().clearAll();
+  auto input = makeIdTableFromVector({{3, 1}, {1, 2}, {3, 0}, {2, 5}});
+  Sort sortOnBothColumns = makeSort(input.clone(), {0, 1});
+  auto full = sortOnBothColumns.getResult();
+  EXPECT_EQ(sortOnBothColumns.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::computed);
+
+  // A sort on the first column can reuse the cached result.
+  Sort sortOnFirstColumn = makeSort(input.clone(), {0});
+  EXPECT_EQ(sortOnFirstColumn.getCostEstimate(), 0u);
+  auto prefix = sortOnFirstColumn.getResult();
+  EXPECT_EQ(sortOnFirstColumn.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::cachedNotPinned);
+  EXPECT_EQ(prefix, full);
+
+  // The same holds if the sort on the first column has a LIMIT and OFFSET.
+  Sort limitedSort = makeSort(input.clone(), {0});
+  LimitOffsetClause limit;
+  limit._limit = 2;
+  limit._offset = 1;
+  limitedSort.setLimit(limit);
+  auto limited = limitedSort.getResult();
+  EXPECT_EQ(limitedSort.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::cachedNotPinned);
+  EXPECT_EQ(limited->idTable(), makeIdTableFromVector({{3, 0}, {3, 1}}));
+
+  // A sort on the second column has to be computed.
+  Sort sortOnSecondColumn = makeSort(input.clone(), {1});
+  [[maybe_unused]] auto other = sortOnSecondColumn.getResult();
+  EXPECT_EQ(sortOnSecondColumn.runtimeInfo().cacheStatus_,
+            ad_utility::CacheStatus::computed);
+}
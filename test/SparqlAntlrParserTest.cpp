@@ -15,6 +15,7 @@
 #include "./util/GTestHelpers.h"
 #include "./util/TripleComponentTestHelpers.h"
 #include "SparqlAntlrParserTestHelpers.h"
+#include "engine/sparqlExpressions/ApproxCountDistinctExpression.h"
 #include "engine/sparqlExpressions/LangExpression.h"
 #include "engine/sparqlExpressions/LiteralExpression.h"
 #include "engine/sparqlExpressions/RandomExpression.h"
@@ -819,6 +820,20 @@ TEST(SparqlParser, GroupGraphPattern) {
   expectGraphPattern("{ MINUS { ?a <foo> <bar> } }",
                      m::GraphPattern(m::MinusGraphPattern(
                          m::Triples({{Var{"?a"}, "<foo>", "<bar>"}}))));
+  // A `FILTER NOT EXISTS` is evaluated after the other graph patterns.
+  expectGraphPattern(
+      "{ FILTER NOT EXISTS { ?a <foo> <bar> } ?a ?b ?c }",
+      m::GraphPattern(m::Triples({abc}),
+                      m::NotExistsGraphPattern(
+                          m::Triples({{Var{"?a"}, "<foo>", "<bar>"}}))));
+  expectGraphPattern(
+      "{ ?a ?b ?c FILTER EXISTS { ?a <foo> <bar> } }",
+      m::GraphPattern(m::Triples({abc}),
+                      m::ExistsGraphPattern(
+                          m::Triples({{Var{"?a"}, "<foo>", "<bar>"}}))));
+  expectGroupGraphPatternFails("{ FILTER NOT EXISTS { ?a <foo> <bar> } }");
+  expectGroupGraphPatternFails(
+      "{ ?a ?b ?c FILTER NOT EXISTS { ?a <foo> ?d FILTER (?d != ?c) } }");
   expectGraphPattern(
       "{ FILTER (?a = 10) . ?x ?y ?z }",
       m::GraphPattern(false, {"(?a = 10)"}, DummyTriplesMatcher));
@@ -1447,6 +1462,9 @@ TEST(SparqlParser, FunctionCall) {
                      matchUnary(&makeCosExpression));
   expectFunctionCall(absl::StrCat(math, "tan>(?x)"),
                      matchUnary(&makeTanExpression));
+  expectFunctionCall(
+      absl::StrCat(QL_PREFIX.second, "approx-count-distinct>(?x)"),
+      matchPtr<ApproxCountDistinctExpression>());
 
   // Wrong number of arguments.
   expectFunctionCallFails(
@@ -1454,6 +1472,8 @@ TEST(SparqlParser, FunctionCall) {
   // Unknown function with the `geof:` prefix.
   expectFunctionCallFails(
       "<http://www.opengis.net/def/function/geosparql/notExisting>()");
+  expectFunctionCallFails(absl::StrCat(QL_PREFIX.second,
+                                       "approx-count-distinct>(?x, ?y)"));
   // Prefix for which no function is known.
   expectFunctionCallFails(
       "<http://www.no-existing-prefixes.com/notExisting>()");
@@ -775,6 +775,33 @@ inline auto MinusGraphPattern = [](vector<std::string>&& filters,
 inline auto MinusGraphPattern =
     MatcherWithDefaultFilters<detail::MinusGraphPattern>{};
 
+namespace detail {
+// A `FILTER EXISTS` or `FILTER NOT EXISTS` (if `isNegated`).
+inline auto ExistsFilter = [](bool isNegated, vector<std::string>&& filters,
+                              const auto&... childMatchers)
+    -> Matcher<const p::GraphPatternOperation&> {
+  return detail::GraphPatternOperation<p::ExistsFilter>(testing::AllOf(
+      AD_FIELD(p::ExistsFilter, _child,
+               detail::GraphPattern(false, filters, childMatchers...)),
+      AD_FIELD(p::ExistsFilter, _isNegated, testing::Eq(isNegated))));
+};
+inline auto ExistsGraphPattern = [](vector<std::string>&& filters,
+                                    const auto&... childMatchers)
+    -> Matcher<const p::GraphPatternOperation&> {
+  return ExistsFilter(false, std::move(filters), childMatchers...);
+};
+inline auto NotExistsGraphPattern = [](vector<std::string>&& filters,
+                                       const auto&... childMatchers)
+    -> Matcher<const p::GraphPatternOperation&> {
+  return ExistsFilter(true, std::move(filters), childMatchers...);
+};
+}  // namespace detail
+
+inline auto ExistsGraphPattern =
+    MatcherWithDefaultFilters<detail::ExistsGraphPattern>{};
+inline auto NotExistsGraphPattern =
+    MatcherWithDefaultFilters<detail::NotExistsGraphPattern>{};
+
 inline auto SubSelect =
     [](auto&& selectMatcher,
        auto&& whereMatcher) -> Matcher<const p::GraphPatternOperation&> {
@@ -9,6 +9,7 @@
 
 #include "./SparqlExpressionTestHelpers.h"
 #include "./util/GTestHelpers.h"
+#include "./util/TripleComponentTestHelpers.h"
 #include "engine/sparqlExpressions/AggregateExpression.h"
 #include "engine/sparqlExpressions/GroupConcatExpression.h"
 #include "engine/sparqlExpressions/LiteralExpression.h"
@@ -323,6 +324,87 @@ TEST(SparqlExpression, logicalOperators) {
   }
 }
 
+// _____________________________________________________________________________________
+TEST(SparqlExpression, shortCircuitLogicalOperators) {
+  // An expensive expression that is true for all rows and records the ranges
+  // of rows on which it was evaluated.
+  struct ExpensiveExpression : public DummyExpression {
+    std::vector<std::pair<size_t, size_t>>* ranges_;
+    explicit ExpensiveExpression(std::vector<std::pair<size_t, size_t>>* ranges)
+        : DummyExpression{ExpressionResult{}}, ranges_{ranges} {}
+    ExpressionResult evaluate(EvaluationContext* context) const override {
+      ranges_->emplace_back(context->_beginIndex, context->_endIndex);
+      return V<Id>(context->size(), B(true), context->_allocator);
+    }
+    size_t getCostEstimatePerRow() const override { return 100; }
+  };
+
+  VariableToColumnMap map;
+  LocalVocab localVocab;
+  IdTable table{alloc};
+  sparqlExpression::EvaluationContext context{*ad_utility::testing::getQec(),
+                                              map, table, alloc, localVocab};
+  context._beginIndex = 100;
+  context._endIndex = 164;
+
+  // Evaluate `makeExpression` with the `ExpensiveExpression` as the first
+  // operand and the `left` values as the second operand, check the `expected`
+  // result and return the ranges on which the expensive operand was evaluated.
+  auto evaluate = [&context](auto makeExpression, const std::vector<Id>& left,
+                             const std::vector<Id>& expected,
+                             source_location l = source_location::current()) {
+    auto t = generateLocationTrace(l);
+    std::vector<std::pair<size_t, size_t>> ranges;
+    auto expression = makeExpression(
+        std::make_unique<ExpensiveExpression>(&ranges),
+        std::make_unique<DummyExpression>(liftVector(left)));
+    // The cheap operand is evaluated first.
+    EXPECT_NE(dynamic_cast<const ExpensiveExpression*>(
+                  expression->childrenForTesting()[1].get()),
+              nullptr);
+    auto result = expression->evaluate(&context);
+    EXPECT_THAT(std::get<V<Id>>(result), ::testing::ElementsAreArray(expected));
+    EXPECT_EQ(context._beginIndex, 100u);
+    EXPECT_EQ(context._endIndex, 164u);
+    return ranges;
+  };
+  using Ranges = std::vector<std::pair<size_t, size_t>>;
+
+  Id t = B(true);
+  Id f = B(false);
+  auto repeat = [](std::vector<Id> pattern, size_t n) {
+    std::vector<Id> result;
+    for (size_t i = 0; i < n; ++i) {
+      std::ranges::copy(pattern, std::back_inserter(result));
+    }
+    return result;
+  };
+  auto concat = [](std::vector<Id> a, const std::vector<Id>& b) {
+    std::ranges::copy(b, std::back_inserter(a));
+    return a;
+  };
+
+  // Only the rows that are not determined by the cheap operand are evaluated.
+  auto halfFalse = concat(repeat({f}, 32), repeat({U}, 32));
+  auto halfTrue = concat(repeat({t}, 32), repeat({U}, 32));
+  EXPECT_EQ(evaluate(&makeAndExpression, halfFalse,
+                     concat(repeat({f}, 32), repeat({U}, 32))),
+            (Ranges{{132, 164}}));
+  EXPECT_EQ(evaluate(&makeOrExpression, halfTrue, repeat({t}, 64)),
+            (Ranges{{132, 164}}));
+  EXPECT_EQ(evaluate(&makeAndExpression, repeat({f}, 64), repeat({f}, 64)),
+            Ranges{});
+  EXPECT_EQ(evaluate(&makeOrExpression, repeat({f, t}, 32), repeat({t}, 64)),
+            (Ranges{{100, 164}}));
+  auto alternating = repeat({f, t}, 32);
+  EXPECT_EQ(evaluate(&makeAndExpression, alternating, alternating),
+            (Ranges{{100, 164}}));
+  EXPECT_EQ(evaluate(&makeAndExpression,
+                     concat(repeat({t}, 20), repeat({f}, 44)),
+                     concat(repeat({t}, 20), repeat({f}, 44))),
+            (Ranges{{100, 120}}));
+}
+
 // _____________________________________________________________________________________
 TEST(SparqlExpression, arithmeticOperators) {
   // Test `AddExpression`, `SubtractExpression`, `MultiplyExpression`, and
@@ -579,6 +661,67 @@ TEST(SparqlExpression, binaryStringOperations) {
       S{"", "x", "", "ullo", "ll", "Hällo", "Hällox", "l"});
 }
 
+// _____________________________________________________________________________
+TEST(SparqlExpression, strStartsWithConstantPrefix) {
+  auto makeStrStarts = [](std::string variable, std::string prefix,
+                          bool withStr) {
+    SparqlExpression::Ptr child =
+        std::make_unique<VariableExpression>(Variable{std::move(variable)});
+    if (withStr) {
+      child = makeStrExpression(std::move(child));
+    }
+    return makeStrStartsExpression(
+        std::move(child),
+        std::make_unique<StringLiteralExpression>(
+            ad_utility::testing::tripleComponentLiteral(
+                absl::StrCat("\"", prefix, "\""))));
+  };
+  TestContext ctx;
+  auto evaluate = [&ctx](const SparqlExpression::Ptr& expression) {
+    return std::get<VectorWithMemoryLimit<Id>>(
+        expression->evaluate(&ctx.context));
+  };
+  auto F = Id::makeFromBool(false);
+  auto T = Id::makeFromBool(true);
+  using ::testing::ElementsAre;
+
+  // ?vocab is `"Beta", "alpha", "älpha"`. The ranges of the vocabulary are
+  // case- and accent-insensitive, but the result is exact.
+  auto beta = makeStrStarts("?vocab", "Be", false);
+  auto prefixFilter = beta->getPrefixFilter();
+  ASSERT_TRUE(prefixFilter.has_value());
+  EXPECT_EQ(prefixFilter->variable_, Variable{"?vocab"});
+  EXPECT_EQ(prefixFilter->prefix_, "Be");
+  EXPECT_FALSE(prefixFilter->strIsApplied_);
+  EXPECT_THAT(evaluate(beta), ElementsAre(T, F, F));
+  EXPECT_THAT(evaluate(makeStrStarts("?vocab", "be", false)),
+              ElementsAre(F, F, F));
+  EXPECT_THAT(evaluate(makeStrStarts("?vocab", "al", false)),
+              ElementsAre(F, T, F));
+
+  // ?mixed is `1, -0.1, <x>` and ?localVocab is `"notInVocabA",
+  // "notInVocabB", <notInVocabD>`.
+  auto mixed = makeStrStarts("?mixed", "x", true);
+  ASSERT_TRUE(mixed->getPrefixFilter().has_value());
+  EXPECT_TRUE(mixed->getPrefixFilter()->strIsApplied_);
+  EXPECT_THAT(evaluate(mixed), ElementsAre(F, F, T));
+  EXPECT_THAT(evaluate(makeStrStarts("?mixed", "-0", true)),
+              ElementsAre(F, T, F));
+  EXPECT_THAT(evaluate(makeStrStarts("?localVocab", "notInVocabA", true)),
+              ElementsAre(T, F, F));
+
+  // A prefix that is not ASCII is evaluated without the ranges.
+  auto nonAscii = makeStrStarts("?vocab", "äl", false);
+  EXPECT_FALSE(nonAscii->getPrefixFilter().has_value());
+  EXPECT_THAT(evaluate(nonAscii), ElementsAre(F, F, T));
+  // The same holds if the prefix is not a constant.
+  auto variablePrefix = makeStrStartsExpression(
+      std::make_unique<VariableExpression>(Variable{"?vocab"}),
+      std::make_unique<VariableExpression>(Variable{"?vocab"}));
+  EXPECT_FALSE(variablePrefix->getPrefixFilter().has_value());
+  EXPECT_THAT(evaluate(variablePrefix), ElementsAre(T, T, T));
+}
+
 // ______________________________________________________________________________
 static auto checkSubstr =
     std::bind_front(testNaryExpression, makeSubstrExpression);
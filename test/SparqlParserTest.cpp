@@ -1229,3 +1229,32 @@ TEST(ParserTest, LanguageFilterPostProcessing) {
         triples[2]);
   }
 }
+
+TEST(ParserTest, LanguageFilterOnPropertyPaths) {
+  // Return the predicates of the triples of the first basic graph pattern of
+  // the query with the `triples` and a language filter on `?y`.
+  auto getPredicates = [](const std::string& triples) {
+    ParsedQuery q = SparqlParser::parseQuery(
+        "SELECT * WHERE {" + triples + " FILTER (LANG(?y) = \"en\")}");
+    EXPECT_TRUE(q._rootGraphPattern._filters.empty());
+    std::vector<std::string> predicates;
+    for (const auto& triple :
+         q._rootGraphPattern._graphPatterns[0].getBasic()._triples) {
+      predicates.push_back(triple._p.asString());
+    }
+    return predicates;
+  };
+  using V = std::vector<std::string>;
+  EXPECT_EQ(getPredicates("?x <a>|<b> ?y ."), (V{"(@en@<a>)|(@en@<b>)"}));
+  EXPECT_EQ(getPredicates("?y ^<a> ?x ."), (V{"^(@en@<a>)"}));
+  // Only the last predicate of a sequence binds the object.
+  EXPECT_EQ(getPredicates("?x <a>/<b> ?y ."), (V{"(<a>)/(@en@<b>)"}));
+  EXPECT_EQ(getPredicates("?y ^(<a>/<b>) ?x ."), (V{"^((<a>)/(@en@<b>))"}));
+
+  // The `?y` is not (only) bound by IRI predicates, so the language is checked
+  // via the `ql:langtag` predicate.
+  auto langtag = "<http://qlever.cs.uni-freiburg.de/builtin-functions/langtag>";
+  EXPECT_EQ(getPredicates("?x ^<a> ?y ."), (V{"^(<a>)", langtag}));
+  EXPECT_EQ(getPredicates("?y <a> ?x ."), (V{"<a>", langtag}));
+  EXPECT_EQ(getPredicates("?x <a>|^<b> ?y ."), (V{"(<a>)|(^(<b>))", langtag}));
+}
@@ -0,0 +1,142 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./IndexTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "engine/ExportQueryExecutionTrees.h"
+#include "engine/IndexScan.h"
+#include "engine/SpatialJoin.h"
+#include "util/GeoSparqlHelpers.h"
+
+using namespace ad_utility::testing;
+
+namespace {
+// An index in which `<p>` maps the subjects `<a0>` ... to WKT points on a grid
+// with a spacing of 0.01 degrees, to points close to the north pole, and to
+// some values that are no points.
+QueryExecutionContext* getTestQec() {
+  std::string turtle;
+  auto addPoint = [&turtle, i = 0](std::string_view lng,
+                                   std::string_view lat) mutable {
+    absl::StrAppend(&turtle, "<a", i++, "> <p> \"POINT(", lng, " ", lat,
+                    ")\"^^<http://www.opengis.net/ont/geosparql#wktLiteral>",
+                    " . ");
+  };
+  for (size_t i = 0; i < 10; ++i) {
+    for (size_t j = 0; j < 10; ++j) {
+      addPoint(absl::StrCat("7.8", i), absl::StrCat("47.9", j));
+    }
+  }
+  addPoint("0", "89.99");
+  addPoint("179", "89.99");
+  addPoint("-179", "89.98");
+  absl::StrAppend(&turtle, "<b0> <p> \"no point\" . <b1> <p> <c> . ");
+  return getQec(turtle);
+}
+
+std::shared_ptr<QueryExecutionTree> makeScan(QueryExecutionContext* qec,
+                                             std::string subject,
+                                             std::string object) {
+  return ad_utility::makeExecutionTree<IndexScan>(
+      qec, Permutation::PSO,
+      SparqlTriple{Variable{std::move(subject)}, "<p>",
+                   Variable{std::move(object)}});
+}
+
+// A `SpatialJoin` of the scans `?x <p> ?a` and `?y <p> ?b` on `?a` and `?b`.
+std::shared_ptr<SpatialJoin> makeJoin(QueryExecutionContext* qec,
+                                      double maxDistance,
+                                      bool includeMaxDistance) {
+  return std::make_shared<SpatialJoin>(qec, makeScan(qec, "?x", "?a"),
+                                       makeScan(qec, "?y", "?b"),
+                                       Variable{"?a"}, Variable{"?b"},
+                                       maxDistance, includeMaxDistance);
+}
+
+// The result of the `SpatialJoin` of `left` and `right` on their second
+// columns, computed by checking all pairs of rows.
+IdTable computeExpected(QueryExecutionContext* qec,
+                        const QueryExecutionTree& left,
+                        const QueryExecutionTree& right, double maxDistance,
+                        bool includeMaxDistance) {
+  LocalVocab localVocab;
+  auto getPoint = [qec, &localVocab](Id id) -> std::optional<std::string> {
+    auto literal = ExportQueryExecutionTrees::idToStringAndType<true, true>(
+        qec->getIndex(), id, localVocab);
+    if (!literal.has_value()) {
+      return std::nullopt;
+    }
+    return std::move(literal->first);
+  };
+  const IdTable& leftTable = left.getResult()->idTable();
+  const IdTable& rightTable = right.getResult()->idTable();
+  IdTable expected{4, makeAllocator()};
+  for (const auto& leftRow : leftTable) {
+    for (const auto& rightRow : rightTable) {
+      double distance =
+          ad_utility::wktDist(getPoint(leftRow[1]), getPoint(rightRow[1]));
+      if (includeMaxDistance ? distance <= maxDistance
+                             : distance < maxDistance) {
+        expected.push_back({leftRow[0], leftRow[1], rightRow[0], rightRow[1]});
+      }
+    }
+  }
+  return expected;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(SpatialJoin, computeResult) {
+  auto* qec = getTestQec();
+  auto left = makeScan(qec, "?x", "?a");
+  auto right = makeScan(qec, "?y", "?b");
+  auto join = makeJoin(qec, 2.0, false);
+  EXPECT_EQ(join->getDescriptor(), "Spatial join ?a - ?b within 2 km");
+  EXPECT_EQ(join->getResultWidth(), 4u);
+  const auto& varColMap = join->getExternallyVisibleVariableColumns();
+  EXPECT_EQ(varColMap.at(Variable{"?x"}).columnIndex_, 0u);
+  EXPECT_EQ(varColMap.at(Variable{"?a"}).columnIndex_, 1u);
+  EXPECT_EQ(varColMap.at(Variable{"?y"}).columnIndex_, 2u);
+  EXPECT_EQ(varColMap.at(Variable{"?b"}).columnIndex_, 3u);
+  EXPECT_EQ(join->resultSortedOn(), left->resultSortedOn());
+
+  // The result is the same as for checking all pairs of rows, also for the
+  // points close to the pole and for distances that include all points.
+  for (double maxDistance : {0.0, 0.5, 1.0, 2.0, 5.0, 50.0, 20'000.0}) {
+    for (bool includeMaxDistance : {false, true}) {
+      auto join = makeJoin(qec, maxDistance, includeMaxDistance);
+      EXPECT_EQ(join->computeResultOnlyForTesting().idTable(),
+                computeExpected(qec, *left, *right, maxDistance,
+                                includeMaxDistance))
+          << maxDistance << " " << includeMaxDistance;
+    }
+  }
+
+  // A negative or NaN distance has no matches.
+  for (double maxDistance : {-1.0, std::numeric_limits<double>::quiet_NaN()}) {
+    auto join = makeJoin(qec, maxDistance, true);
+    EXPECT_TRUE(join->computeResultOnlyForTesting().idTable().empty());
+  }
+}
+
+// _____________________________________________________________________________
+TEST(SpatialJoin, maxDistanceOfExistingPair) {
+  auto* qec = getTestQec();
+  auto left = makeScan(qec, "?x", "?a");
+  auto right = makeScan(qec, "?y", "?b");
+  // The distance between two neighboring points of the grid, which occurs for
+  // many pairs.
+  double distance =
+      ad_utility::detail::wktDistImpl("POINT(7.80 47.90)", "POINT(7.81 47.90)");
+  auto exclusive = makeJoin(qec, distance, false);
+  auto inclusive = makeJoin(qec, distance, true);
+  EXPECT_NE(exclusive->getCacheKey(), inclusive->getCacheKey());
+  auto exclusiveResult = exclusive->computeResultOnlyForTesting();
+  auto inclusiveResult = inclusive->computeResultOnlyForTesting();
+  EXPECT_LT(exclusiveResult.idTable().numRows(),
+            inclusiveResult.idTable().numRows());
+  EXPECT_EQ(inclusiveResult.idTable(),
+            computeExpected(qec, *left, *right, distance, true));
+}
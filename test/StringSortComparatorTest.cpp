@@ -4,6 +4,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "./util/GTestHelpers.h"
 #include "index/StringSortComparator.h"
 using namespace std::literals;
@@ -19,6 +21,34 @@ TEST(LocaleManagerTest, Levels) {
   ASSERT_GT(loc.compare("älpha", "ALPHA", L::SECONDARY), 0);
 }
 
+TEST(LocaleManagerTest, SortKeysOfAsciiAndNonAsciiStrings) {
+  using L = LocaleManager::Level;
+  // The sort keys of ASCII strings are computed without decoding the UTF-8,
+  // they have to be consistent with the sort keys of the other strings and
+  // with `compare`. The long strings exceed the initial sort key buffer.
+  std::vector<std::string> strings{
+      "", "a", "A", "alpha", "ALPHA", "älpha", "a.c", "ab", ".a", "#?a",
+      "http://example.org/x", "http://example.org/\xc3\xa4",
+      std::string(100'000, 'x'), std::string(100'000, 'x') + "\xc3\xa4"};
+  for (bool ignorePunctuation : {false, true}) {
+    LocaleManager loc("en", "US", ignorePunctuation);
+    for (auto level : {L::PRIMARY, L::SECONDARY, L::TERTIARY, L::QUARTERNARY,
+                       L::IDENTICAL}) {
+      std::vector<LocaleManager::SortKey> keys;
+      for (const auto& s : strings) {
+        keys.push_back(loc.getSortKey(s, level));
+      }
+      for (size_t i = 0; i < strings.size(); ++i) {
+        for (size_t j = 0; j < strings.size(); ++j) {
+          EXPECT_EQ(std::clamp(keys[i].compare(keys[j]), -1, 1),
+                    loc.compare(strings[i], strings[j], level))
+              << i << " " << j;
+        }
+      }
+    }
+  }
+}
+
 TEST(LocaleManagerTest, getLowercaseUtf8) {
   LocaleManager loc;
   ASSERT_EQ("schindler's list", loc.getLowercaseUtf8("Schindler's List"));
@@ -57,6 +87,16 @@ TEST(LocaleManagerTest, Normalization) {
   auto resB = loc.normalizeUtf8(bs);
   ASSERT_EQ(resA, resB);
   ASSERT_EQ(resA, as);
+
+  // Strings that are already normalized are left as they are.
+  std::string normalized = as;
+  loc.normalizeUtf8InPlace(normalized);
+  ASSERT_EQ(normalized, as);
+  loc.normalizeUtf8InPlace(bs);
+  ASSERT_EQ(bs, as);
+  std::string ascii = "<http://example.org/ascii>";
+  loc.normalizeUtf8InPlace(ascii);
+  ASSERT_EQ(ascii, "<http://example.org/ascii>");
 }
 
 // ______________________________________________________________________________________________
@@ -126,6 +166,17 @@ TEST(StringSortComparatorTest, TripleComponentComparatorTotal) {
         b, TripleComponentComparator::Level::TOTAL);
     EXPECT_EQ(ab, comp(aSplit, bSplit));
     EXPECT_EQ(ba, comp(bSplit, aSplit));
+    // The comparison with the precomputed `SortKey`s that is used for the
+    // merging of the partial vocabularies.
+    auto compareWithSortKeys = [](std::string_view x, const auto& xSplit,
+                                  std::string_view y, const auto& ySplit) {
+      return TripleComponentComparator::compareWithSortKeys(
+                 x, LocaleManager::SortKeyView{xSplit.transformedVal_.get()},
+                 y, LocaleManager::SortKeyView{ySplit.transformedVal_.get()}) <
+             0;
+    };
+    EXPECT_EQ(ab, compareWithSortKeys(a, aSplit, b, bSplit));
+    EXPECT_EQ(ba, compareWithSortKeys(b, bSplit, a, aSplit));
   };
 
   auto assertTrue = [&comp, &assertConsistent](
@@ -0,0 +1,67 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "./util/IdTestHelpers.h"
+#include "index/TransitiveClosures.h"
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+namespace {
+auto V = ad_utility::testing::VocabId;
+}
+
+// _____________________________________________________________________________
+TEST(TransitiveClosure, compute) {
+  // A cycle `0 -> 2 -> 4 -> 0`, an edge `4 -> 7` that leaves it, a self loop
+  // and a duplicate edge.
+  std::vector<Id> subjects{V(0), V(2), V(4), V(4), V(3), V(0)};
+  std::vector<Id> objects{V(2), V(4), V(0), V(7), V(3), V(2)};
+  auto closure = TransitiveClosure::compute(subjects, objects);
+
+  const auto& forward = closure.forward_;
+  EXPECT_THAT(forward.nodes_, ElementsAre(V(0), V(2), V(3), V(4)));
+  EXPECT_THAT(forward.reachableFrom(V(0)),
+              ElementsAre(V(0), V(2), V(4), V(7)));
+  EXPECT_THAT(forward.reachableFrom(V(3)), ElementsAre(V(3)));
+  EXPECT_THAT(forward.reachableFrom(V(7)), IsEmpty());
+  EXPECT_THAT(forward.reachableFrom(V(1)), IsEmpty());
+  EXPECT_EQ(forward.numPairs(), 13u);
+
+  const auto& backward = closure.backward_;
+  EXPECT_THAT(backward.reachableFrom(V(7)), ElementsAre(V(0), V(2), V(4)));
+  EXPECT_THAT(backward.reachableFrom(V(3)), ElementsAre(V(3)));
+  EXPECT_THAT(backward.reachableFrom(V(5)), IsEmpty());
+  EXPECT_EQ(backward.numPairs(), forward.numPairs());
+
+  // An empty graph.
+  auto empty = TransitiveClosure::compute({}, {});
+  EXPECT_THAT(empty.forward_.nodes_, IsEmpty());
+  EXPECT_THAT(empty.forward_.reachableFrom(V(0)), IsEmpty());
+}
+
+// _____________________________________________________________________________
+TEST(TransitiveClosures, writeAndRead) {
+  TransitiveClosures closures;
+  std::vector<Id> subjects{V(0), V(1)};
+  std::vector<Id> objects{V(1), V(2)};
+  closures.add(V(42), TransitiveClosure::compute(subjects, objects));
+  EXPECT_EQ(closures.get(V(43)), nullptr);
+
+  std::string filename = "transitiveClosuresTest.dat";
+  closures.writeToFile(filename);
+  auto read = TransitiveClosures::readFromFile(filename);
+  std::remove(filename.c_str());
+  EXPECT_EQ(read.size(), 1u);
+  ASSERT_NE(read.get(V(42)), nullptr);
+  EXPECT_THAT(read.get(V(42))->forward_.reachableFrom(V(0)),
+              ElementsAre(V(1), V(2)));
+  EXPECT_THAT(read.get(V(42))->backward_.reachableFrom(V(2)),
+              ElementsAre(V(0), V(1)));
+  EXPECT_EQ(read.get(V(43)), nullptr);
+}
@@ -10,6 +10,7 @@
 #include "./util/AllocatorTestHelpers.h"
 #include "./util/IdTestHelpers.h"
 #include "engine/TransitivePath.h"
+#include "global/Constants.h"
 #include "global/Id.h"
 
 using ad_utility::testing::getQec;
@@ -56,7 +57,7 @@ TEST(TransitivePathTest, idToId) {
   TransitivePath T(getQec(), nullptr, left, right, 1,
                    std::numeric_limits<size_t>::max());
 
-  T.computeTransitivePath<2, 2>(&result, sub, left, right);
+  T.computeTransitivePath(&result, sub, left, right);
   assertSameUnorderedContent(expected, result);
 }
 
@@ -79,7 +80,7 @@ TEST(TransitivePathTest, idToVar) {
   TransitivePath T(getQec(), nullptr, left, right, 1,
                    std::numeric_limits<size_t>::max());
 
-  T.computeTransitivePath<2, 2>(&result, sub, left, right);
+  T.computeTransitivePath(&result, sub, left, right);
   assertSameUnorderedContent(expected, result);
 }
 
@@ -105,7 +106,7 @@ TEST(TransitivePathTest, varTovar) {
   TransitivePath T(getQec(), nullptr, right, left, 1,
                    std::numeric_limits<size_t>::max());
 
-  T.computeTransitivePath<2, 2>(&result, sub, left, right);
+  T.computeTransitivePath(&result, sub, left, right);
   assertSameUnorderedContent(expected, result);
 }
 
@@ -147,10 +148,67 @@ TEST(TransitivePathTest, unlimitedMaxLength) {
   TransitivePath T(getQec(), nullptr, left, right, 1,
                    std::numeric_limits<size_t>::max());
 
-  T.computeTransitivePath<2, 2>(&result, sub, left, right);
+  T.computeTransitivePath(&result, sub, left, right);
   assertSameUnorderedContent(expected, result);
 }
 
+TEST(TransitivePathTest, unlimitedMaxLengthViaCondensation) {
+  IdTable sub(2, makeAllocator());
+  sub.push_back({V(0), V(2)});
+  sub.push_back({V(2), V(4)});
+  sub.push_back({V(4), V(7)});
+  sub.push_back({V(0), V(7)});
+  sub.push_back({V(3), V(3)});
+  sub.push_back({V(7), V(0)});
+  // Edges from the cycle to a chain and from the self-loop to the cycle.
+  sub.push_back({V(4), V(10)});
+  sub.push_back({V(10), V(11)});
+  sub.push_back({V(3), V(2)});
+
+  TransitivePathSide left(std::nullopt, 0, Variable{"?start"}, 0);
+  TransitivePathSide right(std::nullopt, 1, Variable{"?target"}, 1);
+  auto minStartNodes =
+      RuntimeParameters()
+          .get<"transitive-path-min-start-nodes-for-condensation">();
+  auto computeResult = [&](size_t minDist, size_t minStartNodesForCondensation,
+                           size_t expectedNumComponents) {
+    RuntimeParameters().set<"transitive-path-min-start-nodes-for-condensation">(
+        minStartNodesForCondensation);
+    TransitivePath T(getQec(), nullptr, left, right, minDist,
+                     std::numeric_limits<size_t>::max());
+    IdTable result(2, makeAllocator());
+    T.computeTransitivePath(&result, sub, left, right);
+    auto& details = T.runtimeInfo().details_;
+    if (expectedNumComponents > 0) {
+      EXPECT_EQ(details["num-strongly-connected-components"].get<size_t>(),
+                expectedNumComponents);
+    } else {
+      EXPECT_FALSE(details.contains("num-strongly-connected-components"));
+    }
+    return result;
+  };
+
+  IdTable expected(2, makeAllocator());
+  for (auto start : {0, 2, 4, 7, 3}) {
+    for (auto target : {0, 2, 4, 7, 10, 11}) {
+      expected.push_back({V(start), V(target)});
+    }
+  }
+  expected.push_back({V(3), V(3)});
+  expected.push_back({V(10), V(11)});
+  // The SCCs are {0, 2, 4, 7}, {3}, {10}, and {11}.
+  auto result = computeResult(1, 1, 4);
+  assertSameUnorderedContent(expected, result);
+  assertSameUnorderedContent(computeResult(1, 1'000'000, 0), result);
+
+  // With paths of length zero, each start node also reaches itself.
+  assertSameUnorderedContent(computeResult(0, 1'000'000, 0),
+                             computeResult(0, 1, 4));
+
+  RuntimeParameters().set<"transitive-path-min-start-nodes-for-condensation">(
+      minStartNodes);
+}
+
 TEST(TransitivePathTest, maxLength2) {
   IdTable sub(2, makeAllocator());
   sub.push_back({V(0), V(2)});
@@ -183,7 +241,7 @@ TEST(TransitivePathTest, maxLength2) {
   TransitivePathSide left(std::nullopt, 0, Variable{"?start"}, 0);
   TransitivePathSide right(std::nullopt, 1, Variable{"?target"}, 1);
   TransitivePath T(getQec(), nullptr, left, right, 1, 2);
-  T.computeTransitivePath<2, 2>(&result, sub, left, right);
+  T.computeTransitivePath(&result, sub, left, right);
   assertSameUnorderedContent(expected, result);
 
   result.clear();
@@ -194,7 +252,7 @@ TEST(TransitivePathTest, maxLength2) {
 
   left.value_ = V(7);
   right.value_ = Variable{"?target"};
-  T.computeTransitivePath<2, 2>(&result, sub, left, right);
+  T.computeTransitivePath(&result, sub, left, right);
   assertSameUnorderedContent(expected, result);
 
   result.clear();
@@ -204,6 +262,81 @@ TEST(TransitivePathTest, maxLength2) {
 
   left.value_ = Variable{"?start"};
   right.value_ = V(2);
-  T.computeTransitivePath<2, 2>(&result, sub, right, left);
+  T.computeTransitivePath(&result, sub, right, left);
+  assertSameUnorderedContent(expected, result);
+}
+
+TEST(TransitivePathTest, maxLengthWithShortcut) {
+  // The node `3` can be reached from `0` via a path of length 2 (via the
+  // shortcut `0 -> 2`), but also via a path of length 3.
+  IdTable sub(2, makeAllocator());
+  sub.push_back({V(0), V(1)});
+  sub.push_back({V(1), V(2)});
+  sub.push_back({V(0), V(2)});
+  sub.push_back({V(2), V(3)});
+
+  IdTable result(2, makeAllocator());
+
+  IdTable expected(2, makeAllocator());
+  expected.push_back({V(0), V(1)});
+  expected.push_back({V(0), V(2)});
+  expected.push_back({V(0), V(3)});
+
+  TransitivePathSide left(std::nullopt, 0, V(0), 0);
+  TransitivePathSide right(std::nullopt, 1, Variable{"?target"}, 1);
+  TransitivePath T(getQec(), nullptr, left, right, 1, 2);
+  T.computeTransitivePath(&result, sub, left, right);
+  assertSameUnorderedContent(expected, result);
+
+  // With a minimal length of 3 only the longer path remains.
+  result.clear();
+  expected.clear();
+  expected.push_back({V(0), V(3)});
+  TransitivePath T3(getQec(), nullptr, left, right, 3, 3);
+  T3.computeTransitivePath(&result, sub, left, right);
+  assertSameUnorderedContent(expected, result);
+}
+
+TEST(TransitivePathTest, boundStartWithFixedTarget) {
+  IdTable sub(2, makeAllocator());
+  sub.push_back({V(0), V(2)});
+  sub.push_back({V(2), V(4)});
+  sub.push_back({V(4), V(7)});
+  sub.push_back({V(0), V(7)});
+  sub.push_back({V(3), V(3)});
+  sub.push_back({V(7), V(0)});
+  sub.push_back({V(10), V(11)});
+
+  // The start nodes and an additional column.
+  IdTable startNodes(2, makeAllocator());
+  startNodes.push_back({V(0), V(100)});
+  startNodes.push_back({V(3), V(101)});
+  startNodes.push_back({V(7), V(102)});
+  startNodes.push_back({V(10), V(103)});
+  startNodes.push_back({V(0), V(104)});
+
+  IdTable result(3, makeAllocator());
+
+  // The target `4` is reached from all start nodes in the strongly connected
+  // component `0, 2, 4, 7`.
+  IdTable expected(3, makeAllocator());
+  expected.push_back({V(0), V(4), V(100)});
+  expected.push_back({V(7), V(4), V(102)});
+  expected.push_back({V(0), V(4), V(104)});
+
+  TransitivePathSide left(TreeAndCol{nullptr, 0}, 0, Variable{"?start"}, 0);
+  TransitivePathSide right(std::nullopt, 1, V(4), 1);
+  TransitivePath T(getQec(), nullptr, left, right, 1,
+                   std::numeric_limits<size_t>::max());
+  T.computeTransitivePathBound(&result, sub, left, right, startNodes);
+  assertSameUnorderedContent(expected, result);
+
+  // With a maximal length of 2, the target can only be reached from `0`.
+  result.clear();
+  expected.clear();
+  expected.push_back({V(0), V(4), V(100)});
+  expected.push_back({V(0), V(4), V(104)});
+  TransitivePath T2(getQec(), nullptr, left, right, 1, 2);
+  T2.computeTransitivePathBound(&result, sub, left, right, startNodes);
   assertSameUnorderedContent(expected, result);
 }
@@ -0,0 +1,65 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "index/TrigramIndex.h"
+
+namespace {
+TrigramIndex makeTestIndex() {
+  TrigramIndex::Builder builder;
+  builder.add(VocabIndex::make(2), "Freiburg");
+  builder.add(VocabIndex::make(3), "Hamburg");
+  builder.add(VocabIndex::make(4), "Berlin");
+  builder.add(VocabIndex::make(7), "Bergen");
+  builder.add(VocabIndex::make(8), "Kiel");
+  EXPECT_ANY_THROW(builder.add(VocabIndex::make(8), "Kiel"));
+  return std::move(builder).finish();
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(TrigramIndex, getCandidates) {
+  auto index = makeTestIndex();
+  using V = std::vector<uint64_t>;
+  EXPECT_EQ(index.getCandidates("burg", false), (V{2, 3}));
+  EXPECT_EQ(index.getCandidates("Berg", false), (V{7}));
+  EXPECT_EQ(index.getCandidates("rlin", false), (V{4}));
+  EXPECT_EQ(index.getCandidates("xyz", false), (V{}));
+  // The candidates are a superset of the literals that contain the substring.
+  EXPECT_EQ(index.getCandidates("BURG", false), (V{2, 3}));
+  EXPECT_EQ(index.getCandidates("bergen", true), (V{7}));
+  // Substrings without a trigram.
+  EXPECT_EQ(index.getCandidates("rg", false), std::nullopt);
+  EXPECT_EQ(index.getCandidates("", false), std::nullopt);
+  // When ignoring the case, the trigrams with `k` and `s` are not used.
+  EXPECT_EQ(index.getCandidates("kie", false), (V{8}));
+  EXPECT_EQ(index.getCandidates("kie", true), std::nullopt);
+  EXPECT_EQ(index.getCandidates("kiel", true), (V{8}));
+}
+
+// _____________________________________________________________________________
+TEST(TrigramIndex, isIndexedWriteAndRead) {
+  auto index = makeTestIndex();
+  EXPECT_FALSE(index.empty());
+  using R = std::vector<std::pair<uint64_t, uint64_t>>;
+  EXPECT_EQ(index.indexedRanges(), (R{{2, 5}, {7, 9}}));
+  for (uint64_t i : {2, 3, 4, 7, 8}) {
+    EXPECT_TRUE(index.isIndexed(VocabIndex::make(i)));
+  }
+  for (uint64_t i : {0, 1, 5, 6, 9, 100}) {
+    EXPECT_FALSE(index.isIndexed(VocabIndex::make(i)));
+  }
+  EXPECT_TRUE(TrigramIndex{}.empty());
+
+  std::string filename = "trigramIndexTest.dat";
+  index.writeToFile(filename);
+  auto read = TrigramIndex::readFromFile(filename);
+  std::remove(filename.c_str());
+  EXPECT_EQ(read.size(), index.size());
+  EXPECT_EQ(read.indexedRanges(), index.indexedRanges());
+  EXPECT_EQ(read.getCandidates("burg", false),
+            (std::vector<uint64_t>{2, 3}));
+}
@@ -2,6 +2,11 @@
 // Chair of Algorithms and Data Structures.
 // Author: Johannes Kalmbach(joka921) <johannes.kalmbach@gmail.com>
 //
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <fstream>
 #include <iostream>
 #include <string>
 
@@ -181,6 +186,14 @@ TEST(TurtleParserTest, stringParse) {
     // string "" but the complex string """..."""
     checker(s3, lit(s3Normalized));
     checker(s4, lit(s4Normalized));
+
+    // Escaped quotes do not end the string, but an escaped backslash directly
+    // before the quote does. Quotes of the other kind or quotes that are
+    // shorter than the long quote are part of the string.
+    checker(R"("an \"escaped\" quote")", lit(R"("an \"escaped\" quote")"));
+    checker(R"("backslash \\" ")", lit(R"("backslash \\")"), 14);
+    checker(R"('it\'s "quoted"')", lit(R"("it's \"quoted\"")"));
+    checker(R"("""a "" b \""" c""")", lit(R"("a \"\" b \"\"\" c")"));
   };
   auto checkRe2 = checkParseResult<Re2Parser, &Re2Parser::stringParse>;
   auto checkCtre = checkParseResult<CtreParser, &CtreParser::stringParse>;
@@ -763,6 +776,40 @@ TEST(TurtleParserTest, multilineComments) {
   forAllParsers(testWithParser, input, expected);
 }
 
+// Test that the parallel parser correctly handles statements that span several
+// batches (here multiline literals that contain a `.` followed by a newline and
+// something that looks like a prefix declaration) and prefixes that are
+// redeclared in the middle of the input.
+TEST(TurtleParserTest, speculativeParallelParsing) {
+  std::string filename{"turtleParserSpeculativeParallelParsing.dat"};
+  std::string input;
+  for (size_t i = 0; i < 50; ++i) {
+    absl::StrAppend(&input, "@prefix ex: <http://example.org/a/> .\n",
+                    "ex:s", i, " ex:p \"\"\"multiline .\n",
+                    "PREFIX ex: <http://example.org/c/>\n",
+                    "ex:fake ex:p ex:o .\n\"\"\" .\n", "<s> <p> \"x", i,
+                    "\" .\n", "PREFIX ex: <http://example.org/b/>\n",
+                    "ex:s", i, " ex:p ex:o .\n");
+  }
+  {
+    auto of = ad_utility::makeOfstream(filename);
+    of << input;
+  }
+  Re2Parser expectedParser;
+  expectedParser.setInputStream(input);
+  auto expected = expectedParser.parseAndReturnAllTriples();
+  ASSERT_EQ(expected.size(), 150ul);
+  sortTriples(expected);
+
+  FILE_BUFFER_SIZE = 100;
+  auto testWithParser = [&]<typename Parser>(bool useBatchInterface) {
+    auto result = parseFromFile<Parser>(filename, useBatchInterface);
+    EXPECT_THAT(result, ::testing::ElementsAreArray(expected));
+  };
+  forAllParallelParsers(testWithParser);
+  ad_utility::deleteFile(filename);
+}
+
 // Test that exceptions during the turtle parsing are properly propagated to the
 // calling code. This is especially important for the parallel parsers where the
 // actual parsing happens on background threads.
@@ -840,3 +887,115 @@ TEST(TurtleParserTest, stopParsingOnOutsideFailure) {
   FILE_BUFFER_SIZE = 40;
   forAllParallelParsers(testWithParser, input);
 }
+
+// _______________________________________________________________________
+TEST(TurtleParserTest, compressedInput) {
+  namespace io = boost::iostreams;
+  std::string input;
+  std::vector<TurtleTriple> expectedTriples;
+  for (size_t i = 0; i < 1'000; ++i) {
+    auto subject = absl::StrCat("<", i / 100, ">");
+    auto object = absl::StrCat("<", i, ">");
+    absl::StrAppend(&input, subject, " <p> ", object, " .\n");
+    expectedTriples.emplace_back(subject, "<p>", object);
+  }
+  sortTriples(expectedTriples);
+
+  auto testCompression = [&](std::string filename, auto compressor) {
+    {
+      std::ofstream file{filename, std::ios::binary};
+      io::filtering_ostream stream;
+      stream.push(compressor);
+      stream.push(file);
+      stream << input;
+    }
+    auto testWithParser = [&]<typename Parser>(bool useBatchInterface) {
+      auto result = parseFromFile<Parser>(filename, useBatchInterface);
+      EXPECT_THAT(result, ::testing::ElementsAreArray(expectedTriples));
+    };
+    forAllParsers(testWithParser);
+    ad_utility::deleteFile(filename);
+  };
+  FILE_BUFFER_SIZE = 1000;
+  testCompression("turtleParserCompressedInput.ttl.gz",
+                  io::gzip_compressor{});
+  testCompression("turtleParserCompressedInput.ttl.bz2",
+                  io::bzip2_compressor{});
+  testCompression("turtleParserCompressedInput.ttl.zst",
+                  io::zstd_compressor{});
+
+  // A file that is not compressed despite its suffix.
+  std::string filename = "turtleParserNotCompressed.ttl.gz";
+  {
+    auto of = ad_utility::makeOfstream(filename);
+    of << input;
+  }
+  EXPECT_ANY_THROW(
+      (parseFromFile<TurtleStreamParser<Tokenizer>>(filename, true)));
+  ad_utility::deleteFile(filename);
+}
+
+// _______________________________________________________________________
+TEST(TurtleParserTest, multiFileParser) {
+  std::vector<std::string> filenames;
+  std::vector<TurtleTriple> expectedTriples;
+  for (size_t i = 0; i < 5; ++i) {
+    auto& filename = filenames.emplace_back(
+        absl::StrCat("turtleParserMultiFileParser", i, ".ttl"));
+    auto of = ad_utility::makeOfstream(filename);
+    // The same prefix is declared differently in each file.
+    of << "@prefix x: <file" << i << "/> .\n";
+    for (size_t j = 0; j < 200; ++j) {
+      of << "x:s" << j << " x:p <o" << j << "> .\n";
+      expectedTriples.emplace_back(absl::StrCat("<file", i, "/s", j, ">"),
+                                   absl::StrCat("<file", i, "/p>"),
+                                   absl::StrCat("<o", j, ">"));
+    }
+  }
+  sortTriples(expectedTriples);
+
+  FILE_BUFFER_SIZE = 1000;
+  auto makeParser = [](const std::string& filename) {
+    return std::make_unique<TurtleParallelParser<Tokenizer>>(filename);
+  };
+  for (size_t numFilesInParallel : {1, 2, 10}) {
+    for (bool useBatchInterface : {true, false}) {
+      MultiFileTurtleParser parser{filenames, makeParser, numFilesInParallel};
+      std::vector<TurtleTriple> result;
+      if (useBatchInterface) {
+        while (auto batch = parser.getBatch()) {
+          std::ranges::move(batch.value(), std::back_inserter(result));
+        }
+      } else {
+        TurtleTriple next;
+        while (parser.getLine(next)) {
+          result.push_back(next);
+        }
+      }
+      // The order of triples in not necessarily the same, so we sort them.
+      sortTriples(result);
+      EXPECT_THAT(result, ::testing::ElementsAreArray(expectedTriples));
+    }
+  }
+
+  // No files.
+  EXPECT_FALSE(MultiFileTurtleParser({}, makeParser, 2).getBatch());
+  // Destroying the parser before it is exhausted is fine.
+  EXPECT_TRUE(MultiFileTurtleParser(filenames, makeParser, 2).getBatch());
+
+  // Exceptions while opening or parsing one of the files are propagated.
+  auto parseAll = [&](std::vector<std::string> files) {
+    MultiFileTurtleParser parser{std::move(files), makeParser, 2};
+    while (parser.getBatch()) {
+    }
+  };
+  {
+    auto of = ad_utility::makeOfstream(filenames.at(0));
+    of << "<a> <b> .\n";
+  }
+  EXPECT_ANY_THROW(parseAll(filenames));
+  for (const auto& filename : filenames) {
+    ad_utility::deleteFile(filename);
+  }
+  EXPECT_ANY_THROW(parseAll({"turtleParserMultiFileParserMissing.ttl"}));
+}
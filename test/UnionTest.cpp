@@ -71,3 +71,145 @@ TEST(UnionTest, computeUnionLarge) {
 
   ASSERT_EQ(result, makeIdTableFromVector(expected));
 }
+
+// Test the lazy computation of a union where one of the inputs is lazy.
+TEST(UnionTest, computeUnionLazily) {
+  auto* qec = ad_utility::testing::getQec();
+  auto leftT = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, makeIdTableFromVector({{V(1)}, {V(2)}, {V(3)}}),
+      Vars{Variable{"?x"}});
+  dynamic_cast<ValuesForTesting&>(*leftT->getRootOperation())
+      .lazyBlockSize() = 2;
+
+  auto rightT = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, makeIdTableFromVector({{V(4), V(5)}, {V(6), V(7)}}),
+      Vars{Variable{"?u"}, Variable{"?x"}});
+
+  Union u{qec, leftT, rightT};
+  auto resultTable = u.computeResultOnlyForTesting(true);
+  ASSERT_FALSE(resultTable.isFullyMaterialized());
+
+  auto U = Id::makeUndefined();
+  std::vector<IdTable> expected;
+  expected.push_back(makeIdTableFromVector({{V(1), U}, {V(2), U}}));
+  expected.push_back(makeIdTableFromVector({{V(3), U}}));
+  expected.push_back(makeIdTableFromVector({{V(5), V(4)}, {V(7), V(6)}}));
+  size_t i = 0;
+  for (const auto& [block, localVocab] : resultTable.idTables()) {
+    ASSERT_LT(i, expected.size());
+    EXPECT_EQ(block, expected.at(i));
+    ++i;
+  }
+  EXPECT_EQ(i, expected.size());
+}
+
+// Test that a union of two fully materialized inputs is computed lazily if a
+// lazy result is requested, and that the blocks of a lazy input are passed on
+// without copying their columns.
+TEST(UnionTest, computeUnionLazilyWithoutCopies) {
+  auto* qec = ad_utility::testing::getQec();
+  auto leftT = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, makeIdTableFromVector({{V(1)}, {V(2)}}), Vars{Variable{"?x"}});
+  auto rightT = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, makeIdTableFromVector({{V(4), V(5)}}),
+      Vars{Variable{"?u"}, Variable{"?x"}});
+  Union u{qec, leftT, rightT};
+  auto resultTable = u.computeResultOnlyForTesting(true);
+  ASSERT_FALSE(resultTable.isFullyMaterialized());
+  auto U = Id::makeUndefined();
+  std::vector<IdTable> blocks;
+  for (auto& [block, localVocab] : resultTable.idTables()) {
+    blocks.push_back(std::move(block));
+  }
+  ASSERT_EQ(blocks.size(), 2u);
+  EXPECT_EQ(blocks.at(0), makeIdTableFromVector({{V(1), U}, {V(2), U}}));
+  EXPECT_EQ(blocks.at(1), makeIdTableFromVector({{V(5), V(4)}}));
+
+  auto block = makeIdTableFromVector({{V(4), V(5)}, {V(6), V(7)}});
+  const Id* firstColumn = block.getColumn(0).data();
+  auto transformed = u.transformBlock(std::move(block), false);
+  EXPECT_EQ(transformed, makeIdTableFromVector({{V(5), V(4)}, {V(7), V(6)}}));
+  EXPECT_EQ(transformed.getColumn(1).data(), firstColumn);
+}
+
+// Test that a wide union of unions is computed correctly when the inputs of
+// the unions are computed concurrently.
+TEST(UnionTest, computeInputsConcurrently) {
+  auto* qec = ad_utility::testing::getQec();
+  auto numThreadsBefore = RuntimeParameters().get<"subtree-num-threads">();
+  for (size_t numThreads : {1, 2, 4}) {
+    RuntimeParameters().set<"subtree-num-threads">(numThreads);
+    qec->clearCacheUnpinnedOnly();
+    std::vector<std::shared_ptr<QueryExecutionTree>> trees;
+    VectorTable expected;
+    for (size_t i = 0; i < 8; ++i) {
+      trees.push_back(ad_utility::makeExecutionTree<ValuesForTesting>(
+          qec, makeIdTableFromVector({{V(2 * i)}, {V(2 * i + 1)}}),
+          Vars{Variable{"?x"}}));
+      expected.push_back({V(2 * i)});
+      expected.push_back({V(2 * i + 1)});
+    }
+    auto leaves = trees;
+    while (trees.size() > 1) {
+      std::vector<std::shared_ptr<QueryExecutionTree>> next;
+      for (size_t i = 0; i < trees.size(); i += 2) {
+        next.push_back(ad_utility::makeExecutionTree<Union>(qec, trees[i],
+                                                            trees[i + 1]));
+      }
+      trees = std::move(next);
+    }
+    auto result = trees.at(0)->getResult();
+    EXPECT_EQ(result->idTable(), makeIdTableFromVector(expected));
+    for (const auto& leaf : leaves) {
+      EXPECT_EQ(leaf->getRootOperation()->runtimeInfo().status_,
+                RuntimeInformation::Status::fullyMaterialized);
+    }
+  }
+  RuntimeParameters().set<"subtree-num-threads">(numThreadsBefore);
+}
+
+// Test that the inputs of a union are merged if they are sorted on the same
+// variable, with and without laziness.
+TEST(UnionTest, mergeSortedInputs) {
+  auto* qec = ad_utility::testing::getQec();
+  auto makeTree = [qec](VectorTable table, Vars vars, ColumnIndex sortedOn,
+                        std::optional<size_t> lazyBlockSize = std::nullopt) {
+    auto tree = ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, makeIdTableFromVector(table), std::move(vars));
+    auto& values = dynamic_cast<ValuesForTesting&>(*tree->getRootOperation());
+    values.sortedColumns() = {sortedOn};
+    values.lazyBlockSize() = lazyBlockSize;
+    return tree;
+  };
+  Variable x{"?x"};
+  Variable y{"?y"};
+  Variable z{"?z"};
+  VectorTable left{{V(1), V(10)}, {V(3), V(30)}, {V(5), V(50)}};
+  VectorTable right{{V(20), V(2)}, {V(40), V(3)}, {V(60), V(6)}};
+  auto expected = makeIdTableFromVector({{V(1), V(10)},
+                                         {V(2), V(20)},
+                                         {V(3), V(30)},
+                                         {V(3), V(40)},
+                                         {V(5), V(50)},
+                                         {V(6), V(60)}});
+
+  for (bool lazy : {false, true}) {
+    Union u{qec, makeTree(left, Vars{x, y}, 0, 2),
+            makeTree(right, Vars{y, x}, 1)};
+    EXPECT_EQ(u.resultSortedOn(), std::vector<ColumnIndex>{0});
+    auto result = u.computeResultOnlyForTesting(lazy);
+    if (!lazy) {
+      EXPECT_EQ(result.idTable(), expected);
+      continue;
+    }
+    IdTable concatenated{2, ad_utility::testing::makeAllocator()};
+    for (const auto& [block, localVocab] : result.idTables()) {
+      concatenated.insertAtEnd(block);
+    }
+    EXPECT_EQ(concatenated, expected);
+  }
+
+  // If the inputs are sorted on different variables, they are concatenated.
+  Union u{qec, makeTree(left, Vars{x, y}, 0), makeTree(right, Vars{x, z}, 1)};
+  EXPECT_TRUE(u.resultSortedOn().empty());
+}
@@ -21,7 +21,8 @@ TEST(ValueIdComparators, GetRangeForDatatype) {
                                   Datatype::Undefined,
                                   Datatype::LocalVocabIndex,
                                   Datatype::TextRecordIndex,
-                                  Datatype::WordVocabIndex};
+                                  Datatype::WordVocabIndex,
+                                  Datatype::InlineString};
   auto ids = makeRandomIds();
   std::sort(ids.begin(), ids.end(), compareByBits);
   for (auto datatype : datatypes) {
@@ -212,7 +213,7 @@ auto testGetRangesForEqualIds(auto begin, auto end, ValueId idBegin,
 
 // Test that `getRangesFromId` works correctly for `ValueId`s of the unsigned
 // index types (`VocabIndex`, `TextRecordIndex`, `LocalVocabIndex`,
-// `WordVocabIndex`).
+// `WordVocabIndex`) and for `InlineString`s.
 TEST(ValueIdComparators, IndexTypes) {
   auto ids = makeRandomIds();
   std::sort(ids.begin(), ids.end(), compareByBits);
@@ -254,6 +255,7 @@ TEST(ValueIdComparators, IndexTypes) {
   testImpl.operator()<Datatype::TextRecordIndex>(&getTextRecordIndex);
   testImpl.operator()<Datatype::LocalVocabIndex>(&getLocalVocabIndex);
   testImpl.operator()<Datatype::WordVocabIndex>(&getWordVocabIndex);
+  testImpl.operator()<Datatype::InlineString>(&getInlineString);
 }
 
 // _______________________________________________________________________
@@ -288,3 +290,99 @@ TEST(ValueIdComparators, contractViolations) {
   // The third argument must be >= the second.
   ASSERT_ANY_THROW((compareWithEqualIds(I(3), I(25), I(12), Comparison::LE)));
 }
+
+// _______________________________________________________________________
+TEST(ValueIdComparators, compareColumnWithConstant) {
+  auto ids = makeRandomIds();
+  ids.push_back(ValueId::makeFromBool(true));
+  ids.push_back(ValueId::makeFromBool(false));
+  auto getRandomIndex =
+      ad_utility::SlowRandomIntGenerator<uint64_t>(0, ids.size() - 1);
+  auto testComparison = [&]<Comparison comparison>() {
+    std::vector<ValueId> result(ids.size());
+    std::vector<ValueId> constants{ValueId::makeUndefined(),
+                                   ValueId::makeFromBool(true)};
+    for (size_t i = 0; i < 50; ++i) {
+      constants.push_back(ids[getRandomIndex()]);
+    }
+    for (auto constant : constants) {
+      compareColumnWithConstant<comparison>(ids, constant, result);
+      for (size_t i = 0; i < ids.size(); ++i) {
+        ASSERT_EQ(result[i],
+                  toValueId(compareIds(ids[i], constant, comparison)))
+            << ids[i] << ' ' << constant;
+      }
+    }
+  };
+  testComparison.operator()<Comparison::LT>();
+  testComparison.operator()<Comparison::LE>();
+  testComparison.operator()<Comparison::EQ>();
+  testComparison.operator()<Comparison::NE>();
+  testComparison.operator()<Comparison::GE>();
+  testComparison.operator()<Comparison::GT>();
+
+  // The sizes of the column and the result must match.
+  std::vector<ValueId> tooSmall(ids.size() - 1);
+  ASSERT_ANY_THROW(compareColumnWithConstant<Comparison::LT>(
+      ids, ValueId::makeFromInt(3), tooSmall));
+}
+
+// _______________________________________________________________________
+TEST(ValueIdComparators, mayContainMatchingId) {
+  auto ids = makeRandomIds();
+  ids.push_back(ValueId::makeFromBool(true));
+  ids.push_back(ValueId::makeFromBool(false));
+  std::ranges::sort(ids, compareByBits);
+  auto getRandomIndex =
+      ad_utility::SlowRandomIntGenerator<uint64_t>(0, ids.size() - 1);
+  auto comparisons = std::array{Comparison::LT, Comparison::LE,
+                                Comparison::EQ, Comparison::NE,
+                                Comparison::GE, Comparison::GT};
+  // If one of the `ids` in `[lower, upper]` matches the constant, then
+  // `mayContainMatchingId` must return true.
+  for (size_t i = 0; i < 300; ++i) {
+    size_t a = getRandomIndex();
+    size_t b = getRandomIndex();
+    if (a > b) {
+      std::swap(a, b);
+    }
+    ValueId constant = ids[getRandomIndex()];
+    for (auto comparison : comparisons) {
+      bool hasMatch = std::any_of(
+          ids.begin() + a, ids.begin() + b + 1, [&](ValueId id) {
+            return compareIds(id, constant, comparison) ==
+                   ComparisonResult::True;
+          });
+      if (hasMatch) {
+        ASSERT_TRUE(mayContainMatchingId(ids[a], ids[b], constant,
+                                         comparison))
+            << ids[a] << ' ' << ids[b] << ' ' << constant;
+      }
+    }
+  }
+
+  auto I = ad_utility::testing::IntId;
+  auto D = ad_utility::testing::DoubleId;
+  auto V = ad_utility::testing::VocabId;
+  using enum Comparison;
+  EXPECT_TRUE(mayContainMatchingId(I(3), I(17), I(12), EQ));
+  EXPECT_FALSE(mayContainMatchingId(I(3), I(17), I(18), EQ));
+  EXPECT_FALSE(mayContainMatchingId(I(3), I(17), D(2.5), LT));
+  EXPECT_TRUE(mayContainMatchingId(I(3), I(17), D(3.5), LT));
+  EXPECT_FALSE(mayContainMatchingId(I(3), I(17), I(17), GT));
+  EXPECT_TRUE(mayContainMatchingId(I(3), I(17), I(17), GE));
+  EXPECT_FALSE(mayContainMatchingId(I(3), I(3), I(3), NE));
+  EXPECT_FALSE(mayContainMatchingId(D(-1.0), D(-8.0), I(0), GE));
+  EXPECT_TRUE(mayContainMatchingId(D(-1.0), D(-8.0), D(-7.5), GT));
+  // Mixed positive and negative integers are conservatively handled.
+  EXPECT_TRUE(mayContainMatchingId(I(3), I(-17), I(0), LT));
+  // Other datatypes are compared by their bits.
+  EXPECT_TRUE(mayContainMatchingId(V(3), V(17), V(12), EQ));
+  EXPECT_FALSE(mayContainMatchingId(V(3), V(17), V(1), LE));
+  EXPECT_FALSE(mayContainMatchingId(V(3), V(17), I(5), EQ));
+  // Blocks that span several datatypes.
+  EXPECT_TRUE(mayContainMatchingId(I(1000), V(17), D(1e10), GT));
+  EXPECT_TRUE(mayContainMatchingId(ValueId::min(), ValueId::max(), V(1), EQ));
+  EXPECT_FALSE(mayContainMatchingId(ValueId::min(), ValueId::max(),
+                                    ValueId::makeUndefined(), NE));
+}
@@ -164,6 +164,59 @@ TEST(ValueId, IndexOrdering) {
   testOrder(&makeTextRecordId, &getTextRecordIndex);
 }
 
+TEST(ValueId, InlineString) {
+  using namespace std::string_view_literals;
+  // The strings include prefixes of each other, strings with null bytes, and
+  // non-ASCII bytes.
+  std::vector<std::string_view> strings{
+      ""sv,     "\0"sv,      "a"sv,       "a\0"sv,     "a\0\0"sv,
+      "ab"sv,   "abc"sv,     "b"sv,       "<b>"sv,     "\xFF"sv,
+      "\xC3\xA4"sv, "1234567"sv, "1234566"sv};
+  std::vector<ValueId> ids;
+  for (auto s : strings) {
+    auto id = ValueId::makeFromInlineString(s);
+    ASSERT_EQ(id.getDatatype(), Datatype::InlineString);
+    ASSERT_EQ(id.getInlineString().view(), s);
+    ids.push_back(id);
+  }
+  ASSERT_ANY_THROW(ValueId::makeFromInlineString("12345678"));
+
+  // The order of the `ValueId`s is the lexicographical order of the strings
+  // (with the bytes compared as unsigned values).
+  std::ranges::sort(strings);
+  std::ranges::sort(ids);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(ids[i].getInlineString().view(), strings[i]);
+    if (i > 0) {
+      ASSERT_LT(ids[i - 1].getInlineString(), ids[i].getInlineString());
+    }
+  }
+}
+
+TEST(ValueId, EncodedIri) {
+  using EncodedIri = ValueId::EncodedIri;
+  std::vector<EncodedIri> iris{{0, 0},
+                               {0, 42},
+                               {0, ValueId::maxEncodedIriNumber},
+                               {3, 7},
+                               {ValueId::maxNumEncodedIriPrefixes - 1, 1}};
+  for (auto iri : iris) {
+    auto id = ValueId::makeFromEncodedIri(iri);
+    ASSERT_EQ(id.getDatatype(), Datatype::EncodedIri);
+    ASSERT_EQ(id.getEncodedIri(), iri);
+  }
+  ASSERT_ANY_THROW(ValueId::makeFromEncodedIri(
+      {ValueId::maxNumEncodedIriPrefixes, 0}));
+  ASSERT_ANY_THROW(
+      ValueId::makeFromEncodedIri({0, ValueId::maxEncodedIriNumber + 1}));
+
+  // The `ValueId`s are ordered by the prefix and then by the number.
+  std::vector<ValueId> ids;
+  std::ranges::transform(iris, std::back_inserter(ids),
+                         &ValueId::makeFromEncodedIri);
+  ASSERT_TRUE(std::ranges::is_sorted(ids));
+}
+
 TEST(ValueId, DoubleOrdering) {
   auto ids = makeRandomDoubleIds();
   std::vector<double> doubles;
@@ -291,6 +344,8 @@ TEST(ValueId, toDebugString) {
   test(makeLocalVocabId(25), "LocalVocabIndex:25");
   test(makeTextRecordId(37), "TextRecordIndex:37");
   test(makeWordVocabId(42), "WordVocabIndex:42");
+  test(ValueId::makeFromInlineString("<x>"), "InlineString:<x>");
+  test(ValueId::makeFromEncodedIri({2, 17}), "EncodedIri:2:17");
   test(ValueId::makeFromDate(
            DateOrLargeYear{123456, DateOrLargeYear::Type::Year}),
        "Date:123456");
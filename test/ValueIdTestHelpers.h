@@ -54,6 +54,12 @@ inline ValueId makeWordVocabId(uint64_t value) {
   return ValueId::makeFromWordVocabIndex(WordVocabIndex::make(value));
 }
 
+// Make an `InlineString` ID from the last (at most 7) decimal digits of the
+// `value`.
+inline ValueId makeInlineStringId(uint64_t value) {
+  return ValueId::makeFromInlineString(std::to_string(value % 10'000'000));
+}
+
 inline uint64_t getVocabIndex(ValueId id) { return id.getVocabIndex().get(); }
 inline uint64_t getLocalVocabIndex(ValueId id) {
   return id.getLocalVocabIndex().get();
@@ -64,6 +70,9 @@ inline uint64_t getTextRecordIndex(ValueId id) {
 inline uint64_t getWordVocabIndex(ValueId id) {
   return id.getWordVocabIndex().get();
 }
+inline std::string getInlineString(ValueId id) {
+  return std::string{id.getInlineString().view()};
+}
 
 inline auto addIdsFromGenerator = [](auto& generator, auto makeIds,
                                      std::vector<ValueId>& ids) {
@@ -107,6 +116,7 @@ inline auto makeRandomIds = []() {
   addIdsFromGenerator(indexGenerator, &makeLocalVocabId, ids);
   addIdsFromGenerator(indexGenerator, &makeTextRecordId, ids);
   addIdsFromGenerator(indexGenerator, &makeWordVocabId, ids);
+  addIdsFromGenerator(indexGenerator, &makeInlineStringId, ids);
   addIdsFromGenerator(nonOverflowingNBitGenerator, &ValueId::makeFromInt, ids);
   addIdsFromGenerator(overflowingNBitGenerator, &ValueId::makeFromInt, ids);
   addIdsFromGenerator(underflowingNBitGenerator, &ValueId::makeFromInt, ids);
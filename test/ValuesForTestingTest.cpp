@@ -36,3 +36,26 @@ TEST(ValuesForTesting, valuesForTesting) {
   auto result = v.getResult();
   ASSERT_EQ(result->idTable(), table);
 }
+
+// _____________________________________________________________________________
+TEST(ValuesForTesting, lazyResult) {
+  auto table = makeIdTableFromVector({{3, 4}, {12, 2}, {1, 63}});
+  ValuesForTesting v{
+      getQec(), table.clone(), {Variable{"?x"}, {Variable{"?y"}}}};
+  v.lazyBlockSize() = 2;
+
+  // Without laziness the result is fully materialized.
+  auto materialized = v.computeResultOnlyForTesting();
+  ASSERT_TRUE(materialized.isFullyMaterialized());
+  ASSERT_EQ(materialized.idTable(), table);
+
+  auto lazy = v.computeResultOnlyForTesting(true);
+  ASSERT_FALSE(lazy.isFullyMaterialized());
+  std::vector<IdTable> blocks;
+  for (auto& [block, localVocab] : lazy.idTables()) {
+    blocks.push_back(std::move(block));
+  }
+  ASSERT_EQ(blocks.size(), 2u);
+  EXPECT_EQ(blocks.at(0), makeIdTableFromVector({{3, 4}, {12, 2}}));
+  EXPECT_EQ(blocks.at(1), makeIdTableFromVector({{1, 63}}));
+}
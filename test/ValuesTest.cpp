@@ -70,9 +70,32 @@ TEST(Values, computeResult) {
   bool success = testQec->getIndex().getId("<x>", &x);
   AD_CORRECTNESS_CHECK(success);
   auto I = ad_utility::testing::IntId;
-  auto L = ad_utility::testing::LocalVocabId;
+  auto S = ad_utility::testing::InlineStringId;
   auto U = Id::makeUndefined();
-  ASSERT_EQ(table, makeIdTableFromVector({{I(12), x}, {U, L(0)}}));
+  // `<y>` is not contained in the vocabulary, but short enough to be stored
+  // directly in its `Id`.
+  ASSERT_EQ(table, makeIdTableFromVector({{I(12), x}, {U, S("<y>")}}));
+  EXPECT_TRUE(result->localVocab().empty());
+}
+
+// Check that strings that occur multiple times in a VALUES clause (in the same
+// or in different columns) get the same ID.
+TEST(Values, computeResultWithRepeatedStrings) {
+  auto testQec = ad_utility::testing::getQec("<x> <x> <x> .");
+  // The words are too long to be inlined into their `Id`s.
+  TC y{"<http://y>"};
+  TC z{"<http://z>"};
+  ValuesComponents values{{y, TC{"<x>"}}, {TC{"<x>"}, y}, {z, y}, {y, z}};
+  Values valuesOperation(testQec, {{Variable{"?x"}, Variable{"?y"}}, values});
+  auto result = valuesOperation.getResult();
+  const auto& table = result->idTable();
+  Id x;
+  bool success = testQec->getIndex().getId("<x>", &x);
+  AD_CORRECTNESS_CHECK(success);
+  auto L = ad_utility::testing::LocalVocabId;
+  ASSERT_EQ(table, makeIdTableFromVector(
+                       {{L(0), x}, {x, L(0)}, {L(1), L(0)}, {L(0), L(1)}}));
+  EXPECT_EQ(result->localVocab().size(), 2u);
 }
 
 // Check that if the number of variables and the number of values in each row
@@ -0,0 +1,117 @@
+//  Copyright 2024, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "../src/index/vocabulary/VocabularyFrontCoded.h"
+#include "../src/util/File.h"
+#include "./VocabularyTestHelpers.h"
+#include "absl/strings/str_cat.h"
+
+using namespace vocabulary_test;
+
+namespace {
+// A common suffix for all files to reduce the probability of colliding file
+// names, when other tests are run in parallel.
+const std::string suffix = ".vocabularyFrontCodedTest.dat";
+
+// Return a function that writes a vector of words to a `VocabularyFrontCoded`
+// with blocks of `numWordsPerBlock` words and reads it back from disk. Each
+// call to the returned function overwrites the files of the previous call.
+auto createVocabulary(std::string filename, size_t numWordsPerBlock) {
+  return [filename = absl::StrCat(filename, numWordsPerBlock, suffix),
+          numWordsPerBlock](const std::vector<std::string>& words) {
+    {
+      VocabularyFrontCoded vocabulary;
+      vocabulary.buildFromVector(words, filename, numWordsPerBlock);
+    }
+    VocabularyFrontCoded vocabulary;
+    vocabulary.open(filename);
+    ad_utility::deleteFile(filename);
+    ad_utility::deleteFile(filename + ".blockIndex");
+    return vocabulary;
+  };
+}
+
+// The block sizes with which all the tests are run, s.t. the searches and
+// lookups also cross the boundaries of the blocks.
+const std::vector<size_t> blockSizes{1, 2, 3, 4, 32};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(VocabularyFrontCoded, LowerUpperBoundStdLess) {
+  for (size_t blockSize : blockSizes) {
+    testUpperAndLowerBoundWithStdLess(
+        createVocabulary("lowerUpperBoundStdLess", blockSize));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(VocabularyFrontCoded, LowerUpperBoundNumeric) {
+  for (size_t blockSize : blockSizes) {
+    testUpperAndLowerBoundWithNumericComparator(
+        createVocabulary("lowerUpperBoundNumeric", blockSize));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(VocabularyFrontCoded, AccessOperator) {
+  for (size_t blockSize : blockSizes) {
+    testAccessOperatorForUnorderedVocabulary(
+        createVocabulary("accessOperator", blockSize));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(VocabularyFrontCoded, EmptyVocabulary) {
+  for (size_t blockSize : blockSizes) {
+    testEmptyVocabulary(createVocabulary("emptyVocabulary", blockSize));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(VocabularyFrontCoded, ManyWordsWithCommonPrefixes) {
+  std::vector<std::string> words;
+  for (size_t i = 0; i < 500; ++i) {
+    // Fixed-width numbers, s.t. the words are sorted and adjacent words share
+    // long prefixes. Some words are prefixes of their successor.
+    auto number = absl::StrCat(10000 + i);
+    words.push_back(absl::StrCat("<http://example.org/", number, ">"));
+    if (i % 7 == 0) {
+      words.back().pop_back();
+    }
+  }
+  std::ranges::sort(words);
+  words.push_back("");
+  std::ranges::rotate(words, words.end() - 1);
+
+  for (size_t blockSize : {1, 5, 16, 64}) {
+    auto vocab = createVocabulary("manyWords", blockSize)(words);
+    assertThatRangesAreEqual(vocab, words);
+    // Compare the results of the searches with the ones of the standard
+    // algorithms for each word and for words that are slightly smaller or
+    // larger.
+    for (const auto& word : words) {
+      std::string smaller = word;
+      if (!smaller.empty()) {
+        smaller.back()--;
+      }
+      for (const auto& query : {word, smaller, word + '\0'}) {
+        auto lower = std::ranges::lower_bound(words, query) - words.begin();
+        EXPECT_EQ(vocab.lower_bound(query, std::less<>{})._index, lower);
+        auto upper = std::ranges::upper_bound(words, query) - words.begin();
+        EXPECT_EQ(vocab.upper_bound(query, std::less<>{})._index, upper);
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+TEST(VocabularyFrontCoded, OutOfBounds) {
+  auto vocab = createVocabulary("outOfBounds", 2)({"a", "b", "c"});
+  EXPECT_EQ(vocab.getHighestId(), 2u);
+  EXPECT_EQ(vocab[2], "c");
+  EXPECT_ANY_THROW(vocab[3]);
+  vocab.close();
+  EXPECT_EQ(vocab.size(), 0u);
+}
@@ -1,3 +1,4 @@
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <cstdlib>
@@ -12,6 +13,7 @@
 #include "index/Index.h"
 #include "index/VocabularyGenerator.h"
 #include "util/Algorithm.h"
+#include "util/Serializer/ZstdFileSerializer.h"
 
 namespace {
 // equality operator used in this test
@@ -100,8 +102,8 @@ class MergeVocabularyTest : public ::testing::Test {
     expExtVoc << "\"bla\"\n";
 
     // open files for partial Vocabularies
-    ad_utility::serialization::FileWriteSerializer partial0(_path0);
-    ad_utility::serialization::FileWriteSerializer partial1(_path1);
+    ad_utility::serialization::ZstdFileWriteSerializer partial0(_path0);
+    ad_utility::serialization::ZstdFileWriteSerializer partial1(_path1);
 
     auto writePartialVocabulary =
         [](auto& partialVocab, const auto& tripleComponents, Mapping* mapping) {
@@ -164,34 +166,43 @@ class MergeVocabularyTest : public ::testing::Test {
 
 // Test for merge Vocabulary
 TEST_F(MergeVocabularyTest, mergeVocabulary) {
-  // mergeVocabulary only gets name of directory and number of files.
-  VocabularyMerger::VocabularyMetaData res;
-  {
-    VocabularyMerger m;
-    auto file = ad_utility::makeOfstream(_basePath + INTERNAL_VOCAB_SUFFIX);
-    auto internalVocabularyAction = [&file](const auto& word) {
-      file << RdfEscaping::escapeNewlinesAndBackslashes(word) << '\n';
-    };
-    res = m.mergeVocabulary(_basePath, 2, TripleComponentComparator(),
-                            internalVocabularyAction, 1_GB);
-  }
+  // With a minimum of one word per thread, the distinct words are identified
+  // and the mappings are written on multiple threads.
+  auto minWordsPerThread = MIN_WORDS_PER_THREAD_VOCABULARY_MERGING;
+  for (size_t minWords : {minWordsPerThread, size_t{1}}) {
+    MIN_WORDS_PER_THREAD_VOCABULARY_MERGING = minWords;
+    // mergeVocabulary only gets name of directory and number of files.
+    VocabularyMerger::VocabularyMetaData res;
+    {
+      VocabularyMerger m;
+      auto file = ad_utility::makeOfstream(_basePath + INTERNAL_VOCAB_SUFFIX);
+      auto internalVocabularyAction = [&file](const auto& word) {
+        file << RdfEscaping::escapeNewlinesAndBackslashes(word) << '\n';
+      };
+      res = m.mergeVocabulary(_basePath, 2, TripleComponentComparator(),
+                              internalVocabularyAction, 1_GB);
+    }
 
-  // No language tags in text file
-  ASSERT_EQ(res.langTaggedPredicates_.begin(), Id::makeUndefined());
-  ASSERT_EQ(res.langTaggedPredicates_.end(), Id::makeUndefined());
-  // Also no internal entities there.
-  ASSERT_EQ(res.internalEntities_.begin(), Id::makeUndefined());
-  ASSERT_EQ(res.internalEntities_.end(), Id::makeUndefined());
-  // check that (external) vocabulary has the right form.
-  ASSERT_TRUE(
-      areBinaryFilesEqual(_pathVocabExp, _basePath + INTERNAL_VOCAB_SUFFIX));
-  ASSERT_TRUE(areBinaryFilesEqual(_pathExternalVocabExp,
-                                  _basePath + EXTERNAL_LITS_TEXT_FILE_NAME));
-
-  IdPairMMapVecView mapping0(_basePath + PARTIAL_MMAP_IDS + std::to_string(0));
-  ASSERT_TRUE(vocabTestCompare(mapping0, _expMapping0));
-  IdPairMMapVecView mapping1(_basePath + PARTIAL_MMAP_IDS + std::to_string(1));
-  ASSERT_TRUE(vocabTestCompare(mapping1, _expMapping1));
+    // No language tags in text file
+    ASSERT_EQ(res.langTaggedPredicates_.begin(), Id::makeUndefined());
+    ASSERT_EQ(res.langTaggedPredicates_.end(), Id::makeUndefined());
+    // Also no internal entities there.
+    ASSERT_EQ(res.internalEntities_.begin(), Id::makeUndefined());
+    ASSERT_EQ(res.internalEntities_.end(), Id::makeUndefined());
+    // check that (external) vocabulary has the right form.
+    ASSERT_TRUE(
+        areBinaryFilesEqual(_pathVocabExp, _basePath + INTERNAL_VOCAB_SUFFIX));
+    ASSERT_TRUE(areBinaryFilesEqual(_pathExternalVocabExp,
+                                    _basePath + EXTERNAL_LITS_TEXT_FILE_NAME));
+
+    IdPairMMapVecView mapping0(_basePath + PARTIAL_MMAP_IDS +
+                                 std::to_string(0));
+    ASSERT_TRUE(vocabTestCompare(mapping0, _expMapping0));
+    IdPairMMapVecView mapping1(_basePath + PARTIAL_MMAP_IDS +
+                                 std::to_string(1));
+    ASSERT_TRUE(vocabTestCompare(mapping1, _expMapping1));
+  }
+  MIN_WORDS_PER_THREAD_VOCABULARY_MERGING = minWordsPerThread;
 }
 
 TEST(VocabularyGenerator, ReadAndWritePartial) {
@@ -231,6 +242,13 @@ TEST(VocabularyGenerator, ReadAndWritePartial) {
     EXPECT_EQ(V(2), idMap[V(7)]);
     EXPECT_EQ(V(3), idMap[V(8)]);
     EXPECT_EQ(V(4), idMap[V(9)]);
+    // The local IDs are not dense, so the lookup is a binary search.
+    PartialToGlobalIdMap mmappedIdMap{basename + PARTIAL_MMAP_IDS + "0"};
+    for (size_t i = 0; i < 5; ++i) {
+      EXPECT_EQ(V(i), mmappedIdMap(V(i + 5)));
+    }
+    EXPECT_ANY_THROW(mmappedIdMap(V(4)));
+    EXPECT_ANY_THROW(mmappedIdMap(V(10)));
     auto res = system("rm _tmp_testidx*");
     (void)res;
   }
@@ -291,6 +309,86 @@ TEST(VocabularyGenerator, ReadAndWritePartial) {
   }
 }
 
+// _____________________________________________________________________________
+TEST(VocabularyGenerator, mergeWithSortKeys) {
+  // Two partial vocabularies that are merged via the `SortKey`s that are
+  // stored in the files (this is how the vocabulary is merged during the index
+  // building).
+  using Level = TripleComponentComparator::Level;
+  RdfsVocabulary v;
+  v.setLocale("en", "US", false);
+  const auto& comparator = v.getCaseComparator();
+  std::pmr::monotonic_buffer_resource buffer;
+  auto alloc = std::pmr::polymorphic_allocator<char>{&buffer};
+  std::string basename = "_tmp_testidx_sortKeys";
+  auto writePartial =
+      [&](const std::vector<std::pair<std::string_view, size_t>>& words,
+          size_t fileIdx) {
+        ItemMapArray arr = makeItemMapArray();
+        for (const auto& [word, id] : words) {
+          arr[0].map_[word] = {
+              id, comparator.extractAndTransformComparableNonOwning(
+                      word, Level::TOTAL, false, &alloc)};
+        }
+        writePartialIdMapToBinaryFileForMerging(
+            std::make_shared<const ItemMapArray>(std::move(arr)),
+            absl::StrCat(basename, PARTIAL_VOCAB_FILE_NAME, fileIdx),
+            [&comparator](const auto& a, const auto& b) {
+              return comparator(a.second.splitVal_, b.second.splitVal_,
+                                Level::TOTAL);
+            },
+            false);
+      };
+  writePartial({{"\"a\"", 0}, {"\"Ba\"", 1}, {"\"Ä\"@en", 2}}, 0);
+  writePartial({{"\"A\"", 0}, {"\"a\"", 1}, {"\"car\"", 2}}, 1);
+
+  std::vector<std::string> words;
+  auto internalVocabularyAction = [&words](const auto& word) {
+    words.emplace_back(word);
+  };
+  VocabularyMerger m;
+  auto sortPred = [](const TripleComponentWithIndex& a,
+                     const TripleComponentWithIndex& b) {
+    return TripleComponentComparator::compareWithSortKeys(
+               a.iriOrLiteral(), a.sortKey(), b.iriOrLiteral(), b.sortKey()) <
+           0;
+  };
+  auto res = m.mergeVocabulary(basename, 2, sortPred, internalVocabularyAction,
+                               1_GB);
+  EXPECT_EQ(res.numWordsTotal_, 5u);
+  EXPECT_THAT(words, ::testing::ElementsAre("\"a\"", "\"A\"", "\"Ä\"@en",
+                                            "\"Ba\"", "\"car\""));
+  EXPECT_TRUE(std::ranges::is_sorted(words, [&comparator](const auto& a,
+                                                          const auto& b) {
+    return comparator(a, b, Level::TOTAL);
+  }));
+  auto idMap0 = IdMapFromPartialIdMapFile(basename + PARTIAL_MMAP_IDS + "0");
+  EXPECT_EQ(V(0), idMap0[V(0)]);
+  EXPECT_EQ(V(3), idMap0[V(1)]);
+  EXPECT_EQ(V(2), idMap0[V(2)]);
+  auto idMap1 = IdMapFromPartialIdMapFile(basename + PARTIAL_MMAP_IDS + "1");
+  EXPECT_EQ(V(1), idMap1[V(0)]);
+  EXPECT_EQ(V(0), idMap1[V(1)]);
+  EXPECT_EQ(V(4), idMap1[V(2)]);
+  // The mappings are sorted by the local IDs, which are dense.
+  using Expected = std::pair<int, std::array<int, 3>>;
+  for (const auto& [i, expected] :
+       {Expected{0, {0, 3, 2}}, Expected{1, {1, 0, 4}}}) {
+    std::string filename = basename + PARTIAL_MMAP_IDS + std::to_string(i);
+    IdPairMMapVecView pairs{filename};
+    EXPECT_TRUE(std::ranges::is_sorted(pairs, {}, [](const auto& pair) {
+      return pair.first.getBits();
+    }));
+    PartialToGlobalIdMap mmappedIdMap{filename};
+    for (size_t j = 0; j < expected.size(); ++j) {
+      EXPECT_EQ(V(expected[j]), mmappedIdMap(V(j)));
+    }
+    EXPECT_ANY_THROW(mmappedIdMap(V(3)));
+  }
+  auto removeFiles = system("rm _tmp_testidx_sortKeys*");
+  (void)removeFiles;
+}
+
 TEST(VocabularyGeneratorTest, createInternalMapping) {
   ItemVec input;
   using S = LocalVocabIndexAndSplitVal;
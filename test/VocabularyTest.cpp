@@ -9,6 +9,7 @@
 
 #include "../src/index/Vocabulary.h"
 #include "../src/util/json.h"
+#include "absl/strings/str_cat.h"
 
 using json = nlohmann::json;
 using std::string;
@@ -41,6 +42,50 @@ TEST(VocabularyTest, getIdForWordTest) {
   ASSERT_FALSE(voc.getId("ba", &idx));
 }
 
+TEST(VocabularyTest, getIdsForManyWords) {
+  ad_utility::HashSet<std::string> set;
+  for (size_t i = 0; i < 2000; ++i) {
+    set.insert(absl::StrCat("word", i));
+  }
+  TextVocabulary v;
+  v.createFromSet(set);
+
+  // Words that are contained and words that are not, in no particular order
+  // and with duplicates.
+  std::vector<std::string> words;
+  for (size_t i = 0; i < 2500; ++i) {
+    words.push_back(absl::StrCat("word", (i * 7919) % 2500));
+  }
+  words.push_back("word3");
+  words.push_back("");
+  words.push_back("zzz");
+  std::vector<std::string_view> wordViews{words.begin(), words.end()};
+
+  for (size_t numThreads : {1, 2, 4}) {
+    auto ids = v.getIds(wordViews, numThreads);
+    ASSERT_EQ(ids.size(), words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+      WordVocabIndex idx;
+      if (v.getId(words[i], &idx)) {
+        EXPECT_EQ(ids[i], idx) << words[i];
+      } else {
+        EXPECT_EQ(ids[i], std::nullopt) << words[i];
+      }
+    }
+  }
+  EXPECT_TRUE(v.getIds({}, 4).empty());
+
+  // The result is the same for a case-insensitive order.
+  TextVocabulary voc;
+  voc.setLocale("en", "US", false);
+  voc.createFromSet(ad_utility::HashSet<string>{"a", "A", "Ba", "car"});
+  std::vector<std::string_view> queries{"car", "ba", "A", "a", "Ba"};
+  using Indices = std::vector<std::optional<WordVocabIndex>>;
+  auto make = &WordVocabIndex::make;
+  EXPECT_EQ(voc.getIds(queries),
+            (Indices{make(3), std::nullopt, make(1), make(0), make(2)}));
+}
+
 TEST(VocabularyTest, getIdRangeForFullTextPrefixTest) {
   TextVocabulary v;
   ad_utility::HashSet<string> s{"wordA0", "wordA1", "wordB2", "wordB3",
@@ -109,6 +154,23 @@ TEST(VocabularyTest, createFromSetTest) {
   ASSERT_FALSE(v.getId("foo", &idx));
 }
 
+TEST(VocabularyTest, indexToOptionalStringUsesTheWordCache) {
+  auto& cache = getVocabularyWordCache();
+  TextVocabulary v;
+  v.createFromSet(ad_utility::HashSet<string>{"a", "b"});
+  size_t numMisses = cache.numMisses();
+  size_t numHits = cache.numHits();
+  EXPECT_EQ(v.indexToOptionalString(WordVocabIndex::make(1)), "b");
+  EXPECT_EQ(v.indexToOptionalString(WordVocabIndex::make(1)), "b");
+  EXPECT_EQ(cache.numMisses(), numMisses + 1);
+  EXPECT_EQ(cache.numHits(), numHits + 1);
+
+  // After the words have changed, the cached words are not used anymore.
+  v.createFromSet(ad_utility::HashSet<string>{"c", "d"});
+  EXPECT_EQ(v.indexToOptionalString(WordVocabIndex::make(1)), "d");
+  EXPECT_EQ(cache.numMisses(), numMisses + 2);
+}
+
 TEST(VocabularyTest, IncompleteLiterals) {
   TripleComponentComparator comp("en", "US", false);
 
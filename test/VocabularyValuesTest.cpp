@@ -0,0 +1,69 @@
+//  Copyright 2026, University of Freiburg,
+//  Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "./util/IdTestHelpers.h"
+#include "index/VocabularyValues.h"
+
+namespace {
+auto I = ad_utility::testing::IntId;
+auto D = ad_utility::testing::DoubleId;
+
+// Make a typed literal with a datatype from XML Schema.
+std::string xsd(std::string_view lexical, std::string_view datatype) {
+  return absl::StrCat("\"", lexical, "\"^^<http://www.w3.org/2001/XMLSchema#",
+                      datatype, ">");
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(VocabularyValues, parseLiteral) {
+  auto parse = &VocabularyValues::parseLiteral;
+  EXPECT_EQ(parse(xsd("42", "unsignedByte")), I(42));
+  EXPECT_EQ(parse(xsd("-17", "integer")), I(-17));
+  EXPECT_EQ(parse(xsd("1.5", "decimal")), D(1.5));
+  EXPECT_EQ(parse(xsd("-2e3", "double")), D(-2000.0));
+  // An integer that is too large for an `Int` becomes a `Double`.
+  EXPECT_EQ(parse(xsd("123456789012345678901234", "integer")),
+            D(123456789012345678901234.0));
+
+  auto date = parse(xsd("2024-05-17T12:30:00Z", "dateTime"));
+  ASSERT_TRUE(date.has_value());
+  EXPECT_EQ(date.value().getDatatype(), Datatype::Date);
+  EXPECT_EQ(date.value().getDate().getYear(), 2024);
+  auto year = parse(xsd("1950", "gYear"));
+  ASSERT_TRUE(year.has_value());
+  EXPECT_EQ(year.value().getDate().getYear(), 1950);
+
+  // No numeric or date literals, or invalid lexical forms.
+  EXPECT_EQ(parse(xsd("abc", "decimal")), std::nullopt);
+  EXPECT_EQ(parse(xsd("2024-13-45", "date")), std::nullopt);
+  EXPECT_EQ(parse(xsd("42", "string")), std::nullopt);
+  EXPECT_EQ(parse("\"42\""), std::nullopt);
+  EXPECT_EQ(parse("\"42\"@en"), std::nullopt);
+  EXPECT_EQ(parse("<http://example.org/42>"), std::nullopt);
+}
+
+// _____________________________________________________________________________
+TEST(VocabularyValues, addGetWriteAndRead) {
+  VocabularyValues values;
+  EXPECT_TRUE(values.empty());
+  values.add(VocabIndex::make(3), I(7));
+  values.add(VocabIndex::make(10), D(2.5));
+  EXPECT_ANY_THROW(values.add(VocabIndex::make(10), I(1)));
+  EXPECT_EQ(values.size(), 2u);
+  EXPECT_EQ(values.get(VocabIndex::make(3)), I(7));
+  EXPECT_EQ(values.get(VocabIndex::make(4)), std::nullopt);
+
+  std::string filename = "vocabularyValuesTest.dat";
+  values.writeToFile(filename);
+  auto read = VocabularyValues::readFromFile(filename);
+  std::remove(filename.c_str());
+  EXPECT_EQ(read.size(), 2u);
+  EXPECT_EQ(read.get(VocabIndex::make(10)), D(2.5));
+  EXPECT_EQ(read.get(VocabIndex::make(0)), std::nullopt);
+  EXPECT_EQ(read.get(VocabIndex::make(11)), std::nullopt);
+}
@@ -0,0 +1,81 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "index/VocabularyWordCache.h"
+
+using namespace ad_utility::memory_literals;
+
+namespace {
+// Return a lambda that returns the `word` and counts how often it was called.
+auto makeWordComputer(std::string word, size_t& numCalls) {
+  return [word = std::move(word), &numCalls]() {
+    ++numCalls;
+    return word;
+  };
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(VocabularyWordCache, hitsAndMisses) {
+  VocabularyWordCache cache{1_MB};
+  size_t numCalls = 0;
+  auto compute = makeWordComputer("<popular>", numCalls);
+  EXPECT_EQ(cache.getOrCompute({0, 42}, compute), "<popular>");
+  EXPECT_EQ(cache.numMisses(), 1);
+  EXPECT_EQ(cache.numHits(), 0);
+
+  // The same key is found in the cache, a different vocabulary or index is
+  // not.
+  EXPECT_EQ(cache.getOrCompute({0, 42}, compute), "<popular>");
+  EXPECT_EQ(numCalls, 1);
+  cache.getOrCompute({1, 42}, compute);
+  cache.getOrCompute({0, 43}, compute);
+  EXPECT_EQ(numCalls, 3);
+  EXPECT_EQ(cache.numHits(), 1);
+  EXPECT_EQ(cache.numMisses(), 3);
+  EXPECT_EQ(cache.numEntries(), 3);
+  EXPECT_EQ(cache.size(),
+            ad_utility::MemorySize::bytes(3 * (sizeof(std::string) + 9)));
+
+  // After clearing the cache, the word has to be computed again, but the
+  // statistics are kept.
+  cache.clear();
+  EXPECT_EQ(cache.numEntries(), 0);
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 4);
+  EXPECT_EQ(cache.numMisses(), 4);
+}
+
+// _____________________________________________________________________________
+TEST(VocabularyWordCache, sizeLimitsAndIds) {
+  // Each of the shards can store `1_kB / NUM_SHARDS` of words, which is less
+  // than the size of the word.
+  VocabularyWordCache cache{1_kB};
+  size_t numCalls = 0;
+  auto compute = makeWordComputer(std::string(100, 'a'), numCalls);
+  cache.getOrCompute({0, 42}, compute);
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 2);
+  EXPECT_EQ(cache.numEntries(), 0);
+
+  // A size of zero disables the cache completely.
+  cache.setMaxSize(0_B);
+  EXPECT_FALSE(cache.isEnabled());
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 3);
+  EXPECT_EQ(cache.numMisses(), 2);
+
+  cache.setMaxSize(1_MB);
+  EXPECT_TRUE(cache.isEnabled());
+  cache.getOrCompute({0, 42}, compute);
+  cache.getOrCompute({0, 42}, compute);
+  EXPECT_EQ(numCalls, 4);
+  EXPECT_EQ(cache.numEntries(), 1);
+
+  // The ids of the vocabularies are unique.
+  EXPECT_NE(VocabularyWordCache::newVocabularyId(),
+            VocabularyWordCache::newVocabularyId());
+}
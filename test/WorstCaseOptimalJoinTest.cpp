@@ -0,0 +1,130 @@
+//  Copyright 2024, University of Freiburg,
+//                  Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "./IndexTestHelpers.h"
+#include "./util/GTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "engine/QueryExecutionTree.h"
+#include "engine/WorstCaseOptimalJoin.h"
+
+using Var = Variable;
+
+namespace {
+// The graph `a -> b -> c -> a` and `c -> d -> e -> c` with two triangles, and
+// some edges that are not part of a triangle.
+constexpr std::string_view turtle =
+    "<a> <p> <b> . <b> <p> <c> . <c> <p> <a> . <c> <p> <d> . <d> <p> <e> . "
+    "<e> <p> <c> . <a> <p> <d> . <b> <p> <f> . <a> <q> <f> . <b> <q> <f> . "
+    "<c> <q> <f> .";
+
+std::vector<SparqlTriple> triangle() {
+  return {SparqlTriple{Var{"?x"}, "<p>", Var{"?y"}},
+          SparqlTriple{Var{"?y"}, "<p>", Var{"?z"}},
+          SparqlTriple{Var{"?z"}, "<p>", Var{"?x"}}};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(WorstCaseOptimalJoin, triangle) {
+  auto qec = ad_utility::testing::getQec(std::string{turtle});
+  auto id = ad_utility::testing::makeGetId(qec->getIndex());
+  WorstCaseOptimalJoin join{qec, triangle()};
+  EXPECT_EQ(join.getChildren().size(), 3u);
+  EXPECT_EQ(join.getResultWidth(), 3u);
+  EXPECT_THAT(join.resultSortedOn(), ::testing::ElementsAre(0, 1, 2));
+  EXPECT_FALSE(join.knownEmptyResult());
+
+  // All the variables occur in two triples, so the variables are bound in the
+  // order of their appearance in the (sorted) triples.
+  const auto& variables = join.variableOrder();
+  ASSERT_EQ(variables.size(), 3u);
+  EXPECT_EQ(join.getDescriptor(),
+            absl::StrCat("WorstCaseOptimalJoin on ", variables[0].name(), " ",
+                         variables[1].name(), " ", variables[2].name()));
+  auto columns = join.getExternallyVisibleVariableColumns();
+  for (size_t i = 0; i < variables.size(); ++i) {
+    EXPECT_EQ(columns.at(variables[i]), makeAlwaysDefinedColumn(i));
+  }
+
+  // Each triangle occurs once for each of its rotations.
+  auto result = join.getResult();
+  auto get = [&](const Var& variable) {
+    return columns.at(variable).columnIndex_;
+  };
+  std::vector<std::array<Id, 3>> rows;
+  for (const auto& row : result->idTable()) {
+    rows.push_back({row[get(Var{"?x"})], row[get(Var{"?y"})],
+                    row[get(Var{"?z"})]});
+  }
+  auto a = id("<a>"), b = id("<b>"), c = id("<c>"), d = id("<d>"),
+       e = id("<e>");
+  EXPECT_THAT(rows, ::testing::UnorderedElementsAre(
+                        std::array{a, b, c}, std::array{b, c, a},
+                        std::array{c, a, b}, std::array{c, d, e},
+                        std::array{d, e, c}, std::array{e, c, d}));
+  EXPECT_TRUE(std::ranges::is_sorted(result->idTable(), [](const auto& x,
+                                                          const auto& y) {
+    return std::ranges::lexicographical_compare(x, y);
+  }));
+}
+
+// _____________________________________________________________________________
+TEST(WorstCaseOptimalJoin, differentPredicatesAndCacheKey) {
+  auto qec = ad_utility::testing::getQec(std::string{turtle});
+  auto id = ad_utility::testing::makeGetId(qec->getIndex());
+  // The nodes `?x` and `?y` with an edge between them that both have a `<q>`
+  // edge to the same node `?z`.
+  std::vector triples{SparqlTriple{Var{"?x"}, "<p>", Var{"?y"}},
+                      SparqlTriple{Var{"?x"}, "<q>", Var{"?z"}},
+                      SparqlTriple{Var{"?y"}, "<q>", Var{"?z"}}};
+  WorstCaseOptimalJoin join{qec, triples};
+  // `?z` is only bound by the `<q>` triples with the object `<f>`.
+  auto columns = join.getExternallyVisibleVariableColumns();
+  auto result = join.getResult();
+  std::vector<std::array<Id, 2>> rows;
+  for (const auto& row : result->idTable()) {
+    EXPECT_EQ(row[columns.at(Var{"?z"}).columnIndex_], id("<f>"));
+    rows.push_back({row[columns.at(Var{"?x"}).columnIndex_],
+                    row[columns.at(Var{"?y"}).columnIndex_]});
+  }
+  EXPECT_THAT(rows, ::testing::UnorderedElementsAre(
+                        std::array{id("<a>"), id("<b>")},
+                        std::array{id("<b>"), id("<c>")},
+                        std::array{id("<c>"), id("<a>")}));
+
+  // The order of the triples doesn't matter.
+  std::ranges::reverse(triples);
+  WorstCaseOptimalJoin reversed{qec, triples};
+  EXPECT_EQ(join.getCacheKey(), reversed.getCacheKey());
+  EXPECT_EQ(join.variableOrder(), reversed.variableOrder());
+
+  // A triple with an empty scan leads to an empty result.
+  triples.push_back(SparqlTriple{Var{"?x"}, "<notInIndex>", Var{"?z"}});
+  WorstCaseOptimalJoin empty{qec, triples};
+  EXPECT_NE(join.getCacheKey(), empty.getCacheKey());
+  EXPECT_TRUE(empty.knownEmptyResult());
+  EXPECT_EQ(empty.getResult()->idTable().size(), 0u);
+}
+
+// _____________________________________________________________________________
+TEST(WorstCaseOptimalJoin, supportedTriples) {
+  auto qec = ad_utility::testing::getQec(std::string{turtle});
+  using W = WorstCaseOptimalJoin;
+  EXPECT_TRUE(W::isSupportedTriple({Var{"?x"}, "<p>", Var{"?y"}}));
+  EXPECT_FALSE(W::isSupportedTriple({Var{"?x"}, "<p>", Var{"?x"}}));
+  EXPECT_FALSE(W::isSupportedTriple({Var{"?x"}, "<p>", "<a>"}));
+  EXPECT_FALSE(W::isSupportedTriple({"<a>", "<p>", Var{"?y"}}));
+  EXPECT_FALSE(W::isSupportedTriple({Var{"?x"}, "?p", Var{"?y"}}));
+  EXPECT_FALSE(
+      W::isSupportedTriple({Var{"?x"}, HAS_PREDICATE_PREDICATE, Var{"?y"}}));
+
+  // At least two triples are required, and all of them must be supported.
+  EXPECT_ANY_THROW(
+      (W{qec, std::vector{SparqlTriple{Var{"?x"}, "<p>", Var{"?y"}}}}));
+  EXPECT_ANY_THROW((W{qec, std::vector{
+                               SparqlTriple{Var{"?x"}, "<p>", Var{"?y"}},
+                               SparqlTriple{Var{"?y"}, "<p>", "<a>"}}}));
+}
@@ -181,3 +181,50 @@ TEST(CartesianProductJoin, variableColumnMap) {
   EXPECT_THAT(join.getExternallyVisibleVariableColumns(),
               ::testing::UnorderedElementsAreArray(expectedVariables));
 }
+
+// ______________________________________________________________
+TEST(CartesianProductJoin, lazyResultInBlocks) {
+  auto qec = getQec();
+  using Vars = std::vector<std::optional<Variable>>;
+  VectorTable left;
+  VectorTable right;
+  for (int64_t i = 0; i < 7; ++i) {
+    left.push_back({i});
+    right.push_back({10 + i});
+  }
+  auto makeProduct = [&](size_t chunkSize) {
+    std::vector<std::shared_ptr<QueryExecutionTree>> subtrees;
+    subtrees.push_back(ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, makeIdTableFromVector(left), Vars{Variable{"?x"}}));
+    subtrees.push_back(ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, makeIdTableFromVector(right), Vars{Variable{"?y"}}));
+    return CartesianProductJoin{qec, std::move(subtrees), chunkSize};
+  };
+  auto expected =
+      makeProduct(1'000).computeResultOnlyForTesting().idTable().clone();
+  ASSERT_EQ(expected.numRows(), 49u);
+
+  for (LimitOffsetClause limit :
+       {LimitOffsetClause{}, LimitOffsetClause{30, 0, 0},
+        LimitOffsetClause{20, 0, 12}, LimitOffsetClause{std::nullopt, 0, 9}}) {
+    auto join = makeProduct(5);
+    join.setLimit(limit);
+    auto result = join.computeResultOnlyForTesting(true);
+    ASSERT_FALSE(result.isFullyMaterialized());
+    IdTable concatenated{2, makeAllocator()};
+    for (const auto& [block, localVocab] : result.idTables()) {
+      EXPECT_LE(block.numRows(), 5u);
+      concatenated.insertAtEnd(block);
+    }
+    IdTable expectedWindow{2, makeAllocator()};
+    expectedWindow.insertAtEnd(
+        expected.begin() + limit.actualOffset(expected.numRows()),
+        expected.begin() + limit.upperBound(expected.numRows()));
+    EXPECT_EQ(concatenated, expectedWindow);
+  }
+
+  // Results with at most `chunkSize` rows are always materialized.
+  auto join = makeProduct(5);
+  join.setLimit({5, 0, 40});
+  EXPECT_TRUE(join.computeResultOnlyForTesting(true).isFullyMaterialized());
+}
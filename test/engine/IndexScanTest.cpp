@@ -344,3 +344,20 @@ TEST(IndexScan, additionalColumn) {
   AD_EXPECT_THROW_WITH_MESSAGE(scan.computeResultOnlyForTesting(),
                                ::testing::ContainsRegex("IdTable.h"));
 }
+
+// _____________________________________________________________________________
+TEST(IndexScan, fullScanLazily) {
+  auto qec = getQec("<a> <p> <A>. <a> <q> <B>. <b> <p> <C>.");
+  SparqlTriple threeVars{Tc{Var{"?x"}}, "?p", Tc{Var{"?y"}}};
+  auto scan = IndexScan{qec, Permutation::PSO, threeVars};
+  auto expected = scan.computeResultOnlyForTesting(false);
+  auto lazyResult = scan.computeResultOnlyForTesting(true);
+  ASSERT_FALSE(lazyResult.isFullyMaterialized());
+  IdTable lazyTable{3, ad_utility::testing::makeAllocator()};
+  for (const auto& [block, localVocab] : lazyResult.idTables()) {
+    EXPECT_TRUE(localVocab.empty());
+    lazyTable.insertAtEnd(block.begin(), block.end());
+  }
+  EXPECT_EQ(lazyTable, expected.idTable());
+  EXPECT_EQ(lazyResult.sortedBy(), expected.sortedBy());
+}
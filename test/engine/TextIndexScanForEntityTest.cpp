@@ -128,6 +128,26 @@ TEST(TextIndexScanForEntity, CacheKeys) {
   ASSERT_NE(s7.getCacheKeyImpl(), s8.getCacheKeyImpl());
 }
 
+TEST(TextIndexScanForEntity, LazyResult) {
+  auto qec = getQec(kg, true, true, true, 16_B, true);
+  auto checkLazyResult = [](TextIndexScanForEntity& scan) {
+    auto lazyResult = scan.computeResultOnlyForTesting(true);
+    ASSERT_FALSE(lazyResult.isFullyMaterialized());
+    IdTable concatenated{scan.getResultWidth(), makeAllocator()};
+    for (const auto& [block, localVocab] : lazyResult.idTables()) {
+      EXPECT_FALSE(block.empty());
+      concatenated.insertAtEnd(block);
+    }
+    EXPECT_EQ(concatenated, scan.computeResultOnlyForTesting().idTable());
+  };
+  TextIndexScanForEntity s1{qec, Variable{"?text"}, Variable{"?entityVar"},
+                            "test*"};
+  checkLazyResult(s1);
+  TextIndexScanForEntity s2{qec, Variable{"?text"}, "\"some other sentence\"",
+                            "sentence"};
+  checkLazyResult(s2);
+}
+
 TEST(TextIndexScanForEntity, KnownEmpty) {
   auto qec = getQec(kg, true, true, true, 16_B, true);
 
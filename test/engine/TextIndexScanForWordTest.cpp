@@ -11,6 +11,7 @@
 #include "./TextIndexScanTestHelpers.h"
 #include "engine/IndexScan.h"
 #include "engine/TextIndexScanForWord.h"
+#include "index/ConstantsIndexBuilding.h"
 #include "parser/ParsedQuery.h"
 
 using namespace ad_utility::testing;
@@ -55,6 +56,38 @@ TEST(TextIndexScanForWord, WordScanPrefix) {
                          h::getWordFromResultTable(qec, result, 2)));
 }
 
+TEST(TextIndexScanForWord, WordScanPrefixWithPrefixBlocks) {
+  // With this threshold, each prefix that is longer than the prefixes of the
+  // regular blocks (e.g. `teste`) gets its own prefix block.
+  auto minNumPostings = MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK;
+  MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK = 1;
+  std::string kgWithPrefixes =
+      "<a> <p> \"he failed the test\" . <a> <p> \"testing can help\" . <b> "
+      "<p> \"the tester tested it\" . <b> <p> \"some other sentence\" .";
+  auto qec = getQec(kgWithPrefixes, true, true, true, 16_B, true);
+  MIN_NUM_POSTINGS_TEXT_PREFIX_BLOCK = minNumPostings;
+
+  auto getResult = [qec](std::string word) {
+    TextIndexScanForWord scan{qec, Variable{"?text"}, std::move(word)};
+    auto result = scan.computeResultOnlyForTesting();
+    std::vector<std::string> rows;
+    for (size_t i = 0; i < result.size(); ++i) {
+      rows.push_back(
+          h::combineToString(h::getTextRecordFromResultTable(qec, result, i),
+                             h::getWordFromResultTable(qec, result, i)));
+    }
+    return rows;
+  };
+  using V = std::vector<std::string>;
+  EXPECT_EQ(getResult("teste*"),
+            (V{h::combineToString("\"the tester tested it\"", "tested"),
+               h::combineToString("\"the tester tested it\"", "tester")}));
+  EXPECT_EQ(getResult("testi*"),
+            (V{h::combineToString("\"testing can help\"", "testing")}));
+  // The prefix of the regular block.
+  EXPECT_EQ(getResult("test*").size(), 4u);
+}
+
 TEST(TextIndexScanForWord, WordScanBasic) {
   auto qec = getQec(kg, true, true, true, 16_B, true);
 
@@ -83,6 +116,21 @@ TEST(TextIndexScanForWord, WordScanBasic) {
             h::getTextRecordFromResultTable(qec, result, 0));
 }
 
+TEST(TextIndexScanForWord, LazyResult) {
+  auto qec = getQec(kg, true, true, true, 16_B, true);
+  for (std::string word : {"test*", "test", "nonExistentWord"}) {
+    TextIndexScanForWord scan{qec, Variable{"?text"}, word};
+    auto lazyResult = scan.computeResultOnlyForTesting(true);
+    ASSERT_FALSE(lazyResult.isFullyMaterialized());
+    IdTable concatenated{scan.getResultWidth(), makeAllocator()};
+    for (const auto& [block, localVocab] : lazyResult.idTables()) {
+      EXPECT_FALSE(block.empty());
+      concatenated.insertAtEnd(block);
+    }
+    EXPECT_EQ(concatenated, scan.computeResultOnlyForTesting().idTable());
+  }
+}
+
 TEST(TextIndexScanForWord, CacheKey) {
   auto qec = getQec(kg, true, true, true, 16_B, true);
 
@@ -159,3 +159,19 @@ TEST(PatternCreatorNew, writeAndReadWithFinish) {
                         getVectorFromSorter(std::move(*hashPatternAsPSOPtr)));
   ad_utility::deleteFile(filename);
 }
+
+// The same patterns, but the triples are processed in many small batches,
+// which are split into several chunks.
+TEST(PatternCreatorNew, writeAndReadWithSmallBatches) {
+  auto batchSize =
+      std::exchange(NUM_TRIPLES_PER_BATCH_PATTERN_CREATION, size_t{2});
+  std::string filename = "patternCreatorSmallBatches.test.tmp";
+  PatternCreatorNew creator{filename, memForStxxl};
+  auto hashPatternAsPSOPtr = createExamplePatterns(creator);
+  creator.finish();
+
+  assertPatternContents(filename,
+                        getVectorFromSorter(std::move(*hashPatternAsPSOPtr)));
+  ad_utility::deleteFile(filename);
+  NUM_TRIPLES_PER_BATCH_PATTERN_CREATION = batchSize;
+}
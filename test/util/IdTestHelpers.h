@@ -29,4 +29,8 @@ inline auto TextRecordId = [](const auto& t) {
 inline auto WordVocabId = [](const auto& t) {
   return Id::makeFromWordVocabIndex(WordVocabIndex ::make(t));
 };
+
+inline auto InlineStringId = [](std::string_view s) {
+  return Id::makeFromInlineString(s);
+};
 }  // namespace ad_utility::testing
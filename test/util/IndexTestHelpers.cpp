@@ -34,6 +34,8 @@ std::vector<std::string> getAllIndexFilenames(
           indexBasename + ".index.osp",
           indexBasename + ".index.osp.meta",
           indexBasename + ".index.patterns",
+          absl::StrCat(indexBasename, ".index.patterns",
+                       CharacteristicSets::FILE_SUFFIX),
           indexBasename + ".meta-data.json",
           indexBasename + ".prefixes",
           indexBasename + ".vocabulary.internal",